@@ -0,0 +1,458 @@
+#include "../v8/src/v8.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Runs the suites in v8/benchmarks natively with warm-up control and
+// statistics.  Each suite runs in a fresh isolate for every flag
+// configuration; every iteration runs the suite once through base.js and
+// records its score together with the GC pause time and the compile time
+// V8 reported meanwhile.
+//
+//   xruby_benchmark [options] [v8 flags]
+//
+// Arguments that are not runner options are passed to V8 for every
+// configuration.
+
+namespace i = v8::internal;
+
+static const char* const kUsage =
+    "Usage: xruby_benchmark [options] [v8 flags]\n"
+    "  --benchmarks=<dir>  directory with base.js and the suites"
+    " (default v8/benchmarks)\n"
+    "  --suite=<name>      run only this suite, may be repeated\n"
+    "  --iterations=<n>    measured iterations per isolate (default 10)\n"
+    "  --warmup=<n>        iterations run first and discarded (default 2)\n"
+    "  --isolates=<n>      fresh isolates per suite and configuration"
+    " (default 1)\n"
+    "  --config=<flags>    V8 flags of one configuration, may be repeated\n"
+    "  --json=<file>       write the results as JSON\n";
+
+struct SuiteInfo {
+  const char* name;
+  const char* file;
+};
+
+static const SuiteInfo kSuites[] = {
+  { "Richards", "richards.js" },
+  { "DeltaBlue", "deltablue.js" },
+  { "Crypto", "crypto.js" },
+  { "RayTrace", "raytrace.js" },
+  { "EarleyBoyer", "earley-boyer.js" },
+  { "RegExp", "regexp.js" },
+  { "Splay", "splay.js" }
+};
+static const int kSuiteCount = sizeof(kSuites) / sizeof(kSuites[0]);
+
+// Runs the loaded suite once and returns its raw score, or throws the
+// first error a benchmark reported.
+static const char kIterationSource[] =
+    "function RunIteration() {\n"
+    "  var error = null;\n"
+    "  BenchmarkSuite.RunSuites({\n"
+    "    NotifyError: function(name, e) {\n"
+    "      if (error == null) error = name + ': ' + e;\n"
+    "    }\n"
+    "  });\n"
+    "  if (error != null) throw error;\n"
+    "  return 100 * BenchmarkSuite.scores[0];\n"
+    "}\n";
+
+struct Options {
+  Options()
+      : benchmarks_dir("v8/benchmarks"),
+        iterations(10),
+        warmup(2),
+        isolates(1),
+        json_file(NULL) {}
+
+  std::string benchmarks_dir;
+  std::vector<const SuiteInfo*> suites;
+  int iterations;
+  int warmup;
+  int isolates;
+  std::vector<std::string> configs;
+  std::string base_flags;
+  const char* json_file;
+};
+
+// What V8 reports during the current iteration.
+struct IterationCounters {
+  double gc_pause_ms;
+  int gc_count;
+  double compile_ms;
+};
+
+static IterationCounters counters;
+
+// Histograms of compile times, keyed by the names V8 creates them with.
+static const char* const kCompileHistograms[] = {
+  "V8.Compile", "V8.CompileEval", "V8.CompileLazy"
+};
+
+struct Result {
+  std::string config;
+  const SuiteInfo* suite;
+  std::string error;
+  std::vector<double> scores;
+  std::vector<double> times_ms;
+  std::vector<double> gc_pause_ms;
+  std::vector<double> gc_counts;
+  std::vector<double> compile_ms;
+};
+
+struct Summary {
+  double mean;
+  double median;
+  double stddev;
+  double ci95;
+  double min;
+  double max;
+};
+
+
+static void OnGCEvent(const v8::GCEvent& event) {
+  counters.gc_pause_ms += event.pause_time();
+  counters.gc_count++;
+}
+
+
+static void* CreateHistogram(const char* name, int min, int max,
+                             size_t buckets) {
+  for (size_t i = 0; i < sizeof(kCompileHistograms) / sizeof(char*); i++) {
+    if (strcmp(name, kCompileHistograms[i]) == 0) return &counters.compile_ms;
+  }
+  return NULL;
+}
+
+
+static void AddHistogramSample(void* histogram, int sample) {
+  *static_cast<double*>(histogram) += sample;
+}
+
+
+// Returns the two-sided 95% quantile of Student's t distribution.
+static double TQuantile95(int degrees_of_freedom) {
+  static const double kTable[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  static const int kTableSize = sizeof(kTable) / sizeof(kTable[0]);
+  if (degrees_of_freedom < 1) return 0;
+  if (degrees_of_freedom <= kTableSize) return kTable[degrees_of_freedom - 1];
+  return 1.960;
+}
+
+
+static Summary Summarize(const std::vector<double>& samples) {
+  Summary summary = { 0, 0, 0, 0, 0, 0 };
+  int n = static_cast<int>(samples.size());
+  if (n == 0) return summary;
+  std::vector<double> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0;
+  for (int i = 0; i < n; i++) sum += sorted[i];
+  summary.mean = sum / n;
+  summary.median = (n % 2 == 1) ? sorted[n / 2]
+                                : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+  summary.min = sorted[0];
+  summary.max = sorted[n - 1];
+  if (n > 1) {
+    double squares = 0;
+    for (int i = 0; i < n; i++) {
+      double delta = sorted[i] - summary.mean;
+      squares += delta * delta;
+    }
+    summary.stddev = sqrt(squares / (n - 1));
+    summary.ci95 = TQuantile95(n - 1) * summary.stddev / sqrt(n);
+  }
+  return summary;
+}
+
+
+static bool ReadFile(const std::string& name, std::string* contents) {
+  FILE* file = fopen(name.c_str(), "rb");
+  if (file == NULL) return false;
+  char buffer[4096];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents->append(buffer, read);
+  }
+  fclose(file);
+  return true;
+}
+
+
+static bool Execute(const std::string& source, const std::string& name,
+                    std::string* error) {
+  v8::HandleScope handle_scope;
+  v8::TryCatch try_catch;
+  v8::Handle<v8::Script> script =
+      v8::Script::Compile(v8::String::New(source.data(),
+                                          static_cast<int>(source.size())),
+                          v8::String::New(name.c_str()));
+  if (!script.IsEmpty() && !script->Run().IsEmpty()) return true;
+  v8::String::Utf8Value message(try_catch.Exception());
+  *error = name + ": " + (*message != NULL ? *message : "exception");
+  return false;
+}
+
+
+static bool LoadSuite(const Options& options, const SuiteInfo* suite,
+                      std::string* error) {
+  const char* files[] = { "base.js", suite->file };
+  for (int i = 0; i < 2; i++) {
+    std::string name = options.benchmarks_dir + "/" + files[i];
+    std::string source;
+    if (!ReadFile(name, &source)) {
+      *error = "cannot read " + name;
+      return false;
+    }
+    if (!Execute(source, name, error)) return false;
+  }
+  return Execute(kIterationSource, "runner", error);
+}
+
+
+// Runs one iteration of the loaded suite and adds its measurements to
+// result unless it is a warm-up iteration.
+static bool RunIteration(v8::Handle<v8::Function> run, bool measure,
+                         Result* result) {
+  v8::HandleScope handle_scope;
+  v8::TryCatch try_catch;
+  memset(&counters, 0, sizeof(counters));
+  double start = i::OS::TimeCurrentMillis();
+  v8::Handle<v8::Value> score =
+      run->Call(v8::Context::GetCurrent()->Global(), 0, NULL);
+  double elapsed = i::OS::TimeCurrentMillis() - start;
+  if (score.IsEmpty()) {
+    v8::String::Utf8Value message(try_catch.Exception());
+    result->error = *message != NULL ? *message : "exception";
+    return false;
+  }
+  if (measure) {
+    result->scores.push_back(score->NumberValue());
+    result->times_ms.push_back(elapsed);
+    result->gc_pause_ms.push_back(counters.gc_pause_ms);
+    result->gc_counts.push_back(counters.gc_count);
+    result->compile_ms.push_back(counters.compile_ms);
+  }
+  return true;
+}
+
+
+// Runs the suite in a fresh isolate, with the V8 flags of the current
+// configuration already set.
+static bool RunInIsolate(const Options& options, Result* result) {
+  v8::Isolate* isolate = v8::Isolate::New();
+  bool ok = true;
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::V8::SetCreateHistogramFunction(CreateHistogram);
+    v8::V8::SetAddHistogramSampleFunction(AddHistogramSample);
+    v8::HandleScope handle_scope;
+    v8::Persistent<v8::Context> context = v8::Context::New();
+    v8::V8::SetGCEventCallback(OnGCEvent);
+    {
+      v8::Context::Scope context_scope(context);
+      ok = LoadSuite(options, result->suite, &result->error);
+      if (ok) {
+        v8::Handle<v8::Function> run = v8::Handle<v8::Function>::Cast(
+            context->Global()->Get(v8::String::New("RunIteration")));
+        int total = options.warmup + options.iterations;
+        for (int i = 0; ok && i < total; i++) {
+          ok = RunIteration(run, i >= options.warmup, result);
+        }
+      }
+    }
+    context.Dispose();
+  }
+  isolate->Dispose();
+  return ok;
+}
+
+
+static void SetFlags(const Options& options, const std::string& config) {
+  i::FlagList::ResetAllFlags();
+  std::string flags = options.base_flags + " " + config;
+  v8::V8::SetFlagsFromString(flags.c_str(), static_cast<int>(flags.size()));
+}
+
+
+static void PrintSummary(const Result& result) {
+  const char* config = result.config.empty() ? "(default)"
+                                             : result.config.c_str();
+  if (!result.error.empty()) {
+    printf("%-12s %-24s error: %s\n", result.suite->name, config,
+           result.error.c_str());
+    return;
+  }
+  Summary score = Summarize(result.scores);
+  Summary gc = Summarize(result.gc_pause_ms);
+  Summary compile = Summarize(result.compile_ms);
+  printf("%-12s %-24s %10.1f %10.1f %9.1f %9.1f %9.2f\n",
+         result.suite->name, config, score.mean, score.median, score.ci95,
+         gc.mean, compile.mean);
+}
+
+
+static void WriteJSONString(FILE* out, const std::string& value) {
+  fputc('"', out);
+  for (size_t i = 0; i < value.size(); i++) {
+    char c = value[i];
+    if (c == '"' || c == '\\') {
+      fprintf(out, "\\%c", c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      fprintf(out, "\\u%04x", c);
+    } else {
+      fputc(c, out);
+    }
+  }
+  fputc('"', out);
+}
+
+
+static void WriteJSONSamples(FILE* out, const char* name,
+                             const std::vector<double>& samples) {
+  Summary summary = Summarize(samples);
+  fprintf(out, "\"%s\":{\"samples\":[", name);
+  for (size_t i = 0; i < samples.size(); i++) {
+    fprintf(out, "%s%.17g", i == 0 ? "" : ",", samples[i]);
+  }
+  fprintf(out, "],\"mean\":%.17g,\"median\":%.17g,\"stddev\":%.17g,"
+          "\"ci95\":%.17g,\"min\":%.17g,\"max\":%.17g}",
+          summary.mean, summary.median, summary.stddev, summary.ci95,
+          summary.min, summary.max);
+}
+
+
+static bool WriteJSON(const Options& options,
+                      const std::vector<Result>& results) {
+  FILE* out = fopen(options.json_file, "w");
+  if (out == NULL) return false;
+  fprintf(out, "{\"v8_version\":");
+  WriteJSONString(out, v8::V8::GetVersion());
+  fprintf(out, ",\"flags\":");
+  WriteJSONString(out, options.base_flags);
+  fprintf(out, ",\"iterations\":%d,\"warmup\":%d,\"isolates\":%d,"
+          "\"results\":[", options.iterations, options.warmup,
+          options.isolates);
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& result = results[i];
+    fprintf(out, "%s\n{\"suite\":", i == 0 ? "" : ",");
+    WriteJSONString(out, result.suite->name);
+    fprintf(out, ",\"config\":");
+    WriteJSONString(out, result.config);
+    if (!result.error.empty()) {
+      fprintf(out, ",\"error\":");
+      WriteJSONString(out, result.error);
+    } else {
+      fputc(',', out);
+      WriteJSONSamples(out, "score", result.scores);
+      fputc(',', out);
+      WriteJSONSamples(out, "time_ms", result.times_ms);
+      fputc(',', out);
+      WriteJSONSamples(out, "gc_pause_ms", result.gc_pause_ms);
+      fputc(',', out);
+      WriteJSONSamples(out, "gc_count", result.gc_counts);
+      fputc(',', out);
+      WriteJSONSamples(out, "compile_ms", result.compile_ms);
+    }
+    fputc('}', out);
+  }
+  fprintf(out, "\n]}\n");
+  fclose(out);
+  return true;
+}
+
+
+static const SuiteInfo* FindSuite(const char* name) {
+  for (int i = 0; i < kSuiteCount; i++) {
+    if (strcmp(kSuites[i].name, name) == 0) return &kSuites[i];
+  }
+  return NULL;
+}
+
+
+static bool ParseOptions(int argc, char* argv[], Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (strncmp(arg, "--benchmarks=", 13) == 0) {
+      options->benchmarks_dir = arg + 13;
+    } else if (strncmp(arg, "--suite=", 8) == 0) {
+      const SuiteInfo* suite = FindSuite(arg + 8);
+      if (suite == NULL) {
+        fprintf(stderr, "Unknown suite %s\n", arg + 8);
+        return false;
+      }
+      options->suites.push_back(suite);
+    } else if (strncmp(arg, "--iterations=", 13) == 0) {
+      options->iterations = atoi(arg + 13);
+    } else if (strncmp(arg, "--warmup=", 9) == 0) {
+      options->warmup = atoi(arg + 9);
+    } else if (strncmp(arg, "--isolates=", 11) == 0) {
+      options->isolates = atoi(arg + 11);
+    } else if (strncmp(arg, "--config=", 9) == 0) {
+      options->configs.push_back(arg + 9);
+    } else if (strncmp(arg, "--json=", 7) == 0) {
+      options->json_file = arg + 7;
+    } else if (strcmp(arg, "--help") == 0) {
+      return false;
+    } else {
+      options->base_flags += std::string(" ") + arg;
+    }
+  }
+  if (options->iterations < 1 || options->warmup < 0 ||
+      options->isolates < 1) {
+    return false;
+  }
+  if (options->suites.empty()) {
+    for (int i = 0; i < kSuiteCount; i++) {
+      options->suites.push_back(&kSuites[i]);
+    }
+  }
+  if (options->configs.empty()) options->configs.push_back("");
+  return true;
+}
+
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    fprintf(stderr, "%s", kUsage);
+    return 1;
+  }
+
+  printf("%-12s %-24s %10s %10s %9s %9s %9s\n", "Suite", "Config", "Mean",
+         "Median", "CI95 +/-", "GC ms", "Compile");
+  std::vector<Result> results;
+  bool failed = false;
+  for (size_t c = 0; c < options.configs.size(); c++) {
+    for (size_t s = 0; s < options.suites.size(); s++) {
+      Result result;
+      result.config = options.configs[c];
+      result.suite = options.suites[s];
+      for (int n = 0; n < options.isolates; n++) {
+        SetFlags(options, result.config);
+        if (!RunInIsolate(options, &result)) break;
+      }
+      failed |= !result.error.empty();
+      PrintSummary(result);
+      results.push_back(result);
+    }
+  }
+
+  if (options.json_file != NULL && !WriteJSON(options, results)) {
+    fprintf(stderr, "Cannot write %s\n", options.json_file);
+    failed = true;
+  }
+  v8::V8::Dispose();
+  return failed ? 1 : 0;
+}
@@ -1,33 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
 #include "../v8/src/v8.h"
+#include "../v8/src/snapshot.h"
 using namespace v8;
-//#include "ruby_parser.h"
+#include "ruby_parser.h"
+
+// Runs a Ruby script.
+//
+//   xruby [options] [v8 flags] [script.rb [arguments]]
+//
+// Options and V8 flags have to come before the script name.  The script's
+// own arguments are in the ARGV array.  Without a script a greeting is
+// printed.
+
+namespace i = v8::internal;
+
+static const char* const kUsage =
+    "Usage: xruby [options] [v8 flags] [script.rb [arguments]]\n"
+    "  --heap-limit=<mb>   maximum size of the old generation\n"
+    "  --young-limit=<mb>  maximum size of the young generation\n"
+    "  --cache=<file>      code cache of the script: used if it exists,"
+    " otherwise\n"
+    "                      written (this run is not optimized then)\n"
+    "  --snapshot=<file>   start from this startup snapshot instead of the"
+    " built-in one\n"
+    "  --stats             print startup, compile and run times to stderr\n"
+    "  --help              print this message and the V8 flags\n";
+
+struct Options {
+  Options()
+      : heap_limit_mb(0),
+        young_limit_mb(0),
+        cache_file(NULL),
+        snapshot_file(NULL),
+        stats(false),
+        script_file(NULL) {}
+
+  int heap_limit_mb;
+  int young_limit_mb;
+  const char* cache_file;
+  const char* snapshot_file;
+  bool stats;
+  const char* script_file;
+  std::vector<const char*> script_arguments;
+};
+
+// What V8 reports while the script runs, for --stats.
+static int gc_count = 0;
+static double gc_pause_ms = 0;
+
+
+// Prints its arguments, one per line, like Kernel#puts.
+static Handle<Value> Puts(const Arguments& args) {
+  for (int i = 0; i < args.Length(); i++) {
+    String::Utf8Value str(args[i]);
+    printf("%s\n", *str ? *str : "<string conversion failed>");
+  }
+  fflush(stdout);
+  return Undefined();
+}
+
+
+// Reads a file into a new[]-allocated buffer.  Returns NULL if the file
+// cannot be read.
+static char* ReadBytes(const char* name, int* size) {
+  FILE* file = fopen(name, "rb");
+  if (file == NULL) return NULL;
+
+  fseek(file, 0, SEEK_END);
+  *size = ftell(file);
+  rewind(file);
+
+  char* chars = new char[*size + 1];
+  chars[*size] = '\0';
+  for (int i = 0; i < *size;) {
+    int read = static_cast<int>(fread(&chars[i], 1, *size - i, file));
+    if (read == 0) break;
+    i += read;
+  }
+  fclose(file);
+  return chars;
+}
+
+
+// Reads a UTF-8 file into a v8 string.
+static Handle<String> ReadFile(const char* name) {
+  int size;
+  char* chars = ReadBytes(name, &size);
+  if (chars == NULL) return Handle<String>();
+  Handle<String> result = String::New(chars, size);
+  delete[] chars;
+  return result;
+}
+
+
+static bool WriteBytes(const char* name, const char* data, int size) {
+  FILE* file = fopen(name, "wb");
+  if (file == NULL) return false;
+  bool ok = static_cast<int>(fwrite(data, 1, size, file)) == size;
+  return fclose(file) == 0 && ok;
+}
+
+
+static void ReportException(TryCatch* try_catch) {
+  String::Utf8Value exception(try_catch->Exception());
+  Handle<Message> message = try_catch->Message();
+  if (message.IsEmpty()) {
+    fprintf(stderr, "%s\n", *exception);
+    return;
+  }
+  String::Utf8Value filename(message->GetScriptResourceName());
+  fprintf(stderr, "%s:%i: %s\n",
+          *filename ? *filename : "-e", message->GetLineNumber(), *exception);
+}
+
+
+static void OnGCEvent(const GCEvent& event) {
+  gc_pause_ms += event.pause_time();
+  gc_count++;
+}
+
+
+// Takes the xruby options out of argv and passes the flags before the
+// script name to V8.
+static bool ParseOptions(int argc, char* argv[], Options* options) {
+  std::vector<char*> flags;
+  flags.push_back(argv[0]);
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    const char* arg = argv[i];
+    if (strncmp(arg, "--heap-limit=", 13) == 0) {
+      options->heap_limit_mb = atoi(arg + 13);
+    } else if (strncmp(arg, "--young-limit=", 14) == 0) {
+      options->young_limit_mb = atoi(arg + 14);
+    } else if (strncmp(arg, "--cache=", 8) == 0) {
+      options->cache_file = arg + 8;
+    } else if (strncmp(arg, "--snapshot=", 11) == 0) {
+      options->snapshot_file = arg + 11;
+    } else if (strcmp(arg, "--stats") == 0) {
+      options->stats = true;
+    } else if (strcmp(arg, "--help") == 0) {
+      // V8 prints its flags after this and exits.
+      printf("%s", kUsage);
+      flags.push_back(argv[i]);
+    } else {
+      flags.push_back(argv[i]);
+    }
+  }
+  if (i < argc) options->script_file = argv[i++];
+  for (; i < argc; i++) options->script_arguments.push_back(argv[i]);
+
+  // Leaves the flags V8 does not know.
+  int flag_count = static_cast<int>(flags.size());
+  V8::SetFlagsFromCommandLine(&flag_count, &flags[0], true);
+  if (flag_count > 1) {
+    fprintf(stderr, "Unknown option %s\n", flags[1]);
+    return false;
+  }
+  if (options->heap_limit_mb < 0 || options->young_limit_mb < 0) {
+    return false;
+  }
+  if (options->cache_file != NULL && options->script_file == NULL) {
+    fprintf(stderr, "--cache needs a script\n");
+    return false;
+  }
+  return true;
+}
+
+
+// Sets up V8 before it is initialized, and initializes it from the
+// snapshot file if there is one.
+static bool InitializeV8(const Options& options, bool create_code_cache) {
+  if (options.heap_limit_mb != 0 || options.young_limit_mb != 0) {
+    ResourceConstraints constraints;
+    constraints.set_max_old_space_size(options.heap_limit_mb * i::MB);
+    constraints.set_max_young_space_size(options.young_limit_mb * i::MB);
+    if (!SetResourceConstraints(&constraints)) {
+      fprintf(stderr, "Invalid heap limits.\n");
+      return false;
+    }
+  }
+  if (create_code_cache) V8::EnableCodeCacheCreation();
+  if (options.snapshot_file != NULL &&
+      !i::Snapshot::Initialize(options.snapshot_file)) {
+    fprintf(stderr, "Error reading snapshot '%s'.\n", options.snapshot_file);
+    return false;
+  }
+  return true;
+}
+
 
 int main(int argc, char* argv[]) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    fprintf(stderr, "%s", kUsage);
+    return 1;
+  }
+  double start = i::OS::TimeCurrentMillis();
+
+  // A code cache is only written when there is none to read, because
+  // creating one disables the optimizing compiler.
+  int cache_size = 0;
+  char* cache_data = NULL;
+  if (options.cache_file != NULL) {
+    cache_data = ReadBytes(options.cache_file, &cache_size);
+  }
+  bool create_code_cache = options.cache_file != NULL && cache_data == NULL;
+  if (!InitializeV8(options, create_code_cache)) return 1;
 
   // Create a stack-allocated handle scope.
   HandleScope handle_scope;
 
-  // Create a new context.
-  Persistent<Context> context = Context::New();//will also initilize v8 if not done yet
-  
-  // Enter the created context for compiling and
-  // running the hello world script. 
+  // Expose puts to Ruby code as a global method.
+  Handle<ObjectTemplate> global = ObjectTemplate::New();
+  global->Set(String::New("puts"), FunctionTemplate::New(Puts));
+
+  // Create a new context, which also initializes V8 unless the snapshot
+  // file did.
+  Persistent<Context> context = Context::New(NULL, global);
+  V8::SetGCEventCallback(OnGCEvent);
+
+  // Enter the created context for compiling and running the script.
   Context::Scope context_scope(context);
 
-  // Create a string containing the JavaScript source code.
-  Handle<String> source = String::New("'Hello' + ', World!'");
+  Handle<Array> arguments =
+      Array::New(static_cast<int>(options.script_arguments.size()));
+  for (size_t i = 0; i < options.script_arguments.size(); i++) {
+    arguments->Set(static_cast<uint32_t>(i),
+                   String::New(options.script_arguments[i]));
+  }
+  context->Global()->Set(String::New("ARGV"), arguments);
 
-  // Compile the source code.
-  Handle<Script> script = Script::Compile(source);//api.cc
+  // Read the Ruby source from the file named on the command line.
+  Handle<String> source;
+  Handle<Value> file_name;
+  if (options.script_file != NULL) {
+    source = ReadFile(options.script_file);
+    if (source.IsEmpty()) {
+      fprintf(stderr, "Error reading '%s'.\n", options.script_file);
+      context.Dispose();
+      return 1;
+    }
+    file_name = String::New(options.script_file);
+  } else {
+    source = String::New("puts 'Hello, World!'");
+  }
+  double compile_start = i::OS::TimeCurrentMillis();
 
-  // Run the script to get the result.
-  Handle<Value> result = script->Run();
+  // Compile the source code straight to V8 syntax trees, or restore the
+  // compiled code from the cache, and run it.
+  TryCatch try_catch;
+  ScriptData* code_cache = NULL;
+  if (cache_data != NULL) code_cache = ScriptData::New(cache_data, cache_size);
+  Handle<Script> script = xruby::CompileRuby(source, file_name, code_cache);
+  delete code_cache;
+  delete[] cache_data;
+  if (script.IsEmpty()) {
+    ReportException(&try_catch);
+    context.Dispose();
+    return 1;
+  }
+  if (create_code_cache) {
+    ScriptData* cache = script->CreateCodeCache();
+    if (cache == NULL ||
+        !WriteBytes(options.cache_file, cache->Data(), cache->Length())) {
+      fprintf(stderr, "Cannot write code cache '%s'.\n", options.cache_file);
+    }
+    delete cache;
+  }
+  double run_start = i::OS::TimeCurrentMillis();
+  bool ok = !script->Run().IsEmpty();
+  if (!ok) ReportException(&try_catch);
+  double end = i::OS::TimeCurrentMillis();
+
+  if (options.stats) {
+    HeapStatistics heap;
+    V8::GetHeapStatistics(&heap);
+    fprintf(stderr, "startup   %9.1f ms%s\n", compile_start - start,
+            options.snapshot_file != NULL ? " (snapshot file)" : "");
+    fprintf(stderr, "compile   %9.1f ms%s\n", run_start - compile_start,
+            create_code_cache ? " (cache written)" :
+            options.cache_file != NULL ? " (cache read)" : "");
+    fprintf(stderr, "run       %9.1f ms\n", end - run_start);
+    fprintf(stderr, "gc        %9.1f ms in %d collections\n", gc_pause_ms,
+            gc_count);
+    fprintf(stderr, "heap      %9d KB used of %d KB\n",
+            static_cast<int>(heap.used_heap_size() / i::KB),
+            static_cast<int>(heap.total_heap_size() / i::KB));
+  }
 
   // Dispose the persistent context.
   context.Dispose();
-
-  // Convert the result to an ASCII string and print it.
-  String::AsciiValue ascii(result);
-  printf("%s\n", *ascii);
-  return 0;
-}
\ No newline at end of file
+  return ok ? 0 : 1;
+}
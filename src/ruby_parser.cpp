@@ -0,0 +1,2441 @@
+#include "ruby_parser.h"
+
+#include "../v8/src/ast.h"
+#include "../v8/src/char-predicates-inl.h"
+#include "../v8/src/compiler.h"
+#include "../v8/src/conversions.h"
+#include "../v8/src/messages.h"
+#include "../v8/src/scanner-character-streams.h"
+#include "../v8/src/scopes.h"
+
+using namespace v8::internal;
+
+namespace xruby {
+
+// ----------------------------------------------------------------------------
+// Tokens
+
+class RubyToken {
+ public:
+  enum Value {
+    EOS,
+    NEWLINE,
+    NUMBER,
+    STRING,
+    SYMBOL,
+    IDENTIFIER,
+    CONSTANT,
+    INSTANCE_VARIABLE,
+
+    // Keywords.
+    AND,
+    BEGIN,
+    BREAK,
+    CLASS,
+    DEF,
+    DO,
+    ELSE,
+    ELSIF,
+    END,
+    ENSURE,
+    FALSE_LITERAL,
+    IF,
+    NEXT,
+    NIL,
+    NOT,
+    OR,
+    RAISE,
+    RESCUE,
+    RETURN,
+    SELF,
+    THEN,
+    TRUE_LITERAL,
+    UNLESS,
+    UNTIL,
+    WHILE,
+    YIELD,
+
+    // Punctuators.
+    LPAREN,
+    RPAREN,
+    LBRACK,
+    RBRACK,
+    LBRACE,
+    RBRACE,
+    PIPE,
+    COMMA,
+    PERIOD,
+    SEMICOLON,
+    CONDITIONAL,
+    COLON,
+    ARROW,
+
+    // Assignment operators.
+    ASSIGN,
+    ASSIGN_ADD,
+    ASSIGN_SUB,
+    ASSIGN_MUL,
+    ASSIGN_DIV,
+    ASSIGN_MOD,
+
+    // Binary and unary operators.
+    OR_OR,
+    AND_AND,
+    BANG,
+    EQ,
+    NE,
+    LT,
+    GT,
+    LTE,
+    GTE,
+    SHL,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    MOD,
+    POW,
+
+    ILLEGAL,
+    NUM_TOKENS
+  };
+
+  // Returns the source text of a token, used in error messages.
+  static const char* Text(Value token) {
+    ASSERT(0 <= token && token < NUM_TOKENS);
+    return text_[token];
+  }
+
+  static bool IsAssignmentOp(Value token) {
+    return ASSIGN <= token && token <= ASSIGN_MOD;
+  }
+
+  // Returns the binding power of a binary operator, or 0 for tokens that
+  // are not binary operators.  The logical keyword operators, the ternary
+  // operator and '**' are handled separately.
+  static int Precedence(Value token) {
+    switch (token) {
+      case OR_OR: return 1;
+      case AND_AND: return 2;
+      case EQ: case NE: return 3;
+      case LT: case GT: case LTE: case GTE: return 4;
+      case SHL: return 5;
+      case ADD: case SUB: return 6;
+      case MUL: case DIV: case MOD: return 7;
+      default: return 0;
+    }
+  }
+
+ private:
+  static const char* const text_[NUM_TOKENS];
+};
+
+
+const char* const RubyToken::text_[NUM_TOKENS] = {
+  NULL, "\\n", NULL, NULL, NULL, NULL, NULL, NULL,
+  "and", "begin", "break", "class", "def", "do", "else", "elsif", "end",
+  "ensure", "false", "if", "next", "nil", "not", "or", "raise", "rescue",
+  "return", "self", "then", "true", "unless", "until", "while", "yield",
+  "(", ")", "[", "]", "{", "}", "|", ",", ".", ";", "?", ":", "=>",
+  "=", "+=", "-=", "*=", "/=", "%=",
+  "||", "&&", "!", "==", "!=", "<", ">", "<=", ">=", "<<", "+", "-", "*",
+  "/", "%", "**",
+  "ILLEGAL"
+};
+
+
+// ----------------------------------------------------------------------------
+// Scanner
+
+class RubyScanner {
+ public:
+  struct Location {
+    Location(int b, int e) : beg_pos(b), end_pos(e) { }
+    Location() : beg_pos(0), end_pos(0) { }
+    int beg_pos;
+    int end_pos;
+  };
+
+  explicit RubyScanner(Isolate* isolate)
+      : isolate_(isolate),
+        source_(NULL),
+        c0_(kEndOfInput),
+        has_peek_ahead_(false) { }
+
+  void Initialize(UC16CharacterStream* source) {
+    source_ = source;
+    Advance();
+    Scan(&next_);
+  }
+
+  // Returns the next token and advances input.
+  RubyToken::Value Next() {
+    current_ = next_;
+    if (has_peek_ahead_) {
+      next_ = peek_ahead_;
+      has_peek_ahead_ = false;
+    } else {
+      Scan(&next_);
+    }
+    return current_.token;
+  }
+
+  // Returns the next token without advancing input.
+  RubyToken::Value peek() const { return next_.token; }
+
+  // Returns the token after the next one without advancing input.
+  RubyToken::Value PeekAhead() {
+    if (!has_peek_ahead_) {
+      Scan(&peek_ahead_);
+      has_peek_ahead_ = true;
+    }
+    return peek_ahead_.token;
+  }
+
+  // Whether whitespace separates the next token from the current one.
+  // Distinguishes 'f [1]' (a call with an array argument) from 'a[1]'.
+  bool peek_after_space() const { return next_.after_space; }
+
+  Location location() const { return current_.location; }
+  Location peek_location() const { return next_.location; }
+
+  // The value of the current NUMBER token.
+  double number() const { return current_.number; }
+
+  // The symbol for the current STRING, IDENTIFIER, CONSTANT or
+  // INSTANCE_VARIABLE token.
+  Handle<String> literal() const { return current_.literal; }
+
+ private:
+  static const int kEndOfInput = -1;
+
+  struct TokenDesc {
+    TokenDesc() : token(RubyToken::EOS), after_space(false), number(0) { }
+    RubyToken::Value token;
+    Location location;
+    bool after_space;
+    double number;
+    Handle<String> literal;
+  };
+
+  void Advance() { c0_ = source_->Advance(); }
+
+  void PushBack(uc32 ch) {
+    source_->PushBack(c0_);
+    c0_ = ch;
+  }
+
+  // Position of c0_ in the source.
+  int source_pos() { return source_->pos() - 1; }
+
+  RubyToken::Value Select(RubyToken::Value token) {
+    Advance();
+    return token;
+  }
+
+  // Consumes c0_ and returns 'then' if the following character is 'next',
+  // else 'otherwise'.
+  RubyToken::Value Select(uc32 next,
+                          RubyToken::Value then,
+                          RubyToken::Value otherwise) {
+    Advance();
+    if (c0_ == next) {
+      Advance();
+      return then;
+    }
+    return otherwise;
+  }
+
+  static bool IsIdentifierStart(uc32 c) {
+    return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_';
+  }
+
+  static bool IsIdentifierPart(uc32 c) {
+    return IsIdentifierStart(c) || IsDecimalDigit(c);
+  }
+
+  // Skips spaces, comments and escaped line breaks.  Returns true if
+  // anything was skipped.
+  bool SkipWhitespace();
+
+  void Scan(TokenDesc* desc);
+  RubyToken::Value ScanNumber(TokenDesc* desc);
+  RubyToken::Value ScanIdentifierOrKeyword(TokenDesc* desc);
+  RubyToken::Value ScanString(TokenDesc* desc);
+  RubyToken::Value ScanSymbol(TokenDesc* desc);
+  RubyToken::Value ScanInstanceVariable(TokenDesc* desc);
+
+  Isolate* isolate_;
+  UC16CharacterStream* source_;
+  uc32 c0_;
+
+  TokenDesc current_;
+  TokenDesc next_;
+  TokenDesc peek_ahead_;
+  bool has_peek_ahead_;
+};
+
+
+bool RubyScanner::SkipWhitespace() {
+  bool skipped = false;
+  while (true) {
+    if (c0_ == ' ' || c0_ == '\t' || c0_ == '\r' ||
+        c0_ == '\f' || c0_ == '\v') {
+      Advance();
+    } else if (c0_ == '#') {
+      while (c0_ != '\n' && c0_ != kEndOfInput) Advance();
+    } else if (c0_ == '\\') {
+      Advance();
+      if (c0_ == '\r') Advance();
+      if (c0_ != '\n') {
+        PushBack('\\');
+        return skipped;
+      }
+      Advance();
+    } else {
+      return skipped;
+    }
+    skipped = true;
+  }
+}
+
+
+void RubyScanner::Scan(TokenDesc* desc) {
+  desc->after_space = SkipWhitespace();
+  desc->number = 0;
+  desc->literal = Handle<String>::null();
+  int beg_pos = source_pos();
+  RubyToken::Value token;
+  switch (c0_) {
+    case kEndOfInput: token = RubyToken::EOS; break;
+    case '\n': token = Select(RubyToken::NEWLINE); break;
+    case '"':
+    case '\'': token = ScanString(desc); break;
+    case '(': token = Select(RubyToken::LPAREN); break;
+    case ')': token = Select(RubyToken::RPAREN); break;
+    case '[': token = Select(RubyToken::LBRACK); break;
+    case ']': token = Select(RubyToken::RBRACK); break;
+    case '{': token = Select(RubyToken::LBRACE); break;
+    case '}': token = Select(RubyToken::RBRACE); break;
+    case ',': token = Select(RubyToken::COMMA); break;
+    case '.': token = Select(RubyToken::PERIOD); break;
+    case ';': token = Select(RubyToken::SEMICOLON); break;
+    case '@':
+      Advance();
+      token = ScanInstanceVariable(desc);
+      break;
+    case '?': token = Select(RubyToken::CONDITIONAL); break;
+    case ':':
+      // ':name' is a symbol, a lone ':' belongs to a conditional.
+      Advance();
+      if (IsIdentifierStart(c0_)) {
+        token = ScanSymbol(desc);
+      } else {
+        token = RubyToken::COLON;
+      }
+      break;
+    case '=':
+      Advance();
+      if (c0_ == '=') {
+        token = Select(RubyToken::EQ);
+      } else if (c0_ == '>') {
+        token = Select(RubyToken::ARROW);
+      } else {
+        token = RubyToken::ASSIGN;
+      }
+      break;
+    case '!': token = Select('=', RubyToken::NE, RubyToken::BANG); break;
+    case '<':
+      Advance();
+      if (c0_ == '=') {
+        token = Select(RubyToken::LTE);
+      } else if (c0_ == '<') {
+        token = Select(RubyToken::SHL);
+      } else {
+        token = RubyToken::LT;
+      }
+      break;
+    case '>': token = Select('=', RubyToken::GTE, RubyToken::GT); break;
+    case '+': token = Select('=', RubyToken::ASSIGN_ADD, RubyToken::ADD); break;
+    case '-': token = Select('=', RubyToken::ASSIGN_SUB, RubyToken::SUB); break;
+    case '/': token = Select('=', RubyToken::ASSIGN_DIV, RubyToken::DIV); break;
+    case '%': token = Select('=', RubyToken::ASSIGN_MOD, RubyToken::MOD); break;
+    case '&':
+      token = Select('&', RubyToken::AND_AND, RubyToken::ILLEGAL);
+      break;
+    case '|': token = Select('|', RubyToken::OR_OR, RubyToken::PIPE); break;
+    case '*':
+      Advance();
+      if (c0_ == '*') {
+        token = Select(RubyToken::POW);
+      } else if (c0_ == '=') {
+        token = Select(RubyToken::ASSIGN_MUL);
+      } else {
+        token = RubyToken::MUL;
+      }
+      break;
+    default:
+      if (IsDecimalDigit(c0_)) {
+        token = ScanNumber(desc);
+      } else if (IsIdentifierStart(c0_)) {
+        token = ScanIdentifierOrKeyword(desc);
+      } else {
+        token = Select(RubyToken::ILLEGAL);
+      }
+      break;
+  }
+  desc->token = token;
+  desc->location = Location(beg_pos, source_pos());
+}
+
+
+RubyToken::Value RubyScanner::ScanNumber(TokenDesc* desc) {
+  // Number ::
+  //   Digits ('.' Digits)? (('e' | 'E') ('+' | '-')? Digits)?
+  // where Digits may contain '_' separators.
+  List<char> chars(16);
+  while (IsDecimalDigit(c0_) || c0_ == '_') {
+    if (c0_ != '_') chars.Add(static_cast<char>(c0_));
+    Advance();
+  }
+  if (c0_ == '.') {
+    Advance();
+    if (!IsDecimalDigit(c0_)) {
+      // A method call on an integer, as in '3.times'.
+      PushBack('.');
+    } else {
+      chars.Add('.');
+      while (IsDecimalDigit(c0_) || c0_ == '_') {
+        if (c0_ != '_') chars.Add(static_cast<char>(c0_));
+        Advance();
+      }
+    }
+  }
+  if (c0_ == 'e' || c0_ == 'E') {
+    chars.Add('e');
+    Advance();
+    if (c0_ == '+' || c0_ == '-') {
+      chars.Add(static_cast<char>(c0_));
+      Advance();
+    }
+    if (!IsDecimalDigit(c0_)) return RubyToken::ILLEGAL;
+    while (IsDecimalDigit(c0_)) {
+      chars.Add(static_cast<char>(c0_));
+      Advance();
+    }
+  }
+  if (IsIdentifierStart(c0_)) return RubyToken::ILLEGAL;
+  desc->number = StringToDouble(isolate_->unicode_cache(),
+                                chars.ToConstVector(),
+                                NO_FLAGS);
+  return RubyToken::NUMBER;
+}
+
+
+RubyToken::Value RubyScanner::ScanIdentifierOrKeyword(TokenDesc* desc) {
+  static const struct {
+    const char* text;
+    RubyToken::Value token;
+  } kKeywords[] = {
+    { "and", RubyToken::AND },
+    { "begin", RubyToken::BEGIN },
+    { "break", RubyToken::BREAK },
+    { "class", RubyToken::CLASS },
+    { "def", RubyToken::DEF },
+    { "do", RubyToken::DO },
+    { "else", RubyToken::ELSE },
+    { "elsif", RubyToken::ELSIF },
+    { "end", RubyToken::END },
+    { "ensure", RubyToken::ENSURE },
+    { "false", RubyToken::FALSE_LITERAL },
+    { "if", RubyToken::IF },
+    { "next", RubyToken::NEXT },
+    { "nil", RubyToken::NIL },
+    { "not", RubyToken::NOT },
+    { "or", RubyToken::OR },
+    { "raise", RubyToken::RAISE },
+    { "rescue", RubyToken::RESCUE },
+    { "return", RubyToken::RETURN },
+    { "self", RubyToken::SELF },
+    { "then", RubyToken::THEN },
+    { "true", RubyToken::TRUE_LITERAL },
+    { "unless", RubyToken::UNLESS },
+    { "until", RubyToken::UNTIL },
+    { "while", RubyToken::WHILE },
+    { "yield", RubyToken::YIELD }
+  };
+
+  List<char> chars(16);
+  while (IsIdentifierPart(c0_)) {
+    chars.Add(static_cast<char>(c0_));
+    Advance();
+  }
+  for (size_t i = 0; i < ARRAY_SIZE(kKeywords); i++) {
+    int length = StrLength(kKeywords[i].text);
+    if (length == chars.length() &&
+        strncmp(kKeywords[i].text, &chars[0], length) == 0) {
+      return kKeywords[i].token;
+    }
+  }
+  desc->literal = isolate_->factory()->LookupAsciiSymbol(chars.ToConstVector());
+  return ('A' <= chars[0] && chars[0] <= 'Z') ? RubyToken::CONSTANT
+                                              : RubyToken::IDENTIFIER;
+}
+
+
+RubyToken::Value RubyScanner::ScanSymbol(TokenDesc* desc) {
+  // Symbol ::
+  //   ':' IdentifierStart IdentifierPart* ('?' | '!')?
+  // The ':' has been consumed.  Keywords are allowed as names.
+  List<char> chars(16);
+  while (IsIdentifierPart(c0_)) {
+    chars.Add(static_cast<char>(c0_));
+    Advance();
+  }
+  if (c0_ == '?' || c0_ == '!') {
+    chars.Add(static_cast<char>(c0_));
+    Advance();
+  }
+  desc->literal = isolate_->factory()->LookupAsciiSymbol(chars.ToConstVector());
+  return RubyToken::SYMBOL;
+}
+
+
+RubyToken::Value RubyScanner::ScanInstanceVariable(TokenDesc* desc) {
+  // InstanceVariable ::
+  //   '@' IdentifierStart IdentifierPart*
+  // The '@' has been consumed.  The property name is the variable name
+  // with a '$' in place of the '@': it is still an identifier, so the
+  // property gets a field, and it does not collide with method names.
+  if (!IsIdentifierStart(c0_)) return RubyToken::ILLEGAL;
+  List<char> chars(16);
+  chars.Add('$');
+  while (IsIdentifierPart(c0_)) {
+    chars.Add(static_cast<char>(c0_));
+    Advance();
+  }
+  desc->literal = isolate_->factory()->LookupAsciiSymbol(chars.ToConstVector());
+  return RubyToken::INSTANCE_VARIABLE;
+}
+
+
+RubyToken::Value RubyScanner::ScanString(TokenDesc* desc) {
+  // Double quoted strings support the usual backslash escapes but not
+  // interpolation.  Single quoted strings only escape '\\' and '\''.
+  uc32 quote = c0_;
+  Advance();
+  List<uc16> chars(16);
+  while (c0_ != quote) {
+    if (c0_ == kEndOfInput) return RubyToken::ILLEGAL;
+    uc32 c = c0_;
+    Advance();
+    if (c == '\\') {
+      if (c0_ == kEndOfInput) return RubyToken::ILLEGAL;
+      c = c0_;
+      Advance();
+      if (quote == '\'') {
+        if (c != '\\' && c != '\'') chars.Add('\\');
+      } else {
+        switch (c) {
+          case '0': c = '\0'; break;
+          case 'a': c = '\a'; break;
+          case 'b': c = '\b'; break;
+          case 'e': c = 0x1b; break;
+          case 'f': c = '\f'; break;
+          case 'n': c = '\n'; break;
+          case 'r': c = '\r'; break;
+          case 's': c = ' '; break;
+          case 't': c = '\t'; break;
+          case 'v': c = '\v'; break;
+          case '\n': continue;
+        }
+      }
+    } else if (c == '#' && quote == '"' && c0_ == '{') {
+      return RubyToken::ILLEGAL;
+    }
+    chars.Add(static_cast<uc16>(c));
+  }
+  Advance();
+  desc->literal =
+      isolate_->factory()->LookupTwoByteSymbol(chars.ToConstVector());
+  return RubyToken::STRING;
+}
+
+
+// ----------------------------------------------------------------------------
+// Parser
+
+class RubyParser {
+ public:
+  explicit RubyParser(CompilationInfo* info);
+
+  FunctionLiteral* ParseProgram();
+  FunctionLiteral* ParseLazy();
+
+ private:
+  // The jumps out of a begin body, see NewJump.
+  enum Jump {
+    kReturnJump = 1,
+    kBreakJump = 2,
+    kNextJump = 4
+  };
+
+  // Per-function state: the scope, the locals declared so far (Ruby
+  // decides between a local variable read and a method call by whether
+  // an assignment to the name has been seen) and the enclosing loops.
+  // Blocks are functions that also see the locals of the enclosing ones.
+  // The parts of a begin statement are closures too, but their locals
+  // belong to the enclosing method or block.
+  class FunctionState BASE_EMBEDDED {
+   public:
+    enum Kind { METHOD, BLOCK, BEGIN_BODY };
+
+    FunctionState(RubyParser* parser, Scope* scope, Kind kind)
+        : parser_(parser),
+          outer_(parser->function_state_),
+          scope_(scope),
+          kind_(kind),
+          next_materialized_literal_index_(JSFunction::kLiteralsPrefixSize),
+          jumps_(0),
+          locals_(4),
+          loops_(4) {
+      parser->function_state_ = this;
+    }
+    ~FunctionState() { parser_->function_state_ = outer_; }
+
+    Scope* scope() const { return scope_; }
+    FunctionState* outer() const { return outer_; }
+    bool is_block() const { return kind_ == BLOCK; }
+    bool is_begin_body() const { return kind_ == BEGIN_BODY; }
+
+    // The method or block whose locals are declared here.
+    FunctionState* locals_owner() {
+      FunctionState* state = this;
+      while (state->is_begin_body()) state = state->outer_;
+      return state;
+    }
+
+    // The first slots of a function's literals array hold the global
+    // context, see JSFunction::kLiteralsPrefixSize.
+    int NextMaterializedLiteralIndex() {
+      return next_materialized_literal_index_++;
+    }
+    int materialized_literal_count() const {
+      return next_materialized_literal_index_ - JSFunction::kLiteralsPrefixSize;
+    }
+
+    bool HasLocal(Handle<String> name) const {
+      for (int i = 0; i < locals_.length(); i++) {
+        if (locals_[i].is_identical_to(name)) return true;
+      }
+      return false;
+    }
+    bool IsLocal(Handle<String> name) const {
+      return HasLocal(name) || (kind_ != METHOD && outer_->IsLocal(name));
+    }
+    void AddLocal(Handle<String> name) { locals_.Add(name); }
+
+    List<IterationStatement*>* loops() { return &loops_; }
+
+    // The Jump kinds that leave this begin body.
+    int jumps() const { return jumps_; }
+    void AddJump(Jump jump) { jumps_ |= jump; }
+
+   private:
+    RubyParser* parser_;
+    FunctionState* outer_;
+    Scope* scope_;
+    Kind kind_;
+    int next_materialized_literal_index_;
+    int jumps_;
+    List<Handle<String> > locals_;
+    List<IterationStatement*> loops_;
+  };
+
+  Isolate* isolate() const { return isolate_; }
+  Zone* zone() const { return isolate_->zone(); }
+  Factory* factory() const { return isolate_->factory(); }
+  Scope* top_scope() const { return function_state_->scope(); }
+
+  RubyToken::Value peek() const { return scanner_.peek(); }
+  RubyToken::Value Next() { return scanner_.Next(); }
+  void Expect(RubyToken::Value token, bool* ok);
+
+  static bool IsTerminator(RubyToken::Value token) {
+    return token == RubyToken::NEWLINE || token == RubyToken::SEMICOLON;
+  }
+  static bool IsBlockEnd(RubyToken::Value token) {
+    return token == RubyToken::EOS || token == RubyToken::END ||
+           token == RubyToken::ELSE || token == RubyToken::ELSIF ||
+           token == RubyToken::RESCUE || token == RubyToken::ENSURE ||
+           token == RubyToken::RBRACE;
+  }
+  void SkipNewlines() {
+    while (peek() == RubyToken::NEWLINE) Next();
+  }
+  bool StartsCommandArgument() const;
+  bool StartsBlock() const {
+    return peek() == RubyToken::LBRACE ||
+           (peek() == RubyToken::DO && do_block_allowed_);
+  }
+
+  void* ParseStatements(ZoneList<Statement*>* body, bool* ok);
+  Block* ParseBody(bool* ok);
+  Statement* ParseStatement(bool* ok);
+  Statement* ParseDefinitionStatement(bool* ok);
+  FunctionLiteral* ParseDefinition(bool* ok);
+  Statement* ParseClassStatement(bool* ok);
+  FunctionLiteral* ParseClassHeader(bool* ok);
+  Statement* ParseIfStatement(bool* ok);
+  Statement* ParseIfRest(bool negate, bool* ok);
+  Statement* ParseWhileStatement(bool* ok);
+  Statement* ParseJumpStatement(bool* ok);
+  Statement* ParseBeginStatement(bool* ok);
+  Expression* ParseBegin(int* jumps, bool* ok);
+  FunctionLiteral* ParseBeginClause(RubyToken::Value keyword,
+                                    int* jumps,
+                                    bool* ok);
+  Statement* ParseRescueClauses(bool* ok);
+  void ParseThen(RubyToken::Value keyword, bool* ok);
+
+  Expression* ParseExpression(bool* ok);
+  Expression* ParseNotExpression(bool* ok);
+  Expression* ParseAssignment(bool* ok);
+  Expression* ParseConditional(bool* ok);
+  Expression* ParseBinaryExpression(int prec, bool* ok);
+  Expression* ParseUnaryExpression(bool* ok);
+  Expression* ParsePowerExpression(bool* ok);
+  Expression* ParsePostfixExpression(bool* ok);
+  Expression* ParsePrimaryExpression(bool* ok);
+  Expression* ParseRaise(bool* ok);
+  Expression* ParseArrayLiteral(bool* ok);
+  ZoneList<Expression*>* ParseArguments(bool* ok);
+  ZoneList<Expression*>* ParseCallArguments(bool* ok);
+  FunctionLiteral* ParseBlock(bool* ok);
+  VariableProxy* NewBlockParameterProxy(int position, bool* ok);
+
+  void DeclareLocal(Handle<String> name, int position);
+  VariableProxy* NewHiddenLocal(const char* name);
+  Statement* NewJump(Jump jump, Expression* value);
+  Expression* NewBinaryOperation(RubyToken::Value op,
+                                 Expression* left,
+                                 Expression* right,
+                                 int position);
+  Expression* NewRuntimeOperation(Runtime::FunctionId id,
+                                  const char* name,
+                                  Expression* left,
+                                  Expression* right);
+  Expression* Negate(Expression* expression);
+  Literal* NewLiteral(Handle<Object> handle) {
+    return new(zone()) Literal(isolate_, handle);
+  }
+  Literal* NewNumberLiteral(double number) {
+    return NewLiteral(factory()->NewNumber(number, TENURED));
+  }
+  Statement* WithImplicitReturn(Statement* statement);
+
+  void ReportUnexpectedToken(RubyToken::Value token);
+  void ReportMessageAt(RubyScanner::Location location,
+                       const char* type,
+                       Vector<const char*> args);
+  void ReportStackOverflow();
+
+  Isolate* isolate_;
+  CompilationInfo* info_;
+  Handle<Script> script_;
+  RubyScanner scanner_;
+  FunctionState* function_state_;
+  // Whether a 'do' starts a block, which it does not in the condition of
+  // a loop and in the arguments of a call without parentheses, where the
+  // block belongs to the outer call.
+  bool do_block_allowed_;
+  // The block that a lazy compilation looks for, see ParseLazy.
+  int lazy_block_position_;
+  FunctionLiteral* lazy_block_;
+  bool has_error_;
+};
+
+
+RubyParser::RubyParser(CompilationInfo* info)
+    : isolate_(info->isolate()),
+      info_(info),
+      script_(info->script()),
+      scanner_(info->isolate()),
+      function_state_(NULL),
+      do_block_allowed_(true),
+      lazy_block_position_(RelocInfo::kNoPosition),
+      lazy_block_(NULL),
+      has_error_(false) {
+}
+
+
+FunctionLiteral* RubyParser::ParseProgram() {
+  ZoneScope zone_scope(isolate_, DONT_DELETE_ON_EXIT);
+  HistogramTimerScope timer(isolate_->counters()->parse());
+  Handle<String> source(String::cast(script_->source()));
+  isolate_->counters()->total_parse_size()->Increment(source->length());
+  source->TryFlatten();
+  GenericStringUC16CharacterStream stream(source, 0, source->length());
+  scanner_.Initialize(&stream);
+
+  ASSERT(!info_->is_eval());
+  Scope* scope = new(zone()) Scope(NULL, GLOBAL_SCOPE);
+  scope->Initialize();
+  info_->SetGlobalScope(scope);
+  scope->set_start_position(0);
+  scope->set_end_position(source->length());
+
+  FunctionLiteral* result = NULL;
+  {
+    FunctionState function_state(this, scope, FunctionState::METHOD);
+    ZoneList<Statement*>* body = new(zone()) ZoneList<Statement*>(16);
+    bool ok = true;
+    ParseStatements(body, &ok);
+    if (ok && peek() != RubyToken::EOS) {
+      ReportUnexpectedToken(Next());
+      ok = false;
+    }
+    if (ok) {
+      result = new(zone()) FunctionLiteral(
+          isolate_,
+          factory()->empty_symbol(),
+          scope,
+          body,
+          function_state.materialized_literal_count(),
+          0,
+          0,
+          false,
+          factory()->empty_fixed_array(),
+          0,
+          FunctionLiteral::ANONYMOUS_EXPRESSION,
+          false);
+    }
+  }
+
+  // If there was a syntax error we have to get rid of the AST.
+  if (result == NULL) zone_scope.DeleteOnExit();
+  return result;
+}
+
+
+FunctionLiteral* RubyParser::ParseLazy() {
+  ZoneScope zone_scope(isolate_, DONT_DELETE_ON_EXIT);
+  HistogramTimerScope timer(isolate_->counters()->parse_lazy());
+  Handle<String> source(String::cast(script_->source()));
+  isolate_->counters()->total_parse_size()->Increment(source->length());
+  source->TryFlatten();
+
+  // Method definitions, class constructors and blocks are compiled
+  // lazily, so the range of the shared function info starts at 'def' and
+  // ends after 'end', covers the 'class' Constant header, starts at the
+  // '{' or 'do' of a block, or at the 'begin', 'rescue' or 'ensure' of a
+  // part of a begin statement.
+  Handle<SharedFunctionInfo> shared_info = info_->shared_info();
+  GenericStringUC16CharacterStream stream(source,
+                                          shared_info->start_position(),
+                                          shared_info->end_position());
+  scanner_.Initialize(&stream);
+
+  Scope* scope = new(zone()) Scope(NULL, GLOBAL_SCOPE);
+  scope->Initialize();
+  info_->SetGlobalScope(scope);
+
+  FunctionLiteral* result = NULL;
+  if (peek() == RubyToken::LBRACE || peek() == RubyToken::DO ||
+      peek() == RubyToken::BEGIN || peek() == RubyToken::RESCUE ||
+      peek() == RubyToken::ENSURE) {
+    // Parsed alone, a block would take the locals of the enclosing method
+    // for method calls.  The whole script is parsed again instead, as for
+    // the first compilation, and the block is picked by its position.
+    GenericStringUC16CharacterStream script_stream(source,
+                                                   0,
+                                                   source->length());
+    scanner_.Initialize(&script_stream);
+    lazy_block_position_ = shared_info->start_position();
+    FunctionState function_state(this, scope, FunctionState::METHOD);
+    ZoneList<Statement*>* body = new(zone()) ZoneList<Statement*>(16);
+    bool ok = true;
+    ParseStatements(body, &ok);
+    ASSERT(ok || has_error_);
+    ASSERT(!ok || lazy_block_ != NULL);
+    if (ok) result = lazy_block_;
+  } else {
+    if (!info_->closure().is_null()) {
+      scope = Scope::DeserializeScopeChain(info_->closure()->context(),
+                                           scope);
+    }
+    FunctionState function_state(this, scope, FunctionState::METHOD);
+    bool ok = true;
+    if (peek() == RubyToken::CLASS) {
+      result = ParseClassHeader(&ok);
+    } else {
+      result = ParseDefinition(&ok);
+    }
+    ASSERT(ok || has_error_);
+    if (!ok) result = NULL;
+  }
+
+  if (result == NULL) zone_scope.DeleteOnExit();
+  return result;
+}
+
+
+#define CHECK_OK  ok);   \
+  if (!*ok) return NULL; \
+  ((void)0
+#define DUMMY )  // to make indentation work
+#undef DUMMY
+
+
+void RubyParser::Expect(RubyToken::Value token, bool* ok) {
+  RubyToken::Value next = Next();
+  if (next == token) return;
+  ReportUnexpectedToken(next);
+  *ok = false;
+}
+
+
+bool RubyParser::StartsCommandArgument() const {
+  // A name followed by one of these tokens on the same line is a call
+  // without parentheses, as in 'puts x'.
+  switch (peek()) {
+    case RubyToken::NUMBER:
+    case RubyToken::STRING:
+    case RubyToken::SYMBOL:
+    case RubyToken::IDENTIFIER:
+    case RubyToken::CONSTANT:
+    case RubyToken::INSTANCE_VARIABLE:
+    case RubyToken::NIL:
+    case RubyToken::TRUE_LITERAL:
+    case RubyToken::FALSE_LITERAL:
+    case RubyToken::SELF:
+    case RubyToken::YIELD:
+    case RubyToken::BANG:
+      return true;
+    case RubyToken::LBRACK:
+      return scanner_.peek_after_space();
+    default:
+      return false;
+  }
+}
+
+
+void* RubyParser::ParseStatements(ZoneList<Statement*>* body, bool* ok) {
+  // Statements ::
+  //   (Statement? (NEWLINE | ';'))* Statement?
+  while (true) {
+    while (IsTerminator(peek())) Next();
+    if (IsBlockEnd(peek())) return NULL;
+    Statement* statement = ParseStatement(CHECK_OK);
+    body->Add(statement);
+    if (!IsTerminator(peek()) && !IsBlockEnd(peek())) {
+      ReportUnexpectedToken(Next());
+      *ok = false;
+      return NULL;
+    }
+  }
+}
+
+
+Block* RubyParser::ParseBody(bool* ok) {
+  ZoneList<Statement*>* statements = new(zone()) ZoneList<Statement*>(4);
+  ParseStatements(statements, CHECK_OK);
+  Block* block =
+      new(zone()) Block(isolate_, NULL, statements->length(), false);
+  for (int i = 0; i < statements->length(); i++) {
+    block->AddStatement(statements->at(i));
+  }
+  return block;
+}
+
+
+Statement* RubyParser::ParseStatement(bool* ok) {
+  // Statement ::
+  //   (Definition | ClassStatement | IfStatement | WhileStatement |
+  //    JumpStatement | BeginStatement | Expression) Modifier*
+  // Modifier ::
+  //   ('if' | 'unless' | 'while' | 'until') Expression
+  StackLimitCheck check(isolate_);
+  if (check.HasOverflowed()) {
+    ReportStackOverflow();
+    *ok = false;
+    return NULL;
+  }
+
+  int statement_pos = scanner_.peek_location().beg_pos;
+  Statement* result = NULL;
+  switch (peek()) {
+    case RubyToken::DEF:
+      result = ParseDefinitionStatement(CHECK_OK);
+      break;
+    case RubyToken::CLASS:
+      result = ParseClassStatement(CHECK_OK);
+      break;
+    case RubyToken::IF:
+    case RubyToken::UNLESS:
+      result = ParseIfStatement(CHECK_OK);
+      break;
+    case RubyToken::WHILE:
+    case RubyToken::UNTIL:
+      result = ParseWhileStatement(CHECK_OK);
+      break;
+    case RubyToken::RETURN:
+    case RubyToken::BREAK:
+    case RubyToken::NEXT:
+      result = ParseJumpStatement(CHECK_OK);
+      break;
+    case RubyToken::BEGIN:
+      result = ParseBeginStatement(CHECK_OK);
+      break;
+    default: {
+      Expression* expression = ParseExpression(CHECK_OK);
+      result = new(zone()) ExpressionStatement(expression);
+      break;
+    }
+  }
+  result->set_statement_pos(statement_pos);
+
+  while (true) {
+    RubyToken::Value modifier = peek();
+    if (modifier == RubyToken::IF || modifier == RubyToken::UNLESS) {
+      Next();
+      Expression* condition = ParseExpression(CHECK_OK);
+      if (modifier == RubyToken::UNLESS) condition = Negate(condition);
+      result = new(zone()) IfStatement(
+          isolate_, condition, result, new(zone()) EmptyStatement());
+    } else if (modifier == RubyToken::WHILE ||
+               modifier == RubyToken::UNTIL) {
+      Next();
+      Expression* condition = ParseExpression(CHECK_OK);
+      if (modifier == RubyToken::UNTIL) condition = Negate(condition);
+      WhileStatement* loop = new(zone()) WhileStatement(isolate_, NULL);
+      loop->Initialize(condition, result);
+      result = loop;
+    } else {
+      return result;
+    }
+    result->set_statement_pos(statement_pos);
+  }
+}
+
+
+Statement* RubyParser::ParseDefinitionStatement(bool* ok) {
+  // Methods are only defined at the top level, where they become global
+  // functions declared on entry like JavaScript function declarations.
+  if (!top_scope()->is_global_scope()) {
+    ReportUnexpectedToken(Next());
+    *ok = false;
+    return NULL;
+  }
+  FunctionLiteral* function = ParseDefinition(CHECK_OK);
+  VariableProxy* proxy = top_scope()->NewUnresolved(
+      function->name(), function->function_token_position());
+  top_scope()->AddDeclaration(
+      new(zone()) Declaration(proxy, VAR, function, top_scope()));
+  return new(zone()) EmptyStatement();
+}
+
+
+FunctionLiteral* RubyParser::ParseDefinition(bool* ok) {
+  // Definition ::
+  //   'def' Identifier ('(' Parameters? ')' | Parameters?) Statements 'end'
+  // Parameters ::
+  //   Identifier (',' Identifier)*
+  Expect(RubyToken::DEF, CHECK_OK);
+  int function_token_position = scanner_.location().beg_pos;
+  Expect(RubyToken::IDENTIFIER, CHECK_OK);
+  Handle<String> name = scanner_.literal();
+
+  Scope* scope = new(zone()) Scope(top_scope(), FUNCTION_SCOPE);
+  scope->Initialize();
+  scope->SetScopeName(name);
+  scope->set_start_position(function_token_position);
+
+  ZoneList<Statement*>* body = new(zone()) ZoneList<Statement*>(8);
+  int materialized_literal_count;
+  {
+    FunctionState function_state(this, scope, FunctionState::METHOD);
+    bool parenthesized = peek() == RubyToken::LPAREN;
+    if (parenthesized) Next();
+    RubyToken::Value close =
+        parenthesized ? RubyToken::RPAREN : RubyToken::NEWLINE;
+    bool done = peek() == close || peek() == RubyToken::SEMICOLON;
+    while (!done) {
+      Expect(RubyToken::IDENTIFIER, CHECK_OK);
+      Handle<String> parameter = scanner_.literal();
+      if (function_state.IsLocal(parameter)) {
+        ReportUnexpectedToken(RubyToken::IDENTIFIER);
+        *ok = false;
+        return NULL;
+      }
+      scope->DeclareParameter(parameter, VAR);
+      function_state.AddLocal(parameter);
+      done = peek() == close || peek() == RubyToken::SEMICOLON;
+      if (!done) Expect(RubyToken::COMMA, CHECK_OK);
+    }
+    if (parenthesized) Expect(RubyToken::RPAREN, CHECK_OK);
+
+    ParseStatements(body, CHECK_OK);
+    Expect(RubyToken::END, CHECK_OK);
+    scope->set_end_position(scanner_.location().end_pos);
+    materialized_literal_count = function_state.materialized_literal_count();
+  }
+
+  // A method returns the value of its last statement.
+  if (!body->is_empty()) {
+    int last = body->length() - 1;
+    (*body)[last] = WithImplicitReturn(body->at(last));
+  }
+
+  FunctionLiteral* function = new(zone()) FunctionLiteral(
+      isolate_,
+      name,
+      scope,
+      body,
+      materialized_literal_count,
+      0,
+      0,
+      false,
+      factory()->empty_fixed_array(),
+      scope->num_parameters(),
+      FunctionLiteral::DECLARATION,
+      false);
+  function->set_function_token_position(function_token_position);
+  return function;
+}
+
+
+Statement* RubyParser::ParseClassStatement(bool* ok) {
+  // ClassStatement ::
+  //   'class' Constant ('<' Expression)? (Definition | NEWLINE | ';')* 'end'
+  // A class is a constructor function in a global of the same name, and
+  // its methods live on the constructor's prototype.  Only the first
+  // class statement for a name creates the class; later ones reopen it.
+  // Methods are defined with %DefineMethod, so redefining one does not
+  // turn it into a field of the prototype.
+  if (!top_scope()->is_global_scope()) {
+    ReportUnexpectedToken(Next());
+    *ok = false;
+    return NULL;
+  }
+  FunctionLiteral* constructor = ParseClassHeader(CHECK_OK);
+  Handle<String> name = constructor->name();
+  int position = constructor->function_token_position();
+  DeclareLocal(name, position);
+
+  Block* create = new(zone()) Block(isolate_, NULL, 2, false);
+  create->AddStatement(new(zone()) ExpressionStatement(
+      new(zone()) Assignment(isolate_,
+                             Token::ASSIGN,
+                             top_scope()->NewUnresolved(name, position),
+                             constructor,
+                             position)));
+  if (peek() == RubyToken::LT) {
+    Next();
+    Expression* superclass = ParseExpression(CHECK_OK);
+    Expression* prototype = new(zone()) Property(
+        isolate_,
+        top_scope()->NewUnresolved(name, position),
+        NewLiteral(factory()->prototype_symbol()),
+        position);
+    Expression* proto = new(zone()) Property(
+        isolate_, prototype, NewLiteral(factory()->Proto_symbol()), position);
+    Expression* super_prototype = new(zone()) Property(
+        isolate_,
+        superclass,
+        NewLiteral(factory()->prototype_symbol()),
+        position);
+    create->AddStatement(new(zone()) ExpressionStatement(
+        new(zone()) Assignment(
+            isolate_, Token::ASSIGN, proto, super_prototype, position)));
+  }
+
+  Block* result = new(zone()) Block(isolate_, NULL, 4, false);
+  Expression* is_new = new(zone()) CompareOperation(
+      isolate_,
+      Token::EQ_STRICT,
+      top_scope()->NewUnresolved(name, position),
+      NewLiteral(factory()->undefined_value()),
+      position);
+  result->AddStatement(new(zone()) IfStatement(
+      isolate_, is_new, create, new(zone()) EmptyStatement()));
+
+  while (true) {
+    while (IsTerminator(peek())) Next();
+    if (peek() == RubyToken::END) break;
+    if (peek() != RubyToken::DEF) {
+      ReportUnexpectedToken(Next());
+      *ok = false;
+      return NULL;
+    }
+    FunctionLiteral* method = ParseDefinition(CHECK_OK);
+    // Pretenured closures can be constant functions of the prototype.
+    method->set_pretenure();
+    ZoneList<Expression*>* arguments = new(zone()) ZoneList<Expression*>(3);
+    arguments->Add(new(zone()) Property(
+        isolate_,
+        top_scope()->NewUnresolved(name, position),
+        NewLiteral(factory()->prototype_symbol()),
+        method->function_token_position()));
+    arguments->Add(NewLiteral(method->name()));
+    arguments->Add(method);
+    CallRuntime* define = new(zone()) CallRuntime(
+        isolate_,
+        factory()->LookupAsciiSymbol("DefineMethod"),
+        Runtime::FunctionForId(Runtime::kDefineMethod),
+        arguments);
+    result->AddStatement(new(zone()) ExpressionStatement(define));
+  }
+  Expect(RubyToken::END, CHECK_OK);
+  return result;
+}
+
+
+FunctionLiteral* RubyParser::ParseClassHeader(bool* ok) {
+  // ClassHeader ::
+  //   'class' Constant
+  // The constructor is built from the header alone, which is also the
+  // range that is parsed again when the constructor is compiled.  It
+  // passes its arguments on to the 'initialize' method, if there is one:
+  //   if (this.initialize !== undefined)
+  //     this.initialize.apply(this, arguments);
+  Expect(RubyToken::CLASS, CHECK_OK);
+  int position = scanner_.location().beg_pos;
+  Expect(RubyToken::CONSTANT, CHECK_OK);
+  Handle<String> name = scanner_.literal();
+  Handle<String> initialize = factory()->LookupAsciiSymbol("initialize");
+
+  Scope* scope = new(zone()) Scope(top_scope(), FUNCTION_SCOPE);
+  scope->Initialize();
+  scope->SetScopeName(name);
+  scope->set_start_position(position);
+  scope->set_end_position(scanner_.location().end_pos);
+
+  ZoneList<Statement*>* body = new(zone()) ZoneList<Statement*>(1);
+  {
+    FunctionState function_state(this, scope, FunctionState::METHOD);
+    Expression* method = new(zone()) Property(
+        isolate_,
+        new(zone()) VariableProxy(isolate_, scope->receiver()),
+        NewLiteral(initialize),
+        position);
+    Expression* has_initialize = Negate(new(zone()) CompareOperation(
+        isolate_,
+        Token::EQ_STRICT,
+        method,
+        NewLiteral(factory()->undefined_value()),
+        position));
+    Expression* apply = new(zone()) Property(
+        isolate_,
+        new(zone()) Property(
+            isolate_,
+            new(zone()) VariableProxy(isolate_, scope->receiver()),
+            NewLiteral(initialize),
+            position),
+        NewLiteral(factory()->apply_symbol()),
+        position);
+    ZoneList<Expression*>* arguments = new(zone()) ZoneList<Expression*>(2);
+    arguments->Add(new(zone()) VariableProxy(isolate_, scope->receiver()));
+    arguments->Add(scope->NewUnresolved(factory()->arguments_symbol(),
+                                        position));
+    Statement* call = new(zone()) ExpressionStatement(
+        new(zone()) Call(isolate_, apply, arguments, position));
+    body->Add(new(zone()) IfStatement(
+        isolate_, has_initialize, call, new(zone()) EmptyStatement()));
+  }
+
+  FunctionLiteral* function = new(zone()) FunctionLiteral(
+      isolate_,
+      name,
+      scope,
+      body,
+      0,
+      0,
+      0,
+      false,
+      factory()->empty_fixed_array(),
+      0,
+      FunctionLiteral::DECLARATION,
+      false);
+  function->set_function_token_position(position);
+  return function;
+}
+
+
+Statement* RubyParser::ParseIfStatement(bool* ok) {
+  // IfStatement ::
+  //   'if' Expression Then Statements
+  //       ('elsif' Expression Then Statements)* ('else' Statements)? 'end'
+  //   'unless' Expression Then Statements ('else' Statements)? 'end'
+  bool negate = Next() == RubyToken::UNLESS;
+  Statement* result = ParseIfRest(negate, CHECK_OK);
+  Expect(RubyToken::END, CHECK_OK);
+  return result;
+}
+
+
+Statement* RubyParser::ParseIfRest(bool negate, bool* ok) {
+  int position = scanner_.location().beg_pos;
+  Expression* condition = ParseExpression(CHECK_OK);
+  if (negate) condition = Negate(condition);
+  ParseThen(RubyToken::THEN, CHECK_OK);
+  Statement* then_statement = ParseBody(CHECK_OK);
+  Statement* else_statement = NULL;
+  if (!negate && peek() == RubyToken::ELSIF) {
+    Next();
+    else_statement = ParseIfRest(false, CHECK_OK);
+  } else if (peek() == RubyToken::ELSE) {
+    Next();
+    else_statement = ParseBody(CHECK_OK);
+  } else {
+    else_statement = new(zone()) EmptyStatement();
+  }
+  IfStatement* result = new(zone()) IfStatement(
+      isolate_, condition, then_statement, else_statement);
+  result->set_statement_pos(position);
+  return result;
+}
+
+
+Statement* RubyParser::ParseWhileStatement(bool* ok) {
+  // WhileStatement ::
+  //   ('while' | 'until') Expression ('do' | NEWLINE | ';') Statements 'end'
+  bool negate = Next() == RubyToken::UNTIL;
+  bool do_block_allowed = do_block_allowed_;
+  do_block_allowed_ = false;
+  Expression* condition = ParseExpression(CHECK_OK);
+  do_block_allowed_ = do_block_allowed;
+  if (negate) condition = Negate(condition);
+  ParseThen(RubyToken::DO, CHECK_OK);
+
+  WhileStatement* loop = new(zone()) WhileStatement(isolate_, NULL);
+  function_state_->loops()->Add(loop);
+  Statement* body = ParseBody(ok);
+  function_state_->loops()->RemoveLast();
+  if (!*ok) return NULL;
+  Expect(RubyToken::END, CHECK_OK);
+  loop->Initialize(condition, body);
+  return loop;
+}
+
+
+Statement* RubyParser::ParseJumpStatement(bool* ok) {
+  // JumpStatement ::
+  //   'return' Expression?
+  //   'break'
+  //   'next' Expression?
+  // Outside of a loop, 'next' returns from a block.  Returning from the
+  // enclosing method and breaking out of the call a block is passed to
+  // are not supported.  The jumps see through begin bodies, which NewJump
+  // leaves first.
+  RubyToken::Value token = Next();
+  FunctionState* function = function_state_->locals_owner();
+  FunctionState* loop_state = function_state_;
+  while (loop_state->is_begin_body() && loop_state->loops()->is_empty()) {
+    loop_state = loop_state->outer();
+  }
+  List<IterationStatement*>* loops = loop_state->loops();
+  bool next_from_block = token == RubyToken::NEXT &&
+      loops->is_empty() && function->is_block();
+  if (token == RubyToken::RETURN || next_from_block) {
+    if (function->scope()->is_global_scope() ||
+        (token == RubyToken::RETURN && function->is_block())) {
+      ReportMessageAt(scanner_.location(), "illegal_return",
+                      Vector<const char*>::empty());
+      *ok = false;
+      return NULL;
+    }
+    RubyToken::Value next = peek();
+    Expression* value = NULL;
+    if (IsTerminator(next) || IsBlockEnd(next) ||
+        next == RubyToken::IF || next == RubyToken::UNLESS ||
+        next == RubyToken::WHILE || next == RubyToken::UNTIL) {
+      value = NewLiteral(factory()->undefined_value());
+    } else {
+      value = ParseExpression(CHECK_OK);
+    }
+    return NewJump(kReturnJump, value);
+  }
+
+  if (loops->is_empty()) {
+    const char* message =
+        token == RubyToken::BREAK ? "illegal_break" : "illegal_continue";
+    ReportMessageAt(scanner_.location(), message,
+                    Vector<const char*>::empty());
+    *ok = false;
+    return NULL;
+  }
+  return NewJump(token == RubyToken::BREAK ? kBreakJump : kNextJump, NULL);
+}
+
+
+Statement* RubyParser::ParseBeginStatement(bool* ok) {
+  // BeginStatement ::
+  //   Begin
+  // A jump out of the begin statement leaves its closures by returning
+  // from them, see NewJump.  The statement then jumps by the '.jump'
+  // variable and has the value of RubyBegin in '.begin'.
+  int jumps = 0;
+  Expression* begin = ParseBegin(&jumps, CHECK_OK);
+  if (jumps == 0) return new(zone()) ExpressionStatement(begin);
+
+  Block* result = new(zone()) Block(isolate_, NULL, 4, false);
+  result->AddStatement(new(zone()) ExpressionStatement(
+      new(zone()) Assignment(isolate_,
+                             Token::ASSIGN,
+                             NewHiddenLocal(".jump"),
+                             NewNumberLiteral(0),
+                             RelocInfo::kNoPosition)));
+  result->AddStatement(new(zone()) ExpressionStatement(
+      new(zone()) Assignment(isolate_,
+                             Token::ASSIGN,
+                             NewHiddenLocal(".begin"),
+                             begin,
+                             RelocInfo::kNoPosition)));
+  static const Jump kJumps[] = { kReturnJump, kBreakJump, kNextJump };
+  for (size_t i = 0; i < ARRAY_SIZE(kJumps); i++) {
+    if ((jumps & kJumps[i]) == 0) continue;
+    Expression* condition = new(zone()) CompareOperation(
+        isolate_,
+        Token::EQ_STRICT,
+        NewHiddenLocal(".jump"),
+        NewNumberLiteral(kJumps[i]),
+        RelocInfo::kNoPosition);
+    result->AddStatement(new(zone()) IfStatement(
+        isolate_,
+        condition,
+        NewJump(kJumps[i], NewHiddenLocal(".begin")),
+        new(zone()) EmptyStatement()));
+  }
+  // The value of the statement, for an implicit return.
+  result->AddStatement(
+      new(zone()) ExpressionStatement(NewHiddenLocal(".begin")));
+  return result;
+}
+
+
+Expression* RubyParser::ParseBegin(int* jumps, bool* ok) {
+  // Begin ::
+  //   'begin' Statements ('rescue' RescueClauses)? ('ensure' Statements)?
+  //       'end'
+  // The body and the clauses become closures, which the RubyBegin native
+  // calls inside a try statement.  Crankshaft does not optimize functions
+  // with try statements, but it does optimize the methods calling
+  // RubyBegin.  The Jump kinds that leave the closures are added to jumps.
+  Expect(RubyToken::BEGIN, CHECK_OK);
+  ZoneList<Expression*>* arguments = new(zone()) ZoneList<Expression*>(4);
+  arguments->Add(new(zone()) VariableProxy(isolate_, top_scope()->receiver()));
+  FunctionLiteral* body = ParseBeginClause(RubyToken::BEGIN, jumps, CHECK_OK);
+  arguments->Add(body);
+  if (peek() == RubyToken::RESCUE) {
+    Next();
+    FunctionLiteral* rescue =
+        ParseBeginClause(RubyToken::RESCUE, jumps, CHECK_OK);
+    arguments->Add(rescue);
+  } else {
+    arguments->Add(NewLiteral(factory()->undefined_value()));
+  }
+  if (peek() == RubyToken::ENSURE) {
+    Next();
+    FunctionLiteral* ensure =
+        ParseBeginClause(RubyToken::ENSURE, jumps, CHECK_OK);
+    arguments->Add(ensure);
+  } else {
+    arguments->Add(NewLiteral(factory()->undefined_value()));
+  }
+  Expect(RubyToken::END, CHECK_OK);
+  return new(zone()) CallRuntime(isolate_,
+                                 factory()->LookupAsciiSymbol("RubyBegin"),
+                                 NULL,
+                                 arguments);
+}
+
+
+FunctionLiteral* RubyParser::ParseBeginClause(RubyToken::Value keyword,
+                                              int* jumps,
+                                              bool* ok) {
+  // Parses the part of a begin statement after keyword into a closure,
+  // which is picked by the position of keyword when it is compiled, like
+  // a block.  The rescue closure takes the exception as its parameter.
+  int position = scanner_.location().beg_pos;
+  Scope* scope = new(zone()) Scope(top_scope(), FUNCTION_SCOPE);
+  scope->Initialize();
+  scope->set_start_position(position);
+
+  ZoneList<Statement*>* body = new(zone()) ZoneList<Statement*>(4);
+  int materialized_literal_count;
+  bool do_block_allowed = do_block_allowed_;
+  do_block_allowed_ = true;
+  {
+    FunctionState function_state(this, scope, FunctionState::BEGIN_BODY);
+    if (keyword == RubyToken::RESCUE) {
+      Handle<String> exception = factory()->LookupAsciiSymbol(".exception");
+      scope->DeclareParameter(exception, VAR);
+      function_state.AddLocal(exception);
+      Statement* clauses = ParseRescueClauses(CHECK_OK);
+      body->Add(clauses);
+    } else {
+      ParseStatements(body, CHECK_OK);
+    }
+    scope->set_end_position(scanner_.location().end_pos);
+    materialized_literal_count = function_state.materialized_literal_count();
+    *jumps |= function_state.jumps();
+  }
+  do_block_allowed_ = do_block_allowed;
+
+  // The value of the ensure clause is dropped.
+  if (keyword != RubyToken::ENSURE && !body->is_empty()) {
+    int last = body->length() - 1;
+    (*body)[last] = WithImplicitReturn(body->at(last));
+  }
+
+  FunctionLiteral* result = new(zone()) FunctionLiteral(
+      isolate_,
+      factory()->empty_symbol(),
+      scope,
+      body,
+      materialized_literal_count,
+      0,
+      0,
+      false,
+      factory()->empty_fixed_array(),
+      scope->num_parameters(),
+      FunctionLiteral::ANONYMOUS_EXPRESSION,
+      false);
+  result->set_function_token_position(position);
+  if (position == lazy_block_position_) lazy_block_ = result;
+  return result;
+}
+
+
+Statement* RubyParser::ParseRescueClauses(bool* ok) {
+  // RescueClauses ::
+  //   RescueClause ('rescue' RescueClause)*
+  // RescueClause ::
+  //   (PostfixExpression (',' PostfixExpression)*)? ('=>' Identifier)?
+  //       Then Statements
+  // The first 'rescue' has been consumed.  A clause without classes
+  // rescues every exception.  An exception that no clause rescues is
+  // thrown again.
+  Handle<String> exception = factory()->LookupAsciiSymbol(".exception");
+  ZoneList<Expression*> conditions(4);
+  ZoneList<Statement*> clauses(4);
+  while (true) {
+    int position = scanner_.location().beg_pos;
+    Expression* condition = NULL;
+    if (!IsTerminator(peek()) && peek() != RubyToken::THEN &&
+        peek() != RubyToken::ARROW) {
+      while (true) {
+        Expression* klass = ParsePostfixExpression(CHECK_OK);
+        Expression* test = new(zone()) CompareOperation(
+            isolate_,
+            Token::INSTANCEOF,
+            top_scope()->NewUnresolved(exception, position),
+            klass,
+            position);
+        condition = condition == NULL ? test : new(zone()) BinaryOperation(
+            isolate_, Token::OR, condition, test, position);
+        if (peek() != RubyToken::COMMA) break;
+        Next();
+      }
+    }
+    Block* clause = new(zone()) Block(isolate_, NULL, 4, false);
+    if (peek() == RubyToken::ARROW) {
+      Next();
+      Expect(RubyToken::IDENTIFIER, CHECK_OK);
+      Handle<String> name = scanner_.literal();
+      int name_position = scanner_.location().beg_pos;
+      DeclareLocal(name, name_position);
+      clause->AddStatement(new(zone()) ExpressionStatement(
+          new(zone()) Assignment(
+              isolate_,
+              Token::ASSIGN,
+              top_scope()->NewUnresolved(name, name_position),
+              top_scope()->NewUnresolved(exception, name_position),
+              name_position)));
+    }
+    ParseThen(RubyToken::THEN, CHECK_OK);
+    ParseStatements(clause->statements(), CHECK_OK);
+    conditions.Add(condition);
+    clauses.Add(clause);
+    if (peek() != RubyToken::RESCUE) break;
+    Next();
+  }
+
+  Statement* result = new(zone()) ExpressionStatement(
+      new(zone()) Throw(isolate_,
+                        top_scope()->NewUnresolved(exception,
+                                                   RelocInfo::kNoPosition),
+                        RelocInfo::kNoPosition));
+  for (int i = clauses.length() - 1; i >= 0; i--) {
+    if (conditions[i] == NULL) {
+      result = clauses[i];
+    } else {
+      result = new(zone()) IfStatement(
+          isolate_, conditions[i], clauses[i], result);
+    }
+  }
+  return result;
+}
+
+
+void RubyParser::ParseThen(RubyToken::Value keyword, bool* ok) {
+  // Then ::
+  //   keyword | NEWLINE | ';'
+  if (peek() == keyword) {
+    Next();
+  } else if (!IsTerminator(peek())) {
+    ReportUnexpectedToken(Next());
+    *ok = false;
+  }
+}
+
+
+Expression* RubyParser::ParseExpression(bool* ok) {
+  // Expression ::
+  //   NotExpression (('and' | 'or') NotExpression)*
+  Expression* result = ParseNotExpression(CHECK_OK);
+  while (peek() == RubyToken::AND || peek() == RubyToken::OR) {
+    Token::Value op = Next() == RubyToken::AND ? Token::AND : Token::OR;
+    int position = scanner_.location().beg_pos;
+    SkipNewlines();
+    Expression* right = ParseNotExpression(CHECK_OK);
+    result = new(zone()) BinaryOperation(isolate_, op, result, right, position);
+  }
+  return result;
+}
+
+
+Expression* RubyParser::ParseNotExpression(bool* ok) {
+  // NotExpression ::
+  //   'not' NotExpression
+  //   Assignment
+  if (peek() != RubyToken::NOT) return ParseAssignment(ok);
+  Next();
+  Expression* expression = ParseNotExpression(CHECK_OK);
+  return Negate(expression);
+}
+
+
+Expression* RubyParser::ParseAssignment(bool* ok) {
+  // Assignment ::
+  //   Identifier AssignmentOperator Assignment
+  //   PostfixExpression AssignmentOperator Assignment
+  //   Conditional
+  if ((peek() == RubyToken::IDENTIFIER || peek() == RubyToken::CONSTANT) &&
+      RubyToken::IsAssignmentOp(scanner_.PeekAhead())) {
+    Next();
+    Handle<String> name = scanner_.literal();
+    int name_position = scanner_.location().beg_pos;
+    Token::Value op = Token::ASSIGN;
+    switch (Next()) {
+      case RubyToken::ASSIGN_ADD: op = Token::ASSIGN_ADD; break;
+      case RubyToken::ASSIGN_SUB: op = Token::ASSIGN_SUB; break;
+      case RubyToken::ASSIGN_MUL: op = Token::ASSIGN_MUL; break;
+      case RubyToken::ASSIGN_DIV: op = Token::ASSIGN_DIV; break;
+      case RubyToken::ASSIGN_MOD: op = Token::ASSIGN_MOD; break;
+      default: break;
+    }
+    int position = scanner_.location().beg_pos;
+    // The variable is in scope in its own initializer, as in Ruby.
+    DeclareLocal(name, name_position);
+    SkipNewlines();
+    Expression* value = ParseAssignment(CHECK_OK);
+    // Integer arithmetic needs the exact operators, so 'a += b' becomes
+    // 'a = a + b' rather than a JavaScript compound assignment.
+    RubyToken::Value binary_op = RubyToken::ILLEGAL;
+    if (op == Token::ASSIGN_ADD) binary_op = RubyToken::ADD;
+    if (op == Token::ASSIGN_SUB) binary_op = RubyToken::SUB;
+    if (op == Token::ASSIGN_MUL) binary_op = RubyToken::MUL;
+    if (binary_op != RubyToken::ILLEGAL) {
+      VariableProxy* current = top_scope()->NewUnresolved(name, name_position);
+      value = NewBinaryOperation(binary_op, current, value, position);
+      op = Token::ASSIGN;
+    }
+    VariableProxy* target = top_scope()->NewUnresolved(name, name_position);
+    return new(zone()) Assignment(isolate_, op, target, value, position);
+  }
+
+  Expression* expression = ParseConditional(CHECK_OK);
+  if (!RubyToken::IsAssignmentOp(peek())) return expression;
+
+  // Attribute and element assignment, as in 'a.b = c' and 'a[b] = c'.
+  RubyToken::Value token = Next();
+  if (expression->AsProperty() == NULL) {
+    ReportUnexpectedToken(token);
+    *ok = false;
+    return NULL;
+  }
+  Token::Value op = Token::ASSIGN;
+  switch (token) {
+    case RubyToken::ASSIGN_ADD: op = Token::ASSIGN_ADD; break;
+    case RubyToken::ASSIGN_SUB: op = Token::ASSIGN_SUB; break;
+    case RubyToken::ASSIGN_MUL: op = Token::ASSIGN_MUL; break;
+    case RubyToken::ASSIGN_DIV: op = Token::ASSIGN_DIV; break;
+    case RubyToken::ASSIGN_MOD: op = Token::ASSIGN_MOD; break;
+    default: break;
+  }
+  int position = scanner_.location().beg_pos;
+  SkipNewlines();
+  Expression* value = ParseAssignment(CHECK_OK);
+  return new(zone()) Assignment(isolate_, op, expression, value, position);
+}
+
+
+Expression* RubyParser::ParseConditional(bool* ok) {
+  // Conditional ::
+  //   BinaryExpression
+  //   BinaryExpression '?' Assignment ':' Assignment
+  Expression* expression = ParseBinaryExpression(1, CHECK_OK);
+  if (peek() != RubyToken::CONDITIONAL) return expression;
+  Next();
+  SkipNewlines();
+  int left_position = scanner_.peek_location().beg_pos;
+  Expression* left = ParseAssignment(CHECK_OK);
+  SkipNewlines();
+  Expect(RubyToken::COLON, CHECK_OK);
+  SkipNewlines();
+  int right_position = scanner_.peek_location().beg_pos;
+  Expression* right = ParseAssignment(CHECK_OK);
+  return new(zone()) Conditional(
+      isolate_, expression, left, right, left_position, right_position);
+}
+
+
+Expression* RubyParser::ParseBinaryExpression(int prec, bool* ok) {
+  ASSERT(prec >= 1);
+  Expression* x = ParseUnaryExpression(CHECK_OK);
+  for (int prec1 = RubyToken::Precedence(peek()); prec1 >= prec; prec1--) {
+    // prec1 >= 1 here.
+    while (RubyToken::Precedence(peek()) == prec1) {
+      RubyToken::Value op = Next();
+      int position = scanner_.location().beg_pos;
+      SkipNewlines();
+      Expression* y = ParseBinaryExpression(prec1 + 1, CHECK_OK);
+      x = NewBinaryOperation(op, x, y, position);
+    }
+  }
+  return x;
+}
+
+
+Expression* RubyParser::ParseUnaryExpression(bool* ok) {
+  // UnaryExpression ::
+  //   PowerExpression
+  //   ('-' | '+' | '!') UnaryExpression
+  RubyToken::Value op = peek();
+  if (op != RubyToken::SUB && op != RubyToken::ADD && op != RubyToken::BANG) {
+    return ParsePowerExpression(ok);
+  }
+
+  StackLimitCheck check(isolate_);
+  if (check.HasOverflowed()) {
+    ReportStackOverflow();
+    *ok = false;
+    return NULL;
+  }
+
+  Next();
+  int position = scanner_.location().beg_pos;
+  Expression* expression = ParseUnaryExpression(CHECK_OK);
+  if (op == RubyToken::BANG) return Negate(expression);
+
+  // Fold negative and positive numeric literals.
+  Literal* literal = expression->AsLiteral();
+  if (literal != NULL && literal->handle()->IsNumber()) {
+    double value = literal->handle()->Number();
+    return op == RubyToken::SUB ? NewNumberLiteral(-value) : literal;
+  }
+  Token::Value js_op = op == RubyToken::SUB ? Token::SUB : Token::ADD;
+  return new(zone()) UnaryOperation(isolate_, js_op, expression, position);
+}
+
+
+Expression* RubyParser::ParsePowerExpression(bool* ok) {
+  // PowerExpression ::
+  //   PostfixExpression ('**' UnaryExpression)?
+  // Exponentiation is right associative and binds tighter than unary
+  // minus on its left, so '-2 ** 2' is -4.  It is compiled as a call to
+  // Math.pow.
+  Expression* base = ParsePostfixExpression(CHECK_OK);
+  if (peek() != RubyToken::POW) return base;
+  Next();
+  int position = scanner_.location().beg_pos;
+  SkipNewlines();
+  Expression* exponent = ParseUnaryExpression(CHECK_OK);
+
+  ZoneList<Expression*>* arguments = new(zone()) ZoneList<Expression*>(2);
+  arguments->Add(base);
+  arguments->Add(exponent);
+  Expression* math = top_scope()->NewUnresolved(
+      factory()->LookupAsciiSymbol("Math"), position);
+  Expression* pow = new(zone()) Property(
+      isolate_, math, NewLiteral(factory()->LookupAsciiSymbol("pow")),
+      position);
+  return new(zone()) Call(isolate_, pow, arguments, position);
+}
+
+
+Expression* RubyParser::ParsePostfixExpression(bool* ok) {
+  // PostfixExpression ::
+  //   PrimaryExpression ('.' Name Arguments? | '[' Expression ']')*
+  Expression* result = ParsePrimaryExpression(CHECK_OK);
+  while (true) {
+    switch (peek()) {
+      case RubyToken::PERIOD: {
+        Next();
+        SkipNewlines();
+        RubyToken::Value token = Next();
+        if (token != RubyToken::IDENTIFIER && token != RubyToken::CONSTANT) {
+          ReportUnexpectedToken(token);
+          *ok = false;
+          return NULL;
+        }
+        int position = scanner_.location().beg_pos;
+        Handle<String> name = scanner_.literal();
+        if (token == RubyToken::IDENTIFIER &&
+            name->IsEqualTo(CStrVector("new"))) {
+          // 'C.new(...)' constructs an instance of the class C.
+          ZoneList<Expression*>* arguments = ParseCallArguments(CHECK_OK);
+          result = new(zone()) CallNew(isolate_, result, arguments, position);
+          break;
+        }
+        Property* property = new(zone()) Property(
+            isolate_, result, NewLiteral(name), position);
+        if (peek() == RubyToken::LPAREN || StartsCommandArgument() ||
+            StartsBlock()) {
+          ZoneList<Expression*>* arguments = ParseCallArguments(CHECK_OK);
+          result = new(zone()) Call(isolate_, property, arguments, position);
+        } else {
+          result = property;
+        }
+        break;
+      }
+      case RubyToken::LBRACK: {
+        Next();
+        int position = scanner_.location().beg_pos;
+        SkipNewlines();
+        Expression* index = ParseExpression(CHECK_OK);
+        SkipNewlines();
+        Expect(RubyToken::RBRACK, CHECK_OK);
+        result = new(zone()) Property(isolate_, result, index, position);
+        break;
+      }
+      default:
+        return result;
+    }
+  }
+}
+
+
+Expression* RubyParser::ParsePrimaryExpression(bool* ok) {
+  // PrimaryExpression ::
+  //   'nil' | 'true' | 'false' | 'self'
+  //   Number | String | Symbol | ArrayLiteral
+  //   '(' Expression ')'
+  //   LocalVariable | InstanceVariable
+  //   Identifier CallArguments
+  //   Constant ('(' Arguments ')')?
+  //   'yield' Arguments?
+  //   'raise' Arguments?
+  //   Begin
+  if (peek() == RubyToken::BEGIN) {
+    // Jumps out of a begin expression would have to leave the expression
+    // around it.
+    int jumps = 0;
+    Expression* result = ParseBegin(&jumps, CHECK_OK);
+    if (jumps != 0) {
+      ReportMessageAt(scanner_.location(),
+                      (jumps & kReturnJump) ? "illegal_return"
+                                            : "illegal_break",
+                      Vector<const char*>::empty());
+      *ok = false;
+      return NULL;
+    }
+    return result;
+  }
+  RubyToken::Value token = Next();
+  int position = scanner_.location().beg_pos;
+  switch (token) {
+    case RubyToken::NUMBER:
+      return NewNumberLiteral(scanner_.number());
+    case RubyToken::STRING:
+      return NewLiteral(scanner_.literal());
+    case RubyToken::SYMBOL:
+      return NewLiteral(factory()->LookupAtom(scanner_.literal()));
+    case RubyToken::NIL:
+      return NewLiteral(factory()->undefined_value());
+    case RubyToken::TRUE_LITERAL:
+      return NewLiteral(factory()->true_value());
+    case RubyToken::FALSE_LITERAL:
+      return NewLiteral(factory()->false_value());
+    case RubyToken::SELF:
+      return new(zone()) VariableProxy(isolate_, top_scope()->receiver());
+    case RubyToken::INSTANCE_VARIABLE:
+      // Instance variables are properties of self.  The ones assigned by
+      // 'initialize' become inobject fields of the instances.
+      return new(zone()) Property(
+          isolate_,
+          new(zone()) VariableProxy(isolate_, top_scope()->receiver()),
+          NewLiteral(scanner_.literal()),
+          position);
+    case RubyToken::LPAREN: {
+      bool do_block_allowed = do_block_allowed_;
+      do_block_allowed_ = true;
+      SkipNewlines();
+      Expression* result = ParseExpression(CHECK_OK);
+      SkipNewlines();
+      Expect(RubyToken::RPAREN, CHECK_OK);
+      do_block_allowed_ = do_block_allowed;
+      return result;
+    }
+    case RubyToken::LBRACK:
+      return ParseArrayLiteral(ok);
+    case RubyToken::IDENTIFIER: {
+      Handle<String> name = scanner_.literal();
+      if (function_state_->IsLocal(name)) {
+        return top_scope()->NewUnresolved(name, position);
+      }
+      // Any other name is a call to a method defined at the top level.
+      ZoneList<Expression*>* arguments = ParseCallArguments(CHECK_OK);
+      return new(zone()) Call(isolate_,
+                              top_scope()->NewUnresolved(name, position),
+                              arguments,
+                              position);
+    }
+    case RubyToken::CONSTANT: {
+      Handle<String> name = scanner_.literal();
+      Expression* result = top_scope()->NewUnresolved(name, position);
+      if (peek() == RubyToken::LPAREN) {
+        ZoneList<Expression*>* arguments = ParseArguments(CHECK_OK);
+        result = new(zone()) Call(isolate_, result, arguments, position);
+      }
+      return result;
+    }
+    case RubyToken::YIELD: {
+      // 'yield' calls the block passed to the method, as a function.
+      VariableProxy* block = NewBlockParameterProxy(position, CHECK_OK);
+      ZoneList<Expression*>* arguments = NULL;
+      if (peek() == RubyToken::LPAREN || StartsCommandArgument()) {
+        arguments = ParseArguments(CHECK_OK);
+      } else {
+        arguments = new(zone()) ZoneList<Expression*>(0);
+      }
+      return new(zone()) Call(isolate_, block, arguments, position);
+    }
+    case RubyToken::RAISE:
+      return ParseRaise(ok);
+    default:
+      ReportUnexpectedToken(token);
+      *ok = false;
+      return NULL;
+  }
+}
+
+
+Expression* RubyParser::ParseRaise(bool* ok) {
+  // 'raise' throws its argument, or a new instance of its first argument
+  // made with the second one, as in 'raise ArgumentError, "message"'.  In
+  // a rescue clause, a plain 'raise' throws the rescued exception again.
+  int position = scanner_.location().beg_pos;
+  Expression* exception = NULL;
+  if (peek() == RubyToken::LPAREN || StartsCommandArgument()) {
+    ZoneList<Expression*>* arguments = ParseArguments(CHECK_OK);
+    if (arguments->length() == 1) {
+      exception = arguments->at(0);
+    } else if (arguments->length() == 2) {
+      ZoneList<Expression*>* message = new(zone()) ZoneList<Expression*>(1);
+      message->Add(arguments->at(1));
+      exception = new(zone()) CallNew(
+          isolate_, arguments->at(0), message, position);
+    }
+  } else {
+    Handle<String> rescued = factory()->LookupAsciiSymbol(".exception");
+    if (function_state_->IsLocal(rescued)) {
+      exception = top_scope()->NewUnresolved(rescued, position);
+    }
+  }
+  if (exception == NULL) {
+    ReportUnexpectedToken(RubyToken::RAISE);
+    *ok = false;
+    return NULL;
+  }
+  return new(zone()) Throw(isolate_, exception, position);
+}
+
+
+Expression* RubyParser::ParseArrayLiteral(bool* ok) {
+  // ArrayLiteral ::
+  //   '[' (Assignment (',' Assignment)* ','?)? ']'
+  // The '[' has already been consumed.  The boilerplate is built the same
+  // way as for JavaScript array literals.
+  ZoneList<Expression*>* values = new(zone()) ZoneList<Expression*>(4);
+  SkipNewlines();
+  while (peek() != RubyToken::RBRACK) {
+    Expression* value = ParseAssignment(CHECK_OK);
+    values->Add(value);
+    SkipNewlines();
+    if (peek() != RubyToken::RBRACK) {
+      Expect(RubyToken::COMMA, CHECK_OK);
+      SkipNewlines();
+    }
+  }
+  Expect(RubyToken::RBRACK, CHECK_OK);
+
+  int literal_index = function_state_->NextMaterializedLiteralIndex();
+  Handle<FixedArray> object_literals =
+      factory()->NewFixedArray(values->length(), TENURED);
+  ElementsKind elements_kind = FAST_SMI_ONLY_ELEMENTS;
+  bool is_simple = true;
+  int depth = 1;
+  for (int i = 0, n = values->length(); i < n; i++) {
+    Expression* value = values->at(i);
+    MaterializedLiteral* m_literal = value->AsMaterializedLiteral();
+    if (m_literal != NULL && m_literal->depth() + 1 > depth) {
+      depth = m_literal->depth() + 1;
+    }
+    // Unlike JavaScript, 'nil' is a literal, so an undefined boilerplate
+    // value is stored as is instead of marking the element as computed.
+    Handle<Object> boilerplate_value;
+    if (value->AsLiteral() != NULL) {
+      boilerplate_value = value->AsLiteral()->handle();
+    } else if (CompileTimeValue::IsCompileTimeValue(value)) {
+      boilerplate_value = CompileTimeValue::GetValue(value);
+    }
+    if (boilerplate_value.is_null()) {
+      object_literals->set_the_hole(i);
+      is_simple = false;
+    } else {
+      object_literals->set(i, *boilerplate_value);
+      if (!boilerplate_value->IsSmi()) elements_kind = FAST_ELEMENTS;
+    }
+  }
+
+  // Simple and shallow arrays can be lazily copied.
+  if (is_simple && depth == 1 && values->length() > 0) {
+    object_literals->set_map(isolate_->heap()->fixed_cow_array_map());
+  }
+
+  Handle<FixedArray> literals = factory()->NewFixedArray(2, TENURED);
+  literals->set(0, Smi::FromInt(elements_kind));
+  literals->set(1, *object_literals);
+  return new(zone()) ArrayLiteral(
+      isolate_, literals, values, literal_index, is_simple, depth);
+}
+
+
+ZoneList<Expression*>* RubyParser::ParseArguments(bool* ok) {
+  // Arguments ::
+  //   '(' (Assignment (',' Assignment)*)? ')'
+  //   Assignment (',' Assignment)*
+  ZoneList<Expression*>* result = new(zone()) ZoneList<Expression*>(4);
+  bool parenthesized = peek() == RubyToken::LPAREN;
+  if (parenthesized) {
+    Next();
+    SkipNewlines();
+    if (peek() == RubyToken::RPAREN) {
+      Next();
+      return result;
+    }
+  }
+  bool do_block_allowed = do_block_allowed_;
+  do_block_allowed_ = parenthesized;
+  while (true) {
+    Expression* argument = ParseAssignment(CHECK_OK);
+    result->Add(argument);
+    if (peek() != RubyToken::COMMA) break;
+    Next();
+    SkipNewlines();
+  }
+  do_block_allowed_ = do_block_allowed;
+  if (parenthesized) {
+    SkipNewlines();
+    Expect(RubyToken::RPAREN, CHECK_OK);
+  }
+  return result;
+}
+
+
+ZoneList<Expression*>* RubyParser::ParseCallArguments(bool* ok) {
+  // CallArguments ::
+  //   Arguments? Block?
+  // The block is passed as an extra last argument.  A '{' block does not
+  // follow arguments without parentheses, where it belongs to the last
+  // argument.
+  ZoneList<Expression*>* result = NULL;
+  bool brace_allowed = true;
+  if (peek() == RubyToken::LPAREN || StartsCommandArgument()) {
+    brace_allowed = peek() == RubyToken::LPAREN;
+    result = ParseArguments(CHECK_OK);
+  } else {
+    result = new(zone()) ZoneList<Expression*>(1);
+  }
+  if (StartsBlock() && (brace_allowed || peek() == RubyToken::DO)) {
+    FunctionLiteral* block = ParseBlock(CHECK_OK);
+    result->Add(block);
+  }
+  return result;
+}
+
+
+FunctionLiteral* RubyParser::ParseBlock(bool* ok) {
+  // Block ::
+  //   '{' BlockParameters? Statements '}'
+  //   'do' BlockParameters? Statements 'end'
+  // BlockParameters ::
+  //   '|' (Identifier (',' Identifier)*)? '|'
+  // A block is a closure.  Its parameters and the variables first
+  // assigned in it are its own, the locals of the enclosing methods and
+  // blocks are shared with them.  Blocks are compiled separately, see
+  // ParseLazy, which is why the scope is not forced to compile eagerly.
+  RubyToken::Value close =
+      Next() == RubyToken::LBRACE ? RubyToken::RBRACE : RubyToken::END;
+  int position = scanner_.location().beg_pos;
+
+  Scope* scope = new(zone()) Scope(top_scope(), FUNCTION_SCOPE);
+  scope->Initialize();
+  scope->set_start_position(position);
+
+  ZoneList<Statement*>* body = new(zone()) ZoneList<Statement*>(4);
+  int materialized_literal_count;
+  bool do_block_allowed = do_block_allowed_;
+  do_block_allowed_ = true;
+  {
+    FunctionState function_state(this, scope, FunctionState::BLOCK);
+    if (peek() == RubyToken::OR_OR) {
+      Next();
+    } else if (peek() == RubyToken::PIPE) {
+      Next();
+      while (peek() != RubyToken::PIPE) {
+        Expect(RubyToken::IDENTIFIER, CHECK_OK);
+        Handle<String> parameter = scanner_.literal();
+        if (function_state.HasLocal(parameter)) {
+          ReportUnexpectedToken(RubyToken::IDENTIFIER);
+          *ok = false;
+          return NULL;
+        }
+        scope->DeclareParameter(parameter, VAR);
+        function_state.AddLocal(parameter);
+        if (peek() != RubyToken::PIPE) Expect(RubyToken::COMMA, CHECK_OK);
+      }
+      Next();
+    }
+    ParseStatements(body, CHECK_OK);
+    Expect(close, CHECK_OK);
+    scope->set_end_position(scanner_.location().end_pos);
+    materialized_literal_count = function_state.materialized_literal_count();
+  }
+  do_block_allowed_ = do_block_allowed;
+
+  // A block returns the value of its last statement, like a method.
+  if (!body->is_empty()) {
+    int last = body->length() - 1;
+    (*body)[last] = WithImplicitReturn(body->at(last));
+  }
+
+  FunctionLiteral* block = new(zone()) FunctionLiteral(
+      isolate_,
+      factory()->empty_symbol(),
+      scope,
+      body,
+      materialized_literal_count,
+      0,
+      0,
+      false,
+      factory()->empty_fixed_array(),
+      scope->num_parameters(),
+      FunctionLiteral::ANONYMOUS_EXPRESSION,
+      false);
+  block->set_function_token_position(position);
+  if (position == lazy_block_position_) lazy_block_ = block;
+  return block;
+}
+
+#undef CHECK_OK
+
+
+VariableProxy* RubyParser::NewBlockParameterProxy(int position, bool* ok) {
+  // The block passed to a method is an implicit last parameter, which is
+  // declared when the method first yields.
+  FunctionState* method = function_state_;
+  while (method->is_block() || method->is_begin_body()) {
+    method = method->outer();
+  }
+  if (method->scope()->is_global_scope()) {
+    ReportUnexpectedToken(RubyToken::YIELD);
+    *ok = false;
+    return NULL;
+  }
+  Handle<String> name = factory()->LookupAsciiSymbol(".block");
+  if (!method->HasLocal(name)) {
+    method->scope()->DeclareParameter(name, VAR);
+    method->AddLocal(name);
+  }
+  return top_scope()->NewUnresolved(name, position);
+}
+
+
+void RubyParser::DeclareLocal(Handle<String> name, int position) {
+  if (function_state_->IsLocal(name)) return;
+  FunctionState* owner = function_state_->locals_owner();
+  owner->AddLocal(name);
+  Scope* scope = owner->scope();
+  if (!scope->is_global_scope()) {
+    scope->DeclareLocal(name, VAR, kCreatedInitialized);
+  }
+  VariableProxy* proxy = scope->NewUnresolved(name, position);
+  scope->AddDeclaration(new(zone()) Declaration(proxy, VAR, NULL, scope));
+}
+
+
+VariableProxy* RubyParser::NewHiddenLocal(const char* name) {
+  Handle<String> symbol = factory()->LookupAsciiSymbol(name);
+  DeclareLocal(symbol, RelocInfo::kNoPosition);
+  return top_scope()->NewUnresolved(symbol, RelocInfo::kNoPosition);
+}
+
+
+Statement* RubyParser::NewJump(Jump jump, Expression* value) {
+  // A return, or a break or next without a loop in the begin body, leaves
+  // the closure with the value and records the jump, which the begin
+  // statement then makes, see ParseBeginStatement.
+  if (function_state_->is_begin_body() &&
+      (jump == kReturnJump || function_state_->loops()->is_empty())) {
+    function_state_->AddJump(jump);
+    if (value == NULL) value = NewLiteral(factory()->undefined_value());
+    Block* result = new(zone()) Block(isolate_, NULL, 2, false);
+    result->AddStatement(new(zone()) ExpressionStatement(
+        new(zone()) Assignment(isolate_,
+                               Token::ASSIGN,
+                               NewHiddenLocal(".jump"),
+                               NewNumberLiteral(jump),
+                               RelocInfo::kNoPosition)));
+    result->AddStatement(new(zone()) ReturnStatement(value));
+    return result;
+  }
+  List<IterationStatement*>* loops = function_state_->loops();
+  switch (jump) {
+    case kReturnJump:
+      return new(zone()) ReturnStatement(value);
+    case kBreakJump:
+      return new(zone()) BreakStatement(loops->last());
+    case kNextJump:
+      return new(zone()) ContinueStatement(loops->last());
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+
+Expression* RubyParser::NewBinaryOperation(RubyToken::Value op,
+                                           Expression* left,
+                                           Expression* right,
+                                           int position) {
+  switch (op) {
+    case RubyToken::EQ:
+      return new(zone()) CompareOperation(
+          isolate_, Token::EQ_STRICT, left, right, position);
+    case RubyToken::NE:
+      return Negate(new(zone()) CompareOperation(
+          isolate_, Token::EQ_STRICT, left, right, position));
+    case RubyToken::LT:
+    case RubyToken::GT:
+    case RubyToken::LTE:
+    case RubyToken::GTE: {
+      Token::Value js_op = Token::LT;
+      if (op == RubyToken::GT) js_op = Token::GT;
+      if (op == RubyToken::LTE) js_op = Token::LTE;
+      if (op == RubyToken::GTE) js_op = Token::GTE;
+      return new(zone()) CompareOperation(
+          isolate_, js_op, left, right, position);
+    }
+    // Integers do not overflow in Ruby, so '+', '-' and '*' use the exact
+    // integer operations, which promote to BigInteger instead of rounding.
+    case RubyToken::ADD:
+      return NewRuntimeOperation(Runtime::kInlineIntegerAdd, "_IntegerAdd",
+                                 left, right);
+    case RubyToken::SUB:
+      return NewRuntimeOperation(Runtime::kInlineIntegerSub, "_IntegerSub",
+                                 left, right);
+    case RubyToken::MUL:
+      return NewRuntimeOperation(Runtime::kInlineIntegerMul, "_IntegerMul",
+                                 left, right);
+    case RubyToken::SHL: {
+      // Strings are mutable in Ruby and '<<' appends in place.  Appending
+      // to an immutable string makes a new string buffer, which is stored
+      // back when the string came from a local or instance variable, so
+      // later appends through the variable are in place.
+      Expression* append = NewRuntimeOperation(Runtime::kStringAppend,
+                                               "StringAppend",
+                                               left,
+                                               right);
+      VariableProxy* proxy = left->AsVariableProxy();
+      if (proxy != NULL && function_state_->IsLocal(proxy->name())) {
+        VariableProxy* target =
+            top_scope()->NewUnresolved(proxy->name(), proxy->position());
+        return new(zone()) Assignment(
+            isolate_, Token::ASSIGN, target, append, position);
+      }
+      Property* property = left->AsProperty();
+      if (property != NULL && property->key()->IsPropertyName() &&
+          property->obj()->AsVariableProxy() != NULL &&
+          property->obj()->AsVariableProxy()->is_this()) {
+        Expression* target = new(zone()) Property(
+            isolate_,
+            new(zone()) VariableProxy(isolate_, top_scope()->receiver()),
+            NewLiteral(property->key()->AsLiteral()->AsPropertyName()),
+            property->position());
+        return new(zone()) Assignment(
+            isolate_, Token::ASSIGN, target, append, position);
+      }
+      return append;
+    }
+    default: {
+      Token::Value js_op = Token::ILLEGAL;
+      switch (op) {
+        case RubyToken::OR_OR: js_op = Token::OR; break;
+        case RubyToken::AND_AND: js_op = Token::AND; break;
+        case RubyToken::DIV: js_op = Token::DIV; break;
+        case RubyToken::MOD: js_op = Token::MOD; break;
+        default: UNREACHABLE();
+      }
+      return new(zone()) BinaryOperation(
+          isolate_, js_op, left, right, position);
+    }
+  }
+}
+
+
+Expression* RubyParser::NewRuntimeOperation(Runtime::FunctionId id,
+                                            const char* name,
+                                            Expression* left,
+                                            Expression* right) {
+  ZoneList<Expression*>* arguments = new(zone()) ZoneList<Expression*>(2);
+  arguments->Add(left);
+  arguments->Add(right);
+  return new(zone()) CallRuntime(isolate_,
+                                 factory()->LookupAsciiSymbol(name),
+                                 Runtime::FunctionForId(id),
+                                 arguments);
+}
+
+
+Expression* RubyParser::Negate(Expression* expression) {
+  return new(zone()) UnaryOperation(
+      isolate_, Token::NOT, expression, RelocInfo::kNoPosition);
+}
+
+
+Statement* RubyParser::WithImplicitReturn(Statement* statement) {
+  ExpressionStatement* expression_statement =
+      statement->AsExpressionStatement();
+  if (expression_statement != NULL) {
+    ReturnStatement* result =
+        new(zone()) ReturnStatement(expression_statement->expression());
+    result->set_statement_pos(statement->statement_pos());
+    return result;
+  }
+  IfStatement* if_statement = statement->AsIfStatement();
+  if (if_statement != NULL) {
+    IfStatement* result = new(zone()) IfStatement(
+        isolate_,
+        if_statement->condition(),
+        WithImplicitReturn(if_statement->then_statement()),
+        WithImplicitReturn(if_statement->else_statement()));
+    result->set_statement_pos(statement->statement_pos());
+    return result;
+  }
+  Block* block = statement->AsBlock();
+  if (block != NULL && !block->statements()->is_empty()) {
+    ZoneList<Statement*>* statements = block->statements();
+    int last = statements->length() - 1;
+    (*statements)[last] = WithImplicitReturn(statements->at(last));
+  }
+  return statement;
+}
+
+
+void RubyParser::ReportUnexpectedToken(RubyToken::Value token) {
+  RubyScanner::Location location = scanner_.location();
+  switch (token) {
+    case RubyToken::EOS:
+      return ReportMessageAt(location, "unexpected_eos",
+                             Vector<const char*>::empty());
+    case RubyToken::NUMBER:
+      return ReportMessageAt(location, "unexpected_token_number",
+                             Vector<const char*>::empty());
+    case RubyToken::STRING:
+      return ReportMessageAt(location, "unexpected_token_string",
+                             Vector<const char*>::empty());
+    case RubyToken::SYMBOL:
+    case RubyToken::IDENTIFIER:
+    case RubyToken::CONSTANT:
+    case RubyToken::INSTANCE_VARIABLE:
+      return ReportMessageAt(location, "unexpected_token_identifier",
+                             Vector<const char*>::empty());
+    default: {
+      const char* name = RubyToken::Text(token);
+      ReportMessageAt(location, "unexpected_token",
+                      Vector<const char*>(&name, 1));
+    }
+  }
+}
+
+
+void RubyParser::ReportMessageAt(RubyScanner::Location source_location,
+                                 const char* type,
+                                 Vector<const char*> args) {
+  // Only the first error is reported.
+  if (has_error_) return;
+  has_error_ = true;
+  MessageLocation location(script_,
+                           source_location.beg_pos,
+                           source_location.end_pos);
+  Handle<FixedArray> elements = factory()->NewFixedArray(args.length());
+  for (int i = 0; i < args.length(); i++) {
+    Handle<String> arg_string =
+        factory()->NewStringFromUtf8(CStrVector(args[i]));
+    elements->set(i, *arg_string);
+  }
+  Handle<JSArray> array = factory()->NewJSArrayWithElements(elements);
+  Handle<Object> result = factory()->NewSyntaxError(type, array);
+  isolate_->Throw(*result, &location);
+}
+
+
+void RubyParser::ReportStackOverflow() {
+  if (has_error_) return;
+  has_error_ = true;
+  isolate_->StackOverflow();
+}
+
+
+// ----------------------------------------------------------------------------
+// Front end
+
+FunctionLiteral* RubyFrontEnd::Parse(CompilationInfo* info) {
+  RubyParser parser(info);
+  return info->is_lazy() ? parser.ParseLazy() : parser.ParseProgram();
+}
+
+
+// The front end has no state, so one instance serves every isolate.
+static RubyFrontEnd ruby_front_end;
+
+
+void RubyFrontEnd::Install() {
+  Isolate* isolate = Isolate::Current();
+  if (isolate->parser_front_end() == NULL) {
+    isolate->set_parser_front_end(&ruby_front_end);
+  }
+}
+
+
+v8::Local<v8::Script> CompileRuby(v8::Handle<v8::String> source,
+                                  v8::Handle<v8::Value> file_name,
+                                  v8::ScriptData* code_cache) {
+  RubyFrontEnd::Install();
+  return v8::Script::CompileWithFrontEnd(source, file_name, code_cache);
+}
+
+}  // namespace xruby
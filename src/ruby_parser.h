@@ -0,0 +1,58 @@
+#ifndef XRUBY_RUBY_PARSER_H_
+#define XRUBY_RUBY_PARSER_H_
+
+#include "../v8/src/v8.h"
+#include "../v8/src/parser.h"
+
+// A parser for a subset of Ruby that builds V8 syntax trees directly, so
+// Ruby scripts are compiled by the full code generator and Crankshaft
+// without being translated to JavaScript source and scanned again.
+//
+// The subset covers number, string, symbol, nil, true, false and array
+// literals, local variables, arithmetic, comparison and logical operators,
+// method calls with and without parentheses, indexing, top-level method
+// definitions, classes with instance methods, instance variables,
+// superclasses, reopening and 'new', blocks and 'yield', return,
+// if/elsif/else/unless, while/until with break and next, begin with rescue
+// and ensure, raise, and statement modifiers.  Top-level methods become
+// global functions and calls without a receiver call them, so Ruby code can
+// call JavaScript functions and the other way around.  Classes are
+// constructor functions whose prototypes hold the instance methods.  Instance
+// variables are properties named with a '$' instead of the '@', which become
+// inobject fields of the instances.  Calls to methods an object does not have
+// go to its 'method_missing' method, with the name as a symbol.  A block is a
+// closure passed as an extra last argument, which 'yield' calls, so
+// Crankshaft can inline it into a method that is inlined where the block is
+// created.  The body and clauses of a begin statement are closures called by
+// a native function that holds the try statement, so methods that rescue
+// exceptions are still optimized by Crankshaft.  A rescue clause tests the
+// exception with 'instanceof' against the listed constructors.  Symbols are
+// interned atoms that compare by identity.  '<<' appends to a string in
+// place, turning an immutable string in a local or instance variable into a
+// mutable string buffer.  Operators, truthiness and numbers follow JavaScript
+// semantics, except that integer '+', '-' and '*' are exact and promote to
+// arbitrary precision as in Ruby.
+
+namespace xruby {
+
+class RubyFrontEnd : public v8::internal::ParserFrontEnd {
+ public:
+  virtual v8::internal::FunctionLiteral* Parse(
+      v8::internal::CompilationInfo* info);
+
+  // Installs a RubyFrontEnd on the current isolate unless it has one.
+  static void Install();
+};
+
+
+// Compiles Ruby source to a script bound to the current context, like
+// v8::Script::Compile.  Installs the front end if necessary.  code_cache
+// can be the result of v8::Script::CreateCodeCache for the same source.
+v8::Local<v8::Script> CompileRuby(
+    v8::Handle<v8::String> source,
+    v8::Handle<v8::Value> file_name = v8::Handle<v8::Value>(),
+    v8::ScriptData* code_cache = NULL);
+
+}  // namespace xruby
+
+#endif  // XRUBY_RUBY_PARSER_H_
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "../v8/src/v8.h"
+using namespace v8;
+#include "ruby_parser.h"
+
+// Tests of the Ruby front end.  Every case runs a Ruby script in a fresh
+// context and compares what it prints with puts to the expected output.
+//
+//   xruby_test [v8 flags] [test name]
+//
+// With a test name only that case runs.
+
+struct TestCase {
+  const char* name;
+  const char* source;
+  const char* expected;
+};
+
+static const TestCase kTests[] = {
+  { "EmptyArrayLiteral",
+    "a = []\n"
+    "puts a.length\n",
+    "0\n" },
+  { "ArrayLiteralElements",
+    "a = [1, 'two', :three, nil]\n"
+    "puts a.length\n"
+    "puts a[0]\n"
+    "puts a[1]\n",
+    "4\n1\ntwo\n" },
+  { "ArrayLiteralsAreFreshCopies",
+    "def make\n"
+    "  [1, 2]\n"
+    "end\n"
+    "a = make\n"
+    "a[0] = 5\n"
+    "puts make[0]\n"
+    "puts a[0]\n",
+    "1\n5\n" },
+  { "SeveralArrayLiteralsInMethod",
+    "def nest(x)\n"
+    "  inner = [x, 'y']\n"
+    "  [inner, [], [x]]\n"
+    "end\n"
+    "r = nest(3)\n"
+    "puts r[0][1]\n"
+    "puts r[1].length\n"
+    "puts r[2][0]\n",
+    "y\n0\n3\n" },
+  { "ArrayLiteralInBlock",
+    "def pass\n"
+    "  yield 7\n"
+    "end\n"
+    "r = pass { |x| [x, [x]] }\n"
+    "puts r[1][0]\n",
+    "7\n" },
+  { "Conditionals",
+    "x = 3\n"
+    "if x > 2\n"
+    "  puts 'big'\n"
+    "else\n"
+    "  puts 'small'\n"
+    "end\n"
+    "puts 'odd' unless x == 4\n",
+    "big\nodd\n" },
+  { "ClassWithInstanceVariables",
+    "class Point\n"
+    "  def initialize(x, y)\n"
+    "    @x = x\n"
+    "    @y = y\n"
+    "  end\n"
+    "  def y\n"
+    "    @y\n"
+    "  end\n"
+    "end\n"
+    "puts Point.new(2, 3).y()\n",
+    "3\n" },
+  { "ArithmeticInMethod",
+    "def inc(n)\n"
+    "  n + 1\n"
+    "end\n"
+    "def area(w, h)\n"
+    "  w * h - 1\n"
+    "end\n"
+    "puts inc(41)\n"
+    "puts area(3, 4)\n",
+    "42\n11\n" },
+  { "ArithmeticInConditions",
+    "def small(n)\n"
+    "  if n + 1 < 3\n"
+    "    'yes'\n"
+    "  else\n"
+    "    'no'\n"
+    "  end\n"
+    "end\n"
+    "i = 0\n"
+    "while i * 2 < 6\n"
+    "  puts small(i)\n"
+    "  i = i + 1\n"
+    "end\n",
+    "yes\nyes\nno\n" }
+};
+static const int kTestCount = sizeof(kTests) / sizeof(kTests[0]);
+
+// What the current test printed.
+static std::string output;
+
+
+// Appends its arguments to the output, one per line, like Kernel#puts.
+static Handle<Value> Puts(const Arguments& args) {
+  for (int i = 0; i < args.Length(); i++) {
+    String::Utf8Value str(args[i]);
+    output += *str ? *str : "<string conversion failed>";
+    output += "\n";
+  }
+  return Undefined();
+}
+
+
+static bool RunTest(const TestCase& test) {
+  HandleScope handle_scope;
+  Handle<ObjectTemplate> global = ObjectTemplate::New();
+  global->Set(String::New("puts"), FunctionTemplate::New(Puts));
+  Persistent<Context> context = Context::New(NULL, global);
+  bool ok = true;
+  {
+    Context::Scope context_scope(context);
+    TryCatch try_catch;
+    output.clear();
+    Handle<Script> script =
+        xruby::CompileRuby(String::New(test.source), String::New(test.name));
+    if (script.IsEmpty() || script->Run().IsEmpty()) {
+      String::Utf8Value exception(try_catch.Exception());
+      fprintf(stderr, "%s: %s\n", test.name,
+              *exception ? *exception : "<exception>");
+      ok = false;
+    } else if (output != test.expected) {
+      fprintf(stderr, "%s: expected\n%sbut got\n%s", test.name,
+              test.expected, output.c_str());
+      ok = false;
+    }
+  }
+  context.Dispose();
+  return ok;
+}
+
+
+int main(int argc, char* argv[]) {
+  V8::SetFlagsFromCommandLine(&argc, argv, true);
+  const char* only = argc > 1 ? argv[1] : NULL;
+  int run = 0;
+  int failed = 0;
+  for (int i = 0; i < kTestCount; i++) {
+    if (only != NULL && strcmp(only, kTests[i].name) != 0) continue;
+    run++;
+    if (!RunTest(kTests[i])) failed++;
+  }
+  printf("%d of %d tests failed\n", failed, run);
+  V8::Dispose();
+  return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Runs the Splay workload for a fixed time without computing a score, to
+// measure the garbage collection pauses it causes:
+//
+//   d8 --gc-latency splay-latency.js
+//
+// d8 reports the distribution of the pauses and the minimum mutator
+// utilization. The longest iteration seen by the script is printed as well,
+// which includes the pauses the way the spinning-balls page observes them.
+
+load('base.js');
+load('splay.js');
+
+var kRunTime = 5000;  // Milliseconds.
+
+SplaySetup();
+var start = new Date();
+var last = start;
+var now = start;
+var iterations = 0;
+var longest = 0;
+while (now - start < kRunTime) {
+  SplayRun();
+  iterations++;
+  now = new Date();
+  longest = Math.max(longest, now - last);
+  last = now;
+}
+SplayTearDown();
+
+print('Splay: ' + iterations + ' iterations in ' + (now - start) + ' ms, ' +
+      'longest iteration ' + longest + ' ms');
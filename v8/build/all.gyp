@@ -12,6 +12,7 @@
         '../samples/samples.gyp:*',
         '../src/d8.gyp:d8',
         '../test/cctest/cctest.gyp:*',
+        '../test/microbench/microbench.gyp:*',
       ],
     }
   ]
@@ -82,6 +82,12 @@ class V8EXPORT CpuProfileNode {
    */
   int GetLineNumber() const;
 
+  /**
+   * Returns the reason the optimizing compiler gave up on the function,
+   * or an empty string if it did not.
+   */
+  const char* GetBailoutReason() const;
+
   /**
    * Returns total (self + children) execution time of the function,
    * in milliseconds, estimated by samples count.
@@ -132,6 +138,23 @@ class V8EXPORT CpuProfile {
   /** Returns the root node of the top down call tree. */
   const CpuProfileNode* GetTopDownRoot() const;
 
+  /**
+   * Writes the top down call tree of the profile to the stream in a
+   * compact binary format. Numbers are unsigned LEB128 varints, strings
+   * are a varint length followed by the characters. The stream starts
+   * with the characters "V8CP", the format version, the profile uid and
+   * the export sequence number (0 for the first export), followed by
+   * records that each start with a tag:
+   *
+   *   1 code entry: id, log tag, name prefix, name, resource name, line
+   *   2 node: id, parent node id (0 for the root), code entry id
+   *   3 ticks: node id, number of self ticks added
+   *   0 end of the stream
+   *
+   * Code entries and nodes are written before they are referenced.
+   */
+  void Serialize(OutputStream* stream) const;
+
   /**
    * Deletes the profile and removes it from CpuProfiler's list.
    * All pointers to nodes previously returned become invalid.
@@ -192,6 +215,18 @@ class V8EXPORT CpuProfiler {
       Handle<String> title,
       Handle<Value> security_token = Handle<Value>());
 
+  /**
+   * Writes what the profile being collected under the given title gained
+   * since the previous call for that profile, in the format described at
+   * CpuProfile::Serialize, without stopping the profile. The first call
+   * writes everything collected so far, later ones only add code entries
+   * and nodes and carry the new ticks. As with a profile being collected,
+   * functions from all security contexts are included. Returns false if no
+   * profile with this title is being collected.
+   */
+  static bool SerializeCurrentProfile(Handle<String> title,
+                                      OutputStream* stream);
+
   /**
    * Deletes all existing profiles, also cancelling all profiling
    * activity.  All previously returned pointers to profiles and their
@@ -201,6 +236,107 @@ class V8EXPORT CpuProfiler {
 };
 
 
+/**
+ * ICProfile contains the inline cache sites of a single function that
+ * changed state while IC recording was active.
+ */
+class V8EXPORT ICProfile {
+ public:
+  enum State {
+    kUninitialized,
+    kPremonomorphic,
+    kMonomorphic,
+    kMonomorphicPrototypeFailure,
+    kMegamorphic,
+    kStateCount
+  };
+
+  enum Kind {
+    kLoad,
+    kKeyedLoad,
+    kStore,
+    kKeyedStore,
+    kCall,
+    kKeyedCall
+  };
+
+  /** Returns the name of the function. */
+  Handle<String> GetFunctionName() const;
+
+  /** Returns the resource name of the script the function belongs to. */
+  Handle<String> GetScriptResourceName() const;
+
+  /** Returns the source position the function starts at. */
+  int GetStartPosition() const;
+
+  /** Returns the number of inline cache sites recorded. */
+  int GetSitesCount() const;
+
+  /** Returns the kind of the inline cache at a site. */
+  Kind GetSiteKind(int index) const;
+
+  /** Returns the source position of a site. */
+  int GetSitePosition(int index) const;
+
+  /** Returns the state a site was last seen in. */
+  State GetSiteState(int index) const;
+
+  /**
+   * Returns the number of receiver maps the site dispatches on. Sites
+   * that went megamorphic through the stub cache report zero.
+   */
+  int GetSiteMapsCount(int index) const;
+
+  /** Returns the number of state transitions seen at a site. */
+  int GetSiteTransitionsCount(int index) const;
+
+  /** Returns the number of sites last seen in the given state. */
+  int GetSitesCountInState(State state) const;
+};
+
+
+/**
+ * Interface for recording inline cache state transitions.
+ */
+class V8EXPORT ICProfiler {
+ public:
+  /**
+   * Callback invoked on every inline cache state transition. It is
+   * called from inside the IC miss handler and must not call into V8.
+   */
+  typedef void (*TransitionCallback)(const char* function_name,
+                                     int position,
+                                     ICProfile::Kind kind,
+                                     ICProfile::State from,
+                                     ICProfile::State to,
+                                     int maps_count);
+
+  /** Starts collecting per function IC profiles. */
+  static void StartRecording();
+
+  /** Stops collecting IC profiles. Collected profiles are kept. */
+  static void StopRecording();
+
+  /**
+   * Sets the callback notified of every transition, or removes it
+   * when NULL is passed. Works independently of recording.
+   */
+  static void SetTransitionCallback(TransitionCallback callback);
+
+  /** Returns the number of functions with recorded IC sites. */
+  static int GetProfilesCount();
+
+  /** Returns a profile by index. */
+  static const ICProfile* GetProfile(int index);
+
+  /**
+   * Deletes all collected profiles. All previously returned pointers
+   * to profiles become invalid after this call.
+   */
+  static void DeleteAllProfiles();
+};
+
+
 class HeapGraphNode;
 
 
@@ -422,6 +558,23 @@ class V8EXPORT HeapProfiler {
    */
   static void DeleteAllSnapshots();
 
+  /**
+   * Starts sampling allocations, on average one per sample_interval bytes.
+   * Each sample records the JavaScript stack of the allocation and is kept
+   * until the sampled object dies. Restarting discards previous samples.
+   */
+  static void StartAllocationSampling(int sample_interval = 512 * 1024);
+
+  /** Stops allocation sampling and discards the samples. */
+  static void StopAllocationSampling();
+
+  /**
+   * Writes the samples of live objects, aggregated into a tree of
+   * allocation stacks, into the stream as JSON. Returns false if
+   * allocation sampling is not running.
+   */
+  static bool SerializeAllocationSamples(OutputStream* stream);
+
   /** Binds a callback to embedder's class ID. */
   static void DefineWrapperClass(
       uint16_t class_id,
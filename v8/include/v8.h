@@ -107,10 +107,13 @@ class Data;
 class AccessorInfo;
 class StackTrace;
 class StackFrame;
+class Isolate;
 
 namespace internal {
 
 class Arguments;
+class ContextPool;
+class GCTracer;
 class Object;
 class Heap;
 class HeapObject;
@@ -134,6 +137,20 @@ typedef void (*WeakReferenceCallback)(Persistent<Value> object,
                                       void* parameter);
 
 
+/**
+ * A callback function for the handles made weak with MakeWeakBatched.
+ *
+ * After a garbage collection it receives the parameters of all such handles
+ * whose objects died in it.  The handles have already been disposed, so the
+ * callback only has to free what the parameters refer to, which it can also
+ * leave for later.
+ *
+ * \param parameters the values passed in when making the handles weak
+ * \param count the number of parameters
+ */
+typedef void (*WeakReferenceBatchCallback)(void** parameters, int count);
+
+
 // --- Handles ---
 
 #define TYPE_CHECK(T, S)                                       \
@@ -292,6 +309,8 @@ template <class T> class Local : public Handle<T> {
    *  the original handle is destroyed/disposed.
    */
   inline static Local<T> New(Handle<T> that);
+  /** Same as above, but avoids looking up the current isolate. */
+  inline static Local<T> New(Isolate* isolate, Handle<T> that);
 };
 
 
@@ -385,6 +404,16 @@ template <class T> class Persistent : public Handle<T> {
    */
   inline void MakeWeak(void* parameters, WeakReferenceCallback callback);
 
+  /**
+   * Make the reference to this object weak without a callback of its own.
+   * When only weak handles refer to the object, the garbage collector
+   * disposes this handle and passes the given parameters to the function
+   * set with V8::SetWeakReferenceBatchCallback, in one call for all such
+   * handles that died in the same collection.  This is cheaper than
+   * MakeWeak when many handles die at once.
+   */
+  inline void MakeWeakBatched(void* parameters);
+
   /** Clears the weak reference to this object.*/
   inline void ClearWeak();
 
@@ -437,6 +466,13 @@ class V8EXPORT HandleScope {
  public:
   HandleScope();
 
+  /**
+   * Creates a handle scope in the given isolate, which must be the
+   * isolate entered by the current thread.  This is faster than the
+   * default constructor, which has to look up the current isolate.
+   */
+  explicit HandleScope(Isolate* isolate);
+
   ~HandleScope();
 
   /**
@@ -456,6 +492,9 @@ class V8EXPORT HandleScope {
   static internal::Object** CreateHandle(internal::Object* value);
   // Faster version, uses HeapObject to obtain the current Isolate.
   static internal::Object** CreateHandle(internal::HeapObject* value);
+  // Faster version, takes the current Isolate as an argument.
+  static internal::Object** CreateHandle(internal::Isolate* isolate,
+                                         internal::Object* value);
 
  private:
   // Make it impossible to create heap-allocated or illegal handle
@@ -523,6 +562,25 @@ class V8EXPORT ScriptData {  // NOLINT
    */
   static ScriptData* PreCompile(const char* input, int length);
 
+  /**
+   * Pre-compiles the specified script without using any isolate, so that it
+   * can run on a background thread while the isolate keeps executing
+   * JavaScript.  Embedders loading many large scripts can preparse them in
+   * parallel and then pass each result as pre_data to Script::New or
+   * Script::Compile on the isolate's thread, which will then skip the bodies
+   * of lazily compiled functions.  The source buffer must stay alive until
+   * this call returns.
+   *
+   * \param input Pointer to UTF-8 script source code.
+   * \param length Length of UTF-8 script source code.
+   * \param max_stack_size The number of bytes of the calling thread's stack
+   *   the preparser may use.
+   * \return NULL if the preparser ran out of stack.
+   */
+  static ScriptData* PreCompileInBackground(const char* input,
+                                            int length,
+                                            size_t max_stack_size);
+
   /**
    * Pre-compiles the specified script (context-independent).
    *
@@ -593,7 +651,8 @@ class V8EXPORT Script {
    * \param source Script source code.
    * \param origin Script origin, owned by caller, no references are kept
    *   when New() returns
-   * \param pre_data Pre-parsing data, as obtained by ScriptData::PreCompile()
+   * \param pre_data Pre-parsing data, as obtained by ScriptData::PreCompile(),
+   *   or a code cache, as obtained by Script::CreateCodeCache();
    *   using pre_data speeds compilation if it's done multiple times.
    *   Owned by caller, no references are kept when New() returns.
    * \param script_data Arbitrary data associated with script. Using
@@ -626,7 +685,8 @@ class V8EXPORT Script {
    * \param source Script source code.
    * \param origin Script origin, owned by caller, no references are kept
    *   when Compile() returns
-   * \param pre_data Pre-parsing data, as obtained by ScriptData::PreCompile()
+   * \param pre_data Pre-parsing data, as obtained by ScriptData::PreCompile(),
+   *   or a code cache, as obtained by Script::CreateCodeCache();
    *   using pre_data speeds compilation if it's done multiple times.
    *   Owned by caller, no references are kept when Compile() returns.
    * \param script_data Arbitrary data associated with script. Using
@@ -658,6 +718,52 @@ class V8EXPORT Script {
                                Handle<Value> file_name,
                                Handle<String> script_data = Handle<String>());
 
+  /**
+   * Called on the isolate's thread when an asynchronous compilation
+   * finishes, with the script bound to the context that was entered when
+   * CompileAsync was called.  On a syntax error the script is empty and
+   * exception holds the error.
+   */
+  typedef void (*CompiledCallback)(Local<Script> script,
+                                   Local<Value> exception,
+                                   void* data);
+
+  /**
+   * Compiles the specified script without blocking the isolate's thread
+   * on the preparser.  The source is preparsed by a background task of
+   * the task runner set with V8::SetTaskRunner; the compilation proper
+   * then runs in an isolate task, which calls the callback.  Without a
+   * task runner the script is compiled and the callback called before
+   * CompileAsync returns.
+   *
+   * \param source Script source code.
+   * \param file_name File name to use as script's origin.
+   * \param callback Called with the result on the isolate's thread.
+   * \param data Passed to the callback.
+   */
+  static void CompileAsync(Handle<String> source,
+                           Handle<Value> file_name,
+                           CompiledCallback callback,
+                           void* data = NULL);
+
+  /**
+   * Compiles a script written in another language.  Its syntax tree is
+   * built by the parser front end installed on the isolate by an
+   * embedder that links against V8's internals (see ParserFrontEnd in
+   * src/parser.h), without generating JavaScript source first.
+   *
+   * \param source Script source code.
+   * \param file_name File name to use as script's origin.
+   * \param code_cache A code cache, as obtained by CreateCodeCache() for a
+   *   script compiled from the same source, or NULL.  Owned by caller.
+   * \return Compiled script object, bound to the context that was active
+   *   when this function was called.
+   */
+  static Local<Script> CompileWithFrontEnd(
+      Handle<String> source,
+      Handle<Value> file_name = Handle<Value>(),
+      ScriptData* code_cache = NULL);
+
   /**
    * Runs the script returning the resulting value.  If the script is
    * context independent (created using ::New) it will be run in the
@@ -678,6 +784,16 @@ class V8EXPORT Script {
    * debugger API.
    */
   void SetData(Handle<String> data);
+
+  /**
+   * Serializes the code compiled for this script.  The result can be passed
+   * as pre_data to New() or Compile() for the same source to skip parsing
+   * and compiling it, provided the same version of V8 runs with the same
+   * flags.  Otherwise the pre_data is ignored.  Returns NULL if the code
+   * cannot be serialized, e.g. because V8::EnableCodeCacheCreation() was not
+   * called or the script has already run.  The caller owns the result.
+   */
+  ScriptData* CreateCodeCache();
 };
 
 
@@ -1161,6 +1277,23 @@ class String : public Primitive {
     ExternalAsciiStringResource() {}
   };
 
+  /**
+   * An ExternalLatin1StringResource is a wrapper around a one-byte string
+   * buffer in Latin-1 (ISO-8859-1), e.g. a network buffer, that resides
+   * outside V8's heap.  See String::NewExternal for how it is used.
+   */
+  class V8EXPORT ExternalLatin1StringResource
+      : public ExternalStringResourceBase {
+   public:
+    virtual ~ExternalLatin1StringResource() {}
+    /** The string data from the underlying buffer.*/
+    virtual const char* data() const = 0;
+    /** The number of Latin-1 characters in the string.*/
+    virtual size_t length() const = 0;
+   protected:
+    ExternalLatin1StringResource() {}
+  };
+
   /**
    * Get the ExternalStringResource for an external string.  Returns
    * NULL if IsExternal() doesn't return true.
@@ -1232,6 +1365,18 @@ class String : public Primitive {
   V8EXPORT static Local<String> NewExternal(
       ExternalAsciiStringResource* resource);
 
+  /**
+   * Creates a new external string from the Latin-1 data defined in the
+   * given resource.  V8 has no one-byte representation for characters
+   * above 0x7F, so only pure ASCII data is used in place, as an external
+   * ASCII string that disposes the resource when it dies.  Otherwise the
+   * data is widened into an external two-byte buffer owned by V8 and the
+   * resource is disposed before this function returns.  Either way the
+   * data is not copied into V8's heap.
+   */
+  V8EXPORT static Local<String> NewExternal(
+      ExternalLatin1StringResource* resource);
+
   /**
    * Associate an external string resource with this string by transforming it
    * in place so that existing references to this string in the JavaScript heap
@@ -1243,6 +1388,15 @@ class String : public Primitive {
    */
   V8EXPORT bool MakeExternal(ExternalAsciiStringResource* resource);
 
+  /**
+   * Strings of at least this many characters can always be made external
+   * unless they already are or MakeExternal is called from a GC callback.
+   * Shorter strings may be refused, e.g. if they were created so recently
+   * that they are likely to die young.  Strings in the young generation
+   * are made external in place, without being copied anywhere first.
+   */
+  static const int kMinGuaranteedExternalLength = 256;
+
   /**
    * Returns true if this string can be made external.
    */
@@ -1711,6 +1865,29 @@ class Array : public Object {
    */
   V8EXPORT static Local<Array> New(int length = 0);
 
+  /**
+   * Bulk accessors.  Copy the elements [start, start + count) to values,
+   * converted as by NumberValue(), Int32Value() or not at all.  Numbers
+   * stored in fast or double elements are read directly, without a handle
+   * per element; holes and other values take the same path as Get(), so
+   * getters and the prototype chain are honored.  Return false if a
+   * conversion or getter threw, in which case values is only partially
+   * written.
+   */
+  V8EXPORT bool CopyTo(uint32_t start, uint32_t count, double* values);
+  V8EXPORT bool CopyTo(uint32_t start, uint32_t count, int32_t* values);
+  V8EXPORT bool CopyTo(uint32_t start,
+                       uint32_t count,
+                       Local<Value>* values);
+
+  /**
+   * Bulk constructors.  Create an array with the given elements, stored
+   * directly as unboxed doubles or small integers where possible.
+   */
+  V8EXPORT static Local<Array> New(const double* values, int length);
+  V8EXPORT static Local<Array> New(const int32_t* values, int length);
+  V8EXPORT static Local<Array> New(Handle<Value>* values, int length);
+
   static inline Array* Cast(Value* obj);
  private:
   V8EXPORT Array();
@@ -1743,6 +1920,28 @@ class Function : public Object {
   V8EXPORT int GetScriptColumnNumber() const;
   V8EXPORT Handle<Value> GetScriptId() const;
   V8EXPORT ScriptOrigin GetScriptOrigin() const;
+
+  /**
+   * Returns true if the optimizing compiler gave up on the function for
+   * good, so that it keeps running unoptimized code.
+   */
+  V8EXPORT bool IsOptimizationDisabled() const;
+  /**
+   * Returns the reason the optimizing compiler last gave up on the
+   * function, or undefined if it never did.
+   */
+  V8EXPORT Handle<Value> GetBailoutReason() const;
+  /**
+   * Returns the reasons the optimizing compiler gave up on the function,
+   * most recent first, as an array of [reason, count] arrays.
+   */
+  V8EXPORT Local<Array> GetBailoutReasons() const;
+  /**
+   * Returns how many times optimized code of the function deoptimized
+   * eagerly.
+   */
+  V8EXPORT int GetDeoptimizationCount() const;
+
   static inline Function* Cast(Value* obj);
   V8EXPORT static const int kLineOffsetNotFound;
 
@@ -1752,6 +1951,48 @@ class Function : public Object {
 };
 
 
+/**
+ * Calls the same function on the same receiver many times, for instance
+ * from an event dispatcher.  The function, the receiver and the arguments
+ * are kept alive by the prepared call, so a call does not need any
+ * handles and passes the same argument buffer every time.  Arguments keep
+ * their value until they are set again.
+ *
+ * A prepared call belongs to the isolate of its function and may only be
+ * used in a context of that isolate.
+ */
+class V8EXPORT PreparedCall {
+ public:
+  PreparedCall(Handle<Function> function, Handle<Object> recv, int argc);
+  ~PreparedCall();
+
+  int argc() const { return argc_; }
+
+  /** Sets the argument at the index to the value for the following calls. */
+  void SetArgument(int index, Handle<Value> value);
+
+  /**
+   * Calls the function with the current arguments.  Returns an empty
+   * handle if the call threw an exception.
+   */
+  Local<Value> Call();
+
+ private:
+  internal::Isolate* isolate_;
+  internal::Object** function_;
+  internal::Object** receiver_;
+  // A fixed array with the arguments.
+  internal::Object** arguments_;
+  // The argument buffer passed to the function, pointing into arguments_.
+  internal::Object*** argv_;
+  int argc_;
+
+  // Disallow copying and assigning.
+  PreparedCall(const PreparedCall&);
+  void operator=(const PreparedCall&);
+};
+
+
 /**
  * An instance of the built-in Date constructor (ECMA-262, 15.9).
  */
@@ -2098,6 +2339,51 @@ typedef bool (*IndexedSecurityCallback)(Local<Object> host,
                                         Local<Value> data);
 
 
+/**
+ * A plain C function that V8 can call in place of a FunctionTemplate's
+ * call handler, see FunctionTemplate::SetFastCallHandler.  Cast the real
+ * function, e.g. int32_t (*)(int32_t, double), to this type.
+ */
+typedef void (*FastCallFunction)();
+
+
+/**
+ * The C types of a FastCallFunction's result and arguments.
+ */
+class V8EXPORT FastCallSignature {
+ public:
+  enum Type { kVoid, kInt32, kDouble };
+  static const int kMaxArguments = 3;
+
+  explicit FastCallSignature(Type result)
+      : result_(result), argument_count_(0) { }
+  FastCallSignature(Type result, Type arg0)
+      : result_(result), argument_count_(1) {
+    arguments_[0] = arg0;
+  }
+  FastCallSignature(Type result, Type arg0, Type arg1)
+      : result_(result), argument_count_(2) {
+    arguments_[0] = arg0;
+    arguments_[1] = arg1;
+  }
+  FastCallSignature(Type result, Type arg0, Type arg1, Type arg2)
+      : result_(result), argument_count_(3) {
+    arguments_[0] = arg0;
+    arguments_[1] = arg1;
+    arguments_[2] = arg2;
+  }
+
+  Type result() const { return result_; }
+  int argument_count() const { return argument_count_; }
+  Type argument(int index) const { return arguments_[index]; }
+
+ private:
+  Type result_;
+  int argument_count_;
+  Type arguments_[kMaxArguments];
+};
+
+
 /**
  * A FunctionTemplate is used to create functions at runtime. There
  * can only be one function created from a FunctionTemplate in a
@@ -2208,6 +2494,21 @@ class V8EXPORT FunctionTemplate : public Template {
   void SetCallHandler(InvocationCallback callback,
                       Handle<Value> data = Handle<Value>());
 
+  /**
+   * Sets a typed fast path next to the call handler.  When the function
+   * is called (not constructed) with at least as many arguments as the
+   * signature has, each of them a number, and every kInt32 argument an
+   * int32 value, V8 calls the C function directly with the unboxed
+   * arguments and boxes its result.  No Arguments object, handle scope or
+   * VM state switch is set up, so the function must not call back into
+   * V8.  Any other call goes to the call handler, which must implement
+   * the same behavior.  The receiver signature is checked as usual first.
+   * kVoid is only valid as the result type, which makes the call return
+   * undefined.
+   */
+  void SetFastCallHandler(FastCallFunction function,
+                          const FastCallSignature& signature);
+
   /** Get the InstanceTemplate. */
   Local<ObjectTemplate> InstanceTemplate();
 
@@ -2327,6 +2628,17 @@ class V8EXPORT ObjectTemplate : public Template {
                    AccessControl settings = DEFAULT,
                    PropertyAttribute attribute = None);
 
+  /**
+   * Sets a read-only accessor that returns the value stored in the
+   * given internal field of the holder.  Loads of such accessors are
+   * inline cached as direct field loads without calling out to C++.
+   * The internal field must hold a JavaScript value set with
+   * Object::SetInternalField, not a pointer.
+   */
+  void SetInternalFieldAccessor(Handle<String> name,
+                                int index,
+                                PropertyAttribute attribute = None);
+
   /**
    * Sets a named property handler on the object template.
    *
@@ -2351,6 +2663,15 @@ class V8EXPORT ObjectTemplate : public Template {
                                NamedPropertyEnumerator enumerator = 0,
                                Handle<Value> data = Handle<Value>());
 
+  /**
+   * Restricts the named property handler to the given property names.
+   * Accesses to any other name bypass the handler entirely and behave
+   * like accesses on an ordinary object, so they can be inline cached,
+   * including lookups that continue on the prototype chain.  Must be
+   * called after SetNamedPropertyHandler.
+   */
+  void SetNamedPropertyHandlerKeys(Handle<Array> keys);
+
   /**
    * Sets an indexed property handler on the object template.
    *
@@ -2558,11 +2879,39 @@ class V8EXPORT ResourceConstraints {
   uint32_t* stack_limit() const { return stack_limit_; }
   // Sets an address beyond which the VM's stack may not grow.
   void set_stack_limit(uint32_t* value) { stack_limit_ = value; }
+  int max_incremental_marking_step() const {
+    return max_incremental_marking_step_;
+  }
+  // Sets the longest an incremental marking step should take, in
+  // milliseconds.  Zero leaves the step size to the allocation rate.
+  void set_max_incremental_marking_step(int value) {
+    max_incremental_marking_step_ = value;
+  }
+  int incremental_marking_growth_target() const {
+    return incremental_marking_growth_target_;
+  }
+  // Sets by how many percent the old generation may grow during incremental
+  // marking before marking should be finished.
+  void set_incremental_marking_growth_target(int value) {
+    incremental_marking_growth_target_ = value;
+  }
+  int stub_cache_size() const { return stub_cache_size_; }
+  // Sets the number of entries in the primary table of the megamorphic
+  // stub cache.  It is rounded up to a power of two.
+  void set_stub_cache_size(int value) { stub_cache_size_ = value; }
+  int lookup_cache_size() const { return lookup_cache_size_; }
+  // Sets the number of entries in the caches that map property names to
+  // field offsets and descriptors.  It is rounded up to a power of two.
+  void set_lookup_cache_size(int value) { lookup_cache_size_ = value; }
  private:
   int max_young_space_size_;
   int max_old_space_size_;
   int max_executable_size_;
   uint32_t* stack_limit_;
+  int max_incremental_marking_step_;
+  int incremental_marking_growth_target_;
+  int stub_cache_size_;
+  int lookup_cache_size_;
 };
 
 
@@ -2673,6 +3022,23 @@ typedef void (*GCEpilogueCallback)(GCType type, GCCallbackFlags flags);
 
 typedef void (*GCCallback)();
 
+/**
+ * Kinds of memory outside the V8 heap that is kept alive by JavaScript
+ * objects, see V8::AdjustAmountOfExternalAllocatedMemory.
+ */
+enum ExternalMemoryType {
+  kExternalStringMemory,    // Resources of external strings.
+  kExternalArrayMemory,     // Backing stores of external arrays.
+  kEmbedderMemory,          // Anything else the embedder allocates.
+  kNumberOfExternalMemoryTypes
+};
+
+
+/**
+ * Called on a thread whose time slice has run out, see V8::SetTimeSlice.
+ */
+typedef void (*TimeSliceCallback)();
+
 
 /**
  * Collection of V8 heap information.
@@ -2687,6 +3053,20 @@ class V8EXPORT HeapStatistics {
   size_t total_heap_size_executable() { return total_heap_size_executable_; }
   size_t used_heap_size() { return used_heap_size_; }
   size_t heap_size_limit() { return heap_size_limit_; }
+  /**
+   * Size of the objects and committed memory of the heap right after the
+   * isolate was set up from the snapshot, before any context was created.
+   * Every isolate in the process carries this much on its own.
+   */
+  size_t startup_heap_size() { return startup_heap_size_; }
+  size_t startup_committed_heap_size() { return startup_committed_heap_size_; }
+  /**
+   * Amount of external memory of the given type registered with
+   * V8::AdjustAmountOfExternalAllocatedMemory.
+   */
+  size_t external_memory_size(ExternalMemoryType type) {
+    return external_memory_size_[type];
+  }
 
  private:
   void set_total_heap_size(size_t size) { total_heap_size_ = size; }
@@ -2695,16 +3075,128 @@ class V8EXPORT HeapStatistics {
   }
   void set_used_heap_size(size_t size) { used_heap_size_ = size; }
   void set_heap_size_limit(size_t size) { heap_size_limit_ = size; }
+  void set_startup_heap_size(size_t size) { startup_heap_size_ = size; }
+  void set_startup_committed_heap_size(size_t size) {
+    startup_committed_heap_size_ = size;
+  }
+  void set_external_memory_size(ExternalMemoryType type, size_t size) {
+    external_memory_size_[type] = size;
+  }
 
   size_t total_heap_size_;
   size_t total_heap_size_executable_;
   size_t used_heap_size_;
   size_t heap_size_limit_;
+  size_t startup_heap_size_;
+  size_t startup_committed_heap_size_;
+  size_t external_memory_size_[kNumberOfExternalMemoryTypes];
 
   friend class V8;
 };
 
 
+/**
+ * Timings and sizes of a single garbage collection.
+ *
+ * Instances of this class are passed to the callback installed with
+ * v8::V8::SetGCEventCallback after the collection has finished. All times
+ * are in milliseconds.
+ */
+class V8EXPORT GCEvent {
+ public:
+  enum Phase {
+    kExternal,         // Embedder callbacks and weak handle callbacks.
+    kMark,             // Marking live objects in a full collection.
+    kSweep,            // Sweeping old spaces and new space.
+    kEvacuate,         // Evacuating new space and fragmented pages.
+    kUpdatePointers,   // Updating pointers to moved objects.
+    kScavengeRoots,    // Copying objects reachable from roots in a scavenge.
+    kWeakProcessing,   // Clearing weak references to dead objects.
+    kNumberOfPhases
+  };
+
+  GCEvent();
+  GCType type() const { return type_; }
+  double pause_time() const { return pause_time_; }
+  double phase_time(Phase phase) const { return phase_times_[phase]; }
+  size_t size_before() const { return size_before_; }
+  size_t size_after() const { return size_after_; }
+  size_t promoted_bytes() const { return promoted_bytes_; }
+  size_t freed_bytes() const {
+    return size_before_ > size_after_ ? size_before_ - size_after_ : 0;
+  }
+  /**
+   * Incremental marking steps that contributed to this collection: the
+   * steps since the previous collection for a scavenge and the steps since
+   * marking started for a full collection.
+   */
+  int incremental_steps_count() const { return incremental_steps_count_; }
+  double incremental_steps_time() const { return incremental_steps_time_; }
+
+ private:
+  GCType type_;
+  double pause_time_;
+  double phase_times_[kNumberOfPhases];
+  size_t size_before_;
+  size_t size_after_;
+  size_t promoted_bytes_;
+  int incremental_steps_count_;
+  double incremental_steps_time_;
+
+  friend class internal::GCTracer;
+};
+
+
+/**
+ * Callback for GC events. It is called inside the garbage collection, so
+ * it must not call into V8 or allocate objects.
+ */
+typedef void (*GCEventCallback)(const GCEvent& event);
+
+
+/**
+ * Interface for iterating through the runtime call statistics collected
+ * with --runtime-call-stats, see V8::VisitRuntimeCallStats.
+ */
+class V8EXPORT RuntimeCallStatsVisitor {  // NOLINT
+ public:
+  virtual ~RuntimeCallStatsVisitor() {}
+  /**
+   * Called for each runtime function, C++ builtin and IC miss handler
+   * that has been called since the statistics were last reset. The time
+   * does not include nested runtime calls.
+   */
+  virtual void VisitRuntimeCall(const char* name,
+                                int count,
+                                double time_ms) = 0;
+};
+
+
+/**
+ * Interface for iterating through the object statistics recorded with
+ * --track-object-stats, see V8::VisitObjectStats.
+ */
+class V8EXPORT ObjectStatsVisitor {  // NOLINT
+ public:
+  enum Category {
+    kInstanceType,  // E.g. "JS_OBJECT_TYPE".
+    kSpace,         // E.g. "OLD_POINTER_SPACE".
+    kCodeKind       // E.g. "OPTIMIZED_FUNCTION", code objects only.
+  };
+
+  virtual ~ObjectStatsVisitor() {}
+  /**
+   * Called for each instance type, heap space and code kind that had live
+   * objects in the last full garbage collection. Every live object is
+   * counted once by instance type and once by space.
+   */
+  virtual void VisitObjectStats(Category category,
+                                const char* name,
+                                int count,
+                                size_t size) = 0;
+};
+
+
 class RetainedObjectInfo;
 
 /**
@@ -2805,7 +3297,9 @@ class StartupData {
  public:
   enum CompressionAlgorithm {
     kUncompressed,
-    kBZip2
+    kBZip2,
+    // Compressed with V8's built-in codec, which V8 decompresses itself.
+    kBuiltIn
   };
 
   const char* data;
@@ -2845,6 +3339,42 @@ class V8EXPORT StartupDataDecompressor {  // NOLINT
  */
 typedef bool (*EntropySource)(unsigned char* buffer, size_t length);
 
+
+/**
+ * A unit of work that V8 hands to the embedder's TaskRunner.
+ */
+class V8EXPORT Task {
+ public:
+  virtual ~Task() {}
+  virtual void Run() = 0;
+};
+
+
+/**
+ * Lets V8 run work on the embedder's threads instead of starting threads
+ * of its own, so that all background work of the process can share one
+ * thread pool.  See V8::SetTaskRunner.
+ */
+class V8EXPORT TaskRunner {
+ public:
+  virtual ~TaskRunner() {}
+
+  /**
+   * Runs the task on some background thread, without any isolate entered,
+   * and then deletes it.  Tasks may block on each other, so they must not
+   * be run one after another on a single thread.
+   */
+  virtual void PostBackgroundTask(Task* task) = 0;
+
+  /**
+   * Runs the task on the thread that uses the isolate, from the
+   * embedder's event loop, with the isolate entered and locked if Lockers
+   * are used, and then deletes it.  The task brings its own handle scope
+   * and context.
+   */
+  virtual void PostIsolateTask(Isolate* isolate, Task* task) = 0;
+};
+
 /**
  * Container class for static utility functions.
  */
@@ -2898,6 +3428,11 @@ class V8EXPORT V8 {
    * A helper class StartupDataDecompressor is provided. It implements
    * the protocol of the interaction described above, and can be used in
    * most cases instead of calling these API functions directly.
+   *
+   * When V8 is built with 'compress_startup_data=lz', the startup data
+   * is compressed with a built-in codec and decompressed by V8 itself.
+   * The algorithm is then kBuiltIn and the count is zero, so there is
+   * nothing for the embedder to do.
    */
   static StartupData::CompressionAlgorithm GetCompressedStartupDataAlgorithm();
   static int GetCompressedStartupDataCount();
@@ -3024,6 +3559,22 @@ class V8EXPORT V8 {
    */
   static void SetGlobalGCEpilogueCallback(GCCallback);
 
+  /**
+   * Enables the host application to receive timings and sizes of every
+   * garbage collection. Passing NULL removes the callback. Independently
+   * of the callback, pause and phase times are recorded in histograms
+   * once SetCreateHistogramFunction has been called.
+   */
+  static void SetGCEventCallback(GCEventCallback callback);
+
+  /**
+   * Sets the function that receives the parameters of dead handles made
+   * weak with Persistent::MakeWeakBatched.  Without one the parameters are
+   * dropped.
+   */
+  static void SetWeakReferenceBatchCallback(
+      WeakReferenceBatchCallback callback);
+
   /**
    * Enables the host application to provide a mechanism to be notified
    * and perform custom logging when V8 Allocates Executable Memory.
@@ -3075,6 +3626,23 @@ class V8EXPORT V8 {
    */
   static void SetEntropySource(EntropySource source);
 
+  /**
+   * Sets the task runner V8 posts background work to: concurrent sweeping
+   * (--concurrent-sweeping) and asynchronous compilation, see
+   * Script::CompileAsync.  Without one, sweeping uses threads of V8's own
+   * and asynchronous compilation is synchronous.  The runner must outlive
+   * the isolates that use it.
+   */
+  static void SetTaskRunner(TaskRunner* runner);
+
+  /**
+   * Makes the code generated from now on independent of the running process
+   * so that it can be serialized with Script::CreateCodeCache().  Must be
+   * called before V8 is initialized.  Note that this disables the optimizing
+   * compiler.
+   */
+  static void EnableCodeCacheCreation();
+
   /**
    * Adjusts the amount of registered external memory.  Used to give
    * V8 an indication of the amount of externally allocated memory
@@ -3091,6 +3659,17 @@ class V8EXPORT V8 {
    */
   static int AdjustAmountOfExternalAllocatedMemory(int change_in_bytes);
 
+  /**
+   * Like the function above, but also records the type of the memory for
+   * HeapStatistics::external_memory_size.  The memory of all types counts
+   * the same towards garbage collections.  While the amount grows past a
+   * limit that scales with the amount that survived the last full garbage
+   * collection, V8 marks the heap incrementally and only forces a full
+   * garbage collection if the amount grows much further.
+   */
+  static int AdjustAmountOfExternalAllocatedMemory(int change_in_bytes,
+                                                   ExternalMemoryType type);
+
   /**
    * Suspends recording of tick samples in the profiler.
    * When the V8 profiling mode is enabled (usually via command line
@@ -3171,6 +3750,23 @@ class V8EXPORT V8 {
    */
   static bool IsExecutionTerminating(Isolate* isolate = NULL);
 
+  /**
+   * Gives the calling thread a time slice of the given number of
+   * microseconds of CPU time in the current isolate.  When the thread
+   * has used it up, the next stack check in JavaScript (on function
+   * entry or a loop back edge) calls the callback on that thread, for
+   * example to let other threads in with an Unlocker.  A new slice
+   * starts when the callback returns.
+   *
+   * Unlike Locker::StartPreemption this starts no thread: the slice is
+   * measured by a per-thread CPU timer that signals the thread itself
+   * (SIGVTALRM on Linux).  Passing 0 microseconds or a NULL callback
+   * stops time slicing for the calling thread.
+   *
+   * Returns false if the platform has no per-thread CPU timers.
+   */
+  static bool SetTimeSlice(int microseconds, TimeSliceCallback callback);
+
   /**
    * Releases any resources used by v8 and stops any utility threads
    * that may be running.  Note that disposing v8 is permanent, it
@@ -3187,6 +3783,26 @@ class V8EXPORT V8 {
    */
   static void GetHeapStatistics(HeapStatistics* heap_statistics);
 
+  /**
+   * Iterates through the runtime call statistics of the current isolate,
+   * in order of decreasing time. Statistics are only collected with the
+   * --runtime-call-stats flag.
+   */
+  static void VisitRuntimeCallStats(RuntimeCallStatsVisitor* visitor);
+
+  /**
+   * Resets the runtime call statistics of the current isolate.
+   */
+  static void ResetRuntimeCallStats();
+
+  /**
+   * Iterates through the number and size of the objects that survived the
+   * last full garbage collection of the current isolate. Statistics are
+   * only collected with the --track-object-stats flag. Returns false if no
+   * full collection has recorded statistics yet.
+   */
+  static bool VisitObjectStats(ObjectStatsVisitor* visitor);
+
   /**
    * Optional notification that the embedder is idle.
    * V8 uses the notification to reduce memory footprint.
@@ -3201,6 +3817,16 @@ class V8EXPORT V8 {
    */
   static bool IdleNotification(int hint = 1000);
 
+  /**
+   * Optional notification that the embedder is idle for the given number
+   * of microseconds.  V8 uses the time to do the garbage collection work
+   * that is expected to fit in it: an incremental marking step, lazy
+   * sweeping, a scavenge or the final full collection.  Returns the
+   * number of microseconds used, which may exceed the given time when
+   * the estimates are off.
+   */
+  static int IdleNotificationWithDeadline(int idle_time_in_us);
+
   /**
    * Optional notification that the system is running low on memory.
    * V8 uses these notifications to attempt to free memory.
@@ -3223,6 +3849,7 @@ class V8EXPORT V8 {
   static void MakeWeak(internal::Object** global_handle,
                        void* data,
                        WeakReferenceCallback);
+  static void MakeWeakBatched(internal::Object** global_handle, void* data);
   static void ClearWeak(internal::Object** global_handle);
   static void MarkIndependent(internal::Object** global_handle);
   static bool IsGlobalNearDeath(internal::Object** global_handle);
@@ -3428,6 +4055,26 @@ class V8EXPORT Context {
       Handle<ObjectTemplate> global_template = Handle<ObjectTemplate>(),
       Handle<Value> global_object = Handle<Value>());
 
+  /**
+   * Creates a new context whose global object starts out with the state
+   * that setup code left on the global object of an existing context.
+   *
+   * The enumerable data properties of the source global object are copied.
+   * Functions declared at the top level of the source are rebound to the
+   * new context and share their compiled code with the source. Plain
+   * objects and arrays are cloned, and array backing stores that only
+   * hold primitive values are shared copy-on-write between the two
+   * contexts. Other values, such as closures over function scopes or
+   * objects created by API templates, are not copied.
+   *
+   * The remaining parameters have the same meaning as for Context::New.
+   * The global template of the source context is not reused.
+   */
+  static Persistent<Context> NewFrom(
+      Handle<Context> source,
+      ExtensionConfiguration* extensions = NULL,
+      Handle<ObjectTemplate> global_template = Handle<ObjectTemplate>());
+
   /** Returns the last entered context. */
   static Local<Context> GetEntered();
 
@@ -3656,6 +4303,167 @@ class V8EXPORT Locker {
 };
 
 
+/**
+ * A pool of contexts that are created ahead of time, so an embedder that
+ * gives every request a fresh context does not pay for bootstrapping on
+ * the request path.
+ *
+ * Apart from AvailableCount, the methods must be called with the isolate
+ * entered and, if Lockers are used, locked.  When background refilling is
+ * enabled the pool creates contexts on its own thread under a v8::Locker,
+ * so the embedder must use Lockers for the isolate too.
+ *
+ * \code
+ * v8::ContextPool::Options options;
+ * options.size = 8;
+ * v8::ContextPool pool(isolate, options, global_template);
+ * ...
+ * v8::Persistent<v8::Context> context = pool.Acquire();
+ * { v8::Context::Scope scope(context); ... }
+ * pool.Release(context, v8::ContextPool::kRecycle);
+ * \endcode
+ */
+class V8EXPORT ContextPool {
+ public:
+  enum ReleaseMode {
+    /** Drops the context and tells V8 that a context was disposed. */
+    kDiscard,
+    /**
+     * Keeps the global proxy of the context and uses it for a replacement
+     * context whose global object is created again from the pool's
+     * template.  Objects holding on to the global keep a valid identity.
+     */
+    kRecycle
+  };
+
+  struct V8EXPORT Options {
+    Options()
+        : size(4),
+          background_refill(false),
+          idle_notification_ms(0) { }
+
+    /** Number of contexts the pool keeps ready. */
+    int size;
+
+    /**
+     * Refill the pool on a background thread instead of on the next
+     * Acquire or Refill call.
+     */
+    bool background_refill;
+
+    /**
+     * With background refilling, the number of milliseconds without
+     * Acquire or Release calls after which the pool thread sends
+     * V8::IdleNotification once.  Zero disables idle notifications.
+     */
+    int idle_notification_ms;
+  };
+
+  ContextPool(Isolate* isolate,
+              const Options& options,
+              Handle<ObjectTemplate> global_template = Handle<ObjectTemplate>(),
+              ExtensionConfiguration* extensions = NULL);
+
+  /** Stops the pool thread and disposes the contexts still in the pool. */
+  ~ContextPool();
+
+  /**
+   * Hands out a context from the pool, or creates one if the pool is
+   * empty.  The caller owns the returned handle until it is given back
+   * with Release.
+   */
+  Persistent<Context> Acquire();
+
+  /**
+   * Takes back a context returned by Acquire.  The handle must not be used
+   * afterwards.
+   */
+  void Release(Persistent<Context> context, ReleaseMode mode = kDiscard);
+
+  /** Creates contexts until the pool is full again. */
+  void Refill();
+
+  /** Returns the number of contexts ready to be handed out. */
+  int AvailableCount();
+
+ private:
+  internal::ContextPool* pool_;
+
+  // Disallow copying and assigning.
+  ContextPool(const ContextPool&);
+  void operator=(const ContextPool&);
+};
+
+
+/**
+ * A value copied out of an isolate with the structured clone algorithm,
+ * so that it can be handed to another isolate, possibly on another thread.
+ *
+ * Primitives, strings, dates, plain objects, arrays and objects with
+ * external array data can be cloned.  Shared and cyclic references are
+ * preserved.  Functions and objects with internal fields cannot be cloned.
+ */
+class V8EXPORT StructuredClone {
+ public:
+  /**
+   * Owns the backing stores of external arrays.  One delegate is normally
+   * used by all isolates of a process, so it must be thread safe.
+   */
+  class V8EXPORT Delegate {  // NOLINT
+   public:
+    virtual ~Delegate() {}
+
+    /** Allocates the backing store of an external array that is copied. */
+    virtual void* AllocateExternalArrayData(size_t size) = 0;
+
+    /** Frees a transferred backing store that was never deserialized. */
+    virtual void FreeExternalArrayData(void* data) = 0;
+
+    /**
+     * Called for every external array created by Deserialize.  From then
+     * on the embedder owns |data|, for example through a weak handle.
+     */
+    virtual void ExternalArrayCreated(Handle<Object> object, void* data) = 0;
+  };
+
+  /**
+   * Serializes |value| in the current isolate.  The backing stores of the
+   * external arrays listed in |transfer| are moved into the clone without
+   * copying, and those arrays are left with a length of zero.  Returns
+   * NULL with an exception pending if the value cannot be cloned.
+   */
+  static StructuredClone* Serialize(Handle<Value> value,
+                                    Handle<Array> transfer,
+                                    Delegate* delegate);
+
+  ~StructuredClone();
+
+  /**
+   * Creates the value in the current isolate.  Transferred backing stores
+   * are handed over, so this can only be called once.
+   */
+  Local<Value> Deserialize();
+
+  /** Returns the size of the serialized data in bytes. */
+  int length() const { return length_; }
+
+ private:
+  StructuredClone(uint8_t* data, int length,
+                  void** transferred, int transferred_count,
+                  Delegate* delegate);
+
+  uint8_t* data_;
+  int length_;
+  void** transferred_;
+  int transferred_count_;
+  Delegate* delegate_;
+
+  // Disallow copying and assigning.
+  StructuredClone(const StructuredClone&);
+  void operator=(const StructuredClone&);
+};
+
+
 /**
  * An interface for exporting data from V8, using "push" model.
  */
@@ -3800,9 +4608,9 @@ class Internals {
   static const int kFullStringRepresentationMask = 0x07;
   static const int kExternalTwoByteRepresentationTag = 0x02;
 
-  static const int kJSObjectType = 0xa6;
+  static const int kJSObjectType = 0xaa;
   static const int kFirstNonstringType = 0x80;
-  static const int kForeignType = 0x85;
+  static const int kForeignType = 0x86;
 
   static inline bool HasHeapObjectTag(internal::Object* value) {
     return ((reinterpret_cast<intptr_t>(value) & kHeapObjectTagMask) ==
@@ -3878,6 +4686,15 @@ Local<T> Local<T>::New(Handle<T> that) {
 }
 
 
+template <class T>
+Local<T> Local<T>::New(Isolate* isolate, Handle<T> that) {
+  if (that.IsEmpty()) return Local<T>();
+  internal::Object** p = reinterpret_cast<internal::Object**>(*that);
+  return Local<T>(reinterpret_cast<T*>(HandleScope::CreateHandle(
+      reinterpret_cast<internal::Isolate*>(isolate), *p)));
+}
+
+
 template <class T>
 Persistent<T> Persistent<T>::New(Handle<T> that) {
   if (that.IsEmpty()) return Persistent<T>();
@@ -3917,6 +4734,12 @@ void Persistent<T>::MakeWeak(void* parameters, WeakReferenceCallback callback) {
                callback);
 }
 
+template <class T>
+void Persistent<T>::MakeWeakBatched(void* parameters) {
+  V8::MakeWeakBatched(reinterpret_cast<internal::Object**>(**this),
+                      parameters);
+}
+
 template <class T>
 void Persistent<T>::ClearWeak() {
   V8::ClearWeak(reinterpret_cast<internal::Object**>(**this));
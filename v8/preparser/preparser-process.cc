@@ -30,6 +30,14 @@
 #include <stdio.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
 #include "../include/v8stdint.h"
 #include "../include/v8-preparser.h"
 
@@ -54,6 +62,13 @@ namespace i = v8::internal;
 // Diagnostic output is output on stderr.
 // The source file must contain only ASCII characters (UTF-8 isn't supported).
 // The file is read into memory, so it should have a reasonable size.
+//
+// Alternatively, the first argument can be the flag "--batch", followed by
+// any number of JavaScript source files. The files are preparsed in parallel
+// and the preparser data of each file is written to a file with the same
+// name and a ".preparse" suffix, in the format accepted by
+// v8::ScriptData::New. Errors are reported on stderr, and the total
+// throughput is reported on stdout.
 
 
 // Adapts an ASCII string to the UnicodeInputStream interface.
@@ -292,18 +307,311 @@ ExceptionExpectation ParseExpectation(int argc, const char* argv[]) {
 }
 
 
+// Minimal threading and timing support for the batch mode. The stand-alone
+// preparser does not link with the V8 platform layer, so the native
+// primitives are used directly.
+#ifdef _WIN32
+
+class BatchMutex {
+ public:
+  BatchMutex() { InitializeCriticalSection(&cs_); }
+  ~BatchMutex() { DeleteCriticalSection(&cs_); }
+  void Lock() { EnterCriticalSection(&cs_); }
+  void Unlock() { LeaveCriticalSection(&cs_); }
+ private:
+  CRITICAL_SECTION cs_;
+};
+
+
+typedef HANDLE BatchThread;
+
+
+static DWORD WINAPI BatchThreadEntry(LPVOID arg);
+
+
+bool StartBatchThread(BatchThread* thread, void* arg) {
+  *thread = CreateThread(NULL, 0, BatchThreadEntry, arg, 0, NULL);
+  return *thread != NULL;
+}
+
+
+void JoinBatchThread(BatchThread thread) {
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+}
+
+
+int CountProcessors() {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return static_cast<int>(info.dwNumberOfProcessors);
+}
+
+
+double CurrentTimeSeconds() {
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
+}
+
+#else  // POSIX
+
+class BatchMutex {
+ public:
+  BatchMutex() { pthread_mutex_init(&mutex_, NULL); }
+  ~BatchMutex() { pthread_mutex_destroy(&mutex_); }
+  void Lock() { pthread_mutex_lock(&mutex_); }
+  void Unlock() { pthread_mutex_unlock(&mutex_); }
+ private:
+  pthread_mutex_t mutex_;
+};
+
+
+typedef pthread_t BatchThread;
+
+
+static void* BatchThreadEntry(void* arg);
+
+
+bool StartBatchThread(BatchThread* thread, void* arg) {
+  return pthread_create(thread, NULL, BatchThreadEntry, arg) == 0;
+}
+
+
+void JoinBatchThread(BatchThread thread) {
+  pthread_join(thread, NULL);
+}
+
+
+int CountProcessors() {
+#ifdef _SC_NPROCESSORS_ONLN
+  long count = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT
+  if (count > 0) return static_cast<int>(count);
+#endif
+  return 1;
+}
+
+
+double CurrentTimeSeconds() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+#endif  // _WIN32
+
+
+// Reads a whole file into a newly allocated buffer. On failure, returns NULL
+// and stores a description of the failing step in *error.
+uint8_t* ReadFile(const char* filename, size_t* length, const char** error) {
+  FILE* input = fopen(filename, "rb");
+  if (input == NULL) {
+    *error = "Error opening file";
+    return NULL;
+  }
+  if (fseek(input, 0, SEEK_END) != 0) {
+    *error = "Error during seek";
+    fclose(input);
+    return NULL;
+  }
+  *length = static_cast<size_t>(ftell(input));
+  rewind(input);
+  uint8_t* buffer = new uint8_t[*length];
+  if (!ReadBuffer(input, buffer, *length)) {
+    *error = "Reading file";
+    delete[] buffer;
+    fclose(input);
+    return NULL;
+  }
+  fclose(input);
+  return buffer;
+}
+
+
+struct BatchEntry {
+  const char* filename;
+  size_t length;
+  bool failed;
+  char message[256];
+};
+
+
+class BatchQueue {
+ public:
+  BatchQueue(BatchEntry* entries, int count, bool write_data)
+      : entries_(entries), count_(count), next_(0), write_data_(write_data) { }
+
+  bool write_data() const { return write_data_; }
+
+  // Returns the next file to preparse, or NULL when all have been handed out.
+  BatchEntry* Next() {
+    mutex_.Lock();
+    BatchEntry* entry = (next_ < count_) ? &entries_[next_++] : NULL;
+    mutex_.Unlock();
+    return entry;
+  }
+
+ private:
+  BatchEntry* const entries_;
+  const int count_;
+  int next_;
+  const bool write_data_;
+  BatchMutex mutex_;
+};
+
+
+void PreparseBatchEntry(BatchEntry* entry, bool write_data) {
+  const char* error = NULL;
+  ScopedPointer<uint8_t> buffer(ReadFile(entry->filename,
+                                         &entry->length,
+                                         &error));
+  if (*buffer == NULL) {
+    entry->failed = true;
+    snprintf(entry->message, sizeof(entry->message), "ERROR: %s", error);
+    return;
+  }
+
+  AsciiInputStream input_buffer(*buffer, entry->length);
+  size_t kMaxStackSize = 64 * 1024 * sizeof(void*);  // NOLINT
+  v8::PreParserData data = v8::Preparse(&input_buffer, kMaxStackSize);
+  if (data.stack_overflow()) {
+    entry->failed = true;
+    snprintf(entry->message, sizeof(entry->message), "ERROR: Stack overflow");
+    return;
+  }
+  // The preparser data is allocated as an array of unsigned words, which
+  // is owned by the caller.
+  ScopedPointer<unsigned> data_owner(
+      reinterpret_cast<unsigned*>(const_cast<uint8_t*>(data.data())));
+
+  PreparseDataInterpreter reader(data.data(), static_cast<int>(data.size()));
+  if (reader.throws()) {
+    entry->failed = true;
+    snprintf(entry->message, sizeof(entry->message), "%s at location %d-%d",
+             reader.message(), reader.beg_pos(), reader.end_pos());
+    return;
+  }
+
+  if (write_data) {
+    size_t name_length = strlen(entry->filename);
+    ScopedPointer<char> data_filename(new char[name_length + 10]);
+    memcpy(*data_filename, entry->filename, name_length);
+    memcpy(*data_filename + name_length, ".preparse", 10);
+    FILE* output = fopen(*data_filename, "wb");
+    bool written = output != NULL &&
+                   WriteBuffer(output, data.data(), data.size());
+    if (output != NULL && fclose(output) != 0) written = false;
+    if (!written) {
+      entry->failed = true;
+      snprintf(entry->message, sizeof(entry->message),
+               "ERROR: Writing data to %s", *data_filename);
+    }
+  }
+}
+
+
+void RunBatchWorker(BatchQueue* queue) {
+  BatchEntry* entry;
+  while ((entry = queue->Next()) != NULL) {
+    PreparseBatchEntry(entry, queue->write_data());
+  }
+}
+
+
+#ifdef _WIN32
+static DWORD WINAPI BatchThreadEntry(LPVOID arg) {
+  RunBatchWorker(reinterpret_cast<BatchQueue*>(arg));
+  return 0;
+}
+#else
+static void* BatchThreadEntry(void* arg) {
+  RunBatchWorker(reinterpret_cast<BatchQueue*>(arg));
+  return NULL;
+}
+#endif
+
+
+int RunBatch(int argc, const char* argv[]) {
+  // Format:  preparser --batch [--threads=<n>] [--no-data] <scriptfile>...
+  int thread_count = 0;
+  bool write_data = true;
+  ScopedPointer<BatchEntry> entries(new BatchEntry[argc]);
+  int count = 0;
+  for (int arg_index = 0; arg_index < argc; arg_index++) {
+    const char* arg = argv[arg_index];
+    if (!strncmp(arg, "--threads=", 10)) {
+      thread_count = atoi(arg + 10);  // NOLINT
+    } else if (!strcmp(arg, "--no-data")) {
+      write_data = false;
+    } else if (IsFlag(arg)) {
+      fprintf(stderr, "ERROR: Unknown flag %s.\n", arg);
+      return EXIT_FAILURE;
+    } else {
+      entries[count].filename = arg;
+      entries[count].length = 0;
+      entries[count].failed = false;
+      entries[count].message[0] = '\0';
+      count++;
+    }
+  }
+  if (count == 0) {
+    fprintf(stderr, "ERROR: No filenames on command line.\n");
+    return EXIT_FAILURE;
+  }
+  if (thread_count <= 0) thread_count = CountProcessors();
+  if (thread_count > count) thread_count = count;
+
+  BatchQueue queue(*entries, count, write_data);
+  double start = CurrentTimeSeconds();
+  // The main thread takes part in the work, so only thread_count - 1
+  // additional threads are started.
+  ScopedPointer<BatchThread> threads(new BatchThread[thread_count]);
+  int started = 0;
+  while (started < thread_count - 1 &&
+         StartBatchThread(&threads[started], &queue)) {
+    started++;
+  }
+  RunBatchWorker(&queue);
+  for (int i = 0; i < started; i++) JoinBatchThread(threads[i]);
+  double elapsed = CurrentTimeSeconds() - start;
+
+  int failures = 0;
+  double total_bytes = 0;
+  for (int i = 0; i < count; i++) {
+    total_bytes += entries[i].length;
+    if (entries[i].failed) {
+      fprintf(stderr, "%s: %s\n", entries[i].filename, entries[i].message);
+      failures++;
+    }
+  }
+  fflush(stderr);
+  double megabytes = total_bytes / (1024 * 1024);
+  printf("Preparsed %d files (%.2f MB) with %d threads in %.3f s",
+         count, megabytes, started + 1, elapsed);
+  if (elapsed > 0) printf(": %.2f MB/s", megabytes / elapsed);
+  printf("\n");
+  if (failures > 0) printf("%d files failed\n", failures);
+  return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
 int main(int argc, const char* argv[]) {
   // Parse command line.
   // Format:  preparser (<scriptfile> | -e "<source>")
   //                    ["throws" [<exn-type> [<start> [<end>]]]]
   // Any flags (except an initial -e) are ignored.
   // Flags must not separate "throws" and its arguments.
+  // An initial --batch selects the multi-file mode, see RunBatch.
 
   // Check for mandatory filename argument.
   int arg_index = 1;
   if (argc <= arg_index) {
     fail(NULL, "ERROR: No filename on command line.\n");
   }
+  if (!strcmp(argv[arg_index], "--batch")) {
+    return RunBatch(argc - arg_index - 1, argv + arg_index + 1);
+  }
   const uint8_t* source = NULL;
   const char* filename = argv[arg_index];
   if (!strcmp(filename, "-e")) {
@@ -322,29 +630,14 @@ int main(int argc, const char* argv[]) {
   size_t length;
 
   if (source == NULL) {
-    // Open JS file.
-    FILE* input = fopen(filename, "rb");
-    if (input == NULL) {
-      perror("ERROR: Error opening file");
-      fflush(stderr);
-      return EXIT_FAILURE;
-    }
-    // Find length of JS file.
-    if (fseek(input, 0, SEEK_END) != 0) {
-      perror("ERROR: Error during seek");
-      fflush(stderr);
-      return EXIT_FAILURE;
-    }
-    length = static_cast<size_t>(ftell(input));
-    rewind(input);
     // Read JS file into memory buffer.
-    buffer = new uint8_t[length];
-    if (!ReadBuffer(input, *buffer, length)) {
-      perror("ERROR: Reading file");
+    const char* error = NULL;
+    buffer = ReadFile(filename, &length, &error);
+    if (*buffer == NULL) {
+      fprintf(stderr, "ERROR: %s\n", error);
       fflush(stderr);
       return EXIT_FAILURE;
     }
-    fclose(input);
     source = *buffer;
   } else {
     length = strlen(reinterpret_cast<const char*>(source));
@@ -37,6 +37,14 @@
       'sources': [
         'preparser-process.cc',
       ],
+      'conditions': [
+        ['OS=="linux" or OS=="freebsd" or OS=="openbsd" or OS=="netbsd" '
+         'or OS=="solaris"', {
+          'link_settings': {
+            'libraries': ['-lpthread'],
+          },
+        }],
+      ],
     },
   ],
 }
@@ -43,6 +43,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 /**
  * This sample program should demonstrate certain aspects of debugging
@@ -80,6 +81,31 @@ while (true) {
   print(res);
 }
 
+ *
+ * 3. The main cycle is on C++ side and hands blocks of lines to JavaScript.
+ * Program should be run with --main-cycle-batched option. C++ reads up to
+ * 4096 lines at a time and calls a function named "ProcessLines" with the
+ * block as one external string, an array of the offsets at which the lines
+ * start and the number of lines. Line i runs from offsets[i] up to the line
+ * end before offsets[i + 1]. The function returns the output for the
+ * block, without a final line end. This saves the string copy, the handles
+ * and the call that the first configuration pays for every line. If the
+ * script only declares "ProcessLine", it is called for each line of the
+ * block from JavaScript. This is a sample script:
+
+function ProcessLines(text, offsets, count) {
+  var result = [];
+  for (var i = 0; i < count; i++) {
+    result.push(">>>" + text.substring(offsets[i], offsets[i + 1] - 1));
+  }
+  return result.join("\n");
+}
+
+ *
+ * When run with "--benchmark <lines>" argument, the program generates that
+ * many lines of input, processes them with "ProcessLine" both through the
+ * first and the third configuration, and prints how long each took instead
+ * of the output.
  *
  * When run with "-p" argument, the program starts V8 Debugger Agent and
  * allows remote debugger to attach and debug JavaScript code.
@@ -102,7 +128,8 @@ while (true) {
 
 enum MainCycleType {
   CycleInCpp,
-  CycleInJs
+  CycleInJs,
+  CycleBatched
 };
 
 const char* ToCString(const v8::String::Utf8Value& value);
@@ -114,6 +141,8 @@ v8::Handle<v8::Value> Print(const v8::Arguments& args);
 v8::Handle<v8::Value> ReadLine(const v8::Arguments& args);
 bool RunCppCycle(v8::Handle<v8::Script> script, v8::Local<v8::Context> context,
                  bool report_exceptions);
+bool RunBatchedCycle(bool report_exceptions);
+bool RunBenchmark(int line_count);
 
 
 #ifdef SUPPORT_DEBUGGING
@@ -153,6 +182,7 @@ int RunMain(int argc, char* argv[]) {
 #endif
 
   MainCycleType cycle_type = CycleInCpp;
+  int benchmark_lines = 0;
 
   for (int i = 1; i < argc; i++) {
     const char* str = argv[i];
@@ -164,6 +194,11 @@ int RunMain(int argc, char* argv[]) {
       cycle_type = CycleInCpp;
     } else if (strcmp(str, "--main-cycle-in-js") == 0) {
       cycle_type = CycleInJs;
+    } else if (strcmp(str, "--main-cycle-batched") == 0) {
+      cycle_type = CycleBatched;
+    } else if (strcmp(str, "--benchmark") == 0 && i + 1 < argc) {
+      benchmark_lines = atoi(argv[i + 1]);  // NOLINT
+      i++;
 #ifdef SUPPORT_DEBUGGING
     } else if (strcmp(str, "--callback") == 0) {
       support_callback = true;
@@ -259,10 +294,14 @@ int RunMain(int argc, char* argv[]) {
     }
   }
 
-  if (cycle_type == CycleInCpp) {
+  if (benchmark_lines > 0) {
+    return !RunBenchmark(benchmark_lines);
+  } else if (cycle_type == CycleInCpp) {
     bool res = RunCppCycle(script, v8::Context::GetCurrent(),
                            report_exceptions);
     return !res;
+  } else if (cycle_type == CycleBatched) {
+    return !RunBatchedCycle(report_exceptions);
   } else {
     // All is already done.
   }
@@ -322,6 +361,333 @@ bool RunCppCycle(v8::Handle<v8::Script> script, v8::Local<v8::Context> context,
   return true;
 }
 
+
+// Lines are handed to ProcessLines in blocks of at most this many lines.
+const int kMaxBlockLines = 4096;
+
+
+// The characters of a block of lines that contains only ASCII characters.
+// V8 deletes the resource when the string is garbage collected.
+class LineBlockResource : public v8::String::ExternalAsciiStringResource {
+ public:
+  LineBlockResource(char* data, size_t length)
+      : data_(data), length_(length) {}
+  virtual ~LineBlockResource() { delete[] data_; }
+
+  virtual const char* data() const { return data_; }
+  virtual size_t length() const { return length_; }
+
+ private:
+  char* data_;
+  size_t length_;
+};
+
+
+// Hands the lines of a buffer to a ProcessLines function a block at a time.
+// The offsets array is allocated once and reused for all blocks, so a block
+// costs one string, which is external unless it has non-ASCII characters,
+// and one call.
+class LineBatcher {
+ public:
+  LineBatcher(v8::Handle<v8::Function> process_lines,
+              FILE* output,
+              bool report_exceptions)
+      : process_lines_(process_lines),
+        output_(output),
+        report_exceptions_(report_exceptions),
+        offsets_(new int32_t[kMaxBlockLines + 1]),
+        output_length_(0) {
+    offsets_object_ = v8::Persistent<v8::Object>::New(v8::Object::New());
+    offsets_object_->SetIndexedPropertiesToExternalArrayData(
+        offsets_, v8::kExternalIntArray, kMaxBlockLines + 1);
+  }
+
+  ~LineBatcher() {
+    offsets_object_.Dispose();
+    delete[] offsets_;
+  }
+
+  // Processes the complete lines at the start of data, and also the last
+  // line without a line end if at_end is true.  Returns the number of
+  // characters consumed, or -1 if ProcessLines threw an exception.
+  int Process(const char* data, int length, bool at_end);
+
+  // The number of UTF-8 characters of output, whether or not it is printed.
+  int output_length() const { return output_length_; }
+
+ private:
+  bool ProcessBlock(const char* data, int length, int count, bool ascii);
+
+  v8::Handle<v8::Function> process_lines_;
+  FILE* output_;
+  bool report_exceptions_;
+  v8::Persistent<v8::Object> offsets_object_;
+  int32_t* offsets_;
+  int output_length_;
+};
+
+
+int LineBatcher::Process(const char* data, int length, bool at_end) {
+  int consumed = 0;
+  while (consumed < length) {
+    // Offsets are in UTF-16 code units, as string indices are.
+    int count = 0;
+    int units = 0;
+    bool ascii = true;
+    int pos = consumed;
+    while (count < kMaxBlockLines && pos < length) {
+      const char* line_end = static_cast<const char*>(
+          memchr(data + pos, '\n', length - pos));
+      if (line_end == NULL && !at_end) break;
+      int next = line_end == NULL ? length : line_end - data + 1;
+      offsets_[count++] = units;
+      for (int i = pos; i < next; i++) {
+        unsigned char c = data[i];
+        if (c >= 0x80) ascii = false;
+        // Continuation bytes add nothing and four-byte sequences are
+        // surrogate pairs.
+        if ((c & 0xc0) != 0x80) units += c >= 0xf0 ? 2 : 1;
+      }
+      if (line_end == NULL) units++;  // For the line end added below.
+      pos = next;
+    }
+    if (count == 0) break;
+    offsets_[count] = units;
+    if (!ProcessBlock(data + consumed, pos - consumed, count, ascii)) {
+      return -1;
+    }
+    consumed = pos;
+  }
+  return consumed;
+}
+
+
+bool LineBatcher::ProcessBlock(const char* data, int length, int count,
+                               bool ascii) {
+  v8::HandleScope handle_scope;
+
+  // Every line of the block ends with a line end, even the last line of
+  // the input.
+  bool add_line_end = data[length - 1] != '\n';
+  int size = length + (add_line_end ? 1 : 0);
+  v8::Handle<v8::String> text;
+  if (ascii) {
+    char* chars = new char[size];
+    memcpy(chars, data, length);
+    if (add_line_end) chars[length] = '\n';
+    text = v8::String::NewExternal(new LineBlockResource(chars, size));
+  } else if (add_line_end) {
+    text = v8::String::Concat(v8::String::New(data, length),
+                              v8::String::New("\n"));
+  } else {
+    text = v8::String::New(data, length);
+  }
+
+  const int argc = 3;
+  v8::Handle<v8::Value> argv[argc] =
+      { text, offsets_object_, v8::Integer::New(count) };
+  v8::Handle<v8::Value> result;
+  {
+    v8::TryCatch try_catch;
+    result = process_lines_->Call(v8::Context::GetCurrent()->Global(),
+                                  argc, argv);
+    if (try_catch.HasCaught()) {
+      if (report_exceptions_)
+        ReportException(&try_catch);
+      return false;
+    }
+  }
+  v8::String::Utf8Value str(result);
+  output_length_ += str.length();
+  if (output_ != NULL) {
+    fprintf(output_, "%s\n", ToCString(str));
+  }
+  return true;
+}
+
+
+// Calls ProcessLine for each line of a block, for scripts that do not
+// declare ProcessLines.
+const char* kProcessLinesAdapter =
+    "(function(text, offsets, count) {\n"
+    "  var result = new Array(count);\n"
+    "  for (var i = 0; i < count; i++) {\n"
+    "    var line = text.substring(offsets[i], offsets[i + 1] - 1);\n"
+    "    result[i] = ProcessLine(line);\n"
+    "  }\n"
+    "  return result.join('\\n');\n"
+    "})";
+
+
+// Returns the script's ProcessLines function, or the adapter if the script
+// only declares ProcessLine.  Returns an empty handle if it declares
+// neither.
+v8::Handle<v8::Function> GetProcessLinesFunction(bool use_adapter) {
+  v8::HandleScope handle_scope;
+  v8::Handle<v8::Object> global = v8::Context::GetCurrent()->Global();
+  v8::Handle<v8::Value> process_val =
+      global->Get(v8::String::New("ProcessLines"));
+  if (use_adapter || !process_val->IsFunction()) {
+    if (!global->Get(v8::String::New("ProcessLine"))->IsFunction()) {
+      return v8::Handle<v8::Function>();
+    }
+    v8::Handle<v8::Script> adapter =
+        v8::Script::Compile(v8::String::New(kProcessLinesAdapter));
+    process_val = adapter->Run();
+  }
+  return handle_scope.Close(v8::Handle<v8::Function>::Cast(process_val));
+}
+
+
+bool RunBatchedCycle(bool report_exceptions) {
+#ifdef SUPPORT_DEBUGGING
+  v8::Locker lock;
+#endif
+  v8::HandleScope handle_scope;
+
+  v8::Handle<v8::Function> process_fun = GetProcessLinesFunction(false);
+  if (process_fun.IsEmpty()) {
+    printf("Error: Script does not declare 'ProcessLines' or 'ProcessLine' "
+           "global function.\n");
+    return false;
+  }
+  LineBatcher batcher(process_fun, stdout, report_exceptions);
+
+  // Lines that do not fit into the buffer make it grow.
+  int capacity = 64 * 1024;
+  char* buffer = new char[capacity];
+  int length = 0;
+  bool at_end = false;
+  bool ok = true;
+  while (ok && !at_end) {
+    if (length == capacity) {
+      char* bigger = new char[capacity * 2];
+      memcpy(bigger, buffer, length);
+      delete[] buffer;
+      buffer = bigger;
+      capacity *= 2;
+    }
+    {
+#ifdef SUPPORT_DEBUGGING
+      v8::Unlocker unlocker;
+#endif
+      length += fread(buffer + length, 1, capacity - length, stdin);
+      at_end = feof(stdin) || ferror(stdin);
+    }
+    int consumed = batcher.Process(buffer, length, at_end);
+    if (consumed < 0) {
+      ok = false;
+    } else {
+      memmove(buffer, buffer + consumed, length - consumed);
+      length -= consumed;
+    }
+  }
+  delete[] buffer;
+  return ok;
+}
+
+
+// Calls ProcessLine for each line of the input, copying every line into a
+// new string as the main cycle on C++ side does.
+bool ProcessEachLine(v8::Handle<v8::Function> process_fun,
+                     const char* data, int length, int* output_length) {
+  v8::Handle<v8::Object> global = v8::Context::GetCurrent()->Global();
+  int pos = 0;
+  while (pos < length) {
+    v8::HandleScope handle_scope;
+    const char* line_end = static_cast<const char*>(
+        memchr(data + pos, '\n', length - pos));
+    int end = line_end == NULL ? length : line_end - data;
+
+    const int argc = 1;
+    v8::Handle<v8::Value> argv[argc] =
+        { v8::String::New(data + pos, end - pos) };
+    v8::TryCatch try_catch;
+    v8::Handle<v8::Value> result = process_fun->Call(global, argc, argv);
+    if (try_catch.HasCaught()) {
+      ReportException(&try_catch);
+      return false;
+    }
+    v8::String::Utf8Value str(result);
+    // Count the line end that would be printed after each line.
+    *output_length += str.length() + 1;
+    pos = end + 1;
+  }
+  return true;
+}
+
+
+double CpuTimeMillis() {
+  return clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+
+// Generates line_count lines that look like a web server log and processes
+// them with ProcessLine line by line and in blocks.  Each way runs twice and
+// the second run is timed, so both measure optimized code.
+bool RunBenchmark(int line_count) {
+#ifdef SUPPORT_DEBUGGING
+  v8::Locker lock;
+#endif
+  v8::HandleScope handle_scope;
+
+  v8::Handle<v8::Value> process_val =
+      v8::Context::GetCurrent()->Global()->Get(
+          v8::String::New("ProcessLine"));
+  if (!process_val->IsFunction()) {
+    printf("Error: Script does not declare 'ProcessLine' global function.\n");
+    return false;
+  }
+  v8::Handle<v8::Function> process_fun =
+      v8::Handle<v8::Function>::Cast(process_val);
+  v8::Handle<v8::Function> process_lines_fun = GetProcessLinesFunction(true);
+
+  const int kMaxLineLength = 80;
+  char* input = new char[line_count * kMaxLineLength];
+  int length = 0;
+  for (int i = 0; i < line_count; i++) {
+    length += sprintf(input + length,  // NOLINT
+                      "10.0.%d.%d GET /page/%d.html 200 %d\n",
+                      (i >> 8) & 0xff, i & 0xff, i % 1000, (i * 7919) % 65536);
+  }
+
+  double per_line_time = 0;
+  double batched_time = 0;
+  int per_line_output = 0;
+  int batched_output = 0;
+  bool ok = true;
+  for (int run = 0; run < 2 && ok; run++) {
+    per_line_output = 0;
+    double start = CpuTimeMillis();
+    ok = ProcessEachLine(process_fun, input, length, &per_line_output);
+    per_line_time = CpuTimeMillis() - start;
+    if (!ok) break;
+
+    LineBatcher batcher(process_lines_fun, NULL, true);
+    start = CpuTimeMillis();
+    ok = batcher.Process(input, length, true) == length;
+    batched_time = CpuTimeMillis() - start;
+    // Count the line end that would be printed after each block.
+    batched_output =
+        batcher.output_length() + (line_count + kMaxBlockLines - 1) /
+                                  kMaxBlockLines;
+  }
+  delete[] input;
+  if (!ok) return false;
+
+  printf("per line: %d lines in %.1f ms, %.0f lines/s\n", line_count,
+         per_line_time, line_count * 1000.0 / per_line_time);
+  printf("batched:  %d lines in %.1f ms, %.0f lines/s\n", line_count,
+         batched_time, line_count * 1000.0 / batched_time);
+  if (per_line_output != batched_output) {
+    printf("Error: per line output has %d characters, batched %d.\n",
+           per_line_output, batched_output);
+    return false;
+  }
+  return true;
+}
+
+
 int main(int argc, char* argv[]) {
   int result = RunMain(argc, argv);
   v8::V8::Dispose();
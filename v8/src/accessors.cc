@@ -151,6 +151,9 @@ MaybeObject* Accessors::StringGetLength(Object* object, void*) {
   Object* value = object;
   if (object->IsJSValue()) value = JSValue::cast(object)->value();
   if (value->IsString()) return Smi::FromInt(String::cast(value)->length());
+  if (value->IsStringBuffer()) {
+    return Smi::FromInt(StringBuffer::cast(value)->length());
+  }
   // If object is not a string we return 0 to be compatible with WebKit.
   // Note: Firefox returns the length of ToString(object).
   return Smi::FromInt(0);
@@ -318,9 +321,7 @@ MaybeObject* Accessors::ScriptGetLineEnds(Object* object, void*) {
   Isolate* isolate = wrapper->GetIsolate();
   HandleScope scope(isolate);
   Handle<Script> script(Script::cast(wrapper->value()), isolate);
-  InitScriptLineEnds(script);
-  ASSERT(script->line_ends()->IsFixedArray());
-  Handle<FixedArray> line_ends(FixedArray::cast(script->line_ends()));
+  Handle<FixedArray> line_ends = GetScriptLineEnds(script);
   // We do not want anyone to modify this array from JS.
   ASSERT(*line_ends == isolate->heap()->empty_fixed_array() ||
          line_ends->map() == isolate->heap()->fixed_cow_array_map());
@@ -575,15 +576,17 @@ static MaybeObject* ConstructArgumentsObjectForInlinedFunction(
     int inlined_frame_index) {
   Factory* factory = Isolate::Current()->factory();
   int args_count = inlined_function->shared()->formal_parameter_count();
-  ScopedVector<SlotRef> args_slots(args_count);
+  List<SlotRef> args_slots(args_count);
   SlotRef::ComputeSlotMappingForArguments(frame,
                                           inlined_frame_index,
+                                          args_count,
                                           &args_slots);
   Handle<JSObject> arguments =
       factory->NewArgumentsObject(inlined_function, args_count);
   Handle<FixedArray> array = factory->NewFixedArray(args_count);
+  int slot_index = 0;
   for (int i = 0; i < args_count; ++i) {
-    Handle<Object> value = args_slots[i].GetValue();
+    Handle<Object> value = SlotRef::GetNextValue(args_slots, &slot_index);
     array->set(i, *value);
   }
   arguments->set_elements(*array);
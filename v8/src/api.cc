@@ -32,12 +32,15 @@
 #include "arguments.h"
 #include "bootstrapper.h"
 #include "compiler.h"
+#include "date.h"
 #include "debug.h"
 #include "deoptimizer.h"
 #include "execution.h"
 #include "flags.h"
 #include "global-handles.h"
 #include "heap-profiler.h"
+#include "ic-inl.h"
+#include "lz-codec.h"
 #include "messages.h"
 #include "natives.h"
 #include "parser.h"
@@ -274,7 +277,15 @@ static inline bool EmptyCheck(const char* location, const v8::Data* obj) {
 // --- S t a t i c s ---
 
 
+#ifdef COMPRESS_STARTUP_DATA_LZ
+static void DecompressStartupData();
+#endif
+
+
 static bool InitializeHelper() {
+#ifdef COMPRESS_STARTUP_DATA_LZ
+  DecompressStartupData();
+#endif
   if (i::Snapshot::Initialize()) return true;
   return i::V8::Initialize(NULL);
 }
@@ -349,8 +360,10 @@ int StartupDataDecompressor::Decompress() {
 
 
 StartupData::CompressionAlgorithm V8::GetCompressedStartupDataAlgorithm() {
-#ifdef COMPRESS_STARTUP_DATA_BZ2
+#if defined(COMPRESS_STARTUP_DATA_BZ2)
   return StartupData::kBZip2;
+#elif defined(COMPRESS_STARTUP_DATA_LZ)
+  return StartupData::kBuiltIn;
 #else
   return StartupData::kUncompressed;
 #endif
@@ -375,7 +388,7 @@ int V8::GetCompressedStartupDataCount() {
 
 
 void V8::GetCompressedStartupData(StartupData* compressed_data) {
-#ifdef COMPRESS_STARTUP_DATA_BZ2
+#if defined(COMPRESS_STARTUP_DATA_BZ2) || defined(COMPRESS_STARTUP_DATA_LZ)
   compressed_data[kSnapshot].data =
       reinterpret_cast<const char*>(i::Snapshot::data());
   compressed_data[kSnapshot].compressed_size = i::Snapshot::size();
@@ -406,7 +419,7 @@ void V8::GetCompressedStartupData(StartupData* compressed_data) {
 
 
 void V8::SetDecompressedStartupData(StartupData* decompressed_data) {
-#ifdef COMPRESS_STARTUP_DATA_BZ2
+#if defined(COMPRESS_STARTUP_DATA_BZ2) || defined(COMPRESS_STARTUP_DATA_LZ)
   ASSERT_EQ(i::Snapshot::raw_size(), decompressed_data[kSnapshot].raw_size);
   i::Snapshot::set_raw_data(
       reinterpret_cast<const i::byte*>(decompressed_data[kSnapshot].data));
@@ -434,6 +447,36 @@ void V8::SetDecompressedStartupData(StartupData* decompressed_data) {
 }
 
 
+#ifdef COMPRESS_STARTUP_DATA_LZ
+static i::Mutex* startup_data_mutex = i::OS::CreateMutex();
+static bool startup_data_decompressed = false;
+
+
+// Decompresses the startup data, which was compressed with the built-in
+// codec, the first time V8 is initialized.  The decompressed data is never
+// freed since the natives sources are used as external strings.
+static void DecompressStartupData() {
+  i::ScopedLock lock(startup_data_mutex);
+  if (startup_data_decompressed) return;
+  StartupData data[kCompressedStartupDataCount];
+  V8::GetCompressedStartupData(data);
+  for (int i = 0; i < kCompressedStartupDataCount; ++i) {
+    char* decompressed = i::NewArray<char>(data[i].raw_size);
+    i::Vector<const i::byte> input(
+        reinterpret_cast<const i::byte*>(data[i].data),
+        data[i].compressed_size);
+    i::Vector<i::byte> output(reinterpret_cast<i::byte*>(decompressed),
+                              data[i].raw_size);
+    CHECK(data[i].compressed_size == 0 ||
+          i::LZCodec::Decompress(input, output));
+    data[i].data = decompressed;
+  }
+  V8::SetDecompressedStartupData(data);
+  startup_data_decompressed = true;
+}
+#endif
+
+
 void V8::SetFatalErrorHandler(FatalErrorCallback that) {
   i::Isolate* isolate = EnterIsolateIfNeeded();
   isolate->set_exception_behavior(that);
@@ -559,7 +602,11 @@ ResourceConstraints::ResourceConstraints()
   : max_young_space_size_(0),
     max_old_space_size_(0),
     max_executable_size_(0),
-    stack_limit_(NULL) { }
+    stack_limit_(NULL),
+    max_incremental_marking_step_(0),
+    incremental_marking_growth_target_(0),
+    stub_cache_size_(0),
+    lookup_cache_size_(0) { }
 
 
 bool SetResourceConstraints(ResourceConstraints* constraints) {
@@ -580,6 +627,22 @@ bool SetResourceConstraints(ResourceConstraints* constraints) {
     uintptr_t limit = reinterpret_cast<uintptr_t>(constraints->stack_limit());
     isolate->stack_guard()->SetStackLimit(limit);
   }
+  if (constraints->max_incremental_marking_step() != 0 ||
+      constraints->incremental_marking_growth_target() != 0) {
+    isolate->heap()->incremental_marking()->SetPauseTarget(
+        constraints->max_incremental_marking_step(),
+        constraints->incremental_marking_growth_target());
+  }
+  if (constraints->stub_cache_size() != 0) {
+    // The stub cache tables are allocated during initialization.
+    ASSERT(!isolate->IsInitialized());
+    isolate->set_stub_cache_size(constraints->stub_cache_size());
+  }
+  if (constraints->lookup_cache_size() != 0) {
+    // The lookup caches are allocated during initialization.
+    ASSERT(!isolate->IsInitialized());
+    isolate->set_lookup_cache_size(constraints->lookup_cache_size());
+  }
   return true;
 }
 
@@ -603,6 +666,13 @@ void V8::MakeWeak(i::Object** object, void* parameters,
 }
 
 
+void V8::MakeWeakBatched(i::Object** object, void* parameters) {
+  i::Isolate* isolate = i::Isolate::Current();
+  LOG_API(isolate, "MakeWeakBatched");
+  isolate->global_handles()->MakeWeakBatched(object, parameters);
+}
+
+
 void V8::ClearWeak(i::Object** obj) {
   i::Isolate* isolate = i::Isolate::Current();
   LOG_API(isolate, "ClearWeak");
@@ -656,6 +726,20 @@ HandleScope::HandleScope() {
 }
 
 
+HandleScope::HandleScope(Isolate* isolate) {
+  i::Isolate* internal_isolate = reinterpret_cast<i::Isolate*>(isolate);
+  ASSERT(internal_isolate == i::Isolate::Current());
+  API_ENTRY_CHECK(internal_isolate, "HandleScope::HandleScope");
+  v8::ImplementationUtilities::HandleScopeData* current =
+      internal_isolate->handle_scope_data();
+  isolate_ = internal_isolate;
+  prev_next_ = current->next;
+  prev_limit_ = current->limit;
+  is_closed_ = false;
+  current->level++;
+}
+
+
 HandleScope::~HandleScope() {
   if (!is_closed_) {
     Leave();
@@ -700,6 +784,12 @@ i::Object** HandleScope::CreateHandle(i::HeapObject* value) {
 }
 
 
+i::Object** HandleScope::CreateHandle(i::Isolate* isolate, i::Object* value) {
+  ASSERT(isolate == i::Isolate::Current());
+  return i::HandleScope::CreateHandle(value, isolate);
+}
+
+
 void Context::Enter() {
   i::Handle<i::Context> env = Utils::OpenHandle(this);
   i::Isolate* isolate = env->GetIsolate();
@@ -1022,6 +1112,33 @@ void FunctionTemplate::SetCallHandler(InvocationCallback callback,
 }
 
 
+void FunctionTemplate::SetFastCallHandler(FastCallFunction function,
+                                          const FastCallSignature& signature) {
+  i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
+  if (IsDeadCheck(isolate, "v8::FunctionTemplate::SetFastCallHandler()")) {
+    return;
+  }
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Object* call_code = Utils::OpenHandle(this)->call_code();
+  if (!ApiCheck(!call_code->IsUndefined(),
+                "v8::FunctionTemplate::SetFastCallHandler()",
+                "SetCallHandler must be called first")) {
+    return;
+  }
+  i::Handle<i::CallHandlerInfo> obj(i::CallHandlerInfo::cast(call_code));
+  int bits = i::CallHandlerInfo::FastResultField::encode(signature.result()) |
+      i::CallHandlerInfo::FastArgumentCountField::encode(
+          signature.argument_count());
+  for (int i = 0; i < signature.argument_count(); i++) {
+    ASSERT(signature.argument(i) != FastCallSignature::kVoid);
+    bits |= signature.argument(i) << i::CallHandlerInfo::FastArgumentShift(i);
+  }
+  SET_FIELD_WRAPPED(obj, set_fast_callback, function);
+  obj->set_fast_signature(i::Smi::FromInt(bits));
+}
+
+
 static i::Handle<i::AccessorInfo> MakeAccessorInfo(
       v8::Handle<String> name,
       AccessorGetter getter,
@@ -1044,6 +1161,24 @@ static i::Handle<i::AccessorInfo> MakeAccessorInfo(
 }
 
 
+static void AddPropertyAccessor(i::Handle<i::FunctionTemplateInfo> info,
+                                i::Handle<i::AccessorInfo> obj) {
+  i::Handle<i::Object> list(info->property_accessors());
+  if (list->IsUndefined()) {
+    list = NeanderArray().value();
+    info->set_property_accessors(*list);
+  }
+  NeanderArray array(list);
+  array.add(obj);
+}
+
+
+static v8::Handle<Value> InternalFieldGetter(Local<String> name,
+                                             const AccessorInfo& info) {
+  return info.Holder()->GetInternalField(info.Data()->Int32Value());
+}
+
+
 void FunctionTemplate::AddInstancePropertyAccessor(
       v8::Handle<String> name,
       AccessorGetter getter,
@@ -1062,13 +1197,7 @@ void FunctionTemplate::AddInstancePropertyAccessor(
   i::Handle<i::AccessorInfo> obj = MakeAccessorInfo(name,
                                                     getter, setter, data,
                                                     settings, attributes);
-  i::Handle<i::Object> list(Utils::OpenHandle(this)->property_accessors());
-  if (list->IsUndefined()) {
-    list = NeanderArray().value();
-    Utils::OpenHandle(this)->set_property_accessors(*list);
-  }
-  NeanderArray array(list);
-  array.add(obj);
+  AddPropertyAccessor(Utils::OpenHandle(this), obj);
 }
 
 
@@ -1264,6 +1393,33 @@ void ObjectTemplate::SetAccessor(v8::Handle<String> name,
 }
 
 
+void ObjectTemplate::SetInternalFieldAccessor(v8::Handle<String> name,
+                                              int index,
+                                              PropertyAttribute attribute) {
+  i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
+  if (IsDeadCheck(isolate, "v8::ObjectTemplate::SetInternalFieldAccessor()")) {
+    return;
+  }
+  if (!ApiCheck(index >= 0,
+                "v8::ObjectTemplate::SetInternalFieldAccessor()",
+                "Invalid internal field index")) {
+    return;
+  }
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  EnsureConstructor(this);
+  i::FunctionTemplateInfo* constructor =
+      i::FunctionTemplateInfo::cast(Utils::OpenHandle(this)->constructor());
+  i::Handle<i::FunctionTemplateInfo> cons(constructor);
+  i::Handle<i::AccessorInfo> obj =
+      MakeAccessorInfo(name, InternalFieldGetter, 0,
+                       v8::Integer::New(index), DEFAULT,
+                       static_cast<PropertyAttribute>(attribute | ReadOnly));
+  obj->set_is_internal_field(true);
+  AddPropertyAccessor(cons, obj);
+}
+
+
 void ObjectTemplate::SetNamedPropertyHandler(NamedPropertyGetter getter,
                                              NamedPropertySetter setter,
                                              NamedPropertyQuery query,
@@ -1289,6 +1445,40 @@ void ObjectTemplate::SetNamedPropertyHandler(NamedPropertyGetter getter,
 }
 
 
+void ObjectTemplate::SetNamedPropertyHandlerKeys(Handle<Array> keys) {
+  i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
+  if (IsDeadCheck(isolate,
+                  "v8::ObjectTemplate::SetNamedPropertyHandlerKeys()")) {
+    return;
+  }
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  EnsureConstructor(this);
+  i::FunctionTemplateInfo* constructor =
+      i::FunctionTemplateInfo::cast(Utils::OpenHandle(this)->constructor());
+  i::Object* handler = constructor->named_property_handler();
+  if (!ApiCheck(!handler->IsUndefined(),
+                "v8::ObjectTemplate::SetNamedPropertyHandlerKeys()",
+                "SetNamedPropertyHandler must be called first")) {
+    return;
+  }
+  i::Handle<i::InterceptorInfo> interceptor(i::InterceptorInfo::cast(handler));
+  int length = keys->Length();
+  i::Handle<i::FixedArray> names = isolate->factory()->NewFixedArray(length);
+  for (int i = 0; i < length; i++) {
+    i::Handle<i::Object> key = Utils::OpenHandle(*keys->Get(i));
+    if (!ApiCheck(key->IsString(),
+                  "v8::ObjectTemplate::SetNamedPropertyHandlerKeys()",
+                  "Keys must be strings")) {
+      return;
+    }
+    names->set(i, *isolate->factory()->LookupSymbol(
+        i::Handle<i::String>::cast(key)));
+  }
+  interceptor->set_keys(*names);
+}
+
+
 void ObjectTemplate::MarkAsUndetectable() {
   i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
   if (IsDeadCheck(isolate, "v8::ObjectTemplate::MarkAsUndetectable()")) return;
@@ -1417,12 +1607,32 @@ ScriptData* ScriptData::PreCompile(const char* input, int length) {
 }
 
 
+ScriptData* ScriptData::PreCompileInBackground(const char* input,
+                                               int length,
+                                               size_t max_stack_size) {
+  // No isolate is entered on a background thread; derive the stack limit
+  // from the current stack position instead of the isolate's stack guard.
+  int limit_marker;
+  uintptr_t stack_limit =
+      reinterpret_cast<uintptr_t>(&limit_marker) - max_stack_size;
+  i::Utf8ToUC16CharacterStream stream(
+      reinterpret_cast<const unsigned char*>(input), length);
+  return i::ParserApi::PreParseWithoutIsolate(&stream,
+                                              i::FLAG_harmony_scoping,
+                                              stack_limit);
+}
+
+
 ScriptData* ScriptData::PreCompile(v8::Handle<String> source) {
   i::Handle<i::String> str = Utils::OpenHandle(*source);
   if (str->IsExternalTwoByteString()) {
     i::ExternalTwoByteStringUC16CharacterStream stream(
       i::Handle<i::ExternalTwoByteString>::cast(str), 0, str->length());
     return i::ParserApi::PreParse(&stream, NULL, i::FLAG_harmony_scoping);
+  } else if (str->IsExternalAsciiString()) {
+    i::ExternalAsciiStringUC16CharacterStream stream(
+      i::Handle<i::ExternalAsciiString>::cast(str), 0, str->length());
+    return i::ParserApi::PreParse(&stream, NULL, i::FLAG_harmony_scoping);
   } else {
     i::GenericStringUC16CharacterStream stream(str, 0, str->length());
     return i::ParserApi::PreParse(&stream, NULL, i::FLAG_harmony_scoping);
@@ -1479,11 +1689,15 @@ Local<Script> Script::New(v8::Handle<String> source,
   }
   EXCEPTION_PREAMBLE(isolate);
   i::ScriptDataImpl* pre_data_impl = static_cast<i::ScriptDataImpl*>(pre_data);
+  // Code caches are validated against the source when they are used.
+  bool is_code_cache = pre_data_impl != NULL && pre_data_impl->is_code_cache();
   // We assert that the pre-data is sane, even though we can actually
   // handle it if it turns out not to be in release mode.
-  ASSERT(pre_data_impl == NULL || pre_data_impl->SanityCheck());
+  ASSERT(pre_data_impl == NULL || is_code_cache ||
+         pre_data_impl->SanityCheck());
   // If the pre-data isn't sane we simply ignore it
-  if (pre_data_impl != NULL && !pre_data_impl->SanityCheck()) {
+  if (pre_data_impl != NULL && !is_code_cache &&
+      !pre_data_impl->SanityCheck()) {
     pre_data_impl = NULL;
   }
   i::Handle<i::SharedFunctionInfo> result =
@@ -1538,6 +1752,139 @@ Local<Script> Script::Compile(v8::Handle<String> source,
 }
 
 
+Local<Script> Script::CompileWithFrontEnd(v8::Handle<String> source,
+                                          v8::Handle<Value> file_name,
+                                          v8::ScriptData* code_cache) {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::Script::CompileWithFrontEnd()",
+             return Local<Script>());
+  LOG_API(isolate, "Script::CompileWithFrontEnd");
+  if (!ApiCheck(isolate->parser_front_end() != NULL,
+                "v8::Script::CompileWithFrontEnd()",
+                "No parser front end installed")) {
+    return Local<Script>();
+  }
+  ENTER_V8(isolate);
+  i::Handle<i::String> str = Utils::OpenHandle(*source);
+  i::Handle<i::Object> name_obj;
+  if (!file_name.IsEmpty()) name_obj = Utils::OpenHandle(*file_name);
+  i::ScriptDataImpl* pre_data = static_cast<i::ScriptDataImpl*>(code_cache);
+  EXCEPTION_PREAMBLE(isolate);
+  i::Handle<i::SharedFunctionInfo> function =
+      i::Compiler::CompileWithFrontEnd(str, name_obj, pre_data);
+  has_pending_exception = function.is_null();
+  EXCEPTION_BAILOUT_CHECK(isolate, Local<Script>());
+  i::Handle<i::JSFunction> result =
+      isolate->factory()->NewFunctionFromSharedFunctionInfo(
+          function,
+          isolate->global_context());
+  return Local<Script>(ToApi<Script>(result));
+}
+
+
+// The isolate half of Script::CompileAsync: compiles the script in the
+// context CompileAsync was called in, with the preparse data if the
+// background half produced any, and reports the result.
+class CompileScriptTask : public Task {
+ public:
+  CompileScriptTask(Isolate* isolate,
+                    Handle<String> source,
+                    Handle<Value> file_name,
+                    Script::CompiledCallback callback,
+                    void* data)
+      : isolate_(isolate),
+        context_(Persistent<Context>::New(Context::GetCurrent())),
+        source_(Persistent<String>::New(source)),
+        file_name_(Persistent<Value>::New(file_name)),
+        callback_(callback),
+        data_(data),
+        utf8_(NULL),
+        utf8_length_(0),
+        pre_data_(NULL) { }
+
+  ~CompileScriptTask() {
+    context_.Dispose();
+    source_.Dispose();
+    file_name_.Dispose();
+    i::DeleteArray(utf8_);
+    delete pre_data_;
+  }
+
+  // Copies the source for the preparser, which must not touch the heap.
+  void PrepareForBackgroundPreparse() {
+    utf8_length_ = source_->Utf8Length();
+    utf8_ = i::NewArray<char>(utf8_length_ + 1);
+    source_->WriteUtf8(utf8_, utf8_length_ + 1);
+  }
+
+  // Runs on a background thread.
+  void Preparse() {
+    pre_data_ = ScriptData::PreCompileInBackground(
+        utf8_, utf8_length_, i::FLAG_stack_size * i::KB);
+  }
+
+  Isolate* isolate() { return isolate_; }
+
+  void Run() {
+    HandleScope scope;
+    Context::Scope context_scope(context_);
+    TryCatch try_catch;
+    ScriptOrigin origin(file_name_);
+    Local<Script> script = Script::Compile(source_, &origin, pre_data_);
+    callback_(script, try_catch.Exception(), data_);
+  }
+
+ private:
+  Isolate* isolate_;
+  Persistent<Context> context_;
+  Persistent<String> source_;
+  Persistent<Value> file_name_;
+  Script::CompiledCallback callback_;
+  void* data_;
+  char* utf8_;
+  int utf8_length_;
+  ScriptData* pre_data_;
+};
+
+
+// The background half of Script::CompileAsync: preparses the source and
+// then hands the compilation back to the isolate's thread.
+class PreparseScriptTask : public Task {
+ public:
+  explicit PreparseScriptTask(CompileScriptTask* compile)
+      : compile_(compile) { }
+
+  void Run() {
+    compile_->Preparse();
+    i::V8::task_runner()->PostIsolateTask(compile_->isolate(), compile_);
+  }
+
+ private:
+  CompileScriptTask* compile_;
+};
+
+
+void Script::CompileAsync(v8::Handle<String> source,
+                          v8::Handle<Value> file_name,
+                          CompiledCallback callback,
+                          void* data) {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::Script::CompileAsync()", return);
+  LOG_API(isolate, "Script::CompileAsync");
+  ENTER_V8(isolate);
+  CompileScriptTask* compile = new CompileScriptTask(
+      reinterpret_cast<Isolate*>(isolate), source, file_name, callback, data);
+  TaskRunner* runner = i::V8::task_runner();
+  if (runner == NULL) {
+    compile->Run();
+    delete compile;
+    return;
+  }
+  compile->PrepareForBackgroundPreparse();
+  runner->PostBackgroundTask(new PreparseScriptTask(compile));
+}
+
+
 Local<Value> Script::Run() {
   i::Isolate* isolate = i::Isolate::Current();
   ON_BAILOUT(isolate, "v8::Script::Run()", return Local<Value>());
@@ -1614,6 +1961,17 @@ void Script::SetData(v8::Handle<String> data) {
 }
 
 
+ScriptData* Script::CreateCodeCache() {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::Script::CreateCodeCache()", return NULL);
+  LOG_API(isolate, "Script::CreateCodeCache");
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Handle<i::SharedFunctionInfo> function_info = OpenScript(this);
+  return i::CodeSerializer::Serialize(function_info);
+}
+
+
 // --- E x c e p t i o n s ---
 
 
@@ -2169,7 +2527,7 @@ bool Value::IsDate() const {
   i::Isolate* isolate = i::Isolate::Current();
   if (IsDeadCheck(isolate, "v8::Value::IsDate()")) return false;
   i::Handle<i::Object> obj = Utils::OpenHandle(this);
-  return obj->HasSpecificClassOf(isolate->heap()->Date_symbol());
+  return obj->IsJSDate();
 }
 
 
@@ -2421,7 +2779,7 @@ void v8::Date::CheckCast(v8::Value* that) {
   i::Isolate* isolate = i::Isolate::Current();
   if (IsDeadCheck(isolate, "v8::Date::Cast()")) return;
   i::Handle<i::Object> obj = Utils::OpenHandle(that);
-  ApiCheck(obj->HasSpecificClassOf(isolate->heap()->Date_symbol()),
+  ApiCheck(obj->IsJSDate(),
            "v8::Date::Cast()",
            "Could not convert to date");
 }
@@ -3577,6 +3935,88 @@ Local<v8::Value> Function::Call(v8::Handle<v8::Object> recv, int argc,
 }
 
 
+PreparedCall::PreparedCall(v8::Handle<v8::Function> function,
+                           v8::Handle<v8::Object> recv,
+                           int argc)
+    : isolate_(NULL),
+      function_(NULL),
+      receiver_(NULL),
+      arguments_(NULL),
+      argv_(NULL),
+      argc_(argc) {
+  i::Handle<i::JSFunction> fun = Utils::OpenHandle(*function);
+  i::Isolate* isolate = fun->GetIsolate();
+  if (IsDeadCheck(isolate, "v8::PreparedCall::PreparedCall()")) return;
+  if (!ApiCheck(argc >= 0,
+                "v8::PreparedCall::PreparedCall()",
+                "Negative argument count")) {
+    return;
+  }
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::GlobalHandles* global_handles = isolate->global_handles();
+  isolate_ = isolate;
+  function_ = global_handles->Create(*fun).location();
+  receiver_ = global_handles->Create(*Utils::OpenHandle(*recv)).location();
+  i::Handle<i::FixedArray> arguments =
+      isolate->factory()->NewFixedArray(argc, i::TENURED);
+  arguments_ = global_handles->Create(*arguments).location();
+  argv_ = i::NewArray<i::Object**>(argc > 0 ? argc : 1);
+}
+
+
+PreparedCall::~PreparedCall() {
+  if (isolate_ == NULL) return;
+  i::GlobalHandles* global_handles = isolate_->global_handles();
+  global_handles->Destroy(function_);
+  global_handles->Destroy(receiver_);
+  global_handles->Destroy(arguments_);
+  i::DeleteArray(argv_);
+}
+
+
+void PreparedCall::SetArgument(int index, v8::Handle<v8::Value> value) {
+  if (isolate_ == NULL) return;
+  if (IsDeadCheck(isolate_, "v8::PreparedCall::SetArgument()")) return;
+  if (!ApiCheck(index >= 0 && index < argc_,
+                "v8::PreparedCall::SetArgument()",
+                "Argument index out of range")) {
+    return;
+  }
+  i::FixedArray::cast(*arguments_)->set(index, *Utils::OpenHandle(*value));
+}
+
+
+Local<v8::Value> PreparedCall::Call() {
+  i::Isolate* isolate = isolate_;
+  if (isolate == NULL) return Local<v8::Value>();
+  ON_BAILOUT(isolate, "v8::PreparedCall::Call()", return Local<v8::Value>());
+  LOG_API(isolate, "PreparedCall::Call");
+  ENTER_V8(isolate);
+  i::Object* raw_result = NULL;
+  {
+    i::HandleScope scope(isolate);
+    // The function, the receiver and the arguments are held by global
+    // handles, so no local handles are needed.  The argument buffer points
+    // into the arguments array.  Like Function::Call, the receiver is not
+    // converted, so nothing allocates before the entry stub has copied the
+    // arguments.
+    i::Handle<i::JSFunction> fun(reinterpret_cast<i::JSFunction**>(function_));
+    i::Handle<i::Object> recv_obj(receiver_);
+    i::Object** slots = i::FixedArray::cast(*arguments_)->data_start();
+    for (int i = 0; i < argc_; i++) argv_[i] = slots + i;
+    i::Handle<i::Object>* args = reinterpret_cast<i::Handle<i::Object>*>(argv_);
+    EXCEPTION_PREAMBLE(isolate);
+    i::Handle<i::Object> returned =
+        i::Execution::Call(fun, recv_obj, argc_, args, &has_pending_exception);
+    EXCEPTION_BAILOUT_CHECK(isolate, Local<Object>());
+    raw_result = *returned;
+  }
+  i::Handle<i::Object> result(raw_result);
+  return Utils::ToLocal(result);
+}
+
+
 void Function::SetName(v8::Handle<v8::String> name) {
   i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
   ENTER_V8(isolate);
@@ -3636,6 +4076,58 @@ Handle<Value> Function::GetScriptId() const {
   return Utils::ToLocal(i::Handle<i::Object>(script->id()));
 }
 
+
+bool Function::IsOptimizationDisabled() const {
+  i::Handle<i::JSFunction> func = Utils::OpenHandle(this);
+  return func->shared()->optimization_disabled();
+}
+
+
+Handle<Value> Function::GetBailoutReason() const {
+  i::Handle<i::JSFunction> func = Utils::OpenHandle(this);
+  return Utils::ToLocal(
+      i::Handle<i::Object>(func->shared()->last_bailout_reason()));
+}
+
+
+Local<Array> Function::GetBailoutReasons() const {
+  i::Handle<i::JSFunction> func = Utils::OpenHandle(this);
+  i::Isolate* isolate = func->GetIsolate();
+  ON_BAILOUT(isolate, "v8::Function::GetBailoutReasons()",
+             return Local<v8::Array>());
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Factory* factory = isolate->factory();
+  i::Handle<i::FixedArray> reasons = factory->empty_fixed_array();
+  if (func->shared()->bailout_reasons()->IsFixedArray()) {
+    reasons = i::Handle<i::FixedArray>(
+        i::FixedArray::cast(func->shared()->bailout_reasons()));
+  }
+  int length = reasons->length() / 2;
+  i::Handle<i::FixedArray> elements = factory->NewFixedArray(length);
+  for (int index = 0; index < length; index++) {
+    i::Handle<i::FixedArray> pair = factory->NewFixedArray(2);
+    pair->set(0, reasons->get(2 * index));
+    pair->set(1, reasons->get(2 * index + 1));
+    elements->set(index, *factory->NewJSArrayWithElements(pair));
+  }
+  i::Handle<i::JSArray> result = factory->NewJSArrayWithElements(elements);
+  return Utils::ToLocal(scope.CloseAndEscape(result));
+}
+
+
+int Function::GetDeoptimizationCount() const {
+  i::Handle<i::JSFunction> func = Utils::OpenHandle(this);
+  i::Object* history = func->shared()->deopt_history();
+  if (!history->IsFixedArray()) return 0;
+  int count = 0;
+  for (int index = 1; index < i::FixedArray::cast(history)->length();
+       index += 2) {
+    count += i::Smi::cast(i::FixedArray::cast(history)->get(index))->value();
+  }
+  return count;
+}
+
 int String::Length() const {
   i::Handle<i::String> str = Utils::OpenHandle(this);
   if (IsDeadCheck(str->GetIsolate(), "v8::String::Length()")) return 0;
@@ -3683,7 +4175,15 @@ int String::WriteUtf8(char* buffer,
     // using StringInputBuffer or Get(i) to access the characters.
     FlattenString(str);
   }
-  write_input_buffer.Reset(0, *str);
+  // Flat strings are encoded straight from their characters; others are
+  // read through the input buffer.
+  i::String::FlatContent content = str->GetFlatContent();
+  const i::uc16* chars = NULL;
+  if (content.IsTwoByte()) {
+    chars = content.ToUC16Vector().start();
+  } else {
+    write_input_buffer.Reset(0, *str);
+  }
   int len = str->length();
   // Encode the first K - 3 bytes directly into the buffer since we
   // know there's room for them.  If no capacity is given we copy all
@@ -3693,7 +4193,7 @@ int String::WriteUtf8(char* buffer,
   int pos = 0;
   int nchars = 0;
   for (i = 0; i < len && (capacity == -1 || pos < fast_end); i++) {
-    i::uc32 c = write_input_buffer.GetNext();
+    i::uc32 c = chars != NULL ? chars[i] : write_input_buffer.GetNext();
     int written = unibrow::Utf8::Encode(buffer + pos, c);
     pos += written;
     nchars++;
@@ -3704,7 +4204,7 @@ int String::WriteUtf8(char* buffer,
     // buffer.
     char intermediate[unibrow::Utf8::kMaxEncodedSize];
     for (; i < len && pos < capacity; i++) {
-      i::uc32 c = write_input_buffer.GetNext();
+      i::uc32 c = chars != NULL ? chars[i] : write_input_buffer.GetNext();
       int written = unibrow::Utf8::Encode(intermediate, c);
       if (pos + written <= capacity) {
         for (int j = 0; j < written; j++)
@@ -3983,6 +4483,16 @@ void v8::V8::SetEntropySource(EntropySource source) {
 }
 
 
+void v8::V8::SetTaskRunner(TaskRunner* runner) {
+  i::V8::SetTaskRunner(runner);
+}
+
+
+void v8::V8::EnableCodeCacheCreation() {
+  i::Serializer::Enable();
+}
+
+
 bool v8::V8::Dispose() {
   i::Isolate* isolate = i::Isolate::Current();
   if (!ApiCheck(isolate != NULL && isolate->IsDefaultIsolate(),
@@ -3998,7 +4508,24 @@ bool v8::V8::Dispose() {
 HeapStatistics::HeapStatistics(): total_heap_size_(0),
                                   total_heap_size_executable_(0),
                                   used_heap_size_(0),
-                                  heap_size_limit_(0) { }
+                                  heap_size_limit_(0),
+                                  startup_heap_size_(0),
+                                  startup_committed_heap_size_(0) {
+  for (int i = 0; i < kNumberOfExternalMemoryTypes; i++) {
+    external_memory_size_[i] = 0;
+  }
+}
+
+
+GCEvent::GCEvent(): type_(kGCTypeScavenge),
+                    pause_time_(0),
+                    size_before_(0),
+                    size_after_(0),
+                    promoted_bytes_(0),
+                    incremental_steps_count_(0),
+                    incremental_steps_time_(0) {
+  for (int i = 0; i < kNumberOfPhases; i++) phase_times_[i] = 0;
+}
 
 
 void v8::V8::GetHeapStatistics(HeapStatistics* heap_statistics) {
@@ -4008,6 +4535,12 @@ void v8::V8::GetHeapStatistics(HeapStatistics* heap_statistics) {
     heap_statistics->set_total_heap_size_executable(0);
     heap_statistics->set_used_heap_size(0);
     heap_statistics->set_heap_size_limit(0);
+    heap_statistics->set_startup_heap_size(0);
+    heap_statistics->set_startup_committed_heap_size(0);
+    for (int i = 0; i < kNumberOfExternalMemoryTypes; i++) {
+      heap_statistics->set_external_memory_size(
+          static_cast<ExternalMemoryType>(i), 0);
+    }
     return;
   }
 
@@ -4017,6 +4550,86 @@ void v8::V8::GetHeapStatistics(HeapStatistics* heap_statistics) {
       heap->CommittedMemoryExecutable());
   heap_statistics->set_used_heap_size(heap->SizeOfObjects());
   heap_statistics->set_heap_size_limit(heap->MaxReserved());
+  heap_statistics->set_startup_heap_size(heap->startup_size());
+  heap_statistics->set_startup_committed_heap_size(
+      heap->startup_committed_memory());
+  for (int i = 0; i < kNumberOfExternalMemoryTypes; i++) {
+    ExternalMemoryType type = static_cast<ExternalMemoryType>(i);
+    heap_statistics->set_external_memory_size(
+        type, heap->amount_of_external_allocated_memory(type));
+  }
+}
+
+
+void v8::V8::VisitRuntimeCallStats(RuntimeCallStatsVisitor* visitor) {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (isolate == NULL || !isolate->IsInitialized()) return;
+  i::List<i::RuntimeCallStats::Entry> entries;
+  isolate->runtime_call_stats()->GetSortedEntries(&entries);
+  for (int i = 0; i < entries.length(); i++) {
+    visitor->VisitRuntimeCall(entries[i].name,
+                              entries[i].count,
+                              static_cast<double>(entries[i].time) / 1000);
+  }
+}
+
+
+void v8::V8::ResetRuntimeCallStats() {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (isolate == NULL || !isolate->IsInitialized()) return;
+  isolate->runtime_call_stats()->Reset();
+}
+
+
+bool v8::V8::VisitObjectStats(ObjectStatsVisitor* visitor) {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (isolate == NULL || !isolate->IsInitialized()) return false;
+  i::ObjectStats* stats = isolate->heap()->object_stats();
+  if (!stats->recorded()) return false;
+
+  static const struct {
+    i::InstanceType type;
+    const char* name;
+  } kInstanceTypes[] = {
+#define INSTANCE_TYPE_ENTRY(type) { i::type, #type },
+    INSTANCE_TYPE_LIST(INSTANCE_TYPE_ENTRY)
+#undef INSTANCE_TYPE_ENTRY
+  };
+  // Some types have two names, such as EXTERNAL_ASCII_STRING_TYPE and
+  // PRIVATE_EXTERNAL_ASCII_STRING_TYPE.  Report them under the first one.
+  bool reported[i::LAST_TYPE + 1] = { false };
+  for (size_t i = 0; i < ARRAY_SIZE(kInstanceTypes); i++) {
+    i::InstanceType type = kInstanceTypes[i].type;
+    if (reported[type]) continue;
+    reported[type] = true;
+    int count = stats->count_by_type(type);
+    if (count == 0) continue;
+    visitor->VisitObjectStats(ObjectStatsVisitor::kInstanceType,
+                              kInstanceTypes[i].name,
+                              count,
+                              stats->size_by_type(type));
+  }
+
+  for (int i = i::FIRST_SPACE; i <= i::LAST_SPACE; i++) {
+    i::AllocationSpace space = static_cast<i::AllocationSpace>(i);
+    int count = stats->count_by_space(space);
+    if (count == 0) continue;
+    visitor->VisitObjectStats(ObjectStatsVisitor::kSpace,
+                              i::AllocationSpaceName(space),
+                              count,
+                              stats->size_by_space(space));
+  }
+
+  for (int i = 0; i < i::Code::NUMBER_OF_KINDS; i++) {
+    i::Code::Kind kind = static_cast<i::Code::Kind>(i);
+    int count = stats->count_by_code_kind(kind);
+    if (count == 0) continue;
+    visitor->VisitObjectStats(ObjectStatsVisitor::kCodeKind,
+                              i::Code::Kind2String(kind),
+                              count,
+                              stats->size_by_code_kind(kind));
+  }
+  return true;
 }
 
 
@@ -4029,6 +4642,13 @@ bool v8::V8::IdleNotification(int hint) {
 }
 
 
+int v8::V8::IdleNotificationWithDeadline(int idle_time_in_us) {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (isolate == NULL || !isolate->IsInitialized()) return 0;
+  return i::V8::IdleNotificationWithDeadline(idle_time_in_us);
+}
+
+
 void v8::V8::LowMemoryNotification() {
   i::Isolate* isolate = i::Isolate::Current();
   if (isolate == NULL || !isolate->IsInitialized()) return;
@@ -4133,6 +4753,30 @@ Persistent<Context> v8::Context::New(
 }
 
 
+Persistent<Context> v8::Context::NewFrom(
+    v8::Handle<Context> source,
+    v8::ExtensionConfiguration* extensions,
+    v8::Handle<ObjectTemplate> global_template) {
+  i::Isolate* isolate = i::Isolate::Current();
+  EnsureInitializedForIsolate(isolate, "v8::Context::NewFrom()");
+  ON_BAILOUT(isolate, "v8::Context::NewFrom()", return Persistent<Context>());
+  if (!ApiCheck(!source.IsEmpty(),
+                "v8::Context::NewFrom()",
+                "Source context is empty")) {
+    return Persistent<Context>();
+  }
+  Persistent<Context> context = New(extensions, global_template);
+  if (context.IsEmpty()) return context;
+  LOG_API(isolate, "Context::NewFrom");
+  {
+    ENTER_V8(isolate);
+    isolate->bootstrapper()->CloneGlobals(Utils::OpenHandle(*source),
+                                          Utils::OpenHandle(*context));
+  }
+  return context;
+}
+
+
 void v8::Context::SetSecurityToken(Handle<Value> token) {
   i::Isolate* isolate = i::Isolate::Current();
   if (IsDeadCheck(isolate, "v8::Context::SetSecurityToken()")) {
@@ -4482,6 +5126,69 @@ i::Handle<i::String> NewExternalAsciiStringHandle(i::Isolate* isolate,
 }
 
 
+// Lets the heap use a pure ASCII Latin-1 resource as an ASCII one.
+class Latin1AsAsciiStringResource
+    : public v8::String::ExternalAsciiStringResource {
+ public:
+  explicit Latin1AsAsciiStringResource(
+      v8::String::ExternalLatin1StringResource* latin1)
+      : latin1_(latin1) { }
+  const char* data() const { return latin1_->data(); }
+  size_t length() const { return latin1_->length(); }
+
+ protected:
+  void Dispose() {
+    i::Heap::DisposeExternalStringResource(latin1_);
+    delete this;
+  }
+
+ private:
+  v8::String::ExternalLatin1StringResource* latin1_;
+};
+
+
+// Holds Latin-1 data widened to UC16 for strings that are not pure ASCII.
+class WidenedLatin1StringResource
+    : public v8::String::ExternalStringResource {
+ public:
+  explicit WidenedLatin1StringResource(
+      const v8::String::ExternalLatin1StringResource* latin1)
+      : length_(latin1->length()),
+        data_(i::NewArray<uint16_t>(latin1->length())) {
+    const uint8_t* chars = reinterpret_cast<const uint8_t*>(latin1->data());
+    for (size_t i = 0; i < length_; i++) data_[i] = chars[i];
+  }
+  ~WidenedLatin1StringResource() { i::DeleteArray(data_); }
+  const uint16_t* data() const { return data_; }
+  size_t length() const { return length_; }
+
+ private:
+  size_t length_;
+  uint16_t* data_;
+};
+
+
+Local<String> v8::String::NewExternal(
+      v8::String::ExternalLatin1StringResource* resource) {
+  i::Isolate* isolate = i::Isolate::Current();
+  EnsureInitializedForIsolate(isolate, "v8::String::NewExternal()");
+  LOG_API(isolate, "String::NewExternal");
+  ENTER_V8(isolate);
+  i::Handle<i::String> result;
+  if (i::String::IsAscii(resource->data(),
+                         static_cast<int>(resource->length()))) {
+    result = NewExternalAsciiStringHandle(
+        isolate, new Latin1AsAsciiStringResource(resource));
+  } else {
+    result = NewExternalStringHandle(
+        isolate, new WidenedLatin1StringResource(resource));
+    i::Heap::DisposeExternalStringResource(resource);
+  }
+  isolate->heap()->external_string_table()->AddString(*result);
+  return Utils::ToLocal(result);
+}
+
+
 Local<String> v8::String::NewExternal(
       v8::String::ExternalStringResource* resource) {
   i::Isolate* isolate = i::Isolate::Current();
@@ -4494,20 +5201,25 @@ Local<String> v8::String::NewExternal(
 }
 
 
+// Strings are made external in place, also in new space.  Large strings
+// skip the freshness heuristic, which only pays off for short strings that
+// are likely to die before the next scavenge.
+static bool IsExternalizable(i::Isolate* isolate, i::Handle<i::String> obj) {
+  if (isolate->heap()->IsInGCPostProcessing()) return false;
+  if (obj->length() >= v8::String::kMinGuaranteedExternalLength) return true;
+  return !isolate->string_tracker()->IsFreshUnusedString(obj);
+}
+
+
 bool v8::String::MakeExternal(v8::String::ExternalStringResource* resource) {
   i::Handle<i::String> obj = Utils::OpenHandle(this);
   i::Isolate* isolate = obj->GetIsolate();
   if (IsDeadCheck(isolate, "v8::String::MakeExternal()")) return false;
-  if (i::StringShape(*obj).IsExternalTwoByte()) {
+  if (i::StringShape(*obj).IsExternal()) {
     return false;  // Already an external string.
   }
   ENTER_V8(isolate);
-  if (isolate->string_tracker()->IsFreshUnusedString(obj)) {
-    return false;
-  }
-  if (isolate->heap()->IsInGCPostProcessing()) {
-    return false;
-  }
+  if (!IsExternalizable(isolate, obj)) return false;
   bool result = obj->MakeExternal(resource);
   if (result && !obj->IsSymbol()) {
     isolate->heap()->external_string_table()->AddString(*obj);
@@ -4533,16 +5245,11 @@ bool v8::String::MakeExternal(
   i::Handle<i::String> obj = Utils::OpenHandle(this);
   i::Isolate* isolate = obj->GetIsolate();
   if (IsDeadCheck(isolate, "v8::String::MakeExternal()")) return false;
-  if (i::StringShape(*obj).IsExternalTwoByte()) {
+  if (i::StringShape(*obj).IsExternal()) {
     return false;  // Already an external string.
   }
   ENTER_V8(isolate);
-  if (isolate->string_tracker()->IsFreshUnusedString(obj)) {
-    return false;
-  }
-  if (isolate->heap()->IsInGCPostProcessing()) {
-    return false;
-  }
+  if (!IsExternalizable(isolate, obj)) return false;
   bool result = obj->MakeExternal(resource);
   if (result && !obj->IsSymbol()) {
     isolate->heap()->external_string_table()->AddString(*obj);
@@ -4552,15 +5259,17 @@ bool v8::String::MakeExternal(
 
 
 bool v8::String::CanMakeExternal() {
-  if (!internal::FLAG_clever_optimizations) return false;
   i::Handle<i::String> obj = Utils::OpenHandle(this);
   i::Isolate* isolate = obj->GetIsolate();
   if (IsDeadCheck(isolate, "v8::String::CanMakeExternal()")) return false;
+  if (i::StringShape(*obj).IsExternal()) return false;
+  if (obj->length() >= kMinGuaranteedExternalLength) {
+    return !isolate->heap()->IsInGCPostProcessing();
+  }
+  if (!internal::FLAG_clever_optimizations) return false;
   if (isolate->string_tracker()->IsFreshUnusedString(obj)) return false;
   int size = obj->Size();  // Byte size of the original string.
-  if (size < i::ExternalString::kShortSize) return false;
-  i::StringShape shape(*obj);
-  return !shape.IsExternal();
+  return size >= i::ExternalString::kShortSize;
 }
 
 
@@ -4664,8 +5373,8 @@ double v8::Date::NumberValue() const {
   if (IsDeadCheck(isolate, "v8::Date::NumberValue()")) return 0;
   LOG_API(isolate, "Date::NumberValue");
   i::Handle<i::Object> obj = Utils::OpenHandle(this);
-  i::Handle<i::JSValue> jsvalue = i::Handle<i::JSValue>::cast(obj);
-  return jsvalue->value()->Number();
+  i::Handle<i::JSDate> jsdate = i::Handle<i::JSDate>::cast(obj);
+  return jsdate->value()->Number();
 }
 
 
@@ -4676,8 +5385,10 @@ void v8::Date::DateTimeConfigurationChangeNotification() {
   LOG_API(isolate, "Date::DateTimeConfigurationChangeNotification");
   ENTER_V8(isolate);
 
+  isolate->date_cache()->ResetDateCache();
+
   i::HandleScope scope(isolate);
-  // Get the function ResetDateCache (defined in date-delay.js).
+  // Get the function ResetDateCache (defined in date.js).
   i::Handle<i::String> func_name_str =
       isolate->factory()->LookupAsciiSymbol("ResetDateCache");
   i::MaybeObject* result =
@@ -4773,6 +5484,200 @@ Local<v8::Array> v8::Array::New(int length) {
 }
 
 
+static inline void StoreNumber(double number, double* value) {
+  *value = number;
+}
+
+
+static inline void StoreNumber(double number, int32_t* value) {
+  *value = i::DoubleToInt32(number);
+}
+
+
+// The length of an array with fast or double elements, which is a Smi.
+static inline uint32_t FastLength(i::JSArray* array) {
+  i::Object* length = array->length();
+  return length->IsSmi() ? i::Smi::cast(length)->value() : 0;
+}
+
+
+// Copies a run of numbers starting at |index| straight out of fast or
+// double elements and returns the index of the first element it could
+// not handle: a hole, a non-number or the end of the array.
+template <typename T>
+static uint32_t CopyFastNumbers(i::JSArray* array,
+                                uint32_t index,
+                                uint32_t end,
+                                T* values) {
+  i::AssertNoAllocation no_allocation;
+  i::ElementsKind kind = array->GetElementsKind();
+  end = i::Min(end, FastLength(array));
+  if (kind == i::FAST_DOUBLE_ELEMENTS) {
+    i::FixedDoubleArray* elements =
+        i::FixedDoubleArray::cast(array->elements());
+    end = i::Min(end, static_cast<uint32_t>(elements->length()));
+    for (; index < end && !elements->is_the_hole(index); index++) {
+      StoreNumber(elements->get_scalar(index), values++);
+    }
+  } else if (kind == i::FAST_SMI_ONLY_ELEMENTS ||
+             kind == i::FAST_ELEMENTS) {
+    i::FixedArray* elements = i::FixedArray::cast(array->elements());
+    end = i::Min(end, static_cast<uint32_t>(elements->length()));
+    for (; index < end; index++) {
+      i::Object* element = elements->get(index);
+      if (!element->IsNumber()) break;
+      StoreNumber(element->Number(), values++);
+    }
+  }
+  return index;
+}
+
+
+template <typename T>
+static bool CopyNumbers(i::Handle<i::JSArray> array,
+                        uint32_t start,
+                        uint32_t count,
+                        T* values) {
+  i::Isolate* isolate = array->GetIsolate();
+  uint32_t end = start + count;
+  uint32_t index = start;
+  while (true) {
+    index = CopyFastNumbers(*array, index, end, values + (index - start));
+    if (index >= end) return true;
+    // One element the slow way; it may run getters that change the array.
+    i::HandleScope scope(isolate);
+    EXCEPTION_PREAMBLE(isolate);
+    i::Handle<i::Object> element = i::Object::GetElement(array, index);
+    has_pending_exception = element.is_null();
+    if (!has_pending_exception) {
+      element = i::Execution::ToNumber(element, &has_pending_exception);
+    }
+    EXCEPTION_BAILOUT_CHECK(isolate, false);
+    StoreNumber(element->Number(), values + (index - start));
+    index++;
+  }
+}
+
+
+bool v8::Array::CopyTo(uint32_t start, uint32_t count, double* values) {
+  i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
+  ON_BAILOUT(isolate, "v8::Array::CopyTo()", return false);
+  LOG_API(isolate, "Array::CopyTo");
+  ENTER_V8(isolate);
+  return CopyNumbers(Utils::OpenHandle(this), start, count, values);
+}
+
+
+bool v8::Array::CopyTo(uint32_t start, uint32_t count, int32_t* values) {
+  i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
+  ON_BAILOUT(isolate, "v8::Array::CopyTo()", return false);
+  LOG_API(isolate, "Array::CopyTo");
+  ENTER_V8(isolate);
+  return CopyNumbers(Utils::OpenHandle(this), start, count, values);
+}
+
+
+bool v8::Array::CopyTo(uint32_t start,
+                       uint32_t count,
+                       Local<Value>* values) {
+  i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
+  ON_BAILOUT(isolate, "v8::Array::CopyTo()", return false);
+  LOG_API(isolate, "Array::CopyTo");
+  ENTER_V8(isolate);
+  i::Handle<i::JSArray> array = Utils::OpenHandle(this);
+  for (uint32_t index = start; index < start + count; index++) {
+    // Re-read the elements each time: boxing a double may move them.
+    i::FixedArrayBase* elements = array->elements();
+    i::ElementsKind kind = array->GetElementsKind();
+    bool in_bounds = index < FastLength(*array) &&
+        index < static_cast<uint32_t>(elements->length());
+    if (in_bounds && kind == i::FAST_DOUBLE_ELEMENTS &&
+        !i::FixedDoubleArray::cast(elements)->is_the_hole(index)) {
+      double number = i::FixedDoubleArray::cast(elements)->get_scalar(index);
+      *values++ = Utils::ToLocal(isolate->factory()->NewNumber(number));
+      continue;
+    }
+    if (in_bounds && (kind == i::FAST_SMI_ONLY_ELEMENTS ||
+                      kind == i::FAST_ELEMENTS)) {
+      i::Object* element = i::FixedArray::cast(elements)->get(index);
+      if (!element->IsTheHole()) {
+        *values++ = Utils::ToLocal(i::Handle<i::Object>(element, isolate));
+        continue;
+      }
+    }
+    EXCEPTION_PREAMBLE(isolate);
+    i::Handle<i::Object> element = i::Object::GetElement(array, index);
+    has_pending_exception = element.is_null();
+    EXCEPTION_BAILOUT_CHECK(isolate, false);
+    *values++ = Utils::ToLocal(element);
+  }
+  return true;
+}
+
+
+Local<v8::Array> v8::Array::New(const double* values, int length) {
+  i::Isolate* isolate = i::Isolate::Current();
+  EnsureInitializedForIsolate(isolate, "v8::Array::New()");
+  LOG_API(isolate, "Array::New(double*)");
+  ENTER_V8(isolate);
+  i::Factory* factory = isolate->factory();
+  if (length <= 0) return Utils::ToLocal(factory->NewJSArray(0));
+  if (!i::FLAG_smi_only_arrays) {
+    // Without double elements every number is boxed.
+    i::Handle<i::FixedArray> elements = factory->NewFixedArray(length);
+    for (int i = 0; i < length; i++) {
+      i::Handle<i::Object> number = factory->NewNumber(values[i]);
+      elements->set(i, *number);
+    }
+    return Utils::ToLocal(factory->NewJSArrayWithElements(elements));
+  }
+  i::Handle<i::FixedDoubleArray> elements =
+      factory->NewFixedDoubleArray(length);
+  for (int i = 0; i < length; i++) elements->set(i, values[i]);
+  i::Handle<i::JSArray> result = factory->NewJSArray(0);
+  result->set_map(
+      *factory->GetElementsTransitionMap(result, i::FAST_DOUBLE_ELEMENTS));
+  result->set_elements(*elements);
+  result->set_length(i::Smi::FromInt(length));
+  return Utils::ToLocal(result);
+}
+
+
+Local<v8::Array> v8::Array::New(const int32_t* values, int length) {
+  i::Isolate* isolate = i::Isolate::Current();
+  EnsureInitializedForIsolate(isolate, "v8::Array::New()");
+  LOG_API(isolate, "Array::New(int32_t*)");
+  ENTER_V8(isolate);
+  i::Factory* factory = isolate->factory();
+  if (length <= 0) return Utils::ToLocal(factory->NewJSArray(0));
+  i::Handle<i::FixedArray> elements = factory->NewFixedArray(length);
+  for (int i = 0; i < length; i++) {
+    if (i::Smi::IsValid(values[i])) {
+      elements->set(i, i::Smi::FromInt(values[i]));
+    } else {
+      i::Handle<i::Object> number = factory->NewNumberFromInt(values[i]);
+      elements->set(i, *number);
+    }
+  }
+  return Utils::ToLocal(factory->NewJSArrayWithElements(elements));
+}
+
+
+Local<v8::Array> v8::Array::New(Handle<Value>* values, int length) {
+  i::Isolate* isolate = i::Isolate::Current();
+  EnsureInitializedForIsolate(isolate, "v8::Array::New()");
+  LOG_API(isolate, "Array::New(Handle<Value>*)");
+  ENTER_V8(isolate);
+  i::Factory* factory = isolate->factory();
+  if (length <= 0) return Utils::ToLocal(factory->NewJSArray(0));
+  i::Handle<i::FixedArray> elements = factory->NewFixedArray(length);
+  for (int i = 0; i < length; i++) {
+    elements->set(i, *Utils::OpenHandle(*values[i]));
+  }
+  return Utils::ToLocal(factory->NewJSArrayWithElements(elements));
+}
+
+
 uint32_t v8::Array::Length() const {
   i::Isolate* isolate = Utils::OpenHandle(this)->GetIsolate();
   if (IsDeadCheck(isolate, "v8::Array::Length()")) return 0;
@@ -4974,7 +5879,18 @@ int V8::AdjustAmountOfExternalAllocatedMemory(int change_in_bytes) {
     return 0;
   }
   return isolate->heap()->AdjustAmountOfExternalAllocatedMemory(
-      change_in_bytes);
+      change_in_bytes, kEmbedderMemory);
+}
+
+
+int V8::AdjustAmountOfExternalAllocatedMemory(int change_in_bytes,
+                                              ExternalMemoryType type) {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (IsDeadCheck(isolate, "v8::V8::AdjustAmountOfExternalAllocatedMemory()")) {
+    return 0;
+  }
+  return isolate->heap()->AdjustAmountOfExternalAllocatedMemory(
+      change_in_bytes, type);
 }
 
 
@@ -4992,6 +5908,20 @@ void V8::SetGlobalGCEpilogueCallback(GCCallback callback) {
 }
 
 
+void V8::SetGCEventCallback(GCEventCallback callback) {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (IsDeadCheck(isolate, "v8::V8::SetGCEventCallback()")) return;
+  isolate->heap()->SetGCEventCallback(callback);
+}
+
+
+void V8::SetWeakReferenceBatchCallback(WeakReferenceBatchCallback callback) {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (IsDeadCheck(isolate, "v8::V8::SetWeakReferenceBatchCallback()")) return;
+  isolate->global_handles()->SetWeakReferenceBatchCallback(callback);
+}
+
+
 void V8::AddGCPrologueCallback(GCPrologueCallback callback, GCType gc_type) {
   i::Isolate* isolate = i::Isolate::Current();
   if (IsDeadCheck(isolate, "v8::V8::AddGCPrologueCallback()")) return;
@@ -5089,6 +6019,13 @@ void V8::TerminateExecution(Isolate* isolate) {
 }
 
 
+bool V8::SetTimeSlice(int microseconds, TimeSliceCallback callback) {
+  i::Isolate* isolate = i::Isolate::Current();
+  if (IsDeadCheck(isolate, "v8::V8::SetTimeSlice()")) return false;
+  return isolate->stack_guard()->SetTimeSlice(microseconds, callback);
+}
+
+
 bool V8::IsExecutionTerminating(Isolate* isolate) {
   i::Isolate* i_isolate = isolate != NULL ?
       reinterpret_cast<i::Isolate*>(isolate) : i::Isolate::Current();
@@ -5554,6 +6491,14 @@ int CpuProfileNode::GetLineNumber() const {
 }
 
 
+const char* CpuProfileNode::GetBailoutReason() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::CpuProfileNode::GetBailoutReason");
+  const i::ProfileNode* node = reinterpret_cast<const i::ProfileNode*>(this);
+  return node->entry()->bailout_reason();
+}
+
+
 double CpuProfileNode::GetTotalTime() const {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::CpuProfileNode::GetTotalTime");
@@ -5649,6 +6594,20 @@ const CpuProfileNode* CpuProfile::GetTopDownRoot() const {
 }
 
 
+void CpuProfile::Serialize(OutputStream* stream) const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::CpuProfile::Serialize");
+  ApiCheck(stream->GetChunkSize() > 0,
+           "v8::CpuProfile::Serialize",
+           "Invalid stream chunk size");
+  i::CpuProfileSerializer serializer(
+      const_cast<i::CpuProfile*>(reinterpret_cast<const i::CpuProfile*>(this)));
+  i::List<char> buffer;
+  serializer.Encode(&buffer);
+  i::CpuProfileSerializer::Write(buffer, stream);
+}
+
+
 int CpuProfiler::GetProfilesCount() {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::CpuProfiler::GetProfilesCount");
@@ -5685,6 +6644,18 @@ void CpuProfiler::StartProfiling(Handle<String> title) {
 }
 
 
+bool CpuProfiler::SerializeCurrentProfile(Handle<String> title,
+                                          OutputStream* stream) {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::CpuProfiler::SerializeCurrentProfile");
+  ApiCheck(stream->GetChunkSize() > 0,
+           "v8::CpuProfiler::SerializeCurrentProfile",
+           "Invalid stream chunk size");
+  return i::CpuProfiler::SerializeCurrentProfile(*Utils::OpenHandle(*title),
+                                                 stream);
+}
+
+
 const CpuProfile* CpuProfiler::StopProfiling(Handle<String> title,
                                              Handle<Value> security_token) {
   i::Isolate* isolate = i::Isolate::Current();
@@ -5703,6 +6674,138 @@ void CpuProfiler::DeleteAllProfiles() {
 }
 
 
+static const i::ICTransitionRecorder::Function* ToInternal(
+    const ICProfile* profile) {
+  return reinterpret_cast<const i::ICTransitionRecorder::Function*>(profile);
+}
+
+
+static i::ICTransitionRecorder* GetICTransitionRecorder(i::Isolate* isolate) {
+  if (isolate->ic_transition_recorder() == NULL) {
+    isolate->set_ic_transition_recorder(new i::ICTransitionRecorder());
+  }
+  return isolate->ic_transition_recorder();
+}
+
+
+Handle<String> ICProfile::GetFunctionName() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfile::GetFunctionName");
+  return Handle<String>(ToApi<String>(isolate->factory()->LookupAsciiSymbol(
+      ToInternal(this)->name())));
+}
+
+
+Handle<String> ICProfile::GetScriptResourceName() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfile::GetScriptResourceName");
+  const char* script_name = ToInternal(this)->script_name();
+  return Handle<String>(ToApi<String>(isolate->factory()->LookupAsciiSymbol(
+      script_name != NULL ? script_name : "")));
+}
+
+
+int ICProfile::GetStartPosition() const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetStartPosition");
+  return ToInternal(this)->start_position();
+}
+
+
+int ICProfile::GetSitesCount() const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetSitesCount");
+  return ToInternal(this)->sites()->length();
+}
+
+
+ICProfile::Kind ICProfile::GetSiteKind(int index) const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetSiteKind");
+  switch (ToInternal(this)->sites()->at(index).kind) {
+    case i::Code::KEYED_LOAD_IC: return kKeyedLoad;
+    case i::Code::STORE_IC: return kStore;
+    case i::Code::KEYED_STORE_IC: return kKeyedStore;
+    case i::Code::CALL_IC: return kCall;
+    case i::Code::KEYED_CALL_IC: return kKeyedCall;
+    default: return kLoad;
+  }
+}
+
+
+int ICProfile::GetSitePosition(int index) const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetSitePosition");
+  return ToInternal(this)->sites()->at(index).position;
+}
+
+
+ICProfile::State ICProfile::GetSiteState(int index) const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetSiteState");
+  return static_cast<State>(ToInternal(this)->sites()->at(index).state);
+}
+
+
+int ICProfile::GetSiteMapsCount(int index) const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetSiteMapsCount");
+  return ToInternal(this)->sites()->at(index).maps_count;
+}
+
+
+int ICProfile::GetSiteTransitionsCount(int index) const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetSiteTransitionsCount");
+  return ToInternal(this)->sites()->at(index).transitions;
+}
+
+
+int ICProfile::GetSitesCountInState(State state) const {
+  IsDeadCheck(i::Isolate::Current(), "v8::ICProfile::GetSitesCountInState");
+  return ToInternal(this)->CountSitesInState(
+      static_cast<i::InlineCacheState>(state));
+}
+
+
+void ICProfiler::StartRecording() {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfiler::StartRecording");
+  GetICTransitionRecorder(isolate)->set_recording(true);
+}
+
+
+void ICProfiler::StopRecording() {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfiler::StopRecording");
+  GetICTransitionRecorder(isolate)->set_recording(false);
+}
+
+
+void ICProfiler::SetTransitionCallback(TransitionCallback callback) {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfiler::SetTransitionCallback");
+  GetICTransitionRecorder(isolate)->set_callback(callback);
+}
+
+
+int ICProfiler::GetProfilesCount() {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfiler::GetProfilesCount");
+  i::ICTransitionRecorder* recorder = isolate->ic_transition_recorder();
+  return recorder != NULL ? recorder->functions_count() : 0;
+}
+
+
+const ICProfile* ICProfiler::GetProfile(int index) {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfiler::GetProfile");
+  return reinterpret_cast<const ICProfile*>(
+      GetICTransitionRecorder(isolate)->function(index));
+}
+
+
+void ICProfiler::DeleteAllProfiles() {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::ICProfiler::DeleteAllProfiles");
+  i::ICTransitionRecorder* recorder = isolate->ic_transition_recorder();
+  if (recorder != NULL) recorder->Clear();
+}
+
+
 static i::HeapGraphEdge* ToInternal(const HeapGraphEdge* edge) {
   return const_cast<i::HeapGraphEdge*>(
       reinterpret_cast<const i::HeapGraphEdge*>(edge));
@@ -5813,7 +6916,7 @@ const HeapGraphEdge* HeapGraphNode::GetChild(int index) const {
 int HeapGraphNode::GetRetainersCount() const {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::HeapSnapshot::GetRetainersCount");
-  return ToInternal(this)->retainers().length();
+  return ToInternal(this)->retainers_count();
 }
 
 
@@ -5821,7 +6924,7 @@ const HeapGraphEdge* HeapGraphNode::GetRetainer(int index) const {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::HeapSnapshot::GetRetainer");
   return reinterpret_cast<const HeapGraphEdge*>(
-      ToInternal(this)->retainers()[index]);
+      ToInternal(this)->retainer(index));
 }
 
 
@@ -5979,6 +7082,36 @@ void HeapProfiler::DeleteAllSnapshots() {
 }
 
 
+void HeapProfiler::StartAllocationSampling(int sample_interval) {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::HeapProfiler::StartAllocationSampling");
+  ApiCheck(sample_interval > 0,
+           "v8::HeapProfiler::StartAllocationSampling",
+           "Sample interval must be positive");
+  i::HeapProfiler::StartAllocationSampling(sample_interval);
+}
+
+
+void HeapProfiler::StopAllocationSampling() {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::HeapProfiler::StopAllocationSampling");
+  i::HeapProfiler::StopAllocationSampling();
+}
+
+
+bool HeapProfiler::SerializeAllocationSamples(OutputStream* stream) {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::HeapProfiler::SerializeAllocationSamples");
+  ApiCheck(stream != NULL,
+           "v8::HeapProfiler::SerializeAllocationSamples",
+           "Invalid stream.");
+  ApiCheck(stream->GetOutputEncoding() == OutputStream::kAscii,
+           "v8::HeapProfiler::SerializeAllocationSamples",
+           "Unsupported output encoding.");
+  return i::HeapProfiler::SerializeAllocationSamples(stream);
+}
+
+
 void HeapProfiler::DefineWrapperClass(uint16_t class_id,
                                       WrapperInfoCallback callback) {
   i::Isolate::Current()->heap_profiler()->DefineWrapperClass(class_id,
@@ -6057,7 +7190,12 @@ namespace internal {
 
 
 void HandleScopeImplementer::FreeThreadResources() {
-  Free();
+  // Keep the spare handle block and the list backing stores, so the next
+  // thread to take the lock does not have to allocate them again.
+  ASSERT(blocks_.length() == 0);
+  ASSERT(entered_contexts_.length() == 0);
+  ASSERT(saved_contexts_.length() == 0);
+  ASSERT(call_depth_ == 0);
 }
 
 
@@ -6090,7 +7228,13 @@ void HandleScopeImplementer::IterateThis(ObjectVisitor* v) {
   // Iterate over all handles in the blocks except for the last.
   for (int i = blocks()->length() - 2; i >= 0; --i) {
     Object** block = blocks()->at(i);
-    v->VisitPointers(block, &block[kHandleBlockSize]);
+    if (last_handle_before_deferred_block_ != NULL &&
+        last_handle_before_deferred_block_ > block &&
+        last_handle_before_deferred_block_ <= &block[kHandleBlockSize]) {
+      v->VisitPointers(block, last_handle_before_deferred_block_);
+    } else {
+      v->VisitPointers(block, &block[kHandleBlockSize]);
+    }
   }
 
   // Iterate over live handles in the last block (if any).
@@ -6120,4 +7264,53 @@ char* HandleScopeImplementer::Iterate(ObjectVisitor* v, char* storage) {
   return storage + ArchiveSpacePerThread();
 }
 
+
+void HandleScopeImplementer::BeginDeferredScope() {
+  ASSERT(last_handle_before_deferred_block_ == NULL);
+  last_handle_before_deferred_block_ = isolate_->handle_scope_data()->next;
+}
+
+
+DeferredHandles* HandleScopeImplementer::Detach(Object** prev_limit) {
+  DeferredHandles* deferred =
+      new DeferredHandles(isolate_->handle_scope_data()->next, isolate_);
+
+  while (!blocks_.is_empty()) {
+    Object** block_start = blocks_.last();
+    Object** block_limit = &block_start[kHandleBlockSize];
+    // NoHandleAllocation may make the prev_limit to point inside the block.
+    if (block_start <= prev_limit && prev_limit <= block_limit) break;
+    deferred->blocks_.Add(block_start);
+    blocks_.RemoveLast();
+  }
+  ASSERT(!deferred->blocks_.is_empty());
+  ASSERT(prev_limit == NULL || !blocks_.is_empty());
+
+  last_handle_before_deferred_block_ = NULL;
+  return deferred;
+}
+
+
+DeferredHandles::~DeferredHandles() {
+  isolate_->UnlinkDeferredHandles(this);
+  for (int i = 0; i < blocks_.length(); i++) {
+#ifdef DEBUG
+    v8::ImplementationUtilities::ZapHandleRange(
+        blocks_[i], &blocks_[i][kHandleBlockSize]);
+#endif
+    DeleteArray(blocks_[i]);
+  }
+}
+
+
+void DeferredHandles::Iterate(ObjectVisitor* v) {
+  ASSERT(!blocks_.is_empty());
+  ASSERT(first_block_limit_ >= blocks_.first() &&
+         first_block_limit_ <= &blocks_.first()[kHandleBlockSize]);
+  v->VisitPointers(blocks_.first(), first_block_limit_);
+  for (int i = 1; i < blocks_.length(); i++) {
+    v->VisitPointers(blocks_[i], &blocks_[i][kHandleBlockSize]);
+  }
+}
+
 } }  // namespace v8::internal
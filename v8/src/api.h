@@ -381,6 +381,36 @@ class StringTracker {
 };
 
 
+// The handles created inside a DeferredHandleScope.  They stay valid, and are
+// visited by the garbage collector, until this object is deleted.
+class DeferredHandles {
+ public:
+  ~DeferredHandles();
+
+ private:
+  DeferredHandles(Object** first_block_limit, Isolate* isolate)
+      : next_(NULL),
+        previous_(NULL),
+        first_block_limit_(first_block_limit),
+        isolate_(isolate) {
+    isolate->LinkDeferredHandles(this);
+  }
+
+  void Iterate(ObjectVisitor* v);
+
+  // The handle blocks, most recently allocated first.  Only the first block
+  // can be partially filled; first_block_limit_ is the end of its handles.
+  List<Object**> blocks_;
+  DeferredHandles* next_;
+  DeferredHandles* previous_;
+  Object** first_block_limit_;
+  Isolate* isolate_;
+
+  friend class HandleScopeImplementer;
+  friend class Isolate;
+};
+
+
 // This class is here in order to be able to declare it a friend of
 // HandleScope.  Moving these methods to be members of HandleScope would be
 // neat in some ways, but it would expose internal implementation details in
@@ -397,11 +427,12 @@ class HandleScopeImplementer {
         blocks_(0),
         entered_contexts_(0),
         saved_contexts_(0),
-        spare_(NULL),
-        call_depth_(0) { }
+        spare_block_count_(0),
+        call_depth_(0),
+        last_handle_before_deferred_block_(NULL) { }
 
   ~HandleScopeImplementer() {
-    DeleteArray(spare_);
+    DeleteSpareBlocks();
   }
 
   // Threading support for handle data.
@@ -416,6 +447,7 @@ class HandleScopeImplementer {
 
 
   inline internal::Object** GetSpareOrNewBlock();
+  inline void ReturnBlock(internal::Object** block);
   inline void DeleteExtensions(internal::Object** prev_limit);
 
   inline void IncrementCallDepth() {call_depth_++;}
@@ -436,12 +468,19 @@ class HandleScopeImplementer {
   inline List<internal::Object**>* blocks() { return &blocks_; }
 
  private:
+  // Support for DeferredHandleScope.  BeginDeferredScope records where the
+  // handles of the enclosing scopes end; Detach moves the handle blocks
+  // added since then to a new DeferredHandles object.
+  void BeginDeferredScope();
+  DeferredHandles* Detach(Object** prev_limit);
+
   void ResetAfterArchive() {
     blocks_.Initialize(0);
     entered_contexts_.Initialize(0);
     saved_contexts_.Initialize(0);
-    spare_ = NULL;
+    spare_block_count_ = 0;
     call_depth_ = 0;
+    last_handle_before_deferred_block_ = NULL;
   }
 
   void Free() {
@@ -451,21 +490,34 @@ class HandleScopeImplementer {
     blocks_.Free();
     entered_contexts_.Free();
     saved_contexts_.Free();
-    if (spare_ != NULL) {
-      DeleteArray(spare_);
-      spare_ = NULL;
-    }
+    DeleteSpareBlocks();
     ASSERT(call_depth_ == 0);
   }
 
+  void DeleteSpareBlocks() {
+    while (spare_block_count_ > 0) {
+      DeleteArray(spare_blocks_[--spare_block_count_]);
+    }
+  }
+
+  // Handle blocks released by closed scopes are kept for reuse, so that
+  // scopes that repeatedly grow by a few blocks do not allocate and free
+  // them every time.
+  static const int kMaxSpareBlocks = 4;
+
   Isolate* isolate_;
   List<internal::Object**> blocks_;
   // Used as a stack to keep track of entered contexts.
   List<Handle<Object> > entered_contexts_;
   // Used as a stack to keep track of saved contexts.
   List<Context*> saved_contexts_;
-  Object** spare_;
+  Object** spare_blocks_[kMaxSpareBlocks];
+  int spare_block_count_;
   int call_depth_;
+  // The end of the handles in the block that was current when a
+  // DeferredHandleScope was entered.  That block is no longer the last one,
+  // so this tells Iterate where its live handles end.
+  Object** last_handle_before_deferred_block_;
   // This is only used for threading support.
   v8::ImplementationUtilities::HandleScopeData handle_scope_data_;
 
@@ -473,6 +525,8 @@ class HandleScopeImplementer {
   char* RestoreThreadHelper(char* from);
   char* ArchiveThreadHelper(char* to);
 
+  friend class DeferredHandleScope;
+
   DISALLOW_COPY_AND_ASSIGN(HandleScopeImplementer);
 };
 
@@ -515,11 +569,17 @@ Handle<Object> HandleScopeImplementer::LastEnteredContext() {
 
 // If there's a spare block, use it for growing the current scope.
 internal::Object** HandleScopeImplementer::GetSpareOrNewBlock() {
-  internal::Object** block = (spare_ != NULL) ?
-      spare_ :
-      NewArray<internal::Object*>(kHandleBlockSize);
-  spare_ = NULL;
-  return block;
+  if (spare_block_count_ > 0) return spare_blocks_[--spare_block_count_];
+  return NewArray<internal::Object*>(kHandleBlockSize);
+}
+
+
+void HandleScopeImplementer::ReturnBlock(internal::Object** block) {
+  if (spare_block_count_ < kMaxSpareBlocks) {
+    spare_blocks_[spare_block_count_++] = block;
+  } else {
+    DeleteArray(block);
+  }
 }
 
 
@@ -538,10 +598,7 @@ void HandleScopeImplementer::DeleteExtensions(internal::Object** prev_limit) {
 #ifdef DEBUG
     v8::ImplementationUtilities::ZapHandleRange(block_start, block_limit);
 #endif
-    if (spare_ != NULL) {
-      DeleteArray(spare_);
-    }
-    spare_ = block_start;
+    ReturnBlock(block_start);
   }
   ASSERT((blocks_.is_empty() && prev_limit == NULL) ||
          (!blocks_.is_empty() && prev_limit != NULL));
@@ -29,6 +29,7 @@
 #define V8_ARGUMENTS_H_
 
 #include "allocation.h"
+#include "counters.h"
 
 namespace v8 {
 namespace internal {
@@ -115,8 +116,18 @@ class CustomArguments : public Relocatable {
 Type Name(Arguments args, Isolate* isolate)
 
 
-#define RUNTIME_FUNCTION(Type, Name)            \
-Type Name(Arguments args, Isolate* isolate)
+// With --runtime-call-stats the calls of a runtime function and the time
+// spent in it are recorded in the isolate's RuntimeCallStats.
+#define RUNTIME_FUNCTION(Type, Name)                          \
+static Type Name##_Body(Arguments args, Isolate* isolate);    \
+Type Name(Arguments args, Isolate* isolate) {                 \
+  if (FLAG_runtime_call_stats) {                              \
+    RuntimeCallTimerScope timer(isolate, #Name);              \
+    return Name##_Body(args, isolate);                        \
+  }                                                           \
+  return Name##_Body(args, isolate);                          \
+}                                                             \
+static Type Name##_Body(Arguments args, Isolate* isolate)
 
 
 #define RUNTIME_ARGUMENTS(isolate, args) args, isolate
@@ -708,7 +708,7 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
         __ Push(r1, r2);
 
         __ push(r1);  // constructor
-        // The call will replace the stub, so the countdown is only done once.
+        // The call either restarts the countdown or replaces the stub.
         __ CallRuntime(Runtime::kFinalizeInstanceSize, 1);
 
         __ pop(r2);
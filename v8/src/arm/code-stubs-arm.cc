@@ -3454,6 +3454,13 @@ void StackCheckStub::Generate(MacroAssembler* masm) {
 }
 
 
+void InterruptStub::Generate(MacroAssembler* masm) {
+  // r2 holds the profiling counter cell.
+  __ push(r2);
+  __ TailCallRuntime(Runtime::kInterrupt, 1, 1);
+}
+
+
 void MathPowStub::Generate(MacroAssembler* masm) {
   Label call_runtime;
 
@@ -3987,10 +3994,19 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   const Register function = r1;  // Function (rhs).
   const Register prototype = r4;  // Prototype of the function.
   const Register inline_site = r9;
+  // Without a call site cache, the offset of the instanceof cache entry.
+  const Register cache_offset = r9;
   const Register scratch = r2;
 
   const int32_t kDeltaToLoadBoolResult = 3 * kPointerSize;
 
+  ExternalReference cache_functions =
+      ExternalReference::instanceof_cache_functions(masm->isolate());
+  ExternalReference cache_maps =
+      ExternalReference::instanceof_cache_maps(masm->isolate());
+  ExternalReference cache_answers =
+      ExternalReference::instanceof_cache_answers(masm->isolate());
+
   Label slow, loop, is_instance, is_not_instance, not_js_object;
 
   if (!HasArgsInRegisters()) {
@@ -4006,13 +4022,19 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   // real lookup and update the call site cache.
   if (!HasCallSiteInlineCheck()) {
     Label miss;
-    __ LoadRoot(ip, Heap::kInstanceofCacheFunctionRootIndex);
+    __ eor(cache_offset, map, Operand(function));
+    __ and_(cache_offset, cache_offset,
+            Operand(InstanceofCache::kOffsetMask));
+    __ mov(ip, Operand(cache_functions));
+    __ ldr(ip, MemOperand(ip, cache_offset));
     __ cmp(function, ip);
     __ b(ne, &miss);
-    __ LoadRoot(ip, Heap::kInstanceofCacheMapRootIndex);
+    __ mov(ip, Operand(cache_maps));
+    __ ldr(ip, MemOperand(ip, cache_offset));
     __ cmp(map, ip);
     __ b(ne, &miss);
-    __ LoadRoot(r0, Heap::kInstanceofCacheAnswerRootIndex);
+    __ mov(ip, Operand(cache_answers));
+    __ ldr(r0, MemOperand(ip, cache_offset));
     __ Ret(HasArgsInRegisters() ? 0 : 2);
 
     __ bind(&miss);
@@ -4028,8 +4050,10 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   // Update the global instanceof or call site inlined cache with the current
   // map and function. The cached answer will be set when it is known below.
   if (!HasCallSiteInlineCheck()) {
-    __ StoreRoot(function, Heap::kInstanceofCacheFunctionRootIndex);
-    __ StoreRoot(map, Heap::kInstanceofCacheMapRootIndex);
+    __ mov(ip, Operand(cache_functions));
+    __ str(function, MemOperand(ip, cache_offset));
+    __ mov(ip, Operand(cache_maps));
+    __ str(map, MemOperand(ip, cache_offset));
   } else {
     ASSERT(HasArgsInRegisters());
     // Patch the (relocated) inlined map check.
@@ -4065,7 +4089,8 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   __ bind(&is_instance);
   if (!HasCallSiteInlineCheck()) {
     __ mov(r0, Operand(Smi::FromInt(0)));
-    __ StoreRoot(r0, Heap::kInstanceofCacheAnswerRootIndex);
+    __ mov(ip, Operand(cache_answers));
+    __ str(r0, MemOperand(ip, cache_offset));
   } else {
     // Patch the call site to return true.
     __ LoadRoot(r0, Heap::kTrueValueRootIndex);
@@ -4083,7 +4108,8 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   __ bind(&is_not_instance);
   if (!HasCallSiteInlineCheck()) {
     __ mov(r0, Operand(Smi::FromInt(1)));
-    __ StoreRoot(r0, Heap::kInstanceofCacheAnswerRootIndex);
+    __ mov(ip, Operand(cache_answers));
+    __ str(r0, MemOperand(ip, cache_offset));
   } else {
     // Patch the call site to return false.
     __ LoadRoot(r0, Heap::kFalseValueRootIndex);
@@ -4611,6 +4637,19 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   // Get the length of the string to r3.
   __ ldr(r3, FieldMemOperand(subject, String::kLengthOffset));
 
+  // r2: Number of capture registers
+  // r3: Length of subject string as a smi
+  // subject: Subject string
+  // regexp_data: RegExp data (FixedArray)
+  // Long subjects are searched for the literal prefix in the runtime.
+  Label no_literal_prefix;
+  __ ldr(r0,
+         FieldMemOperand(regexp_data, JSRegExp::kIrregexpLiteralPrefixOffset));
+  __ JumpIfSmi(r0, &no_literal_prefix);
+  __ cmp(r3, Operand(Smi::FromInt(JSRegExp::kLiteralPrefixMinSubjectLength)));
+  __ b(ge, &runtime);
+  __ bind(&no_literal_prefix);
+
   // r2: Number of capture registers
   // r3: Length of subject string as a smi
   // subject: Subject string
@@ -5637,8 +5676,12 @@ void StringHelper::GenerateTwoCharacterSymbolTableProbe(MacroAssembler* masm,
 void StringHelper::GenerateHashInit(MacroAssembler* masm,
                                     Register hash,
                                     Register character) {
-  // hash = character + (character << 10);
-  __ add(hash, character, Operand(character, LSL, 10));
+  // hash = seed + character + ((seed + character) << 10);
+  __ LoadRoot(hash, Heap::kHashSeedRootIndex);
+  // Untag smi seed and add the character.
+  __ add(hash, character, Operand(hash, LSR, kSmiTagSize));
+  // hash += hash << 10;
+  __ add(hash, hash, Operand(hash, LSL, 10));
   // hash ^= hash >> 6;
   __ eor(hash, hash, Operand(hash, LSR, 6));
 }
@@ -6032,26 +6075,40 @@ void StringCompareStub::GenerateAsciiCharsCompareLoop(
     Register scratch1,
     Register scratch2,
     Label* chars_not_equal) {
-  // Change index to run from -length to -1 by adding length to string
-  // start. This means that loop ends when index reaches zero, which
-  // doesn't need an additional compare.
+  // The characters of both strings start word aligned, so they are compared
+  // a word at a time. The word that differs, and the last few characters,
+  // are compared one at a time, which leaves the flags of the comparison
+  // of the first different characters for the caller.
+  STATIC_ASSERT((SeqAsciiString::kHeaderSize & kObjectAlignmentMask) == 0);
   __ SmiUntag(length);
-  __ add(scratch1, length,
-         Operand(SeqAsciiString::kHeaderSize - kHeapObjectTag));
-  __ add(left, left, Operand(scratch1));
-  __ add(right, right, Operand(scratch1));
-  __ rsb(length, length, Operand::Zero());
-  Register index = length;  // index = -length;
+  __ add(left, left, Operand(SeqAsciiString::kHeaderSize - kHeapObjectTag));
+  __ add(right, right, Operand(SeqAsciiString::kHeaderSize - kHeapObjectTag));
+
+  Label word_loop, bytes, byte_loop, done;
+  __ bind(&word_loop);
+  __ sub(length, length, Operand(kPointerSize), SetCC);
+  __ b(lt, &bytes);
+  __ ldr(scratch1, MemOperand(left, kPointerSize, PostIndex));
+  __ ldr(scratch2, MemOperand(right, kPointerSize, PostIndex));
+  __ cmp(scratch1, scratch2);
+  __ b(eq, &word_loop);
 
-  // Compare loop.
-  Label loop;
-  __ bind(&loop);
-  __ ldrb(scratch1, MemOperand(left, index));
-  __ ldrb(scratch2, MemOperand(right, index));
+  // Go back to the start of the word that differs.
+  __ sub(left, left, Operand(kPointerSize));
+  __ sub(right, right, Operand(kPointerSize));
+
+  // length is the number of characters left minus a word.
+  __ bind(&bytes);
+  __ add(length, length, Operand(kPointerSize), SetCC);
+  __ b(eq, &done);
+  __ bind(&byte_loop);
+  __ ldrb(scratch1, MemOperand(left, 1, PostIndex));
+  __ ldrb(scratch2, MemOperand(right, 1, PostIndex));
   __ cmp(scratch1, scratch2);
   __ b(ne, chars_not_equal);
-  __ add(index, index, Operand(1), SetCC);
-  __ b(ne, &loop);
+  __ sub(length, length, Operand(1), SetCC);
+  __ b(ne, &byte_loop);
+  __ bind(&done);
 }
 
 
@@ -6247,6 +6304,26 @@ void StringAddStub::Generate(MacroAssembler* masm) {
   // Fill the fields of the cons string.
   __ str(r0, FieldMemOperand(r7, ConsString::kFirstOffset));
   __ str(r1, FieldMemOperand(r7, ConsString::kSecondOffset));
+  // The depth of the result is one more than that of its deeper part.  Too
+  // deep results are left to the runtime, which rebalances them.
+  __ mov(r6, Operand(Smi::FromInt(0)));
+  __ ldr(r4, FieldMemOperand(r0, HeapObject::kMapOffset));
+  __ ldrb(r4, FieldMemOperand(r4, Map::kInstanceTypeOffset));
+  __ and_(r4, r4, Operand(kStringRepresentationMask));
+  __ cmp(r4, Operand(kConsStringTag));
+  __ ldr(r6, FieldMemOperand(r0, ConsString::kDepthOffset), eq);
+  __ ldr(r5, FieldMemOperand(r1, HeapObject::kMapOffset));
+  __ ldrb(r5, FieldMemOperand(r5, Map::kInstanceTypeOffset));
+  __ and_(r5, r5, Operand(kStringRepresentationMask));
+  __ cmp(r5, Operand(kConsStringTag));
+  __ ldr(r5, FieldMemOperand(r1, ConsString::kDepthOffset), eq);
+  __ mov(r5, Operand(Smi::FromInt(0)), LeaveCC, ne);
+  __ cmp(r5, r6);
+  __ mov(r6, r5, LeaveCC, gt);
+  __ add(r6, r6, Operand(Smi::FromInt(1)));
+  __ str(r6, FieldMemOperand(r7, ConsString::kDepthOffset));
+  __ cmp(r6, Operand(Smi::FromInt(ConsString::kMaxDepth)));
+  __ b(gt, &string_add_runtime);
   __ mov(r0, Operand(r7));
   __ IncrementCounter(counters->string_add_native(), 1, r2, r3);
   __ add(sp, sp, Operand(2 * kPointerSize));
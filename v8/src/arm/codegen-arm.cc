@@ -54,6 +54,91 @@ void StubRuntimeCallHelper::AfterCall(MacroAssembler* masm) const {
 }
 
 
+#if !defined(USE_SIMULATOR)
+
+#undef __
+#define __ masm.
+
+static void MemCopyWrapper(void* dest, const void* src, size_t size) {
+  memcpy(dest, src, size);
+}
+
+
+OS::MemCopyFunction CreateMemCopyFunction() {
+  if (!CpuFeatures::IsSupported(VFP3)) return &MemCopyWrapper;
+  size_t actual_size;
+  // Allocate buffer in executable space.
+  byte* buffer = static_cast<byte*>(OS::Allocate(1 * KB,
+                                                 &actual_size,
+                                                 true));
+  if (buffer == NULL) return &MemCopyWrapper;
+  MacroAssembler masm(NULL, buffer, static_cast<int>(actual_size));
+
+  // Generated code is put into a fixed, unmovable, buffer, and not into
+  // the V8 heap. We can't, and don't, refer to any relocatable addresses.
+
+  // The arguments are passed in r0 (destination), r1 (source) and r2
+  // (size). Only caller-saved registers are used.
+  Register dst = r0;
+  Register src = r1;
+  Register count = r2;
+  Register scratch = r3;
+  {
+    CpuFeatures::Scope scope(VFP3);
+    Label loop, words, word_loop, bytes, byte_loop;
+
+    // vldm and vstm need word aligned addresses. ARMv7 allows unaligned
+    // ldr and str, which copy unaligned areas a word at a time.
+    __ orr(scratch, dst, Operand(src));
+    __ tst(scratch, Operand(kPointerAlignmentMask));
+    __ sub(count, count, Operand(4 * kDoubleSize), LeaveCC, ne);
+    __ b(ne, &words);
+
+    // Copy 32 bytes at a time through d0-d3.
+    __ bind(&loop);
+    __ sub(count, count, Operand(4 * kDoubleSize), SetCC);
+    __ b(lt, &words);
+    __ vldm(ia_w, src, d0, d3);
+    __ vstm(ia_w, dst, d0, d3);
+    __ b(&loop);
+
+    // count is the number of bytes left minus 32. Copy the remaining words.
+    __ bind(&words);
+    __ add(count, count, Operand(4 * kDoubleSize - kPointerSize), SetCC);
+    __ b(lt, &bytes);
+    __ bind(&word_loop);
+    __ ldr(scratch, MemOperand(src, kPointerSize, PostIndex));
+    __ str(scratch, MemOperand(dst, kPointerSize, PostIndex));
+    __ sub(count, count, Operand(kPointerSize), SetCC);
+    __ b(ge, &word_loop);
+
+    // At most 3 bytes left to copy.
+    __ bind(&bytes);
+    __ add(count, count, Operand(kPointerSize), SetCC);
+    __ Ret(eq);
+    __ bind(&byte_loop);
+    __ ldrb(scratch, MemOperand(src, 1, PostIndex));
+    __ strb(scratch, MemOperand(dst, 1, PostIndex));
+    __ sub(count, count, Operand(1), SetCC);
+    __ b(ne, &byte_loop);
+    __ Ret();
+  }
+
+  CodeDesc desc;
+  masm.GetCode(&desc);
+  ASSERT(desc.reloc_size == 0);
+
+  CPU::FlushICache(buffer, actual_size);
+  OS::ProtectCode(buffer, actual_size);
+  return FUNCTION_CAST<OS::MemCopyFunction>(buffer);
+}
+
+#undef __
+#define __ ACCESS_MASM(masm)
+
+#endif  // !defined(USE_SIMULATOR)
+
+
 // -------------------------------------------------------------------------
 // Code generators
 
@@ -724,6 +724,19 @@ void LoadIC::GenerateNormal(MacroAssembler* masm) {
 
   GenerateStringDictionaryReceiverCheck(masm, r0, r1, r3, r4, &miss);
 
+  if (FLAG_fast_properties_read_threshold > 0) {
+    // Count the read and let the runtime give the receiver fast properties
+    // back when it has been read often enough without changing shape.
+    Label not_counted;
+    __ ldr(r3, FieldMemOperand(r1, StringDictionary::kReadCountOffset));
+    __ JumpIfNotSmi(r3, &not_counted);
+    __ add(r3, r3, Operand(Smi::FromInt(1)));
+    __ str(r3, FieldMemOperand(r1, StringDictionary::kReadCountOffset));
+    __ cmp(r3, Operand(Smi::FromInt(FLAG_fast_properties_read_threshold)));
+    __ b(ge, &miss);
+    __ bind(&not_counted);
+  }
+
   // r1: elements
   GenerateDictionaryLoad(masm, &miss, r1, r2, r0, r3, r4);
   __ Ret();
@@ -1031,15 +1044,36 @@ void KeyedLoadIC::GenerateGeneric(MacroAssembler* masm) {
   __ mov(r3, Operand(r2, ASR, KeyedLookupCache::kMapHashShift));
   __ ldr(r4, FieldMemOperand(r0, String::kHashFieldOffset));
   __ eor(r3, r3, Operand(r4, ASR, String::kHashShift));
-  __ And(r3, r3, Operand(KeyedLookupCache::kCapacityMask));
-
-  // Load the key (consisting of map and symbol) from the cache and
-  // check for match.
+  ExternalReference cache_mask =
+      ExternalReference::keyed_lookup_cache_mask(isolate);
+  __ mov(r4, Operand(cache_mask));
+  __ ldr(r4, MemOperand(r4));
+  __ and_(r3, r3, Operand(r4));
+
+  // Load the key (consisting of map and symbol) from each entry of the
+  // cache bucket and check for match.
+  Label load_in_object_property;
+  static const int kEntriesPerBucket = KeyedLookupCache::kEntriesPerBucket;
+  Label hit_on_nth_entry[kEntriesPerBucket];
   ExternalReference cache_keys =
       ExternalReference::keyed_lookup_cache_keys(isolate);
   __ mov(r4, Operand(cache_keys));
   __ add(r4, r4, Operand(r3, LSL, kPointerSizeLog2 + 1));
-  __ ldr(r5, MemOperand(r4, kPointerSize, PostIndex));  // Move r4 to symbol.
+
+  for (int i = 0; i < kEntriesPerBucket - 1; i++) {
+    Label try_next_entry;
+    // Load map and move r4 to the next entry.
+    __ ldr(r5, MemOperand(r4, kPointerSize * 2, PostIndex));
+    __ cmp(r2, r5);
+    __ b(ne, &try_next_entry);
+    __ ldr(r5, MemOperand(r4, -kPointerSize));  // Load symbol.
+    __ cmp(r0, r5);
+    __ b(eq, &hit_on_nth_entry[i]);
+    __ bind(&try_next_entry);
+  }
+
+  // Last entry: Load map and move r4 to symbol.
+  __ ldr(r5, MemOperand(r4, kPointerSize, PostIndex));
   __ cmp(r2, r5);
   __ b(ne, &slow);
   __ ldr(r5, MemOperand(r4));
@@ -1050,16 +1084,26 @@ void KeyedLoadIC::GenerateGeneric(MacroAssembler* masm) {
   // r0     : key
   // r1     : receiver
   // r2     : receiver's map
-  // r3     : lookup cache index
+  // r3     : lookup cache index of the first entry in the bucket
   ExternalReference cache_field_offsets =
       ExternalReference::keyed_lookup_cache_field_offsets(isolate);
-  __ mov(r4, Operand(cache_field_offsets));
-  __ ldr(r5, MemOperand(r4, r3, LSL, kPointerSizeLog2));
-  __ ldrb(r6, FieldMemOperand(r2, Map::kInObjectPropertiesOffset));
-  __ sub(r5, r5, r6, SetCC);
-  __ b(ge, &property_array_property);
+  for (int i = kEntriesPerBucket - 1; i >= 0; i--) {
+    __ bind(&hit_on_nth_entry[i]);
+    __ mov(r4, Operand(cache_field_offsets));
+    if (i != 0) {
+      __ add(r3, r3, Operand(i));
+    }
+    __ ldr(r5, MemOperand(r4, r3, LSL, kPointerSizeLog2));
+    __ ldrb(r6, FieldMemOperand(r2, Map::kInObjectPropertiesOffset));
+    __ sub(r5, r5, r6, SetCC);
+    __ b(ge, &property_array_property);
+    if (i != 0) {
+      __ b(&load_in_object_property);
+    }
+  }
 
   // Load in-object property.
+  __ bind(&load_in_object_property);
   __ ldrb(r6, FieldMemOperand(r2, Map::kInstanceSizeOffset));
   __ add(r6, r6, r5);  // Index from start of object.
   __ sub(r1, r1, Operand(kHeapObjectTag));  // Remove the heap tag.
@@ -1281,6 +1325,7 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
   Label slow, array, extra, check_if_double_array;
   Label fast_object_with_map_check, fast_object_without_map_check;
   Label fast_double_with_map_check, fast_double_without_map_check;
+  Label transition_smi_elements, finish_object_store;
 
   // Register usage.
   Register value = r0;
@@ -1387,8 +1432,10 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
 
   __ bind(&non_smi_value);
   // Escape to slow case when writing non-smi into smi-only array.
-  __ CheckFastObjectElements(receiver_map, scratch_value, &slow);
+  __ CheckFastObjectElements(receiver_map, scratch_value,
+                             &transition_smi_elements);
   // Fast elements array, store the value to the elements backing store.
+  __ bind(&finish_object_store);
   __ add(address, elements, Operand(FixedArray::kHeaderSize - kHeapObjectTag));
   __ add(address, address, Operand(key, LSL, kPointerSizeLog2 - kSmiTagSize));
   __ str(value, MemOperand(address));
@@ -1403,6 +1450,28 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
                  OMIT_SMI_CHECK);
   __ Ret();
 
+  __ bind(&transition_smi_elements);
+  // Arrays that still have the initial smi-only array map move to object
+  // elements in place.  Heap numbers need double elements, which are left
+  // to the runtime.
+  __ ldr(scratch_value, FieldMemOperand(value, HeapObject::kMapOffset));
+  __ CompareRoot(scratch_value, Heap::kHeapNumberMapRootIndex);
+  __ b(eq, &slow);
+  __ LoadGlobalFunction(Context::SMI_JS_ARRAY_MAP_INDEX, scratch_value);
+  __ cmp(receiver_map, scratch_value);
+  __ b(ne, &slow);
+  __ LoadGlobalFunction(Context::OBJECT_JS_ARRAY_MAP_INDEX, receiver_map);
+  __ str(receiver_map, FieldMemOperand(receiver, HeapObject::kMapOffset));
+  __ RecordWriteField(receiver,
+                      HeapObject::kMapOffset,
+                      receiver_map,
+                      scratch_value,
+                      kLRHasNotBeenSaved,
+                      kDontSaveFPRegs,
+                      EMIT_REMEMBERED_SET,
+                      OMIT_SMI_CHECK);
+  __ jmp(&finish_object_store);
+
   __ bind(&fast_double_with_map_check);
   // Check for fast double array case. If this fails, call through to the
   // runtime.
@@ -577,6 +577,7 @@ void LChunkBuilder::Abort(const char* format, ...) {
     va_end(arguments);
     PrintF("\n");
   }
+  info()->set_bailout_reason(format);
   status_ = ABORTED;
 }
 
@@ -865,8 +866,9 @@ LInstruction* LChunkBuilder::DoShift(Token::Value op,
   }
 
   // Shift operations can only deoptimize if we do a logical shift
-  // by 0 and the result cannot be truncated to int32.
-  bool may_deopt = (op == Token::SHR && constant_value == 0);
+  // by 0 and the result cannot be truncated to int32 or read as uint32.
+  bool may_deopt =
+      op == Token::SHR && constant_value == 0 && !instr->IsUint32();
   bool does_deopt = false;
   if (may_deopt) {
     for (HUseIterator it(instr->uses()); !it.Done(); it.Advance()) {
@@ -1013,19 +1015,59 @@ LEnvironment* LChunkBuilder::CreateEnvironment(
                                           argument_count_,
                                           value_count,
                                           outer);
+  if (hydrogen_env->has_dynamic_closure()) result->set_has_dynamic_closure();
+  // The arguments pushed for an inlined function come after the outgoing
+  // arguments of the outer frames.
+  HEnterInlined* entry = hydrogen_env->entry();
+  if (entry != NULL && entry->arguments_pushed()) {
+    *argument_index_accumulator += entry->arguments_count();
+  }
   for (int i = 0; i < value_count; ++i) {
     if (hydrogen_env->is_special_index(i)) continue;
 
     HValue* value = hydrogen_env->values()->at(i);
     LOperand* op = NULL;
     if (value->IsArgumentsObject()) {
+      HArgumentsObject* arguments = HArgumentsObject::cast(value);
+      if (arguments->is_inlined()) {
+        result->AddCapturedObject(arguments->closure(),
+                                  arguments->arguments_count());
+        continue;
+      }
       op = NULL;
+    } else if (value->IsCapturedObject()) {
+      HCapturedObject* object = HCapturedObject::cast(value);
+      result->AddCapturedObject(object->boilerplate(), object->field_count());
+      continue;
     } else if (value->IsPushArgument()) {
       op = new LArgument((*argument_index_accumulator)++);
     } else {
       op = UseAny(value);
     }
-    result->AddValue(op, value->representation());
+    result->AddValue(op, value->representation(), value->IsUint32());
+  }
+
+  // The fields of captured objects follow the frame values.
+  for (int i = 0; i < value_count; ++i) {
+    if (hydrogen_env->is_special_index(i)) continue;
+
+    HValue* value = hydrogen_env->values()->at(i);
+    if (value->IsArgumentsObject()) {
+      HArgumentsObject* arguments = HArgumentsObject::cast(value);
+      if (!arguments->is_inlined()) continue;
+      for (int j = 0; j < arguments->arguments_count(); ++j) {
+        HValue* argument = arguments->argument(j);
+        result->AddCapturedField(UseAny(argument),
+                                 argument->representation());
+      }
+      continue;
+    }
+    if (!value->IsCapturedObject()) continue;
+    HCapturedObject* object = HCapturedObject::cast(value);
+    for (int j = 0; j < object->field_count(); ++j) {
+      HValue* field = object->current_value(j);
+      result->AddCapturedField(UseAny(field), field->representation());
+    }
   }
 
   return result;
@@ -1270,6 +1312,13 @@ LInstruction* LChunkBuilder::DoDiv(HDiv* instr) {
   if (instr->representation().IsDouble()) {
     return DoArithmeticD(Token::DIV, instr);
   } else if (instr->representation().IsInteger32()) {
+    if (instr->all_uses_truncating()) {
+      // Divide in VFP registers, see LCodeGen::DoDivI.
+      LOperand* dividend = UseRegister(instr->left());
+      LOperand* divisor = UseRegister(instr->right());
+      LDivI* div = new LDivI(dividend, divisor, FixedTemp(d11));
+      return AssignEnvironment(DefineAsRegister(div));
+    }
     // TODO(1042) The fixed register allocation
     // is needed because we call TypeRecordingBinaryOpStub from
     // the generated code, which requires registers r0
@@ -1278,13 +1327,33 @@ LInstruction* LChunkBuilder::DoDiv(HDiv* instr) {
     LOperand* dividend = UseFixed(instr->left(), r0);
     LOperand* divisor = UseFixed(instr->right(), r1);
     return AssignEnvironment(AssignPointerMap(
-             DefineFixed(new LDivI(dividend, divisor), r0)));
+             DefineFixed(new LDivI(dividend, divisor, NULL), r0)));
   } else {
     return DoArithmeticT(Token::DIV, instr);
   }
 }
 
 
+LInstruction* LChunkBuilder::DoMathMinMax(HMathMinMax* instr) {
+  LOperand* left = NULL;
+  LOperand* right = NULL;
+  if (instr->representation().IsInteger32()) {
+    ASSERT(instr->left()->representation().IsInteger32());
+    ASSERT(instr->right()->representation().IsInteger32());
+    left = UseRegisterAtStart(instr->LeastConstantOperand());
+    right = UseOrConstantAtStart(instr->MostConstantOperand());
+  } else {
+    ASSERT(instr->representation().IsDouble());
+    ASSERT(instr->left()->representation().IsDouble());
+    ASSERT(instr->right()->representation().IsDouble());
+    left = UseRegisterAtStart(instr->left());
+    right = UseRegisterAtStart(instr->right());
+  }
+  LMathMinMax* minmax = new LMathMinMax(left, right);
+  return DefineAsRegister(minmax);
+}
+
+
 LInstruction* LChunkBuilder::DoMod(HMod* instr) {
   if (instr->representation().IsInteger32()) {
     ASSERT(instr->left()->representation().IsInteger32());
@@ -1557,6 +1626,13 @@ LInstruction* LChunkBuilder::DoValueOf(HValueOf* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoDateField(HDateField* instr) {
+  LOperand* object = UseFixed(instr->value(), r0);
+  LDateField* result = new LDateField(object, FixedTemp(r1), instr->index());
+  return MarkAsCall(DefineFixed(result, r0), instr);
+}
+
+
 LInstruction* LChunkBuilder::DoBoundsCheck(HBoundsCheck* instr) {
   return AssignEnvironment(new LBoundsCheck(UseRegisterAtStart(instr->index()),
                                             UseRegister(instr->length())));
@@ -1640,7 +1716,10 @@ LInstruction* LChunkBuilder::DoChange(HChange* instr) {
     if (to.IsTagged()) {
       HValue* val = instr->value();
       LOperand* value = UseRegister(val);
-      if (val->HasRange() && val->range()->IsInSmiRange()) {
+      if (val->IsUint32()) {
+        LNumberTagU* result = new LNumberTagU(value);
+        return AssignEnvironment(AssignPointerMap(DefineSameAsFirst(result)));
+      } else if (val->HasRange() && val->range()->IsInSmiRange()) {
         return DefineSameAsFirst(new LSmiTag(value));
       } else {
         LNumberTagI* result = new LNumberTagI(value);
@@ -1648,6 +1727,10 @@ LInstruction* LChunkBuilder::DoChange(HChange* instr) {
       }
     } else {
       ASSERT(to.IsDouble());
+      if (instr->value()->IsUint32()) {
+        LOperand* value = UseRegister(instr->value());
+        return DefineAsRegister(new LUint32ToDouble(value));
+      }
       LOperand* value = Use(instr->value());
       return DefineAsRegister(new LInteger32ToDouble(value));
     }
@@ -1799,6 +1882,13 @@ LInstruction* LChunkBuilder::DoLoadContextSlot(HLoadContextSlot* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoStoreCapturedField(
+    HStoreCapturedField* instr) {
+  instr->object()->set_current_value(instr->index(), instr->value());
+  return NULL;
+}
+
+
 LInstruction* LChunkBuilder::DoStoreContextSlot(HStoreContextSlot* instr) {
   LOperand* context;
   LOperand* value;
@@ -1901,9 +1991,10 @@ LInstruction* LChunkBuilder::DoLoadKeyedSpecializedArrayElement(
   LLoadKeyedSpecializedArrayElement* result =
       new LLoadKeyedSpecializedArrayElement(external_pointer, key);
   LInstruction* load_instr = DefineAsRegister(result);
-  // An unsigned int array load might overflow and cause a deopt, make sure it
-  // has an environment.
-  return (elements_kind == EXTERNAL_UNSIGNED_INT_ELEMENTS) ?
+  // An unsigned int array load might overflow and cause a deopt, unless its
+  // result is read as uint32.  Make sure it has an environment.
+  return (elements_kind == EXTERNAL_UNSIGNED_INT_ELEMENTS &&
+          !instr->IsUint32()) ?
       AssignEnvironment(load_instr) : load_instr;
 }
 
@@ -1951,6 +2042,14 @@ LInstruction* LChunkBuilder::DoStoreKeyedFastDoubleElement(
 }
 
 
+LInstruction* LChunkBuilder::DoFastDoubleArrayMap(
+    HFastDoubleArrayMap* instr) {
+  // The graph builder only emits HFastDoubleArrayMap on ia32 and x64.
+  UNREACHABLE();
+  return NULL;
+}
+
+
 LInstruction* LChunkBuilder::DoStoreKeyedSpecializedArrayElement(
     HStoreKeyedSpecializedArrayElement* instr) {
   Representation representation(instr->value()->representation());
@@ -2038,8 +2137,8 @@ LInstruction* LChunkBuilder::DoStoreNamedGeneric(HStoreNamedGeneric* instr) {
 
 
 LInstruction* LChunkBuilder::DoStringAdd(HStringAdd* instr) {
-  LOperand* left = UseRegisterAtStart(instr->left());
-  LOperand* right = UseRegisterAtStart(instr->right());
+  LOperand* left = UseFixed(instr->left(), r1);
+  LOperand* right = UseFixed(instr->right(), r0);
   return MarkAsCall(DefineFixed(new LStringAdd(left, right), r0), instr);
 }
 
@@ -2059,6 +2158,12 @@ LInstruction* LChunkBuilder::DoStringCharFromCode(HStringCharFromCode* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoStringHashField(HStringHashField* instr) {
+  LOperand* string = UseRegisterAtStart(instr->value());
+  return DefineAsRegister(new LStringHashField(string));
+}
+
+
 LInstruction* LChunkBuilder::DoStringLength(HStringLength* instr) {
   LOperand* string = UseRegisterAtStart(instr->value());
   return DefineAsRegister(new LStringLength(string));
@@ -2070,6 +2175,11 @@ LInstruction* LChunkBuilder::DoArrayLiteral(HArrayLiteral* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoAllocateObject(HAllocateObject* instr) {
+  return MarkAsCall(DefineFixed(new LAllocateObject, r0), instr);
+}
+
+
 LInstruction* LChunkBuilder::DoObjectLiteralFast(HObjectLiteralFast* instr) {
   return MarkAsCall(DefineFixed(new LObjectLiteralFast, r0), instr);
 }
@@ -2137,6 +2247,14 @@ LInstruction* LChunkBuilder::DoArgumentsObject(HArgumentsObject* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoCapturedObject(HCapturedObject* instr) {
+  // The object only exists in deoptimization environments, which use the
+  // current values of its fields.
+  instr->ResetCurrentValues();
+  return NULL;
+}
+
+
 LInstruction* LChunkBuilder::DoAccessArgumentsAt(HAccessArgumentsAt* instr) {
   LOperand* arguments = UseRegister(instr->arguments());
   LOperand* length = UseTempRegister(instr->length());
@@ -2215,9 +2333,12 @@ LInstruction* LChunkBuilder::DoEnterInlined(HEnterInlined* instr) {
   HEnvironment* outer = current_block_->last_environment();
   HConstant* undefined = graph()->GetConstantUndefined();
   HEnvironment* inner = outer->CopyForInlining(instr->closure(),
+                                               instr->arguments_count(),
                                                instr->function(),
                                                undefined,
-                                               instr->call_kind());
+                                               instr->call_kind(),
+                                               instr->dynamic_closure());
+  inner->set_entry(instr);
   current_block_->UpdateEnvironment(inner);
   chunk_->AddInlinedClosure(instr->closure());
   return NULL;
@@ -2225,9 +2346,16 @@ LInstruction* LChunkBuilder::DoEnterInlined(HEnterInlined* instr) {
 
 
 LInstruction* LChunkBuilder::DoLeaveInlined(HLeaveInlined* instr) {
-  HEnvironment* outer = current_block_->last_environment()->outer();
+  LInstruction* pop = NULL;
+  HEnvironment* env = current_block_->last_environment();
+  if (env->entry()->arguments_pushed()) {
+    int argument_count = env->entry()->arguments_count();
+    pop = new LDrop(argument_count);
+    argument_count_ -= argument_count;
+  }
+  HEnvironment* outer = env->outer();
   current_block_->UpdateEnvironment(outer);
-  return NULL;
+  return pop;
 }
 
 
@@ -102,6 +102,7 @@ void LCodeGen::Abort(const char* format, ...) {
     va_end(arguments);
     PrintF("\n");
   }
+  info()->set_bailout_reason(format);
   status_ = ABORTED;
 }
 
@@ -445,16 +446,36 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
                                 Translation* translation) {
   if (environment == NULL) return;
 
-  // The translation includes one command per value in the environment.
-  int translation_size = environment->values()->length();
+  // The translation includes one command per frame value in the environment.
+  int translation_size = environment->translation_size();
   // The output frame height does not include the parameters.
   int height = translation_size - environment->parameter_count();
 
   WriteTranslation(environment->outer(), translation);
   int closure_id = DefineDeoptimizationLiteral(environment->closure());
+  if (environment->has_dynamic_closure()) {
+    closure_id = Translation::DynamicClosureId(closure_id);
+  }
   translation->BeginFrame(environment->ast_id(), closure_id, height);
+  // The fields of captured objects follow the frame values.
+  int field_index = translation_size;
   for (int i = 0; i < translation_size; ++i) {
     LOperand* value = environment->values()->at(i);
+    LCapturedObject* captured = environment->CapturedObjectAt(i);
+    if (captured != NULL) {
+      int boilerplate_id =
+          DefineDeoptimizationLiteral(captured->boilerplate());
+      translation->StoreCapturedObject(boilerplate_id,
+                                       captured->field_count());
+      for (int j = 0; j < captured->field_count(); ++j) {
+        AddToTranslation(translation,
+                         environment->values()->at(field_index),
+                         environment->HasTaggedValueAt(field_index),
+                         environment->HasUint32ValueAt(field_index));
+        field_index++;
+      }
+      continue;
+    }
     // spilled_registers_ and spilled_double_registers_ are either
     // both NULL or both set.
     if (environment->spilled_registers() != NULL && value != NULL) {
@@ -463,7 +484,8 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         translation->MarkDuplicate();
         AddToTranslation(translation,
                          environment->spilled_registers()[value->index()],
-                         environment->HasTaggedValueAt(i));
+                         environment->HasTaggedValueAt(i),
+                         environment->HasUint32ValueAt(i));
       } else if (
           value->IsDoubleRegister() &&
           environment->spilled_double_registers()[value->index()] != NULL) {
@@ -471,18 +493,23 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         AddToTranslation(
             translation,
             environment->spilled_double_registers()[value->index()],
+            false,
             false);
       }
     }
 
-    AddToTranslation(translation, value, environment->HasTaggedValueAt(i));
+    AddToTranslation(translation,
+                     value,
+                     environment->HasTaggedValueAt(i),
+                     environment->HasUint32ValueAt(i));
   }
 }
 
 
 void LCodeGen::AddToTranslation(Translation* translation,
                                 LOperand* op,
-                                bool is_tagged) {
+                                bool is_tagged,
+                                bool is_uint32) {
   if (op == NULL) {
     // TODO(twuerthinger): Introduce marker operands to indicate that this value
     // is not present and must be reconstructed from the deoptimizer. Currently
@@ -491,6 +518,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
   } else if (op->IsStackSlot()) {
     if (is_tagged) {
       translation->StoreStackSlot(op->index());
+    } else if (is_uint32) {
+      translation->StoreUint32StackSlot(op->index());
     } else {
       translation->StoreInt32StackSlot(op->index());
     }
@@ -504,6 +533,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
     Register reg = ToRegister(op);
     if (is_tagged) {
       translation->StoreRegister(reg);
+    } else if (is_uint32) {
+      translation->StoreUint32Register(reg);
     } else {
       translation->StoreInt32Register(reg);
     }
@@ -653,6 +684,15 @@ void LCodeGen::PopulateDeoptimizationData(Handle<Code> code) {
   }
   data->SetLiteralArray(*literals);
 
+  const ZoneList<Handle<JSGlobalPropertyCell> >* cells =
+      graph()->dependent_cells();
+  Handle<FixedArray> dependent_cells =
+      factory()->NewFixedArray(cells->length(), TENURED);
+  for (int i = 0; i < cells->length(); i++) {
+    dependent_cells->set(i, *cells->at(i));
+  }
+  data->SetDependentCells(*dependent_cells);
+
   data->SetOsrAstId(Smi::FromInt(info_->osr_ast_id()));
   data->SetOsrPcOffset(Smi::FromInt(osr_pc_offset_));
 
@@ -856,6 +896,70 @@ void LCodeGen::DoUnknownOSRValue(LUnknownOSRValue* instr) {
 }
 
 
+void LCodeGen::DoMathMinMax(LMathMinMax* instr) {
+  LOperand* left = instr->InputAt(0);
+  LOperand* right = instr->InputAt(1);
+  HMathMinMax::Operation operation = instr->hydrogen()->operation();
+  if (instr->hydrogen()->representation().IsInteger32()) {
+    Condition condition = (operation == HMathMinMax::kMathMin) ? le : ge;
+    Register left_reg = ToRegister(left);
+    Operand right_op = (right->IsRegister() || right->IsConstantOperand())
+        ? ToOperand(right)
+        : Operand(EmitLoadRegister(right, ip));
+    Register result_reg = ToRegister(instr->result());
+    __ cmp(left_reg, right_op);
+    if (!result_reg.is(left_reg)) {
+      __ mov(result_reg, left_reg, LeaveCC, condition);
+    }
+    __ mov(result_reg, right_op, LeaveCC, NegateCondition(condition));
+  } else {
+    ASSERT(instr->hydrogen()->representation().IsDouble());
+    DoubleRegister left_reg = ToDoubleRegister(left);
+    DoubleRegister right_reg = ToDoubleRegister(right);
+    DoubleRegister result_reg = ToDoubleRegister(instr->result());
+    Label check_nan_left, check_zero, return_left, return_right, done;
+    Condition condition = (operation == HMathMinMax::kMathMin) ? lt : gt;
+    __ VFPCompareAndSetFlags(left_reg, right_reg);
+    __ b(vs, &check_nan_left);  // At least one NaN.
+    __ b(eq, &check_zero);  // left == right.
+    __ b(condition, &return_left);
+    __ b(al, &return_right);
+
+    __ bind(&check_zero);
+    __ VFPCompareAndSetFlags(left_reg, 0.0);
+    __ b(ne, &return_left);  // left == right != 0.
+    // At this point, both left and right are either 0 or -0.
+    if (operation == HMathMinMax::kMathMin) {
+      // min(a, b) is -(-a - b), which is -0 if either is -0.  The inputs
+      // may share a register with the result, so negate into a scratch.
+      __ vneg(double_scratch0(), left_reg);
+      __ vsub(result_reg, double_scratch0(), right_reg);
+      __ vneg(result_reg, result_reg);
+    } else {
+      // Since we operate on +0 and/or -0, vadd and vand have the same
+      // effect, and vand is a NEON instruction.
+      __ vadd(result_reg, left_reg, right_reg);
+    }
+    __ b(&done);
+
+    __ bind(&check_nan_left);
+    __ VFPCompareAndSetFlags(left_reg, left_reg);
+    __ b(vs, &return_left);  // left == NaN.
+    __ bind(&return_right);
+    if (!right_reg.is(result_reg)) {
+      __ vmov(result_reg, right_reg);
+    }
+    __ b(&done);
+
+    __ bind(&return_left);
+    if (!left_reg.is(result_reg)) {
+      __ vmov(result_reg, left_reg);
+    }
+    __ bind(&done);
+  }
+}
+
+
 void LCodeGen::DoModI(LModI* instr) {
   if (instr->hydrogen()->HasPowerOf2Divisor()) {
     Register dividend = ToRegister(instr->InputAt(0));
@@ -1037,6 +1141,22 @@ void LCodeGen::DoDivI(LDivI* instr) {
     __ bind(&left_not_min_int);
   }
 
+  if (instr->hydrogen()->all_uses_truncating()) {
+    // The quotient of two int32 values rounded to double truncates to the
+    // same int32 as the exact quotient, and the only quotient out of the
+    // int32 range, kMinInt / -1, has been excluded above.
+    DwVfpRegister dividend = ToDoubleRegister(instr->TempAt(0));
+    DwVfpRegister divisor = double_scratch0();
+    __ vmov(divisor.low(), left);
+    __ vcvt_f64_s32(dividend, divisor.low());
+    __ vmov(divisor.low(), right);
+    __ vcvt_f64_s32(divisor, divisor.low());
+    __ vdiv(dividend, dividend, divisor);
+    __ vcvt_s32_f64(divisor.low(), dividend);
+    __ vmov(result, divisor.low());
+    return;
+  }
+
   Label done, deoptimize;
   // Test for a few common cases first.
   __ cmp(right, Operand(1));
@@ -1391,6 +1511,46 @@ void LCodeGen::DoValueOf(LValueOf* instr) {
 }
 
 
+void LCodeGen::DoDateField(LDateField* instr) {
+  Register object = ToRegister(instr->InputAt(0));
+  Register result = ToRegister(instr->result());
+  Register scratch = ToRegister(instr->TempAt(0));
+  Smi* index = instr->index();
+  Label runtime, done;
+  ASSERT(object.is(result));
+  ASSERT(object.is(r0));
+  ASSERT(!scratch.is(scratch0()));
+  ASSERT(!scratch.is(object));
+
+#ifdef DEBUG
+  __ AbortIfSmi(object);
+  __ CompareObjectType(object, scratch, scratch, JS_DATE_TYPE);
+  __ Assert(eq, "Trying to get date field from non-date.");
+#endif
+
+  if (index->value() == 0) {
+    __ ldr(result, FieldMemOperand(object, JSDate::kValueOffset));
+  } else {
+    if (index->value() < JSDate::kFirstUncachedField) {
+      ExternalReference stamp = ExternalReference::date_cache_stamp(isolate());
+      __ mov(scratch, Operand(stamp));
+      __ ldr(scratch, MemOperand(scratch));
+      __ ldr(scratch0(), FieldMemOperand(object, JSDate::kCacheStampOffset));
+      __ cmp(scratch, scratch0());
+      __ b(ne, &runtime);
+      __ ldr(result, FieldMemOperand(object, JSDate::kValueOffset +
+                                             kPointerSize * index->value()));
+      __ jmp(&done);
+    }
+    __ bind(&runtime);
+    __ PrepareCallCFunction(2, scratch);
+    __ mov(r1, Operand(index));
+    __ CallCFunction(ExternalReference::get_date_field_function(isolate()), 2);
+    __ bind(&done);
+  }
+}
+
+
 void LCodeGen::DoBitNotI(LBitNotI* instr) {
   Register input = ToRegister(instr->InputAt(0));
   Register result = ToRegister(instr->result());
@@ -1887,6 +2047,29 @@ void LCodeGen::DoStringCompareAndBranch(LStringCompareAndBranch* instr) {
   int true_block = chunk_->LookupDestination(instr->true_block_id());
   int false_block = chunk_->LookupDestination(instr->false_block_id());
 
+  if (op == Token::EQ || op == Token::EQ_STRICT) {
+    // Identical strings are equal.  Different symbols and strings of
+    // different lengths are not.
+    Register left = ToRegister(instr->InputAt(0));
+    Register right = ToRegister(instr->InputAt(1));
+    Label* true_label = chunk_->GetAssemblyLabel(true_block);
+    Label* false_label = chunk_->GetAssemblyLabel(false_block);
+    __ cmp(left, right);
+    __ b(eq, true_label);
+    __ ldr(r2, FieldMemOperand(left, HeapObject::kMapOffset));
+    __ ldr(r3, FieldMemOperand(right, HeapObject::kMapOffset));
+    __ ldrb(r2, FieldMemOperand(r2, Map::kInstanceTypeOffset));
+    __ ldrb(r3, FieldMemOperand(r3, Map::kInstanceTypeOffset));
+    STATIC_ASSERT(kSymbolTag != 0);
+    __ and_(r2, r2, Operand(r3));
+    __ tst(r2, Operand(kIsSymbolMask));
+    __ b(ne, false_label);
+    __ ldr(r2, FieldMemOperand(left, String::kLengthOffset));
+    __ ldr(r3, FieldMemOperand(right, String::kLengthOffset));
+    __ cmp(r2, r3);
+    __ b(ne, false_label);
+  }
+
   Handle<Code> ic = CompareIC::GetUninitialized(op);
   CallCode(ic, RelocInfo::CODE_TARGET, instr);
   __ cmp(r0, Operand(0));  // This instruction also signals no smi code inlined.
@@ -2629,11 +2812,10 @@ void LCodeGen::DoLoadKeyedSpecializedArrayElement(
         break;
       case EXTERNAL_UNSIGNED_INT_ELEMENTS:
         __ ldr(result, mem_operand);
-        __ cmp(result, Operand(0x80000000));
-        // TODO(danno): we could be more clever here, perhaps having a special
-        // version of the stub that detects if the overflow case actually
-        // happens, and generate code that returns a double rather than int.
-        DeoptimizeIf(cs, instr->environment());
+        if (!instr->hydrogen_value()->IsUint32()) {
+          __ cmp(result, Operand(0x80000000));
+          DeoptimizeIf(cs, instr->environment());
+        }
         break;
       case EXTERNAL_FLOAT_ELEMENTS:
       case EXTERNAL_DOUBLE_ELEMENTS:
@@ -2659,6 +2841,14 @@ void LCodeGen::DoLoadKeyedGeneric(LLoadKeyedGeneric* instr) {
 
 
 void LCodeGen::DoArgumentsElements(LArgumentsElements* instr) {
+  if (instr->hydrogen()->from_inlined()) {
+    // The arguments of an inlined function were just pushed.  The result is
+    // biased like a frame pointer, for LAccessArgumentsAt.
+    Register result = ToRegister(instr->result());
+    __ sub(result, sp, Operand(2 * kPointerSize));
+    return;
+  }
+
   Register scratch = scratch0();
   Register result = ToRegister(instr->result());
 
@@ -2798,6 +2988,11 @@ void LCodeGen::DoPushArgument(LPushArgument* instr) {
 }
 
 
+void LCodeGen::DoDrop(LDrop* instr) {
+  __ Drop(instr->count());
+}
+
+
 void LCodeGen::DoThisFunction(LThisFunction* instr) {
   Register result = ToRegister(instr->result());
   LoadHeapObject(result, instr->hydrogen()->closure());
@@ -2846,8 +3041,19 @@ void LCodeGen::CallKnownFunction(Handle<JSFunction> function,
 
   // Set r0 to arguments count if adaption is not needed. Assumes that r0
   // is available to write to at this point.
+  int formal_count = function->shared()->formal_parameter_count();
   if (!function->NeedsArgumentsAdaption()) {
     __ mov(r0, Operand(arity));
+  } else if (arity != formal_count) {
+    // The target does not look at the actual argument count, so adapt the
+    // arguments here instead of going through the arguments adaptor.
+    ASSERT(!function->shared()->uses_arguments());
+    if (arity < formal_count) {
+      __ LoadRoot(ip, Heap::kUndefinedValueRootIndex);
+      for (int i = arity; i < formal_count; i++) __ push(ip);
+    } else {
+      __ Drop(arity - formal_count);
+    }
   }
 
   LPointerMap* pointers = instr->pointer_map();
@@ -3585,10 +3791,77 @@ void LCodeGen::DoTransitionElementsKind(LTransitionElementsKind* instr) {
 
 
 void LCodeGen::DoStringAdd(LStringAdd* instr) {
-  __ push(ToRegister(instr->left()));
-  __ push(ToRegister(instr->right()));
+  Register left = ToRegister(instr->left());
+  Register right = ToRegister(instr->right());
+  ASSERT(left.is(r1));
+  ASSERT(right.is(r0));
+  ASSERT(ToRegister(instr->result()).is(r0));
+
+  Label call_stub, done;
+  if (FLAG_inline_new) {
+    // Adding an empty string returns the other string.
+    __ ldr(r2, FieldMemOperand(left, String::kLengthOffset));
+    __ ldr(r3, FieldMemOperand(right, String::kLengthOffset));
+    __ cmp(r2, Operand(Smi::FromInt(0)));
+    __ b(eq, &done);
+    __ cmp(r3, Operand(Smi::FromInt(0)));
+    __ mov(r0, left, LeaveCC, eq);
+    __ b(eq, &done);
+
+    // Results shorter than a cons string are flat strings, which the stub
+    // builds.  Exceptionally long results are handled by the stub too.
+    __ add(r6, r2, Operand(r3));
+    __ SmiUntag(r6);
+    __ cmp(r6, Operand(String::kMinNonFlatLength));
+    __ b(lt, &call_stub);
+    ASSERT(IsPowerOf2(String::kMaxLength + 1));
+    __ cmp(r6, Operand(String::kMaxLength + 1));
+    __ b(hs, &call_stub);
+
+    // The depth of the result is one more than that of its deeper part.
+    // Too deep results are rebalanced by the runtime system.
+    __ ldr(r2, FieldMemOperand(left, HeapObject::kMapOffset));
+    __ ldr(r3, FieldMemOperand(right, HeapObject::kMapOffset));
+    __ ldrb(r2, FieldMemOperand(r2, Map::kInstanceTypeOffset));
+    __ ldrb(r3, FieldMemOperand(r3, Map::kInstanceTypeOffset));
+    __ mov(r5, Operand(Smi::FromInt(0)));
+    __ and_(r4, r2, Operand(kStringRepresentationMask));
+    __ cmp(r4, Operand(kConsStringTag));
+    __ ldr(r5, FieldMemOperand(left, ConsString::kDepthOffset), eq);
+    __ and_(r4, r3, Operand(kStringRepresentationMask));
+    __ cmp(r4, Operand(kConsStringTag));
+    __ ldr(r4, FieldMemOperand(right, ConsString::kDepthOffset), eq);
+    __ mov(r4, Operand(Smi::FromInt(0)), LeaveCC, ne);
+    __ cmp(r4, r5);
+    __ mov(r5, r4, LeaveCC, gt);
+    __ add(r5, r5, Operand(Smi::FromInt(1)));
+    __ cmp(r5, Operand(Smi::FromInt(ConsString::kMaxDepth)));
+    __ b(gt, &call_stub);
+
+    // The result is an ASCII cons string if both strings are ASCII.
+    Label two_byte, allocated;
+    STATIC_ASSERT(kTwoByteStringTag == 0);
+    __ tst(r2, Operand(kStringEncodingMask));
+    __ tst(r3, Operand(kStringEncodingMask), ne);
+    __ b(eq, &two_byte);
+    __ AllocateAsciiConsString(r7, r6, r2, r3, &call_stub);
+    __ b(&allocated);
+    __ bind(&two_byte);
+    __ AllocateTwoByteConsString(r7, r6, r2, r3, &call_stub);
+    __ bind(&allocated);
+    __ str(left, FieldMemOperand(r7, ConsString::kFirstOffset));
+    __ str(right, FieldMemOperand(r7, ConsString::kSecondOffset));
+    __ str(r5, FieldMemOperand(r7, ConsString::kDepthOffset));
+    __ mov(r0, r7);
+    __ b(&done);
+  }
+
+  __ bind(&call_stub);
+  __ push(left);
+  __ push(right);
   StringAddStub stub(NO_STRING_CHECK_IN_STUB);
   CallCode(stub.GetCode(), RelocInfo::CODE_TARGET, instr);
+  __ bind(&done);
 }
 
 
@@ -3695,6 +3968,13 @@ void LCodeGen::DoDeferredStringCharFromCode(LStringCharFromCode* instr) {
 }
 
 
+void LCodeGen::DoStringHashField(LStringHashField* instr) {
+  Register string = ToRegister(instr->string());
+  Register result = ToRegister(instr->result());
+  __ ldr(result, FieldMemOperand(string, String::kHashFieldOffset));
+}
+
+
 void LCodeGen::DoStringLength(LStringLength* instr) {
   Register string = ToRegister(instr->InputAt(0));
   Register result = ToRegister(instr->result());
@@ -3719,6 +3999,15 @@ void LCodeGen::DoInteger32ToDouble(LInteger32ToDouble* instr) {
 }
 
 
+void LCodeGen::DoUint32ToDouble(LUint32ToDouble* instr) {
+  LOperand* input = instr->InputAt(0);
+  LOperand* output = instr->result();
+  SwVfpRegister flt_scratch = double_scratch0().low();
+  __ vmov(flt_scratch, ToRegister(input));
+  __ vcvt_f64_u32(ToDoubleRegister(output), flt_scratch);
+}
+
+
 void LCodeGen::DoNumberTagI(LNumberTagI* instr) {
   class DeferredNumberTagI: public LDeferredCode {
    public:
@@ -3785,6 +4074,71 @@ void LCodeGen::DoDeferredNumberTagI(LNumberTagI* instr) {
 }
 
 
+void LCodeGen::DoNumberTagU(LNumberTagU* instr) {
+  class DeferredNumberTagU: public LDeferredCode {
+   public:
+    DeferredNumberTagU(LCodeGen* codegen, LNumberTagU* instr)
+        : LDeferredCode(codegen), instr_(instr) { }
+    virtual void Generate() { codegen()->DoDeferredNumberTagU(instr_); }
+    virtual LInstruction* instr() { return instr_; }
+   private:
+    LNumberTagU* instr_;
+  };
+
+  LOperand* input = instr->InputAt(0);
+  ASSERT(input->IsRegister() && input->Equals(instr->result()));
+  Register reg = ToRegister(input);
+
+  DeferredNumberTagU* deferred = new DeferredNumberTagU(this, instr);
+  __ cmp(reg, Operand(Smi::kMaxValue));
+  __ b(hi, deferred->entry());
+  __ SmiTag(reg);
+  __ bind(deferred->exit());
+}
+
+
+void LCodeGen::DoDeferredNumberTagU(LNumberTagU* instr) {
+  Label slow;
+  Register reg = ToRegister(instr->InputAt(0));
+  DoubleRegister dbl_scratch = double_scratch0();
+  SwVfpRegister flt_scratch = dbl_scratch.low();
+
+  // Preserve the value of all registers.
+  PushSafepointRegistersScope scope(this, Safepoint::kWithRegisters);
+
+  // The value does not fit in a smi. Try to allocate a heap number in new
+  // space and store the value in there. If that fails, call the runtime
+  // system.
+  Label done;
+  __ vmov(flt_scratch, reg);
+  __ vcvt_f64_u32(dbl_scratch, flt_scratch);
+  if (FLAG_inline_new) {
+    __ LoadRoot(r6, Heap::kHeapNumberMapRootIndex);
+    __ AllocateHeapNumber(r5, r3, r4, r6, &slow);
+    if (!reg.is(r5)) __ mov(reg, r5);
+    __ b(&done);
+  }
+
+  // Slow case: Call the runtime system to do the number allocation.
+  __ bind(&slow);
+
+  // Put a valid pointer value in the stack slot where the result register
+  // is stored, as this register is in the pointer map, but contains an
+  // integer value.
+  __ mov(ip, Operand(0));
+  __ StoreToSafepointRegisterSlot(ip, reg);
+  CallRuntimeFromDeferred(Runtime::kAllocateHeapNumber, 0, instr);
+  if (!reg.is(r0)) __ mov(reg, r0);
+
+  // Done. Put the value in dbl_scratch into the value of the allocated heap
+  // number.
+  __ bind(&done);
+  __ sub(ip, reg, Operand(kHeapObjectTag));
+  __ vstr(dbl_scratch, ip, HeapNumber::kValueOffset);
+  __ StoreToSafepointRegisterSlot(reg, reg);
+}
+
+
 void LCodeGen::DoNumberTagD(LNumberTagD* instr) {
   class DeferredNumberTagD: public LDeferredCode {
    public:
@@ -4280,8 +4634,6 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 
   // Copy object header.
   ASSERT(object->properties()->length() == 0);
-  ASSERT(object->elements()->length() == 0 ||
-         object->elements()->map() == isolate()->heap()->fixed_cow_array_map());
   int inobject_properties = object->map()->inobject_properties();
   int header_size = size - inobject_properties * kPointerSize;
   for (int i = 0; i < header_size; i += kPointerSize) {
@@ -4289,6 +4641,24 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
     __ str(r2, FieldMemOperand(result, current_offset + i));
   }
 
+  // Copy the elements of a small array literal to right after it.
+  Handle<FixedArrayBase> elements(object->elements());
+  if (elements->length() > 0 &&
+      elements->map() != isolate()->heap()->fixed_cow_array_map()) {
+    ASSERT(object->IsJSArray() && inobject_properties == 0);
+    int elements_offset = *offset;
+    int elements_size = elements->Size();
+    *offset += elements_size;
+    __ add(r2, result, Operand(elements_offset));
+    __ str(r2, FieldMemOperand(result,
+                               current_offset + JSObject::kElementsOffset));
+    __ ldr(source, FieldMemOperand(source, JSObject::kElementsOffset));
+    for (int i = 0; i < elements_size; i += kPointerSize) {
+      __ ldr(r2, FieldMemOperand(source, i));
+      __ str(r2, FieldMemOperand(result, elements_offset + i));
+    }
+  }
+
   // Copy in-object properties.
   for (int i = 0; i < inobject_properties; i++) {
     int total_offset = current_offset + object->GetInObjectPropertyOffset(i);
@@ -4310,8 +4680,60 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 }
 
 
+void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
+  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
+  Handle<Map> initial_map = instr->hydrogen()->initial_map();
+  int instance_size = initial_map->instance_size();
+
+  // Deoptimize if the constructor got a new initial map since, for
+  // example because its prototype was replaced.
+  LoadHeapObject(r1, constructor);
+  __ ldr(r2, FieldMemOperand(r1, JSFunction::kPrototypeOrInitialMapOffset));
+  __ cmp(r2, Operand(initial_map));
+  DeoptimizeIf(ne, instr->environment());
+
+  // The object is always allocated in new space, so the stores that
+  // initialize its properties need no write barrier.
+  Label allocated, runtime_allocate;
+  __ AllocateInNewSpace(instance_size, r0, r2, r3, &runtime_allocate,
+                        TAG_OBJECT);
+  __ jmp(&allocated);
+
+  __ bind(&runtime_allocate);
+  __ mov(r0, Operand(Smi::FromInt(instance_size)));
+  __ push(r0);
+  CallRuntime(Runtime::kAllocateInNewSpace, 1, instr);
+
+  __ bind(&allocated);
+  __ mov(r1, Operand(initial_map));
+  __ str(r1, FieldMemOperand(r0, JSObject::kMapOffset));
+  __ LoadRoot(r1, Heap::kEmptyFixedArrayRootIndex);
+  __ str(r1, FieldMemOperand(r0, JSObject::kPropertiesOffset));
+  __ str(r1, FieldMemOperand(r0, JSObject::kElementsOffset));
+  // The in-object properties follow the header.
+  ASSERT(initial_map->instance_size() ==
+         JSObject::kHeaderSize +
+         initial_map->inobject_properties() * kPointerSize);
+  __ LoadRoot(r1, Heap::kUndefinedValueRootIndex);
+  for (int offset = JSObject::kHeaderSize;
+       offset < instance_size;
+       offset += kPointerSize) {
+    __ str(r1, FieldMemOperand(r0, offset));
+  }
+}
+
+
 void LCodeGen::DoObjectLiteralFast(LObjectLiteralFast* instr) {
   int size = instr->hydrogen()->total_size();
+  Handle<JSObject> boilerplate = instr->hydrogen()->boilerplate();
+
+  // Deoptimize if the elements kind of the boilerplate changed since.
+  if (instr->hydrogen()->copies_elements()) {
+    LoadHeapObject(r1, boilerplate);
+    __ ldr(r2, FieldMemOperand(r1, HeapObject::kMapOffset));
+    __ cmp(r2, Operand(Handle<Map>(boilerplate->map())));
+    DeoptimizeIf(ne, instr->environment());
+  }
 
   // Allocate all objects that are part of the literal in one big
   // allocation. This avoids multiple limit checks.
@@ -4326,8 +4748,8 @@ void LCodeGen::DoObjectLiteralFast(LObjectLiteralFast* instr) {
 
   __ bind(&allocated);
   int offset = 0;
-  LoadHeapObject(r1, instr->hydrogen()->boilerplate());
-  EmitDeepCopy(instr->hydrogen()->boilerplate(), r0, r1, &offset);
+  LoadHeapObject(r1, boilerplate);
+  EmitDeepCopy(boilerplate, r0, r1, &offset);
   ASSERT_EQ(size, offset);
 }
 
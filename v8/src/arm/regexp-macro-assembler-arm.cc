@@ -171,6 +171,7 @@ void RegExpMacroAssemblerARM::AdvanceRegister(int reg, int by) {
 
 void RegExpMacroAssemblerARM::Backtrack() {
   CheckPreemption();
+  CheckBacktrackLimit();
   // Pop Code* offset from backtrack stack, add Code* and jump to location.
   Pop(r0);
   __ add(pc, r0, Operand(code_pointer()));
@@ -808,6 +809,12 @@ Handle<HeapObject> RegExpMacroAssemblerARM::GetCode(Handle<String> source) {
     SafeReturn();
   }
 
+  if (backtrack_limit_label_.is_linked()) {
+    // Reached if the backtrack budget has been used up.
+    __ bind(&backtrack_limit_label_);
+    __ jmp(&exit_with_exception);
+  }
+
   if (exit_with_exception.is_linked()) {
     // If any of the code above needed to exit with an exception.
     __ bind(&exit_with_exception);
@@ -1200,6 +1207,18 @@ void RegExpMacroAssemblerARM::CheckPreemption() {
 }
 
 
+void RegExpMacroAssemblerARM::CheckBacktrackLimit() {
+  if (FLAG_regexp_backtrack_limit <= 0) return;
+  ExternalReference backtracks_left =
+      ExternalReference::address_of_regexp_backtracks_left(masm_->isolate());
+  __ mov(r0, Operand(backtracks_left));
+  __ ldr(r1, MemOperand(r0));
+  __ sub(r1, r1, Operand(1), SetCC);
+  __ str(r1, MemOperand(r0));
+  __ b(eq, &backtrack_limit_label_);
+}
+
+
 void RegExpMacroAssemblerARM::CheckStackLimit() {
   ExternalReference stack_limit =
       ExternalReference::address_of_regexp_stack_limit(masm_->isolate());
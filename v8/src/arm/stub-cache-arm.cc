@@ -182,6 +182,9 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   ASSERT(!extra.is(no_reg));
   ASSERT(!extra2.is(no_reg));
 
+  Counters* counters = isolate->counters();
+  __ IncrementCounter(counters->stub_cache_probes(), 1, extra, extra2);
+
   // Check that the receiver isn't a smi.
   __ JumpIfSmi(receiver, &miss);
 
@@ -190,19 +193,21 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ ldr(ip, FieldMemOperand(receiver, HeapObject::kMapOffset));
   __ add(scratch, scratch, Operand(ip));
   __ eor(scratch, scratch, Operand(flags));
-  __ and_(scratch,
-          scratch,
-          Operand((kPrimaryTableSize - 1) << kHeapObjectTagSize));
+  __ mov(extra, Operand(ExternalReference(mask_reference(kPrimary))));
+  __ ldr(extra, MemOperand(extra));
+  __ and_(scratch, scratch, Operand(extra));
 
   // Probe the primary table.
   ProbeTable(isolate, masm, flags, kPrimary, name, scratch, extra, extra2);
 
   // Primary miss: Compute hash for secondary probe.
+  __ IncrementCounter(
+      counters->stub_cache_secondary_probes(), 1, extra, extra2);
   __ sub(scratch, scratch, Operand(name));
   __ add(scratch, scratch, Operand(flags));
-  __ and_(scratch,
-          scratch,
-          Operand((kSecondaryTableSize - 1) << kHeapObjectTagSize));
+  __ mov(extra, Operand(ExternalReference(mask_reference(kSecondary))));
+  __ ldr(extra, MemOperand(extra));
+  __ and_(scratch, scratch, Operand(extra));
 
   // Probe the secondary table.
   ProbeTable(isolate, masm, flags, kSecondary, name, scratch, extra, extra2);
@@ -210,6 +215,7 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   // Cache miss: Fall-through and let caller handle the miss by
   // entering the runtime system.
   __ bind(&miss);
+  __ IncrementCounter(counters->stub_cache_misses(), 1, extra, extra2);
 }
 
 
@@ -2585,6 +2591,12 @@ Handle<Code> StoreStubCompiler::CompileStoreGlobal(
   __ cmp(r5, r6);
   __ b(eq, &miss);
 
+  // Check that optimized code does not embed the value in the cell. The
+  // runtime system deoptimizes that code before changing it.
+  __ ldr(r6, FieldMemOperand(r4, JSGlobalPropertyCell::kStateOffset));
+  __ cmp(r6, Operand(Smi::FromInt(JSGlobalPropertyCell::CONSTANT)));
+  __ b(eq, &miss);
+
   // Store the value in the cell.
   __ str(r0, FieldMemOperand(r4, JSGlobalPropertyCell::kValueOffset));
 
@@ -997,13 +997,25 @@ function ArraySort(comparefn) {
 }
 
 
+// Helper functions to throw errors.  ArrayFilter, ArrayForEach and ArrayMap
+// do not throw themselves, so that the optimizing compiler can inline them
+// together with their callbacks.
+function ThrowCalledOnNullOrUndefined(name) {
+  throw MakeTypeError("called_on_null_or_undefined", [name]);
+}
+
+
+function ThrowCalledNonCallable(f) {
+  throw MakeTypeError('called_non_callable', [ f ]);
+}
+
+
 // The following functions cannot be made efficient on sparse arrays while
 // preserving the semantics, since the calls to the receiver function can add
 // or delete elements from the array.
 function ArrayFilter(f, receiver) {
   if (IS_NULL_OR_UNDEFINED(this) && !IS_UNDETECTABLE(this)) {
-    throw MakeTypeError("called_on_null_or_undefined",
-                        ["Array.prototype.filter"]);
+    ThrowCalledOnNullOrUndefined("Array.prototype.filter");
   }
 
   // Pull out the length so that modifications to the length in the
@@ -1011,9 +1023,7 @@ function ArrayFilter(f, receiver) {
   var array = ToObject(this);
   var length = ToUint32(array.length);
 
-  if (!IS_SPEC_FUNCTION(f)) {
-    throw MakeTypeError('called_non_callable', [ f ]);
-  }
+  if (!IS_SPEC_FUNCTION(f)) ThrowCalledNonCallable(f);
   if (IS_NULL_OR_UNDEFINED(receiver)) {
     receiver = %GetDefaultReceiver(f) || receiver;
   } else if (!IS_SPEC_OBJECT(receiver)) {
@@ -1038,8 +1048,7 @@ function ArrayFilter(f, receiver) {
 
 function ArrayForEach(f, receiver) {
   if (IS_NULL_OR_UNDEFINED(this) && !IS_UNDETECTABLE(this)) {
-    throw MakeTypeError("called_on_null_or_undefined",
-                        ["Array.prototype.forEach"]);
+    ThrowCalledOnNullOrUndefined("Array.prototype.forEach");
   }
 
   // Pull out the length so that modifications to the length in the
@@ -1047,9 +1056,7 @@ function ArrayForEach(f, receiver) {
   var array = ToObject(this);
   var length = TO_UINT32(array.length);
 
-  if (!IS_SPEC_FUNCTION(f)) {
-    throw MakeTypeError('called_non_callable', [ f ]);
-  }
+  if (!IS_SPEC_FUNCTION(f)) ThrowCalledNonCallable(f);
   if (IS_NULL_OR_UNDEFINED(receiver)) {
     receiver = %GetDefaultReceiver(f) || receiver;
   } else if (!IS_SPEC_OBJECT(receiver)) {
@@ -1128,8 +1135,7 @@ function ArrayEvery(f, receiver) {
 
 function ArrayMap(f, receiver) {
   if (IS_NULL_OR_UNDEFINED(this) && !IS_UNDETECTABLE(this)) {
-    throw MakeTypeError("called_on_null_or_undefined",
-                        ["Array.prototype.map"]);
+    ThrowCalledOnNullOrUndefined("Array.prototype.map");
   }
 
   // Pull out the length so that modifications to the length in the
@@ -1137,9 +1143,7 @@ function ArrayMap(f, receiver) {
   var array = ToObject(this);
   var length = TO_UINT32(array.length);
 
-  if (!IS_SPEC_FUNCTION(f)) {
-    throw MakeTypeError('called_non_callable', [ f ]);
-  }
+  if (!IS_SPEC_FUNCTION(f)) ThrowCalledNonCallable(f);
   if (IS_NULL_OR_UNDEFINED(receiver)) {
     receiver = %GetDefaultReceiver(f) || receiver;
   } else if (!IS_SPEC_OBJECT(receiver)) {
@@ -1400,7 +1404,7 @@ function SetUpArray() {
     "unshift", getFunction("unshift", ArrayUnshift, 1),
     "slice", getFunction("slice", ArraySlice, 2),
     "splice", getFunction("splice", ArraySplice, 2),
-    "sort", getFunction("sort", ArraySort),
+    "sort", getFunction("sort", ArraySort, 1),
     "filter", getFunction("filter", ArrayFilter, 1),
     "forEach", getFunction("forEach", ArrayForEach, 1),
     "some", getFunction("some", ArraySome, 1),
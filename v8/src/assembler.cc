@@ -35,6 +35,7 @@
 #include "v8.h"
 
 #include "arguments.h"
+#include "date.h"
 #include "deoptimizer.h"
 #include "execution.h"
 #include "ic-inl.h"
@@ -76,6 +77,8 @@ const double DoubleConstant::zero = 0.0;
 const double DoubleConstant::canonical_non_hole_nan = OS::nan_value();
 const double DoubleConstant::the_hole_nan = BitCast<double>(kHoleNanInt64);
 const double DoubleConstant::negative_infinity = -V8_INFINITY;
+const double DoubleConstant::uint32_bias =
+    static_cast<double>(static_cast<uint32_t>(0xFFFFFFFF)) + 1;
 const char* const RelocInfo::kFillerCommentString = "DEOPTIMIZATION PADDING";
 
 // -----------------------------------------------------------------------------
@@ -152,8 +155,14 @@ int Label::pos() const {
 //      1110: long_data_record
 //        The format is:       [2-bit data_type_tag] 1110 11
 //                             signed intptr_t, lowest byte written first
-//                             (except data_type code_target_with_id, which
-//                             is followed by a signed int, not intptr_t.)
+//        or, for the data types code_target_with_id and the positions:
+//                             [2-bit data_type_tag] 1110 11
+//                             [7 bits data] 0
+//                                ...
+//                             [7 bits data] 1
+//               (Signed int, lowest chunk first, with the chunks that only
+//                repeat the sign of the last one dropped and the last
+//                chunk tagged with 1.)
 //
 //      1111: long_pc_jump
 //        The format is:
@@ -194,6 +203,7 @@ const int kChunkMask = (1 << kChunkBits) - 1;
 const int kLastChunkTagBits = 1;
 const int kLastChunkTagMask = 1;
 const int kLastChunkTag = 1;
+const int kChunkSignMask = 1 << (kChunkBits - 1);
 
 
 const int kDataJumpExtraTag = kPCJumpExtraTag - 1;
@@ -253,11 +263,18 @@ void RelocInfoWriter::WriteExtraTaggedPC(uint32_t pc_delta, int extra_tag) {
 
 void RelocInfoWriter::WriteExtraTaggedIntData(int data_delta, int top_tag) {
   WriteExtraTag(kDataJumpExtraTag, top_tag);
-  for (int i = 0; i < kIntSize; i++) {
-    *--pos_ = static_cast<byte>(data_delta);
+  // Write kChunkBits size chunks of the delta until the remaining bits are
+  // just the sign extension of the last chunk written.  Ids and positions
+  // mostly move by less than a few thousand, which takes two bytes.
+  bool last_chunk;
+  do {
+    byte chunk = data_delta & kChunkMask;
     // Signed right shift is arithmetic shift.  Tested in test-utils.cc.
-    data_delta = data_delta >> kBitsPerByte;
-  }
+    data_delta = data_delta >> kChunkBits;
+    last_chunk = (chunk & kChunkSignMask) == 0 ? data_delta == 0
+                                               : data_delta == -1;
+    *--pos_ = chunk << kLastChunkTagBits | (last_chunk ? kLastChunkTag : 0);
+  } while (!last_chunk);
 }
 
 void RelocInfoWriter::WriteExtraTaggedData(intptr_t data_delta, int top_tag) {
@@ -362,22 +379,32 @@ inline void RelocIterator::AdvanceReadPC() {
 }
 
 
-void RelocIterator::AdvanceReadId() {
-  int x = 0;
-  for (int i = 0; i < kIntSize; i++) {
-    x |= static_cast<int>(*--pos_) << i * kBitsPerByte;
+int RelocIterator::AdvanceReadVariableLengthInt() {
+  // Read the kChunkBits bit chunks up to the last one and sign extend the
+  // result from the most significant bit of the last chunk.
+  uint32_t x = 0;
+  int shift = 0;
+  byte chunk;
+  do {
+    chunk = *--pos_;
+    x |= static_cast<uint32_t>(chunk >> kLastChunkTagBits) << shift;
+    shift += kChunkBits;
+  } while ((chunk & kLastChunkTagMask) != kLastChunkTag);
+  if (shift < kBitsPerInt && (chunk & (kChunkSignMask << kLastChunkTagBits))) {
+    x |= ~static_cast<uint32_t>(0) << shift;
   }
-  last_id_ += x;
+  return static_cast<int>(x);
+}
+
+
+void RelocIterator::AdvanceReadId() {
+  last_id_ += AdvanceReadVariableLengthInt();
   rinfo_.data_ = last_id_;
 }
 
 
 void RelocIterator::AdvanceReadPosition() {
-  int x = 0;
-  for (int i = 0; i < kIntSize; i++) {
-    x |= static_cast<int>(*--pos_) << i * kBitsPerByte;
-  }
-  last_position_ += x;
+  last_position_ += AdvanceReadVariableLengthInt();
   rinfo_.data_ = last_position_;
 }
 
@@ -488,7 +515,7 @@ void RelocIterator::next() {
             AdvanceReadId();
             return;
           }
-          Advance(kIntSize);
+          AdvanceReadVariableLengthInt();
         } else if (locatable_tag != kCommentTag) {
           ASSERT(locatable_tag == kNonstatementPositionTag ||
                  locatable_tag == kStatementPositionTag);
@@ -496,7 +523,7 @@ void RelocIterator::next() {
             AdvanceReadPosition();
             if (SetMode(GetPositionModeFromTag(locatable_tag))) return;
           } else {
-            Advance(kIntSize);
+            AdvanceReadVariableLengthInt();
           }
         } else {
           ASSERT(locatable_tag == kCommentTag);
@@ -803,6 +830,17 @@ ExternalReference ExternalReference::transcendental_cache_array_address(
 }
 
 
+ExternalReference ExternalReference::get_date_field_function(
+    Isolate* isolate) {
+  return ExternalReference(Redirect(isolate, FUNCTION_ADDR(JSDate::GetField)));
+}
+
+
+ExternalReference ExternalReference::date_cache_stamp(Isolate* isolate) {
+  return ExternalReference(isolate->date_cache()->stamp_address());
+}
+
+
 ExternalReference ExternalReference::new_deoptimizer_function(
     Isolate* isolate) {
   return ExternalReference(
@@ -834,6 +872,29 @@ ExternalReference ExternalReference::keyed_lookup_cache_field_offsets(
 }
 
 
+ExternalReference ExternalReference::keyed_lookup_cache_mask(
+    Isolate* isolate) {
+  return ExternalReference(isolate->keyed_lookup_cache()->mask_address());
+}
+
+
+ExternalReference ExternalReference::instanceof_cache_functions(
+    Isolate* isolate) {
+  return ExternalReference(isolate->instanceof_cache()->functions_address());
+}
+
+
+ExternalReference ExternalReference::instanceof_cache_maps(Isolate* isolate) {
+  return ExternalReference(isolate->instanceof_cache()->maps_address());
+}
+
+
+ExternalReference ExternalReference::instanceof_cache_answers(
+    Isolate* isolate) {
+  return ExternalReference(isolate->instanceof_cache()->answers_address());
+}
+
+
 ExternalReference ExternalReference::roots_array_start(Isolate* isolate) {
   return ExternalReference(isolate->heap()->roots_array_start());
 }
@@ -960,6 +1021,12 @@ ExternalReference ExternalReference::address_of_the_hole_nan() {
 }
 
 
+ExternalReference ExternalReference::address_of_uint32_bias() {
+  return ExternalReference(reinterpret_cast<void*>(
+      const_cast<double*>(&DoubleConstant::uint32_bias)));
+}
+
+
 #ifndef V8_INTERPRETED_REGEXP
 
 ExternalReference ExternalReference::re_check_stack_guard_state(
@@ -1013,6 +1080,11 @@ ExternalReference ExternalReference::address_of_regexp_stack_memory_size(
   return ExternalReference(isolate->regexp_stack()->memory_size_address());
 }
 
+ExternalReference ExternalReference::address_of_regexp_backtracks_left(
+    Isolate* isolate) {
+  return ExternalReference(isolate->regexp_stack()->backtracks_left_address());
+}
+
 #endif  // V8_INTERPRETED_REGEXP
 
 
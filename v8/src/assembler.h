@@ -72,6 +72,7 @@ class DoubleConstant: public AllStatic {
   static const double negative_infinity;
   static const double canonical_non_hole_nan;
   static const double the_hole_nan;
+  static const double uint32_bias;
 };
 
 
@@ -409,7 +410,8 @@ class RelocInfoWriter BASE_EMBEDDED {
 
   // Max size (bytes) of a written RelocInfo. Longest encoding is
   // ExtraTag, VariableLengthPCJump, ExtraTag, pc_delta, ExtraTag, data_delta.
-  // On ia32 and arm this is 1 + 4 + 1 + 1 + 1 + 4 = 12.
+  // On ia32 and arm this is 1 + 4 + 1 + 1 + 1 + 5 = 13, as an int data
+  // delta takes up to five 7-bit chunks and pointer sized data 4 bytes.
   // On x64 this is 1 + 4 + 1 + 1 + 1 + 8 == 16;
   // Here we use the maximum of the two.
   static const int kMaxSize = 16;
@@ -468,6 +470,7 @@ class RelocIterator: public Malloced {
   int GetTopTag();
   void ReadTaggedPC();
   void AdvanceReadPC();
+  int AdvanceReadVariableLengthInt();
   void AdvanceReadId();
   void AdvanceReadPosition();
   void AdvanceReadData();
@@ -587,6 +590,9 @@ class ExternalReference BASE_EMBEDDED {
   static ExternalReference transcendental_cache_array_address(Isolate* isolate);
   static ExternalReference delete_handle_scope_extensions(Isolate* isolate);
 
+  static ExternalReference get_date_field_function(Isolate* isolate);
+  static ExternalReference date_cache_stamp(Isolate* isolate);
+
   // Deoptimization support.
   static ExternalReference new_deoptimizer_function(Isolate* isolate);
   static ExternalReference compute_output_frames_function(Isolate* isolate);
@@ -595,6 +601,12 @@ class ExternalReference BASE_EMBEDDED {
   // Static data in the keyed lookup cache.
   static ExternalReference keyed_lookup_cache_keys(Isolate* isolate);
   static ExternalReference keyed_lookup_cache_field_offsets(Isolate* isolate);
+  static ExternalReference keyed_lookup_cache_mask(Isolate* isolate);
+
+  // Static data in the instanceof cache.
+  static ExternalReference instanceof_cache_functions(Isolate* isolate);
+  static ExternalReference instanceof_cache_maps(Isolate* isolate);
+  static ExternalReference instanceof_cache_answers(Isolate* isolate);
 
   // Static variable Heap::roots_array_start()
   static ExternalReference roots_array_start(Isolate* isolate);
@@ -614,6 +626,8 @@ class ExternalReference BASE_EMBEDDED {
       Isolate* isolate);
   static ExternalReference address_of_regexp_stack_memory_size(
       Isolate* isolate);
+  static ExternalReference address_of_regexp_backtracks_left(
+      Isolate* isolate);
 
   // Static variable Heap::NewSpaceStart()
   static ExternalReference new_space_start(Isolate* isolate);
@@ -649,6 +663,7 @@ class ExternalReference BASE_EMBEDDED {
   static ExternalReference address_of_negative_infinity();
   static ExternalReference address_of_canonical_non_hole_nan();
   static ExternalReference address_of_the_hole_nan();
+  static ExternalReference address_of_uint32_bias();
 
   static ExternalReference math_sin_double_function(Isolate* isolate);
   static ExternalReference math_cos_double_function(Isolate* isolate);
@@ -243,8 +243,8 @@ bool IsEqualNumber(void* first, void* second) {
 
 
 void ObjectLiteral::CalculateEmitStore() {
-  HashMap properties(&IsEqualString);
-  HashMap elements(&IsEqualNumber);
+  ZoneHashMap properties(&IsEqualString);
+  ZoneHashMap elements(&IsEqualNumber);
   for (int i = this->properties()->length() - 1; i >= 0; i--) {
     ObjectLiteral::Property* property = this->properties()->at(i);
     Literal* literal = property->key();
@@ -255,7 +255,7 @@ void ObjectLiteral::CalculateEmitStore() {
     }
 
     uint32_t hash;
-    HashMap* table;
+    ZoneHashMap* table;
     void* key;
     Factory* factory = Isolate::Current()->factory();
     if (handle->IsSymbol()) {
@@ -602,9 +602,9 @@ bool CallNew::IsInlineable() const {
 
 
 bool CallRuntime::IsInlineable() const {
-  // Don't try to inline JS runtime calls because we don't (currently) even
-  // optimize them.
-  if (is_jsruntime()) return false;
+  // JS runtime calls are calls to constant functions in the builtins object
+  // of the inlined function's context.
+  if (is_jsruntime()) return true;
   // Don't inline the %_ArgumentsLength or %_Arguments because their
   // implementation will not work.  There is no stack frame to get them
   // from.
@@ -724,22 +724,29 @@ void CaseClause::RecordTypeFeedback(TypeFeedbackOracle* oracle) {
 
 static bool CanCallWithoutIC(Handle<JSFunction> target, int arity) {
   SharedFunctionInfo* info = target->shared();
+  if (!target->NeedsArgumentsAdaption() ||
+      info->formal_parameter_count() == arity) {
+    return true;
+  }
   // If the number of formal parameters of the target function does
-  // not match the number of arguments we're passing, we don't want to
-  // deal with it. Otherwise, we can call it directly.
-  return !target->NeedsArgumentsAdaption() ||
-      info->formal_parameter_count() == arity;
+  // not match the number of arguments we're passing, the call site
+  // can still adapt the arguments itself by padding them with undefined
+  // or dropping the surplus ones, as long as the target never observes
+  // the actual argument count.  That is only known once the target has
+  // been compiled, and builtins read it through %_ArgumentsLength.
+  return info->is_compiled() && !info->uses_arguments() && !info->native();
 }
 
 
 bool Call::ComputeTarget(Handle<Map> type, Handle<String> name) {
-  if (check_type_ == RECEIVER_MAP_CHECK) {
+  Feedback* feedback = this->feedback();
+  if (feedback->check_type == RECEIVER_MAP_CHECK) {
     // For primitive checks the holder is set up to point to the
     // corresponding prototype object, i.e. one step of the algorithm
     // below has been already performed.
     // For non-primitive checks we clear it to allow computing targets
     // for polymorphic calls.
-    holder_ = Handle<JSObject>::null();
+    feedback->holder = Handle<JSObject>::null();
   }
   while (true) {
     LookupResult lookup(type->GetIsolate());
@@ -747,11 +754,12 @@ bool Call::ComputeTarget(Handle<Map> type, Handle<String> name) {
     // If the function wasn't found directly in the map, we start
     // looking upwards through the prototype chain.
     if (!lookup.IsFound() && type->prototype()->IsJSObject()) {
-      holder_ = Handle<JSObject>(JSObject::cast(type->prototype()));
-      type = Handle<Map>(holder()->map());
+      feedback->holder = Handle<JSObject>(JSObject::cast(type->prototype()));
+      type = Handle<Map>(feedback->holder->map());
     } else if (lookup.IsProperty() && lookup.type() == CONSTANT_FUNCTION) {
-      target_ = Handle<JSFunction>(lookup.GetConstantFunctionFromMap(*type));
-      return CanCallWithoutIC(target_, arguments()->length());
+      feedback->target =
+          Handle<JSFunction>(lookup.GetConstantFunctionFromMap(*type));
+      return CanCallWithoutIC(feedback->target, arguments()->length());
     } else {
       return false;
     }
@@ -761,19 +769,21 @@ bool Call::ComputeTarget(Handle<Map> type, Handle<String> name) {
 
 bool Call::ComputeGlobalTarget(Handle<GlobalObject> global,
                                LookupResult* lookup) {
-  target_ = Handle<JSFunction>::null();
-  cell_ = Handle<JSGlobalPropertyCell>::null();
+  Feedback* feedback = this->feedback();
+  feedback->target = Handle<JSFunction>::null();
+  feedback->cell = Handle<JSGlobalPropertyCell>::null();
   ASSERT(lookup->IsProperty() &&
          lookup->type() == NORMAL &&
          lookup->holder() == *global);
-  cell_ = Handle<JSGlobalPropertyCell>(global->GetPropertyCell(lookup));
-  if (cell_->value()->IsJSFunction()) {
-    Handle<JSFunction> candidate(JSFunction::cast(cell_->value()));
+  feedback->cell =
+      Handle<JSGlobalPropertyCell>(global->GetPropertyCell(lookup));
+  if (feedback->cell->value()->IsJSFunction()) {
+    Handle<JSFunction> candidate(JSFunction::cast(feedback->cell->value()));
     // If the function is in new space we assume it's more likely to
     // change and thus prefer the general IC code.
     if (!HEAP->InNewSpace(*candidate) &&
         CanCallWithoutIC(candidate, arguments()->length())) {
-      target_ = candidate;
+      feedback->target = candidate;
       return true;
     }
   }
@@ -783,40 +793,44 @@ bool Call::ComputeGlobalTarget(Handle<GlobalObject> global,
 
 void Call::RecordTypeFeedback(TypeFeedbackOracle* oracle,
                               CallKind call_kind) {
-  is_monomorphic_ = oracle->CallIsMonomorphic(this);
+  Feedback* feedback = this->feedback();
+  feedback->is_monomorphic = oracle->CallIsMonomorphic(this);
   Property* property = expression()->AsProperty();
   if (property == NULL) {
     // Function call.  Specialize for monomorphic calls.
-    if (is_monomorphic_) target_ = oracle->GetCallTarget(this);
+    if (feedback->is_monomorphic) {
+      feedback->target = oracle->GetCallTarget(this);
+    }
   } else {
     // Method call.  Specialize for the receiver types seen at runtime.
     Literal* key = property->key()->AsLiteral();
     ASSERT(key != NULL && key->handle()->IsString());
     Handle<String> name = Handle<String>::cast(key->handle());
-    receiver_types_.Clear();
-    oracle->CallReceiverTypes(this, name, call_kind, &receiver_types_);
+    SmallMapList* receiver_types = &feedback->receiver_types;
+    receiver_types->Clear();
+    oracle->CallReceiverTypes(this, name, call_kind, receiver_types);
 #ifdef DEBUG
     if (FLAG_enable_slow_asserts) {
-      int length = receiver_types_.length();
+      int length = receiver_types->length();
       for (int i = 0; i < length; i++) {
-        Handle<Map> map = receiver_types_.at(i);
+        Handle<Map> map = receiver_types->at(i);
         ASSERT(!map.is_null() && *map != NULL);
       }
     }
 #endif
-    check_type_ = oracle->GetCallCheckType(this);
-    if (is_monomorphic_) {
+    feedback->check_type = oracle->GetCallCheckType(this);
+    if (feedback->is_monomorphic) {
       Handle<Map> map;
-      if (receiver_types_.length() > 0) {
-        ASSERT(check_type_ == RECEIVER_MAP_CHECK);
-        map = receiver_types_.at(0);
+      if (receiver_types->length() > 0) {
+        ASSERT(feedback->check_type == RECEIVER_MAP_CHECK);
+        map = receiver_types->at(0);
       } else {
-        ASSERT(check_type_ != RECEIVER_MAP_CHECK);
-        holder_ = Handle<JSObject>(
-            oracle->GetPrototypeForPrimitiveCheck(check_type_));
-        map = Handle<Map>(holder_->map());
+        ASSERT(feedback->check_type != RECEIVER_MAP_CHECK);
+        feedback->holder = Handle<JSObject>(
+            oracle->GetPrototypeForPrimitiveCheck(feedback->check_type));
+        map = Handle<Map>(feedback->holder->map());
       }
-      is_monomorphic_ = ComputeTarget(map, name);
+      feedback->is_monomorphic = ComputeTarget(map, name);
     }
   }
 }
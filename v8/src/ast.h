@@ -595,7 +595,10 @@ class ForInStatement: public IterationStatement {
       : IterationStatement(isolate, labels),
         each_(NULL),
         enumerable_(NULL),
-        assignment_id_(GetNextId(isolate)) {
+        assignment_id_(GetNextId(isolate)),
+        enum_id_(GetNextId(isolate)),
+        prepare_id_(GetNextId(isolate)),
+        body_id_(GetNextId(isolate)) {
   }
 
   DECLARE_NODE_TYPE(ForInStatement)
@@ -614,11 +617,21 @@ class ForInStatement: public IterationStatement {
   int AssignmentId() const { return assignment_id_; }
   virtual int ContinueId() const { return EntryId(); }
   virtual int StackCheckId() const { return EntryId(); }
+  // After the enumerable is evaluated, with the value in the accumulator.
+  int EnumId() const { return enum_id_; }
+  // After the runtime call for the enum cache or the keys, with the result
+  // in the accumulator.
+  int PrepareId() const { return prepare_id_; }
+  // Before the loop condition, with the five loop values on the stack.
+  int BodyId() const { return body_id_; }
 
  private:
   Expression* each_;
   Expression* enumerable_;
   int assignment_id_;
+  int enum_id_;
+  int prepare_id_;
+  int body_id_;
 };
 
 
@@ -1237,8 +1250,7 @@ class Call: public Expression {
         expression_(expression),
         arguments_(arguments),
         pos_(pos),
-        is_monomorphic_(false),
-        check_type_(RECEIVER_MAP_CHECK),
+        feedback_(NULL),
         return_id_(GetNextId(isolate)) {
   }
 
@@ -1252,12 +1264,24 @@ class Call: public Expression {
 
   void RecordTypeFeedback(TypeFeedbackOracle* oracle,
                           CallKind call_kind);
-  virtual SmallMapList* GetReceiverTypes() { return &receiver_types_; }
-  virtual bool IsMonomorphic() { return is_monomorphic_; }
-  CheckType check_type() const { return check_type_; }
-  Handle<JSFunction> target() { return target_; }
-  Handle<JSObject> holder() { return holder_; }
-  Handle<JSGlobalPropertyCell> cell() { return cell_; }
+  virtual SmallMapList* GetReceiverTypes() {
+    return &feedback()->receiver_types;
+  }
+  virtual bool IsMonomorphic() {
+    return feedback_ != NULL && feedback_->is_monomorphic;
+  }
+  CheckType check_type() const {
+    return feedback_ != NULL ? feedback_->check_type : RECEIVER_MAP_CHECK;
+  }
+  Handle<JSFunction> target() {
+    return feedback_ != NULL ? feedback_->target : Handle<JSFunction>();
+  }
+  Handle<JSObject> holder() {
+    return feedback_ != NULL ? feedback_->holder : Handle<JSObject>();
+  }
+  Handle<JSGlobalPropertyCell> cell() {
+    return feedback_ != NULL ? feedback_->cell : Handle<JSGlobalPropertyCell>();
+  }
 
   bool ComputeTarget(Handle<Map> type, Handle<String> name);
   bool ComputeGlobalTarget(Handle<GlobalObject> global, LookupResult* lookup);
@@ -1271,16 +1295,28 @@ class Call: public Expression {
 #endif
 
  private:
+  // The type feedback of a call.  Only the calls in code that Crankshaft
+  // compiles have any, so it is allocated when it is first recorded instead
+  // of being part of every call in the AST.
+  struct Feedback: public ZoneObject {
+    Feedback() : is_monomorphic(false), check_type(RECEIVER_MAP_CHECK) { }
+    bool is_monomorphic;
+    CheckType check_type;
+    SmallMapList receiver_types;
+    Handle<JSFunction> target;
+    Handle<JSObject> holder;
+    Handle<JSGlobalPropertyCell> cell;
+  };
+
+  Feedback* feedback() {
+    if (feedback_ == NULL) feedback_ = new Feedback();
+    return feedback_;
+  }
+
   Expression* expression_;
   ZoneList<Expression*>* arguments_;
   int pos_;
-
-  bool is_monomorphic_;
-  CheckType check_type_;
-  SmallMapList receiver_types_;
-  Handle<JSFunction> target_;
-  Handle<JSObject> holder_;
-  Handle<JSGlobalPropertyCell> cell_;
+  Feedback* feedback_;
 
   int return_id_;
 };
@@ -1325,7 +1361,8 @@ class CallRuntime: public Expression {
       : Expression(isolate),
         name_(name),
         function_(function),
-        arguments_(arguments) { }
+        arguments_(arguments),
+        return_id_(GetNextId(isolate)) { }
 
   DECLARE_NODE_TYPE(CallRuntime)
 
@@ -1336,10 +1373,16 @@ class CallRuntime: public Expression {
   ZoneList<Expression*>* arguments() const { return arguments_; }
   bool is_jsruntime() const { return function_ == NULL; }
 
+  // Bailout support. Only %_CallFunction records a return site, for the
+  // function it calls when that is inlined.
+  int ReturnId() const { return return_id_; }
+
  private:
   Handle<String> name_;
   const Runtime::Function* function_;
   ZoneList<Expression*>* arguments_;
+
+  int return_id_;
 };
 
 
@@ -1725,6 +1768,13 @@ class FunctionLiteral: public Expression {
   void set_pretenure() { bitfield_ |= Pretenure::encode(true); }
   virtual bool IsInlineable() const;
 
+  // The shared function info of an already compiled function whose body was
+  // skipped, or a null handle.
+  Handle<SharedFunctionInfo> shared_info() const { return shared_info_; }
+  void set_shared_info(Handle<SharedFunctionInfo> shared_info) {
+    shared_info_ = shared_info;
+  }
+
   bool has_duplicate_parameters() {
     return HasDuplicateParameters::decode(bitfield_);
   }
@@ -1735,6 +1785,7 @@ class FunctionLiteral: public Expression {
   ZoneList<Statement*>* body_;
   Handle<FixedArray> this_property_assignments_;
   Handle<String> inferred_name_;
+  Handle<SharedFunctionInfo> shared_info_;
 
   int materialized_literal_count_;
   int expected_property_count_;
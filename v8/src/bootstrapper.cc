@@ -38,6 +38,7 @@
 #include "macro-assembler.h"
 #include "natives.h"
 #include "objects-visiting.h"
+#include "parser.h"
 #include "platform.h"
 #include "snapshot.h"
 #include "extensions/externalize-string-extension.h"
@@ -223,7 +224,6 @@ class Genesis BASE_EMBEDDED {
     void set_state(RegisteredExtension* extension,
                    ExtensionTraversalState state);
   private:
-    Allocator allocator_;
     HashMap map_;
     DISALLOW_COPY_AND_ASSIGN(ExtensionStates);
   };
@@ -279,6 +279,7 @@ class Genesis BASE_EMBEDDED {
                                   Handle<String> source,
                                   SourceCodeCache* cache,
                                   v8::Extension* extension,
+                                  ScriptDataImpl* pre_data,
                                   Handle<Context> top_context,
                                   bool use_runtime_context);
 
@@ -352,6 +353,204 @@ void Bootstrapper::ReattachGlobal(Handle<Context> env,
 }
 
 
+// Copies the user-defined state reachable from the global object of one
+// global context into another global context. Objects are cloned at most
+// once, so sharing and cycles in the source object graph are preserved.
+class GlobalCloner BASE_EMBEDDED {
+ public:
+  GlobalCloner(Isolate* isolate,
+               Handle<Context> source,
+               Handle<Context> target)
+      : isolate_(isolate),
+        source_(source),
+        target_(target),
+        originals_(16),
+        clones_(16) { }
+
+  // Copies the enumerable data properties of from to to. Values that
+  // cannot be cloned are left out.
+  void CopyProperties(Handle<JSObject> from, Handle<JSObject> to, int depth);
+
+ private:
+  static const int kMaxDepth = 32;
+
+  // Returns a null handle if the value cannot be cloned.
+  Handle<Object> Clone(Handle<Object> value, int depth);
+  Handle<Object> CloneFunction(Handle<JSFunction> function);
+  Handle<Object> CloneArray(Handle<JSArray> array, int depth);
+  Handle<Object> CloneObject(Handle<JSObject> object, int depth);
+
+  void Remember(Handle<Object> original, Handle<Object> clone) {
+    originals_.Add(original);
+    clones_.Add(clone);
+  }
+
+  // Primitive values are immutable and do not refer to their context, so
+  // they are shared between the source and the clone.
+  static bool IsShareable(Object* value) {
+    return !value->IsHeapObject() ||
+        value->IsString() ||
+        value->IsHeapNumber() ||
+        value->IsOddball();
+  }
+
+  Isolate* isolate_;
+  Handle<Context> source_;
+  Handle<Context> target_;
+  List<Handle<Object> > originals_;
+  List<Handle<Object> > clones_;
+};
+
+
+void GlobalCloner::CopyProperties(Handle<JSObject> from,
+                                  Handle<JSObject> to,
+                                  int depth) {
+  Handle<FixedArray> names =
+      isolate_->factory()->NewFixedArray(from->NumberOfLocalProperties(NONE));
+  from->GetLocalPropertyNames(*names, 0);
+  for (int i = 0; i < names->length(); i++) {
+    Handle<String> name(String::cast(names->get(i)));
+    LookupResult lookup(isolate_);
+    from->LocalLookupRealNamedProperty(*name, &lookup);
+    // The builtins installed on every global object are not enumerable,
+    // so they are never copied.
+    if (!lookup.IsProperty() || lookup.IsDontEnum()) continue;
+    if (lookup.type() != NORMAL &&
+        lookup.type() != FIELD &&
+        lookup.type() != CONSTANT_FUNCTION) {
+      continue;
+    }
+    Handle<Object> value(lookup.GetLazyValue());
+    if (value->IsTheHole()) continue;
+    Handle<Object> clone = Clone(value, depth + 1);
+    if (clone.is_null()) continue;
+    SetLocalPropertyIgnoreAttributes(to, name, clone, lookup.GetAttributes());
+  }
+}
+
+
+Handle<Object> GlobalCloner::Clone(Handle<Object> value, int depth) {
+  if (IsShareable(*value)) return value;
+  if (depth > kMaxDepth) return Handle<Object>::null();
+  for (int i = 0; i < originals_.length(); i++) {
+    if (originals_[i].is_identical_to(value)) return clones_[i];
+  }
+  if (value->IsJSFunction()) {
+    return CloneFunction(Handle<JSFunction>::cast(value));
+  }
+  if (value->IsJSArray()) {
+    return CloneArray(Handle<JSArray>::cast(value), depth);
+  }
+  if (value->IsJSObject()) {
+    return CloneObject(Handle<JSObject>::cast(value), depth);
+  }
+  return Handle<Object>::null();
+}
+
+
+Handle<Object> GlobalCloner::CloneFunction(Handle<JSFunction> function) {
+  // Only functions declared at the top level of the source context can be
+  // rebound. Natives, API functions and bound functions have their own
+  // setup, and closures over function contexts carry state that cannot be
+  // shared.
+  if (function->context() != *source_) return Handle<Object>::null();
+  if (function->shared()->native() ||
+      function->shared()->IsApiFunction() ||
+      function->shared()->bound()) {
+    return Handle<Object>::null();
+  }
+  // The shared function info and its code are shared with the source.
+  Handle<SharedFunctionInfo> shared(function->shared());
+  Handle<JSFunction> clone =
+      isolate_->factory()->NewFunctionFromSharedFunctionInfo(shared, target_);
+  Remember(function, clone);
+  return clone;
+}
+
+
+Handle<Object> GlobalCloner::CloneArray(Handle<JSArray> array, int depth) {
+  // Named properties of arrays are not copied, so such arrays are left out.
+  if (!array->HasFastProperties() || array->properties()->length() != 0) {
+    return Handle<Object>::null();
+  }
+  if (array->map()->prototype() !=
+      source_->array_function()->instance_prototype()) {
+    return Handle<Object>::null();
+  }
+  if (!array->HasFastSmiOnlyElements() && !array->HasFastElements()) {
+    return Handle<Object>::null();
+  }
+
+  Factory* factory = isolate_->factory();
+  Heap* heap = isolate_->heap();
+  Handle<Object> length(array->length());
+  Handle<FixedArray> elements(FixedArray::cast(array->elements()));
+  bool shareable = true;
+  for (int i = 0; i < elements->length(); i++) {
+    if (!IsShareable(elements->get(i))) {
+      shareable = false;
+      break;
+    }
+  }
+
+  Handle<JSArray> clone;
+  if (elements->length() == 0) {
+    clone = factory->NewJSArrayWithElements(factory->empty_fixed_array());
+  } else if (shareable) {
+    // Both arrays refer to the same backing store, which is copied by
+    // whichever of them is written to first.
+    if (elements->map() != heap->fixed_cow_array_map()) {
+      elements->set_map(heap->fixed_cow_array_map());
+      isolate_->counters()->cow_arrays_created_runtime()->Increment();
+    }
+    clone = factory->NewJSArrayWithElements(elements);
+  } else {
+    Handle<FixedArray> copy = factory->CopyFixedArray(elements);
+    clone = factory->NewJSArrayWithElements(copy);
+    Remember(array, clone);
+    for (int i = 0; i < copy->length(); i++) {
+      Handle<Object> value(copy->get(i));
+      Handle<Object> element = Clone(value, depth + 1);
+      copy->set(i, element.is_null() ? heap->the_hole_value() : *element);
+    }
+  }
+  clone->set_length(*length);
+  if (shareable) Remember(array, clone);
+  return clone;
+}
+
+
+Handle<Object> GlobalCloner::CloneObject(Handle<JSObject> object, int depth) {
+  // Only plain objects created by the source's Object function are cloned.
+  Handle<JSFunction> object_function(source_->object_function());
+  if (object->map()->constructor() != *object_function ||
+      object->map()->prototype() != object_function->instance_prototype() ||
+      object->IsAccessCheckNeeded() ||
+      object->elements()->length() != 0) {
+    return Handle<Object>::null();
+  }
+  Handle<JSObject> clone = isolate_->factory()->NewJSObject(
+      Handle<JSFunction>(target_->object_function()));
+  Remember(object, clone);
+  CopyProperties(object, clone, depth);
+  return clone;
+}
+
+
+void Bootstrapper::CloneGlobals(Handle<Context> source,
+                                Handle<Context> target) {
+  Isolate* isolate = target->GetIsolate();
+  HandleScope scope(isolate);
+  // Objects are created with the functions of the target context.
+  SaveContext save(isolate);
+  isolate->set_context(*target);
+  GlobalCloner cloner(isolate, source, target);
+  cloner.CopyProperties(Handle<JSObject>(source->global()),
+                        Handle<JSObject>(target->global()),
+                        0);
+}
+
+
 static Handle<JSFunction> InstallFunction(Handle<JSObject> target,
                                           const char* name,
                                           InstanceType type,
@@ -944,7 +1143,7 @@ void Genesis::InitializeGlobal(Handle<GlobalObject> inner_global,
   {  // --- D a t e ---
     // Builtin functions for Date.prototype.
     Handle<JSFunction> date_fun =
-        InstallFunction(global, "Date", JS_VALUE_TYPE, JSValue::kSize,
+        InstallFunction(global, "Date", JS_DATE_TYPE, JSDate::kSize,
                         isolate->initial_object_prototype(),
                         Builtins::kIllegal, true);
 
@@ -1041,7 +1240,8 @@ void Genesis::InitializeGlobal(Handle<GlobalObject> inner_global,
     initial_map->set_prototype(*proto);
     factory->SetRegExpIrregexpData(Handle<JSRegExp>::cast(proto),
                                    JSRegExp::IRREGEXP, factory->empty_string(),
-                                   JSRegExp::Flags(0), 0);
+                                   JSRegExp::Flags(0), 0,
+                                   Handle<String>::null());
   }
 
   {  // -- J S O N
@@ -1283,6 +1483,33 @@ void Genesis::InitializeExperimentalGlobal() {
                       prototype, Builtins::kIllegal, true);
     }
   }
+
+  if (FLAG_harmony_typed_arrays) {
+    {  // -- A r r a y B u f f e r
+      // A buffer wraps the external byte array over its backing store and
+      // has its byteLength in an inobject field.
+      Handle<JSObject> prototype =
+          factory()->NewJSObject(isolate()->object_function(), TENURED);
+      InstallFunction(global, "ArrayBuffer", JS_VALUE_TYPE,
+                      JSValue::kSize + kPointerSize, prototype,
+                      Builtins::kIllegal, true);
+    }
+    // The views have external array elements on the backing store of their
+    // buffer, and buffer, byteOffset, byteLength and length in inobject
+    // fields.
+    static const char* const kTypedArrayNames[] = {
+      "Int8Array", "Uint8Array", "Uint8ClampedArray", "Int16Array",
+      "Uint16Array", "Int32Array", "Uint32Array", "Float32Array",
+      "Float64Array"
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(kTypedArrayNames); i++) {
+      Handle<JSObject> prototype =
+          factory()->NewJSObject(isolate()->object_function(), TENURED);
+      InstallFunction(global, kTypedArrayNames[i], JS_OBJECT_TYPE,
+                      JSObject::kHeaderSize + 4 * kPointerSize, prototype,
+                      Builtins::kIllegal, true);
+    }
+  }
 }
 
 
@@ -1304,18 +1531,70 @@ bool Genesis::CompileExperimentalBuiltin(Isolate* isolate, int index) {
 }
 
 
+// The function entries recorded by preparsing the native scripts.  The
+// sources never change, so they are preparsed once per process and every
+// later compile of a native script, in any isolate, skips the bodies of its
+// lazily compiled functions instead of scanning them again.
+class NativesPreparseData : public AllStatic {
+ public:
+  // Returns preparse data for the native script with the given name that
+  // is owned by the caller, or NULL if none could be computed.
+  static ScriptDataImpl* Get(Vector<const char> name, Handle<String> source);
+
+ private:
+  struct Entry {
+    const char* name;
+    Vector<unsigned> data;
+    Entry* next;
+  };
+
+  static Mutex* mutex_;
+  static Entry* entries_;
+};
+
+
+Mutex* NativesPreparseData::mutex_ = OS::CreateMutex();
+NativesPreparseData::Entry* NativesPreparseData::entries_ = NULL;
+
+
+ScriptDataImpl* NativesPreparseData::Get(Vector<const char> name,
+                                         Handle<String> source) {
+  if (!FLAG_cache_preparse_data) return NULL;
+  ScopedLock lock(mutex_);
+  // The names are static data, so they can be compared by address.
+  Entry* entry = entries_;
+  while (entry != NULL && entry->name != name.start()) entry = entry->next;
+  if (entry == NULL) {
+    ScriptDataImpl* pre_data =
+        ParserApi::PartialPreParse(source, NULL, kAllowNativesSyntax);
+    if (pre_data == NULL) return NULL;
+    entry = new Entry;
+    entry->name = name.start();
+    entry->data = Vector<unsigned>::New(pre_data->Length() / sizeof(unsigned));
+    memcpy(entry->data.start(), pre_data->Data(), pre_data->Length());
+    entry->next = entries_;
+    entries_ = entry;
+    return pre_data;
+  }
+  return new ScriptDataImpl(entry->data.Clone());
+}
+
+
 bool Genesis::CompileNative(Vector<const char> name, Handle<String> source) {
   HandleScope scope;
   Isolate* isolate = source->GetIsolate();
 #ifdef ENABLE_DEBUGGER_SUPPORT
   isolate->debugger()->set_compiling_natives(true);
 #endif
+  ScriptDataImpl* pre_data = NativesPreparseData::Get(name, source);
   bool result = CompileScriptCached(name,
                                     source,
                                     NULL,
                                     NULL,
+                                    pre_data,
                                     Handle<Context>(isolate->context()),
                                     true);
+  delete pre_data;
   ASSERT(isolate->has_pending_exception() != result);
   if (!result) isolate->clear_pending_exception();
 #ifdef ENABLE_DEBUGGER_SUPPORT
@@ -1329,6 +1608,7 @@ bool Genesis::CompileScriptCached(Vector<const char> name,
                                   Handle<String> source,
                                   SourceCodeCache* cache,
                                   v8::Extension* extension,
+                                  ScriptDataImpl* pre_data,
                                   Handle<Context> top_context,
                                   bool use_runtime_context) {
   Factory* factory = source->GetIsolate()->factory();
@@ -1346,7 +1626,7 @@ bool Genesis::CompileScriptCached(Vector<const char> name,
         0,
         0,
         extension,
-        NULL,
+        pre_data,
         Handle<String>::null(),
         use_runtime_context ? NATIVES_CODE : NOT_NATIVES_CODE);
     if (function_info.is_null()) return false;
@@ -1403,6 +1683,8 @@ void Genesis::InstallNativeFunctions() {
   INSTALL_NATIVE(JSObject, "functionCache", function_cache);
   INSTALL_NATIVE(JSFunction, "ToCompletePropertyDescriptor",
                  to_complete_property_descriptor);
+  INSTALL_NATIVE(JSFunction, "MethodMissingTrampoline",
+                 method_missing_trampoline_fun);
 }
 
 void Genesis::InstallExperimentalNativeFunctions() {
@@ -1775,6 +2057,24 @@ bool Genesis::InstallNatives() {
     global_context()->set_regexp_result_map(*initial_map);
   }
 
+  {
+    // Cache the initial array map together with the map arrays move to
+    // when they are handed their first non-smi element, so that the
+    // generic keyed store stub can do the transition in place.  This adds
+    // an elements transition to the initial map, so it must come after the
+    // maps that copy its descriptors are set up.
+    Handle<Map> smi_array_map(
+        global_context()->array_function()->initial_map());
+    Handle<Map> object_array_map = smi_array_map;
+    if (smi_array_map->elements_kind() == FAST_SMI_ONLY_ELEMENTS) {
+      Handle<JSArray> array = factory()->NewJSArray(0);
+      object_array_map =
+          JSObject::GetElementsTransitionMap(array, FAST_ELEMENTS);
+    }
+    global_context()->set_smi_js_array_map(*smi_array_map);
+    global_context()->set_object_js_array_map(*object_array_map);
+  }
+
 #ifdef DEBUG
   builtins->Verify();
 #endif
@@ -1797,6 +2097,11 @@ bool Genesis::InstallExperimentalNatives() {
                "native collection.js") == 0) {
       if (!CompileExperimentalBuiltin(isolate(), i)) return false;
     }
+    if (FLAG_harmony_typed_arrays &&
+        strcmp(ExperimentalNatives::GetScriptName(i).start(),
+               "native typedarray.js") == 0) {
+      if (!CompileExperimentalBuiltin(isolate(), i)) return false;
+    }
   }
 
   InstallExperimentalNativeFunctions();
@@ -1895,7 +2200,11 @@ void Genesis::InstallJSFunctionResultCaches() {
 void Genesis::InitializeNormalizedMapCaches() {
   Handle<FixedArray> array(
       FACTORY->NewFixedArray(NormalizedMapCache::kEntries, TENURED));
+  Handle<FixedArray> fast_properties_maps(
+      FACTORY->NewFixedArray(JSObject::kFastPropertiesMapCacheEntries,
+                             TENURED));
   global_context()->set_normalized_map_cache(NormalizedMapCache::cast(*array));
+  global_context()->set_fast_properties_map_cache(*fast_properties_maps);
 }
 
 
@@ -1963,8 +2272,7 @@ static bool MatchRegisteredExtensions(void* key1, void* key2) {
 }
 
 Genesis::ExtensionStates::ExtensionStates()
-  : allocator_(),
-    map_(MatchRegisteredExtensions, &allocator_, 8)
+  : map_(MatchRegisteredExtensions, 8)
   {}
 
 Genesis::ExtensionTraversalState Genesis::ExtensionStates::get_state(
@@ -2065,6 +2373,7 @@ bool Genesis::InstallExtension(v8::RegisteredExtension* current,
       source_code,
       isolate->bootstrapper()->extensions_cache(),
       extension,
+      NULL,
       Handle<Context>(isolate->context()),
       false);
   ASSERT(isolate->has_pending_exception() != result);
@@ -2165,6 +2474,9 @@ void Genesis::TransferNamedProperties(Handle<JSObject> from,
           Handle<String> key = Handle<String>(descs->GetKey(i));
           int index = descs->GetFieldIndex(i);
           Handle<Object> value = Handle<Object>(from->FastPropertyAt(index));
+          if (value->IsMutableHeapNumber()) {
+            value = factory()->NewNumber(value->Number());
+          }
           SetLocalPropertyNoThrow(to, key, value, details.attributes());
           break;
         }
@@ -106,6 +106,12 @@ class Bootstrapper {
   // Reattach an outer global object to an environment.
   void ReattachGlobal(Handle<Context> env, Handle<Object> global_object);
 
+  // Copies the enumerable data properties of the source global object into
+  // the target global object. Top-level functions are rebound to the
+  // target, plain objects and arrays are cloned, and array backing stores
+  // holding only primitives are shared copy-on-write.
+  void CloneGlobals(Handle<Context> source, Handle<Context> target);
+
   // Traverses the pointers for memory management.
   void Iterate(ObjectVisitor* v);
 
@@ -34,6 +34,7 @@
 #include "gdb-jit.h"
 #include "ic-inl.h"
 #include "mark-compact.h"
+#include "type-info.h"
 #include "vm-state-inl.h"
 
 namespace v8 {
@@ -119,26 +120,42 @@ BUILTIN_LIST_C(DEF_ARG_TYPE)
 //   }
 //
 // In the body of the builtin function the arguments can be accessed
-// through the BuiltinArguments object args.
+// through the BuiltinArguments object args.  With --runtime-call-stats
+// the calls of the builtin and the time spent in it are recorded.
 
 #ifdef DEBUG
 
-#define BUILTIN(name)                                      \
-  MUST_USE_RESULT static MaybeObject* Builtin_Impl_##name( \
-      name##ArgumentsType args, Isolate* isolate);         \
-  MUST_USE_RESULT static MaybeObject* Builtin_##name(      \
-      name##ArgumentsType args, Isolate* isolate) {        \
-    ASSERT(isolate == Isolate::Current());                 \
-    args.Verify();                                         \
-    return Builtin_Impl_##name(args, isolate);             \
-  }                                                        \
-  MUST_USE_RESULT static MaybeObject* Builtin_Impl_##name( \
+#define BUILTIN(name)                                           \
+  MUST_USE_RESULT static MaybeObject* Builtin_Impl_##name(      \
+      name##ArgumentsType args, Isolate* isolate);              \
+  MUST_USE_RESULT static MaybeObject* Builtin_##name(           \
+      name##ArgumentsType args, Isolate* isolate) {             \
+    ASSERT(isolate == Isolate::Current());                      \
+    args.Verify();                                              \
+    if (FLAG_runtime_call_stats) {                              \
+      RuntimeCallTimerScope timer(isolate, "Builtin_" #name);   \
+      return Builtin_Impl_##name(args, isolate);                \
+    }                                                           \
+    return Builtin_Impl_##name(args, isolate);                  \
+  }                                                             \
+  MUST_USE_RESULT static MaybeObject* Builtin_Impl_##name(      \
       name##ArgumentsType args, Isolate* isolate)
 
 #else  // For release mode.
 
-#define BUILTIN(name)                                      \
-  static MaybeObject* Builtin_##name(name##ArgumentsType args, Isolate* isolate)
+#define BUILTIN(name)                                           \
+  static MaybeObject* Builtin_Impl_##name(                      \
+      name##ArgumentsType args, Isolate* isolate);              \
+  static MaybeObject* Builtin_##name(                           \
+      name##ArgumentsType args, Isolate* isolate) {             \
+    if (FLAG_runtime_call_stats) {                              \
+      RuntimeCallTimerScope timer(isolate, "Builtin_" #name);   \
+      return Builtin_Impl_##name(args, isolate);                \
+    }                                                           \
+    return Builtin_Impl_##name(args, isolate);                  \
+  }                                                             \
+  static MaybeObject* Builtin_Impl_##name(                      \
+      name##ArgumentsType args, Isolate* isolate)
 
 #endif
 
@@ -330,6 +347,15 @@ static void FillWithHoles(Heap* heap, FixedArray* dst, int from, int to) {
 }
 
 
+// Returns the largest backing store length that is not allocated in large
+// object space, where LeftTrimFixedArray cannot be used.
+static int MaxTrimmableLength(Heap* heap) {
+  int max_size = Min(heap->MaxObjectSizeInNewSpace(),
+                     heap->MaxObjectSizeInPagedSpace());
+  return (max_size - FixedArray::kHeaderSize) / kPointerSize;
+}
+
+
 static FixedArray* LeftTrimFixedArray(Heap* heap,
                                       FixedArray* elms,
                                       int to_trim) {
@@ -343,6 +369,8 @@ static FixedArray* LeftTrimFixedArray(Heap* heap,
   STATIC_ASSERT(FixedArray::kLengthOffset == kPointerSize);
   STATIC_ASSERT(FixedArray::kHeaderSize == 2 * kPointerSize);
 
+  heap->EnsureSweptBeforeResizing(elms);
+
   Object** former_start = HeapObject::RawField(elms, 0);
 
   const int len = elms->length();
@@ -495,6 +523,13 @@ BUILTIN(ArrayPush) {
   if (new_length > elms->length()) {
     // New backing storage is needed.
     int capacity = new_length + (new_length >> 1) + 16;
+    // Stay out of large object space while that is enough, so that shift
+    // can keep left-trimming the backing store of an array used as a queue.
+    int max_trimmable_length = MaxTrimmableLength(heap);
+    if (new_length <= max_trimmable_length &&
+        capacity > max_trimmable_length) {
+      capacity = max_trimmable_length;
+    }
     Object* obj;
     { MaybeObject* maybe_obj = heap->AllocateUninitializedFixedArray(capacity);
       if (!maybe_obj->ToObject(&obj)) return maybe_obj;
@@ -586,8 +621,22 @@ BUILTIN(ArrayShift) {
     first = heap->undefined_value();
   }
 
+  int max_trimmable_length = MaxTrimmableLength(heap);
   if (!heap->lo_space()->Contains(elms)) {
     array->set_elements(LeftTrimFixedArray(heap, elms, 1));
+  } else if (len > 1 && len - 1 <= max_trimmable_length) {
+    // Move the remaining elements out of large object space, leaving room
+    // for pushes, so that the following shifts only left-trim.
+    Object* obj;
+    { MaybeObject* maybe_obj =
+          heap->AllocateUninitializedFixedArray(max_trimmable_length);
+      if (!maybe_obj->ToObject(&obj)) return maybe_obj;
+    }
+    FixedArray* new_elms = FixedArray::cast(obj);
+    AssertNoAllocation no_gc;
+    CopyElements(heap, &no_gc, new_elms, 0, elms, 1, len - 1);
+    FillWithHoles(heap, new_elms, len - 1, max_trimmable_length);
+    array->set_elements(new_elms);
   } else {
     // Shift the elements.
     AssertNoAllocation no_gc;
@@ -633,6 +682,13 @@ BUILTIN(ArrayUnshift) {
   if (new_length > elms->length()) {
     // New backing storage is needed.
     int capacity = new_length + (new_length >> 1) + 16;
+    // Stay out of large object space while that is enough, so that shift
+    // can keep left-trimming the backing store of an array used as a queue.
+    int max_trimmable_length = MaxTrimmableLength(heap);
+    if (new_length <= max_trimmable_length &&
+        capacity > max_trimmable_length) {
+      capacity = max_trimmable_length;
+    }
     Object* obj;
     { MaybeObject* maybe_obj = heap->AllocateUninitializedFixedArray(capacity);
       if (!maybe_obj->ToObject(&obj)) return maybe_obj;
@@ -1050,6 +1106,382 @@ BUILTIN(ArrayConcat) {
 }
 
 
+// Sorting of arrays with the default order, in which elements compare as
+// strings. Sorts of packed smi, double and string arrays are done here
+// without calling back into JavaScript for every comparison.
+
+template <typename T>
+static inline void SwapSortEntries(T* a, T* b) {
+  T tmp = *a;
+  *a = *b;
+  *b = tmp;
+}
+
+
+template <typename T, typename LessThan>
+static void InsertionSort(T* start, T* end, LessThan less) {
+  for (T* i = start + 1; i < end; i++) {
+    T value = *i;
+    T* j = i;
+    for (; j > start && less(value, *(j - 1)); j--) *j = *(j - 1);
+    *j = value;
+  }
+}
+
+
+template <typename T, typename LessThan>
+static void SiftDown(T* heap, int root, int size, LessThan less) {
+  T value = heap[root];
+  while (true) {
+    int child = 2 * root + 1;
+    if (child >= size) break;
+    if (child + 1 < size && less(heap[child], heap[child + 1])) child++;
+    if (!less(value, heap[child])) break;
+    heap[root] = heap[child];
+    root = child;
+  }
+  heap[root] = value;
+}
+
+
+template <typename T, typename LessThan>
+static void HeapSort(T* start, T* end, LessThan less) {
+  int size = static_cast<int>(end - start);
+  for (int i = size / 2 - 1; i >= 0; i--) SiftDown(start, i, size, less);
+  for (int i = size - 1; i > 0; i--) {
+    SwapSortEntries(start, start + i);
+    SiftDown(start, 0, i, less);
+  }
+}
+
+
+// Moves the median of *a, *b and *c to *result.
+template <typename T, typename LessThan>
+static void MoveMedianToFirst(T* result, T* a, T* b, T* c, LessThan less) {
+  if (less(*a, *b)) {
+    if (less(*b, *c)) {
+      SwapSortEntries(result, b);
+    } else if (less(*a, *c)) {
+      SwapSortEntries(result, c);
+    } else {
+      SwapSortEntries(result, a);
+    }
+  } else if (less(*a, *c)) {
+    SwapSortEntries(result, a);
+  } else if (less(*b, *c)) {
+    SwapSortEntries(result, c);
+  } else {
+    SwapSortEntries(result, b);
+  }
+}
+
+
+// Introsort: quicksort with median of three pivots that switches to
+// heapsort when the partitions keep being unbalanced, and to insertion
+// sort for short ranges.
+template <typename T, typename LessThan>
+static void IntroSort(T* start, T* end, int depth_limit, LessThan less) {
+  static const int kInsertionSortLength = 16;
+  while (end - start > kInsertionSortLength) {
+    if (depth_limit == 0) {
+      HeapSort(start, end, less);
+      return;
+    }
+    depth_limit--;
+    MoveMedianToFirst(start, start + 1, start + (end - start) / 2, end - 1,
+                      less);
+    // Partition around the pivot at *start. Both scans are bounded without
+    // index checks: the left one by an element no less than the pivot
+    // among the median candidates, the right one by the pivot itself.
+    T* left = start + 1;
+    T* right = end;
+    while (true) {
+      while (less(*left, *start)) left++;
+      right--;
+      while (less(*start, *right)) right--;
+      if (!(left < right)) break;
+      SwapSortEntries(left, right);
+      left++;
+    }
+    IntroSort(left, end, depth_limit, less);
+    end = left;
+  }
+  InsertionSort(start, end, less);
+}
+
+
+template <typename T, typename LessThan>
+static void IntroSort(T* start, T* end, LessThan less) {
+  int depth_limit = 0;
+  for (intptr_t n = end - start; n > 1; n >>= 1) depth_limit += 2;
+  IntroSort(start, end, depth_limit, less);
+}
+
+
+// A smi with a key that orders smis like their decimal strings: a sign
+// digit, as '-' sorts before the digits, followed by the ten base 11
+// digits of the string left aligned, with 0 for the positions after its
+// end so that prefixes sort first.
+struct SmiSortEntry {
+  uint64_t key;
+  Smi* value;
+};
+
+
+static const int kSmiSortKeyBits = 36;
+STATIC_ASSERT(kSmiValueSize <= 32);
+
+
+static inline uint64_t SmiSortKey(int value) {
+  static const int kMaxDigits = 10;
+  uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value)
+                                 : static_cast<uint32_t>(value);
+  int digits[kMaxDigits];
+  int length = 0;
+  do {
+    digits[length++] = magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude != 0);
+  uint64_t key = value < 0 ? 0 : 1;
+  for (int i = 0; i < kMaxDigits; i++) {
+    key = key * 11 + (i < length ? digits[length - 1 - i] + 1 : 0);
+  }
+  ASSERT(key < (static_cast<uint64_t>(1) << kSmiSortKeyBits));
+  return key;
+}
+
+
+struct SmiSortLess {
+  bool operator()(const SmiSortEntry& a, const SmiSortEntry& b) const {
+    return a.key < b.key;
+  }
+};
+
+
+// Least significant digit first radix sort on the keys, a byte at a time.
+static void RadixSortSmis(SmiSortEntry* entries, int length) {
+  static const int kRadixBits = 8;
+  static const int kRadix = 1 << kRadixBits;
+  ScopedVector<SmiSortEntry> scratch(length);
+  SmiSortEntry* from = entries;
+  SmiSortEntry* to = scratch.start();
+  for (int shift = 0; shift < kSmiSortKeyBits; shift += kRadixBits) {
+    int offsets[kRadix] = { 0 };
+    for (int i = 0; i < length; i++) {
+      offsets[(from[i].key >> shift) & (kRadix - 1)]++;
+    }
+    int offset = 0;
+    for (int digit = 0; digit < kRadix; digit++) {
+      int count = offsets[digit];
+      offsets[digit] = offset;
+      offset += count;
+    }
+    for (int i = 0; i < length; i++) {
+      to[offsets[(from[i].key >> shift) & (kRadix - 1)]++] = from[i];
+    }
+    SwapSortEntries(&from, &to);
+  }
+  if (from != entries) memcpy(entries, from, length * sizeof(entries[0]));
+}
+
+
+static void SortSmis(FixedArray* elms, int length) {
+  // Radix sort takes a fixed number of passes over the whole array, which
+  // only pays off for longer arrays.
+  static const int kRadixSortLength = 256;
+  ScopedVector<SmiSortEntry> entries(length);
+  for (int i = 0; i < length; i++) {
+    Smi* value = Smi::cast(elms->get(i));
+    entries[i].key = SmiSortKey(value->value());
+    entries[i].value = value;
+  }
+  if (length < kRadixSortLength) {
+    IntroSort(entries.start(), entries.start() + length, SmiSortLess());
+  } else {
+    RadixSortSmis(entries.start(), length);
+  }
+  for (int i = 0; i < length; i++) elms->set(i, entries[i].value);
+}
+
+
+// A double with its string representation. Doubles that convert to the
+// same string keep their order, which tells 0 and -0 apart.
+struct DoubleSortEntry {
+  const char* string;
+  double value;
+  int index;
+};
+
+
+struct DoubleSortLess {
+  bool operator()(const DoubleSortEntry& a, const DoubleSortEntry& b) const {
+    int result = strcmp(a.string, b.string);
+    return result < 0 || (result == 0 && a.index < b.index);
+  }
+};
+
+
+static void SortDoubles(FixedDoubleArray* elms, int length) {
+  // The shortest representation of a double has at most 17 digits, so it
+  // fits with sign, point, exponent and terminator.
+  static const int kMaxStringLength = 32;
+  ScopedVector<DoubleSortEntry> entries(length);
+  ScopedVector<char> strings(length * kMaxStringLength);
+  char buffer[kDoubleToCStringMinBufferSize];
+  for (int i = 0; i < length; i++) {
+    double value = elms->get_scalar(i);
+    const char* string =
+        DoubleToCString(value, Vector<char>(buffer, ARRAY_SIZE(buffer)));
+    char* copy = &strings[i * kMaxStringLength];
+    ASSERT(StrLength(string) < kMaxStringLength);
+    strncpy(copy, string, kMaxStringLength);
+    entries[i].string = copy;
+    entries[i].value = value;
+    entries[i].index = i;
+  }
+  IntroSort(entries.start(), entries.start() + length, DoubleSortLess());
+  for (int i = 0; i < length; i++) elms->set(i, entries[i].value);
+}
+
+
+// A flat string with its characters. Equal strings need no particular
+// order, they cannot be told apart.
+struct StringSortEntry {
+  String* string;
+  const void* chars;
+  int length;
+  bool is_ascii;
+};
+
+
+template <typename Char1, typename Char2>
+static inline int CompareSortChars(const void* a, int a_length,
+                                   const void* b, int b_length) {
+  const Char1* a_chars = reinterpret_cast<const Char1*>(a);
+  const Char2* b_chars = reinterpret_cast<const Char2*>(b);
+  int length = Min(a_length, b_length);
+  for (int i = 0; i < length; i++) {
+    int a_char = a_chars[i];
+    int b_char = b_chars[i];
+    if (a_char != b_char) return a_char - b_char;
+  }
+  return a_length - b_length;
+}
+
+
+struct StringSortLess {
+  bool operator()(const StringSortEntry& a, const StringSortEntry& b) const {
+    int result;
+    if (a.is_ascii) {
+      result = b.is_ascii
+          ? CompareSortChars<uint8_t, uint8_t>(a.chars, a.length,
+                                               b.chars, b.length)
+          : CompareSortChars<uint8_t, uc16>(a.chars, a.length,
+                                            b.chars, b.length);
+    } else {
+      result = b.is_ascii
+          ? CompareSortChars<uc16, uint8_t>(a.chars, a.length,
+                                            b.chars, b.length)
+          : CompareSortChars<uc16, uc16>(a.chars, a.length,
+                                         b.chars, b.length);
+    }
+    return result < 0;
+  }
+};
+
+
+// The strings must be flat.
+static void SortStrings(FixedArray* elms,
+                        int length,
+                        const AssertNoAllocation& no_gc) {
+  ScopedVector<StringSortEntry> entries(length);
+  for (int i = 0; i < length; i++) {
+    String* string = String::cast(elms->get(i));
+    String::FlatContent content = string->GetFlatContent();
+    ASSERT(content.IsFlat());
+    entries[i].string = string;
+    entries[i].length = string->length();
+    entries[i].is_ascii = content.IsAscii();
+    entries[i].chars = content.IsAscii()
+        ? static_cast<const void*>(content.ToAsciiVector().start())
+        : static_cast<const void*>(content.ToUC16Vector().start());
+  }
+  IntroSort(entries.start(), entries.start() + length, StringSortLess());
+  WriteBarrierMode mode = elms->GetWriteBarrierMode(no_gc);
+  for (int i = 0; i < length; i++) elms->set(i, entries[i].string, mode);
+}
+
+
+BUILTIN(ArraySort) {
+  Object* receiver = *args.receiver();
+  // Comparators are called from the JavaScript implementation.
+  if (args.length() > 1 && args[1]->IsSpecFunction()) {
+    return CallJsBuiltin(isolate, "ArraySort", args);
+  }
+  if (!receiver->IsJSArray()) {
+    return CallJsBuiltin(isolate, "ArraySort", args);
+  }
+  JSArray* array = JSArray::cast(receiver);
+  if (!array->length()->IsSmi()) {
+    return CallJsBuiltin(isolate, "ArraySort", args);
+  }
+  int len = Smi::cast(array->length())->value();
+  if (len < 2) return array;
+
+  // Only packed arrays are handled, holes are looked up in the prototype
+  // chain and sort to the end.
+  if (array->HasFastDoubleElements()) {
+    FixedDoubleArray* elms = FixedDoubleArray::cast(array->elements());
+    if (len > elms->length()) {
+      return CallJsBuiltin(isolate, "ArraySort", args);
+    }
+    for (int i = 0; i < len; i++) {
+      if (elms->is_the_hole(i)) {
+        return CallJsBuiltin(isolate, "ArraySort", args);
+      }
+    }
+    SortDoubles(elms, len);
+    return array;
+  }
+
+  if (!array->HasFastTypeElements()) {
+    return CallJsBuiltin(isolate, "ArraySort", args);
+  }
+  { MaybeObject* maybe_writable = array->EnsureWritableFastElements();
+    if (maybe_writable->IsFailure()) return maybe_writable;
+  }
+  FixedArray* elms = FixedArray::cast(array->elements());
+  if (len > elms->length()) {
+    return CallJsBuiltin(isolate, "ArraySort", args);
+  }
+
+  if (array->HasFastSmiOnlyElements()) {
+    for (int i = 0; i < len; i++) {
+      if (!elms->get(i)->IsSmi()) {
+        return CallJsBuiltin(isolate, "ArraySort", args);
+      }
+    }
+    SortSmis(elms, len);
+    return array;
+  }
+
+  for (int i = 0; i < len; i++) {
+    if (!elms->get(i)->IsString()) {
+      return CallJsBuiltin(isolate, "ArraySort", args);
+    }
+  }
+  // Flattening allocates, so the array is looked at again afterwards. A
+  // failed allocation retries the builtin after a GC.
+  for (int i = 0; i < len; i++) {
+    MaybeObject* maybe_flat = String::cast(elms->get(i))->TryFlatten();
+    if (maybe_flat->IsFailure()) return maybe_flat;
+  }
+  AssertNoAllocation no_gc;
+  SortStrings(elms, len, no_gc);
+  return array;
+}
+
+
 // -----------------------------------------------------------------------------
 // Strict mode poison pills
 
@@ -1115,6 +1547,132 @@ static inline Object* TypeCheck(Heap* heap,
 }
 
 
+// Typed fast calls, see v8::FunctionTemplate::SetFastCallHandler.  The
+// C function is called through a pointer of its exact type, which is
+// picked one argument at a time from the signature.
+union FastCallArgument {
+  int32_t int32;
+  double number;
+};
+
+
+template <typename R>
+static R CallFast(v8::FastCallFunction function) {
+  return reinterpret_cast<R (*)()>(function)();
+}
+
+
+template <typename R, typename A0>
+static R CallFast(v8::FastCallFunction function, A0 a0) {
+  return reinterpret_cast<R (*)(A0)>(function)(a0);
+}
+
+
+template <typename R, typename A0, typename A1>
+static R CallFast(v8::FastCallFunction function, A0 a0, A1 a1) {
+  return reinterpret_cast<R (*)(A0, A1)>(function)(a0, a1);
+}
+
+
+template <typename R, typename A0, typename A1, typename A2>
+static R CallFast(v8::FastCallFunction function, A0 a0, A1 a1, A2 a2) {
+  return reinterpret_cast<R (*)(A0, A1, A2)>(function)(a0, a1, a2);
+}
+
+
+template <typename R, typename A0, typename A1>
+static R CallFast2(v8::FastCallFunction function,
+                   int bits,
+                   const FastCallArgument* args,
+                   A0 a0,
+                   A1 a1) {
+  if (CallHandlerInfo::FastArgumentCountField::decode(bits) == 2) {
+    return CallFast<R>(function, a0, a1);
+  }
+  if (CallHandlerInfo::FastArgumentType(bits, 2) ==
+      v8::FastCallSignature::kInt32) {
+    return CallFast<R>(function, a0, a1, args[2].int32);
+  }
+  return CallFast<R>(function, a0, a1, args[2].number);
+}
+
+
+template <typename R, typename A0>
+static R CallFast1(v8::FastCallFunction function,
+                   int bits,
+                   const FastCallArgument* args,
+                   A0 a0) {
+  if (CallHandlerInfo::FastArgumentCountField::decode(bits) == 1) {
+    return CallFast<R>(function, a0);
+  }
+  if (CallHandlerInfo::FastArgumentType(bits, 1) ==
+      v8::FastCallSignature::kInt32) {
+    return CallFast2<R>(function, bits, args, a0, args[1].int32);
+  }
+  return CallFast2<R>(function, bits, args, a0, args[1].number);
+}
+
+
+template <typename R>
+static R CallFast0(v8::FastCallFunction function,
+                   int bits,
+                   const FastCallArgument* args) {
+  if (CallHandlerInfo::FastArgumentCountField::decode(bits) == 0) {
+    return CallFast<R>(function);
+  }
+  if (CallHandlerInfo::FastArgumentType(bits, 0) ==
+      v8::FastCallSignature::kInt32) {
+    return CallFast1<R>(function, bits, args, args[0].int32);
+  }
+  return CallFast1<R>(function, bits, args, args[0].number);
+}
+
+
+// Calls the fast callback of |call_data| if the arguments match its
+// signature.  Returns NULL if the call handler has to take the call.
+static Object* TryFastApiCall(
+    Isolate* isolate,
+    CallHandlerInfo* call_data,
+    BuiltinArguments<NEEDS_CALLED_FUNCTION>* args) {
+  int bits = Smi::cast(call_data->fast_signature())->value();
+  int argc = CallHandlerInfo::FastArgumentCountField::decode(bits);
+  if (args->length() - 1 < argc) return NULL;
+  FastCallArgument unboxed[v8::FastCallSignature::kMaxArguments];
+  for (int i = 0; i < argc; i++) {
+    Object* arg = (*args)[i + 1];
+    if (CallHandlerInfo::FastArgumentType(bits, i) ==
+        v8::FastCallSignature::kInt32) {
+      if (arg->IsSmi()) {
+        unboxed[i].int32 = Smi::cast(arg)->value();
+      } else if (arg->IsHeapNumber()) {
+        double value = HeapNumber::cast(arg)->value();
+        if (!TypeInfo::IsInt32Double(value)) return NULL;
+        unboxed[i].int32 = static_cast<int32_t>(value);
+      } else {
+        return NULL;
+      }
+    } else {
+      if (!arg->IsNumber()) return NULL;
+      unboxed[i].number = arg->Number();
+    }
+  }
+  isolate->counters()->fast_api_calls()->Increment();
+  v8::FastCallFunction function =
+      v8::ToCData<v8::FastCallFunction>(call_data->fast_callback());
+  switch (CallHandlerInfo::FastResultField::decode(bits)) {
+    case v8::FastCallSignature::kInt32:
+      return *isolate->factory()->NewNumberFromInt(
+          CallFast0<int32_t>(function, bits, unboxed));
+    case v8::FastCallSignature::kDouble:
+      return *isolate->factory()->NewNumber(
+          CallFast0<double>(function, bits, unboxed));
+    default:
+      CallFast0<void>(function, bits, unboxed);
+      return isolate->heap()->undefined_value();
+  }
+}
+
+
 template <bool is_construct>
 MUST_USE_RESULT static MaybeObject* HandleApiCallHelper(
     BuiltinArguments<NEEDS_CALLED_FUNCTION> args, Isolate* isolate) {
@@ -1149,6 +1707,10 @@ MUST_USE_RESULT static MaybeObject* HandleApiCallHelper(
   Object* raw_call_data = fun_data->call_code();
   if (!raw_call_data->IsUndefined()) {
     CallHandlerInfo* call_data = CallHandlerInfo::cast(raw_call_data);
+    if (!is_construct && !call_data->fast_callback()->IsUndefined()) {
+      Object* result = TryFastApiCall(isolate, call_data, &args);
+      if (result != NULL) return result;
+    }
     Object* callback_obj = call_data->callback();
     v8::InvocationCallback callback =
         v8::ToCData<v8::InvocationCallback>(callback_obj);
@@ -38,16 +38,78 @@ namespace v8 {
 namespace internal {
 
 bool CodeStub::FindCodeInCache(Code** code_out) {
-  Heap* heap = Isolate::Current()->heap();
-  int index = heap->code_stubs()->FindEntry(GetKey());
+  Isolate* isolate = Isolate::Current();
+  uint32_t key = GetKey();
+  CodeStubLookupCache* cache = isolate->code_stub_lookup_cache();
+  Code* code = cache->Lookup(key);
+  if (code != NULL) {
+    *code_out = code;
+    return true;
+  }
+  Heap* heap = isolate->heap();
+  int index = heap->code_stubs()->FindEntry(key);
   if (index != NumberDictionary::kNotFound) {
     *code_out = Code::cast(heap->code_stubs()->ValueAt(index));
+    cache->Update(key, *code_out);
     return true;
   }
   return false;
 }
 
 
+void CodeStub::GenerateCommonStubsForSnapshot() {
+  // Binary operations start out in the uninitialized state, so every binary
+  // operation site asks for one of these before it has seen any operands.
+  static const Token::Value kBinaryOps[] = {
+    Token::ADD, Token::SUB, Token::MUL, Token::DIV, Token::MOD,
+    Token::BIT_OR, Token::BIT_AND, Token::BIT_XOR,
+    Token::SAR, Token::SHR, Token::SHL
+  };
+  static const OverwriteMode kOverwriteModes[] = {
+    NO_OVERWRITE, OVERWRITE_LEFT, OVERWRITE_RIGHT
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(kBinaryOps); i++) {
+    for (size_t j = 0; j < ARRAY_SIZE(kOverwriteModes); j++) {
+      BinaryOpStub stub(kBinaryOps[i], kOverwriteModes[j]);
+      stub.GetCode();
+    }
+  }
+
+  static const Token::Value kCompareOps[] = {
+    Token::EQ, Token::EQ_STRICT, Token::LT, Token::GT, Token::LTE, Token::GTE
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(kCompareOps); i++) {
+    CompareIC::GetUninitialized(kCompareOps[i]);
+  }
+
+  static const Token::Value kUnaryOps[] = { Token::SUB, Token::BIT_NOT };
+  static const UnaryOverwriteMode kUnaryOverwriteModes[] = {
+    UNARY_OVERWRITE, UNARY_NO_OVERWRITE
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(kUnaryOps); i++) {
+    for (size_t j = 0; j < ARRAY_SIZE(kUnaryOverwriteModes); j++) {
+      UnaryOpStub stub(kUnaryOps[i], kUnaryOverwriteModes[j]);
+      stub.GetCode();
+    }
+  }
+
+  // The element access stubs that keyed load and store ICs use for the
+  // common elements kinds.
+  static const ElementsKind kElementsKinds[] = {
+    FAST_SMI_ONLY_ELEMENTS, FAST_ELEMENTS, FAST_DOUBLE_ELEMENTS,
+    DICTIONARY_ELEMENTS
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(kElementsKinds); i++) {
+    KeyedLoadElementStub load_stub(kElementsKinds[i]);
+    load_stub.GetCode();
+    KeyedStoreElementStub store_stub(true, kElementsKinds[i]);
+    store_stub.GetCode();
+    KeyedStoreElementStub store_object_stub(false, kElementsKinds[i]);
+    store_object_stub.GetCode();
+  }
+}
+
+
 void CodeStub::GenerateCode(MacroAssembler* masm) {
   // Update the static counter each time a new code stub is generated.
   masm->isolate()->counters()->code_stubs()->Increment();
@@ -361,6 +423,11 @@ bool ToBooleanStub::Types::Record(Handle<Object> object) {
     Add(HEAP_NUMBER);
     double value = HeapNumber::cast(*object)->value();
     return value != 0 && !isnan(value);
+  } else if (object->IsBigInteger() ||
+             object->IsAtom() ||
+             object->IsStringBuffer()) {
+    // Always true and rare enough to be left to the runtime.
+    return true;
   } else {
     // We should never see an internal object at runtime here!
     UNREACHABLE();
@@ -54,6 +54,7 @@ namespace internal {
   V(ConvertToDouble)                     \
   V(WriteInt32ToHeapNumber)              \
   V(StackCheck)                          \
+  V(Interrupt)                           \
   V(FastNewClosure)                      \
   V(FastNewContext)                      \
   V(FastNewBlockContext)                 \
@@ -148,6 +149,11 @@ class CodeStub BASE_EMBEDDED {
   static void GenerateStubsAheadOfTime();
   static void GenerateFPStubs();
 
+  // Compiles the stubs that are asked for first by most code, so that the
+  // snapshot contains them.  Unlike pregenerated stubs these are ordinary
+  // stubs that may also be compiled on demand.
+  static void GenerateCommonStubsForSnapshot();
+
   // Some stubs put untagged junk on the stack that cannot be scanned by the
   // GC.  This means that we must be statically sure that no GC can occur while
   // they are running.  If that is the case they should override this to return
@@ -285,6 +291,20 @@ class StackCheckStub : public CodeStub {
 };
 
 
+// Called by unoptimized code when the interrupt budget in the profiling
+// counter cell passed in a register has run out.
+class InterruptStub : public CodeStub {
+ public:
+  InterruptStub() { }
+
+  void Generate(MacroAssembler* masm);
+
+ private:
+  Major MajorKey() { return Interrupt; }
+  int MinorKey() { return 0; }
+};
+
+
 class ToNumberStub: public CodeStub {
  public:
   ToNumberStub() { }
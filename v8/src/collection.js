@@ -70,6 +70,33 @@ function SetDelete(key) {
 }
 
 
+function SetGetSize() {
+  return %SetGetSize(this);
+}
+
+
+// Calls f with each key of the set in insertion order. Keys added while
+// iterating are not visited.
+function SetForEach(f, receiver) {
+  var keys = %SetGetKeys(this);
+  if (!IS_SPEC_FUNCTION(f)) {
+    throw MakeTypeError('called_non_callable', [ f ]);
+  }
+  if (IS_NULL_OR_UNDEFINED(receiver)) {
+    receiver = %GetDefaultReceiver(f) || receiver;
+  } else if (!IS_SPEC_OBJECT(receiver)) {
+    receiver = ToObject(receiver);
+  }
+  for (var i = 0; i < keys.length; i++) {
+    var key = keys[i];
+    if (key === undefined_sentinel) {
+      key = void 0;
+    }
+    %_CallFunction(receiver, key, key, this, f);
+  }
+}
+
+
 function MapConstructor() {
   if (%_IsConstructCall()) {
     %MapInitialize(this);
@@ -116,6 +143,33 @@ function MapDelete(key) {
 }
 
 
+function MapGetSize() {
+  return %MapGetSize(this);
+}
+
+
+// Calls f with each value and key of the map in insertion order. Entries
+// added while iterating are not visited.
+function MapForEach(f, receiver) {
+  var entries = %MapGetEntries(this);
+  if (!IS_SPEC_FUNCTION(f)) {
+    throw MakeTypeError('called_non_callable', [ f ]);
+  }
+  if (IS_NULL_OR_UNDEFINED(receiver)) {
+    receiver = %GetDefaultReceiver(f) || receiver;
+  } else if (!IS_SPEC_OBJECT(receiver)) {
+    receiver = ToObject(receiver);
+  }
+  for (var i = 0; i < entries.length; i += 2) {
+    var key = entries[i];
+    if (key === undefined_sentinel) {
+      key = void 0;
+    }
+    %_CallFunction(receiver, entries[i + 1], key, this, f);
+  }
+}
+
+
 function WeakMapConstructor() {
   if (%_IsConstructCall()) {
     %WeakMapInitialize(this);
@@ -178,16 +232,22 @@ function WeakMapDelete(key) {
   InstallFunctions($Set.prototype, DONT_ENUM, $Array(
     "add", SetAdd,
     "has", SetHas,
-    "delete", SetDelete
+    "delete", SetDelete,
+    "forEach", SetForEach
   ));
+  %DefineOrRedefineAccessorProperty($Set.prototype, "size", GETTER,
+                                    SetGetSize, DONT_ENUM);
 
   // Set up the non-enumerable functions on the Map prototype object.
   InstallFunctions($Map.prototype, DONT_ENUM, $Array(
     "get", MapGet,
     "set", MapSet,
     "has", MapHas,
-    "delete", MapDelete
+    "delete", MapDelete,
+    "forEach", MapForEach
   ));
+  %DefineOrRedefineAccessorProperty($Map.prototype, "size", GETTER,
+                                    MapGetSize, DONT_ENUM);
 
   // Set up the WeakMap constructor function.
   %SetCode($WeakMap, WeakMapConstructor);
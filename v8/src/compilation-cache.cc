@@ -42,6 +42,7 @@ static const int kScriptGenerations = 5;
 static const int kEvalGlobalGenerations = 2;
 static const int kEvalContextualGenerations = 2;
 static const int kRegExpGenerations = 2;
+static const int kPreparseDataGenerations = 5;
 
 // Initial size of each compilation cache table allocated.
 static const int kInitialCacheSize = 64;
@@ -53,9 +54,11 @@ CompilationCache::CompilationCache(Isolate* isolate)
       eval_global_(isolate, kEvalGlobalGenerations),
       eval_contextual_(isolate, kEvalContextualGenerations),
       reg_exp_(isolate, kRegExpGenerations),
-      enabled_(true) {
+      preparse_data_(isolate, kPreparseDataGenerations),
+      enabled_(true),
+      aged_for_current_gc_(false) {
   CompilationSubCache* subcaches[kSubCacheCount] =
-    {&script_, &eval_global_, &eval_contextual_, &reg_exp_};
+    {&script_, &eval_global_, &eval_contextual_, &reg_exp_, &preparse_data_};
   for (int i = 0; i < kSubCacheCount; ++i) {
     subcaches_[i] = subcaches[i];
   }
@@ -86,7 +89,24 @@ Handle<CompilationCacheTable> CompilationSubCache::GetTable(int generation) {
   return result;
 }
 
-void CompilationSubCache::Age() {
+void CompilationSubCache::SetFirstTable(Handle<CompilationCacheTable> value) {
+  ASSERT(kFirstGeneration < generations_);
+  tables_[kFirstGeneration] = *value;
+  if (value->NumberOfElements() >= FLAG_compilation_cache_generation_size) {
+    int evicted = Age();
+    isolate()->counters()->compilation_cache_evicted_size()->Increment(
+        evicted);
+  }
+}
+
+
+int CompilationSubCache::Age() {
+  int evicted = 0;
+  Object* oldest = tables_[generations_ - 1];
+  if (!oldest->IsUndefined()) {
+    evicted = CompilationCacheTable::cast(oldest)->NumberOfElements();
+  }
+
   // Age the generations implicitly killing off the oldest.
   for (int i = generations_ - 1; i > 0; i--) {
     tables_[i] = tables_[i - 1];
@@ -94,6 +114,7 @@ void CompilationSubCache::Age() {
 
   // Set the first generation as unborn.
   tables_[0] = isolate()->heap()->undefined_value();
+  return evicted;
 }
 
 
@@ -330,20 +351,137 @@ Handle<FixedArray> CompilationCacheRegExp::Lookup(Handle<String> source,
       }
     }
   }
+  if (!result->IsFixedArray()) {
+    result = LookupRetained(*source, flags);
+  }
   if (result->IsFixedArray()) {
     Handle<FixedArray> data(FixedArray::cast(result), isolate());
     if (generation != 0) {
       Put(source, flags, data);
+    } else {
+      Retain(source, flags, data);
     }
     isolate()->counters()->compilation_cache_hits()->Increment();
+    isolate()->counters()->regexp_cache_hits()->Increment();
     return data;
   } else {
     isolate()->counters()->compilation_cache_misses()->Increment();
+    isolate()->counters()->regexp_cache_misses()->Increment();
     return Handle<FixedArray>::null();
   }
 }
 
 
+// Returns the number of bytes kept alive by a retained regular
+// expression, including its compiled code.
+static int RetainedRegExpSize(String* source, FixedArray* data) {
+  int size = source->Size() + data->Size();
+  if (Smi::cast(data->get(JSRegExp::kTagIndex))->value() !=
+      JSRegExp::IRREGEXP) {
+    return size;
+  }
+  for (int i = 0; i < 2; i++) {
+    bool is_ascii = (i == 0);
+    Object* code = data->get(JSRegExp::code_index(is_ascii));
+    if (!code->IsHeapObject()) {
+      code = data->get(JSRegExp::saved_code_index(is_ascii));
+    }
+    if (code->IsHeapObject()) size += HeapObject::cast(code)->Size();
+    Object* bytecode = data->get(JSRegExp::bytecode_index(is_ascii));
+    if (bytecode->IsHeapObject()) size += HeapObject::cast(bytecode)->Size();
+  }
+  return size;
+}
+
+
+Object* CompilationCacheRegExp::LookupRetained(String* source,
+                                               JSRegExp::Flags flags) {
+  if (!retained_->IsFixedArray()) return isolate()->heap()->undefined_value();
+  FixedArray* retained = FixedArray::cast(retained_);
+  for (int i = 0; i < kRetainedEntries; i++) {
+    int index = i * kRetainedEntrySize;
+    Object* entry_source = retained->get(index + kRetainedSourceOffset);
+    if (!entry_source->IsString()) break;
+    if (Smi::cast(retained->get(index + kRetainedFlagsOffset))->value() ==
+            static_cast<int>(flags.value()) &&
+        String::cast(entry_source)->Equals(source)) {
+      return retained->get(index + kRetainedDataOffset);
+    }
+  }
+  return isolate()->heap()->undefined_value();
+}
+
+
+void CompilationCacheRegExp::Retain(Handle<String> source,
+                                    JSRegExp::Flags flags,
+                                    Handle<FixedArray> data) {
+  if (!retained_->IsFixedArray()) {
+    HandleScope scope(isolate());
+    retained_ = *isolate()->factory()->NewFixedArray(
+        kRetainedEntries * kRetainedEntrySize, TENURED);
+  }
+  AssertNoAllocation no_allocation;
+  FixedArray* retained = FixedArray::cast(retained_);
+
+  // Reuse the entry of this regular expression if it is in the list, and
+  // the least recently used one otherwise.
+  int entry = kRetainedEntries - 1;
+  for (int i = 0; i < kRetainedEntries - 1; i++) {
+    int index = i * kRetainedEntrySize;
+    Object* entry_source = retained->get(index + kRetainedSourceOffset);
+    if (!entry_source->IsString()) {
+      entry = i;
+      break;
+    }
+    if (retained->get(index + kRetainedDataOffset) == *data ||
+        (Smi::cast(retained->get(index + kRetainedFlagsOffset))->value() ==
+             static_cast<int>(flags.value()) &&
+         String::cast(entry_source)->Equals(*source))) {
+      entry = i;
+      break;
+    }
+  }
+  for (int i = entry * kRetainedEntrySize - 1; i >= 0; i--) {
+    retained->set(i + kRetainedEntrySize, retained->get(i));
+  }
+  retained->set(kRetainedSourceOffset, *source);
+  retained->set(kRetainedFlagsOffset, Smi::FromInt(flags.value()));
+  retained->set(kRetainedDataOffset, *data);
+
+  // Keep the most recently used regular expression even if it alone
+  // exceeds the limit.
+  int limit = FLAG_regexp_cache_retained_size * KB;
+  int size = 0;
+  for (int i = 0; i < kRetainedEntries; i++) {
+    int index = i * kRetainedEntrySize;
+    Object* entry_source = retained->get(index + kRetainedSourceOffset);
+    if (!entry_source->IsString()) break;
+    int entry_size = RetainedRegExpSize(
+        String::cast(entry_source),
+        FixedArray::cast(retained->get(index + kRetainedDataOffset)));
+    if (i > 0 && size + entry_size > limit) {
+      MemsetPointer(retained->data_start() + index,
+                    isolate()->heap()->undefined_value(),
+                    retained->length() - index);
+      break;
+    }
+    size += entry_size;
+  }
+  isolate()->counters()->regexp_cache_retained_size()->Set(size);
+}
+
+
+void CompilationCacheRegExp::IterateRetained(ObjectVisitor* v) {
+  v->VisitPointer(&retained_);
+}
+
+
+void CompilationCacheRegExp::ClearRetained() {
+  retained_ = isolate()->heap()->undefined_value();
+  isolate()->counters()->regexp_cache_retained_size()->Set(0);
+}
+
+
 MaybeObject* CompilationCacheRegExp::TryTablePut(
     Handle<String> source,
     JSRegExp::Flags flags,
@@ -368,6 +506,7 @@ void CompilationCacheRegExp::Put(Handle<String> source,
                                  Handle<FixedArray> data) {
   HandleScope scope(isolate());
   SetFirstTable(TablePut(source, flags, data));
+  Retain(source, flags, data);
 }
 
 
@@ -380,6 +519,61 @@ void CompilationCache::Remove(Handle<SharedFunctionInfo> function_info) {
 }
 
 
+Handle<ByteArray> CompilationCachePreparseData::Lookup(Handle<String> source,
+                                                       int parsing_flags) {
+  // Make sure not to leak the table into the surrounding handle
+  // scope. Otherwise, we risk keeping old tables around even after
+  // having cleared the cache.
+  Object* result = NULL;
+  int generation;
+  { HandleScope scope(isolate());
+    for (generation = 0; generation < generations(); generation++) {
+      Handle<CompilationCacheTable> table = GetTable(generation);
+      Object* probe = table->Lookup(*source);
+      if (probe->IsFixedArray() &&
+          FixedArray::cast(probe)->get(kFlagsIndex) ==
+              Smi::FromInt(parsing_flags)) {
+        result = FixedArray::cast(probe)->get(kDataIndex);
+        break;
+      }
+    }
+  }
+  if (result == NULL) return Handle<ByteArray>::null();
+  Handle<ByteArray> data(ByteArray::cast(result), isolate());
+  if (generation != 0) Put(source, parsing_flags, data);
+  return data;
+}
+
+
+MaybeObject* CompilationCachePreparseData::TryTablePut(
+    Handle<String> source,
+    Handle<FixedArray> entry) {
+  Handle<CompilationCacheTable> table = GetFirstTable();
+  return table->Put(*source, *entry);
+}
+
+
+Handle<CompilationCacheTable> CompilationCachePreparseData::TablePut(
+    Handle<String> source,
+    Handle<FixedArray> entry) {
+  CALL_HEAP_FUNCTION(isolate(),
+                     TryTablePut(source, entry),
+                     CompilationCacheTable);
+}
+
+
+void CompilationCachePreparseData::Put(Handle<String> source,
+                                       int parsing_flags,
+                                       Handle<ByteArray> data) {
+  HandleScope scope(isolate());
+  Handle<FixedArray> entry =
+      isolate()->factory()->NewFixedArray(kEntrySize, TENURED);
+  entry->set(kFlagsIndex, Smi::FromInt(parsing_flags));
+  entry->set(kDataIndex, *data);
+  SetFirstTable(TablePut(source, entry));
+}
+
+
 Handle<SharedFunctionInfo> CompilationCache::LookupScript(Handle<String> source,
                                                           Handle<Object> name,
                                                           int line_offset,
@@ -425,6 +619,16 @@ Handle<FixedArray> CompilationCache::LookupRegExp(Handle<String> source,
 }
 
 
+Handle<ByteArray> CompilationCache::LookupPreparseData(Handle<String> source,
+                                                     int parsing_flags) {
+  if (!IsEnabled()) {
+    return Handle<ByteArray>::null();
+  }
+
+  return preparse_data_.Lookup(source, parsing_flags);
+}
+
+
 void CompilationCache::PutScript(Handle<String> source,
                                  Handle<SharedFunctionInfo> function_info) {
   if (!IsEnabled()) {
@@ -466,10 +670,22 @@ void CompilationCache::PutRegExp(Handle<String> source,
 }
 
 
+void CompilationCache::PutPreparseData(Handle<String> source,
+                                       int parsing_flags,
+                                       Handle<ByteArray> data) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  preparse_data_.Put(source, parsing_flags, data);
+}
+
+
 void CompilationCache::Clear() {
   for (int i = 0; i < kSubCacheCount; i++) {
     subcaches_[i]->Clear();
   }
+  reg_exp_.ClearRetained();
 }
 
 
@@ -477,6 +693,7 @@ void CompilationCache::Iterate(ObjectVisitor* v) {
   for (int i = 0; i < kSubCacheCount; i++) {
     subcaches_[i]->Iterate(v);
   }
+  reg_exp_.IterateRetained(v);
 }
 
 
@@ -488,9 +705,18 @@ void CompilationCache::IterateFunctions(ObjectVisitor* v) {
 
 
 void CompilationCache::MarkCompactPrologue() {
+  if (aged_for_current_gc_) return;
+  aged_for_current_gc_ = true;
+  int evicted = 0;
   for (int i = 0; i < kSubCacheCount; i++) {
-    subcaches_[i]->Age();
+    evicted += subcaches_[i]->Age();
   }
+  isolate()->counters()->compilation_cache_evicted_age()->Increment(evicted);
+}
+
+
+void CompilationCache::MarkCompactEpilogue() {
+  aged_for_current_gc_ = false;
 }
 
 
@@ -31,8 +31,6 @@
 namespace v8 {
 namespace internal {
 
-class HashMap;
-
 // The compilation cache consists of several generational sub-caches which uses
 // this class as a base class. A sub-cache contains a compilation cache tables
 // for each generation of the sub-cache. Since the same source code string has
@@ -58,14 +56,15 @@ class CompilationSubCache {
   Handle<CompilationCacheTable> GetFirstTable() {
     return GetTable(kFirstGeneration);
   }
-  void SetFirstTable(Handle<CompilationCacheTable> value) {
-    ASSERT(kFirstGeneration < generations_);
-    tables_[kFirstGeneration] = *value;
-  }
+  // Installs a new first generation table. Once the first generation holds
+  // FLAG_compilation_cache_generation_size entries the sub-cache is aged, so
+  // a burst of distinct sources cannot grow the cache without bound between
+  // garbage collections.
+  void SetFirstTable(Handle<CompilationCacheTable> value);
 
   // Age the sub-cache by evicting the oldest generation and creating a new
-  // young generation.
-  void Age();
+  // young generation. Returns the number of entries evicted.
+  int Age();
 
   // GC support.
   void Iterate(ObjectVisitor* v);
@@ -169,18 +168,39 @@ class CompilationCacheEval: public CompilationSubCache {
 };
 
 
-// Sub-cache for regular expressions.
+// Sub-cache for regular expressions. Besides the generational tables it
+// keeps a short list of the most recently used regular expressions that
+// is not aged, so that regular expressions that are still in use are not
+// recompiled after every couple of mark-compact collections. The list is
+// bounded by --regexp-cache-retained-size.
 class CompilationCacheRegExp: public CompilationSubCache {
  public:
   CompilationCacheRegExp(Isolate* isolate, int generations)
-      : CompilationSubCache(isolate, generations) { }
+      : CompilationSubCache(isolate, generations),
+        retained_(NULL) { }
 
   Handle<FixedArray> Lookup(Handle<String> source, JSRegExp::Flags flags);
 
   void Put(Handle<String> source,
            JSRegExp::Flags flags,
            Handle<FixedArray> data);
+
+  // GC support for the retained regular expressions.
+  void IterateRetained(ObjectVisitor* v);
+
+  // Evict all the retained regular expressions.
+  void ClearRetained();
+
  private:
+  // Returns the data of the retained regular expression or undefined.
+  Object* LookupRetained(String* source, JSRegExp::Flags flags);
+
+  // Move the regular expression to the front of the retained list and
+  // evict the least recently used ones that exceed the size limit.
+  void Retain(Handle<String> source,
+              JSRegExp::Flags flags,
+              Handle<FixedArray> data);
+
   MUST_USE_RESULT MaybeObject* TryTablePut(Handle<String> source,
                                       JSRegExp::Flags flags,
                                       Handle<FixedArray> data);
@@ -190,10 +210,56 @@ class CompilationCacheRegExp: public CompilationSubCache {
                                          JSRegExp::Flags flags,
                                          Handle<FixedArray> data);
 
+  // Layout of the retained list: a fixed array of source, flags and data
+  // triples, most recently used first. Unused entries are at the end and
+  // hold undefined.
+  static const int kRetainedEntries = 32;
+  static const int kRetainedSourceOffset = 0;
+  static const int kRetainedFlagsOffset = 1;
+  static const int kRetainedDataOffset = 2;
+  static const int kRetainedEntrySize = 3;
+
+  // The retained list, or not a fixed array before first use.
+  Object* retained_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(CompilationCacheRegExp);
 };
 
 
+// Sub-cache for the function entries the parser records while parsing a
+// script. When the same source has to be parsed again, for instance because
+// it is compiled with another origin or its code has been evicted from the
+// script sub-cache, the parser uses them to skip the bodies of lazily
+// compiled functions instead of preparsing each of them again.
+class CompilationCachePreparseData: public CompilationSubCache {
+ public:
+  CompilationCachePreparseData(Isolate* isolate, int generations)
+      : CompilationSubCache(isolate, generations) { }
+
+  Handle<ByteArray> Lookup(Handle<String> source, int parsing_flags);
+
+  void Put(Handle<String> source,
+           int parsing_flags,
+           Handle<ByteArray> data);
+
+ private:
+  MUST_USE_RESULT MaybeObject* TryTablePut(Handle<String> source,
+                                           Handle<FixedArray> entry);
+
+  // Note: Returns a new hash table if operation results in expansion.
+  Handle<CompilationCacheTable> TablePut(Handle<String> source,
+                                         Handle<FixedArray> entry);
+
+  // Layout of a cache entry: the parsing flags the data was recorded with,
+  // and the data itself.
+  static const int kFlagsIndex = 0;
+  static const int kDataIndex = 1;
+  static const int kEntrySize = 2;
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(CompilationCachePreparseData);
+};
+
+
 // The compilation cache keeps shared function infos for compiled
 // scripts and evals. The shared function infos are looked up using
 // the source string as the key. For regular expressions the
@@ -222,6 +288,11 @@ class CompilationCache {
   Handle<FixedArray> LookupRegExp(Handle<String> source,
                                   JSRegExp::Flags flags);
 
+  // Returns the function entries recorded by an earlier parse of the given
+  // script source with the same parsing flags, otherwise an empty handle.
+  Handle<ByteArray> LookupPreparseData(Handle<String> source,
+                                       int parsing_flags);
+
   // Associate the (source, kind) pair to the shared function
   // info. This may overwrite an existing mapping.
   void PutScript(Handle<String> source,
@@ -241,6 +312,12 @@ class CompilationCache {
                  JSRegExp::Flags flags,
                  Handle<FixedArray> data);
 
+  // Associate the (source, parsing flags) pair to the function entries
+  // recorded while parsing the source.
+  void PutPreparseData(Handle<String> source,
+                       int parsing_flags,
+                       Handle<ByteArray> data);
+
   // Clear the cache - also used to initialize the cache at startup.
   void Clear();
 
@@ -253,9 +330,14 @@ class CompilationCache {
 
   // Notify the cache that a mark-sweep garbage collection is about to
   // take place. This is used to retire entries from the cache to
-  // avoid keeping them alive too long without using them.
+  // avoid keeping them alive too long without using them. Incremental
+  // marking notifies the cache when marking starts and the collector again
+  // when it finishes; the cache is only aged once per collection.
   void MarkCompactPrologue();
 
+  // Notify the cache that a mark-sweep garbage collection has finished.
+  void MarkCompactEpilogue();
+
   // Enable/disable compilation cache. Used by debugger to disable compilation
   // cache during debugging to make sure new scripts are always compiled.
   void Enable();
@@ -268,7 +350,7 @@ class CompilationCache {
   HashMap* EagerOptimizingSet();
 
   // The number of sub caches covering the different types to cache.
-  static const int kSubCacheCount = 4;
+  static const int kSubCacheCount = 5;
 
   bool IsEnabled() { return FLAG_compilation_cache && enabled_; }
 
@@ -280,11 +362,16 @@ class CompilationCache {
   CompilationCacheEval eval_global_;
   CompilationCacheEval eval_contextual_;
   CompilationCacheRegExp reg_exp_;
+  CompilationCachePreparseData preparse_data_;
   CompilationSubCache* subcaches_[kSubCacheCount];
 
   // Current enable state of the compilation cache.
   bool enabled_;
 
+  // Whether the sub-caches have been aged for the mark-sweep collection
+  // currently in progress.
+  bool aged_for_current_gc_;
+
   friend class Isolate;
 
   DISALLOW_COPY_AND_ASSIGN(CompilationCache);
@@ -33,18 +33,21 @@
 #include "codegen.h"
 #include "compilation-cache.h"
 #include "debug.h"
+#include "feedback-profile.h"
 #include "full-codegen.h"
 #include "gdb-jit.h"
 #include "hydrogen.h"
 #include "isolate-inl.h"
 #include "lithium.h"
 #include "liveedit.h"
+#include "optimizing-compiler-thread.h"
 #include "parser.h"
 #include "rewriter.h"
 #include "runtime-profiler.h"
 #include "scanner-character-streams.h"
 #include "scopeinfo.h"
 #include "scopes.h"
+#include "serialize.h"
 #include "vm-state-inl.h"
 
 namespace v8 {
@@ -60,7 +63,8 @@ CompilationInfo::CompilationInfo(Handle<Script> script)
       script_(script),
       extension_(NULL),
       pre_parse_data_(NULL),
-      osr_ast_id_(AstNode::kNoNumber) {
+      osr_ast_id_(AstNode::kNoNumber),
+      bailout_reason_(NULL) {
   Initialize(NONOPT);
 }
 
@@ -76,7 +80,8 @@ CompilationInfo::CompilationInfo(Handle<SharedFunctionInfo> shared_info)
       script_(Handle<Script>(Script::cast(shared_info->script()))),
       extension_(NULL),
       pre_parse_data_(NULL),
-      osr_ast_id_(AstNode::kNoNumber) {
+      osr_ast_id_(AstNode::kNoNumber),
+      bailout_reason_(NULL) {
   Initialize(BASE);
 }
 
@@ -93,7 +98,8 @@ CompilationInfo::CompilationInfo(Handle<JSFunction> closure)
       script_(Handle<Script>(Script::cast(shared_info_->script()))),
       extension_(NULL),
       pre_parse_data_(NULL),
-      osr_ast_id_(AstNode::kNoNumber) {
+      osr_ast_id_(AstNode::kNoNumber),
+      bailout_reason_(NULL) {
   Initialize(BASE);
 }
 
@@ -122,13 +128,13 @@ void CompilationInfo::AbortOptimization() {
 // the code from the full compiler supports mode precise break points. For the
 // crankshaft adaptive compiler debugging the optimized code is not possible at
 // all. However crankshaft support recompilation of functions, so in this case
-// the full compiler need not be be used if a debugger is attached, but only if
-// break points has actually been set.
-static bool is_debugging_active() {
+// the full compiler need not be be used if a debugger is attached, but only
+// for functions with break points, or for all functions while stepping.
+static bool is_debugging_active(CompilationInfo* info) {
 #ifdef ENABLE_DEBUGGER_SUPPORT
-  Isolate* isolate = Isolate::Current();
+  Isolate* isolate = info->isolate();
   return V8::UseCrankshaft() ?
-    isolate->debug()->has_break_points() :
+    isolate->DebuggerNeedsFullCode(*info->shared_info()) :
     isolate->debugger()->IsDebuggerActive();
 #else
   return false;
@@ -136,8 +142,8 @@ static bool is_debugging_active() {
 }
 
 
-static bool AlwaysFullCompiler() {
-  return FLAG_always_full_compiler || is_debugging_active();
+static bool AlwaysFullCompiler(CompilationInfo* info) {
+  return FLAG_always_full_compiler || is_debugging_active(info);
 }
 
 
@@ -167,7 +173,8 @@ static void FinishOptimization(Handle<JSFunction> function, int64_t start) {
 }
 
 
-static bool MakeCrankshaftCode(CompilationInfo* info) {
+static bool MakeCrankshaftCode(CompilationInfo* info,
+                               OptimizingCompiler* job) {
   // Test if we can optimize this function when asked to. We can only
   // do this after the scopes are computed.
   if (!info->AllowOptimize()) {
@@ -194,7 +201,7 @@ static bool MakeCrankshaftCode(CompilationInfo* info) {
   // Fall back to using the full code generator if it's not possible
   // to use the Hydrogen-based optimizing compiler. We already have
   // generated code for this from the shared function object.
-  if (AlwaysFullCompiler() || !FLAG_use_hydrogen) {
+  if (AlwaysFullCompiler(info) || !FLAG_use_hydrogen) {
     info->SetCode(code);
     return true;
   }
@@ -205,8 +212,7 @@ static bool MakeCrankshaftCode(CompilationInfo* info) {
       FLAG_deopt_every_n_times == 0 ? Compiler::kDefaultMaxOptCount : 1000;
   if (info->shared_info()->opt_count() > kMaxOptCount) {
     info->AbortOptimization();
-    Handle<JSFunction> closure = info->closure();
-    info->shared_info()->DisableOptimization(*closure);
+    Compiler::DisableOptimization(info->closure(), "optimized too many times");
     // True indicates the compilation pipeline is still going, not
     // necessarily that we optimized the code.
     return true;
@@ -226,8 +232,8 @@ static bool MakeCrankshaftCode(CompilationInfo* info) {
       (info->osr_ast_id() != AstNode::kNoNumber &&
        scope->num_parameters() + 1 + scope->num_stack_slots() > locals_limit)) {
     info->AbortOptimization();
-    Handle<JSFunction> closure = info->closure();
-    info->shared_info()->DisableOptimization(*closure);
+    Compiler::DisableOptimization(info->closure(),
+                                  "too many parameters or locals");
     // True indicates the compilation pipeline is still going, not
     // necessarily that we optimized the code.
     return true;
@@ -282,7 +288,8 @@ static bool MakeCrankshaftCode(CompilationInfo* info) {
   }
 
   Handle<Context> global_context(info->closure()->context()->global_context());
-  TypeFeedbackOracle oracle(code, global_context, info->isolate());
+  TypeFeedbackOracle oracle(
+      code, info->shared_info(), global_context, info->isolate());
   HGraphBuilder builder(info, &oracle);
   HPhase phase(HPhase::kTotal);
   HGraph* graph = builder.CreateGraph();
@@ -291,8 +298,20 @@ static bool MakeCrankshaftCode(CompilationInfo* info) {
     return false;
   }
 
+  if (graph != NULL && job == NULL) graph->Optimize();
+  Isolate* isolate = info->isolate();
+  isolate->zone()->RecordHighWaterMark(
+      isolate->counters()->zone_hydrogen_high_water_mark());
+
   if (graph != NULL && FLAG_build_lithium) {
+    if (job != NULL) {
+      // The rest of the pipeline runs on the optimizing compiler thread.
+      job->SetGraph(graph, start, builder.inline_bailout());
+      return true;
+    }
     Handle<Code> optimized_code = graph->Compile(info);
+    isolate->zone()->RecordHighWaterMark(
+        isolate->counters()->zone_lithium_high_water_mark());
     if (!optimized_code.is_null()) {
       info->SetCode(optimized_code);
       FinishOptimization(info->closure(), start);
@@ -305,8 +324,10 @@ static bool MakeCrankshaftCode(CompilationInfo* info) {
   if (!builder.inline_bailout()) {
     // Mark the shared code as unoptimizable unless it was an inlined
     // function that bailed out.
-    Handle<JSFunction> closure = info->closure();
-    info->shared_info()->DisableOptimization(*closure);
+    Compiler::DisableOptimization(info->closure(), info->bailout_reason());
+  } else {
+    Compiler::RecordBailoutReason(info->shared_info(),
+                                  "inlined function bailed out");
   }
   // True indicates the compilation pipeline is still going, not necessarily
   // that we optimized the code.
@@ -317,7 +338,7 @@ static bool MakeCrankshaftCode(CompilationInfo* info) {
 static bool GenerateCode(CompilationInfo* info) {
   return info->IsCompilingForDebugging() || !V8::UseCrankshaft() ?
       FullCodeGenerator::MakeCode(info) :
-      MakeCrankshaftCode(info);
+      MakeCrankshaftCode(info, NULL);
 }
 
 
@@ -512,12 +533,27 @@ Handle<SharedFunctionInfo> Compiler::Compile(Handle<String> source,
     script->set_data(script_data.is_null() ? HEAP->undefined_value()
                                            : *script_data);
 
-    // Compile the function and add it to the cache.
-    CompilationInfo info(script);
-    info.MarkAsGlobal();
-    info.SetExtension(extension);
-    info.SetPreParseData(pre_data);
-    result = MakeFunctionInfo(&info);
+    if (pre_data != NULL && pre_data->is_code_cache()) {
+      // Restore the code from the cache.  If it was produced for another
+      // source or with other flags, compile the script from scratch.
+      result = CodeSerializer::Deserialize(script, pre_data);
+      pre_data = NULL;
+#ifdef ENABLE_DEBUGGER_SUPPORT
+      if (!result.is_null()) {
+        isolate->debugger()->OnAfterCompile(
+            script, Debugger::NO_AFTER_COMPILE_FLAGS);
+      }
+#endif
+    }
+
+    if (result.is_null()) {
+      // Compile the function.
+      CompilationInfo info(script);
+      info.MarkAsGlobal();
+      info.SetExtension(extension);
+      info.SetPreParseData(pre_data);
+      result = MakeFunctionInfo(&info);
+    }
     if (extension == NULL && !result.is_null()) {
       compilation_cache->PutScript(source, result);
     }
@@ -528,6 +564,47 @@ Handle<SharedFunctionInfo> Compiler::Compile(Handle<String> source,
 }
 
 
+Handle<SharedFunctionInfo> Compiler::CompileWithFrontEnd(
+    Handle<String> source,
+    Handle<Object> script_name,
+    ScriptDataImpl* pre_data) {
+  Isolate* isolate = source->GetIsolate();
+  ASSERT(isolate->parser_front_end() != NULL);
+  int source_length = source->length();
+  isolate->counters()->total_load_size()->Increment(source_length);
+  isolate->counters()->total_compile_size()->Increment(source_length);
+
+  // The VM is in the COMPILER state until exiting this function.
+  VMState state(isolate, COMPILER);
+
+  // The compilation cache is keyed on the source alone, which would mix
+  // up scripts in different languages, so it is bypassed.
+  Handle<Script> script = isolate->factory()->NewScript(source);
+  script->set_type(Smi::FromInt(Script::TYPE_FRONT_END));
+  if (!script_name.is_null()) script->set_name(*script_name);
+
+  // Front ends do not use preparse data, only code caches.
+  Handle<SharedFunctionInfo> result;
+  if (pre_data != NULL && pre_data->is_code_cache()) {
+    result = CodeSerializer::Deserialize(script, pre_data);
+#ifdef ENABLE_DEBUGGER_SUPPORT
+    if (!result.is_null()) {
+      isolate->debugger()->OnAfterCompile(
+          script, Debugger::NO_AFTER_COMPILE_FLAGS);
+    }
+#endif
+  }
+
+  if (result.is_null()) {
+    CompilationInfo info(script);
+    info.MarkAsGlobal();
+    result = MakeFunctionInfo(&info);
+  }
+  if (result.is_null()) isolate->ReportPendingMessages();
+  return result;
+}
+
+
 Handle<SharedFunctionInfo> Compiler::CompileEval(Handle<String> source,
                                                  Handle<Context> context,
                                                  bool is_global,
@@ -658,7 +735,7 @@ bool Compiler::CompileLazy(CompilationInfo* info) {
           // version of the function right away - unless the debugger is
           // active as it makes no sense to compile optimized code then.
           if (FLAG_always_opt &&
-              !Isolate::Current()->DebuggerHasBreakPoints()) {
+              !Isolate::Current()->DebuggerNeedsFullCode(*shared)) {
             CompilationInfo optimized(function);
             optimized.SetOptimizing(AstNode::kNoNumber);
             return CompileLazy(&optimized);
@@ -675,6 +752,157 @@ bool Compiler::CompileLazy(CompilationInfo* info) {
 }
 
 
+bool Compiler::RecompileConcurrent(Handle<JSFunction> closure) {
+  Isolate* isolate = closure->GetIsolate();
+  OptimizingCompilerThread* thread = isolate->optimizing_compiler_thread();
+  // The Hydrogen statistics and tracer are not thread safe.
+  if (thread == NULL || FLAG_hydrogen_stats || FLAG_trace_hydrogen) {
+    return false;
+  }
+  if (thread->IsQueued(*closure)) {
+    closure->ReplaceCode(closure->shared()->code());
+    return true;
+  }
+  if (!thread->IsQueueAvailable()) return false;
+
+  // The AST, the graph and the handles they refer to must outlive this
+  // function, so they go into the zone and the deferred handles of the job.
+  Zone* zone = new Zone(isolate);
+  Zone* previous_zone = isolate->zone();
+  Isolate::SetThreadZone(zone);
+  OptimizingCompiler* job;
+  bool has_graph;
+  {
+    ZoneScope zone_scope(isolate, DONT_DELETE_ON_EXIT);
+    DeferredHandleScope deferred(isolate);
+    job = new OptimizingCompiler(Handle<JSFunction>(*closure), zone);
+    has_graph = job->CreateGraph();
+    job->set_deferred_handles(deferred.Detach());
+  }
+  Isolate::SetThreadZone(previous_zone);
+
+  // Keep running the unoptimized code until the optimized code is installed.
+  closure->ReplaceCode(closure->shared()->code());
+  if (has_graph) {
+    thread->QueueForOptimization(job);
+  } else {
+    delete job;
+  }
+  return true;
+}
+
+
+OptimizingCompiler::OptimizingCompiler(Handle<JSFunction> closure, Zone* zone)
+    : zone_(zone),
+      info_(closure),
+      deferred_handles_(NULL),
+      graph_(NULL),
+      chunk_(NULL),
+      start_(0),
+      inline_bailout_(false) {
+  info_.SetOptimizing(AstNode::kNoNumber);
+  info_.MarkAsConcurrent();
+}
+
+
+OptimizingCompiler::~OptimizingCompiler() {
+  delete deferred_handles_;
+  zone_->DeleteAll();
+  zone_->DeleteKeptSegment();
+  delete zone_;
+}
+
+
+bool OptimizingCompiler::CreateGraph() {
+  Isolate* isolate = info_.isolate();
+  VMState state(isolate, COMPILER);
+  PostponeInterruptsScope postpone(isolate);
+
+  Handle<SharedFunctionInfo> shared = info_.shared_info();
+  int compiled_size = shared->end_position() - shared->start_position();
+  isolate->counters()->total_compile_size()->Increment(compiled_size);
+
+  if (ParserApi::Parse(&info_, kNoParsingFlags)) {
+    LanguageMode language_mode = info_.function()->language_mode();
+    info_.SetLanguageMode(language_mode);
+    shared->set_language_mode(language_mode);
+    if (Rewriter::Rewrite(&info_) && Scope::Analyze(&info_)) {
+      MakeCrankshaftCode(&info_, this);
+    }
+  }
+  // A failed optimization leaves the function with its unoptimized code.
+  if (isolate->has_pending_exception()) isolate->clear_pending_exception();
+  if (graph_ == NULL) return false;
+
+  unoptimized_code_ = Handle<Code>(shared->code());
+  return true;
+}
+
+
+void OptimizingCompiler::OptimizeGraph() {
+  Isolate* isolate = info_.isolate();
+  Zone* previous_zone = isolate->zone();
+  Isolate::SetThreadZone(zone_);
+  {
+    ZoneScope zone_scope(isolate, DONT_DELETE_ON_EXIT);
+    graph_->Optimize();
+    zone_->RecordHighWaterMark(
+        isolate->counters()->zone_hydrogen_high_water_mark());
+    chunk_ = graph_->CreateChunk(&info_);
+    zone_->RecordHighWaterMark(
+        isolate->counters()->zone_lithium_high_water_mark());
+  }
+  Isolate::SetThreadZone(previous_zone);
+}
+
+
+void OptimizingCompiler::GenerateAndInstallCode() {
+  Isolate* isolate = info_.isolate();
+  Handle<JSFunction> closure = info_.closure();
+  Handle<SharedFunctionInfo> shared = info_.shared_info();
+
+  // Deoptimization translates to the unoptimized code the graph was built
+  // against.  Code flushing, live editing or the debugger may have replaced
+  // that code in the meantime, which makes the graph useless.  So does a
+  // change of a global property value the graph embeds as a constant.
+  if (shared->code() != *unoptimized_code_ ||
+      shared->optimization_disabled() ||
+      isolate->DebuggerNeedsFullCode(*shared) ||
+      closure->IsOptimized() ||
+      graph_->HasChangedConstantCells()) {
+    return;
+  }
+
+  Zone* previous_zone = isolate->zone();
+  Isolate::SetThreadZone(zone_);
+  {
+    ZoneScope zone_scope(isolate, DONT_DELETE_ON_EXIT);
+    VMState state(isolate, COMPILER);
+    Handle<Code> code;
+    if (chunk_ != NULL) code = graph_->GenerateCode(chunk_, &info_);
+    zone_->RecordHighWaterMark(
+        isolate->counters()->zone_lithium_high_water_mark());
+    if (!code.is_null()) {
+      info_.SetCode(code);
+      FinishOptimization(closure, start_);
+      Compiler::RecordFunctionCompilation(
+          Logger::LAZY_COMPILE_TAG, &info_, shared);
+      closure->ReplaceCode(*code);
+    } else {
+      // Mark the shared code as unoptimizable unless it was an inlined
+      // function that bailed out.
+      if (inline_bailout_) {
+        Compiler::RecordBailoutReason(shared, "inlined function bailed out");
+      } else {
+        Compiler::DisableOptimization(closure, info_.bailout_reason());
+      }
+      closure->ReplaceCode(shared->code());
+    }
+  }
+  Isolate::SetThreadZone(previous_zone);
+}
+
+
 Handle<SharedFunctionInfo> Compiler::BuildFunctionInfo(FunctionLiteral* literal,
                                                        Handle<Script> script) {
   // Precondition: code has been parsed and scopes have been analyzed.
@@ -698,7 +926,7 @@ Handle<SharedFunctionInfo> Compiler::BuildFunctionInfo(FunctionLiteral* literal,
   if (FLAG_lazy && allow_lazy) {
     Handle<Code> code = info.isolate()->builtins()->LazyCompile();
     info.SetCode(code);
-  } else if ((V8::UseCrankshaft() && MakeCrankshaftCode(&info)) ||
+  } else if ((V8::UseCrankshaft() && MakeCrankshaftCode(&info, NULL)) ||
              (!V8::UseCrankshaft() && FullCodeGenerator::MakeCode(&info))) {
     ASSERT(!info.code().is_null());
     scope_info = ScopeInfo::Create(info.scope());
@@ -715,6 +943,8 @@ Handle<SharedFunctionInfo> Compiler::BuildFunctionInfo(FunctionLiteral* literal,
   SetFunctionInfo(result, literal, false, script);
   RecordFunctionCompilation(Logger::FUNCTION_TAG, &info, result);
   result->set_allows_lazy_compilation(allow_lazy);
+  FeedbackProfile* profile = info.isolate()->feedback_profile();
+  if (profile != NULL) profile->ApplyTo(*result);
 
   // Set the expected number of properties for instances and return
   // the resulting function.
@@ -792,4 +1022,49 @@ void Compiler::RecordFunctionCompilation(Logger::LogEventsAndTags tag,
                  info));
 }
 
+
+void Compiler::RecordBailoutReason(Handle<SharedFunctionInfo> shared,
+                                   const char* reason) {
+  Factory* factory = shared->GetIsolate()->factory();
+  Handle<String> symbol =
+      factory->LookupAsciiSymbol(reason != NULL ? reason : "unknown reason");
+  Handle<FixedArray> reasons;
+  int length = 0;
+  if (shared->bailout_reasons()->IsFixedArray()) {
+    reasons = Handle<FixedArray>(FixedArray::cast(shared->bailout_reasons()));
+    length = reasons->length();
+  }
+  int index = 0;
+  while (index < length && reasons->get(index) != *symbol) index += 2;
+  int count = 1;
+  if (index < length) {
+    count = Smi::cast(reasons->get(index + 1))->value() + 1;
+  } else if (length < 2 * kMaxBailoutReasons) {
+    Handle<FixedArray> grown = factory->NewFixedArray(length + 2, TENURED);
+    for (int i = 0; i < length; i++) grown->set(i, reasons->get(i));
+    reasons = grown;
+    shared->set_bailout_reasons(*reasons);
+  } else {
+    // Forget the least recent reason.
+    index = length - 2;
+  }
+  // Keep the most recent reason first.
+  for (int i = index; i > 0; i -= 2) {
+    reasons->set(i, reasons->get(i - 2));
+    reasons->set(i + 1, reasons->get(i - 1));
+  }
+  reasons->set(0, *symbol);
+  reasons->set(1, Smi::FromInt(count));
+}
+
+
+void Compiler::DisableOptimization(Handle<JSFunction> closure,
+                                   const char* reason) {
+  Handle<SharedFunctionInfo> shared(closure->shared());
+  RecordBailoutReason(shared, reason);
+  shared->DisableOptimization(*closure);
+  PROFILE(shared->GetIsolate(),
+          CodeDisableOptEvent(shared->code(), *shared));
+}
+
 } }  // namespace v8::internal
@@ -91,6 +91,13 @@ class CompilationInfo BASE_EMBEDDED {
   void MarkAsNative() {
     flags_ |= IsNative::encode(true);
   }
+  void MarkAsConcurrent() {
+    ASSERT(IsOptimizing());
+    flags_ |= IsConcurrent::encode(true);
+  }
+  bool is_concurrent() const {
+    return IsConcurrent::decode(flags_);
+  }
   bool is_native() const {
     return IsNative::decode(flags_);
   }
@@ -172,6 +179,13 @@ class CompilationInfo BASE_EMBEDDED {
   // current compilation pipeline.
   void AbortOptimization();
 
+  // The reason the optimizing compiler gave up on the function, or NULL.
+  // Only the first reason is kept, later ones are usually consequences.
+  const char* bailout_reason() const { return bailout_reason_; }
+  void set_bailout_reason(const char* reason) {
+    if (bailout_reason_ == NULL) bailout_reason_ = reason;
+  }
+
  private:
   Isolate* isolate_;
 
@@ -225,6 +239,8 @@ class CompilationInfo BASE_EMBEDDED {
   // If compiling for debugging produce just full code matching the
   // initial mode setting.
   class IsCompilingForDebugging: public BitField<bool, 8, 1> {};
+  // Is this function being optimized on the optimizing compiler thread.
+  class IsConcurrent: public BitField<bool, 9, 1> {};
 
 
   unsigned flags_;
@@ -257,10 +273,72 @@ class CompilationInfo BASE_EMBEDDED {
   Mode mode_;
   int osr_ast_id_;
 
+  // Static string, see set_bailout_reason.
+  const char* bailout_reason_;
+
   DISALLOW_COPY_AND_ASSIGN(CompilationInfo);
 };
 
 
+class DeferredHandles;
+class HGraph;
+class LChunk;
+
+// A function that is optimized on the optimizing compiler thread.  Building
+// the graph and generating code need the heap, so they run on the main
+// thread; the optimization phases, the translation to Lithium and register
+// allocation run on the optimizing compiler thread in between.  The AST and
+// the graph are allocated in a zone of their own and the handles they refer
+// to are deferred, so that both survive until the code is installed.
+class OptimizingCompiler: public Malloced {
+ public:
+  // Takes ownership of the zone.  Must be created with the zone as the zone
+  // of the current thread and inside the DeferredHandleScope whose handles
+  // are passed to set_deferred_handles.
+  OptimizingCompiler(Handle<JSFunction> closure, Zone* zone);
+  ~OptimizingCompiler();
+
+  // Parses the function and builds its graph on the main thread.  Returns
+  // false if there is nothing left to do for the optimizing compiler
+  // thread because the function cannot be optimized.
+  bool CreateGraph();
+
+  // Runs on the optimizing compiler thread.
+  void OptimizeGraph();
+
+  // Generates the code on the main thread and installs it on the function,
+  // unless the function changed in a way that makes the graph stale.
+  void GenerateAndInstallCode();
+
+  // Called by the graph builder pipeline when the graph is ready.
+  void SetGraph(HGraph* graph, int64_t start, bool inline_bailout) {
+    graph_ = graph;
+    start_ = start;
+    inline_bailout_ = inline_bailout;
+  }
+
+  void set_deferred_handles(DeferredHandles* deferred_handles) {
+    deferred_handles_ = deferred_handles;
+  }
+
+  CompilationInfo* info() { return &info_; }
+  Zone* zone() const { return zone_; }
+
+ private:
+  Zone* zone_;
+  CompilationInfo info_;
+  DeferredHandles* deferred_handles_;
+  // The unoptimized code the graph was built against.
+  Handle<Code> unoptimized_code_;
+  HGraph* graph_;
+  LChunk* chunk_;
+  int64_t start_;
+  bool inline_bailout_;
+
+  DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
+};
+
+
 // The V8 compiler
 //
 // General strategy: Source code is translated into an anonymous function w/o
@@ -280,6 +358,9 @@ class Compiler : public AllStatic {
 
   static const int kMaxInliningLevels = 3;
 
+  // Maximum number of different bailout reasons kept for a function.
+  static const int kMaxBailoutReasons = 8;
+
   // All routines return a SharedFunctionInfo.
   // If an error occurs an exception is raised and the return handle
   // contains NULL.
@@ -294,6 +375,14 @@ class Compiler : public AllStatic {
                                             Handle<Object> script_data,
                                             NativesFlag is_natives_code);
 
+  // Compile a source in another language, parsed by the isolate's
+  // ParserFrontEnd, within a context.  The result is not put in the
+  // compilation cache.  pre_data can be a code cache for the source.
+  static Handle<SharedFunctionInfo> CompileWithFrontEnd(
+      Handle<String> source,
+      Handle<Object> script_name,
+      ScriptDataImpl* pre_data);
+
   // Compile a String source within a context for Eval.
   static Handle<SharedFunctionInfo> CompileEval(Handle<String> source,
                                                 Handle<Context> context,
@@ -305,6 +394,11 @@ class Compiler : public AllStatic {
   // success and false if the compilation resulted in a stack overflow.
   static bool CompileLazy(CompilationInfo* info);
 
+  // Queues the function for optimization on the optimizing compiler thread
+  // and lets it run its unoptimized code in the meantime.  Returns false if
+  // the function has to be optimized synchronously instead.
+  static bool RecompileConcurrent(Handle<JSFunction> closure);
+
   // Compile a shared function info object (the function is possibly lazily
   // compiled).
   static Handle<SharedFunctionInfo> BuildFunctionInfo(FunctionLiteral* node,
@@ -323,6 +417,16 @@ class Compiler : public AllStatic {
   static void RecordFunctionCompilation(Logger::LogEventsAndTags tag,
                                         CompilationInfo* info,
                                         Handle<SharedFunctionInfo> shared);
+
+  // Records on the shared function info that an attempt to optimize the
+  // function failed, and why.  The reason is a static string, NULL if
+  // unknown.
+  static void RecordBailoutReason(Handle<SharedFunctionInfo> shared,
+                                  const char* reason);
+
+  // Records the reason and gives up on optimizing the function for good.
+  static void DisableOptimization(Handle<JSFunction> closure,
+                                  const char* reason);
 };
 
 
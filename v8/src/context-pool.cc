@@ -0,0 +1,217 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "context-pool.h"
+
+namespace v8 {
+
+ContextPool::ContextPool(Isolate* isolate,
+                         const Options& options,
+                         Handle<ObjectTemplate> global_template,
+                         ExtensionConfiguration* extensions)
+    : pool_(new internal::ContextPool(isolate, options, global_template,
+                                      extensions)) {
+}
+
+
+ContextPool::~ContextPool() {
+  delete pool_;
+}
+
+
+Persistent<Context> ContextPool::Acquire() {
+  return pool_->Acquire();
+}
+
+
+void ContextPool::Release(Persistent<Context> context, ReleaseMode mode) {
+  pool_->Release(context, mode);
+}
+
+
+void ContextPool::Refill() {
+  pool_->Refill();
+}
+
+
+int ContextPool::AvailableCount() {
+  return pool_->AvailableCount();
+}
+
+
+namespace internal {
+
+
+class ContextPool::RefillThread : public Thread {
+ public:
+  explicit RefillThread(ContextPool* pool)
+      : Thread("v8:ContextPool"), pool_(pool) { }
+
+  virtual void Run() { pool_->RunRefillThread(); }
+
+ private:
+  ContextPool* pool_;
+};
+
+
+ContextPool::ContextPool(v8::Isolate* isolate,
+                         const v8::ContextPool::Options& options,
+                         v8::Handle<v8::ObjectTemplate> global_template,
+                         v8::ExtensionConfiguration* extensions)
+    : isolate_(isolate),
+      options_(options),
+      extensions_(extensions),
+      mutex_(OS::CreateMutex()),
+      contexts_(options.size),
+      recycled_globals_(0),
+      thread_(NULL),
+      wakeup_(NULL),
+      keep_going_(true),
+      active_(false) {
+  if (!global_template.IsEmpty()) {
+    global_template_ = v8::Persistent<v8::ObjectTemplate>::New(global_template);
+  }
+  if (options_.background_refill) {
+    ASSERT(v8::Locker::IsActive());
+    wakeup_ = OS::CreateSemaphore(1);
+    thread_ = new RefillThread(this);
+    thread_->Start();
+  }
+}
+
+
+ContextPool::~ContextPool() {
+  if (thread_ != NULL) {
+    keep_going_ = false;
+    wakeup_->Signal();
+    {
+      // The refill thread may be waiting for the lock held by the caller.
+      v8::Unlocker unlocker(isolate_);
+      thread_->Join();
+    }
+    delete thread_;
+    delete wakeup_;
+  }
+  for (int i = 0; i < contexts_.length(); i++) {
+    contexts_[i].Dispose();
+  }
+  for (int i = 0; i < recycled_globals_.length(); i++) {
+    recycled_globals_[i].Dispose();
+  }
+  global_template_.Dispose();
+  delete mutex_;
+}
+
+
+v8::Persistent<v8::Context> ContextPool::NewContext() {
+  v8::HandleScope scope;
+  v8::Local<v8::Value> global;
+  {
+    ScopedLock lock(mutex_);
+    if (!recycled_globals_.is_empty()) {
+      v8::Persistent<v8::Value> recycled = recycled_globals_.RemoveLast();
+      global = v8::Local<v8::Value>::New(recycled);
+      recycled.Dispose();
+    }
+  }
+  return v8::Context::New(extensions_, global_template_, global);
+}
+
+
+v8::Persistent<v8::Context> ContextPool::Acquire() {
+  active_ = true;
+  v8::Persistent<v8::Context> context;
+  {
+    ScopedLock lock(mutex_);
+    if (!contexts_.is_empty()) context = contexts_.RemoveLast();
+  }
+  if (thread_ != NULL) wakeup_->Signal();
+  if (context.IsEmpty()) context = NewContext();
+  return context;
+}
+
+
+void ContextPool::Release(v8::Persistent<v8::Context> context,
+                          v8::ContextPool::ReleaseMode mode) {
+  active_ = true;
+  if (mode == v8::ContextPool::kRecycle) {
+    v8::HandleScope scope;
+    v8::Local<v8::Object> global = context->Global();
+    context->DetachGlobal();
+    ScopedLock lock(mutex_);
+    // Only keep as many globals as the pool can use.
+    if (contexts_.length() + recycled_globals_.length() < options_.size) {
+      recycled_globals_.Add(v8::Persistent<v8::Value>::New(global));
+    }
+  }
+  context.Dispose();
+  v8::V8::ContextDisposedNotification();
+  if (thread_ != NULL) wakeup_->Signal();
+}
+
+
+void ContextPool::Refill() {
+  while (AvailableCount() < options_.size) {
+    v8::Persistent<v8::Context> context = NewContext();
+    if (context.IsEmpty()) return;
+    ScopedLock lock(mutex_);
+    contexts_.Add(context);
+  }
+}
+
+
+int ContextPool::AvailableCount() {
+  ScopedLock lock(mutex_);
+  return contexts_.length();
+}
+
+
+void ContextPool::RunRefillThread() {
+  const int timeout = options_.idle_notification_ms * 1000;
+  while (keep_going_) {
+    bool woken = true;
+    if (timeout > 0) {
+      woken = wakeup_->Wait(timeout);
+    } else {
+      wakeup_->Wait();
+    }
+    if (!keep_going_) break;
+    if (!woken && !active_) continue;
+    v8::Locker locker(isolate_);
+    v8::Isolate::Scope isolate_scope(isolate_);
+    if (woken) {
+      Refill();
+    } else {
+      active_ = false;
+      v8::V8::IdleNotification();
+    }
+  }
+}
+
+} }  // namespace v8::internal
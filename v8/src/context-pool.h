@@ -0,0 +1,86 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_CONTEXT_POOL_H_
+#define V8_CONTEXT_POOL_H_
+
+#include "../include/v8.h"
+
+#include "allocation.h"
+#include "list.h"
+#include "platform.h"
+
+namespace v8 {
+namespace internal {
+
+// Backs v8::ContextPool.  The context lists are guarded by mutex_ so that
+// AvailableCount can be called without the isolate lock.  Everything that
+// touches the heap runs with the isolate locked and entered.
+class ContextPool : public Malloced {
+ public:
+  ContextPool(v8::Isolate* isolate,
+              const v8::ContextPool::Options& options,
+              v8::Handle<v8::ObjectTemplate> global_template,
+              v8::ExtensionConfiguration* extensions);
+  ~ContextPool();
+
+  v8::Persistent<v8::Context> Acquire();
+  void Release(v8::Persistent<v8::Context> context,
+               v8::ContextPool::ReleaseMode mode);
+  void Refill();
+  int AvailableCount();
+
+ private:
+  class RefillThread;
+
+  // Creates a context, reusing a recycled global proxy if there is one.
+  v8::Persistent<v8::Context> NewContext();
+
+  // Body of the refill thread.
+  void RunRefillThread();
+
+  v8::Isolate* isolate_;
+  v8::ContextPool::Options options_;
+  v8::Persistent<v8::ObjectTemplate> global_template_;
+  v8::ExtensionConfiguration* extensions_;
+
+  Mutex* mutex_;
+  List<v8::Persistent<v8::Context> > contexts_;
+  List<v8::Persistent<v8::Value> > recycled_globals_;
+
+  RefillThread* thread_;
+  Semaphore* wakeup_;
+  volatile bool keep_going_;
+  // Set by Acquire and Release, cleared when an idle notification is sent.
+  volatile bool active_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContextPool);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_CONTEXT_POOL_H_
@@ -30,6 +30,7 @@
 #include <limits.h>
 
 #include "conversions-inl.h"
+#include "char-predicates-inl.h"
 #include "dtoa.h"
 #include "strtod.h"
 #include "utils.h"
@@ -41,6 +42,8 @@ namespace internal {
 double StringToDouble(UnicodeCache* unicode_cache,
                       const char* str, int flags, double empty_string_val) {
   const char* end = str + StrLength(str);
+  double result;
+  if (FastAsciiStringToDouble(str, end, &result)) return result;
   return InternalStringToDouble(unicode_cache, str, end, flags,
                                 empty_string_val);
 }
@@ -51,6 +54,8 @@ double StringToDouble(UnicodeCache* unicode_cache,
                       int flags,
                       double empty_string_val) {
   const char* end = str.start() + str.length();
+  double result;
+  if (FastAsciiStringToDouble(str.start(), end, &result)) return result;
   return InternalStringToDouble(unicode_cache, str.start(), end, flags,
                                 empty_string_val);
 }
@@ -65,12 +70,133 @@ double StringToDouble(UnicodeCache* unicode_cache,
 }
 
 
+// Reads the eight characters at current as decimal digits into *value.
+// Returns false if any of them is not a digit. The characters are loaded
+// as one little-endian word, as on all of V8's targets.
+static inline bool ReadEightDigits(const char* current, uint64_t* value) {
+  uint64_t chunk;
+  memcpy(&chunk, current, sizeof(chunk));
+  // Every byte is a digit iff its high nibble is 3 and adding 6 to it does
+  // not carry out of its low nibble.
+  const uint64_t kHighNibbles = V8_2PART_UINT64_C(0xf0f0f0f0, f0f0f0f0);
+  const uint64_t kDigitHighNibbles = V8_2PART_UINT64_C(0x30303030, 30303030);
+  if ((chunk & kHighNibbles) != kDigitHighNibbles ||
+      ((chunk + V8_2PART_UINT64_C(0x06060606, 06060606)) & kHighNibbles) !=
+          kDigitHighNibbles) {
+    return false;
+  }
+  // Combine adjacent digits, then pairs and then quads of digits. The
+  // first character is in the low byte and is the most significant digit.
+  chunk -= kDigitHighNibbles;
+  chunk = (chunk * 10 + (chunk >> 8)) & V8_2PART_UINT64_C(0x00ff00ff, 00ff00ff);
+  chunk = (chunk * 100 + (chunk >> 16)) &
+          V8_2PART_UINT64_C(0x0000ffff, 0000ffff);
+  chunk = (chunk * 10000 + (chunk >> 32)) & 0xffffffffu;
+  *value = chunk;
+  return true;
+}
+
+
+bool FastAsciiStringToDouble(const char* current,
+                             const char* end,
+                             double* result) {
+  // With more digits the value need not be an integer that fits into a
+  // double exactly.
+  static const int kMaxDigits = 15;
+  static const double kPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+  };
+
+  bool negative = false;
+  if (current != end && *current == '-') {
+    negative = true;
+    ++current;
+  }
+  // Leave out leading zeros, which may start an octal literal, and
+  // anything but digits, such as whitespace, signs, hex and exponents.
+  if (current == end || !IsDecimalDigit(*current)) return false;
+  if (*current == '0' && current + 1 != end && current[1] != '.') {
+    return false;
+  }
+
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int fraction_digits = 0;
+  bool seen_point = false;
+  while (current != end) {
+    uint64_t eight_digits;
+    if (end - current >= 8 && digits + 8 <= kMaxDigits &&
+        ReadEightDigits(current, &eight_digits)) {
+      mantissa = mantissa * 100000000 + eight_digits;
+      digits += 8;
+      if (seen_point) fraction_digits += 8;
+      current += 8;
+      continue;
+    }
+    char c = *current;
+    if (IsDecimalDigit(c)) {
+      if (digits == kMaxDigits) return false;
+      mantissa = mantissa * 10 + (c - '0');
+      digits++;
+      if (seen_point) fraction_digits++;
+    } else if (c == '.' && !seen_point) {
+      seen_point = true;
+      // Require a digit after the point.
+      if (current + 1 == end || !IsDecimalDigit(current[1])) return false;
+    } else {
+      return false;
+    }
+    ++current;
+  }
+
+  double value = static_cast<double>(mantissa);
+  if (fraction_digits > 0) {
+#if (defined(V8_TARGET_ARCH_IA32) || defined(USE_SIMULATOR)) && !defined(WIN32)
+    // The division may round twice on the 80-bit x87 stack, see
+    // DoubleStrtod in strtod.cc.
+    return false;
+#endif
+    // Both operands are exact, so IEEE division rounds correctly.
+    value /= kPowersOfTen[fraction_digits];
+  }
+  *result = negative ? -value : value;
+  return true;
+}
+
+
+// Formats an integer whose magnitude is below 2^63 by building the
+// string backwards from the end of the buffer.
+static const char* Int64ToCString(int64_t n, Vector<char> buffer) {
+  bool negative = n < 0;
+  uint64_t magnitude = static_cast<uint64_t>(negative ? -n : n);
+  int i = buffer.length();
+  buffer[--i] = '\0';
+  do {
+    buffer[--i] = '0' + static_cast<char>(magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (negative) buffer[--i] = '-';
+  return buffer.start() + i;
+}
+
+
 const char* DoubleToCString(double v, Vector<char> buffer) {
   switch (fpclassify(v)) {
     case FP_NAN: return "NaN";
     case FP_INFINITE: return (v < 0.0 ? "-Infinity" : "Infinity");
     case FP_ZERO: return "0";
     default: {
+      // Integers below 2^53 are exact, so their shortest representation is
+      // their decimal digits, which need no call to DoubleToAscii.
+      const double kMaxExactInteger = 9007199254740992.0;  // 2^53
+      if (-kMaxExactInteger < v && v < kMaxExactInteger) {
+        int64_t integer = static_cast<int64_t>(v);
+        if (static_cast<double>(integer) == v) {
+          return Int64ToCString(integer, buffer);
+        }
+      }
+
       SimpleStringBuilder builder(buffer.start(), buffer.length());
       int decimal_point;
       int sign;
@@ -125,6 +125,14 @@ double StringToDouble(UnicodeCache* unicode_cache,
                       int flags,
                       double empty_string_val = 0);
 
+// Converts a plain decimal number of the form [-]digits[.digits] with at
+// most 15 digits, which is the common case when parsing numeric data, by
+// reading eight digits at a time. Returns false without touching *result
+// for any other string, which then needs the general conversion above.
+bool FastAsciiStringToDouble(const char* current,
+                             const char* end,
+                             double* result);
+
 const int kDoubleToCStringMinBufferSize = 100;
 
 // Converts a double to a string value according to ECMA-262 9.8.1.
@@ -34,10 +34,102 @@
 namespace v8 {
 namespace internal {
 
+CounterBlock::CounterBlock(Layout* layout, OS::MemoryMappedFile* file)
+    : layout_(layout),
+      file_(file),
+      slots_map_(Match) {
+  STATIC_ASSERT(sizeof(Slot) == 64);
+}
+
+
+CounterBlock::~CounterBlock() {
+  if (file_ != NULL) {
+    delete file_;
+  } else {
+    DeleteArray(reinterpret_cast<char*>(layout_));
+  }
+}
+
+
+CounterBlock* CounterBlock::New(const char* file_name) {
+  char* memory = NewArray<char>(sizeof(Layout));
+  memset(memory, 0, sizeof(Layout));
+  Layout* layout = reinterpret_cast<Layout*>(memory);
+  layout->magic_number = kMagicNumber;
+  layout->max_counters = kMaxCounters;
+  layout->max_name_size = kMaxNameSize;
+  layout->counters_in_use = 0;
+  if (file_name == NULL) return new CounterBlock(layout, NULL);
+
+  OS::MemoryMappedFile* file =
+      OS::MemoryMappedFile::create(file_name, sizeof(Layout), memory);
+  DeleteArray(memory);
+  if (file == NULL || file->memory() == NULL) {
+    delete file;
+    return NULL;
+  }
+  return new CounterBlock(reinterpret_cast<Layout*>(file->memory()), file);
+}
+
+
+int* CounterBlock::Lookup(const char* name) {
+  uint32_t hash = Hash(name);
+  HashMap::Entry* entry =
+      slots_map_.Lookup(const_cast<char*>(name), hash, false);
+  if (entry != NULL) {
+    intptr_t index = reinterpret_cast<intptr_t>(entry->value);
+    return &layout_->slots[index].value;
+  }
+  if (layout_->counters_in_use == kMaxCounters) return NULL;
+
+  int index = layout_->counters_in_use;
+  Slot* slot = &layout_->slots[index];
+  slot->value = 0;
+  OS::StrNCpy(Vector<char>(slot->name, kMaxNameSize), name, kMaxNameSize);
+  slot->name[kMaxNameSize - 1] = '\0';
+  // Publish the slot to readers of the block only after it is named.
+  layout_->counters_in_use = index + 1;
+  entry = slots_map_.Lookup(slot->name, hash, true);
+  entry->value = reinterpret_cast<void*>(static_cast<intptr_t>(index));
+  return &slot->value;
+}
+
+
+uint32_t CounterBlock::Hash(const char* name) {
+  // Only the stored prefix of a name takes part in hashing and matching.
+  uint32_t hash = 0;
+  for (int i = 0; i < kMaxNameSize - 1 && name[i] != '\0'; i++) {
+    hash += hash << 5;
+    hash += static_cast<unsigned char>(name[i]);
+  }
+  return hash;
+}
+
+
+bool CounterBlock::Match(void* key1, void* key2) {
+  return strncmp(static_cast<const char*>(key1),
+                 static_cast<const char*>(key2),
+                 kMaxNameSize - 1) == 0;
+}
+
+
 StatsTable::StatsTable()
     : lookup_function_(NULL),
       create_histogram_function_(NULL),
-      add_histogram_sample_function_(NULL) {}
+      add_histogram_sample_function_(NULL),
+      counter_block_(NULL) {}
+
+
+StatsTable::~StatsTable() {
+  delete counter_block_;
+}
+
+
+bool StatsTable::EnableCounterBlock(const char* file_name) {
+  if (counter_block_ != NULL) return true;
+  counter_block_ = CounterBlock::New(file_name);
+  return counter_block_ != NULL;
+}
 
 
 int* StatsCounter::FindLocationInStatsTable() const {
@@ -90,4 +182,104 @@ void* HistogramTimer::CreateHistogram() const {
       CreateHistogram(name_, 0, 10000, 50);
 }
 
+
+void Histogram::AddSample(int sample) {
+  if (GetHistogram() != NULL) {
+    Isolate::Current()->stats_table()->AddHistogramSample(histogram_, sample);
+  }
+}
+
+
+void* Histogram::CreateHistogram() const {
+  return Isolate::Current()->stats_table()->
+      CreateHistogram(name_, min_, max_, num_buckets_);
+}
+
+
+RuntimeCallStats::RuntimeCallStats()
+    : entry_indices_(NameEquals),
+      entries_(0),
+      current_timer_(NULL) {}
+
+
+void RuntimeCallStats::Reset() {
+  for (int i = 0; i < entries_.length(); i++) {
+    entries_[i].count = 0;
+    entries_[i].time = 0;
+  }
+}
+
+
+static int CompareEntriesByTime(const RuntimeCallStats::Entry* a,
+                                const RuntimeCallStats::Entry* b) {
+  if (a->time != b->time) return a->time > b->time ? -1 : 1;
+  return b->count - a->count;
+}
+
+
+void RuntimeCallStats::GetSortedEntries(List<Entry>* result) {
+  for (int i = 0; i < entries_.length(); i++) {
+    if (entries_[i].count > 0) result->Add(entries_[i]);
+  }
+  result->Sort(CompareEntriesByTime);
+}
+
+
+void RuntimeCallStats::Print(FILE* out) {
+  List<Entry> entries;
+  GetSortedEntries(&entries);
+  int64_t total_time = 0;
+  int total_count = 0;
+  for (int i = 0; i < entries.length(); i++) {
+    total_time += entries[i].time;
+    total_count += entries[i].count;
+  }
+  fprintf(out, "%-40s %12s %7s %10s\n", "Runtime function", "Time (ms)",
+          "Time", "Count");
+  for (int i = 0; i < entries.length(); i++) {
+    const Entry& entry = entries[i];
+    double percent = total_time == 0 ? 0.0 :
+        100.0 * static_cast<double>(entry.time) / total_time;
+    fprintf(out, "%-40s %12.3f %6.2f%% %10d\n", entry.name,
+            static_cast<double>(entry.time) / 1000, percent, entry.count);
+  }
+  fprintf(out, "%-40s %12.3f %7s %10d\n", "Total",
+          static_cast<double>(total_time) / 1000, "", total_count);
+}
+
+
+int RuntimeCallStats::EntryIndex(const char* name) {
+  void* key = const_cast<char*>(name);
+  HashMap::Entry* map_entry =
+      entry_indices_.Lookup(key, ComputePointerHash(key), true);
+  if (map_entry->value == NULL) {
+    Entry entry = { name, 0, 0 };
+    entries_.Add(entry);
+    // Indices are stored biased by one to tell them from a new entry.
+    map_entry->value = reinterpret_cast<void*>(entries_.length());
+  }
+  return static_cast<int>(reinterpret_cast<intptr_t>(map_entry->value)) - 1;
+}
+
+
+RuntimeCallTimerScope::RuntimeCallTimerScope(Isolate* isolate,
+                                             const char* name)
+    : stats_(isolate->runtime_call_stats()),
+      parent_(stats_->current_timer_),
+      entry_index_(stats_->EntryIndex(name)),
+      start_time_(OS::Ticks()),
+      nested_time_(0) {
+  stats_->current_timer_ = this;
+}
+
+
+RuntimeCallTimerScope::~RuntimeCallTimerScope() {
+  int64_t elapsed = OS::Ticks() - start_time_;
+  RuntimeCallStats::Entry* entry = &stats_->entries_[entry_index_];
+  entry->count++;
+  entry->time += elapsed - nested_time_;
+  if (parent_ != NULL) parent_->nested_time_ += elapsed;
+  stats_->current_timer_ = parent_;
+}
+
 } }  // namespace v8::internal
@@ -30,10 +30,68 @@
 
 #include "../include/v8.h"
 #include "allocation.h"
+#include "hashmap.h"
+#include "list.h"
+#include "platform.h"
 
 namespace v8 {
 namespace internal {
 
+// A CounterBlock holds the values of named counters for one isolate.  It
+// is used by the StatsTable when no counter lookup function has been
+// registered, so every stats counter can be read by name without any help
+// from the embedder.  The layout is the one d8 uses for --map-counters, so
+// tools/stats-viewer.py can watch a block backed by a memory-mapped file
+// while V8 is running.  Each counter occupies a whole cache line, which
+// keeps counters incremented from generated code from sharing a line.
+class CounterBlock : public Malloced {
+ public:
+  static const int kMaxCounters = 512;
+  static const int kMaxNameSize = 60;
+
+  // Creates a counter block.  If file_name is non-NULL the block lives
+  // in a memory-mapped file of that name.  Returns NULL if the file could
+  // not be mapped.
+  static CounterBlock* New(const char* file_name);
+  ~CounterBlock();
+
+  // Returns the location of the counter with the given name, binding a
+  // free slot to the name on first use.  Returns NULL if the block is full.
+  int* Lookup(const char* name);
+
+  int counters_in_use() const { return layout_->counters_in_use; }
+  const char* name(int index) const { return layout_->slots[index].name; }
+  int value(int index) const { return layout_->slots[index].value; }
+
+ private:
+  static const uint32_t kMagicNumber = 0xDEADFACE;
+
+  struct Slot {
+    int32_t value;
+    char name[kMaxNameSize];
+  };
+
+  struct Layout {
+    uint32_t magic_number;
+    uint32_t max_counters;
+    uint32_t max_name_size;
+    uint32_t counters_in_use;
+    Slot slots[kMaxCounters];
+  };
+
+  CounterBlock(Layout* layout, OS::MemoryMappedFile* file);
+
+  static uint32_t Hash(const char* name);
+  static bool Match(void* key1, void* key2);
+
+  Layout* layout_;
+  OS::MemoryMappedFile* file_;
+  // Maps counter names (owned by the slots) to slot indices.
+  HashMap slots_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(CounterBlock);
+};
+
 // StatsCounters is an interface for plugging into external
 // counters for monitoring.  Counters can be looked up and
 // manipulated by name.
@@ -62,17 +120,31 @@ class StatsTable {
     return lookup_function_ != NULL;
   }
 
+  bool HasCreateHistogramFunction() const {
+    return create_histogram_function_ != NULL;
+  }
+
   // Lookup the location of a counter by name.  If the lookup
   // is successful, returns a non-NULL pointer for writing the
   // value of the counter.  Each thread calling this function
   // may receive a different location to store it's counter.
   // The return value must not be cached and re-used across
   // threads, although a single thread is free to cache it.
+  // Without a lookup function counters are kept in the counter block,
+  // if one has been enabled.
   int* FindLocation(const char* name) {
-    if (!lookup_function_) return NULL;
-    return lookup_function_(name);
+    if (lookup_function_ != NULL) return lookup_function_(name);
+    if (counter_block_ != NULL) return counter_block_->Lookup(name);
+    return NULL;
   }
 
+  // Keep counters in a CounterBlock, backed by the given memory-mapped
+  // file if file_name is non-NULL.  Returns false if the block could not
+  // be created.
+  bool EnableCounterBlock(const char* file_name);
+
+  CounterBlock* counter_block() const { return counter_block_; }
+
   // Create a histogram by name. If the create is successful,
   // returns a non-NULL pointer for use with AddHistogramSample
   // function. min and max define the expected minimum and maximum
@@ -95,10 +167,12 @@ class StatsTable {
 
  private:
   StatsTable();
+  ~StatsTable();
 
   CounterLookupCallback lookup_function_;
   CreateHistogramCallback create_histogram_function_;
   AddHistogramSampleCallback add_histogram_sample_function_;
+  CounterBlock* counter_block_;
 
   friend class Isolate;
 
@@ -234,6 +308,34 @@ struct HistogramTimer {
   void* CreateHistogram() const;
 };
 
+// A Histogram records arbitrary samples, such as sizes or times that
+// were measured elsewhere. Like HistogramTimer it is POD initialized and
+// creates its histogram on first use.
+struct Histogram {
+  const char* name_;
+  int min_;
+  int max_;
+  int num_buckets_;
+  void* histogram_;
+  bool lookup_done_;
+
+  // Add a single sample to the histogram.
+  void AddSample(int sample);
+
+ protected:
+  // Returns the handle to the histogram.
+  void* GetHistogram() {
+    if (!lookup_done_) {
+      lookup_done_ = true;
+      histogram_ = CreateHistogram();
+    }
+    return histogram_;
+  }
+
+ private:
+  void* CreateHistogram() const;
+};
+
 // Helper class for scoping a HistogramTimer.
 class HistogramTimerScope BASE_EMBEDDED {
  public:
@@ -249,6 +351,65 @@ class HistogramTimerScope BASE_EMBEDDED {
 };
 
 
+class RuntimeCallTimerScope;
+
+// RuntimeCallStats counts the calls of runtime functions, C++ builtins
+// and IC misses of an isolate and the time spent in them with
+// --runtime-call-stats.  Entries are keyed by the address of their name,
+// which is a string literal, so no strings are compared on a call.
+class RuntimeCallStats {
+ public:
+  struct Entry {
+    const char* name;
+    int count;
+    // Microseconds spent in the function itself, excluding nested
+    // runtime calls.
+    int64_t time;
+  };
+
+  RuntimeCallStats();
+
+  // Sets the counts and times of all entries to zero.
+  void Reset();
+
+  // Adds the entries that have been called since the last Reset to
+  // result, sorted by descending time.
+  void GetSortedEntries(List<Entry>* result);
+
+  // Prints the entries sorted by time.
+  void Print(FILE* out);
+
+ private:
+  int EntryIndex(const char* name);
+
+  static bool NameEquals(void* name1, void* name2) { return name1 == name2; }
+
+  HashMap entry_indices_;
+  List<Entry> entries_;
+  RuntimeCallTimerScope* current_timer_;
+
+  friend class RuntimeCallTimerScope;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeCallStats);
+};
+
+
+// Times a call for the RuntimeCallStats of an isolate.  Scopes nest, the
+// time of an inner scope is not counted for the outer one.
+class RuntimeCallTimerScope BASE_EMBEDDED {
+ public:
+  RuntimeCallTimerScope(Isolate* isolate, const char* name);
+  ~RuntimeCallTimerScope();
+
+ private:
+  RuntimeCallStats* stats_;
+  RuntimeCallTimerScope* parent_;
+  int entry_index_;
+  int64_t start_time_;
+  int64_t nested_time_;
+};
+
+
 } }  // namespace v8::internal
 
 #endif  // V8_COUNTERS_H_
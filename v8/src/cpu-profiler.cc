@@ -137,6 +137,18 @@ void ProfilerEventsProcessor::CodeMoveEvent(Address from, Address to) {
 }
 
 
+void ProfilerEventsProcessor::CodeDisableOptEvent(Address start,
+                                                  String* bailout_reason) {
+  CodeEventsContainer evt_rec;
+  CodeDisableOptEventRecord* rec = &evt_rec.CodeDisableOptEventRecord_;
+  rec->type = CodeEventRecord::CODE_DISABLE_OPT;
+  rec->order = ++enqueue_order_;
+  rec->start = start;
+  rec->bailout_reason = generator_->GetName(bailout_reason);
+  events_buffer_.Enqueue(evt_rec);
+}
+
+
 void ProfilerEventsProcessor::SharedFunctionInfoMoveEvent(Address from,
                                                           Address to) {
   CodeEventsContainer evt_rec;
@@ -285,6 +297,22 @@ CpuProfile* CpuProfiler::StopProfiling(Object* security_token, String* title) {
 }
 
 
+bool CpuProfiler::SerializeCurrentProfile(String* title,
+                                          v8::OutputStream* stream) {
+  Isolate* isolate = Isolate::Current();
+  if (!is_profiling(isolate)) return false;
+  CpuProfilesCollection* profiles = isolate->cpu_profiler()->profiles_;
+  // Encode under the profiles lock, then stream without holding it.
+  List<char> buffer;
+  if (!profiles->EncodeCurrentProfileDelta(profiles->GetName(title),
+                                           &buffer)) {
+    return false;
+  }
+  CpuProfileSerializer::Write(buffer, stream);
+  return true;
+}
+
+
 int CpuProfiler::GetProfilesCount() {
   ASSERT(Isolate::Current()->cpu_profiler() != NULL);
   // The count of profiles doesn't depend on a security token.
@@ -381,6 +409,7 @@ void CpuProfiler::CodeCreateEvent(Logger::LogEventsAndTags tag,
       code->address(),
       code->ExecutableSize(),
       shared->address());
+  if (shared->optimization_disabled()) CodeDisableOptEvent(code, shared);
 }
 
 
@@ -396,6 +425,7 @@ void CpuProfiler::CodeCreateEvent(Logger::LogEventsAndTags tag,
       code->address(),
       code->ExecutableSize(),
       shared->address());
+  if (shared->optimization_disabled()) CodeDisableOptEvent(code, shared);
 }
 
 
@@ -418,6 +448,14 @@ void CpuProfiler::CodeDeleteEvent(Address from) {
 }
 
 
+void CpuProfiler::CodeDisableOptEvent(Code* code, SharedFunctionInfo* shared) {
+  Object* reason = shared->last_bailout_reason();
+  if (!reason->IsString()) return;
+  Isolate::Current()->cpu_profiler()->processor_->CodeDisableOptEvent(
+      code->address(), String::cast(reason));
+}
+
+
 void CpuProfiler::SharedFunctionInfoMoveEvent(Address from, Address to) {
   CpuProfiler* profiler = Isolate::Current()->cpu_profiler();
   profiler->processor_->SharedFunctionInfoMoveEvent(from, to);
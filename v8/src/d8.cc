@@ -117,6 +117,8 @@ i::OS::MemoryMappedFile* Shell::counters_file_ = NULL;
 CounterCollection Shell::local_counters_;
 CounterCollection* Shell::counters_ = &local_counters_;
 i::Mutex* Shell::context_mutex_(i::OS::CreateMutex());
+i::Mutex* Shell::workers_mutex_(i::OS::CreateMutex());
+i::List<Worker*> Shell::workers_;
 Persistent<Context> Shell::utility_context_;
 LineEditor* Shell::console = NULL;
 #endif  // V8_SHARED
@@ -321,11 +323,9 @@ Handle<Value> Shell::CreateExternalArray(const Arguments& args,
     return ThrowException(String::New("Memory allocation failed."));
   }
   Handle<Object> array = Object::New();
-  Persistent<Object> persistent_array = Persistent<Object>::New(array);
-  persistent_array.MakeWeak(data, ExternalArrayWeakCallback);
-  persistent_array.MarkIndependent();
   array->SetIndexedPropertiesToExternalArrayData(data, type,
                                                  static_cast<int>(length));
+  MakeExternalArrayWeak(array);
   array->Set(String::New("length"),
              Int32::New(static_cast<int32_t>(length)), ReadOnly);
   array->Set(String::New("BYTES_PER_ELEMENT"),
@@ -334,12 +334,233 @@ Handle<Value> Shell::CreateExternalArray(const Arguments& args,
 }
 
 
+void Shell::MakeExternalArrayWeak(Handle<Object> array) {
+  Persistent<Object> persistent_array = Persistent<Object>::New(array);
+  persistent_array.MakeWeak(NULL, ExternalArrayWeakCallback);
+  persistent_array.MarkIndependent();
+}
+
+
 void Shell::ExternalArrayWeakCallback(Persistent<Value> object, void* data) {
-  free(data);
+  // Free the current backing store, which is NULL if it was transferred to
+  // another isolate.
+  free(Handle<Object>::Cast(object)->GetIndexedPropertiesExternalArrayData());
   object.Dispose();
 }
 
 
+#ifndef V8_SHARED
+class ShellCloneDelegate : public StructuredClone::Delegate {
+ public:
+  virtual void* AllocateExternalArrayData(size_t size) {
+    return malloc(size);
+  }
+
+  virtual void FreeExternalArrayData(void* data) {
+    free(data);
+  }
+
+  virtual void ExternalArrayCreated(Handle<Object> object, void* data) {
+    Shell::MakeExternalArrayWeak(object);
+  }
+};
+
+
+StructuredClone::Delegate* Shell::clone_delegate() {
+  static ShellCloneDelegate delegate;
+  return &delegate;
+}
+
+
+CloneQueue::~CloneQueue() {
+  for (int i = 0; i < queue_.length(); i++) delete queue_[i];
+  delete semaphore_;
+  delete mutex_;
+}
+
+
+void CloneQueue::Enqueue(StructuredClone* data) {
+  {
+    i::ScopedLock lock(mutex_);
+    queue_.Add(data);
+  }
+  semaphore_->Signal();
+}
+
+
+StructuredClone* CloneQueue::Dequeue() {
+  semaphore_->Wait();
+  i::ScopedLock lock(mutex_);
+  StructuredClone* data = queue_[0];
+  queue_.Remove(0);
+  return data;
+}
+
+
+Worker::~Worker() {
+  Terminate();
+  i::DeleteArray(script_);
+}
+
+
+void Worker::StartExecuteInThread(const char* script) {
+  script_ = i::StrDup(script);
+  thread_ = new WorkerThread(this);
+  thread_->Start();
+}
+
+
+StructuredClone* Worker::GetMessage() {
+  if (finished_) return NULL;
+  StructuredClone* data = out_queue_.Dequeue();
+  if (data == NULL) finished_ = true;
+  return data;
+}
+
+
+void Worker::Terminate() {
+  if (thread_ == NULL) return;
+  in_queue_.Enqueue(NULL);
+  thread_->Join();
+  delete thread_;
+  thread_ = NULL;
+}
+
+
+void Worker::ExecuteInThread() {
+  Isolate* isolate = Isolate::New();
+  {
+    Isolate::Scope isolate_scope(isolate);
+    Locker lock(isolate);
+    HandleScope scope;
+    Persistent<Context> context = Shell::CreateEvaluationContext();
+    {
+      Context::Scope context_scope(context);
+      Handle<Object> global = context->Global();
+      global->Set(String::New("postMessage"),
+                  FunctionTemplate::New(PostMessageOut,
+                                        External::New(this))->GetFunction());
+      Shell::ExecuteString(String::New(script_), String::New("(worker)"),
+                           false, true);
+      Handle<Value> onmessage = global->Get(String::New("onmessage"));
+      if (onmessage->IsFunction()) {
+        Handle<Function> handler = Handle<Function>::Cast(onmessage);
+        // Handle messages until the parent terminates the worker.
+        for (StructuredClone* data = in_queue_.Dequeue();
+             data != NULL;
+             data = in_queue_.Dequeue()) {
+          HandleScope message_scope;
+          TryCatch try_catch;
+          Handle<Value> message = data->Deserialize();
+          delete data;
+          if (!message.IsEmpty()) {
+            Handle<Value> argv[] = { message };
+            handler->Call(global, 1, argv);
+          }
+          if (try_catch.HasCaught()) Shell::ReportException(&try_catch);
+        }
+      }
+    }
+    context.Dispose();
+  }
+  isolate->Dispose();
+  // Tell the parent that no more messages will follow.
+  out_queue_.Enqueue(NULL);
+}
+
+
+Handle<Value> Worker::PostMessageOut(const Arguments& args) {
+  Worker* worker = static_cast<Worker*>(External::Unwrap(args.Data()));
+  Handle<Array> transfer;
+  if (args.Length() > 1 && args[1]->IsArray()) {
+    transfer = Handle<Array>::Cast(args[1]);
+  }
+  StructuredClone* data =
+      StructuredClone::Serialize(args[0], transfer, Shell::clone_delegate());
+  if (data == NULL) return Handle<Value>();
+  worker->out_queue_.Enqueue(data);
+  return Undefined();
+}
+
+
+static Worker* GetWorker(const Arguments& args) {
+  Handle<Object> holder = args.Holder();
+  if (holder->InternalFieldCount() < 1) return NULL;
+  return static_cast<Worker*>(holder->GetPointerFromInternalField(0));
+}
+
+
+Handle<Value> Shell::WorkerNew(const Arguments& args) {
+  if (!args.IsConstructCall()) {
+    return ThrowException(String::New("Worker must be constructed with new"));
+  }
+  if (args.Length() < 1 || !args[0]->IsString()) {
+    return ThrowException(String::New("Worker needs a script source"));
+  }
+  String::Utf8Value script(args[0]);
+  Worker* worker = new Worker();
+  {
+    i::ScopedLock lock(workers_mutex_);
+    workers_.Add(worker);
+  }
+  args.This()->SetPointerInInternalField(0, worker);
+  worker->StartExecuteInThread(*script);
+  return Undefined();
+}
+
+
+Handle<Value> Shell::WorkerPostMessage(const Arguments& args) {
+  Worker* worker = GetWorker(args);
+  if (worker == NULL) return ThrowException(String::New("Not a worker"));
+  Handle<Array> transfer;
+  if (args.Length() > 1 && args[1]->IsArray()) {
+    transfer = Handle<Array>::Cast(args[1]);
+  }
+  StructuredClone* data =
+      StructuredClone::Serialize(args[0], transfer, clone_delegate());
+  if (data == NULL) return Handle<Value>();
+  worker->PostMessage(data);
+  return Undefined();
+}
+
+
+Handle<Value> Shell::WorkerGetMessage(const Arguments& args) {
+  Worker* worker = GetWorker(args);
+  if (worker == NULL) return ThrowException(String::New("Not a worker"));
+  StructuredClone* data;
+  Isolate* isolate = Isolate::GetCurrent();
+  if (Locker::IsLocked(isolate)) {
+    // Let other threads use this isolate while waiting.
+    Unlocker unlocker(isolate);
+    data = worker->GetMessage();
+  } else {
+    data = worker->GetMessage();
+  }
+  if (data == NULL) return Undefined();
+  Local<Value> message = data->Deserialize();
+  delete data;
+  return message;
+}
+
+
+Handle<Value> Shell::WorkerTerminate(const Arguments& args) {
+  Worker* worker = GetWorker(args);
+  if (worker == NULL) return ThrowException(String::New("Not a worker"));
+  worker->Terminate();
+  return Undefined();
+}
+
+
+void Shell::CleanupWorkers() {
+  i::ScopedLock lock(workers_mutex_);
+  for (int i = 0; i < workers_.length(); i++) {
+    delete workers_[i];
+  }
+  workers_.Clear();
+}
+#endif  // V8_SHARED
+
+
 Handle<Value> Shell::Int8Array(const Arguments& args) {
   return CreateExternalArray(args, v8::kExternalByteArray, sizeof(int8_t));
 }
@@ -700,6 +921,20 @@ Handle<ObjectTemplate> Shell::CreateGlobalTemplate() {
   global_template->Set(String::New("PixelArray"),
                        FunctionTemplate::New(PixelArray));
 
+#ifndef V8_SHARED
+  Handle<FunctionTemplate> worker_template = FunctionTemplate::New(WorkerNew);
+  worker_template->InstanceTemplate()->SetInternalFieldCount(1);
+  Handle<ObjectTemplate> worker_prototype =
+      worker_template->PrototypeTemplate();
+  worker_prototype->Set(String::New("postMessage"),
+                        FunctionTemplate::New(WorkerPostMessage));
+  worker_prototype->Set(String::New("getMessage"),
+                        FunctionTemplate::New(WorkerGetMessage));
+  worker_prototype->Set(String::New("terminate"),
+                        FunctionTemplate::New(WorkerTerminate));
+  global_template->Set(String::New("Worker"), worker_template);
+#endif  // V8_SHARED
+
 #ifdef LIVE_OBJECT_LIST
   global_template->Set(String::New("lol_is_enabled"), True());
 #else
@@ -806,6 +1041,28 @@ int CompareKeys(const void* a, const void* b) {
 }
 
 
+class RuntimeCallStatsPrinter : public RuntimeCallStatsVisitor {
+ public:
+  virtual void VisitRuntimeCall(const char* name, int count, double time_ms) {
+    printf("| %-42s | %11.3f | %11i |\n", name, time_ms, count);
+  }
+};
+
+
+void Shell::PrintRuntimeCallStats() {
+  printf("+--------------------------------------------+-------------+"
+         "-------------+\n");
+  printf("| Runtime function                           | Time (ms)   |"
+         " Count       |\n");
+  printf("+--------------------------------------------+-------------+"
+         "-------------+\n");
+  RuntimeCallStatsPrinter printer;
+  V8::VisitRuntimeCallStats(&printer);
+  printf("+--------------------------------------------+-------------+"
+         "-------------+\n");
+}
+
+
 void Shell::OnExit() {
   if (console != NULL) console->Close();
   if (i::FLAG_dump_counters) {
@@ -1117,6 +1374,270 @@ void SourceGroup::WaitForThread() {
     done_semaphore_->Wait();
   }
 }
+
+
+void ThroughputThread::Run() {
+  Isolate* isolate = Isolate::New();
+  isolate->SetData(this);
+  {
+    Isolate::Scope iscope(isolate);
+    Locker lock(isolate);
+    V8::SetGCEventCallback(OnGCEvent);
+  }
+  ready_->Signal();
+  start_->Wait();
+  for (int i = 0; i < Shell::options.throughput_iterations; i++) {
+    double start = i::OS::TimeCurrentMillis();
+    {
+      Isolate::Scope iscope(isolate);
+      Locker lock(isolate);
+      HandleScope scope;
+      Persistent<Context> context = Shell::CreateEvaluationContext();
+      setup_time_ += i::OS::TimeCurrentMillis() - start;
+      {
+        Context::Scope cscope(context);
+        Shell::options.isolate_sources[0].Execute();
+      }
+      context.Dispose();
+    }
+    double time = i::OS::TimeCurrentMillis() - start;
+    if (iterations_ == 0 || time < min_time_) min_time_ = time;
+    if (iterations_ == 0 || time > max_time_) max_time_ = time;
+    total_time_ += time;
+    iterations_++;
+  }
+  isolate->Dispose();
+}
+
+
+void ThroughputThread::OnGCEvent(const GCEvent& event) {
+  // Called on the thread that owns the isolate.
+  ThroughputThread* thread =
+      static_cast<ThroughputThread*>(Isolate::GetCurrent()->GetData());
+  thread->gc_count_++;
+  thread->gc_pause_time_ += event.pause_time();
+}
+
+
+void ThroughputThread::PrintReportHeader() {
+  printf("%7s %10s %10s %10s %10s %10s %10s %6s %10s\n",
+         "isolate", "iterations", "total ms", "mean ms", "min ms", "max ms",
+         "setup ms", "gcs", "gc ms");
+}
+
+
+void ThroughputThread::PrintReport() const {
+  printf("%7d %10d %10.1f %10.2f %10.2f %10.2f %10.1f %6d %10.1f\n",
+         index_, iterations_, total_time_,
+         iterations_ > 0 ? total_time_ / iterations_ : 0.0,
+         min_time_, max_time_, setup_time_, gc_count_, gc_pause_time_);
+}
+
+
+// Runs the scripts in --throughput isolates at the same time and reports
+// how long each isolate took and how well the runs scaled.  Efficiency is
+// the time the isolates spent running scripts divided by the wall time
+// times the number of isolates, and slowdown compares the mean iteration
+// time with the fastest iteration of any isolate; both show how much the
+// isolates got in each other's way.
+int Shell::RunThroughput() {
+  int count = options.throughput_isolates;
+  i::Semaphore* ready = i::OS::CreateSemaphore(0);
+  i::Semaphore* start = i::OS::CreateSemaphore(0);
+  i::List<ThroughputThread*> threads(count);
+  for (int i = 0; i < count; i++) {
+    ThroughputThread* thread = new ThroughputThread(i, ready, start);
+    thread->Start();
+    threads.Add(thread);
+  }
+  for (int i = 0; i < count; i++) ready->Wait();
+  double start_time = i::OS::TimeCurrentMillis();
+  for (int i = 0; i < count; i++) start->Signal();
+  for (int i = 0; i < count; i++) threads[i]->Join();
+  double wall_time = i::OS::TimeCurrentMillis() - start_time;
+  options.script_executed = true;
+
+  int iterations = 0;
+  int gc_count = 0;
+  double busy_time = 0;
+  double setup_time = 0;
+  double gc_pause_time = 0;
+  double best_time = 0;
+  ThroughputThread::PrintReportHeader();
+  for (int i = 0; i < count; i++) {
+    ThroughputThread* thread = threads[i];
+    thread->PrintReport();
+    iterations += thread->iterations();
+    busy_time += thread->total_time();
+    setup_time += thread->setup_time();
+    gc_count += thread->gc_count();
+    gc_pause_time += thread->gc_pause_time();
+    if (i == 0 || thread->min_time() < best_time) {
+      best_time = thread->min_time();
+    }
+    delete thread;
+  }
+  printf("%d isolates x %d iterations in %.1f ms: %.2f iterations/s\n",
+         count, options.throughput_iterations, wall_time,
+         wall_time > 0 ? iterations * 1000.0 / wall_time : 0.0);
+  printf("gc: %d collections, %.1f ms paused (%.1f%% of run time)\n",
+         gc_count, gc_pause_time,
+         busy_time > 0 ? gc_pause_time * 100.0 / busy_time : 0.0);
+  printf("contention: efficiency %.1f%%, slowdown %.2fx, setup %.1f ms\n",
+         wall_time > 0 ? busy_time * 100.0 / (wall_time * count) : 0.0,
+         best_time > 0 && iterations > 0 ?
+             busy_time / iterations / best_time : 0.0,
+         setup_time);
+
+  delete ready;
+  delete start;
+  return 0;
+}
+
+
+i::List<GCLatencyRecorder::Pause>* GCLatencyRecorder::pauses_ = NULL;
+double GCLatencyRecorder::start_time_ = 0;
+double GCLatencyRecorder::end_time_ = 0;
+
+
+void GCLatencyRecorder::Start() {
+  pauses_ = new i::List<Pause>(256);
+  V8::SetGCEventCallback(OnGCEvent);
+  start_time_ = i::OS::TimeCurrentMillis();
+}
+
+
+void GCLatencyRecorder::Stop() {
+  end_time_ = i::OS::TimeCurrentMillis();
+  V8::SetGCEventCallback(NULL);
+}
+
+
+void GCLatencyRecorder::OnGCEvent(const GCEvent& event) {
+  // Allocating outside the JavaScript heap is fine in the GC event callback.
+  Pause pause;
+  pause.type = event.type();
+  pause.end = i::OS::TimeCurrentMillis();
+  pause.start = pause.end - event.pause_time();
+  pause.paused_before = 0;
+  if (!pauses_->is_empty()) {
+    const Pause& last = pauses_->last();
+    pause.paused_before = last.paused_before + (last.end - last.start);
+  }
+  for (int i = 0; i < GCEvent::kNumberOfPhases; i++) {
+    pause.phase_times[i] = event.phase_time(static_cast<GCEvent::Phase>(i));
+  }
+  pauses_->Add(pause);
+}
+
+
+double GCLatencyRecorder::PausedUntil(double time) {
+  // Find the last pause that started before |time|.
+  int low = 0;
+  int high = pauses_->length();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (pauses_->at(mid).start < time) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low == 0) return 0;
+  const Pause& pause = pauses_->at(low - 1);
+  return pause.paused_before + (i::Min(time, pause.end) - pause.start);
+}
+
+
+double GCLatencyRecorder::MinimumMutatorUtilization(double window) {
+  // The utilization of a window only changes its slope where a pause
+  // starts or ends, so the minimum is found among the windows that start
+  // at the beginning of the run or of a pause, or end at the end of a pause.
+  double last_start = end_time_ - window;
+  double max_paused = PausedUntil(start_time_ + window);
+  for (int i = 0; i < pauses_->length(); i++) {
+    const Pause& pause = pauses_->at(i);
+    double starts[] = { pause.start, pause.end - window };
+    for (int j = 0; j < 2; j++) {
+      double start = i::Max(start_time_, i::Min(starts[j], last_start));
+      double paused = PausedUntil(start + window) - PausedUntil(start);
+      max_paused = i::Max(max_paused, paused);
+    }
+  }
+  return 1.0 - i::Min(max_paused, window) / window;
+}
+
+
+static int CompareDoubles(const double* a, const double* b) {
+  if (*a < *b) return -1;
+  if (*a > *b) return 1;
+  return 0;
+}
+
+
+// Returns the nearest-rank percentile of a sorted list.
+static double Percentile(const i::List<double>& sorted, int percent) {
+  int rank = (sorted.length() * percent + 99) / 100;
+  return sorted[i::Max(rank, 1) - 1];
+}
+
+
+void GCLatencyRecorder::PrintPauses(const char* name, GCType type) {
+  i::List<double> times(pauses_->length());
+  double total = 0;
+  for (int i = 0; i < pauses_->length(); i++) {
+    const Pause& pause = pauses_->at(i);
+    if ((pause.type & type) == 0) continue;
+    times.Add(pause.end - pause.start);
+    total += pause.end - pause.start;
+  }
+  if (times.is_empty()) return;
+  times.Sort(CompareDoubles);
+  printf("%-14s %6d %9.1f %8.2f %8.2f %8.2f %8.2f %8.2f\n",
+         name, times.length(), total, total / times.length(),
+         Percentile(times, 50), Percentile(times, 90), Percentile(times, 99),
+         times.last());
+}
+
+
+void GCLatencyRecorder::PrintReport() {
+  static const char* const kPhaseNames[GCEvent::kNumberOfPhases] = {
+    "external", "mark", "sweep", "evacuate", "update pointers",
+    "scavenge roots", "weak processing"
+  };
+  double run_time = end_time_ - start_time_;
+  printf("gc latency: %d collections in %.1f ms\n",
+         pauses_->length(), run_time);
+  printf("%-14s %6s %9s %8s %8s %8s %8s %8s\n",
+         "pauses", "count", "total ms", "mean ms", "p50 ms", "p90 ms",
+         "p99 ms", "max ms");
+  PrintPauses("all", kGCTypeAll);
+  PrintPauses("scavenge", kGCTypeScavenge);
+  PrintPauses("mark-compact", kGCTypeMarkSweepCompact);
+
+  printf("%-16s %9s %8s\n", "phases", "total ms", "max ms");
+  for (int phase = 0; phase < GCEvent::kNumberOfPhases; phase++) {
+    double total = 0;
+    double max = 0;
+    for (int i = 0; i < pauses_->length(); i++) {
+      double time = pauses_->at(i).phase_times[phase];
+      total += time;
+      max = i::Max(max, time);
+    }
+    printf("%-16s %9.1f %8.2f\n", kPhaseNames[phase], total, max);
+  }
+
+  static const int kWindows[] = { 10, 50, 100, 500, 1000 };
+  printf("minimum mutator utilization:");
+  for (size_t i = 0; i < ARRAY_SIZE(kWindows); i++) {
+    if (kWindows[i] > run_time) break;
+    printf(" %d ms %.1f%%", kWindows[i],
+           MinimumMutatorUtilization(kWindows[i]) * 100.0);
+  }
+  printf("\n");
+  delete pauses_;
+  pauses_ = NULL;
+}
 #endif  // V8_SHARED
 
 
@@ -1174,6 +1695,40 @@ bool Shell::SetOptions(int argc, char* argv[]) {
         printf("Missing value for --preemption-interval\n");
         return false;
       }
+#endif  // V8_SHARED
+    } else if (strcmp(argv[i], "--throughput") == 0 ||
+               strcmp(argv[i], "--throughput-iterations") == 0) {
+#ifdef V8_SHARED
+      printf("D8 with shared library does not support multi-threading\n");
+      return false;
+#else
+      const char* option = argv[i];
+      if (++i < argc) {
+        argv[i-1] = NULL;
+        char* end = NULL;
+        int value = strtol(argv[i], &end, 10);  // NOLINT
+        if (value <= 0 || *end != '\0' || errno == ERANGE) {
+          printf("Invalid value for %s '%s'\n", option, argv[i]);
+          return false;
+        }
+        if (strcmp(option, "--throughput") == 0) {
+          options.throughput_isolates = value;
+        } else {
+          options.throughput_iterations = value;
+        }
+        argv[i] = NULL;
+      } else {
+        printf("Missing value for %s\n", option);
+        return false;
+      }
+#endif  // V8_SHARED
+    } else if (strcmp(argv[i], "--gc-latency") == 0) {
+#ifdef V8_SHARED
+      printf("D8 with shared library does not support --gc-latency\n");
+      return false;
+#else
+      options.gc_latency = true;
+      argv[i] = NULL;
 #endif  // V8_SHARED
     } else if (strcmp(argv[i], "-f") == 0) {
       // Ignore any -f flags for compatibility with other stand-alone
@@ -1226,6 +1781,15 @@ bool Shell::SetOptions(int argc, char* argv[]) {
     printf("-p requires a file containing a list of files as parameter\n");
     return false;
   }
+  if (options.throughput_isolates > 0 &&
+      (options.num_isolates > 1 || options.num_parallel_files > 0)) {
+    printf("--throughput is not compatible with --isolate and -p\n");
+    return false;
+  }
+  if (options.gc_latency && options.throughput_isolates > 0) {
+    printf("--gc-latency is not compatible with --throughput\n");
+    return false;
+  }
 #endif  // V8_SHARED
 
   v8::V8::SetFlagsFromCommandLine(&argc, argv, true);
@@ -1252,6 +1816,8 @@ bool Shell::SetOptions(int argc, char* argv[]) {
 
 int Shell::RunMain(int argc, char* argv[]) {
 #ifndef V8_SHARED
+  if (options.throughput_isolates > 0) return RunThroughput();
+
   i::List<i::Thread*> threads(1);
   if (options.parallel_files != NULL) {
     for (int i = 0; i < options.num_parallel_files; i++) {
@@ -1329,6 +1895,9 @@ int Shell::Main(int argc, char* argv[]) {
   if (!SetOptions(argc, argv)) return 1;
   Initialize();
 
+#ifndef V8_SHARED
+  if (options.gc_latency) GCLatencyRecorder::Start();
+#endif  // V8_SHARED
   int result = 0;
   if (options.stress_opt || options.stress_deopt) {
     Testing::SetStressRunType(
@@ -1347,6 +1916,13 @@ int Shell::Main(int argc, char* argv[]) {
     result = RunMain(argc, argv);
   }
 
+#ifndef V8_SHARED
+  if (options.gc_latency) {
+    GCLatencyRecorder::Stop();
+    GCLatencyRecorder::PrintReport();
+  }
+#endif  // V8_SHARED
+
 
 #if !defined(V8_SHARED) && defined(ENABLE_DEBUGGER_SUPPORT)
   // Run remote debugger if requested, but never on --test
@@ -1371,6 +1947,11 @@ int Shell::Main(int argc, char* argv[]) {
     RunShell();
   }
 
+#ifndef V8_SHARED
+  CleanupWorkers();
+  if (i::FLAG_runtime_call_stats) PrintRuntimeCallStats();
+#endif  // V8_SHARED
+
   V8::Dispose();
 
 #ifndef V8_SHARED
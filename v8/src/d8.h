@@ -166,6 +166,8 @@ class SourceGroup {
   void StartExecuteInThread();
   void WaitForThread();
 
+  static i::Thread::Options GetThreadOptions();
+
  private:
   class IsolateThread : public i::Thread {
    public:
@@ -180,7 +182,6 @@ class SourceGroup {
     SourceGroup* group_;
   };
 
-  static i::Thread::Options GetThreadOptions();
   void ExecuteInThread();
 
   i::Semaphore* next_semaphore_;
@@ -197,6 +198,148 @@ class SourceGroup {
 };
 
 
+#ifndef V8_SHARED
+// Queue of structured clones passed between a worker and its parent.  A
+// NULL entry marks the end of the stream.
+class CloneQueue {
+ public:
+  CloneQueue()
+      : mutex_(i::OS::CreateMutex()),
+        semaphore_(i::OS::CreateSemaphore(0)) { }
+  ~CloneQueue();
+
+  void Enqueue(StructuredClone* data);
+  // Blocks until there is an entry.
+  StructuredClone* Dequeue();
+
+ private:
+  i::Mutex* mutex_;
+  i::Semaphore* semaphore_;
+  i::List<StructuredClone*> queue_;
+};
+
+
+// Runs a script in its own isolate on its own thread.  The script talks to
+// its parent through postMessage() and an onmessage handler.
+class Worker {
+ public:
+  Worker() : thread_(NULL), script_(NULL), finished_(false) { }
+  ~Worker();
+
+  void StartExecuteInThread(const char* script);
+  void PostMessage(StructuredClone* data) { in_queue_.Enqueue(data); }
+  // Blocks until the worker posts a message.  Returns NULL once the worker
+  // has finished and all its messages have been read.
+  StructuredClone* GetMessage();
+  void Terminate();
+
+ private:
+  class WorkerThread : public i::Thread {
+   public:
+    explicit WorkerThread(Worker* worker)
+        : i::Thread("d8:Worker"), worker_(worker) {}
+
+    virtual void Run() {
+      worker_->ExecuteInThread();
+    }
+
+   private:
+    Worker* worker_;
+  };
+
+  void ExecuteInThread();
+  static Handle<Value> PostMessageOut(const Arguments& args);
+
+  CloneQueue in_queue_;
+  CloneQueue out_queue_;
+  i::Thread* thread_;
+  char* script_;
+  bool finished_;
+};
+
+
+// Runs the scripts of the first source group over and over in its own
+// isolate for --throughput.  The threads wait for each other before the
+// first iteration so that all isolates run at the same time.
+class ThroughputThread : public i::Thread {
+ public:
+  ThroughputThread(int index, i::Semaphore* ready, i::Semaphore* start)
+      : i::Thread(SourceGroup::GetThreadOptions()),
+        index_(index),
+        ready_(ready),
+        start_(start),
+        iterations_(0),
+        total_time_(0),
+        min_time_(0),
+        max_time_(0),
+        setup_time_(0),
+        gc_count_(0),
+        gc_pause_time_(0) { }
+
+  virtual void Run();
+
+  // Prints one line of the --throughput report.
+  void PrintReport() const;
+  static void PrintReportHeader();
+
+  int iterations() const { return iterations_; }
+  double total_time() const { return total_time_; }
+  double min_time() const { return min_time_; }
+  double setup_time() const { return setup_time_; }
+  int gc_count() const { return gc_count_; }
+  double gc_pause_time() const { return gc_pause_time_; }
+
+ private:
+  static void OnGCEvent(const GCEvent& event);
+
+  int index_;
+  i::Semaphore* ready_;
+  i::Semaphore* start_;
+  // Times are in milliseconds.  The setup time is the time spent creating
+  // evaluation contexts, which all isolates do under one mutex.
+  int iterations_;
+  double total_time_;
+  double min_time_;
+  double max_time_;
+  double setup_time_;
+  int gc_count_;
+  double gc_pause_time_;
+};
+
+
+// Records every collection of the main isolate for --gc-latency and
+// reports the distribution of the pauses, the time spent in each GC phase
+// and the minimum mutator utilization: the smallest share of any time
+// window of a given length that was left to JavaScript.
+class GCLatencyRecorder : public i::AllStatic {
+ public:
+  static void Start();
+  static void Stop();
+  static void PrintReport();
+
+ private:
+  struct Pause {
+    GCType type;
+    double start;
+    double end;
+    // Sum of the lengths of all earlier pauses.
+    double paused_before;
+    double phase_times[GCEvent::kNumberOfPhases];
+  };
+
+  static void OnGCEvent(const GCEvent& event);
+  static void PrintPauses(const char* name, GCType type);
+  // Total time paused between the start of the recording and |time|.
+  static double PausedUntil(double time);
+  static double MinimumMutatorUtilization(double window);
+
+  static i::List<Pause>* pauses_;
+  static double start_time_;
+  static double end_time_;
+};
+#endif  // V8_SHARED
+
+
 class ShellOptions {
  public:
   ShellOptions() :
@@ -205,6 +348,9 @@ class ShellOptions {
      preemption_interval(10),
      num_parallel_files(0),
      parallel_files(NULL),
+     throughput_isolates(0),
+     throughput_iterations(1),
+     gc_latency(false),
 #endif  // V8_SHARED
      script_executed(false),
      last_run(true),
@@ -227,6 +373,9 @@ class ShellOptions {
   int preemption_interval;
   int num_parallel_files;
   char** parallel_files;
+  int throughput_isolates;
+  int throughput_iterations;
+  bool gc_latency;
 #endif  // V8_SHARED
   bool script_executed;
   bool last_run;
@@ -261,6 +410,7 @@ class Shell : public i::AllStatic {
   static Handle<Array> GetCompletions(Handle<String> text,
                                       Handle<String> full);
   static void OnExit();
+  static void PrintRuntimeCallStats();
   static int* LookupCounter(const char* name);
   static void* CreateHistogram(const char* name,
                                int min,
@@ -298,6 +448,17 @@ class Shell : public i::AllStatic {
   static Handle<Value> Float32Array(const Arguments& args);
   static Handle<Value> Float64Array(const Arguments& args);
   static Handle<Value> PixelArray(const Arguments& args);
+  // Frees the backing store of |array| once it is garbage collected.
+  static void MakeExternalArrayWeak(Handle<Object> array);
+#ifndef V8_SHARED
+  static Handle<Value> WorkerNew(const Arguments& args);
+  static Handle<Value> WorkerPostMessage(const Arguments& args);
+  static Handle<Value> WorkerGetMessage(const Arguments& args);
+  static Handle<Value> WorkerTerminate(const Arguments& args);
+  static void CleanupWorkers();
+  // Lets a clone received from another isolate create external arrays.
+  static StructuredClone::Delegate* clone_delegate();
+#endif  // V8_SHARED
   // The OS object on the global object contains methods for performing
   // operating system calls:
   //
@@ -353,9 +514,12 @@ class Shell : public i::AllStatic {
   static CounterCollection* counters_;
   static i::OS::MemoryMappedFile* counters_file_;
   static i::Mutex* context_mutex_;
+  static i::Mutex* workers_mutex_;
+  static i::List<Worker*> workers_;
 
   static Counter* GetCounter(const char* name, bool is_histogram);
   static void InstallUtilityScript();
+  static int RunThroughput();
 #endif  // V8_SHARED
   static void Initialize();
   static void RunShell();
@@ -28,6 +28,7 @@
 #ifndef V8_DATEPARSER_INL_H_
 #define V8_DATEPARSER_INL_H_
 
+#include "date.h"
 #include "dateparser.h"
 
 namespace v8 {
@@ -179,6 +180,92 @@ bool DateParser::Parse(Vector<Char> str,
 }
 
 
+template <typename Char>
+bool DateParser::ParseISODateTime(Vector<Char> str,
+                                  DateCache* date_cache,
+                                  double* time) {
+  const int kPrefixLength = DateCache::kParsedDayPrefixLength;
+  int length = str.length();
+  if (length < kPrefixLength) return false;
+  const Char* s = str.start();
+
+  int days;
+  if (!date_cache->LookupParsedDay(s, &days)) {
+    int year, month, day;
+    if (s[4] != '-' || s[7] != '-' ||
+        !ReadFixedDigits(s, 4, &year) ||
+        !ReadFixedDigits(s + 5, 2, &month) ||
+        !ReadFixedDigits(s + 8, 2, &day) ||
+        !DayComposer::IsMonth(month) ||
+        !DayComposer::IsDay(day)) {
+      return false;
+    }
+    days = DateCache::DaysFromYearMonth(year, month - 1) + day - 1;
+    date_cache->UpdateParsedDay(s, days);
+  }
+
+  int time_in_day_ms = 0;
+  int offset_min = 0;
+  int pos = kPrefixLength;
+  if (pos < length) {
+    // 'T'HH':'mm[':'ss['.'sss]]
+    int hour, minute;
+    int second = 0;
+    int millisecond = 0;
+    if (length < pos + 6 ||
+        (s[pos] != 'T' && s[pos] != 't') ||
+        s[pos + 3] != ':' ||
+        !ReadFixedDigits(s + pos + 1, 2, &hour) ||
+        !ReadFixedDigits(s + pos + 4, 2, &minute) ||
+        !TimeComposer::IsHour(hour) ||
+        !TimeComposer::IsMinute(minute)) {
+      return false;
+    }
+    pos += 6;
+    if (pos < length && s[pos] == ':') {
+      if (length < pos + 3 ||
+          !ReadFixedDigits(s + pos + 1, 2, &second) ||
+          !TimeComposer::IsSecond(second)) {
+        return false;
+      }
+      pos += 3;
+      if (pos < length && s[pos] == '.') {
+        if (length < pos + 4 ||
+            !ReadFixedDigits(s + pos + 1, 3, &millisecond)) {
+          return false;
+        }
+        pos += 4;
+      }
+    }
+    // Optional 'Z' | ('+'|'-')hh':'mm.  Without one, ES5 dates are UTC.
+    if (pos < length) {
+      if (s[pos] == 'Z' || s[pos] == 'z') {
+        pos++;
+      } else if (s[pos] == '+' || s[pos] == '-') {
+        int tz_hour, tz_minute;
+        if (length < pos + 6 ||
+            s[pos + 3] != ':' ||
+            !ReadFixedDigits(s + pos + 1, 2, &tz_hour) ||
+            !ReadFixedDigits(s + pos + 4, 2, &tz_minute) ||
+            !TimeComposer::IsHour(tz_hour) ||
+            !TimeComposer::IsMinute(tz_minute)) {
+          return false;
+        }
+        offset_min = tz_hour * 60 + tz_minute;
+        if (s[pos] == '-') offset_min = -offset_min;
+        pos += 6;
+      }
+    }
+    time_in_day_ms = ((hour * 60 + minute) * 60 + second) * 1000 + millisecond;
+  }
+  if (pos != length) return false;
+
+  *time = static_cast<double>(days) * DateCache::kMsPerDay +
+      time_in_day_ms - offset_min * DateCache::kMsPerMin;
+  return true;
+}
+
+
 template<typename CharType>
 DateParser::DateToken DateParser::DateStringTokenizer<CharType>::Scan() {
   int pre_pos = in_->position();
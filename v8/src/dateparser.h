@@ -34,6 +34,8 @@
 namespace v8 {
 namespace internal {
 
+class DateCache;
+
 class DateParser : public AllStatic {
  public:
   // Parse the string as a date. If parsing succeeds, return true after
@@ -54,6 +56,20 @@ class DateParser : public AllStatic {
     YEAR, MONTH, DAY, HOUR, MINUTE, SECOND, MILLISECOND, UTC_OFFSET, OUTPUT_SIZE
   };
 
+  // Fast path for the layout of ES5 ISO 8601 date-time strings that
+  // programs generate:
+  //   yyyy-MM-dd[THH:mm[:ss[.sss]][Z|(+|-)hh:mm]]
+  // The digits are read at fixed positions without the tokenizer, and the
+  // day number of the yyyy-MM-dd prefix is shared through the prefix cache
+  // of the DateCache.  On success, stores the time value in milliseconds
+  // since the epoch in 'time' and returns true.  Returns false if the
+  // string has any other layout; such strings have to go through Parse,
+  // which then also decides whether they are valid.
+  template <typename Char>
+  static bool ParseISODateTime(Vector<Char> str,
+                               DateCache* date_cache,
+                               double* time);
+
  private:
   // Range testing
   static inline bool Between(int x, int lo, int hi) {
@@ -63,6 +79,18 @@ class DateParser : public AllStatic {
   // Indicates a missing value.
   static const int kNone = kMaxInt;
 
+  // Reads a number of exactly 'digits' ASCII digits.
+  template <typename Char>
+  static bool ReadFixedDigits(const Char* s, int digits, int* value) {
+    int n = 0;
+    for (int i = 0; i < digits; i++) {
+      if (!IsDecimalDigit(s[i])) return false;
+      n = n * 10 + (s[i] - '0');
+    }
+    *value = n;
+    return true;
+  }
+
   // Maximal number of digits used to build the value of a numeral.
   // Remaining digits are ignored.
   static const int kMaxSignificantDigits = 9;
@@ -57,6 +57,7 @@ namespace internal {
 
 Debug::Debug(Isolate* isolate)
     : has_break_points_(false),
+      prepared_all_functions_(false),
       script_cache_(NULL),
       debug_info_list_(NULL),
       disable_break_(false),
@@ -1137,7 +1138,7 @@ void Debug::SetBreakPoint(Handle<SharedFunctionInfo> shared,
                           int* source_position) {
   HandleScope scope(isolate_);
 
-  PrepareForBreakPoints();
+  PrepareFunctionForBreakPoints(shared);
 
   if (!EnsureDebugInfo(shared)) {
     // Return if retrieving debug info failed.
@@ -1761,179 +1762,198 @@ static bool CompileFullCodeForDebugging(Handle<SharedFunctionInfo> shared,
 void Debug::PrepareForBreakPoints() {
   // If preparing for the first break point make sure to deoptimize all
   // functions as debugging does not work with optimized code.
-  if (!has_break_points_) {
+  if (!prepared_all_functions_) {
     Deoptimizer::DeoptimizeAll();
+    RecompileForBreakPoints(Handle<SharedFunctionInfo>::null());
+    prepared_all_functions_ = true;
+  }
+}
 
-    Handle<Code> lazy_compile =
-        Handle<Code>(isolate_->builtins()->builtin(Builtins::kLazyCompile));
 
-    // Keep the list of activated functions in a handlified list as it
-    // is used both in GC and non-GC code.
-    List<Handle<JSFunction> > active_functions(100);
+void Debug::PrepareFunctionForBreakPoints(Handle<SharedFunctionInfo> shared) {
+  // Functions with debug info are never optimized or inlined, so only the
+  // first break point in a function deoptimizes the code that includes it.
+  if (prepared_all_functions_ || HasDebugInfo(shared)) return;
+  Deoptimizer::DeoptimizeFunctionsIncluding(*shared);
+  if (shared->is_compiled() && !shared->code()->has_debug_break_slots()) {
+    RecompileForBreakPoints(shared);
+  }
+}
 
-    {
-      // We are going to iterate heap to find all functions without
-      // debug break slots.
-      isolate_->heap()->CollectAllGarbage(Heap::kMakeHeapIterableMask);
-
-      // Ensure no GC in this scope as we are comparing raw pointer
-      // values and performing a heap iteration.
-      AssertNoAllocation no_allocation;
-
-      // Find all non-optimized code functions with activation frames
-      // on the stack. This includes functions which have optimized
-      // activations (including inlined functions) on the stack as the
-      // non-optimized code is needed for the lazy deoptimization.
-      for (JavaScriptFrameIterator it(isolate_); !it.done(); it.Advance()) {
-        JavaScriptFrame* frame = it.frame();
-        if (frame->is_optimized()) {
-          List<JSFunction*> functions(Compiler::kMaxInliningLevels + 1);
-          frame->GetFunctions(&functions);
-          for (int i = 0; i < functions.length(); i++) {
-            if (!functions[i]->shared()->code()->has_debug_break_slots()) {
-              active_functions.Add(Handle<JSFunction>(functions[i]));
-            }
-          }
-        } else if (frame->function()->IsJSFunction()) {
-          JSFunction* function = JSFunction::cast(frame->function());
-          if (function->code()->kind() == Code::FUNCTION &&
-              !function->code()->has_debug_break_slots()) {
-            active_functions.Add(Handle<JSFunction>(function));
+
+void Debug::RecompileForBreakPoints(Handle<SharedFunctionInfo> target) {
+  Handle<Code> lazy_compile =
+      Handle<Code>(isolate_->builtins()->builtin(Builtins::kLazyCompile));
+
+  // Keep the list of activated functions in a handlified list as it
+  // is used both in GC and non-GC code.
+  List<Handle<JSFunction> > active_functions(100);
+
+  {
+    // We are going to iterate heap to find all functions without
+    // debug break slots.
+    isolate_->heap()->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+
+    // Ensure no GC in this scope as we are comparing raw pointer
+    // values and performing a heap iteration.
+    AssertNoAllocation no_allocation;
+
+    // Find all non-optimized code functions with activation frames
+    // on the stack. This includes functions which have optimized
+    // activations (including inlined functions) on the stack as the
+    // non-optimized code is needed for the lazy deoptimization.
+    for (JavaScriptFrameIterator it(isolate_); !it.done(); it.Advance()) {
+      JavaScriptFrame* frame = it.frame();
+      if (frame->is_optimized()) {
+        List<JSFunction*> functions(Compiler::kMaxInliningLevels + 1);
+        frame->GetFunctions(&functions);
+        for (int i = 0; i < functions.length(); i++) {
+          if ((target.is_null() || functions[i]->shared() == *target) &&
+              !functions[i]->shared()->code()->has_debug_break_slots()) {
+            active_functions.Add(Handle<JSFunction>(functions[i]));
           }
         }
+      } else if (frame->function()->IsJSFunction()) {
+        JSFunction* function = JSFunction::cast(frame->function());
+        if ((target.is_null() || function->shared() == *target) &&
+            function->code()->kind() == Code::FUNCTION &&
+            !function->code()->has_debug_break_slots()) {
+          active_functions.Add(Handle<JSFunction>(function));
+        }
       }
+    }
 
-      // Sort the functions on the object pointer value to prepare for
-      // the binary search below.
-      active_functions.Sort(HandleObjectPointerCompare<JSFunction>);
-
-      // Scan the heap for all non-optimized functions which has no
-      // debug break slots.
-      HeapIterator iterator;
-      HeapObject* obj = NULL;
-      while (((obj = iterator.next()) != NULL)) {
-        if (obj->IsJSFunction()) {
-          JSFunction* function = JSFunction::cast(obj);
-          if (function->shared()->allows_lazy_compilation() &&
-              function->shared()->script()->IsScript() &&
-              function->code()->kind() == Code::FUNCTION &&
-              !function->code()->has_debug_break_slots()) {
-            bool has_activation =
-                SortedListBSearch<Handle<JSFunction> >(
-                    active_functions,
-                    Handle<JSFunction>(function),
-                    HandleObjectPointerCompare<JSFunction>) != -1;
-            if (!has_activation) {
-              function->set_code(*lazy_compile);
-              function->shared()->set_code(*lazy_compile);
-            }
+    // Sort the functions on the object pointer value to prepare for
+    // the binary search below.
+    active_functions.Sort(HandleObjectPointerCompare<JSFunction>);
+
+    // Scan the heap for all non-optimized functions which has no
+    // debug break slots.
+    HeapIterator iterator;
+    HeapObject* obj = NULL;
+    while (((obj = iterator.next()) != NULL)) {
+      if (obj->IsJSFunction()) {
+        JSFunction* function = JSFunction::cast(obj);
+        if ((target.is_null() || function->shared() == *target) &&
+            function->shared()->allows_lazy_compilation() &&
+            function->shared()->script()->IsScript() &&
+            function->code()->kind() == Code::FUNCTION &&
+            !function->code()->has_debug_break_slots()) {
+          bool has_activation =
+              SortedListBSearch<Handle<JSFunction> >(
+                  active_functions,
+                  Handle<JSFunction>(function),
+                  HandleObjectPointerCompare<JSFunction>) != -1;
+          if (!has_activation) {
+            function->set_code(*lazy_compile);
+            function->shared()->set_code(*lazy_compile);
           }
         }
       }
     }
+  }
+
+  // Now the non-GC scope is left, and the sorting of the functions
+  // in active_function is not ensured any more. The code below does
+  // not rely on it.
+
+  // Now recompile all functions with activation frames and and
+  // patch the return address to run in the new compiled code.
+  for (int i = 0; i < active_functions.length(); i++) {
+    Handle<JSFunction> function = active_functions[i];
+    Handle<SharedFunctionInfo> shared(function->shared());
+    // If recompilation is not possible just skip it.
+    if (shared->is_toplevel() ||
+        !shared->allows_lazy_compilation() ||
+        shared->code()->kind() == Code::BUILTIN) {
+      continue;
+    }
 
-    // Now the non-GC scope is left, and the sorting of the functions
-    // in active_function is not ensured any more. The code below does
-    // not rely on it.
-
-    // Now recompile all functions with activation frames and and
-    // patch the return address to run in the new compiled code.
-    for (int i = 0; i < active_functions.length(); i++) {
-      Handle<JSFunction> function = active_functions[i];
-      Handle<SharedFunctionInfo> shared(function->shared());
-      // If recompilation is not possible just skip it.
-      if (shared->is_toplevel() ||
-          !shared->allows_lazy_compilation() ||
-          shared->code()->kind() == Code::BUILTIN) {
+    // Make sure that the shared full code is compiled with debug
+    // break slots.
+    if (function->code() == *lazy_compile) {
+      function->set_code(shared->code());
+    }
+    Handle<Code> current_code(function->code());
+    if (shared->code()->has_debug_break_slots()) {
+      // if the code is already recompiled to have break slots skip
+      // recompilation.
+      ASSERT(!function->code()->has_debug_break_slots());
+    } else {
+      // Try to compile the full code with debug break slots. If it
+      // fails just keep the current code.
+      ASSERT(shared->code() == *current_code);
+      ZoneScope zone_scope(isolate_, DELETE_ON_EXIT);
+      shared->set_code(*lazy_compile);
+      bool prev_force_debugger_active =
+          isolate_->debugger()->force_debugger_active();
+      isolate_->debugger()->set_force_debugger_active(true);
+      CompileFullCodeForDebugging(shared, current_code);
+      isolate_->debugger()->set_force_debugger_active(
+          prev_force_debugger_active);
+      if (!shared->is_compiled()) {
+        shared->set_code(*current_code);
         continue;
       }
+    }
+    Handle<Code> new_code(shared->code());
 
-      // Make sure that the shared full code is compiled with debug
-      // break slots.
-      if (function->code() == *lazy_compile) {
-        function->set_code(shared->code());
-      }
-      Handle<Code> current_code(function->code());
-      if (shared->code()->has_debug_break_slots()) {
-        // if the code is already recompiled to have break slots skip
-        // recompilation.
-        ASSERT(!function->code()->has_debug_break_slots());
-      } else {
-        // Try to compile the full code with debug break slots. If it
-        // fails just keep the current code.
-        ASSERT(shared->code() == *current_code);
-        ZoneScope zone_scope(isolate_, DELETE_ON_EXIT);
-        shared->set_code(*lazy_compile);
-        bool prev_force_debugger_active =
-            isolate_->debugger()->force_debugger_active();
-        isolate_->debugger()->set_force_debugger_active(true);
-        CompileFullCodeForDebugging(shared, current_code);
-        isolate_->debugger()->set_force_debugger_active(
-            prev_force_debugger_active);
-        if (!shared->is_compiled()) {
-          shared->set_code(*current_code);
-          continue;
-        }
-      }
-      Handle<Code> new_code(shared->code());
-
-      // Find the function and patch the return address.
-      for (JavaScriptFrameIterator it(isolate_); !it.done(); it.Advance()) {
-        JavaScriptFrame* frame = it.frame();
-        // If the current frame is for this function in its
-        // non-optimized form rewrite the return address to continue
-        // in the newly compiled full code with debug break slots.
-        if (frame->function()->IsJSFunction() &&
-            frame->function() == *function &&
-            frame->LookupCode()->kind() == Code::FUNCTION) {
-          intptr_t delta = frame->pc() - current_code->instruction_start();
-          int debug_break_slot_count = 0;
-          int mask = RelocInfo::ModeMask(RelocInfo::DEBUG_BREAK_SLOT);
-          for (RelocIterator it(*new_code, mask); !it.done(); it.next()) {
-            // Check if the pc in the new code with debug break
-            // slots is before this slot.
-            RelocInfo* info = it.rinfo();
-            int debug_break_slot_bytes =
-                debug_break_slot_count * Assembler::kDebugBreakSlotLength;
-            intptr_t new_delta =
-                info->pc() -
-                new_code->instruction_start() -
-                debug_break_slot_bytes;
-            if (new_delta > delta) {
-              break;
-            }
-
-            // Passed a debug break slot in the full code with debug
-            // break slots.
-            debug_break_slot_count++;
-          }
+    // Find the function and patch the return address.
+    for (JavaScriptFrameIterator it(isolate_); !it.done(); it.Advance()) {
+      JavaScriptFrame* frame = it.frame();
+      // If the current frame is for this function in its
+      // non-optimized form rewrite the return address to continue
+      // in the newly compiled full code with debug break slots.
+      if (frame->function()->IsJSFunction() &&
+          frame->function() == *function &&
+          frame->LookupCode()->kind() == Code::FUNCTION) {
+        intptr_t delta = frame->pc() - current_code->instruction_start();
+        int debug_break_slot_count = 0;
+        int mask = RelocInfo::ModeMask(RelocInfo::DEBUG_BREAK_SLOT);
+        for (RelocIterator it(*new_code, mask); !it.done(); it.next()) {
+          // Check if the pc in the new code with debug break
+          // slots is before this slot.
+          RelocInfo* info = it.rinfo();
           int debug_break_slot_bytes =
               debug_break_slot_count * Assembler::kDebugBreakSlotLength;
-          if (FLAG_trace_deopt) {
-            PrintF("Replacing code %08" V8PRIxPTR " - %08" V8PRIxPTR " (%d) "
-                   "with %08" V8PRIxPTR " - %08" V8PRIxPTR " (%d) "
-                   "for debugging, "
-                   "changing pc from %08" V8PRIxPTR " to %08" V8PRIxPTR "\n",
-                   reinterpret_cast<intptr_t>(
-                       current_code->instruction_start()),
-                   reinterpret_cast<intptr_t>(
-                       current_code->instruction_start()) +
-                       current_code->instruction_size(),
-                   current_code->instruction_size(),
-                   reinterpret_cast<intptr_t>(new_code->instruction_start()),
-                   reinterpret_cast<intptr_t>(new_code->instruction_start()) +
-                       new_code->instruction_size(),
-                   new_code->instruction_size(),
-                   reinterpret_cast<intptr_t>(frame->pc()),
-                   reinterpret_cast<intptr_t>(new_code->instruction_start()) +
-                       delta + debug_break_slot_bytes);
+          intptr_t new_delta =
+              info->pc() -
+              new_code->instruction_start() -
+              debug_break_slot_bytes;
+          if (new_delta > delta) {
+            break;
           }
 
-          // Patch the return address to return into the code with
-          // debug break slots.
-          frame->set_pc(
-              new_code->instruction_start() + delta + debug_break_slot_bytes);
+          // Passed a debug break slot in the full code with debug
+          // break slots.
+          debug_break_slot_count++;
+        }
+        int debug_break_slot_bytes =
+            debug_break_slot_count * Assembler::kDebugBreakSlotLength;
+        if (FLAG_trace_deopt) {
+          PrintF("Replacing code %08" V8PRIxPTR " - %08" V8PRIxPTR " (%d) "
+                 "with %08" V8PRIxPTR " - %08" V8PRIxPTR " (%d) "
+                 "for debugging, "
+                 "changing pc from %08" V8PRIxPTR " to %08" V8PRIxPTR "\n",
+                 reinterpret_cast<intptr_t>(
+                     current_code->instruction_start()),
+                 reinterpret_cast<intptr_t>(
+                     current_code->instruction_start()) +
+                     current_code->instruction_size(),
+                 current_code->instruction_size(),
+                 reinterpret_cast<intptr_t>(new_code->instruction_start()),
+                 reinterpret_cast<intptr_t>(new_code->instruction_start()) +
+                     new_code->instruction_size(),
+                 new_code->instruction_size(),
+                 reinterpret_cast<intptr_t>(frame->pc()),
+                 reinterpret_cast<intptr_t>(new_code->instruction_start()) +
+                     delta + debug_break_slot_bytes);
         }
+
+        // Patch the return address to return into the code with
+        // debug break slots.
+        frame->set_pc(
+            new_code->instruction_start() + delta + debug_break_slot_bytes);
       }
     }
   }
@@ -1988,6 +2008,7 @@ void Debug::RemoveDebugInfo(Handle<DebugInfo> debug_info) {
       // If there are no more debug info objects there are not more break
       // points.
       has_break_points_ = debug_info_list_ != NULL;
+      if (!has_break_points_) prepared_all_functions_ = false;
 
       return;
     }
@@ -2094,11 +2115,10 @@ bool Debug::IsBreakAtReturn(JavaScriptFrame* frame) {
     return false;
   }
 
-  PrepareForBreakPoints();
-
   // Get the executing function in which the debug break occurred.
   Handle<SharedFunctionInfo> shared =
       Handle<SharedFunctionInfo>(JSFunction::cast(frame->function())->shared());
+  PrepareFunctionForBreakPoints(shared);
   if (!EnsureDebugInfo(shared)) {
     // Return if we failed to retrieve the debug info.
     return false;
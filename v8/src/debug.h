@@ -247,8 +247,15 @@ class Debug {
   static Handle<DebugInfo> GetDebugInfo(Handle<SharedFunctionInfo> shared);
   static bool HasDebugInfo(Handle<SharedFunctionInfo> shared);
 
+  // Deoptimizes all functions and recompiles the full code of the ones on
+  // the stack with debug break slots, as stepping can enter any function.
   void PrepareForBreakPoints();
 
+  // Deoptimizes the optimized code that includes shared, itself or inlined,
+  // and gives it full code with debug break slots.  Other functions keep
+  // their optimized code.
+  void PrepareFunctionForBreakPoints(Handle<SharedFunctionInfo> shared);
+
   // Returns whether the operation succeeded.
   bool EnsureDebugInfo(Handle<SharedFunctionInfo> shared);
 
@@ -281,6 +288,10 @@ class Debug {
   // Fast check to see if any break points are active.
   inline bool has_break_points() { return has_break_points_; }
 
+  // Whether all functions were prepared for stepping, so that no code
+  // should be optimized until the break points are gone.
+  inline bool prepared_all_functions() { return prepared_all_functions_; }
+
   void NewBreak(StackFrame::Id break_frame_id);
   void SetBreak(StackFrame::Id break_frame_id, int break_id);
   StackFrame::Id break_frame_id() {
@@ -463,6 +474,9 @@ class Debug {
   void ClearStepNext();
   // Returns whether the compile succeeded.
   void RemoveDebugInfo(Handle<DebugInfo> debug_info);
+  // Recompiles the full code of target, or of all functions if it is null,
+  // with debug break slots.
+  void RecompileForBreakPoints(Handle<SharedFunctionInfo> target);
   void SetAfterBreakTarget(JavaScriptFrame* frame);
   Handle<Object> CheckBreakPoints(Handle<Object> break_point);
   bool CheckBreakPoint(Handle<Object> break_point_object);
@@ -474,6 +488,9 @@ class Debug {
   // Boolean state indicating whether any break points are set.
   bool has_break_points_;
 
+  // Set by PrepareForBreakPoints until there are no break points left.
+  bool prepared_all_functions_;
+
   // Cache of all scripts in the heap.
   ScriptCache* script_cache_;
 
@@ -156,8 +156,8 @@ DeoptimizedFrameInfo* Deoptimizer::DebuggerInspectableFrame(
   // Done with the GC-unsafe frame descriptions. This re-enables allocation.
   deoptimizer->DeleteFrameDescriptions();
 
-  // Allocate a heap number for the doubles belonging to this frame.
-  deoptimizer->MaterializeHeapNumbersForDebuggerInspectableFrame(
+  // Allocate the heap numbers and captured objects belonging to this frame.
+  deoptimizer->MaterializeHeapObjectsForDebuggerInspectableFrame(
       top, size, info);
 
   // Finished using the deoptimizer instance.
@@ -223,6 +223,159 @@ void Deoptimizer::DeoptimizeGlobalObject(JSObject* object) {
 }
 
 
+// Collects the optimized functions whose code depends on a global property
+// cell.  They are deoptimized after the visit, because deoptimization
+// invalidates code that can be shared by other functions in the list.
+class DependentFunctionsVisitor : public OptimizedFunctionVisitor {
+ public:
+  explicit DependentFunctionsVisitor(JSGlobalPropertyCell* cell)
+      : cell_(cell), functions_(4) { }
+
+  virtual void EnterContext(Context* context) { }
+
+  virtual void VisitFunction(JSFunction* function) {
+    FixedArray* data = function->code()->deoptimization_data();
+    // Code without deoptimization data cannot tell its dependencies.
+    bool depends = data->length() == 0;
+    if (!depends) {
+      FixedArray* cells = DeoptimizationInputData::cast(data)->DependentCells();
+      for (int i = 0; i < cells->length(); i++) {
+        if (cells->get(i) == cell_) {
+          depends = true;
+          break;
+        }
+      }
+    }
+    if (depends) functions_.Add(function);
+  }
+
+  virtual void LeaveContext(Context* context) { }
+
+  const List<JSFunction*>* functions() const { return &functions_; }
+
+ private:
+  JSGlobalPropertyCell* cell_;
+  List<JSFunction*> functions_;
+};
+
+
+void Deoptimizer::DeoptimizeDependentFunctions(JSObject* object,
+                                               JSGlobalPropertyCell* cell) {
+  AssertNoAllocation no_allocation;
+
+  DependentFunctionsVisitor visitor(cell);
+  VisitAllOptimizedFunctionsForGlobalObject(object, &visitor);
+  const List<JSFunction*>* functions = visitor.functions();
+  if (FLAG_trace_deopt) {
+    PrintF("[deoptimize %d function%s depending on cell 0x%08" V8PRIxPTR "]\n",
+           functions->length(), functions->length() == 1 ? "" : "s",
+           reinterpret_cast<intptr_t>(cell));
+  }
+  for (int i = 0; i < functions->length(); i++) {
+    DeoptimizeFunction(functions->at(i));
+  }
+}
+
+
+// Collects the optimized functions whose code includes a function, as the
+// optimized function itself or inlined into it.  Inlined closures are
+// among the deoptimization literals.
+class IncludingFunctionsVisitor : public OptimizedFunctionVisitor {
+ public:
+  explicit IncludingFunctionsVisitor(SharedFunctionInfo* shared)
+      : shared_(shared), functions_(4) { }
+
+  virtual void EnterContext(Context* context) { }
+
+  virtual void VisitFunction(JSFunction* function) {
+    FixedArray* data = function->code()->deoptimization_data();
+    // Code without deoptimization data cannot tell what it inlined.
+    bool includes = function->shared() == shared_ || data->length() == 0;
+    if (!includes) {
+      FixedArray* literals =
+          DeoptimizationInputData::cast(data)->LiteralArray();
+      for (int i = 0; i < literals->length(); i++) {
+        Object* literal = literals->get(i);
+        if (literal->IsJSFunction() &&
+            JSFunction::cast(literal)->shared() == shared_) {
+          includes = true;
+          break;
+        }
+      }
+    }
+    if (includes) functions_.Add(function);
+  }
+
+  virtual void LeaveContext(Context* context) { }
+
+  const List<JSFunction*>* functions() const { return &functions_; }
+
+ private:
+  SharedFunctionInfo* shared_;
+  List<JSFunction*> functions_;
+};
+
+
+void Deoptimizer::DeoptimizeFunctionsIncluding(SharedFunctionInfo* shared) {
+  AssertNoAllocation no_allocation;
+
+  IncludingFunctionsVisitor visitor(shared);
+  VisitAllOptimizedFunctions(&visitor);
+  const List<JSFunction*>* functions = visitor.functions();
+  if (FLAG_trace_deopt && functions->length() > 0) {
+    PrintF("[deoptimize %d function%s including ",
+           functions->length(), functions->length() == 1 ? "" : "s");
+    shared->ShortPrint();
+    PrintF("]\n");
+  }
+  for (int i = 0; i < functions->length(); i++) {
+    DeoptimizeFunction(functions->at(i));
+  }
+}
+
+
+// Collects the optimized functions whose code was last used in or before
+// a full garbage collection.
+class UnusedFunctionsVisitor : public OptimizedFunctionVisitor {
+ public:
+  explicit UnusedFunctionsVisitor(int last_used_gc)
+      : last_used_gc_(last_used_gc), functions_(4) { }
+
+  virtual void EnterContext(Context* context) { }
+
+  virtual void VisitFunction(JSFunction* function) {
+    if (function->code()->last_used_gc() <= last_used_gc_) {
+      functions_.Add(function);
+    }
+  }
+
+  virtual void LeaveContext(Context* context) { }
+
+  const List<JSFunction*>* functions() const { return &functions_; }
+
+ private:
+  int last_used_gc_;
+  List<JSFunction*> functions_;
+};
+
+
+int Deoptimizer::DeoptimizeUnusedFunctions(int last_used_gc) {
+  AssertNoAllocation no_allocation;
+
+  UnusedFunctionsVisitor visitor(last_used_gc);
+  VisitAllOptimizedFunctions(&visitor);
+  const List<JSFunction*>* functions = visitor.functions();
+  if (FLAG_trace_deopt && functions->length() > 0) {
+    PrintF("[deoptimize %d unused function%s]\n",
+           functions->length(), functions->length() == 1 ? "" : "s");
+  }
+  for (int i = 0; i < functions->length(); i++) {
+    DeoptimizeFunction(functions->at(i));
+  }
+  return functions->length();
+}
+
+
 void Deoptimizer::VisitAllOptimizedFunctionsForContext(
     Context* context, OptimizedFunctionVisitor* visitor) {
   AssertNoAllocation no_allocation;
@@ -306,12 +459,16 @@ Deoptimizer::Deoptimizer(Isolate* isolate,
       bailout_type_(type),
       from_(from),
       fp_to_sp_delta_(fp_to_sp_delta),
+      deopt_site_id_(AstNode::kNoNumber),
+      deopt_site_function_(NULL),
       input_(NULL),
       output_count_(0),
       output_(NULL),
       frame_alignment_marker_(isolate->heap()->frame_alignment_marker()),
       has_alignment_padding_(0),
-      deferred_heap_numbers_(0) {
+      deferred_heap_numbers_(0),
+      deferred_objects_(0),
+      captured_field_values_(0) {
   if (FLAG_trace_deopt && type != OSR) {
     if (type == DEBUGGER) {
       PrintF("**** DEOPT FOR DEBUGGER: ");
@@ -517,10 +674,17 @@ void Deoptimizer::DoComputeOutputFrames() {
   }
   output_count_ = count;
 
-  // Translate each output frame.
+  // Translate each output frame.  The ast id of the innermost frame is
+  // read ahead of its translation to identify the deoptimization site.
   for (int i = 0; i < count; ++i) {
+    if (i == count - 1) {
+      TranslationIterator site = iterator;
+      site.Next();  // Skip the FRAME opcode.
+      deopt_site_id_ = site.Next();
+    }
     DoComputeFrame(&iterator, i);
   }
+  deopt_site_function_ = output_[count - 1]->GetFunction();
 
   // Print some helpful diagnostic information.
   if (FLAG_trace_deopt) {
@@ -541,8 +705,129 @@ void Deoptimizer::DoComputeOutputFrames() {
 }
 
 
-void Deoptimizer::MaterializeHeapNumbers() {
+void Deoptimizer::RecordDeoptimizationSite(Handle<SharedFunctionInfo> shared,
+                                           int ast_id) {
+  Factory* factory = shared->GetIsolate()->factory();
+  Handle<FixedArray> history;
+  int length = 0;
+  if (shared->deopt_history()->IsFixedArray()) {
+    history = Handle<FixedArray>(FixedArray::cast(shared->deopt_history()));
+    length = history->length();
+  }
+  int count = 1;
+  for (int i = 0; i < length; i += 2) {
+    if (Smi::cast(history->get(i))->value() == ast_id) {
+      count = Smi::cast(history->get(i + 1))->value() + 1;
+      history->set(i + 1, Smi::FromInt(count));
+      break;
+    }
+  }
+  if (count == 1) {
+    if (length == 2 * kMaxDeoptimizationSites) return;
+    Handle<FixedArray> grown = factory->NewFixedArray(length + 2, TENURED);
+    for (int i = 0; i < length; i++) grown->set(i, history->get(i));
+    grown->set(length, Smi::FromInt(ast_id));
+    grown->set(length + 1, Smi::FromInt(count));
+    shared->set_deopt_history(*grown);
+  }
+  if (FLAG_trace_deopt) {
+    SmartArrayPointer<char> name = shared->DebugName()->ToCString();
+    PrintF("[deoptimization site %s @%d: %d deoptimization%s]\n",
+           *name, ast_id, count, count == 1 ? "" : "s");
+  }
+}
+
+
+int Deoptimizer::DeoptimizationCountAt(SharedFunctionInfo* shared,
+                                       int ast_id) {
+  if (!shared->deopt_history()->IsFixedArray()) return 0;
+  FixedArray* history = FixedArray::cast(shared->deopt_history());
+  for (int i = 0; i < history->length(); i += 2) {
+    if (Smi::cast(history->get(i))->value() == ast_id) {
+      return Smi::cast(history->get(i + 1))->value();
+    }
+  }
+  return 0;
+}
+
+
+// An inlined arguments object is captured with the callee in place of the
+// boilerplate and the arguments as its fields.
+static Handle<JSObject> NewCapturedObject(Handle<JSObject> boilerplate,
+                                          int field_count) {
+  if (!boilerplate->IsJSFunction()) return Copy(boilerplate);
+  Factory* factory = boilerplate->GetIsolate()->factory();
+  Handle<JSObject> arguments =
+      factory->NewArgumentsObject(boilerplate, field_count);
+  arguments->set_elements(*factory->NewFixedArray(field_count));
+  return arguments;
+}
+
+
+static void SetCapturedField(Handle<JSObject> boilerplate,
+                             Handle<JSObject> object,
+                             int index,
+                             Object* value) {
+  if (boilerplate->IsJSFunction()) {
+    FixedArray::cast(object->elements())->set(index, value);
+  } else {
+    object->InObjectPropertyAtPut(index, value);
+  }
+}
+
+
+void Deoptimizer::MaterializeCapturedObjects(
+    Address top, uint32_t size, List<Handle<Object> >* objects) {
+  // The field values and boilerplates are raw pointers, so handles are
+  // created for all of them before anything is allocated.
+  List<Handle<Object> > values(captured_field_values_.length());
+  for (int i = 0; i < captured_field_values_.length(); i++) {
+    CapturedFieldValue value = captured_field_values_[i];
+    values.Add(value.is_number()
+               ? Handle<Object>::null()
+               : Handle<Object>(value.value(), isolate_));
+  }
+  List<Handle<JSObject> > boilerplates(deferred_objects_.length());
+  for (int i = 0; i < deferred_objects_.length(); i++) {
+    boilerplates.Add(
+        Handle<JSObject>(deferred_objects_[i].boilerplate(), isolate_));
+  }
+
+  for (int i = 0; i < deferred_objects_.length(); i++) {
+    ObjectMaterializationDescriptor d = deferred_objects_[i];
+    Address slot = d.slot_address();
+    if (top != NULL && (slot < top || slot >= top + size)) {
+      objects->Add(Handle<Object>::null());
+      continue;
+    }
+    Handle<JSObject> object =
+        NewCapturedObject(boilerplates[i], d.field_count());
+    for (int j = 0; j < d.field_count(); j++) {
+      int index = d.first_field() + j;
+      CapturedFieldValue value = captured_field_values_[index];
+      Handle<Object> field = value.is_number()
+          ? isolate_->factory()->NewNumber(value.number())
+          : values[index];
+      SetCapturedField(boilerplates[i], object, j, *field);
+    }
+    if (FLAG_trace_deopt) {
+      PrintF("Materializing a captured object %p in slot %p\n",
+             reinterpret_cast<void*>(*object),
+             slot);
+    }
+    objects->Add(object);
+  }
+}
+
+
+void Deoptimizer::MaterializeHeapObjects() {
   ASSERT_NE(DEBUGGER, bailout_type_);
+  List<Handle<Object> > objects(deferred_objects_.length());
+  MaterializeCapturedObjects(NULL, 0, &objects);
+  for (int i = 0; i < objects.length(); i++) {
+    Memory::Object_at(deferred_objects_[i].slot_address()) = *objects[i];
+  }
+
   for (int i = 0; i < deferred_heap_numbers_.length(); i++) {
     HeapNumberMaterializationDescriptor d = deferred_heap_numbers_[i];
     Handle<Object> num = isolate_->factory()->NewNumber(d.value());
@@ -559,9 +844,43 @@ void Deoptimizer::MaterializeHeapNumbers() {
 
 
 #ifdef ENABLE_DEBUGGER_SUPPORT
-void Deoptimizer::MaterializeHeapNumbersForDebuggerInspectableFrame(
+void Deoptimizer::SetDebuggerInspectableFrameSlot(DeoptimizedFrameInfo* info,
+                                                  Address top,
+                                                  uint32_t size,
+                                                  Address slot,
+                                                  Object* value) {
+  // Calculate the index with the botton of the expression stack
+  // at index 0, and the fixed part (including incoming arguments)
+  // at negative indexes.
+  int index = static_cast<int>(
+      info->expression_count_ - (slot - top) / kPointerSize - 1);
+  if (FLAG_trace_deopt) {
+    PrintF("  (slot %p is stack index %d)\n", slot, index);
+  }
+  if (index >=0) {
+    info->SetExpression(index, value);
+  } else {
+    // Calculate parameter index subtracting one for the receiver.
+    int parameter_index =
+        index +
+        static_cast<int>(size) / kPointerSize -
+        info->expression_count_ - 1;
+    info->SetParameter(parameter_index, value);
+  }
+}
+
+
+void Deoptimizer::MaterializeHeapObjectsForDebuggerInspectableFrame(
     Address top, uint32_t size, DeoptimizedFrameInfo* info) {
   ASSERT_EQ(DEBUGGER, bailout_type_);
+  List<Handle<Object> > objects(deferred_objects_.length());
+  MaterializeCapturedObjects(top, size, &objects);
+  for (int i = 0; i < objects.length(); i++) {
+    if (objects[i].is_null()) continue;
+    SetDebuggerInspectableFrameSlot(
+        info, top, size, deferred_objects_[i].slot_address(), *objects[i]);
+  }
+
   for (int i = 0; i < deferred_heap_numbers_.length(); i++) {
     HeapNumberMaterializationDescriptor d = deferred_heap_numbers_[i];
 
@@ -570,29 +889,13 @@ void Deoptimizer::MaterializeHeapNumbersForDebuggerInspectableFrame(
     Address slot = d.slot_address();
     if (top <= slot && slot < top + size) {
       Handle<Object> num = isolate_->factory()->NewNumber(d.value());
-      // Calculate the index with the botton of the expression stack
-      // at index 0, and the fixed part (including incoming arguments)
-      // at negative indexes.
-      int index = static_cast<int>(
-          info->expression_count_ - (slot - top) / kPointerSize - 1);
       if (FLAG_trace_deopt) {
-        PrintF("Materializing a new heap number %p [%e] in slot %p"
-               "for stack index %d\n",
+        PrintF("Materializing a new heap number %p [%e] in slot %p\n",
                reinterpret_cast<void*>(*num),
                d.value(),
-               d.slot_address(),
-               index);
-      }
-      if (index >=0) {
-        info->SetExpression(index, *num);
-      } else {
-        // Calculate parameter index subtracting one for the receiver.
-        int parameter_index =
-            index +
-            static_cast<int>(size) / kPointerSize -
-            info->expression_count_ - 1;
-        info->SetParameter(parameter_index, *num);
+               d.slot_address());
       }
+      SetDebuggerInspectableFrameSlot(info, top, size, slot, *num);
     }
   }
 }
@@ -666,6 +969,33 @@ void Deoptimizer::DoTranslateCommand(TranslationIterator* iterator,
       return;
     }
 
+    case Translation::UINT32_REGISTER: {
+      int input_reg = iterator->Next();
+      uint32_t value = static_cast<uint32_t>(input_->GetRegister(input_reg));
+      bool is_smi = value <= static_cast<uint32_t>(Smi::kMaxValue);
+      if (FLAG_trace_deopt) {
+        PrintF(
+            "    0x%08" V8PRIxPTR ": [top + %d] <- %u ; %s (uint32 %s)\n",
+            output_[frame_index]->GetTop() + output_offset,
+            output_offset,
+            value,
+            converter.NameOfCPURegister(input_reg),
+            is_smi ? "smi" : "heap number");
+      }
+      if (is_smi) {
+        intptr_t tagged_value =
+            reinterpret_cast<intptr_t>(Smi::FromInt(static_cast<int>(value)));
+        output_[frame_index]->SetFrameSlot(output_offset, tagged_value);
+      } else {
+        // We save the untagged value on the side and store a GC-safe
+        // temporary placeholder in the frame.
+        AddDoubleValue(output_[frame_index]->GetTop() + output_offset,
+                       static_cast<double>(value));
+        output_[frame_index]->SetFrameSlot(output_offset, kPlaceholder);
+      }
+      return;
+    }
+
     case Translation::DOUBLE_REGISTER: {
       int input_reg = iterator->Next();
       double value = input_->GetDoubleRegister(input_reg);
@@ -731,6 +1061,36 @@ void Deoptimizer::DoTranslateCommand(TranslationIterator* iterator,
       return;
     }
 
+    case Translation::UINT32_STACK_SLOT: {
+      int input_slot_index = iterator->Next();
+      unsigned input_offset =
+          input_->GetOffsetFromSlotIndex(this, input_slot_index);
+      uint32_t value =
+          static_cast<uint32_t>(input_->GetFrameSlot(input_offset));
+      bool is_smi = value <= static_cast<uint32_t>(Smi::kMaxValue);
+      if (FLAG_trace_deopt) {
+        PrintF("    0x%08" V8PRIxPTR ": ",
+               output_[frame_index]->GetTop() + output_offset);
+        PrintF("[top + %d] <- %u ; [esp + %d] (uint32 %s)\n",
+               output_offset,
+               value,
+               input_offset,
+               is_smi ? "smi" : "heap number");
+      }
+      if (is_smi) {
+        intptr_t tagged_value =
+            reinterpret_cast<intptr_t>(Smi::FromInt(static_cast<int>(value)));
+        output_[frame_index]->SetFrameSlot(output_offset, tagged_value);
+      } else {
+        // We save the untagged value on the side and store a GC-safe
+        // temporary placeholder in the frame.
+        AddDoubleValue(output_[frame_index]->GetTop() + output_offset,
+                       static_cast<double>(value));
+        output_[frame_index]->SetFrameSlot(output_offset, kPlaceholder);
+      }
+      return;
+    }
+
     case Translation::DOUBLE_STACK_SLOT: {
       int input_slot_index = iterator->Next();
       unsigned input_offset =
@@ -764,6 +1124,33 @@ void Deoptimizer::DoTranslateCommand(TranslationIterator* iterator,
       return;
     }
 
+    case Translation::CAPTURED_OBJECT: {
+      // We save the boilerplate and the field values on the side, store a
+      // GC-safe temporary placeholder in the frame and allocate the object
+      // after the deoptimized frames are built.
+      JSObject* boilerplate = JSObject::cast(ComputeLiteral(iterator->Next()));
+      int field_count = iterator->Next();
+      intptr_t slot_address = output_[frame_index]->GetTop() + output_offset;
+      if (FLAG_trace_deopt) {
+        PrintF("    0x%08" V8PRIxPTR ": [top + %d] <- captured object with "
+               "%d fields\n",
+               slot_address,
+               output_offset,
+               field_count);
+      }
+      ObjectMaterializationDescriptor object_desc(
+          reinterpret_cast<Address>(slot_address),
+          boilerplate,
+          captured_field_values_.length(),
+          field_count);
+      deferred_objects_.Add(object_desc);
+      for (int i = 0; i < field_count; i++) {
+        DoTranslateCapturedField(iterator);
+      }
+      output_[frame_index]->SetFrameSlot(output_offset, kPlaceholder);
+      return;
+    }
+
     case Translation::ARGUMENTS_OBJECT: {
       // Use the arguments marker value as a sentinel and fill in the arguments
       // object after the deoptimized frame is built.
@@ -784,6 +1171,121 @@ void Deoptimizer::DoTranslateCommand(TranslationIterator* iterator,
 }
 
 
+void Deoptimizer::DoTranslateCapturedField(TranslationIterator* iterator) {
+  Translation::Opcode opcode =
+      static_cast<Translation::Opcode>(iterator->Next());
+  switch (opcode) {
+    case Translation::REGISTER: {
+      int input_reg = iterator->Next();
+      Object* value = reinterpret_cast<Object*>(input_->GetRegister(input_reg));
+      captured_field_values_.Add(CapturedFieldValue(value));
+      return;
+    }
+
+    case Translation::INT32_REGISTER: {
+      int input_reg = iterator->Next();
+      intptr_t value = input_->GetRegister(input_reg);
+      int32_t int32_value = static_cast<int32_t>(value);
+      if (Smi::IsValid(value)) {
+        captured_field_values_.Add(
+            CapturedFieldValue(Smi::FromInt(int32_value)));
+      } else {
+        captured_field_values_.Add(
+            CapturedFieldValue(static_cast<double>(int32_value)));
+      }
+      return;
+    }
+
+    case Translation::UINT32_REGISTER: {
+      int input_reg = iterator->Next();
+      uint32_t value = static_cast<uint32_t>(input_->GetRegister(input_reg));
+      if (value <= static_cast<uint32_t>(Smi::kMaxValue)) {
+        captured_field_values_.Add(
+            CapturedFieldValue(Smi::FromInt(static_cast<int>(value))));
+      } else {
+        captured_field_values_.Add(
+            CapturedFieldValue(static_cast<double>(value)));
+      }
+      return;
+    }
+
+    case Translation::DOUBLE_REGISTER: {
+      int input_reg = iterator->Next();
+      double value = input_->GetDoubleRegister(input_reg);
+      captured_field_values_.Add(CapturedFieldValue(value));
+      return;
+    }
+
+    case Translation::STACK_SLOT: {
+      int input_slot_index = iterator->Next();
+      unsigned input_offset =
+          input_->GetOffsetFromSlotIndex(this, input_slot_index);
+      Object* value =
+          reinterpret_cast<Object*>(input_->GetFrameSlot(input_offset));
+      captured_field_values_.Add(CapturedFieldValue(value));
+      return;
+    }
+
+    case Translation::INT32_STACK_SLOT: {
+      int input_slot_index = iterator->Next();
+      unsigned input_offset =
+          input_->GetOffsetFromSlotIndex(this, input_slot_index);
+      intptr_t value = input_->GetFrameSlot(input_offset);
+      int32_t int32_value = static_cast<int32_t>(value);
+      if (Smi::IsValid(value)) {
+        captured_field_values_.Add(
+            CapturedFieldValue(Smi::FromInt(int32_value)));
+      } else {
+        captured_field_values_.Add(
+            CapturedFieldValue(static_cast<double>(int32_value)));
+      }
+      return;
+    }
+
+    case Translation::UINT32_STACK_SLOT: {
+      int input_slot_index = iterator->Next();
+      unsigned input_offset =
+          input_->GetOffsetFromSlotIndex(this, input_slot_index);
+      uint32_t value =
+          static_cast<uint32_t>(input_->GetFrameSlot(input_offset));
+      if (value <= static_cast<uint32_t>(Smi::kMaxValue)) {
+        captured_field_values_.Add(
+            CapturedFieldValue(Smi::FromInt(static_cast<int>(value))));
+      } else {
+        captured_field_values_.Add(
+            CapturedFieldValue(static_cast<double>(value)));
+      }
+      return;
+    }
+
+    case Translation::DOUBLE_STACK_SLOT: {
+      int input_slot_index = iterator->Next();
+      unsigned input_offset =
+          input_->GetOffsetFromSlotIndex(this, input_slot_index);
+      double value = input_->GetDoubleFrameSlot(input_offset);
+      captured_field_values_.Add(CapturedFieldValue(value));
+      return;
+    }
+
+    case Translation::LITERAL: {
+      Object* literal = ComputeLiteral(iterator->Next());
+      captured_field_values_.Add(CapturedFieldValue(literal));
+      return;
+    }
+
+    case Translation::BEGIN:
+    case Translation::FRAME:
+    case Translation::DUPLICATE:
+    case Translation::ARGUMENTS_OBJECT:
+    case Translation::CAPTURED_OBJECT:
+      // Fields of captured objects are never duplicated and never hold
+      // the arguments object or another captured object.
+      break;
+  }
+  UNREACHABLE();
+}
+
+
 bool Deoptimizer::DoOsrTranslateCommand(TranslationIterator* iterator,
                                         int* input_offset) {
   disasm::NameConverter converter;
@@ -847,6 +1349,32 @@ bool Deoptimizer::DoOsrTranslateCommand(TranslationIterator* iterator,
       break;
     }
 
+    case Translation::UINT32_REGISTER: {
+      // Abort OSR if we don't have a number.
+      if (!input_object->IsNumber()) return false;
+
+      int output_reg = iterator->Next();
+      uint32_t uint32_value = input_object->IsSmi()
+          ? static_cast<uint32_t>(Smi::cast(input_object)->value())
+          : DoubleToUint32(input_object->Number());
+      // Abort the translation if the conversion lost information.
+      if (static_cast<double>(uint32_value) != input_object->Number()) {
+        if (FLAG_trace_osr) {
+          PrintF("**** %g could not be converted to uint32 ****\n",
+                 input_object->Number());
+        }
+        return false;
+      }
+      if (FLAG_trace_osr) {
+        PrintF("    %s <- %u (uint32) ; [sp + %d]\n",
+               converter.NameOfCPURegister(output_reg),
+               uint32_value,
+               *input_offset);
+      }
+      output->SetRegister(output_reg, static_cast<intptr_t>(uint32_value));
+      break;
+    }
+
     case Translation::DOUBLE_REGISTER: {
       // Abort OSR if we don't have a number.
       if (!input_object->IsNumber()) return false;
@@ -908,6 +1436,34 @@ bool Deoptimizer::DoOsrTranslateCommand(TranslationIterator* iterator,
       break;
     }
 
+    case Translation::UINT32_STACK_SLOT: {
+      // Abort OSR if we don't have a number.
+      if (!input_object->IsNumber()) return false;
+
+      int output_index = iterator->Next();
+      unsigned output_offset =
+          output->GetOffsetFromSlotIndex(this, output_index);
+      uint32_t uint32_value = input_object->IsSmi()
+          ? static_cast<uint32_t>(Smi::cast(input_object)->value())
+          : DoubleToUint32(input_object->Number());
+      // Abort the translation if the conversion lost information.
+      if (static_cast<double>(uint32_value) != input_object->Number()) {
+        if (FLAG_trace_osr) {
+          PrintF("**** %g could not be converted to uint32 ****\n",
+                 input_object->Number());
+        }
+        return false;
+      }
+      if (FLAG_trace_osr) {
+        PrintF("    [sp + %d] <- %u (uint32) ; [sp + %d]\n",
+               output_offset,
+               uint32_value,
+               *input_offset);
+      }
+      output->SetFrameSlot(output_offset, uint32_value);
+      break;
+    }
+
     case Translation::DOUBLE_STACK_SLOT: {
       static const int kLowerOffset = 0 * kPointerSize;
       static const int kUpperOffset = 1 * kPointerSize;
@@ -953,6 +1509,13 @@ bool Deoptimizer::DoOsrTranslateCommand(TranslationIterator* iterator,
       UNREACHABLE();
       return false;
     }
+
+    case Translation::CAPTURED_OBJECT: {
+      // Objects are only captured in optimized code, the input frame of an
+      // on-stack replacement is unoptimized.
+      UNREACHABLE();
+      return false;
+    }
   }
 
   if (!duplicate) *input_offset -= kPointerSize;
@@ -977,7 +1540,7 @@ void Deoptimizer::PatchStackCheckCode(Code* unoptimized_code,
                           pc_after,
                           check_code,
                           replacement_code);
-    stack_check_cursor += 2 * kIntSize;
+    stack_check_cursor += Code::kStackCheckTableEntrySize;
   }
 }
 
@@ -999,7 +1562,7 @@ void Deoptimizer::RevertStackCheckCode(Code* unoptimized_code,
                            pc_after,
                            check_code,
                            replacement_code);
-    stack_check_cursor += 2 * kIntSize;
+    stack_check_cursor += Code::kStackCheckTableEntrySize;
   }
 }
 
@@ -1057,6 +1620,20 @@ Object* Deoptimizer::ComputeLiteral(int index) const {
 }
 
 
+JSFunction* Deoptimizer::ComputeFunction(int frame_index,
+                                         int function_id) const {
+  if (!Translation::IsDynamicClosureId(function_id)) {
+    return JSFunction::cast(ComputeLiteral(function_id));
+  }
+  // The closure was pushed before the receiver and the arguments, which
+  // the inlined frame took over, so it is the top of the frame below.
+  ASSERT(frame_index > 0);
+  Object* function =
+      reinterpret_cast<Object*>(output_[frame_index - 1]->GetFrameSlot(0));
+  return JSFunction::cast(function);
+}
+
+
 void Deoptimizer::AddDoubleValue(intptr_t slot_address,
                                  double value) {
   HeapNumberMaterializationDescriptor value_desc(
@@ -1257,6 +1834,12 @@ void Translation::StoreInt32Register(Register reg) {
 }
 
 
+void Translation::StoreUint32Register(Register reg) {
+  buffer_->Add(UINT32_REGISTER);
+  buffer_->Add(reg.code());
+}
+
+
 void Translation::StoreDoubleRegister(DoubleRegister reg) {
   buffer_->Add(DOUBLE_REGISTER);
   buffer_->Add(DoubleRegister::ToAllocationIndex(reg));
@@ -1275,6 +1858,12 @@ void Translation::StoreInt32StackSlot(int index) {
 }
 
 
+void Translation::StoreUint32StackSlot(int index) {
+  buffer_->Add(UINT32_STACK_SLOT);
+  buffer_->Add(index);
+}
+
+
 void Translation::StoreDoubleStackSlot(int index) {
   buffer_->Add(DOUBLE_STACK_SLOT);
   buffer_->Add(index);
@@ -1292,6 +1881,13 @@ void Translation::StoreArgumentsObject() {
 }
 
 
+void Translation::StoreCapturedObject(int boilerplate_id, int field_count) {
+  buffer_->Add(CAPTURED_OBJECT);
+  buffer_->Add(boilerplate_id);
+  buffer_->Add(field_count);
+}
+
+
 void Translation::MarkDuplicate() {
   buffer_->Add(DUPLICATE);
 }
@@ -1305,12 +1901,16 @@ int Translation::NumberOfOperandsFor(Opcode opcode) {
     case BEGIN:
     case REGISTER:
     case INT32_REGISTER:
+    case UINT32_REGISTER:
     case DOUBLE_REGISTER:
     case STACK_SLOT:
     case INT32_STACK_SLOT:
+    case UINT32_STACK_SLOT:
     case DOUBLE_STACK_SLOT:
     case LITERAL:
       return 1;
+    case CAPTURED_OBJECT:
+      return 2;
     case FRAME:
       return 3;
   }
@@ -1331,18 +1931,24 @@ const char* Translation::StringFor(Opcode opcode) {
       return "REGISTER";
     case INT32_REGISTER:
       return "INT32_REGISTER";
+    case UINT32_REGISTER:
+      return "UINT32_REGISTER";
     case DOUBLE_REGISTER:
       return "DOUBLE_REGISTER";
     case STACK_SLOT:
       return "STACK_SLOT";
     case INT32_STACK_SLOT:
       return "INT32_STACK_SLOT";
+    case UINT32_STACK_SLOT:
+      return "UINT32_STACK_SLOT";
     case DOUBLE_STACK_SLOT:
       return "DOUBLE_STACK_SLOT";
     case LITERAL:
       return "LITERAL";
     case ARGUMENTS_OBJECT:
       return "ARGUMENTS_OBJECT";
+    case CAPTURED_OBJECT:
+      return "CAPTURED_OBJECT";
     case DUPLICATE:
       return "DUPLICATE";
   }
@@ -1372,9 +1978,10 @@ DeoptimizingCodeListNode::~DeoptimizingCodeListNode() {
 // We can't intermix stack decoding and allocations because
 // deoptimization infrastracture is not GC safe.
 // Thus we build a temporary structure in malloced space.
-SlotRef SlotRef::ComputeSlotForNextArgument(TranslationIterator* iterator,
-                                            DeoptimizationInputData* data,
-                                            JavaScriptFrame* frame) {
+void SlotRef::ComputeSlotsForNextArgument(TranslationIterator* iterator,
+                                          DeoptimizationInputData* data,
+                                          JavaScriptFrame* frame,
+                                          List<SlotRef>* slots) {
   Translation::Opcode opcode =
       static_cast<Translation::Opcode>(iterator->Next());
 
@@ -1390,6 +1997,7 @@ SlotRef SlotRef::ComputeSlotForNextArgument(TranslationIterator* iterator,
 
     case Translation::REGISTER:
     case Translation::INT32_REGISTER:
+    case Translation::UINT32_REGISTER:
     case Translation::DOUBLE_REGISTER:
     case Translation::DUPLICATE:
       // We are at safepoint which corresponds to call.  All registers are
@@ -1400,35 +2008,71 @@ SlotRef SlotRef::ComputeSlotForNextArgument(TranslationIterator* iterator,
     case Translation::STACK_SLOT: {
       int slot_index = iterator->Next();
       Address slot_addr = SlotAddress(frame, slot_index);
-      return SlotRef(slot_addr, SlotRef::TAGGED);
+      slots->Add(SlotRef(slot_addr, SlotRef::TAGGED));
+      return;
     }
 
     case Translation::INT32_STACK_SLOT: {
       int slot_index = iterator->Next();
       Address slot_addr = SlotAddress(frame, slot_index);
-      return SlotRef(slot_addr, SlotRef::INT32);
+      slots->Add(SlotRef(slot_addr, SlotRef::INT32));
+      return;
+    }
+
+    case Translation::UINT32_STACK_SLOT: {
+      int slot_index = iterator->Next();
+      Address slot_addr = SlotAddress(frame, slot_index);
+      slots->Add(SlotRef(slot_addr, SlotRef::UINT32));
+      return;
     }
 
     case Translation::DOUBLE_STACK_SLOT: {
       int slot_index = iterator->Next();
       Address slot_addr = SlotAddress(frame, slot_index);
-      return SlotRef(slot_addr, SlotRef::DOUBLE);
+      slots->Add(SlotRef(slot_addr, SlotRef::DOUBLE));
+      return;
     }
 
     case Translation::LITERAL: {
       int literal_index = iterator->Next();
-      return SlotRef(data->LiteralArray()->get(literal_index));
+      slots->Add(SlotRef(data->LiteralArray()->get(literal_index)));
+      return;
+    }
+
+    case Translation::CAPTURED_OBJECT: {
+      int boilerplate_index = iterator->Next();
+      int field_count = iterator->Next();
+      slots->Add(SlotRef(data->LiteralArray()->get(boilerplate_index),
+                         field_count));
+      for (int i = 0; i < field_count; ++i) {
+        ComputeSlotsForNextArgument(iterator, data, frame, slots);
+      }
+      return;
     }
   }
 
   UNREACHABLE();
-  return SlotRef();
+}
+
+
+Handle<Object> SlotRef::GetNextValue(const List<SlotRef>& slots, int* index) {
+  SlotRef slot = slots[(*index)++];
+  if (slot.representation_ != CAPTURED_OBJECT) return slot.GetValue();
+
+  Handle<JSObject> boilerplate = Handle<JSObject>::cast(slot.literal_);
+  Handle<JSObject> object = NewCapturedObject(boilerplate, slot.field_count_);
+  for (int i = 0; i < slot.field_count_; ++i) {
+    Handle<Object> value = GetNextValue(slots, index);
+    SetCapturedField(boilerplate, object, i, *value);
+  }
+  return object;
 }
 
 
 void SlotRef::ComputeSlotMappingForArguments(JavaScriptFrame* frame,
                                              int inlined_frame_index,
-                                             Vector<SlotRef>* args_slots) {
+                                             int args_count,
+                                             List<SlotRef>* args_slots) {
   AssertNoAllocation no_gc;
   int deopt_index = AstNode::kNoNumber;
   DeoptimizationInputData* data =
@@ -1455,8 +2099,8 @@ void SlotRef::ComputeSlotMappingForArguments(JavaScriptFrame* frame,
         it.Skip(Translation::NumberOfOperandsFor(
             static_cast<Translation::Opcode>(it.Next())));
         // Compute slots for arguments.
-        for (int i = 0; i < args_slots->length(); ++i) {
-          (*args_slots)[i] = ComputeSlotForNextArgument(&it, data, frame);
+        for (int i = 0; i < args_count; ++i) {
+          ComputeSlotsForNextArgument(&it, data, frame, args_slots);
         }
         return;
       }
@@ -57,6 +57,54 @@ class HeapNumberMaterializationDescriptor BASE_EMBEDDED {
 };
 
 
+// An object removed by escape analysis, or the arguments object of an
+// inlined function, whose "boilerplate" is then the callee.  Its field values
+// are stored in the deoptimizer's captured field value list starting at
+// first_field.
+class ObjectMaterializationDescriptor BASE_EMBEDDED {
+ public:
+  ObjectMaterializationDescriptor(Address slot_address,
+                                  JSObject* boilerplate,
+                                  int first_field,
+                                  int field_count)
+      : slot_address_(slot_address),
+        boilerplate_(boilerplate),
+        first_field_(first_field),
+        field_count_(field_count) { }
+
+  Address slot_address() const { return slot_address_; }
+  JSObject* boilerplate() const { return boilerplate_; }
+  int first_field() const { return first_field_; }
+  int field_count() const { return field_count_; }
+
+ private:
+  Address slot_address_;
+  JSObject* boilerplate_;
+  int first_field_;
+  int field_count_;
+};
+
+
+// A field value of an object removed by escape analysis: either a tagged
+// value or an untagged number that needs a heap number.
+class CapturedFieldValue BASE_EMBEDDED {
+ public:
+  explicit CapturedFieldValue(Object* value)
+      : value_(value), is_number_(false), number_(0) { }
+  explicit CapturedFieldValue(double number)
+      : value_(NULL), is_number_(true), number_(number) { }
+
+  Object* value() const { return value_; }
+  bool is_number() const { return is_number_; }
+  double number() const { return number_; }
+
+ private:
+  Object* value_;
+  bool is_number_;
+  double number_;
+};
+
+
 class OptimizedFunctionVisitor BASE_EMBEDDED {
  public:
   virtual ~OptimizedFunctionVisitor() {}
@@ -154,6 +202,21 @@ class Deoptimizer : public Malloced {
 
   static void DeoptimizeGlobalObject(JSObject* object);
 
+  // Deoptimize the functions whose optimized code is or inlines the code
+  // of shared.
+  static void DeoptimizeFunctionsIncluding(SharedFunctionInfo* shared);
+
+  // Deoptimize the functions of the global object's context whose optimized
+  // code embeds the given global property cell.  Other optimized code that
+  // relies on the global object is left alone.
+  static void DeoptimizeDependentFunctions(JSObject* object,
+                                           JSGlobalPropertyCell* cell);
+
+  // Deoptimize the functions whose optimized code was last found running
+  // in or before the given full garbage collection, so that code that is
+  // no longer used can be collected.  Returns the number of functions.
+  static int DeoptimizeUnusedFunctions(int last_used_gc);
+
   static void VisitAllOptimizedFunctionsForContext(
       Context* context, OptimizedFunctionVisitor* visitor);
 
@@ -193,14 +256,33 @@ class Deoptimizer : public Malloced {
 
   ~Deoptimizer();
 
-  void MaterializeHeapNumbers();
+  // Allocates the heap numbers and the objects removed by escape analysis
+  // that are referenced from the output frames.
+  void MaterializeHeapObjects();
 #ifdef ENABLE_DEBUGGER_SUPPORT
-  void MaterializeHeapNumbersForDebuggerInspectableFrame(
+  void MaterializeHeapObjectsForDebuggerInspectableFrame(
       Address top, uint32_t size, DeoptimizedFrameInfo* info);
 #endif
 
   static void ComputeOutputFrames(Deoptimizer* deoptimizer);
 
+  // The site of the deoptimization: the ast id and function of the
+  // innermost output frame.
+  int deopt_site_id() const { return deopt_site_id_; }
+  JSFunction* deopt_site_function() const { return deopt_site_function_; }
+
+  // Records an eager deoptimization at the site with the given ast id in
+  // the deoptimization history of the function.
+  static void RecordDeoptimizationSite(Handle<SharedFunctionInfo> shared,
+                                       int ast_id);
+
+  // Returns the number of eager deoptimizations recorded at the site with
+  // the given ast id.
+  static int DeoptimizationCountAt(SharedFunctionInfo* shared, int ast_id);
+
+  // Sites beyond this number are not recorded.
+  static const int kMaxDeoptimizationSites = 16;
+
   static Address GetDeoptimizationEntry(int id, BailoutType type);
   static int GetDeoptimizationId(Address addr, BailoutType type);
   static int GetOutputInfo(DeoptimizationOutputData* data,
@@ -275,6 +357,9 @@ class Deoptimizer : public Malloced {
   void DoTranslateCommand(TranslationIterator* iterator,
                           int frame_index,
                           unsigned output_offset);
+  // Translate the command for a field of a captured object into the list
+  // of captured field values.
+  void DoTranslateCapturedField(TranslationIterator* iterator);
   // Translate a command for OSR.  Updates the input offset to be used for
   // the next command.  Returns false if translation of the command failed
   // (e.g., a number conversion failed) and may or may not have updated the
@@ -289,9 +374,29 @@ class Deoptimizer : public Malloced {
   unsigned ComputeOutgoingArgumentSize() const;
 
   Object* ComputeLiteral(int index) const;
+  // The function of the output frame at frame_index, given the function
+  // id of its FRAME command.
+  JSFunction* ComputeFunction(int frame_index, int function_id) const;
 
   void AddDoubleValue(intptr_t slot_address, double value);
 
+  // Allocate the objects removed by escape analysis whose slots are in
+  // [top, top + size) and return them in the order of their descriptors.
+  // A NULL top selects all objects; the objects outside the range are
+  // returned as null handles.
+  void MaterializeCapturedObjects(Address top,
+                                  uint32_t size,
+                                  List<Handle<Object> >* objects);
+#ifdef ENABLE_DEBUGGER_SUPPORT
+  // Store a value materialized for the slot of an output frame into the
+  // frame information given to the debugger.
+  static void SetDebuggerInspectableFrameSlot(DeoptimizedFrameInfo* info,
+                                              Address top,
+                                              uint32_t size,
+                                              Address slot,
+                                              Object* value);
+#endif
+
   static MemoryChunk* CreateCode(BailoutType type);
   static void GenerateDeoptimizationEntries(
       MacroAssembler* masm, int count, BailoutType type);
@@ -314,6 +419,8 @@ class Deoptimizer : public Malloced {
   BailoutType bailout_type_;
   Address from_;
   int fp_to_sp_delta_;
+  int deopt_site_id_;
+  JSFunction* deopt_site_function_;
 
   // Input frame description.
   FrameDescription* input_;
@@ -327,6 +434,8 @@ class Deoptimizer : public Malloced {
   intptr_t has_alignment_padding_;
 
   List<HeapNumberMaterializationDescriptor> deferred_heap_numbers_;
+  List<ObjectMaterializationDescriptor> deferred_objects_;
+  List<CapturedFieldValue> captured_field_values_;
 
   static const int table_entry_size_;
 
@@ -544,12 +653,15 @@ class Translation BASE_EMBEDDED {
     FRAME,
     REGISTER,
     INT32_REGISTER,
+    UINT32_REGISTER,
     DOUBLE_REGISTER,
     STACK_SLOT,
     INT32_STACK_SLOT,
+    UINT32_STACK_SLOT,
     DOUBLE_STACK_SLOT,
     LITERAL,
     ARGUMENTS_OBJECT,
+    CAPTURED_OBJECT,
 
     // A prefix indicating that the next command is a duplicate of the one
     // that follows it.
@@ -569,16 +681,30 @@ class Translation BASE_EMBEDDED {
   void BeginFrame(int node_id, int literal_id, unsigned height);
   void StoreRegister(Register reg);
   void StoreInt32Register(Register reg);
+  void StoreUint32Register(Register reg);
   void StoreDoubleRegister(DoubleRegister reg);
   void StoreStackSlot(int index);
   void StoreInt32StackSlot(int index);
+  void StoreUint32StackSlot(int index);
   void StoreDoubleStackSlot(int index);
   void StoreLiteral(int literal_id);
   void StoreArgumentsObject();
+  void StoreCapturedObject(int boilerplate_id, int field_count);
   void MarkDuplicate();
 
   static int NumberOfOperandsFor(Opcode opcode);
 
+  // The function of a frame is a deoptimization literal, except for
+  // inlined closures created by the optimized code itself.  Those frames
+  // refer to a template function with the same shared function info by a
+  // negative id, and the closure is the top of the expression stack of
+  // the frame below.
+  static int DynamicClosureId(int literal_id) { return -literal_id - 1; }
+  static bool IsDynamicClosureId(int function_id) { return function_id < 0; }
+  static int LiteralIdForFunction(int function_id) {
+    return IsDynamicClosureId(function_id) ? -function_id - 1 : function_id;
+  }
+
 #if defined(OBJECT_PRINT) || defined(ENABLE_DISASSEMBLER)
   static const char* StringFor(Opcode opcode);
 #endif
@@ -615,18 +741,26 @@ class SlotRef BASE_EMBEDDED {
     UNKNOWN,
     TAGGED,
     INT32,
+    UINT32,
     DOUBLE,
-    LITERAL
+    LITERAL,
+    CAPTURED_OBJECT
   };
 
   SlotRef()
-      : addr_(NULL), representation_(UNKNOWN) { }
+      : addr_(NULL), representation_(UNKNOWN), field_count_(0) { }
 
   SlotRef(Address addr, SlotRepresentation representation)
-      : addr_(addr), representation_(representation) { }
+      : addr_(addr), representation_(representation), field_count_(0) { }
 
   explicit SlotRef(Object* literal)
-      : literal_(literal), representation_(LITERAL) { }
+      : literal_(literal), representation_(LITERAL), field_count_(0) { }
+
+  // A captured object, followed by the slots of its fields.
+  SlotRef(Object* boilerplate, int field_count)
+      : literal_(boilerplate),
+        representation_(CAPTURED_OBJECT),
+        field_count_(field_count) { }
 
   Handle<Object> GetValue() {
     switch (representation_) {
@@ -642,6 +776,11 @@ class SlotRef BASE_EMBEDDED {
         }
       }
 
+      case UINT32: {
+        uint32_t value = Memory::uint32_at(addr_);
+        return Isolate::Current()->factory()->NewNumberFromUint(value);
+      }
+
       case DOUBLE: {
         double value = Memory::double_at(addr_);
         return Isolate::Current()->factory()->NewNumber(value);
@@ -656,14 +795,20 @@ class SlotRef BASE_EMBEDDED {
     }
   }
 
+  // Returns the value of the slot at *index and advances *index past it
+  // and, for a captured object, past the slots of its fields.
+  static Handle<Object> GetNextValue(const List<SlotRef>& slots, int* index);
+
   static void ComputeSlotMappingForArguments(JavaScriptFrame* frame,
                                              int inlined_frame_index,
-                                             Vector<SlotRef>* args_slots);
+                                             int args_count,
+                                             List<SlotRef>* args_slots);
 
  private:
   Address addr_;
   Handle<Object> literal_;
   SlotRepresentation representation_;
+  int field_count_;
 
   static Address SlotAddress(JavaScriptFrame* frame, int slot_index) {
     if (slot_index >= 0) {
@@ -675,9 +820,12 @@ class SlotRef BASE_EMBEDDED {
     }
   }
 
-  static SlotRef ComputeSlotForNextArgument(TranslationIterator* iterator,
-                                            DeoptimizationInputData* data,
-                                            JavaScriptFrame* frame);
+  // Adds the slot for the next argument to slots, followed by the slots of
+  // its fields if it is a captured object.
+  static void ComputeSlotsForNextArgument(TranslationIterator* iterator,
+                                          DeoptimizationInputData* data,
+                                          JavaScriptFrame* frame,
+                                          List<SlotRef>* slots);
 };
 
 
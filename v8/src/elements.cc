@@ -186,15 +186,13 @@ class ElementsAccessorBase : public ElementsAccessor {
     if (!maybe_obj->To<FixedArray>(&result)) return maybe_obj;
 
     // Fill in the content
-    {
-      AssertNoAllocation no_gc;
-      WriteBarrierMode mode = result->GetWriteBarrierMode(no_gc);
-      for (int i = 0; i < len0; i++) {
-        Object* e = to->get(i);
-        ASSERT(e->IsString() || e->IsNumber());
-        result->set(i, e, mode);
-      }
+#ifdef DEBUG
+    for (int i = 0; i < len0; i++) {
+      Object* e = to->get(i);
+      ASSERT(e->IsString() || e->IsNumber());
     }
+#endif
+    to->CopyTo(0, result, 0, len0);
     // Fill in the extra values.
     int index = 0;
     for (uint32_t y = 0; y < len1; y++) {
@@ -293,11 +291,16 @@ class FastElementsAccessor
         if (length == 0) {
           array->initialize_elements();
         } else {
+          array->GetHeap()->EnsureSweptBeforeResizing(backing_store);
           backing_store->set_length(length);
           Address filler_start = backing_store->address() +
               BackingStore::OffsetOfElementAt(length);
           int filler_size = (old_capacity - length) * ElementSize;
-          array->GetHeap()->CreateFillerObjectAt(filler_start, filler_size);
+          Heap* heap = array->GetHeap();
+          heap->CreateFillerObjectAt(filler_start, filler_size);
+          if (heap->lo_space()->Contains(backing_store)) {
+            heap->lo_space()->TrimObject(backing_store, filler_size);
+          }
         }
       } else {
         // Otherwise, fill the unused tail with holes.
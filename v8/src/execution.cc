@@ -34,6 +34,7 @@
 #include "codegen.h"
 #include "debug.h"
 #include "isolate-inl.h"
+#include "optimizing-compiler-thread.h"
 #include "runtime-profiler.h"
 #include "simulator.h"
 #include "v8threads.h"
@@ -450,6 +451,81 @@ void StackGuard::RequestGC() {
 }
 
 
+bool StackGuard::IsInstallCodeRequest() {
+  ExecutionAccess access(isolate_);
+  return (thread_local_.interrupt_flags_ & INSTALL_CODE) != 0;
+}
+
+
+void StackGuard::RequestInstallCode() {
+  ExecutionAccess access(isolate_);
+  thread_local_.interrupt_flags_ |= INSTALL_CODE;
+  if (thread_local_.postpone_interrupts_nesting_ == 0) {
+    thread_local_.jslimit_ = thread_local_.climit_ = kInterruptLimit;
+    isolate_->heap()->SetStackLimits();
+  }
+}
+
+
+bool StackGuard::IsTimeSliceExpired() {
+  return thread_local_.time_slice_expired_ != 0;
+}
+
+
+void StackGuard::TimeSliceExpired() {
+  // Runs in a signal handler on the thread that owns thread_local_, so only
+  // word-sized stores and no ExecutionAccess.  If the handler interrupted a
+  // reset_limits the flag may be left without lowered limits; the timer is
+  // periodic, so the next expiry lowers them again.
+  if (thread_local_.real_climit_ == kIllegalLimit) return;
+  thread_local_.time_slice_expired_ = 1;
+  if (thread_local_.postpone_interrupts_nesting_ == 0) {
+    thread_local_.jslimit_ = thread_local_.climit_ = kInterruptLimit;
+    isolate_->heap()->SetStackLimits();
+  }
+}
+
+
+static void TimeSliceTimerFired() {
+  Isolate* isolate = Isolate::UncheckedCurrent();
+  if (isolate == NULL) return;
+  // With Lockers the stack guard's thread data belongs to whichever thread
+  // holds the lock; a slice that runs out while waiting for it is ignored.
+  if (v8::Locker::IsActive() &&
+      !isolate->thread_manager()->IsLockedByCurrentThread()) {
+    return;
+  }
+  isolate->stack_guard()->TimeSliceExpired();
+}
+
+
+bool StackGuard::SetTimeSlice(int microseconds,
+                              v8::TimeSliceCallback callback) {
+  if (callback == NULL) microseconds = 0;
+  {
+    ExecutionAccess access(isolate_);
+    thread_local_.time_slice_microseconds_ = microseconds;
+    thread_local_.time_slice_callback_ = callback;
+    thread_local_.time_slice_expired_ = 0;
+  }
+  return OS::ArmThreadCpuTimer(microseconds, TimeSliceTimerFired);
+}
+
+
+void StackGuard::RestartTimeSlice() {
+  {
+    ExecutionAccess access(isolate_);
+    thread_local_.time_slice_expired_ = 0;
+    if (!should_postpone_interrupts(access) &&
+        !has_pending_interrupts(access)) {
+      reset_limits(access);
+    }
+  }
+  OS::ArmThreadCpuTimer(thread_local_.time_slice_microseconds_,
+                        TimeSliceTimerFired);
+}
+
+
 #ifdef ENABLE_DEBUGGER_SUPPORT
 bool StackGuard::IsDebugBreak() {
   ExecutionAccess access(isolate_);
@@ -528,6 +604,9 @@ void StackGuard::ThreadLocal::Clear() {
   nesting_ = 0;
   postpone_interrupts_nesting_ = 0;
   interrupt_flags_ = 0;
+  time_slice_expired_ = 0;
+  time_slice_microseconds_ = 0;
+  time_slice_callback_ = NULL;
 }
 
 
@@ -548,6 +627,9 @@ bool StackGuard::ThreadLocal::Initialize(Isolate* isolate) {
   nesting_ = 0;
   postpone_interrupts_nesting_ = 0;
   interrupt_flags_ = 0;
+  time_slice_expired_ = 0;
+  time_slice_microseconds_ = 0;
+  time_slice_callback_ = NULL;
   return should_set_stack_limits;
 }
 
@@ -710,6 +792,19 @@ Handle<JSFunction> Execution::InstantiateFunction(
 }
 
 
+// Tells whether constructing an instance of the given function template
+// would do nothing but allocate the object, in which case it can be
+// allocated directly instead of through a construct call.
+static bool IsTrivialConstructor(FunctionTemplateInfo* cons_template) {
+  if (!cons_template->call_code()->IsUndefined()) return false;
+  if (!cons_template->signature()->IsUndefined()) return false;
+  Object* instance_template = cons_template->instance_template();
+  return instance_template->IsUndefined() ||
+      ObjectTemplateInfo::cast(instance_template)->property_list()->
+          IsUndefined();
+}
+
+
 Handle<JSObject> Execution::InstantiateObject(Handle<ObjectTemplateInfo> data,
                                               bool* exc) {
   Isolate* isolate = data->GetIsolate();
@@ -724,9 +819,16 @@ Handle<JSObject> Execution::InstantiateObject(Handle<ObjectTemplateInfo> data,
               FunctionTemplateInfo::cast(data->constructor()));
       Handle<JSFunction> cons = InstantiateFunction(cons_template, exc);
       if (*exc) return Handle<JSObject>::null();
-      Handle<Object> value = New(cons, 0, NULL, exc);
-      if (*exc) return Handle<JSObject>::null();
-      result = *value;
+      if (IsTrivialConstructor(*cons_template)) {
+        // The instance gets all its accessors and internal fields from the
+        // initial map of the constructor, so there is no need to enter
+        // JavaScript to run the construct stub.
+        result = *isolate->factory()->NewJSObject(cons);
+      } else {
+        Handle<Object> value = New(cons, 0, NULL, exc);
+        if (*exc) return Handle<JSObject>::null();
+        result = *value;
+      }
     }
     ASSERT(!*exc);
     return Handle<JSObject>(JSObject::cast(result));
@@ -876,11 +978,20 @@ MaybeObject* Execution::HandleStackGuardInterrupt() {
   Isolate* isolate = Isolate::Current();
   StackGuard* stack_guard = isolate->stack_guard();
 
-  if (stack_guard->IsGCRequest()) {
+  // Interrupts are also handled at loop back edges, which may run inside
+  // an AlwaysAllocateScope, where no collection may start.  The request
+  // then stays pending until the scope is left.
+  if (stack_guard->IsGCRequest() && !isolate->heap()->always_allocate()) {
     isolate->heap()->CollectAllGarbage(false);
     stack_guard->Continue(GC_REQUEST);
   }
 
+  if (stack_guard->IsInstallCodeRequest()) {
+    ASSERT(isolate->optimizing_compiler_thread() != NULL);
+    stack_guard->Continue(INSTALL_CODE);
+    isolate->optimizing_compiler_thread()->InstallOptimizedFunctions();
+  }
+
   isolate->counters()->stack_interrupts()->Increment();
   if (stack_guard->IsRuntimeProfilerTick()) {
     isolate->counters()->runtime_profiler_ticks()->Increment();
@@ -893,6 +1004,15 @@ MaybeObject* Execution::HandleStackGuardInterrupt() {
   }
 #endif
   if (stack_guard->IsPreempted()) RuntimePreempt();
+  if (stack_guard->IsTimeSliceExpired()) {
+    isolate->counters()->time_slice_callbacks()->Increment();
+    v8::TimeSliceCallback callback = stack_guard->time_slice_callback();
+    if (callback != NULL) {
+      VMState state(isolate, EXTERNAL);
+      callback();
+    }
+    stack_guard->RestartTimeSlice();
+  }
   if (stack_guard->IsTerminateExecution()) {
     stack_guard->Continue(TERMINATE);
     return isolate->TerminateExecution();
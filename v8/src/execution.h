@@ -42,7 +42,8 @@ enum InterruptFlag {
   PREEMPT = 1 << 3,
   TERMINATE = 1 << 4,
   RUNTIME_PROFILER_TICK = 1 << 5,
-  GC_REQUEST = 1 << 6
+  GC_REQUEST = 1 << 6,
+  INSTALL_CODE = 1 << 7
 };
 
 class Execution : public AllStatic {
@@ -199,6 +200,20 @@ class StackGuard {
 #endif
   bool IsGCRequest();
   void RequestGC();
+  bool IsInstallCodeRequest();
+  void RequestInstallCode();
+  bool IsTimeSliceExpired();
+  // Called from the time slice timer's signal handler on the thread that
+  // owns this stack guard, so it takes no locks.
+  void TimeSliceExpired();
+  // Starts or stops time slicing for the current thread.  Returns false if
+  // the platform has no per-thread CPU timers.
+  bool SetTimeSlice(int microseconds, v8::TimeSliceCallback callback);
+  v8::TimeSliceCallback time_slice_callback() {
+    return thread_local_.time_slice_callback_;
+  }
+  // Starts a new time slice once the callback has run.
+  void RestartTimeSlice();
   void Continue(InterruptFlag after_what);
 
   // This provides an asynchronous read of the stack limits for the current
@@ -231,7 +246,8 @@ class StackGuard {
     // Sanity check: We shouldn't be asking about pending interrupts
     // unless we're not postponing them anymore.
     ASSERT(!should_postpone_interrupts(lock));
-    return thread_local_.interrupt_flags_ != 0;
+    return thread_local_.interrupt_flags_ != 0 ||
+        thread_local_.time_slice_expired_ != 0;
   }
 
   // You should hold the ExecutionAccess lock when calling this method.
@@ -285,6 +301,13 @@ class StackGuard {
     int nesting_;
     int postpone_interrupts_nesting_;
     int interrupt_flags_;
+
+    // Set by the time slice timer's signal handler.  Kept apart from
+    // interrupt_flags_ so that the handler never races with a
+    // read-modify-write of the flags on the thread it interrupted.
+    volatile int time_slice_expired_;
+    int time_slice_microseconds_;
+    v8::TimeSliceCallback time_slice_callback_;
   };
 
   // TODO(isolates): Technically this could be calculated directly from a
@@ -27,6 +27,10 @@
 
 #include "src/extensions/experimental/collator.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/extensions/experimental/i18n-utils.h"
 #include "unicode/coll.h"
 #include "unicode/locid.h"
 #include "unicode/ucol.h"
@@ -36,6 +40,17 @@ namespace internal {
 
 v8::Persistent<v8::FunctionTemplate> Collator::collator_template_;
 
+// Strings up to this length are copied to the stack for comparison.
+static const int kStackBufferLength = 256;
+
+// Sort keys up to this length are computed on the stack first.
+static const int kStackSortKeyLength = 512;
+
+// Settings that make up the cache key of a collator.
+static const char* const kCollatorSettings[] = {
+  "ignoreCase", "ignoreAccents", "numeric", NULL
+};
+
 icu::Collator* Collator::UnpackCollator(v8::Handle<v8::Object> obj) {
   if (collator_template_->HasInstance(obj)) {
     return static_cast<icu::Collator*>(obj->GetPointerFromInternalField(0));
@@ -93,43 +108,12 @@ static v8::Handle<v8::Value> ThrowExceptionForICUError(const char* message) {
   return v8::ThrowException(v8::Exception::Error(v8::String::New(message)));
 }
 
-v8::Handle<v8::Value> Collator::CollatorCompare(const v8::Arguments& args) {
-  if (args.Length() != 2 || !args[0]->IsString() || !args[1]->IsString()) {
-    return v8::ThrowException(v8::Exception::SyntaxError(
-        v8::String::New("Two string arguments are required.")));
-  }
-
-  icu::Collator* collator = UnpackCollator(args.Holder());
-  if (!collator) {
-    return ThrowUnexpectedObjectError();
-  }
-
-  v8::String::Value string_value1(args[0]);
-  v8::String::Value string_value2(args[1]);
-  const UChar* string1 = reinterpret_cast<const UChar*>(*string_value1);
-  const UChar* string2 = reinterpret_cast<const UChar*>(*string_value2);
-  UErrorCode status = U_ZERO_ERROR;
-  UCollationResult result = collator->compare(
-      string1, string_value1.length(), string2, string_value2.length(), status);
-
-  if (U_FAILURE(status)) {
-    return ThrowExceptionForICUError(
-        "Unexpected failure in Collator.compare.");
-  }
-
-  return v8::Int32::New(result);
-}
-
-v8::Handle<v8::Value> Collator::JSCollator(const v8::Arguments& args) {
-  v8::HandleScope handle_scope;
-
-  if (args.Length() != 2 || !args[0]->IsString() || !args[1]->IsObject()) {
-    return v8::ThrowException(v8::Exception::SyntaxError(
-        v8::String::New("Locale and collation options are required.")));
-  }
-
-  v8::String::AsciiValue locale(args[0]);
-  icu::Locale icu_locale(*locale);
+// Creates a collator for |locale| with the collation options that are
+// explicitly specified.  Returns NULL and sets |error| on failure.
+static icu::Collator* CreateCollator(const char* locale,
+                                     const v8::Local<v8::Object>& options,
+                                     const char** error) {
+  icu::Locale icu_locale(locale);
 
   icu::Collator* collator = NULL;
   UErrorCode status = U_ZERO_ERROR;
@@ -137,11 +121,10 @@ v8::Handle<v8::Value> Collator::JSCollator(const v8::Arguments& args) {
 
   if (U_FAILURE(status)) {
     delete collator;
-    return ThrowExceptionForICUError("Failed to create collator.");
+    *error = "Failed to create collator.";
+    return NULL;
   }
 
-  v8::Local<v8::Object> options(args[1]->ToObject());
-
   // Below, we change collation options that are explicitly specified
   // by a caller in JavaScript. Otherwise, we don't touch because
   // we don't want to change the locale-dependent default value.
@@ -162,7 +145,8 @@ v8::Handle<v8::Value> Collator::JSCollator(const v8::Arguments& args) {
                            status);
     if (U_FAILURE(status)) {
       delete collator;
-      return ThrowExceptionForICUError("Failed to set ignoreCase.");
+      *error = "Failed to set ignoreCase.";
+      return NULL;
     }
   }
 
@@ -180,8 +164,181 @@ v8::Handle<v8::Value> Collator::JSCollator(const v8::Arguments& args) {
                            numeric ? UCOL_ON : UCOL_OFF, status);
     if (U_FAILURE(status)) {
       delete collator;
-      return ThrowExceptionForICUError("Failed to set numeric sort option.");
+      *error = "Failed to set numeric sort option.";
+      return NULL;
+    }
+  }
+
+  return collator;
+}
+
+v8::Handle<v8::Value> Collator::CollatorCompare(const v8::Arguments& args) {
+  if (args.Length() != 2 || !args[0]->IsString() || !args[1]->IsString()) {
+    return v8::ThrowException(v8::Exception::SyntaxError(
+        v8::String::New("Two string arguments are required.")));
+  }
+
+  icu::Collator* collator = UnpackCollator(args.Holder());
+  if (!collator) {
+    return ThrowUnexpectedObjectError();
+  }
+
+  // Identical strings are equal under every collation.
+  if (args[0]->StrictEquals(args[1])) {
+    return v8::Int32::New(UCOL_EQUAL);
+  }
+
+  UErrorCode status = U_ZERO_ERROR;
+  UCollationResult result;
+  v8::Local<v8::String> string1 = args[0]->ToString();
+  v8::Local<v8::String> string2 = args[1]->ToString();
+  int length1 = string1->Length();
+  int length2 = string2->Length();
+  if (length1 <= kStackBufferLength && length2 <= kStackBufferLength) {
+    // Avoid the heap allocations of String::Value for short strings.
+    uint16_t buffer1[kStackBufferLength];
+    uint16_t buffer2[kStackBufferLength];
+    string1->Write(buffer1, 0, length1, v8::String::NO_NULL_TERMINATION);
+    string2->Write(buffer2, 0, length2, v8::String::NO_NULL_TERMINATION);
+    result = collator->compare(reinterpret_cast<const UChar*>(buffer1),
+                               length1,
+                               reinterpret_cast<const UChar*>(buffer2),
+                               length2,
+                               status);
+  } else {
+    v8::String::Value string_value1(string1);
+    v8::String::Value string_value2(string2);
+    result = collator->compare(
+        reinterpret_cast<const UChar*>(*string_value1), string_value1.length(),
+        reinterpret_cast<const UChar*>(*string_value2), string_value2.length(),
+        status);
+  }
+
+  if (U_FAILURE(status)) {
+    return ThrowExceptionForICUError(
+        "Unexpected failure in Collator.compare.");
+  }
+
+  return v8::Int32::New(result);
+}
+
+// An element of the array being sorted and its collation sort key.
+struct SortEntry {
+  uint8_t* key;
+  uint32_t index;
+};
+
+// Sort keys end with a zero byte and compare bytewise.
+static int CompareSortEntries(const void* a, const void* b) {
+  return strcmp(
+      reinterpret_cast<const char*>(static_cast<const SortEntry*>(a)->key),
+      reinterpret_cast<const char*>(static_cast<const SortEntry*>(b)->key));
+}
+
+// Returns a new[] allocated sort key for |string|.
+static uint8_t* GetSortKey(icu::Collator* collator,
+                           v8::Handle<v8::String> string) {
+  v8::String::Value value(string);
+  const UChar* chars = reinterpret_cast<const UChar*>(*value);
+  uint8_t stack_key[kStackSortKeyLength];
+  int32_t length = collator->getSortKey(
+      chars, value.length(), stack_key, kStackSortKeyLength);
+  if (length == 0) {
+    // ICU failed; sort the string first.
+    uint8_t* key = new uint8_t[1];
+    key[0] = 0;
+    return key;
+  }
+  uint8_t* key = new uint8_t[length];
+  if (length <= kStackSortKeyLength) {
+    memcpy(key, stack_key, length);
+  } else {
+    collator->getSortKey(chars, value.length(), key, length);
+  }
+  return key;
+}
+
+v8::Handle<v8::Value> Collator::CollatorSort(const v8::Arguments& args) {
+  v8::HandleScope handle_scope;
+
+  if (args.Length() != 1 || !args[0]->IsArray()) {
+    return v8::ThrowException(v8::Exception::SyntaxError(
+        v8::String::New("An array argument is required.")));
+  }
+
+  icu::Collator* collator = UnpackCollator(args.Holder());
+  if (!collator) {
+    return ThrowUnexpectedObjectError();
+  }
+
+  // Each element is converted to a string and gets a sort key once, so
+  // sorting costs one ICU call per element instead of two string
+  // conversions and a collation per comparison.
+  v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(args[0]);
+  uint32_t length = array->Length();
+  v8::Local<v8::Array> strings = v8::Array::New(length);
+  SortEntry* entries = new SortEntry[length];
+  uint32_t count = 0;
+  v8::TryCatch try_catch;
+  for (uint32_t i = 0; i < length; ++i) {
+    v8::Local<v8::Value> value = array->Get(i);
+    if (try_catch.HasCaught()) break;
+    // Undefined values and holes go to the end, as in Array.prototype.sort.
+    if (value->IsUndefined()) continue;
+    v8::Local<v8::String> string = value->ToString();
+    if (try_catch.HasCaught()) break;
+    strings->Set(count, value);
+    entries[count].key = GetSortKey(collator, string);
+    entries[count].index = count;
+    ++count;
+  }
+
+  if (!try_catch.HasCaught()) {
+    qsort(entries, count, sizeof(entries[0]), CompareSortEntries);
+    for (uint32_t i = 0; i < count; ++i) {
+      array->Set(i, strings->Get(entries[i].index));
+    }
+    for (uint32_t i = count; i < length; ++i) {
+      array->Set(i, v8::Undefined());
+    }
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    delete[] entries[i].key;
+  }
+  delete[] entries;
+
+  if (try_catch.HasCaught()) {
+    return try_catch.ReThrow();
+  }
+  return handle_scope.Close(array);
+}
+
+v8::Handle<v8::Value> Collator::JSCollator(const v8::Arguments& args) {
+  v8::HandleScope handle_scope;
+
+  if (args.Length() != 2 || !args[0]->IsString() || !args[1]->IsObject()) {
+    return v8::ThrowException(v8::Exception::SyntaxError(
+        v8::String::New("Locale and collation options are required.")));
+  }
+
+  v8::String::AsciiValue locale(args[0]);
+  v8::Local<v8::Object> options(args[1]->ToObject());
+
+  icu::UnicodeString key;
+  I18NCache::MakeKey(*locale, options, kCollatorSettings, &key);
+  icu::Collator* collator = NULL;
+  icu::Collator* cached_collator = static_cast<icu::Collator*>(
+      I18NCache::Lookup(I18NCache::kCollator, key));
+  if (cached_collator != NULL) {
+    collator = cached_collator->clone();
+  } else {
+    const char* error = NULL;
+    collator = CreateCollator(*locale, options, &error);
+    if (!collator) {
+      return ThrowExceptionForICUError(error);
     }
+    I18NCache::Insert(I18NCache::kCollator, key, collator->clone());
   }
 
   if (collator_template_.IsEmpty()) {
@@ -199,6 +356,8 @@ v8::Handle<v8::Value> Collator::JSCollator(const v8::Arguments& args) {
     v8::Local<v8::ObjectTemplate> proto = raw_template->PrototypeTemplate();
     proto->Set(v8::String::New("compare"),
                v8::FunctionTemplate::New(CollatorCompare));
+    proto->Set(v8::String::New("sort"),
+               v8::FunctionTemplate::New(CollatorSort));
 
     collator_template_ =
         v8::Persistent<v8::FunctionTemplate>::New(raw_template);
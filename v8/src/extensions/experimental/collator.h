@@ -57,6 +57,10 @@ class Collator {
   // whether string1 is smaller than, equal to or larger than string2.
   static v8::Handle<v8::Value> CollatorCompare(const v8::Arguments& args);
 
+  // Sorts an array in place with this collator, like Array.prototype.sort
+  // with compare as the comparison function, and returns it.
+  static v8::Handle<v8::Value> CollatorSort(const v8::Arguments& args);
+
  private:
   Collator() {}
 
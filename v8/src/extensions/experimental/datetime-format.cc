@@ -30,6 +30,7 @@
 #include <string.h>
 
 #include "src/extensions/experimental/i18n-utils.h"
+#include "unicode/calendar.h"
 #include "unicode/dtfmtsym.h"
 #include "unicode/dtptngen.h"
 #include "unicode/locid.h"
@@ -40,6 +41,12 @@ namespace internal {
 
 v8::Persistent<v8::FunctionTemplate> DateTimeFormat::datetime_format_template_;
 
+// Settings that make up the cache key of a date time format, see
+// CreateDateTimeFormat.
+static const char* const kDateTimeFormatSettings[] = {
+  "skeleton", "dateStyle", "timeStyle", NULL
+};
+
 static icu::DateFormat* CreateDateTimeFormat(v8::Handle<v8::String>,
                                              v8::Handle<v8::Object>);
 static v8::Handle<v8::Value> GetSymbols(
@@ -80,14 +87,9 @@ v8::Handle<v8::Value> DateTimeFormat::Format(const v8::Arguments& args) {
 
   double millis = 0.0;
   if (args.Length() != 1 || !args[0]->IsDate()) {
-    // Create a new date.
-    v8::TryCatch try_catch;
-    v8::Local<v8::Script> date_script =
-        v8::Script::Compile(v8::String::New("eval('new Date()')"));
-    millis = date_script->Run()->NumberValue();
-    if (try_catch.HasCaught()) {
-      return try_catch.ReThrow();
-    }
+    // Format the current time, which ICU reads as new Date() would,
+    // instead of compiling a script for every call.
+    millis = icu::Calendar::getNow();
   } else {
     millis = v8::Date::Cast(*args[0])->NumberValue();
   }
@@ -211,8 +213,21 @@ v8::Handle<v8::Value> DateTimeFormat::JSDateTimeFormat(
         v8::String::New("Locale and date/time options are required.")));
   }
 
-  icu::SimpleDateFormat* date_format = static_cast<icu::SimpleDateFormat*>(
-      CreateDateTimeFormat(args[0]->ToString(), args[1]->ToObject()));
+  v8::String::AsciiValue ascii_locale(args[0]);
+  icu::UnicodeString key;
+  I18NCache::MakeKey(
+      *ascii_locale, args[1]->ToObject(), kDateTimeFormatSettings, &key);
+
+  icu::SimpleDateFormat* date_format = NULL;
+  icu::SimpleDateFormat* cached_format = static_cast<icu::SimpleDateFormat*>(
+      I18NCache::Lookup(I18NCache::kDateTimeFormat, key));
+  if (cached_format != NULL) {
+    date_format = static_cast<icu::SimpleDateFormat*>(cached_format->clone());
+  } else {
+    date_format = static_cast<icu::SimpleDateFormat*>(
+        CreateDateTimeFormat(args[0]->ToString(), args[1]->ToObject()));
+    I18NCache::Insert(I18NCache::kDateTimeFormat, key, date_format->clone());
+  }
 
   if (datetime_format_template_.IsEmpty()) {
     v8::Local<v8::FunctionTemplate> raw_template(v8::FunctionTemplate::New());
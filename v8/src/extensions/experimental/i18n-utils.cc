@@ -84,4 +84,58 @@ void I18NUtils::AsciiToUChar(const char* source,
   target[length - 1] = 0x0u;
 }
 
+I18NCache::Entry I18NCache::entries_[I18NCache::kSize];
+int I18NCache::next_ = 0;
+
+// static
+void I18NCache::MakeKey(const char* locale,
+                        const v8::Handle<v8::Object>& settings,
+                        const char* const* setting_names,
+                        icu::UnicodeString* key) {
+  v8::HandleScope handle_scope;
+
+  key->setTo(icu::UnicodeString(locale, -1, US_INV));
+  for (const char* const* name = setting_names; *name != NULL; ++name) {
+    v8::TryCatch try_catch;
+    v8::Handle<v8::Value> value = settings->Get(v8::String::New(*name));
+    if (try_catch.HasCaught()) continue;
+    // Other values are ignored when the ICU objects are created.
+    if (!value->IsString() && !value->IsBoolean()) continue;
+    v8::String::Value string_value(value);
+    key->append(static_cast<UChar>(value->IsString() ? 0x1 : 0x2));
+    key->append(icu::UnicodeString(*name, -1, US_INV));
+    key->append(static_cast<UChar>('='));
+    key->append(reinterpret_cast<const UChar*>(*string_value),
+                string_value.length());
+  }
+}
+
+// static
+icu::UObject* I18NCache::Lookup(Kind kind, const icu::UnicodeString& key) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  for (int i = 0; i < kSize; ++i) {
+    Entry* entry = &entries_[i];
+    if (entry->object != NULL && entry->isolate == isolate &&
+        entry->kind == kind && *entry->key == key) {
+      return entry->object;
+    }
+  }
+  return NULL;
+}
+
+// static
+void I18NCache::Insert(Kind kind,
+                       const icu::UnicodeString& key,
+                       icu::UObject* object) {
+  Entry* entry = &entries_[next_];
+  next_ = (next_ + 1) % kSize;
+
+  delete entry->object;
+  delete entry->key;
+  entry->isolate = v8::Isolate::GetCurrent();
+  entry->kind = kind;
+  entry->key = new icu::UnicodeString(key);
+  entry->object = object;
+}
+
 } }  // namespace v8::internal
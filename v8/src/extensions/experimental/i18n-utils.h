@@ -33,6 +33,7 @@
 #include "unicode/uversion.h"
 
 namespace U_ICU_NAMESPACE {
+class UObject;
 class UnicodeString;
 }
 
@@ -64,6 +65,52 @@ class I18NUtils {
   I18NUtils() {}
 };
 
+// Caches ICU objects by isolate, kind, locale and settings.  Creating an
+// ICU collator or formatter loads and parses locale data, so JavaScript
+// wrappers get clones of the cached objects instead.  The cache owns its
+// objects and deletes the oldest one when it is full; the wrappers own
+// their clones.  Like the wrapper templates, the cache is not synchronized
+// between threads.
+class I18NCache {
+ public:
+  enum Kind {
+    kCollator,
+    kNumberFormat,
+    kDateTimeFormat
+  };
+
+  // Makes a cache key from the locale and the string and boolean values of
+  // the named settings.  |setting_names| ends with NULL.
+  static void MakeKey(const char* locale,
+                      const v8::Handle<v8::Object>& settings,
+                      const char* const* setting_names,
+                      icu::UnicodeString* key);
+
+  // Returns the object cached for the current isolate, or NULL.
+  static icu::UObject* Lookup(Kind kind, const icu::UnicodeString& key);
+
+  // Caches |object| for the current isolate and takes ownership of it.
+  static void Insert(Kind kind,
+                     const icu::UnicodeString& key,
+                     icu::UObject* object);
+
+ private:
+  struct Entry {
+    v8::Isolate* isolate;
+    Kind kind;
+    icu::UnicodeString* key;
+    icu::UObject* object;
+  };
+
+  static const int kSize = 64;
+
+  static Entry entries_[kSize];
+  // Index of the entry to replace next.
+  static int next_;
+
+  I18NCache() {}
+};
+
 } }  // namespace v8::internal
 
 #endif  // V8_EXTENSIONS_EXPERIMENTAL_I18N_UTILS_H_
@@ -46,6 +46,12 @@ const int NumberFormat::kCurrencyCodeLength = 4;
 
 v8::Persistent<v8::FunctionTemplate> NumberFormat::number_format_template_;
 
+// Settings that make up the cache key of a number format, see
+// CreateNumberFormat.
+static const char* const kNumberFormatSettings[] = {
+  "skeleton", "pattern", "style", "currencyCode", NULL
+};
+
 static icu::DecimalFormat* CreateNumberFormat(v8::Handle<v8::String>,
                                               v8::Handle<v8::String>,
                                               v8::Handle<v8::Object>);
@@ -97,8 +103,13 @@ v8::Handle<v8::Value> NumberFormat::Format(const v8::Arguments& args) {
   }
 
   // ICU will handle actual NaN value properly and return NaN string.
+  // Integers take ICU's cheaper integer path.
   icu::UnicodeString result;
-  number_format->format(args[0]->NumberValue(), result);
+  if (args[0]->IsInt32()) {
+    number_format->format(args[0]->Int32Value(), result);
+  } else {
+    number_format->format(args[0]->NumberValue(), result);
+  }
 
   return v8::String::New(
       reinterpret_cast<const uint16_t*>(result.getBuffer()), result.length());
@@ -114,8 +125,25 @@ v8::Handle<v8::Value> NumberFormat::JSNumberFormat(const v8::Arguments& args) {
         v8::String::New("Locale, region and number settings are required.")));
   }
 
-  icu::DecimalFormat* number_format = CreateNumberFormat(
-      args[0]->ToString(), args[1]->ToString(), args[2]->ToObject());
+  // The region only matters for the currency code.
+  v8::String::AsciiValue ascii_locale(args[0]);
+  v8::String::AsciiValue ascii_region(args[1]);
+  icu::UnicodeString key;
+  I18NCache::MakeKey(
+      *ascii_locale, args[2]->ToObject(), kNumberFormatSettings, &key);
+  key.append(static_cast<UChar>(0x3));
+  key.append(icu::UnicodeString(*ascii_region, -1, US_INV));
+
+  icu::DecimalFormat* number_format = NULL;
+  icu::DecimalFormat* cached_format = static_cast<icu::DecimalFormat*>(
+      I18NCache::Lookup(I18NCache::kNumberFormat, key));
+  if (cached_format != NULL) {
+    number_format = static_cast<icu::DecimalFormat*>(cached_format->clone());
+  } else {
+    number_format = CreateNumberFormat(
+        args[0]->ToString(), args[1]->ToString(), args[2]->ToObject());
+    I18NCache::Insert(I18NCache::kNumberFormat, key, number_format->clone());
+  }
 
   if (number_format_template_.IsEmpty()) {
     v8::Local<v8::FunctionTemplate> raw_template(v8::FunctionTemplate::New());
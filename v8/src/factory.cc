@@ -101,6 +101,14 @@ Handle<ObjectHashTable> Factory::NewObjectHashTable(int at_least_space_for) {
 }
 
 
+Handle<OrderedHashTable> Factory::NewOrderedHashTable(int at_least_space_for) {
+  ASSERT(0 <= at_least_space_for);
+  CALL_HEAP_FUNCTION(isolate(),
+                     OrderedHashTable::Allocate(at_least_space_for),
+                     OrderedHashTable);
+}
+
+
 Handle<DescriptorArray> Factory::NewDescriptorArray(int number_of_descriptors) {
   ASSERT(0 <= number_of_descriptors);
   CALL_HEAP_FUNCTION(isolate(),
@@ -145,6 +153,13 @@ Handle<String> Factory::LookupSymbol(Handle<String> string) {
                      String);
 }
 
+// Atoms are interned and created in the old generation.
+Handle<Atom> Factory::LookupAtom(Handle<String> name) {
+  CALL_HEAP_FUNCTION(isolate(),
+                     isolate()->heap()->LookupAtom(*name),
+                     Atom);
+}
+
 Handle<String> Factory::LookupAsciiSymbol(Vector<const char> string) {
   CALL_HEAP_FUNCTION(isolate(),
                      isolate()->heap()->LookupAsciiSymbol(string),
@@ -214,14 +229,118 @@ Handle<SeqTwoByteString> Factory::NewRawTwoByteString(int length,
 }
 
 
+// Rebalances cons trees the way Boehm, Atkinson and Plass rebalance ropes.
+// A tree is balanced if its length is at least the (depth + 2)th Fibonacci
+// number.  Balanced subtrees are added from left to right to a forest whose
+// i-th slot holds a tree at least min_length_[i] long; concatenating the
+// forest yields a balanced tree.  Every cons cell is allocated on its own,
+// so a garbage collection may happen between any two of them.
+class ConsStringBalancer {
+ public:
+  explicit ConsStringBalancer(Isolate* isolate) : isolate_(isolate) {
+    min_length_[0] = 1;
+    min_length_[1] = 2;
+    for (int i = 2; i < kForestSize; i++) {
+      if (min_length_[i - 1] > String::kMaxLength) {
+        min_length_[i] = min_length_[i - 1];
+      } else {
+        min_length_[i] = min_length_[i - 1] + min_length_[i - 2];
+      }
+    }
+  }
+
+  bool IsBalanced(String* string) {
+    int depth = ConsString::DepthOf(string);
+    return depth == 0 ||
+        (depth < kForestSize && string->length() >= min_length_[depth]);
+  }
+
+  void Add(Handle<String> part) {
+    int length = part->length();
+    Handle<String> sum = isolate_->factory()->empty_string();
+    int i = 0;
+    while (length > min_length_[i + 1]) {
+      if (!forest_[i].is_null()) {
+        sum = Concatenate(forest_[i], sum);
+        forest_[i] = Handle<String>::null();
+      }
+      i++;
+    }
+    sum = Concatenate(sum, part);
+    while (sum->length() >= min_length_[i]) {
+      if (!forest_[i].is_null()) {
+        sum = Concatenate(forest_[i], sum);
+        forest_[i] = Handle<String>::null();
+      }
+      i++;
+    }
+    forest_[i - 1] = sum;
+  }
+
+  Handle<String> Result() {
+    Handle<String> sum = isolate_->factory()->empty_string();
+    for (int i = 0; i < kForestSize; i++) {
+      if (!forest_[i].is_null()) sum = Concatenate(forest_[i], sum);
+    }
+    return sum;
+  }
+
+ private:
+  // Lengths are bounded by String::kMaxLength, so the Fibonacci numbers
+  // exceed it long before the last slot.
+  static const int kForestSize = 48;
+
+  Handle<String> Concatenate(Handle<String> first, Handle<String> second) {
+    CALL_HEAP_FUNCTION(isolate_,
+                       isolate_->heap()->AllocateConsString(*first, *second),
+                       String);
+  }
+
+  Isolate* isolate_;
+  int min_length_[kForestSize];
+  Handle<String> forest_[kForestSize];
+};
+
+
 Handle<String> Factory::NewConsString(Handle<String> first,
                                       Handle<String> second) {
+  // Repeated appends to the same string produce a list-shaped tree which
+  // makes every later traversal proportional to the number of appends.
+  int depth =
+      Max(ConsString::DepthOf(*first), ConsString::DepthOf(*second)) + 1;
+  if (depth > ConsString::kMaxDepth) {
+    return NewBalancedConsString(first, second);
+  }
   CALL_HEAP_FUNCTION(isolate(),
                      isolate()->heap()->AllocateConsString(*first, *second),
                      String);
 }
 
 
+Handle<String> Factory::NewBalancedConsString(Handle<String> first,
+                                              Handle<String> second) {
+  // Walk the unbalanced part of the tree with an explicit stack, so that
+  // deep trees on either side do not recurse on the C++ stack.
+  HandleScope scope(isolate());
+  ConsStringBalancer balancer(isolate());
+  List<Handle<String> > stack;
+  stack.Add(second);
+  stack.Add(first);
+  while (!stack.is_empty()) {
+    Handle<String> current = stack.RemoveLast();
+    if (balancer.IsBalanced(*current)) {
+      balancer.Add(current);
+    } else {
+      Handle<ConsString> cons = Handle<ConsString>::cast(current);
+      stack.Add(Handle<String>(cons->second(), isolate()));
+      stack.Add(Handle<String>(cons->first(), isolate()));
+    }
+  }
+  isolate()->counters()->cons_strings_rebalanced()->Increment();
+  return scope.CloseAndEscape(balancer.Result());
+}
+
+
 Handle<String> Factory::NewSubString(Handle<String> str,
                                      int begin,
                                      int end) {
@@ -1317,7 +1436,8 @@ void Factory::SetRegExpIrregexpData(Handle<JSRegExp> regexp,
                                     JSRegExp::Type type,
                                     Handle<String> source,
                                     JSRegExp::Flags flags,
-                                    int capture_count) {
+                                    int capture_count,
+                                    Handle<String> literal_prefix) {
   Handle<FixedArray> store = NewFixedArray(JSRegExp::kIrregexpDataSize);
   Smi* uninitialized = Smi::FromInt(JSRegExp::kUninitializedValue);
   store->set(JSRegExp::kTagIndex, Smi::FromInt(type));
@@ -1330,6 +1450,15 @@ void Factory::SetRegExpIrregexpData(Handle<JSRegExp> regexp,
   store->set(JSRegExp::kIrregexpMaxRegisterCountIndex, Smi::FromInt(0));
   store->set(JSRegExp::kIrregexpCaptureCountIndex,
              Smi::FromInt(capture_count));
+  if (literal_prefix.is_null()) {
+    store->set(JSRegExp::kIrregexpLiteralPrefixIndex, Smi::FromInt(0));
+  } else {
+    store->set(JSRegExp::kIrregexpLiteralPrefixIndex, *literal_prefix);
+  }
+  store->set(JSRegExp::kIrregexpASCIIBytecodeIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpUC16BytecodeIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpExecutionCountIndex, Smi::FromInt(0));
+  store->set(JSRegExp::kIrregexpSubjectLengthIndex, Smi::FromInt(0));
   regexp->set_data(*store);
 }
 
@@ -62,6 +62,8 @@ class Factory {
 
   Handle<ObjectHashTable> NewObjectHashTable(int at_least_space_for);
 
+  Handle<OrderedHashTable> NewOrderedHashTable(int at_least_space_for);
+
   Handle<DescriptorArray> NewDescriptorArray(int number_of_descriptors);
   Handle<DeoptimizationInputData> NewDeoptimizationInputData(
       int deopt_entry_count,
@@ -72,6 +74,7 @@ class Factory {
 
   Handle<String> LookupSymbol(Vector<const char> str);
   Handle<String> LookupSymbol(Handle<String> str);
+  Handle<Atom> LookupAtom(Handle<String> name);
   Handle<String> LookupAsciiSymbol(Vector<const char> str);
   Handle<String> LookupAsciiSymbol(Handle<SeqAsciiString>,
                                    int from,
@@ -129,6 +132,8 @@ class Factory {
       PretenureFlag pretenure = NOT_TENURED);
 
   // Create a new cons string object which consists of a pair of strings.
+  // Concatenations that would get deeper than ConsString::kMaxDepth
+  // rebuild the tree as a balanced one.
   Handle<String> NewConsString(Handle<String> first,
                                Handle<String> second);
 
@@ -451,7 +456,8 @@ class Factory {
                              JSRegExp::Type type,
                              Handle<String> source,
                              JSRegExp::Flags flags,
-                             int capture_count);
+                             int capture_count,
+                             Handle<String> literal_prefix);
 
   // Returns the value for a known global constant (a property of the global
   // object which is neither configurable nor writable) like 'undefined'.
@@ -471,6 +477,9 @@ class Factory {
       Handle<String> name,
       LanguageMode language_mode);
 
+  Handle<String> NewBalancedConsString(Handle<String> first,
+                                       Handle<String> second);
+
   Handle<DescriptorArray> CopyAppendCallbackDescriptors(
       Handle<DescriptorArray> array,
       Handle<Object> descriptors);
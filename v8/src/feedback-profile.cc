@@ -0,0 +1,435 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "feedback-profile.h"
+
+#include "char-predicates-inl.h"
+#include "code-stubs.h"
+#include "ic-inl.h"
+#include "string-stream.h"
+#include "v8utils.h"
+#include "version.h"
+
+namespace v8 {
+namespace internal {
+
+// The textual profile format is line based.  It starts with
+//
+//   v8-feedback-profile <format version> <V8 version>
+//
+// because ast ids and IC state encodings change between V8 versions.  A
+// function is described by
+//
+//   f <start position> <length> <flags> <script name>
+//
+// followed by one line per recorded IC
+//
+//   i <code kind> <ast id> <state>
+static const char* const kProfileMagic = "v8-feedback-profile 2";
+static const int kOptimizedFlag = 1 << 0;
+static const int kUsedOnStackReplacementFlag = 1 << 1;
+
+
+FeedbackProfileEntry::FeedbackProfileEntry(const char* script_name,
+                                           int start_position,
+                                           int length)
+    : script_name_(StrDup(script_name)),
+      start_position_(start_position),
+      length_(length),
+      optimized_(false),
+      used_on_stack_replacement_(false),
+      ics_(0) {
+}
+
+
+FeedbackProfileEntry::~FeedbackProfileEntry() {
+  DeleteArray(script_name_);
+}
+
+
+int FeedbackProfileEntry::CompareICRecords(const ICRecord* a,
+                                           const ICRecord* b) {
+  if (a->ast_id < b->ast_id) return -1;
+  if (a->ast_id > b->ast_id) return 1;
+  return 0;
+}
+
+
+int FeedbackProfileEntry::ICState(Code::Kind kind, unsigned ast_id) {
+  int low = 0;
+  int high = ics_.length() - 1;
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    const ICRecord& record = ics_[mid];
+    if (record.ast_id < ast_id) {
+      low = mid + 1;
+    } else if (record.ast_id > ast_id) {
+      high = mid - 1;
+    } else {
+      return record.kind == kind ? record.state : 0;
+    }
+  }
+  return 0;
+}
+
+
+FeedbackProfile::FeedbackProfile(Isolate* isolate)
+    : isolate_(isolate),
+      entries_(MatchEntries) {
+}
+
+
+FeedbackProfile::~FeedbackProfile() {
+  Clear();
+}
+
+
+void FeedbackProfile::Clear() {
+  for (HashMap::Entry* p = entries_.Start(); p != NULL; p = entries_.Next(p)) {
+    delete reinterpret_cast<FeedbackProfileEntry*>(p->value);
+  }
+  entries_.Clear();
+}
+
+
+bool FeedbackProfile::MatchEntries(void* key1, void* key2) {
+  FeedbackProfileEntry* a = reinterpret_cast<FeedbackProfileEntry*>(key1);
+  FeedbackProfileEntry* b = reinterpret_cast<FeedbackProfileEntry*>(key2);
+  return a->start_position_ == b->start_position_ &&
+      a->length_ == b->length_ &&
+      strcmp(a->script_name_, b->script_name_) == 0;
+}
+
+
+uint32_t FeedbackProfile::Hash(const char* script_name, int start_position) {
+  uint32_t hash = static_cast<uint32_t>(start_position);
+  for (const char* p = script_name; *p != '\0'; p++) {
+    hash = hash * 31 + static_cast<uint32_t>(*p);
+  }
+  return ComputeIntegerHash(hash);
+}
+
+
+FeedbackProfileEntry* FeedbackProfile::Lookup(const char* script_name,
+                                              int start_position,
+                                              int length,
+                                              bool insert) {
+  FeedbackProfileEntry key(script_name, start_position, length);
+  HashMap::Entry* entry = entries_.Lookup(
+      &key, Hash(script_name, start_position), insert);
+  if (entry == NULL) return NULL;
+  if (entry->value == NULL) {
+    FeedbackProfileEntry* result =
+        new FeedbackProfileEntry(script_name, start_position, length);
+    // The key must outlive the lookup, so it is the entry itself.
+    entry->key = result;
+    entry->value = result;
+  }
+  return reinterpret_cast<FeedbackProfileEntry*>(entry->value);
+}
+
+
+int FeedbackProfile::EncodeICState(Code* target) {
+  switch (target->kind()) {
+    case Code::UNARY_OP_IC:
+      return target->unary_op_type();
+    case Code::BINARY_OP_IC:
+      return target->binary_op_type() |
+          (target->binary_op_result_type() << kBinaryOpResultTypeShift);
+    case Code::COMPARE_IC:
+      return CompareIC::ComputeState(target);
+    case Code::TO_BOOLEAN_IC:
+      return target->to_boolean_state();
+    default:
+      UNREACHABLE();
+      return 0;
+  }
+}
+
+
+bool FeedbackProfile::IsValidICState(Code::Kind kind, int state) {
+  if (state <= 0) return false;
+  switch (kind) {
+    case Code::UNARY_OP_IC:
+      return state <= UnaryOpIC::GENERIC;
+    case Code::BINARY_OP_IC:
+      return (state & kBinaryOpTypeMask) <= BinaryOpIC::GENERIC &&
+          (state >> kBinaryOpResultTypeShift) <= BinaryOpIC::GENERIC;
+    case Code::COMPARE_IC:
+      return state <= CompareIC::GENERIC;
+    case Code::TO_BOOLEAN_IC:
+      return state < (1 << ToBooleanStub::NUMBER_OF_TYPES);
+    default:
+      return false;
+  }
+}
+
+
+// Returns the profile header of this V8 version, including the newline.
+static SmartArrayPointer<const char> ProfileHeader() {
+  HeapStringAllocator allocator;
+  StringStream stream(&allocator);
+  stream.Add("%s %s\n", kProfileMagic, Version::GetVersion());
+  return stream.ToCString();
+}
+
+
+// Returns the name of the script the function belongs to if the function
+// can be identified in another process, or NULL.
+static String* ProfiledScriptName(SharedFunctionInfo* shared) {
+  if (!shared->script()->IsScript()) return NULL;
+  Script* script = Script::cast(shared->script());
+  if (script->type()->value() != Script::TYPE_NORMAL) return NULL;
+  if (!script->name()->IsString()) return NULL;
+  return String::cast(script->name());
+}
+
+
+FeedbackProfileEntry* FeedbackProfile::Find(SharedFunctionInfo* shared) {
+  String* name = ProfiledScriptName(shared);
+  if (name == NULL) return NULL;
+  SmartArrayPointer<char> name_chars = name->ToCString();
+  return Lookup(*name_chars,
+                shared->start_position(),
+                shared->end_position() - shared->start_position(),
+                false);
+}
+
+
+void FeedbackProfile::ApplyTo(SharedFunctionInfo* shared) {
+  FeedbackProfileEntry* entry = Find(shared);
+  if (entry == NULL) return;
+  if (entry->optimized_) shared->set_optimize_from_profile(true);
+  if (entry->used_on_stack_replacement_) {
+    shared->set_used_on_stack_replacement(true);
+  }
+}
+
+
+void FeedbackProfile::RecordFunction(SharedFunctionInfo* shared) {
+  String* name = ProfiledScriptName(shared);
+  if (name == NULL || !shared->is_compiled()) return;
+  Code* code = shared->code();
+  if (code->kind() != Code::FUNCTION) return;
+
+  SmartArrayPointer<char> name_chars = name->ToCString();
+  // Newlines delimit records; such names cannot be saved.
+  if (strchr(*name_chars, '\n') != NULL) return;
+  int start_position = shared->start_position();
+  int length = shared->end_position() - start_position;
+  FeedbackProfileEntry* old_entry =
+      Lookup(*name_chars, start_position, length, false);
+  bool optimized = shared->opt_count() > 0 || shared->optimize_from_profile();
+  bool used_osr = shared->used_on_stack_replacement();
+
+  List<FeedbackProfileEntry::ICRecord> ics;
+  int mask = RelocInfo::ModeMask(RelocInfo::CODE_TARGET_WITH_ID);
+  for (RelocIterator it(code, mask); !it.done(); it.next()) {
+    RelocInfo* info = it.rinfo();
+    Code* target = Code::GetCodeFromTargetAddress(info->target_address());
+    if (target->kind() != Code::UNARY_OP_IC &&
+        target->kind() != Code::BINARY_OP_IC &&
+        target->kind() != Code::COMPARE_IC &&
+        target->kind() != Code::TO_BOOLEAN_IC) {
+      continue;
+    }
+    FeedbackProfileEntry::ICRecord record;
+    record.ast_id = static_cast<unsigned>(info->data());
+    record.kind = target->kind();
+    record.state = EncodeICState(target);
+    // Keep the recorded state of ICs that were not reached in this run.
+    if (record.state == 0 && old_entry != NULL) {
+      record.state = old_entry->ICState(record.kind, record.ast_id);
+    }
+    if (record.state != 0) ics.Add(record);
+  }
+  if (!optimized && !used_osr && ics.is_empty() && old_entry == NULL) return;
+
+  FeedbackProfileEntry* entry =
+      Lookup(*name_chars, start_position, length, true);
+  entry->optimized_ = optimized;
+  entry->used_on_stack_replacement_ = used_osr;
+  entry->ics_.Clear();
+  entry->ics_.AddAll(ics);
+  entry->ics_.Sort(FeedbackProfileEntry::CompareICRecords);
+}
+
+
+void FeedbackProfile::Record() {
+  isolate_->heap()->EnsureHeapIsIterable();
+  HeapIterator iterator;
+  AssertNoAllocation no_allocation;
+  for (HeapObject* obj = iterator.next(); obj != NULL; obj = iterator.next()) {
+    if (!obj->IsSharedFunctionInfo()) continue;
+    RecordFunction(SharedFunctionInfo::cast(obj));
+  }
+}
+
+
+SmartArrayPointer<const char> FeedbackProfile::Serialize() {
+  HeapStringAllocator allocator;
+  StringStream stream(&allocator);
+  stream.Add("%s", *ProfileHeader());
+  for (HashMap::Entry* p = entries_.Start(); p != NULL; p = entries_.Next(p)) {
+    FeedbackProfileEntry* entry =
+        reinterpret_cast<FeedbackProfileEntry*>(p->value);
+    int flags = 0;
+    if (entry->optimized_) flags |= kOptimizedFlag;
+    if (entry->used_on_stack_replacement_) {
+      flags |= kUsedOnStackReplacementFlag;
+    }
+    stream.Add("f %d %d %d ", entry->start_position_, entry->length_, flags);
+    stream.Add("%s\n", entry->script_name_);
+    for (int i = 0; i < entry->ics_.length(); i++) {
+      const FeedbackProfileEntry::ICRecord& record = entry->ics_[i];
+      stream.Add("i %d %d %d\n",
+                 static_cast<int>(record.kind),
+                 static_cast<int>(record.ast_id),
+                 record.state);
+    }
+  }
+  return stream.ToCString();
+}
+
+
+// Reads the textual profile format.
+class ProfileReader {
+ public:
+  explicit ProfileReader(Vector<const char> data) : data_(data), pos_(0) { }
+
+  bool done() { return pos_ >= data_.length(); }
+
+  bool Expect(char c) {
+    if (done() || data_[pos_] != c) return false;
+    pos_++;
+    return true;
+  }
+
+  bool ReadInt(int* value) {
+    bool negative = Expect('-');
+    if (done() || !IsDecimalDigit(data_[pos_])) return false;
+    int result = 0;
+    while (!done() && IsDecimalDigit(data_[pos_])) {
+      if (result > (kMaxInt - 9) / 10) return false;
+      result = result * 10 + (data_[pos_++] - '0');
+    }
+    *value = negative ? -result : result;
+    return true;
+  }
+
+  // Reads up to the end of the line, consuming the newline.
+  bool ReadLine(Vector<const char>* line) {
+    int start = pos_;
+    while (!done() && data_[pos_] != '\n') pos_++;
+    if (done()) return false;
+    *line = data_.SubVector(start, pos_++);
+    return true;
+  }
+
+ private:
+  Vector<const char> data_;
+  int pos_;
+};
+
+
+bool FeedbackProfile::Deserialize(Vector<const char> data) {
+  Clear();
+  SmartArrayPointer<const char> header = ProfileHeader();
+  int header_length = StrLength(*header);
+  if (data.length() < header_length ||
+      strncmp(data.start(), *header, header_length) != 0) {
+    return false;
+  }
+  ProfileReader reader(data.SubVector(header_length, data.length()));
+  FeedbackProfileEntry* entry = NULL;
+  while (!reader.done()) {
+    if (reader.Expect('f')) {
+      int start_position, length, flags;
+      Vector<const char> name;
+      if (!reader.Expect(' ') || !reader.ReadInt(&start_position) ||
+          !reader.Expect(' ') || !reader.ReadInt(&length) ||
+          !reader.Expect(' ') || !reader.ReadInt(&flags) ||
+          !reader.Expect(' ') || !reader.ReadLine(&name)) {
+        break;
+      }
+      if (entry != NULL) {
+        entry->ics_.Sort(FeedbackProfileEntry::CompareICRecords);
+      }
+      SmartArrayPointer<char> name_chars(StrNDup(name.start(), name.length()));
+      entry = Lookup(*name_chars, start_position, length, true);
+      entry->optimized_ = (flags & kOptimizedFlag) != 0;
+      entry->used_on_stack_replacement_ =
+          (flags & kUsedOnStackReplacementFlag) != 0;
+    } else if (reader.Expect('i')) {
+      int kind, ast_id, state;
+      if (entry == NULL ||
+          !reader.Expect(' ') || !reader.ReadInt(&kind) ||
+          !reader.Expect(' ') || !reader.ReadInt(&ast_id) ||
+          !reader.Expect(' ') || !reader.ReadInt(&state) ||
+          !reader.Expect('\n')) {
+        break;
+      }
+      // The states are cast to the IC's enums when used, so anything the
+      // running V8 could not have recorded is rejected.
+      if (!IsValidICState(static_cast<Code::Kind>(kind), state)) break;
+      FeedbackProfileEntry::ICRecord record;
+      record.ast_id = static_cast<unsigned>(ast_id);
+      record.kind = static_cast<Code::Kind>(kind);
+      record.state = state;
+      entry->ics_.Add(record);
+    } else {
+      break;
+    }
+  }
+  if (!reader.done()) {
+    Clear();
+    return false;
+  }
+  if (entry != NULL) entry->ics_.Sort(FeedbackProfileEntry::CompareICRecords);
+  return true;
+}
+
+
+bool FeedbackProfile::Save(const char* filename) {
+  SmartArrayPointer<const char> data = Serialize();
+  int length = StrLength(*data);
+  return WriteChars(filename, *data, length) == length;
+}
+
+
+bool FeedbackProfile::Load(const char* filename) {
+  bool exists;
+  Vector<const char> data = ReadFile(filename, &exists, false);
+  if (!exists) return false;
+  bool result = Deserialize(data);
+  data.Dispose();
+  return result;
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,148 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_FEEDBACK_PROFILE_H_
+#define V8_FEEDBACK_PROFILE_H_
+
+#include "allocation.h"
+#include "hashmap.h"
+#include "ic.h"
+#include "list.h"
+#include "objects.h"
+
+namespace v8 {
+namespace internal {
+
+// The type feedback and optimization decisions recorded for one function.
+// Functions are identified by script name, start position and source
+// length, which stay stable across processes running the same sources.
+class FeedbackProfileEntry {
+ public:
+  FeedbackProfileEntry(const char* script_name,
+                       int start_position,
+                       int length);
+  ~FeedbackProfileEntry();
+
+  // Returns the recorded state of the IC of the given kind at ast_id,
+  // encoded as by FeedbackProfile::EncodeICState, or 0 if none is recorded.
+  int ICState(Code::Kind kind, unsigned ast_id);
+
+ private:
+  struct ICRecord {
+    unsigned ast_id;
+    Code::Kind kind;
+    int state;
+  };
+
+  static int CompareICRecords(const ICRecord* a, const ICRecord* b);
+
+  char* script_name_;
+  int start_position_;
+  int length_;
+  bool optimized_;
+  bool used_on_stack_replacement_;
+  // Sorted by ast id.
+  List<ICRecord> ics_;
+
+  friend class FeedbackProfile;
+
+  DISALLOW_COPY_AND_ASSIGN(FeedbackProfileEntry);
+};
+
+
+// A feedback profile holds the state of the map-independent ICs (unary,
+// binary, compare and ToBoolean) of all functions of an isolate, together
+// with whether they got optimized and entered optimized code through
+// on-stack replacement.  A profile saved when one process exits can be
+// loaded by a fresh isolate: hot functions are then optimized on their
+// first runtime profiler sample, and the type feedback oracle falls back to
+// the recorded states for ICs that have not been reached yet.  States that
+// refer to maps or other heap objects are not persisted.
+class FeedbackProfile {
+ public:
+  explicit FeedbackProfile(Isolate* isolate);
+  ~FeedbackProfile();
+
+  // Records the feedback of all compiled functions in the heap.  Entries of
+  // functions that have not been compiled in this run are kept.
+  void Record();
+
+  // Converts the profile to and from its textual form.  Deserialize returns
+  // false, leaving the profile empty, if the data is malformed or was saved
+  // by a different V8 version.
+  SmartArrayPointer<const char> Serialize();
+  bool Deserialize(Vector<const char> data);
+
+  bool Save(const char* filename);
+  bool Load(const char* filename);
+
+  // Returns the entry recorded for the given function, or NULL.
+  FeedbackProfileEntry* Find(SharedFunctionInfo* shared);
+
+  // Transfers the optimization decisions recorded for a newly created
+  // function to its compiler hints.
+  void ApplyTo(SharedFunctionInfo* shared);
+
+  int length() { return static_cast<int>(entries_.occupancy()); }
+
+  // Returns a non-zero encoding of the state of a unary, binary, compare or
+  // ToBoolean IC, or 0 if the IC is uninitialized.
+  static int EncodeICState(Code* target);
+  // Returns whether state is a non-zero encoding of a state of an IC of the
+  // given kind.
+  static bool IsValidICState(Code::Kind kind, int state);
+  static BinaryOpIC::TypeInfo BinaryOpType(int state) {
+    return static_cast<BinaryOpIC::TypeInfo>(state & kBinaryOpTypeMask);
+  }
+  static BinaryOpIC::TypeInfo BinaryOpResultType(int state) {
+    return static_cast<BinaryOpIC::TypeInfo>(
+        state >> kBinaryOpResultTypeShift);
+  }
+
+ private:
+  static const int kBinaryOpResultTypeShift = kBitsPerByte;
+  static const int kBinaryOpTypeMask = (1 << kBinaryOpResultTypeShift) - 1;
+
+  static bool MatchEntries(void* key1, void* key2);
+  static uint32_t Hash(const char* script_name, int start_position);
+
+  FeedbackProfileEntry* Lookup(const char* script_name,
+                               int start_position,
+                               int length,
+                               bool insert);
+  void RecordFunction(SharedFunctionInfo* shared);
+  void Clear();
+
+  Isolate* isolate_;
+  HashMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(FeedbackProfile);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_FEEDBACK_PROFILE_H_
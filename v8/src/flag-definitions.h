@@ -102,6 +102,8 @@ DEFINE_bool(harmony_scoping, false, "enable harmony block scoping")
 DEFINE_bool(harmony_proxies, false, "enable harmony proxies")
 DEFINE_bool(harmony_collections, false,
             "enable harmony collections (sets, maps, and weak maps)")
+DEFINE_bool(harmony_typed_arrays, false,
+            "enable harmony typed arrays (array buffers and their views)")
 DEFINE_bool(harmony, false, "enable all harmony features")
 
 // Flags for experimental implementation features.
@@ -119,6 +121,8 @@ DEFINE_string(hydrogen_filter, "", "hydrogen use/trace filter")
 DEFINE_bool(use_hydrogen, true, "use generated hydrogen for compilation")
 DEFINE_bool(build_lithium, true, "use lithium chunk builder")
 DEFINE_bool(alloc_lithium, true, "use lithium register allocator")
+DEFINE_bool(optimize_gap_moves, true,
+            "merge gap moves and remove moves into unused spill slots")
 DEFINE_bool(use_lithium, true, "use lithium code generator")
 DEFINE_bool(use_range, true, "use hydrogen range analysis")
 DEFINE_bool(eliminate_dead_phis, true, "eliminate dead phis")
@@ -126,8 +130,46 @@ DEFINE_bool(use_gvn, true, "use hydrogen global value numbering")
 DEFINE_bool(use_canonicalizing, true, "use hydrogen instruction canonicalizing")
 DEFINE_bool(use_inlining, true, "use function inlining")
 DEFINE_bool(limit_inlining, true, "limit code size growth from inlining")
+DEFINE_bool(inline_construct, true,
+            "allocate objects of constructors with simple bodies inline")
+DEFINE_bool(inline_array_builtins, true,
+            "inline Array.prototype.forEach, map and filter and their "
+            "callbacks")
+DEFINE_int(max_inlined_source_size, 600,
+           "maximum source size in bytes considered for a single inlining")
+DEFINE_int(max_inlined_nodes, 196,
+           "maximum number of AST nodes considered for a single inlining")
+DEFINE_int(max_inlined_nodes_cumulative, 392,
+           "maximum cumulative number of AST nodes considered for inlining")
 DEFINE_bool(eliminate_empty_blocks, true, "eliminate empty blocks")
 DEFINE_bool(loop_invariant_code_motion, true, "loop invariant code motion")
+DEFINE_bool(loop_peeling, false,
+            "peel the first iteration of small inner loops")
+DEFINE_int(max_peeled_loop_size, 64,
+           "maximum number of AST nodes in the body of a peeled loop")
+DEFINE_bool(vectorize_double_loops, true,
+            "use packed SSE2 operations for element-wise double array loops")
+DEFINE_bool(array_bounds_checks_elimination, true,
+            "eliminate redundant array bounds checks")
+DEFINE_bool(array_bounds_checks_hoisting, true,
+            "hoist array bounds checks out of loops")
+DEFINE_bool(check_elimination, true,
+            "eliminate map checks implied by dominating checks and transitions")
+DEFINE_bool(uint32_analysis, true,
+            "keep unsigned shift results and unsigned array elements that "
+            "are only read as unsigned values in integer registers")
+DEFINE_bool(load_elimination, true,
+            "forward stored field values to loads and remove redundant "
+            "field loads and dead field stores")
+DEFINE_bool(escape_analysis, true,
+            "replace object literals that do not escape by their fields")
+DEFINE_bool(dead_code_elimination, true,
+            "remove instructions whose values are not used")
+DEFINE_bool(sink_instructions, true,
+            "move instructions into the branch that uses their values")
+DEFINE_bool(constant_global_cells, true,
+            "embed the values of global properties that are not written "
+            "as constants")
 DEFINE_bool(collect_megamorphic_maps_from_stub_cache,
             true,
             "crankshaft harvests type feedback from stub cache")
@@ -138,6 +180,14 @@ DEFINE_bool(trace_alloc, false, "trace register allocator")
 DEFINE_bool(trace_all_uses, false, "trace all use positions")
 DEFINE_bool(trace_range, false, "trace range analysis")
 DEFINE_bool(trace_gvn, false, "trace global value numbering")
+DEFINE_bool(trace_bounds_check_elimination, false,
+            "trace array bounds check elimination")
+DEFINE_bool(trace_check_elimination, false, "trace map check elimination")
+DEFINE_bool(trace_dead_code_elimination, false,
+            "trace dead code elimination and instruction sinking")
+DEFINE_bool(trace_load_elimination, false,
+            "trace field load and store elimination")
+DEFINE_bool(trace_escape_analysis, false, "trace escape analysis")
 DEFINE_bool(trace_representation, false, "trace representation types")
 DEFINE_bool(stress_pointer_maps, false, "pointer map for every instruction")
 DEFINE_bool(stress_environments, false, "environment for every instruction")
@@ -146,12 +196,35 @@ DEFINE_int(deopt_every_n_times,
            "deoptimize every n times a deopt point is passed")
 DEFINE_bool(trap_on_deopt, false, "put a break point before deoptimizing")
 DEFINE_bool(deoptimize_uncommon_cases, true, "deoptimize uncommon cases")
+DEFINE_int(max_deopts_per_site, 2,
+           "number of deoptimizations at a site of optimized code after "
+           "which recompiled code uses generic operations there")
 DEFINE_bool(polymorphic_inlining, true, "polymorphic inlining")
+DEFINE_int(max_polymorphic_inlining_maps, 4,
+           "maximum number of receiver maps of a call inlined polymorphically")
 DEFINE_bool(use_osr, true, "use on-stack replacement")
+DEFINE_bool(optimize_for_in, true,
+            "optimize functions containing for-in loops")
 
 DEFINE_bool(trace_osr, false, "trace on-stack replacement")
+DEFINE_bool(count_based_interrupts, false,
+            "trigger profiler ticks based on counting instead of timing")
+DEFINE_bool(weighted_back_edges, true,
+            "weight back edges and returns by the amount of code they cover")
+DEFINE_int(interrupt_budget, 0x1800,
+           "execution budget before an interrupt is triggered "
+           "(count-based interrupts only)")
+DEFINE_int(profiler_ticks_before_optimization, 2,
+           "profiler ticks a function needs before it is optimized "
+           "(count-based interrupts only)")
 DEFINE_int(stress_runs, 0, "number of stress runs")
 DEFINE_bool(optimize_closures, true, "optimize closures")
+DEFINE_bool(concurrent_recompilation, false,
+            "optimize functions on a background thread")
+DEFINE_int(concurrent_recompilation_queue_length, 8,
+           "the length of the concurrent recompilation queue")
+DEFINE_bool(trace_concurrent_recompilation, false,
+            "track concurrent recompilation")
 
 // assembler-ia32.cc / assembler-arm.cc / assembler-x64.cc
 DEFINE_bool(debug_code, false,
@@ -205,6 +278,9 @@ DEFINE_bool(mask_constants_with_cookie,
 
 // codegen.cc
 DEFINE_bool(lazy, true, "use lazy compilation")
+DEFINE_bool(reuse_scope_info, true,
+            "reuse scope info and inner functions when recompiling for "
+            "optimization")
 DEFINE_bool(trace_opt, false, "trace lazy optimization")
 DEFINE_bool(trace_opt_stats, false, "trace lazy optimization statistics")
 DEFINE_bool(opt, true, "use adaptive optimizations")
@@ -217,6 +293,9 @@ DEFINE_bool(trace_deopt, false, "trace deoptimization")
 // compiler.cc
 DEFINE_int(min_preparse_length, 1024,
            "minimum length for automatic enable preparsing")
+DEFINE_bool(cache_preparse_data, true,
+            "reuse the function entries recorded while parsing a script "
+            "when the same source is parsed again")
 DEFINE_bool(always_full_compiler, false,
             "try to use the dedicated run-once backend for all code")
 DEFINE_bool(trace_bailout, false,
@@ -224,6 +303,12 @@ DEFINE_bool(trace_bailout, false,
 
 // compilation-cache.cc
 DEFINE_bool(compilation_cache, true, "enable compilation cache")
+DEFINE_int(compilation_cache_generation_size, 4096,
+           "number of entries in the youngest generation of a compilation "
+           "sub-cache before it is aged outside of garbage collections")
+DEFINE_int(regexp_cache_retained_size, 1024,
+           "size in KB of the recently used regexps that the compilation "
+           "cache keeps across garbage collections")
 
 DEFINE_bool(cache_prototype_transitions, true, "cache prototype transitions")
 
@@ -248,6 +333,18 @@ DEFINE_bool(always_inline_smi_code, false,
 
 // heap.cc
 DEFINE_int(max_new_space_size, 0, "max size of the new generation (in kBytes)")
+DEFINE_bool(adaptive_new_space, true,
+            "size new space by the share of time spent in scavenges")
+DEFINE_int(target_scavenge_overhead, 5,
+           "percentage of the time between scavenges that a scavenge may "
+           "take before new space grows")
+DEFINE_bool(memory_reducer, true,
+            "compact sparse pages and give free memory back to the "
+            "operating system when the isolate is idle")
+DEFINE_int(target_gc_overhead, 0,
+           "percentage of the time that full collections may take, which "
+           "sets how far the old generation grows between them "
+           "(0 for fixed growth factors)")
 DEFINE_int(max_old_space_size, 0, "max size of the old generation (in Mbytes)")
 DEFINE_int(max_executable_size, 0, "max size of executable memory (in Mbytes)")
 DEFINE_bool(gc_global, false, "always perform global GCs")
@@ -267,16 +364,55 @@ DEFINE_bool(collect_maps, true,
             "garbage collect maps from which no objects can be reached")
 DEFINE_bool(flush_code, true,
             "flush code that we expect not to use again before full gc")
+DEFINE_bool(parallel_scavenge, false,
+            "use helper threads to copy objects during scavenges")
+DEFINE_int(scavenger_threads, 2,
+           "number of helper threads used by the parallel scavenger")
+DEFINE_bool(concurrent_sweeping, false,
+            "sweep the old pointer and data space on background threads")
+DEFINE_int(sweeper_threads, 2,
+           "number of threads used by concurrent sweeping")
+DEFINE_bool(parallel_marking, false,
+            "use helper threads to mark live objects during full gcs")
+DEFINE_int(marking_threads, 2,
+           "number of helper threads used by parallel marking")
+DEFINE_bool(parallel_evacuation, false,
+            "use helper threads to evacuate pages and update pointers")
+DEFINE_int(evacuation_threads, 2,
+           "number of helper threads used by parallel evacuation")
+DEFINE_bool(pretenuring, true,
+            "allocate copies of literals whose copies survive in old space")
+DEFINE_int(pretenuring_survival_percent, 85,
+           "percentage of sampled copies of a literal that must be promoted "
+           "before its copies are allocated in old space")
+DEFINE_bool(trace_pretenuring, false,
+            "print the survival of the sampled literal sites after each gc")
+DEFINE_bool(track_object_stats, false,
+            "record the number and size of live objects by instance type, "
+            "space and code kind in each full gc")
+DEFINE_bool(card_marking, true,
+            "remember the old-to-new pointers of pages that keep overflowing "
+            "the store buffer in per-page card tables")
+DEFINE_int(card_marking_threshold, 2,
+           "number of store buffer overflows before a page switches to card "
+           "marking")
 DEFINE_bool(incremental_marking, true, "use incremental marking")
 DEFINE_bool(incremental_marking_steps, true, "do incremental marking steps")
 DEFINE_bool(trace_incremental_marking, false,
             "trace progress of the incremental marking")
+DEFINE_int(lookup_cache_size, 256,
+           "number of entries in the keyed and descriptor lookup caches "
+           "(rounded up to a power of two)")
 
 // v8.cc
 DEFINE_bool(use_idle_notification, true,
             "Use idle notification to reduce memory footprint.")
 // ic.cc
 DEFINE_bool(use_ic, true, "use inline caching")
+DEFINE_int(fast_properties_read_threshold, 1000,
+           "number of named loads from an object in dictionary mode without "
+           "added or deleted properties before it gets fast properties again "
+           "(0 disables)")
 
 #ifdef LIVE_OBJECT_LIST
 // liveobjectlist.cc
@@ -284,6 +420,19 @@ DEFINE_string(lol_workdir, NULL, "path for lol temp files")
 DEFINE_bool(verify_lol, false, "perform debugging verification for lol")
 #endif
 
+// counters.cc
+DEFINE_bool(runtime_call_stats, false,
+            "count calls of runtime functions, C++ builtins and IC misses "
+            "and the time spent in them")
+
+// isolate.cc
+DEFINE_bool(counters_block, false,
+            "keep stats counters in a per-isolate block when the embedder "
+            "has not set a counter function")
+DEFINE_string(counters_file, NULL,
+              "memory-map the default isolate's counters block to this file "
+              "(implies --counters-block)")
+
 // macro-assembler-ia32.cc
 DEFINE_bool(native_code_counters, false,
             "generate extra code for manipulating stats counters")
@@ -296,13 +445,29 @@ DEFINE_bool(cleanup_caches_in_maps_at_gc, true,
             "Flush code caches in maps during mark compact cycle.")
 DEFINE_bool(never_compact, false,
             "Never perform compaction on full GC - testing only")
-DEFINE_bool(compact_code_space, false, "Compact code space")
+DEFINE_bool(compact_code_space, true,
+            "Compact code space on full non-incremental collections")
+DEFINE_bool(incremental_code_compaction, false,
+            "Compact code space on full incremental collections")
+DEFINE_int(max_optimized_code_age, 32,
+           "deoptimize functions whose optimized code was not found running "
+           "for this many full collections, so the code can be collected "
+           "(0 disables)")
+DEFINE_bool(string_dedup, false,
+            "make references to equal short strings share one copy during "
+            "full non-incremental collections")
 DEFINE_bool(cleanup_code_caches_at_gc, true,
             "Flush inline caches prior to mark compact collection and "
             "flush code caches in maps during mark compact cycle.")
 DEFINE_int(random_seed, 0,
            "Default seed for initializing random generator "
            "(0, the default, means to use system random).")
+DEFINE_bool(randomize_hashes, true,
+            "randomize the seed of string hashes so colliding keys cannot be "
+            "predicted (with snapshots the seed in the snapshot is used)")
+DEFINE_int(hash_seed, 0,
+           "fixed seed for string hashes (0 means random) "
+           "(with snapshots the seed in the snapshot is used)")
 
 DEFINE_bool(canonicalize_object_literal_maps, true,
             "Canonicalize maps for object literals.")
@@ -315,9 +480,17 @@ DEFINE_int(max_map_space_pages, MapSpace::kMaxMapPageIndex - 1,
 // mksnapshot.cc
 DEFINE_bool(h, false, "print this message")
 DEFINE_bool(new_snapshot, true, "use new snapshot implementation")
+DEFINE_string(extra_code, NULL, "A filename with extra code to be included in"
+              " the snapshot (mksnapshot only)")
 
 // objects.cc
 DEFINE_bool(use_verbose_printer, true, "allows verbose printing")
+DEFINE_bool(share_field_descriptors, true,
+            "share the descriptor arrays of identically shaped objects "
+            "between maps, also across contexts")
+DEFINE_bool(unbox_double_fields, true,
+            "keep double properties in mutable heap numbers owned by the "
+            "object, which stores update in place")
 
 // parser.cc
 DEFINE_bool(allow_natives_syntax, false, "allow natives syntax")
@@ -330,11 +503,26 @@ DEFINE_int(stop_sim_at, 0, "Simulator stop after x number of instructions")
 DEFINE_int(sim_stack_alignment, 8,
            "Stack alingment in bytes in simulator (4 or 8, 8 is default)")
 
+// stub-cache.cc
+DEFINE_int(stub_cache_size, 2048,
+           "number of entries in the primary megamorphic stub cache "
+           "(rounded up to a power of two)")
+
+// zone.cc
+DEFINE_int(zone_segment_pool_size, 1024,
+           "maximum size (in KB) of the zone segments kept for reuse "
+           "across compilations")
+
 // isolate.cc
 DEFINE_bool(trace_exception, false,
             "print stack trace when throwing exceptions")
 DEFINE_bool(preallocate_message_memory, false,
             "preallocate some memory to build stack traces.")
+DEFINE_string(feedback_profile_load, NULL,
+              "load type feedback and optimization decisions from this file")
+DEFINE_string(feedback_profile_save, NULL,
+              "save type feedback and optimization decisions to this file "
+              "when the isolate is torn down")
 
 // v8.cc
 DEFINE_bool(preemption, false,
@@ -342,6 +530,18 @@ DEFINE_bool(preemption, false,
 
 // Regexp
 DEFINE_bool(regexp_optimization, true, "generate optimized regexp code")
+DEFINE_bool(regexp_tier_up, true,
+            "interpret regexps with the bytecode interpreter until they are "
+            "hot, then compile them to native code")
+DEFINE_int(regexp_tier_up_executions, 3,
+           "number of executions after which a regexp is compiled to "
+           "native code")
+DEFINE_int(regexp_tier_up_subject_length, 8192,
+           "total subject length after which a regexp is compiled to "
+           "native code")
+DEFINE_int(regexp_backtrack_limit, 0,
+           "maximum number of backtracks in a single regexp execution "
+           "before it fails with an exception (0 for no limit)")
 
 // Testing flags test/cctest/test-{flags,api,serialization}.cc
 DEFINE_bool(testing_bool_flag, true, "testing_bool_flag")
@@ -394,6 +594,11 @@ DEFINE_bool(debug_script_collected_events, true,
 DEFINE_bool(gdbjit, false, "enable GDBJIT interface (disables compacting GC)")
 DEFINE_bool(gdbjit_full, false, "enable GDBJIT interface for all code objects")
 DEFINE_bool(gdbjit_dump, false, "dump elf objects with debug info to disk")
+DEFINE_int(gdbjit_batch_size, 1,
+           "number of code objects described by each GDBJIT image")
+DEFINE_bool(gdbjit_lazy, false,
+            "register code objects with GDB only when the debugger calls "
+            "__gdb_register_v8_code()")
 DEFINE_string(gdbjit_dump_filter, "",
               "dump only objects containing this substring")
 
@@ -468,6 +673,20 @@ DEFINE_bool(debug_serialization, false,
 DEFINE_bool(collect_heap_spill_statistics, false,
             "report heap spill statistics along with heap_stats "
             "(requires heap_stats)")
+DEFINE_int(large_object_cache_size, 16,
+           "maximum size in megabytes of freed large object chunks kept "
+           "for reuse")
+DEFINE_int(large_object_cache_age, 2,
+           "number of full gcs a freed large object chunk is kept for reuse")
+DEFINE_int(page_pool_size, 32,
+           "maximum size in megabytes of the memory released by isolates "
+           "that is kept for reuse instead of being unmapped")
+DEFINE_bool(huge_pages, false,
+            "back new space and large objects with transparent huge pages "
+            "(Linux only)")
+DEFINE_bool(numa_local_heap, false,
+            "prefer the NUMA node of the committing thread for heap memory "
+            "(Linux only)")
 
 DEFINE_bool(trace_isolates, false, "trace isolate state changes")
 
@@ -503,6 +722,7 @@ DEFINE_bool(log_handles, false, "Log global handle events.")
 DEFINE_bool(log_snapshot_positions, false,
             "log positions of (de)serialized objects in the snapshot.")
 DEFINE_bool(log_suspect, false, "Log suspect operations.")
+DEFINE_bool(log_ic, false, "Log inline cache state transitions.")
 DEFINE_bool(prof, false,
             "Log statistical profiling information (implies --log-code).")
 DEFINE_bool(prof_auto, true,
@@ -512,11 +732,29 @@ DEFINE_bool(prof_lazy, false,
             " when profiler is active (implies --noprof_auto).")
 DEFINE_bool(prof_browser_mode, true,
             "Used with --prof, turns on browser-compatible mode for profiling.")
+DEFINE_bool(prof_cpu_timer, false,
+            "Linux only: sample the VM thread from a timer on its CPU time "
+            "clock instead of sending it signals from the profiler thread.")
+DEFINE_int(prof_cpu_timer_interval, 10000,
+           "Used with --prof-cpu-timer, CPU time in microseconds consumed by "
+           "the VM thread between two samples.")
 DEFINE_bool(log_regexp, false, "Log regular expression execution.")
 DEFINE_bool(sliding_state_window, false,
             "Update sliding state window counters.")
 DEFINE_string(logfile, "v8.log", "Specify the name of the log file.")
+DEFINE_bool(log_async, true,
+            "Write the log file on a background thread. Messages are "
+            "dropped when the thread falls behind by more than 4 MB.")
 DEFINE_bool(ll_prof, false, "Enable low-level linux profiler.")
+DEFINE_bool(prof_binary, false,
+            "Used with --prof, writes code and tick events to <logfile>.bin "
+            "in a compact binary form for the native tick-processor.")
+DEFINE_bool(perf_basic_prof, false,
+            "Write the names of generated code to /tmp/perf-<pid>.map "
+            "for the linux perf tool.")
+DEFINE_bool(perf_jit_prof, false,
+            "Write generated code and its names to jit-<pid>.dump "
+            "for the linux perf tool (perf inject --jit).")
 
 //
 // Disassembler only flags
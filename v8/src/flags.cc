@@ -511,6 +511,25 @@ void FlagList::ResetAllFlags() {
 }
 
 
+// static
+uint32_t FlagList::Hash() {
+  uint32_t hash = 0;
+  for (size_t i = 0; i < num_flags; ++i) {
+    Flag* current = &flags[i];
+    if (!current->IsDefault()) {
+      SmartArrayPointer<const char> value = ToString(current);
+      for (const char* c = current->name(); *c != '\0'; c++) {
+        hash = 31 * hash + *c;
+      }
+      for (const char* c = *value; *c != '\0'; c++) {
+        hash = 31 * hash + *c;
+      }
+    }
+  }
+  return ComputeIntegerHash(hash);
+}
+
+
 // static
 void FlagList::PrintHelp() {
   printf("Usage:\n");
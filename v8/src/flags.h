@@ -72,6 +72,10 @@ class FlagList {
 
   // Print help to stdout with flags, types, and default values.
   static void PrintHelp();
+
+  // Hash of the flags with a value different from the default, used to tell
+  // whether cached code was generated with the current flags.
+  static uint32_t Hash();
 };
 
 } }  // namespace v8::internal
@@ -822,7 +822,7 @@ void OptimizedFrame::Summarize(List<FrameSummary>* frames) {
 
       i--;
       int ast_id = it.Next();
-      int function_id = it.Next();
+      int function_id = Translation::LiteralIdForFunction(it.Next());
       it.Next();  // Skip height.
       JSFunction* function =
           JSFunction::cast(data->LiteralArray()->get(function_id));
@@ -832,12 +832,19 @@ void OptimizedFrame::Summarize(List<FrameSummary>* frames) {
       // to construct a stack trace, the receiver is always in a stack slot.
       opcode = static_cast<Translation::Opcode>(it.Next());
       ASSERT(opcode == Translation::STACK_SLOT ||
-             opcode == Translation::LITERAL);
+             opcode == Translation::LITERAL ||
+             opcode == Translation::CAPTURED_OBJECT);
       int index = it.Next();
 
       // Get the correct receiver in the optimized frame.
       Object* receiver = NULL;
-      if (opcode == Translation::LITERAL) {
+      if (opcode == Translation::CAPTURED_OBJECT) {
+        // A receiver removed by escape analysis cannot be materialized
+        // without allocating, so it is reported as undefined.  The
+        // commands for its fields are skipped below.
+        it.Next();  // Skip the field count.
+        receiver = isolate()->heap()->undefined_value();
+      } else if (opcode == Translation::LITERAL) {
         receiver = data->LiteralArray()->get(index);
       } else {
         // Positive index means the value is spilled to the locals
@@ -938,7 +945,9 @@ void OptimizedFrame::GetFunctions(List<JSFunction*>* functions) {
     if (opcode == Translation::FRAME) {
       frame_count--;
       it.Next();  // Skip ast id.
-      int function_id = it.Next();
+      // Inlined closures created by the optimized code are represented
+      // by their template function.
+      int function_id = Translation::LiteralIdForFunction(it.Next());
       it.Next();  // Skip height.
       JSFunction* function =
           JSFunction::cast(data->LiteralArray()->get(function_id));
@@ -292,7 +292,9 @@ bool FullCodeGenerator::MakeCode(CompilationInfo* info) {
       info->isolate()->debugger()->IsDebuggerActive());
   code->set_compiled_optimizable(info->IsOptimizable());
 #endif  // ENABLE_DEBUGGER_SUPPORT
+  code->set_has_interrupt_budget(FLAG_count_based_interrupts);
   code->set_allow_osr_at_loop_nesting_level(0);
+  code->set_profiler_ticks(0);
   code->set_stack_check_table_offset(table_offset);
   CodeGenerator::PrintCode(code, info);
   info->SetCode(code);  // May be an empty handle.
@@ -308,17 +310,24 @@ bool FullCodeGenerator::MakeCode(CompilationInfo* info) {
 }
 
 
+int FullCodeGenerator::InterruptBudgetWeight(int code_size) {
+  if (!FLAG_weighted_back_edges) return 1;
+  return Min(kMaxBackEdgeWeight, Max(1, code_size / kBackEdgeDistanceUnit));
+}
+
+
 unsigned FullCodeGenerator::EmitStackCheckTable() {
   // The stack check table consists of a length (in number of entries)
-  // field, and then a sequence of entries.  Each entry is a pair of AST id
-  // and code-relative pc offset.
+  // field, and then a sequence of entries.  Each entry is a triple of AST
+  // id, code-relative pc offset and loop depth.
   masm()->Align(kIntSize);
   unsigned offset = masm()->pc_offset();
   unsigned length = stack_checks_.length();
   __ dd(length);
   for (unsigned i = 0; i < length; ++i) {
     __ dd(stack_checks_[i].id);
-    __ dd(stack_checks_[i].pc_and_state);
+    __ dd(stack_checks_[i].pc);
+    __ dd(stack_checks_[i].loop_depth);
   }
   return offset;
 }
@@ -387,7 +396,9 @@ void FullCodeGenerator::RecordStackCheck(unsigned ast_id) {
   // The pc offset does not need to be encoded and packed together with a
   // state.
   ASSERT(masm_->pc_offset() > 0);
-  BailoutEntry entry = { ast_id, static_cast<unsigned>(masm_->pc_offset()) };
+  StackCheckEntry entry = { ast_id,
+                            static_cast<unsigned>(masm_->pc_offset()),
+                            static_cast<unsigned>(loop_depth()) };
   stack_checks_.Add(entry);
 }
 
@@ -664,6 +675,35 @@ void FullCodeGenerator::EmitInlineRuntimeCall(CallRuntime* expr) {
 }
 
 
+void FullCodeGenerator::EmitIntegerOperation(CallRuntime* expr,
+                                             Runtime::FunctionId id) {
+  ZoneList<Expression*>* args = expr->arguments();
+  ASSERT(args->length() == 2);
+  VisitForStackValue(args->at(0));
+  VisitForStackValue(args->at(1));
+  // Unoptimized code always calls the runtime.  Optimized code handles
+  // smis inline and joins the runtime call at the bailout point the
+  // caller records for expr.
+  __ CallRuntime(id, 2);
+  context()->Plug(result_register());
+}
+
+
+void FullCodeGenerator::EmitIntegerAdd(CallRuntime* expr) {
+  EmitIntegerOperation(expr, Runtime::kIntegerAdd);
+}
+
+
+void FullCodeGenerator::EmitIntegerSub(CallRuntime* expr) {
+  EmitIntegerOperation(expr, Runtime::kIntegerSub);
+}
+
+
+void FullCodeGenerator::EmitIntegerMul(CallRuntime* expr) {
+  EmitIntegerOperation(expr, Runtime::kIntegerMul);
+}
+
+
 void FullCodeGenerator::VisitBinaryOperation(BinaryOperation* expr) {
   switch (expr->op()) {
     case Token::COMMA:
@@ -995,7 +1035,7 @@ void FullCodeGenerator::VisitDoWhileStatement(DoWhileStatement* stmt) {
   // Check stack before looping.
   PrepareForBailoutForId(stmt->BackEdgeId(), NO_REGISTERS);
   __ bind(&stack_check);
-  EmitStackCheck(stmt);
+  EmitStackCheck(stmt, &body);
   __ jmp(&body);
 
   PrepareForBailoutForId(stmt->ExitId(), NO_REGISTERS);
@@ -1024,7 +1064,7 @@ void FullCodeGenerator::VisitWhileStatement(WhileStatement* stmt) {
   SetStatementPosition(stmt);
 
   // Check stack before looping.
-  EmitStackCheck(stmt);
+  EmitStackCheck(stmt, &body);
 
   __ bind(&test);
   VisitForControl(stmt->cond(),
@@ -1047,6 +1087,10 @@ void FullCodeGenerator::VisitForStatement(ForStatement* stmt) {
     Visit(stmt->init());
   }
 
+  // Optimized code that runs iterations ahead of the loop (see
+  // HGraphBuilder::TryFastDoubleArrayMap) continues here, at the test.
+  PrepareForBailoutForId(stmt->EntryId(), NO_REGISTERS);
+
   increment_loop_depth();
   // Emit the test at the bottom of the loop (even if empty).
   __ jmp(&test);
@@ -1067,7 +1111,7 @@ void FullCodeGenerator::VisitForStatement(ForStatement* stmt) {
   SetStatementPosition(stmt);
 
   // Check stack before looping.
-  EmitStackCheck(stmt);
+  EmitStackCheck(stmt, &body);
 
   __ bind(&test);
   if (stmt->cond() != NULL) {
@@ -1246,9 +1290,12 @@ void FullCodeGenerator::VisitLiteral(Literal* expr) {
 void FullCodeGenerator::VisitFunctionLiteral(FunctionLiteral* expr) {
   Comment cmnt(masm_, "[ FunctionLiteral");
 
-  // Build the function boilerplate and instantiate it.
-  Handle<SharedFunctionInfo> function_info =
-      Compiler::BuildFunctionInfo(expr, script());
+  // Build the function boilerplate and instantiate it, unless the function
+  // was compiled before and its body was not parsed again.
+  Handle<SharedFunctionInfo> function_info = expr->shared_info();
+  if (function_info.is_null()) {
+    function_info = Compiler::BuildFunctionInfo(expr, script());
+  }
   if (function_info.is_null()) {
     SetStackOverflow();
     return;
@@ -98,6 +98,15 @@ class FullCodeGenerator: public AstVisitor {
   class StateField : public BitField<State, 0, 8> { };
   class PcField    : public BitField<unsigned, 8, 32-8> { };
 
+#if defined(V8_TARGET_ARCH_IA32)
+  static const int kBackEdgeDistanceUnit = 100;
+#elif defined(V8_TARGET_ARCH_X64)
+  static const int kBackEdgeDistanceUnit = 162;
+#else
+  static const int kBackEdgeDistanceUnit = 142;
+#endif
+  static const int kMaxBackEdgeWeight = 127;
+
   static const char* State2String(State state) {
     switch (state) {
       case NO_REGISTERS: return "NO_REGISTERS";
@@ -414,9 +423,18 @@ class FullCodeGenerator: public AstVisitor {
                        int* global_count);
 
   // Platform-specific code for checking the stack limit at the back edge of
-  // a loop.
-  void EmitStackCheck(IterationStatement* stmt);
-  // Record the OSR AST id corresponding to a stack check in the code.
+  // a loop, or with --count-based-interrupts for counting down the interrupt
+  // budget by the size of the loop starting at back_edge_target.
+  void EmitStackCheck(IterationStatement* stmt, Label* back_edge_target);
+  // Platform-specific code for counting down the interrupt budget in the
+  // profiling counter cell by delta, which sets the sign flag when it has
+  // run out.
+  void EmitProfilingCounterDecrement(int delta);
+  // The amount a back edge or return counts the interrupt budget down by
+  // for the given size of the code it covers.
+  static int InterruptBudgetWeight(int code_size);
+  // Record the OSR AST id and the loop depth corresponding to a stack check
+  // in the code.
   void RecordStackCheck(unsigned osr_ast_id);
   // Emit a table of stack check ids and pcs into the code stream.  Return
   // the offset of the start of the table.
@@ -434,6 +452,7 @@ class FullCodeGenerator: public AstVisitor {
   InlineFunctionGenerator FindInlineFunctionGenerator(Runtime::FunctionId id);
 
   void EmitInlineRuntimeCall(CallRuntime* expr);
+  void EmitIntegerOperation(CallRuntime* expr, Runtime::FunctionId id);
 
 #define EMIT_INLINE_RUNTIME_CALL(name, x, y) \
   void Emit##name(CallRuntime* expr);
@@ -571,6 +590,12 @@ class FullCodeGenerator: public AstVisitor {
     unsigned pc_and_state;
   };
 
+  struct StackCheckEntry {
+    unsigned id;
+    unsigned pc;
+    unsigned loop_depth;
+  };
+
 
   class ExpressionContext BASE_EMBEDDED {
    public:
@@ -756,8 +781,9 @@ class FullCodeGenerator: public AstVisitor {
   int loop_depth_;
   const ExpressionContext* context_;
   ZoneList<BailoutEntry> bailout_entries_;
-  ZoneList<BailoutEntry> stack_checks_;
+  ZoneList<StackCheckEntry> stack_checks_;
   Handle<FixedArray> handler_table_;
+  Handle<JSGlobalPropertyCell> profiling_counter_;
 
   friend class NestedStatement;
 
@@ -916,7 +916,7 @@ class ELFSymbolTable : public ELFSection {
 #endif  // defined(__ELF)
 
 
-class CodeDescription BASE_EMBEDDED {
+class CodeDescription : public Malloced {
  public:
 #ifdef V8_TARGET_ARCH_X64
   enum StackState {
@@ -935,16 +935,56 @@ class CodeDescription BASE_EMBEDDED {
                   CompilationInfo* info)
       : name_(name),
         code_(code),
+        code_start_(reinterpret_cast<uintptr_t>(code->instruction_start())),
+        code_end_(reinterpret_cast<uintptr_t>(code->instruction_end())),
         script_(script),
         lineinfo_(lineinfo),
         tag_(tag),
-        info_(info) {
+        info_(info),
+        detached_(false),
+        filename_(NULL) {
+  }
+
+  ~CodeDescription() {
+    if (detached_) {
+      DeleteArray(name_);
+      DeleteArray(filename_);
+      delete lineinfo_;
+    }
+  }
+
+  // Copies everything that is needed to describe the code later, when the
+  // script and the compilation info are gone.  Line numbers are resolved
+  // now and the description takes ownership of the line info.  Variables
+  // are not described.  The code itself does not move while the GDBJIT
+  // interface is active.
+  void Detach() {
+    ASSERT(!detached_);
+    name_ = StrDup(name_);
+    if (IsLineInfoAvailable()) {
+      filename_ = GetFilename().Detach();
+      List<GDBJITLineInfo::PCInfo>* pc_info = lineinfo_->pc_info();
+      for (int i = 0; i < pc_info->length(); i++) {
+        pc_info->at(i).pos_ = GetScriptLineNumber(pc_info->at(i).pos_);
+      }
+    } else {
+      delete lineinfo_;
+      lineinfo_ = NULL;
+    }
+    script_ = Handle<Script>();
+    info_ = NULL;
+    detached_ = true;
   }
 
   const char* name() const {
     return name_;
   }
 
+  // Identifies the code object; detached descriptions do not access it.
+  Code* code() const {
+    return code_;
+  }
+
   GDBJITLineInfo* lineinfo() const {
     return lineinfo_;
   }
@@ -962,11 +1002,11 @@ class CodeDescription BASE_EMBEDDED {
   }
 
   uintptr_t CodeStart() const {
-    return reinterpret_cast<uintptr_t>(code_->instruction_start());
+    return code_start_;
   }
 
   uintptr_t CodeEnd() const {
-    return reinterpret_cast<uintptr_t>(code_->instruction_end());
+    return code_end_;
   }
 
   uintptr_t CodeSize() const {
@@ -974,6 +1014,7 @@ class CodeDescription BASE_EMBEDDED {
   }
 
   bool IsLineInfoAvailable() {
+    if (detached_) return filename_ != NULL && lineinfo_ != NULL;
     return !script_.is_null() &&
         script_->source()->IsString() &&
         script_->HasValidSource() &&
@@ -994,10 +1035,13 @@ class CodeDescription BASE_EMBEDDED {
 #endif
 
   SmartArrayPointer<char> GetFilename() {
+    if (detached_) return SmartArrayPointer<char>(StrDup(filename_));
     return String::cast(script_->name())->ToCString();
   }
 
   int GetScriptLineNumber(int pos) {
+    // Detached descriptions store line numbers in place of positions.
+    if (detached_) return pos;
     return GetScriptLineNumberSafe(script_, pos) + 1;
   }
 
@@ -1005,17 +1049,28 @@ class CodeDescription BASE_EMBEDDED {
  private:
   const char* name_;
   Code* code_;
+  uintptr_t code_start_;
+  uintptr_t code_end_;
   Handle<Script> script_;
   GDBJITLineInfo* lineinfo_;
   GDBJITInterface::CodeTag tag_;
   CompilationInfo* info_;
+  bool detached_;
+  char* filename_;
 #ifdef V8_TARGET_ARCH_X64
   uintptr_t stack_state_start_addresses_[STACK_STATE_MAX];
 #endif
 };
 
+// The code objects described by one debug object.  There is more than one
+// only when the GDBJIT interface batches registrations, and then none of
+// them has compilation info.
+typedef ZoneList<CodeDescription*> CodeDescriptionList;
+
+
 #if defined(__ELF)
-static void CreateSymbolsTable(CodeDescription* desc,
+static void CreateSymbolsTable(const CodeDescriptionList* descs,
+                               uintptr_t text_start,
                                ELF* elf,
                                int text_section_index) {
   ELFSymbolTable* symtab = new ELFSymbolTable(".symtab");
@@ -1032,19 +1087,23 @@ static void CreateSymbolsTable(CodeDescription* desc,
                         ELFSymbol::TYPE_FILE,
                         ELFSection::INDEX_ABSOLUTE));
 
-  symtab->Add(ELFSymbol(desc->name(),
-                        0,
-                        desc->CodeSize(),
-                        ELFSymbol::BIND_GLOBAL,
-                        ELFSymbol::TYPE_FUNC,
-                        text_section_index));
+  for (int i = 0; i < descs->length(); i++) {
+    CodeDescription* desc = descs->at(i);
+    symtab->Add(ELFSymbol(desc->name(),
+                          desc->CodeStart() - text_start,
+                          desc->CodeSize(),
+                          ELFSymbol::BIND_GLOBAL,
+                          ELFSymbol::TYPE_FUNC,
+                          text_section_index));
+  }
 }
 #endif  // defined(__ELF)
 
 
 class DebugInfoSection : public DebugSection {
  public:
-  explicit DebugInfoSection(CodeDescription* desc)
+  DebugInfoSection(const CodeDescriptionList* descs,
+                   const ZoneList<uint32_t>* line_program_offsets)
 #if defined(__ELF)
       : ELFSection(".debug_info", TYPE_PROGBITS, 1),
 #else
@@ -1053,7 +1112,8 @@ class DebugInfoSection : public DebugSection {
                      1,
                      MachOSection::S_REGULAR | MachOSection::S_ATTR_DEBUG),
 #endif
-        desc_(desc) { }
+        descs_(descs),
+        line_program_offsets_(line_program_offsets) { }
 
   // DWARF2 standard
   enum DWARF2LocationOp {
@@ -1074,6 +1134,18 @@ class DebugInfoSection : public DebugSection {
   };
 
   bool WriteBody(Writer* w) {
+    // One compilation unit for each code object, all using the same
+    // abbreviations.
+    for (int i = 0; i < descs_->length(); i++) {
+      WriteCompilationUnit(w, descs_->at(i), line_program_offsets_->at(i));
+    }
+    return true;
+  }
+
+ private:
+  void WriteCompilationUnit(Writer* w,
+                            CodeDescription* desc,
+                            uint32_t line_program_offset) {
     uintptr_t cu_start = w->position();
     Writer::Slot<uint32_t> size = w->CreateSlotHere<uint32_t>();
     uintptr_t start = w->position();
@@ -1082,23 +1154,23 @@ class DebugInfoSection : public DebugSection {
     w->Write<uint8_t>(sizeof(intptr_t));
 
     w->WriteULEB128(1);  // Abbreviation code.
-    w->WriteString(*desc_->GetFilename());
-    w->Write<intptr_t>(desc_->CodeStart());
-    w->Write<intptr_t>(desc_->CodeStart() + desc_->CodeSize());
-    w->Write<uint32_t>(0);
+    w->WriteString(*desc->GetFilename());
+    w->Write<intptr_t>(desc->CodeStart());
+    w->Write<intptr_t>(desc->CodeStart() + desc->CodeSize());
+    w->Write<uint32_t>(line_program_offset);
 
     uint32_t ty_offset = static_cast<uint32_t>(w->position() - cu_start);
     w->WriteULEB128(3);
     w->Write<uint8_t>(kPointerSize);
     w->WriteString("v8value");
 
-    if (desc_->IsInfoAvailable()) {
-      CompilationInfo* info = desc_->info();
+    if (desc->IsInfoAvailable()) {
+      CompilationInfo* info = desc->info();
       ScopeInfo<FreeStoreAllocationPolicy> scope_info(info->scope());
       w->WriteULEB128(2);
-      w->WriteString(desc_->name());
-      w->Write<intptr_t>(desc_->CodeStart());
-      w->Write<intptr_t>(desc_->CodeStart() + desc_->CodeSize());
+      w->WriteString(desc->name());
+      w->Write<intptr_t>(desc->CodeStart());
+      w->Write<intptr_t>(desc->CodeStart() + desc->CodeSize());
       Writer::Slot<uint32_t> fb_block_size = w->CreateSlotHere<uint32_t>();
       uintptr_t fb_block_start = w->position();
 #if defined(V8_TARGET_ARCH_IA32)
@@ -1204,17 +1276,16 @@ class DebugInfoSection : public DebugSection {
     }
 
     size.set(static_cast<uint32_t>(w->position() - start));
-    return true;
   }
 
- private:
-  CodeDescription* desc_;
+  const CodeDescriptionList* descs_;
+  const ZoneList<uint32_t>* line_program_offsets_;
 };
 
 
 class DebugAbbrevSection : public DebugSection {
  public:
-  explicit DebugAbbrevSection(CodeDescription* desc)
+  explicit DebugAbbrevSection(const CodeDescriptionList* descs)
 #ifdef __ELF
       : ELFSection(".debug_abbrev", TYPE_PROGBITS, 1),
 #else
@@ -1223,7 +1294,7 @@ class DebugAbbrevSection : public DebugSection {
                      1,
                      MachOSection::S_REGULAR | MachOSection::S_ATTR_DEBUG),
 #endif
-        desc_(desc) { }
+        descs_(descs) { }
 
   // DWARF2 standard, figure 14.
   enum DWARF2Tags {
@@ -1287,9 +1358,13 @@ class DebugAbbrevSection : public DebugSection {
   }
 
   bool WriteBody(Writer* w) {
+    // Only a single code object can have variables, which need their own
+    // abbreviations.
+    CodeDescription* desc = descs_->at(0);
+    ASSERT(descs_->length() == 1 || !desc->IsInfoAvailable());
     int current_abbreviation = 1;
-    bool extra_info = desc_->IsInfoAvailable();
-    ASSERT(desc_->IsLineInfoAvailable());
+    bool extra_info = desc->IsInfoAvailable();
+    ASSERT(desc->IsLineInfoAvailable());
     w->WriteULEB128(current_abbreviation++);
     w->WriteULEB128(DW_TAG_COMPILE_UNIT);
     w->Write<uint8_t>(extra_info ? DW_CHILDREN_YES : DW_CHILDREN_NO);
@@ -1305,7 +1380,7 @@ class DebugAbbrevSection : public DebugSection {
     w->WriteULEB128(0);
 
     if (extra_info) {
-      CompilationInfo* info = desc_->info();
+      CompilationInfo* info = desc->info();
       ScopeInfo<FreeStoreAllocationPolicy> scope_info(info->scope());
       int params = scope_info.number_of_parameters();
       int slots = scope_info.number_of_stack_slots();
@@ -1383,13 +1458,14 @@ class DebugAbbrevSection : public DebugSection {
   }
 
  private:
-  CodeDescription* desc_;
+  const CodeDescriptionList* descs_;
 };
 
 
 class DebugLineSection : public DebugSection {
  public:
-  explicit DebugLineSection(CodeDescription* desc)
+  DebugLineSection(const CodeDescriptionList* descs,
+                   ZoneList<uint32_t>* line_program_offsets)
 #ifdef __ELF
       : ELFSection(".debug_line", TYPE_PROGBITS, 1),
 #else
@@ -1398,7 +1474,8 @@ class DebugLineSection : public DebugSection {
                      1,
                      MachOSection::S_REGULAR | MachOSection::S_ATTR_DEBUG),
 #endif
-        desc_(desc) { }
+        descs_(descs),
+        line_program_offsets_(line_program_offsets) { }
 
   // DWARF2 standard, figure 34.
   enum DWARF2Opcodes {
@@ -1418,6 +1495,19 @@ class DebugLineSection : public DebugSection {
   };
 
   bool WriteBody(Writer* w) {
+    // One line number program for each code object, at the offsets the
+    // compilation units refer to.
+    uintptr_t section_start = w->position();
+    for (int i = 0; i < descs_->length(); i++) {
+      line_program_offsets_->Add(
+          static_cast<uint32_t>(w->position() - section_start));
+      WriteLineProgram(w, descs_->at(i));
+    }
+    return true;
+  }
+
+ private:
+  void WriteLineProgram(Writer* w, CodeDescription* desc) {
     // Write prologue.
     Writer::Slot<uint32_t> total_length = w->CreateSlotHere<uint32_t>();
     uintptr_t start = w->position();
@@ -1443,7 +1533,7 @@ class DebugLineSection : public DebugSection {
     w->Write<uint8_t>(1);  // DW_LNS_SET_COLUMN operands count.
     w->Write<uint8_t>(0);  // DW_LNS_NEGATE_STMT operands count.
     w->Write<uint8_t>(0);  // Empty include_directories sequence.
-    w->WriteString(*desc_->GetFilename());  // File name.
+    w->WriteString(*desc->GetFilename());  // File name.
     w->WriteULEB128(0);  // Current directory.
     w->WriteULEB128(0);  // Unknown modification time.
     w->WriteULEB128(0);  // Unknown file size.
@@ -1451,14 +1541,14 @@ class DebugLineSection : public DebugSection {
     prologue_length.set(static_cast<uint32_t>(w->position() - prologue_start));
 
     WriteExtendedOpcode(w, DW_LNE_SET_ADDRESS, sizeof(intptr_t));
-    w->Write<intptr_t>(desc_->CodeStart());
+    w->Write<intptr_t>(desc->CodeStart());
     w->Write<uint8_t>(DW_LNS_COPY);
 
     intptr_t pc = 0;
     intptr_t line = 1;
     bool is_statement = true;
 
-    List<GDBJITLineInfo::PCInfo>* pc_info = desc_->lineinfo()->pc_info();
+    List<GDBJITLineInfo::PCInfo>* pc_info = desc->lineinfo()->pc_info();
     pc_info->Sort(&ComparePCInfo);
 
     int pc_info_length = pc_info->length();
@@ -1468,7 +1558,7 @@ class DebugLineSection : public DebugSection {
 
       // Reduce bloating in the debug line table by removing duplicate line
       // entries (per DWARF2 standard).
-      intptr_t  new_line = desc_->GetScriptLineNumber(info->pos_);
+      intptr_t  new_line = desc->GetScriptLineNumber(info->pos_);
       if (new_line == line) {
         continue;
       }
@@ -1519,13 +1609,11 @@ class DebugLineSection : public DebugSection {
     // Advance the pc to the end of the routine, since the end sequence opcode
     // requires this.
     w->Write<uint8_t>(DW_LNS_ADVANCE_PC);
-    w->WriteSLEB128(desc_->CodeSize() - pc);
+    w->WriteSLEB128(desc->CodeSize() - pc);
     WriteExtendedOpcode(w, DW_LNE_END_SEQUENCE, 0);
     total_length.set(static_cast<uint32_t>(w->position() - start));
-    return true;
   }
 
- private:
   void WriteExtendedOpcode(Writer* w,
                            DWARF2ExtendedOpcode op,
                            size_t operands_size) {
@@ -1548,7 +1636,8 @@ class DebugLineSection : public DebugSection {
     }
   }
 
-  CodeDescription* desc_;
+  const CodeDescriptionList* descs_;
+  ZoneList<uint32_t>* line_program_offsets_;
 };
 
 
@@ -1556,23 +1645,23 @@ class DebugLineSection : public DebugSection {
 
 class UnwindInfoSection : public DebugSection {
  public:
-  explicit UnwindInfoSection(CodeDescription *desc);
+  explicit UnwindInfoSection(const CodeDescriptionList* descs);
   virtual bool WriteBody(Writer *w);
 
   int WriteCIE(Writer *w);
-  void WriteFDE(Writer *w, int);
+  void WriteFDE(Writer *w, int, CodeDescription *desc);
 
-  void WriteFDEStateOnEntry(Writer *w);
-  void WriteFDEStateAfterRBPPush(Writer *w);
-  void WriteFDEStateAfterRBPSet(Writer *w);
-  void WriteFDEStateAfterRBPPop(Writer *w);
+  void WriteFDEStateOnEntry(Writer *w, CodeDescription *desc);
+  void WriteFDEStateAfterRBPPush(Writer *w, CodeDescription *desc);
+  void WriteFDEStateAfterRBPSet(Writer *w, CodeDescription *desc);
+  void WriteFDEStateAfterRBPPop(Writer *w, CodeDescription *desc);
 
   void WriteLength(Writer *w,
                    Writer::Slot<uint32_t>* length_slot,
                    int initial_position);
 
  private:
-  CodeDescription *desc_;
+  const CodeDescriptionList* descs_;
 
   // DWARF3 Specification, Table 7.23
   enum CFIInstructions {
@@ -1639,14 +1728,14 @@ void UnwindInfoSection::WriteLength(Writer *w,
 }
 
 
-UnwindInfoSection::UnwindInfoSection(CodeDescription *desc)
+UnwindInfoSection::UnwindInfoSection(const CodeDescriptionList* descs)
 #ifdef __ELF
     : ELFSection(".eh_frame", TYPE_X86_64_UNWIND, 1),
 #else
     : MachOSection("__eh_frame", "__TEXT", sizeof(uintptr_t),
                    MachOSection::S_REGULAR),
 #endif
-      desc_(desc) { }
+      descs_(descs) { }
 
 int UnwindInfoSection::WriteCIE(Writer *w) {
   Writer::Slot<uint32_t> cie_length_slot = w->CreateSlotHere<uint32_t>();
@@ -1668,25 +1757,28 @@ int UnwindInfoSection::WriteCIE(Writer *w) {
 }
 
 
-void UnwindInfoSection::WriteFDE(Writer *w, int cie_position) {
+void UnwindInfoSection::WriteFDE(Writer *w,
+                                 int cie_position,
+                                 CodeDescription *desc) {
   // The only FDE for this function. The CFA is the current RBP.
   Writer::Slot<uint32_t> fde_length_slot = w->CreateSlotHere<uint32_t>();
   int fde_position = w->position();
   w->Write<int32_t>(fde_position - cie_position + 4);
 
-  w->Write<uintptr_t>(desc_->CodeStart());
-  w->Write<uintptr_t>(desc_->CodeSize());
+  w->Write<uintptr_t>(desc->CodeStart());
+  w->Write<uintptr_t>(desc->CodeSize());
 
-  WriteFDEStateOnEntry(w);
-  WriteFDEStateAfterRBPPush(w);
-  WriteFDEStateAfterRBPSet(w);
-  WriteFDEStateAfterRBPPop(w);
+  WriteFDEStateOnEntry(w, desc);
+  WriteFDEStateAfterRBPPush(w, desc);
+  WriteFDEStateAfterRBPSet(w, desc);
+  WriteFDEStateAfterRBPPop(w, desc);
 
   WriteLength(w, &fde_length_slot, fde_position);
 }
 
 
-void UnwindInfoSection::WriteFDEStateOnEntry(Writer *w) {
+void UnwindInfoSection::WriteFDEStateOnEntry(Writer *w,
+                                             CodeDescription *desc) {
   // The first state, just after the control has been transferred to the the
   // function.
 
@@ -1709,11 +1801,12 @@ void UnwindInfoSection::WriteFDEStateOnEntry(Writer *w) {
   // Last location described by this entry.
   w->Write<uint8_t>(DW_CFA_SET_LOC);
   w->Write<uint64_t>(
-      desc_->GetStackStateStartAddress(CodeDescription::POST_RBP_PUSH));
+      desc->GetStackStateStartAddress(CodeDescription::POST_RBP_PUSH));
 }
 
 
-void UnwindInfoSection::WriteFDEStateAfterRBPPush(Writer *w) {
+void UnwindInfoSection::WriteFDEStateAfterRBPPush(Writer *w,
+                                                  CodeDescription *desc) {
   // The second state, just after RBP has been pushed.
 
   // RBP / CFA for this function is now the current RSP, so just set the
@@ -1730,11 +1823,12 @@ void UnwindInfoSection::WriteFDEStateAfterRBPPush(Writer *w) {
   // Last location described by this entry.
   w->Write<uint8_t>(DW_CFA_SET_LOC);
   w->Write<uint64_t>(
-      desc_->GetStackStateStartAddress(CodeDescription::POST_RBP_SET));
+      desc->GetStackStateStartAddress(CodeDescription::POST_RBP_SET));
 }
 
 
-void UnwindInfoSection::WriteFDEStateAfterRBPSet(Writer *w) {
+void UnwindInfoSection::WriteFDEStateAfterRBPSet(Writer *w,
+                                                 CodeDescription *desc) {
   // The third state, after the RBP has been set.
 
   // The CFA can now directly be set to RBP.
@@ -1745,11 +1839,12 @@ void UnwindInfoSection::WriteFDEStateAfterRBPSet(Writer *w) {
   // Last location described by this entry.
   w->Write<uint8_t>(DW_CFA_SET_LOC);
   w->Write<uint64_t>(
-      desc_->GetStackStateStartAddress(CodeDescription::POST_RBP_POP));
+      desc->GetStackStateStartAddress(CodeDescription::POST_RBP_POP));
 }
 
 
-void UnwindInfoSection::WriteFDEStateAfterRBPPop(Writer *w) {
+void UnwindInfoSection::WriteFDEStateAfterRBPPop(Writer *w,
+                                                 CodeDescription *desc) {
   // The fourth (final) state. The RBP has been popped (just before issuing a
   // return).
 
@@ -1765,27 +1860,38 @@ void UnwindInfoSection::WriteFDEStateAfterRBPPop(Writer *w) {
 
   // Last location described by this entry.
   w->Write<uint8_t>(DW_CFA_SET_LOC);
-  w->Write<uint64_t>(desc_->CodeEnd());
+  w->Write<uint64_t>(desc->CodeEnd());
 }
 
 
 bool UnwindInfoSection::WriteBody(Writer *w) {
   uint32_t cie_position = WriteCIE(w);
-  WriteFDE(w, cie_position);
+  for (int i = 0; i < descs_->length(); i++) {
+    WriteFDE(w, cie_position, descs_->at(i));
+  }
   return true;
 }
 
 
 #endif  // V8_TARGET_ARCH_X64
 
-static void CreateDWARFSections(CodeDescription* desc, DebugObject* obj) {
-  if (desc->IsLineInfoAvailable()) {
-    obj->AddSection(new DebugInfoSection(desc));
-    obj->AddSection(new DebugAbbrevSection(desc));
-    obj->AddSection(new DebugLineSection(desc));
+static void CreateDWARFSections(const CodeDescriptionList* descs,
+                                DebugObject* obj) {
+  CodeDescriptionList* line_descs = new CodeDescriptionList(descs->length());
+  for (int i = 0; i < descs->length(); i++) {
+    if (descs->at(i)->IsLineInfoAvailable()) line_descs->Add(descs->at(i));
+  }
+  if (!line_descs->is_empty()) {
+    // The line number programs are written before the compilation units
+    // that refer to them.
+    ZoneList<uint32_t>* line_program_offsets =
+        new ZoneList<uint32_t>(line_descs->length());
+    obj->AddSection(new DebugLineSection(line_descs, line_program_offsets));
+    obj->AddSection(new DebugInfoSection(line_descs, line_program_offsets));
+    obj->AddSection(new DebugAbbrevSection(line_descs));
   }
 #ifdef V8_TARGET_ARCH_X64
-  obj->AddSection(new UnwindInfoSection(desc));
+  obj->AddSection(new UnwindInfoSection(descs));
 #endif
 }
 
@@ -1805,6 +1911,8 @@ extern "C" {
     JITCodeEntry* prev_;
     Address symfile_addr_;
     uint64_t symfile_size_;
+    // Not read by GDB: the number of live code objects the entry describes.
+    int code_count_;
   };
 
   struct JITDescriptor {
@@ -1845,6 +1953,7 @@ static JITCodeEntry* CreateCodeEntry(Address symfile_addr,
   memcpy(entry->symfile_addr_, symfile_addr, symfile_size);
 
   entry->prev_ = entry->next_ = NULL;
+  entry->code_count_ = 0;
 
   return entry;
 }
@@ -1903,19 +2012,29 @@ static void UnregisterCodeEntry(JITCodeEntry* entry) {
 }
 
 
-static JITCodeEntry* CreateELFObject(CodeDescription* desc) {
+static JITCodeEntry* CreateELFObject(Vector<CodeDescription*> code) {
   ZoneScope zone_scope(Isolate::Current(), DELETE_ON_EXIT);
+  CodeDescriptionList* descs = new CodeDescriptionList(code.length());
+  // The text section spans all the code objects.
+  uintptr_t code_start = code[0]->CodeStart();
+  uintptr_t code_end = code[0]->CodeEnd();
+  for (int i = 0; i < code.length(); i++) {
+    descs->Add(code[i]);
+    code_start = Min(code_start, code[i]->CodeStart());
+    code_end = Max(code_end, code[i]->CodeEnd());
+  }
+  uintptr_t code_size = code_end - code_start;
 #ifdef __MACH_O
   MachO mach_o;
   Writer w(&mach_o);
 
   mach_o.AddSection(new MachOTextSection(kCodeAlignment,
-                                         desc->CodeStart(),
-                                         desc->CodeSize()));
+                                         code_start,
+                                         code_size));
 
-  CreateDWARFSections(desc, &mach_o);
+  CreateDWARFSections(descs, &mach_o);
 
-  mach_o.Write(&w, desc->CodeStart(), desc->CodeSize());
+  mach_o.Write(&w, code_start, code_size);
 #else
   ELF elf;
   Writer w(&elf);
@@ -1924,14 +2043,14 @@ static JITCodeEntry* CreateELFObject(CodeDescription* desc) {
       new FullHeaderELFSection(".text",
                                ELFSection::TYPE_NOBITS,
                                kCodeAlignment,
-                               desc->CodeStart(),
+                               code_start,
                                0,
-                               desc->CodeSize(),
+                               code_size,
                                ELFSection::FLAG_ALLOC | ELFSection::FLAG_EXEC));
 
-  CreateSymbolsTable(desc, &elf, text_section_index);
+  CreateSymbolsTable(descs, code_start, &elf, text_section_index);
 
-  CreateDWARFSections(desc, &elf);
+  CreateDWARFSections(descs, &elf);
 
   elf.Write(&w);
 #endif
@@ -1961,11 +2080,16 @@ static uint32_t HashForCodeObject(Code* code) {
 }
 
 
+// The entries map code objects to their JITCodeEntry, to the line info
+// registered before the code was added, or to the description of code that
+// is waiting to be registered.
 static const intptr_t kLineInfoTag = 0x1;
+static const intptr_t kPendingCodeTag = 0x2;
+static const intptr_t kTagMask = 0x3;
 
 
 static bool IsLineInfoTagged(void* ptr) {
-  return 0 != (reinterpret_cast<intptr_t>(ptr) & kLineInfoTag);
+  return (reinterpret_cast<intptr_t>(ptr) & kTagMask) == kLineInfoTag;
 }
 
 
@@ -1977,7 +2101,80 @@ static void* TagLineInfo(GDBJITLineInfo* ptr) {
 
 static GDBJITLineInfo* UntagLineInfo(void* ptr) {
   return reinterpret_cast<GDBJITLineInfo*>(
-      reinterpret_cast<intptr_t>(ptr) & ~kLineInfoTag);
+      reinterpret_cast<intptr_t>(ptr) & ~kTagMask);
+}
+
+
+static bool IsPendingCodeTagged(void* ptr) {
+  return (reinterpret_cast<intptr_t>(ptr) & kTagMask) == kPendingCodeTag;
+}
+
+
+static void* TagPendingCode(CodeDescription* ptr) {
+  return reinterpret_cast<void*>(
+      reinterpret_cast<intptr_t>(ptr) | kPendingCodeTag);
+}
+
+
+static CodeDescription* UntagPendingCode(void* ptr) {
+  return reinterpret_cast<CodeDescription*>(
+      reinterpret_cast<intptr_t>(ptr) & ~kTagMask);
+}
+
+
+// The number of code objects whose descriptions are waiting to be
+// registered in a batch, or until the debugger asks for them.
+static int pending_code_count = 0;
+
+
+static bool IsRegistrationDeferred() {
+  return FLAG_gdbjit_lazy || FLAG_gdbjit_batch_size > 1;
+}
+
+
+static bool ShouldDump(const char* name, const char** name_hint) {
+  if (!FLAG_gdbjit_dump) return false;
+  if (strlen(FLAG_gdbjit_dump_filter) == 0) {
+    *name_hint = name;
+    return true;
+  }
+  if (name == NULL) return false;
+  *name_hint = strstr(name, FLAG_gdbjit_dump_filter);
+  return *name_hint != NULL;
+}
+
+
+// Registers the pending code objects, FLAG_gdbjit_batch_size of them in each
+// debug object.
+static void RegisterPendingDescriptions() {
+  if (pending_code_count == 0) return;
+  List<CodeDescription*> pending(pending_code_count);
+  HashMap* entries = GetEntries();
+  for (HashMap::Entry* e = entries->Start(); e != NULL; e = entries->Next(e)) {
+    if (IsPendingCodeTagged(e->value)) pending.Add(UntagPendingCode(e->value));
+  }
+  ASSERT(pending.length() == pending_code_count);
+
+  int batch_size = Max(FLAG_gdbjit_batch_size, 1);
+  for (int start = 0; start < pending.length(); start += batch_size) {
+    int end = Min(start + batch_size, pending.length());
+    Vector<CodeDescription*> batch = pending.ToVector().SubVector(start, end);
+    JITCodeEntry* entry = CreateELFObject(batch);
+    entry->code_count_ = batch.length();
+
+    const char* name_hint = NULL;
+    bool should_dump = false;
+    for (int i = 0; i < batch.length(); i++) {
+      Code* code = batch[i]->code();
+      HashMap::Entry* e = entries->Lookup(code, HashForCodeObject(code), false);
+      ASSERT(e != NULL && IsPendingCodeTagged(e->value));
+      e->value = entry;
+      if (!should_dump) should_dump = ShouldDump(batch[i]->name(), &name_hint);
+    }
+    RegisterCodeEntry(entry, should_dump, name_hint);
+    for (int i = 0; i < batch.length(); i++) delete batch[i];
+  }
+  pending_code_count = 0;
 }
 
 
@@ -2052,38 +2249,46 @@ void GDBJITInterface::AddCode(const char* name,
   if (e->value != NULL && !IsLineInfoTagged(e->value)) return;
 
   GDBJITLineInfo* lineinfo = UntagLineInfo(e->value);
-  CodeDescription code_desc(name,
-                            code,
-                            script != NULL ? Handle<Script>(script)
-                                           : Handle<Script>(),
-                            lineinfo,
-                            tag,
-                            info);
-
-  if (!FLAG_gdbjit_full && !code_desc.IsLineInfoAvailable()) {
+  CodeDescription* code_desc =
+      new CodeDescription(name,
+                          code,
+                          script != NULL ? Handle<Script>(script)
+                                         : Handle<Script>(),
+                          lineinfo,
+                          tag,
+                          info);
+
+  if (!FLAG_gdbjit_full && !code_desc->IsLineInfoAvailable()) {
+    delete code_desc;
     delete lineinfo;
     GetEntries()->Remove(code, HashForCodeObject(code));
     return;
   }
 
-  AddUnwindInfo(&code_desc);
-  JITCodeEntry* entry = CreateELFObject(&code_desc);
-  ASSERT(!IsLineInfoTagged(entry));
+  AddUnwindInfo(code_desc);
+
+  if (IsRegistrationDeferred()) {
+    // Only copy what is needed to build the debug object later.
+    code_desc->Detach();
+    e->value = TagPendingCode(code_desc);
+    pending_code_count++;
+    if (!FLAG_gdbjit_lazy && pending_code_count >= FLAG_gdbjit_batch_size) {
+      RegisterPendingDescriptions();
+    }
+    return;
+  }
 
+  JITCodeEntry* entry =
+      CreateELFObject(Vector<CodeDescription*>(&code_desc, 1));
+  ASSERT(!IsLineInfoTagged(entry) && !IsPendingCodeTagged(entry));
+  entry->code_count_ = 1;
+
+  delete code_desc;
   delete lineinfo;
   e->value = entry;
 
   const char* name_hint = NULL;
-  bool should_dump = false;
-  if (FLAG_gdbjit_dump) {
-    if (strlen(FLAG_gdbjit_dump_filter) == 0) {
-      name_hint = name;
-      should_dump = true;
-    } else if (name != NULL) {
-      name_hint = strstr(name, FLAG_gdbjit_dump_filter);
-      should_dump = (name_hint != NULL);
-    }
-  }
+  bool should_dump = ShouldDump(name, &name_hint);
   RegisterCodeEntry(entry, should_dump, name_hint);
 }
 
@@ -2134,16 +2339,40 @@ void GDBJITInterface::RemoveCode(Code* code) {
 
   if (IsLineInfoTagged(e->value)) {
     delete UntagLineInfo(e->value);
+  } else if (IsPendingCodeTagged(e->value)) {
+    delete UntagPendingCode(e->value);
+    pending_code_count--;
   } else {
+    // An entry describing several code objects stays registered until the
+    // last of them dies.
     JITCodeEntry* entry = static_cast<JITCodeEntry*>(e->value);
-    UnregisterCodeEntry(entry);
-    DestroyCodeEntry(entry);
+    if (--entry->code_count_ == 0) {
+      UnregisterCodeEntry(entry);
+      DestroyCodeEntry(entry);
+    }
   }
   e->value = NULL;
   GetEntries()->Remove(code, HashForCodeObject(code));
 }
 
 
+void GDBJITInterface::RegisterPendingCode() {
+  if (!FLAG_gdbjit) return;
+
+  // The debugger may call this while V8 is stopped holding the lock.
+  if (!mutex_->TryLock()) return;
+  RegisterPendingDescriptions();
+  mutex_->Unlock();
+}
+
+
+// Lets the debugger ask for the code objects that have not been registered
+// yet, with "call __gdb_register_v8_code()".
+extern "C" void __gdb_register_v8_code() {
+  GDBJITInterface::RegisterPendingCode();
+}
+
+
 void GDBJITInterface::RegisterDetailedLineInfo(Code* code,
                                                GDBJITLineInfo* line_info) {
   ScopedLock lock(mutex_);
@@ -131,6 +131,10 @@ class GDBJITInterface: public AllStatic {
 
   static void RemoveCode(Code* code);
 
+  // Registers the code objects that --gdbjit_batch_size or --gdbjit_lazy
+  // held back.
+  static void RegisterPendingCode();
+
   static void RegisterDetailedLineInfo(Code* code, GDBJITLineInfo* line_info);
 
  private:
@@ -70,6 +70,8 @@ class GlobalHandles::Node {
     index_ = 0;
     independent_ = false;
     in_new_space_list_ = false;
+    in_weak_list_ = false;
+    batched_ = false;
     parameter_or_next_free_.next_free = NULL;
     callback_ = NULL;
   }
@@ -80,6 +82,7 @@ class GlobalHandles::Node {
     ASSERT(static_cast<int>(index_) == index);
     state_ = FREE;
     in_new_space_list_ = false;
+    in_weak_list_ = false;
     parameter_or_next_free_.next_free = *first_free;
     *first_free = this;
   }
@@ -89,6 +92,7 @@ class GlobalHandles::Node {
     object_ = object;
     class_id_ = v8::HeapProfiler::kPersistentHandleNoClassId;
     independent_ = false;
+    batched_ = false;
     state_  = NORMAL;
     parameter_or_next_free_.parameter = NULL;
     callback_ = NULL;
@@ -158,6 +162,10 @@ class GlobalHandles::Node {
   void set_in_new_space_list(bool v) { in_new_space_list_ = v; }
   bool is_in_new_space_list() const { return in_new_space_list_; }
 
+  // In-weak-list flag accessors.
+  void set_in_weak_list(bool v) { in_weak_list_ = v; }
+  bool is_in_weak_list() const { return in_weak_list_; }
+
   // Callback accessor.
   WeakReferenceCallback callback() { return callback_; }
 
@@ -183,7 +191,8 @@ class GlobalHandles::Node {
 
   void MakeWeak(GlobalHandles* global_handles,
                 void* parameter,
-                WeakReferenceCallback callback) {
+                WeakReferenceCallback callback,
+                bool batched) {
     ASSERT(state_ != FREE);
     if (!IsWeakRetainer()) {
       global_handles->number_of_weak_handles_++;
@@ -194,6 +203,11 @@ class GlobalHandles::Node {
     state_ = WEAK;
     set_parameter(parameter);
     callback_ = callback;
+    batched_ = batched;
+    if (!in_weak_list_) {
+      global_handles->weak_nodes_.Add(this);
+      in_weak_list_ = true;
+    }
   }
 
   void ClearWeakness(GlobalHandles* global_handles) {
@@ -205,12 +219,19 @@ class GlobalHandles::Node {
       }
     }
     state_ = NORMAL;
+    batched_ = false;
     set_parameter(NULL);
   }
 
   bool PostGarbageCollectionProcessing(Isolate* isolate,
                                        GlobalHandles* global_handles) {
     if (state_ != Node::PENDING) return false;
+    if (batched_) {
+      // The embedder gets the parameter later, together with the others.
+      global_handles->batched_parameters_.Add(parameter());
+      Release(global_handles);
+      return false;
+    }
     WeakReferenceCallback func = callback();
     if (func == NULL) {
       Release(global_handles);
@@ -261,6 +282,10 @@ class GlobalHandles::Node {
 
   bool independent_ : 1;
   bool in_new_space_list_ : 1;
+  bool in_weak_list_ : 1;
+
+  // Made weak with MakeWeakBatched.
+  bool batched_ : 1;
 
   // Handle specific callback.
   WeakReferenceCallback callback_;
@@ -387,6 +412,7 @@ GlobalHandles::GlobalHandles(Isolate* isolate)
       first_block_(NULL),
       first_used_block_(NULL),
       first_free_(NULL),
+      batch_callback_(NULL),
       post_gc_processing_count_(0) {}
 
 
@@ -431,7 +457,12 @@ void GlobalHandles::Destroy(Object** location) {
 void GlobalHandles::MakeWeak(Object** location, void* parameter,
                              WeakReferenceCallback callback) {
   ASSERT(callback != NULL);
-  Node::FromLocation(location)->MakeWeak(this, parameter, callback);
+  Node::FromLocation(location)->MakeWeak(this, parameter, callback, false);
+}
+
+
+void GlobalHandles::MakeWeakBatched(Object** location, void* parameter) {
+  Node::FromLocation(location)->MakeWeak(this, parameter, NULL, true);
 }
 
 
@@ -461,26 +492,30 @@ void GlobalHandles::SetWrapperClassId(Object** location, uint16_t class_id) {
 
 
 void GlobalHandles::IterateWeakRoots(ObjectVisitor* v) {
-  for (NodeIterator it(this); !it.done(); it.Advance()) {
-    if (it.node()->IsWeakRetainer()) v->VisitPointer(it.node()->location());
+  for (int i = 0; i < weak_nodes_.length(); ++i) {
+    Node* node = weak_nodes_[i];
+    ASSERT(node->is_in_weak_list());
+    if (node->IsWeakRetainer()) v->VisitPointer(node->location());
   }
 }
 
 
 void GlobalHandles::IterateWeakRoots(WeakReferenceGuest f,
                                      WeakReferenceCallback callback) {
-  for (NodeIterator it(this); !it.done(); it.Advance()) {
-    if (it.node()->IsWeak() && it.node()->callback() == callback) {
-      f(it.node()->object(), it.node()->parameter());
+  for (int i = 0; i < weak_nodes_.length(); ++i) {
+    Node* node = weak_nodes_[i];
+    if (node->IsWeak() && node->callback() == callback) {
+      f(node->object(), node->parameter());
     }
   }
 }
 
 
 void GlobalHandles::IdentifyWeakHandles(WeakSlotCallback f) {
-  for (NodeIterator it(this); !it.done(); it.Advance()) {
-    if (it.node()->IsWeak() && f(it.node()->location())) {
-      it.node()->MarkPending();
+  for (int i = 0; i < weak_nodes_.length(); ++i) {
+    Node* node = weak_nodes_[i];
+    if (node->IsWeak() && f(node->location())) {
+      node->MarkPending();
     }
   }
 }
@@ -551,17 +586,32 @@ bool GlobalHandles::PostGarbageCollectionProcessing(
       }
     }
   } else {
-    for (NodeIterator it(this); !it.done(); it.Advance()) {
-      if (it.node()->PostGarbageCollectionProcessing(isolate_, this)) {
+    // Only weak handles can be pending.  Callbacks may make more handles
+    // weak, which are appended to the list and skipped as not pending.
+    for (int i = 0; i < weak_nodes_.length(); ++i) {
+      Node* node = weak_nodes_[i];
+      if (node->PostGarbageCollectionProcessing(isolate_, this)) {
         if (initial_post_gc_processing_count != post_gc_processing_count_) {
           // See the comment above.
           return next_gc_likely_to_collect_more;
         }
       }
-      if (!it.node()->IsRetainer()) {
+      if (!node->IsRetainer()) {
         next_gc_likely_to_collect_more = true;
       }
     }
+    // Update the list of weak nodes.
+    int last = 0;
+    for (int i = 0; i < weak_nodes_.length(); ++i) {
+      Node* node = weak_nodes_[i];
+      ASSERT(node->is_in_weak_list());
+      if (node->IsWeakRetainer()) {
+        weak_nodes_[last++] = node;
+      } else {
+        node->set_in_weak_list(false);
+      }
+    }
+    weak_nodes_.Rewind(last);
   }
   // Update the list of new space nodes.
   int last = 0;
@@ -575,6 +625,19 @@ bool GlobalHandles::PostGarbageCollectionProcessing(
     }
   }
   new_space_nodes_.Rewind(last);
+
+  if (!batched_parameters_.is_empty()) {
+    // Take the parameters out first, the callback may cause another
+    // collection that collects more.
+    List<void*> batch(batched_parameters_.length());
+    batch.AddAll(batched_parameters_);
+    batched_parameters_.Clear();
+    if (batch_callback_ != NULL) {
+      // Leaving V8.
+      VMState state(isolate_, EXTERNAL);
+      batch_callback_(&batch[0], batch.length());
+    }
+  }
   return next_gc_likely_to_collect_more;
 }
 
@@ -130,6 +130,18 @@ class GlobalHandles {
                 void* parameter,
                 WeakReferenceCallback callback);
 
+  // Make the global handle weak without a callback of its own.  When only
+  // weak handles point to the object the handle is destroyed and the
+  // parameter is passed, together with those of the other such handles
+  // that died in the same collection, to the batch callback.
+  void MakeWeakBatched(Object** location, void* parameter);
+
+  // Sets the function that receives the parameters of dead handles made
+  // weak with MakeWeakBatched.  Without one the parameters are dropped.
+  void SetWeakReferenceBatchCallback(WeakReferenceBatchCallback callback) {
+    batch_callback_ = callback;
+  }
+
   static void SetWrapperClassId(Object** location, uint16_t class_id);
 
   // Returns the current number of weak handles.
@@ -168,6 +180,11 @@ class GlobalHandles {
   // Iterates over all handles that have embedder-assigned class ID.
   void IterateAllRootsWithClassIds(ObjectVisitor* v);
 
+  // NOTE: The weak handle functions below iterate over a list that is
+  // guaranteed to contain all weak handles (but may also include handles
+  // that are not weak anymore), so collections do not walk the strong
+  // handles to find the few weak ones.
+
   // Iterates over all weak roots in heap.
   void IterateWeakRoots(ObjectVisitor* v);
 
@@ -261,6 +278,17 @@ class GlobalHandles {
   // is accessed, some of the objects may have been promoted already.
   List<Node*> new_space_nodes_;
 
+  // Contains all nodes that were made weak since the last mark-compact
+  // collection.  Note: some of them may have been destroyed or made strong
+  // again since.
+  List<Node*> weak_nodes_;
+
+  // Parameters of batched weak handles that died, waiting for the batch
+  // callback.
+  List<void*> batched_parameters_;
+
+  WeakReferenceBatchCallback batch_callback_;
+
   int post_gc_processing_count_;
 
   List<ObjectGroup*> object_groups_;
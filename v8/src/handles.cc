@@ -104,6 +104,50 @@ void HandleScope::DeleteExtensions(Isolate* isolate) {
 }
 
 
+DeferredHandleScope::DeferredHandleScope(Isolate* isolate)
+    : impl_(isolate->handle_scope_implementer()) {
+  ASSERT(isolate == Isolate::Current());
+  impl_->BeginDeferredScope();
+  v8::ImplementationUtilities::HandleScopeData* data =
+      isolate->handle_scope_data();
+  // Start a new handle block so that the handles of this scope can be
+  // detached from the blocks of the enclosing scopes.
+  Object** new_next = impl_->GetSpareOrNewBlock();
+  Object** new_limit = &new_next[kHandleBlockSize];
+  impl_->blocks()->Add(new_next);
+
+#ifdef DEBUG
+  handles_detached_ = false;
+  prev_level_ = data->level;
+#endif
+  data->level++;
+  prev_limit_ = data->limit;
+  prev_next_ = data->next;
+  data->next = new_next;
+  data->limit = new_limit;
+}
+
+
+DeferredHandleScope::~DeferredHandleScope() {
+  impl_->isolate_->handle_scope_data()->level--;
+  ASSERT(handles_detached_);
+  ASSERT(impl_->isolate_->handle_scope_data()->level == prev_level_);
+}
+
+
+DeferredHandles* DeferredHandleScope::Detach() {
+  DeferredHandles* deferred = impl_->Detach(prev_limit_);
+  v8::ImplementationUtilities::HandleScopeData* data =
+      impl_->isolate_->handle_scope_data();
+  data->next = prev_next_;
+  data->limit = prev_limit_;
+#ifdef DEBUG
+  handles_detached_ = true;
+#endif
+  return deferred;
+}
+
+
 void HandleScope::ZapRange(Object** start, Object** end) {
   ASSERT(end - start <= kHandleBlockSize);
   for (Object** p = start; p != end; p++) {
@@ -233,6 +277,12 @@ void TransformToFastProperties(Handle<JSObject> object,
 }
 
 
+void TransformToFastPropertiesAfterReads(Handle<JSObject> object) {
+  CALL_HEAP_FUNCTION_VOID(object->GetIsolate(),
+                          object->TransformToFastPropertiesAfterReads());
+}
+
+
 Handle<NumberDictionary> NumberDictionarySet(
     Handle<NumberDictionary> dictionary,
     uint32_t index,
@@ -551,7 +601,155 @@ Handle<JSValue> GetScriptWrapper(Handle<Script> script) {
 }
 
 
-// Init line_ends array with code positions of line ends inside script
+// Script line ends are kept in a ByteArray instead of a FixedArray of smis.
+// The table starts with the number of line ends, followed by one checkpoint
+// per chunk of kLineEndsChunkSize line ends holding the absolute position of
+// the chunk's first line end and the byte offset of the chunk's deltas. The
+// remaining line ends of a chunk are stored as variable-length deltas from
+// their predecessor. A lookup binary-searches the checkpoints and decodes at
+// most one chunk, and a typical line costs a single byte.
+static const int kLineEndsChunkSize = 32;
+static const int kLineEndsCountIndex = 0;
+static const int kLineEndsFirstCheckpointIndex = 1;
+static const int kLineEndsCheckpointSize = 2;
+
+
+static int LineEndsChunkCount(int line_count) {
+  return (line_count + kLineEndsChunkSize - 1) / kLineEndsChunkSize;
+}
+
+
+static int LineEndsDeltaSize(int delta) {
+  int size = 1;
+  while (delta >= 0x80) {
+    delta >>= 7;
+    size++;
+  }
+  return size;
+}
+
+
+static Handle<ByteArray> EncodeLineEnds(Isolate* isolate,
+                                        const List<int>& line_ends) {
+  int line_count = line_ends.length();
+  int chunk_count = LineEndsChunkCount(line_count);
+  int deltas_start = (kLineEndsFirstCheckpointIndex +
+                      chunk_count * kLineEndsCheckpointSize) * kIntSize;
+  int size = deltas_start;
+  for (int i = 0; i < line_count; i++) {
+    if (i % kLineEndsChunkSize != 0) {
+      size += LineEndsDeltaSize(line_ends[i] - line_ends[i - 1]);
+    }
+  }
+
+  Handle<ByteArray> table = isolate->factory()->NewByteArray(size, TENURED);
+  table->set_int(kLineEndsCountIndex, line_count);
+  int offset = deltas_start;
+  for (int i = 0; i < line_count; i++) {
+    if (i % kLineEndsChunkSize == 0) {
+      int checkpoint = kLineEndsFirstCheckpointIndex +
+          (i / kLineEndsChunkSize) * kLineEndsCheckpointSize;
+      table->set_int(checkpoint, line_ends[i]);
+      table->set_int(checkpoint + 1, offset);
+    } else {
+      int delta = line_ends[i] - line_ends[i - 1];
+      while (delta >= 0x80) {
+        table->set(offset++, static_cast<byte>((delta & 0x7f) | 0x80));
+        delta >>= 7;
+      }
+      table->set(offset++, static_cast<byte>(delta));
+    }
+  }
+  ASSERT(offset == size);
+  return table;
+}
+
+
+// Iterates the line ends of one chunk of an encoded line ends table.
+class LineEndsChunkIterator {
+ public:
+  LineEndsChunkIterator(ByteArray* table, int chunk)
+      : table_(table),
+        index_(chunk * kLineEndsChunkSize),
+        limit_(Min(index_ + kLineEndsChunkSize,
+                   table->get_int(kLineEndsCountIndex))) {
+    int checkpoint = kLineEndsFirstCheckpointIndex +
+        chunk * kLineEndsCheckpointSize;
+    position_ = table->get_int(checkpoint);
+    offset_ = table->get_int(checkpoint + 1);
+  }
+
+  int index() { return index_; }
+  int position() { return position_; }
+
+  bool Advance() {
+    if (index_ + 1 >= limit_) return false;
+    int delta = 0;
+    int shift = 0;
+    byte b;
+    do {
+      b = table_->get(offset_++);
+      delta |= (b & 0x7f) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    position_ += delta;
+    index_++;
+    return true;
+  }
+
+ private:
+  ByteArray* table_;
+  int index_;
+  int limit_;
+  int position_;
+  int offset_;
+};
+
+
+static int LineEndsCount(ByteArray* table) {
+  return table->get_int(kLineEndsCountIndex);
+}
+
+
+static int LineEndAt(ByteArray* table, int index) {
+  ASSERT(index >= 0 && index < LineEndsCount(table));
+  LineEndsChunkIterator it(table, index / kLineEndsChunkSize);
+  while (it.index() < index) it.Advance();
+  return it.position();
+}
+
+
+// Returns the number of line ends before position, or at or before position
+// if inclusive is set.
+static int CountLineEnds(ByteArray* table, int position, bool inclusive) {
+  int chunk_count = LineEndsChunkCount(LineEndsCount(table));
+  // Find the last chunk starting before (or at) position.
+  int left = 0;
+  int right = chunk_count;
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    int start = table->get_int(kLineEndsFirstCheckpointIndex +
+                               mid * kLineEndsCheckpointSize);
+    if (start < position || (inclusive && start == position)) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  if (left == 0) return 0;
+
+  LineEndsChunkIterator it(table, left - 1);
+  int count = it.index() + 1;
+  while (it.Advance()) {
+    int end = it.position();
+    if (end > position || (!inclusive && end == position)) break;
+    count++;
+  }
+  return count;
+}
+
+
+// Init line_ends table with code positions of line ends inside script
 // source.
 void InitScriptLineEnds(Handle<Script> script) {
   if (!script->line_ends()->IsUndefined()) return;
@@ -560,22 +758,19 @@ void InitScriptLineEnds(Handle<Script> script) {
 
   if (!script->source()->IsString()) {
     ASSERT(script->source()->IsUndefined());
-    Handle<FixedArray> empty = isolate->factory()->NewFixedArray(0);
-    script->set_line_ends(*empty);
-    ASSERT(script->line_ends()->IsFixedArray());
+    script->set_line_ends(*EncodeLineEnds(isolate, List<int>()));
+    ASSERT(script->line_ends()->IsByteArray());
     return;
   }
 
   Handle<String> src(String::cast(script->source()), isolate);
+  // Rough estimate of line count based on a roughly estimated average
+  // length of (unpacked) code.
+  List<int> line_ends(src->length() >> 4);
+  CalculateLineEnds(src, true, &line_ends);
 
-  Handle<FixedArray> array = CalculateLineEnds(src, true);
-
-  if (*array != isolate->heap()->empty_fixed_array()) {
-    array->set_map(isolate->heap()->fixed_cow_array_map());
-  }
-
-  script->set_line_ends(*array);
-  ASSERT(script->line_ends()->IsFixedArray());
+  script->set_line_ends(*EncodeLineEnds(isolate, line_ends));
+  ASSERT(script->line_ends()->IsByteArray());
 }
 
 
@@ -603,31 +798,36 @@ static void CalculateLineEnds(Isolate* isolate,
 }
 
 
+void CalculateLineEnds(Handle<String> src,
+                       bool with_last_line,
+                       List<int>* line_ends) {
+  src = FlattenGetString(src);
+  Isolate* isolate = src->GetIsolate();
+  AssertNoAllocation no_heap_allocation;  // ensure vectors stay valid.
+  // Dispatch on type of strings.
+  String::FlatContent content = src->GetFlatContent();
+  ASSERT(content.IsFlat());
+  if (content.IsAscii()) {
+    CalculateLineEnds(isolate,
+                      line_ends,
+                      content.ToAsciiVector(),
+                      with_last_line);
+  } else {
+    CalculateLineEnds(isolate,
+                      line_ends,
+                      content.ToUC16Vector(),
+                      with_last_line);
+  }
+}
+
+
 Handle<FixedArray> CalculateLineEnds(Handle<String> src,
                                      bool with_last_line) {
-  src = FlattenGetString(src);
   // Rough estimate of line count based on a roughly estimated average
   // length of (unpacked) code.
-  int line_count_estimate = src->length() >> 4;
-  List<int> line_ends(line_count_estimate);
+  List<int> line_ends(src->length() >> 4);
+  CalculateLineEnds(src, with_last_line, &line_ends);
   Isolate* isolate = src->GetIsolate();
-  {
-    AssertNoAllocation no_heap_allocation;  // ensure vectors stay valid.
-    // Dispatch on type of strings.
-    String::FlatContent content = src->GetFlatContent();
-    ASSERT(content.IsFlat());
-    if (content.IsAscii()) {
-      CalculateLineEnds(isolate,
-                        &line_ends,
-                        content.ToAsciiVector(),
-                        with_last_line);
-    } else {
-      CalculateLineEnds(isolate,
-                        &line_ends,
-                        content.ToUC16Vector(),
-                        with_last_line);
-    }
-  }
   int line_count = line_ends.length();
   Handle<FixedArray> array = isolate->factory()->NewFixedArray(line_count);
   for (int i = 0; i < line_count; i++) {
@@ -637,29 +837,59 @@ Handle<FixedArray> CalculateLineEnds(Handle<String> src,
 }
 
 
+int GetScriptLineCount(Handle<Script> script) {
+  InitScriptLineEnds(script);
+  return LineEndsCount(ByteArray::cast(script->line_ends()));
+}
+
+
+int GetScriptLineEnd(Handle<Script> script, int line) {
+  InitScriptLineEnds(script);
+  ByteArray* table = ByteArray::cast(script->line_ends());
+  if (line < 0 || line >= LineEndsCount(table)) return -1;
+  return LineEndAt(table, line);
+}
+
+
+int GetScriptLineFromPosition(Handle<Script> script, int position) {
+  InitScriptLineEnds(script);
+  ByteArray* table = ByteArray::cast(script->line_ends());
+  int line = CountLineEnds(table, position, false);
+  return line < LineEndsCount(table) ? line : -1;
+}
+
+
+Handle<FixedArray> GetScriptLineEnds(Handle<Script> script) {
+  Isolate* isolate = script->GetIsolate();
+  int line_count = GetScriptLineCount(script);
+  if (line_count == 0) return isolate->factory()->empty_fixed_array();
+  Handle<FixedArray> array = isolate->factory()->NewFixedArray(line_count);
+  AssertNoAllocation no_allocation;
+  ByteArray* table = ByteArray::cast(script->line_ends());
+  for (int chunk = 0; chunk < LineEndsChunkCount(line_count); chunk++) {
+    LineEndsChunkIterator it(table, chunk);
+    do {
+      array->set(it.index(), Smi::FromInt(it.position()));
+    } while (it.Advance());
+  }
+  array->set_map(isolate->heap()->fixed_cow_array_map());
+  return array;
+}
+
+
 // Convert code position into line number.
 int GetScriptLineNumber(Handle<Script> script, int code_pos) {
   InitScriptLineEnds(script);
   AssertNoAllocation no_allocation;
-  FixedArray* line_ends_array = FixedArray::cast(script->line_ends());
-  const int line_ends_len = line_ends_array->length();
+  ByteArray* table = ByteArray::cast(script->line_ends());
 
-  if (!line_ends_len) return -1;
+  if (LineEndsCount(table) == 0) return -1;
 
-  if ((Smi::cast(line_ends_array->get(0)))->value() >= code_pos) {
+  if (LineEndAt(table, 0) >= code_pos) {
     return script->line_offset()->value();
   }
 
-  int left = 0;
-  int right = line_ends_len;
-  while (int half = (right - left) / 2) {
-    if ((Smi::cast(line_ends_array->get(left + half)))->value() > code_pos) {
-      right -= half;
-    } else {
-      left += half;
-    }
-  }
-  return right + script->line_offset()->value();
+  return CountLineEnds(table, code_pos, true) + script->line_offset()->value();
 }
 
 // Convert code position into column number.
@@ -668,11 +898,10 @@ int GetScriptColumnNumber(Handle<Script> script, int code_pos) {
   if (line_number == -1) return -1;
 
   AssertNoAllocation no_allocation;
-  FixedArray* line_ends_array = FixedArray::cast(script->line_ends());
+  ByteArray* table = ByteArray::cast(script->line_ends());
   line_number = line_number - script->line_offset()->value();
   if (line_number == 0) return code_pos + script->column_offset()->value();
-  int prev_line_end_pos =
-      Smi::cast(line_ends_array->get(line_number - 1))->value();
+  int prev_line_end_pos = LineEndAt(table, line_number - 1);
   return code_pos - (prev_line_end_pos + 1);
 }
 
@@ -931,4 +1160,21 @@ Handle<ObjectHashTable> PutIntoObjectHashTable(Handle<ObjectHashTable> table,
 }
 
 
+Handle<OrderedHashTable> OrderedHashTablePut(Handle<OrderedHashTable> table,
+                                             Handle<Object> key,
+                                             Handle<Object> value) {
+  CALL_HEAP_FUNCTION(table->GetIsolate(),
+                     table->Put(*key, *value),
+                     OrderedHashTable);
+}
+
+
+Handle<OrderedHashTable> OrderedHashTableRemove(Handle<OrderedHashTable> table,
+                                                Handle<Object> key) {
+  CALL_HEAP_FUNCTION(table->GetIsolate(),
+                     table->Remove(*key),
+                     OrderedHashTable);
+}
+
+
 } }  // namespace v8::internal
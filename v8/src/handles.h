@@ -161,6 +161,36 @@ class HandleScope {
 };
 
 
+class DeferredHandles;
+class HandleScopeImplementer;
+
+
+// A DeferredHandleScope is a HandleScope whose handles are not deallocated
+// when the scope is left.  Detach() hands them to a DeferredHandles object
+// that keeps them alive until it is deleted.  This is used to pass handles
+// to work that completes later, like the optimization of a function on the
+// optimizing compiler thread.  Detach() must be called before the scope is
+// left.
+class DeferredHandleScope {
+ public:
+  explicit DeferredHandleScope(Isolate* isolate);
+  ~DeferredHandleScope();
+
+  // Returns the handles created since this scope was entered.
+  DeferredHandles* Detach();
+
+ private:
+  Object** prev_limit_;
+  Object** prev_next_;
+  HandleScopeImplementer* impl_;
+
+#ifdef DEBUG
+  bool handles_detached_;
+  int prev_level_;
+#endif
+};
+
+
 // ----------------------------------------------------------------------------
 // Handle operations.
 // They might invoke garbage collection. The result is an handle to
@@ -173,6 +203,7 @@ void NormalizeProperties(Handle<JSObject> object,
 Handle<NumberDictionary> NormalizeElements(Handle<JSObject> object);
 void TransformToFastProperties(Handle<JSObject> object,
                                int unused_property_fields);
+void TransformToFastPropertiesAfterReads(Handle<JSObject> object);
 MUST_USE_RESULT Handle<NumberDictionary> NumberDictionarySet(
     Handle<NumberDictionary> dictionary,
     uint32_t index,
@@ -276,13 +307,27 @@ Handle<FixedArray> AddKeysFromJSArray(Handle<FixedArray>,
 // if none exists.
 Handle<JSValue> GetScriptWrapper(Handle<Script> script);
 
-// Script line number computations.
+// Script line number computations. The line ends of a script are computed
+// on first use and kept in a compact, delta-encoded table.
 void InitScriptLineEnds(Handle<Script> script);
 // For string calculates an array of line end positions. If the string
 // does not end with a new line character, this character may optionally be
 // imagined.
 Handle<FixedArray> CalculateLineEnds(Handle<String> string,
                                      bool with_imaginary_last_new_line);
+void CalculateLineEnds(Handle<String> string,
+                       bool with_imaginary_last_new_line,
+                       List<int>* line_ends);
+// Number of lines in the script, and the position of the end of a line
+// (-1 if there is no such line). Lines are counted from the start of the
+// script source, ignoring the script's line offset.
+int GetScriptLineCount(Handle<Script> script);
+int GetScriptLineEnd(Handle<Script> script, int line);
+// Line containing the position, the line end character included, or -1 if
+// the position is past the end of the source. Ignores the line offset.
+int GetScriptLineFromPosition(Handle<Script> script, int position);
+// Copy-on-write array of all line end positions, for exposing to JS.
+Handle<FixedArray> GetScriptLineEnds(Handle<Script> script);
 int GetScriptLineNumber(Handle<Script> script, int code_position);
 // The safe version does not make heap allocations but may work much slower.
 int GetScriptLineNumberSafe(Handle<Script> script, int code_position);
@@ -347,6 +392,13 @@ Handle<ObjectHashTable> PutIntoObjectHashTable(Handle<ObjectHashTable> table,
                                                Handle<Object> key,
                                                Handle<Object> value);
 
+Handle<OrderedHashTable> OrderedHashTablePut(Handle<OrderedHashTable> table,
+                                             Handle<Object> key,
+                                             Handle<Object> value);
+
+Handle<OrderedHashTable> OrderedHashTableRemove(Handle<OrderedHashTable> table,
+                                                Handle<Object> key);
+
 class NoHandleAllocation BASE_EMBEDDED {
  public:
 #ifndef DEBUG
@@ -89,13 +89,14 @@ int Heap::MaxObjectSizeInPagedSpace() {
 MaybeObject* Heap::AllocateStringFromUtf8(Vector<const char> str,
                                           PretenureFlag pretenure) {
   // Check for ASCII first since this is the common case.
-  if (String::IsAscii(str.start(), str.length())) {
+  int non_ascii_start = String::NonAsciiStart(str.start(), str.length());
+  if (non_ascii_start >= str.length()) {
     // If the string is ASCII, we do not need to convert the characters
     // since UTF8 is backwards compatible with ASCII.
     return AllocateStringFromAscii(str, pretenure);
   }
   // Non-ASCII and we need to decode.
-  return AllocateStringFromUtf8Slow(str, pretenure);
+  return AllocateStringFromUtf8Slow(str, non_ascii_start, pretenure);
 }
 
 
@@ -173,13 +174,14 @@ MaybeObject* Heap::AllocateTwoByteSymbol(Vector<const uc16> str,
   return answer;
 }
 
-MaybeObject* Heap::CopyFixedArray(FixedArray* src) {
-  return CopyFixedArrayWithMap(src, src->map());
+MaybeObject* Heap::CopyFixedArray(FixedArray* src, PretenureFlag pretenure) {
+  return CopyFixedArrayWithMap(src, src->map(), pretenure);
 }
 
 
-MaybeObject* Heap::CopyFixedDoubleArray(FixedDoubleArray* src) {
-  return CopyFixedDoubleArrayWithMap(src, src->map());
+MaybeObject* Heap::CopyFixedDoubleArray(FixedDoubleArray* src,
+                                        PretenureFlag pretenure) {
+  return CopyFixedDoubleArrayWithMap(src, src->map(), pretenure);
 }
 
 
@@ -224,7 +226,13 @@ MaybeObject* Heap::AllocateRaw(int size_in_bytes,
     ASSERT(MAP_SPACE == space);
     result = map_space_->AllocateRaw(size_in_bytes);
   }
-  if (result->IsFailure()) old_gen_exhausted_ = true;
+  if (result->IsFailure()) {
+    old_gen_exhausted_ = true;
+  } else if (allocation_sampler_ != NULL) {
+    // New space allocations are sampled when they cross the lowered inline
+    // allocation limit.
+    SampleAllocation(result, size_in_bytes, size_in_bytes);
+  }
   return result;
 }
 
@@ -336,15 +344,12 @@ bool Heap::ShouldBePromoted(Address old_address, int object_size) {
 
 
 void Heap::RecordWrite(Address address, int offset) {
-  if (!InNewSpace(address)) store_buffer_.Mark(address + offset);
-}
-
-
-void Heap::RecordWrites(Address address, int start, int len) {
-  if (!InNewSpace(address)) {
-    for (int i = 0; i < len; i++) {
-      store_buffer_.Mark(address + start + i * kPointerSize);
-    }
+  if (InNewSpace(address)) return;
+  MemoryChunk* chunk = MemoryChunk::FromAddress(address);
+  if (chunk->uses_card_table()) {
+    chunk->MarkCard(address + offset);
+  } else {
+    store_buffer_.Mark(address + offset);
   }
 }
 
@@ -461,24 +466,28 @@ MaybeObject* Heap::PrepareForCompare(String* str) {
 }
 
 
-int Heap::AdjustAmountOfExternalAllocatedMemory(int change_in_bytes) {
+int Heap::AdjustAmountOfExternalAllocatedMemory(int change_in_bytes,
+                                                v8::ExternalMemoryType type) {
   ASSERT(HasBeenSetup());
   int amount = amount_of_external_allocated_memory_ + change_in_bytes;
+  int* amount_of_type = &amount_of_external_allocated_memory_by_type_[type];
   if (change_in_bytes >= 0) {
     // Avoid overflow.
     if (amount > amount_of_external_allocated_memory_) {
       amount_of_external_allocated_memory_ = amount;
+      *amount_of_type += change_in_bytes;
     }
     int amount_since_last_global_gc =
         amount_of_external_allocated_memory_ -
         amount_of_external_allocated_memory_at_last_global_gc_;
-    if (amount_since_last_global_gc > external_allocation_limit_) {
-      CollectAllGarbage(kNoGCFlags);
+    if (amount_since_last_global_gc > external_memory_limit_) {
+      ExternalMemoryPressure(change_in_bytes);
     }
   } else {
     // Avoid underflow.
     if (amount >= 0) {
       amount_of_external_allocated_memory_ = amount;
+      *amount_of_type = Max(*amount_of_type + change_in_bytes, 0);
     }
   }
   ASSERT(amount_of_external_allocated_memory_ >= 0);
@@ -622,7 +631,7 @@ void ExternalStringTable::ShrinkNewStrings(int position) {
 
 
 void Heap::ClearInstanceofCache() {
-  set_instanceof_cache_function(the_hole_value());
+  isolate_->instanceof_cache()->Clear();
 }
 
 
@@ -631,12 +640,6 @@ Object* Heap::ToBoolean(bool condition) {
 }
 
 
-void Heap::CompletelyClearInstanceofCache() {
-  set_instanceof_cache_map(the_hole_value());
-  set_instanceof_cache_function(the_hole_value());
-}
-
-
 MaybeObject* TranscendentalCache::Get(Type type, double input) {
   SubCache* cache = caches_[type];
   if (cache == NULL) {
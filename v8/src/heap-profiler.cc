@@ -36,11 +36,13 @@ namespace internal {
 
 HeapProfiler::HeapProfiler()
     : snapshots_(new HeapSnapshotsCollection()),
-      next_snapshot_uid_(1) {
+      next_snapshot_uid_(1),
+      allocation_sampler_(NULL) {
 }
 
 
 HeapProfiler::~HeapProfiler() {
+  StopAllocationSamplingImpl();
   delete snapshots_;
 }
 
@@ -165,6 +167,46 @@ void HeapProfiler::DeleteAllSnapshots() {
 }
 
 
+void HeapProfiler::StartAllocationSampling(intptr_t sample_interval) {
+  HeapProfiler* profiler = Isolate::Current()->heap_profiler();
+  ASSERT(profiler != NULL);
+  profiler->StartAllocationSamplingImpl(sample_interval);
+}
+
+
+void HeapProfiler::StopAllocationSampling() {
+  HeapProfiler* profiler = Isolate::Current()->heap_profiler();
+  ASSERT(profiler != NULL);
+  profiler->StopAllocationSamplingImpl();
+}
+
+
+bool HeapProfiler::SerializeAllocationSamples(v8::OutputStream* stream) {
+  HeapProfiler* profiler = Isolate::Current()->heap_profiler();
+  ASSERT(profiler != NULL);
+  if (profiler->allocation_sampler_ == NULL) return false;
+  profiler->allocation_sampler_->Serialize(stream);
+  return true;
+}
+
+
+void HeapProfiler::StartAllocationSamplingImpl(intptr_t sample_interval) {
+  // Restarting drops the samples collected so far.
+  StopAllocationSamplingImpl();
+  Isolate* isolate = Isolate::Current();
+  allocation_sampler_ = new AllocationSampler(isolate, sample_interval);
+  isolate->heap()->set_allocation_sampler(allocation_sampler_);
+}
+
+
+void HeapProfiler::StopAllocationSamplingImpl() {
+  if (allocation_sampler_ == NULL) return;
+  Isolate::Current()->heap()->set_allocation_sampler(NULL);
+  delete allocation_sampler_;
+  allocation_sampler_ = NULL;
+}
+
+
 void HeapProfiler::ObjectMoveEvent(Address from, Address to) {
   snapshots_->ObjectMoveEvent(from, to);
 }
@@ -33,6 +33,7 @@
 namespace v8 {
 namespace internal {
 
+class AllocationSampler;
 class HeapSnapshot;
 class HeapSnapshotsCollection;
 
@@ -62,6 +63,10 @@ class HeapProfiler {
   static HeapSnapshot* FindSnapshot(unsigned uid);
   static void DeleteAllSnapshots();
 
+  static void StartAllocationSampling(intptr_t sample_interval);
+  static void StopAllocationSampling();
+  static bool SerializeAllocationSamples(v8::OutputStream* stream);
+
   void ObjectMoveEvent(Address from, Address to);
 
   void DefineWrapperClass(
@@ -83,9 +88,12 @@ class HeapProfiler {
                                  int type,
                                  v8::ActivityControl* control);
   void ResetSnapshots();
+  void StartAllocationSamplingImpl(intptr_t sample_interval);
+  void StopAllocationSamplingImpl();
 
   HeapSnapshotsCollection* snapshots_;
   unsigned next_snapshot_uid_;
+  AllocationSampler* allocation_sampler_;
   List<v8::HeapProfiler::WrapperInfoCallback> wrapper_callbacks_;
 };
 
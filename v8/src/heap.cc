@@ -42,6 +42,8 @@
 #include "natives.h"
 #include "objects-visiting.h"
 #include "objects-visiting-inl.h"
+#include "optimizing-compiler-thread.h"
+#include "profile-generator.h"
 #include "runtime-profiler.h"
 #include "scopeinfo.h"
 #include "snapshot.h"
@@ -89,6 +91,8 @@ Heap::Heap()
 // Will be 4 * reserved_semispace_size_ to ensure that young
 // generation can be aligned to its size.
       survived_since_last_expansion_(0),
+      last_scavenge_end_time_(0),
+      grow_new_space_(false),
       sweep_generation_(0),
       always_allocate_scope_depth_(0),
       linear_allocation_scope_depth_(0),
@@ -118,6 +122,7 @@ Heap::Heap()
       old_gen_limit_factor_(1),
       size_of_old_gen_at_last_old_space_gc_(0),
       external_allocation_limit_(0),
+      external_memory_limit_(0),
       amount_of_external_allocated_memory_(0),
       amount_of_external_allocated_memory_at_last_global_gc_(0),
       old_gen_exhausted_(false),
@@ -125,6 +130,7 @@ Heap::Heap()
       hidden_symbol_(NULL),
       global_gc_prologue_callback_(NULL),
       global_gc_epilogue_callback_(NULL),
+      gc_event_callback_(NULL),
       gc_safe_size_of_old_object_(NULL),
       total_regexp_code_generated_(0),
       tracer_(NULL),
@@ -137,10 +143,14 @@ Heap::Heap()
       max_alive_after_gc_(0),
       min_in_mutator_(kMaxInt),
       alive_after_last_gc_(0),
+      startup_size_(0),
+      startup_committed_memory_(0),
       last_gc_end_timestamp_(0.0),
       store_buffer_(this),
       marking_(this),
       incremental_marking_(this),
+      pretenuring_tracker_(this),
+      allocation_sampler_(NULL),
       number_idle_notifications_(0),
       last_idle_notification_gc_count_(0),
       last_idle_notification_gc_count_init_(false),
@@ -149,9 +159,18 @@ Heap::Heap()
       ms_count_at_last_idle_notification_(0),
       gc_count_at_last_idle_gc_(0),
       scavenges_since_last_idle_round_(kIdleScavengeThreshold),
+      idle_sweeping_speed_(kInitialIdleSpeed),
+      idle_scavenge_speed_(kInitialIdleSpeed),
+      idle_mark_compact_speed_(kInitialIdleSpeed),
+      mark_compact_speed_(0),
+      old_gen_promotion_rate_(0),
+      last_mark_compact_end_time_(0),
       promotion_queue_(this),
       configured_(false),
-      chunks_queued_for_free_(NULL) {
+      chunks_queued_for_free_(NULL),
+      scavenger_threads_(NULL),
+      scavenger_threads_count_(0),
+      scavenge_allocation_mutex_(NULL) {
   // Allow build-time customization of the max semispace size. Building
   // V8 with snapshots and a non-default max semispace size is much
   // easier if you can define it as part of the build environment.
@@ -169,6 +188,8 @@ Heap::Heap()
   }
 
   memset(roots_, 0, sizeof(roots_[0]) * kRootListLength);
+  memset(amount_of_external_allocated_memory_by_type_, 0,
+         sizeof(amount_of_external_allocated_memory_by_type_));
   global_contexts_list_ = NULL;
   mark_compact_collector_.heap_ = this;
   external_string_table_.heap_ = this;
@@ -418,6 +439,13 @@ void Heap::GarbageCollectionEpilogue() {
   isolate_->counters()->alive_after_last_gc()->Set(
       static_cast<int>(SizeOfObjects()));
 
+  isolate_->counters()->code_space_bytes_committed()->Set(
+      static_cast<int>(code_space()->CommittedMemory()));
+  isolate_->counters()->code_space_bytes_used()->Set(
+      static_cast<int>(code_space()->SizeOfObjects()));
+  isolate_->counters()->executable_bytes()->Set(
+      static_cast<int>(isolate_->memory_allocator()->SizeExecutable()));
+
   isolate_->counters()->symbol_table_capacity()->Set(
       symbol_table()->Capacity());
   isolate_->counters()->number_of_symbols()->Set(
@@ -441,6 +469,34 @@ void Heap::CollectAllGarbage(int flags) {
 }
 
 
+void Heap::ReduceMemoryFootprint() {
+  CollectAllGarbage(kReduceMemoryFootprintMask);
+  ReleaseFreeMemory();
+}
+
+
+void Heap::ReleaseFreeMemory() {
+  new_space_.Shrink();
+  UncommitFromSpace();
+  Shrink();
+  isolate_->memory_allocator()->ReleaseLargeChunkCache();
+  PagePool::TearDown();
+  intptr_t discarded = 0;
+  PagedSpaces spaces;
+  for (PagedSpace* space = spaces.next();
+       space != NULL;
+       space = spaces.next()) {
+    discarded += space->DiscardFreeMemory();
+  }
+  if (FLAG_trace_gc) {
+    PrintF("Memory reducer: %d KB committed, %d KB of free blocks "
+           "discarded\n",
+           static_cast<int>(CommittedMemory() / KB),
+           static_cast<int>(discarded / KB));
+  }
+}
+
+
 void Heap::CollectAllAvailableGarbage() {
   // Since we are ignoring the return value, the exact choice of space does
   // not matter, so long as we do not specify NEW_SPACE, which would not
@@ -499,6 +555,11 @@ bool Heap::CollectGarbage(AllocationSpace space, GarbageCollector collector) {
 
   bool next_gc_likely_to_collect_more = false;
 
+  // Objects must not move while the optimizing compiler thread looks at
+  // them.
+  OptimizingCompilerThread::PauseScope pause_optimizing_compiler(
+      isolate_->optimizing_compiler_thread());
+
   { GCTracer tracer(this);
     GarbageCollectionPrologue();
     // The GC count was incremented in the prologue.  Tell the tracer about
@@ -666,6 +727,11 @@ void Heap::ClearNormalizedMapCaches() {
   Object* context = global_contexts_list_;
   while (!context->IsUndefined()) {
     Context::cast(context)->normalized_map_cache()->Clear();
+    FixedArray* fast_properties_maps =
+        Context::cast(context)->fast_properties_map_cache();
+    for (int i = 0; i < fast_properties_maps->length(); i++) {
+      fast_properties_maps->set_undefined(i);
+    }
     context = Context::cast(context)->get(Context::NEXT_CONTEXT_LINK);
   }
 }
@@ -734,7 +800,11 @@ bool Heap::PerformGarbageCollection(GarbageCollector collector,
 
   if (collector == MARK_COMPACTOR) {
     // Perform mark-sweep with optional compaction.
+    intptr_t old_gen_size_before_gc = PromotedSpaceSize();
+    double mark_compact_start = OS::TimeCurrentMillis();
     MarkCompact(tracer);
+    UpdateOldGenGrowthRates(old_gen_size_before_gc,
+                            OS::TimeCurrentMillis() - mark_compact_start);
     sweep_generation_++;
     bool high_survival_rate_during_scavenges = IsHighSurvivalRate() &&
         IsStableOrIncreasingSurvivalTrend();
@@ -790,10 +860,13 @@ bool Heap::PerformGarbageCollection(GarbageCollector collector,
     old_gen_exhausted_ = false;
   } else {
     tracer_ = tracer;
+    double scavenge_start = OS::TimeCurrentMillis();
     Scavenge();
     tracer_ = NULL;
 
     UpdateSurvivalRateTrend(start_new_space_size);
+    ResizeNewSpace(start_new_space_size,
+                   OS::TimeCurrentMillis() - scavenge_start);
   }
 
   if (new_space_high_promotion_mode_active_ &&
@@ -815,9 +888,15 @@ bool Heap::PerformGarbageCollection(GarbageCollector collector,
   Relocatable::PostGarbageCollectionProcessing();
 
   if (collector == MARK_COMPACTOR) {
-    // Register the amount of external allocated memory.
+    // Register the amount of external allocated memory, and allow it to
+    // grow by half of that before the next global GC, like the old
+    // generation.
     amount_of_external_allocated_memory_at_last_global_gc_ =
         amount_of_external_allocated_memory_;
+    external_memory_limit_ =
+        Max(external_allocation_limit_,
+            static_cast<intptr_t>(amount_of_external_allocated_memory_ / 2));
+    external_memory_limit_ *= old_gen_limit_factor_;
   }
 
   GCCallbackFlags callback_flags = kNoGCCallbackFlags;
@@ -853,6 +932,8 @@ void Heap::MarkCompact(GCTracer* tracer) {
 
   mark_compact_collector_.CollectGarbage();
 
+  isolate_->compilation_cache()->MarkCompactEpilogue();
+
   LOG(isolate_, ResourceEvent("markcompact", "end"));
 
   gc_state_ = NOT_IN_GC;
@@ -869,11 +950,13 @@ void Heap::MarkCompactPrologue() {
   isolate_->keyed_lookup_cache()->Clear();
   isolate_->context_slot_cache()->Clear();
   isolate_->descriptor_lookup_cache()->Clear();
+  isolate_->code_stub_lookup_cache()->Clear();
   StringSplitCache::Clear(string_split_cache());
+  FieldDescriptorsCache::Clear(field_descriptors_cache());
 
   isolate_->compilation_cache()->MarkCompactPrologue();
 
-  CompletelyClearInstanceofCache();
+  ClearInstanceofCache();
 
   // TODO(1605) select heuristic for flushing NumberString cache with
   // FlushNumberStringCache
@@ -952,6 +1035,15 @@ static void VerifyNonPointerSpacePointers() {
 
 
 void Heap::CheckNewSpaceExpansionCriteria() {
+  if (FLAG_adaptive_new_space) {
+    if (grow_new_space_ &&
+        new_space_.Capacity() < new_space_.MaximumCapacity() &&
+        !new_space_high_promotion_mode_active_) {
+      new_space_.Grow();
+    }
+    grow_new_space_ = false;
+    return;
+  }
   if (new_space_.Capacity() < new_space_.MaximumCapacity() &&
       survived_since_last_expansion_ > new_space_.Capacity() &&
       !new_space_high_promotion_mode_active_) {
@@ -964,12 +1056,107 @@ void Heap::CheckNewSpaceExpansionCriteria() {
 }
 
 
+void Heap::UpdateOldGenGrowthRates(intptr_t old_gen_size_before_gc,
+                                   double mark_compact_ms) {
+  double now = OS::TimeCurrentMillis();
+  if (mark_compact_ms > 0) {
+    double speed = old_gen_size_before_gc / mark_compact_ms;
+    mark_compact_speed_ = mark_compact_speed_ == 0
+        ? speed : (mark_compact_speed_ + speed) / 2;
+  }
+  // size_of_old_gen_at_last_old_space_gc_ still holds the size after the
+  // previous full collection.
+  double interval = now - mark_compact_ms - last_mark_compact_end_time_;
+  intptr_t promoted =
+      old_gen_size_before_gc - size_of_old_gen_at_last_old_space_gc_;
+  if (last_mark_compact_end_time_ != 0 && interval > 0 && promoted > 0) {
+    double rate = promoted / interval;
+    old_gen_promotion_rate_ = old_gen_promotion_rate_ == 0
+        ? rate : (old_gen_promotion_rate_ + rate) / 2;
+  }
+  last_mark_compact_end_time_ = now;
+  if (FLAG_trace_gc_verbose && FLAG_target_gc_overhead > 0) {
+    PrintF("Full collections: %.0f KB/ms collected, %.1f KB/ms promoted\n",
+           mark_compact_speed_ / KB, old_gen_promotion_rate_ / KB);
+  }
+}
+
+
+intptr_t Heap::OldGenGrowthForTargetOverhead(intptr_t old_gen_size) {
+  if (FLAG_target_gc_overhead <= 0 || FLAG_stress_compaction ||
+      mark_compact_speed_ == 0 || old_gen_promotion_rate_ == 0) {
+    return -1;
+  }
+  double target = Min(FLAG_target_gc_overhead, 99) / 100.0;
+  double gc_ms = old_gen_size / mark_compact_speed_;
+  double mutator_ms = gc_ms * (1 - target) / target;
+  double growth = Min(mutator_ms * old_gen_promotion_rate_,
+                      static_cast<double>(max_old_generation_size_));
+  return static_cast<intptr_t>(growth);
+}
+
+
+void Heap::ResizeNewSpace(int allocated, double scavenge_ms) {
+  double now = OS::TimeCurrentMillis();
+  double interval = now - last_scavenge_end_time_;
+  bool first_scavenge = last_scavenge_end_time_ == 0;
+  last_scavenge_end_time_ = now;
+  if (!FLAG_adaptive_new_space || first_scavenge || interval <= 0) return;
+
+  double overhead = scavenge_ms * 100 / interval;
+  if (FLAG_trace_gc_verbose) {
+    double allocated_mb = static_cast<double>(allocated) / MB;
+    PrintF("New space %d KB: %.2f ms per MB allocated, %.1f MB/s, "
+           "%.1f%% of the time in scavenges\n",
+           static_cast<int>(new_space_.Capacity() / KB),
+           allocated_mb > 0 ? scavenge_ms / allocated_mb : 0.0,
+           allocated_mb * 1000 / interval,
+           overhead);
+  }
+
+  // Doubling new space about halves the share of time in scavenges, since
+  // their cost follows the survivors and not the capacity, so the share
+  // has to drop well below the target before new space shrinks again.
+  // Idle time between scavenges lowers the share, so new space shrinks
+  // back when the isolate is idle.
+  if (overhead > FLAG_target_scavenge_overhead) {
+    grow_new_space_ = true;
+  } else if (overhead < FLAG_target_scavenge_overhead / 4.0 &&
+             new_space_.Capacity() > new_space_.InitialCapacity()) {
+    new_space_.Shrink();
+  }
+}
+
+
 static bool IsUnscavengedHeapObject(Heap* heap, Object** p) {
   return heap->InNewSpace(*p) &&
       !HeapObject::cast(*p)->map_word().IsForwardingAddress();
 }
 
 
+void Heap::RecordWrites(Address address, int start, int len) {
+  if (InNewSpace(address)) return;
+  MemoryChunk* chunk = MemoryChunk::FromAddress(address);
+  // A quarter of the store buffer is the most a single range may take.
+  static const int kMaxRecordedSlots = StoreBuffer::kStoreBufferLength / 4;
+  Object** slots = reinterpret_cast<Object**>(address + start);
+  int recorded = 0;
+  for (int i = 0; i < len; i++) {
+    if (chunk->scan_on_scavenge()) return;
+    if (!InNewSpace(slots[i])) continue;
+    Address slot = reinterpret_cast<Address>(slots + i);
+    if (chunk->uses_card_table()) {
+      chunk->MarkCard(slot);
+    } else if (++recorded > kMaxRecordedSlots) {
+      chunk->set_scan_on_scavenge(true);
+      return;
+    } else {
+      store_buffer_.Mark(slot);
+    }
+  }
+}
+
+
 void Heap::ScavengeStoreBufferCallback(
     Heap* heap,
     MemoryChunk* page,
@@ -1077,6 +1264,9 @@ void Heap::Scavenge() {
   // Clear descriptor cache.
   isolate_->descriptor_lookup_cache()->Clear();
 
+  // Functions cached by the instanceof stub may move.
+  ClearInstanceofCache();
+
   // Used for updating survived_since_last_expansion_ at function end.
   intptr_t survived_watermark = PromotedSpaceSize();
 
@@ -1118,46 +1308,56 @@ void Heap::Scavenge() {
 #endif
 
   ScavengeVisitor scavenge_visitor(this);
-  // Copy roots.
-  IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
+  { GCTracer::Scope gc_scope(tracer_, GCTracer::Scope::SCAVENGER_ROOTS);
+    // Copy roots.
+    IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
 
-  // Copy objects reachable from the old generation.
-  {
-    StoreBufferRebuildScope scope(this,
-                                  store_buffer(),
-                                  &ScavengeStoreBufferCallback);
-    store_buffer()->IteratePointersToNewSpace(&ScavengeObject);
-  }
+    // Copy objects reachable from the old generation.
+    {
+      StoreBufferRebuildScope scope(this,
+                                    store_buffer(),
+                                    &ScavengeStoreBufferCallback);
+      store_buffer()->IteratePointersToNewSpace(&ScavengeObject);
+    }
 
-  // Copy objects reachable from cells by scavenging cell values directly.
-  HeapObjectIterator cell_iterator(cell_space_);
-  for (HeapObject* cell = cell_iterator.Next();
-       cell != NULL; cell = cell_iterator.Next()) {
-    if (cell->IsJSGlobalPropertyCell()) {
-      Address value_address =
-          reinterpret_cast<Address>(cell) +
-          (JSGlobalPropertyCell::kValueOffset - kHeapObjectTag);
-      scavenge_visitor.VisitPointer(reinterpret_cast<Object**>(value_address));
+    // Copy objects reachable from cells by scavenging cell values directly.
+    HeapObjectIterator cell_iterator(cell_space_);
+    for (HeapObject* cell = cell_iterator.Next();
+         cell != NULL; cell = cell_iterator.Next()) {
+      if (cell->IsJSGlobalPropertyCell()) {
+        Address value_address =
+            reinterpret_cast<Address>(cell) +
+            (JSGlobalPropertyCell::kValueOffset - kHeapObjectTag);
+        scavenge_visitor.VisitPointer(
+            reinterpret_cast<Object**>(value_address));
+      }
     }
-  }
 
-  // Scavenge object reachable from the global contexts list directly.
-  scavenge_visitor.VisitPointer(BitCast<Object**>(&global_contexts_list_));
+    // Scavenge object reachable from the global contexts list directly.
+    scavenge_visitor.VisitPointer(BitCast<Object**>(&global_contexts_list_));
+  }
 
+  if (CanUseParallelScavenge()) {
+    new_space_front = ParallelScavenge(new_space_front);
+  }
   new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
-  isolate_->global_handles()->IdentifyNewSpaceWeakIndependentHandles(
-      &IsUnscavengedHeapObject);
-  isolate_->global_handles()->IterateNewSpaceWeakIndependentRoots(
-      &scavenge_visitor);
-  new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+  { GCTracer::Scope gc_scope(tracer_,
+                             GCTracer::Scope::SCAVENGER_WEAK_PROCESSING);
+    isolate_->global_handles()->IdentifyNewSpaceWeakIndependentHandles(
+        &IsUnscavengedHeapObject);
+    isolate_->global_handles()->IterateNewSpaceWeakIndependentRoots(
+        &scavenge_visitor);
+    new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
 
-  UpdateNewSpaceReferencesInExternalStringTable(
-      &UpdateNewSpaceReferenceInExternalStringTableEntry);
+    UpdateNewSpaceReferencesInExternalStringTable(
+        &UpdateNewSpaceReferenceInExternalStringTableEntry);
+  }
 
   promotion_queue_.Destroy();
 
   LiveObjectList::UpdateReferencesForScavengeGC();
   isolate()->runtime_profiler()->UpdateSamplesAfterScavenge();
+  pretenuring_tracker_.UpdateSitesAfterScavenge();
   incremental_marking()->UpdateMarkingDequeAfterScavenge();
 
   ASSERT(new_space_front == new_space_.top());
@@ -1400,6 +1600,509 @@ Address Heap::DoScavenge(ObjectVisitor* scavenge_visitor,
 }
 
 
+// Per-thread state of the parallel scavenger.  A worker copies objects into
+// its own linear allocation buffers in to-space and in old space and is the
+// only one to scan the objects it copied, so once the initial work has been
+// handed out no work has to move between workers.  Objects are claimed by
+// installing the forwarding address with a compare-and-swap on their map
+// word; a worker that loses the race gives back the space it allocated.
+class ScavengeWorker {
+ public:
+  explicit ScavengeWorker(Heap* heap)
+      : heap_(heap),
+        scan_index_(0),
+        lab_range_index_(-1),
+        promoted_size_(0) {
+    new_space_lab_.top = new_space_lab_.limit = NULL;
+    old_pointer_lab_.top = old_pointer_lab_.limit = NULL;
+    old_data_lab_.top = old_data_lab_.limit = NULL;
+  }
+
+  // Adds a range of copied but not yet scanned to-space objects.
+  void AddToSpaceWork(Address start, Address end) {
+    ranges_.Add(ScanRange(start, end));
+  }
+
+  // Adds a promoted object that has not been scanned yet.
+  void AddPromotedWork(HeapObject* target, int size) {
+    promoted_.Add(PromotedEntry(target, size));
+  }
+
+  // Scans the work of this worker until it has no unscanned objects left.
+  // Called on a scavenger thread or on the thread running the scavenge.
+  void ProcessWork();
+
+  // Gives back the unused parts of the allocation buffers and enters the
+  // recorded old-to-new slots into the store buffer.  Called on the thread
+  // running the scavenge after all workers are done.
+  void Finish();
+
+  inline void ScavengeSlot(HeapObject** slot, HeapObject* object);
+
+ private:
+  static const int kLinearAllocationBufferSize = 8 * KB;
+
+  struct ScanRange {
+    ScanRange(Address start, Address end) : scan(start), end(end) { }
+    Address scan;
+    Address end;
+  };
+
+  struct PromotedEntry {
+    PromotedEntry(HeapObject* target, int size) : target(target), size(size) { }
+    HeapObject* target;
+    int size;
+  };
+
+  HeapObject* CopyObject(HeapObject* object, Map* map);
+  HeapObject* AllocateInNewSpace(int size);
+  HeapObject* AllocateInOldSpace(AllocationSpace space,
+                                 int size,
+                                 bool beyond_limit);
+  bool RefillNewSpaceLab(int size);
+  bool RefillOldSpaceLab(OldSpace* space,
+                         AllocationInfo* lab,
+                         int size,
+                         bool beyond_limit);
+  void RetireNewSpaceLab();
+  void RetireOldSpaceLab(OldSpace* space, AllocationInfo* lab);
+  bool ScanToSpace();
+  void ScanPromotedObject(HeapObject* target, int size);
+
+  Heap* heap_;
+
+  // Ranges of to-space objects to scan.  The range the current to-space
+  // allocation buffer is carved from ends at the top of that buffer.
+  List<ScanRange> ranges_;
+  int scan_index_;
+  int lab_range_index_;
+
+  List<PromotedEntry> promoted_;
+
+  // Slots of promoted objects that still point into new space.
+  List<Address> old_to_new_slots_;
+
+  AllocationInfo new_space_lab_;
+  AllocationInfo old_pointer_lab_;
+  AllocationInfo old_data_lab_;
+
+  intptr_t promoted_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScavengeWorker);
+};
+
+
+class ScavengeWorkerVisitor : public ObjectVisitor {
+ public:
+  ScavengeWorkerVisitor(Heap* heap, ScavengeWorker* worker)
+      : heap_(heap), worker_(worker) { }
+
+  void VisitPointer(Object** p) { ScavengePointer(p); }
+
+  void VisitPointers(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) ScavengePointer(p);
+  }
+
+ private:
+  void ScavengePointer(Object** p) {
+    Object* object = *p;
+    if (!heap_->InNewSpace(object)) return;
+    worker_->ScavengeSlot(reinterpret_cast<HeapObject**>(p),
+                          reinterpret_cast<HeapObject*>(object));
+  }
+
+  Heap* heap_;
+  ScavengeWorker* worker_;
+};
+
+
+void ScavengeWorker::ScavengeSlot(HeapObject** slot, HeapObject* object) {
+  ASSERT(heap_->InFromSpace(object));
+  MapWord first_word = MapWord::FromRawValue(static_cast<uintptr_t>(
+      Acquire_Load(reinterpret_cast<AtomicWord*>(object->address()))));
+  if (first_word.IsForwardingAddress()) {
+    *slot = first_word.ToForwardingAddress();
+    return;
+  }
+  *slot = CopyObject(object, first_word.ToMap());
+}
+
+
+HeapObject* ScavengeWorker::CopyObject(HeapObject* object, Map* map) {
+  int size = object->SizeFromMap(map);
+  ASSERT(size <= Page::kMaxHeapObjectSize);
+
+  AllocationSpace space = heap_->TargetSpaceId(map->instance_type());
+  HeapObject* target = NULL;
+  AllocationInfo* lab = NULL;
+  if (heap_->ShouldBePromoted(object->address(), size)) {
+    target = AllocateInOldSpace(space, size, false);
+    if (target != NULL) {
+      lab = (space == OLD_POINTER_SPACE) ? &old_pointer_lab_ : &old_data_lab_;
+    }
+  }
+  if (target == NULL) {
+    target = AllocateInNewSpace(size);
+    if (target != NULL) {
+      lab = &new_space_lab_;
+    } else {
+      // The allocation buffers can waste a little to-space at the end of
+      // each page, so the survivors may not fit.  Promote them instead, even
+      // if that takes the old generation past its limit: the limit only
+      // schedules the next mark-compact, and the serial scavenger would have
+      // kept these objects in to-space without needing one.
+      target = AllocateInOldSpace(space, size, true);
+      if (target == NULL) {
+        // Old space cannot grow at all, which the serial scavenger would not
+        // survive either once to-space is full.
+        V8::FatalProcessOutOfMemory("ScavengeWorker::CopyObject");
+      }
+      lab = (space == OLD_POINTER_SPACE) ? &old_pointer_lab_ : &old_data_lab_;
+    }
+  }
+
+  heap_->CopyBlock(target->address(), object->address(), size);
+
+  AtomicWord expected =
+      static_cast<AtomicWord>(MapWord::FromMap(map).ToRawValue());
+  AtomicWord forwarding = static_cast<AtomicWord>(
+      MapWord::FromForwardingAddress(target).ToRawValue());
+  AtomicWord previous = Release_CompareAndSwap(
+      reinterpret_cast<AtomicWord*>(object->address()), expected, forwarding);
+  if (previous != expected) {
+    // Another worker copied the object first.  The copy we made is the last
+    // allocation in its buffer, so simply give its space back.
+    ASSERT(lab->top == target->address() + size);
+    lab->top -= size;
+    return MapWord::FromRawValue(
+        static_cast<uintptr_t>(previous)).ToForwardingAddress();
+  }
+
+  if (lab != &new_space_lab_) {
+    promoted_size_ += size;
+    if (space == OLD_POINTER_SPACE) AddPromotedWork(target, size);
+  }
+  return target;
+}
+
+
+HeapObject* ScavengeWorker::AllocateInNewSpace(int size) {
+  if (new_space_lab_.limit - new_space_lab_.top < size) {
+    if (!RefillNewSpaceLab(size)) return NULL;
+  }
+  HeapObject* result = HeapObject::FromAddress(new_space_lab_.top);
+  new_space_lab_.top += size;
+  return result;
+}
+
+
+HeapObject* ScavengeWorker::AllocateInOldSpace(AllocationSpace space,
+                                               int size,
+                                               bool beyond_limit) {
+  OldSpace* old_space;
+  AllocationInfo* lab;
+  if (space == OLD_POINTER_SPACE) {
+    old_space = heap_->old_pointer_space();
+    lab = &old_pointer_lab_;
+  } else {
+    old_space = heap_->old_data_space();
+    lab = &old_data_lab_;
+  }
+  if (lab->limit - lab->top < size) {
+    if (!RefillOldSpaceLab(old_space, lab, size, beyond_limit)) return NULL;
+  }
+  HeapObject* result = HeapObject::FromAddress(lab->top);
+  lab->top += size;
+  return result;
+}
+
+
+bool ScavengeWorker::RefillNewSpaceLab(int size) {
+  RetireNewSpaceLab();
+  ScopedLock lock(heap_->scavenge_allocation_mutex_);
+  NewSpace* new_space = heap_->new_space();
+  int lab_size = Max(size, kLinearAllocationBufferSize);
+  Object* result;
+  MaybeObject* maybe_result = new_space->AllocateRaw(lab_size);
+  if (!maybe_result->ToObject(&result) && lab_size > size) {
+    lab_size = size;
+    maybe_result = new_space->AllocateRaw(lab_size);
+  }
+  if (!maybe_result->ToObject(&result)) return false;
+  heap_->promotion_queue()->SetNewLimit(new_space->top());
+  new_space_lab_.top = HeapObject::cast(result)->address();
+  new_space_lab_.limit = new_space_lab_.top + lab_size;
+  lab_range_index_ = ranges_.length();
+  ranges_.Add(ScanRange(new_space_lab_.top, NULL));
+  return true;
+}
+
+
+bool ScavengeWorker::RefillOldSpaceLab(OldSpace* space,
+                                       AllocationInfo* lab,
+                                       int size,
+                                       bool beyond_limit) {
+  ScopedLock lock(heap_->scavenge_allocation_mutex_);
+  RetireOldSpaceLab(space, lab);
+  int lab_size = Max(size, kLinearAllocationBufferSize);
+  Object* result;
+  MaybeObject* maybe_result = space->AllocateRaw(lab_size);
+  if (!maybe_result->ToObject(&result) && lab_size > size) {
+    lab_size = size;
+    maybe_result = space->AllocateRaw(lab_size);
+  }
+  if (!maybe_result->ToObject(&result) && beyond_limit) {
+    // Paged spaces only read always_allocate() when they expand, which the
+    // workers do under the allocation mutex, so it is safe to set it here.
+    // AlwaysAllocateScope is not used because the scavenge may already run
+    // inside one.
+    heap_->always_allocate_scope_depth_++;
+    maybe_result = space->AllocateRaw(lab_size);
+    heap_->always_allocate_scope_depth_--;
+  }
+  if (!maybe_result->ToObject(&result)) return false;
+  lab->top = HeapObject::cast(result)->address();
+  lab->limit = lab->top + lab_size;
+  return true;
+}
+
+
+void ScavengeWorker::RetireNewSpaceLab() {
+  if (lab_range_index_ < 0) return;
+  ranges_[lab_range_index_].end = new_space_lab_.top;
+  lab_range_index_ = -1;
+  int remaining = static_cast<int>(new_space_lab_.limit - new_space_lab_.top);
+  if (remaining > 0) heap_->CreateFillerObjectAt(new_space_lab_.top, remaining);
+  new_space_lab_.top = new_space_lab_.limit = NULL;
+}
+
+
+void ScavengeWorker::RetireOldSpaceLab(OldSpace* space, AllocationInfo* lab) {
+  int remaining = static_cast<int>(lab->limit - lab->top);
+  if (remaining > 0) space->Free(lab->top, remaining);
+  lab->top = lab->limit = NULL;
+}
+
+
+bool ScavengeWorker::ScanToSpace() {
+  ScavengeWorkerVisitor visitor(heap_, this);
+  bool scanned = false;
+  while (scan_index_ < ranges_.length()) {
+    Address current = ranges_[scan_index_].scan;
+    Address end = (scan_index_ == lab_range_index_)
+        ? new_space_lab_.top
+        : ranges_[scan_index_].end;
+    if (current == end) {
+      // The range of the current allocation buffer can still grow.
+      if (scan_index_ == lab_range_index_) break;
+      scan_index_++;
+      continue;
+    }
+    if (NewSpacePage::IsAtEnd(current)) {
+      ranges_[scan_index_].scan =
+          NewSpacePage::FromLimit(current)->next_page()->body();
+      continue;
+    }
+    HeapObject* object = HeapObject::FromAddress(current);
+    Map* map = object->map();
+    int size = object->SizeFromMap(map);
+    // Scanning may add ranges, so advance before visiting the body.
+    ranges_[scan_index_].scan = current + size;
+    object->IterateBody(map->instance_type(), size, &visitor);
+    scanned = true;
+  }
+  return scanned;
+}
+
+
+void ScavengeWorker::ScanPromotedObject(HeapObject* target, int size) {
+  // Like Heap::IterateAndMarkPointersToFromSpace, but the slots that still
+  // point into new space are collected instead of being entered into the
+  // store buffer, which is not thread safe.
+  Address end = target->address() + size;
+  for (Address slot_address = target->address();
+       slot_address < end;
+       slot_address += kPointerSize) {
+    Object** slot = reinterpret_cast<Object**>(slot_address);
+    Object* object = *slot;
+    if (object->IsHeapObject() && heap_->InFromSpace(object)) {
+      ScavengeSlot(reinterpret_cast<HeapObject**>(slot),
+                   HeapObject::cast(object));
+      if (heap_->InNewSpace(*slot)) old_to_new_slots_.Add(slot_address);
+    }
+  }
+}
+
+
+void ScavengeWorker::ProcessWork() {
+  bool progress;
+  do {
+    progress = ScanToSpace();
+    while (!promoted_.is_empty()) {
+      PromotedEntry entry = promoted_.RemoveLast();
+      ScanPromotedObject(entry.target, entry.size);
+      progress = true;
+    }
+  } while (progress);
+}
+
+
+void ScavengeWorker::Finish() {
+  ASSERT(promoted_.is_empty());
+  RetireNewSpaceLab();
+  RetireOldSpaceLab(heap_->old_pointer_space(), &old_pointer_lab_);
+  RetireOldSpaceLab(heap_->old_data_space(), &old_data_lab_);
+  StoreBuffer* store_buffer = heap_->store_buffer();
+  for (int i = 0; i < old_to_new_slots_.length(); i++) {
+    store_buffer->EnterDirectlyIntoStoreBuffer(old_to_new_slots_[i]);
+  }
+  heap_->tracer()->increment_promoted_objects_size(promoted_size_);
+}
+
+
+class ScavengerThread : public Thread {
+ public:
+  explicit ScavengerThread(Isolate* isolate)
+      : Thread("v8:Scavenger"),
+        isolate_(isolate),
+        start_semaphore_(OS::CreateSemaphore(0)),
+        done_semaphore_(OS::CreateSemaphore(0)),
+        worker_(NULL),
+        stop_(false) { }
+
+  ~ScavengerThread() {
+    delete start_semaphore_;
+    delete done_semaphore_;
+  }
+
+  void Run() {
+    Isolate::SetIsolateThreadLocals(isolate_, NULL);
+    while (true) {
+      start_semaphore_->Wait();
+      if (stop_) return;
+      worker_->ProcessWork();
+      done_semaphore_->Signal();
+    }
+  }
+
+  void StartWork(ScavengeWorker* worker) {
+    worker_ = worker;
+    start_semaphore_->Signal();
+  }
+
+  void WaitForWork() {
+    done_semaphore_->Wait();
+    worker_ = NULL;
+  }
+
+  void Stop() {
+    stop_ = true;
+    start_semaphore_->Signal();
+    Join();
+  }
+
+ private:
+  Isolate* isolate_;
+  Semaphore* start_semaphore_;
+  Semaphore* done_semaphore_;
+  ScavengeWorker* worker_;
+  bool stop_;
+};
+
+
+bool Heap::CanUseParallelScavenge() {
+  if (!FLAG_parallel_scavenge || FLAG_scavenger_threads <= 0) return false;
+  if (incremental_marking()->IsMarking()) return false;
+  return !(isolate()->logger()->is_logging() ||
+           CpuProfiler::is_profiling(isolate()) ||
+           (isolate()->heap_profiler() != NULL &&
+            isolate()->heap_profiler()->is_profiling()));
+}
+
+
+Address Heap::ParallelScavenge(Address new_space_front) {
+  if (scavenger_threads_ == NULL) {
+    scavenge_allocation_mutex_ = OS::CreateMutex();
+    scavenger_threads_count_ = FLAG_scavenger_threads;
+    scavenger_threads_ = new ScavengerThread*[scavenger_threads_count_];
+    for (int i = 0; i < scavenger_threads_count_; i++) {
+      scavenger_threads_[i] = new ScavengerThread(isolate_);
+      scavenger_threads_[i]->Start();
+    }
+  }
+
+  // The current thread takes part in the scavenge as the last worker.
+  int workers_count = scavenger_threads_count_ + 1;
+  ScopedVector<ScavengeWorker*> workers(workers_count);
+  for (int i = 0; i < workers_count; i++) {
+    workers[i] = new ScavengeWorker(this);
+  }
+
+  // Split the unscanned to-space objects into ranges of about equal size.
+  Address top = new_space_.top();
+  intptr_t chunk_size = Max(static_cast<intptr_t>(kPointerSize),
+                            (top - new_space_front) / workers_count);
+  Address chunk_start = new_space_front;
+  Address current = new_space_front;
+  int next_worker = 0;
+  while (current != top) {
+    if (NewSpacePage::IsAtEnd(current)) {
+      current = NewSpacePage::FromLimit(current)->next_page()->body();
+      continue;
+    }
+    current += HeapObject::FromAddress(current)->Size();
+    if (current - chunk_start >= chunk_size || current == top) {
+      workers[next_worker]->AddToSpaceWork(chunk_start, current);
+      next_worker = (next_worker + 1) % workers_count;
+      chunk_start = current;
+    }
+  }
+
+  // Hand out the promoted objects that have not been scanned yet.
+  while (!promotion_queue_.is_empty()) {
+    HeapObject* target;
+    int size;
+    promotion_queue_.remove(&target, &size);
+    workers[next_worker]->AddPromotedWork(target, size);
+    next_worker = (next_worker + 1) % workers_count;
+  }
+
+  for (int i = 0; i < scavenger_threads_count_; i++) {
+    scavenger_threads_[i]->StartWork(workers[i]);
+  }
+  workers[scavenger_threads_count_]->ProcessWork();
+  for (int i = 0; i < scavenger_threads_count_; i++) {
+    scavenger_threads_[i]->WaitForWork();
+  }
+
+  {
+    StoreBufferRebuildScope scope(this,
+                                  store_buffer(),
+                                  &ScavengeStoreBufferCallback);
+    for (int i = 0; i < workers_count; i++) {
+      workers[i]->Finish();
+      delete workers[i];
+    }
+  }
+
+  return new_space_.top();
+}
+
+
+void Heap::TearDownScavengerThreads() {
+  if (scavenger_threads_ == NULL) return;
+  for (int i = 0; i < scavenger_threads_count_; i++) {
+    scavenger_threads_[i]->Stop();
+    delete scavenger_threads_[i];
+  }
+  delete[] scavenger_threads_;
+  scavenger_threads_ = NULL;
+  scavenger_threads_count_ = 0;
+  delete scavenge_allocation_mutex_;
+  scavenge_allocation_mutex_ = NULL;
+}
+
+
 enum LoggingAndProfiling {
   LOGGING_AND_PROFILING_ENABLED,
   LOGGING_AND_PROFILING_DISABLED
@@ -1968,6 +2671,11 @@ bool Heap::CreateInitialMaps() {
   }
   set_heap_number_map(Map::cast(obj));
 
+  { MaybeObject* maybe_obj = AllocateMap(HEAP_NUMBER_TYPE, HeapNumber::kSize);
+    if (!maybe_obj->ToObject(&obj)) return false;
+  }
+  set_mutable_heap_number_map(Map::cast(obj));
+
   { MaybeObject* maybe_obj = AllocateMap(FOREIGN_TYPE, Foreign::kSize);
     if (!maybe_obj->ToObject(&obj)) return false;
   }
@@ -2006,6 +2714,12 @@ bool Heap::CreateInitialMaps() {
   }
   set_byte_array_map(Map::cast(obj));
 
+  { MaybeObject* maybe_obj =
+        AllocateMap(BIG_INTEGER_TYPE, kVariableSizeSentinel);
+    if (!maybe_obj->ToObject(&obj)) return false;
+  }
+  set_big_integer_map(Map::cast(obj));
+
   { MaybeObject* maybe_obj =
         AllocateMap(FREE_SPACE_TYPE, kVariableSizeSentinel);
     if (!maybe_obj->ToObject(&obj)) return false;
@@ -2197,6 +2911,17 @@ MaybeObject* Heap::AllocateHeapNumber(double value) {
 }
 
 
+MaybeObject* Heap::AllocateMutableHeapNumber(double value,
+                                             PretenureFlag pretenure) {
+  Object* result;
+  { MaybeObject* maybe_result = AllocateHeapNumber(value, pretenure);
+    if (!maybe_result->ToObject(&result)) return maybe_result;
+  }
+  HeapObject::cast(result)->set_map_unsafe(mutable_heap_number_map());
+  return result;
+}
+
+
 MaybeObject* Heap::AllocateJSGlobalPropertyCell(Object* value) {
   Object* result;
   { MaybeObject* maybe_result = AllocateRawCell();
@@ -2204,6 +2929,8 @@ MaybeObject* Heap::AllocateJSGlobalPropertyCell(Object* value) {
   }
   HeapObject::cast(result)->set_map_unsafe(global_property_cell_map());
   JSGlobalPropertyCell::cast(result)->set_value(value);
+  JSGlobalPropertyCell::cast(result)->set_state(
+      JSGlobalPropertyCell::UNOBSERVED);
   return result;
 }
 
@@ -2428,9 +3155,10 @@ bool Heap::CreateInitialObjects() {
   }
   set_polymorphic_code_cache(PolymorphicCodeCache::cast(obj));
 
-  set_instanceof_cache_function(Smi::FromInt(0));
-  set_instanceof_cache_map(Smi::FromInt(0));
-  set_instanceof_cache_answer(Smi::FromInt(0));
+  { MaybeObject* maybe_obj = ObjectHashTable::Allocate(16);
+    if (!maybe_obj->ToObject(&obj)) return false;
+  }
+  set_atom_table(ObjectHashTable::cast(obj));
 
   CreateFixedStubs();
 
@@ -2460,6 +3188,13 @@ bool Heap::CreateInitialObjects() {
   }
   set_string_split_cache(FixedArray::cast(obj));
 
+  // Allocate cache for descriptor arrays shared between maps.
+  { MaybeObject* maybe_obj = AllocateFixedArray(
+        FieldDescriptorsCache::kFieldDescriptorsCacheSize, TENURED);
+    if (!maybe_obj->ToObject(&obj)) return false;
+  }
+  set_field_descriptors_cache(FixedArray::cast(obj));
+
   // Allocate cache for external strings pointing to native source code.
   { MaybeObject* maybe_obj = AllocateFixedArray(Natives::GetBuiltinsCount());
     if (!maybe_obj->ToObject(&obj)) return false;
@@ -2478,6 +3213,9 @@ bool Heap::CreateInitialObjects() {
   // Initialize descriptor cache.
   isolate_->descriptor_lookup_cache()->Clear();
 
+  // Initialize code stub cache.
+  isolate_->code_stub_lookup_cache()->Clear();
+
   // Initialize compilation cache.
   isolate_->compilation_cache()->Clear();
 
@@ -2485,56 +3223,75 @@ bool Heap::CreateInitialObjects() {
 }
 
 
-Object* StringSplitCache::Lookup(
-    FixedArray* cache, String* string, String* pattern) {
-  if (!string->IsSymbol() || !pattern->IsSymbol()) return Smi::FromInt(0);
+static bool IsSplitPattern(Object* pattern) {
+  return pattern->IsSymbol() || pattern->IsFixedArray();
+}
+
+
+Object* StringSplitCache::Lookup(FixedArray* cache,
+                                 String* string,
+                                 Object* pattern,
+                                 Object** last_match) {
+  if (!string->IsSymbol() || !IsSplitPattern(pattern)) {
+    return Smi::FromInt(0);
+  }
   uint32_t hash = string->Hash();
   uint32_t index = ((hash & (kStringSplitCacheSize - 1)) &
       ~(kArrayEntriesPerCacheEntry - 1));
-  if (cache->get(index + kStringOffset) == string &&
-      cache->get(index + kPatternOffset) == pattern) {
-    return cache->get(index + kArrayOffset);
-  }
-  index = ((index + kArrayEntriesPerCacheEntry) & (kStringSplitCacheSize - 1));
-  if (cache->get(index + kStringOffset) == string &&
-      cache->get(index + kPatternOffset) == pattern) {
-    return cache->get(index + kArrayOffset);
+  if (cache->get(index + kStringOffset) != string ||
+      cache->get(index + kPatternOffset) != pattern) {
+    index =
+        ((index + kArrayEntriesPerCacheEntry) & (kStringSplitCacheSize - 1));
+    if (cache->get(index + kStringOffset) != string ||
+        cache->get(index + kPatternOffset) != pattern) {
+      return Smi::FromInt(0);
+    }
   }
-  return Smi::FromInt(0);
+  if (last_match != NULL) *last_match = cache->get(index + kLastMatchOffset);
+  return cache->get(index + kArrayOffset);
+}
+
+
+void StringSplitCache::Set(FixedArray* cache,
+                           int index,
+                           Object* string,
+                           Object* pattern,
+                           Object* array,
+                           Object* last_match) {
+  cache->set(index + kStringOffset, string);
+  cache->set(index + kPatternOffset, pattern);
+  cache->set(index + kArrayOffset, array);
+  cache->set(index + kLastMatchOffset, last_match);
 }
 
 
 void StringSplitCache::Enter(Heap* heap,
                              FixedArray* cache,
                              String* string,
-                             String* pattern,
-                             FixedArray* array) {
-  if (!string->IsSymbol() || !pattern->IsSymbol()) return;
+                             Object* pattern,
+                             FixedArray* array,
+                             Object* last_match) {
+  if (!string->IsSymbol() || !IsSplitPattern(pattern)) return;
   uint32_t hash = string->Hash();
   uint32_t index = ((hash & (kStringSplitCacheSize - 1)) &
       ~(kArrayEntriesPerCacheEntry - 1));
-  if (cache->get(index + kStringOffset) == Smi::FromInt(0)) {
-    cache->set(index + kStringOffset, string);
-    cache->set(index + kPatternOffset, pattern);
-    cache->set(index + kArrayOffset, array);
+  Smi* empty = Smi::FromInt(0);
+  if (cache->get(index + kStringOffset) == empty) {
+    Set(cache, index, string, pattern, array, last_match);
   } else {
     uint32_t index2 =
         ((index + kArrayEntriesPerCacheEntry) & (kStringSplitCacheSize - 1));
-    if (cache->get(index2 + kStringOffset) == Smi::FromInt(0)) {
-      cache->set(index2 + kStringOffset, string);
-      cache->set(index2 + kPatternOffset, pattern);
-      cache->set(index2 + kArrayOffset, array);
+    if (cache->get(index2 + kStringOffset) == empty) {
+      Set(cache, index2, string, pattern, array, last_match);
     } else {
-      cache->set(index2 + kStringOffset, Smi::FromInt(0));
-      cache->set(index2 + kPatternOffset, Smi::FromInt(0));
-      cache->set(index2 + kArrayOffset, Smi::FromInt(0));
-      cache->set(index + kStringOffset, string);
-      cache->set(index + kPatternOffset, pattern);
-      cache->set(index + kArrayOffset, array);
+      Set(cache, index2, empty, empty, empty, empty);
+      Set(cache, index, string, pattern, array, last_match);
     }
   }
   if (array->length() < 100) {  // Limit how many new symbols we want to make.
     for (int i = 0; i < array->length(); i++) {
+      // Regexp splits have undefined for captures that did not participate.
+      if (!array->get(i)->IsString()) continue;
       String* str = String::cast(array->get(i));
       Object* symbol;
       MaybeObject* maybe_symbol = heap->LookupSymbol(str);
@@ -2554,20 +3311,110 @@ void StringSplitCache::Clear(FixedArray* cache) {
 }
 
 
+DescriptorArray* FieldDescriptorsCache::Share(FixedArray* cache,
+                                              DescriptorArray* descriptors) {
+  if (!IsShareable(descriptors)) return descriptors;
+  uint32_t index = Hash(descriptors) & (kFieldDescriptorsCacheSize - 1);
+  Object* cached = cache->get(index);
+  if (cached->IsDescriptorArray() &&
+      Equals(DescriptorArray::cast(cached), descriptors)) {
+    Isolate* isolate = descriptors->GetIsolate();
+    isolate->counters()->shared_field_descriptors()->Increment();
+    return DescriptorArray::cast(cached);
+  }
+  cache->set(index, descriptors);
+  return descriptors;
+}
+
+
+void FieldDescriptorsCache::Clear(FixedArray* cache) {
+  for (int i = 0; i < kFieldDescriptorsCacheSize; i++) {
+    cache->set_undefined(i);
+  }
+}
+
+
+bool FieldDescriptorsCache::IsShareable(DescriptorArray* descriptors) {
+  // Transitions are added to a fresh copy of a descriptor array, so an array
+  // without them is never written to again except for its enum cache, which
+  // only holds the keys, and for double fields becoming mixed fields, which
+  // is valid for every map.  bit_field3 is only non-zero for shared maps,
+  // which have no descriptors.
+  if (descriptors->IsEmpty() || descriptors->bit_field3_storage() != 0) {
+    return false;
+  }
+  for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+    if (descriptors->GetType(i) != FIELD) return false;
+  }
+  return true;
+}
+
+
+uint32_t FieldDescriptorsCache::Hash(DescriptorArray* descriptors) {
+  uint32_t hash = descriptors->number_of_descriptors();
+  for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+    hash = hash * 31 + descriptors->GetKey(i)->Hash();
+    hash = hash * 31 + descriptors->GetDetails(i)->value();
+    hash = hash * 31 + descriptors->GetFieldIndex(i);
+  }
+  return hash;
+}
+
+
+bool FieldDescriptorsCache::Equals(DescriptorArray* a, DescriptorArray* b) {
+  if (a->number_of_descriptors() != b->number_of_descriptors() ||
+      a->NextEnumerationIndex() != b->NextEnumerationIndex()) {
+    return false;
+  }
+  for (int i = 0; i < a->number_of_descriptors(); i++) {
+    if (a->GetKey(i) != b->GetKey(i) ||
+        a->GetDetails(i) != b->GetDetails(i) ||
+        a->GetValue(i) != b->GetValue(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
 MaybeObject* Heap::InitializeNumberStringCache() {
-  // Compute the size of the number string cache based on the max heap size.
-  // max_semispace_size_ == 512 KB => number_string_cache_size = 32.
-  // max_semispace_size_ ==   8 MB => number_string_cache_size = 16KB.
-  int number_string_cache_size = max_semispace_size_ / 512;
-  number_string_cache_size = Max(32, Min(16*KB, number_string_cache_size));
+  // Start out with a small cache, which keeps the snapshot and the memory
+  // of isolates that convert few numbers small. It grows to full size on
+  // the first collision, see SetNumberStringCache.
   Object* obj;
   MaybeObject* maybe_obj =
-      AllocateFixedArray(number_string_cache_size * 2, TENURED);
+      AllocateFixedArray(kInitialNumberStringCacheSize * 2, TENURED);
   if (maybe_obj->ToObject(&obj)) set_number_string_cache(FixedArray::cast(obj));
   return maybe_obj;
 }
 
 
+int Heap::FullSizeNumberStringCacheLength() {
+  // Compute the size of the number string cache based on the max heap size.
+  // max_semispace_size_ == 512 KB => number_string_cache_size = 512.
+  // max_semispace_size_ ==   8 MB => number_string_cache_size = 32KB.
+  // max_semispace_size_ >=  16 MB => number_string_cache_size = 64KB.
+  int number_string_cache_size = max_semispace_size_ / 256;
+  number_string_cache_size = Max(kInitialNumberStringCacheSize * 2,
+                                 Min(64 * KB, number_string_cache_size));
+  // There is a number and a string per entry.
+  return number_string_cache_size * 2;
+}
+
+
+void Heap::AllocateFullSizeNumberStringCache() {
+  // Keep the cache in the snapshot small.
+  if (Serializer::enabled()) return;
+  Object* obj;
+  MaybeObject* maybe_obj =
+      AllocateFixedArray(FullSizeNumberStringCacheLength(), TENURED);
+  // The entries of the old cache are not copied over, the new cache fills
+  // up again soon enough. If the allocation fails the old cache is kept,
+  // as it is only a cache.
+  if (maybe_obj->ToObject(&obj)) set_number_string_cache(FixedArray::cast(obj));
+}
+
+
 void Heap::FlushNumberStringCache() {
   // Flush the number to string cache.
   int len = number_string_cache()->length();
@@ -2613,11 +3460,17 @@ void Heap::SetNumberStringCache(Object* number, String* string) {
   int mask = (number_string_cache()->length() >> 1) - 1;
   if (number->IsSmi()) {
     hash = smi_get_hash(Smi::cast(number)) & mask;
-    number_string_cache()->set(hash * 2, Smi::cast(number));
   } else {
     hash = double_get_hash(number->Number()) & mask;
-    number_string_cache()->set(hash * 2, number);
   }
+  if (number_string_cache()->get(hash * 2) != undefined_value() &&
+      number_string_cache()->length() < FullSizeNumberStringCacheLength()) {
+    // The first collision shows that the isolate converts enough numbers
+    // to make the full size cache worth its memory.
+    AllocateFullSizeNumberStringCache();
+    return;
+  }
+  number_string_cache()->set(hash * 2, number);
   number_string_cache()->set(hash * 2 + 1, string);
 }
 
@@ -2747,6 +3600,8 @@ MaybeObject* Heap::AllocateSharedFunctionInfo(Object* name) {
   share->set_inferred_name(empty_string(), SKIP_WRITE_BARRIER);
   share->set_initial_map(undefined_value(), SKIP_WRITE_BARRIER);
   share->set_this_property_assignments(undefined_value(), SKIP_WRITE_BARRIER);
+  share->set_deopt_history(undefined_value(), SKIP_WRITE_BARRIER);
+  share->set_bailout_reasons(undefined_value(), SKIP_WRITE_BARRIER);
   share->set_deopt_counter(Smi::FromInt(FLAG_deopt_every_n_times));
 
   // Set integer fields (smi or int, depending on the architecture).
@@ -2846,6 +3701,7 @@ MaybeObject* Heap::AllocateConsString(String* first, String* second) {
   }
 
   int length = first_length + second_length;
+  int depth = Max(ConsString::DepthOf(first), ConsString::DepthOf(second)) + 1;
 
   // Optimization for 2-byte strings often used as keys in a decompression
   // dictionary.  Check whether we already have the string in the symbol
@@ -2949,6 +3805,7 @@ MaybeObject* Heap::AllocateConsString(String* first, String* second) {
   cons_string->set_hash_field(String::kEmptyHashField);
   cons_string->set_first(first, mode);
   cons_string->set_second(second, mode);
+  cons_string->set_depth(depth);
   return result;
 }
 
@@ -3163,6 +4020,28 @@ MaybeObject* Heap::AllocateByteArray(int length) {
 }
 
 
+MaybeObject* Heap::AllocateBigInteger(int digit_count,
+                                      PretenureFlag pretenure) {
+  if (digit_count < 0 || digit_count > BigInteger::kMaxDigits) {
+    return Failure::OutOfMemoryException();
+  }
+  int size = BigInteger::SizeFor(digit_count);
+  AllocationSpace space =
+      (pretenure == TENURED) ? OLD_DATA_SPACE : NEW_SPACE;
+  if (size > MaxObjectSizeInPagedSpace()) space = LO_SPACE;
+  Object* result;
+  { MaybeObject* maybe_result = AllocateRaw(size, space, OLD_DATA_SPACE);
+    if (!maybe_result->ToObject(&result)) return maybe_result;
+  }
+
+  BigInteger* integer = reinterpret_cast<BigInteger*>(result);
+  integer->set_map_unsafe(big_integer_map());
+  integer->set_length(BigInteger::LengthFor(digit_count));
+  integer->set_is_negative(false);
+  return result;
+}
+
+
 void Heap::CreateFillerObjectAt(Address addr, int size) {
   if (size == 0) return;
   HeapObject* filler = HeapObject::FromAddress(addr);
@@ -3236,6 +4115,9 @@ MaybeObject* Heap::CreateCode(const CodeDesc& desc,
   if (code->is_call_stub() || code->is_keyed_call_stub()) {
     code->set_check_type(RECEIVER_MAP_CHECK);
   }
+  if (code->kind() == Code::OPTIMIZED_FUNCTION) {
+    code->set_last_used_gc(ms_count_);
+  }
   code->set_deoptimization_data(empty_fixed_array(), SKIP_WRITE_BARRIER);
   code->set_handler_table(empty_fixed_array(), SKIP_WRITE_BARRIER);
   code->set_next_code_flushing_candidate(undefined_value());
@@ -3546,10 +4428,11 @@ MaybeObject* Heap::AllocateInitialMap(JSFunction* fun) {
         String* name = fun->shared()->GetThisPropertyAssignmentName(i);
         ASSERT(name->IsSymbol());
         FieldDescriptor field(name, i, NONE);
-        field.SetEnumerationIndex(i);
+        field.SetEnumerationIndex(PropertyDetails::kInitialIndex + i);
         descriptors->Set(i, &field, witness);
       }
-      descriptors->SetNextEnumerationIndex(count);
+      descriptors->SetNextEnumerationIndex(PropertyDetails::kInitialIndex +
+                                           count);
       descriptors->SortUnchecked(witness);
 
       // The descriptors may contain duplicates because the compiler does not
@@ -3559,6 +4442,11 @@ MaybeObject* Heap::AllocateInitialMap(JSFunction* fun) {
       if (HasDuplicates(descriptors)) {
         fun->shared()->ForbidInlineConstructor();
       } else {
+        if (FLAG_share_field_descriptors &&
+            !isolate_->bootstrapper()->IsActive()) {
+          descriptors = FieldDescriptorsCache::Share(field_descriptors_cache(),
+                                                     descriptors);
+        }
         map->set_instance_descriptors(descriptors);
         map->set_pre_allocated_property_fields(count);
         map->set_unused_property_fields(in_object_properties - count);
@@ -3786,7 +4674,7 @@ MaybeObject* Heap::AllocateGlobalObject(JSFunction* constructor) {
 }
 
 
-MaybeObject* Heap::CopyJSObject(JSObject* source) {
+MaybeObject* Heap::CopyJSObject(JSObject* source, PretenureFlag pretenure) {
   // Never used to copy functions.  If functions need to be copied we
   // have to be careful to clear the literals array.
   SLOW_ASSERT(!source->IsJSFunction());
@@ -3800,9 +4688,11 @@ MaybeObject* Heap::CopyJSObject(JSObject* source) {
 
   // If we're forced to always allocate, we use the general allocation
   // functions which may leave us with an object in old space.
-  if (always_allocate()) {
+  if (always_allocate() || pretenure == TENURED) {
+    AllocationSpace space =
+        (pretenure == TENURED) ? OLD_POINTER_SPACE : NEW_SPACE;
     { MaybeObject* maybe_clone =
-          AllocateRaw(object_size, NEW_SPACE, OLD_POINTER_SPACE);
+          AllocateRaw(object_size, space, OLD_POINTER_SPACE);
       if (!maybe_clone->ToObject(&clone)) return maybe_clone;
     }
     Address clone_address = HeapObject::cast(clone)->address();
@@ -3837,9 +4727,10 @@ MaybeObject* Heap::CopyJSObject(JSObject* source) {
       if (elements->map() == fixed_cow_array_map()) {
         maybe_elem = FixedArray::cast(elements);
       } else if (source->HasFastDoubleElements()) {
-        maybe_elem = CopyFixedDoubleArray(FixedDoubleArray::cast(elements));
+        maybe_elem = CopyFixedDoubleArray(FixedDoubleArray::cast(elements),
+                                          pretenure);
       } else {
-        maybe_elem = CopyFixedArray(FixedArray::cast(elements));
+        maybe_elem = CopyFixedArray(FixedArray::cast(elements), pretenure);
       }
       if (!maybe_elem->ToObject(&elem)) return maybe_elem;
     }
@@ -3848,11 +4739,32 @@ MaybeObject* Heap::CopyJSObject(JSObject* source) {
   // Update properties if necessary.
   if (properties->length() > 0) {
     Object* prop;
-    { MaybeObject* maybe_prop = CopyFixedArray(properties);
+    { MaybeObject* maybe_prop = CopyFixedArray(properties, pretenure);
       if (!maybe_prop->ToObject(&prop)) return maybe_prop;
     }
     JSObject::cast(clone)->set_properties(FixedArray::cast(prop), wb_mode);
   }
+  // The mutable heap numbers in double fields belong to the source.
+  if (FLAG_unbox_double_fields && source->HasFastProperties()) {
+    DescriptorArray* descriptors = map->instance_descriptors();
+    for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+      PropertyDetails details(descriptors->GetDetails(i));
+      if (details.type() != FIELD ||
+          details.representation() == TAGGED_FIELD) {
+        continue;
+      }
+      int index = descriptors->GetFieldIndex(i);
+      Object* value = source->FastPropertyAt(index);
+      if (!value->IsMutableHeapNumber()) continue;
+      Object* box;
+      { MaybeObject* maybe_box =
+            AllocateMutableHeapNumber(HeapNumber::cast(value)->value(),
+                                      pretenure);
+        if (!maybe_box->ToObject(&box)) return maybe_box;
+      }
+      JSObject::cast(clone)->FastPropertyAtPut(index, box);
+    }
+  }
   // Return the new clone.
   return clone;
 }
@@ -3894,6 +4806,7 @@ MaybeObject* Heap::ReinitializeJSReceiver(
   // we must NOT fail after this point, where we have changed the type!
 
   // Reset the map for the object.
+  EnsureSweptBeforeResizing(object);
   object->set_map(map);
   JSObject* jsobj = JSObject::cast(object);
 
@@ -3965,15 +4878,19 @@ MaybeObject* Heap::AllocateStringFromAscii(Vector<const char> string,
 
 
 MaybeObject* Heap::AllocateStringFromUtf8Slow(Vector<const char> string,
+                                              int non_ascii_start,
                                               PretenureFlag pretenure) {
   // V8 only supports characters in the Basic Multilingual Plane.
   const uc32 kMaxSupportedChar = 0xFFFF;
-  // Count the number of characters in the UTF-8 string and check if
-  // it is an ASCII string.
+  // The first non_ascii_start characters are ASCII and need no decoding.
+  // Count the number of characters in the rest of the UTF-8 string.
+  ASSERT(non_ascii_start < string.length());
+  const char* rest = string.start() + non_ascii_start;
+  int rest_length = string.length() - non_ascii_start;
   Access<UnicodeCache::Utf8Decoder>
       decoder(isolate_->unicode_cache()->utf8_decoder());
-  decoder->Reset(string.start(), string.length());
-  int chars = 0;
+  decoder->Reset(rest, rest_length);
+  int chars = non_ascii_start;
   while (decoder->has_more()) {
     decoder->GetNext();
     chars++;
@@ -3984,13 +4901,15 @@ MaybeObject* Heap::AllocateStringFromUtf8Slow(Vector<const char> string,
     if (!maybe_result->ToObject(&result)) return maybe_result;
   }
 
-  // Convert and copy the characters into the new object.
-  String* string_result = String::cast(result);
-  decoder->Reset(string.start(), string.length());
-  for (int i = 0; i < chars; i++) {
+  // Copy the ASCII prefix and convert the rest of the characters directly
+  // into the new object.
+  uc16* dest = SeqTwoByteString::cast(result)->GetChars();
+  CopyChars(dest, string.start(), non_ascii_start);
+  decoder->Reset(rest, rest_length);
+  for (int i = non_ascii_start; i < chars; i++) {
     uc32 r = decoder->GetNext();
     if (r > kMaxSupportedChar) { r = unibrow::Utf8::kBadChar; }
-    string_result->Set(i, r);
+    dest[i] = static_cast<uc16>(r);
   }
   return result;
 }
@@ -4200,10 +5119,12 @@ MaybeObject* Heap::AllocateRawFixedArray(int length) {
 }
 
 
-MaybeObject* Heap::CopyFixedArrayWithMap(FixedArray* src, Map* map) {
+MaybeObject* Heap::CopyFixedArrayWithMap(FixedArray* src,
+                                         Map* map,
+                                         PretenureFlag pretenure) {
   int len = src->length();
   Object* obj;
-  { MaybeObject* maybe_obj = AllocateRawFixedArray(len);
+  { MaybeObject* maybe_obj = AllocateRawFixedArray(len, pretenure);
     if (!maybe_obj->ToObject(&obj)) return maybe_obj;
   }
   if (InNewSpace(obj)) {
@@ -4227,10 +5148,11 @@ MaybeObject* Heap::CopyFixedArrayWithMap(FixedArray* src, Map* map) {
 
 
 MaybeObject* Heap::CopyFixedDoubleArrayWithMap(FixedDoubleArray* src,
-                                               Map* map) {
+                                               Map* map,
+                                               PretenureFlag pretenure) {
   int len = src->length();
   Object* obj;
-  { MaybeObject* maybe_obj = AllocateRawFixedDoubleArray(len, NOT_TENURED);
+  { MaybeObject* maybe_obj = AllocateRawFixedDoubleArray(len, pretenure);
     if (!maybe_obj->ToObject(&obj)) return maybe_obj;
   }
   HeapObject* dst = HeapObject::cast(obj);
@@ -4540,6 +5462,27 @@ void Heap::EnsureHeapIsIterable() {
 }
 
 
+void Heap::set_allocation_sampler(AllocationSampler* sampler) {
+  allocation_sampler_ = sampler;
+  new_space_.SetAllocationSamplingStep(
+      sampler == NULL ? 0 : sampler->bytes_until_sample());
+}
+
+
+void Heap::SampleAllocation(MaybeObject* result,
+                            int size_in_bytes,
+                            intptr_t bytes_allocated) {
+  if (allocation_sampler_ == NULL || gc_state_ != NOT_IN_GC) return;
+  Object* object;
+  if (!result->ToObject(&object)) return;
+  if (allocation_sampler_->AllocationEvent(
+          HeapObject::cast(object), size_in_bytes, bytes_allocated)) {
+    new_space_.SetAllocationSamplingStep(
+        allocation_sampler_->bytes_until_sample());
+  }
+}
+
+
 bool Heap::IdleNotification(int hint) {
   if (!FLAG_incremental_marking || FLAG_expose_gc || Serializer::enabled()) {
     return hint < 1000 ? true : IdleGlobalGC();
@@ -4602,9 +5545,13 @@ bool Heap::IdleNotification(int hint) {
       isolate_->compilation_cache()->Clear();
       uncommit = true;
     }
-    CollectAllGarbage(kNoGCFlags);
+    if (uncommit && FLAG_memory_reducer) {
+      ReduceMemoryFootprint();
+    } else {
+      CollectAllGarbage(kNoGCFlags);
+    }
     gc_count_at_last_idle_gc_ = gc_count_;
-    if (uncommit) {
+    if (uncommit && !FLAG_memory_reducer) {
       new_space_.Shrink();
       UncommitFromSpace();
     }
@@ -4613,6 +5560,92 @@ bool Heap::IdleNotification(int hint) {
 }
 
 
+// Folds the speed of the last piece of idle work into the estimate.
+static double UpdatedIdleSpeed(double speed, intptr_t bytes, double ms) {
+  if (ms <= 0 || bytes <= 0) return speed;
+  return (speed + bytes / ms) / 2;
+}
+
+
+int Heap::IdleNotificationWithDeadline(int idle_time_in_us) {
+  if (idle_time_in_us <= 0 || Serializer::enabled()) return 0;
+
+  double start = OS::TimeCurrentMillis();
+  double budget_ms = idle_time_in_us / 1000.0;
+
+  int new_mark_sweeps = ms_count_ - ms_count_at_last_idle_notification_;
+  mark_sweeps_since_idle_round_started_ += new_mark_sweeps;
+  ms_count_at_last_idle_notification_ = ms_count_;
+
+  // Do at most one piece of work, the first one of the following that is
+  // pending and is expected to fit in the budget: finishing incremental
+  // marking with a full GC, a marking step, lazy sweeping, a scavenge,
+  // starting a new incremental GC and finally flushing caches once the
+  // mutator looks inactive.
+  if (incremental_marking()->IsComplete()) {
+    intptr_t size = PromotedSpaceSize();
+    if (size / idle_mark_compact_speed_ <= budget_ms) {
+      CollectAllGarbage(kNoGCFlags);
+      gc_count_at_last_idle_gc_ = gc_count_;
+      idle_mark_compact_speed_ = UpdatedIdleSpeed(
+          idle_mark_compact_speed_, size, OS::TimeCurrentMillis() - start);
+    }
+  } else if (!incremental_marking()->IsStopped()) {
+    intptr_t step_size = Max(
+        static_cast<intptr_t>(incremental_marking()->marking_speed() *
+                              budget_ms),
+        static_cast<intptr_t>(IncrementalMarking::kAllocatedThreshold));
+    // This flag prevents incremental marking from requesting GC via stack
+    // guard, the next idle notification will finish the GC instead.
+    idle_notification_will_schedule_next_gc_ = true;
+    incremental_marking()->IdleStep(step_size);
+    idle_notification_will_schedule_next_gc_ = false;
+    if (incremental_marking()->IsComplete()) {
+      double remaining_ms = budget_ms - (OS::TimeCurrentMillis() - start);
+      if (PromotedSpaceSize() / idle_mark_compact_speed_ > remaining_ms) {
+        // Too big for any deadline we have seen; let the mutator do it.
+        isolate_->stack_guard()->RequestGC();
+      }
+    }
+  } else if (!IsSweepingComplete()) {
+    intptr_t step_size = Max(
+        static_cast<intptr_t>(idle_sweeping_speed_ * budget_ms),
+        static_cast<intptr_t>(IncrementalMarking::kAllocatedThreshold));
+    if (!AdvanceSweepers(static_cast<int>(step_size))) {
+      // Only a step that used all of its budget says much about the speed.
+      idle_sweeping_speed_ = UpdatedIdleSpeed(
+          idle_sweeping_speed_, step_size, OS::TimeCurrentMillis() - start);
+    }
+  } else if (new_space_.Size() > new_space_.Capacity() / 2 &&
+             new_space_.Size() / idle_scavenge_speed_ <= budget_ms) {
+    intptr_t size = new_space_.Size();
+    CollectGarbage(NEW_SPACE);
+    idle_scavenge_speed_ = UpdatedIdleSpeed(
+        idle_scavenge_speed_, size, OS::TimeCurrentMillis() - start);
+  } else if (FLAG_incremental_marking &&
+             mark_sweeps_since_idle_round_started_ <
+                 kMaxMarkSweepsInIdleRound &&
+             WorthStartingGCWhenIdle()) {
+    incremental_marking()->Start();
+  } else if (mark_sweeps_since_idle_round_started_ >=
+                 kMaxMarkSweepsInIdleRound &&
+             EnoughGarbageSinceLastIdleRound()) {
+    StartIdleRound();
+  } else if (gc_count_at_last_idle_gc_ == gc_count_) {
+    // No GC since the last idle GC, the mutator is probably not active.
+    isolate_->compilation_cache()->Clear();
+    if (FLAG_memory_reducer) {
+      ReleaseFreeMemory();
+    } else {
+      new_space_.Shrink();
+      UncommitFromSpace();
+    }
+  }
+
+  return static_cast<int>((OS::TimeCurrentMillis() - start) * 1000);
+}
+
+
 bool Heap::IdleGlobalGC() {
   static const int kIdlesBeforeScavenge = 4;
   static const int kIdlesBeforeMarkSweep = 7;
@@ -4812,6 +5845,11 @@ bool Heap::InSpace(Address addr, AllocationSpace space) {
 void Heap::Verify() {
   ASSERT(HasBeenSetup());
 
+  // Verification scans the old space pages word by word.
+  if (mark_compact_collector()->IsConcurrentSweepingInProgress()) {
+    mark_compact_collector()->WaitUntilSweepingCompleted();
+  }
+
   store_buffer()->Verify();
 
   VerifyPointersVisitor visitor;
@@ -4914,6 +5952,28 @@ MaybeObject* Heap::LookupSymbol(String* string) {
 }
 
 
+MaybeObject* Heap::LookupAtom(String* string) {
+  Object* name;
+  { MaybeObject* maybe_name = LookupSymbol(string);
+    if (!maybe_name->ToObject(&name)) return maybe_name;
+  }
+  Object* atom = atom_table()->Lookup(name);
+  if (atom->IsAtom()) return atom;
+
+  { MaybeObject* maybe_atom = AllocateStruct(ATOM_TYPE);
+    if (!maybe_atom->ToObject(&atom)) return maybe_atom;
+  }
+  Atom::cast(atom)->set_name(String::cast(name));
+  Atom::cast(atom)->set_hash(Smi::FromInt(String::cast(name)->Hash()));
+  Object* new_table;
+  { MaybeObject* maybe_new_table = atom_table()->Put(name, atom);
+    if (!maybe_new_table->ToObject(&new_table)) return maybe_new_table;
+  }
+  set_atom_table(ObjectHashTable::cast(new_table));
+  return atom;
+}
+
+
 bool Heap::LookupSymbolIfExists(String* string, String** symbol) {
   if (string->IsSymbol()) {
     *symbol = string;
@@ -5186,6 +6246,7 @@ void Heap::IterateStrongRoots(ObjectVisitor* v, VisitMode mode) {
 
   // Iterate over local handles in handle scopes.
   isolate_->handle_scope_implementer()->Iterate(v);
+  isolate_->IterateDeferredHandles(v);
   v->Synchronize("handlescope");
 
   // Iterate over the builtin code objects and code stubs in the
@@ -5286,6 +6347,7 @@ bool Heap::ConfigureHeap(int max_semispace_size,
   reserved_semispace_size_ = RoundUpToPowerOf2(reserved_semispace_size_);
   initial_semispace_size_ = Min(initial_semispace_size_, max_semispace_size_);
   external_allocation_limit_ = 10 * max_semispace_size_;
+  external_memory_limit_ = external_allocation_limit_;
 
   // The old generation is paged and needs at least one page for each space.
   int paged_space_count = LAST_PAGED_SPACE - FIRST_PAGED_SPACE + 1;
@@ -5353,6 +6415,29 @@ intptr_t Heap::PromotedSpaceSize() {
 }
 
 
+void Heap::ExternalMemoryPressure(int change_in_bytes) {
+  int amount_since_last_global_gc =
+      amount_of_external_allocated_memory_ -
+      amount_of_external_allocated_memory_at_last_global_gc_;
+  if (amount_since_last_global_gc > 2 * external_memory_limit_) {
+    // Marking did not keep up.
+    CollectAllGarbage(kNoGCFlags);
+    return;
+  }
+  if (incremental_marking()->IsStopped()) {
+    if (!incremental_marking()->WorthActivating()) {
+      // The heap is small enough for a quick atomic collection.
+      CollectAllGarbage(kNoGCFlags);
+      return;
+    }
+    incremental_marking()->Start();
+  }
+  // Advance marking with the external allocation, so it finishes before
+  // the amount reaches the hard limit.
+  incremental_marking()->Step(change_in_bytes);
+}
+
+
 int Heap::PromotedExternalMemorySize() {
   if (amount_of_external_allocated_memory_
       <= amount_of_external_allocated_memory_at_last_global_gc_) return 0;
@@ -5618,6 +6703,16 @@ bool Heap::Setup(bool create_heap_objects) {
   if (lo_space_ == NULL) return false;
   if (!lo_space_->Setup()) return false;
   if (create_heap_objects) {
+    // Set the seed of the string hash function before any string is hashed.
+    if (FLAG_randomize_hashes) {
+      int seed = FLAG_hash_seed != 0
+          ? FLAG_hash_seed
+          : static_cast<int>(V8::RandomPrivate(isolate()));
+      set_hash_seed(Smi::FromInt(seed & 0x3fffffff));
+    } else {
+      set_hash_seed(Smi::FromInt(0));
+    }
+
     // Create initial maps.
     if (!CreateInitialMaps()) return false;
     if (!CreateApiObjects()) return false;
@@ -5666,6 +6761,10 @@ void Heap::TearDown() {
     PrintF("\n\n");
   }
 
+  TearDownScavengerThreads();
+
+  mark_compact_collector()->TearDown();
+
   isolate_->global_handles()->TearDown();
 
   external_string_table_.TearDown();
@@ -6287,8 +7386,13 @@ GCTracer::GCTracer(Heap* heap)
       allocated_since_last_gc_(0),
       spent_in_mutator_(0),
       promoted_objects_size_(0),
+      deduplicated_strings_size_(0),
       heap_(heap) {
-  if (!FLAG_trace_gc && !FLAG_print_cumulative_gc_stat) return;
+  enabled_ = FLAG_trace_gc ||
+      FLAG_print_cumulative_gc_stat ||
+      heap->gc_event_callback() != NULL ||
+      heap->isolate()->stats_table()->HasCreateHistogramFunction();
+  if (!enabled_) return;
   start_time_ = OS::TimeCurrentMillis();
   start_size_ = heap_->SizeOfObjects();
 
@@ -6312,18 +7416,26 @@ GCTracer::GCTracer(Heap* heap)
       heap_->incremental_marking()->steps_count_since_last_gc();
   steps_took_since_last_gc_ =
       heap_->incremental_marking()->steps_took_since_last_gc();
+  steps_bytes_ = heap_->incremental_marking()->steps_bytes();
+  biggest_step_bytes_ = heap_->incremental_marking()->biggest_step_bytes();
 }
 
 
 GCTracer::~GCTracer() {
-  // Printf ONE line iff flag is set.
-  if (!FLAG_trace_gc && !FLAG_print_cumulative_gc_stat) return;
+  if (FLAG_trace_pretenuring) heap_->pretenuring_tracker()->PrintStatistics();
+
+  if (!enabled_) return;
 
   bool first_gc = (heap_->last_gc_end_timestamp_ == 0);
 
   heap_->alive_after_last_gc_ = heap_->SizeOfObjects();
   heap_->last_gc_end_timestamp_ = OS::TimeCurrentMillis();
 
+  ReportEvent(heap_->last_gc_end_timestamp_ - start_time_);
+
+  // Printf ONE line iff flag is set.
+  if (!FLAG_trace_gc && !FLAG_print_cumulative_gc_stat) return;
+
   int time = static_cast<int>(heap_->last_gc_end_timestamp_ - start_time_);
 
   // Update cumulative GC statistics if required.
@@ -6354,10 +7466,13 @@ GCTracer::~GCTracer() {
                steps_count_since_last_gc_);
       } else {
         PrintF(" (+ %d ms in %d steps since start of marking, "
-                   "biggest step %f ms)",
+                   "biggest step %f ms, "
+                   "%d KB per step on average, %d KB at most)",
                static_cast<int>(steps_took_),
                steps_count_,
-               longest_step_);
+               longest_step_,
+               static_cast<int>(steps_bytes_ / steps_count_ / KB),
+               static_cast<int>(biggest_step_bytes_ / KB));
       }
     }
     PrintF(".\n");
@@ -6405,6 +7520,9 @@ GCTracer::~GCTracer() {
 
     PrintF("allocated=%" V8_PTR_PREFIX "d ", allocated_since_last_gc_);
     PrintF("promoted=%" V8_PTR_PREFIX "d ", promoted_objects_size_);
+    if (FLAG_string_dedup) {
+      PrintF("dedup=%" V8_PTR_PREFIX "d ", deduplicated_strings_size_);
+    }
 
     if (collector_ == SCAVENGER) {
       PrintF("stepscount=%d ", steps_count_since_last_gc_);
@@ -6412,6 +7530,9 @@ GCTracer::~GCTracer() {
     } else {
       PrintF("stepscount=%d ", steps_count_);
       PrintF("stepstook=%d ", static_cast<int>(steps_took_));
+      PrintF("stepsbytes=%" V8_PTR_PREFIX "d ",
+             static_cast<intptr_t>(steps_bytes_));
+      PrintF("biggeststepbytes=%" V8_PTR_PREFIX "d ", biggest_step_bytes_);
     }
 
     PrintF("\n");
@@ -6421,6 +7542,68 @@ GCTracer::~GCTracer() {
 }
 
 
+void GCTracer::ReportEvent(double pause_time) {
+  v8::GCEvent event;
+  event.type_ = collector_ == SCAVENGER ? kGCTypeScavenge
+                                        : kGCTypeMarkSweepCompact;
+  event.pause_time_ = pause_time;
+  event.phase_times_[v8::GCEvent::kExternal] = scopes_[Scope::EXTERNAL];
+  event.phase_times_[v8::GCEvent::kMark] = scopes_[Scope::MC_MARK];
+  event.phase_times_[v8::GCEvent::kSweep] =
+      scopes_[Scope::MC_SWEEP] + scopes_[Scope::MC_SWEEP_NEWSPACE];
+  event.phase_times_[v8::GCEvent::kEvacuate] =
+      scopes_[Scope::MC_EVACUATE_PAGES];
+  event.phase_times_[v8::GCEvent::kUpdatePointers] =
+      scopes_[Scope::MC_UPDATE_NEW_TO_NEW_POINTERS] +
+      scopes_[Scope::MC_UPDATE_ROOT_TO_NEW_POINTERS] +
+      scopes_[Scope::MC_UPDATE_OLD_TO_NEW_POINTERS] +
+      scopes_[Scope::MC_UPDATE_POINTERS_TO_EVACUATED] +
+      scopes_[Scope::MC_UPDATE_POINTERS_BETWEEN_EVACUATED] +
+      scopes_[Scope::MC_UPDATE_MISC_POINTERS];
+  event.phase_times_[v8::GCEvent::kScavengeRoots] =
+      scopes_[Scope::SCAVENGER_ROOTS];
+  event.phase_times_[v8::GCEvent::kWeakProcessing] =
+      scopes_[Scope::MC_WEAK_PROCESSING] +
+      scopes_[Scope::SCAVENGER_WEAK_PROCESSING];
+  event.size_before_ = start_size_;
+  event.size_after_ = heap_->SizeOfObjects();
+  event.promoted_bytes_ = promoted_objects_size_;
+  if (collector_ == SCAVENGER) {
+    event.incremental_steps_count_ = steps_count_since_last_gc_;
+    event.incremental_steps_time_ = steps_took_since_last_gc_;
+  } else {
+    event.incremental_steps_count_ = steps_count_;
+    event.incremental_steps_time_ = steps_took_;
+  }
+
+  Counters* counters = heap_->isolate()->counters();
+  counters->gc_external()->AddSample(
+      static_cast<int>(event.phase_time(v8::GCEvent::kExternal)));
+  counters->gc_weak_processing()->AddSample(
+      static_cast<int>(event.phase_time(v8::GCEvent::kWeakProcessing)));
+  if (collector_ == SCAVENGER) {
+    counters->gc_scavenge_roots()->AddSample(
+        static_cast<int>(event.phase_time(v8::GCEvent::kScavengeRoots)));
+  } else {
+    counters->gc_mark()->AddSample(
+        static_cast<int>(event.phase_time(v8::GCEvent::kMark)));
+    counters->gc_sweep()->AddSample(
+        static_cast<int>(event.phase_time(v8::GCEvent::kSweep)));
+    counters->gc_evacuate()->AddSample(
+        static_cast<int>(event.phase_time(v8::GCEvent::kEvacuate)));
+    counters->gc_update_pointers()->AddSample(
+        static_cast<int>(event.phase_time(v8::GCEvent::kUpdatePointers)));
+  }
+  counters->gc_promoted()->AddSample(
+      static_cast<int>(event.promoted_bytes() / KB));
+  counters->gc_freed()->AddSample(static_cast<int>(event.freed_bytes() / KB));
+
+  if (heap_->gc_event_callback() != NULL) {
+    heap_->gc_event_callback()(event);
+  }
+}
+
+
 const char* GCTracer::CollectorString() {
   switch (collector_) {
     case SCAVENGER:
@@ -6432,28 +7615,76 @@ const char* GCTracer::CollectorString() {
 }
 
 
+// Rounds a requested cache length up to a power of two within bounds.
+static int LookupCacheLength(int length, int min_length, int max_length) {
+  length = Max(length, min_length);
+  length = Min(length, max_length);
+  return static_cast<int>(RoundUpToPowerOf2(length));
+}
+
+
+KeyedLookupCache::KeyedLookupCache(Isolate* isolate, int length)
+    : isolate_(isolate) {
+  length_ = LookupCacheLength(length, kMinLength, kMaxLength);
+  mask_ = (length_ - 1) & ~(kEntriesPerBucket - 1);
+  keys_ = NewArray<Key>(length_);
+  field_offsets_ = NewArray<int>(length_);
+  for (int i = 0; i < length_; ++i) {
+    keys_[i].map = NULL;
+    keys_[i].name = NULL;
+    field_offsets_[i] = kNotFound;
+  }
+}
+
+
+KeyedLookupCache::~KeyedLookupCache() {
+  DeleteArray(keys_);
+  DeleteArray(field_offsets_);
+}
+
+
 int KeyedLookupCache::Hash(Map* map, String* name) {
   // Uses only lower 32 bits if pointers are larger.
   uintptr_t addr_hash =
       static_cast<uint32_t>(reinterpret_cast<uintptr_t>(map)) >> kMapHashShift;
-  return static_cast<uint32_t>((addr_hash ^ name->Hash()) & kCapacityMask);
+  return static_cast<uint32_t>((addr_hash ^ name->Hash()) & mask_);
 }
 
 
 int KeyedLookupCache::Lookup(Map* map, String* name) {
   int index = Hash(map, name);
-  Key& key = keys_[index];
-  if ((key.map == map) && key.name->Equals(name)) {
-    return field_offsets_[index];
+  for (int i = 0; i < kEntriesPerBucket; i++) {
+    Key& key = keys_[index + i];
+    if ((key.map == map) && key.name->Equals(name)) {
+      isolate_->counters()->keyed_lookup_cache_hits()->Increment();
+      return field_offsets_[index + i];
+    }
   }
+  isolate_->counters()->keyed_lookup_cache_misses()->Increment();
   return kNotFound;
 }
 
 
 void KeyedLookupCache::Update(Map* map, String* name, int field_offset) {
   String* symbol;
-  if (HEAP->LookupSymbolIfExists(name, &symbol)) {
+  if (isolate_->heap()->LookupSymbolIfExists(name, &symbol)) {
     int index = Hash(map, symbol);
+    // Fill the bucket in order after a clear.  Once it is full, move the
+    // entries down by one and put the new entry first, where the generic
+    // keyed load stub finds it soonest.
+    for (int i = 0; i < kEntriesPerBucket; i++) {
+      Key& key = keys_[index + i];
+      if (key.map == NULL) {
+        key.map = map;
+        key.name = symbol;
+        field_offsets_[index + i] = field_offset;
+        return;
+      }
+    }
+    for (int i = kEntriesPerBucket - 1; i > 0; i--) {
+      keys_[index + i] = keys_[index + i - 1];
+      field_offsets_[index + i] = field_offsets_[index + i - 1];
+    }
     Key& key = keys_[index];
     key.map = map;
     key.name = symbol;
@@ -6463,12 +7694,42 @@ void KeyedLookupCache::Update(Map* map, String* name, int field_offset) {
 
 
 void KeyedLookupCache::Clear() {
-  for (int index = 0; index < kLength; index++) keys_[index].map = NULL;
+  // The generic keyed load stub compares the keys without an epoch, so the
+  // maps have to be wiped.  This only happens before mark sweep collections.
+  for (int index = 0; index < length_; index++) keys_[index].map = NULL;
 }
 
 
-void DescriptorLookupCache::Clear() {
-  for (int index = 0; index < kLength; index++) keys_[index].array = NULL;
+DescriptorLookupCache::DescriptorLookupCache(Isolate* isolate, int length)
+    : counters_(isolate->counters()) {
+  length_ = LookupCacheLength(length, kMinLength, kMaxLength);
+  mask_ = (length_ - 1) & ~(kEntriesPerBucket - 1);
+  entries_ = NewArray<Entry>(length_);
+  Reset();
+}
+
+
+DescriptorLookupCache::~DescriptorLookupCache() {
+  DeleteArray(entries_);
+}
+
+
+void DescriptorLookupCache::Reset() {
+  for (int index = 0; index < length_; index++) {
+    entries_[index].array = NULL;
+    entries_[index].name = NULL;
+    entries_[index].result = kAbsent;
+    entries_[index].epoch = 0;
+  }
+  epoch_ = 1;
+}
+
+
+void CodeStubLookupCache::Clear() {
+  for (int index = 0; index < kLength; index++) {
+    keys_[index] = kNoKey;
+    codes_[index] = NULL;
+  }
 }
 
 
@@ -6505,6 +7766,179 @@ void TranscendentalCache::Clear() {
 }
 
 
+PretenuringTracker::PretenuringTracker(Heap* heap)
+    : heap_(heap),
+      length_(0) {
+}
+
+
+PretenuringTracker::Site* PretenuringTracker::Lookup(JSObject* boilerplate) {
+  for (int i = 0; i < length_; i++) {
+    if (sites_[i].boilerplate == boilerplate) return &sites_[i];
+  }
+  Site* site = NULL;
+  if (length_ < kMaxSites) {
+    site = &sites_[length_++];
+  } else {
+    // Replace the least used site that has not made its decision yet.
+    for (int i = 0; i < length_; i++) {
+      Site* candidate = &sites_[i];
+      if (candidate->pretenure || candidate->sample != NULL) continue;
+      if (site == NULL || candidate->allocated < site->allocated) {
+        site = candidate;
+      }
+    }
+    if (site == NULL) return NULL;
+  }
+  site->boilerplate = boilerplate;
+  site->sample = NULL;
+  site->allocated = 0;
+  site->survived = 0;
+  site->died = 0;
+  site->pretenure = false;
+  return site;
+}
+
+
+PretenureFlag PretenuringTracker::GetPretenureFlag(JSObject* boilerplate) {
+  if (!FLAG_pretenuring) return NOT_TENURED;
+  for (int i = 0; i < length_; i++) {
+    if (sites_[i].boilerplate == boilerplate) {
+      return sites_[i].pretenure ? TENURED : NOT_TENURED;
+    }
+  }
+  return NOT_TENURED;
+}
+
+
+void PretenuringTracker::RecordAllocation(JSObject* boilerplate,
+                                          JSObject* copy) {
+  if (!FLAG_pretenuring) return;
+  Site* site = Lookup(boilerplate);
+  if (site == NULL) return;
+  site->allocated++;
+  if (site->sample == NULL && !site->pretenure && heap_->InNewSpace(copy)) {
+    site->sample = copy;
+  }
+}
+
+
+void PretenuringTracker::SampleSurvived(Site* site) {
+  site->sample = NULL;
+  site->survived++;
+  int samples = site->survived + site->died;
+  if (samples >= kMinimumSamples &&
+      site->survived * 100 >= FLAG_pretenuring_survival_percent * samples) {
+    site->pretenure = true;
+  }
+}
+
+
+void PretenuringTracker::SampleDied(Site* site) {
+  site->sample = NULL;
+  site->died++;
+}
+
+
+void PretenuringTracker::UpdateSitesAfterScavenge() {
+  int last = 0;
+  for (int i = 0; i < length_; i++) {
+    Site* site = &sites_[i];
+    if (heap_->InNewSpace(site->boilerplate)) {
+      MapWord map_word = HeapObject::cast(site->boilerplate)->map_word();
+      // The boilerplate died together with its function.
+      if (!map_word.IsForwardingAddress()) continue;
+      site->boilerplate = map_word.ToForwardingAddress();
+    }
+    if (site->sample != NULL) {
+      ASSERT(heap_->InNewSpace(site->sample));
+      MapWord map_word = HeapObject::cast(site->sample)->map_word();
+      if (!map_word.IsForwardingAddress()) {
+        SampleDied(site);
+      } else {
+        site->sample = map_word.ToForwardingAddress();
+        // Samples that are still in new space have not been promoted yet.
+        if (!heap_->InNewSpace(site->sample)) SampleSurvived(site);
+      }
+    }
+    sites_[last++] = *site;
+  }
+  length_ = last;
+}
+
+
+void PretenuringTracker::RemoveDeadSites() {
+  int last = 0;
+  for (int i = 0; i < length_; i++) {
+    Site* site = &sites_[i];
+    if (!Marking::MarkBitFrom(HeapObject::cast(site->boilerplate)).Get()) {
+      continue;
+    }
+    // A full collection promotes the live objects of new space or keeps
+    // them for another scavenge; either way the sample has survived.
+    if (site->sample != NULL) {
+      if (Marking::MarkBitFrom(HeapObject::cast(site->sample)).Get()) {
+        SampleSurvived(site);
+      } else {
+        SampleDied(site);
+      }
+    }
+    sites_[last++] = *site;
+  }
+  length_ = last;
+}
+
+
+void PretenuringTracker::UpdateSitesAfterCompact(ObjectVisitor* visitor) {
+  for (int i = 0; i < length_; i++) {
+    ASSERT(sites_[i].sample == NULL);
+    visitor->VisitPointer(&sites_[i].boilerplate);
+  }
+}
+
+
+void PretenuringTracker::PrintStatistics() {
+  for (int i = 0; i < length_; i++) {
+    Site* site = &sites_[i];
+    PrintF("pretenuring site %p: %d allocated, %d sampled, "
+           "%d survived, %d died%s\n",
+           reinterpret_cast<void*>(site->boilerplate),
+           site->allocated,
+           site->survived + site->died,
+           site->survived,
+           site->died,
+           site->pretenure ? ", pretenured" : "");
+  }
+}
+
+
+void ObjectStats::Clear() {
+  memset(type_counts_, 0, sizeof(type_counts_));
+  memset(type_sizes_, 0, sizeof(type_sizes_));
+  memset(space_counts_, 0, sizeof(space_counts_));
+  memset(space_sizes_, 0, sizeof(space_sizes_));
+  memset(code_kind_counts_, 0, sizeof(code_kind_counts_));
+  memset(code_kind_sizes_, 0, sizeof(code_kind_sizes_));
+}
+
+
+void ObjectStats::Record(AllocationSpace space, HeapObject* object) {
+  Map* map = object->map();
+  InstanceType type = map->instance_type();
+  ASSERT(0 <= type && type <= LAST_TYPE);
+  int size = object->SizeFromMap(map);
+  type_counts_[type]++;
+  type_sizes_[type] += size;
+  space_counts_[space]++;
+  space_sizes_[space] += size;
+  if (type == CODE_TYPE) {
+    Code::Kind kind = Code::cast(object)->kind();
+    code_kind_counts_[kind]++;
+    code_kind_sizes_[kind] += size;
+  }
+}
+
+
 void ExternalStringTable::CleanUp() {
   int last = 0;
   for (int i = 0; i < new_space_strings_.length(); ++i) {
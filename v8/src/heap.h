@@ -90,11 +90,9 @@ inline Heap* _inline_get_heap_();
   /* view.  This means they are never in new space and never on a page that */ \
   /* is being compacted.                                                    */ \
   V(FixedArray, number_string_cache, NumberStringCache)                        \
-  V(Object, instanceof_cache_function, InstanceofCacheFunction)                \
-  V(Object, instanceof_cache_map, InstanceofCacheMap)                          \
-  V(Object, instanceof_cache_answer, InstanceofCacheAnswer)                    \
   V(FixedArray, single_character_string_cache, SingleCharacterStringCache)     \
   V(FixedArray, string_split_cache, StringSplitCache)                          \
+  V(FixedArray, field_descriptors_cache, FieldDescriptorsCache)                \
   V(Object, termination_exception, TerminationException)                       \
   V(Map, string_map, StringMap)                                                \
   V(Map, symbol_map, SymbolMap)                                                \
@@ -139,6 +137,8 @@ inline Heap* _inline_get_heap_();
   V(Map, oddball_map, OddballMap)                                              \
   V(Map, message_object_map, JSMessageObjectMap)                               \
   V(Map, foreign_map, ForeignMap)                                              \
+  V(Map, mutable_heap_number_map, MutableHeapNumberMap)                        \
+  V(Map, big_integer_map, BigIntegerMap)                                       \
   V(HeapNumber, nan_value, NanValue)                                           \
   V(HeapNumber, infinity_value, InfinityValue)                                 \
   V(HeapNumber, minus_zero_value, MinusZeroValue)                              \
@@ -148,12 +148,14 @@ inline Heap* _inline_get_heap_();
   V(NumberDictionary, code_stubs, CodeStubs)                                   \
   V(NumberDictionary, non_monomorphic_cache, NonMonomorphicCache)              \
   V(PolymorphicCodeCache, polymorphic_code_cache, PolymorphicCodeCache)        \
+  V(ObjectHashTable, atom_table, AtomTable)                                    \
   V(Code, js_entry_code, JsEntryCode)                                          \
   V(Code, js_construct_entry_code, JsConstructEntryCode)                       \
   V(FixedArray, natives_source_cache, NativesSourceCache)                      \
   V(Object, last_script_id, LastScriptId)                                      \
   V(Script, empty_script, EmptyScript)                                         \
   V(Smi, real_stack_limit, RealStackLimit)                                     \
+  V(Smi, hash_seed, HashSeed)                                                  \
   V(StringDictionary, intrinsic_function_names, IntrinsicFunctionNames)        \
 
 #define ROOT_LIST(V)                                  \
@@ -198,10 +200,12 @@ inline Heap* _inline_get_heap_();
   V(object_symbol, "object")                                             \
   V(prototype_symbol, "prototype")                                       \
   V(string_symbol, "string")                                             \
+  V(symbol_symbol, "symbol")                                             \
   V(String_symbol, "String")                                             \
   V(Date_symbol, "Date")                                                 \
   V(this_symbol, "this")                                                 \
   V(to_string_symbol, "toString")                                        \
+  V(to_json_symbol, "toJSON")                                            \
   V(char_at_symbol, "CharAt")                                            \
   V(undefined_symbol, "undefined")                                       \
   V(value_of_symbol, "valueOf")                                          \
@@ -246,12 +250,15 @@ inline Heap* _inline_get_heap_();
   V(dot_symbol, ".")                                                     \
   V(anonymous_function_symbol, "(anonymous function)")                   \
   V(infinity_symbol, "Infinity")                                         \
-  V(minus_infinity_symbol, "-Infinity")
+  V(minus_infinity_symbol, "-Infinity")                                  \
+  V(method_missing_symbol, "method_missing")
 
 // Forward declarations.
+class AllocationSampler;
 class GCTracer;
 class HeapStats;
 class Isolate;
+class ScavengerThread;
 class WeakObjectRetainer;
 
 
@@ -288,6 +295,95 @@ class HeapDebugUtils;
 #endif
 
 
+// Tracks how many of the objects created by a literal site survive until
+// they are promoted.  A site is identified by its boilerplate.  It samples
+// one of its copies at a time, and once nearly all of the samples have
+// been promoted the site allocates its copies in old space directly.
+class PretenuringTracker {
+ public:
+  explicit PretenuringTracker(Heap* heap);
+
+  // Returns where copies of the boilerplate should be allocated.
+  PretenureFlag GetPretenureFlag(JSObject* boilerplate);
+
+  // Counts a copy of the boilerplate, sampling it if the site has no
+  // sample in flight.
+  void RecordAllocation(JSObject* boilerplate, JSObject* copy);
+
+  void UpdateSitesAfterScavenge();
+  void RemoveDeadSites();
+  void UpdateSitesAfterCompact(ObjectVisitor* visitor);
+
+  void PrintStatistics();
+
+ private:
+  struct Site {
+    Object* boilerplate;
+    Object* sample;
+    int allocated;
+    int survived;
+    int died;
+    bool pretenure;
+  };
+
+  Site* Lookup(JSObject* boilerplate);
+  void SampleSurvived(Site* site);
+  void SampleDied(Site* site);
+
+  static const int kMaxSites = 64;
+  static const int kMinimumSamples = 8;
+
+  Heap* heap_;
+  Site sites_[kMaxSites];
+  int length_;
+
+  DISALLOW_COPY_AND_ASSIGN(PretenuringTracker);
+};
+
+
+// Number and size of the objects that survived the last full collection,
+// by instance type, by space and, for code objects, by code kind.  Only
+// recorded with --track-object-stats, from the mark bits right before
+// sweeping.
+class ObjectStats {
+ public:
+  ObjectStats() : recorded_(false) { Clear(); }
+
+  void Clear();
+  void Record(AllocationSpace space, HeapObject* object);
+  void set_recorded() { recorded_ = true; }
+
+  // Whether any full collection has recorded statistics yet.
+  bool recorded() const { return recorded_; }
+
+  int count_by_type(InstanceType type) const { return type_counts_[type]; }
+  intptr_t size_by_type(InstanceType type) const { return type_sizes_[type]; }
+  int count_by_space(AllocationSpace space) const {
+    return space_counts_[space];
+  }
+  intptr_t size_by_space(AllocationSpace space) const {
+    return space_sizes_[space];
+  }
+  int count_by_code_kind(Code::Kind kind) const {
+    return code_kind_counts_[kind];
+  }
+  intptr_t size_by_code_kind(Code::Kind kind) const {
+    return code_kind_sizes_[kind];
+  }
+
+ private:
+  bool recorded_;
+  int type_counts_[LAST_TYPE + 1];
+  intptr_t type_sizes_[LAST_TYPE + 1];
+  int space_counts_[LAST_SPACE + 1];
+  intptr_t space_sizes_[LAST_SPACE + 1];
+  int code_kind_counts_[Code::NUMBER_OF_KINDS];
+  intptr_t code_kind_sizes_[Code::NUMBER_OF_KINDS];
+
+  DISALLOW_COPY_AND_ASSIGN(ObjectStats);
+};
+
+
 // A queue of objects promoted during scavenge. Each object is accompanied
 // by it's size to avoid dereferencing a map pointer for scanning.
 class PromotionQueue {
@@ -489,6 +585,15 @@ class Heap {
   // Returns of size of all objects residing in the heap.
   intptr_t SizeOfObjects();
 
+  // Records the size of the heap once the isolate has been set up, which
+  // is what every isolate of the process pays before it runs any code.
+  void RecordStartupSize() {
+    startup_size_ = SizeOfObjects();
+    startup_committed_memory_ = CommittedMemory();
+  }
+  intptr_t startup_size() { return startup_size_; }
+  intptr_t startup_committed_memory() { return startup_committed_memory_; }
+
   // Return the starting address and a mask for the new space.  And-masking an
   // address with the mask will result in the start address of the new space
   // for all addresses in either semispace.
@@ -539,7 +644,9 @@ class Heap {
   // Returns a deep copy of the JavaScript object.
   // Properties and elements are copied too.
   // Returns failure if allocation failed.
-  MUST_USE_RESULT MaybeObject* CopyJSObject(JSObject* source);
+  MUST_USE_RESULT MaybeObject* CopyJSObject(
+      JSObject* source,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Allocates the function prototype.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -613,7 +720,8 @@ class Heap {
   // Allocates an empty PolymorphicCodeCache.
   MUST_USE_RESULT MaybeObject* AllocatePolymorphicCodeCache();
 
-  // Clear the Instanceof cache (used when a prototype changes).
+  // Clear the Instanceof cache (used when a prototype changes and before
+  // GCs).
   inline void ClearInstanceofCache();
 
   // Allocates and fully initializes a String.  There are two String
@@ -642,6 +750,7 @@ class Heap {
       PretenureFlag pretenure = NOT_TENURED);
   MUST_USE_RESULT MaybeObject* AllocateStringFromUtf8Slow(
       Vector<const char> str,
+      int non_ascii_start,
       PretenureFlag pretenure = NOT_TENURED);
   MUST_USE_RESULT MaybeObject* AllocateStringFromTwoByte(
       Vector<const uc16> str,
@@ -704,6 +813,15 @@ class Heap {
   // Please note this does not perform a garbage collection.
   MUST_USE_RESULT MaybeObject* AllocateByteArray(int length);
 
+  // Allocates a BigInteger with the given number of digits, all of which
+  // must be set by the caller.  The sign is positive.
+  // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
+  // failed.
+  // Please note this does not perform a garbage collection.
+  MUST_USE_RESULT MaybeObject* AllocateBigInteger(
+      int digit_count,
+      PretenureFlag pretenure = NOT_TENURED);
+
   // Allocates an external array of the specified length and type.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
   // failed.
@@ -738,21 +856,29 @@ class Heap {
 
   // Make a copy of src and return it. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
-  MUST_USE_RESULT inline MaybeObject* CopyFixedArray(FixedArray* src);
+  MUST_USE_RESULT inline MaybeObject* CopyFixedArray(
+      FixedArray* src,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src, set the map, and return the copy. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
-  MUST_USE_RESULT MaybeObject* CopyFixedArrayWithMap(FixedArray* src, Map* map);
+  MUST_USE_RESULT MaybeObject* CopyFixedArrayWithMap(
+      FixedArray* src,
+      Map* map,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src and return it. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
   MUST_USE_RESULT inline MaybeObject* CopyFixedDoubleArray(
-      FixedDoubleArray* src);
+      FixedDoubleArray* src,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src, set the map, and return the copy. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
   MUST_USE_RESULT MaybeObject* CopyFixedDoubleArrayWithMap(
-      FixedDoubleArray* src, Map* map);
+      FixedDoubleArray* src,
+      Map* map,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Allocates a fixed array initialized with the hole values.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -843,6 +969,12 @@ class Heap {
   // pretenure = NOT_TENURED
   MUST_USE_RESULT MaybeObject* AllocateHeapNumber(double value);
 
+  // Allocates a HeapNumber with the mutable heap number map, for the
+  // double fields of an object (see DOUBLE_FIELD).
+  MUST_USE_RESULT MaybeObject* AllocateMutableHeapNumber(
+      double value,
+      PretenureFlag pretenure = NOT_TENURED);
+
   // Converts an int into either a Smi or a HeapNumber object.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
   // failed.
@@ -883,7 +1015,8 @@ class Heap {
       Object* stack_trace,
       Object* stack_frames);
 
-  // Allocates a new cons string object.
+  // Allocates a new cons string object.  Concatenations that may get
+  // deeper than ConsString::kMaxDepth go through Factory::NewConsString.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
   // failed.
   // Please note this does not perform a garbage collection.
@@ -916,6 +1049,13 @@ class Heap {
   // data and clearing the resource pointer.
   inline void FinalizeExternalString(String* string);
 
+  // Disposes a resource that the API wraps or replaces instead of handing
+  // it to an external string.
+  static void DisposeExternalStringResource(
+      v8::String::ExternalStringResourceBase* resource) {
+    resource->Dispose();
+  }
+
   // Allocates an uninitialized object.  The memory is non-executable if the
   // hardware and OS allow.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -959,6 +1099,11 @@ class Heap {
     return LookupSymbol(CStrVector(str));
   }
   MUST_USE_RESULT MaybeObject* LookupSymbol(String* str);
+
+  // Finds the atom named by str in the atom table, creating and adding it
+  // if it is not there yet.  Atoms are never removed from the table.
+  // Please note this function does not perform a garbage collection.
+  MUST_USE_RESULT MaybeObject* LookupAtom(String* str);
   MUST_USE_RESULT MaybeObject* LookupAsciiSymbol(Handle<SeqAsciiString> string,
                                                  int from,
                                                  int length);
@@ -999,12 +1144,23 @@ class Heap {
 
   static const int kNoGCFlags = 0;
   static const int kMakeHeapIterableMask = 1;
+  static const int kReduceMemoryFootprintMask = 2;
 
   // Performs a full garbage collection.  If (flags & kMakeHeapIterableMask) is
   // non-zero, then the slower precise sweeper is used, which leaves the heap
-  // in a state where we can iterate over the heap visiting all objects.
+  // in a state where we can iterate over the heap visiting all objects.  If
+  // (flags & kReduceMemoryFootprintMask) is non-zero, every sparse page is
+  // evacuated, so the pages left empty can be released.
   void CollectAllGarbage(int flags);
 
+  // Compacts sparse pages and gives the memory freed by the collection back
+  // to the operating system.  Used when the isolate is idle.
+  void ReduceMemoryFootprint();
+
+  // Releases empty pages, pooled memory and new space above its initial
+  // size, and discards the memory of large free blocks.
+  void ReleaseFreeMemory();
+
   // Last hope GC, should try to squeeze as much as possible.
   void CollectAllAvailableGarbage();
 
@@ -1059,6 +1215,10 @@ class Heap {
     ASSERT((callback == NULL) ^ (global_gc_epilogue_callback_ == NULL));
     global_gc_epilogue_callback_ = callback;
   }
+  void SetGCEventCallback(GCEventCallback callback) {
+    gc_event_callback_ = callback;
+  }
+  GCEventCallback gc_event_callback() { return gc_event_callback_; }
 
   // Heap root getters.  We have versions with and without type::cast() here.
   // You can't use type::cast during GC because the assert fails.
@@ -1207,8 +1367,11 @@ class Heap {
   // Write barrier support for address[offset] = o.
   inline void RecordWrite(Address address, int offset);
 
-  // Write barrier support for address[start : start + len[ = o.
-  inline void RecordWrites(Address address, int start, int len);
+  // Write barrier support for address[start : start + len[ = o, after the
+  // values have been stored.  Only the slots that point to new space are
+  // remembered, and a range with many of them makes the scavenger scan the
+  // whole chunk instead.
+  void RecordWrites(Address address, int start, int len);
 
   // Given an address occupied by a live code object, return that object.
   Object* FindCodeObject(Address a);
@@ -1271,9 +1434,24 @@ class Heap {
   // Update the cache with a new number-string pair.
   void SetNumberStringCache(Object* number, String* str);
 
-  // Adjusts the amount of registered external memory.
-  // Returns the adjusted value.
-  inline int AdjustAmountOfExternalAllocatedMemory(int change_in_bytes);
+  // The seed of the string hash function.  Set when the heap is created
+  // and stored in snapshots, since the hashes of the symbols in them
+  // depend on it.
+  uint32_t HashSeed() {
+    uint32_t seed = static_cast<uint32_t>(hash_seed()->value());
+    ASSERT(FLAG_randomize_hashes || seed == 0);
+    return seed;
+  }
+
+  // Adjusts the amount of registered external memory of the given type.
+  // Returns the adjusted total.
+  inline int AdjustAmountOfExternalAllocatedMemory(
+      int change_in_bytes,
+      v8::ExternalMemoryType type = v8::kEmbedderMemory);
+
+  int amount_of_external_allocated_memory(v8::ExternalMemoryType type) {
+    return amount_of_external_allocated_memory_by_type_[type];
+  }
 
   // Allocate uninitialized fixed array.
   MUST_USE_RESULT MaybeObject* AllocateRawFixedArray(int length);
@@ -1313,8 +1491,9 @@ class Heap {
 
   intptr_t OldGenPromotionLimit(intptr_t old_gen_size) {
     const int divisor = FLAG_stress_compaction ? 10 : 3;
-    intptr_t limit =
-        Max(old_gen_size + old_gen_size / divisor, kMinimumPromotionLimit);
+    intptr_t growth = OldGenGrowthForTargetOverhead(old_gen_size);
+    growth = growth < 0 ? old_gen_size / divisor : growth * 2 / 3;
+    intptr_t limit = Max(old_gen_size + growth, kMinimumPromotionLimit);
     limit += new_space_.Capacity();
     limit *= old_gen_limit_factor_;
     intptr_t halfway_to_the_max = (old_gen_size + max_old_generation_size_) / 2;
@@ -1323,17 +1502,29 @@ class Heap {
 
   intptr_t OldGenAllocationLimit(intptr_t old_gen_size) {
     const int divisor = FLAG_stress_compaction ? 8 : 2;
-    intptr_t limit =
-        Max(old_gen_size + old_gen_size / divisor, kMinimumAllocationLimit);
+    intptr_t growth = OldGenGrowthForTargetOverhead(old_gen_size);
+    if (growth < 0) growth = old_gen_size / divisor;
+    intptr_t limit = Max(old_gen_size + growth, kMinimumAllocationLimit);
     limit += new_space_.Capacity();
     limit *= old_gen_limit_factor_;
     intptr_t halfway_to_the_max = (old_gen_size + max_old_generation_size_) / 2;
     return Min(limit, halfway_to_the_max);
   }
 
+  // With --target-gc-overhead, returns how much the old generation of the
+  // given size may grow before the next full collection.  The mutator then
+  // runs long enough between collections, at the measured promotion rate,
+  // for a collection at the measured speed to take the target share of the
+  // time.  Returns -1 if the fixed growth factors apply.
+  intptr_t OldGenGrowthForTargetOverhead(intptr_t old_gen_size);
+
   // Implements the corresponding V8 API function.
   bool IdleNotification(int hint);
 
+  // Implements the corresponding V8 API function.  Picks the idle work that
+  // is expected to fit in the given time and returns the time used.
+  int IdleNotificationWithDeadline(int idle_time_in_us);
+
   // Declare all the root indices.
   enum RootListIndex {
 #define ROOT_INDEX_DECLARATION(type, name, camel_name) k##camel_name##RootIndex,
@@ -1376,6 +1567,13 @@ class Heap {
   // Check new space expansion criteria and expand semispaces if it was hit.
   void CheckNewSpaceExpansionCriteria();
 
+  // With --adaptive-new-space, decides after a scavenge whether new space
+  // grows at the next scavenge or shrinks now.  The share of time spent in
+  // scavenges is the cost of a scavenge per allocated megabyte times the
+  // allocation rate, and new space is sized to keep it near
+  // --target-scavenge-overhead.
+  void ResizeNewSpace(int allocated, double scavenge_ms);
+
   inline void IncrementYoungSurvivorsCounter(int survived) {
     young_survivors_after_last_gc_ = survived;
     survived_since_last_expansion_ += survived;
@@ -1443,10 +1641,26 @@ class Heap {
     return &mark_compact_collector_;
   }
 
+  // The concurrent sweeper reads the sizes of the live objects on the pages
+  // it has not finished yet, so an object on such a page must not shrink or
+  // change its start.  Call this before resizing an object in place.
+  void EnsureSweptBeforeResizing(HeapObject* object) {
+    mark_compact_collector_.EnsurePageIsSwept(
+        MemoryChunk::FromAddress(object->address()));
+  }
+
   StoreBuffer* store_buffer() {
     return &store_buffer_;
   }
 
+  PretenuringTracker* pretenuring_tracker() {
+    return &pretenuring_tracker_;
+  }
+
+  ObjectStats* object_stats() {
+    return &object_stats_;
+  }
+
   Marking* marking() {
     return &marking_;
   }
@@ -1455,6 +1669,17 @@ class Heap {
     return &incremental_marking_;
   }
 
+  // Installs the sampler that is notified about allocated bytes, or
+  // uninstalls it when passed NULL. Owned by the heap profiler.
+  void set_allocation_sampler(AllocationSampler* sampler);
+  AllocationSampler* allocation_sampler() { return allocation_sampler_; }
+
+  // Reports an allocation of size_in_bytes that completes bytes_allocated
+  // bytes of allocation since the previous report to the sampler.
+  void SampleAllocation(MaybeObject* result,
+                        int size_in_bytes,
+                        intptr_t bytes_allocated);
+
   bool IsSweepingComplete() {
     return old_data_space()->IsSweepingComplete() &&
            old_pointer_space()->IsSweepingComplete();
@@ -1494,10 +1719,6 @@ class Heap {
   void QueueMemoryChunkForFree(MemoryChunk* chunk);
   void FreeQueuedChunks();
 
-  // Completely clear the Instanceof cache (to stop it keeping objects alive
-  // around a GC).
-  inline void CompletelyClearInstanceofCache();
-
   // The roots that have an index less than this are always in old space.
   static const int kOldSpaceRoots = 0x20;
 
@@ -1523,6 +1744,11 @@ class Heap {
   // scavenge since last new space expansion.
   int survived_since_last_expansion_;
 
+  // When the last scavenge ended, and whether new space should grow at the
+  // next one, for --adaptive-new-space.
+  double last_scavenge_end_time_;
+  bool grow_new_space_;
+
   // For keeping track on when to flush RegExp code.
   int sweep_generation_;
 
@@ -1605,13 +1831,24 @@ class Heap {
   // Used to adjust the limits that control the timing of the next GC.
   intptr_t size_of_old_gen_at_last_old_space_gc_;
 
-  // Limit on the amount of externally allocated memory allowed
-  // between global GCs. If reached a global GC is forced.
+  // Minimum of external_memory_limit_.
   intptr_t external_allocation_limit_;
 
+  // Limit on the amount of externally allocated memory allowed between
+  // global GCs.  Set after each global GC from the amount that survived
+  // it, like the old generation limits.  If reached, incremental marking
+  // is started, and at twice the limit a global GC is forced.
+  intptr_t external_memory_limit_;
+
   // The amount of external memory registered through the API kept alive
   // by global handles
   int amount_of_external_allocated_memory_;
+  int amount_of_external_allocated_memory_by_type_[
+      v8::kNumberOfExternalMemoryTypes];
+
+  // Called when the external memory allocated since the last global GC
+  // exceeds external_memory_limit_.
+  void ExternalMemoryPressure(int change_in_bytes);
 
   // Caches the amount of external memory registered at the last global gc.
   int amount_of_external_allocated_memory_at_last_global_gc_;
@@ -1680,6 +1917,8 @@ class Heap {
   GCCallback global_gc_prologue_callback_;
   GCCallback global_gc_epilogue_callback_;
 
+  GCEventCallback gc_event_callback_;
+
   // Support for computing object sizes during GC.
   HeapObjectCallback gc_safe_size_of_old_object_;
   static int GcSafeSizeOfOldObject(HeapObject* object);
@@ -1745,6 +1984,21 @@ class Heap {
       Object** pointer);
 
   Address DoScavenge(ObjectVisitor* scavenge_visitor, Address new_space_front);
+
+  // Returns true if the objects discovered from the roots can be copied by
+  // the parallel scavenger.  Marks transfer and logging of object moves are
+  // only supported by the sequential scavenging visitors.
+  bool CanUseParallelScavenge();
+
+  // Copies the transitive closure of the unscanned to-space objects between
+  // new_space_front and the allocation top and of the objects in the
+  // promotion queue using the scavenger threads in addition to the current
+  // thread.  Returns the new front of the to-space queue, which is the
+  // allocation top.
+  Address ParallelScavenge(Address new_space_front);
+
+  void TearDownScavengerThreads();
+
   static void ScavengeStoreBufferCallback(Heap* heap,
                                           MemoryChunk* page,
                                           StoreBufferEvent event);
@@ -1778,8 +2032,13 @@ class Heap {
   GCTracer* tracer_;
 
 
-  // Initializes the number to string cache based on the max semispace size.
+  // Initializes the number to string cache with the initial size.
   MUST_USE_RESULT MaybeObject* InitializeNumberStringCache();
+  // Length of the number to string cache once it has grown, based on the
+  // max semispace size.
+  int FullSizeNumberStringCacheLength();
+  // Replaces the number to string cache with an empty full size one.
+  void AllocateFullSizeNumberStringCache();
   // Flush the number to string cache.
   void FlushNumberStringCache();
 
@@ -1864,6 +2123,7 @@ class Heap {
 
   static const int kInitialSymbolTableSize = 2048;
   static const int kInitialEvalCacheSize = 64;
+  static const int kInitialNumberStringCacheSize = 256;
 
   // Maximum GC pause.
   int max_gc_pause_;
@@ -1877,6 +2137,10 @@ class Heap {
   // Size of objects alive after last GC.
   intptr_t alive_after_last_gc_;
 
+  // Sizes recorded by RecordStartupSize.
+  intptr_t startup_size_;
+  intptr_t startup_committed_memory_;
+
   double last_gc_end_timestamp_;
 
   MarkCompactCollector mark_compact_collector_;
@@ -1887,6 +2151,12 @@ class Heap {
 
   IncrementalMarking incremental_marking_;
 
+  PretenuringTracker pretenuring_tracker_;
+
+  ObjectStats object_stats_;
+
+  AllocationSampler* allocation_sampler_;
+
   int number_idle_notifications_;
   unsigned int last_idle_notification_gc_count_;
   bool last_idle_notification_gc_count_init_;
@@ -1900,6 +2170,21 @@ class Heap {
   static const int kMaxMarkSweepsInIdleRound = 7;
   static const int kIdleScavengeThreshold = 5;
 
+  // Estimated speeds of the idle work in bytes per millisecond, used to
+  // decide what fits in the time given by IdleNotificationWithDeadline.
+  static const int kInitialIdleSpeed = 1 * MB;
+  double idle_sweeping_speed_;
+  double idle_scavenge_speed_;
+  double idle_mark_compact_speed_;
+
+  // Measured speed of full collections and promotion rate of the mutator
+  // between them, in bytes per millisecond, for --target-gc-overhead.
+  void UpdateOldGenGrowthRates(intptr_t old_gen_size_before_gc,
+                               double mark_compact_ms);
+  double mark_compact_speed_;
+  double old_gen_promotion_rate_;
+  double last_mark_compact_end_time_;
+
   // Shared state read by the scavenge collector and set by ScavengeObject.
   PromotionQueue promotion_queue_;
 
@@ -1913,6 +2198,14 @@ class Heap {
 
   MemoryChunk* chunks_queued_for_free_;
 
+  // Helper threads of the parallel scavenger, started on first use.
+  ScavengerThread** scavenger_threads_;
+  int scavenger_threads_count_;
+
+  // Protects the new space and old space allocation done while scavenging
+  // in parallel.
+  Mutex* scavenge_allocation_mutex_;
+
   friend class Factory;
   friend class GCTracer;
   friend class DisallowAllocationFailure;
@@ -1923,6 +2216,7 @@ class Heap {
   friend class MarkCompactCollector;
   friend class StaticMarkingVisitor;
   friend class MapCompact;
+  friend class ScavengeWorker;
 
   DISALLOW_COPY_AND_ASSIGN(Heap);
 };
@@ -2110,7 +2404,11 @@ class HeapIterator BASE_EMBEDDED {
 };
 
 
-// Cache for mapping (map, property name) into field offset.
+// Cache for mapping (map, property name) into field offset.  The cache is
+// set-associative: a (map, name) pair can be in any of the
+// kEntriesPerBucket entries of its bucket.  The generic keyed load stub
+// probes the cache too, so the layout of the entries and the bucket mask
+// are known to generated code.
 // Cleared at startup and prior to mark sweep collection.
 class KeyedLookupCache {
  public:
@@ -2123,30 +2421,34 @@ class KeyedLookupCache {
   // Clear the cache.
   void Clear();
 
-  static const int kLength = 64;
-  static const int kCapacityMask = kLength - 1;
+  int length() const { return length_; }
+
+  static const int kEntriesPerBucket = 2;
   static const int kMapHashShift = 2;
   static const int kNotFound = -1;
+  static const int kMinLength = 64;
+  static const int kMaxLength = 1 << 16;
 
  private:
-  KeyedLookupCache() {
-    for (int i = 0; i < kLength; ++i) {
-      keys_[i].map = NULL;
-      keys_[i].name = NULL;
-      field_offsets_[i] = kNotFound;
-    }
-  }
+  // The length is rounded up to a power of two.
+  KeyedLookupCache(Isolate* isolate, int length);
+  ~KeyedLookupCache();
 
-  static inline int Hash(Map* map, String* name);
+  // Returns the index of the first entry of the bucket for (map, name).
+  inline int Hash(Map* map, String* name);
 
-  // Get the address of the keys and field_offsets arrays.  Used in
-  // generated code to perform cache lookups.
+  // Get the address of the keys and field_offsets arrays and of the bucket
+  // mask.  Used in generated code to perform cache lookups.
   Address keys_address() {
-    return reinterpret_cast<Address>(&keys_);
+    return reinterpret_cast<Address>(keys_);
   }
 
   Address field_offsets_address() {
-    return reinterpret_cast<Address>(&field_offsets_);
+    return reinterpret_cast<Address>(field_offsets_);
+  }
+
+  Address mask_address() {
+    return reinterpret_cast<Address>(&mask_);
   }
 
   struct Key {
@@ -2154,8 +2456,12 @@ class KeyedLookupCache {
     String* name;
   };
 
-  Key keys_[kLength];
-  int field_offsets_[kLength];
+  Isolate* isolate_;
+  int length_;
+  // Masks a hash to the index of the first entry of a bucket.
+  int mask_;
+  Key* keys_;
+  int* field_offsets_;
 
   friend class ExternalReference;
   friend class Isolate;
@@ -2166,16 +2472,25 @@ class KeyedLookupCache {
 // Cache for mapping (array, property name) into descriptor index.
 // The cache contains both positive and negative results.
 // Descriptor index equals kNotFound means the property is absent.
-// Cleared at startup and prior to any gc.
+// The cache is set-associative like the keyed lookup cache.
+// Cleared at startup and prior to any gc.  Clearing starts a new epoch
+// instead of wiping the entries; entries from an older epoch never match.
 class DescriptorLookupCache {
  public:
   // Lookup descriptor index for (map, name).
   // If absent, kAbsent is returned.
   int Lookup(DescriptorArray* array, String* name) {
     if (!StringShape(name).IsSymbol()) return kAbsent;
-    int index = Hash(array, name);
-    Key& key = keys_[index];
-    if ((key.array == array) && (key.name == name)) return results_[index];
+    Entry* bucket = &entries_[Hash(array, name)];
+    for (int i = 0; i < kEntriesPerBucket; i++) {
+      Entry& entry = bucket[i];
+      if ((entry.array == array) && (entry.name == name) &&
+          (entry.epoch == epoch_)) {
+        counters_->descriptor_lookup_cache_hits()->Increment();
+        return entry.result;
+      }
+    }
+    counters_->descriptor_lookup_cache_misses()->Increment();
     return kAbsent;
   }
 
@@ -2183,51 +2498,177 @@ class DescriptorLookupCache {
   void Update(DescriptorArray* array, String* name, int result) {
     ASSERT(result != kAbsent);
     if (StringShape(name).IsSymbol()) {
-      int index = Hash(array, name);
-      Key& key = keys_[index];
-      key.array = array;
-      key.name = name;
-      results_[index] = result;
+      Entry* bucket = &entries_[Hash(array, name)];
+      // Use an entry left over from an older epoch if there is one.
+      // Otherwise evict the last entry of the bucket, so that the newest
+      // entry is probed first.
+      int index = 0;
+      while (index < kEntriesPerBucket - 1 && bucket[index].epoch == epoch_) {
+        index++;
+      }
+      if (bucket[index].epoch == epoch_) {
+        for (int i = kEntriesPerBucket - 1; i > 0; i--) {
+          bucket[i] = bucket[i - 1];
+        }
+        index = 0;
+      }
+      Entry& entry = bucket[index];
+      entry.array = array;
+      entry.name = name;
+      entry.result = result;
+      entry.epoch = epoch_;
     }
   }
 
   // Clear the cache.
-  void Clear();
+  void Clear() {
+    if (++epoch_ == 0) Reset();
+  }
+
+  int length() const { return length_; }
 
   static const int kAbsent = -2;
+  static const int kEntriesPerBucket = 2;
+  static const int kMinLength = 64;
+  static const int kMaxLength = 1 << 16;
 
  private:
-  DescriptorLookupCache() {
-    for (int i = 0; i < kLength; ++i) {
-      keys_[i].array = NULL;
-      keys_[i].name = NULL;
-      results_[i] = kAbsent;
-    }
-  }
+  // The length is rounded up to a power of two.
+  DescriptorLookupCache(Isolate* isolate, int length);
+  ~DescriptorLookupCache();
 
-  static int Hash(DescriptorArray* array, String* name) {
+  // Wipes all entries and starts over at the first epoch.  Used when the
+  // epoch counter wraps around.
+  void Reset();
+
+  int Hash(DescriptorArray* array, String* name) {
     // Uses only lower 32 bits if pointers are larger.
     uint32_t array_hash =
         static_cast<uint32_t>(reinterpret_cast<uintptr_t>(array)) >> 2;
     uint32_t name_hash =
         static_cast<uint32_t>(reinterpret_cast<uintptr_t>(name)) >> 2;
-    return (array_hash ^ name_hash) % kLength;
+    return (array_hash ^ name_hash) & mask_;
   }
 
-  static const int kLength = 64;
-  struct Key {
+  struct Entry {
     DescriptorArray* array;
     String* name;
+    int result;
+    uint32_t epoch;
   };
 
-  Key keys_[kLength];
-  int results_[kLength];
+  Counters* counters_;
+  int length_;
+  // Masks a hash to the index of the first entry of a bucket.
+  int mask_;
+  // Entries are only valid in the epoch they were added in.  Entries with
+  // epoch 0 are empty.
+  uint32_t epoch_;
+  Entry* entries_;
 
   friend class Isolate;
   DISALLOW_COPY_AND_ASSIGN(DescriptorLookupCache);
 };
 
 
+// Cache for code stubs, keyed by the stub key.  It sits in front of the
+// code stubs dictionary, so that asking repeatedly for the same stub does
+// not probe the dictionary each time.  Entries only point at code objects
+// and the cache is cleared before code can move.
+class CodeStubLookupCache {
+ public:
+  // Returns the cached code for the stub key, or NULL if it is not cached.
+  Code* Lookup(uint32_t key) {
+    int index = Hash(key);
+    if (keys_[index] == key) return codes_[index];
+    return NULL;
+  }
+
+  // Update an element in the cache.
+  void Update(uint32_t key, Code* code) {
+    int index = Hash(key);
+    keys_[index] = key;
+    codes_[index] = code;
+  }
+
+  // Clear the cache.
+  void Clear();
+
+ private:
+  CodeStubLookupCache() {
+    for (int i = 0; i < kLength; ++i) {
+      keys_[i] = kNoKey;
+      codes_[i] = NULL;
+    }
+  }
+
+  static int Hash(uint32_t key) {
+    // The minor key lives in the upper bits, so fold it onto the major key.
+    return (key ^ (key >> 6) ^ (key >> 12)) % kLength;
+  }
+
+  static const int kLength = 64;
+  // Stub keys are smis, so the top bit of a key is never set.
+  static const uint32_t kNoKey = 0xffffffffu;
+
+  uint32_t keys_[kLength];
+  Code* codes_[kLength];
+
+  friend class Isolate;
+  DISALLOW_COPY_AND_ASSIGN(CodeStubLookupCache);
+};
+
+
+// Cache for the answers of the instanceof stub, keyed by the map of the
+// object and the function.  It is probed and updated by generated code
+// only: the byte offset of the entry for (map, function) is
+// (map ^ function) & kOffsetMask in each of the three tables.  The entries
+// are not visited by the GC, so the cache is cleared before every GC and
+// whenever a prototype changes.
+class InstanceofCache {
+ public:
+  // Clear the cache.
+  void Clear() {
+    for (int i = 0; i < kLength; i++) functions_[i] = NULL;
+  }
+
+  static const int kLength = 16;
+  static const int kOffsetMask = (kLength - 1) << kPointerSizeLog2;
+
+ private:
+  InstanceofCache() {
+    for (int i = 0; i < kLength; i++) {
+      functions_[i] = NULL;
+      maps_[i] = NULL;
+      answers_[i] = NULL;
+    }
+  }
+
+  // Get the addresses of the tables.  Used in generated code to perform
+  // cache lookups.
+  Address functions_address() {
+    return reinterpret_cast<Address>(&functions_);
+  }
+
+  Address maps_address() {
+    return reinterpret_cast<Address>(&maps_);
+  }
+
+  Address answers_address() {
+    return reinterpret_cast<Address>(&answers_);
+  }
+
+  Object* functions_[kLength];
+  Object* maps_[kLength];
+  // Zero if the object is an instance of the function, non-zero otherwise.
+  Object* answers_[kLength];
+
+  friend class ExternalReference;
+  friend class Isolate;
+  DISALLOW_COPY_AND_ASSIGN(InstanceofCache);
+};
+
+
 // A helper class to document/test C++ scopes where we do not
 // expect a GC. Usage:
 //
@@ -2315,6 +2756,9 @@ class GCTracer BASE_EMBEDDED {
       MC_UPDATE_POINTERS_BETWEEN_EVACUATED,
       MC_UPDATE_MISC_POINTERS,
       MC_FLUSH_CODE,
+      MC_WEAK_PROCESSING,
+      SCAVENGER_ROOTS,
+      SCAVENGER_WEAK_PROCESSING,
       kNumberOfScopes
     };
 
@@ -2351,6 +2795,10 @@ class GCTracer BASE_EMBEDDED {
     promoted_objects_size_ += object_size;
   }
 
+  void increment_deduplicated_strings_size(intptr_t size) {
+    deduplicated_strings_size_ += size;
+  }
+
  private:
   // Returns a string matching the collector.
   const char* CollectorString();
@@ -2360,6 +2808,13 @@ class GCTracer BASE_EMBEDDED {
     return (static_cast<double>(HEAP->SizeOfObjects())) / MB;
   }
 
+  // Reports the collection to the GC event callback and histograms.
+  void ReportEvent(double pause_time);
+
+  // Whether this collection is timed at all. Timing is needed for tracing
+  // flags, the GC event callback and histograms.
+  bool enabled_;
+
   double start_time_;  // Timestamp set in the constructor.
   intptr_t start_size_;  // Size of objects in heap set in constructor.
   GarbageCollector collector_;  // Type of collector.
@@ -2389,25 +2844,41 @@ class GCTracer BASE_EMBEDDED {
   // Size of objects promoted during the current collection.
   intptr_t promoted_objects_size_;
 
+  // Size of the strings that died because --string-dedup made their
+  // references point to an equal string.
+  intptr_t deduplicated_strings_size_;
+
   // Incremental marking steps counters.
   int steps_count_;
   double steps_took_;
   double longest_step_;
   int steps_count_since_last_gc_;
   double steps_took_since_last_gc_;
+  int64_t steps_bytes_;
+  intptr_t biggest_step_bytes_;
 
   Heap* heap_;
 };
 
 
+// Cache of the parts of unlimited splits of symbols.  The pattern is the
+// separator symbol, or the data of the separator regexp, which regexps with
+// the same source and flags share.  The cached parts are copy-on-write, so
+// a hit only allocates the JSArray that holds them.
 class StringSplitCache {
  public:
-  static Object* Lookup(FixedArray* cache, String* string, String* pattern);
+  // Returns the cached parts, or Smi 0.  For a regexp pattern, *last_match
+  // is set to the registers of the last match as a FixedArray of smis.
+  static Object* Lookup(FixedArray* cache,
+                        String* string,
+                        Object* pattern,
+                        Object** last_match = NULL);
   static void Enter(Heap* heap,
                     FixedArray* cache,
                     String* string,
-                    String* pattern,
-                    FixedArray* array);
+                    Object* pattern,
+                    FixedArray* array,
+                    Object* last_match = Smi::FromInt(0));
   static void Clear(FixedArray* cache);
   static const int kStringSplitCacheSize = 0x100;
 
@@ -2416,8 +2887,35 @@ class StringSplitCache {
   static const int kStringOffset = 0;
   static const int kPatternOffset = 1;
   static const int kArrayOffset = 2;
+  static const int kLastMatchOffset = 3;
+
+  static void Set(FixedArray* cache,
+                  int index,
+                  Object* string,
+                  Object* pattern,
+                  Object* array,
+                  Object* last_match);
+};
 
-  static MaybeObject* WrapFixedArrayInJSArray(Object* fixed_array);
+
+// Cache of descriptor arrays that only describe fields.  Such arrays do not
+// refer to anything specific to a global context, so maps of identically
+// shaped objects can share them even when the maps themselves belong to
+// different contexts.
+class FieldDescriptorsCache {
+ public:
+  // Returns a cached descriptor array with the same contents as descriptors
+  // if there is one.  Otherwise descriptors is entered in the cache, if it
+  // can be shared, and returned.
+  static DescriptorArray* Share(FixedArray* cache,
+                                DescriptorArray* descriptors);
+  static void Clear(FixedArray* cache);
+  static const int kFieldDescriptorsCacheSize = 0x80;
+
+ private:
+  static bool IsShareable(DescriptorArray* descriptors);
+  static uint32_t Hash(DescriptorArray* descriptors);
+  static bool Equals(DescriptorArray* a, DescriptorArray* b);
 };
 
 
@@ -745,6 +745,12 @@ void HUnaryMathOperation::PrintDataTo(StringStream* stream) {
 }
 
 
+void HMathMinMax::PrintDataTo(StringStream* stream) {
+  stream->Add(operation_ == kMathMin ? "min " : "max ");
+  HArithmeticBinaryOperation::PrintDataTo(stream);
+}
+
+
 void HUnaryOperation::PrintDataTo(StringStream* stream) {
   value()->PrintNameTo(stream);
 }
@@ -1031,6 +1037,22 @@ Range* HDiv::InferRange() {
 }
 
 
+Range* HMathMinMax::InferRange() {
+  if (representation().IsInteger32()) {
+    Range* a = left()->range();
+    Range* b = right()->range();
+    Range* result = (operation_ == kMathMax)
+        ? new Range(Max(a->lower(), b->lower()), Max(a->upper(), b->upper()))
+        : new Range(Min(a->lower(), b->lower()), Min(a->upper(), b->upper()));
+    result->set_can_be_minus_zero(a->CanBeMinusZero() ||
+                                  b->CanBeMinusZero());
+    return result;
+  } else {
+    return HValue::InferRange();
+  }
+}
+
+
 Range* HMod::InferRange() {
   if (representation().IsInteger32()) {
     Range* a = left()->range();
@@ -1154,6 +1176,21 @@ void HSimulate::PrintDataTo(StringStream* stream) {
 }
 
 
+void HCapturedObject::PrintDataTo(StringStream* stream) {
+  for (int i = 0; i < values_.length(); ++i) {
+    if (i > 0) stream->Add(" ");
+    values_[i]->PrintNameTo(stream);
+  }
+}
+
+
+void HStoreCapturedField::PrintDataTo(StringStream* stream) {
+  object()->PrintNameTo(stream);
+  stream->Add("[%d] = ", index());
+  value()->PrintNameTo(stream);
+}
+
+
 void HDeoptimize::PrintDataTo(StringStream* stream) {
   if (OperandCount() == 0) return;
   OperandAt(0)->PrintNameTo(stream);
@@ -1372,7 +1409,8 @@ void HParameter::PrintDataTo(StringStream* stream) {
 
 void HLoadNamedField::PrintDataTo(StringStream* stream) {
   object()->PrintNameTo(stream);
-  stream->Add(" @%d%s", offset(), is_in_object() ? "[in-object]" : "");
+  stream->Add(" @%d%s%s", offset(), is_in_object() ? "[in-object]" : "",
+              is_double_field() ? "[double]" : "");
 }
 
 
@@ -1396,6 +1434,9 @@ HLoadNamedFieldPolymorphic::HLoadNamedFieldPolymorphic(HValue* context,
     if (lookup.IsProperty()) {
       switch (lookup.type()) {
         case FIELD: {
+          // Double and mixed fields hold mutable heap numbers, which only
+          // the IC copies.
+          if (lookup.GetFieldRepresentation() != TAGGED_FIELD) break;
           int index = lookup.GetLocalFieldIndexFromMap(*map);
           if (index < 0) {
             SetFlag(kDependsOnInobjectFields);
@@ -1551,13 +1592,29 @@ void HStoreNamedField::PrintDataTo(StringStream* stream) {
   stream->Add(*String::cast(*name())->ToCString());
   stream->Add(" = ");
   value()->PrintNameTo(stream);
-  stream->Add(" @%d%s", offset(), is_in_object() ? "[in-object]" : "");
+  stream->Add(" @%d%s%s", offset(), is_in_object() ? "[in-object]" : "",
+              is_double_field() ? "[double]" : "");
   if (!transition().is_null()) {
     stream->Add(" (transition map %p)", *transition());
   }
 }
 
 
+bool HStoreNamedField::InitializesNewObject() {
+  if (!object()->IsAllocateObject()) return false;
+  for (HInstruction* instr = previous();
+       instr != object();
+       instr = instr->previous()) {
+    if (instr == NULL ||
+        !instr->IsStoreNamedField() ||
+        HStoreNamedField::cast(instr)->object() != object()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
 void HStoreKeyedFastElement::PrintDataTo(StringStream* stream) {
   object()->PrintNameTo(stream);
   stream->Add("[");
@@ -1576,6 +1633,20 @@ void HStoreKeyedFastDoubleElement::PrintDataTo(StringStream* stream) {
 }
 
 
+void HFastDoubleArrayMap::PrintDataTo(StringStream* stream) {
+  target()->PrintNameTo(stream);
+  stream->Add("[");
+  start()->PrintNameTo(stream);
+  stream->Add("..");
+  limit()->PrintNameTo(stream);
+  stream->Add("] = ");
+  left()->PrintNameTo(stream);
+  stream->Add(left_is_array() ? "[] %s " : " %s ", Token::String(op()));
+  right()->PrintNameTo(stream);
+  if (right_is_array()) stream->Add("[]");
+}
+
+
 void HStoreKeyedGeneric::PrintDataTo(StringStream* stream) {
   object()->PrintNameTo(stream);
   stream->Add("[");
@@ -1792,11 +1863,23 @@ HType HArrayLiteral::CalculateInferredType() {
 }
 
 
-HType HObjectLiteralFast::CalculateInferredType() {
+HType HAllocateObject::CalculateInferredType() {
   return HType::JSObject();
 }
 
 
+HType HObjectLiteralFast::CalculateInferredType() {
+  return boilerplate_->IsJSArray() ? HType::JSArray() : HType::JSObject();
+}
+
+
+bool HObjectLiteralFast::copies_elements() const {
+  FixedArrayBase* elements = boilerplate_->elements();
+  return elements->length() > 0 &&
+      elements->map() != HEAP->fixed_cow_array_map();
+}
+
+
 HType HObjectLiteralGeneric::CalculateInferredType() {
   return HType::JSObject();
 }
@@ -33,6 +33,7 @@
 #include "allocation.h"
 #include "code-stubs.h"
 #include "data-flow.h"
+#include "optimizing-compiler-thread.h"
 #include "small-pointer-list.h"
 #include "string-stream.h"
 #include "v8conversions.h"
@@ -62,6 +63,7 @@ class LChunkBuilder;
   V(AbnormalExit)                              \
   V(AccessArgumentsAt)                         \
   V(Add)                                       \
+  V(AllocateObject)                            \
   V(ApplyArguments)                            \
   V(ArgumentsElements)                         \
   V(ArgumentsLength)                           \
@@ -81,6 +83,7 @@ class LChunkBuilder;
   V(CallNew)                                   \
   V(CallRuntime)                               \
   V(CallStub)                                  \
+  V(CapturedObject)                            \
   V(Change)                                    \
   V(CheckFunction)                             \
   V(CheckInstanceType)                         \
@@ -97,11 +100,13 @@ class LChunkBuilder;
   V(CompareConstantEqAndBranch)                \
   V(Constant)                                  \
   V(Context)                                   \
+  V(DateField)                                 \
   V(DeleteProperty)                            \
   V(Deoptimize)                                \
   V(Div)                                       \
   V(ElementsKind)                              \
   V(EnterInlined)                              \
+  V(FastDoubleArrayMap)                        \
   V(FixedArrayBaseLength)                      \
   V(ForceRepresentation)                       \
   V(FunctionLiteral)                           \
@@ -137,6 +142,7 @@ class LChunkBuilder;
   V(LoadNamedField)                            \
   V(LoadNamedFieldPolymorphic)                 \
   V(LoadNamedGeneric)                          \
+  V(MathMinMax)                                \
   V(Mod)                                       \
   V(Mul)                                       \
   V(ObjectLiteralFast)                         \
@@ -154,6 +160,7 @@ class LChunkBuilder;
   V(Simulate)                                  \
   V(SoftDeoptimize)                            \
   V(StackCheck)                                \
+  V(StoreCapturedField)                        \
   V(StoreContextSlot)                          \
   V(StoreGlobalCell)                           \
   V(StoreGlobalGeneric)                        \
@@ -166,6 +173,7 @@ class LChunkBuilder;
   V(StringAdd)                                 \
   V(StringCharCodeAt)                          \
   V(StringCharFromCode)                        \
+  V(StringHashField)                           \
   V(StringLength)                              \
   V(Sub)                                       \
   V(ThisFunction)                              \
@@ -555,7 +563,8 @@ class HValue: public ZoneObject {
              type_(HType::Tagged()),
              use_list_(NULL),
              range_(NULL),
-             flags_(0) {}
+             flags_(0),
+             is_uint32_(false) {}
   virtual ~HValue() {}
 
   HBasicBlock* block() const { return block_; }
@@ -567,6 +576,12 @@ class HValue: public ZoneObject {
   HUseIterator uses() const { return HUseIterator(use_list_); }
 
   virtual bool EmitAtUses() { return false; }
+
+  // An instruction is deletable if computing its value has no effect
+  // other than possibly deoptimizing, so it can be dropped when the value
+  // is not needed (see HDeadCodeEliminator).
+  virtual bool IsDeletable() { return false; }
+
   Representation representation() const { return representation_; }
   void ChangeRepresentation(Representation r) {
     // Representation was already set and is allowed to be changed.
@@ -621,6 +636,12 @@ class HValue: public ZoneObject {
   void ClearFlag(Flag f) { flags_ &= ~(1 << f); }
   bool CheckFlag(Flag f) const { return (flags_ & (1 << f)) != 0; }
 
+  // An Integer32 value whose bits are to be read as an unsigned integer,
+  // see HUint32Analysis.  This is not a flag because all flag bits are
+  // taken.
+  bool IsUint32() const { return is_uint32_; }
+  void SetUint32() { is_uint32_ = true; }
+
   void SetAllSideEffects() { flags_ |= AllSideEffects(); }
   void ClearAllSideEffects() { flags_ &= ~AllSideEffects(); }
   bool HasSideEffects() const { return (flags_ & AllSideEffects()) != 0; }
@@ -734,6 +755,7 @@ class HValue: public ZoneObject {
   HUseListNode* use_list_;
   Range* range_;
   int flags_;
+  bool is_uint32_;
 
   DISALLOW_COPY_AND_ASSIGN(HValue);
 };
@@ -1144,6 +1166,11 @@ class HChange: public HUnaryOperation {
 
   virtual void PrintDataTo(StringStream* stream);
 
+  // Conversions from tagged values double as type checks.
+  virtual bool IsDeletable() {
+    return !from().IsTagged() || value()->type().IsSmi();
+  }
+
   DECLARE_CONCRETE_INSTRUCTION(Change)
 
  protected:
@@ -1307,18 +1334,31 @@ class HStackCheck: public HTemplateInstruction<1> {
 class HEnterInlined: public HTemplateInstruction<0> {
  public:
   HEnterInlined(Handle<JSFunction> closure,
+                int arguments_count,
                 FunctionLiteral* function,
-                CallKind call_kind)
+                CallKind call_kind,
+                bool dynamic_closure)
       : closure_(closure),
+        arguments_count_(arguments_count),
         function_(function),
-        call_kind_(call_kind) {
+        call_kind_(call_kind),
+        dynamic_closure_(dynamic_closure),
+        arguments_pushed_(false) {
   }
 
   virtual void PrintDataTo(StringStream* stream);
 
   Handle<JSFunction> closure() const { return closure_; }
+  int arguments_count() const { return arguments_count_; }
   FunctionLiteral* function() const { return function_; }
   CallKind call_kind() const { return call_kind_; }
+  bool dynamic_closure() const { return dynamic_closure_; }
+
+  // The arguments of the call, without the receiver, are pushed on the
+  // stack after entering the inlined function when it accesses them by a
+  // variable index.  Leaving the function drops them again.
+  bool arguments_pushed() const { return arguments_pushed_; }
+  void set_arguments_pushed() { arguments_pushed_ = true; }
 
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::None();
@@ -1328,8 +1368,11 @@ class HEnterInlined: public HTemplateInstruction<0> {
 
  private:
   Handle<JSFunction> closure_;
+  int arguments_count_;
   FunctionLiteral* function_;
   CallKind call_kind_;
+  bool dynamic_closure_;
+  bool arguments_pushed_;
 };
 
 
@@ -1673,6 +1716,36 @@ class HCallNew: public HBinaryCall {
 };
 
 
+// Allocates an object with the initial map of a constructor whose
+// specialized construct stub only stores arguments and constants into
+// in-object properties.  All in-object properties start out undefined;
+// the stores of the constructor follow as HStoreNamedField instructions.
+class HAllocateObject: public HTemplateInstruction<1> {
+ public:
+  HAllocateObject(HValue* context, Handle<JSFunction> constructor)
+      : constructor_(constructor),
+        initial_map_(constructor->initial_map()) {
+    SetOperandAt(0, context);
+    set_representation(Representation::Tagged());
+  }
+
+  HValue* context() { return OperandAt(0); }
+  Handle<JSFunction> constructor() const { return constructor_; }
+  Handle<Map> initial_map() const { return initial_map_; }
+
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::Tagged();
+  }
+  virtual HType CalculateInferredType();
+
+  DECLARE_CONCRETE_INSTRUCTION(AllocateObject)
+
+ private:
+  Handle<JSFunction> constructor_;
+  Handle<Map> initial_map_;
+};
+
+
 class HCallRuntime: public HCall<1> {
  public:
   HCallRuntime(HValue* context,
@@ -1724,6 +1797,8 @@ class HJSArrayLength: public HTemplateInstruction<2> {
   HValue* value() { return OperandAt(0); }
   HValue* typecheck() { return OperandAt(1); }
 
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(JSArrayLength)
 
  protected:
@@ -1743,6 +1818,10 @@ class HFixedArrayBaseLength: public HUnaryOperation {
     return Representation::Tagged();
   }
 
+  virtual HType CalculateInferredType() { return HType::Smi(); }
+
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(FixedArrayBaseLength)
 
  protected:
@@ -1782,6 +1861,8 @@ class HBitNot: public HUnaryOperation {
   }
   virtual HType CalculateInferredType();
 
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(BitNot)
 
  protected:
@@ -1851,10 +1932,10 @@ class HUnaryMathOperation: public HTemplateInstruction<2> {
   }
 
   virtual HValue* Canonicalize() {
-    // If the input is integer32 then we replace the floor instruction
-    // with its inputs.  This happens before the representation changes are
-    // introduced.
-    if (op() == kMathFloor) {
+    // If the input is integer32 then we replace the floor and round
+    // instructions with their inputs.  This happens before the
+    // representation changes are introduced.
+    if (op() == kMathFloor || op() == kMathRound) {
       if (value()->representation().IsInteger32()) return value();
     }
     return this;
@@ -1863,6 +1944,8 @@ class HUnaryMathOperation: public HTemplateInstruction<2> {
   BuiltinFunctionId op() const { return op_; }
   const char* OpName() const;
 
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(UnaryMathOperation)
 
  protected:
@@ -2264,18 +2347,136 @@ class HPhi: public HValue {
 };
 
 
-class HArgumentsObject: public HTemplateInstruction<0> {
+// The arguments object, which is not allocated as long as it is only used
+// for its length and elements.  The arguments object of the optimized
+// function itself is reconstructed from the stack frame when deoptimizing.
+// That of an inlined call has the arguments of the call as its operands
+// and is materialized from them.
+class HArgumentsObject: public HInstruction {
  public:
-  HArgumentsObject() {
+  HArgumentsObject() : values_(0) {
     set_representation(Representation::Tagged());
     SetFlag(kIsArguments);
   }
 
+  HArgumentsObject(Handle<JSFunction> closure, int arguments_count)
+      : closure_(closure), values_(arguments_count) {
+    set_representation(Representation::Tagged());
+    SetFlag(kIsArguments);
+  }
+
+  void AddArgument(HValue* value) {
+    values_.Add(NULL);
+    // Set the operand through the base method in HValue to make sure that
+    // the use lists are correctly updated.
+    SetOperandAt(values_.length() - 1, value);
+  }
+
+  bool is_inlined() const { return !closure_.is_null(); }
+  Handle<JSFunction> closure() const { return closure_; }
+  int arguments_count() const { return values_.length(); }
+  HValue* argument(int index) const { return values_[index]; }
+
+  virtual int OperandCount() { return values_.length(); }
+  virtual HValue* OperandAt(int index) { return values_[index]; }
+
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::None();
   }
 
   DECLARE_CONCRETE_INSTRUCTION(ArgumentsObject)
+
+ protected:
+  virtual void InternalSetOperandAt(int index, HValue* value) {
+    values_[index] = value;
+  }
+
+ private:
+  Handle<JSFunction> closure_;
+  ZoneList<HValue*> values_;
+};
+
+
+// An object literal removed by escape analysis.  It generates no code; a
+// deoptimization materializes a copy of the boilerplate object from the
+// current values of its in-object fields.  The operands are the initial
+// field values, HStoreCapturedField instructions change them as the
+// Lithium builder passes the stores.
+class HCapturedObject: public HInstruction {
+ public:
+  HCapturedObject(Handle<JSObject> boilerplate, int field_count)
+      : boilerplate_(boilerplate),
+        values_(field_count),
+        current_values_(field_count) {
+    set_representation(Representation::Tagged());
+  }
+
+  Handle<JSObject> boilerplate() const { return boilerplate_; }
+  int field_count() const { return values_.length(); }
+
+  void AddInitialValue(HValue* value) {
+    values_.Add(NULL);
+    // Set the operand through the base method in HValue to make sure that
+    // the use lists are correctly updated.
+    SetOperandAt(values_.length() - 1, value);
+  }
+
+  // The field values at the point the Lithium builder has reached.
+  void ResetCurrentValues() {
+    current_values_.Rewind(0);
+    current_values_.AddAll(values_);
+  }
+  HValue* current_value(int index) const { return current_values_[index]; }
+  void set_current_value(int index, HValue* value) {
+    current_values_[index] = value;
+  }
+
+  virtual int OperandCount() { return values_.length(); }
+  virtual HValue* OperandAt(int index) { return values_[index]; }
+
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::None();
+  }
+  virtual void PrintDataTo(StringStream* stream);
+
+  DECLARE_CONCRETE_INSTRUCTION(CapturedObject)
+
+ protected:
+  virtual void InternalSetOperandAt(int index, HValue* value) {
+    values_[index] = value;
+  }
+
+ private:
+  Handle<JSObject> boilerplate_;
+  ZoneList<HValue*> values_;
+  ZoneList<HValue*> current_values_;
+};
+
+
+// A store to an in-object field of an HCapturedObject.  It generates no
+// code and only changes the field value used by later deoptimization
+// environments.
+class HStoreCapturedField: public HTemplateInstruction<2> {
+ public:
+  HStoreCapturedField(HCapturedObject* object, int index, HValue* value)
+      : index_(index) {
+    SetOperandAt(0, object);
+    SetOperandAt(1, value);
+  }
+
+  HCapturedObject* object() { return HCapturedObject::cast(OperandAt(0)); }
+  HValue* value() { return OperandAt(1); }
+  int index() const { return index_; }
+
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::None();
+  }
+  virtual void PrintDataTo(StringStream* stream);
+
+  DECLARE_CONCRETE_INSTRUCTION(StoreCapturedField)
+
+ private:
+  int index_;
 };
 
 
@@ -2340,7 +2541,7 @@ class HConstant: public HTemplateInstruction<0> {
   bool ToBoolean() const;
 
   virtual intptr_t Hashcode() {
-    ASSERT(!HEAP->allow_allocation(false));
+    ASSERT_ALLOCATION_DISABLED;
     return reinterpret_cast<intptr_t>(*handle());
   }
 
@@ -2433,13 +2634,19 @@ class HApplyArguments: public HTemplateInstruction<4> {
 
 class HArgumentsElements: public HTemplateInstruction<0> {
  public:
-  HArgumentsElements() {
+  // The elements of an inlined call are the arguments pushed right before
+  // this instruction, instead of those in the frame or the adaptor frame
+  // below it.
+  explicit HArgumentsElements(bool from_inlined)
+      : from_inlined_(from_inlined) {
     // The value produced by this instruction is a pointer into the stack
     // that looks as if it was a smi because of alignment.
     set_representation(Representation::Tagged());
-    SetFlag(kUseGVN);
+    if (!from_inlined) SetFlag(kUseGVN);
   }
 
+  bool from_inlined() const { return from_inlined_; }
+
   DECLARE_CONCRETE_INSTRUCTION(ArgumentsElements)
 
   virtual Representation RequiredInputRepresentation(int index) {
@@ -2448,6 +2655,9 @@ class HArgumentsElements: public HTemplateInstruction<0> {
 
  protected:
   virtual bool DataEquals(HValue* other) { return true; }
+
+ private:
+  bool from_inlined_;
 };
 
 
@@ -2549,6 +2759,8 @@ class HBitwiseBinaryOperation: public HBinaryOperation {
 
   virtual HType CalculateInferredType();
 
+  virtual bool IsDeletable() { return !HasObservableSideEffects(); }
+
   DECLARE_ABSTRACT_INSTRUCTION(BitwiseBinaryOperation)
 };
 
@@ -2582,6 +2794,8 @@ class HArithmeticBinaryOperation: public HBinaryOperation {
     }
     return HValue::InferredRepresentation();
   }
+
+  virtual bool IsDeletable() { return !HasObservableSideEffects(); }
 };
 
 
@@ -3103,13 +3317,25 @@ class HMod: public HArithmeticBinaryOperation {
 class HDiv: public HArithmeticBinaryOperation {
  public:
   HDiv(HValue* context, HValue* left, HValue* right)
-      : HArithmeticBinaryOperation(context, left, right) {
+      : HArithmeticBinaryOperation(context, left, right),
+        all_uses_truncating_(false) {
     SetFlag(kCanBeDivByZero);
     SetFlag(kCanOverflow);
   }
 
   virtual HValue* EnsureAndPropagateNotMinusZero(BitVector* visited);
 
+  // An integer division whose uses all truncate to int32, like x / y | 0,
+  // does not have to deoptimize on a remainder.
+  bool all_uses_truncating() const { return all_uses_truncating_; }
+  void ChangeToTruncatingInteger32Division() {
+    ASSERT(representation().IsDouble());
+    SetFlag(kFlexibleRepresentation);
+    ChangeRepresentation(Representation::Integer32());
+    ClearFlag(kFlexibleRepresentation);
+    all_uses_truncating_ = true;
+  }
+
 
   static HInstruction* NewHDiv(Zone* zone,
                                HValue* context,
@@ -3119,9 +3345,50 @@ class HDiv: public HArithmeticBinaryOperation {
   DECLARE_CONCRETE_INSTRUCTION(Div)
 
  protected:
-  virtual bool DataEquals(HValue* other) { return true; }
+  virtual bool DataEquals(HValue* other) {
+    return all_uses_truncating_ == HDiv::cast(other)->all_uses_truncating_;
+  }
 
   virtual Range* InferRange();
+
+ private:
+  bool all_uses_truncating_;
+};
+
+
+class HMathMinMax: public HArithmeticBinaryOperation {
+ public:
+  enum Operation { kMathMin, kMathMax };
+
+  HMathMinMax(HValue* context, HValue* left, HValue* right, Operation op)
+      : HArithmeticBinaryOperation(context, left, right),
+        operation_(op) { }
+
+  virtual Representation InferredRepresentation() {
+    if (left()->representation().IsInteger32() &&
+        right()->representation().IsInteger32()) {
+      return Representation::Integer32();
+    }
+    return Representation::Double();
+  }
+
+  virtual bool IsCommutative() const { return true; }
+
+  Operation operation() { return operation_; }
+
+  virtual void PrintDataTo(StringStream* stream);
+
+  DECLARE_CONCRETE_INSTRUCTION(MathMinMax)
+
+ protected:
+  virtual bool DataEquals(HValue* other) {
+    return HMathMinMax::cast(other)->operation_ == operation_;
+  }
+
+  virtual Range* InferRange();
+
+ private:
+  Operation operation_;
 };
 
 
@@ -3315,7 +3582,7 @@ class HLoadGlobalCell: public HTemplateInstruction<0> {
   virtual void PrintDataTo(StringStream* stream);
 
   virtual intptr_t Hashcode() {
-    ASSERT(!HEAP->allow_allocation(false));
+    ASSERT_ALLOCATION_DISABLED;
     return reinterpret_cast<intptr_t>(*cell_);
   }
 
@@ -3510,6 +3777,7 @@ class HLoadNamedField: public HUnaryOperation {
   HLoadNamedField(HValue* object, bool is_in_object, int offset)
       : HUnaryOperation(object),
         is_in_object_(is_in_object),
+        is_double_field_(false),
         offset_(offset) {
     set_representation(Representation::Tagged());
     SetFlag(kUseGVN);
@@ -3525,21 +3793,33 @@ class HLoadNamedField: public HUnaryOperation {
   bool is_in_object() const { return is_in_object_; }
   int offset() const { return offset_; }
 
+  // A double field holds a mutable heap number, whose value is loaded.
+  bool is_double_field() const { return is_double_field_; }
+  void set_double_field() {
+    is_double_field_ = true;
+    set_representation(Representation::Double());
+  }
+
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::Tagged();
   }
   virtual void PrintDataTo(StringStream* stream);
 
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(LoadNamedField)
 
  protected:
   virtual bool DataEquals(HValue* other) {
     HLoadNamedField* b = HLoadNamedField::cast(other);
-    return is_in_object_ == b->is_in_object_ && offset_ == b->offset_;
+    return is_in_object_ == b->is_in_object_ &&
+        is_double_field_ == b->is_double_field_ &&
+        offset_ == b->offset_;
   }
 
  private:
   bool is_in_object_;
+  bool is_double_field_;
   int offset_;
 };
 
@@ -3651,6 +3931,8 @@ class HLoadKeyedFastElement: public HTemplateInstruction<2> {
 
   bool RequiresHoleCheck();
 
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(LoadKeyedFastElement)
 
  protected:
@@ -3680,6 +3962,8 @@ class HLoadKeyedFastDoubleElement: public HTemplateInstruction<2> {
 
   virtual void PrintDataTo(StringStream* stream);
 
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(LoadKeyedFastDoubleElement)
 
  protected:
@@ -3721,6 +4005,8 @@ class HLoadKeyedSpecializedArrayElement: public HTemplateInstruction<2> {
   HValue* key() { return OperandAt(1); }
   ElementsKind elements_kind() const { return elements_kind_; }
 
+  virtual bool IsDeletable() { return true; }
+
   DECLARE_CONCRETE_INSTRUCTION(LoadKeyedSpecializedArrayElement)
 
  protected:
@@ -3769,6 +4055,7 @@ class HStoreNamedField: public HTemplateInstruction<2> {
                    int offset)
       : name_(name),
         is_in_object_(in_object),
+        is_double_field_(false),
         offset_(offset) {
     SetOperandAt(0, obj);
     SetOperandAt(1, val);
@@ -3782,7 +4069,9 @@ class HStoreNamedField: public HTemplateInstruction<2> {
   DECLARE_CONCRETE_INSTRUCTION(StoreNamedField)
 
   virtual Representation RequiredInputRepresentation(int index) {
-    return Representation::Tagged();
+    return index == 1 && is_double_field_
+        ? Representation::Double()
+        : Representation::Tagged();
   }
   virtual void PrintDataTo(StringStream* stream);
 
@@ -3795,13 +4084,30 @@ class HStoreNamedField: public HTemplateInstruction<2> {
   Handle<Map> transition() const { return transition_; }
   void set_transition(Handle<Map> map) { transition_ = map; }
 
+  // A double field holds a mutable heap number, whose value is updated in
+  // place.  Storing undefined has to generalize the field instead.
+  bool is_double_field() const { return is_double_field_; }
+  void set_double_field() {
+    ASSERT(transition_.is_null());
+    is_double_field_ = true;
+    SetFlag(kDeoptimizeOnUndefined);
+  }
+
   bool NeedsWriteBarrier() {
-    return StoringValueNeedsWriteBarrier(value());
+    return !is_double_field_ &&
+        StoringValueNeedsWriteBarrier(value()) &&
+        !InitializesNewObject();
   }
 
+  // Whether the store initializes a field of an object allocated in new
+  // space right before it, with nothing that could allocate in between.
+  // Such an object cannot have been promoted or marked yet.
+  bool InitializesNewObject();
+
  private:
   Handle<String> name_;
   bool is_in_object_;
+  bool is_double_field_;
   int offset_;
   Handle<Map> transition_;
 };
@@ -3923,6 +4229,59 @@ class HStoreKeyedFastDoubleElement: public HTemplateInstruction<3> {
 };
 
 
+// Computes target[j] = left[j] op right[j] two elements at a time for j
+// starting at start, where left or right may also be a number that is
+// used for every element.  The kernel only runs over JSArrays with fast
+// double elements and stops at the first pair that would produce a NaN
+// (which covers holes) or run past limit or any array's length.  The
+// result is the index at which the remaining iterations have to continue.
+class HFastDoubleArrayMap: public HTemplateInstruction<5> {
+ public:
+  HFastDoubleArrayMap(HValue* target,
+                      HValue* left,
+                      HValue* right,
+                      HValue* start,
+                      HValue* limit,
+                      Token::Value op,
+                      bool left_is_array,
+                      bool right_is_array)
+      : op_(op),
+        left_is_array_(left_is_array),
+        right_is_array_(right_is_array) {
+    ASSERT(left_is_array || right_is_array);
+    SetOperandAt(0, target);
+    SetOperandAt(1, left);
+    SetOperandAt(2, right);
+    SetOperandAt(3, start);
+    SetOperandAt(4, limit);
+    set_representation(Representation::Tagged());
+    SetFlag(kChangesDoubleArrayElements);
+  }
+
+  HValue* target() { return OperandAt(0); }
+  HValue* left() { return OperandAt(1); }
+  HValue* right() { return OperandAt(2); }
+  HValue* start() { return OperandAt(3); }
+  HValue* limit() { return OperandAt(4); }
+  Token::Value op() const { return op_; }
+  bool left_is_array() const { return left_is_array_; }
+  bool right_is_array() const { return right_is_array_; }
+
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::Tagged();
+  }
+
+  virtual void PrintDataTo(StringStream* stream);
+
+  DECLARE_CONCRETE_INSTRUCTION(FastDoubleArrayMap)
+
+ private:
+  Token::Value op_;
+  bool left_is_array_;
+  bool right_is_array_;
+};
+
+
 class HStoreKeyedSpecializedArrayElement: public HTemplateInstruction<3> {
  public:
   HStoreKeyedSpecializedArrayElement(HValue* external_elements,
@@ -4119,6 +4478,24 @@ class HStringCharFromCode: public HTemplateInstruction<2> {
 };
 
 
+// The raw hash field of a string as an untagged integer: the hash shifted
+// left by String::kHashShift, and flags in the low bits that say whether it
+// has been computed yet.  It is not moved by GVN, since it is only valid
+// where the value is known to be a string.
+class HStringHashField: public HUnaryOperation {
+ public:
+  explicit HStringHashField(HValue* string) : HUnaryOperation(string) {
+    set_representation(Representation::Integer32());
+  }
+
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::Tagged();
+  }
+
+  DECLARE_CONCRETE_INSTRUCTION(StringHashField)
+};
+
+
 class HStringLength: public HUnaryOperation {
  public:
   explicit HStringLength(HValue* string) : HUnaryOperation(string) {
@@ -4205,7 +4582,8 @@ class HObjectLiteralFast: public HMaterializedLiteral<1> {
                      int depth)
       : HMaterializedLiteral<1>(literal_index, depth),
         boilerplate_(boilerplate),
-        total_size_(total_size) {
+        total_size_(total_size),
+        in_object_values_(NULL) {
     SetOperandAt(0, context);
   }
 
@@ -4218,6 +4596,22 @@ class HObjectLiteralFast: public HMaterializedLiteral<1> {
   Handle<JSObject> boilerplate() const { return boilerplate_; }
   int total_size() const { return total_size_; }
 
+  // Whether the elements of the boilerplate, which can only be those of a
+  // small array literal, are copied right after it.  The copy needs the
+  // boilerplate to still have the map it had when compiling, so the kind
+  // and length of its elements are the same.
+  bool copies_elements() const;
+
+  // The in-object property values of a boilerplate without nested objects
+  // or elements, recorded while building the graph for escape analysis.
+  // NULL for other boilerplates.
+  ZoneList<Handle<Object> >* in_object_values() const {
+    return in_object_values_;
+  }
+  void set_in_object_values(ZoneList<Handle<Object> >* values) {
+    in_object_values_ = values;
+  }
+
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::Tagged();
   }
@@ -4228,6 +4622,7 @@ class HObjectLiteralFast: public HMaterializedLiteral<1> {
  private:
   Handle<JSObject> boilerplate_;
   int total_size_;
+  ZoneList<Handle<Object> >* in_object_values_;
 };
 
 
@@ -4379,6 +4774,26 @@ class HValueOf: public HUnaryOperation {
 };
 
 
+class HDateField: public HUnaryOperation {
+ public:
+  HDateField(HValue* date, Smi* index)
+      : HUnaryOperation(date), index_(index) {
+    set_representation(Representation::Tagged());
+  }
+
+  Smi* index() const { return index_; }
+
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::Tagged();
+  }
+
+  DECLARE_CONCRETE_INSTRUCTION(DateField)
+
+ private:
+  Smi* index_;
+};
+
+
 class HDeleteProperty: public HBinaryOperation {
  public:
   HDeleteProperty(HValue* context, HValue* obj, HValue* key)
@@ -31,6 +31,7 @@
 #include "codegen.h"
 #include "full-codegen.h"
 #include "hashmap.h"
+#include "isolate-inl.h"
 #include "lithium-allocator.h"
 #include "parser.h"
 #include "scopeinfo.h"
@@ -612,11 +613,14 @@ void HBasicBlock::FinishExit(HControlInstruction* instruction) {
 
 HGraph::HGraph(CompilationInfo* info)
     : isolate_(info->isolate()),
+      info_(info),
       next_block_id_(0),
       entry_block_(NULL),
       blocks_(8),
       values_(16),
-      phi_list_(NULL) {
+      phi_list_(NULL),
+      dependent_cells_(0),
+      constant_cells_(0) {
   start_environment_ =
       new(zone()) HEnvironment(NULL, info->scope(), info->closure());
   start_environment_->set_ast_id(AstNode::kFunctionEntryId);
@@ -625,24 +629,65 @@ HGraph::HGraph(CompilationInfo* info)
 }
 
 
-Handle<Code> HGraph::Compile(CompilationInfo* info) {
+void HGraph::RecordDependentCell(Handle<JSGlobalPropertyCell> cell) {
+  for (int i = 0; i < dependent_cells_.length(); i++) {
+    if (dependent_cells_[i].is_identical_to(cell)) return;
+  }
+  dependent_cells_.Add(cell);
+}
+
+
+void HGraph::RecordConstantCell(Handle<JSGlobalPropertyCell> cell) {
+  ASSERT(cell->state() == JSGlobalPropertyCell::CONSTANT);
+  RecordDependentCell(cell);
+  for (int i = 0; i < constant_cells_.length(); i++) {
+    if (constant_cells_[i].is_identical_to(cell)) return;
+  }
+  constant_cells_.Add(cell);
+}
+
+
+bool HGraph::HasChangedConstantCells() const {
+  for (int i = 0; i < constant_cells_.length(); i++) {
+    if (constant_cells_[i]->state() != JSGlobalPropertyCell::CONSTANT) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+LChunk* HGraph::CreateChunk(CompilationInfo* info) {
   int values = GetMaximumValueID();
   if (values > LAllocator::max_initial_value_ids()) {
     if (FLAG_trace_bailout) PrintF("Function is too big\n");
-    return Handle<Code>::null();
+    info->set_bailout_reason("function is too big");
+    return NULL;
   }
 
   LAllocator allocator(values, this);
   LChunkBuilder builder(info, this, &allocator);
   LChunk* chunk = builder.Build();
-  if (chunk == NULL) return Handle<Code>::null();
+  if (chunk == NULL) return NULL;
 
-  if (!FLAG_alloc_lithium) return Handle<Code>::null();
+  if (!FLAG_alloc_lithium) return NULL;
 
   allocator.Allocate(chunk);
 
-  if (!FLAG_use_lithium) return Handle<Code>::null();
+  if (!FLAG_use_lithium) return NULL;
+
+  return chunk;
+}
+
+
+Handle<Code> HGraph::Compile(CompilationInfo* info) {
+  LChunk* chunk = CreateChunk(info);
+  if (chunk == NULL) return Handle<Code>::null();
+  return GenerateCode(chunk, info);
+}
+
 
+Handle<Code> HGraph::GenerateCode(LChunk* chunk, CompilationInfo* info) {
   MacroAssembler assembler(info->isolate(), NULL, 0);
   LCodeGen generator(chunk, &assembler, info);
 
@@ -1302,989 +1347,2776 @@ void HStackCheckEliminator::Process() {
 }
 
 
-// Simple sparse set with O(1) add, contains, and clear.
-class SparseSet {
+// Eliminates array bounds checks that are implied by other bounds checks or
+// by the loop condition of an induction variable, and hoists the upper bound
+// check of an induction variable with a loop-invariant limit out of its loop.
+class HBoundsCheckEliminator BASE_EMBEDDED {
  public:
-  SparseSet(Zone* zone, int capacity)
-      : capacity_(capacity),
-        length_(0),
-        dense_(zone->NewArray<int>(capacity)),
-        sparse_(zone->NewArray<int>(capacity)) {
-#ifndef NVALGRIND
-    // Initialize the sparse array to make valgrind happy.
-    memset(sparse_, 0, sizeof(sparse_[0]) * capacity);
-#endif
-  }
+  explicit HBoundsCheckEliminator(HGraph* graph)
+      : graph_(graph),
+        allow_hoisting_(FLAG_array_bounds_checks_hoisting &&
+                        graph->info()->shared_info()->opt_count() == 0),
+        ranges_(8),
+        hoisted_(4) { }
 
-  bool Contains(int n) const {
-    ASSERT(0 <= n && n < capacity_);
-    int d = sparse_[n];
-    return 0 <= d && d < length_ && dense_[d] == n;
+  void Process();
+
+ private:
+  // The range of offsets [lower_offset, upper_offset] from base that is
+  // known to be within the bounds given by length in the dominator subtree
+  // of block.  lower_check and upper_check are the checks establishing the
+  // two ends of the range.
+  struct CheckedRange {
+    HValue* base;
+    HValue* length;
+    int32_t lower_offset;
+    int32_t upper_offset;
+    HBoundsCheck* lower_check;
+    HBoundsCheck* upper_check;
+    HBasicBlock* block;
+  };
+
+  // An upper bound check hoisted into the pre-header of a loop.
+  struct HoistedCheck {
+    HBasicBlock* pre_header;
+    HValue* limit;
+    HValue* length;
+  };
+
+  void EliminateRedundantChecks(HBasicBlock* block);
+  void ProcessCheck(HBoundsCheck* check, HBasicBlock* block);
+  bool IsImpliedByLoopCondition(HBoundsCheck* check);
+  bool HoistOutOfLoop(HBoundsCheck* check);
+  void CoverCheck(HBoundsCheck* check,
+                  HValue* base,
+                  int32_t offset,
+                  HBasicBlock* block);
+  bool MoveIndexBefore(HValue* index, HInstruction* position);
+  void RemoveCheck(HBoundsCheck* check, const char* reason);
+
+  HGraph* graph_;
+  bool allow_hoisting_;
+  ZoneList<CheckedRange> ranges_;
+  ZoneList<HoistedCheck> hoisted_;
+};
+
+
+// Looks through representation changes that preserve the value, i.e. that
+// either produce the same number or deoptimize.
+static HValue* ActualValue(HValue* value) {
+  while (value->IsChange() && !value->CheckFlag(HValue::kTruncatingToInt32)) {
+    value = HChange::cast(value)->value();
   }
+  return value;
+}
 
-  bool Add(int n) {
-    if (Contains(n)) return false;
-    dense_[length_] = n;
-    sparse_[n] = length_;
-    ++length_;
-    return true;
+
+// Two loads of the length of the same array give the same value if nothing
+// in between can change the length.  Value numbering keeps them apart when
+// they depend on different type checks.
+static bool IsSameLength(HValue* a, HValue* b) {
+  a = ActualValue(a);
+  b = ActualValue(b);
+  if (a == b) return true;
+  if (!a->IsJSArrayLength() || !b->IsJSArrayLength()) return false;
+  if (HJSArrayLength::cast(a)->value() != HJSArrayLength::cast(b)->value() ||
+      a->block() != b->block()) {
+    return false;
   }
+  for (int i = 0; i < 2; i++) {
+    HInstruction* first = HInstruction::cast(i == 0 ? a : b);
+    HInstruction* second = HInstruction::cast(i == 0 ? b : a);
+    for (HInstruction* instr = first->next();
+         instr != NULL && !instr->CheckFlag(HValue::kChangesArrayLengths);
+         instr = instr->next()) {
+      if (instr == second) return true;
+    }
+  }
+  return false;
+}
 
-  void Clear() { length_ = 0; }
 
- private:
-  int capacity_;
-  int length_;
-  int* dense_;
-  int* sparse_;
+static bool DominatesOrEquals(HBasicBlock* dominator, HBasicBlock* block) {
+  return dominator == block || dominator->Dominates(block);
+}
 
-  DISALLOW_COPY_AND_ASSIGN(SparseSet);
-};
 
+static bool IsInteger32Constant(HValue* value, int32_t* result) {
+  if (!value->IsConstant()) return false;
+  HConstant* constant = HConstant::cast(value);
+  if (!constant->HasInteger32Value()) return false;
+  *result = constant->Integer32Value();
+  return true;
+}
 
-class HGlobalValueNumberer BASE_EMBEDDED {
- public:
-  explicit HGlobalValueNumberer(HGraph* graph, CompilationInfo* info)
-      : graph_(graph),
-        info_(info),
-        removed_side_effects_(false),
-        block_side_effects_(graph->blocks()->length()),
-        loop_side_effects_(graph->blocks()->length()),
-        visited_on_paths_(graph->zone(), graph->blocks()->length()) {
-    ASSERT(info->isolate()->heap()->allow_allocation(false));
-    block_side_effects_.AddBlock(0, graph_->blocks()->length());
-    loop_side_effects_.AddBlock(0, graph_->blocks()->length());
+
+// Splits an integer index into a base value and a constant offset.  Offsets
+// are kept small so that comparing and widening them cannot overflow.
+static void DecomposeIndex(HValue* index, HValue** base, int32_t* offset) {
+  static const int32_t kMaxOffset = 1 << 20;
+  int32_t constant;
+  *base = index;
+  *offset = 0;
+  if (!index->representation().IsInteger32()) return;
+  if (index->IsAdd()) {
+    HAdd* add = HAdd::cast(index);
+    if (IsInteger32Constant(add->right(), &constant)) {
+      *base = add->left();
+    } else if (IsInteger32Constant(add->left(), &constant)) {
+      *base = add->right();
+    } else {
+      return;
+    }
+  } else if (index->IsSub()) {
+    HSub* sub = HSub::cast(index);
+    if (!IsInteger32Constant(sub->right(), &constant)) return;
+    if (constant == kMinInt) return;
+    *base = sub->left();
+    constant = -constant;
+  } else {
+    return;
   }
-  ~HGlobalValueNumberer() {
-    ASSERT(!info_->isolate()->heap()->allow_allocation(true));
+  if (constant < -kMaxOffset || constant > kMaxOffset) {
+    *base = index;
+    return;
+  }
+  *offset = constant;
+}
+
+
+// Returns the constant a loop phi is incremented by on its back edge, or 0 if
+// the phi is not an induction variable of that form.  The integer addition
+// deoptimizes on overflow, so the values of the phi change monotonically.
+static int32_t InductionStep(HPhi* phi, HValue** update) {
+  if (!phi->block()->IsLoopHeader() ||
+      phi->OperandCount() != 2 ||
+      !phi->representation().IsInteger32()) {
+    return 0;
+  }
+  *update = phi->OperandAt(1);
+  HValue* base;
+  int32_t step;
+  DecomposeIndex(*update, &base, &step);
+  return base == phi ? step : 0;
+}
+
+
+// Finds the condition of the loop header of the given induction variable
+// that holds in block, in the form "phi token limit".  Returns false if
+// there is no such condition.
+static bool LoopCondition(HPhi* phi,
+                          HBasicBlock* block,
+                          Token::Value* token,
+                          HValue** limit) {
+  HBasicBlock* header = phi->block();
+  if (!header->end()->IsCompareIDAndBranch()) return false;
+  HCompareIDAndBranch* compare = HCompareIDAndBranch::cast(header->end());
+  // Negating a comparison is only valid in the absence of NaNs.
+  if (!compare->GetInputRepresentation().IsInteger32()) return false;
+  *token = compare->token();
+  HBasicBlock* true_successor = compare->SuccessorAt(0);
+  HBasicBlock* false_successor = compare->SuccessorAt(1);
+  if (true_successor->predecessors()->length() == 1 &&
+      DominatesOrEquals(true_successor, block)) {
+    // The condition holds.
+  } else if (false_successor->predecessors()->length() == 1 &&
+             DominatesOrEquals(false_successor, block)) {
+    *token = Token::NegateCompareOp(*token);
+  } else {
+    return false;
+  }
+  if (ActualValue(compare->left()) == phi) {
+    *limit = compare->right();
+  } else if (ActualValue(compare->right()) == phi) {
+    *limit = compare->left();
+    *token = Token::InvertCompareOp(*token);
+  } else {
+    return false;
   }
+  return true;
+}
 
-  // Returns true if values with side effects are removed.
-  bool Analyze();
 
- private:
-  int CollectSideEffectsOnPathsToDominatedBlock(HBasicBlock* dominator,
-                                                HBasicBlock* dominated);
-  void AnalyzeBlock(HBasicBlock* block, HValueMap* map);
-  void ComputeBlockSideEffects();
-  void LoopInvariantCodeMotion();
-  void ProcessLoopBlock(HBasicBlock* block,
-                        HBasicBlock* before_loop,
-                        int loop_kills);
-  bool AllowCodeMotion();
-  bool ShouldMove(HInstruction* instr, HBasicBlock* loop_header);
+void HBoundsCheckEliminator::RemoveCheck(HBoundsCheck* check,
+                                         const char* reason) {
+  if (FLAG_trace_bounds_check_elimination) {
+    PrintF("Removing bounds check %d (%s)\n", check->id(), reason);
+  }
+  check->DeleteAndReplaceWith(check->index());
+}
 
-  HGraph* graph() { return graph_; }
-  CompilationInfo* info() { return info_; }
-  Zone* zone() { return graph_->zone(); }
 
-  HGraph* graph_;
-  CompilationInfo* info_;
-  bool removed_side_effects_;
+// A check of an induction variable is redundant if the loop condition
+// bounds the variable by the checked length at one end and the variable
+// moves away from that end from a start value that is within bounds.
+bool HBoundsCheckEliminator::IsImpliedByLoopCondition(HBoundsCheck* check) {
+  HValue* index = ActualValue(check->index());
+  if (!index->IsPhi()) return false;
+  HPhi* phi = HPhi::cast(index);
+  HValue* update;
+  int32_t step = InductionStep(phi, &update);
+  if (step == 0) return false;
 
-  // A map of block IDs to their side effects.
-  ZoneList<int> block_side_effects_;
+  Token::Value token;
+  HValue* limit;
+  if (!LoopCondition(phi, check->block(), &token, &limit)) return false;
+  HValue* length = check->length();
+  HValue* initial = phi->OperandAt(0);
+  int32_t constant;
 
-  // A map of loop header block IDs to their loop's side effects.
-  ZoneList<int> loop_side_effects_;
+  if (step > 0) {
+    // for (i = start; i < length; i += step) with 0 <= start.
+    if (token != Token::LT || !IsSameLength(limit, length)) return false;
+    if (IsInteger32Constant(initial, &constant)) return constant >= 0;
+    return initial->HasRange() && initial->range()->lower() >= 0;
+  } else {
+    // for (i = length - c; i >= 0; i -= step) with 0 < c.
+    if (!IsInteger32Constant(limit, &constant)) return false;
+    if (!(token == Token::GTE && constant == 0) &&
+        !(token == Token::GT && constant == -1)) {
+      return false;
+    }
+    HValue* base;
+    int32_t offset;
+    DecomposeIndex(initial, &base, &offset);
+    return IsSameLength(base, length) && offset < 0;
+  }
+}
 
-  // Used when collecting side effects on paths from dominator to
-  // dominated.
-  SparseSet visited_on_paths_;
-};
 
+// Replaces the check of an induction variable i in a loop of the form
+// for (i = start; i < limit; i++) with 0 <= start, where both the limit and
+// the checked length are loop invariant, by the single check limit <= length
+// in the loop pre-header.  The hoisted check deoptimizes before the loop is
+// entered if the loop might run out of bounds, even if it would have left
+// the loop early; this is why hoisting is not repeated after a deopt.
+bool HBoundsCheckEliminator::HoistOutOfLoop(HBoundsCheck* check) {
+  if (!allow_hoisting_) return false;
+  HValue* index = ActualValue(check->index());
+  if (!index->IsPhi()) return false;
+  HPhi* phi = HPhi::cast(index);
+  HValue* update;
+  if (InductionStep(phi, &update) != 1) return false;
 
-bool HGlobalValueNumberer::Analyze() {
-  ComputeBlockSideEffects();
-  if (FLAG_loop_invariant_code_motion) {
-    LoopInvariantCodeMotion();
+  Token::Value token;
+  HValue* limit;
+  if (!LoopCondition(phi, check->block(), &token, &limit)) return false;
+  if (token != Token::LT || !limit->representation().IsInteger32()) {
+    return false;
   }
-  HValueMap* map = new(zone()) HValueMap();
-  AnalyzeBlock(graph_->entry_block(), map);
-  return removed_side_effects_;
+  HValue* initial = phi->OperandAt(0);
+  int32_t constant, hoisted_constant;
+  if (IsInteger32Constant(initial, &constant)) {
+    if (constant < 0) return false;
+  } else if (!initial->HasRange() || initial->range()->lower() < 0) {
+    return false;
+  }
+
+  // The check must be inside the loop and both bounds defined before it.
+  HBasicBlock* header = phi->block();
+  HBasicBlock* pre_header = header->predecessors()->at(0);
+  if (!header->loop_information()->blocks()->Contains(check->block())) {
+    return false;
+  }
+  HValue* length = check->length();
+  if (!DominatesOrEquals(length->block(), pre_header)) return false;
+  // Constants are materialized next to their uses and are copied.
+  bool copy_limit = !DominatesOrEquals(limit->block(), pre_header);
+  if (copy_limit && !limit->IsConstant()) return false;
+
+  for (int i = 0; i < hoisted_.length(); i++) {
+    HoistedCheck& hoisted = hoisted_[i];
+    if (hoisted.pre_header == pre_header &&
+        hoisted.length == length &&
+        (hoisted.limit == limit ||
+         (IsInteger32Constant(limit, &constant) &&
+          IsInteger32Constant(hoisted.limit, &hoisted_constant) &&
+          constant == hoisted_constant))) {
+      RemoveCheck(check, "hoisted");
+      return true;
+    }
+  }
+
+  if (copy_limit) {
+    HConstant* new_limit = HConstant::cast(limit)->CopyToRepresentation(
+        Representation::Integer32());
+    new_limit->InsertBefore(pre_header->end());
+    limit = new_limit;
+  }
+
+  // limit <= length is checked as limit < length + 1.  The constant 1 is
+  // taken from the increment so that no new handles are created here.
+  HAdd* increment = HAdd::cast(update);
+  HValue* one = increment->right()->IsConstant()
+      ? increment->right()
+      : increment->left();
+  Zone* zone = graph_->zone();
+  HConstant* new_one = HConstant::cast(one)->CopyToRepresentation(
+      Representation::Integer32());
+  new_one->InsertBefore(pre_header->end());
+  HAdd* new_length = new(zone) HAdd(increment->context(), length, new_one);
+  new_length->ChangeRepresentation(Representation::Integer32());
+  new_length->InsertBefore(pre_header->end());
+  HBoundsCheck* new_check = new(zone) HBoundsCheck(limit, new_length);
+  new_check->InsertBefore(pre_header->end());
+  HoistedCheck hoisted = { pre_header, limit, length };
+  hoisted_.Add(hoisted);
+  if (FLAG_trace_bounds_check_elimination) {
+    PrintF("Hoisting bounds check %d out of loop B%d as %d\n",
+           check->id(), header->block_id(), new_check->id());
+  }
+  RemoveCheck(check, "hoisted");
+  return true;
 }
 
 
-void HGlobalValueNumberer::ComputeBlockSideEffects() {
-  for (int i = graph_->blocks()->length() - 1; i >= 0; --i) {
-    // Compute side effects for the block.
-    HBasicBlock* block = graph_->blocks()->at(i);
-    HInstruction* instr = block->first();
-    int id = block->block_id();
-    int side_effects = 0;
-    while (instr != NULL) {
-      side_effects |= instr->ChangesFlags();
-      instr = instr->next();
+// Makes sure that index is computed before position, moving its
+// computation up within the block if needed.  This only ever moves a pure
+// addition or subtraction of a constant, whose base operand is known to be
+// available at position.
+bool HBoundsCheckEliminator::MoveIndexBefore(HValue* index,
+                                             HInstruction* position) {
+  if (index->block() != position->block()) return true;
+  HInstruction* instr = position->next();
+  while (instr != NULL && instr != index) instr = instr->next();
+  if (instr == NULL) return true;  // Already before position.
+  if (!index->IsAdd() && !index->IsSub()) return false;
+
+  HBinaryOperation* operation = index->IsAdd()
+      ? static_cast<HBinaryOperation*>(HAdd::cast(index))
+      : static_cast<HBinaryOperation*>(HSub::cast(index));
+  HValue* base;
+  int32_t offset;
+  DecomposeIndex(index, &base, &offset);
+  HValue* constant = (operation->left() == base)
+      ? operation->right()
+      : operation->left();
+  if (constant->block() == position->block()) {
+    HInstruction* constant_instr = HInstruction::cast(constant);
+    for (HInstruction* it = position->next(); it != NULL; it = it->next()) {
+      if (it == constant_instr) {
+        constant_instr->Unlink();
+        constant_instr->InsertBefore(position);
+        break;
+      }
     }
-    block_side_effects_[id] |= side_effects;
+  }
+  instr->Unlink();
+  instr->InsertBefore(position);
+  return true;
+}
 
-    // Loop headers are part of their loop.
-    if (block->IsLoopHeader()) {
-      loop_side_effects_[id] |= side_effects;
-    }
 
-    // Propagate loop side effects upwards.
-    if (block->HasParentLoopHeader()) {
-      int header_id = block->parent_loop_header()->block_id();
-      loop_side_effects_[header_id] |=
-          block->IsLoopHeader() ? loop_side_effects_[id] : side_effects;
+// Records that check covers base + offset, removing it if a dominating check
+// already does.  Two checks on base + a and base + b with a < b in the same
+// block cover everything in between, so further checks in the block widen
+// one of the two instead of adding a third.
+void HBoundsCheckEliminator::CoverCheck(HBoundsCheck* check,
+                                        HValue* base,
+                                        int32_t offset,
+                                        HBasicBlock* block) {
+  HValue* length = check->length();
+  int found = -1;
+  for (int i = ranges_.length() - 1; i >= 0; i--) {
+    if (ranges_[i].base == base && ranges_[i].length == length) {
+      found = i;
+      break;
     }
   }
-}
+  if (found == -1) {
+    CheckedRange range = { base, length, offset, offset, check, check, block };
+    ranges_.Add(range);
+    return;
+  }
 
+  CheckedRange* range = &ranges_[found];
+  if (range->lower_offset <= offset && offset <= range->upper_offset) {
+    RemoveCheck(check, "dominated");
+    return;
+  }
+  if (range->block != block) {
+    // Ranges inherited from a dominator are only extended in a copy, which
+    // is discarded when leaving this block.
+    CheckedRange copy = *range;
+    copy.block = block;
+    ranges_.Add(copy);
+    range = &ranges_.last();
+  }
+
+  bool upper = offset > range->upper_offset;
+  HBoundsCheck* widened = upper ? range->upper_check : range->lower_check;
+  if (widened->block() == block &&
+      range->lower_check != range->upper_check &&
+      MoveIndexBefore(check->index(), widened)) {
+    // Users of the widened check still refer to its original index.
+    widened->ReplaceAllUsesWith(widened->index());
+    widened->SetOperandAt(0, check->index());
+    RemoveCheck(check, "merged");
+  } else if (upper) {
+    range->upper_check = check;
+  } else {
+    range->lower_check = check;
+  }
+  if (upper) {
+    range->upper_offset = offset;
+  } else {
+    range->lower_offset = offset;
+  }
+}
 
-void HGlobalValueNumberer::LoopInvariantCodeMotion() {
-  for (int i = graph_->blocks()->length() - 1; i >= 0; --i) {
-    HBasicBlock* block = graph_->blocks()->at(i);
-    if (block->IsLoopHeader()) {
-      int side_effects = loop_side_effects_[block->block_id()];
-      TraceGVN("Try loop invariant motion for block B%d effects=0x%x\n",
-               block->block_id(),
-               side_effects);
 
-      HBasicBlock* last = block->loop_information()->GetLastBackEdge();
-      for (int j = block->block_id(); j <= last->block_id(); ++j) {
-        ProcessLoopBlock(graph_->blocks()->at(j), block, side_effects);
-      }
-    }
+void HBoundsCheckEliminator::ProcessCheck(HBoundsCheck* check,
+                                          HBasicBlock* block) {
+  if (IsImpliedByLoopCondition(check)) {
+    RemoveCheck(check, "loop condition");
+    return;
   }
+  if (HoistOutOfLoop(check)) return;
+  HValue* base;
+  int32_t offset;
+  DecomposeIndex(check->index(), &base, &offset);
+  CoverCheck(check, base, offset, block);
 }
 
 
-void HGlobalValueNumberer::ProcessLoopBlock(HBasicBlock* block,
-                                            HBasicBlock* loop_header,
-                                            int loop_kills) {
-  HBasicBlock* pre_header = loop_header->predecessors()->at(0);
-  int depends_flags = HValue::ConvertChangesToDependsFlags(loop_kills);
-  TraceGVN("Loop invariant motion for B%d depends_flags=0x%x\n",
-           block->block_id(),
-           depends_flags);
+void HBoundsCheckEliminator::EliminateRedundantChecks(HBasicBlock* block) {
+  int saved_length = ranges_.length();
   HInstruction* instr = block->first();
   while (instr != NULL) {
     HInstruction* next = instr->next();
-    if (instr->CheckFlag(HValue::kUseGVN) &&
-        (instr->flags() & depends_flags) == 0) {
-      TraceGVN("Checking instruction %d (%s)\n",
-               instr->id(),
-               instr->Mnemonic());
-      bool inputs_loop_invariant = true;
-      for (int i = 0; i < instr->OperandCount(); ++i) {
-        if (instr->OperandAt(i)->IsDefinedAfter(pre_header)) {
-          inputs_loop_invariant = false;
-        }
-      }
-
-      if (inputs_loop_invariant && ShouldMove(instr, loop_header)) {
-        TraceGVN("Found loop invariant instruction %d\n", instr->id());
-        // Move the instruction out of the loop.
-        instr->Unlink();
-        instr->InsertBefore(pre_header->end());
-      }
-    }
+    if (instr->IsBoundsCheck()) ProcessCheck(HBoundsCheck::cast(instr), block);
     instr = next;
   }
+  for (int i = 0; i < block->dominated_blocks()->length(); i++) {
+    EliminateRedundantChecks(block->dominated_blocks()->at(i));
+  }
+  ranges_.Rewind(saved_length);
 }
 
 
-bool HGlobalValueNumberer::AllowCodeMotion() {
-  return info()->shared_info()->opt_count() + 1 < Compiler::kDefaultMaxOptCount;
-}
-
-
-bool HGlobalValueNumberer::ShouldMove(HInstruction* instr,
-                                      HBasicBlock* loop_header) {
-  // If we've disabled code motion or we're in a block that unconditionally
-  // deoptimizes, don't move any instructions.
-  return AllowCodeMotion() && !instr->block()->IsDeoptimizing();
+void HBoundsCheckEliminator::Process() {
+  EliminateRedundantChecks(graph_->entry_block());
 }
 
 
-int HGlobalValueNumberer::CollectSideEffectsOnPathsToDominatedBlock(
-    HBasicBlock* dominator, HBasicBlock* dominated) {
-  int side_effects = 0;
-  for (int i = 0; i < dominated->predecessors()->length(); ++i) {
-    HBasicBlock* block = dominated->predecessors()->at(i);
-    if (dominator->block_id() < block->block_id() &&
-        block->block_id() < dominated->block_id() &&
-        visited_on_paths_.Add(block->block_id())) {
-      side_effects |= block_side_effects_[block->block_id()];
-      if (block->IsLoopHeader()) {
-        side_effects |= loop_side_effects_[block->block_id()];
-      }
-      side_effects |= CollectSideEffectsOnPathsToDominatedBlock(
-          dominator, block);
+// Looks through the checks that return the value they check.
+static HValue* CheckedObject(HValue* value) {
+  while (true) {
+    if (value->IsCheckMap()) {
+      value = HCheckMap::cast(value)->value();
+    } else if (value->IsCheckNonSmi()) {
+      value = HCheckNonSmi::cast(value)->value();
+    } else if (value->IsCheckInstanceType()) {
+      value = HCheckInstanceType::cast(value)->value();
+    } else {
+      return value;
     }
   }
-  return side_effects;
 }
 
 
-void HGlobalValueNumberer::AnalyzeBlock(HBasicBlock* block, HValueMap* map) {
-  TraceGVN("Analyzing block B%d%s\n",
-           block->block_id(),
-           block->IsLoopHeader() ? " (loop header)" : "");
+// Removes map checks and prototype map checks that are implied by checks,
+// map comparisons and map transitions dominating them.  Unlike value
+// numbering it knows the map of an object after a transitioning store, and
+// a transitioning store only forgets the maps of objects that had the same
+// map as the stored object.  Any other instruction that changes maps, and
+// an on-stack replacement entry, forgets everything.
+class HCheckMapsEliminator BASE_EMBEDDED {
+ public:
+  explicit HCheckMapsEliminator(HGraph* graph)
+      : graph_(graph),
+        changes_maps_(graph->blocks()->length()),
+        visited_on_paths_(graph->blocks()->length()) { }
 
-  // If this is a loop header kill everything killed by the loop.
-  if (block->IsLoopHeader()) {
-    map->Kill(loop_side_effects_[block->block_id()]);
+  void Process();
+
+ private:
+  struct KnownMap {
+    HValue* object;
+    Handle<Map> map;
+  };
+
+  // The maps known at a point of the graph.
+  struct State: public ZoneObject {
+    State() : maps(4), prototype_checks(2) { }
+    State(const State& other)
+        : maps(other.maps.length()),
+          prototype_checks(other.prototype_checks.length()) {
+      maps.AddAll(other.maps);
+      prototype_checks.AddAll(other.prototype_checks);
+    }
+    ZoneList<KnownMap> maps;
+    ZoneList<HCheckPrototypeMaps*> prototype_checks;
+  };
+
+  void ComputeChangesMaps();
+  bool ChangesMapsOnPathsToDominatedBlock(HBasicBlock* dominator,
+                                          HBasicBlock* dominated);
+  void EliminateRedundantChecks(HBasicBlock* block, State* state);
+  void ProcessCheckMap(HCheckMap* check, State* state);
+  void ProcessCheckPrototypeMaps(HCheckPrototypeMaps* check, State* state);
+  void ProcessTransition(HStoreNamedField* store, State* state);
+  static int IndexOf(State* state, HValue* object);
+  static void SetMap(State* state, HValue* object, Handle<Map> map);
+  void RemoveCheck(HInstruction* check, HValue* value);
+
+  HGraph* graph_;
+  // Blocks that contain an instruction changing maps or an on-stack
+  // replacement entry, and loop headers of loops that do.
+  BitVector changes_maps_;
+  BitVector visited_on_paths_;
+};
+
+
+void HCheckMapsEliminator::Process() {
+  ComputeChangesMaps();
+  EliminateRedundantChecks(graph_->entry_block(), new(graph_->zone()) State());
+}
+
+
+void HCheckMapsEliminator::ComputeChangesMaps() {
+  for (int i = 0; i < graph_->blocks()->length(); i++) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (instr->CheckFlag(HValue::kChangesMaps) ||
+          instr->CheckFlag(HValue::kChangesOsrEntries)) {
+        changes_maps_.Add(block->block_id());
+        break;
+      }
+    }
+  }
+  for (int i = 0; i < graph_->blocks()->length(); i++) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    if (!block->IsLoopHeader()) continue;
+    const ZoneList<HBasicBlock*>* blocks = block->loop_information()->blocks();
+    for (int j = 0; j < blocks->length(); j++) {
+      if (changes_maps_.Contains(blocks->at(j)->block_id())) {
+        changes_maps_.Add(block->block_id());
+        break;
+      }
+    }
+  }
+}
+
+
+bool HCheckMapsEliminator::ChangesMapsOnPathsToDominatedBlock(
+    HBasicBlock* dominator, HBasicBlock* dominated) {
+  for (int i = 0; i < dominated->predecessors()->length(); ++i) {
+    HBasicBlock* block = dominated->predecessors()->at(i);
+    if (dominator->block_id() < block->block_id() &&
+        block->block_id() < dominated->block_id() &&
+        !visited_on_paths_.Contains(block->block_id())) {
+      visited_on_paths_.Add(block->block_id());
+      if (changes_maps_.Contains(block->block_id()) ||
+          ChangesMapsOnPathsToDominatedBlock(dominator, block)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+
+int HCheckMapsEliminator::IndexOf(State* state, HValue* object) {
+  for (int i = 0; i < state->maps.length(); i++) {
+    if (state->maps[i].object == object) return i;
+  }
+  return -1;
+}
+
+
+void HCheckMapsEliminator::SetMap(State* state,
+                                  HValue* object,
+                                  Handle<Map> map) {
+  int index = IndexOf(state, object);
+  if (index >= 0) {
+    state->maps[index].map = map;
+  } else {
+    KnownMap known = { object, map };
+    state->maps.Add(known);
+  }
+}
+
+
+void HCheckMapsEliminator::RemoveCheck(HInstruction* check, HValue* value) {
+  if (FLAG_trace_check_elimination) {
+    PrintF("Removing %s %d\n", check->Mnemonic(), check->id());
+  }
+  check->DeleteAndReplaceWith(value);
+}
+
+
+void HCheckMapsEliminator::ProcessCheckMap(HCheckMap* check, State* state) {
+  HValue* object = CheckedObject(check->value());
+  int index = IndexOf(state, object);
+  if (index >= 0 && state->maps[index].map.is_identical_to(check->map())) {
+    RemoveCheck(check, check->value());
+  } else {
+    SetMap(state, object, check->map());
+  }
+}
+
+
+void HCheckMapsEliminator::ProcessCheckPrototypeMaps(
+    HCheckPrototypeMaps* check, State* state) {
+  for (int i = 0; i < state->prototype_checks.length(); i++) {
+    if (check->Equals(state->prototype_checks[i])) {
+      RemoveCheck(check, NULL);
+      return;
+    }
+  }
+  state->prototype_checks.Add(check);
+}
+
+
+void HCheckMapsEliminator::ProcessTransition(HStoreNamedField* store,
+                                             State* state) {
+  // The stored object may be a prototype.
+  state->prototype_checks.Rewind(0);
+  HValue* object = CheckedObject(store->object());
+  int index = IndexOf(state, object);
+  if (index < 0) {
+    state->maps.Rewind(0);
+  } else {
+    // Only objects with the map of the stored object can be the stored
+    // object.
+    Handle<Map> map = state->maps[index].map;
+    int length = 0;
+    for (int i = 0; i < state->maps.length(); i++) {
+      if (!state->maps[i].map.is_identical_to(map)) {
+        state->maps[length++] = state->maps[i];
+      }
+    }
+    state->maps.Rewind(length);
+  }
+  SetMap(state, object, store->transition());
+}
+
+
+void HCheckMapsEliminator::EliminateRedundantChecks(HBasicBlock* block,
+                                                    State* state) {
+  if (block->IsLoopHeader() && changes_maps_.Contains(block->block_id())) {
+    state->maps.Rewind(0);
+    state->prototype_checks.Rewind(0);
   }
 
-  // Go through all instructions of the current block.
   HInstruction* instr = block->first();
   while (instr != NULL) {
     HInstruction* next = instr->next();
-    int flags = instr->ChangesFlags();
-    if (flags != 0) {
-      // Clear all instructions in the map that are affected by side effects.
-      map->Kill(flags);
-      TraceGVN("Instruction %d kills\n", instr->id());
-    }
-    if (instr->CheckFlag(HValue::kUseGVN)) {
-      ASSERT(!instr->HasObservableSideEffects());
-      HValue* other = map->Lookup(instr);
-      if (other != NULL) {
-        ASSERT(instr->Equals(other) && other->Equals(instr));
-        TraceGVN("Replacing value %d (%s) with value %d (%s)\n",
-                 instr->id(),
-                 instr->Mnemonic(),
-                 other->id(),
-                 other->Mnemonic());
-        if (instr->HasSideEffects()) removed_side_effects_ = true;
-        instr->DeleteAndReplaceWith(other);
-      } else {
-        map->Add(instr);
-      }
+    if (instr->IsCheckMap()) {
+      ProcessCheckMap(HCheckMap::cast(instr), state);
+    } else if (instr->IsCheckPrototypeMaps()) {
+      ProcessCheckPrototypeMaps(HCheckPrototypeMaps::cast(instr), state);
+    } else if (instr->IsStoreNamedField() &&
+               !HStoreNamedField::cast(instr)->transition().is_null()) {
+      ProcessTransition(HStoreNamedField::cast(instr), state);
+    } else if (instr->CheckFlag(HValue::kChangesMaps) ||
+               instr->CheckFlag(HValue::kChangesOsrEntries)) {
+      state->maps.Rewind(0);
+      state->prototype_checks.Rewind(0);
     }
     instr = next;
   }
 
-  // Recursively continue analysis for all immediately dominated blocks.
   int length = block->dominated_blocks()->length();
-  for (int i = 0; i < length; ++i) {
+  for (int i = 0; i < length; i++) {
     HBasicBlock* dominated = block->dominated_blocks()->at(i);
-    // No need to copy the map for the last child in the dominator tree.
-    HValueMap* successor_map = (i == length - 1) ? map : map->Copy(zone());
-
-    // Kill everything killed on any path between this block and the
-    // dominated block.
-    // We don't have to traverse these paths if the value map is
-    // already empty.
-    // If the range of block ids (block_id, dominated_id) is empty
-    // there are no such paths.
-    if (!successor_map->IsEmpty() &&
-        block->block_id() + 1 < dominated->block_id()) {
+    // No need to copy the state for the last child in the dominator tree.
+    State* successor_state =
+        (i == length - 1) ? state : new(graph_->zone()) State(*state);
+    if (block->block_id() + 1 < dominated->block_id()) {
       visited_on_paths_.Clear();
-      successor_map->Kill(CollectSideEffectsOnPathsToDominatedBlock(block,
-                                                                    dominated));
+      if (ChangesMapsOnPathsToDominatedBlock(block, dominated)) {
+        successor_state->maps.Rewind(0);
+        successor_state->prototype_checks.Rewind(0);
+      }
     }
-    AnalyzeBlock(dominated, successor_map);
+    // The true branch of a map comparison knows the map.
+    if (block->end()->IsCompareMap() &&
+        block->end()->SuccessorAt(0) == dominated &&
+        dominated->predecessors()->length() == 1) {
+      HCompareMap* compare = HCompareMap::cast(block->end());
+      SetMap(successor_state, CheckedObject(compare->value()), compare->map());
+    }
+    EliminateRedundantChecks(dominated, successor_state);
   }
 }
 
 
-class HInferRepresentation BASE_EMBEDDED {
+// Forwards the values of named field stores to later loads of the same
+// field of the same object, replaces loads of fields whose value is
+// already known, and removes stores that are overwritten before anything
+// can observe them.  Unlike value numbering, which treats all in-object
+// fields as one location, it tracks every field offset separately: a
+// store to an object only forgets the fields at the same offset, which
+// the stored field of another object may alias.  Any other instruction
+// that changes fields forgets all fields of that kind, an instruction
+// that changes maps forgets the loaded maps, and an on-stack replacement
+// entry forgets everything.
+class HLoadStoreEliminator BASE_EMBEDDED {
  public:
-  explicit HInferRepresentation(HGraph* graph)
-      : graph_(graph), worklist_(8), in_worklist_(graph->GetMaximumValueID()) {}
+  explicit HLoadStoreEliminator(HGraph* graph)
+      : graph_(graph),
+        changes_fields_(graph->blocks()->length()),
+        visited_on_paths_(graph->blocks()->length()) { }
 
-  void Analyze();
+  void Process();
 
  private:
-  Representation TryChange(HValue* current);
-  void AddToWorklist(HValue* current);
-  void InferBasedOnInputs(HValue* current);
-  void AddDependantsToWorklist(HValue* current);
-  void InferBasedOnUses(HValue* current);
-
-  Zone* zone() { return graph_->zone(); }
+  struct KnownField {
+    HValue* object;
+    bool is_in_object;
+    int offset;
+    HValue* value;
+  };
+
+  // The field values known at a point of the graph.
+  struct State: public ZoneObject {
+    State() : fields(8) { }
+    State(const State& other) : fields(other.fields.length()) {
+      fields.AddAll(other.fields);
+    }
+    ZoneList<KnownField> fields;
+  };
+
+  static bool ChangesFields(HInstruction* instr);
+  void ComputeChangesFields();
+  bool ChangesFieldsOnPathsToDominatedBlock(HBasicBlock* dominator,
+                                            HBasicBlock* dominated);
+  void EliminateLoads(HBasicBlock* block, State* state);
+  void ProcessLoad(HLoadNamedField* load, State* state);
+  void ProcessStore(HStoreNamedField* store, State* state);
+  void EliminateDeadStores(HBasicBlock* block);
+  static void Kill(State* state, bool is_in_object, int offset);
+  static void KillAll(State* state, bool is_in_object);
 
   HGraph* graph_;
-  ZoneList<HValue*> worklist_;
-  BitVector in_worklist_;
+  // Blocks that contain an instruction changing fields or maps or an
+  // on-stack replacement entry, and loop headers of loops that do.
+  BitVector changes_fields_;
+  BitVector visited_on_paths_;
 };
 
 
-void HInferRepresentation::AddToWorklist(HValue* current) {
-  if (current->representation().IsSpecialization()) return;
-  if (!current->CheckFlag(HValue::kFlexibleRepresentation)) return;
-  if (in_worklist_.Contains(current->id())) return;
-  worklist_.Add(current);
-  in_worklist_.Add(current->id());
+void HLoadStoreEliminator::Process() {
+  ComputeChangesFields();
+  EliminateLoads(graph_->entry_block(), new(graph_->zone()) State());
+  for (int i = 0; i < graph_->blocks()->length(); i++) {
+    EliminateDeadStores(graph_->blocks()->at(i));
+  }
 }
 
 
-// This method tries to specialize the representation type of the value
-// given as a parameter. The value is asked to infer its representation type
-// based on its inputs. If the inferred type is more specialized, then this
-// becomes the new representation type of the node.
-void HInferRepresentation::InferBasedOnInputs(HValue* current) {
-  Representation r = current->representation();
-  if (r.IsSpecialization()) return;
-  ASSERT(current->CheckFlag(HValue::kFlexibleRepresentation));
-  Representation inferred = current->InferredRepresentation();
-  if (inferred.IsSpecialization()) {
-    current->ChangeRepresentation(inferred);
-    AddDependantsToWorklist(current);
-  }
+bool HLoadStoreEliminator::ChangesFields(HInstruction* instr) {
+  return instr->CheckFlag(HValue::kChangesInobjectFields) ||
+      instr->CheckFlag(HValue::kChangesBackingStoreFields) ||
+      instr->CheckFlag(HValue::kChangesMaps) ||
+      instr->CheckFlag(HValue::kChangesOsrEntries);
 }
 
 
-void HInferRepresentation::AddDependantsToWorklist(HValue* value) {
-  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
-    AddToWorklist(it.value());
+void HLoadStoreEliminator::ComputeChangesFields() {
+  for (int i = 0; i < graph_->blocks()->length(); i++) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (ChangesFields(instr)) {
+        changes_fields_.Add(block->block_id());
+        break;
+      }
+    }
   }
-  for (int i = 0; i < value->OperandCount(); ++i) {
-    AddToWorklist(value->OperandAt(i));
+  for (int i = 0; i < graph_->blocks()->length(); i++) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    if (!block->IsLoopHeader()) continue;
+    const ZoneList<HBasicBlock*>* blocks = block->loop_information()->blocks();
+    for (int j = 0; j < blocks->length(); j++) {
+      if (changes_fields_.Contains(blocks->at(j)->block_id())) {
+        changes_fields_.Add(block->block_id());
+        break;
+      }
+    }
   }
 }
 
 
-// This method calculates whether specializing the representation of the value
-// given as the parameter has a benefit in terms of less necessary type
-// conversions. If there is a benefit, then the representation of the value is
-// specialized.
-void HInferRepresentation::InferBasedOnUses(HValue* value) {
-  Representation r = value->representation();
-  if (r.IsSpecialization() || value->HasNoUses()) return;
-  ASSERT(value->CheckFlag(HValue::kFlexibleRepresentation));
-  Representation new_rep = TryChange(value);
-  if (!new_rep.IsNone()) {
-    if (!value->representation().Equals(new_rep)) {
-      value->ChangeRepresentation(new_rep);
-      AddDependantsToWorklist(value);
+bool HLoadStoreEliminator::ChangesFieldsOnPathsToDominatedBlock(
+    HBasicBlock* dominator, HBasicBlock* dominated) {
+  for (int i = 0; i < dominated->predecessors()->length(); ++i) {
+    HBasicBlock* block = dominated->predecessors()->at(i);
+    if (dominator->block_id() < block->block_id() &&
+        block->block_id() < dominated->block_id() &&
+        !visited_on_paths_.Contains(block->block_id())) {
+      visited_on_paths_.Add(block->block_id());
+      if (changes_fields_.Contains(block->block_id()) ||
+          ChangesFieldsOnPathsToDominatedBlock(dominator, block)) {
+        return true;
+      }
     }
   }
+  return false;
 }
 
 
-Representation HInferRepresentation::TryChange(HValue* value) {
-  // Array of use counts for each representation.
-  int use_count[Representation::kNumRepresentations] = { 0 };
-
-  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
-    HValue* use = it.value();
-    Representation rep = use->RequiredInputRepresentation(it.index());
-    if (rep.IsNone()) continue;
-    if (use->IsPhi()) HPhi::cast(use)->AddIndirectUsesTo(&use_count[0]);
-    ++use_count[rep.kind()];
+void HLoadStoreEliminator::Kill(State* state, bool is_in_object, int offset) {
+  int length = 0;
+  for (int i = 0; i < state->fields.length(); i++) {
+    if (state->fields[i].is_in_object != is_in_object ||
+        state->fields[i].offset != offset) {
+      state->fields[length++] = state->fields[i];
+    }
   }
-  int tagged_count = use_count[Representation::kTagged];
-  int double_count = use_count[Representation::kDouble];
-  int int32_count = use_count[Representation::kInteger32];
-  int non_tagged_count = double_count + int32_count;
+  state->fields.Rewind(length);
+}
 
-  // If a non-loop phi has tagged uses, don't convert it to untagged.
-  if (value->IsPhi() && !value->block()->IsLoopHeader() && tagged_count > 0) {
-    return Representation::None();
+
+void HLoadStoreEliminator::KillAll(State* state, bool is_in_object) {
+  int length = 0;
+  for (int i = 0; i < state->fields.length(); i++) {
+    if (state->fields[i].is_in_object != is_in_object) {
+      state->fields[length++] = state->fields[i];
+    }
   }
+  state->fields.Rewind(length);
+}
 
-  // Prefer unboxing over boxing, the latter is more expensive.
-  if (tagged_count > non_tagged_count) return Representation::None();
 
-  // Prefer Integer32 over Double, if possible.
-  if (int32_count > 0 && value->IsConvertibleToInteger()) {
-    return Representation::Integer32();
+void HLoadStoreEliminator::ProcessLoad(HLoadNamedField* load, State* state) {
+  HValue* object = CheckedObject(load->object());
+  for (int i = 0; i < state->fields.length(); i++) {
+    KnownField* field = &state->fields[i];
+    if (field->object == object &&
+        field->is_in_object == load->is_in_object() &&
+        field->offset == load->offset()) {
+      if (field->value->representation().Equals(load->representation())) {
+        if (FLAG_trace_load_elimination) {
+          PrintF("Replacing LoadNamedField %d by %s %d\n",
+                 load->id(),
+                 field->value->Mnemonic(),
+                 field->value->id());
+        }
+        load->DeleteAndReplaceWith(field->value);
+      } else {
+        field->value = load;
+      }
+      return;
+    }
   }
+  KnownField field = { object, load->is_in_object(), load->offset(), load };
+  state->fields.Add(field);
+}
 
-  if (double_count > 0) return Representation::Double();
 
-  return Representation::None();
+void HLoadStoreEliminator::ProcessStore(HStoreNamedField* store,
+                                        State* state) {
+  Kill(state, store->is_in_object(), store->offset());
+  if (!store->transition().is_null()) {
+    Kill(state, true, HeapObject::kMapOffset);
+  }
+  KnownField field = { CheckedObject(store->object()),
+                       store->is_in_object(),
+                       store->offset(),
+                       store->value() };
+  state->fields.Add(field);
 }
 
 
-void HInferRepresentation::Analyze() {
-  HPhase phase("Infer representations", graph_);
+void HLoadStoreEliminator::EliminateLoads(HBasicBlock* block, State* state) {
+  if (block->IsLoopHeader() && changes_fields_.Contains(block->block_id())) {
+    state->fields.Rewind(0);
+  }
 
-  // (1) Initialize bit vectors and count real uses. Each phi gets a
-  // bit-vector of length <number of phis>.
-  const ZoneList<HPhi*>* phi_list = graph_->phi_list();
-  int phi_count = phi_list->length();
-  ZoneList<BitVector*> connected_phis(phi_count);
-  for (int i = 0; i < phi_count; ++i) {
-    phi_list->at(i)->InitRealUses(i);
-    BitVector* connected_set = new(zone()) BitVector(phi_count);
-    connected_set->Add(i);
-    connected_phis.Add(connected_set);
+  HInstruction* instr = block->first();
+  while (instr != NULL) {
+    HInstruction* next = instr->next();
+    if (instr->IsLoadNamedField()) {
+      ProcessLoad(HLoadNamedField::cast(instr), state);
+    } else if (instr->IsStoreNamedField()) {
+      ProcessStore(HStoreNamedField::cast(instr), state);
+    } else if (instr->CheckFlag(HValue::kChangesOsrEntries)) {
+      state->fields.Rewind(0);
+    } else {
+      if (instr->CheckFlag(HValue::kChangesInobjectFields)) {
+        KillAll(state, true);
+      }
+      if (instr->CheckFlag(HValue::kChangesBackingStoreFields)) {
+        KillAll(state, false);
+      }
+      if (instr->CheckFlag(HValue::kChangesMaps)) {
+        Kill(state, true, HeapObject::kMapOffset);
+      }
+    }
+    instr = next;
   }
 
-  // (2) Do a fixed point iteration to find the set of connected phis.  A
-  // phi is connected to another phi if its value is used either directly or
-  // indirectly through a transitive closure of the def-use relation.
-  bool change = true;
-  while (change) {
-    change = false;
-    // We normally have far more "forward edges" than "backward edges",
-    // so we terminate faster when we walk backwards.
-    for (int i = phi_count - 1; i >= 0; --i) {
-      HPhi* phi = phi_list->at(i);
-      for (HUseIterator it(phi->uses()); !it.Done(); it.Advance()) {
-        HValue* use = it.value();
-        if (use->IsPhi()) {
-          int id = HPhi::cast(use)->phi_id();
-          if (connected_phis[i]->UnionIsChanged(*connected_phis[id]))
-            change = true;
+  int length = block->dominated_blocks()->length();
+  for (int i = 0; i < length; i++) {
+    HBasicBlock* dominated = block->dominated_blocks()->at(i);
+    // No need to copy the state for the last child in the dominator tree.
+    State* successor_state =
+        (i == length - 1) ? state : new(graph_->zone()) State(*state);
+    if (block->block_id() + 1 < dominated->block_id()) {
+      visited_on_paths_.Clear();
+      if (ChangesFieldsOnPathsToDominatedBlock(block, dominated)) {
+        successor_state->fields.Rewind(0);
+      }
+    }
+    EliminateLoads(dominated, successor_state);
+  }
+}
+
+
+// Removes a store when a later store in the block writes the same field of
+// the same object, and nothing in between can read the field or
+// deoptimize.  Transitioning stores and stores to double fields are kept.
+void HLoadStoreEliminator::EliminateDeadStores(HBasicBlock* block) {
+  ZoneList<HStoreNamedField*> stores(4);
+  for (HInstruction* instr = block->first();
+       instr != NULL;
+       instr = instr->next()) {
+    if (instr->IsStoreNamedField()) {
+      HStoreNamedField* store = HStoreNamedField::cast(instr);
+      HValue* object = CheckedObject(store->object());
+      int length = 0;
+      for (int i = 0; i < stores.length(); i++) {
+        HStoreNamedField* previous = stores[i];
+        if (!store->is_double_field() &&
+            CheckedObject(previous->object()) == object &&
+            previous->is_in_object() == store->is_in_object() &&
+            previous->offset() == store->offset()) {
+          if (FLAG_trace_load_elimination) {
+            PrintF("Removing StoreNamedField %d\n", previous->id());
+          }
+          previous->DeleteAndReplaceWith(NULL);
+        } else {
+          stores[length++] = previous;
+        }
+      }
+      stores.Rewind(length);
+      if (store->transition().is_null() && !store->is_double_field()) {
+        stores.Add(store);
+      }
+    } else if (instr->IsLoadNamedField()) {
+      HLoadNamedField* load = HLoadNamedField::cast(instr);
+      int length = 0;
+      for (int i = 0; i < stores.length(); i++) {
+        if (stores[i]->is_in_object() != load->is_in_object() ||
+            stores[i]->offset() != load->offset()) {
+          stores[length++] = stores[i];
         }
       }
+      stores.Rewind(length);
+    } else if (!instr->IsSimulate() &&
+               !instr->IsConstant() &&
+               !instr->IsEnterInlined() &&
+               !instr->IsLeaveInlined()) {
+      stores.Rewind(0);
     }
   }
+}
 
-  // (3) Use the phi reachability information from step 2 to
-  //     (a) sum up the non-phi use counts of all connected phis.
-  //     (b) push information about values which can't be converted to integer
-  //         without deoptimization through the phi use-def chains, avoiding
-  //         unnecessary deoptimizations later.
-  for (int i = 0; i < phi_count; ++i) {
-    HPhi* phi = phi_list->at(i);
-    bool cti = phi->AllOperandsConvertibleToInteger();
-    for (BitVector::Iterator it(connected_phis.at(i));
-         !it.Done();
-         it.Advance()) {
-      int index = it.Current();
-      HPhi* it_use = phi_list->at(it.Current());
-      if (index != i) phi->AddNonPhiUsesFrom(it_use);  // Don't count twice!
-      if (!cti) it_use->set_is_convertible_to_integer(false);
+
+// Marks the Integer32 results of logical right shifts and of unsigned int
+// array loads as uint32 values when every use either reads them as
+// unsigned or only depends on their bits: conversions to double and
+// tagged values, bitwise operations, integer array stores, deoptimization
+// environments and phis that are uint32 values themselves.  A uint32 value
+// stays in an integer register instead of deoptimizing when it does not
+// fit in an int32.
+class HUint32Analysis BASE_EMBEDDED {
+ public:
+  explicit HUint32Analysis(HGraph* graph)
+      : graph_(graph),
+        candidates_(8),
+        in_candidates_(graph->GetMaximumValueID()) { }
+
+  void Analyze();
+
+ private:
+  static bool IsCandidate(HValue* value);
+  static bool IsSafeUse(HValue* use, HValue* value);
+  static bool IsNonNegative(HValue* value);
+  bool UsesAreSafe(HValue* value);
+  bool InputsAreUint32(HPhi* phi);
+
+  HGraph* graph_;
+  ZoneList<HValue*> candidates_;
+  BitVector in_candidates_;
+};
+
+
+bool HUint32Analysis::IsNonNegative(HValue* value) {
+  return value->HasRange() && !value->range()->CanBeNegative();
+}
+
+
+// Non-negative values are the same as int32 and uint32 values.
+bool HUint32Analysis::IsCandidate(HValue* value) {
+  if (!value->representation().IsInteger32() || IsNonNegative(value)) {
+    return false;
+  }
+  if (value->IsLoadKeyedSpecializedArrayElement()) {
+    return HLoadKeyedSpecializedArrayElement::cast(value)->elements_kind() ==
+        EXTERNAL_UNSIGNED_INT_ELEMENTS;
+  }
+  return value->IsShr() || value->IsPhi();
+}
+
+
+bool HUint32Analysis::IsSafeUse(HValue* use, HValue* value) {
+  if (use->IsSimulate()) return true;
+  if (use->IsChange()) {
+    Representation to = HChange::cast(use)->to();
+    return to.IsDouble() || to.IsTagged();
+  }
+  if (use->IsBitwiseBinaryOperation() || use->IsBitNot()) {
+    return use->representation().IsInteger32();
+  }
+  if (use->IsStoreKeyedSpecializedArrayElement()) {
+    HStoreKeyedSpecializedArrayElement* store =
+        HStoreKeyedSpecializedArrayElement::cast(use);
+    return store->value() == value &&
+        store->key() != value &&
+        store->elements_kind() != EXTERNAL_FLOAT_ELEMENTS &&
+        store->elements_kind() != EXTERNAL_DOUBLE_ELEMENTS;
+  }
+  return false;
+}
+
+
+bool HUint32Analysis::UsesAreSafe(HValue* value) {
+  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    if (use->IsPhi()) {
+      if (!in_candidates_.Contains(use->id())) return false;
+    } else if (!IsSafeUse(use, value)) {
+      return false;
     }
   }
+  return true;
+}
 
-  // Initialize work list
-  for (int i = 0; i < graph_->blocks()->length(); ++i) {
+
+bool HUint32Analysis::InputsAreUint32(HPhi* phi) {
+  for (int i = 0; i < phi->OperandCount(); i++) {
+    HValue* input = phi->OperandAt(i);
+    if (!in_candidates_.Contains(input->id()) && !IsNonNegative(input)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void HUint32Analysis::Analyze() {
+  // Start from all candidates, then drop the ones with a use or, for phis,
+  // an input that is not uint32 until nothing changes.
+  for (int i = 0; i < graph_->blocks()->length(); i++) {
     HBasicBlock* block = graph_->blocks()->at(i);
-    const ZoneList<HPhi*>* phis = block->phis();
-    for (int j = 0; j < phis->length(); ++j) {
-      AddToWorklist(phis->at(j));
+    for (int j = 0; j < block->phis()->length(); j++) {
+      HPhi* phi = block->phis()->at(j);
+      if (IsCandidate(phi)) {
+        candidates_.Add(phi);
+        in_candidates_.Add(phi->id());
+      }
     }
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (IsCandidate(instr)) {
+        candidates_.Add(instr);
+        in_candidates_.Add(instr->id());
+      }
+    }
+  }
 
-    HInstruction* current = block->first();
-    while (current != NULL) {
-      AddToWorklist(current);
-      current = current->next();
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    int length = 0;
+    for (int i = 0; i < candidates_.length(); i++) {
+      HValue* value = candidates_[i];
+      if (UsesAreSafe(value) &&
+          (!value->IsPhi() || InputsAreUint32(HPhi::cast(value)))) {
+        candidates_[length++] = value;
+      } else {
+        in_candidates_.Remove(value->id());
+        changed = true;
+      }
+    }
+    candidates_.Rewind(length);
+  }
+
+  for (int i = 0; i < candidates_.length(); i++) {
+    if (FLAG_trace_representation) {
+      PrintF("Marking %s %d as uint32\n",
+             candidates_[i]->Mnemonic(),
+             candidates_[i]->id());
+    }
+    candidates_[i]->SetUint32();
+  }
+}
+
+
+// Removes deletable instructions whose values are not needed.  Phis and
+// instructions that are not deletable are live, and so are the operands
+// of live values.  Deoptimization environments are operands of simulates,
+// so values that are only needed to deoptimize are kept.
+class HDeadCodeEliminator BASE_EMBEDDED {
+ public:
+  explicit HDeadCodeEliminator(HGraph* graph)
+      : graph_(graph),
+        live_(graph->GetMaximumValueID()),
+        worklist_(graph->blocks()->length()) { }
+
+  void Process();
+
+ private:
+  void MarkLive(HValue* value);
+
+  HGraph* graph_;
+  BitVector live_;
+  ZoneList<HValue*> worklist_;
+};
+
+
+void HDeadCodeEliminator::MarkLive(HValue* value) {
+  if (live_.Contains(value->id())) return;
+  live_.Add(value->id());
+  worklist_.Add(value);
+}
+
+
+void HDeadCodeEliminator::Process() {
+  const ZoneList<HBasicBlock*>* blocks = graph_->blocks();
+  for (int i = 0; i < blocks->length(); i++) {
+    HBasicBlock* block = blocks->at(i);
+    for (int j = 0; j < block->phis()->length(); j++) {
+      MarkLive(block->phis()->at(j));
+    }
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (!instr->IsDeletable()) MarkLive(instr);
     }
   }
 
-  // Do a fixed point iteration, trying to improve representations
   while (!worklist_.is_empty()) {
-    HValue* current = worklist_.RemoveLast();
-    in_worklist_.Remove(current->id());
-    InferBasedOnInputs(current);
-    InferBasedOnUses(current);
+    HValue* value = worklist_.RemoveLast();
+    for (int i = 0; i < value->OperandCount(); i++) {
+      MarkLive(value->OperandAt(i));
+    }
+  }
+
+  // Dead instructions may use each other, so drop all their uses before
+  // deleting any of them.
+  ZoneList<HInstruction*> dead(8);
+  for (int i = 0; i < blocks->length(); i++) {
+    for (HInstruction* instr = blocks->at(i)->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (!live_.Contains(instr->id())) {
+        instr->ClearOperands();
+        dead.Add(instr);
+      }
+    }
+  }
+  for (int i = 0; i < dead.length(); i++) {
+    HInstruction* instr = dead[i];
+    if (FLAG_trace_dead_code_elimination) {
+      PrintF("Removing dead %s %d\n", instr->Mnemonic(), instr->id());
+    }
+    instr->DeleteAndReplaceWith(NULL);
   }
 }
 
 
-void HGraph::InitializeInferredTypes() {
-  HPhase phase("Inferring types", this);
-  InitializeInferredTypes(0, this->blocks_.length() - 1);
+// Moves a deletable instruction that does not depend on any state from a
+// block ending in a branch into the successor that dominates all of its
+// uses, so the value is only computed on the path that needs it.  The
+// successor must have no other predecessor, which also keeps instructions
+// from moving into loops.  Uses by phis or by simulates in the original
+// block keep the instruction where it is.
+class HInstructionSinker BASE_EMBEDDED {
+ public:
+  explicit HInstructionSinker(HGraph* graph) : graph_(graph) { }
+
+  void Process();
+
+ private:
+  static bool CanSink(HInstruction* instr);
+  static HBasicBlock* FindTarget(HInstruction* instr);
+
+  HGraph* graph_;
+};
+
+
+bool HInstructionSinker::CanSink(HInstruction* instr) {
+  if (!instr->IsDeletable() || instr->HasNoUses()) return false;
+  int depends_flags = 0;
+#define ADD_FLAG(type) depends_flags |= (1 << HValue::kDependsOn##type);
+  GVN_FLAG_LIST(ADD_FLAG)
+#undef ADD_FLAG
+  depends_flags &= ~(1 << HValue::kDependsOnOsrEntries);
+  return (instr->flags() & depends_flags) == 0;
 }
 
 
-void HGraph::InitializeInferredTypes(int from_inclusive, int to_inclusive) {
-  for (int i = from_inclusive; i <= to_inclusive; ++i) {
-    HBasicBlock* block = blocks_[i];
+// Returns the successor of the instruction's block that dominates all
+// uses of the instruction, or NULL if there is none.
+HBasicBlock* HInstructionSinker::FindTarget(HInstruction* instr) {
+  HBasicBlock* block = instr->block();
+  HBasicBlock* target = NULL;
+  for (HUseIterator it(instr->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    if (use->IsPhi()) return NULL;
+    HBasicBlock* use_block = use->block();
+    if (target == NULL) {
+      for (HSuccessorIterator succ(block->end());
+           !succ.Done();
+           succ.Advance()) {
+        HBasicBlock* successor = succ.Current();
+        if (successor == use_block || successor->Dominates(use_block)) {
+          target = successor;
+          break;
+        }
+      }
+      if (target == NULL) return NULL;
+    } else if (target != use_block && !target->Dominates(use_block)) {
+      return NULL;
+    }
+  }
+  if (target == NULL || target->predecessors()->length() != 1) return NULL;
+  return target;
+}
 
-    const ZoneList<HPhi*>* phis = block->phis();
-    for (int j = 0; j < phis->length(); j++) {
-      phis->at(j)->UpdateInferredType();
+
+void HInstructionSinker::Process() {
+  // Blocks are visited in reverse post order, so an instruction sunk into
+  // a successor can be sunk further when the successor is visited.  Within
+  // a block, visiting instructions backwards lets the operands of a sunk
+  // instruction follow it.
+  const ZoneList<HBasicBlock*>* blocks = graph_->blocks();
+  for (int i = 0; i < blocks->length(); i++) {
+    HBasicBlock* block = blocks->at(i);
+    if (block->end() == NULL || block->end()->SuccessorCount() < 2) continue;
+    HInstruction* instr = block->end()->previous();
+    while (instr != block->first()) {
+      HInstruction* previous = instr->previous();
+      if (CanSink(instr)) {
+        HBasicBlock* target = FindTarget(instr);
+        if (target != NULL) {
+          if (FLAG_trace_dead_code_elimination) {
+            PrintF("Sinking %s %d from B%d to B%d\n",
+                   instr->Mnemonic(),
+                   instr->id(),
+                   block->block_id(),
+                   target->block_id());
+          }
+          instr->Unlink();
+          instr->InsertAfter(target->first());
+        }
+      }
+      instr = previous;
     }
+  }
+}
 
-    HInstruction* current = block->first();
-    while (current != NULL) {
-      current->UpdateInferredType();
-      current = current->next();
+
+// Replaces object literals that do not escape the optimized function by
+// their in-object fields.  A literal is captured if it is only used as the
+// object of in-object field loads and stores, by smi and map checks
+// against the boilerplate map, and by deoptimization environments.  All
+// stores must be in the block of the literal, so a load in a dominated
+// block sees the field values at the end of that block and no phis are
+// needed.
+class HEscapeAnalysis BASE_EMBEDDED {
+ public:
+  explicit HEscapeAnalysis(HGraph* graph) : graph_(graph) { }
+
+  void Analyze();
+
+ private:
+  int FieldIndex(HObjectLiteralFast* literal, bool is_in_object, int offset);
+  bool IsCaptured(HObjectLiteralFast* literal);
+  HCapturedObject* Capture(HObjectLiteralFast* literal);
+
+  HGraph* graph_;
+};
+
+
+// Returns the index of the in-object field of the literal at the given
+// offset, or -1 if there is no such field.
+int HEscapeAnalysis::FieldIndex(HObjectLiteralFast* literal,
+                                bool is_in_object,
+                                int offset) {
+  if (!is_in_object) return -1;
+  Map* map = literal->boilerplate()->map();
+  int first_offset =
+      map->instance_size() - map->inobject_properties() * kPointerSize;
+  if (offset < first_offset || (offset - first_offset) % kPointerSize != 0) {
+    return -1;
+  }
+  int index = (offset - first_offset) / kPointerSize;
+  return index < map->inobject_properties() ? index : -1;
+}
+
+
+bool HEscapeAnalysis::IsCaptured(HObjectLiteralFast* literal) {
+  if (literal->in_object_values() == NULL) return false;
+  Map* map = literal->boilerplate()->map();
+  for (HUseIterator it(literal->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    if (use->IsSimulate()) continue;
+    if (use->IsCheckNonSmi()) {
+      if (!use->HasNoUses()) return false;
+    } else if (use->IsCheckMap()) {
+      HCheckMap* check = HCheckMap::cast(use);
+      if (check->value() != literal ||
+          *check->map() != map ||
+          !check->HasNoUses()) {
+        return false;
+      }
+    } else if (use->IsLoadNamedField()) {
+      HLoadNamedField* load = HLoadNamedField::cast(use);
+      if (load->is_double_field() ||
+          FieldIndex(literal, load->is_in_object(), load->offset()) < 0) {
+        return false;
+      }
+    } else if (use->IsStoreNamedField()) {
+      HStoreNamedField* store = HStoreNamedField::cast(use);
+      if (it.index() != 0 ||
+          store->value() == literal ||
+          store->value()->IsArgumentsObject() ||
+          !store->transition().is_null() ||
+          store->is_double_field() ||
+          store->block() != literal->block() ||
+          FieldIndex(literal, store->is_in_object(), store->offset()) < 0) {
+        return false;
+      }
+    } else {
+      return false;
     }
+  }
+  return true;
+}
 
-    if (block->IsLoopHeader()) {
-      HBasicBlock* last_back_edge =
-          block->loop_information()->GetLastBackEdge();
-      InitializeInferredTypes(i + 1, last_back_edge->block_id());
-      // Skip all blocks already processed by the recursive call.
-      i = last_back_edge->block_id();
-      // Update phis of the loop header now after the whole loop body is
-      // guaranteed to be processed.
-      ZoneList<HValue*> worklist(block->phis()->length());
-      for (int j = 0; j < block->phis()->length(); ++j) {
-        worklist.Add(block->phis()->at(j));
+
+HCapturedObject* HEscapeAnalysis::Capture(HObjectLiteralFast* literal) {
+  Zone* zone = graph_->zone();
+  ZoneList<Handle<Object> >* initial_values = literal->in_object_values();
+  int field_count = initial_values->length();
+  HCapturedObject* object =
+      new(zone) HCapturedObject(literal->boilerplate(), field_count);
+  ZoneList<HValue*> values(field_count);
+  for (int i = 0; i < field_count; i++) {
+    HConstant* constant =
+        new(zone) HConstant(initial_values->at(i), Representation::Tagged());
+    constant->InsertBefore(literal);
+    object->AddInitialValue(constant);
+    values.Add(constant);
+  }
+  object->InsertBefore(literal);
+
+  // Replace the uses in the block of the literal in order, so that loads
+  // see the values of the stores before them.
+  HInstruction* instr = literal->next();
+  while (instr != NULL) {
+    HInstruction* next = instr->next();
+    if (instr->OperandCount() > 0 && instr->OperandAt(0) == literal) {
+      if (instr->IsStoreNamedField()) {
+        HStoreNamedField* store = HStoreNamedField::cast(instr);
+        int index = FieldIndex(literal, true, store->offset());
+        HStoreCapturedField* captured_store =
+            new(zone) HStoreCapturedField(object, index, store->value());
+        captured_store->InsertBefore(store);
+        values[index] = store->value();
+        store->DeleteAndReplaceWith(NULL);
+      } else if (instr->IsLoadNamedField()) {
+        HLoadNamedField* load = HLoadNamedField::cast(instr);
+        load->DeleteAndReplaceWith(
+            values[FieldIndex(literal, true, load->offset())]);
+      } else if (instr->IsCheckNonSmi() || instr->IsCheckMap()) {
+        instr->DeleteAndReplaceWith(NULL);
       }
-      InferTypes(&worklist);
     }
+    instr = next;
+  }
+
+  // The remaining loads and checks are in dominated blocks.
+  ZoneList<HInstruction*> uses(4);
+  for (HUseIterator it(literal->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    if (use->IsLoadNamedField() || use->IsCheckNonSmi() || use->IsCheckMap()) {
+      HInstruction* instr = HInstruction::cast(use);
+      if (!uses.Contains(instr)) uses.Add(instr);
+    }
+  }
+  for (int i = 0; i < uses.length(); i++) {
+    HInstruction* instr = uses[i];
+    if (instr->IsLoadNamedField()) {
+      HLoadNamedField* load = HLoadNamedField::cast(instr);
+      load->DeleteAndReplaceWith(
+          values[FieldIndex(literal, true, load->offset())]);
+    } else {
+      instr->DeleteAndReplaceWith(NULL);
+    }
+  }
+
+  // Deoptimization environments now refer to the captured object.
+  literal->DeleteAndReplaceWith(object);
+  return object;
+}
+
+
+void HEscapeAnalysis::Analyze() {
+  for (int i = 0; i < graph_->blocks()->length(); ++i) {
+    HInstruction* instr = graph_->blocks()->at(i)->first();
+    while (instr != NULL) {
+      HInstruction* next = instr->next();
+      if (instr->IsObjectLiteralFast()) {
+        HObjectLiteralFast* literal = HObjectLiteralFast::cast(instr);
+        if (IsCaptured(literal)) {
+          if (FLAG_trace_escape_analysis) {
+            PrintF("Capturing object literal %d\n", literal->id());
+          }
+          next = Capture(literal)->next();
+        }
+      }
+      instr = next;
+    }
+  }
+}
+
+
+// Simple sparse set with O(1) add, contains, and clear.
+class SparseSet {
+ public:
+  SparseSet(Zone* zone, int capacity)
+      : capacity_(capacity),
+        length_(0),
+        dense_(zone->NewArray<int>(capacity)),
+        sparse_(zone->NewArray<int>(capacity)) {
+#ifndef NVALGRIND
+    // Initialize the sparse array to make valgrind happy.
+    memset(sparse_, 0, sizeof(sparse_[0]) * capacity);
+#endif
+  }
+
+  bool Contains(int n) const {
+    ASSERT(0 <= n && n < capacity_);
+    int d = sparse_[n];
+    return 0 <= d && d < length_ && dense_[d] == n;
+  }
+
+  bool Add(int n) {
+    if (Contains(n)) return false;
+    dense_[length_] = n;
+    sparse_[n] = length_;
+    ++length_;
+    return true;
+  }
+
+  void Clear() { length_ = 0; }
+
+ private:
+  int capacity_;
+  int length_;
+  int* dense_;
+  int* sparse_;
+
+  DISALLOW_COPY_AND_ASSIGN(SparseSet);
+};
+
+
+class HGlobalValueNumberer BASE_EMBEDDED {
+ public:
+  explicit HGlobalValueNumberer(HGraph* graph, CompilationInfo* info)
+      : graph_(graph),
+        info_(info),
+        removed_side_effects_(false),
+        block_side_effects_(graph->blocks()->length()),
+        loop_side_effects_(graph->blocks()->length()),
+        visited_on_paths_(graph->zone(), graph->blocks()->length()) {
+    // The optimizing compiler thread must not touch the allocation state
+    // of the heap, which belongs to the main thread.
+    ASSERT(info->is_concurrent() ||
+           info->isolate()->heap()->allow_allocation(false));
+    block_side_effects_.AddBlock(0, graph_->blocks()->length());
+    loop_side_effects_.AddBlock(0, graph_->blocks()->length());
+  }
+  ~HGlobalValueNumberer() {
+    ASSERT(info_->is_concurrent() ||
+           !info_->isolate()->heap()->allow_allocation(true));
+  }
+
+  // Returns true if values with side effects are removed.
+  bool Analyze();
+
+ private:
+  int CollectSideEffectsOnPathsToDominatedBlock(HBasicBlock* dominator,
+                                                HBasicBlock* dominated);
+  void AnalyzeBlock(HBasicBlock* block, HValueMap* map);
+  void ComputeBlockSideEffects();
+  void LoopInvariantCodeMotion();
+  void ProcessLoopBlock(HBasicBlock* block,
+                        HBasicBlock* before_loop,
+                        int loop_kills);
+  bool AllowCodeMotion();
+  bool ShouldMove(HInstruction* instr, HBasicBlock* loop_header);
+
+  HGraph* graph() { return graph_; }
+  CompilationInfo* info() { return info_; }
+  Zone* zone() { return graph_->zone(); }
+
+  HGraph* graph_;
+  CompilationInfo* info_;
+  bool removed_side_effects_;
+
+  // A map of block IDs to their side effects.
+  ZoneList<int> block_side_effects_;
+
+  // A map of loop header block IDs to their loop's side effects.
+  ZoneList<int> loop_side_effects_;
+
+  // Used when collecting side effects on paths from dominator to
+  // dominated.
+  SparseSet visited_on_paths_;
+};
+
+
+bool HGlobalValueNumberer::Analyze() {
+  ComputeBlockSideEffects();
+  if (FLAG_loop_invariant_code_motion) {
+    LoopInvariantCodeMotion();
+  }
+  HValueMap* map = new(zone()) HValueMap();
+  AnalyzeBlock(graph_->entry_block(), map);
+  return removed_side_effects_;
+}
+
+
+void HGlobalValueNumberer::ComputeBlockSideEffects() {
+  for (int i = graph_->blocks()->length() - 1; i >= 0; --i) {
+    // Compute side effects for the block.
+    HBasicBlock* block = graph_->blocks()->at(i);
+    HInstruction* instr = block->first();
+    int id = block->block_id();
+    int side_effects = 0;
+    while (instr != NULL) {
+      side_effects |= instr->ChangesFlags();
+      instr = instr->next();
+    }
+    block_side_effects_[id] |= side_effects;
+
+    // Loop headers are part of their loop.
+    if (block->IsLoopHeader()) {
+      loop_side_effects_[id] |= side_effects;
+    }
+
+    // Propagate loop side effects upwards.
+    if (block->HasParentLoopHeader()) {
+      int header_id = block->parent_loop_header()->block_id();
+      loop_side_effects_[header_id] |=
+          block->IsLoopHeader() ? loop_side_effects_[id] : side_effects;
+    }
+  }
+}
+
+
+void HGlobalValueNumberer::LoopInvariantCodeMotion() {
+  for (int i = graph_->blocks()->length() - 1; i >= 0; --i) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    if (block->IsLoopHeader()) {
+      int side_effects = loop_side_effects_[block->block_id()];
+      TraceGVN("Try loop invariant motion for block B%d effects=0x%x\n",
+               block->block_id(),
+               side_effects);
+
+      HBasicBlock* last = block->loop_information()->GetLastBackEdge();
+      for (int j = block->block_id(); j <= last->block_id(); ++j) {
+        ProcessLoopBlock(graph_->blocks()->at(j), block, side_effects);
+      }
+    }
+  }
+}
+
+
+void HGlobalValueNumberer::ProcessLoopBlock(HBasicBlock* block,
+                                            HBasicBlock* loop_header,
+                                            int loop_kills) {
+  HBasicBlock* pre_header = loop_header->predecessors()->at(0);
+  int depends_flags = HValue::ConvertChangesToDependsFlags(loop_kills);
+  TraceGVN("Loop invariant motion for B%d depends_flags=0x%x\n",
+           block->block_id(),
+           depends_flags);
+  HInstruction* instr = block->first();
+  while (instr != NULL) {
+    HInstruction* next = instr->next();
+    if (instr->CheckFlag(HValue::kUseGVN) &&
+        (instr->flags() & depends_flags) == 0) {
+      TraceGVN("Checking instruction %d (%s)\n",
+               instr->id(),
+               instr->Mnemonic());
+      bool inputs_loop_invariant = true;
+      for (int i = 0; i < instr->OperandCount(); ++i) {
+        if (instr->OperandAt(i)->IsDefinedAfter(pre_header)) {
+          inputs_loop_invariant = false;
+        }
+      }
+
+      if (inputs_loop_invariant && ShouldMove(instr, loop_header)) {
+        TraceGVN("Found loop invariant instruction %d\n", instr->id());
+        // Move the instruction out of the loop.
+        instr->Unlink();
+        instr->InsertBefore(pre_header->end());
+      }
+    }
+    instr = next;
+  }
+}
+
+
+bool HGlobalValueNumberer::AllowCodeMotion() {
+  return info()->shared_info()->opt_count() + 1 < Compiler::kDefaultMaxOptCount;
+}
+
+
+bool HGlobalValueNumberer::ShouldMove(HInstruction* instr,
+                                      HBasicBlock* loop_header) {
+  // If we've disabled code motion or we're in a block that unconditionally
+  // deoptimizes, don't move any instructions.
+  return AllowCodeMotion() && !instr->block()->IsDeoptimizing();
+}
+
+
+int HGlobalValueNumberer::CollectSideEffectsOnPathsToDominatedBlock(
+    HBasicBlock* dominator, HBasicBlock* dominated) {
+  int side_effects = 0;
+  for (int i = 0; i < dominated->predecessors()->length(); ++i) {
+    HBasicBlock* block = dominated->predecessors()->at(i);
+    if (dominator->block_id() < block->block_id() &&
+        block->block_id() < dominated->block_id() &&
+        visited_on_paths_.Add(block->block_id())) {
+      side_effects |= block_side_effects_[block->block_id()];
+      if (block->IsLoopHeader()) {
+        side_effects |= loop_side_effects_[block->block_id()];
+      }
+      side_effects |= CollectSideEffectsOnPathsToDominatedBlock(
+          dominator, block);
+    }
+  }
+  return side_effects;
+}
+
+
+void HGlobalValueNumberer::AnalyzeBlock(HBasicBlock* block, HValueMap* map) {
+  TraceGVN("Analyzing block B%d%s\n",
+           block->block_id(),
+           block->IsLoopHeader() ? " (loop header)" : "");
+
+  // If this is a loop header kill everything killed by the loop.
+  if (block->IsLoopHeader()) {
+    map->Kill(loop_side_effects_[block->block_id()]);
+  }
+
+  // Go through all instructions of the current block.
+  HInstruction* instr = block->first();
+  while (instr != NULL) {
+    HInstruction* next = instr->next();
+    int flags = instr->ChangesFlags();
+    if (flags != 0) {
+      // Clear all instructions in the map that are affected by side effects.
+      map->Kill(flags);
+      TraceGVN("Instruction %d kills\n", instr->id());
+    }
+    if (instr->CheckFlag(HValue::kUseGVN)) {
+      ASSERT(!instr->HasObservableSideEffects());
+      HValue* other = map->Lookup(instr);
+      if (other != NULL) {
+        ASSERT(instr->Equals(other) && other->Equals(instr));
+        TraceGVN("Replacing value %d (%s) with value %d (%s)\n",
+                 instr->id(),
+                 instr->Mnemonic(),
+                 other->id(),
+                 other->Mnemonic());
+        if (instr->HasSideEffects()) removed_side_effects_ = true;
+        instr->DeleteAndReplaceWith(other);
+      } else {
+        map->Add(instr);
+      }
+    }
+    instr = next;
+  }
+
+  // Recursively continue analysis for all immediately dominated blocks.
+  int length = block->dominated_blocks()->length();
+  for (int i = 0; i < length; ++i) {
+    HBasicBlock* dominated = block->dominated_blocks()->at(i);
+    // No need to copy the map for the last child in the dominator tree.
+    HValueMap* successor_map = (i == length - 1) ? map : map->Copy(zone());
+
+    // Kill everything killed on any path between this block and the
+    // dominated block.
+    // We don't have to traverse these paths if the value map is
+    // already empty.
+    // If the range of block ids (block_id, dominated_id) is empty
+    // there are no such paths.
+    if (!successor_map->IsEmpty() &&
+        block->block_id() + 1 < dominated->block_id()) {
+      visited_on_paths_.Clear();
+      successor_map->Kill(CollectSideEffectsOnPathsToDominatedBlock(block,
+                                                                    dominated));
+    }
+    AnalyzeBlock(dominated, successor_map);
+  }
+}
+
+
+class HInferRepresentation BASE_EMBEDDED {
+ public:
+  explicit HInferRepresentation(HGraph* graph)
+      : graph_(graph), worklist_(8), in_worklist_(graph->GetMaximumValueID()) {}
+
+  void Analyze();
+
+ private:
+  Representation TryChange(HValue* current);
+  void AddToWorklist(HValue* current);
+  void InferBasedOnInputs(HValue* current);
+  void AddDependantsToWorklist(HValue* current);
+  void InferBasedOnUses(HValue* current);
+
+  Zone* zone() { return graph_->zone(); }
+
+  HGraph* graph_;
+  ZoneList<HValue*> worklist_;
+  BitVector in_worklist_;
+};
+
+
+void HInferRepresentation::AddToWorklist(HValue* current) {
+  if (current->representation().IsSpecialization()) return;
+  if (!current->CheckFlag(HValue::kFlexibleRepresentation)) return;
+  if (in_worklist_.Contains(current->id())) return;
+  worklist_.Add(current);
+  in_worklist_.Add(current->id());
+}
+
+
+// This method tries to specialize the representation type of the value
+// given as a parameter. The value is asked to infer its representation type
+// based on its inputs. If the inferred type is more specialized, then this
+// becomes the new representation type of the node.
+void HInferRepresentation::InferBasedOnInputs(HValue* current) {
+  Representation r = current->representation();
+  if (r.IsSpecialization()) return;
+  ASSERT(current->CheckFlag(HValue::kFlexibleRepresentation));
+  Representation inferred = current->InferredRepresentation();
+  if (inferred.IsSpecialization()) {
+    current->ChangeRepresentation(inferred);
+    AddDependantsToWorklist(current);
+  }
+}
+
+
+void HInferRepresentation::AddDependantsToWorklist(HValue* value) {
+  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
+    AddToWorklist(it.value());
+  }
+  for (int i = 0; i < value->OperandCount(); ++i) {
+    AddToWorklist(value->OperandAt(i));
+  }
+}
+
+
+// This method calculates whether specializing the representation of the value
+// given as the parameter has a benefit in terms of less necessary type
+// conversions. If there is a benefit, then the representation of the value is
+// specialized.
+void HInferRepresentation::InferBasedOnUses(HValue* value) {
+  Representation r = value->representation();
+  if (r.IsSpecialization() || value->HasNoUses()) return;
+  ASSERT(value->CheckFlag(HValue::kFlexibleRepresentation));
+  Representation new_rep = TryChange(value);
+  if (!new_rep.IsNone()) {
+    if (!value->representation().Equals(new_rep)) {
+      value->ChangeRepresentation(new_rep);
+      AddDependantsToWorklist(value);
+    }
+  }
+}
+
+
+Representation HInferRepresentation::TryChange(HValue* value) {
+  // Array of use counts for each representation.
+  int use_count[Representation::kNumRepresentations] = { 0 };
+
+  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    Representation rep = use->RequiredInputRepresentation(it.index());
+    if (rep.IsNone()) continue;
+    if (use->IsPhi()) HPhi::cast(use)->AddIndirectUsesTo(&use_count[0]);
+    ++use_count[rep.kind()];
+  }
+  int tagged_count = use_count[Representation::kTagged];
+  int double_count = use_count[Representation::kDouble];
+  int int32_count = use_count[Representation::kInteger32];
+  int non_tagged_count = double_count + int32_count;
+
+  // If a non-loop phi has tagged uses, don't convert it to untagged.
+  if (value->IsPhi() && !value->block()->IsLoopHeader() && tagged_count > 0) {
+    return Representation::None();
+  }
+
+  // Prefer unboxing over boxing, the latter is more expensive.
+  if (tagged_count > non_tagged_count) return Representation::None();
+
+  // Prefer Integer32 over Double, if possible.
+  if (int32_count > 0 && value->IsConvertibleToInteger()) {
+    return Representation::Integer32();
+  }
+
+  if (double_count > 0) return Representation::Double();
+
+  return Representation::None();
+}
+
+
+void HInferRepresentation::Analyze() {
+  HPhase phase("Infer representations", graph_);
+
+  // (1) Initialize bit vectors and count real uses. Each phi gets a
+  // bit-vector of length <number of phis>.
+  const ZoneList<HPhi*>* phi_list = graph_->phi_list();
+  int phi_count = phi_list->length();
+  ZoneList<BitVector*> connected_phis(phi_count);
+  for (int i = 0; i < phi_count; ++i) {
+    phi_list->at(i)->InitRealUses(i);
+    BitVector* connected_set = new(zone()) BitVector(phi_count);
+    connected_set->Add(i);
+    connected_phis.Add(connected_set);
+  }
+
+  // (2) Do a fixed point iteration to find the set of connected phis.  A
+  // phi is connected to another phi if its value is used either directly or
+  // indirectly through a transitive closure of the def-use relation.
+  bool change = true;
+  while (change) {
+    change = false;
+    // We normally have far more "forward edges" than "backward edges",
+    // so we terminate faster when we walk backwards.
+    for (int i = phi_count - 1; i >= 0; --i) {
+      HPhi* phi = phi_list->at(i);
+      for (HUseIterator it(phi->uses()); !it.Done(); it.Advance()) {
+        HValue* use = it.value();
+        if (use->IsPhi()) {
+          int id = HPhi::cast(use)->phi_id();
+          if (connected_phis[i]->UnionIsChanged(*connected_phis[id]))
+            change = true;
+        }
+      }
+    }
+  }
+
+  // (3) Use the phi reachability information from step 2 to
+  //     (a) sum up the non-phi use counts of all connected phis.
+  //     (b) push information about values which can't be converted to integer
+  //         without deoptimization through the phi use-def chains, avoiding
+  //         unnecessary deoptimizations later.
+  for (int i = 0; i < phi_count; ++i) {
+    HPhi* phi = phi_list->at(i);
+    bool cti = phi->AllOperandsConvertibleToInteger();
+    for (BitVector::Iterator it(connected_phis.at(i));
+         !it.Done();
+         it.Advance()) {
+      int index = it.Current();
+      HPhi* it_use = phi_list->at(it.Current());
+      if (index != i) phi->AddNonPhiUsesFrom(it_use);  // Don't count twice!
+      if (!cti) it_use->set_is_convertible_to_integer(false);
+    }
+  }
+
+  // Initialize work list
+  for (int i = 0; i < graph_->blocks()->length(); ++i) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    const ZoneList<HPhi*>* phis = block->phis();
+    for (int j = 0; j < phis->length(); ++j) {
+      AddToWorklist(phis->at(j));
+    }
+
+    HInstruction* current = block->first();
+    while (current != NULL) {
+      AddToWorklist(current);
+      current = current->next();
+    }
+  }
+
+  // Do a fixed point iteration, trying to improve representations
+  while (!worklist_.is_empty()) {
+    HValue* current = worklist_.RemoveLast();
+    in_worklist_.Remove(current->id());
+    InferBasedOnInputs(current);
+    InferBasedOnUses(current);
+  }
+}
+
+
+void HGraph::InitializeInferredTypes() {
+  HPhase phase("Inferring types", this);
+  InitializeInferredTypes(0, this->blocks_.length() - 1);
+}
+
+
+void HGraph::InitializeInferredTypes(int from_inclusive, int to_inclusive) {
+  for (int i = from_inclusive; i <= to_inclusive; ++i) {
+    HBasicBlock* block = blocks_[i];
+
+    const ZoneList<HPhi*>* phis = block->phis();
+    for (int j = 0; j < phis->length(); j++) {
+      phis->at(j)->UpdateInferredType();
+    }
+
+    HInstruction* current = block->first();
+    while (current != NULL) {
+      current->UpdateInferredType();
+      current = current->next();
+    }
+
+    if (block->IsLoopHeader()) {
+      HBasicBlock* last_back_edge =
+          block->loop_information()->GetLastBackEdge();
+      InitializeInferredTypes(i + 1, last_back_edge->block_id());
+      // Skip all blocks already processed by the recursive call.
+      i = last_back_edge->block_id();
+      // Update phis of the loop header now after the whole loop body is
+      // guaranteed to be processed.
+      ZoneList<HValue*> worklist(block->phis()->length());
+      for (int j = 0; j < block->phis()->length(); ++j) {
+        worklist.Add(block->phis()->at(j));
+      }
+      InferTypes(&worklist);
+    }
+  }
+}
+
+
+void HGraph::PropagateMinusZeroChecks(HValue* value, BitVector* visited) {
+  HValue* current = value;
+  while (current != NULL) {
+    if (visited->Contains(current->id())) return;
+
+    // For phis, we must propagate the check to all of its inputs.
+    if (current->IsPhi()) {
+      visited->Add(current->id());
+      HPhi* phi = HPhi::cast(current);
+      for (int i = 0; i < phi->OperandCount(); ++i) {
+        PropagateMinusZeroChecks(phi->OperandAt(i), visited);
+      }
+      break;
+    }
+
+    // For multiplication and division, we must propagate to the left and
+    // the right side.
+    if (current->IsMul()) {
+      HMul* mul = HMul::cast(current);
+      mul->EnsureAndPropagateNotMinusZero(visited);
+      PropagateMinusZeroChecks(mul->left(), visited);
+      PropagateMinusZeroChecks(mul->right(), visited);
+    } else if (current->IsDiv()) {
+      HDiv* div = HDiv::cast(current);
+      div->EnsureAndPropagateNotMinusZero(visited);
+      PropagateMinusZeroChecks(div->left(), visited);
+      PropagateMinusZeroChecks(div->right(), visited);
+    }
+
+    current = current->EnsureAndPropagateNotMinusZero(visited);
+  }
+}
+
+
+void HGraph::InsertRepresentationChangeForUse(HValue* value,
+                                              HValue* use_value,
+                                              int use_index,
+                                              Representation to) {
+  // Insert the representation change right before its use. For phi-uses we
+  // insert at the end of the corresponding predecessor.
+  HInstruction* next = NULL;
+  if (use_value->IsPhi()) {
+    next = use_value->block()->predecessors()->at(use_index)->end();
+  } else {
+    next = HInstruction::cast(use_value);
+  }
+
+  // For constants we try to make the representation change at compile
+  // time. When a representation change is not possible without loss of
+  // information we treat constants like normal instructions and insert the
+  // change instructions for them.
+  HInstruction* new_value = NULL;
+  bool is_truncating = use_value->CheckFlag(HValue::kTruncatingToInt32);
+  bool deoptimize_on_undefined =
+      use_value->CheckFlag(HValue::kDeoptimizeOnUndefined);
+  if (value->IsConstant()) {
+    HConstant* constant = HConstant::cast(value);
+    // Try to create a new copy of the constant with the new representation.
+    // Truncation allocates a heap number, which the optimizing compiler
+    // thread cannot do; it inserts a change instruction instead.
+    if (!is_truncating) {
+      new_value = constant->CopyToRepresentation(to);
+    } else if (!info()->is_concurrent()) {
+      new_value = constant->CopyToTruncatedInt32();
+    }
+  }
+
+  if (new_value == NULL) {
+    new_value = new(zone()) HChange(value, to,
+                                    is_truncating, deoptimize_on_undefined);
+  }
+
+  new_value->InsertBefore(next);
+  use_value->SetOperandAt(use_index, new_value);
+}
+
+
+void HGraph::InsertRepresentationChangesForValue(HValue* value) {
+  Representation r = value->representation();
+  if (r.IsNone()) return;
+  if (value->HasNoUses()) return;
+
+  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
+    HValue* use_value = it.value();
+    int use_index = it.index();
+    Representation req = use_value->RequiredInputRepresentation(use_index);
+    if (req.IsNone() || req.Equals(r)) continue;
+    InsertRepresentationChangeForUse(value, use_value, use_index, req);
+  }
+  if (value->HasNoUses()) {
+    ASSERT(value->IsConstant());
+    value->DeleteAndReplaceWith(NULL);
+  }
+
+  // The only purpose of a HForceRepresentation is to represent the value
+  // after the (possible) HChange instruction.  We make it disappear.
+  if (value->IsForceRepresentation()) {
+    value->DeleteAndReplaceWith(HForceRepresentation::cast(value)->value());
+  }
+}
+
+
+void HGraph::InsertRepresentationChanges() {
+  HPhase phase("Insert representation changes", this);
+
+
+  // Compute truncation flag for phis: Initially assume that all
+  // int32-phis allow truncation and iteratively remove the ones that
+  // are used in an operation that does not allow a truncating
+  // conversion.
+  // TODO(fschneider): Replace this with a worklist-based iteration.
+  for (int i = 0; i < phi_list()->length(); i++) {
+    HPhi* phi = phi_list()->at(i);
+    if (phi->representation().IsInteger32()) {
+      phi->SetFlag(HValue::kTruncatingToInt32);
+    }
+  }
+  bool change = true;
+  while (change) {
+    change = false;
+    for (int i = 0; i < phi_list()->length(); i++) {
+      HPhi* phi = phi_list()->at(i);
+      if (!phi->CheckFlag(HValue::kTruncatingToInt32)) continue;
+      for (HUseIterator it(phi->uses()); !it.Done(); it.Advance()) {
+        HValue* use = it.value();
+        if (!use->CheckFlag(HValue::kTruncatingToInt32)) {
+          phi->ClearFlag(HValue::kTruncatingToInt32);
+          change = true;
+          break;
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < blocks_.length(); ++i) {
+    // Process phi instructions first.
+    const ZoneList<HPhi*>* phis = blocks_[i]->phis();
+    for (int j = 0; j < phis->length(); j++) {
+      InsertRepresentationChangesForValue(phis->at(j));
+    }
+
+    // Process normal instructions.
+    HInstruction* current = blocks_[i]->first();
+    while (current != NULL) {
+      InsertRepresentationChangesForValue(current);
+      current = current->next();
+    }
+  }
+}
+
+
+void HGraph::RecursivelyMarkPhiDeoptimizeOnUndefined(HPhi* phi) {
+  if (phi->CheckFlag(HValue::kDeoptimizeOnUndefined)) return;
+  phi->SetFlag(HValue::kDeoptimizeOnUndefined);
+  for (int i = 0; i < phi->OperandCount(); ++i) {
+    HValue* input = phi->OperandAt(i);
+    if (input->IsPhi()) {
+      RecursivelyMarkPhiDeoptimizeOnUndefined(HPhi::cast(input));
+    }
+  }
+}
+
+
+void HGraph::MarkDeoptimizeOnUndefined() {
+  HPhase phase("MarkDeoptimizeOnUndefined", this);
+  // Compute DeoptimizeOnUndefined flag for phis.
+  // Any phi that can reach a use with DeoptimizeOnUndefined set must
+  // have DeoptimizeOnUndefined set.  Currently only HCompareIDAndBranch, with
+  // double input representation, has this flag set.
+  // The flag is used by HChange tagged->double, which must deoptimize
+  // if one of its uses has this flag set.
+  for (int i = 0; i < phi_list()->length(); i++) {
+    HPhi* phi = phi_list()->at(i);
+    if (phi->representation().IsDouble()) {
+      for (HUseIterator it(phi->uses()); !it.Done(); it.Advance()) {
+        if (it.value()->CheckFlag(HValue::kDeoptimizeOnUndefined)) {
+          RecursivelyMarkPhiDeoptimizeOnUndefined(phi);
+          break;
+        }
+      }
+    }
+  }
+}
+
+
+void HGraph::MarkTruncatingDivisions() {
+  HPhase phase("MarkTruncatingDivisions", this);
+  // A division of int32 values has a double representation when its type
+  // feedback saw fractional results.  If all its uses truncate the result
+  // to int32, as in x / y | 0, an integer division computes the same value.
+  for (int i = 0; i < blocks_.length(); ++i) {
+    for (HInstruction* current = blocks_[i]->first();
+         current != NULL;
+         current = current->next()) {
+      if (!current->IsDiv() || !current->representation().IsDouble()) {
+        continue;
+      }
+      HDiv* div = HDiv::cast(current);
+      if (!div->left()->representation().IsInteger32() ||
+          !div->right()->representation().IsInteger32() ||
+          div->HasNoUses()) {
+        continue;
+      }
+      bool all_uses_truncating = true;
+      for (HUseIterator it(div->uses()); !it.Done(); it.Advance()) {
+        HValue* use = it.value();
+        if (use->IsPhi() || !use->CheckFlag(HValue::kTruncatingToInt32)) {
+          all_uses_truncating = false;
+          break;
+        }
+      }
+      if (all_uses_truncating) div->ChangeToTruncatingInteger32Division();
+    }
+  }
+}
+
+
+void HGraph::ComputeMinusZeroChecks() {
+  BitVector visited(GetMaximumValueID());
+  for (int i = 0; i < blocks_.length(); ++i) {
+    for (HInstruction* current = blocks_[i]->first();
+         current != NULL;
+         current = current->next()) {
+      if (current->IsChange()) {
+        HChange* change = HChange::cast(current);
+        // Propagate flags for negative zero checks upwards from conversions
+        // int32-to-tagged and int32-to-double.
+        Representation from = change->value()->representation();
+        ASSERT(from.Equals(change->from()));
+        if (from.IsInteger32()) {
+          ASSERT(change->to().IsTagged() || change->to().IsDouble());
+          ASSERT(visited.IsEmpty());
+          PropagateMinusZeroChecks(change->value(), &visited);
+          visited.Clear();
+        }
+      }
+    }
+  }
+}
+
+
+// Implementation of utility class to encapsulate the translation state for
+// a (possibly inlined) function.
+FunctionState::FunctionState(HGraphBuilder* owner,
+                             CompilationInfo* info,
+                             TypeFeedbackOracle* oracle,
+                             bool drop_extra)
+    : owner_(owner),
+      compilation_info_(info),
+      oracle_(oracle),
+      call_context_(NULL),
+      drop_extra_(drop_extra),
+      function_return_(NULL),
+      test_context_(NULL),
+      entry_(NULL),
+      arguments_object_(NULL),
+      arguments_elements_(NULL),
+      outer_(owner->function_state()) {
+  if (outer_ != NULL) {
+    // State for an inline function.
+    if (owner->ast_context()->IsTest()) {
+      HBasicBlock* if_true = owner->graph()->CreateBasicBlock();
+      HBasicBlock* if_false = owner->graph()->CreateBasicBlock();
+      if_true->MarkAsInlineReturnTarget();
+      if_false->MarkAsInlineReturnTarget();
+      Expression* cond = TestContext::cast(owner->ast_context())->condition();
+      // The AstContext constructor pushed on the context stack.  This newed
+      // instance is the reason that AstContext can't be BASE_EMBEDDED.
+      test_context_ = new TestContext(owner, cond, if_true, if_false);
+    } else {
+      function_return_ = owner->graph()->CreateBasicBlock();
+      function_return()->MarkAsInlineReturnTarget();
+    }
+    // Set this after possibly allocating a new TestContext above.
+    call_context_ = owner->ast_context();
+  }
+
+  // Push on the state stack.
+  owner->set_function_state(this);
+}
+
+
+FunctionState::~FunctionState() {
+  delete test_context_;
+  owner_->set_function_state(outer_);
+}
+
+
+// Implementation of utility classes to represent an expression's context in
+// the AST.
+AstContext::AstContext(HGraphBuilder* owner, Expression::Context kind)
+    : owner_(owner),
+      kind_(kind),
+      outer_(owner->ast_context()),
+      for_typeof_(false) {
+  owner->set_ast_context(this);  // Push.
+#ifdef DEBUG
+  original_length_ = owner->environment()->length();
+#endif
+}
+
+
+AstContext::~AstContext() {
+  owner_->set_ast_context(outer_);  // Pop.
+}
+
+
+EffectContext::~EffectContext() {
+  ASSERT(owner()->HasStackOverflow() ||
+         owner()->current_block() == NULL ||
+         owner()->environment()->length() == original_length_);
+}
+
+
+ValueContext::~ValueContext() {
+  ASSERT(owner()->HasStackOverflow() ||
+         owner()->current_block() == NULL ||
+         owner()->environment()->length() == original_length_ + 1);
+}
+
+
+void EffectContext::ReturnValue(HValue* value) {
+  // The value is simply ignored.
+}
+
+
+void ValueContext::ReturnValue(HValue* value) {
+  // The value is tracked in the bailout environment, and communicated
+  // through the environment as the result of the expression.
+  if (!arguments_allowed() && value->CheckFlag(HValue::kIsArguments)) {
+    owner()->Bailout("bad value context for arguments value");
+  }
+  owner()->Push(value);
+}
+
+
+void TestContext::ReturnValue(HValue* value) {
+  BuildBranch(value);
+}
+
+
+void EffectContext::ReturnInstruction(HInstruction* instr, int ast_id) {
+  ASSERT(!instr->IsControlInstruction());
+  owner()->AddInstruction(instr);
+  if (instr->HasObservableSideEffects()) owner()->AddSimulate(ast_id);
+}
+
+
+void EffectContext::ReturnControl(HControlInstruction* instr, int ast_id) {
+  ASSERT(!instr->HasObservableSideEffects());
+  HBasicBlock* empty_true = owner()->graph()->CreateBasicBlock();
+  HBasicBlock* empty_false = owner()->graph()->CreateBasicBlock();
+  instr->SetSuccessorAt(0, empty_true);
+  instr->SetSuccessorAt(1, empty_false);
+  owner()->current_block()->Finish(instr);
+  HBasicBlock* join = owner()->CreateJoin(empty_true, empty_false, ast_id);
+  owner()->set_current_block(join);
+}
+
+
+void ValueContext::ReturnInstruction(HInstruction* instr, int ast_id) {
+  ASSERT(!instr->IsControlInstruction());
+  if (!arguments_allowed() && instr->CheckFlag(HValue::kIsArguments)) {
+    return owner()->Bailout("bad value context for arguments object value");
+  }
+  owner()->AddInstruction(instr);
+  owner()->Push(instr);
+  if (instr->HasObservableSideEffects()) owner()->AddSimulate(ast_id);
+}
+
+
+void ValueContext::ReturnControl(HControlInstruction* instr, int ast_id) {
+  ASSERT(!instr->HasObservableSideEffects());
+  if (!arguments_allowed() && instr->CheckFlag(HValue::kIsArguments)) {
+    return owner()->Bailout("bad value context for arguments object value");
+  }
+  HBasicBlock* materialize_false = owner()->graph()->CreateBasicBlock();
+  HBasicBlock* materialize_true = owner()->graph()->CreateBasicBlock();
+  instr->SetSuccessorAt(0, materialize_true);
+  instr->SetSuccessorAt(1, materialize_false);
+  owner()->current_block()->Finish(instr);
+  owner()->set_current_block(materialize_true);
+  owner()->Push(owner()->graph()->GetConstantTrue());
+  owner()->set_current_block(materialize_false);
+  owner()->Push(owner()->graph()->GetConstantFalse());
+  HBasicBlock* join =
+    owner()->CreateJoin(materialize_true, materialize_false, ast_id);
+  owner()->set_current_block(join);
+}
+
+
+void TestContext::ReturnInstruction(HInstruction* instr, int ast_id) {
+  ASSERT(!instr->IsControlInstruction());
+  HGraphBuilder* builder = owner();
+  builder->AddInstruction(instr);
+  // We expect a simulate after every expression with side effects, though
+  // this one isn't actually needed (and wouldn't work if it were targeted).
+  if (instr->HasObservableSideEffects()) {
+    builder->Push(instr);
+    builder->AddSimulate(ast_id);
+    builder->Pop();
+  }
+  BuildBranch(instr);
+}
+
+
+void TestContext::ReturnControl(HControlInstruction* instr, int ast_id) {
+  ASSERT(!instr->HasObservableSideEffects());
+  HBasicBlock* empty_true = owner()->graph()->CreateBasicBlock();
+  HBasicBlock* empty_false = owner()->graph()->CreateBasicBlock();
+  instr->SetSuccessorAt(0, empty_true);
+  instr->SetSuccessorAt(1, empty_false);
+  owner()->current_block()->Finish(instr);
+  empty_true->Goto(if_true(), owner()->function_state()->drop_extra());
+  empty_false->Goto(if_false(), owner()->function_state()->drop_extra());
+  owner()->set_current_block(NULL);
+}
+
+
+void TestContext::BuildBranch(HValue* value) {
+  // We expect the graph to be in edge-split form: there is no edge that
+  // connects a branch node to a join node.  We conservatively ensure that
+  // property by always adding an empty block on the outgoing edges of this
+  // branch.
+  HGraphBuilder* builder = owner();
+  if (value != NULL && value->CheckFlag(HValue::kIsArguments)) {
+    builder->Bailout("arguments object value in a test context");
+  }
+  HBasicBlock* empty_true = builder->graph()->CreateBasicBlock();
+  HBasicBlock* empty_false = builder->graph()->CreateBasicBlock();
+  unsigned test_id = condition()->test_id();
+  ToBooleanStub::Types expected(builder->oracle()->ToBooleanTypes(test_id));
+  HBranch* test = new(zone()) HBranch(value, empty_true, empty_false, expected);
+  builder->current_block()->Finish(test);
+
+  empty_true->Goto(if_true(), owner()->function_state()->drop_extra());
+  empty_false->Goto(if_false(), owner()->function_state()->drop_extra());
+  builder->set_current_block(NULL);
+}
+
+
+// HGraphBuilder infrastructure for bailing out and checking bailouts.
+#define CHECK_BAILOUT(call)                     \
+  do {                                          \
+    call;                                       \
+    if (HasStackOverflow()) return;             \
+  } while (false)
+
+
+#define CHECK_ALIVE(call)                                       \
+  do {                                                          \
+    call;                                                       \
+    if (HasStackOverflow() || current_block() == NULL) return;  \
+  } while (false)
+
+
+void HGraphBuilder::Bailout(const char* reason) {
+  if (FLAG_trace_bailout) {
+    SmartArrayPointer<char> name(
+        info()->shared_info()->DebugName()->ToCString());
+    PrintF("Bailout in HGraphBuilder: @\"%s\": %s\n", *name, reason);
+  }
+  info()->set_bailout_reason(reason);
+  SetStackOverflow();
+}
+
+
+void HGraphBuilder::VisitForEffect(Expression* expr) {
+  EffectContext for_effect(this);
+  Visit(expr);
+}
+
+
+void HGraphBuilder::VisitForValue(Expression* expr, ArgumentsAllowedFlag flag) {
+  ValueContext for_value(this, flag);
+  Visit(expr);
+}
+
+
+void HGraphBuilder::VisitForTypeOf(Expression* expr) {
+  ValueContext for_value(this, ARGUMENTS_NOT_ALLOWED);
+  for_value.set_for_typeof(true);
+  Visit(expr);
+}
+
+
+
+void HGraphBuilder::VisitForControl(Expression* expr,
+                                    HBasicBlock* true_block,
+                                    HBasicBlock* false_block) {
+  TestContext for_test(this, expr, true_block, false_block);
+  Visit(expr);
+}
+
+
+HValue* HGraphBuilder::VisitArgument(Expression* expr) {
+  VisitForValue(expr);
+  if (HasStackOverflow() || current_block() == NULL) return NULL;
+  HValue* value = Pop();
+  Push(AddInstruction(new(zone()) HPushArgument(value)));
+  return value;
+}
+
+
+void HGraphBuilder::VisitArgumentList(ZoneList<Expression*>* arguments) {
+  for (int i = 0; i < arguments->length(); i++) {
+    CHECK_ALIVE(VisitArgument(arguments->at(i)));
+  }
+}
+
+
+void HGraphBuilder::VisitExpressions(ZoneList<Expression*>* exprs) {
+  for (int i = 0; i < exprs->length(); ++i) {
+    CHECK_ALIVE(VisitForValue(exprs->at(i)));
   }
 }
 
 
-void HGraph::PropagateMinusZeroChecks(HValue* value, BitVector* visited) {
-  HValue* current = value;
-  while (current != NULL) {
-    if (visited->Contains(current->id())) return;
+// Whether the type feedback of a named call says that it is a call of
+// Function.prototype.apply on a function.
+static bool IsFunctionApplyCall(Call* expr) {
+  if (!expr->IsMonomorphic() || expr->check_type() != RECEIVER_MAP_CHECK) {
+    return false;
+  }
+  Handle<Map> function_map = expr->GetReceiverTypes()->first();
+  return function_map->instance_type() == JS_FUNCTION_TYPE &&
+      expr->target()->shared()->HasBuiltinFunctionId() &&
+      expr->target()->shared()->builtin_function_id() == kFunctionApply;
+}
 
-    // For phis, we must propagate the check to all of its inputs.
-    if (current->IsPhi()) {
-      visited->Add(current->id());
-      HPhi* phi = HPhi::cast(current);
-      for (int i = 0; i < phi->OperandCount(); ++i) {
-        PropagateMinusZeroChecks(phi->OperandAt(i), visited);
-      }
-      break;
-    }
 
-    // For multiplication and division, we must propagate to the left and
-    // the right side.
-    if (current->IsMul()) {
-      HMul* mul = HMul::cast(current);
-      mul->EnsureAndPropagateNotMinusZero(visited);
-      PropagateMinusZeroChecks(mul->left(), visited);
-      PropagateMinusZeroChecks(mul->right(), visited);
-    } else if (current->IsDiv()) {
-      HDiv* div = HDiv::cast(current);
-      div->EnsureAndPropagateNotMinusZero(visited);
-      PropagateMinusZeroChecks(div->left(), visited);
-      PropagateMinusZeroChecks(div->right(), visited);
-    }
+// Decides whether the arguments object of a function escapes.  It does
+// not if it is only used for its length, to load its elements and as the
+// arguments array of Function.prototype.apply, which optimized code does
+// without allocating it.
+class ArgumentsEscapeChecker: public AstVisitor {
+ public:
+  ArgumentsEscapeChecker(Variable* arguments, TypeFeedbackOracle* oracle)
+      : arguments_(arguments), oracle_(oracle), escapes_(false) { }
 
-    current = current->EnsureAndPropagateNotMinusZero(visited);
+  bool Check(FunctionLiteral* function) {
+    VisitStatements(function->body());
+    return escapes_ || HasStackOverflow();
   }
-}
 
+ private:
+  // AST node visit functions.
+#define DECLARE_VISIT(type) virtual void Visit##type(type* node);
+  AST_NODE_LIST(DECLARE_VISIT)
+#undef DECLARE_VISIT
 
-void HGraph::InsertRepresentationChangeForUse(HValue* value,
-                                              HValue* use_value,
-                                              int use_index,
-                                              Representation to) {
-  // Insert the representation change right before its use. For phi-uses we
-  // insert at the end of the corresponding predecessor.
-  HInstruction* next = NULL;
-  if (use_value->IsPhi()) {
-    next = use_value->block()->predecessors()->at(use_index)->end();
-  } else {
-    next = HInstruction::cast(use_value);
+  bool IsArguments(Expression* expr) {
+    VariableProxy* proxy = expr->AsVariableProxy();
+    return proxy != NULL && proxy->var() == arguments_;
   }
 
-  // For constants we try to make the representation change at compile
-  // time. When a representation change is not possible without loss of
-  // information we treat constants like normal instructions and insert the
-  // change instructions for them.
-  HInstruction* new_value = NULL;
-  bool is_truncating = use_value->CheckFlag(HValue::kTruncatingToInt32);
-  bool deoptimize_on_undefined =
-      use_value->CheckFlag(HValue::kDeoptimizeOnUndefined);
-  if (value->IsConstant()) {
-    HConstant* constant = HConstant::cast(value);
-    // Try to create a new copy of the constant with the new representation.
-    new_value = is_truncating
-        ? constant->CopyToTruncatedInt32()
-        : constant->CopyToRepresentation(to);
+  void VisitOptional(AstNode* node) {
+    if (node != NULL) Visit(node);
   }
 
-  if (new_value == NULL) {
-    new_value = new(zone()) HChange(value, to,
-                                    is_truncating, deoptimize_on_undefined);
+  // Stores to, calls of and deletes of elements of the arguments object
+  // need the object.
+  void VisitReference(Expression* expr) {
+    Property* property = expr->AsProperty();
+    if (property != NULL && IsArguments(property->obj())) {
+      escapes_ = true;
+    } else {
+      Visit(expr);
+    }
   }
 
-  new_value->InsertBefore(next);
-  use_value->SetOperandAt(use_index, new_value);
+  Variable* arguments_;
+  TypeFeedbackOracle* oracle_;
+  bool escapes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArgumentsEscapeChecker);
+};
+
+
+void ArgumentsEscapeChecker::VisitDeclaration(Declaration* decl) {
+  // Declared functions have arguments objects of their own.
 }
 
 
-void HGraph::InsertRepresentationChangesForValue(HValue* value) {
-  Representation r = value->representation();
-  if (r.IsNone()) return;
-  if (value->HasNoUses()) return;
+void ArgumentsEscapeChecker::VisitBlock(Block* stmt) {
+  VisitStatements(stmt->statements());
+}
 
-  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
-    HValue* use_value = it.value();
-    int use_index = it.index();
-    Representation req = use_value->RequiredInputRepresentation(use_index);
-    if (req.IsNone() || req.Equals(r)) continue;
-    InsertRepresentationChangeForUse(value, use_value, use_index, req);
-  }
-  if (value->HasNoUses()) {
-    ASSERT(value->IsConstant());
-    value->DeleteAndReplaceWith(NULL);
-  }
 
-  // The only purpose of a HForceRepresentation is to represent the value
-  // after the (possible) HChange instruction.  We make it disappear.
-  if (value->IsForceRepresentation()) {
-    value->DeleteAndReplaceWith(HForceRepresentation::cast(value)->value());
-  }
+void ArgumentsEscapeChecker::VisitExpressionStatement(
+    ExpressionStatement* stmt) {
+  Visit(stmt->expression());
 }
 
 
-void HGraph::InsertRepresentationChanges() {
-  HPhase phase("Insert representation changes", this);
+void ArgumentsEscapeChecker::VisitEmptyStatement(EmptyStatement* stmt) {
+}
 
 
-  // Compute truncation flag for phis: Initially assume that all
-  // int32-phis allow truncation and iteratively remove the ones that
-  // are used in an operation that does not allow a truncating
-  // conversion.
-  // TODO(fschneider): Replace this with a worklist-based iteration.
-  for (int i = 0; i < phi_list()->length(); i++) {
-    HPhi* phi = phi_list()->at(i);
-    if (phi->representation().IsInteger32()) {
-      phi->SetFlag(HValue::kTruncatingToInt32);
-    }
-  }
-  bool change = true;
-  while (change) {
-    change = false;
-    for (int i = 0; i < phi_list()->length(); i++) {
-      HPhi* phi = phi_list()->at(i);
-      if (!phi->CheckFlag(HValue::kTruncatingToInt32)) continue;
-      for (HUseIterator it(phi->uses()); !it.Done(); it.Advance()) {
-        HValue* use = it.value();
-        if (!use->CheckFlag(HValue::kTruncatingToInt32)) {
-          phi->ClearFlag(HValue::kTruncatingToInt32);
-          change = true;
-          break;
-        }
-      }
-    }
-  }
+void ArgumentsEscapeChecker::VisitIfStatement(IfStatement* stmt) {
+  Visit(stmt->condition());
+  Visit(stmt->then_statement());
+  Visit(stmt->else_statement());
+}
 
-  for (int i = 0; i < blocks_.length(); ++i) {
-    // Process phi instructions first.
-    const ZoneList<HPhi*>* phis = blocks_[i]->phis();
-    for (int j = 0; j < phis->length(); j++) {
-      InsertRepresentationChangesForValue(phis->at(j));
-    }
 
-    // Process normal instructions.
-    HInstruction* current = blocks_[i]->first();
-    while (current != NULL) {
-      InsertRepresentationChangesForValue(current);
-      current = current->next();
-    }
-  }
+void ArgumentsEscapeChecker::VisitContinueStatement(ContinueStatement* stmt) {
 }
 
 
-void HGraph::RecursivelyMarkPhiDeoptimizeOnUndefined(HPhi* phi) {
-  if (phi->CheckFlag(HValue::kDeoptimizeOnUndefined)) return;
-  phi->SetFlag(HValue::kDeoptimizeOnUndefined);
-  for (int i = 0; i < phi->OperandCount(); ++i) {
-    HValue* input = phi->OperandAt(i);
-    if (input->IsPhi()) {
-      RecursivelyMarkPhiDeoptimizeOnUndefined(HPhi::cast(input));
-    }
-  }
+void ArgumentsEscapeChecker::VisitBreakStatement(BreakStatement* stmt) {
 }
 
 
-void HGraph::MarkDeoptimizeOnUndefined() {
-  HPhase phase("MarkDeoptimizeOnUndefined", this);
-  // Compute DeoptimizeOnUndefined flag for phis.
-  // Any phi that can reach a use with DeoptimizeOnUndefined set must
-  // have DeoptimizeOnUndefined set.  Currently only HCompareIDAndBranch, with
-  // double input representation, has this flag set.
-  // The flag is used by HChange tagged->double, which must deoptimize
-  // if one of its uses has this flag set.
-  for (int i = 0; i < phi_list()->length(); i++) {
-    HPhi* phi = phi_list()->at(i);
-    if (phi->representation().IsDouble()) {
-      for (HUseIterator it(phi->uses()); !it.Done(); it.Advance()) {
-        if (it.value()->CheckFlag(HValue::kDeoptimizeOnUndefined)) {
-          RecursivelyMarkPhiDeoptimizeOnUndefined(phi);
-          break;
-        }
-      }
-    }
-  }
+void ArgumentsEscapeChecker::VisitReturnStatement(ReturnStatement* stmt) {
+  Visit(stmt->expression());
 }
 
 
-void HGraph::ComputeMinusZeroChecks() {
-  BitVector visited(GetMaximumValueID());
-  for (int i = 0; i < blocks_.length(); ++i) {
-    for (HInstruction* current = blocks_[i]->first();
-         current != NULL;
-         current = current->next()) {
-      if (current->IsChange()) {
-        HChange* change = HChange::cast(current);
-        // Propagate flags for negative zero checks upwards from conversions
-        // int32-to-tagged and int32-to-double.
-        Representation from = change->value()->representation();
-        ASSERT(from.Equals(change->from()));
-        if (from.IsInteger32()) {
-          ASSERT(change->to().IsTagged() || change->to().IsDouble());
-          ASSERT(visited.IsEmpty());
-          PropagateMinusZeroChecks(change->value(), &visited);
-          visited.Clear();
-        }
-      }
-    }
-  }
+void ArgumentsEscapeChecker::VisitWithStatement(WithStatement* stmt) {
+  Visit(stmt->expression());
+  Visit(stmt->statement());
 }
 
 
-// Implementation of utility class to encapsulate the translation state for
-// a (possibly inlined) function.
-FunctionState::FunctionState(HGraphBuilder* owner,
-                             CompilationInfo* info,
-                             TypeFeedbackOracle* oracle,
-                             bool drop_extra)
-    : owner_(owner),
-      compilation_info_(info),
-      oracle_(oracle),
-      call_context_(NULL),
-      drop_extra_(drop_extra),
-      function_return_(NULL),
-      test_context_(NULL),
-      outer_(owner->function_state()) {
-  if (outer_ != NULL) {
-    // State for an inline function.
-    if (owner->ast_context()->IsTest()) {
-      HBasicBlock* if_true = owner->graph()->CreateBasicBlock();
-      HBasicBlock* if_false = owner->graph()->CreateBasicBlock();
-      if_true->MarkAsInlineReturnTarget();
-      if_false->MarkAsInlineReturnTarget();
-      Expression* cond = TestContext::cast(owner->ast_context())->condition();
-      // The AstContext constructor pushed on the context stack.  This newed
-      // instance is the reason that AstContext can't be BASE_EMBEDDED.
-      test_context_ = new TestContext(owner, cond, if_true, if_false);
-    } else {
-      function_return_ = owner->graph()->CreateBasicBlock();
-      function_return()->MarkAsInlineReturnTarget();
-    }
-    // Set this after possibly allocating a new TestContext above.
-    call_context_ = owner->ast_context();
+void ArgumentsEscapeChecker::VisitSwitchStatement(SwitchStatement* stmt) {
+  Visit(stmt->tag());
+  ZoneList<CaseClause*>* clauses = stmt->cases();
+  for (int i = 0; i < clauses->length(); i++) {
+    CaseClause* clause = clauses->at(i);
+    if (!clause->is_default()) Visit(clause->label());
+    VisitStatements(clause->statements());
   }
-
-  // Push on the state stack.
-  owner->set_function_state(this);
 }
 
 
-FunctionState::~FunctionState() {
-  delete test_context_;
-  owner_->set_function_state(outer_);
+void ArgumentsEscapeChecker::VisitDoWhileStatement(DoWhileStatement* stmt) {
+  Visit(stmt->body());
+  Visit(stmt->cond());
 }
 
 
-// Implementation of utility classes to represent an expression's context in
-// the AST.
-AstContext::AstContext(HGraphBuilder* owner, Expression::Context kind)
-    : owner_(owner),
-      kind_(kind),
-      outer_(owner->ast_context()),
-      for_typeof_(false) {
-  owner->set_ast_context(this);  // Push.
-#ifdef DEBUG
-  original_length_ = owner->environment()->length();
-#endif
+void ArgumentsEscapeChecker::VisitWhileStatement(WhileStatement* stmt) {
+  Visit(stmt->cond());
+  Visit(stmt->body());
 }
 
 
-AstContext::~AstContext() {
-  owner_->set_ast_context(outer_);  // Pop.
+void ArgumentsEscapeChecker::VisitForStatement(ForStatement* stmt) {
+  VisitOptional(stmt->init());
+  VisitOptional(stmt->cond());
+  VisitOptional(stmt->next());
+  Visit(stmt->body());
 }
 
 
-EffectContext::~EffectContext() {
-  ASSERT(owner()->HasStackOverflow() ||
-         owner()->current_block() == NULL ||
-         owner()->environment()->length() == original_length_);
+void ArgumentsEscapeChecker::VisitForInStatement(ForInStatement* stmt) {
+  VisitReference(stmt->each());
+  Visit(stmt->enumerable());
+  Visit(stmt->body());
 }
 
 
-ValueContext::~ValueContext() {
-  ASSERT(owner()->HasStackOverflow() ||
-         owner()->current_block() == NULL ||
-         owner()->environment()->length() == original_length_ + 1);
+void ArgumentsEscapeChecker::VisitTryCatchStatement(TryCatchStatement* stmt) {
+  Visit(stmt->try_block());
+  Visit(stmt->catch_block());
 }
 
 
-void EffectContext::ReturnValue(HValue* value) {
-  // The value is simply ignored.
+void ArgumentsEscapeChecker::VisitTryFinallyStatement(
+    TryFinallyStatement* stmt) {
+  Visit(stmt->try_block());
+  Visit(stmt->finally_block());
 }
 
 
-void ValueContext::ReturnValue(HValue* value) {
-  // The value is tracked in the bailout environment, and communicated
-  // through the environment as the result of the expression.
-  if (!arguments_allowed() && value->CheckFlag(HValue::kIsArguments)) {
-    owner()->Bailout("bad value context for arguments value");
-  }
-  owner()->Push(value);
+void ArgumentsEscapeChecker::VisitDebuggerStatement(DebuggerStatement* stmt) {
 }
 
 
-void TestContext::ReturnValue(HValue* value) {
-  BuildBranch(value);
+void ArgumentsEscapeChecker::VisitFunctionLiteral(FunctionLiteral* expr) {
+}
+
+
+void ArgumentsEscapeChecker::VisitSharedFunctionInfoLiteral(
+    SharedFunctionInfoLiteral* expr) {
 }
 
 
-void EffectContext::ReturnInstruction(HInstruction* instr, int ast_id) {
-  ASSERT(!instr->IsControlInstruction());
-  owner()->AddInstruction(instr);
-  if (instr->HasObservableSideEffects()) owner()->AddSimulate(ast_id);
+void ArgumentsEscapeChecker::VisitConditional(Conditional* expr) {
+  Visit(expr->condition());
+  Visit(expr->then_expression());
+  Visit(expr->else_expression());
 }
 
 
-void EffectContext::ReturnControl(HControlInstruction* instr, int ast_id) {
-  ASSERT(!instr->HasObservableSideEffects());
-  HBasicBlock* empty_true = owner()->graph()->CreateBasicBlock();
-  HBasicBlock* empty_false = owner()->graph()->CreateBasicBlock();
-  instr->SetSuccessorAt(0, empty_true);
-  instr->SetSuccessorAt(1, empty_false);
-  owner()->current_block()->Finish(instr);
-  HBasicBlock* join = owner()->CreateJoin(empty_true, empty_false, ast_id);
-  owner()->set_current_block(join);
+void ArgumentsEscapeChecker::VisitVariableProxy(VariableProxy* expr) {
+  if (expr->var() == arguments_) escapes_ = true;
 }
 
 
-void ValueContext::ReturnInstruction(HInstruction* instr, int ast_id) {
-  ASSERT(!instr->IsControlInstruction());
-  if (!arguments_allowed() && instr->CheckFlag(HValue::kIsArguments)) {
-    return owner()->Bailout("bad value context for arguments object value");
-  }
-  owner()->AddInstruction(instr);
-  owner()->Push(instr);
-  if (instr->HasObservableSideEffects()) owner()->AddSimulate(ast_id);
+void ArgumentsEscapeChecker::VisitLiteral(Literal* expr) {
 }
 
 
-void ValueContext::ReturnControl(HControlInstruction* instr, int ast_id) {
-  ASSERT(!instr->HasObservableSideEffects());
-  if (!arguments_allowed() && instr->CheckFlag(HValue::kIsArguments)) {
-    return owner()->Bailout("bad value context for arguments object value");
-  }
-  HBasicBlock* materialize_false = owner()->graph()->CreateBasicBlock();
-  HBasicBlock* materialize_true = owner()->graph()->CreateBasicBlock();
-  instr->SetSuccessorAt(0, materialize_true);
-  instr->SetSuccessorAt(1, materialize_false);
-  owner()->current_block()->Finish(instr);
-  owner()->set_current_block(materialize_true);
-  owner()->Push(owner()->graph()->GetConstantTrue());
-  owner()->set_current_block(materialize_false);
-  owner()->Push(owner()->graph()->GetConstantFalse());
-  HBasicBlock* join =
-    owner()->CreateJoin(materialize_true, materialize_false, ast_id);
-  owner()->set_current_block(join);
+void ArgumentsEscapeChecker::VisitRegExpLiteral(RegExpLiteral* expr) {
 }
 
 
-void TestContext::ReturnInstruction(HInstruction* instr, int ast_id) {
-  ASSERT(!instr->IsControlInstruction());
-  HGraphBuilder* builder = owner();
-  builder->AddInstruction(instr);
-  // We expect a simulate after every expression with side effects, though
-  // this one isn't actually needed (and wouldn't work if it were targeted).
-  if (instr->HasObservableSideEffects()) {
-    builder->Push(instr);
-    builder->AddSimulate(ast_id);
-    builder->Pop();
+void ArgumentsEscapeChecker::VisitObjectLiteral(ObjectLiteral* expr) {
+  ZoneList<ObjectLiteral::Property*>* properties = expr->properties();
+  for (int i = 0; i < properties->length(); i++) {
+    Visit(properties->at(i)->value());
   }
-  BuildBranch(instr);
 }
 
 
-void TestContext::ReturnControl(HControlInstruction* instr, int ast_id) {
-  ASSERT(!instr->HasObservableSideEffects());
-  HBasicBlock* empty_true = owner()->graph()->CreateBasicBlock();
-  HBasicBlock* empty_false = owner()->graph()->CreateBasicBlock();
-  instr->SetSuccessorAt(0, empty_true);
-  instr->SetSuccessorAt(1, empty_false);
-  owner()->current_block()->Finish(instr);
-  empty_true->Goto(if_true(), owner()->function_state()->drop_extra());
-  empty_false->Goto(if_false(), owner()->function_state()->drop_extra());
-  owner()->set_current_block(NULL);
+void ArgumentsEscapeChecker::VisitArrayLiteral(ArrayLiteral* expr) {
+  VisitExpressions(expr->values());
 }
 
 
-void TestContext::BuildBranch(HValue* value) {
-  // We expect the graph to be in edge-split form: there is no edge that
-  // connects a branch node to a join node.  We conservatively ensure that
-  // property by always adding an empty block on the outgoing edges of this
-  // branch.
-  HGraphBuilder* builder = owner();
-  if (value != NULL && value->CheckFlag(HValue::kIsArguments)) {
-    builder->Bailout("arguments object value in a test context");
-  }
-  HBasicBlock* empty_true = builder->graph()->CreateBasicBlock();
-  HBasicBlock* empty_false = builder->graph()->CreateBasicBlock();
-  unsigned test_id = condition()->test_id();
-  ToBooleanStub::Types expected(builder->oracle()->ToBooleanTypes(test_id));
-  HBranch* test = new(zone()) HBranch(value, empty_true, empty_false, expected);
-  builder->current_block()->Finish(test);
-
-  empty_true->Goto(if_true(), owner()->function_state()->drop_extra());
-  empty_false->Goto(if_false(), owner()->function_state()->drop_extra());
-  builder->set_current_block(NULL);
+void ArgumentsEscapeChecker::VisitAssignment(Assignment* expr) {
+  VisitReference(expr->target());
+  Visit(expr->value());
 }
 
 
-// HGraphBuilder infrastructure for bailing out and checking bailouts.
-#define CHECK_BAILOUT(call)                     \
-  do {                                          \
-    call;                                       \
-    if (HasStackOverflow()) return;             \
-  } while (false)
+void ArgumentsEscapeChecker::VisitThrow(Throw* expr) {
+  Visit(expr->exception());
+}
 
 
-#define CHECK_ALIVE(call)                                       \
-  do {                                                          \
-    call;                                                       \
-    if (HasStackOverflow() || current_block() == NULL) return;  \
-  } while (false)
+void ArgumentsEscapeChecker::VisitProperty(Property* expr) {
+  if (IsArguments(expr->obj())) {
+    if (expr->key()->IsPropertyName()) {
+      Handle<String> name = expr->key()->AsLiteral()->AsPropertyName();
+      if (!name->IsEqualTo(CStrVector("length"))) escapes_ = true;
+    } else {
+      Visit(expr->key());
+    }
+    return;
+  }
+  Visit(expr->obj());
+  Visit(expr->key());
+}
 
 
-void HGraphBuilder::Bailout(const char* reason) {
-  if (FLAG_trace_bailout) {
-    SmartArrayPointer<char> name(
-        info()->shared_info()->DebugName()->ToCString());
-    PrintF("Bailout in HGraphBuilder: @\"%s\": %s\n", *name, reason);
+void ArgumentsEscapeChecker::VisitCall(Call* expr) {
+  Property* callee = expr->expression()->AsProperty();
+  ZoneList<Expression*>* arguments = expr->arguments();
+  if (callee != NULL &&
+      callee->key()->IsPropertyName() &&
+      arguments->length() == 2 &&
+      IsArguments(arguments->at(1))) {
+    expr->RecordTypeFeedback(oracle_, CALL_AS_METHOD);
+    if (IsFunctionApplyCall(expr)) {
+      Visit(callee->obj());
+      Visit(arguments->at(0));
+      return;
+    }
   }
-  SetStackOverflow();
+  VisitReference(expr->expression());
+  VisitExpressions(arguments);
 }
 
 
-void HGraphBuilder::VisitForEffect(Expression* expr) {
-  EffectContext for_effect(this);
-  Visit(expr);
+void ArgumentsEscapeChecker::VisitCallNew(CallNew* expr) {
+  Visit(expr->expression());
+  VisitExpressions(expr->arguments());
 }
 
 
-void HGraphBuilder::VisitForValue(Expression* expr, ArgumentsAllowedFlag flag) {
-  ValueContext for_value(this, flag);
-  Visit(expr);
+void ArgumentsEscapeChecker::VisitCallRuntime(CallRuntime* expr) {
+  VisitExpressions(expr->arguments());
 }
 
 
-void HGraphBuilder::VisitForTypeOf(Expression* expr) {
-  ValueContext for_value(this, ARGUMENTS_NOT_ALLOWED);
-  for_value.set_for_typeof(true);
-  Visit(expr);
+void ArgumentsEscapeChecker::VisitUnaryOperation(UnaryOperation* expr) {
+  if (expr->op() == Token::DELETE) {
+    VisitReference(expr->expression());
+  } else {
+    Visit(expr->expression());
+  }
 }
 
 
+void ArgumentsEscapeChecker::VisitCountOperation(CountOperation* expr) {
+  VisitReference(expr->expression());
+}
 
-void HGraphBuilder::VisitForControl(Expression* expr,
-                                    HBasicBlock* true_block,
-                                    HBasicBlock* false_block) {
-  TestContext for_test(this, expr, true_block, false_block);
-  Visit(expr);
+
+void ArgumentsEscapeChecker::VisitBinaryOperation(BinaryOperation* expr) {
+  Visit(expr->left());
+  Visit(expr->right());
 }
 
 
-HValue* HGraphBuilder::VisitArgument(Expression* expr) {
-  VisitForValue(expr);
-  if (HasStackOverflow() || current_block() == NULL) return NULL;
-  HValue* value = Pop();
-  Push(AddInstruction(new(zone()) HPushArgument(value)));
-  return value;
+void ArgumentsEscapeChecker::VisitCompareOperation(CompareOperation* expr) {
+  Visit(expr->left());
+  Visit(expr->right());
 }
 
 
-void HGraphBuilder::VisitArgumentList(ZoneList<Expression*>* arguments) {
-  for (int i = 0; i < arguments->length(); i++) {
-    CHECK_ALIVE(VisitArgument(arguments->at(i)));
-  }
+void ArgumentsEscapeChecker::VisitThisFunction(ThisFunction* expr) {
 }
 
 
-void HGraphBuilder::VisitExpressions(ZoneList<Expression*>* exprs) {
-  for (int i = 0; i < exprs->length(); ++i) {
-    CHECK_ALIVE(VisitForValue(exprs->at(i)));
-  }
+static bool ArgumentsEscape(FunctionLiteral* function,
+                            Variable* arguments,
+                            TypeFeedbackOracle* oracle) {
+  ArgumentsEscapeChecker checker(arguments, oracle);
+  return checker.Check(function);
 }
 
 
@@ -2324,6 +4156,15 @@ HGraph* HGraphBuilder::CreateGraph() {
     body_entry->SetJoinId(AstNode::kFunctionEntryId);
     set_current_block(body_entry);
 
+    // An arguments object that escapes is allocated on entry.  Otherwise it
+    // is only used for its length and elements, which are read from the
+    // frame.
+    if (scope->arguments() != NULL &&
+        scope->arguments()->IsStackAllocated() &&
+        ArgumentsEscape(info()->function(), scope->arguments(), oracle())) {
+      AllocateArgumentsObject(scope->arguments());
+    }
+
     // Handle implicit declaration of the function name in named function
     // expressions before other declarations.
     if (scope->is_function_scope() && scope->function() != NULL) {
@@ -2367,19 +4208,31 @@ HGraph* HGraphBuilder::CreateGraph() {
   if (FLAG_eliminate_dead_phis) graph()->EliminateUnreachablePhis();
   graph()->CollectPhis();
 
-  HInferRepresentation rep(graph());
+  return graph();
+}
+
+
+void HGraph::Optimize() {
+  if (FLAG_escape_analysis) {
+    HPhase phase("Escape analysis", this);
+    HEscapeAnalysis escape_analysis(this);
+    escape_analysis.Analyze();
+  }
+
+  HInferRepresentation rep(this);
   rep.Analyze();
 
-  graph()->MarkDeoptimizeOnUndefined();
-  graph()->InsertRepresentationChanges();
+  MarkDeoptimizeOnUndefined();
+  MarkTruncatingDivisions();
+  InsertRepresentationChanges();
 
-  graph()->InitializeInferredTypes();
-  graph()->Canonicalize();
+  InitializeInferredTypes();
+  Canonicalize();
 
   // Perform common subexpression elimination and loop-invariant code motion.
   if (FLAG_use_gvn) {
-    HPhase phase("Global value numbering", graph());
-    HGlobalValueNumberer gvn(graph(), info());
+    HPhase phase("Global value numbering", this);
+    HGlobalValueNumberer gvn(this, info());
     bool removed_side_effects = gvn.Analyze();
     // Trigger a second analysis pass to further eliminate duplicate values that
     // could only be discovered by removing side-effect-generating instructions
@@ -2389,23 +4242,57 @@ HGraph* HGraphBuilder::CreateGraph() {
     }
   }
 
+  if (FLAG_check_elimination) {
+    HPhase phase("Map check elimination", this);
+    HCheckMapsEliminator cme(this);
+    cme.Process();
+  }
+
+  if (FLAG_load_elimination) {
+    HPhase phase("Load elimination", this);
+    HLoadStoreEliminator lse(this);
+    lse.Process();
+  }
+
   if (FLAG_use_range) {
-    HRangeAnalysis rangeAnalysis(graph());
+    HRangeAnalysis rangeAnalysis(this);
     rangeAnalysis.Analyze();
   }
-  graph()->ComputeMinusZeroChecks();
+  ComputeMinusZeroChecks();
+
+  if (FLAG_uint32_analysis) {
+    HPhase phase("Uint32 analysis", this);
+    HUint32Analysis uint32_analysis(this);
+    uint32_analysis.Analyze();
+  }
+
+  if (FLAG_array_bounds_checks_elimination) {
+    HPhase phase("Bounds check elimination", this);
+    HBoundsCheckEliminator bce(this);
+    bce.Process();
+  }
 
   // Eliminate redundant stack checks on backwards branches.
-  HStackCheckEliminator sce(graph());
+  HStackCheckEliminator sce(this);
   sce.Process();
 
+  if (FLAG_dead_code_elimination) {
+    HPhase phase("Dead code elimination", this);
+    HDeadCodeEliminator dce(this);
+    dce.Process();
+  }
+
+  if (FLAG_sink_instructions) {
+    HPhase phase("Instruction sinking", this);
+    HInstructionSinker sinker(this);
+    sinker.Process();
+  }
+
   // Replace the results of check instructions with the original value, if the
   // result is used. This is safe now, since we don't do code motion after this
   // point. It enables better register allocation since the value produced by
   // check instructions is really a copy of the original value.
-  graph()->ReplaceCheckedValues();
-
-  return graph();
+  ReplaceCheckedValues();
 }
 
 
@@ -2416,7 +4303,6 @@ void HGraph::ReplaceCheckedValues() {
     while (instr != NULL) {
       if (instr->IsBoundsCheck()) {
         // Replace all uses of the checked value with the original input.
-        ASSERT(instr->UseCount() > 0);
         instr->ReplaceAllUsesWith(HBoundsCheck::cast(instr)->index());
       }
       instr = instr->next();
@@ -2438,6 +4324,39 @@ void HGraphBuilder::AddSimulate(int ast_id) {
 }
 
 
+bool HGraphBuilder::IsUnstableDeoptimizationSite() {
+  SharedFunctionInfo* shared = *info()->shared_info();
+  if (!shared->deopt_history()->IsFixedArray()) return false;
+  // Deoptimization uses the environment of the closest simulate before
+  // the deoptimizing instruction, so its ast id identifies the site.
+  int ast_id = AstNode::kNoNumber;
+  HBasicBlock* block = current_block();
+  while (block != NULL && ast_id == AstNode::kNoNumber) {
+    for (HInstruction* instr = block->last();
+         instr != NULL;
+         instr = instr->previous()) {
+      if (instr->IsSimulate()) {
+        ast_id = HSimulate::cast(instr)->ast_id();
+        break;
+      }
+    }
+    block = block->predecessors()->is_empty()
+        ? NULL
+        : block->predecessors()->first();
+  }
+  if (ast_id == AstNode::kNoNumber) return false;
+  if (Deoptimizer::DeoptimizationCountAt(shared, ast_id) <
+      FLAG_max_deopts_per_site) {
+    return false;
+  }
+  if (FLAG_trace_deopt) {
+    SmartArrayPointer<char> name = shared->DebugName()->ToCString();
+    PrintF("[generic code at deoptimization site %s @%d]\n", *name, ast_id);
+  }
+  return true;
+}
+
+
 void HGraphBuilder::AddPhi(HPhi* instr) {
   ASSERT(current_block() != NULL);
   current_block()->AddPhi(instr);
@@ -2452,7 +4371,12 @@ void HGraphBuilder::PushAndAdd(HInstruction* instr) {
 
 template <int V>
 HInstruction* HGraphBuilder::PreProcessCall(HCall<V>* call) {
-  int count = call->argument_count();
+  PushArgumentsFromEnvironment(call->argument_count());
+  return call;
+}
+
+
+void HGraphBuilder::PushArgumentsFromEnvironment(int count) {
   ZoneList<HValue*> arguments(count);
   for (int i = 0; i < count; ++i) {
     arguments.Add(Pop());
@@ -2461,7 +4385,6 @@ HInstruction* HGraphBuilder::PreProcessCall(HCall<V>* call) {
   while (!arguments.is_empty()) {
     AddInstruction(new(zone()) HPushArgument(arguments.RemoveLast()));
   }
-  return call;
 }
 
 
@@ -2505,6 +4428,30 @@ void HGraphBuilder::SetupScope(Scope* scope) {
 }
 
 
+void HGraphBuilder::AllocateArgumentsObject(Variable* arguments) {
+  // The arguments object of a non-strict function with parameters maps its
+  // elements to the parameters, which the object allocated from the frame
+  // would not do.  Such a function bails out where the object escapes, as
+  // do natives, which have no arguments property.
+  if ((info()->is_classic_mode() && info()->scope()->num_parameters() > 0) ||
+      info()->shared_info()->native()) {
+    return;
+  }
+  HValue* context = environment()->LookupContext();
+  PushAndAdd(new(zone()) HThisFunction(info()->closure()));
+  HInstruction* object = PreProcessCall(new(zone()) HCallRuntime(
+      context,
+      isolate()->factory()->LookupAsciiSymbol("NewArgumentsFromOptimizedFrame"),
+      Runtime::FunctionForId(Runtime::kNewArgumentsFromOptimizedFrame),
+      1));
+  AddInstruction(object);
+  environment()->Bind(arguments, object);
+  // Unoptimized code allocates the arguments object before the function
+  // entry.
+  AddSimulate(AstNode::kFunctionEntryId);
+}
+
+
 void HGraphBuilder::VisitStatements(ZoneList<Statement*>* statements) {
   for (int i = 0; i < statements->length(); i++) {
     CHECK_ALIVE(Visit(statements->at(i)));
@@ -2604,15 +4551,19 @@ void HGraphBuilder::VisitIfStatement(IfStatement* stmt) {
 
 HBasicBlock* HGraphBuilder::BreakAndContinueScope::Get(
     BreakableStatement* stmt,
-    BreakType type) {
+    BreakType type,
+    int* drop_extra) {
+  *drop_extra = 0;
   BreakAndContinueScope* current = this;
   while (current != NULL && current->info()->target() != stmt) {
+    *drop_extra += current->info()->drop_extra();
     current = current->next();
   }
   ASSERT(current != NULL);  // Always found (unless stack is malformed).
   HBasicBlock* block = NULL;
   switch (type) {
     case BREAK:
+      *drop_extra += current->info()->drop_extra();
       block = current->info()->break_block();
       if (block == NULL) {
         block = current->owner()->graph()->CreateBasicBlock();
@@ -2637,7 +4588,10 @@ void HGraphBuilder::VisitContinueStatement(ContinueStatement* stmt) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
-  HBasicBlock* continue_block = break_scope()->Get(stmt->target(), CONTINUE);
+  int drop_extra = 0;
+  HBasicBlock* continue_block =
+      break_scope()->Get(stmt->target(), CONTINUE, &drop_extra);
+  Drop(drop_extra);
   current_block()->Goto(continue_block);
   set_current_block(NULL);
 }
@@ -2647,7 +4601,10 @@ void HGraphBuilder::VisitBreakStatement(BreakStatement* stmt) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
-  HBasicBlock* break_block = break_scope()->Get(stmt->target(), BREAK);
+  int drop_extra = 0;
+  HBasicBlock* break_block =
+      break_scope()->Get(stmt->target(), BREAK, &drop_extra);
+  Drop(drop_extra);
   current_block()->Goto(break_block);
   set_current_block(NULL);
 }
@@ -2696,122 +4653,346 @@ void HGraphBuilder::VisitWithStatement(WithStatement* stmt) {
 }
 
 
-void HGraphBuilder::VisitSwitchStatement(SwitchStatement* stmt) {
-  ASSERT(!HasStackOverflow());
-  ASSERT(current_block() != NULL);
-  ASSERT(current_block()->HasPredecessor());
-  // We only optimize switch statements with smi-literal smi comparisons,
-  // with a bounded number of clauses.
-  const int kCaseClauseLimit = 128;
+HGraphBuilder::SwitchTargets::SwitchTargets(HGraphBuilder* owner,
+                                            SwitchStatement* stmt)
+    : owner_(owner),
+      stmt_(stmt),
+      body_entries_(stmt->cases()->length()),
+      no_match_(NULL),
+      no_match_id_(stmt->ExitId()) {
   ZoneList<CaseClause*>* clauses = stmt->cases();
-  int clause_count = clauses->length();
-  if (clause_count > kCaseClauseLimit) {
-    return Bailout("SwitchStatement: too many clauses");
+  for (int i = 0; i < clauses->length(); ++i) {
+    body_entries_.Add(NULL);
+    // Without a match control goes to the default clause, if any.
+    if (clauses->at(i)->is_default()) no_match_id_ = clauses->at(i)->EntryId();
   }
+}
 
-  HValue* context = environment()->LookupContext();
 
-  CHECK_ALIVE(VisitForValue(stmt->tag()));
-  AddSimulate(stmt->EntryId());
-  HValue* tag_value = Pop();
-  HBasicBlock* first_test_block = current_block();
+void HGraphBuilder::SwitchTargets::GotoBody(HBasicBlock* block, int index) {
+  block->last_environment()->Drop(1);  // The tag.
+  body_entries_[index] = owner_->CreateJoin(
+      body_entries_[index], block, stmt_->cases()->at(index)->EntryId());
+}
 
-  SwitchType switch_type = UNKNOWN_SWITCH;
 
-  // 1. Extract clause type
-  for (int i = 0; i < clause_count; ++i) {
+void HGraphBuilder::SwitchTargets::GotoNoMatch(HBasicBlock* block) {
+  block->last_environment()->Drop(1);  // The tag.
+  no_match_ = owner_->CreateJoin(no_match_, block, no_match_id_);
+}
+
+
+static int CompareSwitchCases(const HGraphBuilder::SwitchCase* a,
+                              const HGraphBuilder::SwitchCase* b) {
+  if (a->key != b->key) return a->key < b->key ? -1 : 1;
+  return a->clause_index - b->clause_index;
+}
+
+
+// Label ranges of at most this size are tested one label after the other.
+static const int kSwitchLinearSearchLimit = 4;
+
+
+void HGraphBuilder::BuildSmiSwitch(SwitchTargets* targets, HValue* tag) {
+  ZoneList<CaseClause*>* clauses = targets->stmt()->cases();
+  ZoneList<SwitchCase> cases(clauses->length());
+  for (int i = 0; i < clauses->length(); ++i) {
+    CaseClause* clause = clauses->at(i);
+    if (clause->is_default()) continue;
+    SwitchCase c;
+    c.key = Smi::cast(*clause->label()->AsLiteral()->handle())->value();
+    c.clause_index = i;
+    cases.Add(c);
+  }
+  cases.Sort(CompareSwitchCases);
+
+  // Only the first of several clauses with the same label can match.
+  int length = 0;
+  for (int i = 0; i < cases.length(); ++i) {
+    if (length > 0 && cases[length - 1].key == cases[i].key) continue;
+    cases[length++] = cases[i];
+  }
+  cases.Rewind(length);
+
+  BuildSwitchSearch(targets, tag, NULL, &cases, 0, cases.length());
+}
+
+
+void HGraphBuilder::BuildStringSwitch(SwitchTargets* targets, HValue* tag) {
+  ZoneList<CaseClause*>* clauses = targets->stmt()->cases();
+  ZoneList<SwitchCase> cases(clauses->length());
+  for (int i = 0; i < clauses->length(); ++i) {
+    CaseClause* clause = clauses->at(i);
+    if (clause->is_default()) continue;
+    Handle<String> label =
+        Handle<String>::cast(clause->label()->AsLiteral()->handle());
+    SwitchCase c;
+    c.key = static_cast<int>(label->Hash());
+    c.clause_index = i;
+    cases.Add(c);
+  }
+  cases.Sort(CompareSwitchCases);
+
+  // Only the first of several clauses with the same label can match.  Equal
+  // labels have equal hashes, so they are next to each other.
+  int length = 0;
+  for (int i = 0; i < cases.length(); ++i) {
+    bool duplicate = false;
+    for (int j = length - 1; j >= 0 && cases[j].key == cases[i].key; --j) {
+      Handle<Object> first = clauses->at(cases[j].clause_index)->label()->
+          AsLiteral()->handle();
+      Handle<Object> other = clauses->at(cases[i].clause_index)->label()->
+          AsLiteral()->handle();
+      if (String::cast(*first)->Equals(String::cast(*other))) {
+        duplicate = true;
+        break;
+      }
+    }
+    if (!duplicate) cases[length++] = cases[i];
+  }
+  cases.Rewind(length);
+
+  // A tag that is not a string matches no label.
+  HBasicBlock* string_block = graph()->CreateBasicBlock();
+  HBasicBlock* not_string_block = graph()->CreateBasicBlock();
+  HIsStringAndBranch* string_check = new(zone()) HIsStringAndBranch(tag);
+  string_check->SetSuccessorAt(0, string_block);
+  string_check->SetSuccessorAt(1, not_string_block);
+  current_block()->Finish(string_check);
+  targets->GotoNoMatch(not_string_block);
+  set_current_block(string_block);
+
+  if (cases.length() <= kSwitchLinearSearchLimit) {
+    BuildStringCompareChain(targets, tag, &cases);
+    return;
+  }
+
+  // Symbols and strings used as property names or compared before have
+  // their hash computed.  The others are compared with all the labels.
+  HValue* context = environment()->LookupContext();
+  HInstruction* hash_field = AddInstruction(new(zone()) HStringHashField(tag));
+  HInstruction* flag_mask = AddInstruction(new(zone()) HConstant(
+      Handle<Object>(Smi::FromInt(String::kHashNotComputedMask)),
+      Representation::Integer32()));
+  HInstruction* not_computed = AddInstruction(new(zone()) HBitwise(
+      Token::BIT_AND, context, hash_field, flag_mask));
+  not_computed->AssumeRepresentation(Representation::Integer32());
+  HInstruction* zero = AddInstruction(new(zone()) HConstant(
+      Handle<Object>(Smi::FromInt(0)), Representation::Integer32()));
+  HCompareIDAndBranch* computed_check =
+      new(zone()) HCompareIDAndBranch(not_computed, zero, Token::EQ);
+  computed_check->SetInputRepresentation(Representation::Integer32());
+  HBasicBlock* computed_block = graph()->CreateBasicBlock();
+  HBasicBlock* not_computed_block = graph()->CreateBasicBlock();
+  computed_check->SetSuccessorAt(0, computed_block);
+  computed_check->SetSuccessorAt(1, not_computed_block);
+  current_block()->Finish(computed_check);
+
+  set_current_block(not_computed_block);
+  BuildStringCompareChain(targets, tag, &cases);
+
+  set_current_block(computed_block);
+  HInstruction* shift = AddInstruction(new(zone()) HConstant(
+      Handle<Object>(Smi::FromInt(String::kHashShift)),
+      Representation::Integer32()));
+  HInstruction* hash =
+      AddInstruction(new(zone()) HShr(context, hash_field, shift));
+  hash->AssumeRepresentation(Representation::Integer32());
+  BuildSwitchSearch(targets, hash, tag, &cases, 0, cases.length());
+}
+
+
+void HGraphBuilder::BuildGenericSwitch(SwitchTargets* targets, HValue* tag) {
+  HValue* context = environment()->LookupContext();
+  ZoneList<CaseClause*>* clauses = targets->stmt()->cases();
+  for (int i = 0; i < clauses->length(); ++i) {
     CaseClause* clause = clauses->at(i);
     if (clause->is_default()) continue;
 
-    if (switch_type == UNKNOWN_SWITCH) {
-      if (clause->label()->IsSmiLiteral()) {
-        switch_type = SMI_SWITCH;
-      } else if (clause->label()->IsStringLiteral()) {
-        switch_type = STRING_SWITCH;
+    CHECK_ALIVE(VisitForValue(clause->label()));
+    HValue* label_value = Pop();
+    HCompareGeneric* compare = new(zone()) HCompareGeneric(
+        context, tag, label_value, Token::EQ_STRICT);
+    // Strict equality is not observable, a deoptimization during the
+    // comparison goes back to the last label evaluated.
+    compare->ClearAllSideEffects();
+    AddInstruction(compare);
+
+    HBasicBlock* body_block = graph()->CreateBasicBlock();
+    HBasicBlock* next_test_block = graph()->CreateBasicBlock();
+    current_block()->Finish(
+        new(zone()) HBranch(compare, body_block, next_test_block));
+    targets->GotoBody(body_block, i);
+    set_current_block(next_test_block);
+  }
+  targets->GotoNoMatch(current_block());
+}
+
+
+void HGraphBuilder::BuildSwitchSearch(SwitchTargets* targets,
+                                      HValue* key,
+                                      HValue* tag,
+                                      ZoneList<SwitchCase>* cases,
+                                      int from,
+                                      int to) {
+  // Split the range between labels, keeping string labels with equal
+  // hashes together.
+  int middle = from + (to - from) / 2;
+  while (middle > from && cases->at(middle - 1).key == cases->at(middle).key) {
+    middle--;
+  }
+  if (to - from > kSwitchLinearSearchLimit && middle > from) {
+    HInstruction* middle_key = AddInstruction(new(zone()) HConstant(
+        Handle<Object>(Smi::FromInt(cases->at(middle).key)),
+        Representation::Integer32()));
+    HCompareIDAndBranch* compare =
+        new(zone()) HCompareIDAndBranch(key, middle_key, Token::LT);
+    compare->SetInputRepresentation(Representation::Integer32());
+    HBasicBlock* lower_block = graph()->CreateBasicBlock();
+    HBasicBlock* upper_block = graph()->CreateBasicBlock();
+    compare->SetSuccessorAt(0, lower_block);
+    compare->SetSuccessorAt(1, upper_block);
+    current_block()->Finish(compare);
+
+    set_current_block(lower_block);
+    BuildSwitchSearch(targets, key, tag, cases, from, middle);
+    set_current_block(upper_block);
+    BuildSwitchSearch(targets, key, tag, cases, middle, to);
+    return;
+  }
+
+  HValue* context = environment()->LookupContext();
+  for (int i = from; i < to; ++i) {
+    SwitchCase c = cases->at(i);
+    CaseClause* clause = targets->stmt()->cases()->at(c.clause_index);
+    HInstruction* case_key = AddInstruction(new(zone()) HConstant(
+        Handle<Object>(Smi::FromInt(c.key)), Representation::Integer32()));
+    HCompareIDAndBranch* compare =
+        new(zone()) HCompareIDAndBranch(key, case_key, Token::EQ_STRICT);
+    compare->SetInputRepresentation(Representation::Integer32());
+    HBasicBlock* match_block = graph()->CreateBasicBlock();
+    HBasicBlock* next_test_block = graph()->CreateBasicBlock();
+    compare->SetSuccessorAt(0, match_block);
+    compare->SetSuccessorAt(1, next_test_block);
+    current_block()->Finish(compare);
+
+    if (tag == NULL) {
+      targets->GotoBody(match_block, c.clause_index);
+    } else {
+      // The hashes are equal, compare the strings.
+      set_current_block(match_block);
+      HInstruction* label = AddInstruction(new(zone()) HConstant(
+          clause->label()->AsLiteral()->handle(), Representation::Tagged()));
+      HStringCompareAndBranch* string_compare =
+          new(zone()) HStringCompareAndBranch(context, tag, label,
+                                              Token::EQ_STRICT);
+      HBasicBlock* equal_block = graph()->CreateBasicBlock();
+      HBasicBlock* different_block = graph()->CreateBasicBlock();
+      string_compare->SetSuccessorAt(0, equal_block);
+      string_compare->SetSuccessorAt(1, different_block);
+      current_block()->Finish(string_compare);
+      targets->GotoBody(equal_block, c.clause_index);
+      if (i + 1 < to && cases->at(i + 1).key == c.key) {
+        // Another label has the same hash.
+        next_test_block = CreateJoin(next_test_block,
+                                     different_block,
+                                     targets->stmt()->EntryId());
       } else {
-        return Bailout("SwitchStatement: non-literal switch label");
+        targets->GotoNoMatch(different_block);
       }
-    } else if ((switch_type == STRING_SWITCH &&
-                !clause->label()->IsStringLiteral()) ||
-               (switch_type == SMI_SWITCH &&
-                !clause->label()->IsSmiLiteral())) {
-      return Bailout("SwitchStatemnt: mixed label types are not supported");
     }
+    set_current_block(next_test_block);
   }
+  targets->GotoNoMatch(current_block());
+}
+
 
-  HUnaryControlInstruction* string_check = NULL;
-  HBasicBlock* not_string_block = NULL;
+void HGraphBuilder::BuildStringCompareChain(SwitchTargets* targets,
+                                            HValue* tag,
+                                            ZoneList<SwitchCase>* cases) {
+  HValue* context = environment()->LookupContext();
+  for (int i = 0; i < cases->length(); ++i) {
+    int index = cases->at(i).clause_index;
+    CaseClause* clause = targets->stmt()->cases()->at(index);
+    HInstruction* label = AddInstruction(new(zone()) HConstant(
+        clause->label()->AsLiteral()->handle(), Representation::Tagged()));
+    HStringCompareAndBranch* compare =
+        new(zone()) HStringCompareAndBranch(context, tag, label,
+                                            Token::EQ_STRICT);
+    HBasicBlock* body_block = graph()->CreateBasicBlock();
+    HBasicBlock* next_test_block = graph()->CreateBasicBlock();
+    compare->SetSuccessorAt(0, body_block);
+    compare->SetSuccessorAt(1, next_test_block);
+    current_block()->Finish(compare);
+    targets->GotoBody(body_block, index);
+    set_current_block(next_test_block);
+  }
+  targets->GotoNoMatch(current_block());
+}
 
-  // Test switch's tag value if all clauses are string literals
-  if (switch_type == STRING_SWITCH) {
-    string_check = new(zone()) HIsStringAndBranch(tag_value);
-    first_test_block = graph()->CreateBasicBlock();
-    not_string_block = graph()->CreateBasicBlock();
 
-    string_check->SetSuccessorAt(0, first_test_block);
-    string_check->SetSuccessorAt(1, not_string_block);
-    current_block()->Finish(string_check);
+void HGraphBuilder::VisitSwitchStatement(SwitchStatement* stmt) {
+  ASSERT(!HasStackOverflow());
+  ASSERT(current_block() != NULL);
+  ASSERT(current_block()->HasPredecessor());
+  ZoneList<CaseClause*>* clauses = stmt->cases();
+  int clause_count = clauses->length();
 
-    set_current_block(first_test_block);
-  }
+  CHECK_ALIVE(VisitForValue(stmt->tag()));
+  AddSimulate(stmt->EntryId());
+  HValue* tag_value = Top();
 
-  // 2. Build all the tests, with dangling true branches
+  // 1. Extract clause type.  Switches on smi literals or on string literals
+  // are dispatched on the label values, the others compare the tag with
+  // each label in turn.
+  SwitchType switch_type = UNKNOWN_SWITCH;
+  CaseClause* first_clause = NULL;
   for (int i = 0; i < clause_count; ++i) {
     CaseClause* clause = clauses->at(i);
     if (clause->is_default()) continue;
 
-    if (switch_type == SMI_SWITCH) {
-      clause->RecordTypeFeedback(oracle());
+    SwitchType clause_type = GENERIC_SWITCH;
+    if (clause->label()->IsSmiLiteral()) {
+      clause_type = SMI_SWITCH;
+    } else if (clause->label()->IsStringLiteral()) {
+      clause_type = STRING_SWITCH;
     }
-
-    // Generate a compare and branch.
-    CHECK_ALIVE(VisitForValue(clause->label()));
-    HValue* label_value = Pop();
-
-    HBasicBlock* next_test_block = graph()->CreateBasicBlock();
-    HBasicBlock* body_block = graph()->CreateBasicBlock();
-
-    HControlInstruction* compare;
-
-    if (switch_type == SMI_SWITCH) {
-      if (!clause->IsSmiCompare()) {
-        // Finish with deoptimize and add uses of enviroment values to
-        // account for invisible uses.
-        current_block()->FinishExitWithDeoptimization(HDeoptimize::kUseAll);
-        set_current_block(NULL);
-        break;
-      }
-
-      HCompareIDAndBranch* compare_ =
-          new(zone()) HCompareIDAndBranch(tag_value,
-                                          label_value,
-                                          Token::EQ_STRICT);
-      compare_->SetInputRepresentation(Representation::Integer32());
-      compare = compare_;
-    } else {
-      compare = new(zone()) HStringCompareAndBranch(context, tag_value,
-                                                     label_value,
-                                                     Token::EQ_STRICT);
+    if (first_clause == NULL) {
+      first_clause = clause;
+      switch_type = clause_type;
+    } else if (switch_type != clause_type) {
+      switch_type = GENERIC_SWITCH;
     }
-
-    compare->SetSuccessorAt(0, body_block);
-    compare->SetSuccessorAt(1, next_test_block);
-    current_block()->Finish(compare);
-
-    set_current_block(next_test_block);
   }
 
-  // Save the current block to use for the default or to join with the
-  // exit.  This block is NULL if we deoptimized.
-  HBasicBlock* last_block = current_block();
+  // Every execution compares the tag with the first label, so the type
+  // feedback there says whether the tag has always been a smi.
+  if (switch_type == SMI_SWITCH) {
+    first_clause->RecordTypeFeedback(oracle());
+    if (!first_clause->IsSmiCompare()) switch_type = GENERIC_SWITCH;
+  }
 
-  if (not_string_block != NULL) {
-    last_block = CreateJoin(last_block, not_string_block, stmt->ExitId());
+  // 2. Build the tests.
+  SwitchTargets targets(this, stmt);
+  switch (switch_type) {
+    case UNKNOWN_SWITCH:
+      targets.GotoNoMatch(current_block());
+      break;
+    case SMI_SWITCH:
+      BuildSmiSwitch(&targets, tag_value);
+      break;
+    case STRING_SWITCH:
+      BuildStringSwitch(&targets, tag_value);
+      break;
+    case GENERIC_SWITCH:
+      CHECK_BAILOUT(BuildGenericSwitch(&targets, tag_value));
+      break;
   }
 
-  // 3. Loop over the clauses and the linked list of tests in lockstep,
-  // translating the clause bodies.
-  HBasicBlock* curr_test_block = first_test_block;
+  // The block to use for the default or to join with the exit, or NULL.
+  HBasicBlock* last_block = targets.no_match();
+
+  // 3. Loop over the clauses, translating the clause bodies.
   HBasicBlock* fall_through_block = NULL;
 
   BreakAndContinueInfo break_info(stmt);
@@ -2827,20 +5008,15 @@ void HGraphBuilder::VisitSwitchStatement(SwitchStatement* stmt) {
           normal_block = last_block;
           last_block = NULL;  // Cleared to indicate we've handled it.
         }
-      } else if (!curr_test_block->end()->IsDeoptimize()) {
-        normal_block = curr_test_block->end()->FirstSuccessor();
-        curr_test_block = curr_test_block->end()->SecondSuccessor();
+      } else {
+        normal_block = targets.body_entry(i);
       }
 
       // Identify a block to emit the body into.
       if (normal_block == NULL) {
         if (fall_through_block == NULL) {
           // (a) Unreachable.
-          if (clause->is_default()) {
-            continue;  // Might still be reachable clause bodies.
-          } else {
-            break;
-          }
+          continue;  // Might still be reachable clause bodies.
         } else {
           // (b) Reachable only as fall through.
           set_current_block(fall_through_block);
@@ -2877,6 +5053,438 @@ void HGraphBuilder::VisitSwitchStatement(SwitchStatement* stmt) {
 }
 
 
+// Decides whether the body of a loop is small and simple enough to be
+// duplicated by peeling.  Only innermost loops are peeled, so the code
+// growth stays linear in the size of the function.
+class LoopPeelingChecker: public AstVisitor {
+ public:
+  LoopPeelingChecker() : node_count_(0), peelable_(true) { }
+
+  bool Check(Statement* body) {
+    if (!body->IsInlineable()) return false;
+    Visit(body);
+    return peelable_ && !HasStackOverflow();
+  }
+
+ private:
+  // AST node visit functions.
+#define DECLARE_VISIT(type) virtual void Visit##type(type* node);
+  AST_NODE_LIST(DECLARE_VISIT)
+#undef DECLARE_VISIT
+
+  void Count() {
+    if (++node_count_ > FLAG_max_peeled_loop_size) peelable_ = false;
+  }
+
+  void Reject() { peelable_ = false; }
+
+  int node_count_;
+  bool peelable_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopPeelingChecker);
+};
+
+
+void LoopPeelingChecker::VisitDeclaration(Declaration* decl) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitBlock(Block* stmt) {
+  Count();
+  VisitStatements(stmt->statements());
+}
+
+
+void LoopPeelingChecker::VisitExpressionStatement(ExpressionStatement* stmt) {
+  Count();
+  Visit(stmt->expression());
+}
+
+
+void LoopPeelingChecker::VisitEmptyStatement(EmptyStatement* stmt) {
+}
+
+
+void LoopPeelingChecker::VisitIfStatement(IfStatement* stmt) {
+  Count();
+  Visit(stmt->condition());
+  Visit(stmt->then_statement());
+  Visit(stmt->else_statement());
+}
+
+
+void LoopPeelingChecker::VisitContinueStatement(ContinueStatement* stmt) {
+  Count();
+}
+
+
+void LoopPeelingChecker::VisitBreakStatement(BreakStatement* stmt) {
+  Count();
+}
+
+
+void LoopPeelingChecker::VisitReturnStatement(ReturnStatement* stmt) {
+  Count();
+  Visit(stmt->expression());
+}
+
+
+void LoopPeelingChecker::VisitWithStatement(WithStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitSwitchStatement(SwitchStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitDoWhileStatement(DoWhileStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitWhileStatement(WhileStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitForStatement(ForStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitForInStatement(ForInStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitTryCatchStatement(TryCatchStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitTryFinallyStatement(TryFinallyStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitDebuggerStatement(DebuggerStatement* stmt) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitFunctionLiteral(FunctionLiteral* expr) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitSharedFunctionInfoLiteral(
+    SharedFunctionInfoLiteral* expr) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitConditional(Conditional* expr) {
+  Count();
+  Visit(expr->condition());
+  Visit(expr->then_expression());
+  Visit(expr->else_expression());
+}
+
+
+void LoopPeelingChecker::VisitVariableProxy(VariableProxy* expr) {
+  Count();
+}
+
+
+void LoopPeelingChecker::VisitLiteral(Literal* expr) {
+  Count();
+}
+
+
+void LoopPeelingChecker::VisitRegExpLiteral(RegExpLiteral* expr) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitObjectLiteral(ObjectLiteral* expr) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitArrayLiteral(ArrayLiteral* expr) {
+  Reject();
+}
+
+
+void LoopPeelingChecker::VisitAssignment(Assignment* expr) {
+  // The graph builder relies on seeing the hole flow into const
+  // initializations inside loops to detect repeated initialization.
+  if (expr->op() == Token::INIT_CONST) Reject();
+  Count();
+  Visit(expr->target());
+  Visit(expr->value());
+}
+
+
+void LoopPeelingChecker::VisitThrow(Throw* expr) {
+  Count();
+  Visit(expr->exception());
+}
+
+
+void LoopPeelingChecker::VisitProperty(Property* expr) {
+  Count();
+  Visit(expr->obj());
+  Visit(expr->key());
+}
+
+
+void LoopPeelingChecker::VisitCall(Call* expr) {
+  Count();
+  Visit(expr->expression());
+  VisitExpressions(expr->arguments());
+}
+
+
+void LoopPeelingChecker::VisitCallNew(CallNew* expr) {
+  Count();
+  Visit(expr->expression());
+  VisitExpressions(expr->arguments());
+}
+
+
+void LoopPeelingChecker::VisitCallRuntime(CallRuntime* expr) {
+  Count();
+  VisitExpressions(expr->arguments());
+}
+
+
+void LoopPeelingChecker::VisitUnaryOperation(UnaryOperation* expr) {
+  Count();
+  Visit(expr->expression());
+}
+
+
+void LoopPeelingChecker::VisitCountOperation(CountOperation* expr) {
+  Count();
+  Visit(expr->expression());
+}
+
+
+void LoopPeelingChecker::VisitBinaryOperation(BinaryOperation* expr) {
+  Count();
+  Visit(expr->left());
+  Visit(expr->right());
+}
+
+
+void LoopPeelingChecker::VisitCompareOperation(CompareOperation* expr) {
+  Count();
+  Visit(expr->left());
+  Visit(expr->right());
+}
+
+
+void LoopPeelingChecker::VisitThisFunction(ThisFunction* expr) {
+  Count();
+}
+
+
+bool HGraphBuilder::ShouldPeelLoop(IterationStatement* stmt) {
+  if (!FLAG_loop_peeling || HasOsrEntryAt(stmt)) return false;
+  LoopPeelingChecker checker;
+  return checker.Check(stmt->body());
+}
+
+
+void HGraphBuilder::VisitPeeledIteration(IterationStatement* stmt,
+                                         Expression* cond,
+                                         int body_id,
+                                         Statement* next,
+                                         HBasicBlock** peel_exit) {
+  *peel_exit = NULL;
+  if (cond != NULL && !cond->ToBooleanIsTrue()) {
+    HBasicBlock* body_entry = graph()->CreateBasicBlock();
+    HBasicBlock* cond_false = graph()->CreateBasicBlock();
+    CHECK_BAILOUT(VisitForControl(cond, body_entry, cond_false));
+    if (cond_false->HasPredecessor()) {
+      cond_false->SetJoinId(stmt->ExitId());
+      *peel_exit = cond_false;
+    }
+    if (!body_entry->HasPredecessor()) {
+      set_current_block(NULL);
+      return;
+    }
+    body_entry->SetJoinId(body_id);
+    set_current_block(body_entry);
+  }
+
+  // The peeled body has break and continue targets of its own.  It needs
+  // no stack check, the loop that follows it has one.
+  BreakAndContinueInfo break_info(stmt);
+  { BreakAndContinueScope push(&break_info, this);
+    CHECK_BAILOUT(Visit(stmt->body()));
+  }
+  HBasicBlock* body_exit =
+      JoinContinue(stmt, current_block(), break_info.continue_block());
+  set_current_block(body_exit);
+  if (next != NULL && body_exit != NULL) {
+    CHECK_BAILOUT(Visit(next));
+  }
+
+  HBasicBlock* break_block = break_info.break_block();
+  if (break_block != NULL) {
+    if (*peel_exit != NULL) (*peel_exit)->Goto(break_block);
+    break_block->SetJoinId(stmt->ExitId());
+    *peel_exit = break_block;
+  }
+}
+
+
+// Returns the stack-allocated variable expr refers to, or NULL.
+static Variable* StackVariableOf(Expression* expr) {
+  VariableProxy* proxy = expr->AsVariableProxy();
+  if (proxy == NULL) return NULL;
+  Variable* var = proxy->var();
+  return (var != NULL && var->IsStackAllocated()) ? var : NULL;
+}
+
+
+bool HGraphBuilder::MatchFastDoubleArrayOperand(Expression* expr,
+                                                Variable* index,
+                                                HValue** value,
+                                                bool* is_array) {
+  Property* prop = expr->AsProperty();
+  if (prop != NULL) {
+    Variable* array = StackVariableOf(prop->obj());
+    if (array == NULL || array == index) return false;
+    if (StackVariableOf(prop->key()) != index) return false;
+    *value = environment()->Lookup(array);
+    *is_array = true;
+    return true;
+  }
+  *is_array = false;
+  Literal* literal = expr->AsLiteral();
+  if (literal != NULL) {
+    if (!literal->handle()->IsNumber()) return false;
+    *value = AddInstruction(
+        new(zone()) HConstant(literal->handle(), Representation::Tagged()));
+    return true;
+  }
+  Variable* var = StackVariableOf(expr);
+  if (var == NULL || var == index) return false;
+  *value = environment()->Lookup(var);
+  return true;
+}
+
+
+void HGraphBuilder::TryFastDoubleArrayMap(ForStatement* stmt) {
+#if defined(V8_TARGET_ARCH_IA32) || defined(V8_TARGET_ARCH_X64)
+  if (!FLAG_vectorize_double_loops) return;
+  if (stmt->cond() == NULL || stmt->next() == NULL) return;
+
+  // The loop must count a stack variable up by one.
+  CompareOperation* cond = stmt->cond()->AsCompareOperation();
+  if (cond == NULL || cond->op() != Token::LT) return;
+  Variable* index = StackVariableOf(cond->left());
+  if (index == NULL) return;
+  ExpressionStatement* next = stmt->next()->AsExpressionStatement();
+  if (next == NULL) return;
+  CountOperation* increment = next->expression()->AsCountOperation();
+  if (increment == NULL || increment->op() != Token::INC) return;
+  if (StackVariableOf(increment->expression()) != index) return;
+
+  // The body must be a single store of a binary operation to target[i].
+  Statement* body = stmt->body();
+  Block* block = body->AsBlock();
+  if (block != NULL) {
+    if (block->block_scope() != NULL) return;
+    if (block->statements()->length() != 1) return;
+    body = block->statements()->at(0);
+  }
+  ExpressionStatement* statement = body->AsExpressionStatement();
+  if (statement == NULL) return;
+  Assignment* assignment = statement->expression()->AsAssignment();
+  if (assignment == NULL || assignment->op() != Token::ASSIGN) return;
+  Property* store = assignment->target()->AsProperty();
+  if (store == NULL) return;
+  Variable* target_var = StackVariableOf(store->obj());
+  if (target_var == NULL || target_var == index) return;
+  if (StackVariableOf(store->key()) != index) return;
+  BinaryOperation* operation = assignment->value()->AsBinaryOperation();
+  if (operation == NULL) return;
+  Token::Value op = operation->op();
+  if (op != Token::ADD && op != Token::SUB &&
+      op != Token::MUL && op != Token::DIV) {
+    return;
+  }
+
+  // Only bother when the store has only seen double arrays so far.
+  assignment->RecordTypeFeedback(oracle());
+  if (!assignment->IsMonomorphic() ||
+      !assignment->GetReceiverTypes()->first()->has_fast_double_elements()) {
+    return;
+  }
+
+  // The limit is either a variable or the length of one of the arrays,
+  // which the kernel stays below anyway.
+  HValue* limit = NULL;
+  Property* length = cond->right()->AsProperty();
+  Variable* length_var = NULL;
+  if (length != NULL) {
+    length_var = StackVariableOf(length->obj());
+    if (length_var == NULL || !length->key()->IsPropertyName()) return;
+    Handle<String> name = length->key()->AsLiteral()->AsPropertyName();
+    if (!name->IsEqualTo(CStrVector("length"))) return;
+  } else {
+    Variable* limit_var = StackVariableOf(cond->right());
+    if (limit_var == NULL || limit_var == index) return;
+    limit = environment()->Lookup(limit_var);
+  }
+
+  HValue* left = NULL;
+  HValue* right = NULL;
+  bool left_is_array = false;
+  bool right_is_array = false;
+  if (!MatchFastDoubleArrayOperand(
+          operation->left(), index, &left, &left_is_array) ||
+      !MatchFastDoubleArrayOperand(
+          operation->right(), index, &right, &right_is_array) ||
+      (!left_is_array && !right_is_array)) {
+    return;
+  }
+  if (length_var != NULL) {
+    HValue* array = environment()->Lookup(length_var);
+    if (array != environment()->Lookup(target_var) &&
+        !(left_is_array && array == left) &&
+        !(right_is_array && array == right)) {
+      return;
+    }
+    limit = AddInstruction(new(zone()) HConstant(
+        Handle<Object>(Smi::FromInt(Smi::kMaxValue)),
+        Representation::Tagged()));
+  }
+
+  HInstruction* map = AddInstruction(new(zone()) HFastDoubleArrayMap(
+      environment()->Lookup(target_var),
+      left,
+      right,
+      environment()->Lookup(index),
+      limit,
+      op,
+      left_is_array,
+      right_is_array));
+  // Continue with the loop's condition at the index the kernel stopped at.
+  // Full-codegen records the entry id right before it jumps to the test.
+  environment()->Bind(index, map);
+  AddSimulate(stmt->EntryId());
+#endif
+}
+
+
 bool HGraphBuilder::HasOsrEntryAt(IterationStatement* statement) {
   return statement->OsrEntryId() == info()->osr_ast_id();
 }
@@ -2978,6 +5586,15 @@ void HGraphBuilder::VisitWhileStatement(WhileStatement* stmt) {
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
   ASSERT(current_block() != NULL);
+  HBasicBlock* peel_exit = NULL;
+  if (ShouldPeelLoop(stmt)) {
+    CHECK_BAILOUT(VisitPeeledIteration(stmt,
+                                       stmt->cond(),
+                                       stmt->BodyId(),
+                                       NULL,
+                                       &peel_exit));
+    if (current_block() == NULL) return set_current_block(peel_exit);
+  }
   PreProcessOsrEntry(stmt);
   HBasicBlock* loop_entry = CreateLoopHeaderBlock();
   current_block()->Goto(loop_entry);
@@ -3012,7 +5629,7 @@ void HGraphBuilder::VisitWhileStatement(WhileStatement* stmt) {
                                       body_exit,
                                       loop_successor,
                                       break_info.break_block());
-  set_current_block(loop_exit);
+  set_current_block(CreateJoin(peel_exit, loop_exit, stmt->ExitId()));
 }
 
 
@@ -3024,6 +5641,16 @@ void HGraphBuilder::VisitForStatement(ForStatement* stmt) {
     CHECK_ALIVE(Visit(stmt->init()));
   }
   ASSERT(current_block() != NULL);
+  TryFastDoubleArrayMap(stmt);
+  HBasicBlock* peel_exit = NULL;
+  if (ShouldPeelLoop(stmt)) {
+    CHECK_BAILOUT(VisitPeeledIteration(stmt,
+                                       stmt->cond(),
+                                       stmt->BodyId(),
+                                       stmt->next(),
+                                       &peel_exit));
+    if (current_block() == NULL) return set_current_block(peel_exit);
+  }
   PreProcessOsrEntry(stmt);
   HBasicBlock* loop_entry = CreateLoopHeaderBlock();
   current_block()->Goto(loop_entry);
@@ -3064,7 +5691,7 @@ void HGraphBuilder::VisitForStatement(ForStatement* stmt) {
                                       body_exit,
                                       loop_successor,
                                       break_info.break_block());
-  set_current_block(loop_exit);
+  set_current_block(CreateJoin(peel_exit, loop_exit, stmt->ExitId()));
 }
 
 
@@ -3072,7 +5699,121 @@ void HGraphBuilder::VisitForInStatement(ForInStatement* stmt) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
-  return Bailout("ForInStatement");
+  // Only the fast case of the full code generator is optimized: a JS
+  // object whose keys are in the enum cache of its map.  The cache stays
+  // valid as long as the object has that map, which is checked on every
+  // iteration.  Anything else deoptimizes, and the loop keeps the same five
+  // values on the expression stack as the unoptimized code, so it can
+  // continue there.
+  if (!FLAG_optimize_for_in) {
+    return Bailout("ForInStatement optimization is disabled");
+  }
+  VariableProxy* each = stmt->each()->AsVariableProxy();
+  if (each == NULL || !each->var()->IsStackAllocated()) {
+    return Bailout("ForInStatement with non-local each variable");
+  }
+  SharedFunctionInfo* shared = *info()->shared_info();
+  int deopt_count =
+      Deoptimizer::DeoptimizationCountAt(shared, stmt->EnumId()) +
+      Deoptimizer::DeoptimizationCountAt(shared, stmt->PrepareId()) +
+      Deoptimizer::DeoptimizationCountAt(shared, stmt->BodyId());
+  if (deopt_count >= FLAG_max_deopts_per_site) {
+    return Bailout("ForInStatement is not fast case");
+  }
+
+  CHECK_ALIVE(VisitForValue(stmt->enumerable()));
+  AddSimulate(stmt->EnumId());
+  HValue* enumerable = Top();  // Leave the enumerable on the stack.
+  AddInstruction(new(zone()) HCheckNonSmi(enumerable));
+  AddInstruction(HCheckInstanceType::NewIsSpecObject(enumerable));
+
+  // The runtime returns the map if its enum cache can be used, otherwise
+  // the keys in a fixed array, which the unoptimized code iterates.
+  Push(enumerable);
+  HValue* context = environment()->LookupContext();
+  HInstruction* prepare = PreProcessCall(new(zone()) HCallRuntime(
+      context,
+      isolate()->factory()->LookupAsciiSymbol("GetPropertyNamesFast"),
+      Runtime::FunctionForId(Runtime::kGetPropertyNamesFast),
+      1));
+  PushAndAdd(prepare);
+  AddSimulate(stmt->PrepareId());
+  HValue* map = prepare;
+  AddInstruction(new(zone()) HCheckMap(map, isolate()->factory()->meta_map()));
+  HInstruction* descriptors = AddInstruction(new(zone()) HLoadNamedField(
+      map, true, Map::kInstanceDescriptorsOrBitField3Offset));
+  HInstruction* bridge = AddInstruction(new(zone()) HLoadNamedField(
+      descriptors, true, DescriptorArray::kEnumerationIndexOffset));
+  HInstruction* array = AddInstruction(new(zone()) HLoadNamedField(
+      bridge, true, DescriptorArray::kEnumCacheBridgeCacheOffset));
+  Push(array);
+  PushAndAdd(new(zone()) HFixedArrayBaseLength(array));
+  PushAndAdd(new(zone()) HConstant(Handle<Object>(Smi::FromInt(0)),
+                                   Representation::Integer32()));
+
+  PreProcessOsrEntry(stmt);
+  HBasicBlock* loop_entry = CreateLoopHeaderBlock();
+  current_block()->Goto(loop_entry);
+  set_current_block(loop_entry);
+  AddSimulate(stmt->BodyId());
+
+  HValue* index = environment()->ExpressionStackAt(0);
+  HValue* limit = environment()->ExpressionStackAt(1);
+  HCompareIDAndBranch* compare_index =
+      new(zone()) HCompareIDAndBranch(index, limit, Token::LT);
+  compare_index->SetInputRepresentation(Representation::Integer32());
+  HBasicBlock* loop_body = graph()->CreateBasicBlock();
+  HBasicBlock* loop_successor = graph()->CreateBasicBlock();
+  compare_index->SetSuccessorAt(0, loop_body);
+  compare_index->SetSuccessorAt(1, loop_successor);
+  current_block()->Finish(compare_index);
+
+  set_current_block(loop_successor);
+  Drop(5);
+  loop_successor->SetJoinId(stmt->ExitId());
+
+  set_current_block(loop_body);
+  HValue* key = AddInstruction(new(zone()) HLoadKeyedFastElement(
+      environment()->ExpressionStackAt(2),    // Enum cache.
+      environment()->ExpressionStackAt(0)));  // Index.
+
+  // Deleting or adding a property changes the map of the enumerable, and
+  // the unoptimized code filters the remaining keys.
+  HValue* enumerable_map = AddInstruction(new(zone()) HLoadNamedField(
+      environment()->ExpressionStackAt(4), true, HeapObject::kMapOffset));
+  HCompareObjectEqAndBranch* compare_map = new(zone())
+      HCompareObjectEqAndBranch(enumerable_map,
+                                environment()->ExpressionStackAt(3));
+  HBasicBlock* map_unchanged = graph()->CreateBasicBlock();
+  HBasicBlock* map_changed = graph()->CreateBasicBlock();
+  compare_map->SetSuccessorAt(0, map_unchanged);
+  compare_map->SetSuccessorAt(1, map_changed);
+  current_block()->Finish(compare_map);
+  map_changed->FinishExitWithDeoptimization(HDeoptimize::kNoUses);
+  set_current_block(map_unchanged);
+
+  Bind(each->var(), key);
+
+  BreakAndContinueInfo break_info(stmt, 5);
+  CHECK_BAILOUT(VisitLoopBody(stmt, loop_entry, &break_info));
+  HBasicBlock* body_exit =
+      JoinContinue(stmt, current_block(), break_info.continue_block());
+  if (body_exit != NULL) {
+    set_current_block(body_exit);
+    HValue* current_index = Pop();
+    HInstruction* next_index = new(zone()) HAdd(
+        environment()->LookupContext(), current_index, graph()->GetConstant1());
+    next_index->AssumeRepresentation(Representation::Integer32());
+    PushAndAdd(next_index);
+    body_exit = current_block();
+  }
+
+  HBasicBlock* loop_exit = CreateLoop(stmt,
+                                      loop_entry,
+                                      body_exit,
+                                      loop_successor,
+                                      break_info.break_block());
+  set_current_block(loop_exit);
 }
 
 
@@ -3124,9 +5865,11 @@ void HGraphBuilder::VisitFunctionLiteral(FunctionLiteral* expr) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
-  Handle<SharedFunctionInfo> shared_info =
-      SearchSharedFunctionInfo(info()->shared_info()->code(),
-                               expr);
+  Handle<SharedFunctionInfo> shared_info = expr->shared_info();
+  if (shared_info.is_null()) {
+    shared_info = SearchSharedFunctionInfo(info()->shared_info()->code(),
+                                           expr);
+  }
   if (shared_info.is_null()) {
     shared_info = Compiler::BuildFunctionInfo(expr, info()->script());
   }
@@ -3249,10 +5992,34 @@ void HGraphBuilder::VisitVariableProxy(VariableProxy* expr) {
       if (type == kUseCell) {
         Handle<GlobalObject> global(info()->global_object());
         Handle<JSGlobalPropertyCell> cell(global->GetPropertyCell(&lookup));
+        // A value that has not changed since optimized code started to rely
+        // on it is embedded as a constant.  Writing the property deoptimizes
+        // the code.  Code objects cannot refer to new space, so values that
+        // still live there are loaded from the cell.
+        if (FLAG_constant_global_cells &&
+            cell->state() != JSGlobalPropertyCell::MUTABLE &&
+            !cell->value()->IsTheHole() &&
+            !isolate()->heap()->InNewSpace(cell->value())) {
+          cell->set_state(JSGlobalPropertyCell::CONSTANT);
+          graph()->RecordConstantCell(cell);
+          Handle<Object> value(cell->value());
+          HConstant* instr =
+              new(zone()) HConstant(value, Representation::Tagged());
+          return ast_context()->ReturnInstruction(instr, expr->id());
+        }
+        graph()->RecordDependentCell(cell);
         HLoadGlobalCell* instr =
             new(zone()) HLoadGlobalCell(cell, lookup.GetPropertyDetails());
         return ast_context()->ReturnInstruction(instr, expr->id());
       } else {
+#if !defined(V8_TARGET_ARCH_IA32)
+        // Inlined builtins run with the context of the function being
+        // compiled, which does not have their global object.
+        if (info()->closure()->context() !=
+            graph()->info()->closure()->context()) {
+          return Bailout("generic global load in inlined builtin");
+        }
+#endif
         HValue* context = environment()->LookupContext();
         HGlobalObject* global_object = new(zone()) HGlobalObject(context);
         AddInstruction(global_object);
@@ -3339,6 +6106,8 @@ static bool IsFastObjectLiteral(Handle<JSObject> boilerplate,
     for (int i = 0; i < nof; i++) {
       if ((*max_properties)-- <= 0) return false;
       Handle<Object> value(boilerplate->InObjectPropertyAt(i));
+      // The copies need mutable heap numbers of their own.
+      if (value->IsMutableHeapNumber()) return false;
       if (value->IsJSObject()) {
         Handle<JSObject> value_object = Handle<JSObject>::cast(value);
         if (!IsFastObjectLiteral(value_object,
@@ -3350,8 +6119,43 @@ static bool IsFastObjectLiteral(Handle<JSObject> boilerplate,
       }
     }
   }
-
-  *total_size += boilerplate->map()->instance_size();
+
+  *total_size += boilerplate->map()->instance_size();
+  return true;
+}
+
+
+// Determines whether the given array literal boilerplate is small enough to
+// be copied inline, together with its elements, and computes the size of
+// the copy.  The elements are put right after the array, so the two stay
+// next to each other until the array grows out of them.
+static bool IsFastArrayLiteral(Handle<JSArray> boilerplate, int* total_size) {
+  ElementsKind kind = boilerplate->GetElementsKind();
+  if (kind != FAST_SMI_ONLY_ELEMENTS &&
+      kind != FAST_ELEMENTS &&
+      kind != FAST_DOUBLE_ELEMENTS) {
+    return false;
+  }
+  if (boilerplate->properties()->length() > 0 ||
+      boilerplate->map()->inobject_properties() > 0) {
+    return false;
+  }
+  *total_size = boilerplate->map()->instance_size();
+  FixedArrayBase* elements = boilerplate->elements();
+  if (elements->length() == 0 ||
+      elements->map() == HEAP->fixed_cow_array_map()) {
+    return true;
+  }
+  if (elements->length() > FastCloneShallowArrayStub::kMaximumClonedLength) {
+    return false;
+  }
+  if (kind == FAST_ELEMENTS) {
+    FixedArray* values = FixedArray::cast(elements);
+    for (int i = 0; i < values->length(); i++) {
+      if (values->get(i)->IsJSObject()) return false;
+    }
+  }
+  *total_size += elements->Size();
   return true;
 }
 
@@ -3374,11 +6178,27 @@ void HGraphBuilder::VisitObjectLiteral(ObjectLiteral* expr) {
                           &max_properties,
                           &total_size)) {
     Handle<JSObject> boilerplate_object = Handle<JSObject>::cast(boilerplate);
-    literal = new(zone()) HObjectLiteralFast(context,
-                                             boilerplate_object,
-                                             total_size,
-                                             expr->literal_index(),
-                                             expr->depth());
+    HObjectLiteralFast* fast_literal =
+        new(zone()) HObjectLiteralFast(context,
+                                       boilerplate_object,
+                                       total_size,
+                                       expr->literal_index(),
+                                       expr->depth());
+    if (FLAG_escape_analysis &&
+        expr->depth() == 1 &&
+        boilerplate_object->elements()->length() == 0) {
+      // Escape analysis runs without access to the heap, so the field
+      // values it may need are collected here.
+      int count = boilerplate_object->map()->inobject_properties();
+      ZoneList<Handle<Object> >* values =
+          new(zone()) ZoneList<Handle<Object> >(count);
+      for (int i = 0; i < count; i++) {
+        values->Add(
+            Handle<Object>(boilerplate_object->InObjectPropertyAt(i)));
+      }
+      fast_literal->set_in_object_values(values);
+    }
+    literal = fast_literal;
   } else {
     literal = new(zone()) HObjectLiteralGeneric(context,
                                                 expr->constant_properties(),
@@ -3411,13 +6231,28 @@ void HGraphBuilder::VisitObjectLiteral(ObjectLiteral* expr) {
             CHECK_ALIVE(VisitForValue(value));
             HValue* value = Pop();
             Handle<String> name = Handle<String>::cast(key->handle());
-            HStoreNamedGeneric* store =
-                new(zone()) HStoreNamedGeneric(
-                                context,
-                                literal,
-                                name,
-                                value,
-                                function_strict_mode_flag());
+            HInstruction* store = NULL;
+            if (literal->IsObjectLiteralFast()) {
+              // The copy has the map of the boilerplate, which already has
+              // a field for every property of the literal.
+              Handle<JSObject> boilerplate_object =
+                  HObjectLiteralFast::cast(literal)->boilerplate();
+              Handle<Map> map(boilerplate_object->map());
+              LookupResult lookup(isolate());
+              map->LookupInDescriptors(NULL, *name, &lookup);
+              if (lookup.IsProperty() && lookup.type() == FIELD) {
+                store = BuildStoreNamedField(literal, name, value, map,
+                                             &lookup, false);
+              }
+            }
+            if (store == NULL) {
+              store = new(zone()) HStoreNamedGeneric(
+                                      context,
+                                      literal,
+                                      name,
+                                      value,
+                                      function_strict_mode_flag());
+            }
             AddInstruction(store);
             AddSimulate(key->id());
           } else {
@@ -3456,12 +6291,29 @@ void HGraphBuilder::VisitArrayLiteral(ArrayLiteral* expr) {
   ZoneList<Expression*>* subexprs = expr->values();
   int length = subexprs->length();
   HValue* context = environment()->LookupContext();
+  HInstruction* literal;
 
-  HArrayLiteral* literal = new(zone()) HArrayLiteral(context,
-                                                     expr->constant_elements(),
-                                                     length,
-                                                     expr->literal_index(),
-                                                     expr->depth());
+  // Small array literals whose boilerplate exists are copied inline like
+  // object literals, with their elements.
+  Handle<JSFunction> closure = function_state()->compilation_info()->closure();
+  Handle<Object> boilerplate(closure->literals()->get(expr->literal_index()));
+  int total_size = 0;
+  if (expr->depth() == 1 &&
+      boilerplate->IsJSArray() &&
+      IsFastArrayLiteral(Handle<JSArray>::cast(boilerplate), &total_size)) {
+    Handle<JSObject> boilerplate_object = Handle<JSObject>::cast(boilerplate);
+    literal = new(zone()) HObjectLiteralFast(context,
+                                             boilerplate_object,
+                                             total_size,
+                                             expr->literal_index(),
+                                             expr->depth());
+  } else {
+    literal = new(zone()) HArrayLiteral(context,
+                                        expr->constant_elements(),
+                                        length,
+                                        expr->literal_index(),
+                                        expr->depth());
+  }
   // The array is expected in the bailout environment during computation
   // of the property values and is the value of the entire expression.
   PushAndAdd(literal);
@@ -3534,8 +6386,16 @@ static bool ComputeStoredField(Handle<Map> type,
   type->LookupInDescriptors(NULL, *name, lookup);
   if (!lookup->IsPropertyOrTransition()) return false;
   if (lookup->type() == FIELD) return true;
-  return (lookup->type() == MAP_TRANSITION) &&
-      (type->unused_property_fields() > 0);
+  if (lookup->type() != MAP_TRANSITION ||
+      type->unused_property_fields() == 0) {
+    return false;
+  }
+  // Adding a double field allocates its mutable heap number in the IC.
+  Map* transition = lookup->GetTransitionMapFromMap(*type);
+  LookupResult field(type->GetIsolate());
+  transition->LookupInDescriptors(NULL, *name, &field);
+  return field.IsProperty() && field.type() == FIELD &&
+      field.GetFieldRepresentation() != DOUBLE_FIELD;
 }
 
 
@@ -3575,6 +6435,10 @@ HInstruction* HGraphBuilder::BuildStoreNamedField(HValue* object,
   }
   HStoreNamedField* instr =
       new(zone()) HStoreNamedField(object, name, value, is_in_object, offset);
+  if (lookup->type() == FIELD &&
+      lookup->GetFieldRepresentation() == DOUBLE_FIELD) {
+    instr->set_double_field();
+  }
   if (lookup->type() == MAP_TRANSITION) {
     Handle<Map> transition(lookup->GetTransitionMapFromMap(*type));
     instr->set_transition(transition);
@@ -3717,11 +6581,12 @@ void HGraphBuilder::HandlePropertyAssignment(Assignment* expr) {
 
     SmallMapList* types = expr->GetReceiverTypes();
     LookupResult lookup(isolate());
+    bool speculate = !IsUnstableDeoptimizationSite();
 
-    if (expr->IsMonomorphic()) {
+    if (speculate && expr->IsMonomorphic()) {
       instr = BuildStoreNamed(object, value, expr);
 
-    } else if (types != NULL && types->length() > 1) {
+    } else if (speculate && types != NULL && types->length() > 1) {
       HandlePolymorphicStoreNamedField(expr, object, value, types, name);
       return;
 
@@ -3763,9 +6628,18 @@ void HGraphBuilder::HandleGlobalVariableAssignment(Variable* var,
                                                    int ast_id) {
   LookupResult lookup(isolate());
   GlobalPropertyAccess type = LookupGlobalProperty(var, &lookup, true);
+  Handle<JSGlobalPropertyCell> cell;
   if (type == kUseCell) {
     Handle<GlobalObject> global(info()->global_object());
-    Handle<JSGlobalPropertyCell> cell(global->GetPropertyCell(&lookup));
+    cell = Handle<JSGlobalPropertyCell>(global->GetPropertyCell(&lookup));
+    // Code embedding the value as a constant is deoptimized by the runtime
+    // system when the value changes, so the store has to go through it.
+    if (cell->state() == JSGlobalPropertyCell::CONSTANT) type = kUseGeneric;
+  }
+  if (type == kUseCell) {
+    // The value of a cell written by optimized code is never embedded.
+    cell->set_state(JSGlobalPropertyCell::MUTABLE);
+    graph()->RecordDependentCell(cell);
     HInstruction* instr =
         new(zone()) HStoreGlobalCell(value, cell, lookup.GetPropertyDetails());
     instr->set_position(position);
@@ -4054,16 +6928,21 @@ HLoadNamedField* HGraphBuilder::BuildLoadNamedField(HValue* object,
   }
 
   int index = lookup->GetLocalFieldIndexFromMap(*type);
+  HLoadNamedField* instr;
   if (index < 0) {
     // Negative property indices are in-object properties, indexed
     // from the end of the fixed part of the object.
     int offset = (index * kPointerSize) + type->instance_size();
-    return new(zone()) HLoadNamedField(object, true, offset);
+    instr = new(zone()) HLoadNamedField(object, true, offset);
   } else {
     // Non-negative property indices are in the properties array.
     int offset = (index * kPointerSize) + FixedArray::kHeaderSize;
-    return new(zone()) HLoadNamedField(object, false, offset);
+    instr = new(zone()) HLoadNamedField(object, false, offset);
+  }
+  if (lookup->GetFieldRepresentation() == DOUBLE_FIELD) {
+    instr->set_double_field();
   }
+  return instr;
 }
 
 
@@ -4082,7 +6961,10 @@ HInstruction* HGraphBuilder::BuildLoadNamed(HValue* obj,
                                             Handle<String> name) {
   LookupResult lookup(isolate());
   map->LookupInDescriptors(NULL, *name, &lookup);
-  if (lookup.IsProperty() && lookup.type() == FIELD) {
+  // A mixed field may or may not hold a mutable heap number, which only
+  // the IC copies.
+  if (lookup.IsProperty() && lookup.type() == FIELD &&
+      lookup.GetFieldRepresentation() != MIXED_FIELD) {
     return BuildLoadNamedField(obj,
                                expr,
                                map,
@@ -4418,11 +7300,13 @@ HValue* HGraphBuilder::HandleKeyedElementAccess(HValue* obj,
                                                 bool* has_side_effects) {
   ASSERT(!expr->IsPropertyName());
   HInstruction* instr = NULL;
-  if (expr->IsMonomorphic()) {
+  bool speculate = !IsUnstableDeoptimizationSite();
+  if (speculate && expr->IsMonomorphic()) {
     Handle<Map> map = expr->GetMonomorphicReceiverType();
     AddInstruction(new(zone()) HCheckNonSmi(obj));
     instr = BuildMonomorphicElementAccess(obj, key, val, map, is_store);
-  } else if (expr->GetReceiverTypes() != NULL &&
+  } else if (speculate &&
+             expr->GetReceiverTypes() != NULL &&
              !expr->GetReceiverTypes()->is_empty()) {
     return HandlePolymorphicElementAccess(
         obj, key, val, expr, ast_id, position, is_store, has_side_effects);
@@ -4460,28 +7344,49 @@ bool HGraphBuilder::TryArgumentsAccess(Property* expr) {
     return false;
   }
 
-  // Our implementation of arguments (based on this stack frame or an
-  // adapter below it) does not work for inlined functions.
-  if (function_state()->outer() != NULL) {
-    Bailout("arguments access in inlined function");
-    return true;
-  }
-
+  // The arguments object of an inlined call has the arguments of the call.
+  HArgumentsObject* inlined = function_state()->arguments_object();
   HInstruction* result = NULL;
   if (expr->key()->IsPropertyName()) {
     Handle<String> name = expr->key()->AsLiteral()->AsPropertyName();
     if (!name->IsEqualTo(CStrVector("length"))) return false;
-    HInstruction* elements = AddInstruction(new(zone()) HArgumentsElements);
-    result = new(zone()) HArgumentsLength(elements);
+    if (inlined != NULL) {
+      result = new(zone()) HConstant(
+          Handle<Object>(Smi::FromInt(inlined->arguments_count())),
+          Representation::Integer32());
+    } else {
+      HInstruction* elements = AddInstruction(
+          new(zone()) HArgumentsElements(false));
+      result = new(zone()) HArgumentsLength(elements);
+    }
   } else {
-    Push(graph()->GetArgumentsObject());
+    Push(environment()->Lookup(proxy->var()));
     VisitForValue(expr->key());
     if (HasStackOverflow() || current_block() == NULL) return true;
     HValue* key = Pop();
     Drop(1);  // Arguments object.
-    HInstruction* elements = AddInstruction(new(zone()) HArgumentsElements);
-    HInstruction* length = AddInstruction(
-        new(zone()) HArgumentsLength(elements));
+    if (inlined != NULL && key->IsConstant()) {
+      // A constant index selects the argument.
+      HConstant* constant = HConstant::cast(key);
+      if (constant->HasInteger32Value() &&
+          constant->Integer32Value() >= 0 &&
+          constant->Integer32Value() < inlined->arguments_count()) {
+        ast_context()->ReturnValue(
+            inlined->argument(constant->Integer32Value()));
+        return true;
+      }
+    }
+    HInstruction* elements = NULL;
+    HInstruction* length = NULL;
+    if (inlined != NULL) {
+      elements = EnsureArgumentsArePushedForAccess();
+      length = AddInstruction(new(zone()) HConstant(
+          Handle<Object>(Smi::FromInt(inlined->arguments_count())),
+          Representation::Integer32()));
+    } else {
+      elements = AddInstruction(new(zone()) HArgumentsElements(false));
+      length = AddInstruction(new(zone()) HArgumentsLength(elements));
+    }
     HInstruction* checked_key =
         AddInstruction(new(zone()) HBoundsCheck(key, length));
     result = new(zone()) HAccessArgumentsAt(elements, length, checked_key);
@@ -4491,6 +7396,30 @@ bool HGraphBuilder::TryArgumentsAccess(Property* expr) {
 }
 
 
+HInstruction* HGraphBuilder::EnsureArgumentsArePushedForAccess() {
+  // The arguments of the inlined call are pushed right after entering the
+  // inlined function, so the pushes dominate all accesses, and are dropped
+  // again by HLeaveInlined.
+  FunctionState* state = function_state();
+  if (state->arguments_elements() == NULL) {
+    HEnterInlined* entry = state->entry();
+    HArgumentsObject* arguments = state->arguments_object();
+    entry->set_arguments_pushed();
+    HInstruction* insert_after = entry;
+    for (int i = 0; i < arguments->arguments_count(); i++) {
+      HInstruction* push =
+          new(zone()) HPushArgument(arguments->argument(i));
+      push->InsertAfter(insert_after);
+      insert_after = push;
+    }
+    HArgumentsElements* elements = new(zone()) HArgumentsElements(true);
+    elements->InsertAfter(insert_after);
+    state->set_arguments_elements(elements);
+  }
+  return state->arguments_elements();
+}
+
+
 void HGraphBuilder::VisitProperty(Property* expr) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
@@ -4534,9 +7463,10 @@ void HGraphBuilder::VisitProperty(Property* expr) {
     SmallMapList* types = expr->GetReceiverTypes();
 
     HValue* obj = Pop();
-    if (expr->IsMonomorphic()) {
+    bool speculate = !IsUnstableDeoptimizationSite();
+    if (speculate && expr->IsMonomorphic()) {
       instr = BuildLoadNamed(obj, expr, types->first(), name);
-    } else if (types != NULL && types->length() > 1) {
+    } else if (speculate && types != NULL && types->length() > 1) {
       AddInstruction(new(zone()) HCheckNonSmi(obj));
       HValue* context = environment()->LookupContext();
       instr = new(zone()) HLoadNamedFieldPolymorphic(context, obj, types, name);
@@ -4598,6 +7528,10 @@ void HGraphBuilder::HandlePolymorphicCallNamed(Call* expr,
   // maps are identical. In that case we can avoid repeatedly generating the
   // same prototype map checks.
   int argument_count = expr->arguments()->length() + 1;  // Includes receiver.
+  // Only call sites with a handful of receiver maps get their arms inlined;
+  // each arm is still subject to the inlining budget of the compilation.
+  bool inline_arms = FLAG_polymorphic_inlining &&
+      types->length() <= FLAG_max_polymorphic_inlining_maps;
   int count = 0;
   HBasicBlock* join = NULL;
   for (int i = 0; i < types->length() && count < kMaxCallPolymorphism; ++i) {
@@ -4617,11 +7551,11 @@ void HGraphBuilder::HandlePolymorphicCallNamed(Call* expr,
 
       set_current_block(if_true);
       AddCheckConstantFunction(expr, receiver, map, false);
-      if (FLAG_trace_inlining && FLAG_polymorphic_inlining) {
+      if (FLAG_trace_inlining && inline_arms) {
         PrintF("Trying to inline the polymorphic call to %s\n",
                *name->ToCString());
       }
-      if (FLAG_polymorphic_inlining && TryInline(expr)) {
+      if (inline_arms && TryInline(expr)) {
         // Trying to inline will signal that we should bailout from the
         // entire compilation by setting stack overflow on the visitor.
         if (HasStackOverflow()) return;
@@ -4692,23 +7626,42 @@ void HGraphBuilder::TraceInline(Handle<JSFunction> target,
 
 
 bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
-  if (!FLAG_use_inlining) return false;
-
   // The function call we are inlining is a method call if the call
   // is a property call.
   CallKind call_kind = (expr->expression()->AsProperty() == NULL)
       ? CALL_AS_FUNCTION
       : CALL_AS_METHOD;
 
-  // Precondition: call is monomorphic and we have found a target with the
-  // appropriate arity.
+  // Precondition: call is monomorphic and we have found a target.
+  return TryInline(call_kind,
+                   expr->target(),
+                   expr->arguments()->length(),
+                   expr->id(),
+                   expr->ReturnId(),
+                   drop_extra);
+}
+
+
+bool HGraphBuilder::TryInline(CallKind call_kind,
+                              Handle<JSFunction> target,
+                              int arguments_count,
+                              int ast_id,
+                              int return_id,
+                              bool drop_extra,
+                              HFunctionLiteral* closure_literal) {
+  if (!FLAG_use_inlining) return false;
+  // A closure created by the code being compiled is found through the
+  // outer frame when deoptimizing, so the call must leave it there.
+  ASSERT(closure_literal == NULL || drop_extra);
+
   Handle<JSFunction> caller = info()->closure();
-  Handle<JSFunction> target = expr->target();
   Handle<SharedFunctionInfo> target_shared(target->shared());
 
   // Do a quick check on source code length to avoid parsing large
-  // inlining candidates.
-  if (FLAG_limit_inlining && target->shared()->SourceSize() > kMaxSourceSize) {
+  // inlining candidates.  Inlineable builtins are known to be small enough.
+  if (FLAG_limit_inlining &&
+      !target->IsInlineableBuiltin() &&
+      target->shared()->SourceSize() > FLAG_max_inlined_source_size) {
     TraceInline(target, caller, "target text too big");
     return false;
   }
@@ -4719,12 +7672,31 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
     return false;
   }
 
+  // Break points only work in the full code of a function.
+  if (isolate()->DebuggerNeedsFullCode(*target_shared)) {
+    TraceInline(target, caller, "target has break points");
+    return false;
+  }
+
 #if !defined(V8_TARGET_ARCH_IA32)
-  // Target must be able to use caller's context.
-  CompilationInfo* outer_info = info();
-  if (target->context() != outer_info->closure()->context() ||
-      outer_info->scope()->contains_with() ||
-      outer_info->scope()->num_heap_slots() > 0) {
+  // Target must be able to use the context of the function being compiled,
+  // which inlined code runs with.  Inlineable builtins do not depend on
+  // their context, and functions declared at the top level only use it to
+  // get to the global object.  A closure created by the code being
+  // compiled must have been created in the context inlined code runs with.
+  CompilationInfo* outer_info = graph()->info();
+  Context* outer_context = outer_info->closure()->context();
+  bool context_change = false;
+  if (closure_literal != NULL) {
+    context_change =
+        closure_literal->context() != environment()->LookupContext();
+  } else if (!target->IsInlineableBuiltin() &&
+             target->context() != outer_context->global_context()) {
+    context_change = target->context() != outer_context ||
+        outer_info->scope()->contains_with() ||
+        outer_info->scope()->num_heap_slots() > 0;
+  }
+  if (context_change) {
     TraceInline(target, caller, "target requires context change");
     return false;
   }
@@ -4753,8 +7725,10 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
     }
   }
 
-  // We don't want to add more than a certain number of nodes from inlining.
-  if (FLAG_limit_inlining && inlined_count_ > kMaxInlinedNodes) {
+  // Once the budget of the whole compilation is used up there is no point in
+  // parsing further candidates.
+  if (FLAG_limit_inlining &&
+      inlined_count_ >= FLAG_max_inlined_nodes_cumulative) {
     TraceInline(target, caller, "cumulative AST node limit reached");
     return false;
   }
@@ -4768,7 +7742,7 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
     if (target_info.isolate()->has_pending_exception()) {
       // Parse or scope error, never optimize this function.
       SetStackOverflow();
-      target_shared->DisableOptimization(*target);
+      Compiler::DisableOptimization(target, "parse failure");
     }
     TraceInline(target, caller, "parse failure");
     return false;
@@ -4782,17 +7756,17 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
 
   // Count the number of AST nodes added by inlining this call.
   int nodes_added = AstNode::Count() - count_before;
-  if (FLAG_limit_inlining && nodes_added > kMaxInlinedSize) {
+  if (FLAG_limit_inlining && nodes_added > FLAG_max_inlined_nodes) {
     TraceInline(target, caller, "target AST is too large");
     return false;
   }
 
-  // Don't inline functions that uses the arguments object or that
-  // have a mismatching number of parameters.
-  int arity = expr->arguments()->length();
-  if (function->scope()->arguments() != NULL ||
-      arity != target_shared->formal_parameter_count()) {
-    TraceInline(target, caller, "target requires special argument handling");
+  // We don't want to add more than a certain number of nodes from inlining
+  // into a single compilation, whether from one call site or from the arms
+  // of a polymorphic one.
+  if (FLAG_limit_inlining &&
+      inlined_count_ + nodes_added > FLAG_max_inlined_nodes_cumulative) {
+    TraceInline(target, caller, "cumulative AST node limit reached");
     return false;
   }
 
@@ -4836,53 +7810,94 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
                                         target_shared);
   }
 
-  // ----------------------------------------------------------------
-  // After this point, we've made a decision to inline this function (so
-  // TryInline should always return true).
-
-  // Save the pending call context and type feedback oracle. Set up new ones
-  // for the inlined function.
   ASSERT(target_shared->has_deoptimization_support());
   TypeFeedbackOracle target_oracle(
       Handle<Code>(target_shared->code()),
+      target_shared,
       Handle<Context>(target->context()->global_context()),
       isolate());
-  // The function state is new-allocated because we need to delete it
-  // in two different places.
+
+  // A function that uses the arguments object is only inlined if the
+  // object does not escape.  Its length and elements are then those of the
+  // call, which may have more or fewer arguments than the function has
+  // parameters.  The arguments object is materialized from them when
+  // deoptimizing, which needs the callee, so closures created by the code
+  // being compiled are not inlined then.
+  Variable* arguments = function->scope()->arguments();
+  if (arguments != NULL &&
+      (closure_literal != NULL ||
+       ArgumentsEscape(function, arguments, &target_oracle))) {
+    TraceInline(target, caller, "target requires special argument handling");
+    return false;
+  }
+
+  // ----------------------------------------------------------------
+  // After this point, we've made a decision to inline this function (so
+  // TryInline should always return true).
+
+  // Save the pending call context and type feedback oracle. Set up new ones
+  // for the inlined function.  The function state is new-allocated because
+  // we need to delete it in two different places.
   FunctionState* target_state =
       new FunctionState(this, &target_info, &target_oracle, drop_extra);
 
+  HArgumentsObject* arguments_object = NULL;
+  if (arguments != NULL) {
+    arguments_object = new(zone()) HArgumentsObject(target, arguments_count);
+    for (int i = 0; i < arguments_count; i++) {
+      arguments_object->AddArgument(
+          environment()->ExpressionStackAt(arguments_count - 1 - i));
+    }
+  }
+
   HConstant* undefined = graph()->GetConstantUndefined();
   HEnvironment* inner_env =
       environment()->CopyForInlining(target,
+                                     arguments_count,
                                      function,
                                      undefined,
-                                     call_kind);
+                                     call_kind,
+                                     closure_literal != NULL);
 #ifdef V8_TARGET_ARCH_IA32
   // IA32 only, overwrite the caller's context in the deoptimization
   // environment with the correct one.
   //
   // TODO(kmillikin): implement the same inlining on other platforms so we
   // can remove the unsightly ifdefs in this function.
-  HConstant* context = new HConstant(Handle<Context>(target->context()),
-                                     Representation::Tagged());
-  AddInstruction(context);
-  inner_env->BindContext(context);
+  if (closure_literal != NULL) {
+    inner_env->BindContext(closure_literal->context());
+  } else {
+    HConstant* context = new HConstant(Handle<Context>(target->context()),
+                                       Representation::Tagged());
+    AddInstruction(context);
+    inner_env->BindContext(context);
+  }
 #endif
   HBasicBlock* body_entry = CreateBasicBlock(inner_env);
   current_block()->Goto(body_entry);
-  body_entry->SetJoinId(expr->ReturnId());
+  body_entry->SetJoinId(return_id);
   set_current_block(body_entry);
-  AddInstruction(new(zone()) HEnterInlined(target,
-                                           function,
-                                           call_kind));
+  HEnterInlined* enter_inlined =
+      new(zone()) HEnterInlined(target,
+                                arguments_count,
+                                function,
+                                call_kind,
+                                closure_literal != NULL);
+  AddInstruction(enter_inlined);
+  target_state->set_entry(enter_inlined);
+  if (arguments_object != NULL) {
+    AddInstruction(arguments_object);
+    target_state->set_arguments_object(arguments_object);
+    environment()->Bind(arguments, arguments_object);
+    AddSimulate(AstNode::kFunctionEntryId);
+  }
   VisitDeclarations(target_info.scope()->declarations());
   VisitStatements(function->body());
   if (HasStackOverflow()) {
     // Bail out if the inline function did, as we cannot residualize a call
     // instead.
     TraceInline(target, caller, "inline graph construction failed");
-    target_shared->DisableOptimization(*target);
+    Compiler::DisableOptimization(target, target_info.bailout_reason());
     inline_bailout_ = true;
     delete target_state;
     return true;
@@ -4935,12 +7950,12 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
 
     // Forward to the real test context.
     if (if_true->HasPredecessor()) {
-      if_true->SetJoinId(expr->id());
+      if_true->SetJoinId(ast_id);
       HBasicBlock* true_target = TestContext::cast(ast_context())->if_true();
       if_true->Goto(true_target, function_state()->drop_extra());
     }
     if (if_false->HasPredecessor()) {
-      if_false->SetJoinId(expr->id());
+      if_false->SetJoinId(ast_id);
       HBasicBlock* false_target = TestContext::cast(ast_context())->if_false();
       if_false->Goto(false_target, function_state()->drop_extra());
     }
@@ -4948,7 +7963,7 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
     return true;
 
   } else if (function_return()->HasPredecessor()) {
-    function_return()->SetJoinId(expr->id());
+    function_return()->SetJoinId(ast_id);
     set_current_block(function_return());
   } else {
     set_current_block(NULL);
@@ -4958,6 +7973,40 @@ bool HGraphBuilder::TryInline(Call* expr, bool drop_extra) {
 }
 
 
+bool HGraphBuilder::TryInlineClosure(Call* expr, HFunctionLiteral* closure) {
+  // Only closures from the source of the function being compiled are
+  // inlined, so that a template with the context of that function has the
+  // scope chain of the closure.  The template stands in for the closure
+  // when parsing and in the type feedback and deoptimization data.
+  CompilationInfo* outer_info = graph()->info();
+  Handle<SharedFunctionInfo> shared = closure->shared_info();
+  Handle<SharedFunctionInfo> outer_shared = outer_info->shared_info();
+  if (shared->script() != outer_shared->script() ||
+      shared->start_position() <= outer_shared->start_position() ||
+      shared->end_position() > outer_shared->end_position()) {
+    return false;
+  }
+  Handle<JSFunction> outer_closure = outer_info->closure();
+  Handle<Context> context(outer_closure->context());
+  int heap_slots = outer_info->scope()->num_heap_slots();
+  if (heap_slots > 0) {
+    context = isolate()->factory()->NewFunctionContext(heap_slots,
+                                                       outer_closure);
+  }
+  Handle<JSFunction> target =
+      isolate()->factory()->NewFunctionFromSharedFunctionInfo(shared,
+                                                              context,
+                                                              TENURED);
+  return TryInline(CALL_AS_FUNCTION,
+                   target,
+                   expr->arguments()->length(),
+                   expr->id(),
+                   expr->ReturnId(),
+                   true,
+                   closure);
+}
+
+
 bool HGraphBuilder::TryInlineBuiltinFunction(Call* expr,
                                              HValue* receiver,
                                              Handle<Map> receiver_map,
@@ -5052,6 +8101,24 @@ bool HGraphBuilder::TryInlineBuiltinFunction(Call* expr,
         return true;
       }
       break;
+#if !defined(V8_TARGET_ARCH_MIPS)
+    case kMathMax:
+    case kMathMin:
+      if (argument_count == 3 && check_type == RECEIVER_MAP_CHECK) {
+        AddCheckConstantFunction(expr, receiver, receiver_map, true);
+        HValue* right = Pop();
+        HValue* left = Pop();
+        Drop(1);  // Receiver.
+        HValue* context = environment()->LookupContext();
+        HMathMinMax::Operation op = (id == kMathMin) ? HMathMinMax::kMathMin
+                                                     : HMathMinMax::kMathMax;
+        HMathMinMax* result =
+            new(zone()) HMathMinMax(context, left, right, op);
+        ast_context()->ReturnInstruction(result, expr->id());
+        return true;
+      }
+      break;
+#endif
     default:
       // Not yet supported for inlining.
       break;
@@ -5065,15 +8132,8 @@ bool HGraphBuilder::TryCallApply(Call* expr) {
   Property* prop = callee->AsProperty();
   ASSERT(prop != NULL);
 
-  if (!expr->IsMonomorphic() || expr->check_type() != RECEIVER_MAP_CHECK) {
-    return false;
-  }
+  if (!IsFunctionApplyCall(expr)) return false;
   Handle<Map> function_map = expr->GetReceiverTypes()->first();
-  if (function_map->instance_type() != JS_FUNCTION_TYPE ||
-      !expr->target()->shared()->HasBuiltinFunctionId() ||
-      expr->target()->shared()->builtin_function_id() != kFunctionApply) {
-    return false;
-  }
 
   if (info()->scope()->arguments() == NULL) return false;
 
@@ -5085,13 +8145,6 @@ bool HGraphBuilder::TryCallApply(Call* expr) {
   HValue* arg_two_value = environment()->Lookup(arg_two->var());
   if (!arg_two_value->CheckFlag(HValue::kIsArguments)) return false;
 
-  // Our implementation of arguments (based on this stack frame or an
-  // adapter below it) does not work for inlined functions.
-  if (function_state()->outer() != NULL) {
-    Bailout("Function.prototype.apply optimization in inlined function");
-    return true;
-  }
-
   // Found pattern f.apply(receiver, arguments).
   VisitForValue(prop->obj());
   if (HasStackOverflow() || current_block() == NULL) return true;
@@ -5102,10 +8155,26 @@ bool HGraphBuilder::TryCallApply(Call* expr) {
   VisitForValue(args->at(0));
   if (HasStackOverflow() || current_block() == NULL) return true;
   HValue* receiver = Pop();
-  HInstruction* elements = AddInstruction(new(zone()) HArgumentsElements);
-  HInstruction* length = AddInstruction(new(zone()) HArgumentsLength(elements));
-  HInstruction* result =
-      new(zone()) HApplyArguments(function, receiver, length, elements);
+  HInstruction* result = NULL;
+  HArgumentsObject* inlined = function_state()->arguments_object();
+  if (inlined != NULL) {
+    // The arguments of an inlined call are known and are pushed for an
+    // ordinary call.
+    AddInstruction(new(zone()) HPushArgument(receiver));
+    for (int i = 0; i < inlined->arguments_count(); i++) {
+      AddInstruction(new(zone()) HPushArgument(inlined->argument(i)));
+    }
+    HValue* context = environment()->LookupContext();
+    result = new(zone()) HInvokeFunction(context,
+                                         function,
+                                         inlined->arguments_count() + 1);
+  } else {
+    HInstruction* elements = AddInstruction(
+        new(zone()) HArgumentsElements(false));
+    HInstruction* length =
+        AddInstruction(new(zone()) HArgumentsLength(elements));
+    result = new(zone()) HApplyArguments(function, receiver, length, elements);
+  }
   result->set_position(expr->position());
   ast_context()->ReturnInstruction(result, expr->id());
   return true;
@@ -5156,7 +8225,8 @@ void HGraphBuilder::VisitCall(Call* expr) {
 
     HValue* receiver =
         environment()->ExpressionStackAt(expr->arguments()->length());
-    if (expr->IsMonomorphic()) {
+    bool speculate = !IsUnstableDeoptimizationSite();
+    if (speculate && expr->IsMonomorphic()) {
       Handle<Map> receiver_map = (types == NULL || types->is_empty())
           ? Handle<Map>::null()
           : types->first();
@@ -5183,7 +8253,7 @@ void HGraphBuilder::VisitCall(Call* expr) {
             new(zone()) HCallConstantFunction(expr->target(),
                                               argument_count));
       }
-    } else if (types != NULL && types->length() > 1) {
+    } else if (speculate && types != NULL && types->length() > 1) {
       ASSERT(expr->check_type() == RECEIVER_MAP_CHECK);
       HandlePolymorphicCallNamed(expr, receiver, types, name);
       return;
@@ -5222,7 +8292,12 @@ void HGraphBuilder::VisitCall(Call* expr) {
 
         CHECK_ALIVE(VisitForValue(expr->expression()));
         HValue* function = Pop();
-        AddInstruction(new(zone()) HCheckFunction(function, expr->target()));
+        // A function embedded as a constant needs no check.
+        if (!function->IsConstant() ||
+            !HConstant::cast(function)->handle().is_identical_to(
+                expr->target())) {
+          AddInstruction(new(zone()) HCheckFunction(function, expr->target()));
+        }
 
         // Replace the global object with the global receiver.
         HGlobalReceiver* global_receiver =
@@ -5248,7 +8323,7 @@ void HGraphBuilder::VisitCall(Call* expr) {
         Drop(argument_count);
       }
 
-    } else if (expr->IsMonomorphic()) {
+    } else {
       // The function is on the stack in the unoptimized code during
       // evaluation of the arguments.
       CHECK_ALIVE(VisitForValue(expr->expression()));
@@ -5257,31 +8332,32 @@ void HGraphBuilder::VisitCall(Call* expr) {
       HGlobalObject* global = new(zone()) HGlobalObject(context);
       HGlobalReceiver* receiver = new(zone()) HGlobalReceiver(global);
       AddInstruction(global);
-      PushAndAdd(receiver);
-      CHECK_ALIVE(VisitExpressions(expr->arguments()));
-      AddInstruction(new(zone()) HCheckFunction(function, expr->target()));
-      if (TryInline(expr, true)) {   // Drop function from environment.
-        return;
-      } else {
+      // A closure created by this code, like a block passed on to an
+      // inlined method, is known without type feedback.
+      bool is_closure_literal = function->IsFunctionLiteral();
+      if (is_closure_literal || expr->IsMonomorphic()) {
+        PushAndAdd(receiver);
+        CHECK_ALIVE(VisitExpressions(expr->arguments()));
+        if (is_closure_literal) {
+          if (TryInlineClosure(expr, HFunctionLiteral::cast(function))) {
+            return;
+          }
+        } else {
+          AddInstruction(new(zone()) HCheckFunction(function, expr->target()));
+          if (TryInline(expr, true)) return;  // Drop function from environment.
+        }
         call = PreProcessCall(new(zone()) HInvokeFunction(context,
                                                           function,
                                                           argument_count));
         Drop(1);  // The function.
-      }
-
-    } else {
-      CHECK_ALIVE(VisitForValue(expr->expression()));
-      HValue* function = Top();
-      HValue* context = environment()->LookupContext();
-      HGlobalObject* global_object = new(zone()) HGlobalObject(context);
-      HGlobalReceiver* receiver = new(zone()) HGlobalReceiver(global_object);
-      AddInstruction(global_object);
-      AddInstruction(receiver);
-      PushAndAdd(new(zone()) HPushArgument(receiver));
-      CHECK_ALIVE(VisitArgumentList(expr->arguments()));
+      } else {
+        AddInstruction(receiver);
+        PushAndAdd(new(zone()) HPushArgument(receiver));
+        CHECK_ALIVE(VisitArgumentList(expr->arguments()));
 
-      call = new(zone()) HCallFunction(context, function, argument_count);
-      Drop(argument_count + 1);
+        call = new(zone()) HCallFunction(context, function, argument_count);
+        Drop(argument_count + 1);
+      }
     }
   }
 
@@ -5294,6 +8370,11 @@ void HGraphBuilder::VisitCallNew(CallNew* expr) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
+  Handle<JSFunction> target;
+  if (FLAG_inline_construct && ComputeInlineConstructTarget(expr, &target)) {
+    return BuildInlineConstruct(expr, target);
+  }
+
   // The constructor function is also used as the receiver argument to the
   // JS construct call builtin.
   HValue* constructor = NULL;
@@ -5312,6 +8393,90 @@ void HGraphBuilder::VisitCallNew(CallNew* expr) {
 }
 
 
+bool HGraphBuilder::ComputeInlineConstructTarget(CallNew* expr,
+                                                 Handle<JSFunction>* target) {
+  VariableProxy* proxy = expr->expression()->AsVariableProxy();
+  if (proxy == NULL || !proxy->var()->IsUnallocated()) return false;
+  LookupResult lookup(isolate());
+  if (LookupGlobalProperty(proxy->var(), &lookup, false) != kUseCell) {
+    return false;
+  }
+  Handle<GlobalObject> global(info()->global_object());
+  if (global->IsAccessCheckNeeded()) return false;
+  Object* value = global->GetPropertyCell(&lookup)->value();
+  if (!value->IsJSFunction()) return false;
+  Handle<JSFunction> function(JSFunction::cast(value));
+  // As for calls of global functions, a function in new space is more
+  // likely to change.
+  if (isolate()->heap()->InNewSpace(*function)) return false;
+  if (!function->has_initial_map()) return false;
+  Handle<Map> initial_map(function->initial_map());
+  if (initial_map->instance_type() != JS_OBJECT_TYPE) return false;
+  // The runtime system installs a specialized construct stub only for
+  // functions whose bodies consist of simple this property assignments,
+  // once in-object slack tracking is over.  The generic construct stubs
+  // are builtins.
+  if (function->shared()->construct_stub()->kind() != Code::STUB) {
+    return false;
+  }
+  ASSERT(function->shared()->has_only_simple_this_property_assignments());
+  ASSERT(function->shared()->this_property_assignments_count() <=
+         initial_map->inobject_properties());
+  *target = function;
+  return true;
+}
+
+
+void HGraphBuilder::BuildInlineConstruct(CallNew* expr,
+                                         Handle<JSFunction> target) {
+  // Keep the constructor and the arguments on the expression stack, as the
+  // full code generator does, so that deoptimizing in between resumes there.
+  CHECK_ALIVE(VisitForValue(expr->expression()));
+  HValue* function = Top();
+  // A function embedded as a constant needs no check.
+  if (!function->IsConstant() ||
+      !HConstant::cast(function)->handle().is_identical_to(target)) {
+    AddInstruction(new(zone()) HCheckFunction(function, target));
+  }
+  CHECK_ALIVE(VisitExpressions(expr->arguments()));
+  int argument_count = expr->arguments()->length();
+
+  // Look up the values of the property assignments before allocating, so
+  // that no constant is materialized between the allocation and the stores.
+  Handle<SharedFunctionInfo> shared(target->shared());
+  int assignments_count = shared->this_property_assignments_count();
+  ZoneList<HValue*> values(assignments_count);
+  for (int i = 0; i < assignments_count; i++) {
+    HValue* value;
+    if (shared->IsThisPropertyAssignmentArgument(i)) {
+      int arg_number = shared->GetThisPropertyAssignmentArgument(i);
+      value = arg_number < argument_count
+          ? environment()->ExpressionStackAt(argument_count - 1 - arg_number)
+          : graph()->GetConstantUndefined();
+    } else {
+      Handle<Object> constant(shared->GetThisPropertyAssignmentConstant(i));
+      value = AddInstruction(
+          new(zone()) HConstant(constant, Representation::Tagged()));
+    }
+    values.Add(value);
+  }
+
+  HValue* context = environment()->LookupContext();
+  HAllocateObject* receiver = new(zone()) HAllocateObject(context, target);
+  receiver->set_position(expr->position());
+  AddInstruction(receiver);
+  for (int i = 0; i < assignments_count; i++) {
+    Handle<String> name(shared->GetThisPropertyAssignmentName(i));
+    int offset = JSObject::kHeaderSize + i * kPointerSize;
+    AddInstruction(new(zone()) HStoreNamedField(
+        receiver, name, values[i], true, offset));
+  }
+
+  Drop(argument_count + 1);
+  return ast_context()->ReturnValue(receiver);
+}
+
+
 // Support for generating inlined runtime functions.
 
 // Lookup table for generators for runtime calls that are  generated inline.
@@ -5331,9 +8496,7 @@ void HGraphBuilder::VisitCallRuntime(CallRuntime* expr) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
-  if (expr->is_jsruntime()) {
-    return Bailout("call to a JavaScript runtime function");
-  }
+  if (expr->is_jsruntime()) return HandleJSRuntimeCall(expr);
 
   const Runtime::Function* function = expr->function();
   ASSERT(function != NULL);
@@ -5366,6 +8529,32 @@ void HGraphBuilder::VisitCallRuntime(CallRuntime* expr) {
 }
 
 
+// The builtins object is not reachable from user code, so the functions
+// in it do not change and a call to one is a call to a constant function.
+void HGraphBuilder::HandleJSRuntimeCall(CallRuntime* expr) {
+  Handle<JSObject> builtins(
+      info()->closure()->context()->global()->builtins());
+  LookupResult lookup(isolate());
+  builtins->LocalLookup(*expr->name(), &lookup);
+  if (!lookup.IsProperty() || lookup.type() != NORMAL) {
+    return Bailout("call to an unknown JavaScript runtime function");
+  }
+  Object* value = builtins->GetNormalizedProperty(&lookup);
+  if (!value->IsJSFunction()) {
+    return Bailout("call to an unknown JavaScript runtime function");
+  }
+  Handle<JSFunction> function(JSFunction::cast(value));
+
+  PushAndAdd(new(zone()) HConstant(builtins, Representation::Tagged()));
+  CHECK_ALIVE(VisitExpressions(expr->arguments()));
+  int argument_count = expr->arguments()->length() + 1;  // Plus receiver.
+  HInstruction* call = PreProcessCall(
+      new(zone()) HCallConstantFunction(function, argument_count));
+  call->set_position(RelocInfo::kNoPosition);
+  return ast_context()->ReturnInstruction(call, expr->id());
+}
+
+
 void HGraphBuilder::VisitUnaryOperation(UnaryOperation* expr) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
@@ -5727,6 +8916,8 @@ HInstruction* HGraphBuilder::BuildBinaryOperation(BinaryOperation* expr,
     AddInstruction(new(zone()) HSoftDeoptimize);
     current_block()->MarkAsDeoptimizing();
     info = TypeInfo::Unknown();
+  } else if (IsUnstableDeoptimizationSite()) {
+    info = TypeInfo::Unknown();
   }
   HInstruction* instr = NULL;
   switch (expr->op()) {
@@ -6021,6 +9212,21 @@ static bool IsLiteralCompareNil(HValue* left,
 }
 
 
+static bool IsAtomConstant(HValue* value) {
+  return value->IsConstant() && HConstant::cast(value)->handle()->IsAtom();
+}
+
+
+// Atoms are interned and only equal to themselves, so comparing against a
+// literal atom is an identity compare whatever the other operand is.
+static bool IsLiteralCompareAtom(HValue* left,
+                                 Token::Value op,
+                                 HValue* right) {
+  return (op == Token::EQ || op == Token::EQ_STRICT) &&
+      (IsAtomConstant(left) || IsAtomConstant(right));
+}
+
+
 void HGraphBuilder::VisitCompareOperation(CompareOperation* expr) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
@@ -6049,6 +9255,7 @@ void HGraphBuilder::VisitCompareOperation(CompareOperation* expr) {
 
   CHECK_ALIVE(VisitForValue(expr->left()));
   CHECK_ALIVE(VisitForValue(expr->right()));
+  if (IsUnstableDeoptimizationSite()) type_info = TypeInfo::Unknown();
 
   HValue* context = environment()->LookupContext();
   HValue* right = Pop();
@@ -6068,6 +9275,12 @@ void HGraphBuilder::VisitCompareOperation(CompareOperation* expr) {
   if (IsLiteralCompareNil(left, op, right, f->null_value(), &sub_expr)) {
     return HandleLiteralCompareNil(expr, sub_expr, kNullValue);
   }
+  if (IsLiteralCompareAtom(left, op, right)) {
+    HCompareObjectEqAndBranch* result =
+        new(zone()) HCompareObjectEqAndBranch(left, right);
+    result->set_position(expr->position());
+    return ast_context()->ReturnControl(result, expr->id());
+  }
 
   if (op == Token::INSTANCEOF) {
     // Check to see if the rhs of the instanceof is a global function not
@@ -6095,14 +9308,30 @@ void HGraphBuilder::VisitCompareOperation(CompareOperation* expr) {
       }
     }
 
-    // If the target is not null we have found a known global function that is
-    // assumed to stay the same for this instanceof.
+    // A constant function, for instance one loaded from a constant function
+    // property of a known map, does not need to be checked.
+    bool constant_function = false;
+    if (target.is_null() && right->IsConstant()) {
+      Handle<Object> constant = HConstant::cast(right)->handle();
+      if (constant->IsJSFunction() &&
+          !isolate()->heap()->InNewSpace(*constant)) {
+        target = Handle<JSFunction>::cast(constant);
+        constant_function = true;
+      }
+    }
+
+    // If the target is not null we have found a known function that is
+    // assumed to stay the same for this instanceof.  The instanceof then
+    // checks the map of the left operand against the map it last saw at
+    // this site and loads the cached answer.
     if (target.is_null()) {
       HInstanceOf* result = new(zone()) HInstanceOf(context, left, right);
       result->set_position(expr->position());
       return ast_context()->ReturnInstruction(result, expr->id());
     } else {
-      AddInstruction(new(zone()) HCheckFunction(right, target));
+      if (!constant_function) {
+        AddInstruction(new(zone()) HCheckFunction(right, target));
+      }
       HInstanceOfKnownGlobal* result =
           new(zone()) HInstanceOfKnownGlobal(context, left, target);
       result->set_position(expr->position());
@@ -6138,6 +9367,16 @@ void HGraphBuilder::VisitCompareOperation(CompareOperation* expr) {
         new(zone()) HCompareObjectEqAndBranch(left, right);
     result->set_position(expr->position());
     return ast_context()->ReturnControl(result, expr->id());
+  } else if (type_info.IsString() &&
+             (op == Token::EQ || op == Token::EQ_STRICT)) {
+    AddInstruction(new(zone()) HCheckNonSmi(left));
+    AddInstruction(HCheckInstanceType::NewIsString(left));
+    AddInstruction(new(zone()) HCheckNonSmi(right));
+    AddInstruction(HCheckInstanceType::NewIsString(right));
+    HStringCompareAndBranch* result =
+        new(zone()) HStringCompareAndBranch(context, left, right, op);
+    result->set_position(expr->position());
+    return ast_context()->ReturnControl(result, expr->id());
   } else {
     Representation r = ToRepresentation(type_info);
     if (r.IsTagged()) {
@@ -6339,7 +9578,8 @@ void HGraphBuilder::GenerateArgumentsLength(CallRuntime* call) {
   // function is blacklisted by AstNode::IsInlineable.
   ASSERT(function_state()->outer() == NULL);
   ASSERT(call->arguments()->length() == 0);
-  HInstruction* elements = AddInstruction(new(zone()) HArgumentsElements);
+  HInstruction* elements = AddInstruction(
+      new(zone()) HArgumentsElements(false));
   HArgumentsLength* result = new(zone()) HArgumentsLength(elements);
   return ast_context()->ReturnInstruction(result, call->id());
 }
@@ -6353,7 +9593,8 @@ void HGraphBuilder::GenerateArguments(CallRuntime* call) {
   ASSERT(call->arguments()->length() == 1);
   CHECK_ALIVE(VisitForValue(call->arguments()->at(0)));
   HValue* index = Pop();
-  HInstruction* elements = AddInstruction(new(zone()) HArgumentsElements);
+  HInstruction* elements = AddInstruction(
+      new(zone()) HArgumentsElements(false));
   HInstruction* length = AddInstruction(new(zone()) HArgumentsLength(elements));
   HAccessArgumentsAt* result =
       new(zone()) HAccessArgumentsAt(elements, length, index);
@@ -6378,6 +9619,17 @@ void HGraphBuilder::GenerateValueOf(CallRuntime* call) {
 }
 
 
+void HGraphBuilder::GenerateDateField(CallRuntime* call) {
+  ASSERT(call->arguments()->length() == 2);
+  ASSERT_NE(NULL, call->arguments()->at(1)->AsLiteral());
+  Smi* index = Smi::cast(*(call->arguments()->at(1)->AsLiteral()->handle()));
+  CHECK_ALIVE(VisitForValue(call->arguments()->at(0)));
+  HValue* date = Pop();
+  HDateField* result = new(zone()) HDateField(date, index);
+  return ast_context()->ReturnInstruction(result, call->id());
+}
+
+
 void HGraphBuilder::GenerateSetValueOf(CallRuntime* call) {
   ASSERT(call->arguments()->length() == 2);
   CHECK_ALIVE(VisitForValue(call->arguments()->at(0)));
@@ -6569,6 +9821,118 @@ void HGraphBuilder::GenerateSwapElements(CallRuntime* call) {
 }
 
 
+// Exact integer arithmetic.  Two smis are combined as doubles, which is
+// exact whenever the result is in smi range, so only results outside that
+// range and non-smi operands take the runtime call.  Unlike the int32
+// arithmetic of a binary operation, overflow never deoptimizes.
+void HGraphBuilder::GenerateIntegerOperation(CallRuntime* call,
+                                             Token::Value op,
+                                             Runtime::FunctionId id) {
+  ASSERT(call->arguments()->length() == 2);
+  CHECK_ALIVE(VisitForValue(call->arguments()->at(0)));
+  CHECK_ALIVE(VisitForValue(call->arguments()->at(1)));
+  HValue* right = Pop();
+  HValue* left = Pop();
+  HValue* context = environment()->LookupContext();
+
+  static const int kSlowCases = 4;
+  HBasicBlock* slow[kSlowCases];
+  for (int i = 0; i < kSlowCases; i++) slow[i] = graph()->CreateBasicBlock();
+  HBasicBlock* join = graph()->CreateBasicBlock();
+
+  // Check that both operands are smis.
+  HBasicBlock* left_smi = graph()->CreateBasicBlock();
+  HIsSmiAndBranch* left_check = new(zone()) HIsSmiAndBranch(left);
+  left_check->SetSuccessorAt(0, left_smi);
+  left_check->SetSuccessorAt(1, slow[0]);
+  current_block()->Finish(left_check);
+  set_current_block(left_smi);
+  HBasicBlock* both_smi = graph()->CreateBasicBlock();
+  HIsSmiAndBranch* right_check = new(zone()) HIsSmiAndBranch(right);
+  right_check->SetSuccessorAt(0, both_smi);
+  right_check->SetSuccessorAt(1, slow[1]);
+  current_block()->Finish(right_check);
+
+  // Compute the result as a double and check that it is in smi range.
+  set_current_block(both_smi);
+  HInstruction* result = NULL;
+  switch (op) {
+    case Token::ADD:
+      result = new(zone()) HAdd(context, left, right);
+      break;
+    case Token::SUB:
+      result = new(zone()) HSub(context, left, right);
+      break;
+    case Token::MUL:
+      result = new(zone()) HMul(context, left, right);
+      break;
+    default:
+      UNREACHABLE();
+  }
+  result->AssumeRepresentation(Representation::Double());
+  AddInstruction(result);
+  HConstant* min_value = new(zone()) HConstant(
+      Handle<Object>(Smi::FromInt(Smi::kMinValue)), Representation::Double());
+  AddInstruction(min_value);
+  HBasicBlock* above_min = graph()->CreateBasicBlock();
+  HCompareIDAndBranch* min_check =
+      new(zone()) HCompareIDAndBranch(result, min_value, Token::GTE);
+  min_check->SetInputRepresentation(Representation::Double());
+  min_check->SetSuccessorAt(0, above_min);
+  min_check->SetSuccessorAt(1, slow[2]);
+  current_block()->Finish(min_check);
+  set_current_block(above_min);
+  HConstant* max_value = new(zone()) HConstant(
+      Handle<Object>(Smi::FromInt(Smi::kMaxValue)), Representation::Double());
+  AddInstruction(max_value);
+  HBasicBlock* in_range = graph()->CreateBasicBlock();
+  HCompareIDAndBranch* max_check =
+      new(zone()) HCompareIDAndBranch(result, max_value, Token::LTE);
+  max_check->SetInputRepresentation(Representation::Double());
+  max_check->SetSuccessorAt(0, in_range);
+  max_check->SetSuccessorAt(1, slow[3]);
+  current_block()->Finish(max_check);
+
+  // The result is integral, so truncation is exact and also drops -0.
+  set_current_block(in_range);
+  Push(AddInstruction(
+      new(zone()) HChange(result, Representation::Integer32(), true, false)));
+  current_block()->Goto(join);
+
+  // Everything else is left to the runtime, which promotes to BigInteger.
+  const Runtime::Function* function = Runtime::FunctionForId(id);
+  for (int i = 0; i < kSlowCases; i++) {
+    set_current_block(slow[i]);
+    AddInstruction(new(zone()) HPushArgument(left));
+    AddInstruction(new(zone()) HPushArgument(right));
+    HCallRuntime* runtime_call =
+        new(zone()) HCallRuntime(context, call->name(), function, 2);
+    runtime_call->set_position(RelocInfo::kNoPosition);
+    Push(AddInstruction(runtime_call));
+    current_block()->Goto(join);
+  }
+
+  join->SetJoinId(call->id());
+  set_current_block(join);
+  return ast_context()->ReturnValue(Pop());
+}
+
+
+void HGraphBuilder::GenerateIntegerAdd(CallRuntime* call) {
+  return GenerateIntegerOperation(call, Token::ADD, Runtime::kIntegerAdd);
+}
+
+
+void HGraphBuilder::GenerateIntegerSub(CallRuntime* call) {
+  return GenerateIntegerOperation(call, Token::SUB, Runtime::kIntegerSub);
+}
+
+
+void HGraphBuilder::GenerateIntegerMul(CallRuntime* call) {
+  return GenerateIntegerOperation(call, Token::MUL, Runtime::kIntegerMul);
+}
+
+
 // Fast call for custom callbacks.
 void HGraphBuilder::GenerateCallFunction(CallRuntime* call) {
   // 1 ~ The function to call is not itself an argument to the call.
@@ -6576,11 +9940,13 @@ void HGraphBuilder::GenerateCallFunction(CallRuntime* call) {
   ASSERT(arg_count >= 1);  // There's always at least a receiver.
 
   for (int i = 0; i < arg_count; ++i) {
-    CHECK_ALIVE(VisitArgument(call->arguments()->at(i)));
+    CHECK_ALIVE(VisitForValue(call->arguments()->at(i)));
   }
   CHECK_ALIVE(VisitForValue(call->arguments()->last()));
 
   HValue* function = Pop();
+  if (TryInlineCallFunction(call, function, arg_count - 1)) return;
+  PushArgumentsFromEnvironment(arg_count);
   HValue* context = environment()->LookupContext();
 
   // Branch for function proxies, or other non-functions.
@@ -6596,14 +9962,12 @@ void HGraphBuilder::GenerateCallFunction(CallRuntime* call) {
   set_current_block(if_jsfunction);
   HInstruction* invoke_result = AddInstruction(
       new(zone()) HInvokeFunction(context, function, arg_count));
-  Drop(arg_count);
   Push(invoke_result);
   if_jsfunction->Goto(join);
 
   set_current_block(if_nonfunction);
   HInstruction* call_result = AddInstruction(
       new(zone()) HCallFunction(context, function, arg_count));
-  Drop(arg_count);
   Push(call_result);
   if_nonfunction->Goto(join);
 
@@ -6613,6 +9977,40 @@ void HGraphBuilder::GenerateCallFunction(CallRuntime* call) {
 }
 
 
+bool HGraphBuilder::TryInlineCallFunction(CallRuntime* call,
+                                          HValue* function,
+                                          int arguments_count) {
+  // The function is known if it is a constant, or speculatively if it is
+  // loaded from a global property cell, like a callback passed to an
+  // inlined Array.prototype.forEach.
+  Handle<JSFunction> target;
+  bool needs_check = false;
+  if (function->IsConstant() &&
+      HConstant::cast(function)->handle()->IsJSFunction()) {
+    target = Handle<JSFunction>::cast(HConstant::cast(function)->handle());
+  } else if (function->IsLoadGlobalCell()) {
+    Handle<Object> value(HLoadGlobalCell::cast(function)->cell()->value());
+    if (!value->IsJSFunction()) return false;
+    target = Handle<JSFunction>::cast(value);
+    needs_check = true;
+  } else {
+    return false;
+  }
+  if (!target->IsInlineable()) return false;
+
+  if (needs_check) {
+    AddInstruction(new(zone()) HCheckFunction(function, target));
+  }
+  // The receiver is passed explicitly, like for a method call.
+  return TryInline(CALL_AS_METHOD,
+                   target,
+                   arguments_count,
+                   call->id(),
+                   call->ReturnId(),
+                   false);
+}
+
+
 // Fast call to math functions.
 void HGraphBuilder::GenerateMathPow(CallRuntime* call) {
   ASSERT_EQ(2, call->arguments()->length());
@@ -6706,6 +10104,8 @@ HEnvironment::HEnvironment(HEnvironment* outer,
                            Scope* scope,
                            Handle<JSFunction> closure)
     : closure_(closure),
+      has_dynamic_closure_(false),
+      entry_(NULL),
       values_(0),
       assigned_variables_(4),
       parameter_count_(0),
@@ -6720,7 +10120,9 @@ HEnvironment::HEnvironment(HEnvironment* outer,
 
 
 HEnvironment::HEnvironment(const HEnvironment* other)
-    : values_(0),
+    : has_dynamic_closure_(false),
+      entry_(NULL),
+      values_(0),
       assigned_variables_(0),
       parameter_count_(0),
       specials_count_(1),
@@ -6748,6 +10150,8 @@ void HEnvironment::Initialize(int parameter_count,
 
 void HEnvironment::Initialize(const HEnvironment* other) {
   closure_ = other->closure();
+  has_dynamic_closure_ = other->has_dynamic_closure_;
+  entry_ = other->entry_;
   values_.AddAll(other->values_);
   assigned_variables_.AddAll(other->assigned_variables_);
   parameter_count_ = other->parameter_count_;
@@ -6859,20 +10263,26 @@ HEnvironment* HEnvironment::CopyAsLoopHeader(HBasicBlock* loop_header) const {
 
 HEnvironment* HEnvironment::CopyForInlining(
     Handle<JSFunction> target,
+    int arguments,
     FunctionLiteral* function,
     HConstant* undefined,
-    CallKind call_kind) const {
+    CallKind call_kind,
+    bool dynamic_closure) const {
   // Outer environment is a copy of this one without the arguments.
   int arity = function->scope()->num_parameters();
   HEnvironment* outer = Copy();
-  outer->Drop(arity + 1);  // Including receiver.
+  outer->Drop(arguments + 1);  // Including receiver.
   outer->ClearHistory();
   Zone* zone = closure()->GetIsolate()->zone();
   HEnvironment* inner =
       new(zone) HEnvironment(outer, function->scope(), target);
-  // Get the argument values from the original environment.
+  inner->has_dynamic_closure_ = dynamic_closure;
+  // Get the argument values from the original environment.  Parameters
+  // without an argument are undefined.
   for (int i = 0; i <= arity; ++i) {  // Include receiver.
-    HValue* push = ExpressionStackAt(arity - i);
+    HValue* push = (i <= arguments)
+        ? ExpressionStackAt(arguments - i)
+        : undefined;
     inner->SetValueAt(i, push);
   }
   // If the function we are inlining is a strict mode function or a
@@ -7165,6 +10575,46 @@ void HStatistics::Print() {
          "Total",
          static_cast<double>(total_) / 1000,
          static_cast<double>(total_) / full_code_gen_);
+
+  if (allocated_chunks_ == 0) return;
+  PrintF("---------------------------------------------------------------\n");
+  PrintF("Register allocation results (%d chunks):\n", allocated_chunks_);
+  PrintF("%30s - %8d\n", "Live ranges", live_ranges_);
+  PrintF("%30s - %8d / %4.1f %%\n", "Split ranges", split_ranges_,
+         static_cast<double>(split_ranges_) * 100 / live_ranges_);
+  PrintF("%30s - %8d / %4.1f %%\n", "Spilled ranges", spilled_ranges_,
+         static_cast<double>(spilled_ranges_) * 100 / live_ranges_);
+  PrintF("%30s - %8d (%.1f per chunk, at most %d)\n", "Spill slots",
+         spill_slots_,
+         static_cast<double>(spill_slots_) / allocated_chunks_,
+         max_spill_slots_);
+  PrintF("%30s - %8d\n", "Max register pressure", max_register_pressure_);
+  if (gap_moves_ == 0) return;
+  PrintF("%30s - %8d\n", "Gap moves", gap_moves_);
+  PrintF("%30s - %8d / %4.1f %%\n", "Eliminated gap moves",
+         eliminated_gap_moves_,
+         static_cast<double>(eliminated_gap_moves_) * 100 / gap_moves_);
+}
+
+
+void HStatistics::SaveRegisterAllocation(int live_ranges,
+                                         int split_ranges,
+                                         int spilled_ranges,
+                                         int spill_slots,
+                                         int max_pressure) {
+  allocated_chunks_++;
+  live_ranges_ += live_ranges;
+  split_ranges_ += split_ranges;
+  spilled_ranges_ += spilled_ranges;
+  spill_slots_ += spill_slots;
+  max_spill_slots_ = Max(max_spill_slots_, spill_slots);
+  max_register_pressure_ = Max(max_register_pressure_, max_pressure);
+}
+
+
+void HStatistics::SaveGapMoves(int moves, int eliminated_moves) {
+  gap_moves_ += moves;
+  eliminated_gap_moves_ += eliminated_moves;
 }
 
 
@@ -223,6 +223,7 @@ class HGraph: public ZoneObject {
 
   Isolate* isolate() { return isolate_; }
   Zone* zone() { return isolate_->zone(); }
+  CompilationInfo* info() const { return info_; }
 
   const ZoneList<HBasicBlock*>* blocks() const { return &blocks_; }
   const ZoneList<HPhi*>* phi_list() const { return phi_list_; }
@@ -233,6 +234,7 @@ class HGraph: public ZoneObject {
   void InsertTypeConversions();
   void InsertRepresentationChanges();
   void MarkDeoptimizeOnUndefined();
+  void MarkTruncatingDivisions();
   void ComputeMinusZeroChecks();
   bool ProcessArgumentsObject();
   void EliminateRedundantPhis();
@@ -253,6 +255,18 @@ class HGraph: public ZoneObject {
 
   void CollectPhis();
 
+  // Runs the optimization phases on a graph built by
+  // HGraphBuilder::CreateGraph.
+  void Optimize();
+
+  // Translates the optimized graph to Lithium and allocates registers.
+  // Returns NULL if that fails.  Neither allocates on the heap nor creates
+  // handles, so it can run on the optimizing compiler thread.
+  LChunk* CreateChunk(CompilationInfo* info);
+
+  // Generates the native code for a chunk from CreateChunk.
+  Handle<Code> GenerateCode(LChunk* chunk, CompilationInfo* info);
+
   Handle<Code> Compile(CompilationInfo* info);
 
   void set_undefined_constant(HConstant* constant) {
@@ -286,6 +300,19 @@ class HGraph: public ZoneObject {
     return NULL;
   }
 
+  // Global property cells embedded in the generated code.  The code is
+  // deoptimized when a property of one of them changes into an accessor.
+  void RecordDependentCell(Handle<JSGlobalPropertyCell> cell);
+  const ZoneList<Handle<JSGlobalPropertyCell> >* dependent_cells() const {
+    return &dependent_cells_;
+  }
+
+  // Global property cells whose values are embedded as constants.  The
+  // code is deoptimized when one of the values changes, and is not
+  // installed if one changed while it was being compiled.
+  void RecordConstantCell(Handle<JSGlobalPropertyCell> cell);
+  bool HasChangedConstantCells() const;
+
 #ifdef DEBUG
   void Verify(bool do_full_verify) const;
 #endif
@@ -316,12 +343,15 @@ class HGraph: public ZoneObject {
   void CheckForBackEdge(HBasicBlock* block, HBasicBlock* successor);
 
   Isolate* isolate_;
+  CompilationInfo* info_;
   int next_block_id_;
   HBasicBlock* entry_block_;
   HEnvironment* start_environment_;
   ZoneList<HBasicBlock*> blocks_;
   ZoneList<HValue*> values_;
   ZoneList<HPhi*>* phi_list_;
+  ZoneList<Handle<JSGlobalPropertyCell> > dependent_cells_;
+  ZoneList<Handle<JSGlobalPropertyCell> > constant_cells_;
   SetOncePointer<HConstant> undefined_constant_;
   SetOncePointer<HConstant> constant_1_;
   SetOncePointer<HConstant> constant_minus1_;
@@ -345,6 +375,15 @@ class HEnvironment: public ZoneObject {
 
   // Simple accessors.
   Handle<JSFunction> closure() const { return closure_; }
+  // The environment of an inlined closure that is created by the code
+  // being compiled only has a template of the closure, with the right
+  // shared function info but not the right context.  The closure itself
+  // is the top of the outer environment's expression stack.
+  bool has_dynamic_closure() const { return has_dynamic_closure_; }
+  // The entry of the inlined function the environment belongs to, or NULL
+  // for the function being compiled.
+  HEnterInlined* entry() const { return entry_; }
+  void set_entry(HEnterInlined* entry) { entry_ = entry; }
   const ZoneList<HValue*>* values() const { return &values_; }
   const ZoneList<int>* assigned_variables() const {
     return &assigned_variables_;
@@ -427,9 +466,11 @@ class HEnvironment: public ZoneObject {
   // environment is the outer environment but the top expression stack
   // elements are moved to an inner environment as parameters.
   HEnvironment* CopyForInlining(Handle<JSFunction> target,
+                                int arguments,
                                 FunctionLiteral* function,
                                 HConstant* undefined,
-                                CallKind call_kind) const;
+                                CallKind call_kind,
+                                bool dynamic_closure) const;
 
   void AddIncomingEdge(HBasicBlock* block, HEnvironment* other);
 
@@ -468,6 +509,8 @@ class HEnvironment: public ZoneObject {
   }
 
   Handle<JSFunction> closure_;
+  bool has_dynamic_closure_;
+  HEnterInlined* entry_;
   // Value array [parameters] [specials] [locals] [temporaries].
   ZoneList<HValue*> values_;
   ZoneList<int> assigned_variables_;
@@ -626,6 +669,20 @@ class FunctionState {
 
   FunctionState* outer() { return outer_; }
 
+  // The entry of an inlined function, and its arguments object if it uses
+  // one.  The elements are set once the arguments are pushed for an access
+  // by a variable index.
+  HEnterInlined* entry() { return entry_; }
+  void set_entry(HEnterInlined* entry) { entry_ = entry; }
+  HArgumentsObject* arguments_object() { return arguments_object_; }
+  void set_arguments_object(HArgumentsObject* object) {
+    arguments_object_ = object;
+  }
+  HArgumentsElements* arguments_elements() { return arguments_elements_; }
+  void set_arguments_elements(HArgumentsElements* elements) {
+    arguments_elements_ = elements;
+  }
+
  private:
   HGraphBuilder* owner_;
 
@@ -650,6 +707,10 @@ class FunctionState {
   // return blocks.  NULL in all other cases.
   TestContext* test_context_;
 
+  HEnterInlined* entry_;
+  HArgumentsObject* arguments_object_;
+  HArgumentsElements* arguments_elements_;
+
   FunctionState* outer_;
 };
 
@@ -657,15 +718,30 @@ class FunctionState {
 class HGraphBuilder: public AstVisitor {
  public:
   enum BreakType { BREAK, CONTINUE };
-  enum SwitchType { UNKNOWN_SWITCH, SMI_SWITCH, STRING_SWITCH };
+  enum SwitchType {
+    UNKNOWN_SWITCH, SMI_SWITCH, STRING_SWITCH, GENERIC_SWITCH
+  };
+
+  // A switch clause with a literal label, keyed by the value of a smi label
+  // or by the hash of a string label.
+  struct SwitchCase {
+    int key;
+    int clause_index;
+  };
 
   // A class encapsulating (lazily-allocated) break and continue blocks for
   // a breakable statement.  Separated from BreakAndContinueScope so that it
   // can have a separate lifetime.
   class BreakAndContinueInfo BASE_EMBEDDED {
    public:
-    explicit BreakAndContinueInfo(BreakableStatement* target)
-      : target_(target), break_block_(NULL), continue_block_(NULL) {
+    // drop_extra is the number of values the statement keeps on the
+    // expression stack while its body runs, like the state of a for-in.
+    explicit BreakAndContinueInfo(BreakableStatement* target,
+                                  int drop_extra = 0)
+      : target_(target),
+        break_block_(NULL),
+        continue_block_(NULL),
+        drop_extra_(drop_extra) {
     }
 
     BreakableStatement* target() { return target_; }
@@ -673,11 +749,13 @@ class HGraphBuilder: public AstVisitor {
     void set_break_block(HBasicBlock* block) { break_block_ = block; }
     HBasicBlock* continue_block() { return continue_block_; }
     void set_continue_block(HBasicBlock* block) { continue_block_ = block; }
+    int drop_extra() { return drop_extra_; }
 
    private:
     BreakableStatement* target_;
     HBasicBlock* break_block_;
     HBasicBlock* continue_block_;
+    int drop_extra_;
   };
 
   // A helper class to maintain a stack of current BreakAndContinueInfo
@@ -695,8 +773,12 @@ class HGraphBuilder: public AstVisitor {
     HGraphBuilder* owner() { return owner_; }
     BreakAndContinueScope* next() { return next_; }
 
-    // Search the break stack for a break or continue target.
-    HBasicBlock* Get(BreakableStatement* stmt, BreakType type);
+    // Search the break stack for a break or continue target.  Sets
+    // drop_extra to the number of values to drop from the expression stack
+    // before jumping there.
+    HBasicBlock* Get(BreakableStatement* stmt,
+                     BreakType type,
+                     int* drop_extra);
 
    private:
     BreakAndContinueInfo* info_;
@@ -752,10 +834,6 @@ class HGraphBuilder: public AstVisitor {
   static const int kMaxLoadPolymorphism = 4;
   static const int kMaxStorePolymorphism = 4;
 
-  static const int kMaxInlinedNodes = 196;
-  static const int kMaxInlinedSize = 196;
-  static const int kMaxSourceSize = 600;
-
   // Simple accessors.
   void set_function_state(FunctionState* state) { function_state_ = state; }
 
@@ -792,6 +870,10 @@ class HGraphBuilder: public AstVisitor {
   INLINE_RUNTIME_FUNCTION_LIST(INLINE_FUNCTION_GENERATOR_DECLARATION)
 #undef INLINE_FUNCTION_GENERATOR_DECLARATION
 
+  void GenerateIntegerOperation(CallRuntime* call,
+                                Token::Value op,
+                                Runtime::FunctionId id);
+
   void HandleDeclaration(VariableProxy* proxy,
                          VariableMode mode,
                          FunctionLiteral* function);
@@ -815,6 +897,70 @@ class HGraphBuilder: public AstVisitor {
                      HBasicBlock* loop_entry,
                      BreakAndContinueInfo* break_info);
 
+  // Loop peeling support.  A small inner loop gets its first iteration
+  // built ahead of the loop itself, so that the checks done there dominate
+  // the steady-state loop body.  The statement's condition (which can be
+  // NULL) is visited before and its next statement (which can be NULL)
+  // after the peeled body.  peel_exit is set to the block where the peeled
+  // iteration leaves the loop, or NULL.
+  bool ShouldPeelLoop(IterationStatement* stmt);
+  void VisitPeeledIteration(IterationStatement* stmt,
+                            Expression* cond,
+                            int body_id,
+                            Statement* next,
+                            HBasicBlock** peel_exit);
+
+  // Element-wise double array loops.  A for loop of the form
+  //   for (; i < n; i++) a[i] = b[i] op c[i];
+  // where op is one of + - * / and b or c can also be a number, gets an
+  // HFastDoubleArrayMap ahead of it that handles as many elements as
+  // possible two at a time; the loop itself takes care of the rest.
+  void TryFastDoubleArrayMap(ForStatement* stmt);
+  bool MatchFastDoubleArrayOperand(Expression* expr,
+                                   Variable* index,
+                                   HValue** value,
+                                   bool* is_array);
+
+  // Switch statement support.  The tests keep the tag on the expression
+  // stack, as the unoptimized code does, so they can be repeated after a
+  // deoptimization.  SwitchTargets collects the blocks where they enter the
+  // clause bodies, and the block where control goes when no label matches,
+  // dropping the tag on the way.
+  class SwitchTargets BASE_EMBEDDED {
+   public:
+    SwitchTargets(HGraphBuilder* owner, SwitchStatement* stmt);
+
+    SwitchStatement* stmt() const { return stmt_; }
+    HBasicBlock* body_entry(int index) const { return body_entries_[index]; }
+    HBasicBlock* no_match() const { return no_match_; }
+
+    void GotoBody(HBasicBlock* block, int index);
+    void GotoNoMatch(HBasicBlock* block);
+
+   private:
+    HGraphBuilder* owner_;
+    SwitchStatement* stmt_;
+    ZoneList<HBasicBlock*> body_entries_;
+    HBasicBlock* no_match_;
+    int no_match_id_;
+  };
+
+  // Smi labels are found by a binary search on the tag's value and string
+  // labels by a binary search on the tag's hash, with linear tests at the
+  // leaves.  Other switches test the labels one after the other.
+  void BuildSmiSwitch(SwitchTargets* targets, HValue* tag);
+  void BuildStringSwitch(SwitchTargets* targets, HValue* tag);
+  void BuildGenericSwitch(SwitchTargets* targets, HValue* tag);
+  void BuildSwitchSearch(SwitchTargets* targets,
+                         HValue* key,
+                         HValue* tag,
+                         ZoneList<SwitchCase>* cases,
+                         int from,
+                         int to);
+  void BuildStringCompareChain(SwitchTargets* targets,
+                               HValue* tag,
+                               ZoneList<SwitchCase>* cases);
+
   // Create a back edge in the flow graph.  body_exit is the predecessor
   // block and loop_entry is the successor block.  loop_successor is the
   // block where control flow exits the loop normally (e.g., via failure of
@@ -863,6 +1009,7 @@ class HGraphBuilder: public AstVisitor {
   // Remove the arguments from the bailout environment and emit instructions
   // to push them as outgoing parameters.
   template <int V> HInstruction* PreProcessCall(HCall<V>* call);
+  void PushArgumentsFromEnvironment(int count);
 
   void TraceRepresentation(Token::Value op,
                            TypeInfo info,
@@ -871,6 +1018,8 @@ class HGraphBuilder: public AstVisitor {
   static Representation ToRepresentation(TypeInfo info);
 
   void SetupScope(Scope* scope);
+  // Allocates an escaping arguments object on function entry.
+  void AllocateArgumentsObject(Variable* arguments);
   virtual void VisitStatements(ZoneList<Statement*>* statements);
 
 #define DECLARE_VISIT(type) virtual void Visit##type(type* node);
@@ -890,16 +1039,44 @@ class HGraphBuilder: public AstVisitor {
                                             bool is_store);
 
   bool TryArgumentsAccess(Property* expr);
+  // Returns the elements of the arguments of the inlined call being built.
+  HInstruction* EnsureArgumentsArePushedForAccess();
 
   // Try to optimize fun.apply(receiver, arguments) pattern.
   bool TryCallApply(Call* expr);
 
   bool TryInline(Call* expr, bool drop_extra = false);
+  // Inline a call of target with the receiver and arguments_count arguments
+  // on top of the expression stack.  Missing arguments are undefined and
+  // extra arguments are dropped.  If closure_literal is not NULL, target
+  // is a template for the closure it creates, which is below the receiver
+  // on the expression stack.
+  bool TryInline(CallKind call_kind,
+                 Handle<JSFunction> target,
+                 int arguments_count,
+                 int ast_id,
+                 int return_id,
+                 bool drop_extra,
+                 HFunctionLiteral* closure_literal = NULL);
+  // Try to inline a call of a closure created by the code being compiled,
+  // like a block passed to an inlined Ruby method.
+  bool TryInlineClosure(Call* expr, HFunctionLiteral* closure);
+  // Try to inline the function called by %_CallFunction, if it is known.
+  bool TryInlineCallFunction(CallRuntime* call,
+                             HValue* function,
+                             int arguments_count);
   bool TryInlineBuiltinFunction(Call* expr,
                                 HValue* receiver,
                                 Handle<Map> receiver_map,
                                 CheckType check_type);
 
+  // Returns whether 'new' of the global function referenced by expr can
+  // allocate and initialize the object inline, and the function if so.
+  bool ComputeInlineConstructTarget(CallNew* expr, Handle<JSFunction>* target);
+  // Allocate the object for 'new target(...)' inline and perform the
+  // property assignments of target's specialized construct stub.
+  void BuildInlineConstruct(CallNew* expr, Handle<JSFunction> target);
+
   // If --trace-inlining, print a line of the inlining trace.  Inlining
   // succeeded if the reason string is NULL and failed if there is a
   // non-NULL reason string.
@@ -907,6 +1084,11 @@ class HGraphBuilder: public AstVisitor {
                    Handle<JSFunction> caller,
                    const char* failure_reason);
 
+  // Returns true if optimized code for the current function repeatedly
+  // deoptimized at the site of the instructions about to be added.  Such
+  // sites use generic operations instead of speculating on type feedback.
+  bool IsUnstableDeoptimizationSite();
+
   void HandleGlobalVariableAssignment(Variable* var,
                                       HValue* value,
                                       int position,
@@ -914,6 +1096,7 @@ class HGraphBuilder: public AstVisitor {
 
   void HandlePropertyAssignment(Assignment* expr);
   void HandleCompoundAssignment(Assignment* expr);
+  void HandleJSRuntimeCall(CallRuntime* expr);
   void HandlePolymorphicStoreNamedField(Assignment* expr,
                                         HValue* object,
                                         HValue* value,
@@ -1105,6 +1288,12 @@ class HStatistics: public Malloced {
   void Initialize(CompilationInfo* info);
   void Print();
   void SaveTiming(const char* name, int64_t ticks, unsigned size);
+  void SaveRegisterAllocation(int live_ranges,
+                              int split_ranges,
+                              int spilled_ranges,
+                              int spill_slots,
+                              int max_pressure);
+  void SaveGapMoves(int moves, int eliminated_moves);
   static HStatistics* Instance() {
     static SetOncePointer<HStatistics> instance;
     if (!instance.is_set()) {
@@ -1121,7 +1310,16 @@ class HStatistics: public Malloced {
         total_(0),
         total_size_(0),
         full_code_gen_(0),
-        source_size_(0) { }
+        source_size_(0),
+        allocated_chunks_(0),
+        live_ranges_(0),
+        split_ranges_(0),
+        spilled_ranges_(0),
+        spill_slots_(0),
+        max_spill_slots_(0),
+        max_register_pressure_(0),
+        gap_moves_(0),
+        eliminated_gap_moves_(0) { }
 
   List<int64_t> timing_;
   List<const char*> names_;
@@ -1130,6 +1328,17 @@ class HStatistics: public Malloced {
   unsigned total_size_;
   int64_t full_code_gen_;
   double source_size_;
+
+  // Register allocation statistics, summed over all chunks.
+  int allocated_chunks_;
+  int live_ranges_;
+  int split_ranges_;
+  int spilled_ranges_;
+  int spill_slots_;
+  int max_spill_slots_;
+  int max_register_pressure_;
+  int gap_moves_;
+  int eliminated_gap_moves_;
 };
 
 
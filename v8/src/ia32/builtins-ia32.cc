@@ -175,7 +175,7 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
         __ push(edi);
 
         __ push(edi);  // constructor
-        // The call will replace the stub, so the countdown is only done once.
+        // The call either restarts the countdown or replaces the stub.
         __ CallRuntime(Runtime::kFinalizeInstanceSize, 1);
 
         __ pop(edi);
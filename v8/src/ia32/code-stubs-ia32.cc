@@ -3571,6 +3571,18 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   // Get the length of the string to ebx.
   __ mov(ebx, FieldOperand(eax, String::kLengthOffset));
 
+  // ebx: Length of subject string as a smi
+  // ecx: RegExp data (FixedArray)
+  // edx: Number of capture registers
+  // Long subjects are searched for the literal prefix in the runtime.
+  Label no_literal_prefix;
+  __ mov(eax, FieldOperand(ecx, JSRegExp::kIrregexpLiteralPrefixOffset));
+  __ JumpIfSmi(eax, &no_literal_prefix);
+  __ cmp(ebx,
+         Immediate(Smi::FromInt(JSRegExp::kLiteralPrefixMinSubjectLength)));
+  __ j(greater_equal, &runtime);
+  __ bind(&no_literal_prefix);
+
   // ebx: Length of subject string as a smi
   // ecx: RegExp data (FixedArray)
   // edx: Number of capture registers
@@ -4467,6 +4479,15 @@ void StackCheckStub::Generate(MacroAssembler* masm) {
 }
 
 
+void InterruptStub::Generate(MacroAssembler* masm) {
+  // ebx holds the profiling counter cell.
+  __ pop(ecx);  // Return address.
+  __ push(ebx);
+  __ push(ecx);
+  __ TailCallRuntime(Runtime::kInterrupt, 1, 1);
+}
+
+
 void CallFunctionStub::FinishCode(Handle<Code> code) {
   code->set_has_function_cache(RecordCallTarget());
 }
@@ -4948,6 +4969,18 @@ void JSEntryStub::GenerateBody(MacroAssembler* masm, bool is_construct) {
 }
 
 
+// Computes the byte offset of the instanceof cache entry for the map and the
+// function in the offset register.
+static void GenerateInstanceofCacheOffset(MacroAssembler* masm,
+                                          Register map,
+                                          Register function,
+                                          Register offset) {
+  __ mov(offset, map);
+  __ xor_(offset, function);
+  __ and_(offset, InstanceofCache::kOffsetMask);
+}
+
+
 // Generate stub code for instanceof.
 // This code can patch a call site inlined cache of the instance of check,
 // which looks like this.
@@ -4983,8 +5016,12 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   static const int8_t kCmpEdiImmediateByte2 = BitCast<int8_t, uint8_t>(0xff);
   static const int8_t kMovEaxImmediateByte = BitCast<int8_t, uint8_t>(0xb8);
 
-  ExternalReference roots_array_start =
-      ExternalReference::roots_array_start(masm->isolate());
+  ExternalReference cache_functions =
+      ExternalReference::instanceof_cache_functions(masm->isolate());
+  ExternalReference cache_maps =
+      ExternalReference::instanceof_cache_maps(masm->isolate());
+  ExternalReference cache_answers =
+      ExternalReference::instanceof_cache_answers(masm->isolate());
 
   ASSERT_EQ(object.code(), InstanceofStub::left().code());
   ASSERT_EQ(function.code(), InstanceofStub::right().code());
@@ -5005,18 +5042,12 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   if (!HasCallSiteInlineCheck()) {
     // Look up the function and the map in the instanceof cache.
     Label miss;
-    __ mov(scratch, Immediate(Heap::kInstanceofCacheFunctionRootIndex));
-    __ cmp(function, Operand::StaticArray(scratch,
-                                          times_pointer_size,
-                                          roots_array_start));
+    GenerateInstanceofCacheOffset(masm, map, function, scratch);
+    __ cmp(function, Operand::StaticArray(scratch, times_1, cache_functions));
     __ j(not_equal, &miss, Label::kNear);
-    __ mov(scratch, Immediate(Heap::kInstanceofCacheMapRootIndex));
-    __ cmp(map, Operand::StaticArray(
-        scratch, times_pointer_size, roots_array_start));
+    __ cmp(map, Operand::StaticArray(scratch, times_1, cache_maps));
     __ j(not_equal, &miss, Label::kNear);
-    __ mov(scratch, Immediate(Heap::kInstanceofCacheAnswerRootIndex));
-    __ mov(eax, Operand::StaticArray(
-        scratch, times_pointer_size, roots_array_start));
+    __ mov(eax, Operand::StaticArray(scratch, times_1, cache_answers));
     __ ret((HasArgsInRegisters() ? 0 : 2) * kPointerSize);
     __ bind(&miss);
   }
@@ -5031,12 +5062,9 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   // Update the global instanceof or call site inlined cache with the current
   // map and function. The cached answer will be set when it is known below.
   if (!HasCallSiteInlineCheck()) {
-  __ mov(scratch, Immediate(Heap::kInstanceofCacheMapRootIndex));
-  __ mov(Operand::StaticArray(scratch, times_pointer_size, roots_array_start),
-         map);
-  __ mov(scratch, Immediate(Heap::kInstanceofCacheFunctionRootIndex));
-  __ mov(Operand::StaticArray(scratch, times_pointer_size, roots_array_start),
-         function);
+    GenerateInstanceofCacheOffset(masm, map, function, scratch);
+    __ mov(Operand::StaticArray(scratch, times_1, cache_maps), map);
+    __ mov(Operand::StaticArray(scratch, times_1, cache_functions), function);
   } else {
     // The constants for the code patching are based on no push instructions
     // at the call site.
@@ -5070,9 +5098,8 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   __ bind(&is_instance);
   if (!HasCallSiteInlineCheck()) {
     __ Set(eax, Immediate(0));
-    __ mov(scratch, Immediate(Heap::kInstanceofCacheAnswerRootIndex));
-    __ mov(Operand::StaticArray(scratch,
-                                times_pointer_size, roots_array_start), eax);
+    GenerateInstanceofCacheOffset(masm, map, function, scratch);
+    __ mov(Operand::StaticArray(scratch, times_1, cache_answers), eax);
   } else {
     // Get return address and delta to inlined map check.
     __ mov(eax, factory->true_value());
@@ -5092,9 +5119,8 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   __ bind(&is_not_instance);
   if (!HasCallSiteInlineCheck()) {
     __ Set(eax, Immediate(Smi::FromInt(1)));
-    __ mov(scratch, Immediate(Heap::kInstanceofCacheAnswerRootIndex));
-    __ mov(Operand::StaticArray(
-        scratch, times_pointer_size, roots_array_start), eax);
+    GenerateInstanceofCacheOffset(masm, map, function, scratch);
+    __ mov(Operand::StaticArray(scratch, times_1, cache_answers), eax);
   } else {
     // Get return address and delta to inlined map check.
     __ mov(eax, factory->false_value());
@@ -5513,6 +5539,31 @@ void StringAddStub::Generate(MacroAssembler* masm) {
          Immediate(String::kEmptyHashField));
   __ mov(FieldOperand(ecx, ConsString::kFirstOffset), eax);
   __ mov(FieldOperand(ecx, ConsString::kSecondOffset), edx);
+  // The depth of the result is one more than that of its deeper part.  Too
+  // deep results are left to the runtime, which rebalances them.
+  Label first_is_flat, second_is_flat;
+  __ Set(ebx, Immediate(Smi::FromInt(0)));
+  __ mov(edi, FieldOperand(eax, HeapObject::kMapOffset));
+  __ movzx_b(edi, FieldOperand(edi, Map::kInstanceTypeOffset));
+  __ and_(edi, kStringRepresentationMask);
+  __ cmp(edi, kConsStringTag);
+  __ j(not_equal, &first_is_flat, Label::kNear);
+  __ mov(ebx, FieldOperand(eax, ConsString::kDepthOffset));
+  __ bind(&first_is_flat);
+  __ mov(edi, FieldOperand(edx, HeapObject::kMapOffset));
+  __ movzx_b(edi, FieldOperand(edi, Map::kInstanceTypeOffset));
+  __ and_(edi, kStringRepresentationMask);
+  __ cmp(edi, kConsStringTag);
+  __ j(not_equal, &second_is_flat, Label::kNear);
+  __ mov(edi, FieldOperand(edx, ConsString::kDepthOffset));
+  __ cmp(edi, ebx);
+  __ j(less_equal, &second_is_flat, Label::kNear);
+  __ mov(ebx, edi);
+  __ bind(&second_is_flat);
+  __ add(ebx, Immediate(Smi::FromInt(1)));
+  __ mov(FieldOperand(ecx, ConsString::kDepthOffset), ebx);
+  __ cmp(ebx, Immediate(Smi::FromInt(ConsString::kMaxDepth)));
+  __ j(greater, &string_add_runtime);
   __ mov(eax, ecx);
   __ IncrementCounter(counters->string_add_native(), 1);
   __ ret(2 * kPointerSize);
@@ -5908,10 +5959,25 @@ void StringHelper::GenerateHashInit(MacroAssembler* masm,
                                     Register hash,
                                     Register character,
                                     Register scratch) {
-  // hash = character + (character << 10);
-  __ mov(hash, character);
-  __ shl(hash, 10);
-  __ add(hash, character);
+  // hash = (seed + character) + ((seed + character) << 10);
+  if (Serializer::enabled()) {
+    ExternalReference roots_array_start =
+        ExternalReference::roots_array_start(masm->isolate());
+    __ mov(scratch, Immediate(Heap::kHashSeedRootIndex));
+    __ mov(scratch, Operand::StaticArray(scratch,
+                                         times_pointer_size,
+                                         roots_array_start));
+    __ SmiUntag(scratch);
+    __ add(scratch, character);
+    __ mov(hash, scratch);
+    __ shl(scratch, 10);
+    __ add(hash, scratch);
+  } else {
+    int32_t seed = masm->isolate()->heap()->HashSeed();
+    __ lea(scratch, Operand(character, seed));
+    __ shl(scratch, 10);
+    __ lea(hash, Operand(scratch, character, times_1, seed));
+  }
   // hash ^= hash >> 6;
   __ mov(scratch, hash);
   __ shr(scratch, 6);
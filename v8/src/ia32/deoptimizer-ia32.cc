@@ -205,6 +205,21 @@ void Deoptimizer::DeoptimizeFunction(JSFunction* function) {
 }
 
 
+static const byte kJnsInstruction = 0x79;
+static const byte kJaeInstruction = 0x73;
+static const byte kJumpOffset = 0x07;
+
+
+// The conditional branch around a call to check_code: the stack check
+// jumps if the stack limit is not hit, the interrupt check if the
+// interrupt budget has not run out.
+static byte StackCheckBranchInstruction(Code* check_code) {
+  return check_code->major_key() == CodeStub::Interrupt
+      ? kJnsInstruction
+      : kJaeInstruction;
+}
+
+
 void Deoptimizer::PatchStackCheckCodeAt(Code* unoptimized_code,
                                         Address pc_after,
                                         Code* check_code,
@@ -220,6 +235,14 @@ void Deoptimizer::PatchStackCheckCodeAt(Code* unoptimized_code,
   //     test eax, <loop nesting depth>
   // ok: ...
   //
+  // or, in code with an interrupt budget:
+  //
+  //     add <profiling counter>, <-weight>
+  //     jns ok
+  //     call <interrupt stub>
+  //     test eax, <loop nesting depth>
+  // ok: ...
+  //
   // We will patch away the branch so the code is:
   //
   //     cmp esp, <limit>  ;; Not changed
@@ -228,8 +251,9 @@ void Deoptimizer::PatchStackCheckCodeAt(Code* unoptimized_code,
   //     call <on-stack replacment>
   //     test eax, <loop nesting depth>
   // ok:
-  ASSERT(*(call_target_address - 3) == 0x73 &&  // jae
-         *(call_target_address - 2) == 0x07 &&  // offset
+  ASSERT(*(call_target_address - 3) ==
+             StackCheckBranchInstruction(check_code) &&  // jae or jns
+         *(call_target_address - 2) == kJumpOffset &&  // offset
          *(call_target_address - 1) == 0xe8);   // call
   *(call_target_address - 3) = 0x90;  // nop
   *(call_target_address - 2) = 0x90;  // nop
@@ -253,8 +277,9 @@ void Deoptimizer::RevertStackCheckCodeAt(Code* unoptimized_code,
   ASSERT(*(call_target_address - 3) == 0x90 &&  // nop
          *(call_target_address - 2) == 0x90 &&  // nop
          *(call_target_address - 1) == 0xe8);   // call
-  *(call_target_address - 3) = 0x73;  // jae
-  *(call_target_address - 2) = 0x07;  // offset
+  // jae or jns
+  *(call_target_address - 3) = StackCheckBranchInstruction(check_code);
+  *(call_target_address - 2) = kJumpOffset;  // offset
   Assembler::set_target_address_at(call_target_address,
                                    check_code->entry());
 
@@ -445,7 +470,7 @@ void Deoptimizer::DoComputeFrame(TranslationIterator* iterator,
   USE(opcode);
   ASSERT(Translation::FRAME == opcode);
   int node_id = iterator->Next();
-  JSFunction* function = JSFunction::cast(ComputeLiteral(iterator->Next()));
+  JSFunction* function = ComputeFunction(frame_index, iterator->Next());
   unsigned height = iterator->Next();
   unsigned height_in_bytes = height * kPointerSize;
   if (FLAG_trace_deopt) {
@@ -535,14 +535,34 @@ void KeyedLoadIC::GenerateGeneric(MacroAssembler* masm) {
   __ mov(edi, FieldOperand(eax, String::kHashFieldOffset));
   __ shr(edi, String::kHashShift);
   __ xor_(ecx, edi);
-  __ and_(ecx, KeyedLookupCache::kCapacityMask);
-
-  // Load the key (consisting of map and symbol) from the cache and
-  // check for match.
+  ExternalReference cache_mask =
+      ExternalReference::keyed_lookup_cache_mask(masm->isolate());
+  __ and_(ecx, Operand::StaticVariable(cache_mask));
+
+  // Load the key (consisting of map and symbol) from each entry of the
+  // cache bucket and check for match.
+  Label load_in_object_property;
+  static const int kEntriesPerBucket = KeyedLookupCache::kEntriesPerBucket;
+  Label hit_on_nth_entry[kEntriesPerBucket];
   ExternalReference cache_keys =
       ExternalReference::keyed_lookup_cache_keys(masm->isolate());
+  for (int i = 0; i < kEntriesPerBucket - 1; i++) {
+    Label try_next_entry;
+    __ mov(edi, ecx);
+    __ shl(edi, kPointerSizeLog2 + 1);
+    if (i != 0) {
+      __ add(edi, Immediate(kPointerSize * i * 2));
+    }
+    __ cmp(ebx, Operand::StaticArray(edi, times_1, cache_keys));
+    __ j(not_equal, &try_next_entry);
+    __ add(edi, Immediate(kPointerSize));
+    __ cmp(eax, Operand::StaticArray(edi, times_1, cache_keys));
+    __ j(equal, &hit_on_nth_entry[i]);
+    __ bind(&try_next_entry);
+  }
   __ mov(edi, ecx);
   __ shl(edi, kPointerSizeLog2 + 1);
+  __ add(edi, Immediate(kPointerSize * (kEntriesPerBucket - 1) * 2));
   __ cmp(ebx, Operand::StaticArray(edi, times_1, cache_keys));
   __ j(not_equal, &slow);
   __ add(edi, Immediate(kPointerSize));
@@ -553,16 +573,26 @@ void KeyedLoadIC::GenerateGeneric(MacroAssembler* masm) {
   // edx     : receiver
   // ebx     : receiver's map
   // eax     : key
-  // ecx     : lookup cache index
+  // ecx     : lookup cache index of the first entry in the bucket
   ExternalReference cache_field_offsets =
       ExternalReference::keyed_lookup_cache_field_offsets(masm->isolate());
-  __ mov(edi,
-         Operand::StaticArray(ecx, times_pointer_size, cache_field_offsets));
-  __ movzx_b(ecx, FieldOperand(ebx, Map::kInObjectPropertiesOffset));
-  __ sub(edi, ecx);
-  __ j(above_equal, &property_array_property);
+  for (int i = kEntriesPerBucket - 1; i >= 0; i--) {
+    __ bind(&hit_on_nth_entry[i]);
+    if (i != 0) {
+      __ add(ecx, Immediate(i));
+    }
+    __ mov(edi,
+           Operand::StaticArray(ecx, times_pointer_size, cache_field_offsets));
+    __ movzx_b(ecx, FieldOperand(ebx, Map::kInObjectPropertiesOffset));
+    __ sub(edi, ecx);
+    __ j(above_equal, &property_array_property);
+    if (i != 0) {
+      __ jmp(&load_in_object_property);
+    }
+  }
 
   // Load in-object property.
+  __ bind(&load_in_object_property);
   __ movzx_b(ecx, FieldOperand(ebx, Map::kInstanceSizeOffset));
   __ add(ecx, edi);
   __ mov(eax, FieldOperand(edx, ecx, times_pointer_size, 0));
@@ -735,6 +765,7 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
   Label slow, fast_object_with_map_check, fast_object_without_map_check;
   Label fast_double_with_map_check, fast_double_without_map_check;
   Label check_if_double_array, array, extra;
+  Label transition_smi_elements, finish_object_store;
 
   // Check that the object isn't a smi.
   __ JumpIfSmi(edx, &slow);
@@ -833,9 +864,10 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
   __ bind(&non_smi_value);
   // Escape to slow case when writing non-smi into smi-only array.
   __ mov(edi, FieldOperand(edx, HeapObject::kMapOffset));
-  __ CheckFastObjectElements(edi, &slow, Label::kNear);
+  __ CheckFastObjectElements(edi, &transition_smi_elements);
 
   // Fast elements array, store the value to the elements backing store.
+  __ bind(&finish_object_store);
   __ mov(CodeGenerator::FixedArrayElementOperand(ebx, ecx), eax);
   // Update write barrier for the elements array address.
   __ mov(edx, eax);  // Preserve the value which is returned.
@@ -843,6 +875,30 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
       ebx, edx, ecx, kDontSaveFPRegs, EMIT_REMEMBERED_SET, OMIT_SMI_CHECK);
   __ ret(0);
 
+  __ bind(&transition_smi_elements);
+  // Arrays that still have the initial smi-only array map move to object
+  // elements in place.  Heap numbers need double elements, which are left
+  // to the runtime.
+  __ cmp(FieldOperand(eax, HeapObject::kMapOffset),
+         Immediate(masm->isolate()->factory()->heap_number_map()));
+  __ j(equal, &slow);
+  __ LoadGlobalFunction(Context::SMI_JS_ARRAY_MAP_INDEX, edi);
+  __ cmp(edi, FieldOperand(edx, HeapObject::kMapOffset));
+  __ j(not_equal, &slow);
+  __ LoadGlobalFunction(Context::OBJECT_JS_ARRAY_MAP_INDEX, edi);
+  __ mov(FieldOperand(edx, HeapObject::kMapOffset), edi);
+  // The elements array is the only register left to use as scratch.
+  __ push(ebx);
+  __ RecordWriteField(edx,
+                      HeapObject::kMapOffset,
+                      edi,
+                      ebx,
+                      kDontSaveFPRegs,
+                      EMIT_REMEMBERED_SET,
+                      OMIT_SMI_CHECK);
+  __ pop(ebx);
+  __ jmp(&finish_object_store);
+
   __ bind(&fast_double_with_map_check);
   // Check for fast double array case. If this fails, call through to the
   // runtime.
@@ -1254,6 +1310,19 @@ void LoadIC::GenerateNormal(MacroAssembler* masm) {
 
   GenerateStringDictionaryReceiverCheck(masm, eax, edx, ebx, &miss);
 
+  if (FLAG_fast_properties_read_threshold > 0) {
+    // Count the read and let the runtime give the receiver fast properties
+    // back when it has been read often enough without changing shape.
+    Label not_counted;
+    __ mov(ebx, FieldOperand(edx, StringDictionary::kReadCountOffset));
+    __ JumpIfNotSmi(ebx, &not_counted);
+    __ add(ebx, Immediate(Smi::FromInt(1)));
+    __ mov(FieldOperand(edx, StringDictionary::kReadCountOffset), ebx);
+    __ cmp(ebx, Immediate(Smi::FromInt(FLAG_fast_properties_read_threshold)));
+    __ j(greater_equal, &miss);
+    __ bind(&not_counted);
+  }
+
   // edx: elements
   // Search the dictionary placing the result in eax.
   GenerateDictionaryLoad(masm, &miss, edx, ecx, edi, ebx, eax);
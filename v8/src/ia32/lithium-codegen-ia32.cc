@@ -109,6 +109,7 @@ void LCodeGen::Abort(const char* format, ...) {
     va_end(arguments);
     PrintF("\n");
   }
+  info()->set_bailout_reason(format);
   status_ = ABORTED;
 }
 
@@ -390,16 +391,36 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
                                 Translation* translation) {
   if (environment == NULL) return;
 
-  // The translation includes one command per value in the environment.
-  int translation_size = environment->values()->length();
+  // The translation includes one command per frame value in the environment.
+  int translation_size = environment->translation_size();
   // The output frame height does not include the parameters.
   int height = translation_size - environment->parameter_count();
 
   WriteTranslation(environment->outer(), translation);
   int closure_id = DefineDeoptimizationLiteral(environment->closure());
+  if (environment->has_dynamic_closure()) {
+    closure_id = Translation::DynamicClosureId(closure_id);
+  }
   translation->BeginFrame(environment->ast_id(), closure_id, height);
+  // The fields of captured objects follow the frame values.
+  int field_index = translation_size;
   for (int i = 0; i < translation_size; ++i) {
     LOperand* value = environment->values()->at(i);
+    LCapturedObject* captured = environment->CapturedObjectAt(i);
+    if (captured != NULL) {
+      int boilerplate_id =
+          DefineDeoptimizationLiteral(captured->boilerplate());
+      translation->StoreCapturedObject(boilerplate_id,
+                                       captured->field_count());
+      for (int j = 0; j < captured->field_count(); ++j) {
+        AddToTranslation(translation,
+                         environment->values()->at(field_index),
+                         environment->HasTaggedValueAt(field_index),
+                         environment->HasUint32ValueAt(field_index));
+        field_index++;
+      }
+      continue;
+    }
     // spilled_registers_ and spilled_double_registers_ are either
     // both NULL or both set.
     if (environment->spilled_registers() != NULL && value != NULL) {
@@ -408,7 +429,8 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         translation->MarkDuplicate();
         AddToTranslation(translation,
                          environment->spilled_registers()[value->index()],
-                         environment->HasTaggedValueAt(i));
+                         environment->HasTaggedValueAt(i),
+                         environment->HasUint32ValueAt(i));
       } else if (
           value->IsDoubleRegister() &&
           environment->spilled_double_registers()[value->index()] != NULL) {
@@ -416,18 +438,23 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         AddToTranslation(
             translation,
             environment->spilled_double_registers()[value->index()],
+            false,
             false);
       }
     }
 
-    AddToTranslation(translation, value, environment->HasTaggedValueAt(i));
+    AddToTranslation(translation,
+                     value,
+                     environment->HasTaggedValueAt(i),
+                     environment->HasUint32ValueAt(i));
   }
 }
 
 
 void LCodeGen::AddToTranslation(Translation* translation,
                                 LOperand* op,
-                                bool is_tagged) {
+                                bool is_tagged,
+                                bool is_uint32) {
   if (op == NULL) {
     // TODO(twuerthinger): Introduce marker operands to indicate that this value
     // is not present and must be reconstructed from the deoptimizer. Currently
@@ -436,6 +463,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
   } else if (op->IsStackSlot()) {
     if (is_tagged) {
       translation->StoreStackSlot(op->index());
+    } else if (is_uint32) {
+      translation->StoreUint32StackSlot(op->index());
     } else {
       translation->StoreInt32StackSlot(op->index());
     }
@@ -449,6 +478,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
     Register reg = ToRegister(op);
     if (is_tagged) {
       translation->StoreRegister(reg);
+    } else if (is_uint32) {
+      translation->StoreUint32Register(reg);
     } else {
       translation->StoreInt32Register(reg);
     }
@@ -632,6 +663,15 @@ void LCodeGen::PopulateDeoptimizationData(Handle<Code> code) {
   }
   data->SetLiteralArray(*literals);
 
+  const ZoneList<Handle<JSGlobalPropertyCell> >* cells =
+      graph()->dependent_cells();
+  Handle<FixedArray> dependent_cells =
+      factory()->NewFixedArray(cells->length(), TENURED);
+  for (int i = 0; i < cells->length(); i++) {
+    dependent_cells->set(i, *cells->at(i));
+  }
+  data->SetDependentCells(*dependent_cells);
+
   data->SetOsrAstId(Smi::FromInt(info_->osr_ast_id()));
   data->SetOsrPcOffset(Smi::FromInt(osr_pc_offset_));
 
@@ -820,6 +860,68 @@ void LCodeGen::DoUnknownOSRValue(LUnknownOSRValue* instr) {
 }
 
 
+void LCodeGen::DoMathMinMax(LMathMinMax* instr) {
+  LOperand* left = instr->InputAt(0);
+  LOperand* right = instr->InputAt(1);
+  ASSERT(left->Equals(instr->result()));
+  HMathMinMax::Operation operation = instr->hydrogen()->operation();
+  if (instr->hydrogen()->representation().IsInteger32()) {
+    Label return_left;
+    Condition condition = (operation == HMathMinMax::kMathMin)
+        ? less_equal
+        : greater_equal;
+    if (right->IsConstantOperand()) {
+      Operand left_op = ToOperand(left);
+      Immediate right_imm = ToImmediate(right);
+      __ cmp(left_op, right_imm);
+      __ j(condition, &return_left, Label::kNear);
+      __ mov(left_op, right_imm);
+    } else {
+      Register left_reg = ToRegister(left);
+      Operand right_op = ToOperand(right);
+      __ cmp(left_reg, right_op);
+      __ j(condition, &return_left, Label::kNear);
+      __ mov(left_reg, right_op);
+    }
+    __ bind(&return_left);
+  } else {
+    ASSERT(instr->hydrogen()->representation().IsDouble());
+    Label check_nan_left, check_zero, return_left, return_right;
+    Condition condition = (operation == HMathMinMax::kMathMin) ? below : above;
+    XMMRegister left_reg = ToDoubleRegister(left);
+    XMMRegister right_reg = ToDoubleRegister(right);
+    __ ucomisd(left_reg, right_reg);
+    __ j(parity_even, &check_nan_left, Label::kNear);  // At least one NaN.
+    __ j(equal, &check_zero, Label::kNear);  // left == right.
+    __ j(condition, &return_left, Label::kNear);
+    __ jmp(&return_right, Label::kNear);
+
+    __ bind(&check_zero);
+    XMMRegister xmm_scratch = xmm0;
+    __ xorps(xmm_scratch, xmm_scratch);
+    __ ucomisd(left_reg, xmm_scratch);
+    __ j(not_equal, &return_left, Label::kNear);  // left == right != 0.
+    // At this point, both left and right are either 0 or -0.
+    if (operation == HMathMinMax::kMathMin) {
+      __ orpd(left_reg, right_reg);
+    } else {
+      // Since we operate on +0 and/or -0, addsd and andsd have the same
+      // effect.
+      __ addsd(left_reg, right_reg);
+    }
+    __ jmp(&return_left, Label::kNear);
+
+    __ bind(&check_nan_left);
+    __ ucomisd(left_reg, left_reg);  // NaN check.
+    __ j(parity_even, &return_left, Label::kNear);  // left == NaN.
+    __ bind(&return_right);
+    __ movsd(left_reg, right_reg);
+
+    __ bind(&return_left);
+  }
+}
+
+
 void LCodeGen::DoModI(LModI* instr) {
   if (instr->hydrogen()->HasPowerOf2Divisor()) {
     Register dividend = ToRegister(instr->InputAt(0));
@@ -972,9 +1074,11 @@ void LCodeGen::DoDivI(LDivI* instr) {
   __ cdq();
   __ idiv(right_reg);
 
-  // Deoptimize if remainder is not 0.
-  __ test(edx, Operand(edx));
-  DeoptimizeIf(not_zero, instr->environment());
+  // Deoptimize if remainder is not 0, unless the result is truncated.
+  if (!instr->hydrogen()->all_uses_truncating()) {
+    __ test(edx, Operand(edx));
+    DeoptimizeIf(not_zero, instr->environment());
+  }
 }
 
 
@@ -1274,6 +1378,44 @@ void LCodeGen::DoValueOf(LValueOf* instr) {
 }
 
 
+void LCodeGen::DoDateField(LDateField* instr) {
+  Register object = ToRegister(instr->InputAt(0));
+  Register result = ToRegister(instr->result());
+  Register scratch = ToRegister(instr->TempAt(0));
+  Smi* index = instr->index();
+  Label runtime, done;
+  ASSERT(object.is(result));
+  ASSERT(object.is(eax));
+
+#ifdef DEBUG
+  __ AbortIfSmi(object);
+  __ CmpObjectType(object, JS_DATE_TYPE, scratch);
+  __ Assert(equal, "Trying to get date field from non-date.");
+#endif
+
+  if (index->value() == 0) {
+    __ mov(result, FieldOperand(object, JSDate::kValueOffset));
+  } else {
+    if (index->value() < JSDate::kFirstUncachedField) {
+      ExternalReference stamp = ExternalReference::date_cache_stamp(isolate());
+      __ mov(scratch, Operand::StaticVariable(stamp));
+      __ cmp(scratch, FieldOperand(object, JSDate::kCacheStampOffset));
+      __ j(not_equal, &runtime, Label::kNear);
+      __ mov(result, FieldOperand(object, JSDate::kValueOffset +
+                                          kPointerSize * index->value()));
+      __ jmp(&done);
+    }
+    __ bind(&runtime);
+    __ PrepareCallCFunction(2, scratch);
+    __ mov(Operand(esp, 0), object);
+    __ mov(Operand(esp, 1 * kPointerSize), Immediate(index));
+    __ CallCFunction(ExternalReference::get_date_field_function(isolate()), 2);
+    __ mov(esi, Operand(ebp, StandardFrameConstants::kContextOffset));
+    __ bind(&done);
+  }
+}
+
+
 void LCodeGen::DoBitNotI(LBitNotI* instr) {
   LOperand* input = instr->InputAt(0);
   ASSERT(input->Equals(instr->result()));
@@ -1761,6 +1903,28 @@ void LCodeGen::DoStringCompareAndBranch(LStringCompareAndBranch* instr) {
   int true_block = chunk_->LookupDestination(instr->true_block_id());
   int false_block = chunk_->LookupDestination(instr->false_block_id());
 
+  if (op == Token::EQ || op == Token::EQ_STRICT) {
+    // Identical strings are equal.  Different symbols and strings of
+    // different lengths are not.
+    Register left = ToRegister(instr->InputAt(1));
+    Register right = ToRegister(instr->InputAt(2));
+    Label* true_label = chunk_->GetAssemblyLabel(true_block);
+    Label* false_label = chunk_->GetAssemblyLabel(false_block);
+    __ cmp(left, right);
+    __ j(equal, true_label);
+    __ mov(ebx, FieldOperand(left, HeapObject::kMapOffset));
+    __ mov(ecx, FieldOperand(right, HeapObject::kMapOffset));
+    __ movzx_b(ebx, FieldOperand(ebx, Map::kInstanceTypeOffset));
+    __ movzx_b(ecx, FieldOperand(ecx, Map::kInstanceTypeOffset));
+    STATIC_ASSERT(kSymbolTag != 0);
+    __ and_(ebx, ecx);
+    __ test(ebx, Immediate(kIsSymbolMask));
+    __ j(not_zero, false_label);
+    __ mov(ebx, FieldOperand(left, String::kLengthOffset));
+    __ cmp(ebx, FieldOperand(right, String::kLengthOffset));
+    __ j(not_equal, false_label);
+  }
+
   Handle<Code> ic = CompareIC::GetUninitialized(op);
   CallCode(ic, RelocInfo::CODE_TARGET, instr);
 
@@ -2197,6 +2361,18 @@ void LCodeGen::DoStoreContextSlot(LStoreContextSlot* instr) {
 
 void LCodeGen::DoLoadNamedField(LLoadNamedField* instr) {
   Register object = ToRegister(instr->object());
+  if (instr->hydrogen()->is_double_field()) {
+    Register box = ToRegister(instr->TempAt(0));
+    EmitLoadMutableHeapNumber(box,
+                              object,
+                              instr->hydrogen()->is_in_object(),
+                              instr->hydrogen()->offset(),
+                              instr->environment());
+    __ movdbl(ToDoubleRegister(instr->result()),
+              FieldOperand(box, HeapNumber::kValueOffset));
+    return;
+  }
+
   Register result = ToRegister(instr->result());
   if (instr->hydrogen()->is_in_object()) {
     __ mov(result, FieldOperand(object, instr->hydrogen()->offset()));
@@ -2207,6 +2383,25 @@ void LCodeGen::DoLoadNamedField(LLoadNamedField* instr) {
 }
 
 
+void LCodeGen::EmitLoadMutableHeapNumber(Register box,
+                                         Register object,
+                                         bool is_in_object,
+                                         int offset,
+                                         LEnvironment* env) {
+  if (is_in_object) {
+    __ mov(box, FieldOperand(object, offset));
+  } else {
+    __ mov(box, FieldOperand(object, JSObject::kPropertiesOffset));
+    __ mov(box, FieldOperand(box, offset));
+  }
+  __ test(box, Immediate(kSmiTagMask));
+  DeoptimizeIf(zero, env);
+  __ cmp(FieldOperand(box, HeapObject::kMapOffset),
+         Immediate(factory()->mutable_heap_number_map()));
+  DeoptimizeIf(not_equal, env);
+}
+
+
 void LCodeGen::EmitLoadFieldOrConstantFunction(Register result,
                                                Register object,
                                                Handle<Map> type,
@@ -2476,11 +2671,10 @@ void LCodeGen::DoLoadKeyedSpecializedArrayElement(
         break;
       case EXTERNAL_UNSIGNED_INT_ELEMENTS:
         __ mov(result, operand);
-        __ test(result, Operand(result));
-        // TODO(danno): we could be more clever here, perhaps having a special
-        // version of the stub that detects if the overflow case actually
-        // happens, and generate code that returns a double rather than int.
-        DeoptimizeIf(negative, instr->environment());
+        if (!instr->hydrogen_value()->IsUint32()) {
+          __ test(result, Operand(result));
+          DeoptimizeIf(negative, instr->environment());
+        }
         break;
       case EXTERNAL_FLOAT_ELEMENTS:
       case EXTERNAL_DOUBLE_ELEMENTS:
@@ -2507,6 +2701,14 @@ void LCodeGen::DoLoadKeyedGeneric(LLoadKeyedGeneric* instr) {
 
 
 void LCodeGen::DoArgumentsElements(LArgumentsElements* instr) {
+  if (instr->hydrogen()->from_inlined()) {
+    // The arguments of an inlined function were just pushed.  The result is
+    // biased like a frame pointer, for LAccessArgumentsAt.
+    Register result = ToRegister(instr->result());
+    __ lea(result, Operand(esp, -2 * kPointerSize));
+    return;
+  }
+
   Register result = ToRegister(instr->result());
 
   // Check for arguments adapter frame.
@@ -2647,6 +2849,11 @@ void LCodeGen::DoPushArgument(LPushArgument* instr) {
 }
 
 
+void LCodeGen::DoDrop(LDrop* instr) {
+  __ Drop(instr->count());
+}
+
+
 void LCodeGen::DoThisFunction(LThisFunction* instr) {
   Register result = ToRegister(instr->result());
   LoadHeapObject(result, instr->hydrogen()->closure());
@@ -2698,8 +2905,19 @@ void LCodeGen::CallKnownFunction(Handle<JSFunction> function,
 
   // Set eax to arguments count if adaption is not needed. Assumes that eax
   // is available to write to at this point.
+  int formal_count = function->shared()->formal_parameter_count();
   if (!function->NeedsArgumentsAdaption()) {
     __ mov(eax, arity);
+  } else if (arity != formal_count) {
+    // The target does not look at the actual argument count, so adapt the
+    // arguments here instead of going through the arguments adaptor.
+    ASSERT(!function->shared()->uses_arguments());
+    if (arity < formal_count) {
+      Handle<Object> undefined = factory()->undefined_value();
+      for (int i = arity; i < formal_count; i++) __ push(Immediate(undefined));
+    } else {
+      __ Drop(arity - formal_count);
+    }
   }
 
   LPointerMap* pointers = instr->pointer_map();
@@ -3182,9 +3400,22 @@ void LCodeGen::DoCallRuntime(LCallRuntime* instr) {
 
 void LCodeGen::DoStoreNamedField(LStoreNamedField* instr) {
   Register object = ToRegister(instr->object());
-  Register value = ToRegister(instr->value());
   int offset = instr->offset();
 
+  if (instr->hydrogen()->is_double_field()) {
+    // Update the field's mutable heap number in place.
+    Register box = ToRegister(instr->TempAt(0));
+    EmitLoadMutableHeapNumber(box,
+                              object,
+                              instr->is_in_object(),
+                              offset,
+                              instr->environment());
+    __ movdbl(FieldOperand(box, HeapNumber::kValueOffset),
+              ToDoubleRegister(instr->value()));
+    return;
+  }
+
+  Register value = ToRegister(instr->value());
   if (!instr->transition().is_null()) {
     __ mov(FieldOperand(object, HeapObject::kMapOffset), instr->transition());
   }
@@ -3357,6 +3588,109 @@ void LCodeGen::DoStoreKeyedFastDoubleElement(
 }
 
 
+void LCodeGen::EmitFastDoubleArrayOperand(Register operand,
+                                          bool is_array,
+                                          Register limit,
+                                          XMMRegister scalar,
+                                          Label* bailout) {
+  Register scratch = esi;
+  if (is_array) {
+    __ JumpIfSmi(operand, bailout);
+    __ CmpObjectType(operand, JS_ARRAY_TYPE, scratch);
+    __ j(not_equal, bailout);
+    __ movzx_b(scratch, FieldOperand(scratch, Map::kBitField2Offset));
+    __ and_(scratch, Map::kElementsKindMask);
+    __ cmp(scratch, FAST_DOUBLE_ELEMENTS << Map::kElementsKindShift);
+    __ j(not_equal, bailout);
+    Label in_bounds;
+    __ cmp(limit, FieldOperand(operand, JSArray::kLengthOffset));
+    __ j(less_equal, &in_bounds, Label::kNear);
+    __ mov(limit, FieldOperand(operand, JSArray::kLengthOffset));
+    __ bind(&in_bounds);
+    __ mov(operand, FieldOperand(operand, JSObject::kElementsOffset));
+  } else {
+    Label is_smi, loaded;
+    __ JumpIfSmi(operand, &is_smi, Label::kNear);
+    __ cmp(FieldOperand(operand, HeapObject::kMapOffset),
+           factory()->heap_number_map());
+    __ j(not_equal, bailout);
+    __ movdbl(scalar, FieldOperand(operand, HeapNumber::kValueOffset));
+    __ jmp(&loaded, Label::kNear);
+    __ bind(&is_smi);
+    __ mov(scratch, operand);
+    __ SmiUntag(scratch);
+    __ cvtsi2sd(scalar, Operand(scratch));
+    __ bind(&loaded);
+    __ unpcklpd(scalar, scalar);
+  }
+}
+
+
+void LCodeGen::DoFastDoubleArrayMap(LFastDoubleArrayMap* instr) {
+  HFastDoubleArrayMap* hinstr = instr->hydrogen();
+  Register target = ToRegister(instr->target());
+  Register left = ToRegister(instr->left());
+  Register right = ToRegister(instr->right());
+  Register index = ToRegister(instr->start());
+  Register limit = ToRegister(instr->limit());
+  ASSERT(index.is(ToRegister(instr->result())));
+  // The instruction is marked as a call, so every allocatable register is
+  // free to use here.
+  Register scratch = esi;
+  XMMRegister left_value = xmm1;
+  XMMRegister right_value = xmm2;
+  XMMRegister nan_mask = xmm3;
+  Label loop, done;
+
+  // Anything unexpected leaves all elements to the scalar loop.
+  __ test(index, Immediate(kSmiTagMask | kMinInt));
+  __ j(not_zero, &done);
+  __ JumpIfNotSmi(limit, &done);
+  EmitFastDoubleArrayOperand(target, true, limit, xmm0, &done);
+  EmitFastDoubleArrayOperand(
+      left, hinstr->left_is_array(), limit, left_value, &done);
+  EmitFastDoubleArrayOperand(
+      right, hinstr->right_is_array(), limit, right_value, &done);
+
+  // Each iteration handles the elements at index and index + 1.  The keys
+  // are smis, so times_4 scales them to double elements.
+  STATIC_ASSERT(kSmiTag == 0 && kSmiTagSize == 1);
+  __ sub(Operand(limit), Immediate(Smi::FromInt(1)));
+  __ bind(&loop);
+  __ cmp(index, Operand(limit));
+  __ j(greater_equal, &done);
+  if (hinstr->left_is_array()) {
+    __ movupd(xmm0, FieldOperand(left, index, times_4,
+                                 FixedDoubleArray::kHeaderSize));
+  } else {
+    __ movaps(xmm0, left_value);
+  }
+  if (hinstr->right_is_array()) {
+    __ movupd(right_value, FieldOperand(right, index, times_4,
+                                        FixedDoubleArray::kHeaderSize));
+  }
+  switch (hinstr->op()) {
+    case Token::ADD: __ addpd(xmm0, right_value); break;
+    case Token::SUB: __ subpd(xmm0, right_value); break;
+    case Token::MUL: __ mulpd(xmm0, right_value); break;
+    case Token::DIV: __ divpd(xmm0, right_value); break;
+    default: UNREACHABLE();
+  }
+  // NaN results, including those computed from holes, are left to the
+  // scalar loop.
+  __ movaps(nan_mask, xmm0);
+  __ cmpunordpd(nan_mask, nan_mask);
+  __ movmskpd(scratch, nan_mask);
+  __ test(scratch, Operand(scratch));
+  __ j(not_zero, &done);
+  __ movupd(FieldOperand(target, index, times_4,
+                         FixedDoubleArray::kHeaderSize), xmm0);
+  __ add(Operand(index), Immediate(Smi::FromInt(2)));
+  __ jmp(&loop);
+  __ bind(&done);
+}
+
+
 void LCodeGen::DoStoreKeyedGeneric(LStoreKeyedGeneric* instr) {
   ASSERT(ToRegister(instr->context()).is(esi));
   ASSERT(ToRegister(instr->object()).is(edx));
@@ -3516,6 +3850,13 @@ void LCodeGen::DoDeferredStringCharFromCode(LStringCharFromCode* instr) {
 }
 
 
+void LCodeGen::DoStringHashField(LStringHashField* instr) {
+  Register string = ToRegister(instr->string());
+  Register result = ToRegister(instr->result());
+  __ mov(result, FieldOperand(string, String::kHashFieldOffset));
+}
+
+
 void LCodeGen::DoStringLength(LStringLength* instr) {
   Register string = ToRegister(instr->string());
   Register result = ToRegister(instr->result());
@@ -3524,18 +3865,97 @@ void LCodeGen::DoStringLength(LStringLength* instr) {
 
 
 void LCodeGen::DoStringAdd(LStringAdd* instr) {
-  if (instr->left()->IsConstantOperand()) {
-    __ push(ToImmediate(instr->left()));
-  } else {
-    __ push(ToOperand(instr->left()));
-  }
-  if (instr->right()->IsConstantOperand()) {
-    __ push(ToImmediate(instr->right()));
-  } else {
-    __ push(ToOperand(instr->right()));
+  Register left = ToRegister(instr->left());
+  Register right = ToRegister(instr->right());
+  ASSERT(left.is(edx));
+  ASSERT(right.is(eax));
+  ASSERT(ToRegister(instr->result()).is(eax));
+
+  Label call_stub, done;
+  if (FLAG_inline_new) {
+    // Adding an empty string returns the other string.
+    Label both_not_empty;
+    __ mov(ecx, FieldOperand(left, String::kLengthOffset));
+    __ test(ecx, ecx);
+    __ j(zero, &done);
+    __ mov(ebx, FieldOperand(right, String::kLengthOffset));
+    __ test(ebx, ebx);
+    __ j(not_zero, &both_not_empty, Label::kNear);
+    __ mov(eax, left);
+    __ jmp(&done);
+    __ bind(&both_not_empty);
+
+    // Results shorter than a cons string are flat strings, which the stub
+    // builds.  Exceptionally long results are handled by the stub too.
+    STATIC_ASSERT(String::kMaxLength <= Smi::kMaxValue / 2);
+    __ add(ebx, ecx);
+    __ cmp(ebx, Immediate(Smi::FromInt(String::kMinNonFlatLength)));
+    __ j(below, &call_stub);
+    __ cmp(ebx, Immediate(Smi::FromInt(String::kMaxLength)));
+    __ j(above, &call_stub);
+
+    // The depth of the result is one more than that of its deeper part.
+    // Too deep results are rebalanced by the runtime system.
+    Label left_is_flat, right_is_flat;
+    __ Set(edi, Immediate(Smi::FromInt(0)));
+    __ mov(ecx, FieldOperand(left, HeapObject::kMapOffset));
+    __ movzx_b(ecx, FieldOperand(ecx, Map::kInstanceTypeOffset));
+    __ and_(ecx, kStringRepresentationMask);
+    __ cmp(ecx, kConsStringTag);
+    __ j(not_equal, &left_is_flat, Label::kNear);
+    __ mov(edi, FieldOperand(left, ConsString::kDepthOffset));
+    __ bind(&left_is_flat);
+    __ mov(ecx, FieldOperand(right, HeapObject::kMapOffset));
+    __ movzx_b(ecx, FieldOperand(ecx, Map::kInstanceTypeOffset));
+    __ and_(ecx, kStringRepresentationMask);
+    __ cmp(ecx, kConsStringTag);
+    __ j(not_equal, &right_is_flat, Label::kNear);
+    __ mov(ecx, FieldOperand(right, ConsString::kDepthOffset));
+    __ cmp(ecx, edi);
+    __ j(less_equal, &right_is_flat, Label::kNear);
+    __ mov(edi, ecx);
+    __ bind(&right_is_flat);
+    __ add(edi, Immediate(Smi::FromInt(1)));
+    __ cmp(edi, Immediate(Smi::FromInt(ConsString::kMaxDepth)));
+    __ j(greater, &call_stub);
+
+    // The result is an ASCII cons string if both strings are ASCII.  The
+    // length is recomputed below because ebx is needed as a scratch
+    // register for the allocation.
+    Label two_byte, allocated;
+    STATIC_ASSERT((kStringEncodingMask & kAsciiStringTag) != 0);
+    STATIC_ASSERT((kStringEncodingMask & kTwoByteStringTag) == 0);
+    __ mov(ecx, FieldOperand(left, HeapObject::kMapOffset));
+    __ test_b(FieldOperand(ecx, Map::kInstanceTypeOffset),
+              kStringEncodingMask);
+    __ j(zero, &two_byte, Label::kNear);
+    __ mov(ecx, FieldOperand(right, HeapObject::kMapOffset));
+    __ test_b(FieldOperand(ecx, Map::kInstanceTypeOffset),
+              kStringEncodingMask);
+    __ j(zero, &two_byte, Label::kNear);
+    __ AllocateAsciiConsString(ecx, ebx, no_reg, &call_stub);
+    __ jmp(&allocated, Label::kNear);
+    __ bind(&two_byte);
+    __ AllocateTwoByteConsString(ecx, ebx, no_reg, &call_stub);
+    __ bind(&allocated);
+    __ mov(ebx, FieldOperand(left, String::kLengthOffset));
+    __ add(ebx, FieldOperand(right, String::kLengthOffset));
+    __ mov(FieldOperand(ecx, ConsString::kLengthOffset), ebx);
+    __ mov(FieldOperand(ecx, ConsString::kHashFieldOffset),
+           Immediate(String::kEmptyHashField));
+    __ mov(FieldOperand(ecx, ConsString::kFirstOffset), left);
+    __ mov(FieldOperand(ecx, ConsString::kSecondOffset), right);
+    __ mov(FieldOperand(ecx, ConsString::kDepthOffset), edi);
+    __ mov(eax, ecx);
+    __ jmp(&done);
   }
+
+  __ bind(&call_stub);
+  __ push(left);
+  __ push(right);
   StringAddStub stub(NO_STRING_CHECK_IN_STUB);
   CallCode(stub.GetCode(), RelocInfo::CODE_TARGET, instr);
+  __ bind(&done);
 }
 
 
@@ -3548,6 +3968,13 @@ void LCodeGen::DoInteger32ToDouble(LInteger32ToDouble* instr) {
 }
 
 
+void LCodeGen::DoUint32ToDouble(LUint32ToDouble* instr) {
+  LOperand* input = instr->InputAt(0);
+  LOperand* output = instr->result();
+  __ LoadUint32(ToDoubleRegister(output), ToRegister(input), xmm0);
+}
+
+
 void LCodeGen::DoNumberTagI(LNumberTagI* instr) {
   class DeferredNumberTagI: public LDeferredCode {
    public:
@@ -3616,6 +4043,69 @@ void LCodeGen::DoDeferredNumberTagI(LNumberTagI* instr) {
 }
 
 
+void LCodeGen::DoNumberTagU(LNumberTagU* instr) {
+  class DeferredNumberTagU: public LDeferredCode {
+   public:
+    DeferredNumberTagU(LCodeGen* codegen, LNumberTagU* instr)
+        : LDeferredCode(codegen), instr_(instr) { }
+    virtual void Generate() { codegen()->DoDeferredNumberTagU(instr_); }
+    virtual LInstruction* instr() { return instr_; }
+   private:
+    LNumberTagU* instr_;
+  };
+
+  LOperand* input = instr->InputAt(0);
+  ASSERT(input->IsRegister() && input->Equals(instr->result()));
+  Register reg = ToRegister(input);
+
+  DeferredNumberTagU* deferred = new DeferredNumberTagU(this, instr);
+  __ cmp(reg, Immediate(Smi::kMaxValue));
+  __ j(above, deferred->entry());
+  __ SmiTag(reg);
+  __ bind(deferred->exit());
+}
+
+
+void LCodeGen::DoDeferredNumberTagU(LNumberTagU* instr) {
+  Label slow;
+  Register reg = ToRegister(instr->InputAt(0));
+  Register tmp = reg.is(eax) ? ecx : eax;
+
+  // Preserve the value of all registers.
+  PushSafepointRegistersScope scope(this);
+
+  // The value does not fit in a smi. Try to allocate a heap number in new
+  // space and store the value in there. If that fails, call the runtime
+  // system.
+  Label done;
+  __ LoadUint32(xmm0, reg, ToDoubleRegister(instr->TempAt(0)));
+  if (FLAG_inline_new) {
+    __ AllocateHeapNumber(reg, tmp, no_reg, &slow);
+    __ jmp(&done, Label::kNear);
+  }
+
+  // Slow case: Call the runtime system to do the number allocation.
+  __ bind(&slow);
+
+  // Put a valid pointer value in the stack slot where the result register
+  // is stored, as this register is in the pointer map, but contains an
+  // integer value.
+  __ StoreToSafepointRegisterSlot(reg, Immediate(0));
+  // See DoDeferredNumberTagI for why the context is taken from the frame.
+  __ mov(esi, Operand(ebp, StandardFrameConstants::kContextOffset));
+  __ CallRuntimeSaveDoubles(Runtime::kAllocateHeapNumber);
+  RecordSafepointWithRegisters(
+      instr->pointer_map(), 0, Safepoint::kNoLazyDeopt);
+  if (!reg.is(eax)) __ mov(reg, eax);
+
+  // Done. Put the value in xmm0 into the value of the allocated heap
+  // number.
+  __ bind(&done);
+  __ movdbl(FieldOperand(reg, HeapNumber::kValueOffset), xmm0);
+  __ StoreToSafepointRegisterSlot(reg, reg);
+}
+
+
 void LCodeGen::DoNumberTagD(LNumberTagD* instr) {
   class DeferredNumberTagD: public LDeferredCode {
    public:
@@ -4192,8 +4682,6 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 
   // Copy object header.
   ASSERT(object->properties()->length() == 0);
-  ASSERT(object->elements()->length() == 0 ||
-         object->elements()->map() == isolate()->heap()->fixed_cow_array_map());
   int inobject_properties = object->map()->inobject_properties();
   int header_size = size - inobject_properties * kPointerSize;
   for (int i = 0; i < header_size; i += kPointerSize) {
@@ -4201,6 +4689,24 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
     __ mov(FieldOperand(result, current_offset + i), ecx);
   }
 
+  // Copy the elements of a small array literal to right after it.
+  Handle<FixedArrayBase> elements(object->elements());
+  if (elements->length() > 0 &&
+      elements->map() != isolate()->heap()->fixed_cow_array_map()) {
+    ASSERT(object->IsJSArray() && inobject_properties == 0);
+    int elements_offset = *offset;
+    int elements_size = elements->Size();
+    *offset += elements_size;
+    __ lea(ecx, Operand(result, elements_offset));
+    __ mov(FieldOperand(result, current_offset + JSObject::kElementsOffset),
+           ecx);
+    __ mov(source, FieldOperand(source, JSObject::kElementsOffset));
+    for (int i = 0; i < elements_size; i += kPointerSize) {
+      __ mov(ecx, FieldOperand(source, i));
+      __ mov(FieldOperand(result, elements_offset + i), ecx);
+    }
+  }
+
   // Copy in-object properties.
   for (int i = 0; i < inobject_properties; i++) {
     int total_offset = current_offset + object->GetInObjectPropertyOffset(i);
@@ -4221,9 +4727,60 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 }
 
 
+void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
+  ASSERT(ToRegister(instr->context()).is(esi));
+  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
+  Handle<Map> initial_map = instr->hydrogen()->initial_map();
+  int instance_size = initial_map->instance_size();
+
+  // Deoptimize if the constructor got a new initial map since, for
+  // example because its prototype was replaced.
+  LoadHeapObject(ecx, constructor);
+  __ cmp(FieldOperand(ecx, JSFunction::kPrototypeOrInitialMapOffset),
+         Immediate(initial_map));
+  DeoptimizeIf(not_equal, instr->environment());
+
+  // The object is always allocated in new space, so the stores that
+  // initialize its properties need no write barrier.
+  Label allocated, runtime_allocate;
+  __ AllocateInNewSpace(instance_size, eax, ecx, edx, &runtime_allocate,
+                        TAG_OBJECT);
+  __ jmp(&allocated);
+
+  __ bind(&runtime_allocate);
+  __ push(Immediate(Smi::FromInt(instance_size)));
+  CallRuntime(Runtime::kAllocateInNewSpace, 1, instr);
+
+  __ bind(&allocated);
+  __ mov(FieldOperand(eax, JSObject::kMapOffset), Immediate(initial_map));
+  __ mov(ecx, Immediate(factory()->empty_fixed_array()));
+  __ mov(FieldOperand(eax, JSObject::kPropertiesOffset), ecx);
+  __ mov(FieldOperand(eax, JSObject::kElementsOffset), ecx);
+  // The in-object properties follow the header.
+  ASSERT(initial_map->instance_size() ==
+         JSObject::kHeaderSize +
+         initial_map->inobject_properties() * kPointerSize);
+  __ mov(ecx, Immediate(factory()->undefined_value()));
+  for (int offset = JSObject::kHeaderSize;
+       offset < instance_size;
+       offset += kPointerSize) {
+    __ mov(FieldOperand(eax, offset), ecx);
+  }
+}
+
+
 void LCodeGen::DoObjectLiteralFast(LObjectLiteralFast* instr) {
   ASSERT(ToRegister(instr->context()).is(esi));
   int size = instr->hydrogen()->total_size();
+  Handle<JSObject> boilerplate = instr->hydrogen()->boilerplate();
+
+  // Deoptimize if the elements kind of the boilerplate changed since.
+  if (instr->hydrogen()->copies_elements()) {
+    LoadHeapObject(ebx, boilerplate);
+    __ cmp(FieldOperand(ebx, HeapObject::kMapOffset),
+           Handle<Map>(boilerplate->map()));
+    DeoptimizeIf(not_equal, instr->environment());
+  }
 
   // Allocate all objects that are part of the literal in one big
   // allocation. This avoids multiple limit checks.
@@ -4237,8 +4794,8 @@ void LCodeGen::DoObjectLiteralFast(LObjectLiteralFast* instr) {
 
   __ bind(&allocated);
   int offset = 0;
-  LoadHeapObject(ebx, instr->hydrogen()->boilerplate());
-  EmitDeepCopy(instr->hydrogen()->boilerplate(), eax, ebx, &offset);
+  LoadHeapObject(ebx, boilerplate);
+  EmitDeepCopy(boilerplate, eax, ebx, &offset);
   ASSERT_EQ(size, offset);
 }
 
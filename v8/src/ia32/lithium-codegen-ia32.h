@@ -96,6 +96,7 @@ class LCodeGen BASE_EMBEDDED {
   // Deferred code support.
   void DoDeferredNumberTagD(LNumberTagD* instr);
   void DoDeferredNumberTagI(LNumberTagI* instr);
+  void DoDeferredNumberTagU(LNumberTagU* instr);
   void DoDeferredTaggedToI(LTaggedToI* instr);
   void DoDeferredMathAbsTaggedHeapNumber(LUnaryMathOperation* instr);
   void DoDeferredStackCheck(LStackCheck* instr);
@@ -218,7 +219,8 @@ class LCodeGen BASE_EMBEDDED {
 
   void AddToTranslation(Translation* translation,
                         LOperand* op,
-                        bool is_tagged);
+                        bool is_tagged,
+                        bool is_uint32);
   void PopulateDeoptimizationData(Handle<Code> code);
   int DefineDeoptimizationLiteral(Handle<Object> literal);
 
@@ -297,6 +299,23 @@ class LCodeGen BASE_EMBEDDED {
                                        Handle<Map> type,
                                        Handle<String> name);
 
+  // Loads the mutable heap number of a double field.  Deoptimizes if the
+  // field was generalized and holds another value.
+  void EmitLoadMutableHeapNumber(Register box,
+                                 Register object,
+                                 bool is_in_object,
+                                 int offset,
+                                 LEnvironment* env);
+
+  // Checks an operand of HFastDoubleArrayMap.  Arrays are replaced by
+  // their double elements and clamp limit to their length, numbers are
+  // loaded into both halves of scalar.
+  void EmitFastDoubleArrayOperand(Register operand,
+                                  bool is_array,
+                                  Register limit,
+                                  XMMRegister scalar,
+                                  Label* bailout);
+
   // Emits optimized code to deep-copy the contents of statically known
   // object graphs (e.g. object literal boilerplate).
   void EmitDeepCopy(Handle<JSObject> object,
@@ -453,6 +453,19 @@ void LStoreKeyedFastDoubleElement::PrintDataTo(StringStream* stream) {
 }
 
 
+void LFastDoubleArrayMap::PrintDataTo(StringStream* stream) {
+  target()->PrintTo(stream);
+  stream->Add("[");
+  start()->PrintTo(stream);
+  stream->Add("..");
+  limit()->PrintTo(stream);
+  stream->Add("] <- ");
+  left()->PrintTo(stream);
+  stream->Add(" %s ", Token::String(hydrogen()->op()));
+  right()->PrintTo(stream);
+}
+
+
 void LStoreKeyedGeneric::PrintDataTo(StringStream* stream) {
   object()->PrintTo(stream);
   stream->Add("[");
@@ -570,6 +583,7 @@ void LChunkBuilder::Abort(const char* format, ...) {
     va_end(arguments);
     PrintF("\n");
   }
+  info()->set_bailout_reason(format);
   status_ = ABORTED;
 }
 
@@ -865,8 +879,9 @@ LInstruction* LChunkBuilder::DoShift(Token::Value op,
   }
 
   // Shift operations can only deoptimize if we do a logical shift by 0 and
-  // the result cannot be truncated to int32.
-  bool may_deopt = (op == Token::SHR && constant_value == 0);
+  // the result cannot be truncated to int32 or read as uint32.
+  bool may_deopt =
+      op == Token::SHR && constant_value == 0 && !instr->IsUint32();
   bool does_deopt = false;
   if (may_deopt) {
     for (HUseIterator it(instr->uses()); !it.Done(); it.Advance()) {
@@ -1016,19 +1031,59 @@ LEnvironment* LChunkBuilder::CreateEnvironment(
                                argument_count_,
                                value_count,
                                outer);
+  if (hydrogen_env->has_dynamic_closure()) result->set_has_dynamic_closure();
+  // The arguments pushed for an inlined function come after the outgoing
+  // arguments of the outer frames.
+  HEnterInlined* entry = hydrogen_env->entry();
+  if (entry != NULL && entry->arguments_pushed()) {
+    *argument_index_accumulator += entry->arguments_count();
+  }
   for (int i = 0; i < value_count; ++i) {
     if (hydrogen_env->is_special_index(i)) continue;
 
     HValue* value = hydrogen_env->values()->at(i);
     LOperand* op = NULL;
     if (value->IsArgumentsObject()) {
+      HArgumentsObject* arguments = HArgumentsObject::cast(value);
+      if (arguments->is_inlined()) {
+        result->AddCapturedObject(arguments->closure(),
+                                  arguments->arguments_count());
+        continue;
+      }
       op = NULL;
+    } else if (value->IsCapturedObject()) {
+      HCapturedObject* object = HCapturedObject::cast(value);
+      result->AddCapturedObject(object->boilerplate(), object->field_count());
+      continue;
     } else if (value->IsPushArgument()) {
       op = new(zone()) LArgument((*argument_index_accumulator)++);
     } else {
       op = UseAny(value);
     }
-    result->AddValue(op, value->representation());
+    result->AddValue(op, value->representation(), value->IsUint32());
+  }
+
+  // The fields of captured objects follow the frame values.
+  for (int i = 0; i < value_count; ++i) {
+    if (hydrogen_env->is_special_index(i)) continue;
+
+    HValue* value = hydrogen_env->values()->at(i);
+    if (value->IsArgumentsObject()) {
+      HArgumentsObject* arguments = HArgumentsObject::cast(value);
+      if (!arguments->is_inlined()) continue;
+      for (int j = 0; j < arguments->arguments_count(); ++j) {
+        HValue* argument = arguments->argument(j);
+        result->AddCapturedField(UseAny(argument),
+                                 argument->representation());
+      }
+      continue;
+    }
+    if (!value->IsCapturedObject()) continue;
+    HCapturedObject* object = HCapturedObject::cast(value);
+    for (int j = 0; j < object->field_count(); ++j) {
+      HValue* field = object->current_value(j);
+      result->AddCapturedField(UseAny(field), field->representation());
+    }
   }
 
   return result;
@@ -1327,6 +1382,26 @@ LInstruction* LChunkBuilder::DoDiv(HDiv* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoMathMinMax(HMathMinMax* instr) {
+  LOperand* left = NULL;
+  LOperand* right = NULL;
+  if (instr->representation().IsInteger32()) {
+    ASSERT(instr->left()->representation().IsInteger32());
+    ASSERT(instr->right()->representation().IsInteger32());
+    left = UseRegisterAtStart(instr->LeastConstantOperand());
+    right = UseOrConstantAtStart(instr->MostConstantOperand());
+  } else {
+    ASSERT(instr->representation().IsDouble());
+    ASSERT(instr->left()->representation().IsDouble());
+    ASSERT(instr->right()->representation().IsDouble());
+    left = UseRegisterAtStart(instr->left());
+    right = UseRegisterAtStart(instr->right());
+  }
+  LMathMinMax* minmax = new(zone()) LMathMinMax(left, right);
+  return DefineSameAsFirst(minmax);
+}
+
+
 LInstruction* LChunkBuilder::DoMod(HMod* instr) {
   if (instr->representation().IsInteger32()) {
     ASSERT(instr->left()->representation().IsInteger32());
@@ -1611,6 +1686,14 @@ LInstruction* LChunkBuilder::DoValueOf(HValueOf* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoDateField(HDateField* instr) {
+  LOperand* date = UseFixed(instr->value(), eax);
+  LDateField* result =
+      new(zone()) LDateField(date, FixedTemp(ecx), instr->index());
+  return MarkAsCall(DefineFixed(result, eax), instr);
+}
+
+
 LInstruction* LChunkBuilder::DoBoundsCheck(HBoundsCheck* instr) {
   return AssignEnvironment(new(zone()) LBoundsCheck(
       UseRegisterOrConstantAtStart(instr->index()),
@@ -1692,7 +1775,11 @@ LInstruction* LChunkBuilder::DoChange(HChange* instr) {
     if (to.IsTagged()) {
       HValue* val = instr->value();
       LOperand* value = UseRegister(val);
-      if (val->HasRange() && val->range()->IsInSmiRange()) {
+      if (val->IsUint32()) {
+        LOperand* temp = FixedTemp(xmm1);
+        LNumberTagU* result = new(zone()) LNumberTagU(value, temp);
+        return AssignEnvironment(AssignPointerMap(DefineSameAsFirst(result)));
+      } else if (val->HasRange() && val->range()->IsInSmiRange()) {
         return DefineSameAsFirst(new(zone()) LSmiTag(value));
       } else {
         LNumberTagI* result = new(zone()) LNumberTagI(value);
@@ -1700,6 +1787,10 @@ LInstruction* LChunkBuilder::DoChange(HChange* instr) {
       }
     } else {
       ASSERT(to.IsDouble());
+      if (instr->value()->IsUint32()) {
+        LOperand* value = UseRegister(instr->value());
+        return DefineAsRegister(new(zone()) LUint32ToDouble(value));
+      }
       return DefineAsRegister(
           new(zone()) LInteger32ToDouble(Use(instr->value())));
     }
@@ -1870,6 +1961,13 @@ LInstruction* LChunkBuilder::DoLoadContextSlot(HLoadContextSlot* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoStoreCapturedField(
+    HStoreCapturedField* instr) {
+  instr->object()->set_current_value(instr->index(), instr->value());
+  return NULL;
+}
+
+
 LInstruction* LChunkBuilder::DoStoreContextSlot(HStoreContextSlot* instr) {
   LOperand* value;
   LOperand* temp;
@@ -1886,9 +1984,14 @@ LInstruction* LChunkBuilder::DoStoreContextSlot(HStoreContextSlot* instr) {
 
 
 LInstruction* LChunkBuilder::DoLoadNamedField(HLoadNamedField* instr) {
-  ASSERT(instr->representation().IsTagged());
   LOperand* obj = UseRegisterAtStart(instr->object());
-  return DefineAsRegister(new(zone()) LLoadNamedField(obj));
+  if (instr->is_double_field()) {
+    ASSERT(instr->representation().IsDouble());
+    LLoadNamedField* result = new(zone()) LLoadNamedField(obj, TempRegister());
+    return AssignEnvironment(DefineAsRegister(result));
+  }
+  ASSERT(instr->representation().IsTagged());
+  return DefineAsRegister(new(zone()) LLoadNamedField(obj, NULL));
 }
 
 
@@ -1980,9 +2083,10 @@ LInstruction* LChunkBuilder::DoLoadKeyedSpecializedArrayElement(
       new(zone()) LLoadKeyedSpecializedArrayElement(external_pointer,
                                             key);
   LInstruction* load_instr = DefineAsRegister(result);
-  // An unsigned int array load might overflow and cause a deopt, make sure it
-  // has an environment.
-  return (elements_kind == EXTERNAL_UNSIGNED_INT_ELEMENTS)
+  // An unsigned int array load might overflow and cause a deopt, unless its
+  // result is read as uint32.  Make sure it has an environment.
+  return (elements_kind == EXTERNAL_UNSIGNED_INT_ELEMENTS &&
+          !instr->IsUint32())
       ? AssignEnvironment(load_instr)
       : load_instr;
 }
@@ -2032,6 +2136,19 @@ LInstruction* LChunkBuilder::DoStoreKeyedFastDoubleElement(
 }
 
 
+LInstruction* LChunkBuilder::DoFastDoubleArrayMap(
+    HFastDoubleArrayMap* instr) {
+  LOperand* target = UseFixed(instr->target(), ecx);
+  LOperand* left = UseFixed(instr->left(), edx);
+  LOperand* right = UseFixed(instr->right(), edi);
+  LOperand* start = UseFixed(instr->start(), eax);
+  LOperand* limit = UseFixed(instr->limit(), ebx);
+  LFastDoubleArrayMap* result =
+      new(zone()) LFastDoubleArrayMap(target, left, right, start, limit);
+  return MarkAsCall(DefineFixed(result, eax), instr);
+}
+
+
 LInstruction* LChunkBuilder::DoStoreKeyedSpecializedArrayElement(
     HStoreKeyedSpecializedArrayElement* instr) {
   Representation representation(instr->value()->representation());
@@ -2104,6 +2221,13 @@ LInstruction* LChunkBuilder::DoTransitionElementsKind(
 
 
 LInstruction* LChunkBuilder::DoStoreNamedField(HStoreNamedField* instr) {
+  if (instr->is_double_field()) {
+    LOperand* obj = UseRegisterAtStart(instr->object());
+    LOperand* val = UseRegisterAtStart(instr->value());
+    return AssignEnvironment(
+        new(zone()) LStoreNamedField(obj, val, TempRegister()));
+  }
+
   bool needs_write_barrier = instr->NeedsWriteBarrier();
 
   LOperand* obj;
@@ -2142,8 +2266,8 @@ LInstruction* LChunkBuilder::DoStoreNamedGeneric(HStoreNamedGeneric* instr) {
 
 LInstruction* LChunkBuilder::DoStringAdd(HStringAdd* instr) {
   LOperand* context = UseFixed(instr->context(), esi);
-  LOperand* left = UseOrConstantAtStart(instr->left());
-  LOperand* right = UseOrConstantAtStart(instr->right());
+  LOperand* left = UseFixed(instr->left(), edx);
+  LOperand* right = UseFixed(instr->right(), eax);
   LStringAdd* string_add = new(zone()) LStringAdd(context, left, right);
   return MarkAsCall(DefineFixed(string_add, eax), instr);
 }
@@ -2168,6 +2292,12 @@ LInstruction* LChunkBuilder::DoStringCharFromCode(HStringCharFromCode* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoStringHashField(HStringHashField* instr) {
+  LOperand* string = UseRegisterAtStart(instr->value());
+  return DefineAsRegister(new(zone()) LStringHashField(string));
+}
+
+
 LInstruction* LChunkBuilder::DoStringLength(HStringLength* instr) {
   LOperand* string = UseRegisterAtStart(instr->value());
   return DefineAsRegister(new(zone()) LStringLength(string));
@@ -2181,6 +2311,13 @@ LInstruction* LChunkBuilder::DoArrayLiteral(HArrayLiteral* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoAllocateObject(HAllocateObject* instr) {
+  LOperand* context = UseFixed(instr->context(), esi);
+  return MarkAsCall(
+      DefineFixed(new(zone()) LAllocateObject(context), eax), instr);
+}
+
+
 LInstruction* LChunkBuilder::DoObjectLiteralFast(HObjectLiteralFast* instr) {
   LOperand* context = UseFixed(instr->context(), esi);
   return MarkAsCall(
@@ -2259,6 +2396,14 @@ LInstruction* LChunkBuilder::DoArgumentsObject(HArgumentsObject* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoCapturedObject(HCapturedObject* instr) {
+  // The object only exists in deoptimization environments, which use the
+  // current values of its fields.
+  instr->ResetCurrentValues();
+  return NULL;
+}
+
+
 LInstruction* LChunkBuilder::DoAccessArgumentsAt(HAccessArgumentsAt* instr) {
   LOperand* arguments = UseRegister(instr->arguments());
   LOperand* length = UseTempRegister(instr->length());
@@ -2344,9 +2489,12 @@ LInstruction* LChunkBuilder::DoEnterInlined(HEnterInlined* instr) {
   HEnvironment* outer = current_block_->last_environment();
   HConstant* undefined = graph()->GetConstantUndefined();
   HEnvironment* inner = outer->CopyForInlining(instr->closure(),
+                                               instr->arguments_count(),
                                                instr->function(),
                                                undefined,
-                                               instr->call_kind());
+                                               instr->call_kind(),
+                                               instr->dynamic_closure());
+  inner->set_entry(instr);
   current_block_->UpdateEnvironment(inner);
   chunk_->AddInlinedClosure(instr->closure());
   return NULL;
@@ -2354,9 +2502,16 @@ LInstruction* LChunkBuilder::DoEnterInlined(HEnterInlined* instr) {
 
 
 LInstruction* LChunkBuilder::DoLeaveInlined(HLeaveInlined* instr) {
-  HEnvironment* outer = current_block_->last_environment()->outer();
+  LInstruction* pop = NULL;
+  HEnvironment* env = current_block_->last_environment();
+  if (env->entry()->arguments_pushed()) {
+    int argument_count = env->entry()->arguments_count();
+    pop = new(zone()) LDrop(argument_count);
+    argument_count_ -= argument_count;
+  }
+  HEnvironment* outer = env->outer();
   current_block_->UpdateEnvironment(outer);
-  return NULL;
+  return pop;
 }
 
 
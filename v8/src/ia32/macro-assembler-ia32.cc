@@ -79,7 +79,7 @@ void MacroAssembler::InNewSpace(
 
 
 void MacroAssembler::RememberedSetHelper(
-    Register object,  // Only used for debug checks.
+    Register object,
     Register addr,
     Register scratch,
     SaveFPRegsMode save_fp,
@@ -91,6 +91,28 @@ void MacroAssembler::RememberedSetHelper(
     int3();
     bind(&ok);
   }
+  Label use_store_buffer;
+  ASSERT(!scratch.is(object));
+  CheckPageFlag(object,
+                scratch,
+                1 << MemoryChunk::USES_CARD_TABLE,
+                zero,
+                &use_store_buffer,
+                Label::kNear);
+  // Dirty the card of the slot.  CheckPageFlag left the chunk of the holder
+  // in scratch, which is also the chunk of the slot for large objects.
+  sub(addr, scratch);
+  shr(addr, MemoryChunk::kCardSizeLog2);
+  mov(scratch, Operand(scratch, MemoryChunk::kCardTableOffset));
+  mov_b(Operand(scratch, addr, times_1, 0),
+        static_cast<int8_t>(MemoryChunk::kDirtyCard));
+  if (and_then == kReturnAtEnd) {
+    ret(0);
+  } else {
+    ASSERT(and_then == kFallThroughAtEnd);
+    jmp(&done);
+  }
+  bind(&use_store_buffer);
   // Load store buffer top.
   ExternalReference store_buffer =
       ExternalReference::store_buffer_top(isolate());
@@ -2353,6 +2375,21 @@ void MacroAssembler::LoadPowerOf2(XMMRegister dst,
 }
 
 
+void MacroAssembler::LoadUint32(XMMRegister dst,
+                                Register src,
+                                XMMRegister scratch) {
+  ASSERT(!dst.is(scratch));
+  Label done;
+  cmp(src, Immediate(0));
+  movdbl(scratch,
+         Operand::StaticVariable(ExternalReference::address_of_uint32_bias()));
+  cvtsi2sd(dst, Operand(src));
+  j(not_sign, &done, Label::kNear);
+  addsd(dst, scratch);
+  bind(&done);
+}
+
+
 void MacroAssembler::JumpIfInstanceTypeIsNotSequentialAscii(
     Register instance_type,
     Register scratch,
@@ -76,8 +76,9 @@ class MacroAssembler: public Assembler {
 
   // Record in the remembered set the fact that we have a pointer to new space
   // at the address pointed to by the addr register.  Only works if addr is not
-  // in new space.
-  void RememberedSetHelper(Register object,  // Used for debug code.
+  // in new space.  If the page of the object holding the slot uses a card
+  // table the card of the slot is dirtied instead, which clobbers addr.
+  void RememberedSetHelper(Register object,  // Holder of the slot.
                            Register addr,
                            Register scratch,
                            SaveFPRegsMode save_fp,
@@ -436,6 +437,9 @@ class MacroAssembler: public Assembler {
 
   void LoadPowerOf2(XMMRegister dst, Register scratch, int power);
 
+  // Convert the unsigned 32-bit integer in src to a double in dst.
+  void LoadUint32(XMMRegister dst, Register src, XMMRegister scratch);
+
   // Abort execution if argument is not a number. Used in debug code.
   void AbortIfNotNumber(Register object);
 
@@ -150,6 +150,7 @@ void RegExpMacroAssemblerIA32::AdvanceRegister(int reg, int by) {
 
 void RegExpMacroAssemblerIA32::Backtrack() {
   CheckPreemption();
+  CheckBacktrackLimit();
   // Pop Code* offset from backtrack stack, add Code* and jump to location.
   Pop(ebx);
   __ add(ebx, Immediate(masm_->CodeObject()));
@@ -872,6 +873,12 @@ Handle<HeapObject> RegExpMacroAssemblerIA32::GetCode(Handle<String> source) {
     SafeReturn();
   }
 
+  if (backtrack_limit_label_.is_linked()) {
+    // Reached if the backtrack budget has been used up.
+    __ bind(&backtrack_limit_label_);
+    __ jmp(&exit_with_exception);
+  }
+
   if (exit_with_exception.is_linked()) {
     // If any of the code above needed to exit with an exception.
     __ bind(&exit_with_exception);
@@ -1243,6 +1250,15 @@ void RegExpMacroAssemblerIA32::CheckPreemption() {
 }
 
 
+void RegExpMacroAssemblerIA32::CheckBacktrackLimit() {
+  if (FLAG_regexp_backtrack_limit <= 0) return;
+  ExternalReference backtracks_left =
+      ExternalReference::address_of_regexp_backtracks_left(masm_->isolate());
+  __ sub(Operand::StaticVariable(backtracks_left), Immediate(1));
+  __ j(zero, &backtrack_limit_label_);
+}
+
+
 void RegExpMacroAssemblerIA32::CheckStackLimit() {
   Label no_stack_overflow;
   ExternalReference stack_limit =
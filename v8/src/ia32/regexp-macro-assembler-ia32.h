@@ -150,6 +150,9 @@ class RegExpMacroAssemblerIA32: public NativeRegExpMacroAssembler {
   // Check whether preemption has been requested.
   void CheckPreemption();
 
+  // Count a backtrack against the budget set by --regexp-backtrack-limit.
+  void CheckBacktrackLimit();
+
   // Check whether we are exceeding the stack limit on the backtrack stack.
   void CheckStackLimit();
 
@@ -211,6 +214,7 @@ class RegExpMacroAssemblerIA32: public NativeRegExpMacroAssembler {
   Label exit_label_;
   Label check_preempt_label_;
   Label stack_overflow_label_;
+  Label backtrack_limit_label_;
 };
 #endif  // V8_INTERPRETED_REGEXP
 
@@ -160,6 +160,10 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
                               Register scratch,
                               Register extra,
                               Register extra2) {
+  Isolate* isolate = masm->isolate();
+  Counters* counters = isolate->counters();
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
   Label miss;
 
   // Assert that code is valid.  The shifting code relies on the entry size
@@ -180,6 +184,8 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   ASSERT(!scratch.is(no_reg));
   ASSERT(extra2.is(no_reg));
 
+  __ IncrementCounter(counters->stub_cache_probes(), 1);
+
   // Check that the receiver isn't a smi.
   __ JumpIfSmi(receiver, &miss);
 
@@ -187,26 +193,28 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ mov(scratch, FieldOperand(name, String::kHashFieldOffset));
   __ add(scratch, FieldOperand(receiver, HeapObject::kMapOffset));
   __ xor_(scratch, flags);
-  __ and_(scratch, (kPrimaryTableSize - 1) << kHeapObjectTagSize);
+  __ and_(scratch, Operand::StaticVariable(primary_mask));
 
   // Probe the primary table.
-  ProbeTable(isolate(), masm, flags, kPrimary, name, scratch, extra);
+  ProbeTable(isolate, masm, flags, kPrimary, name, scratch, extra);
 
   // Primary miss: Compute hash for secondary probe.
+  __ IncrementCounter(counters->stub_cache_secondary_probes(), 1);
   __ mov(scratch, FieldOperand(name, String::kHashFieldOffset));
   __ add(scratch, FieldOperand(receiver, HeapObject::kMapOffset));
   __ xor_(scratch, flags);
-  __ and_(scratch, (kPrimaryTableSize - 1) << kHeapObjectTagSize);
+  __ and_(scratch, Operand::StaticVariable(primary_mask));
   __ sub(scratch, name);
   __ add(scratch, Immediate(flags));
-  __ and_(scratch, (kSecondaryTableSize - 1) << kHeapObjectTagSize);
+  __ and_(scratch, Operand::StaticVariable(secondary_mask));
 
   // Probe the secondary table.
-  ProbeTable(isolate(), masm, flags, kSecondary, name, scratch, extra);
+  ProbeTable(isolate, masm, flags, kSecondary, name, scratch, extra);
 
   // Cache miss: Fall-through and let caller handle the miss by
   // entering the runtime system.
   __ bind(&miss);
+  __ IncrementCounter(counters->stub_cache_misses(), 1);
 }
 
 
@@ -685,6 +693,43 @@ void StubCompiler::GenerateKeyedLoadMissForceGeneric(MacroAssembler* masm) {
 }
 
 
+// Jumps to miss if value is neither a smi nor a heap number.
+static void GenerateNumberCheck(MacroAssembler* masm,
+                                Register value,
+                                Label* miss) {
+  Label done;
+  __ JumpIfSmi(value, &done);
+  __ cmp(FieldOperand(value, HeapObject::kMapOffset),
+         Immediate(masm->isolate()->factory()->heap_number_map()));
+  __ j(not_equal, miss);
+  __ bind(&done);
+}
+
+
+// Writes the number in value, a smi or a heap number, into the heap number
+// box.  Clobbers scratch.
+static void GenerateStoreNumber(MacroAssembler* masm,
+                                Register value,
+                                Register box,
+                                Register scratch) {
+  Label heap_number, done;
+  __ JumpIfNotSmi(value, &heap_number);
+  __ mov(scratch, value);
+  __ SmiUntag(scratch);
+  __ push(scratch);
+  __ fild_s(Operand(esp, 0));
+  __ pop(scratch);
+  __ fstp_d(FieldOperand(box, HeapNumber::kValueOffset));
+  __ jmp(&done);
+  __ bind(&heap_number);
+  __ mov(scratch, FieldOperand(value, HeapNumber::kMantissaOffset));
+  __ mov(FieldOperand(box, HeapNumber::kMantissaOffset), scratch);
+  __ mov(scratch, FieldOperand(value, HeapNumber::kExponentOffset));
+  __ mov(FieldOperand(box, HeapNumber::kExponentOffset), scratch);
+  __ bind(&done);
+}
+
+
 // Both name_reg and receiver_reg are preserved on jumps to miss_label,
 // but may be destroyed if store is successful.
 void StubCompiler::GenerateStoreField(MacroAssembler* masm,
@@ -712,6 +757,14 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
   // checks.
   ASSERT(object->IsJSGlobalProxy() || !object->IsAccessCheckNeeded());
 
+  // Double fields only take numbers; storing anything else generalizes the
+  // field in the runtime.
+  FieldRepresentation representation = GetFieldRepresentation(
+      transition.is_null() ? object->map() : *transition, index);
+  if (representation == DOUBLE_FIELD) {
+    GenerateNumberCheck(masm, eax, miss_label);
+  }
+
   // Perform map transition for the receiver if necessary.
   if (!transition.is_null() && (object->map()->unused_property_fields() == 0)) {
     // The properties must be extended before we can store the value.
@@ -729,6 +782,44 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
     return;
   }
 
+  // Adjust for the number of properties stored in the object. Even in the
+  // face of a transition we can use the old map here because the size of the
+  // object and the number of in-object properties is not going to change.
+  index -= object->map()->inobject_properties();
+  int offset = index < 0
+      ? object->map()->instance_size() + (index * kPointerSize)
+      : index * kPointerSize + FixedArray::kHeaderSize;
+
+  // The value stored in the field, eax or the mutable heap number of a
+  // double field.
+  Register value = eax;
+  if (representation == DOUBLE_FIELD) {
+    if (transition.is_null()) {
+      // Update the mutable heap number in place.  It may have been replaced
+      // by another value if the field was generalized.
+      if (index < 0) {
+        __ mov(scratch, FieldOperand(receiver_reg, offset));
+      } else {
+        __ mov(scratch,
+               FieldOperand(receiver_reg, JSObject::kPropertiesOffset));
+        __ mov(scratch, FieldOperand(scratch, offset));
+      }
+      __ JumpIfSmi(scratch, miss_label);
+      __ cmp(FieldOperand(scratch, HeapObject::kMapOffset),
+             Immediate(masm->isolate()->factory()->mutable_heap_number_map()));
+      __ j(not_equal, miss_label);
+      GenerateStoreNumber(masm, eax, scratch, name_reg);
+      __ ret(0);
+      return;
+    }
+    // The new field gets a mutable heap number of its own.
+    __ AllocateHeapNumber(scratch, no_reg, no_reg, miss_label);
+    __ mov(FieldOperand(scratch, HeapObject::kMapOffset),
+           Immediate(masm->isolate()->factory()->mutable_heap_number_map()));
+    GenerateStoreNumber(masm, eax, scratch, name_reg);
+    value = scratch;
+  }
+
   if (!transition.is_null()) {
     // Update the map of the object; no write barrier updating is
     // needed because the map is never in new space.
@@ -736,19 +827,13 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
            Immediate(transition));
   }
 
-  // Adjust for the number of properties stored in the object. Even in the
-  // face of a transition we can use the old map here because the size of the
-  // object and the number of in-object properties is not going to change.
-  index -= object->map()->inobject_properties();
-
   if (index < 0) {
     // Set the property straight into the object.
-    int offset = object->map()->instance_size() + (index * kPointerSize);
-    __ mov(FieldOperand(receiver_reg, offset), eax);
+    __ mov(FieldOperand(receiver_reg, offset), value);
 
     // Update the write barrier for the array address.
     // Pass the value being stored in the now unused name_reg.
-    __ mov(name_reg, eax);
+    __ mov(name_reg, value);
     __ RecordWriteField(receiver_reg,
                         offset,
                         name_reg,
@@ -756,18 +841,19 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
                         kDontSaveFPRegs);
   } else {
     // Write to the properties array.
-    int offset = index * kPointerSize + FixedArray::kHeaderSize;
-    // Get the properties array (optimistically).
-    __ mov(scratch, FieldOperand(receiver_reg, JSObject::kPropertiesOffset));
-    __ mov(FieldOperand(scratch, offset), eax);
+    // Get the properties array (optimistically).  The properties array
+    // goes in receiver_reg when scratch holds a new mutable heap number.
+    Register properties = value.is(scratch) ? receiver_reg : scratch;
+    __ mov(properties, FieldOperand(receiver_reg, JSObject::kPropertiesOffset));
+    __ mov(FieldOperand(properties, offset), value);
 
     // Update the write barrier for the array address.
     // Pass the value being stored in the now unused name_reg.
-    __ mov(name_reg, eax);
-    __ RecordWriteField(scratch,
+    __ mov(name_reg, value);
+    __ RecordWriteField(properties,
                         offset,
                         name_reg,
-                        receiver_reg,
+                        properties.is(scratch) ? receiver_reg : scratch,
                         kDontSaveFPRegs);
   }
 
@@ -953,7 +1039,28 @@ void StubCompiler::GenerateLoadField(Handle<JSObject> object,
       object, receiver, holder, scratch1, scratch2, scratch3, name, miss);
 
   // Get the value from the properties.
-  GenerateFastPropertyLoad(masm(), eax, reg, holder, index);
+  if (GetFieldRepresentation(holder->map(), index) == TAGGED_FIELD) {
+    GenerateFastPropertyLoad(masm(), eax, reg, holder, index);
+    __ ret(0);
+    return;
+  }
+
+  // A double field holds a mutable heap number owned by the holder, which
+  // must not escape.  Return a copy of it instead.
+  Label done;
+  GenerateFastPropertyLoad(masm(), scratch3, reg, holder, index);
+  __ JumpIfSmi(scratch3, &done);
+  __ cmp(FieldOperand(scratch3, HeapObject::kMapOffset),
+         Immediate(factory()->mutable_heap_number_map()));
+  __ j(not_equal, &done);
+  __ AllocateHeapNumber(scratch1, no_reg, no_reg, miss);
+  __ mov(scratch2, FieldOperand(scratch3, HeapNumber::kMantissaOffset));
+  __ mov(FieldOperand(scratch1, HeapNumber::kMantissaOffset), scratch2);
+  __ mov(scratch2, FieldOperand(scratch3, HeapNumber::kExponentOffset));
+  __ mov(FieldOperand(scratch1, HeapNumber::kExponentOffset), scratch2);
+  __ mov(scratch3, scratch1);
+  __ bind(&done);
+  __ mov(eax, scratch3);
   __ ret(0);
 }
 
@@ -1063,7 +1170,10 @@ void StubCompiler::GenerateLoadInterceptor(Handle<JSObject> object,
   bool compile_followup_inline = false;
   if (lookup->IsProperty() && lookup->IsCacheable()) {
     if (lookup->type() == FIELD) {
-      compile_followup_inline = true;
+      // Loads from double fields copy the field's heap number, which the
+      // inlined follow-up does not.
+      compile_followup_inline =
+          lookup->GetFieldRepresentation() == TAGGED_FIELD;
     } else if (lookup->type() == CALLBACKS &&
                lookup->GetCallbackObject()->IsAccessorInfo()) {
       compile_followup_inline =
@@ -2520,6 +2630,12 @@ Handle<Code> StoreStubCompiler::CompileStoreGlobal(
   __ cmp(cell_operand, factory()->the_hole_value());
   __ j(equal, &miss);
 
+  // Check that optimized code does not embed the value in the cell. The
+  // runtime system deoptimizes that code before changing it.
+  __ cmp(FieldOperand(ebx, JSGlobalPropertyCell::kStateOffset),
+         Immediate(Smi::FromInt(JSGlobalPropertyCell::CONSTANT)));
+  __ j(equal, &miss);
+
   // Store the value in the cell.
   __ mov(cell_operand, eax);
   Label done;
@@ -39,7 +39,6 @@
 namespace v8 {
 namespace internal {
 
-#ifdef DEBUG
 static char TransitionMarkFromState(IC::State state) {
   switch (state) {
     case UNINITIALIZED: return '0';
@@ -58,37 +57,67 @@ static char TransitionMarkFromState(IC::State state) {
   return 0;
 }
 
+
+// Counts the receiver maps an IC target dispatches on.  Megamorphic stubs
+// that probe the stub cache have none.
+static int ICMapsCount(Code* target, IC::State state) {
+  if (state == UNINITIALIZED || state == PREMONOMORPHIC) return 0;
+  if (state == MONOMORPHIC || state == MONOMORPHIC_PROTOTYPE_FAILURE) {
+    return 1;
+  }
+  AssertNoAllocation no_allocation;
+  int count = 0;
+  int mask = RelocInfo::ModeMask(RelocInfo::EMBEDDED_OBJECT);
+  for (RelocIterator it(target, mask); !it.done(); it.next()) {
+    if (it.rinfo()->target_object()->IsMap()) count++;
+  }
+  return count;
+}
+
+
 void IC::TraceIC(const char* type,
                  Handle<Object> name,
                  State old_state,
                  Code* new_target) {
+  ICTransitionRecorder* recorder = isolate()->ic_transition_recorder();
+  bool record = recorder != NULL && recorder->is_active();
+  if (!FLAG_trace_ic && !FLAG_log_ic && !record) return;
+
+  State new_state = StateFrom(new_target,
+                              HEAP->undefined_value(),
+                              HEAP->undefined_value());
+  StackFrameIterator it;
+  while (it.frame()->fp() != this->fp()) it.Advance();
+  StackFrame* raw_frame = it.frame();
+  bool from_apply = false;
+  if (raw_frame->is_internal()) {
+    Code* apply_builtin = isolate()->builtins()->builtin(
+        Builtins::kFunctionApply);
+    if (raw_frame->unchecked_code() == apply_builtin) {
+      from_apply = true;
+      it.Advance();
+      raw_frame = it.frame();
+    }
+  }
+  JSFunction* function = NULL;
+  int code_offset = 0;
+  int position = RelocInfo::kNoPosition;
+  if (raw_frame->is_java_script()) {
+    JavaScriptFrame* frame = JavaScriptFrame::cast(raw_frame);
+    Code* js_code = frame->unchecked_code();
+    // Find the function on the stack and both the active code for the
+    // function and the original code.
+    function = JSFunction::cast(frame->function());
+    code_offset = static_cast<int>(address() - js_code->instruction_start());
+    position = js_code->SourcePosition(address());
+  }
+
+#ifdef DEBUG
   if (FLAG_trace_ic) {
-    State new_state = StateFrom(new_target,
-                                HEAP->undefined_value(),
-                                HEAP->undefined_value());
     PrintF("[%s in ", type);
-    StackFrameIterator it;
-    while (it.frame()->fp() != this->fp()) it.Advance();
-    StackFrame* raw_frame = it.frame();
-    if (raw_frame->is_internal()) {
-      Isolate* isolate = new_target->GetIsolate();
-      Code* apply_builtin = isolate->builtins()->builtin(
-          Builtins::kFunctionApply);
-      if (raw_frame->unchecked_code() == apply_builtin) {
-        PrintF("apply from ");
-        it.Advance();
-        raw_frame = it.frame();
-      }
-    }
-    if (raw_frame->is_java_script()) {
-      JavaScriptFrame* frame = JavaScriptFrame::cast(raw_frame);
-      Code* js_code = frame->unchecked_code();
-      // Find the function on the stack and both the active code for the
-      // function and the original code.
-      JSFunction* function = JSFunction::cast(frame->function());
+    if (from_apply) PrintF("apply from ");
+    if (function != NULL) {
       function->PrintName();
-      int code_offset =
-          static_cast<int>(address() - js_code->instruction_start());
       PrintF("+%d", code_offset);
     } else {
       PrintF("<unknown>");
@@ -99,12 +128,29 @@ void IC::TraceIC(const char* type,
     name->Print();
     PrintF("]\n");
   }
+#endif
+
+  if (function == NULL) return;
+  int maps_count = ICMapsCount(new_target, new_state);
+  LOG(isolate(), ICTransitionEvent(type,
+                                   function->shared(),
+                                   position,
+                                   TransitionMarkFromState(old_state),
+                                   TransitionMarkFromState(new_state),
+                                   maps_count));
+  if (record) {
+    recorder->Record(function->shared(),
+                     new_target->kind(),
+                     position,
+                     old_state,
+                     new_state,
+                     maps_count);
+  }
 }
-#endif  // DEBUG
 
 
 #define TRACE_IC(type, name, old_state, new_target)             \
-  ASSERT((TraceIC(type, name, old_state, new_target), true))
+  TraceIC(type, name, old_state, new_target)
 
 
 IC::IC(FrameDepth depth, Isolate* isolate) : isolate_(isolate) {
@@ -372,6 +418,22 @@ static bool HasInterceptorGetter(JSObject* object) {
 }
 
 
+// Accessors that just return an internal field of their holder are loaded
+// like fields.  Internal fields are stored in front of the in-object
+// properties, so relative to the first in-object property their property
+// index is negative.
+static bool InternalFieldPropertyIndex(JSObject* holder,
+                                       AccessorInfo* callback,
+                                       int* index) {
+  if (!callback->is_internal_field()) return false;
+  int field = Smi::cast(callback->data())->value();
+  int count = holder->GetInternalFieldCount();
+  if (field >= count) return false;
+  *index = field - count;
+  return true;
+}
+
+
 static void LookupForRead(Handle<Object> object,
                           Handle<String> name,
                           LookupResult* lookup) {
@@ -483,6 +545,21 @@ MaybeObject* CallICBase::LoadFunction(State state,
   LookupForRead(object, name, &lookup);
 
   if (!lookup.IsProperty()) {
+    // Objects with a method_missing method, such as Ruby objects, handle
+    // calls to the methods they do not have.
+    Handle<Object> trampoline = TryMethodMissing(object, name);
+    RETURN_IF_EMPTY_HANDLE(isolate(), trampoline);
+    if (trampoline->IsJSFunction()) {
+      if (FLAG_use_ic) {
+        UpdateMethodMissingCaches(state,
+                                  extra_ic_state,
+                                  Handle<JSObject>::cast(object),
+                                  name,
+                                  Handle<JSFunction>::cast(trampoline));
+      }
+      return *trampoline;
+    }
+
     // If the object does not have the requested property, check which
     // exception we need to throw.
     return IsContextual(object)
@@ -644,6 +721,13 @@ void CallICBase::UpdateCaches(LookupResult* lookup,
   // Bail out if we didn't find a result.
   if (!lookup->IsProperty() || !lookup->IsCacheable()) return;
 
+  // The call stubs only check strings, numbers and booleans by type.  Calls
+  // on the other primitives, such as string buffers, are not cached.
+  if (!object->IsJSReceiver() && !object->IsString() &&
+      !object->IsNumber() && !object->IsBoolean()) {
+    return;
+  }
+
   if (lookup->holder() != *object &&
       HasNormalObjectsInPrototypeChain(
           isolate(), lookup, object->GetPrototype())) {
@@ -686,6 +770,18 @@ void CallICBase::UpdateCaches(LookupResult* lookup,
   // If there's no appropriate stub we simply avoid updating the caches.
   if (code.is_null()) return;
 
+  PatchCache(state, object, name, code);
+
+  if (had_proto_failure) state = MONOMORPHIC_PROTOTYPE_FAILURE;
+  TRACE_IC(kind_ == Code::CALL_IC ? "CallIC" : "KeyedCallIC",
+           name, state, target());
+}
+
+
+void CallICBase::PatchCache(State state,
+                            Handle<Object> object,
+                            Handle<String> name,
+                            Handle<Code> code) {
   // Patch the call site depending on the state of the cache.
   if (state == UNINITIALIZED ||
       state == PREMONOMORPHIC ||
@@ -701,8 +797,95 @@ void CallICBase::UpdateCaches(LookupResult* lookup,
     // Update the stub cache.
     isolate()->stub_cache()->Set(*name, cache_object->map(), *code);
   }
+}
 
-  if (had_proto_failure) state = MONOMORPHIC_PROTOTYPE_FAILURE;
+
+Handle<Object> CallICBase::TryMethodMissing(Handle<Object> object,
+                                            Handle<String> name) {
+  Factory* factory = isolate()->factory();
+  if (IsContextual(object) || !object->IsJSObject()) {
+    return factory->undefined_value();
+  }
+  LookupResult lookup(isolate());
+  LookupForRead(object, factory->method_missing_symbol(), &lookup);
+  if (!lookup.IsProperty()) return factory->undefined_value();
+
+  // There is one trampoline per name and global context, so the stubs that
+  // call a trampoline stay valid.
+  Handle<String> symbol = factory->LookupSymbol(name);
+  Handle<Context> global_context(isolate()->context()->global_context());
+  Handle<ObjectHashTable> trampolines;
+  if (global_context->method_missing_trampolines()->IsUndefined()) {
+    trampolines = factory->NewObjectHashTable(16);
+  } else {
+    trampolines = Handle<ObjectHashTable>(
+        ObjectHashTable::cast(global_context->method_missing_trampolines()));
+    Handle<Object> trampoline(trampolines->Lookup(*symbol));
+    if (trampoline->IsJSFunction()) return trampoline;
+  }
+
+  Handle<JSFunction> fun(global_context->method_missing_trampoline_fun());
+  Handle<Object> args[] = { factory->LookupAtom(symbol) };
+  bool caught_exception;
+  Handle<Object> trampoline = Execution::Call(fun,
+                                              isolate()->js_builtins_object(),
+                                              ARRAY_SIZE(args),
+                                              args,
+                                              &caught_exception);
+  if (caught_exception) return Handle<Object>::null();
+  // Call stubs embed the trampoline, and code cannot point into new space,
+  // so keep a copy of the closure in old space.
+  if (trampoline->IsJSFunction()) {
+    Handle<JSFunction> closure = Handle<JSFunction>::cast(trampoline);
+    trampoline = factory->NewFunctionFromSharedFunctionInfo(
+        Handle<SharedFunctionInfo>(closure->shared()),
+        Handle<Context>(closure->context()),
+        TENURED);
+  }
+  trampolines = PutIntoObjectHashTable(trampolines, symbol, trampoline);
+  global_context->set_method_missing_trampolines(*trampolines);
+  return trampoline;
+}
+
+
+void CallICBase::UpdateMethodMissingCaches(State state,
+                                           Code::ExtraICState extra_ic_state,
+                                           Handle<JSObject> object,
+                                           Handle<String> name,
+                                           Handle<JSFunction> trampoline) {
+  // The stub checks the maps of the whole prototype chain, which proves
+  // that the name is still missing.  Objects in dictionary mode are checked
+  // by a negative dictionary lookup instead, and global objects by their
+  // property cells, except for the last object, which must be fast.
+  Handle<JSObject> last = object;
+  while (true) {
+    if (last->IsAccessCheckNeeded() && !last->IsJSGlobalProxy()) return;
+    if (last->GetPrototype()->IsNull()) break;
+    last = Handle<JSObject>(JSObject::cast(last->GetPrototype()));
+  }
+  if (!last->HasFastProperties() || last->IsGlobalObject()) return;
+
+  int argc = target()->arguments_count();
+  Handle<Code> code;
+  if (state == UNINITIALIZED) {
+    code = isolate()->stub_cache()->ComputeCallPreMonomorphic(
+        argc, kind_, extra_ic_state);
+  } else if (state == MONOMORPHIC) {
+    if (kind_ == Code::CALL_IC &&
+        TryRemoveInvalidPrototypeDependentStub(target(), *object, *name)) {
+      state = MONOMORPHIC_PROTOTYPE_FAILURE;
+      code = isolate()->stub_cache()->ComputeCallConstant(
+          argc, kind_, extra_ic_state, name, object, last, trampoline);
+    } else {
+      code = isolate()->stub_cache()->ComputeCallMegamorphic(
+          argc, kind_, extra_ic_state);
+    }
+  } else {
+    code = isolate()->stub_cache()->ComputeCallConstant(
+        argc, kind_, extra_ic_state, name, object, last, trampoline);
+  }
+
+  PatchCache(state, object, name, code);
   TRACE_IC(kind_ == Code::CALL_IC ? "CallIC" : "KeyedCallIC",
            name, state, target());
 }
@@ -844,6 +1027,18 @@ MaybeObject* LoadIC::Load(State state,
   uint32_t index;
   if (name->AsArrayIndex(&index)) return object->GetElement(index);
 
+  // The normal load stub misses once a normalized object has been read
+  // often enough without changing shape. Give it fast properties again.
+  if (FLAG_fast_properties_read_threshold > 0 && object->IsJSObject()) {
+    Handle<JSObject> receiver = Handle<JSObject>::cast(object);
+    if (!receiver->HasFastProperties() &&
+        !receiver->IsGlobalObject() &&
+        receiver->property_dictionary()->HasReachedReadCount(
+            FLAG_fast_properties_read_threshold)) {
+      TransformToFastPropertiesAfterReads(receiver);
+    }
+  }
+
   // Named lookup in the object.
   LookupResult lookup(isolate());
   LookupForRead(object, name, &lookup);
@@ -940,8 +1135,14 @@ void LoadIC::UpdateCaches(LookupResult* lookup,
         Handle<AccessorInfo> callback =
             Handle<AccessorInfo>::cast(callback_object);
         if (v8::ToCData<Address>(callback->getter()) == 0) return;
-        code = isolate()->stub_cache()->ComputeLoadCallback(
-            name, receiver, holder, callback);
+        int index;
+        if (InternalFieldPropertyIndex(*holder, *callback, &index)) {
+          code = isolate()->stub_cache()->ComputeLoadField(
+              name, receiver, holder, index);
+        } else {
+          code = isolate()->stub_cache()->ComputeLoadCallback(
+              name, receiver, holder, callback);
+        }
         break;
       }
       case INTERCEPTOR:
@@ -1174,8 +1375,14 @@ void KeyedLoadIC::UpdateCaches(LookupResult* lookup,
         Handle<AccessorInfo> callback =
             Handle<AccessorInfo>::cast(callback_object);
         if (v8::ToCData<Address>(callback->getter()) == 0) return;
-        code = isolate()->stub_cache()->ComputeKeyedLoadCallback(
-            name, receiver, holder, callback);
+        int index;
+        if (InternalFieldPropertyIndex(*holder, *callback, &index)) {
+          code = isolate()->stub_cache()->ComputeKeyedLoadField(
+              name, receiver, holder, index);
+        } else {
+          code = isolate()->stub_cache()->ComputeKeyedLoadCallback(
+              name, receiver, holder, callback);
+        }
         break;
       }
       case INTERCEPTOR:
@@ -1913,7 +2120,19 @@ RUNTIME_FUNCTION(MaybeObject*, SharedStoreIC_ExtendStorage) {
     if (!maybe_result->ToObject(&result)) return maybe_result;
   }
   FixedArray* new_storage = FixedArray::cast(result);
-  new_storage->set(old_storage->length(), value);
+
+  // A new double field gets a mutable heap number of its own.  The stub
+  // has checked that the value is a number.
+  Object* stored_value = value;
+  int index = transition->inobject_properties() + old_storage->length();
+  if (StubCompiler::GetFieldRepresentation(transition, index) ==
+      DOUBLE_FIELD) {
+    ASSERT(value->IsNumber());
+    MaybeObject* maybe_box =
+        isolate->heap()->AllocateMutableHeapNumber(value->Number());
+    if (!maybe_box->ToObject(&stored_value)) return maybe_box;
+  }
+  new_storage->set(old_storage->length(), stored_value);
 
   // Set the new property value and do the map transition.
   object->set_properties(new_storage);
@@ -2394,4 +2613,124 @@ Address IC::AddressFromUtilityId(IC::UtilityId id) {
 }
 
 
+ICTransitionRecorder::Site* ICTransitionRecorder::Function::FindOrAddSite(
+    Code::Kind kind, int position) {
+  for (int i = 0; i < sites_.length(); i++) {
+    Site* site = &sites_[i];
+    if (site->kind == kind && site->position == position) return site;
+  }
+  Site site = { kind, position, UNINITIALIZED, 0, 0 };
+  sites_.Add(site);
+  return &sites_.last();
+}
+
+
+int ICTransitionRecorder::Function::CountSitesInState(
+    InlineCacheState state) const {
+  int count = 0;
+  for (int i = 0; i < sites_.length(); i++) {
+    if (sites_[i].state == state) count++;
+  }
+  return count;
+}
+
+
+static v8::ICProfile::Kind ICProfileKindFrom(Code::Kind kind) {
+  switch (kind) {
+    case Code::LOAD_IC: return v8::ICProfile::kLoad;
+    case Code::KEYED_LOAD_IC: return v8::ICProfile::kKeyedLoad;
+    case Code::STORE_IC: return v8::ICProfile::kStore;
+    case Code::KEYED_STORE_IC: return v8::ICProfile::kKeyedStore;
+    case Code::CALL_IC: return v8::ICProfile::kCall;
+    case Code::KEYED_CALL_IC: return v8::ICProfile::kKeyedCall;
+    default: break;
+  }
+  UNREACHABLE();
+  return v8::ICProfile::kLoad;
+}
+
+
+ICTransitionRecorder::ICTransitionRecorder()
+    : recording_(false),
+      callback_(NULL),
+      function_map_(FunctionMatch),
+      functions_(16) {
+}
+
+
+ICTransitionRecorder::~ICTransitionRecorder() {
+  Clear();
+}
+
+
+bool ICTransitionRecorder::FunctionMatch(void* key1, void* key2) {
+  Function* function1 = reinterpret_cast<Function*>(key1);
+  Function* function2 = reinterpret_cast<Function*>(key2);
+  return function1->script_id() == function2->script_id() &&
+         function1->start_position() == function2->start_position();
+}
+
+
+ICTransitionRecorder::Function* ICTransitionRecorder::FindOrAddFunction(
+    SharedFunctionInfo* shared) {
+  int script_id = 0;
+  SmartArrayPointer<char> script_name;
+  if (shared->script()->IsScript()) {
+    Script* script = Script::cast(shared->script());
+    if (script->id()->IsSmi()) script_id = Smi::cast(script->id())->value();
+    if (script->name()->IsString()) {
+      script_name = String::cast(script->name())->ToCString();
+    }
+  }
+  Function key(script_id,
+               shared->start_position(),
+               SmartArrayPointer<char>(),
+               SmartArrayPointer<char>());
+  uint32_t hash = ComputeIntegerHash(
+      static_cast<uint32_t>(script_id * 31 + shared->start_position()));
+  HashMap::Entry* entry = function_map_.Lookup(&key, hash, true);
+  if (entry->value == NULL) {
+    Function* function = new Function(script_id,
+                                      shared->start_position(),
+                                      shared->DebugName()->ToCString(),
+                                      script_name);
+    entry->key = function;
+    entry->value = function;
+    functions_.Add(function);
+  }
+  return reinterpret_cast<Function*>(entry->value);
+}
+
+
+void ICTransitionRecorder::Record(SharedFunctionInfo* shared,
+                                  Code::Kind kind,
+                                  int position,
+                                  InlineCacheState old_state,
+                                  InlineCacheState new_state,
+                                  int maps_count) {
+  AssertNoAllocation no_allocation;
+  if (callback_ != NULL) {
+    SmartArrayPointer<char> name = shared->DebugName()->ToCString();
+    callback_(*name,
+              position,
+              ICProfileKindFrom(kind),
+              static_cast<v8::ICProfile::State>(old_state),
+              static_cast<v8::ICProfile::State>(new_state),
+              maps_count);
+  }
+  if (!recording_) return;
+  Site* site = FindOrAddFunction(shared)->FindOrAddSite(kind, position);
+  site->state = new_state;
+  site->maps_count = maps_count;
+  site->transitions++;
+}
+
+
+void ICTransitionRecorder::Clear() {
+  for (int i = 0; i < functions_.length(); i++) delete functions_[i];
+  functions_.Clear();
+  function_map_.Clear();
+}
+
+
 } }  // namespace v8::internal
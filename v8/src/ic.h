@@ -28,6 +28,8 @@
 #ifndef V8_IC_H_
 #define V8_IC_H_
 
+#include "../include/v8-profiler.h"
+#include "hashmap.h"
 #include "macro-assembler.h"
 #include "type-info.h"
 
@@ -145,12 +147,12 @@ class IC {
   // Set the call-site target.
   void set_target(Code* code) { SetTargetAtAddress(address(), code); }
 
-#ifdef DEBUG
+  // Reports a state transition of this IC to --trace-ic, --log-ic and the
+  // isolate's ICTransitionRecorder.
   void TraceIC(const char* type,
                Handle<Object> name,
                State old_state,
                Code* new_target);
-#endif
 
   Failure* TypeError(const char* type,
                      Handle<Object> object,
@@ -227,6 +229,25 @@ class CallICBase: public IC {
                     Handle<Object> object,
                     Handle<String> name);
 
+  // Returns the function to call in place of a method the object does not
+  // have if the object has a method_missing method, and the undefined value
+  // otherwise.  Returns a null handle if an exception was thrown.
+  Handle<Object> TryMethodMissing(Handle<Object> object, Handle<String> name);
+
+  // Update the inline cache and the global stub cache for a call to a
+  // missing method that method_missing handles.
+  void UpdateMethodMissingCaches(State state,
+                                 Code::ExtraICState extra_ic_state,
+                                 Handle<JSObject> object,
+                                 Handle<String> name,
+                                 Handle<JSFunction> trampoline);
+
+  // Patch the call site, or the stub cache if the call site is megamorphic.
+  void PatchCache(State state,
+                  Handle<Object> object,
+                  Handle<String> name,
+                  Handle<Code> code);
+
   // Returns a JSFunction if the object can be called as a function, and
   // patches the stack to be ready for the call.  Otherwise, it returns the
   // undefined value.
@@ -753,6 +774,91 @@ class ToBooleanIC: public IC {
 // Helper for BinaryOpIC and CompareIC.
 void PatchInlinedSmiCode(Address address);
 
+
+// Collects the state transitions of load, store and call ICs while
+// v8::ICProfiler is recording.  The sites are grouped by the function whose
+// code contains them and keep the state they were last seen in.
+class ICTransitionRecorder {
+ public:
+  struct Site {
+    Code::Kind kind;
+    int position;
+    InlineCacheState state;
+    int maps_count;
+    int transitions;
+  };
+
+  class Function: public Malloced {
+   public:
+    Function(int script_id,
+             int start_position,
+             SmartArrayPointer<char> name,
+             SmartArrayPointer<char> script_name)
+        : script_id_(script_id),
+          start_position_(start_position),
+          name_(name),
+          script_name_(script_name),
+          sites_(4) { }
+
+    int script_id() const { return script_id_; }
+    int start_position() const { return start_position_; }
+    const char* name() const { return *name_; }
+    const char* script_name() const { return *script_name_; }
+    const List<Site>* sites() const { return &sites_; }
+
+    // Returns the site at position with the given kind, adding it if this
+    // is its first transition.
+    Site* FindOrAddSite(Code::Kind kind, int position);
+
+    // Counts the sites that were last seen in the given state.
+    int CountSitesInState(InlineCacheState state) const;
+
+   private:
+    int script_id_;
+    int start_position_;
+    // SmartArrayPointer only hands out its pointer from non-const members.
+    mutable SmartArrayPointer<char> name_;
+    mutable SmartArrayPointer<char> script_name_;
+    List<Site> sites_;
+  };
+
+  ICTransitionRecorder();
+  ~ICTransitionRecorder();
+
+  bool is_recording() const { return recording_; }
+  void set_recording(bool recording) { recording_ = recording; }
+  void set_callback(v8::ICProfiler::TransitionCallback callback) {
+    callback_ = callback;
+  }
+  bool is_active() const { return recording_ || callback_ != NULL; }
+
+  void Record(SharedFunctionInfo* shared,
+              Code::Kind kind,
+              int position,
+              InlineCacheState old_state,
+              InlineCacheState new_state,
+              int maps_count);
+
+  int functions_count() const { return functions_.length(); }
+  const Function* function(int index) const { return functions_[index]; }
+
+  // Drops everything recorded so far.
+  void Clear();
+
+ private:
+  Function* FindOrAddFunction(SharedFunctionInfo* shared);
+
+  static bool FunctionMatch(void* key1, void* key2);
+
+  bool recording_;
+  v8::ICProfiler::TransitionCallback callback_;
+  // Maps (script id, start position) to the functions_ entry.
+  HashMap function_map_;
+  List<Function*> functions_;
+
+  DISALLOW_COPY_AND_ASSIGN(ICTransitionRecorder);
+};
+
 } }  // namespace v8::internal
 
 #endif  // V8_IC_H_
@@ -52,6 +52,12 @@ IncrementalMarking::IncrementalMarking(Heap* heap)
       should_hurry_(false),
       allocation_marking_factor_(0),
       allocated_(0),
+      max_step_ms_(0),
+      growth_target_percent_(0),
+      allocated_since_start_of_incremental_(0),
+      marking_speed_(kInitialMarkingSpeed),
+      steps_bytes_(0),
+      biggest_step_bytes_(0),
       no_marking_scope_depth_(0) {
 }
 
@@ -505,7 +511,8 @@ void IncrementalMarking::StartMarking(CompactionFlag flag) {
   }
 
   is_compacting_ = !FLAG_never_compact && (flag == ALLOW_COMPACTION) &&
-      heap_->mark_compact_collector()->StartCompaction();
+      heap_->mark_compact_collector()->StartCompaction(
+          MarkCompactCollector::INCREMENTAL_COMPACTION);
 
   state_ = MARKING;
 
@@ -531,7 +538,6 @@ void IncrementalMarking::StartMarking(CompactionFlag flag) {
   }
 #endif
 
-  heap_->CompletelyClearInstanceofCache();
   heap_->isolate()->compilation_cache()->MarkCompactPrologue();
 
   if (FLAG_cleanup_code_caches_at_gc) {
@@ -763,67 +769,22 @@ void IncrementalMarking::Step(intptr_t allocated_bytes) {
 
   if (state_ == MARKING && no_marking_scope_depth_ > 0) return;
 
-  intptr_t bytes_to_process = allocated_ * allocation_marking_factor_;
-  bytes_scanned_ += bytes_to_process;
+  intptr_t bytes_to_process = (max_step_ms_ > 0 || growth_target_percent_ > 0)
+      ? StepSizeForPauseTarget()
+      : allocated_ * allocation_marking_factor_;
 
   double start = 0;
+  bool timed = FLAG_trace_incremental_marking || FLAG_trace_gc ||
+      max_step_ms_ > 0;
 
-  if (FLAG_trace_incremental_marking || FLAG_trace_gc) {
+  if (timed) {
     start = OS::TimeCurrentMillis();
   }
 
-  if (state_ == SWEEPING) {
-    if (heap_->AdvanceSweepers(static_cast<int>(bytes_to_process))) {
-      bytes_scanned_ = 0;
-      StartMarking(PREVENT_COMPACTION);
-    }
-  } else if (state_ == MARKING) {
-    Map* filler_map = heap_->one_pointer_filler_map();
-    Map* global_context_map = heap_->global_context_map();
-    IncrementalMarkingMarkingVisitor marking_visitor(heap_, this);
-    while (!marking_deque_.IsEmpty() && bytes_to_process > 0) {
-      HeapObject* obj = marking_deque_.Pop();
-
-      // Explicitly skip one word fillers. Incremental markbit patterns are
-      // correct only for objects that occupy at least two words.
-      Map* map = obj->map();
-      if (map == filler_map) continue;
-
-      int size = obj->SizeFromMap(map);
-      bytes_to_process -= size;
-      MarkBit map_mark_bit = Marking::MarkBitFrom(map);
-      if (Marking::IsWhite(map_mark_bit)) {
-        WhiteToGreyAndPush(map, map_mark_bit);
-      }
-
-      // TODO(gc) switch to static visitor instead of normal visitor.
-      if (map == global_context_map) {
-        // Global contexts have weak fields.
-        Context* ctx = Context::cast(obj);
-
-        // We will mark cache black with a separate pass
-        // when we finish marking.
-        MarkObjectGreyDoNotEnqueue(ctx->normalized_map_cache());
-
-        VisitGlobalContext(ctx, &marking_visitor);
-      } else {
-        obj->IterateBody(map->instance_type(), size, &marking_visitor);
-      }
-
-      MarkBit obj_mark_bit = Marking::MarkBitFrom(obj);
-      SLOW_ASSERT(Marking::IsGrey(obj_mark_bit) ||
-                  (obj->IsFiller() && Marking::IsWhite(obj_mark_bit)));
-      Marking::MarkBlack(obj_mark_bit);
-      MemoryChunk::IncrementLiveBytes(obj->address(), size);
-    }
-    if (marking_deque_.IsEmpty()) MarkingComplete();
-  }
+  ProcessStep(bytes_to_process);
 
   allocated_ = 0;
 
-  steps_count_++;
-  steps_count_since_last_gc_++;
-
   bool speed_up = false;
 
   if ((steps_count_ % kAllocationMarkingFactorSpeedupInterval) == 0) {
@@ -871,6 +832,10 @@ void IncrementalMarking::Step(intptr_t allocated_bytes) {
     speed_up = true;
   }
 
+  // With a growth target the step size already takes the space left into
+  // account.
+  if (growth_target_percent_ > 0) speed_up = false;
+
   if (speed_up) {
     if (state_ != MARKING) {
       if (FLAG_trace_gc) {
@@ -887,7 +852,7 @@ void IncrementalMarking::Step(intptr_t allocated_bytes) {
     }
   }
 
-  if (FLAG_trace_incremental_marking || FLAG_trace_gc) {
+  if (timed) {
     double end = OS::TimeCurrentMillis();
     double delta = (end - start);
     longest_step_ = Max(longest_step_, delta);
@@ -897,6 +862,93 @@ void IncrementalMarking::Step(intptr_t allocated_bytes) {
 }
 
 
+void IncrementalMarking::IdleStep(intptr_t bytes_to_process) {
+  if (heap_->gc_state() != Heap::NOT_IN_GC ||
+      !FLAG_incremental_marking ||
+      !FLAG_incremental_marking_steps ||
+      (state_ != SWEEPING && state_ != MARKING)) {
+    return;
+  }
+
+  if (state_ == MARKING && no_marking_scope_depth_ > 0) return;
+
+  double start = OS::TimeCurrentMillis();
+
+  ProcessStep(bytes_to_process);
+
+  double delta = OS::TimeCurrentMillis() - start;
+  longest_step_ = Max(longest_step_, delta);
+  steps_took_ += delta;
+  steps_took_since_last_gc_ += delta;
+}
+
+
+void IncrementalMarking::ProcessStep(intptr_t bytes_to_process) {
+  bytes_scanned_ += bytes_to_process;
+  steps_bytes_ += bytes_to_process;
+  biggest_step_bytes_ = Max(biggest_step_bytes_, bytes_to_process);
+
+  if (state_ == SWEEPING) {
+    if (heap_->AdvanceSweepers(static_cast<int>(bytes_to_process))) {
+      bytes_scanned_ = 0;
+      StartMarking(PREVENT_COMPACTION);
+    }
+  } else if (state_ == MARKING) {
+    double start = OS::TimeCurrentMillis();
+    intptr_t budget = bytes_to_process;
+    Map* filler_map = heap_->one_pointer_filler_map();
+    Map* global_context_map = heap_->global_context_map();
+    IncrementalMarkingMarkingVisitor marking_visitor(heap_, this);
+    while (!marking_deque_.IsEmpty() && bytes_to_process > 0) {
+      HeapObject* obj = marking_deque_.Pop();
+
+      // Explicitly skip one word fillers. Incremental markbit patterns are
+      // correct only for objects that occupy at least two words.
+      Map* map = obj->map();
+      if (map == filler_map) continue;
+
+      int size = obj->SizeFromMap(map);
+      bytes_to_process -= size;
+      MarkBit map_mark_bit = Marking::MarkBitFrom(map);
+      if (Marking::IsWhite(map_mark_bit)) {
+        WhiteToGreyAndPush(map, map_mark_bit);
+      }
+
+      // TODO(gc) switch to static visitor instead of normal visitor.
+      if (map == global_context_map) {
+        // Global contexts have weak fields.
+        Context* ctx = Context::cast(obj);
+
+        // We will mark cache black with a separate pass
+        // when we finish marking.
+        MarkObjectGreyDoNotEnqueue(ctx->normalized_map_cache());
+
+        VisitGlobalContext(ctx, &marking_visitor);
+      } else {
+        obj->IterateBody(map->instance_type(), size, &marking_visitor);
+      }
+
+      MarkBit obj_mark_bit = Marking::MarkBitFrom(obj);
+      SLOW_ASSERT(Marking::IsGrey(obj_mark_bit) ||
+                  (obj->IsFiller() && Marking::IsWhite(obj_mark_bit)));
+      Marking::MarkBlack(obj_mark_bit);
+      MemoryChunk::IncrementLiveBytes(obj->address(), size);
+    }
+    if (marking_deque_.IsEmpty()) MarkingComplete();
+
+    // Only steps that did a fair amount of work say much about the speed.
+    intptr_t marked = budget - bytes_to_process;
+    if (marked >= kAllocatedThreshold) {
+      double delta = OS::TimeCurrentMillis() - start;
+      if (delta > 0) marking_speed_ = (marking_speed_ + marked / delta) / 2;
+    }
+  }
+
+  steps_count_++;
+  steps_count_since_last_gc_++;
+}
+
+
 void IncrementalMarking::ResetStepCounters() {
   steps_count_ = 0;
   steps_took_ = 0;
@@ -910,6 +962,48 @@ void IncrementalMarking::ResetStepCounters() {
   bytes_rescanned_ = 0;
   allocation_marking_factor_ = kInitialAllocationMarkingFactor;
   bytes_scanned_ = 0;
+  steps_bytes_ = 0;
+  biggest_step_bytes_ = 0;
+  allocated_since_start_of_incremental_ = 0;
+}
+
+
+void IncrementalMarking::SetPauseTarget(int max_step_ms,
+                                        int growth_target_percent) {
+  max_step_ms_ = Max(max_step_ms, 0);
+  growth_target_percent_ = Max(growth_target_percent, 0);
+}
+
+
+intptr_t IncrementalMarking::StepSizeForPauseTarget() {
+  intptr_t bytes = allocated_ * allocation_marking_factor_;
+
+  if (growth_target_percent_ > 0) {
+    // Spread the marking work that is left over the growth that is left,
+    // assuming that everything allocated is promoted.  The old generation
+    // size is an upper bound of the live objects to mark.
+    int64_t used = heap_->PromotedTotalSize();
+    int64_t work_left = Max(used - bytes_scanned_, static_cast<int64_t>(0));
+    int64_t growth_target =
+        old_generation_space_used_at_start_of_incremental_ *
+        growth_target_percent_ / 100;
+    int64_t growth = Max(
+        used - old_generation_space_used_at_start_of_incremental_,
+        allocated_since_start_of_incremental_);
+    int64_t growth_left = growth_target - growth;
+    allocated_since_start_of_incremental_ += allocated_;
+    if (growth_left <= allocated_) {
+      bytes = static_cast<intptr_t>(work_left);
+    } else {
+      bytes = static_cast<intptr_t>(allocated_ * work_left / growth_left);
+    }
+    bytes = Max(bytes, allocated_);
+  }
+
+  if (max_step_ms_ > 0) {
+    bytes = Min(bytes, static_cast<intptr_t>(marking_speed_ * max_step_ms_));
+  }
+  return bytes;
 }
 
 
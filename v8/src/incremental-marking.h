@@ -99,6 +99,16 @@ class IncrementalMarking {
   // This is how much we increase the marking/allocating factor by.
   static const intptr_t kAllocationMarkingFactorSpeedup = 2;
   static const intptr_t kMaxAllocationMarkingFactor = 1000;
+  // Marking speed assumed in pause target mode until a step was measured,
+  // in bytes per millisecond.
+  static const intptr_t kInitialMarkingSpeed = 100 * KB;
+
+  // Pause target mode.  With a maximum step duration the marker measures
+  // its speed and keeps each step below that duration.  With a growth
+  // target it sizes the steps so that marking finishes before the old
+  // generation has grown by that percentage of its size at the start of
+  // marking.  Zero disables either limit.
+  void SetPauseTarget(int max_step_ms, int growth_target_percent);
 
   void OldSpaceStep(intptr_t allocated) {
     Step(allocated * kFastMarking / kInitialAllocationMarkingFactor);
@@ -106,6 +116,10 @@ class IncrementalMarking {
 
   void Step(intptr_t allocated);
 
+  // Performs a marking or sweeping step of the given size on behalf of an
+  // idle notification.  Unlike Step it is not tied to the allocation rate.
+  void IdleStep(intptr_t bytes_to_process);
+
   inline void RestartIfNotMarking() {
     if (state_ == COMPLETE) {
       state_ = MARKING;
@@ -182,6 +196,19 @@ class IncrementalMarking {
     return steps_took_since_last_gc_;
   }
 
+  inline int64_t steps_bytes() {
+    return steps_bytes_;
+  }
+
+  inline intptr_t biggest_step_bytes() {
+    return biggest_step_bytes_;
+  }
+
+  // Measured marking speed in bytes per millisecond.
+  inline double marking_speed() {
+    return marking_speed_;
+  }
+
   inline void SetOldSpacePageFlags(MemoryChunk* chunk) {
     SetOldSpacePageFlags(chunk, IsMarking(), IsCompacting());
   }
@@ -227,6 +254,10 @@ class IncrementalMarking {
 
   void ResetStepCounters();
 
+  intptr_t StepSizeForPauseTarget();
+
+  void ProcessStep(intptr_t bytes_to_process);
+
   enum CompactionFlag { ALLOW_COMPACTION, PREVENT_COMPACTION };
 
   void StartMarking(CompactionFlag flag);
@@ -271,6 +302,13 @@ class IncrementalMarking {
   intptr_t bytes_scanned_;
   intptr_t allocated_;
 
+  int max_step_ms_;
+  int growth_target_percent_;
+  int64_t allocated_since_start_of_incremental_;
+  double marking_speed_;
+  int64_t steps_bytes_;
+  intptr_t biggest_step_bytes_;
+
   int no_marking_scope_depth_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(IncrementalMarking);
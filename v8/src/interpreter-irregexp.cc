@@ -35,6 +35,7 @@
 #include "bytecodes-irregexp.h"
 #include "jsregexp.h"
 #include "interpreter-irregexp.h"
+#include "regexp-stack.h"
 
 namespace v8 {
 namespace internal {
@@ -201,6 +202,8 @@ static RegExpImpl::IrregexpResult RawMatch(Isolate* isolate,
   int* backtrack_stack_base = backtrack_stack.data();
   int* backtrack_sp = backtrack_stack_base;
   int backtrack_stack_space = backtrack_stack.max_size();
+  RegExpStack* regexp_stack = isolate->regexp_stack();
+  regexp_stack->ResetBacktrackBudget();
 #ifdef DEBUG
   if (FLAG_trace_regexp_bytecodes) {
     PrintF("\n\nStart bytecode interpreter\n\n");
@@ -267,6 +270,10 @@ static RegExpImpl::IrregexpResult RawMatch(Isolate* isolate,
         pc += BC_POP_CP_LENGTH;
         break;
       BYTECODE(POP_BT)
+        if (FLAG_regexp_backtrack_limit > 0 &&
+            !regexp_stack->ConsumeBacktrack()) {
+          return RegExpImpl::RE_EXCEPTION;
+        }
         backtrack_stack_space++;
         --backtrack_sp;
         pc = code_base + *backtrack_sp;
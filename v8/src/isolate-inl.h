@@ -58,6 +58,16 @@ bool Isolate::DebuggerHasBreakPoints() {
 }
 
 
+bool Isolate::DebuggerNeedsFullCode(SharedFunctionInfo* shared) {
+#ifdef ENABLE_DEBUGGER_SUPPORT
+  return debug()->prepared_all_functions() ||
+      !shared->debug_info()->IsUndefined();
+#else
+  return false;
+#endif
+}
+
+
 } }  // namespace v8::internal
 
 #endif  // V8_ISOLATE_INL_H_
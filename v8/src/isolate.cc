@@ -33,14 +33,18 @@
 #include "bootstrapper.h"
 #include "codegen.h"
 #include "compilation-cache.h"
+#include "date.h"
 #include "debug.h"
 #include "deoptimizer.h"
+#include "feedback-profile.h"
 #include "heap-profiler.h"
 #include "hydrogen.h"
+#include "ic.h"
 #include "isolate.h"
 #include "lithium-allocator.h"
 #include "log.h"
 #include "messages.h"
+#include "optimizing-compiler-thread.h"
 #include "regexp-stack.h"
 #include "runtime-profiler.h"
 #include "scopeinfo.h"
@@ -314,7 +318,11 @@ void Isolate::PreallocatedStorageDelete(void* p) {
 
 Isolate* Isolate::default_isolate_ = NULL;
 Thread::LocalStorageKey Isolate::isolate_key_;
+#ifdef V8_THREAD_STORAGE_CLASS_SUPPORTED
+__thread Isolate* Isolate::current_ = NULL;
+#endif
 Thread::LocalStorageKey Isolate::thread_id_key_;
+Thread::LocalStorageKey Isolate::zone_key_;
 Thread::LocalStorageKey Isolate::per_isolate_thread_data_key_;
 Mutex* Isolate::process_wide_mutex_ = OS::CreateMutex();
 Isolate::ThreadDataTable* Isolate::thread_data_table_ = NULL;
@@ -357,7 +365,11 @@ Isolate::PerIsolateThreadData* Isolate::AllocatePerIsolateThreadData(
 Isolate::PerIsolateThreadData*
     Isolate::FindOrAllocatePerThreadDataForThisThread() {
   ThreadId thread_id = ThreadId::Current();
-  PerIsolateThreadData* per_thread = NULL;
+  PerIsolateThreadData* per_thread = CurrentPerIsolateThreadData();
+  if (per_thread != NULL && per_thread->Matches(this, thread_id)) {
+    return per_thread;
+  }
+  per_thread = NULL;
   {
     ScopedLock lock(process_wide_mutex_);
     per_thread = thread_data_table_->Lookup(this, thread_id);
@@ -371,7 +383,13 @@ Isolate::PerIsolateThreadData*
 
 Isolate::PerIsolateThreadData* Isolate::FindPerThreadDataForThisThread() {
   ThreadId thread_id = ThreadId::Current();
-  PerIsolateThreadData* per_thread = NULL;
+  // A thread that has entered this isolate finds its data in TLS, which
+  // keeps Locker handoffs off the process wide mutex.
+  PerIsolateThreadData* per_thread = CurrentPerIsolateThreadData();
+  if (per_thread != NULL && per_thread->Matches(this, thread_id)) {
+    return per_thread;
+  }
+  per_thread = NULL;
   {
     ScopedLock lock(process_wide_mutex_);
     per_thread = thread_data_table_->Lookup(this, thread_id);
@@ -385,6 +403,7 @@ void Isolate::EnsureDefaultIsolate() {
   if (default_isolate_ == NULL) {
     isolate_key_ = Thread::CreateThreadLocalKey();
     thread_id_key_ = Thread::CreateThreadLocalKey();
+    zone_key_ = Thread::CreateThreadLocalKey();
     per_isolate_thread_data_key_ = Thread::CreateThreadLocalKey();
     thread_data_table_ = new Isolate::ThreadDataTable();
     default_isolate_ = new Isolate();
@@ -392,7 +411,7 @@ void Isolate::EnsureDefaultIsolate() {
   // Can't use SetIsolateThreadLocals(default_isolate_, NULL) here
   // becase a non-null thread data may be already set.
   if (Thread::GetThreadLocal(isolate_key_) == NULL) {
-    Thread::SetThreadLocal(isolate_key_, default_isolate_);
+    SetCurrentIsolate(default_isolate_);
   }
 }
 
@@ -493,6 +512,45 @@ void Isolate::Iterate(ObjectVisitor* v) {
 }
 
 
+void Isolate::IterateDeferredHandles(ObjectVisitor* v) {
+  for (DeferredHandles* deferred = deferred_handles_head_;
+       deferred != NULL;
+       deferred = deferred->next_) {
+    deferred->Iterate(v);
+  }
+}
+
+
+void Isolate::LinkDeferredHandles(DeferredHandles* deferred) {
+  deferred->next_ = deferred_handles_head_;
+  if (deferred_handles_head_ != NULL) {
+    deferred_handles_head_->previous_ = deferred;
+  }
+  deferred_handles_head_ = deferred;
+}
+
+
+void Isolate::UnlinkDeferredHandles(DeferredHandles* deferred) {
+#ifdef DEBUG
+  // In debug mode assert that the linked list is well-formed.
+  DeferredHandles* deferred_iterator = deferred;
+  while (deferred_iterator->previous_ != NULL) {
+    deferred_iterator = deferred_iterator->previous_;
+  }
+  ASSERT(deferred_handles_head_ == deferred_iterator);
+#endif
+  if (deferred_handles_head_ == deferred) {
+    deferred_handles_head_ = deferred_handles_head_->next_;
+  }
+  if (deferred->next_ != NULL) {
+    deferred->next_->previous_ = deferred->previous_;
+  }
+  if (deferred->previous_ != NULL) {
+    deferred->previous_->next_ = deferred->next_;
+  }
+}
+
+
 void Isolate::RegisterTryCatchHandler(v8::TryCatch* that) {
   // The ARM simulator has a separate JS stack.  We therefore register
   // the C++ try catch handler with the simulator and get back an
@@ -582,9 +640,8 @@ Handle<JSArray> Isolate::CaptureCurrentStackTrace(
         // line_number is already shifted by the script_line_offset.
         int relative_line_number = line_number - script_line_offset;
         if (options & StackTrace::kColumnOffset && relative_line_number >= 0) {
-          Handle<FixedArray> line_ends(FixedArray::cast(script->line_ends()));
           int start = (relative_line_number == 0) ? 0 :
-              Smi::cast(line_ends->get(relative_line_number - 1))->value() + 1;
+              GetScriptLineEnd(script, relative_line_number - 1) + 1;
           int column_offset = position - start;
           if (relative_line_number == 0) {
             // For the case where the code is on the same line as the script
@@ -1403,6 +1460,8 @@ Isolate::Isolate()
       preallocated_message_space_(NULL),
       bootstrapper_(NULL),
       runtime_profiler_(NULL),
+      optimizing_compiler_thread_(NULL),
+      feedback_profile_(NULL),
       compilation_cache_(NULL),
       counters_(NULL),
       code_range_(NULL),
@@ -1413,6 +1472,7 @@ Isolate::Isolate()
       debugger_access_(OS::CreateMutex()),
       logger_(NULL),
       stats_table_(NULL),
+      runtime_call_stats_(NULL),
       stub_cache_(NULL),
       deoptimizer_data_(NULL),
       capture_stack_trace_for_uncaught_exceptions_(false),
@@ -1423,8 +1483,13 @@ Isolate::Isolate()
       keyed_lookup_cache_(NULL),
       context_slot_cache_(NULL),
       descriptor_lookup_cache_(NULL),
+      code_stub_lookup_cache_(NULL),
+      instanceof_cache_(NULL),
       handle_scope_implementer_(NULL),
       unicode_cache_(NULL),
+      date_cache_(NULL),
+      zone_segment_pool_(NULL),
+      deferred_handles_head_(NULL),
       in_use_list_(0),
       free_list_(0),
       preallocated_storage_preallocated_(false),
@@ -1519,6 +1584,22 @@ void Isolate::Deinit() {
     // We must stop the logger before we tear down other components.
     logger_->EnsureTickerStopped();
 
+    if (optimizing_compiler_thread_ != NULL) {
+      optimizing_compiler_thread_->Stop();
+      delete optimizing_compiler_thread_;
+      optimizing_compiler_thread_ = NULL;
+    }
+
+    if (FLAG_feedback_profile_save != NULL) {
+      if (feedback_profile_ == NULL) {
+        feedback_profile_ = new FeedbackProfile(this);
+      }
+      feedback_profile_->Record();
+      feedback_profile_->Save(FLAG_feedback_profile_save);
+    }
+    delete feedback_profile_;
+    feedback_profile_ = NULL;
+
     delete deoptimizer_data_;
     deoptimizer_data_ = NULL;
     if (FLAG_preemption) {
@@ -1535,6 +1616,8 @@ void Isolate::Deinit() {
 
     HeapProfiler::TearDown();
     CpuProfiler::TearDown();
+    delete ic_transition_recorder_;
+    ic_transition_recorder_ = NULL;
     if (runtime_profiler_ != NULL) {
       runtime_profiler_->TearDown();
       delete runtime_profiler_;
@@ -1551,16 +1634,26 @@ void Isolate::Deinit() {
 
 void Isolate::SetIsolateThreadLocals(Isolate* isolate,
                                      PerIsolateThreadData* data) {
-  Thread::SetThreadLocal(isolate_key_, isolate);
+  SetCurrentIsolate(isolate);
   Thread::SetThreadLocal(per_isolate_thread_data_key_, data);
 }
 
 
+void Isolate::SetCurrentIsolate(Isolate* isolate) {
+  Thread::SetThreadLocal(isolate_key_, isolate);
+#ifdef V8_THREAD_STORAGE_CLASS_SUPPORTED
+  current_ = isolate;
+#endif
+}
+
+
 Isolate::~Isolate() {
   TRACE_ISOLATE(destructor);
 
   // Has to be called while counters_ are still alive.
   zone_.DeleteKeptSegment();
+  delete zone_segment_pool_;
+  zone_segment_pool_ = NULL;
 
   delete[] assembler_spare_buffer_;
   assembler_spare_buffer_ = NULL;
@@ -1568,9 +1661,16 @@ Isolate::~Isolate() {
   delete unicode_cache_;
   unicode_cache_ = NULL;
 
+  delete date_cache_;
+  date_cache_ = NULL;
+
   delete regexp_stack_;
   regexp_stack_ = NULL;
 
+  delete instanceof_cache_;
+  instanceof_cache_ = NULL;
+  delete code_stub_lookup_cache_;
+  code_stub_lookup_cache_ = NULL;
   delete descriptor_lookup_cache_;
   descriptor_lookup_cache_ = NULL;
   delete context_slot_cache_;
@@ -1584,6 +1684,8 @@ Isolate::~Isolate() {
   stub_cache_ = NULL;
   delete stats_table_;
   stats_table_ = NULL;
+  delete runtime_call_stats_;
+  runtime_call_stats_ = NULL;
 
   delete logger_;
   logger_ = NULL;
@@ -1701,6 +1803,17 @@ bool Isolate::Init(Deserializer* des) {
 
   InitializeLoggingAndCounters();
 
+  if (FLAG_counters_block || FLAG_counters_file != NULL) {
+    // Only the default isolate maps the counters file; other isolates
+    // would otherwise overwrite each other's counters.
+    const char* file_name = IsDefaultIsolate() ? FLAG_counters_file : NULL;
+    if (!stats_table()->EnableCounterBlock(file_name)) {
+      PrintF("Could not map counters file %s\n", file_name);
+      stats_table()->EnableCounterBlock(NULL);
+    }
+    counters_->BindStatsCounters();
+  }
+
   InitializeDebugger();
 
   memory_allocator_ = new MemoryAllocator(this);
@@ -1720,16 +1833,24 @@ bool Isolate::Init(Deserializer* des) {
   string_tracker_->isolate_ = this;
   compilation_cache_ = new CompilationCache(this);
   transcendental_cache_ = new TranscendentalCache();
-  keyed_lookup_cache_ = new KeyedLookupCache();
+  int lookup_cache_length =
+      lookup_cache_size() > 0 ? lookup_cache_size() : FLAG_lookup_cache_size;
+  keyed_lookup_cache_ = new KeyedLookupCache(this, lookup_cache_length);
   context_slot_cache_ = new ContextSlotCache();
-  descriptor_lookup_cache_ = new DescriptorLookupCache();
+  descriptor_lookup_cache_ =
+      new DescriptorLookupCache(this, lookup_cache_length);
+  code_stub_lookup_cache_ = new CodeStubLookupCache();
+  instanceof_cache_ = new InstanceofCache();
   unicode_cache_ = new UnicodeCache();
+  date_cache_ = new DateCache();
+  zone_segment_pool_ = new ZoneSegmentPool(this);
   inner_pointer_to_code_cache_ = new InnerPointerToCodeCache(this);
   write_input_buffer_ = new StringInputBuffer();
   global_handles_ = new GlobalHandles(this);
   bootstrapper_ = new Bootstrapper();
   handle_scope_implementer_ = new HandleScopeImplementer(this);
-  stub_cache_ = new StubCache(this);
+  stub_cache_ = new StubCache(
+      this, stub_cache_size() > 0 ? stub_cache_size() : FLAG_stub_cache_size);
   regexp_stack_ = new RegExpStack();
   regexp_stack_->isolate_ = this;
 
@@ -1807,14 +1928,35 @@ bool Isolate::Init(Deserializer* des) {
   runtime_profiler_ = new RuntimeProfiler(this);
   runtime_profiler_->Setup();
 
+  if (FLAG_concurrent_recompilation) {
+    optimizing_compiler_thread_ = new OptimizingCompilerThread(this);
+    optimizing_compiler_thread_->Start();
+  }
+
+  if (FLAG_feedback_profile_load != NULL) {
+    feedback_profile_ = new FeedbackProfile(this);
+    if (!feedback_profile_->Load(FLAG_feedback_profile_load)) {
+      delete feedback_profile_;
+      feedback_profile_ = NULL;
+    }
+  }
+
   // If we are deserializing, log non-function code objects and compiled
   // functions found in the snapshot.
-  if (des != NULL && (FLAG_log_code || FLAG_ll_prof)) {
+  if (des != NULL && (FLAG_log_code || FLAG_ll_prof ||
+                      FLAG_perf_basic_prof || FLAG_perf_jit_prof)) {
     HandleScope scope;
     LOG(this, LogCodeObjects());
     LOG(this, LogCompiledFunctions());
   }
 
+  heap_.RecordStartupSize();
+  if (FLAG_trace_gc_verbose) {
+    PrintF("Isolate startup heap: %" V8_PTR_PREFIX "d bytes of objects, "
+           "%" V8_PTR_PREFIX "d bytes committed\n",
+           heap_.startup_size(), heap_.startup_committed_memory());
+  }
+
   state_ = INITIALIZED;
   return true;
 }
@@ -1830,6 +1972,14 @@ StatsTable* Isolate::stats_table() {
 }
 
 
+RuntimeCallStats* Isolate::runtime_call_stats() {
+  if (runtime_call_stats_ == NULL) {
+    runtime_call_stats_ = new RuntimeCallStats;
+  }
+  return runtime_call_stats_;
+}
+
+
 void Isolate::Enter() {
   Isolate* current_isolate = NULL;
   PerIsolateThreadData* current_data = CurrentPerIsolateThreadData();
@@ -56,21 +56,28 @@ class ContextSwitcher;
 class Counters;
 class CpuFeatures;
 class CpuProfiler;
+class DateCache;
 class DeoptimizerData;
 class Deserializer;
 class EmptyStatement;
 class ExternalReferenceTable;
 class Factory;
+class DeferredHandles;
+class FeedbackProfile;
 class FunctionInfoListener;
 class HandleScopeImplementer;
 class HeapProfiler;
+class ICTransitionRecorder;
 class InlineRuntimeFunctionsTable;
 class NoAllocationStringAllocator;
 class InnerPointerToCodeCache;
+class OptimizingCompilerThread;
+class ParserFrontEnd;
 class PreallocatedMemoryThread;
 class RegExpStack;
 class SaveContext;
 class UnicodeCache;
+class ZoneSegmentPool;
 class StringInputBuffer;
 class StringTracker;
 class StubCache;
@@ -275,10 +282,6 @@ class ThreadLocalTop BASE_EMBEDDED {
   /* CodeGenerator::EmitNamedStore state */                                    \
   V(int, inlined_write_barrier_size, -1)
 
-#if !defined(__arm__) && !defined(__mips__)
-class HashMap;
-#endif
-
 #else
 
 #define ISOLATE_PLATFORM_INIT_LIST(V)
@@ -356,6 +359,13 @@ typedef List<HeapObject*, PreallocatedStorage> DebugObjectCache;
   V(uint64_t, enabled_cpu_features, 0)                                         \
   V(CpuProfiler*, cpu_profiler, NULL)                                          \
   V(HeapProfiler*, heap_profiler, NULL)                                        \
+  V(ICTransitionRecorder*, ic_transition_recorder, NULL)                       \
+  /* Primary stub cache entries, or 0 to use --stub-cache-size. */            \
+  V(int, stub_cache_size, 0)                                                   \
+  /* Lookup cache entries, or 0 to use --lookup-cache-size. */               \
+  V(int, lookup_cache_size, 0)                                                 \
+  /* Parses scripts of Script::TYPE_FRONT_END, see parser.h. */                \
+  V(ParserFrontEnd*, parser_front_end, NULL)                                   \
   ISOLATE_PLATFORM_INIT_LIST(V)                                                \
   ISOLATE_DEBUGGER_INIT_LIST(V)
 
@@ -440,14 +450,23 @@ class Isolate {
 
   // Returns the isolate inside which the current thread is running.
   INLINE(static Isolate* Current()) {
+#ifdef V8_THREAD_STORAGE_CLASS_SUPPORTED
+    Isolate* isolate = current_;
+    ASSERT(isolate == Thread::GetThreadLocal(isolate_key_));
+#else
     Isolate* isolate = reinterpret_cast<Isolate*>(
         Thread::GetExistingThreadLocal(isolate_key_));
+#endif
     ASSERT(isolate != NULL);
     return isolate;
   }
 
   INLINE(static Isolate* UncheckedCurrent()) {
+#ifdef V8_THREAD_STORAGE_CLASS_SUPPORTED
+    return current_;
+#else
     return reinterpret_cast<Isolate*>(Thread::GetThreadLocal(isolate_key_));
+#endif
   }
 
   // Usually called by Init(), but can be called early e.g. to allow
@@ -739,6 +758,9 @@ class Isolate {
   char* Iterate(ObjectVisitor* v, char* t);
   void IterateThread(ThreadVisitor* v);
   void IterateThread(ThreadVisitor* v, char* t);
+  void IterateDeferredHandles(ObjectVisitor* v);
+  void LinkDeferredHandles(DeferredHandles* deferred_handles);
+  void UnlinkDeferredHandles(DeferredHandles* deferred_handles);
 
 
   // Returns the current global context.
@@ -796,6 +818,12 @@ class Isolate {
   }
   CodeRange* code_range() { return code_range_; }
   RuntimeProfiler* runtime_profiler() { return runtime_profiler_; }
+  // Returns NULL unless --concurrent-recompilation is on.
+  OptimizingCompilerThread* optimizing_compiler_thread() {
+    return optimizing_compiler_thread_;
+  }
+  // Returns NULL unless a profile was loaded with --feedback-profile-load.
+  FeedbackProfile* feedback_profile() { return feedback_profile_; }
   CompilationCache* compilation_cache() { return compilation_cache_; }
   Logger* logger() {
     // Call InitializeLoggingAndCounters() if logging is needed before
@@ -806,6 +834,7 @@ class Isolate {
   StackGuard* stack_guard() { return &stack_guard_; }
   Heap* heap() { return &heap_; }
   StatsTable* stats_table();
+  RuntimeCallStats* runtime_call_stats();
   StubCache* stub_cache() { return stub_cache_; }
   DeoptimizerData* deoptimizer_data() { return deoptimizer_data_; }
   ThreadLocalTop* thread_local_top() { return &thread_local_top_; }
@@ -830,6 +859,14 @@ class Isolate {
     return descriptor_lookup_cache_;
   }
 
+  CodeStubLookupCache* code_stub_lookup_cache() {
+    return code_stub_lookup_cache_;
+  }
+
+  InstanceofCache* instanceof_cache() {
+    return instanceof_cache_;
+  }
+
   v8::ImplementationUtilities::HandleScopeData* handle_scope_data() {
     return &handle_scope_data_;
   }
@@ -837,12 +874,33 @@ class Isolate {
     ASSERT(handle_scope_implementer_);
     return handle_scope_implementer_;
   }
-  Zone* zone() { return &zone_; }
+  // Returns the zone that zone allocations of the current thread go to.
+  // This is the isolate's own zone, except while a function is compiled for
+  // or by the optimizing compiler thread (see SetThreadZone).
+  Zone* zone() {
+    if (optimizing_compiler_thread_ != NULL) {
+      Zone* zone = reinterpret_cast<Zone*>(Thread::GetThreadLocal(zone_key_));
+      if (zone != NULL) return zone;
+    }
+    return &zone_;
+  }
+
+  // Redirects the zone allocations of the current thread to the given zone.
+  // Passing NULL directs them back to the zone of the isolate.
+  static void SetThreadZone(Zone* zone) {
+    Thread::SetThreadLocal(zone_key_, zone);
+  }
 
   UnicodeCache* unicode_cache() {
     return unicode_cache_;
   }
 
+  DateCache* date_cache() {
+    return date_cache_;
+  }
+
+  ZoneSegmentPool* zone_segment_pool() { return zone_segment_pool_; }
+
   InnerPointerToCodeCache* inner_pointer_to_code_cache() {
     return inner_pointer_to_code_cache_;
   }
@@ -929,6 +987,9 @@ class Isolate {
 #endif
 
   inline bool DebuggerHasBreakPoints();
+  // Whether the debugger keeps shared from being optimized or inlined,
+  // because it has break points or all functions are prepared for stepping.
+  inline bool DebuggerNeedsFullCode(SharedFunctionInfo* shared);
 
 #ifdef DEBUG
   HistogramInfo* heap_histograms() { return heap_histograms_; }
@@ -1060,7 +1121,12 @@ class Isolate {
 
   static Thread::LocalStorageKey per_isolate_thread_data_key_;
   static Thread::LocalStorageKey isolate_key_;
+#ifdef V8_THREAD_STORAGE_CLASS_SUPPORTED
+  // Mirrors the value stored under isolate_key_ for faster access.
+  static __thread Isolate* current_;
+#endif
   static Thread::LocalStorageKey thread_id_key_;
+  static Thread::LocalStorageKey zone_key_;
   static Isolate* default_isolate_;
   static ThreadDataTable* thread_data_table_;
 
@@ -1068,6 +1134,7 @@ class Isolate {
 
   static void SetIsolateThreadLocals(Isolate* isolate,
                                      PerIsolateThreadData* data);
+  static void SetCurrentIsolate(Isolate* isolate);
 
   enum State {
     UNINITIALIZED,    // Some components may not have been allocated.
@@ -1125,6 +1192,8 @@ class Isolate {
 
   Bootstrapper* bootstrapper_;
   RuntimeProfiler* runtime_profiler_;
+  OptimizingCompilerThread* optimizing_compiler_thread_;
+  FeedbackProfile* feedback_profile_;
   CompilationCache* compilation_cache_;
   Counters* counters_;
   CodeRange* code_range_;
@@ -1135,6 +1204,7 @@ class Isolate {
   Logger* logger_;
   StackGuard stack_guard_;
   StatsTable* stats_table_;
+  RuntimeCallStats* runtime_call_stats_;
   StubCache* stub_cache_;
   DeoptimizerData* deoptimizer_data_;
   ThreadLocalTop thread_local_top_;
@@ -1146,10 +1216,16 @@ class Isolate {
   KeyedLookupCache* keyed_lookup_cache_;
   ContextSlotCache* context_slot_cache_;
   DescriptorLookupCache* descriptor_lookup_cache_;
+  CodeStubLookupCache* code_stub_lookup_cache_;
+  InstanceofCache* instanceof_cache_;
   v8::ImplementationUtilities::HandleScopeData handle_scope_data_;
   HandleScopeImplementer* handle_scope_implementer_;
   UnicodeCache* unicode_cache_;
+  DateCache* date_cache_;
+  ZoneSegmentPool* zone_segment_pool_;
   Zone zone_;
+  // Handles that outlive their handle scope, see DeferredHandleScope.
+  DeferredHandles* deferred_handles_head_;
   PreallocatedStorage in_use_list_;
   PreallocatedStorage free_list_;
   bool preallocated_storage_preallocated_;
@@ -1218,6 +1294,12 @@ class Isolate {
   friend class ExecutionAccess;
   friend class IsolateInitializer;
   friend class ThreadManager;
+  friend class OptimizingCompilerThread;
+  friend class ScavengerThread;
+  friend class EvacuationThread;
+  friend class MarkingThread;
+  friend class SweeperThread;
+  friend class SweeperTask;
   friend class Simulator;
   friend class StackGuard;
   friend class ThreadId;
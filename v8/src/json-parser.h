@@ -39,8 +39,11 @@
 namespace v8 {
 namespace internal {
 
-// A simple json parser.
-template <bool seq_ascii>
+// A simple json parser.  The seq_ascii variant reads characters directly
+// out of a sequential ASCII string, or, together with external_ascii, out
+// of the resource of an external ASCII string so that embedder-provided
+// buffers are parsed without copying them into the heap.
+template <bool seq_ascii, bool external_ascii = false>
 class JsonParser BASE_EMBEDDED {
  public:
   static Handle<Object> Parse(Handle<String> source) {
@@ -58,7 +61,7 @@ class JsonParser BASE_EMBEDDED {
     if (position_ >= source_length_) {
       c0_ = kEndOfString;
     } else if (seq_ascii) {
-      c0_ = seq_source_->SeqAsciiStringGet(position_);
+      c0_ = AsciiCharAt(position_);
     } else {
       c0_ = source_->Get(position_);
     }
@@ -68,6 +71,21 @@ class JsonParser BASE_EMBEDDED {
   // section 15.12.1.1. The only allowed whitespace characters between tokens
   // are tab, carriage-return, newline and space.
 
+  // Only valid for the seq_ascii variant.  Characters of an external
+  // string do not move during GC, so they are read through the resource
+  // pointer; a sequential string is re-read through its handle.
+  inline uc32 AsciiCharAt(int index) {
+    if (external_ascii) {
+      return static_cast<unsigned char>(external_chars_[index]);
+    }
+    return seq_source_->SeqAsciiStringGet(index);
+  }
+
+  inline const char* AsciiChars() {
+    if (external_ascii) return external_chars_;
+    return seq_source_->GetChars();
+  }
+
   inline void AdvanceSkipWhitespace() {
     do {
       Advance();
@@ -148,6 +166,43 @@ class JsonParser BASE_EMBEDDED {
     return Handle<Object>::null();
   }
 
+  // Arrays of records usually repeat the same keys in the same order, so
+  // the parser remembers, per nesting depth and property position, the map
+  // transition the last object took: the map before the property was added,
+  // the key symbol, the map after it and the field the value went into.
+  // When the next object at that position still has the same map and the
+  // source spells out the same key, the key is taken from the cache without
+  // a symbol table lookup and the value is stored directly into the field.
+  static const int kTransitionCacheSize = 64;
+  static const int kTransitionBeforeMap = 0;
+  static const int kTransitionKey = 1;
+  static const int kTransitionAfterMap = 2;
+  static const int kTransitionFieldIndex = 3;
+  static const int kTransitionEntrySize = 4;
+
+  inline int TransitionCacheSlot(int ordinal) {
+    return ((object_depth_ * 7 + ordinal) & (kTransitionCacheSize - 1)) *
+        kTransitionEntrySize;
+  }
+
+  // Returns the cached key for the entry if json_object still has the map
+  // it was recorded for and the source at the current '"' spells it out,
+  // consuming the key.  Returns a null handle otherwise.
+  Handle<String> MatchCachedKey(Handle<JSObject> json_object, int slot);
+
+  // Stores the value into the cached field when the key is the cached one
+  // and the object has room for it without allocating.
+  bool AddCachedProperty(Handle<JSObject> json_object,
+                         Handle<String> key,
+                         Handle<Object> value,
+                         int slot);
+
+  // Records the transition json_object took when key was added to it.
+  void RecordTransition(Handle<JSObject> json_object,
+                        Handle<Map> before_map,
+                        Handle<String> key,
+                        int slot);
+
   inline Isolate* isolate() { return isolate_; }
 
   static const int kInitialSpecialStringLength = 1024;
@@ -157,23 +212,32 @@ class JsonParser BASE_EMBEDDED {
   Handle<String> source_;
   int source_length_;
   Handle<SeqAsciiString> seq_source_;
+  const char* external_chars_;
+  Handle<FixedArray> transition_cache_;
+  int object_depth_;
 
   Isolate* isolate_;
   uc32 c0_;
   int position_;
 };
 
-template <bool seq_ascii>
-Handle<Object> JsonParser<seq_ascii>::ParseJson(Handle<String> source) {
+template <bool seq_ascii, bool external_ascii>
+Handle<Object> JsonParser<seq_ascii, external_ascii>::ParseJson(
+    Handle<String> source) {
   isolate_ = source->map()->GetHeap()->isolate();
   FlattenString(source);
   source_ = source;
   source_length_ = source_->length();
 
   // Optimized fast case where we only have ASCII characters.
-  if (seq_ascii) {
+  external_chars_ = NULL;
+  if (external_ascii) {
+    ASSERT(seq_ascii);
+    external_chars_ = ExternalAsciiString::cast(*source_)->GetChars();
+  } else if (seq_ascii) {
     seq_source_ = Handle<SeqAsciiString>::cast(source_);
   }
+  object_depth_ = 0;
 
   // Set initial position right before the string.
   position_ = -1;
@@ -231,8 +295,8 @@ Handle<Object> JsonParser<seq_ascii>::ParseJson(Handle<String> source) {
 
 
 // Parse any JSON value.
-template <bool seq_ascii>
-Handle<Object> JsonParser<seq_ascii>::ParseJsonValue() {
+template <bool seq_ascii, bool external_ascii>
+Handle<Object> JsonParser<seq_ascii, external_ascii>::ParseJsonValue() {
   switch (c0_) {
     case '"':
       return ParseJsonString();
@@ -283,44 +347,141 @@ Handle<Object> JsonParser<seq_ascii>::ParseJsonValue() {
 
 
 // Parse a JSON object. Position must be right at '{'.
-template <bool seq_ascii>
-Handle<Object> JsonParser<seq_ascii>::ParseJsonObject() {
+template <bool seq_ascii, bool external_ascii>
+Handle<Object> JsonParser<seq_ascii, external_ascii>::ParseJsonObject() {
   Handle<JSFunction> object_constructor(
       isolate()->global_context()->object_function());
   Handle<JSObject> json_object =
       isolate()->factory()->NewJSObject(object_constructor);
   ASSERT_EQ(c0_, '{');
+  if (transition_cache_.is_null()) {
+    transition_cache_ = isolate()->factory()->NewFixedArray(
+        kTransitionCacheSize * kTransitionEntrySize);
+  }
 
   AdvanceSkipWhitespace();
   if (c0_ != '}') {
+    object_depth_++;
+    int ordinal = 0;
     do {
       if (c0_ != '"') return ReportUnexpectedCharacter();
-      Handle<String> key = ParseJsonSymbol();
+      int slot = TransitionCacheSlot(ordinal++);
+      Handle<String> key = MatchCachedKey(json_object, slot);
+      if (key.is_null()) key = ParseJsonSymbol();
       if (key.is_null() || c0_ != ':') return ReportUnexpectedCharacter();
       AdvanceSkipWhitespace();
+      Handle<Map> before_map(json_object->map());
       Handle<Object> value = ParseJsonValue();
       if (value.is_null()) return ReportUnexpectedCharacter();
 
       uint32_t index;
-      if (key->AsArrayIndex(&index)) {
+      if (AddCachedProperty(json_object, key, value, slot)) {
+        // Stored along the cached transition.
+      } else if (key->AsArrayIndex(&index)) {
         SetOwnElement(json_object, index, value, kNonStrictMode);
       } else if (key->Equals(isolate()->heap()->Proto_symbol())) {
         SetPrototype(json_object, value);
       } else {
         SetLocalPropertyIgnoreAttributes(json_object, key, value, NONE);
+        RecordTransition(json_object, before_map, key, slot);
       }
     } while (MatchSkipWhiteSpace(','));
     if (c0_ != '}') {
       return ReportUnexpectedCharacter();
     }
+    object_depth_--;
   }
   AdvanceSkipWhitespace();
   return json_object;
 }
 
+
+template <bool seq_ascii, bool external_ascii>
+Handle<String> JsonParser<seq_ascii, external_ascii>::MatchCachedKey(
+    Handle<JSObject> json_object, int slot) {
+  ASSERT_EQ('"', c0_);
+  if (!seq_ascii) return Handle<String>::null();
+  FixedArray* cache = *transition_cache_;
+  if (cache->get(slot + kTransitionBeforeMap) != json_object->map()) {
+    return Handle<String>::null();
+  }
+  // Only keys without escapes or non-ASCII characters are recorded, so a
+  // matching key appears verbatim in the source.
+  SeqAsciiString* key = SeqAsciiString::cast(cache->get(slot + kTransitionKey));
+  int length = key->length();
+  int start = position_ + 1;
+  if (start + length >= source_length_) return Handle<String>::null();
+  const char* chars = AsciiChars() + start;
+  if (chars[length] != '"' ||
+      memcmp(chars, key->GetChars(), length) != 0) {
+    return Handle<String>::null();
+  }
+  position_ = start + length;
+  c0_ = '"';
+  AdvanceSkipWhitespace();
+  return Handle<String>(key);
+}
+
+
+template <bool seq_ascii, bool external_ascii>
+bool JsonParser<seq_ascii, external_ascii>::AddCachedProperty(
+    Handle<JSObject> json_object,
+    Handle<String> key,
+    Handle<Object> value,
+    int slot) {
+  FixedArray* cache = *transition_cache_;
+  Map* map = json_object->map();
+  if (cache->get(slot + kTransitionBeforeMap) != map ||
+      cache->get(slot + kTransitionKey) != *key ||
+      map->unused_property_fields() == 0) {
+    return false;
+  }
+  Map* after_map = Map::cast(cache->get(slot + kTransitionAfterMap));
+  int field_index =
+      Smi::cast(cache->get(slot + kTransitionFieldIndex))->value();
+  json_object->set_map(after_map);
+  json_object->FastPropertyAtPut(field_index, *value);
+  return true;
+}
+
+
+template <bool seq_ascii, bool external_ascii>
+void JsonParser<seq_ascii, external_ascii>::RecordTransition(
+    Handle<JSObject> json_object,
+    Handle<Map> before_map,
+    Handle<String> key,
+    int slot) {
+  Map* after_map = json_object->map();
+  if (after_map == *before_map ||
+      !json_object->HasFastProperties() ||
+      !key->IsSymbol() ||
+      !key->IsSeqAsciiString()) {
+    return;
+  }
+  SeqAsciiString* ascii_key = SeqAsciiString::cast(*key);
+  const char* chars = ascii_key->GetChars();
+  for (int i = 0; i < ascii_key->length(); i++) {
+    char c = chars[i];
+    if (c < 0x20 || c == '"' || c == '\\') return;
+  }
+  LookupResult result(isolate());
+  after_map->LookupInDescriptors(*json_object, *key, &result);
+  if (!result.IsFound() ||
+      result.type() != FIELD ||
+      result.GetAttributes() != NONE) {
+    return;
+  }
+  FixedArray* cache = *transition_cache_;
+  cache->set(slot + kTransitionBeforeMap, *before_map);
+  cache->set(slot + kTransitionKey, *key);
+  cache->set(slot + kTransitionAfterMap, after_map);
+  cache->set(slot + kTransitionFieldIndex,
+             Smi::FromInt(result.GetFieldIndex()));
+}
+
 // Parse a JSON array. Position must be right at '['.
-template <bool seq_ascii>
-Handle<Object> JsonParser<seq_ascii>::ParseJsonArray() {
+template <bool seq_ascii, bool external_ascii>
+Handle<Object> JsonParser<seq_ascii, external_ascii>::ParseJsonArray() {
   ZoneScope zone_scope(isolate(), DELETE_ON_EXIT);
   ZoneList<Handle<Object> > elements(4);
   ASSERT_EQ(c0_, '[');
@@ -347,8 +508,8 @@ Handle<Object> JsonParser<seq_ascii>::ParseJsonArray() {
 }
 
 
-template <bool seq_ascii>
-Handle<Object> JsonParser<seq_ascii>::ParseJsonNumber() {
+template <bool seq_ascii, bool external_ascii>
+Handle<Object> JsonParser<seq_ascii, external_ascii>::ParseJsonNumber() {
   bool negative = false;
   int beg_pos = position_;
   if (c0_ == '-') {
@@ -392,7 +553,7 @@ Handle<Object> JsonParser<seq_ascii>::ParseJsonNumber() {
   int length = position_ - beg_pos;
   double number;
   if (seq_ascii) {
-    Vector<const char> chars(seq_source_->GetChars() +  beg_pos, length);
+    Vector<const char> chars(AsciiChars() + beg_pos, length);
     number = StringToDouble(isolate()->unicode_cache(),
                              chars,
                              NO_FLAGS,  // Hex, octal or trailing junk.
@@ -444,9 +605,9 @@ inline Handle<SeqAsciiString> NewRawString(Factory* factory, int length) {
 // Scans the rest of a JSON string starting from position_ and writes
 // prefix[start..end] along with the scanned characters into a
 // sequential string of type StringType.
-template <bool seq_ascii>
+template <bool seq_ascii, bool external_ascii>
 template <typename StringType, typename SinkChar>
-Handle<String> JsonParser<seq_ascii>::SlowScanJsonString(
+Handle<String> JsonParser<seq_ascii, external_ascii>::SlowScanJsonString(
     Handle<String> prefix, int start, int end) {
   int count = end - start;
   int max_length = count + source_length_ - position_;
@@ -539,6 +700,7 @@ Handle<String> JsonParser<seq_ascii>::SlowScanJsonString(
     int allocated_string_size = StringType::SizeFor(length);
     int delta = allocated_string_size - string_size;
     Address start_filler_object = seq_str->address() + string_size;
+    isolate()->heap()->EnsureSweptBeforeResizing(*seq_str);
     seq_str->set_length(count);
     isolate()->heap()->CreateFillerObjectAt(start_filler_object, delta);
   }
@@ -549,9 +711,9 @@ Handle<String> JsonParser<seq_ascii>::SlowScanJsonString(
 }
 
 
-template <bool seq_ascii>
+template <bool seq_ascii, bool external_ascii>
 template <bool is_symbol>
-Handle<String> JsonParser<seq_ascii>::ScanJsonString() {
+Handle<String> JsonParser<seq_ascii, external_ascii>::ScanJsonString() {
   ASSERT_EQ('"', c0_);
   Advance();
   if (c0_ == '"') {
@@ -580,9 +742,14 @@ Handle<String> JsonParser<seq_ascii>::ScanJsonString() {
   int length = position_ - beg_pos;
   Handle<String> result;
   if (seq_ascii && is_symbol) {
-    result = isolate()->factory()->LookupAsciiSymbol(seq_source_,
-                                                     beg_pos,
-                                                     length);
+    if (external_ascii) {
+      Vector<const char> chars(external_chars_ + beg_pos, length);
+      result = isolate()->factory()->LookupAsciiSymbol(chars);
+    } else {
+      result = isolate()->factory()->LookupAsciiSymbol(seq_source_,
+                                                       beg_pos,
+                                                       length);
+    }
   } else {
     result = isolate()->factory()->NewRawAsciiString(length);
     char* dest = SeqAsciiString::cast(*result)->GetChars();
@@ -108,6 +108,32 @@ static inline void ThrowRegExpException(Handle<JSRegExp> re,
 }
 
 
+// Returns the atom that every match of the tree must start with, or NULL if
+// the tree does not start with a non-empty literal.
+static RegExpAtom* LiteralPrefix(RegExpTree* tree) {
+  while (true) {
+    if (tree->IsAtom()) {
+      RegExpAtom* atom = tree->AsAtom();
+      return atom->length() > 0 ? atom : NULL;
+    } else if (tree->IsText()) {
+      ZoneList<TextElement>* elements = tree->AsText()->elements();
+      if (elements->is_empty()) return NULL;
+      TextElement first = elements->at(0);
+      if (first.type != TextElement::ATOM) return NULL;
+      tree = first.data.u_atom;
+    } else if (tree->IsAlternative()) {
+      ZoneList<RegExpTree*>* nodes = tree->AsAlternative()->nodes();
+      if (nodes->is_empty()) return NULL;
+      tree = nodes->at(0);
+    } else if (tree->IsCapture()) {
+      tree = tree->AsCapture()->body();
+    } else {
+      return NULL;
+    }
+  }
+}
+
+
 // Generic RegExp methods. Dispatches to implementation specific methods.
 
 
@@ -153,7 +179,16 @@ Handle<Object> RegExpImpl::Compile(Handle<JSRegExp> re,
         isolate->factory()->NewStringFromTwoByte(atom_pattern);
     AtomCompile(re, pattern, flags, atom_string);
   } else {
-    IrregexpInitialize(re, pattern, flags, parse_result.capture_count);
+    Handle<String> literal_prefix;
+    if (!flags.is_ignore_case()) {
+      RegExpAtom* prefix = LiteralPrefix(parse_result.tree);
+      if (prefix != NULL) {
+        literal_prefix =
+            isolate->factory()->NewStringFromTwoByte(prefix->data());
+      }
+    }
+    IrregexpInitialize(re, pattern, flags, parse_result.capture_count,
+                       literal_prefix);
   }
   ASSERT(re->data()->IsFixedArray());
   // Compilation succeeded so the data is set on the regexp
@@ -213,14 +248,42 @@ static void SetAtomLastCapture(FixedArray* array,
 }
 
 
-Handle<Object> RegExpImpl::AtomExec(Handle<JSRegExp> re,
-                                    Handle<String> subject,
-                                    int index,
-                                    Handle<JSArray> last_match_info) {
+// Collects up to max_matches non-overlapping occurrences of the pattern
+// at or after index, storing start and end of each into output.
+template <typename SubjectChar, typename PatternChar>
+static int AtomSearchBatch(Isolate* isolate,
+                           Vector<const SubjectChar> subject,
+                           Vector<const PatternChar> pattern,
+                           int index,
+                           int32_t* output,
+                           int max_matches) {
+  StringSearch<PatternChar, SubjectChar> search(isolate, pattern);
+  int pattern_length = pattern.length();
+  int subject_length = subject.length();
+  int matches = 0;
+  while (matches < max_matches &&
+         index + pattern_length <= subject_length) {
+    index = search.Search(subject, index);
+    if (index == -1) break;
+    output[matches * 2] = index;
+    output[matches * 2 + 1] = index + pattern_length;
+    matches++;
+    index += pattern_length;
+  }
+  return matches;
+}
+
+
+int RegExpImpl::AtomExecRaw(Handle<JSRegExp> re,
+                            Handle<String> subject,
+                            int index,
+                            int32_t* output,
+                            int max_matches) {
   Isolate* isolate = re->GetIsolate();
 
   ASSERT(0 <= index);
   ASSERT(index <= subject->length());
+  ASSERT(max_matches > 0);
 
   if (!subject->IsFlat()) FlattenString(subject);
   AssertNoAllocation no_heap_allocation;  // ensure vectors stay valid
@@ -229,43 +292,57 @@ Handle<Object> RegExpImpl::AtomExec(Handle<JSRegExp> re,
   int needle_len = needle->length();
   ASSERT(needle->IsFlat());
 
-  if (needle_len != 0) {
-    if (index + needle_len > subject->length()) {
-      return isolate->factory()->null_value();
+  if (needle_len == 0) {
+    // The empty pattern matches at every position.
+    int matches = Min(max_matches, subject->length() - index + 1);
+    for (int i = 0; i < matches; i++) {
+      output[i * 2] = index + i;
+      output[i * 2 + 1] = index + i;
     }
+    return matches;
+  }
 
-    String::FlatContent needle_content = needle->GetFlatContent();
-    String::FlatContent subject_content = subject->GetFlatContent();
-    ASSERT(needle_content.IsFlat());
-    ASSERT(subject_content.IsFlat());
-    // dispatch on type of strings
-    index = (needle_content.IsAscii()
-             ? (subject_content.IsAscii()
-                ? SearchString(isolate,
+  String::FlatContent needle_content = needle->GetFlatContent();
+  String::FlatContent subject_content = subject->GetFlatContent();
+  ASSERT(needle_content.IsFlat());
+  ASSERT(subject_content.IsFlat());
+  // dispatch on type of strings
+  return (needle_content.IsAscii()
+          ? (subject_content.IsAscii()
+             ? AtomSearchBatch(isolate,
                                subject_content.ToAsciiVector(),
                                needle_content.ToAsciiVector(),
-                               index)
-                : SearchString(isolate,
+                               index, output, max_matches)
+             : AtomSearchBatch(isolate,
                                subject_content.ToUC16Vector(),
                                needle_content.ToAsciiVector(),
-                               index))
-             : (subject_content.IsAscii()
-                ? SearchString(isolate,
+                               index, output, max_matches))
+          : (subject_content.IsAscii()
+             ? AtomSearchBatch(isolate,
                                subject_content.ToAsciiVector(),
                                needle_content.ToUC16Vector(),
-                               index)
-                : SearchString(isolate,
+                               index, output, max_matches)
+             : AtomSearchBatch(isolate,
                                subject_content.ToUC16Vector(),
                                needle_content.ToUC16Vector(),
-                               index)));
-    if (index == -1) return isolate->factory()->null_value();
+                               index, output, max_matches)));
+}
+
+
+Handle<Object> RegExpImpl::AtomExec(Handle<JSRegExp> re,
+                                    Handle<String> subject,
+                                    int index,
+                                    Handle<JSArray> last_match_info) {
+  int32_t match[2];
+  if (AtomExecRaw(re, subject, index, match, 1) == 0) {
+    return re->GetIsolate()->factory()->null_value();
   }
   ASSERT(last_match_info->HasFastElements());
 
   {
     NoHandleAllocation no_handles;
     FixedArray* array = FixedArray::cast(last_match_info->elements());
-    SetAtomLastCapture(array, *subject, index, index + needle_len);
+    SetAtomLastCapture(array, *subject, match[0], match[1]);
   }
   return last_match_info;
 }
@@ -295,10 +372,41 @@ bool RegExpImpl::EnsureCompiledIrregexp(Handle<JSRegExp> re, bool is_ascii) {
     ASSERT(compiled_code->IsSmi());
     return true;
   }
-  return CompileIrregexp(re, is_ascii);
+#ifdef V8_INTERPRETED_REGEXP
+  return CompileIrregexp(re, is_ascii, true);
+#else
+  if (!CompileIrregexp(re, is_ascii, false)) return false;
+  // The bytecode is no longer needed once the regexp runs native code.
+  re->SetDataAt(JSRegExp::bytecode_index(is_ascii),
+                Smi::FromInt(JSRegExp::kUninitializedValue));
+  return true;
+#endif
 }
 
 
+#ifndef V8_INTERPRETED_REGEXP
+bool RegExpImpl::EnsureBytecodeIrregexp(Handle<JSRegExp> re, bool is_ascii) {
+  Object* bytecode = re->DataAt(JSRegExp::bytecode_index(is_ascii));
+  if (bytecode->IsByteArray()) return true;
+  return CompileIrregexp(re, is_ascii, true);
+}
+
+
+void RegExpImpl::IrregexpCountExecution(FixedArray* re, int subject_length) {
+  int executions =
+      Smi::cast(re->get(JSRegExp::kIrregexpExecutionCountIndex))->value();
+  int length =
+      Smi::cast(re->get(JSRegExp::kIrregexpSubjectLengthIndex))->value();
+  // Saturate at the limits, which also keeps the counts in smi range.
+  executions = Min(executions + 1, FLAG_regexp_tier_up_executions);
+  length = Min(length + Min(subject_length, FLAG_regexp_tier_up_subject_length),
+               FLAG_regexp_tier_up_subject_length);
+  re->set(JSRegExp::kIrregexpExecutionCountIndex, Smi::FromInt(executions));
+  re->set(JSRegExp::kIrregexpSubjectLengthIndex, Smi::FromInt(length));
+}
+#endif  // V8_INTERPRETED_REGEXP
+
+
 static bool CreateRegExpErrorObjectAndThrow(Handle<JSRegExp> re,
                                             bool is_ascii,
                                             Handle<String> error_message,
@@ -315,7 +423,9 @@ static bool CreateRegExpErrorObjectAndThrow(Handle<JSRegExp> re,
 }
 
 
-bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re, bool is_ascii) {
+bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
+                                 bool is_ascii,
+                                 bool is_bytecode) {
   // Compile the RegExp.
   Isolate* isolate = re->GetIsolate();
   ZoneScope zone_scope(isolate, DELETE_ON_EXIT);
@@ -364,7 +474,10 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re, bool is_ascii) {
                             flags.is_ignore_case(),
                             flags.is_multiline(),
                             pattern,
-                            is_ascii);
+                            is_ascii,
+                            is_bytecode);
+  isolate->zone()->RecordHighWaterMark(
+      isolate->counters()->zone_regexp_high_water_mark());
   if (result.error_message != NULL) {
     // Unable to compile regexp.
     Handle<String> error_message =
@@ -374,7 +487,11 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re, bool is_ascii) {
   }
 
   Handle<FixedArray> data = Handle<FixedArray>(FixedArray::cast(re->data()));
-  data->set(JSRegExp::code_index(is_ascii), result.code);
+  if (is_bytecode && UsesNativeRegExp()) {
+    data->set(JSRegExp::bytecode_index(is_ascii), result.code);
+  } else {
+    data->set(JSRegExp::code_index(is_ascii), result.code);
+  }
   int register_max = IrregexpMaxRegisterCount(*data);
   if (result.num_registers > register_max) {
     SetIrregexpMaxRegisterCount(*data, result.num_registers);
@@ -406,7 +523,11 @@ int RegExpImpl::IrregexpNumberOfRegisters(FixedArray* re) {
 
 
 ByteArray* RegExpImpl::IrregexpByteCode(FixedArray* re, bool is_ascii) {
+#ifdef V8_INTERPRETED_REGEXP
   return ByteArray::cast(re->get(JSRegExp::code_index(is_ascii)));
+#else
+  return ByteArray::cast(re->get(JSRegExp::bytecode_index(is_ascii)));
+#endif
 }
 
 
@@ -415,16 +536,80 @@ Code* RegExpImpl::IrregexpNativeCode(FixedArray* re, bool is_ascii) {
 }
 
 
+bool RegExpImpl::IrregexpUsesNativeCode(FixedArray* re) {
+#ifdef V8_INTERPRETED_REGEXP
+  return false;
+#else
+  if (!FLAG_regexp_tier_up) return true;
+  // Code compiled while the regexp was hot stays in use, even if the
+  // flags have changed since.
+  if (re->get(JSRegExp::code_index(true))->IsCode() ||
+      re->get(JSRegExp::code_index(false))->IsCode() ||
+      re->get(JSRegExp::saved_code_index(true))->IsCode() ||
+      re->get(JSRegExp::saved_code_index(false))->IsCode()) {
+    return true;
+  }
+  return Smi::cast(re->get(JSRegExp::kIrregexpExecutionCountIndex))->value()
+             >= FLAG_regexp_tier_up_executions ||
+         Smi::cast(re->get(JSRegExp::kIrregexpSubjectLengthIndex))->value()
+             >= FLAG_regexp_tier_up_subject_length;
+#endif
+}
+
+
 void RegExpImpl::IrregexpInitialize(Handle<JSRegExp> re,
                                     Handle<String> pattern,
                                     JSRegExp::Flags flags,
-                                    int capture_count) {
+                                    int capture_count,
+                                    Handle<String> literal_prefix) {
   // Initialize compiled code entries to null.
   re->GetIsolate()->factory()->SetRegExpIrregexpData(re,
                                                      JSRegExp::IRREGEXP,
                                                      pattern,
                                                      flags,
-                                                     capture_count);
+                                                     capture_count,
+                                                     literal_prefix);
+}
+
+
+// Advances index to the next occurrence of the regexp's literal prefix.
+// Returns false if there is none, in which case the regexp cannot match
+// at or after index.
+static bool SkipToLiteralPrefix(Isolate* isolate,
+                                FixedArray* irregexp,
+                                String* subject,
+                                int* index) {
+  Object* prefix_object = irregexp->get(JSRegExp::kIrregexpLiteralPrefixIndex);
+  if (prefix_object->IsSmi()) return true;
+  String* prefix = String::cast(prefix_object);
+  if (*index + prefix->length() > subject->length()) return false;
+  AssertNoAllocation no_heap_allocation;  // ensure vectors stay valid
+  String::FlatContent prefix_content = prefix->GetFlatContent();
+  String::FlatContent subject_content = subject->GetFlatContent();
+  ASSERT(prefix_content.IsFlat());
+  ASSERT(subject_content.IsFlat());
+  int found = (prefix_content.IsAscii()
+               ? (subject_content.IsAscii()
+                  ? SearchString(isolate,
+                                 subject_content.ToAsciiVector(),
+                                 prefix_content.ToAsciiVector(),
+                                 *index)
+                  : SearchString(isolate,
+                                 subject_content.ToUC16Vector(),
+                                 prefix_content.ToAsciiVector(),
+                                 *index))
+               : (subject_content.IsAscii()
+                  ? SearchString(isolate,
+                                 subject_content.ToAsciiVector(),
+                                 prefix_content.ToUC16Vector(),
+                                 *index)
+                  : SearchString(isolate,
+                                 subject_content.ToUC16Vector(),
+                                 prefix_content.ToUC16Vector(),
+                                 *index)));
+  if (found == -1) return false;
+  *index = found;
+  return true;
 }
 
 
@@ -434,16 +619,24 @@ int RegExpImpl::IrregexpPrepare(Handle<JSRegExp> regexp,
 
   // Check the asciiness of the underlying storage.
   bool is_ascii = subject->IsAsciiRepresentationUnderneath();
+
+#ifndef V8_INTERPRETED_REGEXP
+  if (IrregexpUsesNativeCode(FixedArray::cast(regexp->data()))) {
+    if (!EnsureCompiledIrregexp(regexp, is_ascii)) return -1;
+    // Native regexp only needs room to output captures. Registers are
+    // handled internally.
+    return (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
+  }
+  // The regexp is still cold, so interpret it rather than spending the
+  // time to compile it to native code.
+  if (!EnsureBytecodeIrregexp(regexp, is_ascii)) return -1;
+  IrregexpCountExecution(FixedArray::cast(regexp->data()), subject->length());
+#else  // V8_INTERPRETED_REGEXP
   if (!EnsureCompiledIrregexp(regexp, is_ascii)) return -1;
+#endif  // V8_INTERPRETED_REGEXP
 
-#ifdef V8_INTERPRETED_REGEXP
   // Byte-code regexp needs space allocated for all its registers.
   return IrregexpNumberOfRegisters(FixedArray::cast(regexp->data()));
-#else  // V8_INTERPRETED_REGEXP
-  // Native regexp only needs room to output captures. Registers are handled
-  // internally.
-  return (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
-#endif  // V8_INTERPRETED_REGEXP
 }
 
 
@@ -462,45 +655,58 @@ RegExpImpl::IrregexpResult RegExpImpl::IrregexpExecOnce(
 
   bool is_ascii = subject->IsAsciiRepresentationUnderneath();
 
+  // Every match starts with the literal prefix, so the generated code only
+  // needs to be entered at its occurrences.
+  if (!SkipToLiteralPrefix(isolate, *irregexp, *subject, &index)) {
+    return RE_FAILURE;
+  }
+
 #ifndef V8_INTERPRETED_REGEXP
-  ASSERT(output.length() >= (IrregexpNumberOfCaptures(*irregexp) + 1) * 2);
-  do {
-    EnsureCompiledIrregexp(regexp, is_ascii);
-    Handle<Code> code(IrregexpNativeCode(*irregexp, is_ascii), isolate);
-    NativeRegExpMacroAssembler::Result res =
-        NativeRegExpMacroAssembler::Match(code,
-                                          subject,
-                                          output.start(),
-                                          output.length(),
-                                          index,
-                                          isolate);
-    if (res != NativeRegExpMacroAssembler::RETRY) {
-      ASSERT(res != NativeRegExpMacroAssembler::EXCEPTION ||
-             isolate->has_pending_exception());
-      STATIC_ASSERT(
-          static_cast<int>(NativeRegExpMacroAssembler::SUCCESS) == RE_SUCCESS);
-      STATIC_ASSERT(
-          static_cast<int>(NativeRegExpMacroAssembler::FAILURE) == RE_FAILURE);
-      STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::EXCEPTION)
-                    == RE_EXCEPTION);
-      return static_cast<IrregexpResult>(res);
-    }
-    // If result is RETRY, the string has changed representation, and we
-    // must restart from scratch.
-    // In this case, it means we must make sure we are prepared to handle
-    // the, potentially, different subject (the string can switch between
-    // being internal and external, and even between being ASCII and UC16,
-    // but the characters are always the same).
-    IrregexpPrepare(regexp, subject);
-    is_ascii = subject->IsAsciiRepresentationUnderneath();
-  } while (true);
-  UNREACHABLE();
-  return RE_EXCEPTION;
-#else  // V8_INTERPRETED_REGEXP
+  // The regexp may have become hot after IrregexpPrepare sized the
+  // registers for the interpreter, which is more room than native code
+  // needs.
+  if (IrregexpUsesNativeCode(*irregexp)) {
+    ASSERT(output.length() >= (IrregexpNumberOfCaptures(*irregexp) + 1) * 2);
+    do {
+      EnsureCompiledIrregexp(regexp, is_ascii);
+      Handle<Code> code(IrregexpNativeCode(*irregexp, is_ascii), isolate);
+      NativeRegExpMacroAssembler::Result res =
+          NativeRegExpMacroAssembler::Match(code,
+                                            subject,
+                                            output.start(),
+                                            output.length(),
+                                            index,
+                                            isolate);
+      if (res != NativeRegExpMacroAssembler::RETRY) {
+        ASSERT(res != NativeRegExpMacroAssembler::EXCEPTION ||
+               isolate->has_pending_exception());
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::SUCCESS)
+                      == RE_SUCCESS);
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::FAILURE)
+                      == RE_FAILURE);
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::EXCEPTION)
+                      == RE_EXCEPTION);
+        return static_cast<IrregexpResult>(res);
+      }
+      // If result is RETRY, the string has changed representation, and we
+      // must restart from scratch.
+      // In this case, it means we must make sure we are prepared to handle
+      // the, potentially, different subject (the string can switch between
+      // being internal and external, and even between being ASCII and UC16,
+      // but the characters are always the same).
+      IrregexpPrepare(regexp, subject);
+      is_ascii = subject->IsAsciiRepresentationUnderneath();
+    } while (true);
+    UNREACHABLE();
+    return RE_EXCEPTION;
+  }
+
+  if (!EnsureBytecodeIrregexp(regexp, is_ascii)) return RE_EXCEPTION;
+#endif  // V8_INTERPRETED_REGEXP
 
   ASSERT(output.length() >= IrregexpNumberOfRegisters(*irregexp));
-  // We must have done EnsureCompiledIrregexp, so we can get the number of
-  // registers.
+  // We must have done EnsureCompiledIrregexp, or EnsureBytecodeIrregexp
+  // with native regexp support, so we can get the number of registers.
   int* register_vector = output.start();
   int number_of_capture_registers =
       (IrregexpNumberOfCaptures(*irregexp) + 1) * 2;
@@ -516,10 +722,20 @@ RegExpImpl::IrregexpResult RegExpImpl::IrregexpExecOnce(
                                                      index);
   if (result == RE_EXCEPTION) {
     ASSERT(!isolate->has_pending_exception());
-    isolate->StackOverflow();
+    ThrowExecutionException(isolate);
   }
   return result;
-#endif  // V8_INTERPRETED_REGEXP
+}
+
+
+void RegExpImpl::ThrowExecutionException(Isolate* isolate) {
+  if (isolate->regexp_stack()->BacktrackBudgetExhausted()) {
+    Handle<Object> error = isolate->factory()->NewRangeError(
+        "regexp_backtrack_limit", HandleVector<Object>(NULL, 0));
+    isolate->Throw(*error);
+  } else {
+    isolate->StackOverflow();
+  }
 }
 
 
@@ -552,20 +768,12 @@ Handle<Object> RegExpImpl::IrregexpExec(Handle<JSRegExp> jsregexp,
       jsregexp, subject, previous_index, Vector<int>(registers.vector(),
                                                      registers.length()));
   if (res == RE_SUCCESS) {
-    int capture_register_count =
-        (IrregexpNumberOfCaptures(FixedArray::cast(jsregexp->data())) + 1) * 2;
-    last_match_info->EnsureSize(capture_register_count + kLastMatchOverhead);
-    AssertNoAllocation no_gc;
-    int* register_vector = registers.vector();
-    FixedArray* array = FixedArray::cast(last_match_info->elements());
-    for (int i = 0; i < capture_register_count; i += 2) {
-      SetCapture(array, i, register_vector[i]);
-      SetCapture(array, i + 1, register_vector[i + 1]);
-    }
-    SetLastCaptureCount(array, capture_register_count);
-    SetLastSubject(array, *subject);
-    SetLastInput(array, *subject);
-    return last_match_info;
+    int capture_count =
+        IrregexpNumberOfCaptures(FixedArray::cast(jsregexp->data()));
+    return SetLastMatchInfo(last_match_info,
+                            subject,
+                            capture_count,
+                            registers.vector());
   }
   if (res == RE_EXCEPTION) {
     ASSERT(Isolate::Current()->has_pending_exception());
@@ -576,6 +784,126 @@ Handle<Object> RegExpImpl::IrregexpExec(Handle<JSRegExp> jsregexp,
 }
 
 
+Handle<JSArray> RegExpImpl::SetLastMatchInfo(Handle<JSArray> last_match_info,
+                                             Handle<String> subject,
+                                             int capture_count,
+                                             int32_t* match) {
+  int capture_register_count = (capture_count + 1) * 2;
+  last_match_info->EnsureSize(capture_register_count + kLastMatchOverhead);
+  AssertNoAllocation no_gc;
+  FixedArray* array = FixedArray::cast(last_match_info->elements());
+  for (int i = 0; i < capture_register_count; i += 2) {
+    SetCapture(array, i, match[i]);
+    SetCapture(array, i + 1, match[i + 1]);
+  }
+  SetLastCaptureCount(array, capture_register_count);
+  SetLastSubject(array, *subject);
+  SetLastInput(array, *subject);
+  return last_match_info;
+}
+
+
+RegExpImpl::GlobalCache::GlobalCache(Handle<JSRegExp> regexp,
+                                     Handle<String> subject,
+                                     bool is_global)
+    : register_array_(NULL),
+      last_match_(NULL),
+      is_global_(is_global),
+      regexp_(regexp),
+      subject_(subject) {
+  if (regexp->TypeTag() == JSRegExp::ATOM) {
+    registers_per_match_ = 2;
+  } else {
+    registers_per_match_ = IrregexpPrepare(regexp, subject);
+    if (registers_per_match_ < 0) {
+      num_matches_ = -1;  // Signal exception.
+      return;
+    }
+  }
+  max_matches_ =
+      is_global ? Max(1, kRegisterArraySize / registers_per_match_) : 1;
+  register_array_ = NewArray<int32_t>(max_matches_ * registers_per_match_);
+  last_match_ = NewArray<int32_t>(registers_per_match_);
+  // Pretend that the previous batch was full and ended with a non-empty
+  // match at position zero, so that the first FetchNext starts there.
+  num_matches_ = max_matches_;
+  current_match_index_ = max_matches_ - 1;
+  int32_t* fake_match =
+      &register_array_[current_match_index_ * registers_per_match_];
+  fake_match[0] = -1;
+  fake_match[1] = 0;
+}
+
+
+RegExpImpl::GlobalCache::~GlobalCache() {
+  if (register_array_ != NULL) DeleteArray(register_array_);
+  if (last_match_ != NULL) DeleteArray(last_match_);
+}
+
+
+int32_t* RegExpImpl::GlobalCache::FetchNext() {
+  if (num_matches_ < 0) return NULL;
+  current_match_index_++;
+  if (current_match_index_ < num_matches_) {
+    return &register_array_[current_match_index_ * registers_per_match_];
+  }
+  // The batch is used up.  A batch that was not full ended with a failed
+  // match, so there are no more matches.
+  if (num_matches_ < max_matches_) return NULL;
+  current_match_index_ = num_matches_;
+  int32_t* last_match =
+      &register_array_[(num_matches_ - 1) * registers_per_match_];
+  // Continue from where the match ended, unless it was an empty match.
+  int next = last_match[1];
+  if (last_match[0] == next) next++;
+  if (next > subject_->length()) return NULL;
+  for (int i = 0; i < registers_per_match_; i++) last_match_[i] = last_match[i];
+  num_matches_ = FillBatch(next);
+  if (num_matches_ <= 0) return NULL;
+  // A non-global regexp matches only once, so treat its batch as the last.
+  if (!is_global_) max_matches_ = num_matches_ + 1;
+  current_match_index_ = 0;
+  return register_array_;
+}
+
+
+int32_t* RegExpImpl::GlobalCache::LastSuccessfulMatch() {
+  ASSERT(num_matches_ >= 0);
+  if (num_matches_ == 0) return last_match_;
+  return &register_array_[(num_matches_ - 1) * registers_per_match_];
+}
+
+
+int RegExpImpl::GlobalCache::FillBatch(int index) {
+  if (regexp_->TypeTag() == JSRegExp::ATOM) {
+    return AtomExecRaw(regexp_, subject_, index, register_array_,
+                       max_matches_);
+  }
+  int subject_length = subject_->length();
+  int32_t* registers = register_array_;
+  int matches = 0;
+  // Run the compiled code for one match after the other without returning
+  // to the caller until the batch is full.
+  while (matches < max_matches_) {
+    IrregexpResult result =
+        IrregexpExecOnce(regexp_,
+                         subject_,
+                         index,
+                         Vector<int>(registers, registers_per_match_));
+    if (result == RE_EXCEPTION) return -1;
+    if (result == RE_FAILURE) break;
+    matches++;
+    index = registers[1];
+    if (registers[0] == index) {
+      index++;
+      if (index > subject_length) break;
+    }
+    registers += registers_per_match_;
+  }
+  return matches;
+}
+
+
 // -------------------------------------------------------------------
 // Implementation of the Irregexp regular expression engine.
 //
@@ -910,7 +1238,7 @@ RegExpEngine::CompilationResult RegExpCompiler::Assemble(
   heap->IncreaseTotalRegexpCodeGenerated(code->Size());
   work_list_ = NULL;
 #ifdef DEBUG
-  if (FLAG_print_code) {
+  if (FLAG_print_code && code->IsCode()) {
     Handle<Code>::cast(code)->Disassemble(*pattern->ToCString());
   }
   if (FLAG_trace_regexp_assembler) {
@@ -5250,11 +5578,35 @@ void DispatchTableConstructor::VisitAction(ActionNode* that) {
 }
 
 
+static RegExpEngine::CompilationResult AssembleRegExp(
+    RegExpCompiler* compiler,
+    RegExpMacroAssembler* macro_assembler,
+    RegExpNode* node,
+    RegExpCompileData* data,
+    Handle<String> pattern) {
+  // Inserted here, instead of in Assembler, because it depends on information
+  // in the AST that isn't replicated in the Node structure.
+  static const int kMaxBacksearchLimit = 1024;
+  int max_length = data->tree->max_match();
+  if (data->tree->IsAnchoredAtEnd() &&
+      !data->tree->IsAnchoredAtStart() &&
+      max_length < kMaxBacksearchLimit) {
+    macro_assembler->SetCurrentPositionFromEnd(max_length);
+  }
+
+  return compiler->Assemble(macro_assembler,
+                            node,
+                            data->capture_count,
+                            pattern);
+}
+
+
 RegExpEngine::CompilationResult RegExpEngine::Compile(RegExpCompileData* data,
                                                       bool ignore_case,
                                                       bool is_multiline,
                                                       Handle<String> pattern,
-                                                      bool is_ascii) {
+                                                      bool is_ascii,
+                                                      bool is_bytecode) {
   if ((data->capture_count + 1) * 2 - 1 > RegExpMacroAssembler::kMaxRegister) {
     return IrregexpRegExpTooBig();
   }
@@ -5265,9 +5617,7 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(RegExpCompileData* data,
                                                     &compiler,
                                                     compiler.accept());
   RegExpNode* node = captured_body;
-  bool is_end_anchored = data->tree->IsAnchoredAtEnd();
   bool is_start_anchored = data->tree->IsAnchoredAtStart();
-  int max_length = data->tree->max_match();
   if (!is_start_anchored) {
     // Add a .*? at the beginning, outside the body capture, unless
     // this expression is anchored at the beginning.
@@ -5302,41 +5652,32 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(RegExpCompileData* data,
 
   // Create the correct assembler for the architecture.
 #ifndef V8_INTERPRETED_REGEXP
-  // Native regexp implementation.
+  if (!is_bytecode) {
+    // Native regexp implementation.
 
-  NativeRegExpMacroAssembler::Mode mode =
-      is_ascii ? NativeRegExpMacroAssembler::ASCII
-               : NativeRegExpMacroAssembler::UC16;
+    NativeRegExpMacroAssembler::Mode mode =
+        is_ascii ? NativeRegExpMacroAssembler::ASCII
+                 : NativeRegExpMacroAssembler::UC16;
+    int registers = (data->capture_count + 1) * 2;
 
 #if V8_TARGET_ARCH_IA32
-  RegExpMacroAssemblerIA32 macro_assembler(mode, (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerIA32 macro_assembler(mode, registers);
 #elif V8_TARGET_ARCH_X64
-  RegExpMacroAssemblerX64 macro_assembler(mode, (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerX64 macro_assembler(mode, registers);
 #elif V8_TARGET_ARCH_ARM
-  RegExpMacroAssemblerARM macro_assembler(mode, (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerARM macro_assembler(mode, registers);
 #elif V8_TARGET_ARCH_MIPS
-  RegExpMacroAssemblerMIPS macro_assembler(mode, (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerMIPS macro_assembler(mode, registers);
 #endif
 
-#else  // V8_INTERPRETED_REGEXP
+    return AssembleRegExp(&compiler, &macro_assembler, node, data, pattern);
+  }
+#endif  // V8_INTERPRETED_REGEXP
+
   // Interpreted regexp implementation.
   EmbeddedVector<byte, 1024> codes;
   RegExpMacroAssemblerIrregexp macro_assembler(codes);
-#endif  // V8_INTERPRETED_REGEXP
-
-  // Inserted here, instead of in Assembler, because it depends on information
-  // in the AST that isn't replicated in the Node structure.
-  static const int kMaxBacksearchLimit = 1024;
-  if (is_end_anchored &&
-      !is_start_anchored &&
-      max_length < kMaxBacksearchLimit) {
-    macro_assembler.SetCurrentPositionFromEnd(max_length);
-  }
-
-  return compiler.Assemble(&macro_assembler,
-                           node,
-                           data->capture_count,
-                           pattern);
+  return AssembleRegExp(&compiler, &macro_assembler, node, data, pattern);
 }
 
 
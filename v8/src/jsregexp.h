@@ -77,11 +77,13 @@ class RegExpImpl {
                              int index,
                              Handle<JSArray> lastMatchInfo);
 
-  // Prepares a JSRegExp object with Irregexp-specific data.
+  // Prepares a JSRegExp object with Irregexp-specific data.  The literal
+  // prefix is a null handle if matches do not start with a known string.
   static void IrregexpInitialize(Handle<JSRegExp> re,
                                  Handle<String> pattern,
                                  JSRegExp::Flags flags,
-                                 int capture_register_count);
+                                 int capture_register_count,
+                                 Handle<String> literal_prefix);
 
 
   static void AtomCompile(Handle<JSRegExp> re,
@@ -94,6 +96,15 @@ class RegExpImpl {
                                  int index,
                                  Handle<JSArray> lastMatchInfo);
 
+  // Stores start and end of up to max_matches consecutive, non-overlapping
+  // matches of an atom regexp at or after index into output, and returns
+  // the number of matches found.
+  static int AtomExecRaw(Handle<JSRegExp> regexp,
+                         Handle<String> subject,
+                         int index,
+                         int32_t* output,
+                         int max_matches);
+
   enum IrregexpResult { RE_FAILURE = 0, RE_SUCCESS = 1, RE_EXCEPTION = -1 };
 
   // Prepare a RegExp for being executed one or more times (using
@@ -117,6 +128,10 @@ class RegExpImpl {
                                          int index,
                                          Vector<int> registers);
 
+  // Sets the pending exception for an execution that failed without
+  // throwing: it either ran out of backtrack budget or of backtrack stack.
+  static void ThrowExecutionException(Isolate* isolate);
+
   // Execute an Irregexp bytecode pattern.
   // On a successful match, the result is a JSArray containing
   // captured positions. On a failure, the result is the null value.
@@ -126,6 +141,55 @@ class RegExpImpl {
                                      int index,
                                      Handle<JSArray> lastMatchInfo);
 
+  // Stores the capture positions of a match into the lastMatchInfo array.
+  static Handle<JSArray> SetLastMatchInfo(Handle<JSArray> last_match_info,
+                                          Handle<String> subject,
+                                          int capture_count,
+                                          int32_t* match);
+
+  // Iterates over the matches of an atom or irregexp regexp in a subject
+  // the way a global regexp steps through it, starting at index zero.
+  // Matches are found in batches: the matcher is run repeatedly, without
+  // returning to the caller, until a capture buffer of a few hundred
+  // registers is full, and FetchNext then hands out one match at a time.
+  class GlobalCache {
+   public:
+    // A cache for a non-global regexp only produces the first match.
+    GlobalCache(Handle<JSRegExp> regexp,
+                Handle<String> subject,
+                bool is_global);
+    ~GlobalCache();
+
+    // Returns the capture positions of the next match, or NULL if there are
+    // no more matches or an exception is pending.  The positions are only
+    // valid until the next call.
+    int32_t* FetchNext();
+
+    // Returns the capture positions of the last match, once FetchNext has
+    // returned NULL after at least one match.
+    int32_t* LastSuccessfulMatch();
+
+    bool HasException() { return num_matches_ < 0; }
+
+   private:
+    static const int kRegisterArraySize = 256;
+
+    // Fills the register array with matches starting at index.  Returns the
+    // number of matches, or -1 if an exception was thrown.
+    int FillBatch(int index);
+
+    int num_matches_;
+    int max_matches_;
+    int current_match_index_;
+    int registers_per_match_;
+    int32_t* register_array_;
+    // Copy of the last match of the previous batch.
+    int32_t* last_match_;
+    bool is_global_;
+    Handle<JSRegExp> regexp_;
+    Handle<String> subject_;
+  };
+
   // Array index in the lastMatchInfo array.
   static const int kLastCaptureCount = 0;
   static const int kLastSubject = 1;
@@ -176,6 +240,12 @@ class RegExpImpl {
   static ByteArray* IrregexpByteCode(FixedArray* re, bool is_ascii);
   static Code* IrregexpNativeCode(FixedArray* re, bool is_ascii);
 
+  // Whether the regexp is matched with native code rather than with the
+  // bytecode interpreter. With --regexp-tier-up a regexp is interpreted
+  // until it has been executed --regexp-tier-up-executions times or on
+  // subjects of --regexp-tier-up-subject-length characters in total.
+  static bool IrregexpUsesNativeCode(FixedArray* re);
+
   // Limit the space regexps take up on the heap.  In order to limit this we
   // would like to keep track of the amount of regexp code on the heap.  This
   // is not tracked, however.  As a conservative approximation we track the
@@ -188,9 +258,21 @@ class RegExpImpl {
   static String* last_ascii_string_;
   static String* two_byte_cached_string_;
 
-  static bool CompileIrregexp(Handle<JSRegExp> re, bool is_ascii);
+  static bool CompileIrregexp(Handle<JSRegExp> re,
+                              bool is_ascii,
+                              bool is_bytecode);
   static inline bool EnsureCompiledIrregexp(Handle<JSRegExp> re, bool is_ascii);
 
+#ifndef V8_INTERPRETED_REGEXP
+  // Ensures that the regexp contains bytecode for the interpreter, which
+  // runs the regexp until it is hot enough to be compiled to native code.
+  static bool EnsureBytecodeIrregexp(Handle<JSRegExp> re, bool is_ascii);
+
+  // Counts an execution of the regexp on a subject of the given length
+  // while it is interpreted.
+  static void IrregexpCountExecution(FixedArray* re, int subject_length);
+#endif  // V8_INTERPRETED_REGEXP
+
 
   // Set the subject cache.  The previous string buffer is not deleted, so the
   // caller should ensure that it doesn't leak.
@@ -1452,11 +1534,15 @@ class RegExpEngine: public AllStatic {
     int num_registers;
   };
 
+  // Compiles to bytecode for the interpreter if is_bytecode is set or V8
+  // is compiled without native regexp support, and to native code
+  // otherwise.
   static CompilationResult Compile(RegExpCompileData* input,
                                    bool ignore_case,
                                    bool multiline,
                                    Handle<String> pattern,
-                                   bool is_ascii);
+                                   bool is_ascii,
+                                   bool is_bytecode);
 
   static void DotPrint(const char* label, RegExpNode* node, bool ignore_case);
 };
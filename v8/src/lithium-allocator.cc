@@ -217,6 +217,18 @@ UsePosition* LiveRange::NextUsePositionRegisterIsBeneficial(
 }
 
 
+UsePosition* LiveRange::PreviousUsePositionRegisterIsBeneficial(
+    LifetimePosition start) {
+  UsePosition* prev_pos = NULL;
+  for (UsePosition* pos = first_pos();
+       pos != NULL && pos->pos().Value() < start.Value();
+       pos = pos->next()) {
+    if (pos->RegisterIsBeneficial()) prev_pos = pos;
+  }
+  return prev_pos;
+}
+
+
 UsePosition* LiveRange::NextRegisterPosition(LifetimePosition start) {
   UsePosition* pos = NextUsePosition(start);
   while (pos != NULL && !pos->RequiresRegister()) {
@@ -558,6 +570,9 @@ LAllocator::LAllocator(int num_values, HGraph* graph)
       first_artificial_register_(num_values),
       mode_(GENERAL_REGISTERS),
       num_registers_(-1),
+      max_active_live_ranges_(0),
+      gap_moves_(0),
+      eliminated_gap_moves_(0),
       graph_(graph),
       has_osr_entry_(false) {}
 
@@ -1076,6 +1091,28 @@ void LAllocator::Allocate(LChunk* chunk) {
   if (has_osr_entry_) ProcessOsrEntry();
   ConnectRanges();
   ResolveControlFlow();
+  if (FLAG_optimize_gap_moves) OptimizeGapMoves();
+  if (FLAG_hydrogen_stats) RecordStatistics();
+}
+
+
+void LAllocator::RecordStatistics() {
+  int range_count = 0;
+  int split_count = 0;
+  int spill_count = 0;
+  for (int i = 0; i < live_ranges_.length(); ++i) {
+    LiveRange* range = live_ranges_[i];
+    if (range == NULL || range->IsEmpty()) continue;
+    range_count++;
+    if (range->IsChild()) split_count++;
+    if (range->IsSpilled()) spill_count++;
+  }
+  HStatistics::Instance()->SaveRegisterAllocation(range_count,
+                                                  split_count,
+                                                  spill_count,
+                                                  chunk_->spill_slot_count(),
+                                                  max_active_live_ranges_);
+  HStatistics::Instance()->SaveGapMoves(gap_moves_, eliminated_gap_moves_);
 }
 
 
@@ -1241,6 +1278,203 @@ void LAllocator::ResolveControlFlow() {
 }
 
 
+// Merges the parallel moves of every gap into one and removes moves into
+// spill slots that are never read.  Merging composes a later move with an
+// earlier move into its source, so a reload of a value that was just
+// spilled reads the register instead of the slot, and drops earlier moves
+// whose destination is overwritten.
+void LAllocator::OptimizeGapMoves() {
+  HPhase phase("Optimize gap moves", this);
+  int instruction_count = chunk_->instructions()->length();
+  for (int i = 0; i < instruction_count; ++i) {
+    if (IsGapAt(i)) {
+      gap_moves_ += CountMoves(GapAt(i));
+      MergeParallelMoves(GapAt(i));
+    }
+  }
+  EliminateDeadSpillMoves();
+  int remaining_moves = 0;
+  for (int i = 0; i < instruction_count; ++i) {
+    if (IsGapAt(i)) remaining_moves += CountMoves(GapAt(i));
+  }
+  eliminated_gap_moves_ = gap_moves_ - remaining_moves;
+  TraceAlloc("Eliminated %d of %d gap moves\n",
+             eliminated_gap_moves_,
+             gap_moves_);
+}
+
+
+int LAllocator::CountMoves(LGap* gap) {
+  int count = 0;
+  for (int i = LGap::FIRST_INNER_POSITION;
+       i <= LGap::LAST_INNER_POSITION;
+       i++) {
+    LParallelMove* move =
+        gap->GetParallelMove(static_cast<LGap::InnerPosition>(i));
+    if (move == NULL) continue;
+    const ZoneList<LMoveOperands>* moves = move->move_operands();
+    for (int j = 0; j < moves->length(); ++j) {
+      if (!moves->at(j).IsRedundant()) count++;
+    }
+  }
+  return count;
+}
+
+
+void LAllocator::MergeParallelMoves(LGap* gap) {
+  LParallelMove* first = NULL;
+  for (int i = LGap::FIRST_INNER_POSITION;
+       i <= LGap::LAST_INNER_POSITION;
+       i++) {
+    LParallelMove* move =
+        gap->GetParallelMove(static_cast<LGap::InnerPosition>(i));
+    if (move == NULL || move->IsRedundant()) continue;
+    if (first == NULL) {
+      first = move;
+    } else {
+      MergeParallelMoves(first, move);
+    }
+  }
+  if (first == NULL) return;
+  ZoneList<LMoveOperands>* moves = first->move_operands();
+  for (int i = 0; i < moves->length(); ++i) {
+    if (moves->at(i).IsRedundant() && !moves->at(i).IsEliminated()) {
+      moves->at(i).Eliminate();
+    }
+  }
+}
+
+
+// Appends the moves of 'second' to 'first', which is performed before it.
+void LAllocator::MergeParallelMoves(LParallelMove* first,
+                                    LParallelMove* second) {
+  ZoneList<LMoveOperands>* first_moves = first->move_operands();
+  ZoneList<LMoveOperands>* second_moves = second->move_operands();
+  // Read the sources of the second moves before the first moves.
+  for (int i = 0; i < second_moves->length(); ++i) {
+    LMoveOperands* move = &second_moves->at(i);
+    if (move->IsRedundant()) continue;
+    for (int j = 0; j < first_moves->length(); ++j) {
+      LMoveOperands* earlier = &first_moves->at(j);
+      if (earlier->IsRedundant()) continue;
+      if (earlier->destination()->Equals(move->source())) {
+        move->set_source(earlier->source());
+        break;
+      }
+    }
+  }
+  // Drop the first moves whose destination the second moves overwrite.
+  for (int i = 0; i < first_moves->length(); ++i) {
+    LMoveOperands* earlier = &first_moves->at(i);
+    if (earlier->IsRedundant()) continue;
+    for (int j = 0; j < second_moves->length(); ++j) {
+      LMoveOperands* move = &second_moves->at(j);
+      if (!move->IsRedundant() &&
+          move->destination()->Equals(earlier->destination())) {
+        earlier->Eliminate();
+        break;
+      }
+    }
+  }
+  for (int i = 0; i < second_moves->length(); ++i) {
+    LMoveOperands* move = &second_moves->at(i);
+    if (move->IsEliminated()) continue;
+    if (!move->IsRedundant()) {
+      first->AddMove(move->source(), move->destination());
+    }
+    move->Eliminate();
+  }
+}
+
+
+// A spill slot is read if it is the source of a move, an input of an
+// instruction, part of a deoptimization environment, or recorded in a
+// pointer map.  Moves into other spill slots are dead.  Parameter slots
+// are never considered dead because the frame can be inspected.
+void LAllocator::EliminateDeadSpillMoves() {
+  int slot_count = chunk_->spill_slot_count();
+  if (slot_count == 0) return;
+  BitVector read_slots(slot_count);
+  int instruction_count = chunk_->instructions()->length();
+  for (int i = 0; i < instruction_count; ++i) {
+    if (IsGapAt(i)) {
+      LGap* gap = GapAt(i);
+      for (int j = LGap::FIRST_INNER_POSITION;
+           j <= LGap::LAST_INNER_POSITION;
+           j++) {
+        LParallelMove* move =
+            gap->GetParallelMove(static_cast<LGap::InnerPosition>(j));
+        if (move == NULL) continue;
+        const ZoneList<LMoveOperands>* moves = move->move_operands();
+        for (int k = 0; k < moves->length(); ++k) {
+          if (!moves->at(k).IsRedundant()) {
+            MarkSlotRead(&read_slots, moves->at(k).source());
+          }
+        }
+      }
+    }
+    LInstruction* instr = InstructionAt(i);
+    for (UseIterator it(instr); !it.Done(); it.Advance()) {
+      MarkSlotRead(&read_slots, it.Current());
+    }
+    for (TempIterator it(instr); !it.Done(); it.Advance()) {
+      MarkSlotRead(&read_slots, it.Current());
+    }
+  }
+  const ZoneList<LPointerMap*>* pointer_maps = chunk_->pointer_maps();
+  for (int i = 0; i < pointer_maps->length(); ++i) {
+    const ZoneList<LOperand*>* operands =
+        pointer_maps->at(i)->pointer_operands();
+    for (int j = 0; j < operands->length(); ++j) {
+      MarkSlotRead(&read_slots, operands->at(j));
+    }
+  }
+
+  for (int i = 0; i < instruction_count; ++i) {
+    if (!IsGapAt(i)) continue;
+    LGap* gap = GapAt(i);
+    for (int j = LGap::FIRST_INNER_POSITION;
+         j <= LGap::LAST_INNER_POSITION;
+         j++) {
+      LParallelMove* move =
+          gap->GetParallelMove(static_cast<LGap::InnerPosition>(j));
+      if (move == NULL) continue;
+      ZoneList<LMoveOperands>* moves = move->move_operands();
+      for (int k = 0; k < moves->length(); ++k) {
+        LMoveOperands* current = &moves->at(k);
+        if (!current->IsRedundant() &&
+            IsDeadSpillSlot(&read_slots, current->destination())) {
+          current->Eliminate();
+        }
+      }
+    }
+  }
+}
+
+
+// A double stack slot at index i also covers index i - 1 on 32-bit
+// platforms.
+void LAllocator::MarkSlotRead(BitVector* read_slots, LOperand* operand) {
+  if (operand->IsStackSlot() || operand->IsDoubleStackSlot()) {
+    int index = operand->index();
+    if (index < 0) return;
+    read_slots->Add(index);
+    if (operand->IsDoubleStackSlot() && index > 0) read_slots->Add(index - 1);
+  }
+}
+
+
+bool LAllocator::IsDeadSpillSlot(BitVector* read_slots, LOperand* operand) {
+  if (!operand->IsStackSlot() && !operand->IsDoubleStackSlot()) return false;
+  int index = operand->index();
+  if (index < 0) return false;
+  if (read_slots->Contains(index)) return false;
+  return !operand->IsDoubleStackSlot() ||
+      index == 0 ||
+      !read_slots->Contains(index - 1);
+}
+
+
 void LAllocator::BuildLiveRanges() {
   HPhase phase("Build live ranges", this);
   InitializeLivenessAnalysis();
@@ -1574,6 +1808,8 @@ void LAllocator::AllocateRegisters() {
 
     if (current->HasRegisterAssigned()) {
       AddToActive(current);
+      max_active_live_ranges_ =
+          Max(max_active_live_ranges_, active_live_ranges_.length());
     }
   }
 
@@ -1728,14 +1964,20 @@ void LAllocator::FreeSpillSlot(LiveRange* range) {
 
 
 LOperand* LAllocator::TryReuseSpillSlot(LiveRange* range) {
-  if (reusable_slots_.is_empty()) return NULL;
-  if (reusable_slots_.first()->End().Value() >
-      range->TopLevel()->Start().Value()) {
-    return NULL;
+  // Take the first slot whose previous owner is dead before the new range
+  // is defined.  The ranges must not touch: the gap at the end of the old
+  // range can still read the slot after the spill store of the new value.
+  // Slots are not freed in the order of their end positions, so the whole
+  // list has to be searched.
+  LifetimePosition start = range->TopLevel()->Start();
+  for (int i = 0; i < reusable_slots_.length(); ++i) {
+    LiveRange* free_range = reusable_slots_[i];
+    if (free_range->End().Value() < start.Value()) {
+      reusable_slots_.Remove(i);
+      return free_range->TopLevel()->GetSpillOperand();
+    }
   }
-  LOperand* result = reusable_slots_.first()->TopLevel()->GetSpillOperand();
-  reusable_slots_.Remove(0);
-  return result;
+  return NULL;
 }
 
 
@@ -1743,7 +1985,8 @@ void LAllocator::ActiveToHandled(LiveRange* range) {
   ASSERT(active_live_ranges_.Contains(range));
   active_live_ranges_.RemoveElement(range);
   TraceAlloc("Moving live range %d from active to handled\n", range->id());
-  FreeSpillSlot(range);
+  // Spill has already freed the slot of a spilled range.
+  if (!range->IsSpilled()) FreeSpillSlot(range);
 }
 
 
@@ -1759,7 +2002,7 @@ void LAllocator::InactiveToHandled(LiveRange* range) {
   ASSERT(inactive_live_ranges_.Contains(range));
   inactive_live_ranges_.RemoveElement(range);
   TraceAlloc("Moving live range %d from inactive to handled\n", range->id());
-  FreeSpillSlot(range);
+  if (!range->IsSpilled()) FreeSpillSlot(range);
 }
 
 
@@ -1960,7 +2203,9 @@ void LAllocator::SplitAndSpillIntersecting(LiveRange* current) {
     if (range->assigned_register() == reg) {
       UsePosition* next_pos = range->NextRegisterPosition(current->Start());
       if (next_pos == NULL) {
-        SpillAfter(range, split_pos);
+        // The range is spilled for the rest of its lifetime, so it can as
+        // well be spilled before entering the loop we are in.
+        SpillAfter(range, FindOptimalSpillingPos(range, split_pos));
       } else {
         SpillBetween(range, split_pos, next_pos->pos());
       }
@@ -2062,6 +2307,31 @@ LifetimePosition LAllocator::FindOptimalSplitPos(LifetimePosition start,
 }
 
 
+LifetimePosition LAllocator::FindOptimalSpillingPos(LiveRange* range,
+                                                    LifetimePosition pos) {
+  HBasicBlock* block = GetBlock(pos.InstructionStart());
+  HBasicBlock* loop_header =
+      block->IsLoopHeader() ? block : block->parent_loop_header();
+  if (loop_header == NULL) return pos;
+
+  UsePosition* prev_use = range->PreviousUsePositionRegisterIsBeneficial(pos);
+  while (loop_header != NULL) {
+    LifetimePosition loop_start = LifetimePosition::FromInstructionIndex(
+        loop_header->first_instruction_index());
+    // Stop at the first loop that the range does not enter live or that
+    // uses the register before pos.
+    if (loop_start.Value() <= range->Start().Value() ||
+        !range->Covers(loop_start) ||
+        (prev_use != NULL && prev_use->pos().Value() >= loop_start.Value())) {
+      break;
+    }
+    pos = loop_start;
+    loop_header = loop_header->parent_loop_header();
+  }
+  return pos;
+}
+
+
 void LAllocator::SpillAfter(LiveRange* range, LifetimePosition pos) {
   LiveRange* second_part = SplitAt(range, pos);
   Spill(second_part);
@@ -2106,6 +2376,10 @@ void LAllocator::Spill(LiveRange* range) {
     first->SetSpillOperand(op);
   }
   range->MakeSpilled();
+  // A spilled range never becomes active again, so its slot would not be
+  // freed when the range is handled.  Free it now: TryReuseSpillSlot only
+  // hands it out to ranges starting after this one ends.
+  FreeSpillSlot(range);
 }
 
 
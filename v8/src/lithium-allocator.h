@@ -309,6 +309,11 @@ class LiveRange: public ZoneObject {
   // Modifies internal state of live range!
   UsePosition* NextUsePositionRegisterIsBeneficial(LifetimePosition start);
 
+  // Returns the last use position before start for which register is
+  // beneficial in this live range, or NULL.
+  UsePosition* PreviousUsePositionRegisterIsBeneficial(
+      LifetimePosition start);
+
   // Can this live range be spilled at this position.
   bool CanBeSpilled(LifetimePosition pos);
 
@@ -480,6 +485,7 @@ class LAllocator BASE_EMBEDDED {
   void AllocateDoubleRegisters();
   void ConnectRanges();
   void ResolveControlFlow();
+  void OptimizeGapMoves();
   void PopulatePointerMaps();
   void ProcessOsrEntry();
   void AllocateRegisters();
@@ -546,6 +552,13 @@ class LAllocator BASE_EMBEDDED {
   LifetimePosition FindOptimalSplitPos(LifetimePosition start,
                                        LifetimePosition end);
 
+  // Find a lifetime position at or before pos at which the given range can
+  // be spilled: if pos is inside a loop and the range does not benefit from
+  // a register between the loop header and pos, spill at the header of the
+  // outermost such loop instead, keeping the stores off the back edge.
+  LifetimePosition FindOptimalSpillingPos(LiveRange* range,
+                                          LifetimePosition pos);
+
   // Spill the given life range after position pos.
   void SpillAfter(LiveRange* range, LifetimePosition pos);
 
@@ -559,6 +572,17 @@ class LAllocator BASE_EMBEDDED {
   void Spill(LiveRange* range);
   bool IsBlockBoundary(LifetimePosition pos);
 
+  // Report register pressure and spilling of this chunk to HStatistics.
+  void RecordStatistics();
+
+  // Helper methods for optimizing gap moves.
+  int CountMoves(LGap* gap);
+  void MergeParallelMoves(LGap* gap);
+  void MergeParallelMoves(LParallelMove* first, LParallelMove* second);
+  void EliminateDeadSpillMoves();
+  static void MarkSlotRead(BitVector* read_slots, LOperand* operand);
+  static bool IsDeadSpillSlot(BitVector* read_slots, LOperand* operand);
+
   // Helper methods for resolving control flow.
   void ResolveControlFlow(LiveRange* range,
                           HBasicBlock* block,
@@ -616,6 +640,13 @@ class LAllocator BASE_EMBEDDED {
   RegisterKind mode_;
   int num_registers_;
 
+  // Maximum number of simultaneously active live ranges.
+  int max_active_live_ranges_;
+
+  // Number of gap moves before and eliminated by OptimizeGapMoves.
+  int gap_moves_;
+  int eliminated_gap_moves_;
+
   HGraph* graph_;
 
   bool has_osr_entry_;
@@ -396,6 +396,7 @@ class LParallelMove : public ZoneObject {
   const ZoneList<LMoveOperands>* move_operands() const {
     return &move_operands_;
   }
+  ZoneList<LMoveOperands>* move_operands() { return &move_operands_; }
 
   void PrintDataTo(StringStream* stream) const;
 
@@ -419,6 +420,10 @@ class LPointerMap: public ZoneObject {
     untagged_operands_.Clear();
     return &pointer_operands_;
   }
+  // Includes operands that are also recorded as untagged.
+  const ZoneList<LOperand*>* pointer_operands() const {
+    return &pointer_operands_;
+  }
   int position() const { return position_; }
   int lithium_position() const { return lithium_position_; }
 
@@ -440,6 +445,28 @@ class LPointerMap: public ZoneObject {
 };
 
 
+// A frame value that holds an object removed by escape analysis, or the
+// arguments object of an inlined function with the callee as boilerplate and
+// the arguments as fields.  The operands for its fields are stored in the
+// environment after the frame values.
+class LCapturedObject: public ZoneObject {
+ public:
+  LCapturedObject(int index, Handle<JSObject> boilerplate, int field_count)
+      : index_(index),
+        boilerplate_(boilerplate),
+        field_count_(field_count) { }
+
+  int index() const { return index_; }
+  Handle<JSObject> boilerplate() const { return boilerplate_; }
+  int field_count() const { return field_count_; }
+
+ private:
+  int index_;
+  Handle<JSObject> boilerplate_;
+  int field_count_;
+};
+
+
 class LEnvironment: public ZoneObject {
  public:
   LEnvironment(Handle<JSFunction> closure,
@@ -457,12 +484,20 @@ class LEnvironment: public ZoneObject {
         pc_offset_(-1),
         values_(value_count),
         representations_(value_count),
+        is_uint32_(value_count),
+        captured_objects_(0),
+        captured_field_count_(0),
         spilled_registers_(NULL),
         spilled_double_registers_(NULL),
+        has_dynamic_closure_(false),
         outer_(outer) {
   }
 
   Handle<JSFunction> closure() const { return closure_; }
+  // Whether closure() is only a template for a closure created at
+  // runtime, see HEnvironment::has_dynamic_closure.
+  bool has_dynamic_closure() const { return has_dynamic_closure_; }
+  void set_has_dynamic_closure() { has_dynamic_closure_ = true; }
   int arguments_stack_height() const { return arguments_stack_height_; }
   int deoptimization_index() const { return deoptimization_index_; }
   int translation_index() const { return translation_index_; }
@@ -476,15 +511,50 @@ class LEnvironment: public ZoneObject {
   const ZoneList<LOperand*>* values() const { return &values_; }
   LEnvironment* outer() const { return outer_; }
 
-  void AddValue(LOperand* operand, Representation representation) {
+  void AddValue(LOperand* operand,
+                Representation representation,
+                bool is_uint32) {
     values_.Add(operand);
     representations_.Add(representation);
+    is_uint32_.Add(is_uint32);
+  }
+
+  // Captured objects are added as frame values with a NULL operand.  The
+  // fields of all captured objects are added after the frame values, in
+  // the same order as the objects.
+  void AddCapturedObject(Handle<JSObject> boilerplate, int field_count) {
+    ASSERT(captured_field_count_ == 0);
+    captured_objects_.Add(
+        new LCapturedObject(values_.length(), boilerplate, field_count));
+    AddValue(NULL, Representation::Tagged(), false);
+  }
+  void AddCapturedField(LOperand* operand, Representation representation) {
+    AddValue(operand, representation, false);
+    captured_field_count_++;
+  }
+
+  // The captured object at the given frame value index, or NULL.
+  LCapturedObject* CapturedObjectAt(int index) const {
+    for (int i = 0; i < captured_objects_.length(); ++i) {
+      if (captured_objects_[i]->index() == index) return captured_objects_[i];
+    }
+    return NULL;
+  }
+
+  // The number of frame values, i.e. the values excluding the fields of
+  // captured objects.
+  int translation_size() const {
+    return values_.length() - captured_field_count_;
   }
 
   bool HasTaggedValueAt(int index) const {
     return representations_[index].IsTagged();
   }
 
+  bool HasUint32ValueAt(int index) const {
+    return is_uint32_[index];
+  }
+
   void Register(int deoptimization_index,
                 int translation_index,
                 int pc_offset) {
@@ -515,6 +585,9 @@ class LEnvironment: public ZoneObject {
   int pc_offset_;
   ZoneList<LOperand*> values_;
   ZoneList<Representation> representations_;
+  ZoneList<bool> is_uint32_;
+  ZoneList<LCapturedObject*> captured_objects_;
+  int captured_field_count_;
 
   // Allocation index indexed arrays of spill slot operands for registers
   // that are also in spill slots at an OSR entry.  NULL for environments
@@ -522,6 +595,7 @@ class LEnvironment: public ZoneObject {
   LOperand** spilled_registers_;
   LOperand** spilled_double_registers_;
 
+  bool has_dynamic_closure_;
   LEnvironment* outer_;
 
   friend class LCodegen;
@@ -204,12 +204,14 @@ Debug.LiveEdit = new function() {
     change_log.push( {position_patched: position_patch_report} );
 
     for (var i = 0; i < update_positions_list.length; i++) {
-      // TODO(LiveEdit): take into account wether it's source_changed or
-      // unchanged and whether positions changed at all.
+      // TODO(LiveEdit): take into account whether positions changed at all.
       PatchPositions(update_positions_list[i], diff_array,
           position_patch_report);
 
-      if (update_positions_list[i].live_shared_function_infos) {
+      // Unchanged functions keep their optimized code, with positions
+      // patched above.
+      if (update_positions_list[i].status == FunctionStatus.SOURCE_CHANGED &&
+          update_positions_list[i].live_shared_function_infos) {
         update_positions_list[i].live_shared_function_infos.
             forEach(function (info) {
                 %LiveEditFunctionSourceUpdated(info.raw_array);
@@ -1254,6 +1254,29 @@ class RelocInfoBuffer {
   static const int kMaximalBufferSize = 512*MB;
 };
 
+// Writes the relocation info of code with translated positions.
+static void TranslatePositionsInRelocInfo(
+    Code* code,
+    Handle<JSArray> position_change_array,
+    RelocInfoBuffer* buffer_writer) {
+  AssertNoAllocation no_allocations_please;
+  for (RelocIterator it(code); !it.done(); it.next()) {
+    RelocInfo* rinfo = it.rinfo();
+    if (RelocInfo::IsPosition(rinfo->rmode())) {
+      int position = static_cast<int>(rinfo->data());
+      int new_position = TranslatePosition(position,
+                                           position_change_array);
+      if (position != new_position) {
+        RelocInfo info_copy(rinfo->pc(), rinfo->rmode(), new_position, NULL);
+        buffer_writer->Write(&info_copy);
+        continue;
+      }
+    }
+    buffer_writer->Write(it.rinfo());
+  }
+}
+
+
 // Patch positions in code (changes relocation info section) and possibly
 // returns new instance of code.
 static Handle<Code> PatchPositionsInCode(
@@ -1262,24 +1285,7 @@ static Handle<Code> PatchPositionsInCode(
 
   RelocInfoBuffer buffer_writer(code->relocation_size(),
                                 code->instruction_start());
-
-  {
-    AssertNoAllocation no_allocations_please;
-    for (RelocIterator it(*code); !it.done(); it.next()) {
-      RelocInfo* rinfo = it.rinfo();
-      if (RelocInfo::IsPosition(rinfo->rmode())) {
-        int position = static_cast<int>(rinfo->data());
-        int new_position = TranslatePosition(position,
-                                             position_change_array);
-        if (position != new_position) {
-          RelocInfo info_copy(rinfo->pc(), rinfo->rmode(), new_position, NULL);
-          buffer_writer.Write(&info_copy);
-          continue;
-        }
-      }
-      buffer_writer.Write(it.rinfo());
-    }
-  }
+  TranslatePositionsInRelocInfo(*code, position_change_array, &buffer_writer);
 
   Vector<byte> buffer = buffer_writer.GetResult();
 
@@ -1297,6 +1303,102 @@ static Handle<Code> PatchPositionsInCode(
 }
 
 
+// Patch positions in optimized code without copying it, which would lose
+// track of the code in the deoptimizer.  Returns false if the relocation
+// info section changes size.
+static bool PatchPositionsInOptimizedCode(
+    Code* code,
+    Handle<JSArray> position_change_array) {
+  RelocInfoBuffer buffer_writer(code->relocation_size(),
+                                code->instruction_start());
+  TranslatePositionsInRelocInfo(code, position_change_array, &buffer_writer);
+
+  Vector<byte> buffer = buffer_writer.GetResult();
+  if (buffer.length() != code->relocation_size()) return false;
+  memcpy(code->relocation_start(), buffer.start(), buffer.length());
+  return true;
+}
+
+
+// Returns true if function's optimized code inlined a function from another
+// script, whose positions cannot be translated with this script's changes.
+static bool InlinesOtherScripts(JSFunction* function) {
+  DeoptimizationInputData* data =
+      DeoptimizationInputData::cast(function->code()->deoptimization_data());
+  if (data == HEAP->empty_fixed_array()) return true;
+
+  FixedArray* literals = data->LiteralArray();
+  int inlined_count = data->InlinedFunctionCount()->value();
+  for (int i = 0; i < inlined_count; ++i) {
+    JSFunction* inlined = JSFunction::cast(literals->get(i));
+    if (inlined->shared()->script() != function->shared()->script()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Collects the optimized closures of a function and the optimized functions
+// from other scripts that inlined it.
+class PositionDependentFunctionsCollector : public OptimizedFunctionVisitor {
+ public:
+  explicit PositionDependentFunctionsCollector(
+      SharedFunctionInfo* function_info)
+      : function_info_(function_info) {}
+
+  virtual void EnterContext(Context* context) {
+  }
+
+  virtual void VisitFunction(JSFunction* function) {
+    if (function->shared() == function_info_) {
+      closures_.Add(function);
+    } else if (function->shared()->script() != function_info_->script() &&
+               IsInlined(function, function_info_)) {
+      // Functions of the same script get their own positions patched.
+      inliners_.Add(function);
+    }
+  }
+
+  virtual void LeaveContext(Context* context) {
+  }
+
+  const List<JSFunction*>* closures() const { return &closures_; }
+  const List<JSFunction*>* inliners() const { return &inliners_; }
+
+ private:
+  SharedFunctionInfo* function_info_;
+  List<JSFunction*> closures_;
+  List<JSFunction*> inliners_;
+};
+
+
+// Keeps the optimized code of a function whose source did not change, only
+// translating its positions.  Optimized code that cannot be patched in place
+// is deoptimized instead.
+static void PatchPositionsInOptimizedFunctions(
+    SharedFunctionInfo* function_info,
+    Handle<JSArray> position_change_array) {
+  AssertNoAllocation no_allocation;
+
+  PositionDependentFunctionsCollector collector(function_info);
+  Deoptimizer::VisitAllOptimizedFunctions(&collector);
+  const List<JSFunction*>* closures = collector.closures();
+  for (int i = 0; i < closures->length(); i++) {
+    JSFunction* function = closures->at(i);
+    if (InlinesOtherScripts(function) ||
+        !PatchPositionsInOptimizedCode(function->code(),
+                                       position_change_array)) {
+      Deoptimizer::DeoptimizeFunction(function);
+    }
+  }
+  const List<JSFunction*>* inliners = collector.inliners();
+  for (int i = 0; i < inliners->length(); i++) {
+    Deoptimizer::DeoptimizeFunction(inliners->at(i));
+  }
+}
+
+
 MaybeObject* LiveEdit::PatchFunctionPositions(
     Handle<JSArray> shared_info_array, Handle<JSArray> position_change_array) {
 
@@ -1335,6 +1437,9 @@ MaybeObject* LiveEdit::PatchFunctionPositions(
     }
   }
 
+  PatchPositionsInOptimizedFunctions(*info, position_change_array);
+  Isolate::Current()->compilation_cache()->Remove(info);
+
   return HEAP->undefined_value();
 }
 
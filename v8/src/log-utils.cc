@@ -37,10 +37,86 @@ namespace internal {
 const char* const Log::kLogToTemporaryFile = "&";
 
 
+LogWriter::LogWriter(FILE* output)
+    : Thread("v8:LogWriter"),
+      output_(output),
+      buffer_(NewArray<char>(kBufferSize)),
+      head_(0),
+      tail_(0),
+      dropped_(0),
+      semaphore_(OS::CreateSemaphore(0)),
+      stop_thread_(0) {
+  STATIC_ASSERT(IS_POWER_OF_TWO(kBufferSize));
+}
+
+
+LogWriter::~LogWriter() {
+  DeleteArray(buffer_);
+  delete semaphore_;
+}
+
+
+void LogWriter::Run() {
+  while (!Acquire_Load(&stop_thread_)) {
+    semaphore_->Wait(kFlushIntervalMicros);
+    Flush();
+  }
+}
+
+
+void LogWriter::Stop() {
+  Release_Store(&stop_thread_, static_cast<AtomicWord>(true));
+  semaphore_->Signal();
+  Join();
+  Flush();
+  if (dropped_ > 0) {
+    fprintf(output_, "log-dropped,%d\n", dropped_);
+    fflush(output_);
+  }
+}
+
+
+void LogWriter::Write(const char* msg, int length) {
+  const uint32_t size = kBufferSize;
+  uint32_t head = static_cast<uint32_t>(head_);
+  uint32_t used = head - static_cast<uint32_t>(Acquire_Load(&tail_));
+  if (static_cast<uint32_t>(length) > size - used) {
+    dropped_++;
+    return;
+  }
+  uint32_t start = head & (size - 1);
+  uint32_t first = Min(static_cast<uint32_t>(length), size - start);
+  memcpy(buffer_ + start, msg, first);
+  memcpy(buffer_, msg + first, length - first);
+  Release_Store(&head_, static_cast<Atomic32>(head + length));
+  // Do not wait for the next interval when the buffer fills up quickly.
+  if (used < size / 2 && used + length >= size / 2) semaphore_->Signal();
+}
+
+
+void LogWriter::Flush() {
+  const uint32_t size = kBufferSize;
+  uint32_t tail = static_cast<uint32_t>(tail_);
+  uint32_t head = static_cast<uint32_t>(Acquire_Load(&head_));
+  if (head == tail) return;
+  uint32_t start = tail & (size - 1);
+  uint32_t length = head - tail;
+  uint32_t first = Min(length, size - start);
+  fwrite(buffer_ + start, 1, first, output_);
+  if (first < length) fwrite(buffer_, 1, length - first, output_);
+  fflush(output_);
+  Release_Store(&tail_, static_cast<Atomic32>(head));
+}
+
+
 Log::Log(Logger* logger)
   : is_stopped_(false),
     output_handle_(NULL),
+    writer_(NULL),
     ll_output_handle_(NULL),
+    binary_output_handle_(NULL),
+    perf_output_handle_(NULL),
+    perf_jit_output_handle_(NULL),
     mutex_(NULL),
     message_buffer_(NULL),
     logger_(logger) {
@@ -67,6 +143,7 @@ void Log::Initialize() {
     FLAG_log_suspect = true;
     FLAG_log_handles = true;
     FLAG_log_regexp = true;
+    FLAG_log_ic = true;
   }
 
   // --prof implies --log-code.
@@ -80,7 +157,8 @@ void Log::Initialize() {
 
   bool open_log_file = FLAG_log || FLAG_log_runtime || FLAG_log_api
       || FLAG_log_code || FLAG_log_gc || FLAG_log_handles || FLAG_log_suspect
-      || FLAG_log_regexp || FLAG_log_state_changes || FLAG_ll_prof;
+      || FLAG_log_regexp || FLAG_log_state_changes || FLAG_ll_prof
+      || FLAG_log_ic;
 
   // If we're logging anything, we need to open the log file.
   if (open_log_file) {
@@ -132,6 +210,15 @@ void Log::Initialize() {
       }
     }
   }
+
+  if (FLAG_perf_basic_prof || FLAG_perf_jit_prof) OpenPerfFiles();
+
+  // Output to stdout stays synchronous, so that it is not interleaved with
+  // what the program prints itself.
+  if (FLAG_log_async && output_handle_ != NULL && output_handle_ != stdout) {
+    writer_ = new LogWriter(output_handle_);
+    writer_->Start();
+  }
 }
 
 
@@ -154,6 +241,9 @@ static const char kLowLevelLogExt[] = ".ll";
 // minimize the associated overhead.
 static const int kLowLevelLogBufferSize = 2 * MB;
 
+// Extension added to V8 log file name to get the binary log name.
+static const char kBinaryLogExt[] = ".bin";
+
 
 void Log::OpenFile(const char* name) {
   ASSERT(!IsEnabled());
@@ -167,11 +257,62 @@ void Log::OpenFile(const char* name) {
     ll_output_handle_ = OS::FOpen(ll_name.start(), OS::LogFileOpenMode);
     setvbuf(ll_output_handle_, NULL, _IOFBF, kLowLevelLogBufferSize);
   }
+  if (FLAG_prof_binary) {
+    size_t len = strlen(name);
+    ScopedVector<char> binary_name(
+        static_cast<int>(len + sizeof(kBinaryLogExt)));
+    memcpy(binary_name.start(), name, len);
+    memcpy(binary_name.start() + len, kBinaryLogExt, sizeof(kBinaryLogExt));
+    binary_output_handle_ =
+        OS::FOpen(binary_name.start(), OS::LogFileOpenMode);
+    if (binary_output_handle_ != NULL) {
+      setvbuf(binary_output_handle_, NULL, _IOFBF, kLowLevelLogBufferSize);
+      fwrite(BinaryLogFormat::kMagic, 1, BinaryLogFormat::kMagicSize,
+             binary_output_handle_);
+      fputc(kPointerSize, binary_output_handle_);
+    }
+  }
+}
+
+
+// perf looks for the symbols of a process's generated code in this file.
+static const char kPerfMapFileFormat[] = "/tmp/perf-%d.map";
+
+// perf inject --jit recognizes dump files by this name.
+static const char kPerfJitDumpFileFormat[] = "jit-%d.dump";
+
+
+void Log::OpenPerfFiles() {
+  // Both files are per process, so only the default isolate writes them.
+  if (!Isolate::Current()->IsDefaultIsolate()) return;
+  int pid = OS::GetCurrentProcessId();
+  EmbeddedVector<char, 64> name;
+  if (FLAG_perf_basic_prof) {
+    OS::SNPrintF(name, kPerfMapFileFormat, pid);
+    perf_output_handle_ = OS::FOpen(name.start(), OS::LogFileOpenMode);
+    // Keep the map usable while the process is still running.
+    if (perf_output_handle_ != NULL) {
+      setvbuf(perf_output_handle_, NULL, _IOLBF, BUFSIZ);
+    }
+  }
+  if (FLAG_perf_jit_prof) {
+    OS::SNPrintF(name, kPerfJitDumpFileFormat, pid);
+    // The file is opened for reading too, so that it can be mapped.
+    perf_jit_output_handle_ = OS::FOpen(name.start(), "w+");
+    if (perf_jit_output_handle_ != NULL) {
+      setvbuf(perf_jit_output_handle_, NULL, _IOFBF, kLowLevelLogBufferSize);
+    }
+  }
 }
 
 
 FILE* Log::Close() {
   FILE* result = NULL;
+  if (writer_ != NULL) {
+    writer_->Stop();
+    delete writer_;
+    writer_ = NULL;
+  }
   if (output_handle_ != NULL) {
     if (strcmp(FLAG_logfile, kLogToTemporaryFile) != 0) {
       fclose(output_handle_);
@@ -182,6 +323,12 @@ FILE* Log::Close() {
   output_handle_ = NULL;
   if (ll_output_handle_ != NULL) fclose(ll_output_handle_);
   ll_output_handle_ = NULL;
+  if (binary_output_handle_ != NULL) fclose(binary_output_handle_);
+  binary_output_handle_ = NULL;
+  if (perf_output_handle_ != NULL) fclose(perf_output_handle_);
+  perf_output_handle_ = NULL;
+  if (perf_jit_output_handle_ != NULL) fclose(perf_jit_output_handle_);
+  perf_jit_output_handle_ = NULL;
 
   DeleteArray(message_buffer_);
   message_buffer_ = NULL;
@@ -29,12 +29,58 @@
 #define V8_LOG_UTILS_H_
 
 #include "allocation.h"
+#include "atomicops.h"
+#include "platform.h"
 
 namespace v8 {
 namespace internal {
 
 class Logger;
 
+
+// Writes the log file on a background thread (--log-async), so that the
+// threads that log only copy their formatted messages into a ring buffer.
+// Messages are added while holding the log mutex, so there is a single
+// producer and a single consumer, which publish their positions in the
+// buffer with release stores.  A message that does not fit in the buffer is
+// dropped and counted, and the count is written at the end of the log.
+class LogWriter : public Thread {
+ public:
+  explicit LogWriter(FILE* output);
+  ~LogWriter();
+
+  void Run();
+
+  // Writes the remaining messages and the number of dropped ones, and joins
+  // the thread.
+  void Stop();
+
+  // Copies a message into the buffer.  Called with the log mutex held.
+  void Write(const char* msg, int length);
+
+  int dropped() const { return dropped_; }
+
+ private:
+  // Writes the messages added so far to the file.
+  void Flush();
+
+  // Must be a power of two.
+  static const int kBufferSize = 4 * MB;
+  // The thread also wakes up to write when the buffer is half full.
+  static const int kFlushIntervalMicros = 20000;
+
+  FILE* output_;
+  char* buffer_;
+  // Both positions only grow, wrapping around at 2^32; the index into the
+  // buffer is the position modulo kBufferSize.
+  volatile Atomic32 head_;  // Written by the logging threads.
+  volatile Atomic32 tail_;  // Written by the writer thread.
+  int dropped_;
+  Semaphore* semaphore_;
+  volatile AtomicWord stop_thread_;
+};
+
+
 // Functions and data for performing output of log messages.
 class Log {
  public:
@@ -54,6 +100,17 @@ class Log {
     return !is_stopped_ && output_handle_ != NULL;
   }
 
+  // Returns whether code and tick events go to the --prof-binary file.
+  bool IsBinaryEnabled() {
+    return !is_stopped_ && binary_output_handle_ != NULL;
+  }
+
+  // Returns whether code events go to a perf map or jitdump file.
+  bool IsPerfEnabled() {
+    return !is_stopped_ &&
+        (perf_output_handle_ != NULL || perf_jit_output_handle_ != NULL);
+  }
+
   // Size of buffer used for formatting log messages.
   static const int kMessageBufferSize = 2048;
 
@@ -73,9 +130,17 @@ class Log {
   // Opens a temporary file for logging.
   void OpenTemporaryFile();
 
+  // Opens the files for perf requested by --perf-basic-prof and
+  // --perf-jit-prof.
+  void OpenPerfFiles();
+
   // Implementation of writing to a log file.
   int WriteToFile(const char* msg, int length) {
     ASSERT(output_handle_ != NULL);
+    if (writer_ != NULL) {
+      writer_->Write(msg, length);
+      return length;
+    }
     size_t rv = fwrite(msg, 1, length, output_handle_);
     ASSERT(static_cast<size_t>(length) == rv);
     USE(rv);
@@ -90,9 +155,22 @@ class Log {
   // destination.  mutex_ should be acquired before using output_handle_.
   FILE* output_handle_;
 
+  // Writes to output_handle_ on a background thread with --log-async.
+  LogWriter* writer_;
+
   // Used when low-level profiling is active.
   FILE* ll_output_handle_;
 
+  // The binary log of code and tick events, used with --prof-binary.
+  // mutex_ should be acquired before using it.
+  FILE* binary_output_handle_;
+
+  // The perf map file, used with --perf-basic-prof.
+  FILE* perf_output_handle_;
+
+  // The jitdump file, used with --perf-jit-prof.
+  FILE* perf_jit_output_handle_;
+
   // mutex_ is a Mutex used for enforcing exclusive
   // access to the formatting buffer and the log file or log memory buffer.
   Mutex* mutex_;
@@ -366,6 +366,40 @@ struct LowLevelSnapshotPositionStruct {
 static const char kCodeMovingGCTag = 'G';
 
 
+// Structures of perf's jitdump format, as described by
+// tools/perf/Documentation/jitdump-specification.txt in the Linux sources.
+
+struct PerfJitHeader {
+  static const uint32_t kMagic = 0x4A695444;
+  static const uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t total_size;
+  uint32_t elf_mach;
+  uint32_t pad1;
+  uint32_t pid;
+  uint64_t timestamp;
+  uint64_t flags;
+};
+
+
+// Followed by the null-terminated name and the code bytes.
+struct PerfJitCodeLoad {
+  static const uint32_t kId = 0;
+
+  uint32_t id;
+  uint32_t total_size;
+  uint64_t timestamp;
+  uint32_t pid;
+  uint32_t tid;
+  uint64_t vma;
+  uint64_t code_address;
+  uint64_t code_size;
+  uint64_t code_index;
+};
+
+
 //
 // Logger class implementation.
 //
@@ -387,6 +421,14 @@ class Logger::NameMap {
     }
   }
 
+  // Like Insert, but replaces the name of dead code that used to live at
+  // the same address.
+  void Set(Address code_address, const char* name, int name_size) {
+    HashMap::Entry* entry = FindOrCreateEntry(code_address);
+    DeleteArray(static_cast<char*>(entry->value));
+    entry->value = CopyName(name, name_size);
+  }
+
   const char* Lookup(Address code_address) {
     HashMap::Entry* entry = FindEntry(code_address);
     return (entry != NULL) ? static_cast<const char*>(entry->value) : NULL;
@@ -512,6 +554,56 @@ class Logger::NameBuffer {
 };
 
 
+const char BinaryLogFormat::kMagic[] = "v8binlog";
+
+
+// Encodes a record of the --prof-binary log, see BinaryLogFormat.
+class Logger::BinaryRecord {
+ public:
+  explicit BinaryRecord(BinaryLogFormat::RecordType type)
+      : size_(0), previous_address_(0) {
+    AppendByte(type);
+  }
+
+  void AppendUnsigned(uintptr_t value) {
+    while (value >= 0x80) {
+      AppendByte(static_cast<int>(value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    AppendByte(static_cast<int>(value));
+  }
+
+  void AppendAddress(Address address) {
+    intptr_t delta = reinterpret_cast<intptr_t>(address) - previous_address_;
+    previous_address_ = reinterpret_cast<intptr_t>(address);
+    AppendUnsigned((static_cast<uintptr_t>(delta) << 1) ^
+                   static_cast<uintptr_t>(delta >> (kBitsPerPointer - 1)));
+  }
+
+  void AppendName(const char* name, int length) {
+    AppendUnsigned(length);
+    for (int i = 0; i < length; i++) AppendByte(name[i]);
+  }
+
+  const byte* data() const { return buffer_; }
+  int size() const { return size_; }
+
+ private:
+  void AppendByte(int value) {
+    ASSERT(size_ < kMaxSize);
+    if (size_ < kMaxSize) buffer_[size_++] = static_cast<byte>(value);
+  }
+
+  // Enough for a tick with TickSample::kMaxFramesCount frames and for a
+  // name from the NameBuffer.
+  static const int kMaxSize = 1024;
+
+  int size_;
+  intptr_t previous_address_;
+  byte buffer_[kMaxSize];
+};
+
+
 Logger::Logger()
   : ticker_(NULL),
     profiler_(NULL),
@@ -522,6 +614,8 @@ Logger::Logger()
     log_(new Log(this)),
     name_buffer_(new NameBuffer),
     address_to_name_map_(NULL),
+    perf_name_map_(NULL),
+    perf_jit_code_index_(0),
     is_initialized_(false),
     last_address_(NULL),
     prev_sp_(NULL),
@@ -533,6 +627,7 @@ Logger::Logger()
 
 Logger::~Logger() {
   delete address_to_name_map_;
+  delete perf_name_map_;
   delete name_buffer_;
   delete log_;
 }
@@ -632,6 +727,14 @@ void Logger::SharedLibraryEvent(const char* library_path,
                                 uintptr_t start,
                                 uintptr_t end) {
   if (!log_->IsEnabled() || !FLAG_prof) return;
+  if (log_->IsBinaryEnabled()) {
+    BinaryRecord record(BinaryLogFormat::kSharedLibrary);
+    record.AppendAddress(reinterpret_cast<Address>(start));
+    record.AppendAddress(reinterpret_cast<Address>(end));
+    record.AppendName(library_path, StrLength(library_path));
+    BinaryLogWriteRecord(record);
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("shared-library,\"%s\",0x%08" V8PRIxPTR ",0x%08" V8PRIxPTR "\n",
              library_path,
@@ -645,6 +748,21 @@ void Logger::SharedLibraryEvent(const wchar_t* library_path,
                                 uintptr_t start,
                                 uintptr_t end) {
   if (!log_->IsEnabled() || !FLAG_prof) return;
+  if (log_->IsBinaryEnabled()) {
+    // Only the ASCII characters of the path are kept.
+    EmbeddedVector<char, 256> path;
+    int length = 0;
+    for (; length < path.length() && library_path[length] != 0; length++) {
+      wchar_t c = library_path[length];
+      path[length] = c < 0x80 ? static_cast<char>(c) : '?';
+    }
+    BinaryRecord record(BinaryLogFormat::kSharedLibrary);
+    record.AppendAddress(reinterpret_cast<Address>(start));
+    record.AppendAddress(reinterpret_cast<Address>(end));
+    record.AppendName(path.start(), length);
+    BinaryLogWriteRecord(record);
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("shared-library,\"%ls\",0x%08" V8PRIxPTR ",0x%08" V8PRIxPTR "\n",
              library_path,
@@ -823,6 +941,15 @@ void Logger::DeleteEventStatic(const char* name, void* object) {
 void Logger::CallbackEventInternal(const char* prefix, const char* name,
                                    Address entry_point) {
   if (!log_->IsEnabled() || !FLAG_log_code) return;
+  if (log_->IsBinaryEnabled()) {
+    name_buffer_->Reset();
+    name_buffer_->AppendBytes(kLogEventsNames[CALLBACK_TAG]);
+    name_buffer_->AppendByte(':');
+    name_buffer_->AppendBytes(prefix);
+    name_buffer_->AppendBytes(name);
+    BinaryCodeCreateEvent(CALLBACK_TAG, entry_point, 1);
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("%s,%s,",
              kLogEventsNames[CODE_CREATION_EVENT],
@@ -861,8 +988,9 @@ void Logger::SetterCallbackEvent(String* name, Address entry_point) {
 void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              const char* comment) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || log_->IsPerfEnabled() || log_->IsBinaryEnabled() ||
+      Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -871,10 +999,17 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (log_->IsPerfEnabled()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
-  if (!FLAG_log_code) return;
+  if (!log_->IsEnabled() || !FLAG_log_code) return;
+  if (log_->IsBinaryEnabled()) {
+    BinaryCodeCreateEvent(tag, code->address(), code->ExecutableSize());
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("%s,%s,",
              kLogEventsNames[CODE_CREATION_EVENT],
@@ -896,8 +1031,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
 void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              String* name) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || log_->IsPerfEnabled() || log_->IsBinaryEnabled() ||
+      Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -906,10 +1042,17 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (log_->IsPerfEnabled()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
-  if (!FLAG_log_code) return;
+  if (!log_->IsEnabled() || !FLAG_log_code) return;
+  if (log_->IsBinaryEnabled()) {
+    BinaryCodeCreateEvent(tag, code->address(), code->ExecutableSize());
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("%s,%s,",
              kLogEventsNames[CODE_CREATION_EVENT],
@@ -937,8 +1080,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              SharedFunctionInfo* shared,
                              String* name) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || log_->IsPerfEnabled() || log_->IsBinaryEnabled() ||
+      Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -948,14 +1092,21 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (log_->IsPerfEnabled()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
-  if (!FLAG_log_code) return;
+  if (!log_->IsEnabled() || !FLAG_log_code) return;
   if (code == Isolate::Current()->builtins()->builtin(
       Builtins::kLazyCompile))
     return;
 
+  if (log_->IsBinaryEnabled()) {
+    BinaryCodeCreateEvent(tag, code->address(), code->ExecutableSize());
+    return;
+  }
   LogMessageBuilder msg(this);
   SmartArrayPointer<char> str =
       name->ToCString(DISALLOW_NULLS, ROBUST_STRING_TRAVERSAL);
@@ -978,8 +1129,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              SharedFunctionInfo* shared,
                              String* source, int line) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || log_->IsPerfEnabled() || log_->IsBinaryEnabled() ||
+      Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -993,10 +1145,17 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (log_->IsPerfEnabled()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
-  if (!FLAG_log_code) return;
+  if (!log_->IsEnabled() || !FLAG_log_code) return;
+  if (log_->IsBinaryEnabled()) {
+    BinaryCodeCreateEvent(tag, code->address(), code->ExecutableSize());
+    return;
+  }
   LogMessageBuilder msg(this);
   SmartArrayPointer<char> name =
       shared->DebugName()->ToCString(DISALLOW_NULLS, ROBUST_STRING_TRAVERSAL);
@@ -1019,8 +1178,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
 
 
 void Logger::CodeCreateEvent(LogEventsAndTags tag, Code* code, int args_count) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || log_->IsPerfEnabled() || log_->IsBinaryEnabled() ||
+      Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -1029,10 +1189,17 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag, Code* code, int args_count) {
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (log_->IsPerfEnabled()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
-  if (!FLAG_log_code) return;
+  if (!log_->IsEnabled() || !FLAG_log_code) return;
+  if (log_->IsBinaryEnabled()) {
+    BinaryCodeCreateEvent(tag, code->address(), code->ExecutableSize());
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("%s,%s,",
              kLogEventsNames[CODE_CREATION_EVENT],
@@ -1052,8 +1219,9 @@ void Logger::CodeMovingGCEvent() {
 
 
 void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || log_->IsPerfEnabled() || log_->IsBinaryEnabled() ||
+      Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[REG_EXP_TAG]);
     name_buffer_->AppendByte(':');
@@ -1062,10 +1230,19 @@ void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (log_->IsPerfEnabled()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
-  if (!FLAG_log_code) return;
+  if (!log_->IsEnabled() || !FLAG_log_code) return;
+  if (log_->IsBinaryEnabled()) {
+    BinaryCodeCreateEvent(REG_EXP_TAG,
+                          code->address(),
+                          code->ExecutableSize());
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("%s,%s,",
              kLogEventsNames[CODE_CREATION_EVENT],
@@ -1080,25 +1257,55 @@ void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
 
 
 void Logger::CodeMoveEvent(Address from, Address to) {
-  if (!log_->IsEnabled()) return;
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
   if (FLAG_ll_prof) LowLevelCodeMoveEvent(from, to);
+  if (log_->IsPerfEnabled()) PerfCodeMoveEvent(from, to);
   if (Serializer::enabled() && address_to_name_map_ != NULL) {
     address_to_name_map_->Move(from, to);
   }
+  if (log_->IsBinaryEnabled() && FLAG_log_code) {
+    BinaryRecord record(BinaryLogFormat::kCodeMove);
+    record.AppendAddress(from);
+    record.AppendAddress(to);
+    BinaryLogWriteRecord(record);
+    return;
+  }
   MoveEventInternal(CODE_MOVE_EVENT, from, to);
 }
 
 
 void Logger::CodeDeleteEvent(Address from) {
-  if (!log_->IsEnabled()) return;
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
   if (FLAG_ll_prof) LowLevelCodeDeleteEvent(from);
+  if (log_->IsPerfEnabled()) PerfCodeDeleteEvent(from);
   if (Serializer::enabled() && address_to_name_map_ != NULL) {
     address_to_name_map_->Remove(from);
   }
+  if (log_->IsBinaryEnabled() && FLAG_log_code) {
+    BinaryRecord record(BinaryLogFormat::kCodeDelete);
+    record.AppendAddress(from);
+    BinaryLogWriteRecord(record);
+    return;
+  }
   DeleteEventInternal(CODE_DELETE_EVENT, from);
 }
 
 
+void Logger::CodeDisableOptEvent(Code* code, SharedFunctionInfo* shared) {
+  if (!log_->IsEnabled() || !FLAG_log_code) return;
+  LogMessageBuilder msg(this);
+  msg.Append("%s,", kLogEventsNames[CODE_DISABLE_OPT_EVENT]);
+  msg.AppendAddress(code->address());
+  msg.Append(",\"");
+  msg.AppendDetailed(shared->DebugName(), false);
+  msg.Append("\",\"");
+  Object* reason = shared->last_bailout_reason();
+  if (reason->IsString()) msg.AppendDetailed(String::cast(reason), false);
+  msg.Append("\"\n");
+  msg.WriteToLogFile();
+}
+
+
 void Logger::SnapshotPositionEvent(Address addr, int pos) {
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) LowLevelSnapshotPositionEvent(addr, pos);
@@ -1186,6 +1393,29 @@ void Logger::SuspectReadEvent(String* name, Object* obj) {
 }
 
 
+void Logger::ICTransitionEvent(const char* type,
+                               SharedFunctionInfo* shared,
+                               int position,
+                               char old_state,
+                               char new_state,
+                               int maps_count) {
+  if (!log_->IsEnabled() || !FLAG_log_ic) return;
+  LogMessageBuilder msg(this);
+  SmartArrayPointer<char> name = shared->DebugName()->ToCString();
+  msg.Append("ic-transition,%s,\"%s\",", type, *name);
+  if (shared->script()->IsScript() &&
+      Script::cast(shared->script())->name()->IsString()) {
+    msg.Append('"');
+    msg.Append(String::cast(Script::cast(shared->script())->name()));
+    msg.Append('"');
+  } else {
+    msg.Append("\"\"");
+  }
+  msg.Append(",%d,%c,%c,%d\n", position, old_state, new_state, maps_count);
+  msg.WriteToLogFile();
+}
+
+
 void Logger::HeapSampleBeginEvent(const char* space, const char* kind) {
   if (!log_->IsEnabled() || !FLAG_log_gc) return;
   LogMessageBuilder msg(this);
@@ -1240,6 +1470,26 @@ void Logger::DebugEvent(const char* event_type, Vector<uint16_t> parameter) {
 
 void Logger::TickEvent(TickSample* sample, bool overflow) {
   if (!log_->IsEnabled() || !FLAG_prof) return;
+  if (log_->IsBinaryEnabled()) {
+    BinaryRecord record(BinaryLogFormat::kTick);
+    record.AppendUnsigned(sample->state);
+    int flags = 0;
+    if (sample->has_external_callback) {
+      flags |= BinaryLogFormat::kHasExternalCallback;
+    }
+    if (overflow) flags |= BinaryLogFormat::kOverflow;
+    record.AppendUnsigned(flags);
+    record.AppendAddress(sample->pc);
+    record.AppendAddress(sample->has_external_callback
+                         ? sample->external_callback
+                         : sample->tos);
+    record.AppendUnsigned(sample->frames_count);
+    for (int i = 0; i < sample->frames_count; ++i) {
+      record.AppendAddress(sample->stack[i]);
+    }
+    BinaryLogWriteRecord(record);
+    return;
+  }
   LogMessageBuilder msg(this);
   msg.Append("%s,", kLogEventsNames[TICK_EVENT]);
   msg.AppendAddress(sample->pc);
@@ -1389,7 +1639,7 @@ static int EnumerateCompiledFunctions(Handle<SharedFunctionInfo>* sfis,
 
 
 void Logger::LogCodeObject(Object* object) {
-  if (FLAG_log_code || FLAG_ll_prof) {
+  if (FLAG_log_code || FLAG_ll_prof || log_->IsPerfEnabled()) {
     Code* code_object = Code::cast(object);
     LogEventsAndTags tag = Logger::STUB_TAG;
     const char* description = "Unknown code from the snapshot";
@@ -1520,6 +1770,127 @@ void Logger::LowLevelLogWriteBytes(const char* bytes, int size) {
 }
 
 
+void Logger::BinaryCodeCreateEvent(LogEventsAndTags tag,
+                                   Address address,
+                                   int size) {
+  // The tag is written as a number.
+  int prefix = Min(StrLength(kLogEventsNames[tag]) + 1, name_buffer_->size());
+  BinaryRecord record(BinaryLogFormat::kCodeCreation);
+  record.AppendUnsigned(tag);
+  record.AppendAddress(address);
+  record.AppendUnsigned(size);
+  record.AppendName(name_buffer_->get() + prefix,
+                    name_buffer_->size() - prefix);
+  BinaryLogWriteRecord(record);
+}
+
+
+void Logger::BinaryLogWriteRecord(const BinaryRecord& record) {
+  // Ticks are written by the profiler thread.
+  ScopedLock lock(log_->mutex_);
+  size_t rv = fwrite(record.data(), 1, record.size(),
+                     log_->binary_output_handle_);
+  ASSERT(static_cast<size_t>(record.size()) == rv);
+  USE(rv);
+}
+
+
+void Logger::PerfCodeCreateEvent(Code* code,
+                                  const char* name,
+                                  int name_size) {
+  if (perf_name_map_ == NULL) perf_name_map_ = new NameMap;
+  // Names are kept to report the code again when it moves.
+  perf_name_map_->Set(code->address(), name, name_size);
+  PerfWriteCode(code->instruction_start(),
+                code->instruction_start(),
+                code->instruction_size(),
+                perf_name_map_->Lookup(code->address()));
+}
+
+
+void Logger::PerfCodeMoveEvent(Address from, Address to) {
+  if (perf_name_map_ == NULL) return;
+  const char* name = perf_name_map_->Lookup(from);
+  if (name == NULL) return;
+  // The code has not been copied yet, so it can still be read at from.
+  Code* code = Code::cast(HeapObject::FromAddress(from));
+  Address instructions = code->instruction_start();
+  PerfWriteCode(to + (instructions - from),
+                instructions,
+                code->instruction_size(),
+                name);
+  perf_name_map_->Set(to, name, StrLength(name));
+  perf_name_map_->Remove(from);
+}
+
+
+void Logger::PerfCodeDeleteEvent(Address from) {
+  if (perf_name_map_ != NULL) perf_name_map_->Remove(from);
+}
+
+
+void Logger::PerfWriteCode(Address address,
+                           Address instructions,
+                           int size,
+                           const char* name) {
+  int name_size = StrLength(name);
+  FILE* map = log_->perf_output_handle_;
+  if (map != NULL) {
+    // Each line of the map is "<start> <size> <name>" in hex.
+    fprintf(map, "%" V8PRIxPTR " %x ", reinterpret_cast<intptr_t>(address),
+            size);
+    for (int i = 0; i < name_size; i++) {
+      fputc(name[i] == '\n' ? ' ' : name[i], map);
+    }
+    fputc('\n', map);
+  }
+  FILE* jit_dump = log_->perf_jit_output_handle_;
+  if (jit_dump != NULL) {
+    PerfJitCodeLoad event;
+    event.id = PerfJitCodeLoad::kId;
+    event.total_size = sizeof(event) + name_size + 1 + size;
+    event.timestamp = OS::MonotonicNanoseconds();
+    event.pid = OS::GetCurrentProcessId();
+    event.tid = event.pid;
+    event.vma = reinterpret_cast<uintptr_t>(address);
+    event.code_address = event.vma;
+    event.code_size = size;
+    event.code_index = perf_jit_code_index_++;
+    fwrite(&event, sizeof(event), 1, jit_dump);
+    fwrite(name, name_size + 1, 1, jit_dump);
+    fwrite(instructions, size, 1, jit_dump);
+  }
+}
+
+
+void Logger::PerfJitLogHeader() {
+  FILE* jit_dump = log_->perf_jit_output_handle_;
+  if (jit_dump == NULL) return;
+  PerfJitHeader header;
+  header.magic = PerfJitHeader::kMagic;
+  header.version = PerfJitHeader::kVersion;
+  header.total_size = sizeof(header);
+  // ELF machine numbers from elf.h.
+#if V8_TARGET_ARCH_IA32
+  header.elf_mach = 3;  // EM_386
+#elif V8_TARGET_ARCH_X64
+  header.elf_mach = 62;  // EM_X86_64
+#elif V8_TARGET_ARCH_ARM
+  header.elf_mach = 40;  // EM_ARM
+#elif V8_TARGET_ARCH_MIPS
+  header.elf_mach = 8;  // EM_MIPS
+#else
+  header.elf_mach = 0;  // EM_NONE
+#endif
+  header.pad1 = 0;
+  header.pid = OS::GetCurrentProcessId();
+  header.timestamp = OS::MonotonicNanoseconds();
+  header.flags = 0;
+  fwrite(&header, sizeof(header), 1, jit_dump);
+  OS::SignalJitDumpFile(jit_dump);
+}
+
+
 void Logger::LogCodeObjects() {
   HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
   HeapIterator iterator;
@@ -1638,6 +2009,7 @@ bool Logger::Setup() {
   log_->Initialize();
 
   if (FLAG_ll_prof) LogCodeInfo();
+  if (FLAG_perf_jit_prof) PerfJitLogHeader();
 
   Isolate* isolate = Isolate::Current();
   ticker_ = new Ticker(isolate, kSamplingIntervalMs);
@@ -1648,7 +2020,8 @@ bool Logger::Setup() {
 
   bool start_logging = FLAG_log || FLAG_log_runtime || FLAG_log_api
     || FLAG_log_code || FLAG_log_gc || FLAG_log_handles || FLAG_log_suspect
-    || FLAG_log_regexp || FLAG_log_state_changes || FLAG_ll_prof;
+    || FLAG_log_regexp || FLAG_log_state_changes || FLAG_ll_prof
+    || FLAG_log_ic || log_->IsPerfEnabled();
 
   if (start_logging) {
     logging_nesting_ = 1;
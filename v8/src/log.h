@@ -29,6 +29,7 @@
 #define V8_LOG_H_
 
 #include "allocation.h"
+#include "hashmap.h"
 #include "objects.h"
 #include "platform.h"
 #include "log-utils.h"
@@ -69,9 +70,12 @@ namespace internal {
 // --prof
 // Collect statistical profiling information (ticks), default is off.  The
 // tick profiler requires code events, so --prof implies --log-code.
+//
+// --prof-binary
+// Used with --prof, writes the code and tick events to <logfile>.bin in the
+// binary form described by BinaryLogFormat, for the native tick-processor.
 
 // Forward declarations.
-class HashMap;
 class LogMessageBuilder;
 class Profiler;
 class Semaphore;
@@ -91,6 +95,7 @@ class Ticker;
   V(CODE_CREATION_EVENT,            "code-creation")                    \
   V(CODE_MOVE_EVENT,                "code-move")                        \
   V(CODE_DELETE_EVENT,              "code-delete")                      \
+  V(CODE_DISABLE_OPT_EVENT,         "code-disable-optimization")        \
   V(CODE_MOVING_GC,                 "code-moving-gc")                   \
   V(SHARED_FUNC_MOVE_EVENT,         "sfi-move")                         \
   V(SNAPSHOT_POSITION_EVENT,        "snapshot-pos")                     \
@@ -140,6 +145,38 @@ class Ticker;
 class Sampler;
 
 
+// The file written with --prof-binary starts with kMagic and a byte holding
+// the size of a pointer, followed by records.  A record is its type byte and
+// the fields below.  Numbers are unsigned base 128, least significant group
+// first.  Each address is the zigzag encoded difference to the previous
+// address of the same record, so that the addresses of a stack take only a
+// few bytes each.  Names are their length and their UTF-8 bytes.
+//
+//   kCodeCreation   tag, address, size, name
+//   kCodeMove       from, to
+//   kCodeDelete     address
+//   kTick           state, flags, pc, tos or external callback,
+//                   frame count, frames
+//   kSharedLibrary  start, end, name
+class BinaryLogFormat : public AllStatic {
+ public:
+  enum RecordType {
+    kCodeCreation = 1,
+    kCodeMove,
+    kCodeDelete,
+    kTick,
+    kSharedLibrary
+  };
+
+  // Flags of a tick record.
+  static const int kHasExternalCallback = 1 << 0;
+  static const int kOverflow = 1 << 1;
+
+  static const int kMagicSize = 8;
+  static const char kMagic[kMagicSize + 1];
+};
+
+
 class Logger {
  public:
 #define DECLARE_ENUM(enum_item, ignore) enum_item,
@@ -194,6 +231,15 @@ class Logger {
   // object.
   void SuspectReadEvent(String* name, Object* obj);
 
+  // Emits an event when an inline cache at the given source position of
+  // a function changes state.  States use the --trace-ic marks.
+  void ICTransitionEvent(const char* type,
+                         SharedFunctionInfo* shared,
+                         int position,
+                         char old_state,
+                         char new_state,
+                         int maps_count);
+
   // Emits an event when a message is put on or read from a debugging queue.
   // DebugTag lets us put a call-site specific label on the event.
   void DebugTag(const char* call_site_tag);
@@ -237,6 +283,9 @@ class Logger {
   void CodeMoveEvent(Address from, Address to);
   // Emits a code delete event.
   void CodeDeleteEvent(Address from);
+  // Emits an event with the reason the optimizing compiler gave up on the
+  // function of the code.
+  void CodeDisableOptEvent(Code* code, SharedFunctionInfo* shared);
 
   void SharedFunctionInfoMoveEvent(Address from, Address to);
 
@@ -307,6 +356,7 @@ class Logger {
   void LogFailure();
 
  private:
+  class BinaryRecord;
   class NameBuffer;
   class NameMap;
 
@@ -357,6 +407,31 @@ class Logger {
     LowLevelLogWriteBytes(reinterpret_cast<const char*>(&s), sizeof(s));
   }
 
+  // Support for --prof-binary.
+
+  // Writes a code creation record with the name in name_buffer_, which
+  // starts with the name of the tag and a colon.
+  void BinaryCodeCreateEvent(LogEventsAndTags tag, Address address, int size);
+
+  void BinaryLogWriteRecord(const BinaryRecord& record);
+
+  // Support for the linux perf tool.
+
+  void PerfCodeCreateEvent(Code* code, const char* name, int name_size);
+
+  void PerfCodeMoveEvent(Address from, Address to);
+
+  void PerfCodeDeleteEvent(Address from);
+
+  // Reports size bytes of code, copied from instructions, as living at
+  // address to the perf map and jitdump files.
+  void PerfWriteCode(Address address,
+                     Address instructions,
+                     int size,
+                     const char* name);
+
+  void PerfJitLogHeader();
+
   // Emits a profiler tick event. Used by the profiler thread.
   void TickEvent(TickSample* sample, bool overflow);
 
@@ -410,6 +485,10 @@ class Logger {
 
   NameMap* address_to_name_map_;
 
+  // Names of the code reported to perf, by code address.
+  NameMap* perf_name_map_;
+  uint64_t perf_jit_code_index_;
+
   // Guards against multiple calls to TearDown() that can happen in some tests.
   // 'true' between Setup() and TearDown().
   bool is_initialized_;
@@ -0,0 +1,180 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "lz-codec.h"
+
+namespace v8 {
+namespace internal {
+
+static const int kHashBits = 14;
+static const int kHashTableSize = 1 << kHashBits;
+static const int kMaxNibble = 15;
+
+
+static inline uint32_t ReadUInt32(const byte* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+
+static inline int Hash(uint32_t sequence) {
+  return static_cast<int>((sequence * 2654435761U) >> (32 - kHashBits));
+}
+
+
+static byte* WriteLengthExtension(byte* output, int length) {
+  while (length >= 255) {
+    *output++ = 255;
+    length -= 255;
+  }
+  *output++ = static_cast<byte>(length);
+  return output;
+}
+
+
+// Writes a token with its literals and, if match_length is not zero, the
+// match that follows them.
+static byte* WriteSequence(byte* output,
+                           const byte* literals,
+                           int literal_length,
+                           int offset,
+                           int match_length) {
+  int match_code = match_length == 0 ? 0 : match_length - LZCodec::kMinMatch;
+  byte* token = output++;
+  *token = static_cast<byte>((Min(literal_length, kMaxNibble) << 4) |
+                             Min(match_code, kMaxNibble));
+  if (literal_length >= kMaxNibble) {
+    output = WriteLengthExtension(output, literal_length - kMaxNibble);
+  }
+  memcpy(output, literals, literal_length);
+  output += literal_length;
+  if (match_length == 0) return output;
+  *output++ = static_cast<byte>(offset & 0xFF);
+  *output++ = static_cast<byte>(offset >> 8);
+  if (match_code >= kMaxNibble) {
+    output = WriteLengthExtension(output, match_code - kMaxNibble);
+  }
+  return output;
+}
+
+
+int LZCodec::Compress(Vector<const byte> input, byte* output) {
+  const byte* data = input.start();
+  int length = input.length();
+  // Positions of the last occurrence of each hashed four byte sequence.
+  ScopedVector<int> table(kHashTableSize);
+  for (int i = 0; i < kHashTableSize; i++) table[i] = -1;
+
+  byte* out = output;
+  int anchor = 0;
+  int pos = 0;
+  while (pos + kMinMatch <= length) {
+    uint32_t sequence = ReadUInt32(data + pos);
+    int hash = Hash(sequence);
+    int candidate = table[hash];
+    table[hash] = pos;
+    if (candidate >= 0 &&
+        pos - candidate <= kMaxOffset &&
+        ReadUInt32(data + candidate) == sequence) {
+      int match_length = kMinMatch;
+      while (pos + match_length < length &&
+             data[candidate + match_length] == data[pos + match_length]) {
+        match_length++;
+      }
+      out = WriteSequence(out, data + anchor, pos - anchor,
+                          pos - candidate, match_length);
+      pos += match_length;
+      anchor = pos;
+    } else {
+      pos++;
+    }
+  }
+  out = WriteSequence(out, data + anchor, length - anchor, 0, 0);
+  ASSERT(out - output <= MaxCompressedSize(length));
+  return static_cast<int>(out - output);
+}
+
+
+// Reads the extra length bytes that follow a nibble of 15.  Returns false if
+// the input ends before the length does.
+static bool ReadLengthExtension(const byte** input,
+                                const byte* input_end,
+                                int* length) {
+  int next;
+  do {
+    if (*input >= input_end) return false;
+    next = *(*input)++;
+    *length += next;
+  } while (next == 255);
+  return true;
+}
+
+
+bool LZCodec::Decompress(Vector<const byte> input, Vector<byte> output) {
+  const byte* in = input.start();
+  const byte* in_end = in + input.length();
+  byte* out = output.start();
+  byte* out_end = out + output.length();
+  while (in < in_end) {
+    int token = *in++;
+    int literal_length = token >> 4;
+    if (literal_length == kMaxNibble &&
+        !ReadLengthExtension(&in, in_end, &literal_length)) {
+      return false;
+    }
+    if (literal_length > in_end - in || literal_length > out_end - out) {
+      return false;
+    }
+    memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    if (in == in_end) break;
+
+    if (in_end - in < 2) return false;
+    int offset = in[0] | (in[1] << 8);
+    in += 2;
+    int match_length = token & kMaxNibble;
+    if (match_length == kMaxNibble &&
+        !ReadLengthExtension(&in, in_end, &match_length)) {
+      return false;
+    }
+    match_length += kMinMatch;
+    if (offset == 0 || offset > out - output.start() ||
+        match_length > out_end - out) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, so copy byte by byte.
+    const byte* match = out - offset;
+    for (int i = 0; i < match_length; i++) *out++ = *match++;
+  }
+  return out == out_end;
+}
+
+} }  // namespace v8::internal
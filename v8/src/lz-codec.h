@@ -0,0 +1,69 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_LZ_CODEC_H_
+#define V8_LZ_CODEC_H_
+
+#include "utils.h"
+
+namespace v8 {
+namespace internal {
+
+// A small LZ77 codec in the style of LZ4, used to compress the startup
+// snapshot and the natives sources.  Decompression is a simple copy loop,
+// which makes it much cheaper at startup than general purpose compressors.
+//
+// The compressed data is a sequence of tokens.  The high nibble of a token
+// is the number of literal bytes that follow it, the low nibble is the
+// length of the match that follows the literals minus kMinMatch.  A nibble
+// of 15 is followed by extra length bytes, which are added to it up to and
+// including the first byte that is not 255.  A match is encoded as a
+// 16-bit little endian offset back into the output.  The last token only
+// has literals and ends the data.
+class LZCodec : public AllStatic {
+ public:
+  static const int kMinMatch = 4;
+  static const int kMaxOffset = 0xFFFF;
+
+  // Returns an upper bound for the size of the compressed data.
+  static int MaxCompressedSize(int size) {
+    return size + size / 255 + 16;
+  }
+
+  // Compresses the input into the output, which must have room for
+  // MaxCompressedSize(input.length()) bytes.  Returns the number of bytes
+  // written.
+  static int Compress(Vector<const byte> input, byte* output);
+
+  // Decompresses the input into the output, which must be exactly as large
+  // as the original data.  Returns false if the input is malformed.
+  static bool Decompress(Vector<const byte> input, Vector<byte> output);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_LZ_CODEC_H_
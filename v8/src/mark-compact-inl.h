@@ -46,6 +46,22 @@ MarkBit Marking::MarkBitFrom(Address addr) {
 
 void MarkCompactCollector::SetFlags(int flags) {
   sweep_precisely_ = ((flags & Heap::kMakeHeapIterableMask) != 0);
+  reduce_memory_footprint_ =
+      ((flags & Heap::kReduceMemoryFootprintMask) != 0);
+}
+
+
+HeapObject* MarkCompactCollector::DeduplicateString(Object** p,
+                                                    HeapObject* object) {
+  if (!deduplicate_strings_) return object;
+  static const uint32_t kSeqStringMask =
+      kIsNotStringMask | kIsSymbolMask | kStringRepresentationMask;
+  static const uint32_t kSeqStringTypeTag =
+      kStringTag | kNotSymbolTag | kSeqStringTag;
+  if ((object->map()->instance_type() & kSeqStringMask) != kSeqStringTypeTag) {
+    return object;
+  }
+  return DeduplicateStringSlow(p, String::cast(object));
 }
 
 
@@ -55,19 +55,38 @@ const char* Marking::kImpossibleBitPattern = "01";
 // -------------------------------------------------------------------------
 // MarkCompactCollector
 
+static bool EphemeronKeysMatch(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
 MarkCompactCollector::MarkCompactCollector() :  // NOLINT
 #ifdef DEBUG
       state_(IDLE),
 #endif
       sweep_precisely_(false),
+      reduce_memory_footprint_(false),
+      deduplicate_strings_(false),
+      string_dedup_table_(NULL),
       compacting_(false),
       was_marked_incrementally_(false),
       collect_maps_(FLAG_collect_maps),
       tracer_(NULL),
       migration_slots_buffer_(NULL),
+      sweeping_in_progress_(false),
+      sweeper_threads_active_(false),
+      sweeper_threads_(NULL),
+      sweeper_threads_count_(0),
+      sweeper_tasks_semaphore_(NULL),
+      sweeper_tasks_running_(0),
+      marking_threads_(NULL),
+      marking_threads_count_(0),
+      evacuation_threads_(NULL),
+      evacuation_threads_count_(0),
       heap_(NULL),
       code_flusher_(NULL),
-      encountered_weak_maps_(NULL) { }
+      encountered_weak_maps_(NULL),
+      pending_ephemeron_keys_(EphemeronKeysMatch) { }
 
 
 #ifdef DEBUG
@@ -229,14 +248,19 @@ void MarkCompactCollector::AddEvacuationCandidate(Page* p) {
 }
 
 
-bool MarkCompactCollector::StartCompaction() {
+bool MarkCompactCollector::StartCompaction(CompactionMode mode) {
   if (!compacting_) {
     ASSERT(evacuation_candidates_.length() == 0);
 
     CollectEvacuationCandidates(heap()->old_pointer_space());
     CollectEvacuationCandidates(heap()->old_data_space());
 
-    if (FLAG_compact_code_space) {
+    // Incremental marking has to record every code target it finds in a
+    // code object that may move, so code space is left alone there unless
+    // asked for.
+    if (FLAG_compact_code_space &&
+        (mode == NON_INCREMENTAL_COMPACTION ||
+         FLAG_incremental_code_compaction)) {
       CollectEvacuationCandidates(heap()->code_space());
     }
 
@@ -259,10 +283,13 @@ void MarkCompactCollector::CollectGarbage() {
 
   MarkLiveObjects();
   ASSERT(heap_->incremental_marking()->IsStopped());
+  if (deduplicate_strings_) FinishStringDeduplication();
 
-  if (collect_maps_) ClearNonLiveTransitions();
+  { GCTracer::Scope gc_scope(tracer_, GCTracer::Scope::MC_WEAK_PROCESSING);
+    if (collect_maps_) ClearNonLiveTransitions();
 
-  ClearWeakMaps();
+    ClearWeakMaps();
+  }
 
 #ifdef DEBUG
   if (FLAG_verify_heap) {
@@ -426,7 +453,8 @@ void MarkCompactCollector::CollectEvacuationCandidates(PagedSpace* space) {
     kMaxMaxEvacuationCandidates,
     static_cast<int>(sqrt(static_cast<double>(number_of_pages / 2)) + 1));
 
-  if (FLAG_stress_compaction || FLAG_always_compact) {
+  if (FLAG_stress_compaction || FLAG_always_compact ||
+      reduce_memory_footprint_) {
     max_evacuation_candidates = kMaxMaxEvacuationCandidates;
   }
 
@@ -456,6 +484,12 @@ void MarkCompactCollector::CollectEvacuationCandidates(PagedSpace* space) {
       int counter = space->heap()->ms_count();
       uintptr_t page_number = reinterpret_cast<uintptr_t>(p) >> kPageSizeBits;
       if ((counter & 1) == (page_number & 1)) fragmentation = 1;
+    } else if (reduce_memory_footprint_) {
+      // Evacuate the pages that are at least half free, emptiest first.
+      static const int kMinFreePercentage = 50;
+      int free_percentage = space->FreePercentage(p);
+      fragmentation = free_percentage >= kMinFreePercentage
+          ? free_percentage : 0;
     } else {
       fragmentation = space->Fragmentation(p);
     }
@@ -508,6 +542,12 @@ void MarkCompactCollector::AbortCompaction() {
 
 
 void MarkCompactCollector::Prepare(GCTracer* tracer) {
+  // The sweeper threads must be done with the previous cycle's mark bits
+  // before we can start marking again.
+  if (sweeping_in_progress_) WaitUntilSweepingCompleted();
+
+  if (FLAG_max_optimized_code_age > 0) EvictUnusedOptimizedCode();
+
   was_marked_incrementally_ = heap()->incremental_marking()->IsMarking();
 
   // Disable collection of maps if incremental marking is enabled.
@@ -534,18 +574,31 @@ void MarkCompactCollector::Prepare(GCTracer* tracer) {
   }
 #endif
 
-  // Clear marking bits for precise sweeping to collect all garbage.
-  if (was_marked_incrementally_ && PreciseSweepingRequired()) {
+  // Clear marking bits for precise sweeping to collect all garbage.  The
+  // incremental marker's evacuation candidates are also dropped when every
+  // sparse page is to be evacuated instead.
+  if (was_marked_incrementally_ &&
+      (PreciseSweepingRequired() || reduce_memory_footprint_)) {
     heap()->incremental_marking()->Abort();
     ClearMarkbits();
     AbortCompaction();
     was_marked_incrementally_ = false;
   }
 
+  // The incremental marker has visited most references already, so
+  // strings are only deduplicated in non-incremental collections.
+  deduplicate_strings_ = FLAG_string_dedup && !was_marked_incrementally_;
+  if (deduplicate_strings_) {
+    if (string_dedup_table_ == NULL) {
+      string_dedup_table_ = NewArray<String*>(kStringDedupTableSize);
+    }
+    memset(string_dedup_table_, 0, kStringDedupTableSize * sizeof(String*));
+  }
+
   // Don't start compaction if we are in the middle of incremental
   // marking cycle. We did not collect any slots.
   if (!FLAG_never_compact && !was_marked_incrementally_) {
-    StartCompaction();
+    StartCompaction(NON_INCREMENTAL_COMPACTION);
   }
 
   PagedSpaces spaces;
@@ -729,6 +782,57 @@ MarkCompactCollector::~MarkCompactCollector() {
     delete code_flusher_;
     code_flusher_ = NULL;
   }
+  DeleteArray(string_dedup_table_);
+}
+
+
+HeapObject* MarkCompactCollector::DeduplicateStringSlow(Object** p,
+                                                        String* string) {
+  if (string->length() > kMaxDedupStringLength ||
+      heap()->InNewSpace(string)) {
+    return string;
+  }
+  uint32_t hash = string->Hash();
+  String** entry = &string_dedup_table_[hash & (kStringDedupTableSize - 1)];
+  String* canonical = *entry;
+  if (canonical == string) return string;
+  // Generated code reads the characters of a sliced string with the
+  // encoding of the slice, so a string is only replaced by one with the
+  // same map.
+  if (canonical != NULL && canonical->map() == string->map() &&
+      canonical->Hash() == hash && canonical->length() == string->length() &&
+      canonical->Equals(string)) {
+    if (!Marking::MarkBitFrom(string).Get()) string_duplicates_.Add(string);
+    *p = canonical;
+    return canonical;
+  }
+  // The caller marks the string, so the table only holds live strings.
+  *entry = string;
+  return string;
+}
+
+
+static int CompareHeapObjects(HeapObject* const* a, HeapObject* const* b) {
+  if (*a == *b) return 0;
+  return *a < *b ? -1 : 1;
+}
+
+
+void MarkCompactCollector::FinishStringDeduplication() {
+  // A string that lost a reference may still be referenced elsewhere, so
+  // only the unmarked ones were freed by the deduplication.
+  string_duplicates_.Sort(&CompareHeapObjects);
+  intptr_t freed = 0;
+  HeapObject* previous = NULL;
+  for (int i = 0; i < string_duplicates_.length(); i++) {
+    HeapObject* string = string_duplicates_[i];
+    if (string == previous) continue;
+    previous = string;
+    if (!Marking::MarkBitFrom(string).Get()) freed += string->Size();
+  }
+  string_duplicates_.Clear();
+  if (tracer_ != NULL) tracer_->increment_deduplicated_strings_size(freed);
+  deduplicate_strings_ = false;
 }
 
 
@@ -917,6 +1021,7 @@ class StaticMarkingVisitor : public StaticVisitorBase {
                                          Object** p)) {
     if (!(*p)->IsHeapObject()) return;
     HeapObject* object = ShortCircuitConsString(p);
+    object = collector->DeduplicateString(p, object);
     collector->RecordSlot(anchor_slot, p, object);
     MarkBit mark = Marking::MarkBitFrom(object);
     collector->MarkObject(object, mark);
@@ -934,6 +1039,7 @@ class StaticMarkingVisitor : public StaticVisitorBase {
     Heap* heap = obj->GetHeap();
     MarkBit mark = Marking::MarkBitFrom(obj);
     heap->mark_compact_collector()->SetMark(obj, mark);
+    heap->mark_compact_collector()->ProcessEphemeronKey(obj);
     // Mark the map pointer and the body.
     MarkBit map_mark = Marking::MarkBitFrom(map);
     heap->mark_compact_collector()->MarkObject(map, map_mark);
@@ -954,10 +1060,16 @@ class StaticMarkingVisitor : public StaticVisitorBase {
     for (Object** p = start; p < end; p++) {
       Object* o = *p;
       if (!o->IsHeapObject()) continue;
-      collector->RecordSlot(start, p, o);
-      HeapObject* obj = HeapObject::cast(o);
+      HeapObject* obj = collector->DeduplicateString(p, HeapObject::cast(o));
+      collector->RecordSlot(start, p, obj);
       MarkBit mark = Marking::MarkBitFrom(obj);
       if (mark.Get()) continue;
+      // Maps need their code caches cleared and their transitions marked
+      // weakly, so they go through the marking stack.
+      if (obj->IsMap()) {
+        collector->MarkObject(obj, mark);
+        continue;
+      }
       VisitUnmarkedObject(collector, obj);
     }
     return true;
@@ -1014,6 +1126,8 @@ class StaticMarkingVisitor : public StaticVisitorBase {
     collector->SetMark(table, Marking::MarkBitFrom(table));
     collector->MarkObject(table->map(), Marking::MarkBitFrom(table->map()));
     ASSERT(MarkCompactCollector::IsMarked(table->map()));
+
+    collector->DiscoverEphemerons(table);
   }
 
   static void VisitCode(Map* map, HeapObject* object) {
@@ -1023,9 +1137,10 @@ class StaticMarkingVisitor : public StaticVisitorBase {
 
   // Code flushing support.
 
-  // How many collections newly compiled code object will survive before being
-  // flushed.
-  static const int kCodeAgeThreshold = 5;
+  // How many collections code that is not run survives before being flushed.
+  // Unoptimized code resets its age whenever it is called, so only code
+  // that has not been run for this many collections is flushed.
+  static const int kCodeAgeThreshold = 3;
 
   static const int kRegExpCodeThreshold = 5;
 
@@ -1427,6 +1542,47 @@ class CodeMarkingVisitor : public ThreadVisitor {
 };
 
 
+// Stamps the optimized code running on a thread's stack with the current
+// number of full collections.
+class OptimizedCodeUseVisitor : public ThreadVisitor {
+ public:
+  explicit OptimizedCodeUseVisitor(int gc_count) : gc_count_(gc_count) {}
+
+  void VisitThread(Isolate* isolate, ThreadLocalTop* top) {
+    for (StackFrameIterator it(isolate, top); !it.done(); it.Advance()) {
+      if (!it.frame()->is_optimized()) continue;
+      // The function of a lazily deoptimized frame already points to
+      // unoptimized code, so find the code from the pc instead.
+      Code* code = it.frame()->LookupCode();
+      if (code->kind() == Code::OPTIMIZED_FUNCTION) {
+        code->set_last_used_gc(gc_count_);
+      }
+    }
+  }
+
+ private:
+  int gc_count_;
+};
+
+
+void MarkCompactCollector::EvictUnusedOptimizedCode() {
+  Isolate* isolate = heap()->isolate();
+#ifdef ENABLE_DEBUGGER_SUPPORT
+  // The debugger keeps its own view of which functions are optimized.
+  if (isolate->debug()->IsLoaded()) return;
+#endif
+
+  int gc_count = heap()->ms_count();
+  OptimizedCodeUseVisitor visitor(gc_count);
+  visitor.VisitThread(isolate, isolate->thread_local_top());
+  isolate->thread_manager()->IterateArchivedThreads(&visitor);
+
+  int evicted = Deoptimizer::DeoptimizeUnusedFunctions(
+      gc_count - FLAG_max_optimized_code_age);
+  isolate->counters()->optimized_code_evicted()->Increment(evicted);
+}
+
+
 class SharedFunctionInfoMarkingVisitor : public ObjectVisitor {
  public:
   explicit SharedFunctionInfoMarkingVisitor(MarkCompactCollector* collector)
@@ -1943,10 +2099,17 @@ void MarkCompactCollector::MarkImplicitRefGroups() {
 void MarkCompactCollector::EmptyMarkingDeque() {
   while (!marking_deque_.IsEmpty()) {
     while (!marking_deque_.IsEmpty()) {
+      if (marking_deque_.Size() >= kMinObjectsForParallelMarking &&
+          CanUseParallelMarking()) {
+        ParallelEmptyMarkingDeque();
+        continue;
+      }
+
       HeapObject* object = marking_deque_.Pop();
       ASSERT(object->IsHeapObject());
       ASSERT(heap()->Contains(object));
       ASSERT(Marking::IsBlack(Marking::MarkBitFrom(object)));
+      ProcessEphemeronKey(object);
 
       Map* map = object->map();
       MarkBit map_mark = Marking::MarkBitFrom(map);
@@ -1955,9 +2118,287 @@ void MarkCompactCollector::EmptyMarkingDeque() {
       StaticMarkingVisitor::IterateBody(map, object);
     }
 
-    // Process encountered weak maps, mark objects only reachable by those
-    // weak maps and repeat until fix-point is reached.
-    ProcessWeakMaps();
+    // Mark the values of weak map entries whose keys were marked elsewhere
+    // and repeat until fix-point is reached.
+    ProcessEphemerons();
+  }
+}
+
+
+// Objects waiting to be marked through that are shared between the parallel
+// marking workers.  A worker with a long local list hands part of it over
+// when some other worker has run out of work.  Marking is over when all
+// workers are out of work and the pool is empty.
+class MarkingWorkPool {
+ public:
+  explicit MarkingWorkPool(int workers)
+      : mutex_(OS::CreateMutex()),
+        workers_(workers),
+        idle_workers_(0) { }
+
+  ~MarkingWorkPool() { delete mutex_; }
+
+  static const int kSegmentSize = 256;
+
+  bool HasIdleWorkers() {
+    return NoBarrier_Load(&idle_workers_) > 0;
+  }
+
+  void Publish(List<HeapObject*>* local) {
+    ScopedLock lock(mutex_);
+    for (int i = 0; i < kSegmentSize; i++) {
+      objects_.Add(local->RemoveLast());
+    }
+  }
+
+  // Moves some objects from the pool to the given list, waiting until
+  // another worker publishes some.  Returns false when marking is over.
+  bool Take(List<HeapObject*>* local) {
+    mutex_->Lock();
+    idle_workers_++;
+    while (objects_.is_empty()) {
+      if (idle_workers_ == workers_) {
+        mutex_->Unlock();
+        return false;
+      }
+      mutex_->Unlock();
+      Thread::YieldCPU();
+      mutex_->Lock();
+    }
+    idle_workers_--;
+    for (int i = 0; i < kSegmentSize && !objects_.is_empty(); i++) {
+      local->Add(objects_.RemoveLast());
+    }
+    mutex_->Unlock();
+    return true;
+  }
+
+ private:
+  Mutex* mutex_;
+  List<HeapObject*> objects_;
+  int workers_;
+  Atomic32 idle_workers_;
+};
+
+
+// A parallel marking worker marks through the objects it is given using
+// only atomic updates of the mark bits and live byte counts.  Everything
+// that needs the collector's bookkeeping (recorded slots, maps, weak maps,
+// code flushing candidates, ...) is kept aside for the main thread, which
+// merges it in after the round.
+class ParallelMarkingWorker : public Malloced {
+ public:
+  explicit ParallelMarkingWorker(MarkingWorkPool* pool)
+      : pool_(pool), overflowed_(false) { }
+
+  // Works on up to kMaxLocalObjects objects before marking overflowed
+  // objects grey for RefillMarkingDeque.
+  static const int kMaxLocalObjects = 16 * KB;
+
+  void Push(HeapObject* object) { local_.Add(object); }
+
+  void Run() {
+    Visitor visitor(this);
+    do {
+      while (!local_.is_empty()) {
+        if (local_.length() > 2 * MarkingWorkPool::kSegmentSize &&
+            pool_->HasIdleWorkers()) {
+          pool_->Publish(&local_);
+        }
+        VisitObject(local_.RemoveLast(), &visitor);
+      }
+    } while (pool_->Take(&local_));
+  }
+
+  // Hands the deferred work to the collector on the main thread.
+  void Merge(MarkCompactCollector* collector) {
+    for (int i = 0; i < recorded_slots_.length(); i += 2) {
+      Object** slot = recorded_slots_[i + 1];
+      collector->RecordSlot(recorded_slots_[i], slot, *slot);
+    }
+    if (overflowed_) collector->marking_deque_.SetOverflowed();
+    for (int i = 0; i < deferred_.length(); i++) {
+      HeapObject* object = deferred_[i];
+      if (object->IsMap()) {
+        collector->ProcessNewlyMarkedObject(object);
+      } else {
+        StaticMarkingVisitor::IterateBody(object->map(), object);
+      }
+    }
+  }
+
+ private:
+  class Visitor : public ObjectVisitor {
+   public:
+    explicit Visitor(ParallelMarkingWorker* worker) : worker_(worker) { }
+
+    void VisitPointer(Object** p) {
+      worker_->MarkObjectByPointer(p, p);
+    }
+
+    void VisitPointers(Object** start, Object** end) {
+      for (Object** p = start; p < end; p++) {
+        worker_->MarkObjectByPointer(start, p);
+      }
+    }
+
+   private:
+    ParallelMarkingWorker* worker_;
+  };
+
+  static bool NeedsMainThread(Map* map) {
+    switch (map->visitor_id()) {
+      case StaticVisitorBase::kVisitCode:
+      case StaticVisitorBase::kVisitSharedFunctionInfo:
+      case StaticVisitorBase::kVisitJSFunction:
+      case StaticVisitorBase::kVisitJSRegExp:
+      case StaticVisitorBase::kVisitJSWeakMap:
+      case StaticVisitorBase::kVisitGlobalContext:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  void VisitObject(HeapObject* object, ObjectVisitor* visitor) {
+    ASSERT(Marking::IsBlack(Marking::MarkBitFrom(object)));
+    Map* map = object->map();
+    if (Marking::MarkBitFrom(map).SetAtomically()) {
+      MemoryChunk::IncrementLiveBytesAtomically(map->address(), map->Size());
+      deferred_.Add(map);
+    }
+    if (NeedsMainThread(map)) {
+      deferred_.Add(object);
+    } else {
+      object->IterateBody(map->instance_type(),
+                          object->SizeFromMap(map),
+                          visitor);
+    }
+  }
+
+  void MarkObjectByPointer(Object** anchor_slot, Object** p) {
+    if (!(*p)->IsHeapObject()) return;
+    HeapObject* object = ShortCircuitConsString(p);
+    if (MarkCompactCollector::IsOnEvacuationCandidate(object) &&
+        !MarkCompactCollector::ShouldSkipEvacuationSlotRecording(anchor_slot)) {
+      recorded_slots_.Add(anchor_slot);
+      recorded_slots_.Add(p);
+    }
+    MarkBit mark = Marking::MarkBitFrom(object);
+    if (!mark.SetAtomically()) return;
+    int size = object->Size();
+    MemoryChunk::IncrementLiveBytesAtomically(object->address(), size);
+    if (object->IsMap()) {
+      deferred_.Add(object);
+    } else if (local_.length() < kMaxLocalObjects) {
+      local_.Add(object);
+    } else {
+      bool grey = mark.Next().SetAtomically();
+      USE(grey);
+      ASSERT(grey);
+      MemoryChunk::IncrementLiveBytesAtomically(object->address(), -size);
+      overflowed_ = true;
+    }
+  }
+
+  MarkingWorkPool* pool_;
+  List<HeapObject*> local_;
+  List<HeapObject*> deferred_;
+  // Pairs of anchor slot and slot.
+  List<Object**> recorded_slots_;
+  bool overflowed_;
+};
+
+
+// A marking thread runs one parallel marking worker per round.  The threads
+// are started on the first full collection that needs them and then sleep
+// between rounds.
+class MarkingThread : public Thread {
+ public:
+  explicit MarkingThread(Isolate* isolate)
+      : Thread("v8:MarkingThread"),
+        isolate_(isolate),
+        worker_(NULL),
+        start_marking_semaphore_(OS::CreateSemaphore(0)),
+        end_marking_semaphore_(OS::CreateSemaphore(0)),
+        stop_(false) { }
+
+  ~MarkingThread() {
+    delete start_marking_semaphore_;
+    delete end_marking_semaphore_;
+  }
+
+  void Run() {
+    Isolate::SetIsolateThreadLocals(isolate_, NULL);
+    while (true) {
+      start_marking_semaphore_->Wait();
+      if (stop_) return;
+      worker_->Run();
+      end_marking_semaphore_->Signal();
+    }
+  }
+
+  void StartMarking(ParallelMarkingWorker* worker) {
+    worker_ = worker;
+    start_marking_semaphore_->Signal();
+  }
+
+  void WaitForMarkingThread() {
+    end_marking_semaphore_->Wait();
+  }
+
+  void Stop() {
+    stop_ = true;
+    start_marking_semaphore_->Signal();
+    Join();
+  }
+
+ private:
+  Isolate* isolate_;
+  ParallelMarkingWorker* worker_;
+  Semaphore* start_marking_semaphore_;
+  Semaphore* end_marking_semaphore_;
+  bool stop_;
+};
+
+
+bool MarkCompactCollector::CanUseParallelMarking() {
+  return FLAG_parallel_marking && FLAG_marking_threads > 0;
+}
+
+
+void MarkCompactCollector::ParallelEmptyMarkingDeque() {
+  if (marking_threads_ == NULL) {
+    marking_threads_count_ = FLAG_marking_threads;
+    marking_threads_ = new MarkingThread*[marking_threads_count_];
+    for (int i = 0; i < marking_threads_count_; i++) {
+      marking_threads_[i] = new MarkingThread(heap()->isolate());
+      marking_threads_[i]->Start();
+    }
+  }
+
+  // The main thread is the last worker.
+  int workers = marking_threads_count_ + 1;
+  MarkingWorkPool pool(workers);
+  ScopedVector<ParallelMarkingWorker*> worker(workers);
+  for (int i = 0; i < workers; i++) {
+    worker[i] = new ParallelMarkingWorker(&pool);
+  }
+  for (int i = 0; !marking_deque_.IsEmpty(); i++) {
+    worker[i % workers]->Push(marking_deque_.Pop());
+  }
+
+  for (int i = 0; i < marking_threads_count_; i++) {
+    marking_threads_[i]->StartMarking(worker[i]);
+  }
+  worker[workers - 1]->Run();
+  for (int i = 0; i < marking_threads_count_; i++) {
+    marking_threads_[i]->WaitForMarkingThread();
+  }
+
+  for (int i = 0; i < workers; i++) {
+    worker[i]->Merge(this);
+    delete worker[i];
   }
 }
 
@@ -2144,6 +2585,9 @@ void MarkCompactCollector::AfterMarking() {
 
   // Clean up dead objects from the runtime profiler.
   heap()->isolate()->runtime_profiler()->RemoveDeadSamples();
+
+  // Forget the literal sites whose boilerplates died.
+  heap()->pretenuring_tracker()->RemoveDeadSites();
 }
 
 
@@ -2334,23 +2778,63 @@ void MarkCompactCollector::ClearNonLiveTransitions() {
 }
 
 
-void MarkCompactCollector::ProcessWeakMaps() {
-  Object* weak_map_obj = encountered_weak_maps();
-  while (weak_map_obj != Smi::FromInt(0)) {
-    ASSERT(MarkCompactCollector::IsMarked(HeapObject::cast(weak_map_obj)));
-    JSWeakMap* weak_map = reinterpret_cast<JSWeakMap*>(weak_map_obj);
-    ObjectHashTable* table = ObjectHashTable::cast(weak_map->table());
-    for (int i = 0; i < table->Capacity(); i++) {
-      if (MarkCompactCollector::IsMarked(HeapObject::cast(table->KeyAt(i)))) {
-        Object* value = table->get(table->EntryToValueIndex(i));
-        StaticMarkingVisitor::VisitPointer(heap(), &value);
-        table->set_unchecked(heap(),
-                             table->EntryToValueIndex(i),
-                             value,
-                             UPDATE_WRITE_BARRIER);
-      }
+void MarkCompactCollector::MarkEphemeronValue(ObjectHashTable* table,
+                                              int entry) {
+  Object* value = table->get(table->EntryToValueIndex(entry));
+  StaticMarkingVisitor::VisitPointer(heap(), &value);
+  table->set_unchecked(heap(),
+                       table->EntryToValueIndex(entry),
+                       value,
+                       UPDATE_WRITE_BARRIER);
+}
+
+
+void MarkCompactCollector::DiscoverEphemerons(ObjectHashTable* table) {
+  for (int i = 0; i < table->Capacity(); i++) {
+    Object* key = table->KeyAt(i);
+    if (!key->IsHeapObject() || IsMarked(key)) {
+      MarkEphemeronValue(table, i);
+      continue;
     }
-    weak_map_obj = weak_map->next();
+    HashMap::Entry* entry =
+        pending_ephemeron_keys_.Lookup(key, ComputePointerHash(key), true);
+    Ephemeron ephemeron;
+    ephemeron.table = table;
+    ephemeron.entry = i;
+    ephemeron.next = static_cast<int>(
+        reinterpret_cast<intptr_t>(entry->value)) - 1;
+    ephemerons_.Add(ephemeron);
+    entry->value = reinterpret_cast<void*>(
+        static_cast<intptr_t>(ephemerons_.length()));
+  }
+}
+
+
+void MarkCompactCollector::ProcessEphemeronKeySlow(HeapObject* key) {
+  uint32_t hash = ComputePointerHash(key);
+  HashMap::Entry* entry = pending_ephemeron_keys_.Lookup(key, hash, false);
+  if (entry == NULL) return;
+  int index = static_cast<int>(reinterpret_cast<intptr_t>(entry->value)) - 1;
+  pending_ephemeron_keys_.Remove(key, hash);
+  while (index >= 0) {
+    const Ephemeron& ephemeron = ephemerons_[index];
+    MarkEphemeronValue(ephemeron.table, ephemeron.entry);
+    index = ephemeron.next;
+  }
+}
+
+
+void MarkCompactCollector::ProcessEphemerons() {
+  if (pending_ephemeron_keys_.occupancy() == 0) return;
+  List<HeapObject*> marked_keys;
+  for (HashMap::Entry* entry = pending_ephemeron_keys_.Start();
+       entry != NULL;
+       entry = pending_ephemeron_keys_.Next(entry)) {
+    HeapObject* key = reinterpret_cast<HeapObject*>(entry->key);
+    if (IsMarked(key)) marked_keys.Add(key);
+  }
+  for (int i = 0; i < marked_keys.length(); i++) {
+    ProcessEphemeronKeySlow(marked_keys[i]);
   }
 }
 
@@ -2370,6 +2854,8 @@ void MarkCompactCollector::ClearWeakMaps() {
     weak_map->set_next(Smi::FromInt(0));
   }
   set_encountered_weak_maps(Smi::FromInt(0));
+  pending_ephemeron_keys_.Clear();
+  ephemerons_.Clear();
 }
 
 
@@ -2711,6 +3197,7 @@ void MarkCompactCollector::EvacuateLiveObjectsFromPage(Page* p) {
 
 
 void MarkCompactCollector::EvacuatePages() {
+  if (CanUseParallelEvacuation() && ParallelEvacuatePages()) return;
   int npages = evacuation_candidates_.length();
   for (int i = 0; i < npages; i++) {
     Page* p = evacuation_candidates_[i];
@@ -2737,6 +3224,419 @@ void MarkCompactCollector::EvacuatePages() {
 }
 
 
+// The work of one parallel evacuation round: either the candidate pages to
+// evacuate or the slots buffers to update.  Threads claim the units one by
+// one.
+class ParallelEvacuationJob {
+ public:
+  enum Phase {
+    EVACUATE_PAGES,
+    UPDATE_SLOTS
+  };
+
+  ParallelEvacuationJob(Phase phase, bool code_slots_filtering_required)
+      : phase_(phase),
+        code_slots_filtering_required_(code_slots_filtering_required),
+        allocation_mutex_(OS::CreateMutex()),
+        next_unit_(0) { }
+
+  ~ParallelEvacuationJob() { delete allocation_mutex_; }
+
+  Phase phase() { return phase_; }
+
+  bool code_slots_filtering_required() {
+    return code_slots_filtering_required_;
+  }
+
+  // Serializes allocation in the target spaces.
+  Mutex* allocation_mutex() { return allocation_mutex_; }
+
+  List<SlotsBuffer*>* buffers() { return &buffers_; }
+
+  void AddPage(Page* p) { pages_.Add(p); }
+
+  void AddChain(SlotsBuffer* buffer) {
+    for (; buffer != NULL; buffer = buffer->next()) buffers_.Add(buffer);
+  }
+
+  Page* NextPage() {
+    int index = ClaimUnit();
+    return index < pages_.length() ? pages_[index] : NULL;
+  }
+
+  SlotsBuffer* NextBuffer() {
+    int index = ClaimUnit();
+    return index < buffers_.length() ? buffers_[index] : NULL;
+  }
+
+ private:
+  int ClaimUnit() {
+    return NoBarrier_AtomicIncrement(&next_unit_, 1) - 1;
+  }
+
+  Phase phase_;
+  bool code_slots_filtering_required_;
+  Mutex* allocation_mutex_;
+  List<Page*> pages_;
+  List<SlotsBuffer*> buffers_;
+  Atomic32 next_unit_;
+};
+
+
+// A parallel evacuator does the work of one thread in a parallel evacuation
+// round.  It allocates the evacuated objects in allocation areas of its own
+// and records the slots that need updating and the pointers into new space
+// in private buffers, which the main thread merges in after the round.
+class ParallelEvacuator : public Malloced {
+ public:
+  ParallelEvacuator(MarkCompactCollector* collector,
+                    ParallelEvacuationJob* job)
+      : collector_(collector),
+        heap_(collector->heap()),
+        job_(job),
+        migration_slots_buffer_(NULL) { }
+
+  // Objects at least this big are allocated directly in the space.
+  static const int kAllocationAreaSize = 8 * KB;
+
+  void Run() {
+    if (job_->phase() == ParallelEvacuationJob::EVACUATE_PAGES) {
+      for (Page* p = job_->NextPage(); p != NULL; p = job_->NextPage()) {
+        EvacuatePage(p);
+      }
+      ScopedLock lock(job_->allocation_mutex());
+      ReleaseAllocationArea(heap_->old_pointer_space(), &pointer_area_);
+      ReleaseAllocationArea(heap_->old_data_space(), &data_area_);
+    } else {
+      for (SlotsBuffer* buffer = job_->NextBuffer();
+           buffer != NULL;
+           buffer = job_->NextBuffer()) {
+        buffer->UpdateSlotsOfKind(heap_,
+                                  SlotsBuffer::UNTYPED_SLOTS,
+                                  job_->code_slots_filtering_required());
+      }
+    }
+  }
+
+  void Merge() {
+    StoreBuffer* store_buffer = heap_->store_buffer();
+    for (int i = 0; i < new_space_slots_.length(); i++) {
+      store_buffer->Mark(new_space_slots_[i]);
+    }
+    if (migration_slots_buffer_ != NULL) {
+      collector_->evacuator_slots_buffers_.Add(migration_slots_buffer_);
+    }
+  }
+
+ private:
+  void EvacuatePage(Page* p) {
+    PagedSpace* space = static_cast<PagedSpace*>(p->owner());
+    ASSERT(p->IsEvacuationCandidate() && !p->WasSwept());
+    MarkBit::CellType* cells = p->markbits()->cells();
+    p->MarkSweptPrecisely();
+
+    int last_cell_index =
+        Bitmap::IndexToCell(
+            Bitmap::CellAlignIndex(
+                p->AddressToMarkbitIndex(p->ObjectAreaEnd())));
+
+    int cell_index = Page::kFirstUsedCell;
+    Address cell_base = p->ObjectAreaStart();
+    int offsets[16];
+
+    for (cell_index = Page::kFirstUsedCell;
+         cell_index < last_cell_index;
+         cell_index++, cell_base += 32 * kPointerSize) {
+      if (cells[cell_index] == 0) continue;
+
+      int live_objects = MarkWordToObjectStarts(cells[cell_index], offsets);
+      for (int i = 0; i < live_objects; i++) {
+        Address object_addr = cell_base + offsets[i] * kPointerSize;
+        HeapObject* object = HeapObject::FromAddress(object_addr);
+        ASSERT(Marking::IsBlack(Marking::MarkBitFrom(object)));
+
+        int size = object->Size();
+        HeapObject* target = Allocate(space, size);
+        MigrateObject(target->address(), object_addr, size, space->identity());
+        ASSERT(object->map_word().IsForwardingAddress());
+      }
+
+      // Clear marking bits for current cell.
+      cells[cell_index] = 0;
+    }
+    p->ResetLiveBytes();
+  }
+
+  HeapObject* Allocate(PagedSpace* space, int size) {
+    AllocationInfo* area = (space->identity() == OLD_POINTER_SPACE)
+        ? &pointer_area_
+        : &data_area_;
+    if (area->limit - area->top >= size) {
+      HeapObject* object = HeapObject::FromAddress(area->top);
+      area->top += size;
+      return object;
+    }
+
+    ScopedLock lock(job_->allocation_mutex());
+    Object* result;
+    if (size < kAllocationAreaSize / 4) {
+      ReleaseAllocationArea(space, area);
+      if (space->AllocateRaw(kAllocationAreaSize)->ToObject(&result)) {
+        Address start = HeapObject::cast(result)->address();
+        area->top = start + size;
+        area->limit = start + kAllocationAreaSize;
+        return HeapObject::cast(result);
+      }
+    }
+    if (!space->AllocateRaw(size)->ToObject(&result)) {
+      // OS refused to give us memory.
+      V8::FatalProcessOutOfMemory("Evacuation");
+    }
+    return HeapObject::cast(result);
+  }
+
+  // The allocation mutex must be held.
+  static void ReleaseAllocationArea(PagedSpace* space, AllocationInfo* area) {
+    if (area->top != area->limit) {
+      space->Free(area->top, static_cast<int>(area->limit - area->top));
+    }
+    area->top = area->limit = NULL;
+  }
+
+  // Like MarkCompactCollector::MigrateObject for the old pointer and old
+  // data space, with private buffers.  The heap profiler is not told about
+  // the move, which is why parallel evacuation is off while it is running.
+  void MigrateObject(Address dst,
+                     Address src,
+                     int size,
+                     AllocationSpace dest) {
+    if (dest == OLD_POINTER_SPACE) {
+      Address src_slot = src;
+      Address dst_slot = dst;
+      ASSERT(IsAligned(size, kPointerSize));
+
+      for (int remaining = size / kPointerSize; remaining > 0; remaining--) {
+        Object* value = Memory::Object_at(src_slot);
+
+        Memory::Object_at(dst_slot) = value;
+
+        if (heap_->InNewSpace(value)) {
+          new_space_slots_.Add(dst_slot);
+        } else if (value->IsHeapObject() &&
+                   MarkCompactCollector::IsOnEvacuationCandidate(value)) {
+          SlotsBuffer::AddTo(&slots_buffer_allocator_,
+                             &migration_slots_buffer_,
+                             reinterpret_cast<Object**>(dst_slot),
+                             SlotsBuffer::IGNORE_OVERFLOW);
+        }
+
+        src_slot += kPointerSize;
+        dst_slot += kPointerSize;
+      }
+
+      if (collector_->compacting_ &&
+          HeapObject::FromAddress(dst)->IsJSFunction()) {
+        Address code_entry_slot = dst + JSFunction::kCodeEntryOffset;
+        Address code_entry = Memory::Address_at(code_entry_slot);
+
+        if (Page::FromAddress(code_entry)->IsEvacuationCandidate()) {
+          SlotsBuffer::AddTo(&slots_buffer_allocator_,
+                             &migration_slots_buffer_,
+                             SlotsBuffer::CODE_ENTRY_SLOT,
+                             code_entry_slot,
+                             SlotsBuffer::IGNORE_OVERFLOW);
+        }
+      }
+    } else {
+      ASSERT(dest == OLD_DATA_SPACE);
+      heap_->MoveBlock(dst, src, size);
+    }
+    Memory::Address_at(src) = dst;
+  }
+
+  MarkCompactCollector* collector_;
+  Heap* heap_;
+  ParallelEvacuationJob* job_;
+  AllocationInfo pointer_area_;
+  AllocationInfo data_area_;
+  SlotsBufferAllocator slots_buffer_allocator_;
+  SlotsBuffer* migration_slots_buffer_;
+  List<Address> new_space_slots_;
+};
+
+
+// An evacuation thread runs one parallel evacuator per round.  The threads
+// are started on the first collection that needs them and then sleep
+// between rounds.
+class EvacuationThread : public Thread {
+ public:
+  explicit EvacuationThread(Isolate* isolate)
+      : Thread("v8:EvacuationThread"),
+        isolate_(isolate),
+        evacuator_(NULL),
+        start_evacuation_semaphore_(OS::CreateSemaphore(0)),
+        end_evacuation_semaphore_(OS::CreateSemaphore(0)),
+        stop_(false) { }
+
+  ~EvacuationThread() {
+    delete start_evacuation_semaphore_;
+    delete end_evacuation_semaphore_;
+  }
+
+  void Run() {
+    Isolate::SetIsolateThreadLocals(isolate_, NULL);
+    while (true) {
+      start_evacuation_semaphore_->Wait();
+      if (stop_) return;
+      evacuator_->Run();
+      end_evacuation_semaphore_->Signal();
+    }
+  }
+
+  void StartEvacuation(ParallelEvacuator* evacuator) {
+    evacuator_ = evacuator;
+    start_evacuation_semaphore_->Signal();
+  }
+
+  void WaitForEvacuationThread() {
+    end_evacuation_semaphore_->Wait();
+  }
+
+  void Stop() {
+    stop_ = true;
+    start_evacuation_semaphore_->Signal();
+    Join();
+  }
+
+ private:
+  Isolate* isolate_;
+  ParallelEvacuator* evacuator_;
+  Semaphore* start_evacuation_semaphore_;
+  Semaphore* end_evacuation_semaphore_;
+  bool stop_;
+};
+
+
+bool MarkCompactCollector::CanUseParallelEvacuation() {
+  if (!FLAG_parallel_evacuation || FLAG_evacuation_threads <= 0) return false;
+  HeapProfiler* profiler = heap()->isolate()->heap_profiler();
+  return profiler == NULL || !profiler->is_profiling();
+}
+
+
+bool MarkCompactCollector::ParallelEvacuatePages() {
+  ParallelEvacuationJob job(ParallelEvacuationJob::EVACUATE_PAGES, false);
+  int npages = evacuation_candidates_.length();
+  int pointer_pages = 0;
+  int data_pages = 0;
+  int code_pages = 0;
+  for (int i = 0; i < npages; i++) {
+    Page* p = evacuation_candidates_[i];
+    ASSERT(p->IsEvacuationCandidate() ||
+           p->IsFlagSet(Page::RESCAN_ON_EVACUATION));
+    if (!p->IsEvacuationCandidate()) continue;
+    switch (p->owner()->identity()) {
+      case OLD_POINTER_SPACE:
+        pointer_pages++;
+        job.AddPage(p);
+        break;
+      case OLD_DATA_SPACE:
+        data_pages++;
+        job.AddPage(p);
+        break;
+      case CODE_SPACE:
+        code_pages++;
+        break;
+      default:
+        UNREACHABLE();
+        break;
+    }
+  }
+
+  // Every evacuator may leave a partly used allocation area behind, so
+  // leave the pessimistic abandoning of pages to the sequential path if the
+  // spaces are close to their maximum capacity.
+  int evacuators = FLAG_evacuation_threads + 1;
+  if ((pointer_pages > 0 &&
+       !heap()->old_pointer_space()->CanExpandBy(pointer_pages + evacuators)) ||
+      (data_pages > 0 &&
+       !heap()->old_data_space()->CanExpandBy(data_pages + evacuators)) ||
+      (code_pages > 0 && !heap()->code_space()->CanExpandBy(code_pages))) {
+    return false;
+  }
+
+  for (int i = 0; i < npages; i++) {
+    Page* p = evacuation_candidates_[i];
+    if (p->IsEvacuationCandidate() && p->owner()->identity() == CODE_SPACE) {
+      EvacuateLiveObjectsFromPage(p);
+    }
+  }
+
+  AlwaysAllocateScope always_allocate;
+  RunParallelEvacuationJob(&job);
+  return true;
+}
+
+
+void MarkCompactCollector::ParallelUpdateSlots(
+    bool code_slots_filtering_required) {
+  ParallelEvacuationJob job(ParallelEvacuationJob::UPDATE_SLOTS,
+                            code_slots_filtering_required);
+  job.AddChain(migration_slots_buffer_);
+  for (int i = 0; i < evacuator_slots_buffers_.length(); i++) {
+    job.AddChain(evacuator_slots_buffers_[i]);
+  }
+  for (int i = 0; i < evacuation_candidates_.length(); i++) {
+    Page* p = evacuation_candidates_[i];
+    if (p->IsEvacuationCandidate()) job.AddChain(p->slots_buffer());
+  }
+
+  RunParallelEvacuationJob(&job);
+
+  // Code may be patched at unaligned addresses that other threads could
+  // see half written, so the typed slots are left to the main thread.
+  List<SlotsBuffer*>* buffers = job.buffers();
+  for (int i = 0; i < buffers->length(); i++) {
+    buffers->at(i)->UpdateSlotsOfKind(heap(),
+                                      SlotsBuffer::TYPED_SLOTS,
+                                      code_slots_filtering_required);
+  }
+}
+
+
+void MarkCompactCollector::RunParallelEvacuationJob(
+    ParallelEvacuationJob* job) {
+  if (evacuation_threads_ == NULL) {
+    evacuation_threads_count_ = FLAG_evacuation_threads;
+    evacuation_threads_ = new EvacuationThread*[evacuation_threads_count_];
+    for (int i = 0; i < evacuation_threads_count_; i++) {
+      evacuation_threads_[i] = new EvacuationThread(heap()->isolate());
+      evacuation_threads_[i]->Start();
+    }
+  }
+
+  // The main thread runs the last evacuator.
+  int evacuators = evacuation_threads_count_ + 1;
+  ScopedVector<ParallelEvacuator*> evacuator(evacuators);
+  for (int i = 0; i < evacuators; i++) {
+    evacuator[i] = new ParallelEvacuator(this, job);
+  }
+
+  for (int i = 0; i < evacuation_threads_count_; i++) {
+    evacuation_threads_[i]->StartEvacuation(evacuator[i]);
+  }
+  evacuator[evacuators - 1]->Run();
+  for (int i = 0; i < evacuation_threads_count_; i++) {
+    evacuation_threads_[i]->WaitForEvacuationThread();
+  }
+
+  for (int i = 0; i < evacuators; i++) {
+    evacuator[i]->Merge();
+    delete evacuator[i];
+  }
+}
+
+
 class EvacuationWeakObjectRetainer : public WeakObjectRetainer {
  public:
   virtual Object* RetainAs(Object* object) {
@@ -3045,11 +3945,19 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
     heap_->store_buffer()->IteratePointersToNewSpace(&UpdatePointer);
   }
 
+  // The slots recorded in the evacuation candidates are updated together
+  // with the migration slots in parallel mode.
+  bool update_slots_in_parallel = CanUseParallelEvacuation();
   { GCTracer::Scope gc_scope(tracer_,
                              GCTracer::Scope::MC_UPDATE_POINTERS_TO_EVACUATED);
-    SlotsBuffer::UpdateSlotsRecordedIn(heap_,
-                                       migration_slots_buffer_,
-                                       code_slots_filtering_required);
+    if (update_slots_in_parallel) {
+      ParallelUpdateSlots(code_slots_filtering_required);
+    } else {
+      ASSERT(evacuator_slots_buffers_.is_empty());
+      SlotsBuffer::UpdateSlotsRecordedIn(heap_,
+                                         migration_slots_buffer_,
+                                         code_slots_filtering_required);
+    }
     if (FLAG_trace_fragmentation) {
       PrintF("  migration slots buffer: %d\n",
              SlotsBuffer::SizeOfChain(migration_slots_buffer_));
@@ -3081,9 +3989,11 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
              p->IsFlagSet(Page::RESCAN_ON_EVACUATION));
 
       if (p->IsEvacuationCandidate()) {
-        SlotsBuffer::UpdateSlotsRecordedIn(heap_,
-                                           p->slots_buffer(),
-                                           code_slots_filtering_required);
+        if (!update_slots_in_parallel) {
+          SlotsBuffer::UpdateSlotsRecordedIn(heap_,
+                                             p->slots_buffer(),
+                                             code_slots_filtering_required);
+        }
         if (FLAG_trace_fragmentation) {
           PrintF("  page %p slots buffer: %d\n",
                  reinterpret_cast<void*>(p),
@@ -3151,6 +4061,9 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
   heap()->isolate()->runtime_profiler()->UpdateSamplesAfterCompact(
       &updating_visitor);
 
+  // Update boilerplate pointers from the pretenuring tracker.
+  heap()->pretenuring_tracker()->UpdateSitesAfterCompact(&updating_visitor);
+
   EvacuationWeakObjectRetainer evacuation_object_retainer;
   heap()->ProcessWeakReferences(&evacuation_object_retainer);
 
@@ -3166,12 +4079,17 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
 
   slots_buffer_allocator_.DeallocateChain(&migration_slots_buffer_);
   ASSERT(migration_slots_buffer_ == NULL);
+  for (int i = 0; i < evacuator_slots_buffers_.length(); i++) {
+    slots_buffer_allocator_.DeallocateChain(&evacuator_slots_buffers_[i]);
+  }
+  evacuator_slots_buffers_.Rewind(0);
   for (int i = 0; i < npages; i++) {
     Page* p = evacuation_candidates_[i];
     if (!p->IsEvacuationCandidate()) continue;
     PagedSpace* space = static_cast<PagedSpace*>(p->owner());
     space->Free(p->ObjectAreaStart(), Page::kObjectAreaSize);
     p->set_scan_on_scavenge(false);
+    p->ReleaseCardTable();
     slots_buffer_allocator_.DeallocateChain(p->slots_buffer_address());
     p->ClearEvacuationCandidate();
   }
@@ -3463,10 +4381,31 @@ static inline Address StartOfLiveObject(Address block_address, uint32_t cell) {
 // because it means that any FreeSpace maps left actually describe a region of
 // memory that can be ignored when scanning.  Dead objects other than free
 // spaces will not contain the free space map.
-intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
-  ASSERT(!p->IsEvacuationCandidate() && !p->WasSwept());
+//
+// When sweeping in parallel the page has already been marked as swept by the
+// main thread and the freed memory goes to the given free list.  The live
+// bytes count is left for the main thread to reset.
+enum SweepingParallelism {
+  SWEEP_SEQUENTIALLY,
+  SWEEP_IN_PARALLEL
+};
+
+
+template<SweepingParallelism mode>
+static inline intptr_t FreeConservatively(PagedSpace* space,
+                                          FreeList* free_list,
+                                          Address start,
+                                          int size) {
+  if (mode == SWEEP_SEQUENTIALLY) return space->Free(start, size);
+  return size - free_list->Free(start, size);
+}
+
+
+template<SweepingParallelism mode>
+static intptr_t SweepConservativelyImpl(PagedSpace* space,
+                                        FreeList* free_list,
+                                        Page* p) {
   MarkBit::CellType* cells = p->markbits()->cells();
-  p->MarkSweptConservatively();
 
   int last_cell_index =
       Bitmap::IndexToCell(
@@ -3487,8 +4426,9 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
   }
   size_t size = block_address - p->ObjectAreaStart();
   if (cell_index == last_cell_index) {
-    freed_bytes += static_cast<int>(space->Free(p->ObjectAreaStart(),
-                                                static_cast<int>(size)));
+    freed_bytes += FreeConservatively<mode>(space, free_list,
+                                            p->ObjectAreaStart(),
+                                            static_cast<int>(size));
     ASSERT_EQ(0, p->LiveBytes());
     return freed_bytes;
   }
@@ -3497,8 +4437,9 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
   Address free_end = StartOfLiveObject(block_address, cells[cell_index]);
   // Free the first free space.
   size = free_end - p->ObjectAreaStart();
-  freed_bytes += space->Free(p->ObjectAreaStart(),
-                             static_cast<int>(size));
+  freed_bytes += FreeConservatively<mode>(space, free_list,
+                                          p->ObjectAreaStart(),
+                                          static_cast<int>(size));
   // The start of the current free area is represented in undigested form by
   // the address of the last 32-word section that contained a live object and
   // the marking bitmap for that cell, which describes where the live object
@@ -3527,8 +4468,9 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
           // so now we need to find the start of the first live object at the
           // end of the free space.
           free_end = StartOfLiveObject(block_address, cell);
-          freed_bytes += space->Free(free_start,
-                                     static_cast<int>(free_end - free_start));
+          freed_bytes += FreeConservatively<mode>(
+              space, free_list, free_start,
+              static_cast<int>(free_end - free_start));
         }
       }
       // Update our undigested record of where the current free area started.
@@ -3542,18 +4484,36 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
   // Handle the free space at the end of the page.
   if (block_address - free_start > 32 * kPointerSize) {
     free_start = DigestFreeStart(free_start, free_start_cell);
-    freed_bytes += space->Free(free_start,
-                               static_cast<int>(block_address - free_start));
+    freed_bytes += FreeConservatively<mode>(
+        space, free_list, free_start,
+        static_cast<int>(block_address - free_start));
   }
 
-  p->ResetLiveBytes();
+  if (mode == SWEEP_SEQUENTIALLY) p->ResetLiveBytes();
   return freed_bytes;
 }
 
 
+intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
+  ASSERT(!p->IsEvacuationCandidate() && !p->WasSwept());
+  p->MarkSweptConservatively();
+  return SweepConservativelyImpl<SWEEP_SEQUENTIALLY>(space, NULL, p);
+}
+
+
+intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space,
+                                                   FreeList* free_list,
+                                                   Page* p) {
+  ASSERT(!p->IsEvacuationCandidate() && p->WasSweptConservatively());
+  ASSERT(p->parallel_sweeping() == MemoryChunk::SWEEPING_IN_PROGRESS);
+  return SweepConservativelyImpl<SWEEP_IN_PARALLEL>(space, free_list, p);
+}
+
+
 void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
   space->set_was_swept_conservatively(sweeper == CONSERVATIVE ||
-                                      sweeper == LAZY_CONSERVATIVE);
+                                      sweeper == LAZY_CONSERVATIVE ||
+                                      sweeper == CONCURRENT_CONSERVATIVE);
 
   space->ClearStats();
 
@@ -3563,6 +4523,7 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
   int pages_swept = 0;
   intptr_t newspace_size = space->heap()->new_space()->Size();
   bool lazy_sweeping_active = false;
+  bool concurrent_sweeping_active = false;
   bool unused_page_present = false;
 
   intptr_t old_space_size = heap()->PromotedSpaceSize();
@@ -3636,6 +4597,23 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
         }
         break;
       }
+      case CONCURRENT_CONSERVATIVE: {
+        if (FLAG_gc_verbose) {
+          PrintF("Sweeping 0x%" V8PRIxPTR " conservatively in parallel.\n",
+                 reinterpret_cast<intptr_t>(p));
+        }
+        // The page flags are only ever written by the main thread, so the
+        // page is marked as swept up front and merely queued here.
+        p->MarkSweptConservatively();
+        p->set_parallel_sweeping(MemoryChunk::SWEEPING_PENDING);
+        pending_sweeper_pages_.Add(p);
+        if (!concurrent_sweeping_active) {
+          space->SetPagesToSweep(p);
+          concurrent_sweeping_active = true;
+        }
+        pages_swept++;
+        break;
+      }
       case PRECISE: {
         if (FLAG_gc_verbose) {
           PrintF("Sweeping 0x%" V8PRIxPTR " precisely.\n",
@@ -3666,14 +4644,76 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
 }
 
 
+static void RecordObjectStatsInPagedSpace(ObjectStats* stats,
+                                          PagedSpace* space) {
+  PageIterator it(space);
+  int offsets[16];
+  while (it.has_next()) {
+    Page* p = it.next();
+    MarkBit::CellType* cells = p->markbits()->cells();
+    int last_cell_index =
+        Bitmap::IndexToCell(
+            Bitmap::CellAlignIndex(
+                p->AddressToMarkbitIndex(p->ObjectAreaEnd())));
+    Address cell_base = p->ObjectAreaStart();
+    for (int cell_index = Page::kFirstUsedCell;
+         cell_index < last_cell_index;
+         cell_index++, cell_base += 32 * kPointerSize) {
+      if (cells[cell_index] == 0) continue;
+      int live_objects = MarkWordToObjectStarts(cells[cell_index], offsets);
+      for (int i = 0; i < live_objects; i++) {
+        Address object_addr = cell_base + offsets[i] * kPointerSize;
+        stats->Record(space->identity(), HeapObject::FromAddress(object_addr));
+      }
+    }
+  }
+}
+
+
+void MarkCompactCollector::RecordObjectStats() {
+  ObjectStats* stats = heap()->object_stats();
+  stats->Clear();
+
+  NewSpace* new_space = heap()->new_space();
+  SemiSpaceIterator new_it(new_space->bottom(), new_space->top());
+  for (HeapObject* object = new_it.Next();
+       object != NULL;
+       object = new_it.Next()) {
+    if (Marking::MarkBitFrom(object).Get()) stats->Record(NEW_SPACE, object);
+  }
+
+  RecordObjectStatsInPagedSpace(stats, heap()->old_pointer_space());
+  RecordObjectStatsInPagedSpace(stats, heap()->old_data_space());
+  RecordObjectStatsInPagedSpace(stats, heap()->code_space());
+  RecordObjectStatsInPagedSpace(stats, heap()->map_space());
+  RecordObjectStatsInPagedSpace(stats, heap()->cell_space());
+
+  LargeObjectIterator lo_it(heap()->lo_space());
+  for (HeapObject* object = lo_it.Next();
+       object != NULL;
+       object = lo_it.Next()) {
+    if (Marking::MarkBitFrom(object).Get()) stats->Record(LO_SPACE, object);
+  }
+
+  stats->set_recorded();
+}
+
+
 void MarkCompactCollector::SweepSpaces() {
   GCTracer::Scope gc_scope(tracer_, GCTracer::Scope::MC_SWEEP);
 #ifdef DEBUG
   state_ = SWEEP_SPACES;
 #endif
+  // The mark bits still describe all live objects here, so the statistics
+  // cost one pass over the bitmaps and the live objects.
+  if (FLAG_track_object_stats) RecordObjectStats();
   SweeperType how_to_sweep =
       FLAG_lazy_sweeping ? LAZY_CONSERVATIVE : CONSERVATIVE;
+  if (FLAG_concurrent_sweeping) how_to_sweep = CONCURRENT_CONSERVATIVE;
   if (sweep_precisely_) how_to_sweep = PRECISE;
+  // From here on the old space pages may be pending concurrent sweeping.
+  // Until the threads are started the main thread sweeps them on demand.
+  if (how_to_sweep == CONCURRENT_CONSERVATIVE) sweeping_in_progress_ = true;
   // Noncompacting collections simply sweep the spaces to clear the mark
   // bits and free the nonlive blocks (for old and map spaces).  We sweep
   // the map space last because freeing non-live maps overwrites them and
@@ -3696,6 +4736,215 @@ void MarkCompactCollector::SweepSpaces() {
 
   // Deallocate unmarked objects and clear marked bits for marked objects.
   heap_->lo_space()->FreeUnmarkedObjects();
+
+  // The old space pages may only be swept by other threads once evacuation
+  // has stopped scanning them for pointers.
+  if (how_to_sweep == CONCURRENT_CONSERVATIVE) StartSweeperThreads();
+}
+
+
+// A sweeper thread sweeps the pages that SweepSpace queued for concurrent
+// sweeping.  The threads are started on the first collection that needs them
+// and then sleep between collections.
+class SweeperThread : public Thread {
+ public:
+  SweeperThread(Isolate* isolate, int index)
+      : Thread("v8:SweeperThread"),
+        isolate_(isolate),
+        collector_(isolate->heap()->mark_compact_collector()),
+        index_(index),
+        start_sweeping_semaphore_(OS::CreateSemaphore(0)),
+        end_sweeping_semaphore_(OS::CreateSemaphore(0)),
+        stop_(false) { }
+
+  ~SweeperThread() {
+    delete start_sweeping_semaphore_;
+    delete end_sweeping_semaphore_;
+  }
+
+  void Run() {
+    Isolate::SetIsolateThreadLocals(isolate_, NULL);
+    while (true) {
+      start_sweeping_semaphore_->Wait();
+      if (stop_) return;
+      collector_->SweepInParallel(index_);
+      end_sweeping_semaphore_->Signal();
+    }
+  }
+
+  void StartSweeping() {
+    start_sweeping_semaphore_->Signal();
+  }
+
+  void WaitForSweeperThread() {
+    end_sweeping_semaphore_->Wait();
+  }
+
+  void Stop() {
+    stop_ = true;
+    start_sweeping_semaphore_->Signal();
+    Join();
+  }
+
+ private:
+  Isolate* isolate_;
+  MarkCompactCollector* collector_;
+  int index_;
+  Semaphore* start_sweeping_semaphore_;
+  Semaphore* end_sweeping_semaphore_;
+  bool stop_;
+};
+
+
+// A sweeper task does the work of one sweeper thread for one collection on
+// a thread of the embedder's task runner.
+class SweeperTask : public v8::Task {
+ public:
+  SweeperTask(Isolate* isolate, int index, Semaphore* done)
+      : isolate_(isolate), index_(index), done_(done) { }
+
+  void Run() {
+    Isolate* previous_isolate = Isolate::UncheckedCurrent();
+    Isolate::PerIsolateThreadData* previous_data =
+        Isolate::CurrentPerIsolateThreadData();
+    Isolate::SetIsolateThreadLocals(isolate_, NULL);
+    isolate_->heap()->mark_compact_collector()->SweepInParallel(index_);
+    Isolate::SetIsolateThreadLocals(previous_isolate, previous_data);
+    done_->Signal();
+  }
+
+ private:
+  Isolate* isolate_;
+  int index_;
+  Semaphore* done_;
+};
+
+
+void MarkCompactCollector::StartSweeperThreads() {
+  if (pending_sweeper_pages_.is_empty()) {
+    sweeping_in_progress_ = false;
+    return;
+  }
+  v8::TaskRunner* runner = V8::task_runner();
+  if (runner != NULL) {
+    if (sweeper_tasks_semaphore_ == NULL) {
+      sweeper_tasks_semaphore_ = OS::CreateSemaphore(0);
+    }
+    sweeper_threads_count_ = Max(FLAG_sweeper_threads, 1);
+    sweeper_tasks_running_ = sweeper_threads_count_;
+    sweeper_threads_active_ = true;
+    for (int i = 0; i < sweeper_threads_count_; i++) {
+      runner->PostBackgroundTask(
+          new SweeperTask(heap()->isolate(), i, sweeper_tasks_semaphore_));
+    }
+    return;
+  }
+  if (sweeper_threads_ == NULL) {
+    sweeper_threads_count_ = Max(FLAG_sweeper_threads, 1);
+    sweeper_threads_ = new SweeperThread*[sweeper_threads_count_];
+    for (int i = 0; i < sweeper_threads_count_; i++) {
+      sweeper_threads_[i] = new SweeperThread(heap()->isolate(), i);
+      sweeper_threads_[i]->Start();
+    }
+  }
+  sweeper_threads_active_ = true;
+  for (int i = 0; i < sweeper_threads_count_; i++) {
+    sweeper_threads_[i]->StartSweeping();
+  }
+}
+
+
+void MarkCompactCollector::SweepInParallel(int thread_index) {
+  // Every thread walks all queued pages, starting at a different offset so
+  // that the threads do not fight over the same pages.
+  int length = pending_sweeper_pages_.length();
+  int start = thread_index * length / sweeper_threads_count_;
+  for (int i = 0; i < length; i++) {
+    Page* p = pending_sweeper_pages_[(start + i) % length];
+    if (!p->TryParallelSweeping()) continue;
+    PagedSpace* space = static_cast<PagedSpace*>(p->owner());
+    FreeList private_free_list(space);
+    intptr_t freed_bytes = SweepConservatively(space, &private_free_list, p);
+    space->AddConcurrentlySweptMemory(&private_free_list, freed_bytes);
+    p->set_parallel_sweeping(MemoryChunk::SWEEPING_DONE);
+  }
+}
+
+
+void MarkCompactCollector::SweepPageOrWaitForSweeper(MemoryChunk* chunk) {
+  ASSERT(sweeping_in_progress_);
+  Page* p = static_cast<Page*>(chunk);
+  static_cast<PagedSpace*>(p->owner())->SweepPendingPage(p);
+  // Another thread may still be in the middle of sweeping it.
+  while (p->parallel_sweeping() != MemoryChunk::SWEEPING_DONE) {
+    Thread::YieldCPU();
+  }
+}
+
+
+void MarkCompactCollector::WaitUntilSweepingCompleted() {
+  ASSERT(sweeping_in_progress_);
+  if (sweeper_threads_active_) {
+    if (sweeper_tasks_running_ > 0) {
+      for (; sweeper_tasks_running_ > 0; sweeper_tasks_running_--) {
+        sweeper_tasks_semaphore_->Wait();
+      }
+    } else {
+      for (int i = 0; i < sweeper_threads_count_; i++) {
+        sweeper_threads_[i]->WaitForSweeperThread();
+      }
+    }
+    sweeper_threads_active_ = false;
+  }
+  // Sweep whatever is left if we are called before the threads were started.
+  // The sweeper threads leave the live bytes alone because the mutator may
+  // still adjust them for objects it shrinks.
+  for (int i = 0; i < pending_sweeper_pages_.length(); i++) {
+    Page* p = pending_sweeper_pages_[i];
+    static_cast<PagedSpace*>(p->owner())->SweepPendingPage(p);
+    ASSERT(p->parallel_sweeping() == MemoryChunk::SWEEPING_DONE);
+    p->ResetLiveBytes();
+  }
+  sweeping_in_progress_ = false;
+  pending_sweeper_pages_.Rewind(0);
+  heap()->old_pointer_space()->RefillFreeListFromSweeperThreads();
+  heap()->old_data_space()->RefillFreeListFromSweeperThreads();
+  heap()->old_pointer_space()->SetPagesToSweep(NULL);
+  heap()->old_data_space()->SetPagesToSweep(NULL);
+}
+
+
+void MarkCompactCollector::TearDown() {
+  if (sweeping_in_progress_) WaitUntilSweepingCompleted();
+  delete sweeper_tasks_semaphore_;
+  sweeper_tasks_semaphore_ = NULL;
+  if (sweeper_threads_ != NULL) {
+    for (int i = 0; i < sweeper_threads_count_; i++) {
+      sweeper_threads_[i]->Stop();
+      delete sweeper_threads_[i];
+    }
+    delete[] sweeper_threads_;
+    sweeper_threads_ = NULL;
+    sweeper_threads_count_ = 0;
+  }
+  if (marking_threads_ != NULL) {
+    for (int i = 0; i < marking_threads_count_; i++) {
+      marking_threads_[i]->Stop();
+      delete marking_threads_[i];
+    }
+    delete[] marking_threads_;
+    marking_threads_ = NULL;
+    marking_threads_count_ = 0;
+  }
+  if (evacuation_threads_ != NULL) {
+    for (int i = 0; i < evacuation_threads_count_; i++) {
+      evacuation_threads_[i]->Stop();
+      delete evacuation_threads_[i];
+    }
+    delete[] evacuation_threads_;
+    evacuation_threads_ = NULL;
+    evacuation_threads_count_ = 0;
+  }
 }
 
 
@@ -3851,6 +5100,34 @@ void SlotsBuffer::UpdateSlotsWithFilter(Heap* heap) {
 }
 
 
+void SlotsBuffer::UpdateSlotsOfKind(Heap* heap,
+                                    SlotKind kind,
+                                    bool code_slots_filtering_required) {
+  PointersUpdatingVisitor v(heap);
+
+  for (int slot_idx = 0; slot_idx < idx_; ++slot_idx) {
+    ObjectSlot slot = slots_[slot_idx];
+    if (!IsTypedSlot(slot)) {
+      if (kind != UNTYPED_SLOTS) continue;
+      if (code_slots_filtering_required &&
+          IsOnInvalidatedCodeObject(reinterpret_cast<Address>(slot))) {
+        continue;
+      }
+      PointersUpdatingVisitor::UpdateSlot(heap, slot);
+    } else {
+      ++slot_idx;
+      ASSERT(slot_idx < idx_);
+      if (kind != TYPED_SLOTS) continue;
+      Address pc = reinterpret_cast<Address>(slots_[slot_idx]);
+      if (code_slots_filtering_required && IsOnInvalidatedCodeObject(pc)) {
+        continue;
+      }
+      UpdateSlot(&v, DecodeSlotType(slot), pc);
+    }
+  }
+}
+
+
 SlotsBuffer* SlotsBufferAllocator::AllocateBuffer(SlotsBuffer* next_buffer) {
   return new SlotsBuffer(next_buffer);
 }
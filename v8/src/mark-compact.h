@@ -29,6 +29,7 @@
 #define V8_MARK_COMPACT_H_
 
 #include "compiler-intrinsics.h"
+#include "hashmap.h"
 #include "spaces.h"
 
 namespace v8 {
@@ -41,9 +42,15 @@ typedef bool (*IsAliveFunction)(HeapObject* obj, int* size, int* offset);
 
 // Forward declarations.
 class CodeFlusher;
+class EvacuationThread;
 class GCTracer;
 class MarkingVisitor;
+class MarkingThread;
+class ParallelEvacuationJob;
+class ParallelEvacuator;
+class ParallelMarkingWorker;
 class RootMarkingVisitor;
+class SweeperThread;
 
 
 class Marking {
@@ -185,6 +192,8 @@ class MarkingDeque {
 
   inline bool IsEmpty() { return top_ == bottom_; }
 
+  inline int Size() { return (top_ - bottom_) & mask_; }
+
   bool overflowed() const { return overflowed_; }
 
   void ClearOverflowed() { overflowed_ = false; }
@@ -308,6 +317,17 @@ class SlotsBuffer {
 
   void UpdateSlotsWithFilter(Heap* heap);
 
+  // Parallel pointer updating updates the untyped slots on several threads
+  // and the typed slots, which patch code, on the main thread only.
+  enum SlotKind {
+    UNTYPED_SLOTS,
+    TYPED_SLOTS
+  };
+
+  void UpdateSlotsOfKind(Heap* heap,
+                         SlotKind kind,
+                         bool code_slots_filtering_required);
+
   SlotsBuffer* next() { return next_; }
 
   static int SizeOfChain(SlotsBuffer* buffer) {
@@ -437,10 +457,21 @@ class MarkCompactCollector {
   // Performs a global garbage collection.
   void CollectGarbage();
 
-  bool StartCompaction();
+  enum CompactionMode {
+    INCREMENTAL_COMPACTION,
+    NON_INCREMENTAL_COMPACTION
+  };
+
+  bool StartCompaction(CompactionMode mode);
 
   void AbortCompaction();
 
+  // With --string-dedup, replaces a reference to a short sequential old
+  // space string by a reference to an equal string seen earlier in the
+  // marking, so copies that are no longer referenced die.  Returns the
+  // object that *p refers to afterwards.
+  inline HeapObject* DeduplicateString(Object** p, HeapObject* object);
+
   // During a full GC, there is a stack-allocated GCTracer that is used for
   // bookkeeping information.  Return a pointer to that tracer.
   GCTracer* tracer() { return tracer_; }
@@ -470,6 +501,7 @@ class MarkCompactCollector {
   enum SweeperType {
     CONSERVATIVE,
     LAZY_CONSERVATIVE,
+    CONCURRENT_CONSERVATIVE,
     PRECISE
   };
 
@@ -483,6 +515,14 @@ class MarkCompactCollector {
   // Return a number of reclaimed bytes.
   static intptr_t SweepConservatively(PagedSpace* space, Page* p);
 
+  // Sweep a page that was claimed for concurrent sweeping.  The reclaimed
+  // memory goes to the given free list and neither the page flags nor the
+  // space accounting are touched, so this is safe to call from a sweeper
+  // thread.  Return a number of reclaimed bytes.
+  static intptr_t SweepConservatively(PagedSpace* space,
+                                      FreeList* free_list,
+                                      Page* p);
+
   INLINE(static bool ShouldSkipEvacuationSlotRecording(Object** anchor)) {
     return Page::FromAddress(reinterpret_cast<Address>(anchor))->
         ShouldSkipEvacuationSlotRecording();
@@ -536,10 +576,43 @@ class MarkCompactCollector {
     encountered_weak_maps_ = weak_map;
   }
 
+  // Marks the values of the entries of an encountered weak map whose keys
+  // are already marked, and remembers the other entries until their keys
+  // get marked.
+  void DiscoverEphemerons(ObjectHashTable* table);
+
+  // Marks the values of the remembered weak map entries with this key,
+  // which has just been marked.
+  INLINE(void ProcessEphemeronKey(HeapObject* key)) {
+    if (pending_ephemeron_keys_.occupancy() > 0) ProcessEphemeronKeySlow(key);
+  }
+
   void InvalidateCode(Code* code);
 
   void ClearMarkbits();
 
+  // Concurrent sweeping of the old pointer and old data space.  Pages that
+  // are pending concurrent sweeping still carry their mark bits, so anything
+  // that needs the mark bits or an iterable page has to wait for the page
+  // with EnsurePageIsSwept or for all of them with
+  // WaitUntilSweepingCompleted.
+  bool IsConcurrentSweepingInProgress() { return sweeping_in_progress_; }
+
+  void EnsurePageIsSwept(MemoryChunk* chunk) {
+    if (sweeping_in_progress_ &&
+        chunk->parallel_sweeping() != MemoryChunk::SWEEPING_DONE) {
+      SweepPageOrWaitForSweeper(chunk);
+    }
+  }
+
+  void WaitUntilSweepingCompleted();
+
+  // Called on the sweeper threads.
+  void SweepInParallel(int thread_index);
+
+  // Stops the sweeper threads.
+  void TearDown();
+
  private:
   MarkCompactCollector();
   ~MarkCompactCollector();
@@ -568,6 +641,21 @@ class MarkCompactCollector {
   // heap.
   bool sweep_precisely_;
 
+  // Global flag that makes compaction evacuate every sparse page, so the
+  // pages left empty can be released.
+  bool reduce_memory_footprint_;
+
+  // State of --string-dedup for the current collection: a lossy table of
+  // the canonical strings, indexed by hash, and the strings that lost a
+  // reference to one of them.
+  static const int kStringDedupTableSize = 4096;
+  static const int kMaxDedupStringLength = 64;
+  HeapObject* DeduplicateStringSlow(Object** p, String* string);
+  void FinishStringDeduplication();
+  bool deduplicate_strings_;
+  String** string_dedup_table_;
+  List<HeapObject*> string_duplicates_;
+
   // True if we are collecting slots to perform evacuation from evacuation
   // candidates.
   bool compacting_;
@@ -584,6 +672,32 @@ class MarkCompactCollector {
 
   SlotsBuffer* migration_slots_buffer_;
 
+  // Pages of the old pointer and old data space queued for the sweeper
+  // threads.  Only the main thread changes the list, and only while the
+  // sweepers are idle.
+  List<Page*> pending_sweeper_pages_;
+
+  bool sweeping_in_progress_;
+
+  bool sweeper_threads_active_;
+
+  SweeperThread** sweeper_threads_;
+  int sweeper_threads_count_;
+
+  // With an embedder task runner the sweepers run as tasks instead of on
+  // sweeper_threads_; each signals the semaphore when it is done.
+  Semaphore* sweeper_tasks_semaphore_;
+  int sweeper_tasks_running_;
+
+  MarkingThread** marking_threads_;
+  int marking_threads_count_;
+
+  EvacuationThread** evacuation_threads_;
+  int evacuation_threads_count_;
+
+  // Slots recorded by the evacuators of a parallel evacuation.
+  List<SlotsBuffer*> evacuator_slots_buffers_;
+
   // Finishes GC, performs heap verification if enabled.
   void Finish();
 
@@ -600,11 +714,18 @@ class MarkCompactCollector {
   friend class RootMarkingVisitor;
   friend class MarkingVisitor;
   friend class StaticMarkingVisitor;
+  friend class ParallelMarkingWorker;
+  friend class ParallelEvacuator;
   friend class CodeMarkingVisitor;
+  friend class OptimizedCodeUseVisitor;
   friend class SharedFunctionInfoMarkingVisitor;
 
   void PrepareForCodeFlushing();
 
+  // Deoptimizes the functions whose optimized code has not been found
+  // running for --max-optimized-code-age full collections.
+  void EvictUnusedOptimizedCode();
+
   // Marking operations for objects reachable from roots.
   void MarkLiveObjects();
 
@@ -650,6 +771,15 @@ class MarkCompactCollector {
   // or overflowed in the heap.
   void ProcessMarkingDeque();
 
+  // Parallel marking.  Once the marking stack holds enough objects its
+  // contents are spread over the marking threads, which mark through all
+  // objects that have no special marking rules, then the main thread takes
+  // care of the rest.  Returns with new objects on the marking stack if
+  // the special objects led to any.
+  static const int kMinObjectsForParallelMarking = 256;
+  bool CanUseParallelMarking();
+  void ParallelEmptyMarkingDeque();
+
   // Mark objects reachable (transitively) from objects in the marking
   // stack.  This function empties the marking stack, but may leave
   // overflowed objects in the heap, in which case the marking stack's
@@ -679,10 +809,25 @@ class MarkCompactCollector {
   // ClearNonLiveTransitions pass or by calling this function.
   void ReattachInitialMaps();
 
-  // Mark all values associated with reachable keys in weak maps encountered
-  // so far.  This might push new object or even new weak maps onto the
-  // marking stack.
-  void ProcessWeakMaps();
+  // Weak map entries are ephemerons: the value is live if the key is.  The
+  // entries whose keys were not marked when their weak map was encountered
+  // are kept in a table indexed by key.  Objects popped from the marking
+  // deque and objects visited recursively are looked up in that table, so
+  // every entry is revisited only once, when its key gets marked.
+  struct Ephemeron {
+    ObjectHashTable* table;
+    int entry;
+    int next;  // Index of the next ephemeron with the same key, or -1.
+  };
+
+  void MarkEphemeronValue(ObjectHashTable* table, int entry);
+  void ProcessEphemeronKeySlow(HeapObject* key);
+
+  // Marks the values of the remembered entries whose keys were marked
+  // without passing through ProcessEphemeronKey, e.g. by the parallel
+  // marking workers.  This might push new objects or even new weak maps
+  // onto the marking stack.
+  void ProcessEphemerons();
 
   // After all reachable objects have been marked those weak map entries
   // with an unreachable key are removed from all encountered weak maps.
@@ -705,16 +850,33 @@ class MarkCompactCollector {
   // regions to each space's free list.
   void SweepSpaces();
 
+  // Records the live objects in Heap::object_stats() for
+  // --track-object-stats.  Must be called before any space is swept.
+  void RecordObjectStats();
+
   void EvacuateNewSpace();
 
   void EvacuateLiveObjectsFromPage(Page* p);
 
   void EvacuatePages();
 
+  // Parallel evacuation.  The pages of the old pointer and old data space
+  // are evacuated by the evacuation threads and the main thread together,
+  // code pages by the main thread alone.  Returns false without doing
+  // anything if the spaces might not have room for the evacuated objects.
+  bool CanUseParallelEvacuation();
+  bool ParallelEvacuatePages();
+  void ParallelUpdateSlots(bool code_slots_filtering_required);
+  void RunParallelEvacuationJob(ParallelEvacuationJob* job);
+
   void EvacuateNewSpaceAndCandidates();
 
   void SweepSpace(PagedSpace* space, SweeperType sweeper);
 
+  void StartSweeperThreads();
+
+  void SweepPageOrWaitForSweeper(MemoryChunk* chunk);
+
 #ifdef DEBUG
   friend class MarkObjectVisitor;
   static void VisitObject(HeapObject* obj);
@@ -727,6 +889,9 @@ class MarkCompactCollector {
   MarkingDeque marking_deque_;
   CodeFlusher* code_flusher_;
   Object* encountered_weak_maps_;
+  List<Ephemeron> ephemerons_;
+  // Maps an unmarked key to the index of its last ephemeron plus one.
+  HashMap pending_ephemeron_keys_;
 
   List<Page*> evacuation_candidates_;
   List<Code*> invalidated_code_;
@@ -195,10 +195,15 @@ function FormatMessage(message) {
       "proxy_non_object_prop_names",  ["Trap '", "%1", "' returned non-object ", "%0"],
       "proxy_repeated_prop_name",     ["Trap '", "%1", "' returned repeated property name '", "%2", "'"],
       "invalid_weakmap_key",          ["Invalid value used as weak map key"],
+      "invalid_typed_array_source",   ["%0", " is not an array-like object"],
       // RangeError
       "invalid_array_length",         ["Invalid array length"],
       "stack_overflow",               ["Maximum call stack size exceeded"],
+      "regexp_backtrack_limit",       ["Maximum regular expression backtracking exceeded"],
       "invalid_time_value",           ["Invalid time value"],
+      "invalid_array_buffer_length",  ["Invalid array buffer length"],
+      "invalid_typed_array_offset",   ["Start offset of ", "%0", " is outside the buffer or not a multiple of the element size"],
+      "invalid_typed_array_length",   ["Invalid typed array length"],
       // SyntaxError
       "unable_to_parse",              ["Parse error"],
       "invalid_regexp_flags",         ["Invalid flags supplied to RegExp constructor '", "%0", "'"],
@@ -334,34 +339,7 @@ function MakeError(type, args) {
        else the line number.
  */
 function ScriptLineFromPosition(position) {
-  var lower = 0;
-  var upper = this.lineCount() - 1;
-  var line_ends = this.line_ends;
-
-  // We'll never find invalid positions so bail right away.
-  if (position > line_ends[upper]) {
-    return -1;
-  }
-
-  // This means we don't have to safe-guard indexing line_ends[i - 1].
-  if (position <= line_ends[0]) {
-    return 0;
-  }
-
-  // Binary search to find line # from position range.
-  while (upper >= 1) {
-    var i = (lower + upper) >> 1;
-
-    if (position > line_ends[i]) {
-      lower = i + 1;
-    } else if (position <= line_ends[i - 1]) {
-      upper = i - 1;
-    } else {
-      return i;
-    }
-  }
-
-  return -1;
+  return %ScriptLineFromPosition(this, position);
 }
 
 /**
@@ -378,9 +356,8 @@ function ScriptLocationFromPosition(position,
   if (line == -1) return null;
 
   // Determine start, end and column.
-  var line_ends = this.line_ends;
-  var start = line == 0 ? 0 : line_ends[line - 1] + 1;
-  var end = line_ends[line];
+  var start = line == 0 ? 0 : %ScriptLineEnd(this, line - 1) + 1;
+  var end = %ScriptLineEnd(this, line);
   if (end > 0 && %_CallFunction(this.source, end - 1, StringCharAt) == '\r') {
     end--;
   }
@@ -440,8 +417,9 @@ function ScriptLocationFromLine(opt_line, opt_column, opt_offset_position) {
       return null;
     }
 
-    return this.locationFromPosition(
-        this.line_ends[offset_line + line - 1] + 1 + column);  // line > 0 here.
+    // line > 0 here.
+    var line_end = %ScriptLineEnd(this, offset_line + line - 1);
+    return this.locationFromPosition(line_end + 1 + column);
   }
 }
 
@@ -475,9 +453,9 @@ function ScriptSourceSlice(opt_from_line, opt_to_line) {
     return null;
   }
 
-  var line_ends = this.line_ends;
-  var from_position = from_line == 0 ? 0 : line_ends[from_line - 1] + 1;
-  var to_position = to_line == 0 ? 0 : line_ends[to_line - 1] + 1;
+  var from_position =
+      from_line == 0 ? 0 : %ScriptLineEnd(this, from_line - 1) + 1;
+  var to_position = to_line == 0 ? 0 : %ScriptLineEnd(this, to_line - 1) + 1;
 
   // Return a source slice with line numbers re-adjusted to the resource.
   return new SourceSlice(this,
@@ -501,9 +479,8 @@ function ScriptSourceLine(opt_line) {
   }
 
   // Return the source line.
-  var line_ends = this.line_ends;
-  var start = line == 0 ? 0 : line_ends[line - 1] + 1;
-  var end = line_ends[line];
+  var start = line == 0 ? 0 : %ScriptLineEnd(this, line - 1) + 1;
+  var end = %ScriptLineEnd(this, line);
   return %_CallFunction(this.source, start, end, StringSubstring);
 }
 
@@ -515,7 +492,7 @@ function ScriptSourceLine(opt_line) {
  */
 function ScriptLineCount() {
   // Return number of source lines.
-  return this.line_ends.length;
+  return %ScriptLineCount(this);
 }
 
 
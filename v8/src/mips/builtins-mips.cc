@@ -730,7 +730,7 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
         __ Push(a1, a2);
 
         __ push(a1);  // Constructor.
-        // The call will replace the stub, so the countdown is only done once.
+        // The call either restarts the countdown or replaces the stub.
         __ CallRuntime(Runtime::kFinalizeInstanceSize, 1);
 
         __ pop(a2);
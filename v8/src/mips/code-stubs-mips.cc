@@ -3509,6 +3509,13 @@ void StackCheckStub::Generate(MacroAssembler* masm) {
 }
 
 
+void InterruptStub::Generate(MacroAssembler* masm) {
+  // a2 holds the profiling counter cell.
+  __ push(a2);
+  __ TailCallRuntime(Runtime::kInterrupt, 1, 1);
+}
+
+
 void MathPowStub::Generate(MacroAssembler* masm) {
   Label call_runtime;
 
@@ -4063,10 +4070,19 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   const Register function = a1;  // Function (rhs).
   const Register prototype = t0;  // Prototype of the function.
   const Register inline_site = t5;
+  // Without a call site cache, the offset of the instanceof cache entry.
+  const Register cache_offset = t5;
   const Register scratch = a2;
 
   const int32_t kDeltaToLoadBoolResult = 4 * kPointerSize;
 
+  ExternalReference cache_functions =
+      ExternalReference::instanceof_cache_functions(masm->isolate());
+  ExternalReference cache_maps =
+      ExternalReference::instanceof_cache_maps(masm->isolate());
+  ExternalReference cache_answers =
+      ExternalReference::instanceof_cache_answers(masm->isolate());
+
   Label slow, loop, is_instance, is_not_instance, not_js_object;
 
   if (!HasArgsInRegisters()) {
@@ -4082,11 +4098,19 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   // real lookup and update the call site cache.
   if (!HasCallSiteInlineCheck()) {
     Label miss;
-    __ LoadRoot(at, Heap::kInstanceofCacheFunctionRootIndex);
+    __ xor_(cache_offset, map, function);
+    __ And(cache_offset, cache_offset, Operand(InstanceofCache::kOffsetMask));
+    __ li(at, Operand(cache_functions));
+    __ addu(at, at, cache_offset);
+    __ lw(at, MemOperand(at));
     __ Branch(&miss, ne, function, Operand(at));
-    __ LoadRoot(at, Heap::kInstanceofCacheMapRootIndex);
+    __ li(at, Operand(cache_maps));
+    __ addu(at, at, cache_offset);
+    __ lw(at, MemOperand(at));
     __ Branch(&miss, ne, map, Operand(at));
-    __ LoadRoot(v0, Heap::kInstanceofCacheAnswerRootIndex);
+    __ li(at, Operand(cache_answers));
+    __ addu(at, at, cache_offset);
+    __ lw(v0, MemOperand(at));
     __ DropAndRet(HasArgsInRegisters() ? 0 : 2);
 
     __ bind(&miss);
@@ -4102,8 +4126,12 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   // Update the global instanceof or call site inlined cache with the current
   // map and function. The cached answer will be set when it is known below.
   if (!HasCallSiteInlineCheck()) {
-    __ StoreRoot(function, Heap::kInstanceofCacheFunctionRootIndex);
-    __ StoreRoot(map, Heap::kInstanceofCacheMapRootIndex);
+    __ li(at, Operand(cache_functions));
+    __ addu(at, at, cache_offset);
+    __ sw(function, MemOperand(at));
+    __ li(at, Operand(cache_maps));
+    __ addu(at, at, cache_offset);
+    __ sw(map, MemOperand(at));
   } else {
     ASSERT(HasArgsInRegisters());
     // Patch the (relocated) inlined map check.
@@ -4137,7 +4165,9 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   ASSERT(Smi::FromInt(0) == 0);
   if (!HasCallSiteInlineCheck()) {
     __ mov(v0, zero_reg);
-    __ StoreRoot(v0, Heap::kInstanceofCacheAnswerRootIndex);
+    __ li(at, Operand(cache_answers));
+    __ addu(at, at, cache_offset);
+    __ sw(v0, MemOperand(at));
   } else {
     // Patch the call site to return true.
     __ LoadRoot(v0, Heap::kTrueValueRootIndex);
@@ -4155,7 +4185,9 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   __ bind(&is_not_instance);
   if (!HasCallSiteInlineCheck()) {
     __ li(v0, Operand(Smi::FromInt(1)));
-    __ StoreRoot(v0, Heap::kInstanceofCacheAnswerRootIndex);
+    __ li(at, Operand(cache_answers));
+    __ addu(at, at, cache_offset);
+    __ sw(v0, MemOperand(at));
   } else {
     // Patch the call site to return false.
     __ LoadRoot(v0, Heap::kFalseValueRootIndex);
@@ -4718,6 +4750,19 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   // Get the length of the string to r3.
   __ lw(a3, FieldMemOperand(subject, String::kLengthOffset));
 
+  // a2: Number of capture registers
+  // a3: Length of subject string as a smi
+  // subject: Subject string
+  // regexp_data: RegExp data (FixedArray)
+  // Long subjects are searched for the literal prefix in the runtime.
+  Label no_literal_prefix;
+  __ lw(a0,
+        FieldMemOperand(regexp_data, JSRegExp::kIrregexpLiteralPrefixOffset));
+  __ JumpIfSmi(a0, &no_literal_prefix);
+  __ Branch(&runtime, ge, a3,
+            Operand(Smi::FromInt(JSRegExp::kLiteralPrefixMinSubjectLength)));
+  __ bind(&no_literal_prefix);
+
   // a2: Number of capture registers
   // a3: Length of subject string as a smi
   // subject: Subject string
@@ -5773,9 +5818,13 @@ void StringHelper::GenerateTwoCharacterSymbolTableProbe(MacroAssembler* masm,
 void StringHelper::GenerateHashInit(MacroAssembler* masm,
                                       Register hash,
                                       Register character) {
-  // hash = character + (character << 10);
-  __ sll(hash, character, 10);
+  // hash = seed + character + ((seed + character) << 10);
+  __ LoadRoot(hash, Heap::kHashSeedRootIndex);
+  // Untag smi seed and add the character.
+  __ SmiUntag(hash);
   __ addu(hash, hash, character);
+  __ sll(at, hash, 10);
+  __ addu(hash, hash, at);
   // hash ^= hash >> 6;
   __ srl(at, hash, 6);
   __ xor_(hash, hash, at);
@@ -6422,6 +6471,28 @@ void StringAddStub::Generate(MacroAssembler* masm) {
   // Fill the fields of the cons string.
   __ sw(a0, FieldMemOperand(t3, ConsString::kFirstOffset));
   __ sw(a1, FieldMemOperand(t3, ConsString::kSecondOffset));
+  // The depth of the result is one more than that of its deeper part.  Too
+  // deep results are left to the runtime, which rebalances them.
+  Label first_is_flat, second_is_flat;
+  __ li(t2, Operand(Smi::FromInt(0)));
+  __ lw(t0, FieldMemOperand(a0, HeapObject::kMapOffset));
+  __ lbu(t0, FieldMemOperand(t0, Map::kInstanceTypeOffset));
+  __ And(t0, t0, Operand(kStringRepresentationMask));
+  __ Branch(&first_is_flat, ne, t0, Operand(kConsStringTag));
+  __ lw(t2, FieldMemOperand(a0, ConsString::kDepthOffset));
+  __ bind(&first_is_flat);
+  __ lw(t1, FieldMemOperand(a1, HeapObject::kMapOffset));
+  __ lbu(t1, FieldMemOperand(t1, Map::kInstanceTypeOffset));
+  __ And(t1, t1, Operand(kStringRepresentationMask));
+  __ Branch(&second_is_flat, ne, t1, Operand(kConsStringTag));
+  __ lw(t1, FieldMemOperand(a1, ConsString::kDepthOffset));
+  __ Branch(&second_is_flat, le, t1, Operand(t2));
+  __ mov(t2, t1);
+  __ bind(&second_is_flat);
+  __ Addu(t2, t2, Operand(Smi::FromInt(1)));
+  __ sw(t2, FieldMemOperand(t3, ConsString::kDepthOffset));
+  __ Branch(&string_add_runtime, gt, t2,
+            Operand(Smi::FromInt(ConsString::kMaxDepth)));
   __ mov(v0, t3);
   __ IncrementCounter(counters->string_add_native(), 1, a2, a3);
   __ Addu(sp, sp, Operand(2 * kPointerSize));
@@ -359,7 +359,7 @@ void Deoptimizer::DoComputeFrame(TranslationIterator* iterator,
   USE(opcode);
   ASSERT(Translation::FRAME == opcode);
   int node_id = iterator->Next();
-  JSFunction* function = JSFunction::cast(ComputeLiteral(iterator->Next()));
+  JSFunction* function = ComputeFunction(frame_index, iterator->Next());
   unsigned height = iterator->Next();
   unsigned height_in_bytes = height * kPointerSize;
   if (FLAG_trace_deopt) {
@@ -100,6 +100,7 @@ void LCodeGen::Abort(const char* format, ...) {
     va_end(arguments);
     PrintF("\n");
   }
+  info()->set_bailout_reason(format);
   status_ = ABORTED;
 }
 
@@ -413,16 +414,36 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
                                 Translation* translation) {
   if (environment == NULL) return;
 
-  // The translation includes one command per value in the environment.
-  int translation_size = environment->values()->length();
+  // The translation includes one command per frame value in the environment.
+  int translation_size = environment->translation_size();
   // The output frame height does not include the parameters.
   int height = translation_size - environment->parameter_count();
 
   WriteTranslation(environment->outer(), translation);
   int closure_id = DefineDeoptimizationLiteral(environment->closure());
+  if (environment->has_dynamic_closure()) {
+    closure_id = Translation::DynamicClosureId(closure_id);
+  }
   translation->BeginFrame(environment->ast_id(), closure_id, height);
+  // The fields of captured objects follow the frame values.
+  int field_index = translation_size;
   for (int i = 0; i < translation_size; ++i) {
     LOperand* value = environment->values()->at(i);
+    LCapturedObject* captured = environment->CapturedObjectAt(i);
+    if (captured != NULL) {
+      int boilerplate_id =
+          DefineDeoptimizationLiteral(captured->boilerplate());
+      translation->StoreCapturedObject(boilerplate_id,
+                                       captured->field_count());
+      for (int j = 0; j < captured->field_count(); ++j) {
+        AddToTranslation(translation,
+                         environment->values()->at(field_index),
+                         environment->HasTaggedValueAt(field_index),
+                         environment->HasUint32ValueAt(field_index));
+        field_index++;
+      }
+      continue;
+    }
     // spilled_registers_ and spilled_double_registers_ are either
     // both NULL or both set.
     if (environment->spilled_registers() != NULL && value != NULL) {
@@ -431,7 +452,8 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         translation->MarkDuplicate();
         AddToTranslation(translation,
                          environment->spilled_registers()[value->index()],
-                         environment->HasTaggedValueAt(i));
+                         environment->HasTaggedValueAt(i),
+                         environment->HasUint32ValueAt(i));
       } else if (
           value->IsDoubleRegister() &&
           environment->spilled_double_registers()[value->index()] != NULL) {
@@ -439,18 +461,23 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         AddToTranslation(
             translation,
             environment->spilled_double_registers()[value->index()],
+            false,
             false);
       }
     }
 
-    AddToTranslation(translation, value, environment->HasTaggedValueAt(i));
+    AddToTranslation(translation,
+                     value,
+                     environment->HasTaggedValueAt(i),
+                     environment->HasUint32ValueAt(i));
   }
 }
 
 
 void LCodeGen::AddToTranslation(Translation* translation,
                                 LOperand* op,
-                                bool is_tagged) {
+                                bool is_tagged,
+                                bool is_uint32) {
   if (op == NULL) {
     // TODO(twuerthinger): Introduce marker operands to indicate that this value
     // is not present and must be reconstructed from the deoptimizer. Currently
@@ -459,6 +486,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
   } else if (op->IsStackSlot()) {
     if (is_tagged) {
       translation->StoreStackSlot(op->index());
+    } else if (is_uint32) {
+      translation->StoreUint32StackSlot(op->index());
     } else {
       translation->StoreInt32StackSlot(op->index());
     }
@@ -472,6 +501,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
     Register reg = ToRegister(op);
     if (is_tagged) {
       translation->StoreRegister(reg);
+    } else if (is_uint32) {
+      translation->StoreUint32Register(reg);
     } else {
       translation->StoreInt32Register(reg);
     }
@@ -620,6 +651,15 @@ void LCodeGen::PopulateDeoptimizationData(Handle<Code> code) {
   }
   data->SetLiteralArray(*literals);
 
+  const ZoneList<Handle<JSGlobalPropertyCell> >* cells =
+      graph()->dependent_cells();
+  Handle<FixedArray> dependent_cells =
+      factory()->NewFixedArray(cells->length(), TENURED);
+  for (int i = 0; i < cells->length(); i++) {
+    dependent_cells->set(i, *cells->at(i));
+  }
+  data->SetDependentCells(*dependent_cells);
+
   data->SetOsrAstId(Smi::FromInt(info_->osr_ast_id()));
   data->SetOsrPcOffset(Smi::FromInt(osr_pc_offset_));
 
@@ -902,8 +942,11 @@ void LCodeGen::DoDivI(LDivI* instr) {
     __ bind(&left_not_min_int);
   }
 
-  __ mfhi(result);
-  DeoptimizeIf(ne, instr->environment(), result, Operand(zero_reg));
+  // Deoptimize if remainder is not 0, unless the result is truncated.
+  if (!instr->hydrogen()->all_uses_truncating()) {
+    __ mfhi(result);
+    DeoptimizeIf(ne, instr->environment(), result, Operand(zero_reg));
+  }
   __ mflo(result);
 }
 
@@ -1214,6 +1257,46 @@ void LCodeGen::DoValueOf(LValueOf* instr) {
 }
 
 
+void LCodeGen::DoDateField(LDateField* instr) {
+  Register object = ToRegister(instr->InputAt(0));
+  Register result = ToRegister(instr->result());
+  Register scratch = ToRegister(instr->TempAt(0));
+  Smi* index = instr->index();
+  Label runtime, done;
+  ASSERT(object.is(a0));
+  ASSERT(result.is(v0));
+  ASSERT(!scratch.is(scratch0()));
+  ASSERT(!scratch.is(object));
+
+#ifdef DEBUG
+  __ AbortIfSmi(object);
+  __ GetObjectType(object, scratch, scratch);
+  __ Assert(eq, "Trying to get date field from non-date.",
+      scratch, Operand(JS_DATE_TYPE));
+#endif
+
+  if (index->value() == 0) {
+    __ lw(result, FieldMemOperand(object, JSDate::kValueOffset));
+  } else {
+    if (index->value() < JSDate::kFirstUncachedField) {
+      ExternalReference stamp = ExternalReference::date_cache_stamp(isolate());
+      __ li(scratch, Operand(stamp));
+      __ lw(scratch, MemOperand(scratch));
+      __ lw(scratch0(), FieldMemOperand(object, JSDate::kCacheStampOffset));
+      __ Branch(&runtime, ne, scratch, Operand(scratch0()));
+      __ lw(result, FieldMemOperand(object, JSDate::kValueOffset +
+                                            kPointerSize * index->value()));
+      __ jmp(&done);
+    }
+    __ bind(&runtime);
+    __ PrepareCallCFunction(2, scratch);
+    __ li(a1, Operand(index));
+    __ CallCFunction(ExternalReference::get_date_field_function(isolate()), 2);
+    __ bind(&done);
+  }
+}
+
+
 void LCodeGen::DoBitNotI(LBitNotI* instr) {
   Register input = ToRegister(instr->InputAt(0));
   Register result = ToRegister(instr->result());
@@ -1753,6 +1836,27 @@ void LCodeGen::DoStringCompareAndBranch(LStringCompareAndBranch* instr) {
   int true_block = chunk_->LookupDestination(instr->true_block_id());
   int false_block = chunk_->LookupDestination(instr->false_block_id());
 
+  if (op == Token::EQ || op == Token::EQ_STRICT) {
+    // Identical strings are equal.  Different symbols and strings of
+    // different lengths are not.
+    Register left = ToRegister(instr->InputAt(0));
+    Register right = ToRegister(instr->InputAt(1));
+    Label* true_label = chunk_->GetAssemblyLabel(true_block);
+    Label* false_label = chunk_->GetAssemblyLabel(false_block);
+    __ Branch(true_label, eq, left, Operand(right));
+    __ lw(a2, FieldMemOperand(left, HeapObject::kMapOffset));
+    __ lw(a3, FieldMemOperand(right, HeapObject::kMapOffset));
+    __ lbu(a2, FieldMemOperand(a2, Map::kInstanceTypeOffset));
+    __ lbu(a3, FieldMemOperand(a3, Map::kInstanceTypeOffset));
+    STATIC_ASSERT(kSymbolTag != 0);
+    __ And(a2, a2, Operand(a3));
+    __ And(a2, a2, Operand(kIsSymbolMask));
+    __ Branch(false_label, ne, a2, Operand(zero_reg));
+    __ lw(a2, FieldMemOperand(left, String::kLengthOffset));
+    __ lw(a3, FieldMemOperand(right, String::kLengthOffset));
+    __ Branch(false_label, ne, a2, Operand(a3));
+  }
+
   Handle<Code> ic = CompareIC::GetUninitialized(op);
   CallCode(ic, RelocInfo::CODE_TARGET, instr);
 
@@ -2515,11 +2619,10 @@ void LCodeGen::DoLoadKeyedSpecializedArrayElement(
         break;
       case EXTERNAL_UNSIGNED_INT_ELEMENTS:
         __ lw(result, mem_operand);
-        // TODO(danno): we could be more clever here, perhaps having a special
-        // version of the stub that detects if the overflow case actually
-        // happens, and generate code that returns a double rather than int.
-        DeoptimizeIf(Ugreater_equal, instr->environment(),
-            result, Operand(0x80000000));
+        if (!instr->hydrogen_value()->IsUint32()) {
+          DeoptimizeIf(Ugreater_equal, instr->environment(),
+              result, Operand(0x80000000));
+        }
         break;
       case EXTERNAL_FLOAT_ELEMENTS:
       case EXTERNAL_DOUBLE_ELEMENTS:
@@ -2545,6 +2648,14 @@ void LCodeGen::DoLoadKeyedGeneric(LLoadKeyedGeneric* instr) {
 
 
 void LCodeGen::DoArgumentsElements(LArgumentsElements* instr) {
+  if (instr->hydrogen()->from_inlined()) {
+    // The arguments of an inlined function were just pushed.  The result is
+    // biased like a frame pointer, for LAccessArgumentsAt.
+    Register result = ToRegister(instr->result());
+    __ Subu(result, sp, Operand(2 * kPointerSize));
+    return;
+  }
+
   Register scratch = scratch0();
   Register temp = scratch1();
   Register result = ToRegister(instr->result());
@@ -2685,6 +2796,11 @@ void LCodeGen::DoPushArgument(LPushArgument* instr) {
 }
 
 
+void LCodeGen::DoDrop(LDrop* instr) {
+  __ Drop(instr->count());
+}
+
+
 void LCodeGen::DoThisFunction(LThisFunction* instr) {
   Register result = ToRegister(instr->result());
   LoadHeapObject(result, instr->hydrogen()->closure());
@@ -2734,8 +2850,19 @@ void LCodeGen::CallKnownFunction(Handle<JSFunction> function,
 
   // Set a0 to arguments count if adaption is not needed. Assumes that a0
   // is available to write to at this point.
+  int formal_count = function->shared()->formal_parameter_count();
   if (!function->NeedsArgumentsAdaption()) {
     __ li(a0, Operand(arity));
+  } else if (arity != formal_count) {
+    // The target does not look at the actual argument count, so adapt the
+    // arguments here instead of going through the arguments adaptor.
+    ASSERT(!function->shared()->uses_arguments());
+    if (arity < formal_count) {
+      __ LoadRoot(t0, Heap::kUndefinedValueRootIndex);
+      for (int i = arity; i < formal_count; i++) __ push(t0);
+    } else {
+      __ Drop(arity - formal_count);
+    }
   }
 
   LPointerMap* pointers = instr->pointer_map();
@@ -3502,10 +3629,77 @@ void LCodeGen::DoTransitionElementsKind(LTransitionElementsKind* instr) {
 
 
 void LCodeGen::DoStringAdd(LStringAdd* instr) {
-  __ push(ToRegister(instr->left()));
-  __ push(ToRegister(instr->right()));
+  Register left = ToRegister(instr->left());
+  Register right = ToRegister(instr->right());
+  ASSERT(left.is(a1));
+  ASSERT(right.is(a0));
+  ASSERT(ToRegister(instr->result()).is(v0));
+
+  Label call_stub, done;
+  if (FLAG_inline_new) {
+    // Adding an empty string returns the other string.
+    Label both_not_empty;
+    __ lw(a2, FieldMemOperand(left, String::kLengthOffset));
+    __ lw(a3, FieldMemOperand(right, String::kLengthOffset));
+    __ mov(v0, right);
+    __ Branch(&done, eq, a2, Operand(Smi::FromInt(0)));
+    __ mov(v0, left);
+    __ Branch(&done, eq, a3, Operand(Smi::FromInt(0)));
+
+    // Results shorter than a cons string are flat strings, which the stub
+    // builds.  Exceptionally long results are handled by the stub too.
+    __ Addu(t2, a2, Operand(a3));
+    __ sra(t2, t2, kSmiTagSize);
+    __ Branch(&call_stub, lt, t2, Operand(String::kMinNonFlatLength));
+    ASSERT(IsPowerOf2(String::kMaxLength + 1));
+    __ Branch(&call_stub, hs, t2, Operand(String::kMaxLength + 1));
+
+    // The depth of the result is one more than that of its deeper part.
+    // Too deep results are rebalanced by the runtime system.
+    Label left_is_flat, right_is_flat;
+    __ lw(a2, FieldMemOperand(left, HeapObject::kMapOffset));
+    __ lw(a3, FieldMemOperand(right, HeapObject::kMapOffset));
+    __ lbu(a2, FieldMemOperand(a2, Map::kInstanceTypeOffset));
+    __ lbu(a3, FieldMemOperand(a3, Map::kInstanceTypeOffset));
+    __ li(t1, Operand(Smi::FromInt(0)));
+    __ And(t0, a2, Operand(kStringRepresentationMask));
+    __ Branch(&left_is_flat, ne, t0, Operand(kConsStringTag));
+    __ lw(t1, FieldMemOperand(left, ConsString::kDepthOffset));
+    __ bind(&left_is_flat);
+    __ And(t0, a3, Operand(kStringRepresentationMask));
+    __ Branch(&right_is_flat, ne, t0, Operand(kConsStringTag));
+    __ lw(t0, FieldMemOperand(right, ConsString::kDepthOffset));
+    __ Branch(&right_is_flat, le, t0, Operand(t1));
+    __ mov(t1, t0);
+    __ bind(&right_is_flat);
+    __ Addu(t1, t1, Operand(Smi::FromInt(1)));
+    __ Branch(&call_stub, gt, t1,
+              Operand(Smi::FromInt(ConsString::kMaxDepth)));
+
+    // The result is an ASCII cons string if both strings are ASCII.
+    Label two_byte, allocated;
+    STATIC_ASSERT(kTwoByteStringTag == 0);
+    __ And(t0, a2, Operand(a3));
+    __ And(t0, t0, Operand(kStringEncodingMask));
+    __ Branch(&two_byte, eq, t0, Operand(zero_reg));
+    __ AllocateAsciiConsString(t3, t2, a2, a3, &call_stub);
+    __ Branch(&allocated);
+    __ bind(&two_byte);
+    __ AllocateTwoByteConsString(t3, t2, a2, a3, &call_stub);
+    __ bind(&allocated);
+    __ sw(left, FieldMemOperand(t3, ConsString::kFirstOffset));
+    __ sw(right, FieldMemOperand(t3, ConsString::kSecondOffset));
+    __ sw(t1, FieldMemOperand(t3, ConsString::kDepthOffset));
+    __ mov(v0, t3);
+    __ Branch(&done);
+  }
+
+  __ bind(&call_stub);
+  __ push(left);
+  __ push(right);
   StringAddStub stub(NO_STRING_CHECK_IN_STUB);
   CallCode(stub.GetCode(), RelocInfo::CODE_TARGET, instr);
+  __ bind(&done);
 }
 
 
@@ -3688,6 +3882,13 @@ void LCodeGen::DoDeferredStringCharFromCode(LStringCharFromCode* instr) {
 }
 
 
+void LCodeGen::DoStringHashField(LStringHashField* instr) {
+  Register string = ToRegister(instr->string());
+  Register result = ToRegister(instr->result());
+  __ lw(result, FieldMemOperand(string, String::kHashFieldOffset));
+}
+
+
 void LCodeGen::DoStringLength(LStringLength* instr) {
   Register string = ToRegister(instr->InputAt(0));
   Register result = ToRegister(instr->result());
@@ -3712,6 +3913,13 @@ void LCodeGen::DoInteger32ToDouble(LInteger32ToDouble* instr) {
 }
 
 
+void LCodeGen::DoUint32ToDouble(LUint32ToDouble* instr) {
+  LOperand* input = instr->InputAt(0);
+  LOperand* output = instr->result();
+  __ Cvt_d_uw(ToDoubleRegister(output), ToRegister(input), double_scratch0());
+}
+
+
 void LCodeGen::DoNumberTagI(LNumberTagI* instr) {
   class DeferredNumberTagI: public LDeferredCode {
    public:
@@ -3776,6 +3984,66 @@ void LCodeGen::DoDeferredNumberTagI(LNumberTagI* instr) {
 }
 
 
+void LCodeGen::DoNumberTagU(LNumberTagU* instr) {
+  class DeferredNumberTagU: public LDeferredCode {
+   public:
+    DeferredNumberTagU(LCodeGen* codegen, LNumberTagU* instr)
+        : LDeferredCode(codegen), instr_(instr) { }
+    virtual void Generate() { codegen()->DoDeferredNumberTagU(instr_); }
+    virtual LInstruction* instr() { return instr_; }
+   private:
+    LNumberTagU* instr_;
+  };
+
+  LOperand* input = instr->InputAt(0);
+  ASSERT(input->IsRegister() && input->Equals(instr->result()));
+  Register reg = ToRegister(input);
+
+  DeferredNumberTagU* deferred = new DeferredNumberTagU(this, instr);
+  __ Branch(deferred->entry(), hi, reg, Operand(Smi::kMaxValue));
+  __ SmiTag(reg, reg);
+  __ bind(deferred->exit());
+}
+
+
+void LCodeGen::DoDeferredNumberTagU(LNumberTagU* instr) {
+  Label slow;
+  Register reg = ToRegister(instr->InputAt(0));
+  FPURegister dbl_scratch = double_scratch0();
+
+  // Preserve the value of all registers.
+  PushSafepointRegistersScope scope(this, Safepoint::kWithRegisters);
+
+  // The value does not fit in a smi. Try to allocate a heap number in new
+  // space and store the value in there. If that fails, call the runtime
+  // system.
+  Label done;
+  __ Cvt_d_uw(dbl_scratch, reg, ToDoubleRegister(instr->TempAt(0)));
+  if (FLAG_inline_new) {
+    __ LoadRoot(t2, Heap::kHeapNumberMapRootIndex);
+    __ AllocateHeapNumber(t1, a3, t0, t2, &slow);
+    if (!reg.is(t1)) __ mov(reg, t1);
+    __ Branch(&done);
+  }
+
+  // Slow case: Call the runtime system to do the number allocation.
+  __ bind(&slow);
+
+  // Put a valid pointer value in the stack slot where the result register
+  // is stored, as this register is in the pointer map, but contains an
+  // integer value.
+  __ StoreToSafepointRegisterSlot(zero_reg, reg);
+  CallRuntimeFromDeferred(Runtime::kAllocateHeapNumber, 0, instr);
+  if (!reg.is(v0)) __ mov(reg, v0);
+
+  // Done. Put the value in dbl_scratch into the value of the allocated heap
+  // number.
+  __ bind(&done);
+  __ sdc1(dbl_scratch, FieldMemOperand(reg, HeapNumber::kValueOffset));
+  __ StoreToSafepointRegisterSlot(reg, reg);
+}
+
+
 void LCodeGen::DoNumberTagD(LNumberTagD* instr) {
   class DeferredNumberTagD: public LDeferredCode {
    public:
@@ -4250,6 +4518,48 @@ void LCodeGen::DoArrayLiteral(LArrayLiteral* instr) {
 }
 
 
+void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
+  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
+  Handle<Map> initial_map = instr->hydrogen()->initial_map();
+  int instance_size = initial_map->instance_size();
+
+  // Deoptimize if the constructor got a new initial map since, for
+  // example because its prototype was replaced.
+  LoadHeapObject(a1, constructor);
+  __ lw(a2, FieldMemOperand(a1, JSFunction::kPrototypeOrInitialMapOffset));
+  DeoptimizeIf(ne, instr->environment(), a2, Operand(initial_map));
+
+  // The object is always allocated in new space, so the stores that
+  // initialize its properties need no write barrier.
+  Label allocated, runtime_allocate;
+  __ AllocateInNewSpace(instance_size, v0, a2, a3, &runtime_allocate,
+                        TAG_OBJECT);
+  __ Branch(&allocated);
+
+  __ bind(&runtime_allocate);
+  __ li(a0, Operand(Smi::FromInt(instance_size)));
+  __ push(a0);
+  CallRuntime(Runtime::kAllocateInNewSpace, 1, instr);
+
+  __ bind(&allocated);
+  __ li(a1, Operand(initial_map));
+  __ sw(a1, FieldMemOperand(v0, JSObject::kMapOffset));
+  __ LoadRoot(a1, Heap::kEmptyFixedArrayRootIndex);
+  __ sw(a1, FieldMemOperand(v0, JSObject::kPropertiesOffset));
+  __ sw(a1, FieldMemOperand(v0, JSObject::kElementsOffset));
+  // The in-object properties follow the header.
+  ASSERT(initial_map->instance_size() ==
+         JSObject::kHeaderSize +
+         initial_map->inobject_properties() * kPointerSize);
+  __ LoadRoot(a1, Heap::kUndefinedValueRootIndex);
+  for (int offset = JSObject::kHeaderSize;
+       offset < instance_size;
+       offset += kPointerSize) {
+    __ sw(a1, FieldMemOperand(v0, offset));
+  }
+}
+
+
 void LCodeGen::DoObjectLiteral(LObjectLiteral* instr) {
   ASSERT(ToRegister(instr->result()).is(v0));
   __ lw(t0, MemOperand(fp, JavaScriptFrameConstants::kFunctionOffset));
@@ -176,6 +176,7 @@ void RegExpMacroAssemblerMIPS::AdvanceRegister(int reg, int by) {
 
 void RegExpMacroAssemblerMIPS::Backtrack() {
   CheckPreemption();
+  CheckBacktrackLimit();
   // Pop Code* offset from backtrack stack, add Code* and jump to location.
   Pop(a0);
   __ Addu(a0, a0, code_pointer());
@@ -818,6 +819,12 @@ Handle<HeapObject> RegExpMacroAssemblerMIPS::GetCode(Handle<String> source) {
       SafeReturn();
     }
 
+    if (backtrack_limit_label_.is_linked()) {
+      // Reached if the backtrack budget has been used up.
+      __ bind(&backtrack_limit_label_);
+      __ jmp(&exit_with_exception);
+    }
+
     if (exit_with_exception.is_linked()) {
       // If any of the code above needed to exit with an exception.
       __ bind(&exit_with_exception);
@@ -1208,6 +1215,18 @@ void RegExpMacroAssemblerMIPS::CheckPreemption() {
 }
 
 
+void RegExpMacroAssemblerMIPS::CheckBacktrackLimit() {
+  if (FLAG_regexp_backtrack_limit <= 0) return;
+  ExternalReference backtracks_left =
+      ExternalReference::address_of_regexp_backtracks_left(masm_->isolate());
+  __ li(a0, Operand(backtracks_left));
+  __ lw(a1, MemOperand(a0));
+  __ Subu(a1, a1, Operand(1));
+  __ sw(a1, MemOperand(a0));
+  __ Branch(&backtrack_limit_label_, eq, a1, Operand(zero_reg));
+}
+
+
 void RegExpMacroAssemblerMIPS::CheckStackLimit() {
   ExternalReference stack_limit =
       ExternalReference::address_of_regexp_stack_limit(masm_->isolate());
@@ -160,6 +160,9 @@ class RegExpMacroAssemblerMIPS: public NativeRegExpMacroAssembler {
   // Check whether preemption has been requested.
   void CheckPreemption();
 
+  // Count a backtrack against the budget set by --regexp-backtrack-limit.
+  void CheckBacktrackLimit();
+
   // Check whether we are exceeding the stack limit on the backtrack stack.
   void CheckStackLimit();
 
@@ -247,6 +250,7 @@ class RegExpMacroAssemblerMIPS: public NativeRegExpMacroAssembler {
   Label exit_label_;
   Label check_preempt_label_;
   Label stack_overflow_label_;
+  Label backtrack_limit_label_;
   Label internal_failure_label_;
 };
 
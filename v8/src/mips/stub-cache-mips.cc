@@ -184,6 +184,9 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   ASSERT(!extra.is(no_reg));
   ASSERT(!extra2.is(no_reg));
 
+  Counters* counters = isolate->counters();
+  __ IncrementCounter(counters->stub_cache_probes(), 1, extra, extra2);
+
   // Check that the receiver isn't a smi.
   __ JumpIfSmi(receiver, &miss, t0);
 
@@ -192,19 +195,21 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ lw(t8, FieldMemOperand(receiver, HeapObject::kMapOffset));
   __ Addu(scratch, scratch, Operand(t8));
   __ Xor(scratch, scratch, Operand(flags));
-  __ And(scratch,
-         scratch,
-         Operand((kPrimaryTableSize - 1) << kHeapObjectTagSize));
+  __ li(extra, Operand(ExternalReference(mask_reference(kPrimary))));
+  __ lw(extra, MemOperand(extra));
+  __ And(scratch, scratch, Operand(extra));
 
   // Probe the primary table.
   ProbeTable(isolate, masm, flags, kPrimary, name, scratch, extra, extra2);
 
   // Primary miss: Compute hash for secondary probe.
+  __ IncrementCounter(
+      counters->stub_cache_secondary_probes(), 1, extra, extra2);
   __ Subu(scratch, scratch, Operand(name));
   __ Addu(scratch, scratch, Operand(flags));
-  __ And(scratch,
-         scratch,
-         Operand((kSecondaryTableSize - 1) << kHeapObjectTagSize));
+  __ li(extra, Operand(ExternalReference(mask_reference(kSecondary))));
+  __ lw(extra, MemOperand(extra));
+  __ And(scratch, scratch, Operand(extra));
 
   // Probe the secondary table.
   ProbeTable(isolate, masm, flags, kSecondary, name, scratch, extra, extra2);
@@ -212,6 +217,7 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   // Cache miss: Fall-through and let caller handle the miss by
   // entering the runtime system.
   __ bind(&miss);
+  __ IncrementCounter(counters->stub_cache_misses(), 1, extra, extra2);
 }
 
 
@@ -2602,6 +2608,12 @@ Handle<Code> StoreStubCompiler::CompileStoreGlobal(
   __ lw(t2, FieldMemOperand(t0, JSGlobalPropertyCell::kValueOffset));
   __ Branch(&miss, eq, t1, Operand(t2));
 
+  // Check that optimized code does not embed the value in the cell. The
+  // runtime system deoptimizes that code before changing it.
+  __ lw(t2, FieldMemOperand(t0, JSGlobalPropertyCell::kStateOffset));
+  __ Branch(&miss, eq, t2,
+            Operand(Smi::FromInt(JSGlobalPropertyCell::CONSTANT)));
+
   // Store the value in the cell.
   __ sw(a0, FieldMemOperand(t0, JSGlobalPropertyCell::kValueOffset));
   __ mov(v0, a0);  // Stored value must be returned in v0.
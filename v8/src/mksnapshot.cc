@@ -33,6 +33,8 @@
 #include "v8.h"
 
 #include "bootstrapper.h"
+#include "code-stubs.h"
+#include "lz-codec.h"
 #include "natives.h"
 #include "platform.h"
 #include "serialize.h"
@@ -147,7 +149,7 @@ class CppByteSink : public PartialSnapshotSink {
 
   virtual ~CppByteSink() {
     fprintf(fp_, "const int Snapshot::size_ = %d;\n", Position());
-#ifdef COMPRESS_STARTUP_DATA_BZ2
+#if defined(COMPRESS_STARTUP_DATA_BZ2) || defined(COMPRESS_STARTUP_DATA_LZ)
     fprintf(fp_, "const byte* Snapshot::raw_data_ = NULL;\n");
     fprintf(fp_,
             "const int Snapshot::raw_size_ = %d;\n\n",
@@ -193,7 +195,7 @@ class CppByteSink : public PartialSnapshotSink {
     int length = partial_sink_.Position();
     fprintf(fp_, "};\n\n");
     fprintf(fp_, "const int Snapshot::context_size_ = %d;\n",  length);
-#ifdef COMPRESS_STARTUP_DATA_BZ2
+#if defined(COMPRESS_STARTUP_DATA_BZ2) || defined(COMPRESS_STARTUP_DATA_LZ)
     fprintf(fp_,
             "const int Snapshot::context_raw_size_ = %d;\n",
             partial_sink_.raw_size());
@@ -205,7 +207,7 @@ class CppByteSink : public PartialSnapshotSink {
     fprintf(fp_, "const byte Snapshot::context_data_[] = {\n");
     partial_sink_.Print(fp_);
     fprintf(fp_, "};\n\n");
-#ifdef COMPRESS_STARTUP_DATA_BZ2
+#if defined(COMPRESS_STARTUP_DATA_BZ2) || defined(COMPRESS_STARTUP_DATA_LZ)
     fprintf(fp_, "const byte* Snapshot::context_raw_data_ = NULL;\n");
 #else
     fprintf(fp_, "const byte* Snapshot::context_raw_data_ ="
@@ -281,6 +283,124 @@ class BZip2Decompressor : public StartupDataDecompressor {
 #endif
 
 
+#ifdef COMPRESS_STARTUP_DATA_LZ
+class LZCompressor : public Compressor {
+ public:
+  LZCompressor() : output_(NULL) {}
+  virtual ~LZCompressor() {
+    delete output_;
+  }
+  virtual bool Compress(i::Vector<char> input) {
+    delete output_;
+    output_ = new i::ScopedVector<char>(
+        i::LZCodec::MaxCompressedSize(input.length()));
+    int output_length = i::LZCodec::Compress(
+        i::Vector<const i::byte>(reinterpret_cast<i::byte*>(input.start()),
+                                 input.length()),
+        reinterpret_cast<i::byte*>(output_->start()));
+    output_->Truncate(output_length);
+    return true;
+  }
+  virtual i::Vector<char>* output() { return output_; }
+
+ private:
+  i::ScopedVector<char>* output_;
+};
+#endif
+
+
+static void DumpException(Handle<Message> message) {
+  String::Utf8Value message_string(message->Get());
+  String::Utf8Value message_line(message->GetSourceLine());
+  fprintf(stderr, "%s at line %d\n", *message_string, message->GetLineNumber());
+  fprintf(stderr, "%s\n", *message_line);
+  for (int i = 0; i <= message->GetEndColumn(); ++i) {
+    fprintf(stderr, "%c", i < message->GetStartColumn() ? ' ' : '^');
+  }
+  fprintf(stderr, "\n");
+}
+
+
+// Runs the script given with --extra-code in the context, so that whatever
+// it sets up becomes part of the snapshot and every context created from the
+// snapshot starts out with it.
+static void RunExtraCode(Persistent<Context> context) {
+  context->Enter();
+  {
+    HandleScope scope;
+    const char* name = i::FLAG_extra_code;
+    bool exists;
+    i::Vector<const char> chars = i::ReadFile(name, &exists);
+    if (!exists) {
+      fprintf(stderr, "Could not read '%s'.\n", name);
+      exit(1);
+    }
+    Handle<String> source = String::New(chars.start(), chars.length());
+    chars.Dispose();
+    TryCatch try_catch;
+    Local<Script> script = Script::Compile(source, String::New(name));
+    if (try_catch.HasCaught()) {
+      fprintf(stderr, "Failure compiling '%s'\n", name);
+      DumpException(try_catch.Message());
+      exit(1);
+    }
+    script->Run();
+    if (try_catch.HasCaught()) {
+      fprintf(stderr, "Failure running '%s'\n", name);
+      DumpException(try_catch.Message());
+      exit(1);
+    }
+  }
+  context->Exit();
+}
+
+
+static bool IsJavaScriptBuiltin(i::JSBuiltinsObject* builtins,
+                                i::SharedFunctionInfo* shared) {
+  for (int id = 0; id < i::Builtins::NumberOfJavaScriptBuiltins(); id++) {
+    i::Object* builtin =
+        builtins->javascript_builtin(static_cast<i::Builtins::JavaScript>(id));
+    if (i::JSFunction::cast(builtin)->shared() == shared) return true;
+  }
+  return false;
+}
+
+
+// Drops the code compiled for the natives functions that ran while the
+// context was set up.  The code is then neither part of the snapshot nor
+// deserialized into every isolate.  Instead the functions are compiled from
+// the natives source when they are first called, like any lazily compiled
+// function.  The JavaScript builtins, which code stubs call through the
+// builtins object, keep their code.
+static void DiscardNativesCode(Persistent<Context> context) {
+  i::Isolate* isolate = i::Isolate::Current();
+  i::Heap* heap = isolate->heap();
+  heap->CollectAllGarbage(i::Heap::kMakeHeapIterableMask);
+  i::AssertNoAllocation no_allocation;
+  i::JSBuiltinsObject* builtins = v8::Utils::OpenHandle(*context)->builtins();
+  i::Code* lazy_compile =
+      isolate->builtins()->builtin(i::Builtins::kLazyCompile);
+  i::HeapIterator iterator;
+  for (i::HeapObject* obj = iterator.next();
+       obj != NULL;
+       obj = iterator.next()) {
+    if (!obj->IsJSFunction()) continue;
+    i::JSFunction* function = i::JSFunction::cast(obj);
+    i::SharedFunctionInfo* shared = function->shared();
+    if (shared->allows_lazy_compilation() &&
+        !shared->is_toplevel() &&
+        shared->script()->IsScript() &&
+        i::Script::cast(shared->script())->type()->value() ==
+            i::Script::TYPE_NATIVE &&
+        shared->code()->kind() == i::Code::FUNCTION &&
+        !IsJavaScriptBuiltin(builtins, shared)) {
+      function->set_code(lazy_compile);
+      shared->set_code(lazy_compile);
+    }
+  }
+}
+
+
 int main(int argc, char** argv) {
   // By default, log code create information in the snapshot.
   i::FLAG_log_code = true;
@@ -304,6 +424,15 @@ int main(int argc, char** argv) {
   i::Serializer::Enable();
   Persistent<Context> context = v8::Context::New();
   ASSERT(!context.IsEmpty());
+  if (i::FLAG_extra_code != NULL) {
+    RunExtraCode(context);
+  }
+  DiscardNativesCode(context);
+  // Compile the common stubs, so that isolates created from the snapshot
+  // do not have to compile them again.
+  { HandleScope scope;
+    i::CodeStub::GenerateCommonStubsForSnapshot();
+  }
   // Make sure all builtin scripts are cached.
   { HandleScope scope;
     for (int i = 0; i < i::Natives::GetBuiltinsCount(); i++) {
@@ -326,8 +455,12 @@ int main(int argc, char** argv) {
 
   ser.SerializeWeakReferences();
 
-#ifdef COMPRESS_STARTUP_DATA_BZ2
+#if defined(COMPRESS_STARTUP_DATA_BZ2)
   BZip2Compressor compressor;
+#elif defined(COMPRESS_STARTUP_DATA_LZ)
+  LZCompressor compressor;
+#endif
+#if defined(COMPRESS_STARTUP_DATA_BZ2) || defined(COMPRESS_STARTUP_DATA_LZ)
   if (!sink.Compress(&compressor))
     return 1;
   if (!sink.partial_sink()->Compress(&compressor))
@@ -27,6 +27,7 @@
 
 #include "v8.h"
 
+#include "date.h"
 #include "disassembler.h"
 #include "disasm.h"
 #include "jsregexp.h"
@@ -85,6 +86,9 @@ void HeapObject::HeapObjectVerify() {
     case HEAP_NUMBER_TYPE:
       HeapNumber::cast(this)->HeapNumberVerify();
       break;
+    case BIG_INTEGER_TYPE:
+      BigInteger::cast(this)->BigIntegerVerify();
+      break;
     case FIXED_ARRAY_TYPE:
       FixedArray::cast(this)->FixedArrayVerify();
       break;
@@ -138,6 +142,9 @@ void HeapObject::HeapObjectVerify() {
     case JS_VALUE_TYPE:
       JSValue::cast(this)->JSValueVerify();
       break;
+    case JS_DATE_TYPE:
+      JSDate::cast(this)->JSDateVerify();
+      break;
     case JS_FUNCTION_TYPE:
       JSFunction::cast(this)->JSFunctionVerify();
       break;
@@ -216,6 +223,14 @@ void ByteArray::ByteArrayVerify() {
 }
 
 
+void BigInteger::BigIntegerVerify() {
+  ASSERT(IsBigInteger());
+  // Normalized: no leading zero digits and never in the smi range.
+  ASSERT(digit_count() > 0);
+  ASSERT(digit(digit_count() - 1) != 0);
+}
+
+
 void FreeSpace::FreeSpaceVerify() {
   ASSERT(IsFreeSpace());
 }
@@ -279,6 +294,15 @@ void JSObject::JSObjectVerify() {
     CHECK_EQ(map()->unused_property_fields(),
              (map()->inobject_properties() + properties()->length() -
               map()->NextFreePropertyIndex()));
+    DescriptorArray* descriptors = map()->instance_descriptors();
+    for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+      PropertyDetails details(descriptors->GetDetails(i));
+      if (details.type() == FIELD &&
+          details.representation() == DOUBLE_FIELD) {
+        int index = descriptors->GetFieldIndex(i);
+        CHECK(FastPropertyAt(index)->IsMutableHeapNumber());
+      }
+    }
   }
   ASSERT_EQ((map()->has_fast_elements() || map()->has_fast_smi_only_elements()),
             (elements()->map() == GetHeap()->fixed_array_map() ||
@@ -357,6 +381,49 @@ void JSValue::JSValueVerify() {
 }
 
 
+void JSDate::JSDateVerify() {
+  if (value()->IsHeapObject()) {
+    VerifyHeapPointer(value());
+  }
+  CHECK(value()->IsUndefined() || value()->IsSmi() || value()->IsHeapNumber());
+  // The cached fields are undefined, smis, or NaN like the value.
+  Object* fields[] = { year(), month(), day(), weekday(), hour(), min(),
+                       sec(), cache_stamp() };
+  for (size_t i = 0; i < ARRAY_SIZE(fields); i++) {
+    CHECK(fields[i]->IsUndefined() || fields[i]->IsSmi() ||
+          fields[i]->IsHeapNumber());
+  }
+  if (month()->IsSmi()) {
+    int month = Smi::cast(this->month())->value();
+    CHECK(0 <= month && month <= 11);
+  }
+  if (day()->IsSmi()) {
+    int day = Smi::cast(this->day())->value();
+    CHECK(1 <= day && day <= 31);
+  }
+  if (weekday()->IsSmi()) {
+    int weekday = Smi::cast(this->weekday())->value();
+    CHECK(0 <= weekday && weekday <= 6);
+  }
+  if (hour()->IsSmi()) {
+    int hour = Smi::cast(this->hour())->value();
+    CHECK(0 <= hour && hour <= 23);
+  }
+  if (min()->IsSmi()) {
+    int min = Smi::cast(this->min())->value();
+    CHECK(0 <= min && min <= 59);
+  }
+  if (sec()->IsSmi()) {
+    int sec = Smi::cast(this->sec())->value();
+    CHECK(0 <= sec && sec <= 59);
+  }
+  if (cache_stamp()->IsSmi()) {
+    CHECK(Smi::cast(cache_stamp())->value() <=
+          Smi::cast(Isolate::Current()->date_cache()->stamp())->value());
+  }
+}
+
+
 void JSMessageObject::JSMessageObjectVerify() {
   CHECK(IsJSMessageObject());
   CHECK(type()->IsString());
@@ -389,6 +456,7 @@ void ConsString::ConsStringVerify() {
   CHECK(this->second() == GetHeap()->empty_string() ||
         this->second()->IsString());
   CHECK(this->length() >= String::kMinNonFlatLength);
+  CHECK(this->depth() > 0 && this->depth() <= kMaxDepth);
   if (this->IsFlat()) {
     // A flat cons can only be created by String::SlowTryFlatten.
     // Afterwards, the first part may be externalized.
@@ -478,6 +546,7 @@ void Oddball::OddballVerify() {
 void JSGlobalPropertyCell::JSGlobalPropertyCellVerify() {
   CHECK(IsJSGlobalPropertyCell());
   VerifyObjectField(kValueOffset);
+  VerifySmiField(kStateOffset);
 }
 
 
@@ -510,7 +579,7 @@ void JSSet::JSSetVerify() {
   CHECK(IsJSSet());
   JSObjectVerify();
   VerifyHeapPointer(table());
-  ASSERT(table()->IsHashTable() || table()->IsUndefined());
+  ASSERT(table()->IsFixedArray() || table()->IsUndefined());
 }
 
 
@@ -518,7 +587,7 @@ void JSMap::JSMapVerify() {
   CHECK(IsJSMap());
   JSObjectVerify();
   VerifyHeapPointer(table());
-  ASSERT(table()->IsHashTable() || table()->IsUndefined());
+  ASSERT(table()->IsFixedArray() || table()->IsUndefined());
 }
 
 
@@ -562,6 +631,16 @@ void JSRegExp::JSRegExpVerify() {
 
       ASSERT(arr->get(JSRegExp::kIrregexpCaptureCountIndex)->IsSmi());
       ASSERT(arr->get(JSRegExp::kIrregexpMaxRegisterCountIndex)->IsSmi());
+      Object* prefix = arr->get(JSRegExp::kIrregexpLiteralPrefixIndex);
+      ASSERT(prefix == Smi::FromInt(0) ||
+             (prefix->IsString() && String::cast(prefix)->length() > 0));
+
+      Object* ascii_bytecode = arr->get(JSRegExp::kIrregexpASCIIBytecodeIndex);
+      ASSERT(ascii_bytecode->IsSmi() || ascii_bytecode->IsByteArray());
+      Object* uc16_bytecode = arr->get(JSRegExp::kIrregexpUC16BytecodeIndex);
+      ASSERT(uc16_bytecode->IsSmi() || uc16_bytecode->IsByteArray());
+      ASSERT(arr->get(JSRegExp::kIrregexpExecutionCountIndex)->IsSmi());
+      ASSERT(arr->get(JSRegExp::kIrregexpSubjectLengthIndex)->IsSmi());
       break;
     }
     default:
@@ -618,6 +697,7 @@ void InterceptorInfo::InterceptorInfoVerify() {
   VerifyPointer(deleter());
   VerifyPointer(enumerator());
   VerifyPointer(data());
+  VerifyPointer(keys());
 }
 
 
@@ -625,6 +705,8 @@ void CallHandlerInfo::CallHandlerInfoVerify() {
   CHECK(IsCallHandlerInfo());
   VerifyPointer(callback());
   VerifyPointer(data());
+  VerifyPointer(fast_callback());
+  CHECK(fast_signature()->IsUndefined() || fast_signature()->IsSmi());
 }
 
 
@@ -670,6 +752,22 @@ void TypeSwitchInfo::TypeSwitchInfoVerify() {
 }
 
 
+void Atom::AtomVerify() {
+  CHECK(IsAtom());
+  CHECK(name()->IsSymbol());
+  CHECK(hash()->IsSmi());
+  CHECK_EQ(static_cast<int>(name()->Hash()), hash()->value());
+}
+
+
+void StringBuffer::StringBufferVerify() {
+  CHECK(IsStringBuffer());
+  CHECK(buffer()->IsSeqString());
+  VerifySmiField(kLengthOffset);
+  CHECK(0 <= length() && length() <= capacity());
+}
+
+
 void Script::ScriptVerify() {
   CHECK(IsScript());
   VerifyPointer(source());
@@ -174,6 +174,13 @@ bool Object::NonFailureIsHeapObject() {
 TYPE_CHECKER(HeapNumber, HEAP_NUMBER_TYPE)
 
 
+bool Object::IsMutableHeapNumber() {
+  if (!IsHeapObject()) return false;
+  HeapObject* object = HeapObject::cast(this);
+  return object->map() == object->GetHeap()->mutable_heap_number_map();
+}
+
+
 bool Object::IsString() {
   return Object::IsHeapObject()
     && HeapObject::cast(this)->map()->instance_type() < FIRST_NONSTRING_TYPE;
@@ -425,6 +432,7 @@ bool Object::IsNumber() {
 
 
 TYPE_CHECKER(ByteArray, BYTE_ARRAY_TYPE)
+TYPE_CHECKER(BigInteger, BIG_INTEGER_TYPE)
 TYPE_CHECKER(FreeSpace, FREE_SPACE_TYPE)
 
 
@@ -595,6 +603,7 @@ TYPE_CHECKER(Oddball, ODDBALL_TYPE)
 TYPE_CHECKER(JSGlobalPropertyCell, JS_GLOBAL_PROPERTY_CELL_TYPE)
 TYPE_CHECKER(SharedFunctionInfo, SHARED_FUNCTION_INFO_TYPE)
 TYPE_CHECKER(JSValue, JS_VALUE_TYPE)
+TYPE_CHECKER(JSDate, JS_DATE_TYPE)
 TYPE_CHECKER(JSMessageObject, JS_MESSAGE_OBJECT_TYPE)
 
 
@@ -1316,6 +1325,16 @@ void JSGlobalPropertyCell::set_value(Object* val, WriteBarrierMode ignored) {
 }
 
 
+JSGlobalPropertyCell::State JSGlobalPropertyCell::state() {
+  return static_cast<State>(Smi::cast(READ_FIELD(this, kStateOffset))->value());
+}
+
+
+void JSGlobalPropertyCell::set_state(State state) {
+  WRITE_FIELD(this, kStateOffset, Smi::FromInt(state));
+}
+
+
 int JSObject::GetHeaderSize() {
   InstanceType type = map()->instance_type();
   // Check for the most common kind of JavaScript object before
@@ -1333,6 +1352,8 @@ int JSObject::GetHeaderSize() {
       return JSFunction::kSize;
     case JS_VALUE_TYPE:
       return JSValue::kSize;
+    case JS_DATE_TYPE:
+      return JSDate::kSize;
     case JS_ARRAY_TYPE:
       return JSValue::kSize;
     case JS_WEAK_MAP_TYPE:
@@ -1426,6 +1447,13 @@ Object* JSObject::FastPropertyAtPut(int index, Object* value) {
 }
 
 
+MaybeObject* JSObject::FastPropertyValueAt(int index) {
+  Object* value = FastPropertyAt(index);
+  if (!value->IsMutableHeapNumber()) return value;
+  return GetHeap()->AllocateHeapNumber(HeapNumber::cast(value)->value());
+}
+
+
 int JSObject::GetInObjectPropertyOffset(int index) {
   // Adjust for the number of properties stored in the object.
   index -= map()->inobject_properties();
@@ -1852,6 +1880,13 @@ Smi* DescriptorArray::GetDetails(int descriptor_number) {
 }
 
 
+void DescriptorArray::SetDetails(int descriptor_number,
+                                 PropertyDetails details) {
+  ASSERT(descriptor_number < number_of_descriptors());
+  GetContentArray()->set(ToDetailsIndex(descriptor_number), details.AsSmi());
+}
+
+
 PropertyType DescriptorArray::GetType(int descriptor_number) {
   ASSERT(descriptor_number < number_of_descriptors());
   return PropertyDetails(GetDetails(descriptor_number)).type();
@@ -1988,8 +2023,16 @@ int HashTable<Shape, Key>::FindEntry(Key key) {
 // Find entry for key otherwise return kNotFound.
 template<typename Shape, typename Key>
 int HashTable<Shape, Key>::FindEntry(Isolate* isolate, Key key) {
+  return FindEntry(isolate, key, Shape::Hash(key));
+}
+
+
+template<typename Shape, typename Key>
+int HashTable<Shape, Key>::FindEntry(Isolate* isolate,
+                                     Key key,
+                                     uint32_t hash) {
   uint32_t capacity = Capacity();
-  uint32_t entry = FirstProbe(Shape::Hash(key), capacity);
+  uint32_t entry = FirstProbe(hash, capacity);
   uint32_t count = 1;
   // EnsureCapacity will guarantee the hash table is never full.
   while (true) {
@@ -2023,6 +2066,22 @@ void NumberDictionary::set_requires_slow_elements() {
 }
 
 
+void StringDictionary::ResetReadCount() {
+  set(kReadCountIndex, Smi::FromInt(0));
+}
+
+
+void StringDictionary::StopCountingReads() {
+  set_undefined(kReadCountIndex);
+}
+
+
+bool StringDictionary::HasReachedReadCount(int count) {
+  Object* read_count = get(kReadCountIndex);
+  return read_count->IsSmi() && Smi::cast(read_count)->value() >= count;
+}
+
+
 // ------------------------------------
 // Cast operations
 
@@ -2073,6 +2132,7 @@ CAST_ACCESSOR(JSMap)
 CAST_ACCESSOR(JSWeakMap)
 CAST_ACCESSOR(Foreign)
 CAST_ACCESSOR(ByteArray)
+CAST_ACCESSOR(BigInteger)
 CAST_ACCESSOR(FreeSpace)
 CAST_ACCESSOR(ExternalArray)
 CAST_ACCESSOR(ExternalByteArray)
@@ -2297,6 +2357,15 @@ void ConsString::set_second(String* value, WriteBarrierMode mode) {
 }
 
 
+SMI_ACCESSORS(ConsString, depth, kDepthOffset)
+
+
+int ConsString::DepthOf(String* string) {
+  if (!StringShape(string).IsCons()) return 0;
+  return ConsString::cast(string)->depth();
+}
+
+
 bool ExternalString::is_short() {
   InstanceType type = map()->instance_type();
   return (type & kShortExternalStringMask) == kShortExternalStringTag;
@@ -2427,6 +2496,39 @@ int ByteArray::get_int(int index) {
 }
 
 
+void ByteArray::set_int(int index, int value) {
+  ASSERT(index >= 0 && (index * kIntSize) < this->length());
+  WRITE_INT_FIELD(this, kHeaderSize + index * kIntSize, value);
+}
+
+
+int BigInteger::digit_count() {
+  return (length() - (kDigitsOffset - kHeaderSize)) / kDigitSize;
+}
+
+
+uint32_t BigInteger::digit(int index) {
+  ASSERT(index >= 0 && index < digit_count());
+  return READ_UINT32_FIELD(this, kDigitsOffset + index * kDigitSize);
+}
+
+
+void BigInteger::set_digit(int index, uint32_t value) {
+  ASSERT(index >= 0 && index < digit_count());
+  WRITE_UINT32_FIELD(this, kDigitsOffset + index * kDigitSize, value);
+}
+
+
+bool BigInteger::is_negative() {
+  return READ_INT_FIELD(this, kSignOffset) != 0;
+}
+
+
+void BigInteger::set_is_negative(bool value) {
+  WRITE_INT_FIELD(this, kSignOffset, value ? 1 : 0);
+}
+
+
 ByteArray* ByteArray::FromDataStartAddress(Address address) {
   ASSERT_TAG_ALIGNED(address);
   return reinterpret_cast<ByteArray*>(address - kHeaderSize + kHeapObjectTag);
@@ -2680,6 +2782,9 @@ int HeapObject::SizeFromMap(Map* map) {
     return FixedDoubleArray::SizeFor(
         reinterpret_cast<FixedDoubleArray*>(this)->length());
   }
+  if (instance_type == BIG_INTEGER_TYPE) {
+    return reinterpret_cast<BigInteger*>(this)->BigIntegerSize();
+  }
   ASSERT(instance_type == CODE_TYPE);
   return reinterpret_cast<Code*>(this)->CodeSize();
 }
@@ -2828,6 +2933,16 @@ bool Map::is_shared() {
 }
 
 
+int Map::method_redefinition_count() {
+  return MethodRedefinitionCountField::decode(bit_field3());
+}
+
+
+void Map::set_method_redefinition_count(int value) {
+  set_bit_field3(MethodRedefinitionCountField::update(bit_field3(), value));
+}
+
+
 JSFunction* Map::unchecked_constructor() {
   return reinterpret_cast<JSFunction*>(READ_FIELD(this, kConstructorOffset));
 }
@@ -2974,6 +3089,21 @@ void Code::set_compiled_optimizable(bool value) {
 }
 
 
+bool Code::has_interrupt_budget() {
+  ASSERT(kind() == FUNCTION);
+  byte flags = READ_BYTE_FIELD(this, kFullCodeFlags);
+  return FullCodeFlagsHasInterruptBudget::decode(flags);
+}
+
+
+void Code::set_has_interrupt_budget(bool value) {
+  ASSERT(kind() == FUNCTION);
+  byte flags = READ_BYTE_FIELD(this, kFullCodeFlags);
+  flags = FullCodeFlagsHasInterruptBudget::update(flags, value);
+  WRITE_BYTE_FIELD(this, kFullCodeFlags, flags);
+}
+
+
 int Code::allow_osr_at_loop_nesting_level() {
   ASSERT(kind() == FUNCTION);
   return READ_BYTE_FIELD(this, kAllowOSRAtLoopNestingLevelOffset);
@@ -2987,6 +3117,19 @@ void Code::set_allow_osr_at_loop_nesting_level(int level) {
 }
 
 
+int Code::profiler_ticks() {
+  ASSERT(kind() == FUNCTION);
+  return READ_BYTE_FIELD(this, kProfilerTicksOffset);
+}
+
+
+void Code::set_profiler_ticks(int ticks) {
+  ASSERT(kind() == FUNCTION);
+  ASSERT(ticks >= 0 && ticks < 256);
+  WRITE_BYTE_FIELD(this, kProfilerTicksOffset, ticks);
+}
+
+
 unsigned Code::stack_slots() {
   ASSERT(kind() == OPTIMIZED_FUNCTION);
   return READ_UINT32_FIELD(this, kStackSlotsOffset);
@@ -3012,6 +3155,18 @@ void Code::set_safepoint_table_offset(unsigned offset) {
 }
 
 
+int Code::last_used_gc() {
+  ASSERT(kind() == OPTIMIZED_FUNCTION);
+  return READ_INT_FIELD(this, kLastUsedGCOffset);
+}
+
+
+void Code::set_last_used_gc(int count) {
+  ASSERT(kind() == OPTIMIZED_FUNCTION);
+  WRITE_INT_FIELD(this, kLastUsedGCOffset, count);
+}
+
+
 unsigned Code::stack_check_table_offset() {
   ASSERT(kind() == FUNCTION);
   return READ_UINT32_FIELD(this, kStackCheckTableOffsetOffset);
@@ -3327,9 +3482,12 @@ ACCESSORS(InterceptorInfo, query, Object, kQueryOffset)
 ACCESSORS(InterceptorInfo, deleter, Object, kDeleterOffset)
 ACCESSORS(InterceptorInfo, enumerator, Object, kEnumeratorOffset)
 ACCESSORS(InterceptorInfo, data, Object, kDataOffset)
+ACCESSORS(InterceptorInfo, keys, Object, kKeysOffset)
 
 ACCESSORS(CallHandlerInfo, callback, Object, kCallbackOffset)
 ACCESSORS(CallHandlerInfo, data, Object, kDataOffset)
+ACCESSORS(CallHandlerInfo, fast_callback, Object, kFastCallbackOffset)
+ACCESSORS(CallHandlerInfo, fast_signature, Object, kFastSignatureOffset)
 
 ACCESSORS(TemplateInfo, tag, Object, kTagOffset)
 ACCESSORS(TemplateInfo, property_list, Object, kPropertyListOffset)
@@ -3364,6 +3522,17 @@ ACCESSORS(SignatureInfo, args, Object, kArgsOffset)
 
 ACCESSORS(TypeSwitchInfo, types, Object, kTypesOffset)
 
+ACCESSORS(Atom, name, String, kNameOffset)
+ACCESSORS(Atom, hash, Smi, kHashOffset)
+
+ACCESSORS(StringBuffer, buffer, SeqString, kBufferOffset)
+SMI_ACCESSORS(StringBuffer, length, kLengthOffset)
+
+
+int StringBuffer::capacity() {
+  return buffer()->length();
+}
+
 ACCESSORS(Script, source, Object, kSourceOffset)
 ACCESSORS(Script, name, Object, kNameOffset)
 ACCESSORS(Script, id, Object, kIdOffset)
@@ -3402,6 +3571,8 @@ ACCESSORS(SharedFunctionInfo, debug_info, Object, kDebugInfoOffset)
 ACCESSORS(SharedFunctionInfo, inferred_name, String, kInferredNameOffset)
 ACCESSORS(SharedFunctionInfo, this_property_assignments, Object,
           kThisPropertyAssignmentsOffset)
+ACCESSORS(SharedFunctionInfo, deopt_history, Object, kDeoptHistoryOffset)
+ACCESSORS(SharedFunctionInfo, bailout_reasons, Object, kBailoutReasonsOffset)
 
 BOOL_ACCESSORS(FunctionTemplateInfo, flag, hidden_prototype,
                kHiddenPrototypeBit)
@@ -3581,6 +3752,10 @@ BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints,
                kNameShouldPrintAsAnonymous)
 BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, bound, kBoundFunction)
 BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, is_anonymous, kIsAnonymous)
+BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, optimize_from_profile,
+               kOptimizeFromProfile)
+BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, used_on_stack_replacement,
+               kUsedOnStackReplacement)
 
 ACCESSORS(CodeCache, default_cache, FixedArray, kDefaultCacheOffset)
 ACCESSORS(CodeCache, normal_type_cache, Object, kNormalTypeCacheOffset)
@@ -3660,6 +3835,12 @@ void SharedFunctionInfo::set_deopt_counter(Smi* value) {
 }
 
 
+Object* SharedFunctionInfo::last_bailout_reason() {
+  if (!bailout_reasons()->IsFixedArray()) return GetHeap()->undefined_value();
+  return FixedArray::cast(bailout_reasons())->get(0);
+}
+
+
 bool SharedFunctionInfo::is_compiled() {
   return code() !=
       Isolate::Current()->builtins()->builtin(Builtins::kLazyCompile);
@@ -3950,6 +4131,24 @@ JSValue* JSValue::cast(Object* obj) {
 }
 
 
+ACCESSORS(JSDate, value, Object, kValueOffset)
+ACCESSORS(JSDate, cache_stamp, Object, kCacheStampOffset)
+ACCESSORS(JSDate, year, Object, kYearOffset)
+ACCESSORS(JSDate, month, Object, kMonthOffset)
+ACCESSORS(JSDate, day, Object, kDayOffset)
+ACCESSORS(JSDate, weekday, Object, kWeekdayOffset)
+ACCESSORS(JSDate, hour, Object, kHourOffset)
+ACCESSORS(JSDate, min, Object, kMinOffset)
+ACCESSORS(JSDate, sec, Object, kSecOffset)
+
+
+JSDate* JSDate::cast(Object* obj) {
+  ASSERT(obj->IsJSDate());
+  ASSERT(HeapObject::cast(obj)->Size() == JSDate::kSize);
+  return reinterpret_cast<JSDate*>(obj);
+}
+
+
 ACCESSORS(JSMessageObject, type, String, kTypeOffset)
 ACCESSORS(JSMessageObject, arguments, JSArray, kArgumentsOffset)
 ACCESSORS(JSMessageObject, script, Object, kScriptOffset)
@@ -4259,9 +4458,9 @@ uint32_t String::Hash() {
 }
 
 
-StringHasher::StringHasher(int length)
+StringHasher::StringHasher(int length, uint32_t seed)
   : length_(length),
-    raw_running_hash_(0),
+    raw_running_hash_(seed),
     array_index_(0),
     is_array_index_(0 < length_ && length_ <= String::kMaxArrayIndexSize),
     is_first_char_(true),
@@ -4325,8 +4524,8 @@ uint32_t StringHasher::GetHash() {
 
 
 template <typename schar>
-uint32_t HashSequentialString(const schar* chars, int length) {
-  StringHasher hasher(length);
+uint32_t HashSequentialString(const schar* chars, int length, uint32_t seed) {
+  StringHasher hasher(length, seed);
   if (!hasher.has_trivial_hash()) {
     int i;
     for (i = 0; hasher.is_array_index() && (i < length); i++) {
@@ -4432,6 +4631,16 @@ void AccessorInfo::set_prohibits_overwriting(bool value) {
 }
 
 
+bool AccessorInfo::is_internal_field() {
+  return BooleanBit::get(flag(), kIsInternalFieldBit);
+}
+
+
+void AccessorInfo::set_is_internal_field(bool value) {
+  set_flag(BooleanBit::set(flag(), kIsInternalFieldBit, value));
+}
+
+
 PropertyAttributes AccessorInfo::property_attributes() {
   return AttributesField::decode(static_cast<uint32_t>(flag()->value()));
 }
@@ -82,6 +82,9 @@ void HeapObject::HeapObjectPrint(FILE* out) {
     case HEAP_NUMBER_TYPE:
       HeapNumber::cast(this)->HeapNumberPrint(out);
       break;
+    case BIG_INTEGER_TYPE:
+      BigInteger::cast(this)->BigIntegerPrint(out);
+      break;
     case FIXED_DOUBLE_ARRAY_TYPE:
       FixedDoubleArray::cast(this)->FixedDoubleArrayPrint(out);
       break;
@@ -151,6 +154,9 @@ void HeapObject::HeapObjectPrint(FILE* out) {
       PrintF(out, "Value wrapper around:");
       JSValue::cast(this)->value()->Print(out);
       break;
+    case JS_DATE_TYPE:
+      JSDate::cast(this)->JSDatePrint(out);
+      break;
     case CODE_TYPE:
       Code::cast(this)->CodePrint(out);
       break;
@@ -195,6 +201,14 @@ void ByteArray::ByteArrayPrint(FILE* out) {
 }
 
 
+void BigInteger::BigIntegerPrint(FILE* out) {
+  PrintF(out, "%s0x", is_negative() ? "-" : "");
+  for (int i = digit_count() - 1; i >= 0; i--) {
+    PrintF(out, i == digit_count() - 1 ? "%x" : "%08x", digit(i));
+  }
+}
+
+
 void FreeSpace::FreeSpacePrint(FILE* out) {
   PrintF(out, "free space, size %d", Size());
 }
@@ -439,6 +453,7 @@ static const char* TypeToString(InstanceType type) {
     case INVALID_TYPE: return "INVALID";
     case MAP_TYPE: return "MAP";
     case HEAP_NUMBER_TYPE: return "HEAP_NUMBER";
+    case BIG_INTEGER_TYPE: return "BIG_INTEGER";
     case SYMBOL_TYPE: return "SYMBOL";
     case ASCII_SYMBOL_TYPE: return "ASCII_SYMBOL";
     case CONS_SYMBOL_TYPE: return "CONS_SYMBOL";
@@ -487,6 +502,7 @@ static const char* TypeToString(InstanceType type) {
     case JS_WEAK_MAP_TYPE: return "JS_WEAK_MAP";
     case JS_REGEXP_TYPE: return "JS_REGEXP";
     case JS_VALUE_TYPE: return "JS_VALUE";
+    case JS_DATE_TYPE: return "JS_DATE";
     case JS_GLOBAL_OBJECT_TYPE: return "JS_GLOBAL_OBJECT";
     case JS_BUILTINS_OBJECT_TYPE: return "JS_BUILTINS_OBJECT";
     case JS_GLOBAL_PROXY_TYPE: return "JS_GLOBAL_PROXY";
@@ -581,6 +597,31 @@ void JSValue::JSValuePrint(FILE* out) {
 }
 
 
+static const char* const weekdays[] = {
+  "???", "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
+
+
+void JSDate::JSDatePrint(FILE* out) {
+  HeapObject::PrintHeader(out, "JSDate");
+  PrintF(out, " - map = 0x%p\n", reinterpret_cast<void*>(map()));
+  PrintF(out, " - value = ");
+  value()->Print(out);
+  if (!year()->IsSmi()) {
+    PrintF(out, "Time: NaN\n");
+  } else {
+    PrintF(out, "Time: %s %04d/%02d/%02d %02d:%02d:%02d\n",
+           weekdays[weekday()->IsSmi() ? Smi::cast(weekday())->value() + 1 : 0],
+           year()->IsSmi() ? Smi::cast(year())->value() : -1,
+           month()->IsSmi() ? Smi::cast(month())->value() : -1,
+           day()->IsSmi() ? Smi::cast(day())->value() : -1,
+           hour()->IsSmi() ? Smi::cast(hour())->value() : -1,
+           min()->IsSmi() ? Smi::cast(min())->value() : -1,
+           sec()->IsSmi() ? Smi::cast(sec())->value() : -1);
+  }
+}
+
+
 void JSMessageObject::JSMessageObjectPrint(FILE* out) {
   HeapObject::PrintHeader(out, "JSMessageObject");
   PrintF(out, " - type: ");
@@ -723,6 +764,10 @@ void SharedFunctionInfo::SharedFunctionInfoPrint(FILE* out) {
          has_only_simple_this_property_assignments());
   PrintF(out, "\n - this_property_assignments = ");
   this_property_assignments()->ShortPrint(out);
+  PrintF(out, "\n - deopt_history = ");
+  deopt_history()->ShortPrint(out);
+  PrintF(out, "\n - bailout_reasons = ");
+  bailout_reasons()->ShortPrint(out);
   PrintF(out, "\n");
 }
 
@@ -811,6 +856,8 @@ void InterceptorInfo::InterceptorInfoPrint(FILE* out) {
   enumerator()->ShortPrint(out);
   PrintF(out, "\n - data: ");
   data()->ShortPrint(out);
+  PrintF(out, "\n - keys: ");
+  keys()->ShortPrint(out);
 }
 
 
@@ -820,6 +867,10 @@ void CallHandlerInfo::CallHandlerInfoPrint(FILE* out) {
   callback()->ShortPrint(out);
   PrintF(out, "\n - data: ");
   data()->ShortPrint(out);
+  PrintF(out, "\n - fast_callback: ");
+  fast_callback()->ShortPrint(out);
+  PrintF(out, "\n - fast_signature: ");
+  fast_signature()->ShortPrint(out);
   PrintF(out, "\n - call_stub_cache: ");
 }
 
@@ -890,6 +941,24 @@ void TypeSwitchInfo::TypeSwitchInfoPrint(FILE* out) {
 }
 
 
+void Atom::AtomPrint(FILE* out) {
+  HeapObject::PrintHeader(out, "Atom");
+  PrintF(out, "\n - name: ");
+  name()->ShortPrint(out);
+  PrintF(out, "\n - hash: %d\n", hash()->value());
+}
+
+
+void StringBuffer::StringBufferPrint(FILE* out) {
+  HeapObject::PrintHeader(out, "StringBuffer");
+  PrintF(out, "\n - length: %d", length());
+  PrintF(out, "\n - capacity: %d", capacity());
+  PrintF(out, "\n - buffer: ");
+  buffer()->ShortPrint(out);
+  PrintF(out, "\n");
+}
+
+
 void Script::ScriptPrint(FILE* out) {
   HeapObject::PrintHeader(out, "Script");
   PrintF(out, "\n - source: ");
@@ -71,6 +71,7 @@ StaticVisitorBase::VisitorId StaticVisitorBase::GetVisitorId(
 
   switch (instance_type) {
     case BYTE_ARRAY_TYPE:
+    case BIG_INTEGER_TYPE:
       return kVisitByteArray;
 
     case FREE_SPACE_TYPE:
@@ -134,6 +135,7 @@ StaticVisitorBase::VisitorId StaticVisitorBase::GetVisitorId(
     case JS_OBJECT_TYPE:
     case JS_CONTEXT_EXTENSION_OBJECT_TYPE:
     case JS_VALUE_TYPE:
+    case JS_DATE_TYPE:
     case JS_ARRAY_TYPE:
     case JS_GLOBAL_PROXY_TYPE:
     case JS_GLOBAL_OBJECT_TYPE:
@@ -31,6 +31,7 @@
 #include "arguments.h"
 #include "bootstrapper.h"
 #include "codegen.h"
+#include "date.h"
 #include "debug.h"
 #include "deoptimizer.h"
 #include "elements.h"
@@ -181,12 +182,14 @@ void Object::Lookup(String* name, LookupResult* result) {
     holder = this;
   } else {
     Context* global_context = Isolate::Current()->context()->global_context();
-    if (IsNumber()) {
+    if (IsNumber() || IsBigInteger()) {
       holder = global_context->number_function()->instance_prototype();
-    } else if (IsString()) {
+    } else if (IsString() || IsStringBuffer()) {
       holder = global_context->string_function()->instance_prototype();
     } else if (IsBoolean()) {
       holder = global_context->boolean_function()->instance_prototype();
+    } else if (IsAtom()) {
+      holder = global_context->object_function()->instance_prototype();
     }
   }
   ASSERT(holder != NULL);  // Cannot handle null or undefined.
@@ -471,12 +474,26 @@ Object* JSObject::GetNormalizedProperty(LookupResult* result) {
 }
 
 
+// Optimized code that embeds the value of a global property cell as a
+// constant has to be deoptimized before the value changes.
+static void PrepareGlobalPropertyCellForWrite(JSObject* global,
+                                              JSGlobalPropertyCell* cell,
+                                              Object* value) {
+  if (cell->state() == JSGlobalPropertyCell::CONSTANT &&
+      cell->value() != value) {
+    Deoptimizer::DeoptimizeDependentFunctions(global, cell);
+    cell->set_state(JSGlobalPropertyCell::MUTABLE);
+  }
+}
+
+
 Object* JSObject::SetNormalizedProperty(LookupResult* result, Object* value) {
   ASSERT(!HasFastProperties());
   if (IsGlobalObject()) {
     JSGlobalPropertyCell* cell =
         JSGlobalPropertyCell::cast(
             property_dictionary()->ValueAt(result->GetDictionaryEntry()));
+    PrepareGlobalPropertyCellForWrite(this, cell, value);
     cell->set_value(value);
   } else {
     property_dictionary()->ValueAtPut(result->GetDictionaryEntry(), value);
@@ -504,6 +521,7 @@ MaybeObject* JSObject::SetNormalizedProperty(String* name,
       if (!maybe_dict->ToObject(&dict)) return maybe_dict;
     }
     set_properties(StringDictionary::cast(dict));
+    property_dictionary()->ResetReadCount();
     return value;
   }
   // Preserve enumeration index.
@@ -513,6 +531,7 @@ MaybeObject* JSObject::SetNormalizedProperty(String* name,
   if (IsGlobalObject()) {
     JSGlobalPropertyCell* cell =
         JSGlobalPropertyCell::cast(property_dictionary()->ValueAt(entry));
+    PrepareGlobalPropertyCellForWrite(this, cell, value);
     cell->set_value(value);
     // Please note we have to update the property details.
     property_dictionary()->DetailsAtPut(entry, details);
@@ -545,6 +564,8 @@ MaybeObject* JSObject::DeleteNormalizedProperty(String* name, DeleteMode mode) {
       }
       JSGlobalPropertyCell* cell =
           JSGlobalPropertyCell::cast(dictionary->ValueAt(entry));
+      PrepareGlobalPropertyCellForWrite(
+          this, cell, cell->GetHeap()->the_hole_value());
       cell->set_value(cell->GetHeap()->the_hole_value());
       dictionary->DetailsAtPut(entry, details.AsDeleted());
     } else {
@@ -556,6 +577,7 @@ MaybeObject* JSObject::DeleteNormalizedProperty(String* name, DeleteMode mode) {
           return maybe_properties;
         }
         set_properties(new_properties);
+        property_dictionary()->ResetReadCount();
       }
       return deleted;
     }
@@ -650,7 +672,8 @@ MaybeObject* Object::GetProperty(Object* receiver,
     case FIELD:
       value = result->holder()->FastPropertyAt(result->GetFieldIndex());
       ASSERT(!value->IsTheHole() || result->IsReadOnly());
-      return value->IsTheHole() ? heap->undefined_value() : value;
+      if (value->IsTheHole()) return heap->undefined_value();
+      return result->holder()->FastPropertyValueAt(result->GetFieldIndex());
     case CONSTANT_FUNCTION:
       return result->GetConstantFunction();
     case CALLBACKS:
@@ -688,12 +711,14 @@ MaybeObject* Object::GetElementWithReceiver(Object* receiver, uint32_t index) {
     if (!holder->IsJSObject()) {
       Isolate* isolate = heap->isolate();
       Context* global_context = isolate->context()->global_context();
-      if (holder->IsNumber()) {
+      if (holder->IsNumber() || holder->IsBigInteger()) {
         holder = global_context->number_function()->instance_prototype();
-      } else if (holder->IsString()) {
+      } else if (holder->IsString() || holder->IsStringBuffer()) {
         holder = global_context->string_function()->instance_prototype();
       } else if (holder->IsBoolean()) {
         holder = global_context->boolean_function()->instance_prototype();
+      } else if (holder->IsAtom()) {
+        holder = global_context->object_function()->instance_prototype();
       } else if (holder->IsJSProxy()) {
         return JSProxy::cast(holder)->GetElementWithHandler(receiver, index);
       } else {
@@ -752,14 +777,16 @@ Object* Object::GetPrototype() {
   Heap* heap = heap_object->GetHeap();
   Context* context = heap->isolate()->context()->global_context();
 
-  if (heap_object->IsHeapNumber()) {
+  if (heap_object->IsHeapNumber() || heap_object->IsBigInteger()) {
     return context->number_function()->instance_prototype();
   }
-  if (heap_object->IsString()) {
+  if (heap_object->IsString() || heap_object->IsStringBuffer()) {
     return context->string_function()->instance_prototype();
   }
   if (heap_object->IsBoolean()) {
     return context->boolean_function()->instance_prototype();
+  } else if (heap_object->IsAtom()) {
+    return context->object_function()->instance_prototype();
   } else {
     return heap->null_value();
   }
@@ -767,8 +794,8 @@ Object* Object::GetPrototype() {
 
 
 MaybeObject* Object::GetHash(CreationFlag flag) {
-  // The object is either a number, a string, an odd-ball,
-  // a real JS object, or a Harmony proxy.
+  // The object is either a number, a string, an odd-ball, an atom, a
+  // string buffer, a real JS object, or a Harmony proxy.
   if (IsNumber()) {
     uint32_t hash = ComputeLongHash(double_to_uint64(Number()));
     return Smi::FromInt(hash & Smi::kMaxValue);
@@ -781,6 +808,10 @@ MaybeObject* Object::GetHash(CreationFlag flag) {
     uint32_t hash = Oddball::cast(this)->to_string()->Hash();
     return Smi::FromInt(hash);
   }
+  if (IsAtom()) return Atom::cast(this)->hash();
+  // Buffers are mutable and compare by identity, but have no room for an
+  // identity hash, so they all share one.
+  if (IsStringBuffer()) return Smi::FromInt(0);
   if (IsJSReceiver()) {
     return JSReceiver::cast(this)->GetIdentityHash(flag);
   }
@@ -927,6 +958,7 @@ MaybeObject* String::SlowTryFlatten(PretenureFlag pretenure) {
       }
       cs->set_first(result);
       cs->set_second(heap->empty_string(), SKIP_WRITE_BARRIER);
+      cs->set_depth(1);
       return result;
     }
     default:
@@ -960,6 +992,7 @@ bool String::MakeExternal(v8::String::ExternalStringResource* resource) {
 
   // Morph the object to an external string by adjusting the map and
   // reinitializing the fields.
+  heap->EnsureSweptBeforeResizing(this);
   if (size >= ExternalString::kSize) {
     this->set_map(
         is_symbol
@@ -1010,6 +1043,7 @@ bool String::MakeExternal(v8::String::ExternalAsciiStringResource* resource) {
 
   // Morph the object to an external string by adjusting the map and
   // reinitializing the fields.  Use short version if space is limited.
+  heap->EnsureSweptBeforeResizing(this);
   if (size >= ExternalString::kSize) {
     this->set_map(is_symbol ? heap->external_ascii_symbol_map()
                             : heap->external_ascii_string_map());
@@ -1304,6 +1338,11 @@ void HeapObject::HeapObjectShortPrint(StringStream* accumulator) {
       HeapNumber::cast(this)->HeapNumberPrint(accumulator);
       accumulator->Put('>');
       break;
+    case BIG_INTEGER_TYPE:
+      accumulator->Add("<BigInteger: ");
+      BigInteger::cast(this)->BigIntegerPrint(accumulator);
+      accumulator->Put('>');
+      break;
     case JS_PROXY_TYPE:
       accumulator->Add("<JSProxy>");
       break;
@@ -1369,6 +1408,7 @@ void HeapObject::IterateBody(InstanceType type, int object_size,
     case JS_OBJECT_TYPE:
     case JS_CONTEXT_EXTENSION_OBJECT_TYPE:
     case JS_VALUE_TYPE:
+    case JS_DATE_TYPE:
     case JS_ARRAY_TYPE:
     case JS_SET_TYPE:
     case JS_MAP_TYPE:
@@ -1406,6 +1446,7 @@ void HeapObject::IterateBody(InstanceType type, int object_size,
       JSGlobalPropertyCell::BodyDescriptor::IterateBody(this, v);
       break;
     case HEAP_NUMBER_TYPE:
+    case BIG_INTEGER_TYPE:
     case FILLER_TYPE:
     case BYTE_ARRAY_TYPE:
     case FREE_SPACE_TYPE:
@@ -1476,6 +1517,206 @@ void HeapNumber::HeapNumberPrint(StringStream* accumulator) {
 }
 
 
+void BigInteger::BigIntegerPrint(StringStream* accumulator) {
+  // Print in hexadecimal, which needs no allocation.
+  accumulator->Add(is_negative() ? "-0x" : "0x");
+  for (int i = digit_count() - 1; i >= 0; i--) {
+    accumulator->Add(i == digit_count() - 1 ? "%x" : "%08x",
+                     static_cast<int>(digit(i)));
+  }
+}
+
+
+// The sign and magnitude of an integer operand, which is a smi or a
+// BigInteger.  The magnitude of a smi always fits in a single digit.
+class IntegerOperand {
+ public:
+  explicit IntegerOperand(Object* value) : integer_(NULL), smi_digit_(0) {
+    if (value->IsSmi()) {
+      int smi = Smi::cast(value)->value();
+      negative_ = smi < 0;
+      smi_digit_ = negative_ ? 0u - static_cast<uint32_t>(smi)
+                             : static_cast<uint32_t>(smi);
+      length_ = (smi == 0) ? 0 : 1;
+    } else {
+      integer_ = BigInteger::cast(value);
+      negative_ = integer_->is_negative();
+      length_ = integer_->digit_count();
+    }
+  }
+
+  bool negative() const { return negative_; }
+  int length() const { return length_; }
+  uint32_t digit(int index) const {
+    ASSERT(index >= 0 && index < length_);
+    return integer_ == NULL ? smi_digit_ : integer_->digit(index);
+  }
+
+ private:
+  BigInteger* integer_;
+  uint32_t smi_digit_;
+  bool negative_;
+  int length_;
+};
+
+
+static int CompareMagnitudes(const IntegerOperand& x,
+                             const IntegerOperand& y) {
+  if (x.length() != y.length()) return x.length() < y.length() ? -1 : 1;
+  for (int i = x.length() - 1; i >= 0; i--) {
+    if (x.digit(i) != y.digit(i)) return x.digit(i) < y.digit(i) ? -1 : 1;
+  }
+  return 0;
+}
+
+
+// Returns the normalized integer with the given sign and magnitude: a smi
+// if it fits, otherwise a BigInteger without leading zero digits.
+MUST_USE_RESULT static MaybeObject* NewInteger(Heap* heap,
+                                               bool negative,
+                                               const Vector<uint32_t>& digits) {
+  int length = digits.length();
+  while (length > 0 && digits[length - 1] == 0) length--;
+  if (length <= 2) {
+    uint64_t magnitude = 0;
+    if (length > 0) magnitude = digits[0];
+    if (length > 1) magnitude |= static_cast<uint64_t>(digits[1]) << 32;
+    uint64_t limit = negative
+        ? static_cast<uint64_t>(-static_cast<int64_t>(Smi::kMinValue))
+        : static_cast<uint64_t>(Smi::kMaxValue);
+    if (magnitude <= limit) {
+      int64_t value = static_cast<int64_t>(magnitude);
+      return Smi::FromInt(static_cast<int>(negative ? -value : value));
+    }
+  }
+
+  Object* result;
+  { MaybeObject* maybe_result = heap->AllocateBigInteger(length);
+    if (!maybe_result->ToObject(&result)) return maybe_result;
+  }
+  BigInteger* integer = BigInteger::cast(result);
+  integer->set_is_negative(negative);
+  for (int i = 0; i < length; i++) integer->set_digit(i, digits[i]);
+  return integer;
+}
+
+
+// Computes x + y, where y has the magnitude of the given operand and the
+// given sign.
+MUST_USE_RESULT static MaybeObject* AddIntegers(Heap* heap,
+                                                const IntegerOperand& x,
+                                                const IntegerOperand& y,
+                                                bool y_negative) {
+  if (x.negative() == y_negative) {
+    int length = Max(x.length(), y.length()) + 1;
+    ScopedVector<uint32_t> digits(length);
+    uint64_t carry = 0;
+    for (int i = 0; i < length; i++) {
+      uint64_t sum = carry;
+      if (i < x.length()) sum += x.digit(i);
+      if (i < y.length()) sum += y.digit(i);
+      digits[i] = static_cast<uint32_t>(sum);
+      carry = sum >> 32;
+    }
+    return NewInteger(heap, y_negative, digits);
+  }
+
+  // The signs differ, so subtract the smaller magnitude from the larger.
+  int comparison = CompareMagnitudes(x, y);
+  if (comparison == 0) return Smi::FromInt(0);
+  const IntegerOperand& larger = comparison > 0 ? x : y;
+  const IntegerOperand& smaller = comparison > 0 ? y : x;
+  ScopedVector<uint32_t> digits(larger.length());
+  uint64_t borrow = 0;
+  for (int i = 0; i < larger.length(); i++) {
+    uint64_t minuend = larger.digit(i);
+    uint64_t subtrahend = borrow;
+    if (i < smaller.length()) subtrahend += smaller.digit(i);
+    digits[i] = static_cast<uint32_t>(minuend - subtrahend);
+    borrow = (minuend < subtrahend) ? 1 : 0;
+  }
+  ASSERT(borrow == 0);
+  return NewInteger(heap, comparison > 0 ? x.negative() : y_negative, digits);
+}
+
+
+MaybeObject* BigInteger::Add(Heap* heap, Object* x, Object* y) {
+  IntegerOperand left(x);
+  IntegerOperand right(y);
+  return AddIntegers(heap, left, right, right.negative());
+}
+
+
+MaybeObject* BigInteger::Subtract(Heap* heap, Object* x, Object* y) {
+  IntegerOperand left(x);
+  IntegerOperand right(y);
+  return AddIntegers(heap, left, right, !right.negative());
+}
+
+
+MaybeObject* BigInteger::Multiply(Heap* heap, Object* x, Object* y) {
+  IntegerOperand left(x);
+  IntegerOperand right(y);
+  if (left.length() == 0 || right.length() == 0) return Smi::FromInt(0);
+  int length = left.length() + right.length();
+  ScopedVector<uint32_t> digits(length);
+  for (int i = 0; i < length; i++) digits[i] = 0;
+  for (int i = 0; i < left.length(); i++) {
+    uint64_t multiplier = left.digit(i);
+    uint64_t carry = 0;
+    for (int j = 0; j < right.length(); j++) {
+      // At most (2^32 - 1)^2 + 2 * (2^32 - 1), which fits in 64 bits.
+      uint64_t product = multiplier * right.digit(j) + digits[i + j] + carry;
+      digits[i + j] = static_cast<uint32_t>(product);
+      carry = product >> 32;
+    }
+    digits[i + right.length()] = static_cast<uint32_t>(carry);
+  }
+  return NewInteger(heap, left.negative() != right.negative(), digits);
+}
+
+
+double BigInteger::ToDouble() {
+  double result = 0;
+  for (int i = digit_count() - 1; i >= 0; i--) {
+    result = result * 4294967296.0 + digit(i);
+  }
+  return is_negative() ? -result : result;
+}
+
+
+MaybeObject* BigInteger::ToString() {
+  // Divide a copy of the magnitude by 10^9 repeatedly, producing nine
+  // decimal digits per step from the least significant end.
+  static const uint32_t kChunk = 1000000000;
+  static const int kChunkDigits = 9;
+  int length = digit_count();
+  ScopedVector<uint32_t> quotient(length);
+  for (int i = 0; i < length; i++) quotient[i] = digit(i);
+  // Each 32-bit digit produces fewer than ten decimal digits.
+  ScopedVector<char> buffer(length * 10 + 2);
+  int position = buffer.length();
+  buffer[--position] = '\0';
+  while (length > 0) {
+    uint64_t remainder = 0;
+    for (int i = length - 1; i >= 0; i--) {
+      uint64_t current = (remainder << 32) | quotient[i];
+      quotient[i] = static_cast<uint32_t>(current / kChunk);
+      remainder = current % kChunk;
+    }
+    while (length > 0 && quotient[length - 1] == 0) length--;
+    for (int i = 0; i < kChunkDigits; i++) {
+      buffer[--position] = static_cast<char>('0' + remainder % 10);
+      remainder /= 10;
+      // No leading zeros in the most significant chunk.
+      if (length == 0 && remainder == 0) break;
+    }
+  }
+  if (is_negative()) buffer[--position] = '-';
+  return GetHeap()->AllocateStringFromAscii(CStrVector(&buffer[position]));
+}
+
+
 String* JSReceiver::class_name() {
   if (IsJSFunction() && IsJSFunctionProxy()) {
     return GetHeap()->function_class_symbol();
@@ -1509,6 +1750,22 @@ MaybeObject* JSObject::AddFastPropertyUsingMap(Map* new_map,
                                                String* name,
                                                Object* value) {
   int index = new_map->PropertyIndexFor(name);
+  Object* stored_value = value;
+  DescriptorArray* new_descriptors = new_map->instance_descriptors();
+  PropertyDetails details(
+      new_descriptors->GetDetails(new_descriptors->Search(name)));
+  if (details.representation() == DOUBLE_FIELD) {
+    if (value->IsNumber()) {
+      MaybeObject* maybe_box =
+          GetHeap()->AllocateMutableHeapNumber(value->Number());
+      if (!maybe_box->ToObject(&stored_value)) return maybe_box;
+    } else {
+      new_map->GeneralizeDoubleField(name);
+      // Our map is not in the transition tree of new_map, but it holds the
+      // stubs for the transition.
+      map()->ClearCodeCache(GetHeap());
+    }
+  }
   if (map()->unused_property_fields() == 0) {
     ASSERT(map()->unused_property_fields() == 0);
     int new_unused = new_map->unused_property_fields();
@@ -1520,6 +1777,24 @@ MaybeObject* JSObject::AddFastPropertyUsingMap(Map* new_map,
     set_properties(FixedArray::cast(values));
   }
   set_map(new_map);
+  FastPropertyAtPut(index, stored_value);
+  return value;
+}
+
+
+MaybeObject* JSObject::SetFieldValue(String* name,
+                                     int index,
+                                     FieldRepresentation representation,
+                                     Object* value) {
+  if (representation != TAGGED_FIELD) {
+    Object* field = FastPropertyAt(index);
+    if (value->IsNumber() && field->IsMutableHeapNumber()) {
+      HeapNumber::cast(field)->set_value(value->Number());
+      return value;
+    }
+    ASSERT(representation == MIXED_FIELD || !value->IsNumber());
+    if (representation == DOUBLE_FIELD) map()->GeneralizeDoubleField(name);
+  }
   return FastPropertyAtPut(index, value);
 }
 
@@ -1542,7 +1817,8 @@ static bool IsIdentifier(UnicodeCache* cache,
 
 MaybeObject* JSObject::AddFastProperty(String* name,
                                        Object* value,
-                                       PropertyAttributes attributes) {
+                                       PropertyAttributes attributes,
+                                       DoubleFieldMode mode) {
   ASSERT(!IsJSGlobalProxy());
 
   // Normalize the object if the name is an actual string (not the
@@ -1559,12 +1835,25 @@ MaybeObject* JSObject::AddFastProperty(String* name,
     return AddSlowProperty(name, value, attributes);
   }
 
+  // Properties added with a heap number value keep it in a mutable heap
+  // number, on the assumption that they will keep holding doubles.
+  FieldRepresentation representation = TAGGED_FIELD;
+  Object* stored_value = value;
+  if (FLAG_unbox_double_fields &&
+      mode == ALLOW_DOUBLE_FIELD &&
+      value->IsHeapNumber()) {
+    representation = DOUBLE_FIELD;
+    MaybeObject* maybe_box =
+        isolate->heap()->AllocateMutableHeapNumber(value->Number());
+    if (!maybe_box->ToObject(&stored_value)) return maybe_box;
+  }
+
   DescriptorArray* old_descriptors = map()->instance_descriptors();
   // Compute the new index for new field.
   int index = map()->NextFreePropertyIndex();
 
   // Allocate new instance descriptors with (name, index) added
-  FieldDescriptor new_field(name, index, attributes);
+  FieldDescriptor new_field(name, index, attributes, 0, representation);
   Object* new_descriptors;
   { MaybeObject* maybe_new_descriptors =
         old_descriptors->CopyInsert(&new_field, REMOVE_TRANSITIONS);
@@ -1608,6 +1897,9 @@ MaybeObject* JSObject::AddFastProperty(String* name,
   }
 
   if (map()->unused_property_fields() == 0) {
+    if (properties()->length() == 0 && map()->constructor()->IsJSFunction()) {
+      JSFunction::cast(map()->constructor())->GrowInitialMap(map());
+    }
     if (properties()->length() > MaxFastProperties()) {
       Object* obj;
       { MaybeObject* maybe_obj =
@@ -1627,12 +1919,19 @@ MaybeObject* JSObject::AddFastProperty(String* name,
   } else {
     new_map->set_unused_property_fields(map()->unused_property_fields() - 1);
   }
+  if (FLAG_share_field_descriptors &&
+      !isolate->bootstrapper()->IsActive()) {
+    new_descriptors = FieldDescriptorsCache::Share(
+        isolate->heap()->field_descriptors_cache(),
+        DescriptorArray::cast(new_descriptors));
+  }
   // We have now allocated all the necessary objects.
   // All the changes can be applied at once, so they are atomic.
   map()->set_instance_descriptors(old_descriptors);
   new_map->set_instance_descriptors(DescriptorArray::cast(new_descriptors));
   set_map(new_map);
-  return FastPropertyAtPut(index, value);
+  FastPropertyAtPut(index, stored_value);
+  return value;
 }
 
 
@@ -1709,6 +2008,8 @@ MaybeObject* JSObject::AddSlowProperty(String* name,
     int entry = dict->FindEntry(name);
     if (entry != StringDictionary::kNotFound) {
       store_value = dict->ValueAt(entry);
+      PrepareGlobalPropertyCellForWrite(
+          this, JSGlobalPropertyCell::cast(store_value), value);
       JSGlobalPropertyCell::cast(store_value)->set_value(value);
       // Assign an enumeration index to the property and update
       // SetNextEnumerationIndex.
@@ -1731,6 +2032,7 @@ MaybeObject* JSObject::AddSlowProperty(String* name,
     if (!maybe_result->ToObject(&result)) return maybe_result;
   }
   if (dict != result) set_properties(StringDictionary::cast(result));
+  property_dictionary()->ResetReadCount();
   return value;
 }
 
@@ -1738,7 +2040,8 @@ MaybeObject* JSObject::AddSlowProperty(String* name,
 MaybeObject* JSObject::AddProperty(String* name,
                                    Object* value,
                                    PropertyAttributes attributes,
-                                   StrictModeFlag strict_mode) {
+                                   StrictModeFlag strict_mode,
+                                   DoubleFieldMode mode) {
   ASSERT(!IsJSGlobalProxy());
   Map* map_of_this = map();
   Heap* heap = GetHeap();
@@ -1761,7 +2064,7 @@ MaybeObject* JSObject::AddProperty(String* name,
                                            JSFunction::cast(value),
                                            attributes);
       } else {
-        return AddFastProperty(name, value, attributes);
+        return AddFastProperty(name, value, attributes, mode);
       }
     } else {
       // Normalize the object to prevent very large instance descriptors.
@@ -1918,6 +2221,54 @@ MaybeObject* JSObject::ConvertDescriptorToField(String* name,
 }
 
 
+MaybeObject* JSObject::DefineMethod(String* name, JSFunction* function) {
+  LookupResult result(GetIsolate());
+  LocalLookupRealNamedProperty(name, &result);
+  if (result.IsProperty() &&
+      result.type() == CONSTANT_FUNCTION &&
+      !result.IsReadOnly()) {
+    if (result.GetConstantFunction() == function) return function;
+    // Constant functions must not be in new space.  Objects that keep
+    // being redefined are left to the generic path, which makes the
+    // method a field, so they cannot churn through maps.
+    if (!GetHeap()->InNewSpace(function) &&
+        map()->method_redefinition_count() < Map::kMaxMethodRedefinitions) {
+      return ReplaceConstantFunction(name, function, result.GetAttributes());
+    }
+  }
+  return SetLocalPropertyIgnoreAttributes(name, function, NONE);
+}
+
+
+MaybeObject* JSObject::ReplaceConstantFunction(String* name,
+                                               JSFunction* function,
+                                               PropertyAttributes attributes) {
+  ASSERT(HasFastProperties());
+  ASSERT(!GetHeap()->InNewSpace(function));
+  ConstantFunctionDescriptor d(name, function, attributes);
+  Object* new_descriptors;
+  { MaybeObject* maybe_new_descriptors =
+        map()->instance_descriptors()->CopyInsert(&d, REMOVE_TRANSITIONS);
+    if (!maybe_new_descriptors->ToObject(&new_descriptors)) {
+      return maybe_new_descriptors;
+    }
+  }
+
+  // The new map has no transitions, so other objects that share the old
+  // map are unaffected and keep their own transition tree.
+  Object* new_map;
+  { MaybeObject* maybe_new_map = map()->CopyDropDescriptors();
+    if (!maybe_new_map->ToObject(&new_map)) return maybe_new_map;
+  }
+  Map::cast(new_map)->set_instance_descriptors(
+      DescriptorArray::cast(new_descriptors));
+  Map::cast(new_map)->set_method_redefinition_count(
+      map()->method_redefinition_count() + 1);
+  set_map(Map::cast(new_map));
+  return function;
+}
+
+
 
 MaybeObject* JSObject::SetPropertyWithInterceptor(
     String* name,
@@ -2962,7 +3313,10 @@ MaybeObject* JSObject::SetPropertyForResult(LookupResult* result,
     case NORMAL:
       return SetNormalizedProperty(result, value);
     case FIELD:
-      return FastPropertyAtPut(result->GetFieldIndex(), value);
+      return SetFieldValue(name,
+                           result->GetFieldIndex(),
+                           result->GetFieldRepresentation(),
+                           value);
     case MAP_TRANSITION:
       if (attributes == result->GetAttributes()) {
         // Only use map transition if the attributes match.
@@ -3060,7 +3414,8 @@ MaybeObject* JSObject::SetLocalPropertyIgnoreAttributes(
   // Check for accessor in prototype chain removed here in clone.
   if (!result.IsFound()) {
     // Neither properties nor transitions found.
-    return AddProperty(name, value, attributes, kNonStrictMode);
+    return AddProperty(name, value, attributes, kNonStrictMode,
+                       OMIT_DOUBLE_FIELD);
   }
 
   PropertyDetails details = PropertyDetails(attributes, NORMAL);
@@ -3070,7 +3425,10 @@ MaybeObject* JSObject::SetLocalPropertyIgnoreAttributes(
     case NORMAL:
       return SetNormalizedProperty(name, value, details);
     case FIELD:
-      return FastPropertyAtPut(result.GetFieldIndex(), value);
+      return SetFieldValue(name,
+                           result.GetFieldIndex(),
+                           result.GetFieldRepresentation(),
+                           value);
     case MAP_TRANSITION:
       if (attributes == result.GetAttributes()) {
         // Only use map transition if the attributes match.
@@ -3409,10 +3767,27 @@ MaybeObject* JSObject::NormalizeProperties(PropertyNormalizationMode mode,
   // We have now successfully allocated all the necessary objects.
   // Changes can now be made with the guarantee that all of them take effect.
 
+  // Nothing updates the mutable heap numbers of double fields in place once
+  // they are in the dictionary, so they become ordinary heap numbers.
+  if (FLAG_unbox_double_fields) {
+    for (int i = 0; i < descs->number_of_descriptors(); i++) {
+      PropertyDetails details(descs->GetDetails(i));
+      if (details.type() != FIELD ||
+          details.representation() == TAGGED_FIELD) {
+        continue;
+      }
+      Object* value = FastPropertyAt(descs->GetFieldIndex(i));
+      if (value->IsMutableHeapNumber()) {
+        HeapObject::cast(value)->set_map(current_heap->heap_number_map());
+      }
+    }
+  }
+
   // Resize the object in the heap if necessary.
   int new_instance_size = new_map->instance_size();
   int instance_size_delta = map_of_this->instance_size() - new_instance_size;
   ASSERT(instance_size_delta >= 0);
+  current_heap->EnsureSweptBeforeResizing(this);
   current_heap->CreateFillerObjectAt(this->address() + new_instance_size,
                                      instance_size_delta);
   if (Marking::IsBlack(Marking::MarkBitFrom(this))) {
@@ -3423,6 +3798,7 @@ MaybeObject* JSObject::NormalizeProperties(PropertyNormalizationMode mode,
   set_map(new_map);
   new_map->clear_instance_descriptors();
 
+  dictionary->ResetReadCount();
   set_properties(dictionary);
 
   current_heap->isolate()->counters()->props_to_dictionary()->Increment();
@@ -3445,6 +3821,43 @@ MaybeObject* JSObject::TransformToFastProperties(int unused_property_fields) {
 }
 
 
+MaybeObject* JSObject::TransformToFastPropertiesAfterReads() {
+  ASSERT(!HasFastProperties());
+  ASSERT(!IsGlobalObject());
+  StringDictionary* dictionary = property_dictionary();
+  // Objects used as hash tables keep their dictionary. They would be
+  // normalized again as soon as another property is added.
+  if (dictionary->NumberOfElements() >
+      map()->inobject_properties() + kMaxFastProperties) {
+    dictionary->StopCountingReads();
+    return this;
+  }
+
+  FixedArray* cache = GetIsolate()->context()->global_context()->
+      fast_properties_map_cache();
+  int index = dictionary->KeySetHash() % kFastPropertiesMapCacheEntries;
+  Object* cached = cache->get(index);
+  Object* result;
+  if (cached->IsMap() &&
+      dictionary->CanTransformPropertiesToFastWith(this, Map::cast(cached))) {
+    MaybeObject* maybe_result =
+        dictionary->TransformPropertiesToFastWith(this, Map::cast(cached));
+    if (!maybe_result->ToObject(&result)) return maybe_result;
+  } else {
+    MaybeObject* maybe_result =
+        dictionary->TransformPropertiesToFastFor(this, 0);
+    if (!maybe_result->ToObject(&result)) return maybe_result;
+    if (!HasFastProperties()) {
+      dictionary->StopCountingReads();
+      return this;
+    }
+    cache->set(index, map());
+  }
+  GetIsolate()->counters()->props_to_fast_after_reads()->Increment();
+  return this;
+}
+
+
 MaybeObject* JSObject::NormalizeElements() {
   ASSERT(!HasExternalArrayElements());
 
@@ -4222,7 +4635,8 @@ void JSReceiver::LocalLookup(String* name, LookupResult* result) {
 
   // Check for lookup interceptor except when bootstrapping.
   if (js_object->HasNamedInterceptor() &&
-      !heap->isolate()->bootstrapper()->IsActive()) {
+      !heap->isolate()->bootstrapper()->IsActive() &&
+      js_object->GetNamedInterceptor()->Intercepts(name)) {
     result->InterceptorResult(js_object);
     return;
   }
@@ -4471,9 +4885,14 @@ MaybeObject* JSObject::SetPropertyCallback(String* name,
     }
     set_map(Map::cast(new_map));
     // When running crankshaft, changing the map is not enough. We
-    // need to deoptimize all functions that rely on this global
-    // object.
-    Deoptimizer::DeoptimizeGlobalObject(this);
+    // need to deoptimize the functions that embed the property cell,
+    // as the cell will hold the callbacks instead of a value.
+    int entry = property_dictionary()->FindEntry(name);
+    if (entry != StringDictionary::kNotFound) {
+      JSGlobalPropertyCell* cell =
+          JSGlobalPropertyCell::cast(property_dictionary()->ValueAt(entry));
+      Deoptimizer::DeoptimizeDependentFunctions(this, cell);
+    }
   }
 
   // Update the dictionary with the new CALLBACKS property.
@@ -4903,6 +5322,27 @@ void Map::TraverseTransitionTree(TraverseCallback callback, void* data) {
 }
 
 
+static void GeneralizeDoubleFieldOfMap(Map* map, void* data) {
+  String* name = reinterpret_cast<String*>(data);
+  DescriptorArray* descriptors = map->instance_descriptors();
+  int number = descriptors->Search(name);
+  if (number == DescriptorArray::kNotFound) return;
+  PropertyDetails details(descriptors->GetDetails(number));
+  if (details.type() != FIELD || details.representation() != DOUBLE_FIELD) {
+    return;
+  }
+  // Identically shaped maps may share the descriptor array, which is fine:
+  // a mixed field can hold anything a double field can.
+  descriptors->SetDetails(number, details.set_representation(MIXED_FIELD));
+  map->ClearCodeCache(map->GetHeap());
+}
+
+
+void Map::GeneralizeDoubleField(String* name) {
+  TraverseTransitionTree(&GeneralizeDoubleFieldOfMap, name);
+}
+
+
 MaybeObject* CodeCache::Update(String* name, Code* code) {
   // The number of monomorphic stubs for normal load/store/call IC's can grow to
   // a large number and therefore they need to go into a hash table. They are
@@ -5405,10 +5845,15 @@ MaybeObject* FixedArray::CopySize(int new_length) {
 
 
 void FixedArray::CopyTo(int pos, FixedArray* dest, int dest_pos, int len) {
+  ASSERT(dest != this);
+  if (len == 0) return;
   AssertNoAllocation no_gc;
-  WriteBarrierMode mode = dest->GetWriteBarrierMode(no_gc);
-  for (int index = 0; index < len; index++) {
-    dest->set(dest_pos+index, get(pos+index), mode);
+  CopyWords(dest->data_start() + dest_pos, data_start() + pos, len);
+  // The write barrier is applied once for the whole range.
+  if (dest->GetWriteBarrierMode(no_gc) == UPDATE_WRITE_BARRIER) {
+    Heap* heap = dest->GetHeap();
+    heap->RecordWrites(dest->address(), dest->OffsetOfElementAt(dest_pos), len);
+    heap->incremental_marking()->RecordWrites(dest);
   }
 }
 
@@ -6194,8 +6639,15 @@ int String::Utf8Length(String* input, int from, int to) {
       case kSeqStringTag: {
         Vector<const uc16> vector = input->GetFlatContent().ToUC16Vector();
         const uc16* p = vector.start();
-        for (int i = from; i < to; i++) {
-          total += unibrow::Utf8::Length(p[i]);
+        int i = from;
+        while (i < to) {
+          // Runs of ASCII characters take one byte each.
+          int ascii_length = NonAsciiStart(p + i, to - i);
+          total += ascii_length;
+          i += ascii_length;
+          while (i < to && p[i] > kMaxAsciiCharCodeU) {
+            total += unibrow::Utf8::Length(p[i++]);
+          }
         }
         return total;
       }
@@ -6616,7 +7068,8 @@ static inline bool CompareRawStringContents(Vector<Char> a, Vector<Char> b) {
   ASSERT_EQ(length, b.length());
   const Char* pa = a.start();
   const Char* pb = b.start();
-  int i = 0;
+  // Whole 16 byte blocks keep the alignment of the remaining characters.
+  int i = SkipEqualBlocks(pa, pb, length);
 #ifndef V8_HOST_CAN_READ_UNALIGNED
   // If this architecture isn't comfortable reading unaligned ints
   // then we have to check that the strings are aligned before
@@ -6813,13 +7266,18 @@ uint32_t String::ComputeAndSetHash() {
 
   // Compute the hash code.
   uint32_t field = 0;
+  uint32_t seed = GetHeap()->HashSeed();
   if (StringShape(this).IsSequentialAscii()) {
-    field = HashSequentialString(SeqAsciiString::cast(this)->GetChars(), len);
+    field = HashSequentialString(SeqAsciiString::cast(this)->GetChars(),
+                                 len,
+                                 seed);
   } else if (StringShape(this).IsSequentialTwoByte()) {
-    field = HashSequentialString(SeqTwoByteString::cast(this)->GetChars(), len);
+    field = HashSequentialString(SeqTwoByteString::cast(this)->GetChars(),
+                                 len,
+                                 seed);
   } else {
     StringInputBuffer buffer(this);
-    field = ComputeHashField(&buffer, len);
+    field = ComputeHashField(&buffer, len, seed);
   }
 
   // Store the hash code in the object.
@@ -6910,8 +7368,9 @@ uint32_t StringHasher::GetHashField() {
 
 
 uint32_t String::ComputeHashField(unibrow::CharacterStream* buffer,
-                                  int length) {
-  StringHasher hasher(length);
+                                  int length,
+                                  uint32_t seed) {
+  StringHasher hasher(length, seed);
 
   // Very long strings have a trivial hash that doesn't inspect the
   // string contents.
@@ -7162,7 +7621,7 @@ bool JSFunction::CompileOptimized(Handle<JSFunction> function,
 
 
 bool JSFunction::IsInlineable() {
-  if (IsBuiltin()) return false;
+  if (IsBuiltin() && !IsInlineableBuiltin()) return false;
   SharedFunctionInfo* shared_info = shared();
   // Check that the function has a script associated with it.
   if (!shared_info->script()->IsScript()) return false;
@@ -7175,6 +7634,23 @@ bool JSFunction::IsInlineable() {
 }
 
 
+bool JSFunction::IsInlineableBuiltin() {
+  if (!FLAG_inline_array_builtins) return false;
+  if (!IsBuiltin() || !shared()->HasBuiltinFunctionId()) return false;
+  // These builtins only refer to globals of the builtins object, which
+  // have property cells, and do not use the arguments object. That lets
+  // them run inlined in the context of their caller.
+  switch (shared()->builtin_function_id()) {
+    case kArrayForEach:
+    case kArrayMap:
+    case kArrayFilter:
+      return true;
+    default:
+      return false;
+  }
+}
+
+
 Object* JSFunction::SetInstancePrototype(Object* value) {
   ASSERT(value->IsJSObject());
   Heap* heap = GetHeap();
@@ -7191,6 +7667,37 @@ Object* JSFunction::SetInstancePrototype(Object* value) {
 }
 
 
+void JSFunction::GrowInitialMap(Map* map) {
+  if (!FLAG_clever_optimizations || !has_initial_map()) return;
+  Map* current = initial_map();
+  if (map != current) return;
+  SharedFunctionInfo* info = shared();
+  if (IsBuiltin() || info->native() || info->IsApiFunction() ||
+      info->IsInobjectSlackTrackingInProgress()) {
+    return;
+  }
+  // Object literals and array literals rely on the initial maps of the
+  // global context's Object and Array functions.
+  Context* global_context = context()->global_context();
+  if (this == global_context->object_function() ||
+      this == global_context->array_function()) {
+    return;
+  }
+  if (current->instance_type() != JS_OBJECT_TYPE ||
+      current->instance_size() >= JSObject::kMaxInstanceSize) {
+    return;
+  }
+
+  // The next constructor call allocates a new initial map sized by the
+  // expected number of properties.  Objects created from the old one keep
+  // their maps.
+  info->set_expected_nof_properties(
+      current->inobject_properties() + JSObject::kFieldsAdded);
+  set_prototype_or_initial_map(current->prototype());
+  GetHeap()->ClearInstanceofCache();
+}
+
+
 MaybeObject* JSFunction::SetPrototype(Object* value) {
   ASSERT(should_have_prototype());
   Object* construct_prototype = value;
@@ -7639,6 +8146,28 @@ void SharedFunctionInfo::CompleteInobjectSlackTracking() {
 }
 
 
+void SharedFunctionInfo::CompleteInobjectSlackTrackingRound() {
+  ASSERT(live_objects_may_exist() && IsInobjectSlackTrackingInProgress());
+  Map* map = Map::cast(initial_map());
+
+  int slack = map->unused_property_fields();
+  map->TraverseTransitionTree(&GetMinInobjectSlack, &slack);
+  int retained = slack / 2;
+  if (retained == 0) {
+    CompleteInobjectSlackTracking();
+    return;
+  }
+
+  // Reclaim the other half now and keep counting.  Unused fields stay
+  // filled with one_pointer_filler_map, so the objects can still shrink.
+  slack -= retained;
+  map->TraverseTransitionTree(&ShrinkInstanceSize, &slack);
+  ASSERT(expected_nof_properties() >= slack);
+  set_expected_nof_properties(expected_nof_properties() - slack);
+  set_construction_count(kGenerousAllocationCount);
+}
+
+
 void ObjectVisitor::VisitCodeTarget(RelocInfo* rinfo) {
   ASSERT(RelocInfo::IsCodeTarget(rinfo->rmode()));
   Object* target = Code::GetCodeFromTargetAddress(rinfo->target_address());
@@ -7814,6 +8343,25 @@ void Code::SetNoStackCheckTable() {
 }
 
 
+int Code::LookupOsrEntryAt(Address pc, int* loop_depth) {
+  ASSERT(kind() == FUNCTION);
+  unsigned offset = stack_check_table_offset();
+  if (static_cast<int>(offset) >= instruction_size()) return AstNode::kNoNumber;
+  Address cursor = instruction_start() + offset;
+  uint32_t length = Memory::uint32_at(cursor);
+  uint32_t pc_offset = static_cast<uint32_t>(pc - instruction_start());
+  cursor += kIntSize;
+  for (uint32_t i = 0; i < length; ++i) {
+    if (Memory::uint32_at(cursor + kIntSize) == pc_offset) {
+      *loop_depth = static_cast<int>(Memory::uint32_at(cursor + 2 * kIntSize));
+      return static_cast<int>(Memory::uint32_at(cursor));
+    }
+    cursor += kStackCheckTableEntrySize;
+  }
+  return AstNode::kNoNumber;
+}
+
+
 Map* Code::FindFirstMap() {
   ASSERT(is_inline_cache_stub());
   AssertNoAllocation no_allocation;
@@ -7827,6 +8375,29 @@ Map* Code::FindFirstMap() {
 }
 
 
+// Identify kind of code.
+const char* Code::Kind2String(Kind kind) {
+  switch (kind) {
+    case FUNCTION: return "FUNCTION";
+    case OPTIMIZED_FUNCTION: return "OPTIMIZED_FUNCTION";
+    case STUB: return "STUB";
+    case BUILTIN: return "BUILTIN";
+    case LOAD_IC: return "LOAD_IC";
+    case KEYED_LOAD_IC: return "KEYED_LOAD_IC";
+    case STORE_IC: return "STORE_IC";
+    case KEYED_STORE_IC: return "KEYED_STORE_IC";
+    case CALL_IC: return "CALL_IC";
+    case KEYED_CALL_IC: return "KEYED_CALL_IC";
+    case UNARY_OP_IC: return "UNARY_OP_IC";
+    case BINARY_OP_IC: return "BINARY_OP_IC";
+    case COMPARE_IC: return "COMPARE_IC";
+    case TO_BOOLEAN_IC: return "TO_BOOLEAN_IC";
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+
 #ifdef ENABLE_DISASSEMBLER
 
 void DeoptimizationInputData::DeoptimizationInputDataPrint(FILE* out) {
@@ -7870,7 +8441,8 @@ void DeoptimizationInputData::DeoptimizationInputDataPrint(FILE* out) {
 
         case Translation::FRAME: {
           int ast_id = iterator.Next();
-          int function_id = iterator.Next();
+          int function_id =
+              Translation::LiteralIdForFunction(iterator.Next());
           JSFunction* function =
               JSFunction::cast(LiteralArray()->get(function_id));
           unsigned height = iterator.Next();
@@ -7895,6 +8467,12 @@ void DeoptimizationInputData::DeoptimizationInputDataPrint(FILE* out) {
           break;
         }
 
+        case Translation::UINT32_REGISTER: {
+          int reg_code = iterator.Next();
+          PrintF(out, "{input=%s}", converter.NameOfCPURegister(reg_code));
+          break;
+        }
+
         case Translation::DOUBLE_REGISTER: {
           int reg_code = iterator.Next();
           PrintF(out, "{input=%s}",
@@ -7914,6 +8492,12 @@ void DeoptimizationInputData::DeoptimizationInputDataPrint(FILE* out) {
           break;
         }
 
+        case Translation::UINT32_STACK_SLOT: {
+          int input_slot_index = iterator.Next();
+          PrintF(out, "{input=%d}", input_slot_index);
+          break;
+        }
+
         case Translation::DOUBLE_STACK_SLOT: {
           int input_slot_index = iterator.Next();
           PrintF(out, "{input=%d}", input_slot_index);
@@ -7928,6 +8512,14 @@ void DeoptimizationInputData::DeoptimizationInputDataPrint(FILE* out) {
 
         case Translation::ARGUMENTS_OBJECT:
           break;
+
+        case Translation::CAPTURED_OBJECT: {
+          unsigned literal_index = iterator.Next();
+          int field_count = iterator.Next();
+          PrintF(out, "{literal_id=%u, field_count=%d}",
+                 literal_index, field_count);
+          break;
+        }
       }
       PrintF(out, "\n");
     }
@@ -7952,29 +8544,6 @@ void DeoptimizationOutputData::DeoptimizationOutputDataPrint(FILE* out) {
 }
 
 
-// Identify kind of code.
-const char* Code::Kind2String(Kind kind) {
-  switch (kind) {
-    case FUNCTION: return "FUNCTION";
-    case OPTIMIZED_FUNCTION: return "OPTIMIZED_FUNCTION";
-    case STUB: return "STUB";
-    case BUILTIN: return "BUILTIN";
-    case LOAD_IC: return "LOAD_IC";
-    case KEYED_LOAD_IC: return "KEYED_LOAD_IC";
-    case STORE_IC: return "STORE_IC";
-    case KEYED_STORE_IC: return "KEYED_STORE_IC";
-    case CALL_IC: return "CALL_IC";
-    case KEYED_CALL_IC: return "KEYED_CALL_IC";
-    case UNARY_OP_IC: return "UNARY_OP_IC";
-    case BINARY_OP_IC: return "BINARY_OP_IC";
-    case COMPARE_IC: return "COMPARE_IC";
-    case TO_BOOLEAN_IC: return "TO_BOOLEAN_IC";
-  }
-  UNREACHABLE();
-  return NULL;
-}
-
-
 const char* Code::ICState2String(InlineCacheState state) {
   switch (state) {
     case UNINITIALIZED: return "UNINITIALIZED";
@@ -8096,10 +8665,11 @@ void Code::Disassemble(const char* name, FILE* out) {
           reinterpret_cast<unsigned*>(instruction_start() + offset);
       unsigned length = address[0];
       PrintF(out, "Stack checks (size = %u)\n", length);
-      PrintF(out, "ast_id  pc_offset\n");
+      PrintF(out, "ast_id  pc_offset  depth\n");
       for (unsigned i = 0; i < length; ++i) {
-        unsigned index = (2 * i) + 1;
-        PrintF(out, "%6u  %9u\n", address[index], address[index + 1]);
+        unsigned index = (3 * i) + 1;
+        PrintF(out, "%6u  %9u  %5u\n",
+               address[index], address[index + 1], address[index + 2]);
       }
       PrintF(out, "\n");
     }
@@ -8113,12 +8683,8 @@ void Code::Disassemble(const char* name, FILE* out) {
 
 
 static void CopyFastElementsToFast(FixedArray* source,
-                                   FixedArray* destination,
-                                   WriteBarrierMode mode) {
-  uint32_t count = static_cast<uint32_t>(source->length());
-  for (uint32_t i = 0; i < count; ++i) {
-    destination->set(i, source->get(i), mode);
-  }
+                                   FixedArray* destination) {
+  source->CopyTo(0, destination, 0, source->length());
 }
 
 
@@ -8173,9 +8739,7 @@ MaybeObject* JSObject::SetFastElementsCapacityAndLength(
     case FAST_SMI_ONLY_ELEMENTS:
     case FAST_ELEMENTS: {
       AssertNoAllocation no_gc;
-      WriteBarrierMode mode(new_elements->GetWriteBarrierMode(no_gc));
-      CopyFastElementsToFast(FixedArray::cast(old_elements_raw),
-                             new_elements, mode);
+      CopyFastElementsToFast(FixedArray::cast(old_elements_raw), new_elements);
       set_map(new_map);
       set_elements(new_elements);
       break;
@@ -8202,7 +8766,7 @@ MaybeObject* JSObject::SetFastElementsCapacityAndLength(
                                new_elements,
                                mode);
       } else {
-        CopyFastElementsToFast(arguments, new_elements, mode);
+        CopyFastElementsToFast(arguments, new_elements);
       }
       parameter_map->set(1, new_elements);
       break;
@@ -9066,7 +9630,7 @@ MaybeObject* JSObject::SetFastElement(uint32_t index,
   // a transition to slow elements is necessary.
   if (index >= capacity) {
     bool convert_to_slow = true;
-    if ((index - capacity) < kMaxGap) {
+    if (IsAcceptableElementsGap(index, capacity)) {
       new_capacity = NewElementsCapacity(index + 1);
       ASSERT(new_capacity > index);
       if (!ShouldConvertToSlowElements(new_capacity)) {
@@ -9291,7 +9855,7 @@ MUST_USE_RESULT MaybeObject* JSObject::SetFastDoubleElement(
   }
 
   // Allow gap in fast case.
-  if ((index - elms_length) < kMaxGap) {
+  if (IsAcceptableElementsGap(index, elms_length)) {
     // Try allocating extra space.
     int new_capacity = NewElementsCapacity(index+1);
     if (!ShouldConvertToSlowElements(new_capacity)) {
@@ -9762,6 +10326,16 @@ InterceptorInfo* JSObject::GetIndexedInterceptor() {
 }
 
 
+bool InterceptorInfo::Intercepts(String* name) {
+  if (keys()->IsUndefined()) return true;
+  FixedArray* names = FixedArray::cast(keys());
+  for (int i = 0; i < names->length(); i++) {
+    if (name->Equals(String::cast(names->get(i)))) return true;
+  }
+  return false;
+}
+
+
 MaybeObject* JSObject::GetPropertyPostInterceptor(
     JSReceiver* receiver,
     String* name,
@@ -10396,10 +10970,13 @@ class RegExpKey : public HashTableKey {
 // Utf8SymbolKey carries a vector of chars as key.
 class Utf8SymbolKey : public HashTableKey {
  public:
-  explicit Utf8SymbolKey(Vector<const char> string)
-      : string_(string), hash_field_(0) { }
+  Utf8SymbolKey(Vector<const char> string, uint32_t seed)
+      : string_(string), hash_field_(0), seed_(seed) { }
 
   bool IsMatch(Object* string) {
+    // Symbols with a different hash cannot match, which saves comparing
+    // the characters of colliding symbols.
+    if (String::cast(string)->hash_field() != hash_field_) return false;
     return String::cast(string)->IsEqualTo(string_);
   }
 
@@ -10408,7 +10985,7 @@ class Utf8SymbolKey : public HashTableKey {
     unibrow::Utf8InputBuffer<> buffer(string_.start(),
                                       static_cast<unsigned>(string_.length()));
     chars_ = buffer.Length();
-    hash_field_ = String::ComputeHashField(&buffer, chars_);
+    hash_field_ = String::ComputeHashField(&buffer, chars_, seed_);
     uint32_t result = hash_field_ >> String::kHashShift;
     ASSERT(result != 0);  // Ensure that the hash value of 0 is never computed.
     return result;
@@ -10427,17 +11004,18 @@ class Utf8SymbolKey : public HashTableKey {
   Vector<const char> string_;
   uint32_t hash_field_;
   int chars_;  // Caches the number of characters when computing the hash code.
+  uint32_t seed_;
 };
 
 
 template <typename Char>
 class SequentialSymbolKey : public HashTableKey {
  public:
-  explicit SequentialSymbolKey(Vector<const Char> string)
-      : string_(string), hash_field_(0) { }
+  SequentialSymbolKey(Vector<const Char> string, uint32_t seed)
+      : string_(string), hash_field_(0), seed_(seed) { }
 
   uint32_t Hash() {
-    StringHasher hasher(string_.length());
+    StringHasher hasher(string_.length(), seed_);
 
     // Very long strings have a trivial hash that doesn't inspect the
     // string contents.
@@ -10471,19 +11049,27 @@ class SequentialSymbolKey : public HashTableKey {
     return String::cast(other)->Hash();
   }
 
+  // Symbols with a different hash cannot match, which saves comparing the
+  // characters of colliding symbols.
+  bool HashMatches(Object* string) {
+    return String::cast(string)->hash_field() == hash_field_;
+  }
+
   Vector<const Char> string_;
   uint32_t hash_field_;
+  uint32_t seed_;
 };
 
 
 
 class AsciiSymbolKey : public SequentialSymbolKey<char> {
  public:
-  explicit AsciiSymbolKey(Vector<const char> str)
-      : SequentialSymbolKey<char>(str) { }
+  AsciiSymbolKey(Vector<const char> str, uint32_t seed)
+      : SequentialSymbolKey<char>(str, seed) { }
 
   bool IsMatch(Object* string) {
-    return String::cast(string)->IsAsciiEqualTo(string_);
+    return HashMatches(string) &&
+        String::cast(string)->IsAsciiEqualTo(string_);
   }
 
   MaybeObject* AsObject() {
@@ -10495,15 +11081,16 @@ class AsciiSymbolKey : public SequentialSymbolKey<char> {
 
 class SubStringAsciiSymbolKey : public HashTableKey {
  public:
-  explicit SubStringAsciiSymbolKey(Handle<SeqAsciiString> string,
-                                   int from,
-                                   int length)
-      : string_(string), from_(from), length_(length) { }
+  SubStringAsciiSymbolKey(Handle<SeqAsciiString> string,
+                          int from,
+                          int length,
+                          uint32_t seed)
+      : string_(string), from_(from), length_(length), seed_(seed) { }
 
   uint32_t Hash() {
     ASSERT(length_ >= 0);
     ASSERT(from_ + length_ <= string_->length());
-    StringHasher hasher(length_);
+    StringHasher hasher(length_, seed_);
 
     // Very long strings have a trivial hash that doesn't inspect the
     // string contents.
@@ -10540,6 +11127,8 @@ class SubStringAsciiSymbolKey : public HashTableKey {
   }
 
   bool IsMatch(Object* string) {
+    // Symbols with a different hash cannot match.
+    if (String::cast(string)->hash_field() != hash_field_) return false;
     Vector<const char> chars(string_->GetChars() + from_, length_);
     return String::cast(string)->IsAsciiEqualTo(chars);
   }
@@ -10555,16 +11144,18 @@ class SubStringAsciiSymbolKey : public HashTableKey {
   int from_;
   int length_;
   uint32_t hash_field_;
+  uint32_t seed_;
 };
 
 
 class TwoByteSymbolKey : public SequentialSymbolKey<uc16> {
  public:
-  explicit TwoByteSymbolKey(Vector<const uc16> str)
-      : SequentialSymbolKey<uc16>(str) { }
+  TwoByteSymbolKey(Vector<const uc16> str, uint32_t seed)
+      : SequentialSymbolKey<uc16>(str, seed) { }
 
   bool IsMatch(Object* string) {
-    return String::cast(string)->IsTwoByteEqualTo(string_);
+    return HashMatches(string) &&
+        String::cast(string)->IsTwoByteEqualTo(string_);
   }
 
   MaybeObject* AsObject() {
@@ -10691,6 +11282,28 @@ int StringDictionary::FindEntry(String* key) {
 }
 
 
+template<typename Shape, typename Key>
+uint32_t HashTable<Shape, Key>::HashForEntry(Key key, int entry) {
+  return Shape::HashForObject(key, KeyAt(entry));
+}
+
+
+template<>
+uint32_t HashTable<ObjectHashTableShape<1>, Object*>::HashForEntry(
+    Object* key, int entry) {
+  int index = EntryToIndex(entry) + ObjectHashTableShape<1>::kHashOffset;
+  return Smi::cast(get(index))->value();
+}
+
+
+template<>
+uint32_t HashTable<ObjectHashTableShape<2>, Object*>::HashForEntry(
+    Object* key, int entry) {
+  int index = EntryToIndex(entry) + ObjectHashTableShape<2>::kHashOffset;
+  return Smi::cast(get(index))->value();
+}
+
+
 template<typename Shape, typename Key>
 MaybeObject* HashTable<Shape, Key>::Rehash(HashTable* new_table, Key key) {
   ASSERT(NumberOfElements() < new_table->Capacity());
@@ -10711,7 +11324,7 @@ MaybeObject* HashTable<Shape, Key>::Rehash(HashTable* new_table, Key key) {
     uint32_t from_index = EntryToIndex(i);
     Object* k = get(from_index);
     if (IsKey(k)) {
-      uint32_t hash = Shape::HashForObject(key, k);
+      uint32_t hash = HashForEntry(key, i);
       uint32_t insertion_index =
           EntryToIndex(new_table->FindInsertionEntry(hash));
       for (int j = 0; j < Shape::kEntrySize; j++) {
@@ -11346,10 +11959,12 @@ MaybeObject* SymbolTable::LookupString(String* string, Object** s) {
 // algorithm.
 class TwoCharHashTableKey : public HashTableKey {
  public:
-  TwoCharHashTableKey(uint32_t c1, uint32_t c2)
+  TwoCharHashTableKey(uint32_t c1, uint32_t c2, uint32_t seed)
     : c1_(c1), c2_(c2) {
     // Char 1.
-    uint32_t hash = c1 + (c1 << 10);
+    uint32_t hash = seed;
+    hash += c1;
+    hash += hash << 10;
     hash ^= hash >> 6;
     // Char 2.
     hash += c2;
@@ -11361,7 +11976,7 @@ class TwoCharHashTableKey : public HashTableKey {
     hash += hash << 15;
     if (hash == 0) hash = 27;
 #ifdef DEBUG
-    StringHasher hasher(2);
+    StringHasher hasher(2, seed);
     hasher.AddCharacter(c1);
     hasher.AddCharacter(c2);
     // If this assert fails then we failed to reproduce the two-character
@@ -11418,7 +12033,7 @@ bool SymbolTable::LookupSymbolIfExists(String* string, String** symbol) {
 bool SymbolTable::LookupTwoCharsSymbolIfExists(uint32_t c1,
                                                uint32_t c2,
                                                String** symbol) {
-  TwoCharHashTableKey key(c1, c2);
+  TwoCharHashTableKey key(c1, c2, GetHeap()->HashSeed());
   int entry = FindEntry(&key);
   if (entry == kNotFound) {
     return false;
@@ -11432,14 +12047,14 @@ bool SymbolTable::LookupTwoCharsSymbolIfExists(uint32_t c1,
 
 
 MaybeObject* SymbolTable::LookupSymbol(Vector<const char> str, Object** s) {
-  Utf8SymbolKey key(str);
+  Utf8SymbolKey key(str, GetHeap()->HashSeed());
   return LookupKey(&key, s);
 }
 
 
 MaybeObject* SymbolTable::LookupAsciiSymbol(Vector<const char> str,
                                             Object** s) {
-  AsciiSymbolKey key(str);
+  AsciiSymbolKey key(str, GetHeap()->HashSeed());
   return LookupKey(&key, s);
 }
 
@@ -11448,14 +12063,14 @@ MaybeObject* SymbolTable::LookupSubStringAsciiSymbol(Handle<SeqAsciiString> str,
                                                      int from,
                                                      int length,
                                                      Object** s) {
-  SubStringAsciiSymbolKey key(str, from, length);
+  SubStringAsciiSymbolKey key(str, from, length, GetHeap()->HashSeed());
   return LookupKey(&key, s);
 }
 
 
 MaybeObject* SymbolTable::LookupTwoByteSymbol(Vector<const uc16> str,
                                               Object** s) {
-  TwoByteSymbolKey key(str);
+  TwoByteSymbolKey key(str, GetHeap()->HashSeed());
   return LookupKey(&key, s);
 }
 
@@ -12144,14 +12759,141 @@ MaybeObject* StringDictionary::TransformPropertiesToFastFor(
 }
 
 
+uint32_t StringDictionary::KeySetHash() {
+  uint32_t hash = NumberOfElements();
+  int capacity = Capacity();
+  for (int i = 0; i < capacity; i++) {
+    Object* k = KeyAt(i);
+    if (IsKey(k)) hash += String::cast(k)->Hash();
+  }
+  return hash;
+}
+
+
+bool StringDictionary::CanTransformPropertiesToFastWith(JSObject* obj,
+                                                        Map* map) {
+  Map* current = obj->map();
+  if (map->constructor() != current->constructor() ||
+      map->prototype() != current->prototype() ||
+      map->instance_type() != current->instance_type() ||
+      map->instance_size() != current->instance_size() ||
+      map->inobject_properties() != current->inobject_properties() ||
+      map->pre_allocated_property_fields() != 0 ||
+      map->bit_field() != current->bit_field() ||
+      map->bit_field2() != current->bit_field2()) {
+    return false;
+  }
+
+  DescriptorArray* descriptors = map->instance_descriptors();
+  int number_of_properties = 0;
+  for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+    if (descriptors->IsProperty(i)) number_of_properties++;
+  }
+  if (number_of_properties != NumberOfElements()) return false;
+
+  int capacity = Capacity();
+  for (int i = 0; i < capacity; i++) {
+    Object* k = KeyAt(i);
+    if (!IsKey(k)) continue;
+    int descriptor = descriptors->Search(String::cast(k));
+    if (descriptor == DescriptorArray::kNotFound) return false;
+    PropertyDetails details = DetailsAt(i);
+    PropertyDetails map_details(descriptors->GetDetails(descriptor));
+    if (details.attributes() != map_details.attributes()) return false;
+    Object* value = ValueAt(i);
+    switch (map_details.type()) {
+      case FIELD:
+        // The dictionary holds no mutable heap numbers for double fields.
+        if (details.type() != NORMAL ||
+            map_details.representation() != TAGGED_FIELD) {
+          return false;
+        }
+        break;
+      case CONSTANT_FUNCTION:
+        if (details.type() != NORMAL ||
+            descriptors->GetConstantFunction(descriptor) != value) {
+          return false;
+        }
+        break;
+      case CALLBACKS:
+        if (details.type() != CALLBACKS ||
+            descriptors->GetCallbacksObject(descriptor) != value) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+
+    // The enumeration order is kept in the descriptors, so the position of
+    // the property among the others has to be the same in both.
+    int dictionary_rank = 0;
+    for (int j = 0; j < capacity; j++) {
+      if (IsKey(KeyAt(j)) && DetailsAt(j).index() < details.index()) {
+        dictionary_rank++;
+      }
+    }
+    int map_rank = 0;
+    for (int j = 0; j < descriptors->number_of_descriptors(); j++) {
+      if (descriptors->IsProperty(j) &&
+          PropertyDetails(descriptors->GetDetails(j)).index() <
+              map_details.index()) {
+        map_rank++;
+      }
+    }
+    if (dictionary_rank != map_rank) return false;
+  }
+  return true;
+}
+
+
+MaybeObject* StringDictionary::TransformPropertiesToFastWith(JSObject* obj,
+                                                             Map* map) {
+  ASSERT(CanTransformPropertiesToFastWith(obj, map));
+  DescriptorArray* descriptors = map->instance_descriptors();
+  int number_of_fields = 0;
+  for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+    if (descriptors->GetType(i) == FIELD) number_of_fields++;
+  }
+  int inobject_props = map->inobject_properties();
+  int number_of_allocated_fields =
+      number_of_fields + map->unused_property_fields() - inobject_props;
+  if (number_of_allocated_fields < 0) number_of_allocated_fields = 0;
+
+  FixedArray* fields;
+  { MaybeObject* maybe_fields =
+        GetHeap()->AllocateFixedArray(number_of_allocated_fields);
+    if (!maybe_fields->To<FixedArray>(&fields)) return maybe_fields;
+  }
+
+  int capacity = Capacity();
+  for (int i = 0; i < capacity; i++) {
+    Object* k = KeyAt(i);
+    if (!IsKey(k)) continue;
+    int descriptor = descriptors->Search(String::cast(k));
+    if (descriptors->GetType(descriptor) != FIELD) continue;
+    int index = descriptors->GetFieldIndex(descriptor);
+    if (index < inobject_props) {
+      obj->InObjectPropertyAtPut(index, ValueAt(i), UPDATE_WRITE_BARRIER);
+    } else {
+      fields->set(index - inobject_props, ValueAt(i));
+    }
+  }
+
+  obj->set_map(map);
+  obj->set_properties(fields);
+  ASSERT(obj->HasFastProperties());
+  return obj;
+}
+
+
 bool ObjectHashSet::Contains(Object* key) {
   ASSERT(IsKey(key));
 
   // If the object does not have an identity hash, it was never used as a key.
-  { MaybeObject* maybe_hash = key->GetHash(OMIT_CREATION);
-    if (maybe_hash->ToObjectUnchecked()->IsUndefined()) return false;
-  }
-  return (FindEntry(key) != kNotFound);
+  Object* hash = key->GetHash(OMIT_CREATION)->ToObjectUnchecked();
+  if (hash->IsUndefined()) return false;
+  return (FindEntry(GetIsolate(), key, Smi::cast(hash)->value()) != kNotFound);
 }
 
 
@@ -12164,7 +12906,7 @@ MaybeObject* ObjectHashSet::Add(Object* key) {
     if (maybe_hash->IsFailure()) return maybe_hash;
     hash = Smi::cast(maybe_hash->ToObjectUnchecked())->value();
   }
-  int entry = FindEntry(key);
+  int entry = FindEntry(GetIsolate(), key, hash);
 
   // Check whether key is already present.
   if (entry != kNotFound) return this;
@@ -12177,6 +12919,8 @@ MaybeObject* ObjectHashSet::Add(Object* key) {
   ObjectHashSet* table = ObjectHashSet::cast(obj);
   entry = table->FindInsertionEntry(hash);
   table->set(EntryToIndex(entry), key);
+  table->set(EntryToIndex(entry) + ObjectHashTableShape<1>::kHashOffset,
+             Smi::FromInt(hash));
   table->ElementAdded();
   return table;
 }
@@ -12186,16 +12930,16 @@ MaybeObject* ObjectHashSet::Remove(Object* key) {
   ASSERT(IsKey(key));
 
   // If the object does not have an identity hash, it was never used as a key.
-  { MaybeObject* maybe_hash = key->GetHash(OMIT_CREATION);
-    if (maybe_hash->ToObjectUnchecked()->IsUndefined()) return this;
-  }
-  int entry = FindEntry(key);
+  Object* hash = key->GetHash(OMIT_CREATION)->ToObjectUnchecked();
+  if (hash->IsUndefined()) return this;
+  int entry = FindEntry(GetIsolate(), key, Smi::cast(hash)->value());
 
   // Check whether key is actually present.
   if (entry == kNotFound) return this;
 
   // Remove entry and try to shrink this hash set.
   set_the_hole(EntryToIndex(entry));
+  set_the_hole(EntryToIndex(entry) + ObjectHashTableShape<1>::kHashOffset);
   ElementRemoved();
   return Shrink(key);
 }
@@ -12205,12 +12949,9 @@ Object* ObjectHashTable::Lookup(Object* key) {
   ASSERT(IsKey(key));
 
   // If the object does not have an identity hash, it was never used as a key.
-  { MaybeObject* maybe_hash = key->GetHash(OMIT_CREATION);
-    if (maybe_hash->ToObjectUnchecked()->IsUndefined()) {
-      return GetHeap()->undefined_value();
-    }
-  }
-  int entry = FindEntry(key);
+  Object* hash = key->GetHash(OMIT_CREATION)->ToObjectUnchecked();
+  if (hash->IsUndefined()) return GetHeap()->undefined_value();
+  int entry = FindEntry(GetIsolate(), key, Smi::cast(hash)->value());
   if (entry == kNotFound) return GetHeap()->undefined_value();
   return get(EntryToIndex(entry) + 1);
 }
@@ -12225,7 +12966,7 @@ MaybeObject* ObjectHashTable::Put(Object* key, Object* value) {
     if (maybe_hash->IsFailure()) return maybe_hash;
     hash = Smi::cast(maybe_hash->ToObjectUnchecked())->value();
   }
-  int entry = FindEntry(key);
+  int entry = FindEntry(GetIsolate(), key, hash);
 
   // Check whether to perform removal operation.
   if (value->IsUndefined()) {
@@ -12246,14 +12987,19 @@ MaybeObject* ObjectHashTable::Put(Object* key, Object* value) {
     if (!maybe_obj->ToObject(&obj)) return maybe_obj;
   }
   ObjectHashTable* table = ObjectHashTable::cast(obj);
-  table->AddEntry(table->FindInsertionEntry(hash), key, value);
+  table->AddEntry(table->FindInsertionEntry(hash), key, value, hash);
   return table;
 }
 
 
-void ObjectHashTable::AddEntry(int entry, Object* key, Object* value) {
+void ObjectHashTable::AddEntry(int entry,
+                               Object* key,
+                               Object* value,
+                               int hash) {
   set(EntryToIndex(entry), key);
   set(EntryToIndex(entry) + 1, value);
+  set(EntryToIndex(entry) + ObjectHashTableShape<2>::kHashOffset,
+      Smi::FromInt(hash));
   ElementAdded();
 }
 
@@ -12261,10 +13007,264 @@ void ObjectHashTable::AddEntry(int entry, Object* key, Object* value) {
 void ObjectHashTable::RemoveEntry(int entry) {
   set_the_hole(EntryToIndex(entry));
   set_the_hole(EntryToIndex(entry) + 1);
+  set_the_hole(EntryToIndex(entry) + ObjectHashTableShape<2>::kHashOffset);
   ElementRemoved();
 }
 
 
+MaybeObject* OrderedHashTable::Allocate(int at_least_space_for) {
+  int capacity = RoundUpToPowerOf2(Max(at_least_space_for, kMinCapacity));
+  int buckets = capacity / kLoadFactor;
+  Object* obj;
+  { MaybeObject* maybe_obj = HEAP->AllocateFixedArray(
+        kHashTableStartIndex + buckets + capacity * kEntrySize);
+    if (!maybe_obj->ToObject(&obj)) return maybe_obj;
+  }
+  OrderedHashTable* table = OrderedHashTable::cast(obj);
+  for (int i = 0; i < buckets; i++) {
+    table->set(kHashTableStartIndex + i, Smi::FromInt(kNotFound));
+  }
+  table->SetNumberOfElements(0);
+  table->SetNumberOfDeletedElements(0);
+  table->set(kNumberOfBucketsIndex, Smi::FromInt(buckets));
+  return table;
+}
+
+
+int OrderedHashTable::FindEntry(Object* key) {
+  // If the object does not have an identity hash, it was never used as a key.
+  Object* hash = key->GetHash(OMIT_CREATION)->ToObjectUnchecked();
+  if (hash->IsUndefined()) return kNotFound;
+  int bucket = Smi::cast(hash)->value() & (NumberOfBuckets() - 1);
+  int entry = Smi::cast(get(kHashTableStartIndex + bucket))->value();
+  while (entry != kNotFound) {
+    Object* candidate = KeyAt(entry);
+    if (!candidate->IsTheHole() && candidate->SameValue(key)) return entry;
+    entry = ChainAt(entry);
+  }
+  return kNotFound;
+}
+
+
+Object* OrderedHashTable::Lookup(Object* key) {
+  int entry = FindEntry(key);
+  if (entry == kNotFound) return GetHeap()->undefined_value();
+  return ValueAt(entry);
+}
+
+
+MaybeObject* OrderedHashTable::Put(Object* key, Object* value) {
+  // Make sure the key object has an identity hash code.
+  int hash;
+  { MaybeObject* maybe_hash = key->GetHash(ALLOW_CREATION);
+    if (maybe_hash->IsFailure()) return maybe_hash;
+    hash = Smi::cast(maybe_hash->ToObjectUnchecked())->value();
+  }
+
+  // Key is already in table, just overwrite value.
+  int entry = FindEntry(key);
+  if (entry != kNotFound) {
+    set(EntryToIndex(entry) + kValueOffset, value);
+    return this;
+  }
+
+  // No free entry is left at the end of the table, so compact it, growing it
+  // if it is more than half full.
+  OrderedHashTable* table = this;
+  if (UsedCapacity() == Capacity()) {
+    int capacity = Capacity();
+    if (NumberOfElements() >= capacity / 2) capacity *= 2;
+    Object* obj;
+    { MaybeObject* maybe_obj = Rehash(capacity);
+      if (!maybe_obj->ToObject(&obj)) return maybe_obj;
+    }
+    table = OrderedHashTable::cast(obj);
+  }
+  table->AddEntry(key, value, hash);
+  return table;
+}
+
+
+MaybeObject* OrderedHashTable::Remove(Object* key) {
+  int entry = FindEntry(key);
+  if (entry == kNotFound) return this;
+
+  // The entry stays in its bucket's chain until the table is rehashed.
+  set_the_hole(EntryToIndex(entry));
+  set_the_hole(EntryToIndex(entry) + kValueOffset);
+  SetNumberOfElements(NumberOfElements() - 1);
+  SetNumberOfDeletedElements(NumberOfDeletedElements() + 1);
+
+  // Shrink the table if only a quarter of the capacity is in use.
+  int capacity = Capacity();
+  if (capacity > kMinCapacity && NumberOfElements() < capacity / 4) {
+    return Rehash(capacity / 2);
+  }
+  return this;
+}
+
+
+MaybeObject* OrderedHashTable::Rehash(int capacity) {
+  ASSERT(NumberOfElements() <= capacity);
+  Object* obj;
+  { MaybeObject* maybe_obj = Allocate(capacity);
+    if (!maybe_obj->ToObject(&obj)) return maybe_obj;
+  }
+  OrderedHashTable* new_table = OrderedHashTable::cast(obj);
+  int used = UsedCapacity();
+  for (int i = 0; i < used; i++) {
+    if (!IsLiveEntry(i)) continue;
+    Object* key = KeyAt(i);
+    Object* hash = key->GetHash(OMIT_CREATION)->ToObjectChecked();
+    new_table->AddEntry(key, ValueAt(i), Smi::cast(hash)->value());
+  }
+  return new_table;
+}
+
+
+void OrderedHashTable::AddEntry(Object* key, Object* value, int hash) {
+  int entry = UsedCapacity();
+  ASSERT(entry < Capacity());
+  int bucket_index = kHashTableStartIndex + (hash & (NumberOfBuckets() - 1));
+  int index = EntryToIndex(entry);
+  set(index, key);
+  set(index + kValueOffset, value);
+  set(index + kChainOffset, get(bucket_index));
+  set(bucket_index, Smi::FromInt(entry));
+  SetNumberOfElements(NumberOfElements() + 1);
+}
+
+
+Object* JSDate::GetField(Object* object, Smi* index) {
+  return JSDate::cast(object)->DoGetField(
+      static_cast<FieldIndex>(index->value()));
+}
+
+
+Object* JSDate::DoGetField(FieldIndex index) {
+  ASSERT(index != kDateValue);
+
+  DateCache* date_cache = GetIsolate()->date_cache();
+
+  if (index < kFirstUncachedField) {
+    Object* stamp = cache_stamp();
+    if (stamp != date_cache->stamp() && stamp->IsSmi()) {
+      // Since the stamp is not NaN, the value is also not NaN.
+      int64_t local_time_ms =
+          date_cache->ToLocal(static_cast<int64_t>(value()->Number()));
+      SetLocalFields(local_time_ms, date_cache);
+    }
+    switch (index) {
+      case kYear: return year();
+      case kMonth: return month();
+      case kDay: return day();
+      case kWeekday: return weekday();
+      case kHour: return hour();
+      case kMinute: return min();
+      case kSecond: return sec();
+      default: UNREACHABLE();
+    }
+  }
+
+  if (index >= kFirstUTCField) {
+    return GetUTCField(index, value()->Number(), date_cache);
+  }
+
+  double time = value()->Number();
+  if (isnan(time)) return GetIsolate()->heap()->nan_value();
+
+  int64_t local_time_ms = date_cache->ToLocal(static_cast<int64_t>(time));
+  int days = DateCache::DaysFromTime(local_time_ms);
+
+  if (index == kDays) return Smi::FromInt(days);
+
+  int time_in_day_ms = DateCache::TimeInDay(local_time_ms, days);
+  if (index == kMillisecond) return Smi::FromInt(time_in_day_ms % 1000);
+  ASSERT(index == kTimeInDay);
+  return Smi::FromInt(time_in_day_ms);
+}
+
+
+Object* JSDate::GetUTCField(FieldIndex index,
+                            double value,
+                            DateCache* date_cache) {
+  ASSERT(index >= kFirstUTCField);
+
+  if (isnan(value)) return GetIsolate()->heap()->nan_value();
+
+  int64_t time_ms = static_cast<int64_t>(value);
+
+  if (index == kTimezoneOffset) {
+    return Smi::FromInt(date_cache->TimezoneOffset(time_ms));
+  }
+
+  int days = DateCache::DaysFromTime(time_ms);
+
+  if (index == kWeekdayUTC) return Smi::FromInt(DateCache::Weekday(days));
+
+  if (index <= kDayUTC) {
+    int year, month, day;
+    date_cache->YearMonthDayFromDays(days, &year, &month, &day);
+    if (index == kYearUTC) return Smi::FromInt(year);
+    if (index == kMonthUTC) return Smi::FromInt(month);
+    ASSERT(index == kDayUTC);
+    return Smi::FromInt(day);
+  }
+
+  int time_in_day_ms = DateCache::TimeInDay(time_ms, days);
+  switch (index) {
+    case kHourUTC: return Smi::FromInt(time_in_day_ms / (60 * 60 * 1000));
+    case kMinuteUTC: return Smi::FromInt((time_in_day_ms / (60 * 1000)) % 60);
+    case kSecondUTC: return Smi::FromInt((time_in_day_ms / 1000) % 60);
+    case kMillisecondUTC: return Smi::FromInt(time_in_day_ms % 1000);
+    case kDaysUTC: return Smi::FromInt(days);
+    case kTimeInDayUTC: return Smi::FromInt(time_in_day_ms);
+    default: UNREACHABLE();
+  }
+
+  UNREACHABLE();
+  return NULL;
+}
+
+
+void JSDate::SetValue(Object* value, bool is_value_nan) {
+  set_value(value);
+  if (is_value_nan) {
+    HeapNumber* nan = GetIsolate()->heap()->nan_value();
+    set_cache_stamp(nan, SKIP_WRITE_BARRIER);
+    set_year(nan, SKIP_WRITE_BARRIER);
+    set_month(nan, SKIP_WRITE_BARRIER);
+    set_day(nan, SKIP_WRITE_BARRIER);
+    set_hour(nan, SKIP_WRITE_BARRIER);
+    set_min(nan, SKIP_WRITE_BARRIER);
+    set_sec(nan, SKIP_WRITE_BARRIER);
+    set_weekday(nan, SKIP_WRITE_BARRIER);
+  } else {
+    set_cache_stamp(Smi::FromInt(DateCache::kInvalidStamp), SKIP_WRITE_BARRIER);
+  }
+}
+
+
+void JSDate::SetLocalFields(int64_t local_time_ms, DateCache* date_cache) {
+  int days = DateCache::DaysFromTime(local_time_ms);
+  int time_in_day_ms = DateCache::TimeInDay(local_time_ms, days);
+  int year, month, day;
+  date_cache->YearMonthDayFromDays(days, &year, &month, &day);
+  int weekday = DateCache::Weekday(days);
+  int hour = time_in_day_ms / (60 * 60 * 1000);
+  int min = (time_in_day_ms / (60 * 1000)) % 60;
+  int sec = (time_in_day_ms / 1000) % 60;
+  set_cache_stamp(date_cache->stamp());
+  set_year(Smi::FromInt(year), SKIP_WRITE_BARRIER);
+  set_month(Smi::FromInt(month), SKIP_WRITE_BARRIER);
+  set_day(Smi::FromInt(day), SKIP_WRITE_BARRIER);
+  set_weekday(Smi::FromInt(weekday), SKIP_WRITE_BARRIER);
+  set_hour(Smi::FromInt(hour), SKIP_WRITE_BARRIER);
+  set_min(Smi::FromInt(min), SKIP_WRITE_BARRIER);
+  set_sec(Smi::FromInt(sec), SKIP_WRITE_BARRIER);
+}
+
+
 #ifdef ENABLE_DEBUGGER_SUPPORT
 // Check if there is a break point at this code position.
 bool DebugInfo::HasBreakPoint(int code_position) {
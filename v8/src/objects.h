@@ -64,6 +64,7 @@
 //             - JSBuiltinsObject
 //           - JSGlobalProxy
 //           - JSValue
+//           - JSDate
 //           - JSMessageObject
 //         - JSProxy
 //           - JSFunctionProxy
@@ -119,6 +120,8 @@
 //         - DebugInfo
 //         - BreakPointInfo
 //         - CodeCache
+//         - Atom
+//         - StringBuffer
 //
 // Formats of Object*:
 //  Smi:        [31 bit signed int] 0
@@ -181,6 +184,15 @@ enum PropertyNormalizationMode {
 };
 
 
+// DoubleFieldMode is used to specify whether a property added with a number
+// value may become a double field.  Literal boilerplates are copied field by
+// field, so their properties must not.
+enum DoubleFieldMode {
+  ALLOW_DOUBLE_FIELD,
+  OMIT_DOUBLE_FIELD
+};
+
+
 // NormalizedMapSharingMode is used to specify whether a map may be shared
 // by different objects with normalized properties.
 enum NormalizedMapSharingMode {
@@ -253,6 +265,7 @@ const int kVariableSizeSentinel = 0;
   V(JS_GLOBAL_PROPERTY_CELL_TYPE)                                              \
                                                                                \
   V(HEAP_NUMBER_TYPE)                                                          \
+  V(BIG_INTEGER_TYPE)                                                          \
   V(FOREIGN_TYPE)                                                              \
   V(BYTE_ARRAY_TYPE)                                                           \
   V(FREE_SPACE_TYPE)                                                           \
@@ -280,6 +293,8 @@ const int kVariableSizeSentinel = 0;
   V(SCRIPT_TYPE)                                                               \
   V(CODE_CACHE_TYPE)                                                           \
   V(POLYMORPHIC_CODE_CACHE_TYPE)                                               \
+  V(ATOM_TYPE)                                                                 \
+  V(STRING_BUFFER_TYPE)                                                        \
                                                                                \
   V(FIXED_ARRAY_TYPE)                                                          \
   V(FIXED_DOUBLE_ARRAY_TYPE)                                                   \
@@ -288,6 +303,7 @@ const int kVariableSizeSentinel = 0;
   V(JS_MESSAGE_OBJECT_TYPE)                                                    \
                                                                                \
   V(JS_VALUE_TYPE)                                                             \
+  V(JS_DATE_TYPE)                                                              \
   V(JS_OBJECT_TYPE)                                                            \
   V(JS_CONTEXT_EXTENSION_OBJECT_TYPE)                                          \
   V(JS_GLOBAL_OBJECT_TYPE)                                                     \
@@ -426,7 +442,9 @@ const int kVariableSizeSentinel = 0;
   V(TYPE_SWITCH_INFO, TypeSwitchInfo, type_switch_info)                        \
   V(SCRIPT, Script, script)                                                    \
   V(CODE_CACHE, CodeCache, code_cache)                                         \
-  V(POLYMORPHIC_CODE_CACHE, PolymorphicCodeCache, polymorphic_code_cache)
+  V(POLYMORPHIC_CODE_CACHE, PolymorphicCodeCache, polymorphic_code_cache)      \
+  V(ATOM, Atom, atom)                                                          \
+  V(STRING_BUFFER, StringBuffer, string_buffer)
 
 #ifdef ENABLE_DEBUGGER_SUPPORT
 #define STRUCT_LIST_DEBUGGER(V)                                                \
@@ -553,6 +571,7 @@ enum InstanceType {
   // "Data", objects that cannot contain non-map-word pointers to heap
   // objects.
   HEAP_NUMBER_TYPE,
+  BIG_INTEGER_TYPE,
   FOREIGN_TYPE,
   BYTE_ARRAY_TYPE,
   FREE_SPACE_TYPE,
@@ -580,6 +599,8 @@ enum InstanceType {
   SCRIPT_TYPE,
   CODE_CACHE_TYPE,
   POLYMORPHIC_CODE_CACHE_TYPE,
+  ATOM_TYPE,
+  STRING_BUFFER_TYPE,
   // The following two instance types are only used when ENABLE_DEBUGGER_SUPPORT
   // is defined. However as include/v8.h contain some of the instance type
   // constants always having them avoids them getting different numbers
@@ -601,6 +622,7 @@ enum InstanceType {
   JS_PROXY_TYPE,  // LAST_JS_PROXY_TYPE
 
   JS_VALUE_TYPE,  // FIRST_JS_OBJECT_TYPE
+  JS_DATE_TYPE,
   JS_OBJECT_TYPE,
   JS_CONTEXT_EXTENSION_OBJECT_TYPE,
   JS_GLOBAL_OBJECT_TYPE,
@@ -754,6 +776,8 @@ class MaybeObject BASE_EMBEDDED {
 
 #define HEAP_OBJECT_TYPE_LIST(V)               \
   V(HeapNumber)                                \
+  V(MutableHeapNumber)                         \
+  V(BigInteger)                                \
   V(String)                                    \
   V(Symbol)                                    \
   V(SeqString)                                 \
@@ -794,6 +818,7 @@ class MaybeObject BASE_EMBEDDED {
   V(Oddball)                                   \
   V(SharedFunctionInfo)                        \
   V(JSValue)                                   \
+  V(JSDate)                                    \
   V(JSMessageObject)                           \
   V(StringWrapper)                             \
   V(Foreign)                                   \
@@ -1644,6 +1669,16 @@ class JSObject: public JSReceiver {
     return old_capacity + (old_capacity >> 1) + 16;
   }
 
+  // Tells whether a store at index may extend fast elements of the given
+  // capacity instead of normalizing them. Besides the absolute kMaxGap,
+  // large backing stores tolerate a gap proportional to their size, so a
+  // single outlier does not turn a big dense array into a dictionary.
+  static bool IsAcceptableElementsGap(uint32_t index, uint32_t capacity) {
+    ASSERT(index >= capacity);
+    uint32_t gap = index - capacity;
+    return gap < kMaxGap || gap < (capacity >> kRelativeMaxGapShift);
+  }
+
   // Tells whether the index'th element is present and how it is stored.
   enum LocalElementType {
     // There is no element with given index.
@@ -1815,10 +1850,25 @@ class JSObject: public JSReceiver {
       Object* new_value,
       PropertyAttributes attributes);
 
+  // Defines a method on a prototype object.  Unlike an ordinary property
+  // store, redefining a constant function keeps it constant and moves the
+  // object to a fresh map, so only ICs and optimized code that depend on
+  // the old map miss or deoptimize, and the new method can be inlined
+  // again.  After Map::kMaxMethodRedefinitions this falls back to a field.
+  MUST_USE_RESULT MaybeObject* DefineMethod(String* name,
+                                            JSFunction* function);
+
+  // Replaces an existing constant function descriptor on a new map.
+  MUST_USE_RESULT MaybeObject* ReplaceConstantFunction(
+      String* name,
+      JSFunction* function,
+      PropertyAttributes attributes);
+
   // Add a property to a fast-case object.
   MUST_USE_RESULT MaybeObject* AddFastProperty(String* name,
                                                Object* value,
-                                               PropertyAttributes attributes);
+                                               PropertyAttributes attributes,
+                                               DoubleFieldMode mode);
 
   // Add a property to a slow-case object.
   MUST_USE_RESULT MaybeObject* AddSlowProperty(String* name,
@@ -1826,10 +1876,12 @@ class JSObject: public JSReceiver {
                                                PropertyAttributes attributes);
 
   // Add a property to an object.
-  MUST_USE_RESULT MaybeObject* AddProperty(String* name,
-                                           Object* value,
-                                           PropertyAttributes attributes,
-                                           StrictModeFlag strict_mode);
+  MUST_USE_RESULT MaybeObject* AddProperty(
+      String* name,
+      Object* value,
+      PropertyAttributes attributes,
+      StrictModeFlag strict_mode,
+      DoubleFieldMode mode = ALLOW_DOUBLE_FIELD);
 
   // Convert the object to use the canonical dictionary
   // representation. If the object is expected to have additional properties
@@ -1854,10 +1906,29 @@ class JSObject: public JSReceiver {
   MUST_USE_RESULT MaybeObject* TransformToFastProperties(
       int unused_property_fields);
 
+  // Transforms a normalized object whose properties have been read often
+  // without changing shape. Objects with the same shape share a map through
+  // the global context's fast properties map cache.
+  MUST_USE_RESULT MaybeObject* TransformToFastPropertiesAfterReads();
+
   // Access fast-case object properties at index.
   inline Object* FastPropertyAt(int index);
   inline Object* FastPropertyAtPut(int index, Object* value);
 
+  // Returns the value of the fast-case property at index.  Unlike
+  // FastPropertyAt it copies the mutable heap number of a double field,
+  // which must not escape from the object.
+  MUST_USE_RESULT inline MaybeObject* FastPropertyValueAt(int index);
+
+  // Stores the value of the fast-case property name, whose field at index
+  // has the given representation.  Numbers are stored in the mutable heap
+  // number of a double field.  Other values turn it into a mixed field.
+  MUST_USE_RESULT MaybeObject* SetFieldValue(
+      String* name,
+      int index,
+      FieldRepresentation representation,
+      Object* value);
+
   // Access to in object properties.
   inline int GetInObjectPropertyOffset(int index);
   inline Object* InObjectPropertyAt(int index);
@@ -1956,6 +2027,10 @@ class JSObject: public JSReceiver {
   // the current elements length.
   static const uint32_t kMaxGap = 1024;
 
+  // Gap relative to the current capacity (1/8th) that can be introduced
+  // when adding an element beyond the elements length.
+  static const int kRelativeMaxGapShift = 3;
+
   // Maximal length of fast elements array that won't be checked for
   // being dense enough on expansion.
   static const int kMaxUncheckedFastElementsLength = 5000;
@@ -1966,6 +2041,7 @@ class JSObject: public JSReceiver {
 
   static const int kInitialMaxFastElementArray = 100000;
   static const int kMaxFastProperties = 12;
+  static const int kFastPropertiesMapCacheEntries = 64;
   static const int kMaxInstanceSize = 255 * kPointerSize;
   // When extending the backing storage for property values, we increase
   // its size by more than the 1 entry necessary, so sequentially adding fields
@@ -2321,6 +2397,7 @@ class DescriptorArray: public FixedArray {
   inline String* GetKey(int descriptor_number);
   inline Object* GetValue(int descriptor_number);
   inline Smi* GetDetails(int descriptor_number);
+  inline void SetDetails(int descriptor_number, PropertyDetails details);
   inline PropertyType GetType(int descriptor_number);
   inline int GetFieldIndex(int descriptor_number);
   inline JSFunction* GetConstantFunction(int descriptor_number);
@@ -2599,6 +2676,8 @@ class HashTable: public FixedArray {
   // Find entry for key otherwise return kNotFound.
   inline int FindEntry(Key key);
   int FindEntry(Isolate* isolate, Key key);
+  // As above, for a key whose hash has already been computed.
+  int FindEntry(Isolate* isolate, Key key, uint32_t hash);
 
  protected:
   // Find the entry at which to insert element with the given key that
@@ -2645,6 +2724,9 @@ class HashTable: public FixedArray {
     return (last + number) & (size - 1);
   }
 
+  // Returns the hash of the key stored in the given entry.
+  uint32_t HashForEntry(Key key, int entry);
+
   // Rehashes this hash-table into the new table.
   MUST_USE_RESULT MaybeObject* Rehash(HashTable* new_table, Key key);
 
@@ -2915,9 +2997,34 @@ class StringDictionary: public Dictionary<StringDictionaryShape, String*> {
       JSObject* obj,
       int unused_property_fields);
 
+  // Transforms the properties of obj to fast properties described by map,
+  // which must have been accepted by CanTransformPropertiesToFastWith.
+  MUST_USE_RESULT MaybeObject* TransformPropertiesToFastWith(JSObject* obj,
+                                                             Map* map);
+
+  // Tells whether map describes exactly the properties in this dictionary,
+  // in the same enumeration order, for an object that currently has the
+  // map of obj.
+  bool CanTransformPropertiesToFastWith(JSObject* obj, Map* map);
+
+  // Hash of the set of keys, independent of their order.
+  uint32_t KeySetHash();
+
   // Find entry for key, otherwise return kNotFound. Optimized version of
   // HashTable::FindEntry.
   int FindEntry(String* key);
+
+  // The load IC for normalized objects counts reads in the otherwise unused
+  // max number key slot. The count is reset when a property is added or
+  // deleted so that objects that have stopped changing shape can go back to
+  // fast properties. The slot holds undefined when reads are not counted.
+  inline void ResetReadCount();
+  inline void StopCountingReads();
+  inline bool HasReachedReadCount(int count);
+
+  static const int kReadCountIndex = kMaxNumberKeyIndex;
+  static const int kReadCountOffset =
+      FixedArray::kHeaderSize + kReadCountIndex * kPointerSize;
 };
 
 
@@ -2981,7 +3088,10 @@ class ObjectHashTableShape {
   static inline uint32_t HashForObject(Object* key, Object* object);
   MUST_USE_RESULT static inline MaybeObject* AsObject(Object* key);
   static const int kPrefixSize = 0;
-  static const int kEntrySize = entrysize;
+  // The identity hash of the key is kept as a smi after the key and value,
+  // so rehashing does not have to look it up in every key object again.
+  static const int kHashOffset = entrysize;
+  static const int kEntrySize = entrysize + 1;
 };
 
 
@@ -3025,7 +3135,7 @@ class ObjectHashTable: public HashTable<ObjectHashTableShape<2>, Object*> {
  private:
   friend class MarkCompactCollector;
 
-  void AddEntry(int entry, Object* key, Object* value);
+  void AddEntry(int entry, Object* key, Object* value, int hash);
   void RemoveEntry(int entry);
 
   // Returns the index to the value of an entry.
@@ -3035,6 +3145,99 @@ class ObjectHashTable: public HashTable<ObjectHashTableShape<2>, Object*> {
 };
 
 
+// OrderedHashTable maps keys that are arbitrary objects to object values
+// like ObjectHashTable, but keeps its entries in insertion order so they can
+// be iterated in that order. It backs the Harmony Map and Set. Entries are
+// appended to the table and chained from the hash buckets; removed entries
+// are left as holes until the table is rehashed. Its layout is:
+//   [0]: number of elements
+//   [1]: number of deleted elements
+//   [2]: number of buckets
+//   [3 .. 3 + number of buckets): first entry of each bucket (smi)
+//   followed by 2 * number of buckets entries of (key, value, next entry).
+class OrderedHashTable: public FixedArray {
+ public:
+  static inline OrderedHashTable* cast(Object* obj) {
+    ASSERT(obj->IsFixedArray());
+    return reinterpret_cast<OrderedHashTable*>(obj);
+  }
+
+  MUST_USE_RESULT static MaybeObject* Allocate(int at_least_space_for);
+
+  int NumberOfElements() {
+    return Smi::cast(get(kNumberOfElementsIndex))->value();
+  }
+
+  int NumberOfDeletedElements() {
+    return Smi::cast(get(kNumberOfDeletedElementsIndex))->value();
+  }
+
+  int NumberOfBuckets() {
+    return Smi::cast(get(kNumberOfBucketsIndex))->value();
+  }
+
+  int Capacity() { return NumberOfBuckets() * kLoadFactor; }
+
+  // Entries below this bound are in use or deleted, in insertion order.
+  int UsedCapacity() {
+    return NumberOfElements() + NumberOfDeletedElements();
+  }
+
+  Object* KeyAt(int entry) { return get(EntryToIndex(entry)); }
+  Object* ValueAt(int entry) { return get(EntryToIndex(entry) + kValueOffset); }
+
+  // Tells whether the entry has not been removed.
+  bool IsLiveEntry(int entry) { return !KeyAt(entry)->IsTheHole(); }
+
+  // Returns the entry for the key or kNotFound.
+  int FindEntry(Object* key);
+
+  // Looks up the value associated with the given key. The undefined value is
+  // returned in case the key is not present.
+  Object* Lookup(Object* key);
+
+  // Adds (or overwrites) the value associated with the given key.
+  MUST_USE_RESULT MaybeObject* Put(Object* key, Object* value);
+
+  // Removes the entry for the given key, if there is one.
+  MUST_USE_RESULT MaybeObject* Remove(Object* key);
+
+  static const int kNotFound = -1;
+  static const int kMinCapacity = 4;
+
+ private:
+  // Copies the live entries in order to a new table with the given capacity.
+  MUST_USE_RESULT MaybeObject* Rehash(int capacity);
+
+  void AddEntry(Object* key, Object* value, int hash);
+
+  int EntryToIndex(int entry) {
+    return kHashTableStartIndex + NumberOfBuckets() + entry * kEntrySize;
+  }
+
+  int ChainAt(int entry) {
+    return Smi::cast(get(EntryToIndex(entry) + kChainOffset))->value();
+  }
+
+  void SetNumberOfElements(int nof) {
+    set(kNumberOfElementsIndex, Smi::FromInt(nof));
+  }
+
+  void SetNumberOfDeletedElements(int nod) {
+    set(kNumberOfDeletedElementsIndex, Smi::FromInt(nod));
+  }
+
+  static const int kNumberOfElementsIndex = 0;
+  static const int kNumberOfDeletedElementsIndex = 1;
+  static const int kNumberOfBucketsIndex = 2;
+  static const int kHashTableStartIndex = 3;
+  static const int kValueOffset = 1;
+  static const int kChainOffset = 2;
+  static const int kEntrySize = 3;
+  static const int kLoadFactor = 2;
+};
+
+
 // JSFunctionResultCache caches results of some JSFunction invocation.
 // It is a fixed array with fixed structure:
 //   [0]: factory function
@@ -3307,6 +3510,7 @@ class ByteArray: public FixedArrayBase {
 
   // Treat contents as an int array.
   inline int get_int(int index);
+  inline void set_int(int index, int value);
 
   static int SizeFor(int length) {
     return OBJECT_POINTER_ALIGN(kHeaderSize + length);
@@ -3357,6 +3561,74 @@ class ByteArray: public FixedArrayBase {
 };
 
 
+// BigInteger holds an integer outside the smi range exactly, as a sign and
+// a magnitude of 32-bit digits, least significant digit first.  Integers
+// in the smi range are always smis, and the most significant digit is never
+// zero.  The layout matches ByteArray, whose length is the payload size in
+// bytes, so the garbage collector treats both alike.
+class BigInteger: public FixedArrayBase {
+ public:
+  inline int digit_count();
+  inline uint32_t digit(int index);
+  inline void set_digit(int index, uint32_t value);
+
+  inline bool is_negative();
+  inline void set_is_negative(bool value);
+
+  // Exact arithmetic on integers, each of which is a smi or a BigInteger.
+  // The result is a smi if it fits.
+  MUST_USE_RESULT static MaybeObject* Add(Heap* heap, Object* x, Object* y);
+  MUST_USE_RESULT static MaybeObject* Subtract(Heap* heap,
+                                               Object* x,
+                                               Object* y);
+  MUST_USE_RESULT static MaybeObject* Multiply(Heap* heap,
+                                               Object* x,
+                                               Object* y);
+
+  // Returns the value as a double, which may be off by one unit in the
+  // last place because the digits are rounded one at a time.
+  double ToDouble();
+
+  // Returns the decimal representation.
+  MUST_USE_RESULT MaybeObject* ToString();
+
+  // Casting.
+  static inline BigInteger* cast(Object* obj);
+
+  static int LengthFor(int digit_count) {
+    return kDigitsOffset - kHeaderSize + digit_count * kDigitSize;
+  }
+  static int SizeFor(int digit_count) {
+    return OBJECT_POINTER_ALIGN(kDigitsOffset + digit_count * kDigitSize);
+  }
+
+  // Dispatched behavior.
+  inline int BigIntegerSize() {
+    return ByteArray::SizeFor(this->length());
+  }
+#ifdef OBJECT_PRINT
+  inline void BigIntegerPrint() {
+    BigIntegerPrint(stdout);
+  }
+  void BigIntegerPrint(FILE* out);
+#endif
+  void BigIntegerPrint(StringStream* accumulator);
+#ifdef DEBUG
+  void BigIntegerVerify();
+#endif
+
+  // Layout description.
+  static const int kSignOffset = FixedArrayBase::kHeaderSize;
+  static const int kDigitsOffset = kSignOffset + kIntSize;
+  static const int kDigitSize = kIntSize;
+  static const int kMaxDigits =
+      (ByteArray::kMaxLength - (kDigitsOffset - kHeaderSize)) / kDigitSize;
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(BigInteger);
+};
+
+
 // FreeSpace represents fixed sized areas of the heap that are not currently in
 // use.  Used by the heap and GC.
 class FreeSpace: public HeapObject {
@@ -3703,7 +3975,8 @@ class ExternalDoubleArray: public ExternalArray {
 // data for code generated by the Hydrogen/Lithium compiler.  It also
 // contains information about functions that were inlined.  If N different
 // functions were inlined then first N elements of the literal array will
-// contain these functions.
+// contain these functions.  The dependent cell array holds the global
+// property cells embedded in the code.
 //
 // It can be empty.
 class DeoptimizationInputData: public FixedArray {
@@ -3714,7 +3987,8 @@ class DeoptimizationInputData: public FixedArray {
   static const int kLiteralArrayIndex = 2;
   static const int kOsrAstIdIndex = 3;
   static const int kOsrPcOffsetIndex = 4;
-  static const int kFirstDeoptEntryIndex = 5;
+  static const int kDependentCellsIndex = 5;
+  static const int kFirstDeoptEntryIndex = 6;
 
   // Offsets of deopt entry elements relative to the start of the entry.
   static const int kAstIdOffset = 0;
@@ -3737,6 +4011,7 @@ class DeoptimizationInputData: public FixedArray {
   DEFINE_ELEMENT_ACCESSORS(LiteralArray, FixedArray)
   DEFINE_ELEMENT_ACCESSORS(OsrAstId, Smi)
   DEFINE_ELEMENT_ACCESSORS(OsrPcOffset, Smi)
+  DEFINE_ELEMENT_ACCESSORS(DependentCells, FixedArray)
 
   // Unchecked accessor to be used during GC.
   FixedArray* UncheckedLiteralArray() {
@@ -3864,9 +4139,10 @@ class Code: public HeapObject {
 
   static const ExtraICState kNoExtraICState = 0;
 
+  static const char* Kind2String(Kind kind);
+
 #ifdef ENABLE_DISASSEMBLER
   // Printing
-  static const char* Kind2String(Kind kind);
   static const char* ICState2String(InlineCacheState state);
   static const char* PropertyType2String(PropertyType type);
   static void PrintExtraICState(FILE* out, Kind kind, ExtraICState extra);
@@ -3954,6 +4230,12 @@ class Code: public HeapObject {
   inline bool is_compiled_optimizable();
   inline void set_compiled_optimizable(bool value);
 
+  // [has_interrupt_budget]: For FUNCTION kind, tells if its back edges
+  // count down an interrupt budget and call the InterruptStub instead of
+  // checking the stack limit.
+  inline bool has_interrupt_budget();
+  inline void set_has_interrupt_budget(bool value);
+
   // [allow_osr_at_loop_nesting_level]: For FUNCTION kind, tells for
   // how long the function has been marked for OSR and therefore which
   // level of loop nesting we are willing to do on-stack replacement
@@ -3961,6 +4243,11 @@ class Code: public HeapObject {
   inline void set_allow_osr_at_loop_nesting_level(int level);
   inline int allow_osr_at_loop_nesting_level();
 
+  // [profiler_ticks]: For FUNCTION kind, the number of profiler ticks
+  // counted for the function since it was last compiled or optimized.
+  inline int profiler_ticks();
+  inline void set_profiler_ticks(int ticks);
+
   // [stack_slots]: For kind OPTIMIZED_FUNCTION, the number of stack slots
   // reserved in the code prologue.
   inline unsigned stack_slots();
@@ -3971,11 +4258,22 @@ class Code: public HeapObject {
   inline unsigned safepoint_table_offset();
   inline void set_safepoint_table_offset(unsigned offset);
 
+  // [last_used_gc]: For kind OPTIMIZED_FUNCTION, the number of full
+  // garbage collections that had happened when the code was created or
+  // was last found running.
+  inline int last_used_gc();
+  inline void set_last_used_gc(int count);
+
   // [stack_check_table_start]: For kind FUNCTION, the offset in the
   // instruction stream where the stack check table starts.
   inline unsigned stack_check_table_offset();
   inline void set_stack_check_table_offset(unsigned offset);
 
+  // For kind FUNCTION, finds the loop back edge whose stack check returns
+  // to pc.  Returns the OSR entry id of the loop and sets *loop_depth, or
+  // returns AstNode::kNoNumber if pc is not after a back edge stack check.
+  int LookupOsrEntryAt(Address pc, int* loop_depth);
+
   // [check type]: For kind CALL_IC, tells how to check if the
   // receiver is valid for the given call.
   inline CheckType check_type();
@@ -4112,6 +4410,10 @@ class Code: public HeapObject {
   // nesting that is deeper than 5 levels into account.
   static const int kMaxLoopNestingMarker = 6;
 
+  // The stack check table of full code is a length followed by entries of
+  // OSR entry id, pc offset after the stack check and loop depth.
+  static const int kStackCheckTableEntrySize = 3 * kIntSize;
+
   // Layout description.
   static const int kInstructionSizeOffset = HeapObject::kHeaderSize;
   static const int kRelocationInfoOffset = kInstructionSizeOffset + kIntSize;
@@ -4124,7 +4426,7 @@ class Code: public HeapObject {
       kNextCodeFlushingCandidateOffset + kPointerSize;
 
   static const int kKindSpecificFlagsOffset = kFlagsOffset + kIntSize;
-  static const int kKindSpecificFlagsSize = 2 * kIntSize;
+  static const int kKindSpecificFlagsSize = 3 * kIntSize;
 
   static const int kHeaderPaddingStart = kKindSpecificFlagsOffset +
       kKindSpecificFlagsSize;
@@ -4151,12 +4453,15 @@ class Code: public HeapObject {
       public BitField<bool, 0, 1> {};  // NOLINT
   class FullCodeFlagsHasDebugBreakSlotsField: public BitField<bool, 1, 1> {};
   class FullCodeFlagsIsCompiledOptimizable: public BitField<bool, 2, 1> {};
+  class FullCodeFlagsHasInterruptBudget: public BitField<bool, 3, 1> {};
 
   static const int kBinaryOpReturnTypeOffset = kBinaryOpTypeOffset + 1;
 
   static const int kAllowOSRAtLoopNestingLevelOffset = kFullCodeFlags + 1;
+  static const int kProfilerTicksOffset = kAllowOSRAtLoopNestingLevelOffset + 1;
 
   static const int kSafepointTableOffsetOffset = kStackSlotsOffset + kIntSize;
+  static const int kLastUsedGCOffset = kStackSlotsOffset + 2 * kIntSize;
   static const int kStackCheckTableOffsetOffset = kStackSlotsOffset + kIntSize;
 
   // Flags layout.  BitField<type, shift, size>.
@@ -4348,6 +4653,11 @@ class Map: public HeapObject {
 
   inline bool is_shared();
 
+  // The number of constant functions replaced by JSObject::DefineMethod
+  // along the history of this map.
+  inline int method_redefinition_count();
+  inline void set_method_redefinition_count(int value);
+
   // Tells whether the instance needs security checks when accessing its
   // properties.
   inline void set_is_access_check_needed(bool access_check_needed);
@@ -4437,6 +4747,12 @@ class Map: public HeapObject {
   // Locate an accessor in the instance descriptor.
   AccessorDescriptor* FindAccessor(String* name);
 
+  // Turns the double field name into a mixed field in this map and in the
+  // maps of its transition tree, after a value that is not a number was
+  // stored in it.  Drops their code caches, because store stubs compiled for
+  // a double field cannot store such values.
+  void GeneralizeDoubleField(String* name);
+
   // Code cache operations.
 
   // Clears the code cache.
@@ -4617,6 +4933,10 @@ class Map: public HeapObject {
 
   // Bit positions for bit field 3
   static const int kIsShared = 0;
+  class MethodRedefinitionCountField: public BitField<int, 1, 4> {};
+
+  static const int kMaxMethodRedefinitions =
+      MethodRedefinitionCountField::kMax;
 
   // Layout of the default cache. It holds alternating name and code objects.
   static const int kCodeCacheEntrySize = 2;
@@ -4650,7 +4970,8 @@ class Script: public Struct {
   enum Type {
     TYPE_NATIVE = 0,
     TYPE_EXTENSION = 1,
-    TYPE_NORMAL = 2
+    TYPE_NORMAL = 2,
+    TYPE_FRONT_END = 3
   };
 
   // Script compilation types.
@@ -4690,7 +5011,7 @@ class Script: public Struct {
   // [compilation]: how the the script was compiled.
   DECL_ACCESSORS(compilation_type, Smi)
 
-  // [line_ends]: FixedArray of line ends positions.
+  // [line_ends]: compact table of line end positions, see handles.cc.
   DECL_ACCESSORS(line_ends, Object)
 
   // [eval_from_shared]: for eval scripts the shared funcion info for the
@@ -4753,6 +5074,9 @@ class Script: public Struct {
 #define FUNCTIONS_WITH_ID_LIST(V)                   \
   V(Array.prototype, push, ArrayPush)               \
   V(Array.prototype, pop, ArrayPop)                 \
+  V(Array.prototype, forEach, ArrayForEach)         \
+  V(Array.prototype, map, ArrayMap)                 \
+  V(Array.prototype, filter, ArrayFilter)           \
   V(Function.prototype, apply, FunctionApply)       \
   V(String.prototype, charCodeAt, StringCharCodeAt) \
   V(String.prototype, charAt, StringCharAt)         \
@@ -4770,7 +5094,9 @@ class Script: public Struct {
   V(Math, atan, MathATan)                           \
   V(Math, exp, MathExp)                             \
   V(Math, sqrt, MathSqrt)                           \
-  V(Math, pow, MathPow)
+  V(Math, pow, MathPow)                             \
+  V(Math, max, MathMax)                             \
+  V(Math, min, MathMin)
 
 
 enum BuiltinFunctionId {
@@ -4847,9 +5173,19 @@ class SharedFunctionInfo: public HeapObject {
   //   use the adjusted instance size.
   // - Decrease expected_nof_properties so that an allocations made from
   //   another context will use the adjusted instance size too.
+  // - If the slack was more than one field, keep half of it and start
+  //   counting again, so that properties that are only added by later
+  //   constructor calls (for example in a branch of the constructor) still
+  //   get inobject fields.  Since the slack at least halves on every round,
+  //   the tracking ends after a few rounds.
   // - Exit "in progress" state by clearing the reference to the initial_map
   //   and setting the regular construct stub (generic or inline).
   //
+  // After the tracking has ended, an object that still has the initial map
+  // and runs out of inobject fields makes the constructor drop its initial
+  // map, and the next constructor call creates a new initial map with
+  // kFieldsAdded more inobject fields (see JSFunction::GrowInitialMap).
+  //
   //  The above is the main event sequence. Some special cases are possible
   //  while the tracking is in progress:
   //
@@ -4902,6 +5238,11 @@ class SharedFunctionInfo: public HeapObject {
   // IsInobjectSlackTrackingInProgress is false after this call.
   void CompleteInobjectSlackTracking();
 
+  // Called when the construction counter runs out.  Reclaims part of the
+  // slack and restarts the counter, or completes the tracking if at most
+  // one unused field is left.
+  void CompleteInobjectSlackTrackingRound();
+
   // Clears the initial_map before the GC marking phase to ensure the reference
   // is weak. IsInobjectSlackTrackingInProgress is false after this call.
   void DetachInitialMap();
@@ -4987,6 +5328,20 @@ class SharedFunctionInfo: public HeapObject {
   inline Smi* deopt_counter();
   inline void set_deopt_counter(Smi* counter);
 
+  // [deopt_history]: Either undefined or a FixedArray of (ast id, count)
+  // pairs recording how often eager deoptimization happened at each
+  // site of optimized code for this function.
+  DECL_ACCESSORS(deopt_history, Object)
+
+  // [bailout_reasons]: Either undefined or a FixedArray of (reason, count)
+  // pairs recording why and how often the optimizing compiler gave up on
+  // this function, most recent reason first.
+  DECL_ACCESSORS(bailout_reasons, Object)
+
+  // The reason the optimizing compiler last gave up on this function, or
+  // undefined.
+  inline Object* last_bailout_reason();
+
   // Add information on assignments of the form this.x = ...;
   void SetThisPropertyAssignmentsInfo(
       bool has_only_simple_this_property_assignments,
@@ -5059,6 +5414,15 @@ class SharedFunctionInfo: public HeapObject {
   // through the API, which does not change this flag).
   DECL_BOOLEAN_ACCESSORS(is_anonymous)
 
+  // Indicates that a loaded feedback profile recorded this function as
+  // optimized, so the runtime profiler optimizes it on its first sample.
+  DECL_BOOLEAN_ACCESSORS(optimize_from_profile)
+
+  // Indicates that an optimized version of this function was entered through
+  // on-stack replacement, in this run or in the run a loaded feedback profile
+  // was recorded in.
+  DECL_BOOLEAN_ACCESSORS(used_on_stack_replacement)
+
   // Indicates whether or not the code in the shared function support
   // deoptimization.
   inline bool has_deoptimization_support();
@@ -5153,8 +5517,12 @@ class SharedFunctionInfo: public HeapObject {
       kInferredNameOffset + kPointerSize;
   static const int kThisPropertyAssignmentsOffset =
       kInitialMapOffset + kPointerSize;
-  static const int kDeoptCounterOffset =
+  static const int kDeoptHistoryOffset =
       kThisPropertyAssignmentsOffset + kPointerSize;
+  static const int kBailoutReasonsOffset =
+      kDeoptHistoryOffset + kPointerSize;
+  static const int kDeoptCounterOffset =
+      kBailoutReasonsOffset + kPointerSize;
 #if V8_HOST_ARCH_32_BIT
   // Smi fields.
   static const int kLengthOffset =
@@ -5232,7 +5600,7 @@ class SharedFunctionInfo: public HeapObject {
   static const int kAlignedSize = POINTER_SIZE_ALIGN(kSize);
 
   typedef FixedBodyDescriptor<kNameOffset,
-                              kThisPropertyAssignmentsOffset + kPointerSize,
+                              kBailoutReasonsOffset + kPointerSize,
                               kSize> BodyDescriptor;
 
   // Bit positions in start_position_and_type.
@@ -5261,6 +5629,8 @@ class SharedFunctionInfo: public HeapObject {
     kBoundFunction,
     kIsAnonymous,
     kNameShouldPrintAsAnonymous,
+    kOptimizeFromProfile,
+    kUsedOnStackReplacement,
     kCompilerHintsCount  // Pseudo entry
   };
 
@@ -5291,6 +5661,11 @@ class SharedFunctionInfo: public HeapObject {
   static const int kNativeBitWithinByte =
       (kNative + kCompilerHintsSmiTagSize) % kBitsPerByte;
 
+  // The code age bits within the compiler hints field, which generated
+  // code clears to reset the age.
+  static const int kCodeAgeMaskInPlace =
+      kCodeAgeMask << (kCodeAgeShift + kCompilerHintsSmiTagSize);
+
 #if __BYTE_ORDER == __LITTLE_ENDIAN
   static const int kStrictModeByteOffset = kCompilerHintsOffset +
       (kStrictModeFunction + kCompilerHintsSmiTagSize) / kBitsPerByte;
@@ -5375,6 +5750,10 @@ class JSFunction: public JSObject {
   // Check whether or not this function is inlineable.
   bool IsInlineable();
 
+  // Check whether this is one of the builtins that are inlined into their
+  // callers, so that the callbacks they call can be inlined as well.
+  bool IsInlineableBuiltin();
+
   // [literals_or_bindings]: Fixed array holding either
   // the materialized literals or the bindings of a bound function.
   //
@@ -5402,6 +5781,12 @@ class JSFunction: public JSObject {
   inline void set_initial_map(Map* value);
   inline bool has_initial_map();
 
+  // Called when an object with the given map, which has no unused inobject
+  // fields left, gets its first out-of-object property.  If the map is the
+  // initial map of a user constructor, drops the initial map so that the
+  // next constructor call allocates one with more inobject fields.
+  void GrowInitialMap(Map* map);
+
   // Get and set the prototype property on a JSFunction. If the
   // function has an initial map the prototype is set on the initial
   // map. Otherwise, the prototype is put in the initial map field
@@ -5655,7 +6040,7 @@ class JSBuiltinsObject: public GlobalObject {
 };
 
 
-// Representation for JS Wrapper objects, String, Number, Boolean, Date, etc.
+// Representation for JS Wrapper objects, String, Number, Boolean, etc.
 class JSValue: public JSObject {
  public:
   // [value]: the object being wrapped.
@@ -5684,6 +6069,110 @@ class JSValue: public JSObject {
 };
 
 
+class DateCache;
+
+// Representation for JS date objects.  Besides the time value, a date
+// caches its local year, month, day, weekday, hour, minute and second,
+// which are valid as long as cache_stamp matches the stamp of the
+// isolate's DateCache.
+class JSDate: public JSObject {
+ public:
+  // If one component is NaN, all of them are, indicating a NaN time value.
+  // [value]: the time value.
+  DECL_ACCESSORS(value, Object)
+  // [year]: caches year. Either undefined, smi, or NaN.
+  DECL_ACCESSORS(year, Object)
+  // [month]: caches month. Either undefined, smi, or NaN.
+  DECL_ACCESSORS(month, Object)
+  // [day]: caches day. Either undefined, smi, or NaN.
+  DECL_ACCESSORS(day, Object)
+  // [weekday]: caches day of week. Either undefined, smi, or NaN.
+  DECL_ACCESSORS(weekday, Object)
+  // [hour]: caches hours. Either undefined, smi, or NaN.
+  DECL_ACCESSORS(hour, Object)
+  // [min]: caches minutes. Either undefined, smi, or NaN.
+  DECL_ACCESSORS(min, Object)
+  // [sec]: caches seconds. Either undefined, smi, or NaN.
+  DECL_ACCESSORS(sec, Object)
+  // [cache_stamp]: sample of the date cache stamp at the
+  // moment when local fields were cached.
+  DECL_ACCESSORS(cache_stamp, Object)
+
+  // Casting.
+  static inline JSDate* cast(Object* obj);
+
+  // Returns the date field with the specified index.
+  // See FieldIndex for the list of date fields.  Does not allocate, so
+  // generated code calls it directly.
+  static Object* GetField(Object* date, Smi* index);
+
+  // Sets the time value and invalidates the cached fields.
+  void SetValue(Object* value, bool is_value_nan);
+
+  // Dispatched behavior.
+#ifdef OBJECT_PRINT
+  inline void JSDatePrint() {
+    JSDatePrint(stdout);
+  }
+  void JSDatePrint(FILE* out);
+#endif
+#ifdef DEBUG
+  void JSDateVerify();
+#endif
+
+  // The order is important. It must be kept in sync with date macros
+  // in macros.py.
+  enum FieldIndex {
+    kDateValue,
+    kYear,
+    kMonth,
+    kDay,
+    kWeekday,
+    kHour,
+    kMinute,
+    kSecond,
+    kFirstUncachedField,
+    kMillisecond = kFirstUncachedField,
+    kDays,
+    kTimeInDay,
+    kFirstUTCField,
+    kYearUTC = kFirstUTCField,
+    kMonthUTC,
+    kDayUTC,
+    kWeekdayUTC,
+    kHourUTC,
+    kMinuteUTC,
+    kSecondUTC,
+    kMillisecondUTC,
+    kDaysUTC,
+    kTimeInDayUTC,
+    kTimezoneOffset
+  };
+
+  // Layout description.
+  static const int kValueOffset = JSObject::kHeaderSize;
+  static const int kYearOffset = kValueOffset + kPointerSize;
+  static const int kMonthOffset = kYearOffset + kPointerSize;
+  static const int kDayOffset = kMonthOffset + kPointerSize;
+  static const int kWeekdayOffset = kDayOffset + kPointerSize;
+  static const int kHourOffset = kWeekdayOffset  + kPointerSize;
+  static const int kMinOffset = kHourOffset + kPointerSize;
+  static const int kSecOffset = kMinOffset + kPointerSize;
+  static const int kCacheStampOffset = kSecOffset + kPointerSize;
+  static const int kSize = kCacheStampOffset + kPointerSize;
+
+ private:
+  Object* DoGetField(FieldIndex index);
+
+  Object* GetUTCField(FieldIndex index, double value, DateCache* date_cache);
+
+  // Computes and caches the cacheable fields of the date.
+  void SetLocalFields(int64_t local_time_ms, DateCache* date_cache);
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(JSDate);
+};
+
+
 // Representation of message objects used for error reporting through
 // the API. The messages are formatted in JavaScript so this object is
 // a real JavaScript object. The information used for formatting the
@@ -5813,6 +6302,14 @@ class JSRegExp: public JSObject {
     }
   }
 
+  static int bytecode_index(bool is_ascii) {
+    if (is_ascii) {
+      return kIrregexpASCIIBytecodeIndex;
+    } else {
+      return kIrregexpUC16BytecodeIndex;
+    }
+  }
+
   static inline JSRegExp* cast(Object* obj);
 
   // Dispatched behavior.
@@ -5856,8 +6353,25 @@ class JSRegExp: public JSObject {
   static const int kIrregexpMaxRegisterCountIndex = kDataIndex + 4;
   // Number of captures in the compiled regexp.
   static const int kIrregexpCaptureCountIndex = kDataIndex + 5;
-
-  static const int kIrregexpDataSize = kIrregexpCaptureCountIndex + 1;
+  // Literal string that every match starts with, or Smi zero if the
+  // pattern does not start with one.
+  static const int kIrregexpLiteralPrefixIndex = kDataIndex + 6;
+  // Irregexp bytecode for ASCII and UC16 that is interpreted until the
+  // regexp has been used enough to be compiled to native code. Only used
+  // when V8 is compiled with native regexp support.
+  static const int kIrregexpASCIIBytecodeIndex = kDataIndex + 7;
+  static const int kIrregexpUC16BytecodeIndex = kDataIndex + 8;
+  // Number of executions and total subject length seen while the regexp
+  // was interpreted, capped at the --regexp-tier-up-* limits.
+  static const int kIrregexpExecutionCountIndex = kDataIndex + 9;
+  static const int kIrregexpSubjectLengthIndex = kDataIndex + 10;
+
+  static const int kIrregexpDataSize = kIrregexpSubjectLengthIndex + 1;
+
+  // Subjects of at least this length are matched through the runtime when
+  // the regexp has a literal prefix, so that candidate start positions are
+  // found with a string search instead of the generated code's scan.
+  static const int kLiteralPrefixMinSubjectLength = 256;
 
   // Offsets directly into the data fixed array.
   static const int kDataTagOffset =
@@ -5868,6 +6382,8 @@ class JSRegExp: public JSObject {
       FixedArray::kHeaderSize + kIrregexpUC16CodeIndex * kPointerSize;
   static const int kIrregexpCaptureCountOffset =
       FixedArray::kHeaderSize + kIrregexpCaptureCountIndex * kPointerSize;
+  static const int kIrregexpLiteralPrefixOffset =
+      FixedArray::kHeaderSize + kIrregexpLiteralPrefixIndex * kPointerSize;
 
   // In-object fields.
   static const int kSourceFieldIndex = 0;
@@ -6096,7 +6612,10 @@ enum RobustnessFlag {ROBUST_STRING_TRAVERSAL, FAST_STRING_TRAVERSAL};
 
 class StringHasher {
  public:
-  explicit inline StringHasher(int length);
+  // The seed, which Heap::HashSeed provides for strings in the heap, is the
+  // initial value of the running hash, so which strings collide cannot be
+  // predicted without knowing it.
+  inline StringHasher(int length, uint32_t seed);
 
   // Returns true if the hash of this string can be computed without
   // looking at the contents.
@@ -6147,7 +6666,9 @@ class StringHasher {
 
 // Calculates string hash.
 template <typename schar>
-inline uint32_t HashSequentialString(const schar* chars, int length);
+inline uint32_t HashSequentialString(const schar* chars,
+                                     int length,
+                                     uint32_t seed);
 
 
 // The characteristics of a string are stored in its map.  Retrieving these
@@ -6370,7 +6891,8 @@ class String: public HeapObject {
   inline uint32_t Hash();
 
   static uint32_t ComputeHashField(unibrow::CharacterStream* buffer,
-                                   int length);
+                                   int length,
+                                   uint32_t seed);
 
   static bool ComputeArrayIndex(unibrow::CharacterStream* buffer,
                                 uint32_t* index,
@@ -6506,32 +7028,50 @@ class String: public HeapObject {
                           int from,
                           int to);
 
-  static inline bool IsAscii(const char* chars, int length) {
+  // Returns the index of the first character that is not ASCII, or length
+  // if there is none.  Where the host can read unaligned words, the
+  // characters are checked a word at a time.
+  static inline int NonAsciiStart(const char* chars, int length) {
+    const char* start = chars;
     const char* limit = chars + length;
 #ifdef V8_HOST_CAN_READ_UNALIGNED
     ASSERT(kMaxAsciiCharCode == 0x7F);
     const uintptr_t non_ascii_mask = kUintptrAllBitsSet / 0xFF * 0x80;
     while (chars <= limit - sizeof(uintptr_t)) {
-      if (*reinterpret_cast<const uintptr_t*>(chars) & non_ascii_mask) {
-        return false;
-      }
+      if (*reinterpret_cast<const uintptr_t*>(chars) & non_ascii_mask) break;
       chars += sizeof(uintptr_t);
     }
 #endif
     while (chars < limit) {
-      if (static_cast<uint8_t>(*chars) > kMaxAsciiCharCodeU) return false;
+      if (static_cast<uint8_t>(*chars) > kMaxAsciiCharCodeU) break;
       ++chars;
     }
-    return true;
+    return static_cast<int>(chars - start);
   }
 
-  static inline bool IsAscii(const uc16* chars, int length) {
+  static inline int NonAsciiStart(const uc16* chars, int length) {
+    const uc16* start = chars;
     const uc16* limit = chars + length;
+#ifdef V8_HOST_CAN_READ_UNALIGNED
+    const uintptr_t non_ascii_mask = kUintptrAllBitsSet / 0xFFFF * 0xFF80;
+    while (chars <= limit - sizeof(uintptr_t) / kUC16Size) {
+      if (*reinterpret_cast<const uintptr_t*>(chars) & non_ascii_mask) break;
+      chars += sizeof(uintptr_t) / kUC16Size;
+    }
+#endif
     while (chars < limit) {
-      if (*chars > kMaxAsciiCharCodeU) return false;
+      if (*chars > kMaxAsciiCharCodeU) break;
       ++chars;
     }
-    return true;
+    return static_cast<int>(chars - start);
+  }
+
+  static inline bool IsAscii(const char* chars, int length) {
+    return NonAsciiStart(chars, length) >= length;
+  }
+
+  static inline bool IsAscii(const uc16* chars, int length) {
+    return NonAsciiStart(chars, length) >= length;
   }
 
  protected:
@@ -6717,6 +7257,14 @@ class ConsString: public String {
   inline void set_second(String* second,
                          WriteBarrierMode mode = UPDATE_WRITE_BARRIER);
 
+  // Height of the cons tree rooted at this string, counting this cell.
+  // Leaves have depth 0, so a cons of two flat strings has depth 1.
+  inline int depth();
+  inline void set_depth(int value);
+
+  // Returns the depth of an arbitrary string; zero if it is not a cons.
+  static inline int DepthOf(String* string);
+
   // Dispatched behavior.
   uint16_t ConsStringGet(int index);
 
@@ -6726,7 +7274,8 @@ class ConsString: public String {
   // Layout description.
   static const int kFirstOffset = POINTER_SIZE_ALIGN(String::kSize);
   static const int kSecondOffset = kFirstOffset + kPointerSize;
-  static const int kSize = kSecondOffset + kPointerSize;
+  static const int kDepthOffset = kSecondOffset + kPointerSize;
+  static const int kSize = kDepthOffset + kPointerSize;
 
   // Support for StringInputBuffer.
   inline const unibrow::byte* ConsStringReadBlock(ReadBlockBuffer* buffer,
@@ -6739,6 +7288,10 @@ class ConsString: public String {
   // Minimum length for a cons string.
   static const int kMinLength = 13;
 
+  // Concatenations that would produce a deeper tree than this rebuild it
+  // as a balanced one instead.  See Heap::AllocateBalancedConsString.
+  static const int kMaxDepth = 64;
+
   typedef FixedBodyDescriptor<kFirstOffset, kSecondOffset + kPointerSize, kSize>
           BodyDescriptor;
 
@@ -7062,9 +7615,26 @@ class Oddball: public HeapObject {
 
 class JSGlobalPropertyCell: public HeapObject {
  public:
+  // How optimized code treats the value of the cell.
+  enum State {
+    // No optimized code relies on the value.
+    UNOBSERVED,
+    // Optimized code has the value embedded as a constant and has to be
+    // deoptimized before the value changes.  Store stubs leave writes to the
+    // runtime system, which does that.
+    CONSTANT,
+    // The value changed after it was embedded, or optimized code writes it.
+    // It is never embedded again.
+    MUTABLE
+  };
+
   // [value]: value of the global property.
   DECL_ACCESSORS(value, Object)
 
+  // [state]: how optimized code treats the value.
+  inline State state();
+  inline void set_state(State state);
+
   // Casting.
   static inline JSGlobalPropertyCell* cast(Object* obj);
 
@@ -7080,7 +7650,8 @@ class JSGlobalPropertyCell: public HeapObject {
 
   // Layout description.
   static const int kValueOffset = HeapObject::kHeaderSize;
-  static const int kSize = kValueOffset + kPointerSize;
+  static const int kStateOffset = kValueOffset + kPointerSize;
+  static const int kSize = kStateOffset + kPointerSize;
 
   typedef FixedBodyDescriptor<kValueOffset,
                               kValueOffset + kPointerSize,
@@ -7236,7 +7807,7 @@ class JSFunctionProxy: public JSProxy {
 // The JSSet describes EcmaScript Harmony sets
 class JSSet: public JSObject {
  public:
-  // [set]: the backing hash set containing keys.
+  // [table]: the backing ordered hash table containing keys.
   DECL_ACCESSORS(table, Object)
 
   // Casting.
@@ -7263,7 +7834,7 @@ class JSSet: public JSObject {
 // The JSMap describes EcmaScript Harmony maps
 class JSMap: public JSObject {
  public:
-  // [table]: the backing hash table mapping keys to values.
+  // [table]: the backing ordered hash table mapping keys to values.
   DECL_ACCESSORS(table, Object)
 
   // Casting.
@@ -7463,6 +8034,12 @@ class AccessorInfo: public Struct {
   inline bool prohibits_overwriting();
   inline void set_prohibits_overwriting(bool value);
 
+  // Whether the getter just returns the holder's internal field whose
+  // index is stored as a Smi in data.  Loads of such accessors are
+  // compiled as plain field loads.
+  inline bool is_internal_field();
+  inline void set_is_internal_field(bool value);
+
   inline PropertyAttributes property_attributes();
   inline void set_property_attributes(PropertyAttributes attributes);
 
@@ -7491,6 +8068,7 @@ class AccessorInfo: public Struct {
   static const int kAllCanWriteBit = 1;
   static const int kProhibitsOverwritingBit = 2;
   class AttributesField: public BitField<PropertyAttributes, 3, 3> {};
+  static const int kIsInternalFieldBit = 6;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(AccessorInfo);
 };
@@ -7532,9 +8110,15 @@ class InterceptorInfo: public Struct {
   DECL_ACCESSORS(deleter, Object)
   DECL_ACCESSORS(enumerator, Object)
   DECL_ACCESSORS(data, Object)
+  // The names this interceptor handles as a FixedArray of symbols, or
+  // undefined if it handles all names.
+  DECL_ACCESSORS(keys, Object)
 
   static inline InterceptorInfo* cast(Object* obj);
 
+  // Returns whether lookups of the given name go through this interceptor.
+  bool Intercepts(String* name);
+
 #ifdef OBJECT_PRINT
   inline void InterceptorInfoPrint() {
     InterceptorInfoPrint(stdout);
@@ -7551,7 +8135,8 @@ class InterceptorInfo: public Struct {
   static const int kDeleterOffset = kQueryOffset + kPointerSize;
   static const int kEnumeratorOffset = kDeleterOffset + kPointerSize;
   static const int kDataOffset = kEnumeratorOffset + kPointerSize;
-  static const int kSize = kDataOffset + kPointerSize;
+  static const int kKeysOffset = kDataOffset + kPointerSize;
+  static const int kSize = kKeysOffset + kPointerSize;
 
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(InterceptorInfo);
@@ -7562,6 +8147,18 @@ class CallHandlerInfo: public Struct {
  public:
   DECL_ACCESSORS(callback, Object)
   DECL_ACCESSORS(data, Object)
+  // The optional v8::FastCallFunction and its v8::FastCallSignature,
+  // encoded as a Smi with the fields below.  Undefined if there is none.
+  DECL_ACCESSORS(fast_callback, Object)
+  DECL_ACCESSORS(fast_signature, Object)
+
+  class FastResultField: public BitField<int, 0, 2> {};
+  class FastArgumentCountField: public BitField<int, 2, 2> {};
+  // Each argument type takes two bits after the count.
+  static int FastArgumentShift(int index) { return 4 + 2 * index; }
+  static int FastArgumentType(int bits, int index) {
+    return (bits >> FastArgumentShift(index)) & 3;
+  }
 
   static inline CallHandlerInfo* cast(Object* obj);
 
@@ -7577,7 +8174,9 @@ class CallHandlerInfo: public Struct {
 
   static const int kCallbackOffset = HeapObject::kHeaderSize;
   static const int kDataOffset = kCallbackOffset + kPointerSize;
-  static const int kSize = kDataOffset + kPointerSize;
+  static const int kFastCallbackOffset = kDataOffset + kPointerSize;
+  static const int kFastSignatureOffset = kFastCallbackOffset + kPointerSize;
+  static const int kSize = kFastSignatureOffset + kPointerSize;
 
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(CallHandlerInfo);
@@ -7740,6 +8339,84 @@ class TypeSwitchInfo: public Struct {
 };
 
 
+// An Atom is an immutable primitive value that stands for a name, like a
+// Ruby symbol.  Atoms are interned in the heap's atom table, keyed by their
+// names, so two atoms with the same name are the same object and compare by
+// identity.  The table is a strong root and atoms live in old space, so
+// optimized code can embed them as constants.  typeof an atom is "symbol".
+class Atom: public Struct {
+ public:
+  // The name of the atom, always a symbol.
+  DECL_ACCESSORS(name, String)
+
+  // The hash of the name, computed when the atom is created.
+  DECL_ACCESSORS(hash, Smi)
+
+  static inline Atom* cast(Object* obj);
+
+#ifdef OBJECT_PRINT
+  inline void AtomPrint() {
+    AtomPrint(stdout);
+  }
+  void AtomPrint(FILE* out);
+#endif
+#ifdef DEBUG
+  void AtomVerify();
+#endif
+
+  static const int kNameOffset = Struct::kHeaderSize;
+  static const int kHashOffset = kNameOffset + kPointerSize;
+  static const int kSize       = kHashOffset + kPointerSize;
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(Atom);
+};
+
+
+// A StringBuffer is a mutable string, like a Ruby String.  Its characters
+// are the first length() characters of a sequential backing store whose
+// length is the capacity of the buffer, and whose representation is the
+// encoding of the buffer.  Appending (see %_StringAppend) copies into the
+// spare capacity in place and only allocates when the buffer is full, which
+// grows the backing store geometrically, or when a two-byte string is
+// appended to an ASCII buffer.  Characters that have been written are never
+// changed, so a slice of the backing store is a flat view of the contents.
+// That is how ToPrimitive and the string builtins read a buffer.  typeof a
+// buffer is "string", and property lookups on a buffer go to
+// String.prototype.
+class StringBuffer: public Struct {
+ public:
+  // The backing store of the buffer.
+  DECL_ACCESSORS(buffer, SeqString)
+
+  // The number of characters in the buffer.
+  inline int length();
+  inline void set_length(int value);
+
+  // The number of characters the buffer can hold without growing.
+  inline int capacity();
+
+  static inline StringBuffer* cast(Object* obj);
+
+#ifdef OBJECT_PRINT
+  inline void StringBufferPrint() {
+    StringBufferPrint(stdout);
+  }
+  void StringBufferPrint(FILE* out);
+#endif
+#ifdef DEBUG
+  void StringBufferVerify();
+#endif
+
+  static const int kBufferOffset = Struct::kHeaderSize;
+  static const int kLengthOffset = kBufferOffset + kPointerSize;
+  static const int kSize         = kLengthOffset + kPointerSize;
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(StringBuffer);
+};
+
+
 #ifdef ENABLE_DEBUGGER_SUPPORT
 // The DebugInfo class holds additional information for a function being
 // debugged.
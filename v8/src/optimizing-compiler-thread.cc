@@ -0,0 +1,136 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "optimizing-compiler-thread.h"
+
+#include "compiler.h"
+#include "isolate.h"
+#include "unbound-queue-inl.h"
+
+namespace v8 {
+namespace internal {
+
+
+OptimizingCompilerThread::OptimizingCompilerThread(Isolate* isolate)
+    : Thread("v8:OptimizingCompiler"),
+      isolate_(isolate),
+      input_queue_semaphore_(OS::CreateSemaphore(0)),
+      compile_mutex_(OS::CreateMutex()),
+      jobs_(FLAG_concurrent_recompilation_queue_length),
+      stop_thread_(0) {
+#ifdef DEBUG
+  thread_id_ = 0;
+#endif
+}
+
+
+OptimizingCompilerThread::~OptimizingCompilerThread() {
+  delete input_queue_semaphore_;
+  delete compile_mutex_;
+}
+
+
+void OptimizingCompilerThread::Run() {
+  Isolate::SetIsolateThreadLocals(isolate_, NULL);
+#ifdef DEBUG
+  thread_id_ = ThreadId::Current().ToInteger();
+#endif
+  while (true) {
+    input_queue_semaphore_->Wait();
+    if (Acquire_Load(&stop_thread_)) return;
+
+    OptimizingCompiler* job = NULL;
+    input_queue_.Dequeue(&job);
+    {
+      ScopedLock lock(compile_mutex_);
+      job->OptimizeGraph();
+    }
+    output_queue_.Enqueue(job);
+    isolate_->stack_guard()->RequestInstallCode();
+  }
+}
+
+
+void OptimizingCompilerThread::Stop() {
+  Release_Store(&stop_thread_, static_cast<AtomicWord>(true));
+  input_queue_semaphore_->Signal();
+  Join();
+  // Jobs that were not installed are dropped; their functions keep the
+  // unoptimized code.
+  for (int i = 0; i < jobs_.length(); i++) delete jobs_[i];
+  jobs_.Clear();
+}
+
+
+void OptimizingCompilerThread::QueueForOptimization(OptimizingCompiler* job) {
+  ASSERT(IsQueueAvailable());
+  if (FLAG_trace_concurrent_recompilation) {
+    PrintF("  ** Queueing ");
+    job->info()->closure()->PrintName();
+    PrintF(" for concurrent recompilation.\n");
+  }
+  jobs_.Add(job);
+  input_queue_.Enqueue(job);
+  input_queue_semaphore_->Signal();
+}
+
+
+void OptimizingCompilerThread::InstallOptimizedFunctions() {
+  HandleScope handle_scope(isolate_);
+  while (!output_queue_.IsEmpty()) {
+    OptimizingCompiler* job = NULL;
+    output_queue_.Dequeue(&job);
+    if (FLAG_trace_concurrent_recompilation) {
+      PrintF("  ** Installing ");
+      job->info()->closure()->PrintName();
+      PrintF(".\n");
+    }
+    job->GenerateAndInstallCode();
+    jobs_.RemoveElement(job);
+    delete job;
+  }
+}
+
+
+bool OptimizingCompilerThread::IsQueued(JSFunction* function) {
+  for (int i = 0; i < jobs_.length(); i++) {
+    if (*jobs_[i]->info()->closure() == function) return true;
+  }
+  return false;
+}
+
+
+#ifdef DEBUG
+bool OptimizingCompilerThread::IsOptimizerThread() {
+  return ThreadId::Current().ToInteger() == thread_id_;
+}
+#endif
+
+
+} }  // namespace v8::internal
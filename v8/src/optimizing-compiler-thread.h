@@ -0,0 +1,118 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_OPTIMIZING_COMPILER_THREAD_H_
+#define V8_OPTIMIZING_COMPILER_THREAD_H_
+
+#include "atomicops.h"
+#include "list.h"
+#include "platform.h"
+#include "unbound-queue.h"
+
+namespace v8 {
+namespace internal {
+
+class JSFunction;
+class OptimizingCompiler;
+
+// Optimizes functions in the background (--concurrent-recompilation).  The
+// main thread queues the graphs built by Compiler::RecompileConcurrent, this
+// thread optimizes them and requests an INSTALL_CODE interrupt, and the main
+// thread generates and installs the code at its next stack guard check.
+//
+// The thread holds the compile mutex while it works on a graph, because the
+// optimization phases read heap objects through the handles of the graph.
+// The garbage collector takes the mutex before it moves any objects.
+class OptimizingCompilerThread : public Thread {
+ public:
+  explicit OptimizingCompilerThread(Isolate* isolate);
+  ~OptimizingCompilerThread();
+
+  void Run();
+  void Stop();
+
+  // Takes ownership of the job.
+  void QueueForOptimization(OptimizingCompiler* job);
+
+  // Installs the code of all jobs that have been optimized so far.
+  void InstallOptimizedFunctions();
+
+  bool IsQueueAvailable() {
+    return jobs_.length() < FLAG_concurrent_recompilation_queue_length;
+  }
+
+  // Returns true if the function is waiting to be optimized or installed.
+  bool IsQueued(JSFunction* function);
+
+#ifdef DEBUG
+  bool IsOptimizerThread();
+#endif
+
+  // Keeps the thread from working on a graph for the lifetime of the scope.
+  class PauseScope {
+   public:
+    explicit PauseScope(OptimizingCompilerThread* thread) : thread_(thread) {
+      if (thread_ != NULL) thread_->compile_mutex_->Lock();
+    }
+    ~PauseScope() {
+      if (thread_ != NULL) thread_->compile_mutex_->Unlock();
+    }
+
+   private:
+    OptimizingCompilerThread* thread_;
+  };
+
+ private:
+  Isolate* isolate_;
+  Semaphore* input_queue_semaphore_;
+  Mutex* compile_mutex_;
+  // Jobs move from the input queue to the output queue on this thread.
+  UnboundQueue<OptimizingCompiler*> input_queue_;
+  UnboundQueue<OptimizingCompiler*> output_queue_;
+  // All jobs that have not been installed yet.  Only used on the main
+  // thread.
+  List<OptimizingCompiler*> jobs_;
+  volatile AtomicWord stop_thread_;
+#ifdef DEBUG
+  int thread_id_;
+#endif
+};
+
+
+// Heap object addresses are used as hash codes while the objects cannot
+// move: on the main thread while allocation is disabled, and on the
+// optimizing compiler thread, which excludes the garbage collector.
+#define ASSERT_ALLOCATION_DISABLED do {                                        \
+    OptimizingCompilerThread* thread =                                         \
+        Isolate::Current()->optimizing_compiler_thread();                      \
+    ASSERT((thread != NULL && thread->IsOptimizerThread()) ||                  \
+           !HEAP->IsAllocationAllowed());                                      \
+  } while (false)
+
+} }  // namespace v8::internal
+
+#endif  // V8_OPTIMIZING_COMPILER_THREAD_H_
@@ -32,6 +32,7 @@
 #include "bootstrapper.h"
 #include "char-predicates-inl.h"
 #include "codegen.h"
+#include "compilation-cache.h"
 #include "compiler.h"
 #include "func-name-inferrer.h"
 #include "messages.h"
@@ -599,7 +600,10 @@ Parser::Parser(Handle<Script> script,
       target_stack_(NULL),
       extension_(extension),
       pre_data_(pre_data),
+      function_log_(NULL),
       fni_(NULL),
+      compiled_functions_(NULL),
+      recompiled_scope_(NULL),
       allow_natives_syntax_((parser_flags & kAllowNativesSyntax) != 0),
       allow_lazy_((parser_flags & kAllowLazy) != 0),
       stack_overflow_(false),
@@ -629,6 +633,11 @@ FunctionLiteral* Parser::ParseProgram(CompilationInfo* info) {
         Handle<ExternalTwoByteString>::cast(source), 0, source->length());
     scanner_.Initialize(&stream);
     return DoParseProgram(info, source, &zone_scope);
+  } else if (source->IsExternalAsciiString()) {
+    ExternalAsciiStringUC16CharacterStream stream(
+        Handle<ExternalAsciiString>::cast(source), 0, source->length());
+    scanner_.Initialize(&stream);
+    return DoParseProgram(info, source, &zone_scope);
   } else {
     GenericStringUC16CharacterStream stream(source, 0, source->length());
     scanner_.Initialize(&stream);
@@ -717,6 +726,13 @@ FunctionLiteral* Parser::ParseLazy(CompilationInfo* info) {
         shared_info->end_position());
     FunctionLiteral* result = ParseLazy(info, &stream, &zone_scope);
     return result;
+  } else if (source->IsExternalAsciiString()) {
+    ExternalAsciiStringUC16CharacterStream stream(
+        Handle<ExternalAsciiString>::cast(source),
+        shared_info->start_position(),
+        shared_info->end_position());
+    FunctionLiteral* result = ParseLazy(info, &stream, &zone_scope);
+    return result;
   } else {
     GenericStringUC16CharacterStream stream(source,
                                             shared_info->start_position(),
@@ -741,6 +757,27 @@ FunctionLiteral* Parser::ParseLazy(CompilationInfo* info,
 
   mode_ = PARSE_EAGERLY;
 
+  // A function that is recompiled for optimization already has compiled
+  // inner functions and a scope info recording which of its variables they
+  // use.  Reuse them instead of building the inner functions' syntax trees
+  // again.  Functions that call eval are always parsed in full.
+  if (FLAG_reuse_scope_info &&
+      info->IsOptimizing() &&
+      shared_info->code()->kind() == Code::FUNCTION &&
+      shared_info->scope_info()->length() > 0 &&
+      !shared_info->scope_info()->CallsEval()) {
+    compiled_functions_ = new(zone()) ZoneList<Handle<SharedFunctionInfo> >(4);
+    for (RelocIterator it(shared_info->code()); !it.done(); it.next()) {
+      RelocInfo* rinfo = it.rinfo();
+      if (rinfo->rmode() != RelocInfo::EMBEDDED_OBJECT) continue;
+      Object* obj = rinfo->target_object();
+      if (obj->IsSharedFunctionInfo()) {
+        compiled_functions_->Add(
+            Handle<SharedFunctionInfo>(SharedFunctionInfo::cast(obj)));
+      }
+    }
+  }
+
   // Place holder for the result.
   FunctionLiteral* result = NULL;
 
@@ -783,6 +820,12 @@ FunctionLiteral* Parser::ParseLazy(CompilationInfo* info,
   } else {
     Handle<String> inferred_name(shared_info->inferred_name());
     result->set_inferred_name(inferred_name);
+    // The skipped inner functions did not mark the variables they use, so
+    // allocate the variables as they were allocated the previous time.
+    if (compiled_functions_ != NULL) {
+      result->scope()->ReuseScopeInfo(
+          Handle<ScopeInfo>(shared_info->scope_info()));
+    }
   }
   return result;
 }
@@ -3567,8 +3610,8 @@ class ObjectLiteralPropertyChecker {
     }
   }
 
-  HashMap props;
-  HashMap elems;
+  ZoneHashMap props;
+  ZoneHashMap elems;
   Parser* parser_;
   LanguageMode language_mode_;
 };
@@ -3585,7 +3628,7 @@ void ObjectLiteralPropertyChecker::CheckProperty(
   Handle<Object> handle = lit->handle();
 
   uint32_t hash;
-  HashMap* map;
+  ZoneHashMap* map;
   void* key;
 
   if (handle->IsSymbol()) {
@@ -3615,7 +3658,7 @@ void ObjectLiteralPropertyChecker::CheckProperty(
   }
 
   // Lookup property previously defined, if any.
-  HashMap::Entry* entry = map->Lookup(key, hash, true);
+  ZoneHashMap::Entry* entry = map->Lookup(key, hash, true);
   intptr_t prev = reinterpret_cast<intptr_t> (entry->value);
   intptr_t curr = GetPropertyKind(property);
 
@@ -4055,7 +4098,14 @@ FunctionLiteral* Parser::ParseFunctionLiteral(Handle<String> function_name,
   Scope* scope = (type == FunctionLiteral::DECLARATION && !is_extended_mode())
       ? NewScope(top_scope_->DeclarationScope(), FUNCTION_SCOPE)
       : NewScope(top_scope_, FUNCTION_SCOPE);
+  // The first function parsed when recompiling is the recompiled function.
+  bool is_recompiled_inner_function =
+      compiled_functions_ != NULL && scope->outer_scope() == recompiled_scope_;
+  if (compiled_functions_ != NULL && recompiled_scope_ == NULL) {
+    recompiled_scope_ = scope;
+  }
   ZoneList<Statement*>* body = NULL;
+  Handle<SharedFunctionInfo> compiled_function;
   int materialized_literal_count = -1;
   int expected_property_count = -1;
   int handler_count = 0;
@@ -4138,14 +4188,21 @@ FunctionLiteral* Parser::ParseFunctionLiteral(Handle<String> function_name,
     //   compiled.
     // These are all things we can know at this point, without looking at the
     // function itself.
-    bool is_lazily_compiled = (mode() == PARSE_LAZILY &&
-                               top_scope_->outer_scope()->is_global_scope() &&
-                               top_scope_->HasTrivialOuterContext() &&
-                               !parenthesized_function_);
+    bool is_lazy_candidate = top_scope_->outer_scope()->is_global_scope() &&
+                             top_scope_->HasTrivialOuterContext() &&
+                             !parenthesized_function_;
+    bool is_lazily_compiled = mode() == PARSE_LAZILY && is_lazy_candidate;
     parenthesized_function_ = false;  // The bit was set for this function only.
 
+    // The inner functions of a function recompiled for optimization keep
+    // the code they already have, so their bodies are only preparsed.
+    if (is_recompiled_inner_function) {
+      compiled_function = FindCompiledFunction(scope->start_position());
+      if (!compiled_function.is_null()) is_lazily_compiled = true;
+    }
+
+    int function_block_pos = scanner().location().beg_pos;
     if (is_lazily_compiled) {
-      int function_block_pos = scanner().location().beg_pos;
       FunctionEntry entry;
       if (pre_data_ != NULL) {
         // If we have pre_data_, we use it to skip parsing the function body.
@@ -4198,6 +4255,13 @@ FunctionLiteral* Parser::ParseFunctionLiteral(Handle<String> function_name,
         }
         scope->set_end_position(logger.end());
         Expect(Token::RBRACE, CHECK_OK);
+        if (function_log_ != NULL) {
+          function_log_->LogFunction(function_block_pos,
+                                     logger.end(),
+                                     logger.literals(),
+                                     logger.properties(),
+                                     logger.language_mode());
+        }
         isolate()->counters()->total_preparse_skipped()->Increment(
             scope->end_position() - function_block_pos);
         materialized_literal_count = logger.literals();
@@ -4231,6 +4295,16 @@ FunctionLiteral* Parser::ParseFunctionLiteral(Handle<String> function_name,
 
       Expect(Token::RBRACE, CHECK_OK);
       scope->set_end_position(scanner().location().end_pos);
+
+      // Log the function as the preparser would have, so that the next
+      // parse of the source can compile it lazily without preparsing it.
+      if (is_lazy_candidate && function_log_ != NULL) {
+        function_log_->LogFunction(function_block_pos,
+                                   scope->end_position(),
+                                   materialized_literal_count,
+                                   expected_property_count,
+                                   top_scope_->language_mode());
+      }
     }
 
     // Validate strict mode.
@@ -4299,12 +4373,24 @@ FunctionLiteral* Parser::ParseFunctionLiteral(Handle<String> function_name,
                                   type,
                                   has_duplicate_parameters);
   function_literal->set_function_token_position(function_token_position);
+  if (!compiled_function.is_null()) {
+    function_literal->set_shared_info(compiled_function);
+  }
 
   if (fni_ != NULL && should_infer_name) fni_->AddFunction(function_literal);
   return function_literal;
 }
 
 
+Handle<SharedFunctionInfo> Parser::FindCompiledFunction(int start_position) {
+  for (int i = 0; i < compiled_functions_->length(); i++) {
+    Handle<SharedFunctionInfo> shared = compiled_functions_->at(i);
+    if (shared->start_position() == start_position) return shared;
+  }
+  return Handle<SharedFunctionInfo>::null();
+}
+
+
 preparser::PreParser::PreParseResult Parser::LazyParseFunctionLiteral(
     SingletonLogger* logger) {
   HistogramTimerScope preparse_scope(isolate()->counters()->pre_parse());
@@ -5487,7 +5573,7 @@ const char* ScriptDataImpl::Data() {
 
 
 bool ScriptDataImpl::HasError() {
-  return has_error();
+  return !is_code_cache() && has_error();
 }
 
 
@@ -5536,22 +5622,22 @@ int ScriptDataImpl::ReadNumber(byte** source) {
 
 
 // Create a Scanner for the preparser to use as input, and preparse the source.
+// Touches no isolate state, so it may run on any thread.  Returns NULL if the
+// preparser ran past the stack limit.
 static ScriptDataImpl* DoPreParse(UC16CharacterStream* source,
                                   int flags,
-                                  ParserRecorder* recorder) {
-  Isolate* isolate = Isolate::Current();
-  HistogramTimerScope timer(isolate->counters()->pre_parse());
-  Scanner scanner(isolate->unicode_cache());
+                                  ParserRecorder* recorder,
+                                  UnicodeCache* unicode_cache,
+                                  uintptr_t stack_limit) {
+  Scanner scanner(unicode_cache);
   scanner.SetHarmonyScoping(FLAG_harmony_scoping);
   scanner.Initialize(source);
-  intptr_t stack_limit = isolate->stack_guard()->real_climit();
   preparser::PreParser::PreParseResult result =
       preparser::PreParser::PreParseProgram(&scanner,
                                             recorder,
                                             flags,
                                             stack_limit);
   if (result == preparser::PreParser::kPreParseStackOverflow) {
-    isolate->StackOverflow();
     return NULL;
   }
 
@@ -5562,6 +5648,19 @@ static ScriptDataImpl* DoPreParse(UC16CharacterStream* source,
 }
 
 
+static ScriptDataImpl* DoPreParse(UC16CharacterStream* source,
+                                  int flags,
+                                  ParserRecorder* recorder) {
+  Isolate* isolate = Isolate::Current();
+  HistogramTimerScope timer(isolate->counters()->pre_parse());
+  ScriptDataImpl* result =
+      DoPreParse(source, flags, recorder, isolate->unicode_cache(),
+                 isolate->stack_guard()->real_climit());
+  if (result == NULL) isolate->StackOverflow();
+  return result;
+}
+
+
 // Preparse, but only collect data that is immediately useful,
 // even if the preparser data is only used once.
 ScriptDataImpl* ParserApi::PartialPreParse(Handle<String> source,
@@ -5580,6 +5679,10 @@ ScriptDataImpl* ParserApi::PartialPreParse(Handle<String> source,
     ExternalTwoByteStringUC16CharacterStream stream(
         Handle<ExternalTwoByteString>::cast(source), 0, source_length);
     return DoPreParse(&stream, flags, &recorder);
+  } else if (source->IsExternalAsciiString()) {
+    ExternalAsciiStringUC16CharacterStream stream(
+        Handle<ExternalAsciiString>::cast(source), 0, source_length);
+    return DoPreParse(&stream, flags, &recorder);
   } else {
     GenericStringUC16CharacterStream stream(source, 0, source_length);
     return DoPreParse(&stream, flags, &recorder);
@@ -5599,6 +5702,16 @@ ScriptDataImpl* ParserApi::PreParse(UC16CharacterStream* source,
 }
 
 
+ScriptDataImpl* ParserApi::PreParseWithoutIsolate(UC16CharacterStream* source,
+                                                  int flags,
+                                                  uintptr_t stack_limit) {
+  if (FLAG_lazy) flags |= kAllowLazy;
+  UnicodeCache unicode_cache;
+  CompleteParserRecorder recorder;
+  return DoPreParse(source, flags, &recorder, &unicode_cache, stack_limit);
+}
+
+
 bool RegExpParser::ParseRegExp(FlatStringReader* input,
                                bool multiline,
                                RegExpCompileData* result) {
@@ -5625,6 +5738,14 @@ bool ParserApi::Parse(CompilationInfo* info, int parsing_flags) {
   ASSERT(info->function() == NULL);
   FunctionLiteral* result = NULL;
   Handle<Script> script = info->script();
+  if (script->type()->value() == Script::TYPE_FRONT_END) {
+    ParserFrontEnd* front_end = info->isolate()->parser_front_end();
+    ASSERT(front_end != NULL);
+    result = front_end->Parse(info);
+    ASSERT(result != NULL || info->isolate()->has_pending_exception());
+    info->SetFunction(result);
+    return (result != NULL);
+  }
   ASSERT((parsing_flags & kLanguageModeMask) == CLASSIC_MODE);
   if (!info->is_native() && FLAG_harmony_scoping) {
     // Harmony scoping is requested.
@@ -5640,7 +5761,35 @@ bool ParserApi::Parse(CompilationInfo* info, int parsing_flags) {
     result = parser.ParseLazy(info);
   } else {
     ScriptDataImpl* pre_data = info->pre_parse_data();
+    // Without preparse data from the embedder, reuse the function entries
+    // recorded by an earlier parse of the same source, or record them for
+    // the next one.  Scripts too short to be parsed lazily are parsed fully
+    // the first time, but their top-level functions are recorded as well,
+    // so that later parses can compile them lazily without a preparse.
+    ScriptDataImpl* cached_data = NULL;
+    PartialParserRecorder recorder;
+    bool use_cache = FLAG_cache_preparse_data &&
+                     FLAG_lazy &&
+                     pre_data == NULL &&
+                     info->is_global() &&
+                     !info->is_eval() &&
+                     info->extension() == NULL &&
+                     (parsing_flags & kAllowNativesSyntax) == 0;
+    Handle<String> source(String::cast(script->source()));
+    if (use_cache) {
+      Handle<ByteArray> data = info->isolate()->compilation_cache()->
+          LookupPreparseData(source, parsing_flags | kAllowLazy);
+      if (!data.is_null()) {
+        int length = data->length() / sizeof(unsigned);
+        Vector<unsigned> store = Vector<unsigned>::New(length);
+        memcpy(store.start(), data->GetDataStartAddress(), data->length());
+        cached_data = new ScriptDataImpl(store);
+        pre_data = cached_data;
+        parsing_flags |= kAllowLazy;
+      }
+    }
     Parser parser(script, parsing_flags, info->extension(), pre_data);
+    if (use_cache && pre_data == NULL) parser.set_function_log(&recorder);
     if (pre_data != NULL && pre_data->has_error()) {
       Scanner::Location loc = pre_data->MessageLocation();
       const char* message = pre_data->BuildMessage();
@@ -5654,8 +5803,22 @@ bool ParserApi::Parse(CompilationInfo* info, int parsing_flags) {
       ASSERT(info->isolate()->has_pending_exception());
     } else {
       result = parser.ParseProgram(info);
+      if (use_cache && pre_data == NULL && result != NULL &&
+          recorder.function_position() > 0) {
+        Vector<unsigned> store = recorder.ExtractData();
+        int length = store.length() * sizeof(unsigned);
+        Handle<ByteArray> data =
+            info->isolate()->factory()->NewByteArray(length, TENURED);
+        memcpy(data->GetDataStartAddress(), store.start(), length);
+        store.Dispose();
+        info->isolate()->compilation_cache()->PutPreparseData(
+            source, parsing_flags | kAllowLazy, data);
+      }
     }
+    delete cached_data;
   }
+  info->isolate()->zone()->RecordHighWaterMark(
+      info->isolate()->counters()->zone_parse_high_water_mark());
   info->SetFunction(result);
   return (result != NULL);
 }
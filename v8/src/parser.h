@@ -137,6 +137,13 @@ class ScriptDataImpl : public ScriptData {
   unsigned magic() { return store_[PreparseDataConstants::kMagicOffset]; }
   unsigned version() { return store_[PreparseDataConstants::kVersionOffset]; }
 
+  // Whether this holds serialized code produced by CodeSerializer rather
+  // than preparse data.
+  bool is_code_cache() {
+    return store_.length() > PreparseDataConstants::kMagicOffset &&
+        magic() == PreparseDataConstants::kCodeCacheMagicNumber;
+  }
+
  private:
   Vector<unsigned> store_;
   unsigned char* symbol_data_;
@@ -161,6 +168,24 @@ class ScriptDataImpl : public ScriptData {
   static const char* ReadString(unsigned* start, int* chars);
 
   friend class ScriptData;
+  friend class CodeSerializer;
+};
+
+
+// Front ends for languages other than JavaScript build the AST of their
+// scripts directly.  Scripts of type Script::TYPE_FRONT_END are parsed,
+// and reparsed for lazy compilation and optimization, by the front end
+// installed on the isolate instead of by the JavaScript parser.
+class ParserFrontEnd {
+ public:
+  virtual ~ParserFrontEnd() { }
+
+  // Builds the function literal for the global code of info->script() or,
+  // if info->is_lazy(), for the function info->shared_info() whose source
+  // range it reported through the scope positions of an earlier parse.
+  // The literal must be allocated in the isolate's zone.  Returns NULL
+  // with a pending exception if parsing failed.
+  virtual FunctionLiteral* Parse(CompilationInfo* info) = 0;
 };
 
 
@@ -176,6 +201,15 @@ class ParserApi {
                                   v8::Extension* extension,
                                   int flags);
 
+  // Same as PreParse, but does not use the current isolate (no counters,
+  // no shared unicode cache, no pending stack overflow exception), so it
+  // can run on a thread that has not entered any isolate.  The caller
+  // supplies the stack limit of the calling thread.  Returns NULL on stack
+  // overflow.
+  static ScriptDataImpl* PreParseWithoutIsolate(UC16CharacterStream* source,
+                                                int flags,
+                                                uintptr_t stack_limit);
+
   // Preparser that only does preprocessing that makes sense if only used
   // immediately after.
   static ScriptDataImpl* PartialPreParse(Handle<String> source,
@@ -444,6 +478,11 @@ class Parser {
   FunctionLiteral* ParseProgram(CompilationInfo* info);
   FunctionLiteral* ParseLazy(CompilationInfo* info);
 
+  // If set, the entries of the functions that are preparsed instead of
+  // being fully parsed are logged to the recorder, so that a later parse
+  // of the same source can skip them using the recorded data.
+  void set_function_log(ParserRecorder* log) { function_log_ = log; }
+
   void ReportMessageAt(Scanner::Location loc,
                        const char* message,
                        Vector<const char*> args);
@@ -741,6 +780,11 @@ class Parser {
   preparser::PreParser::PreParseResult LazyParseFunctionLiteral(
        SingletonLogger* logger);
 
+  // Returns the shared function info of the inner function starting at
+  // start_position in the code of the function being recompiled, or a null
+  // handle if there is none.
+  Handle<SharedFunctionInfo> FindCompiledFunction(int start_position);
+
   Isolate* isolate_;
   ZoneList<Handle<String> > symbol_cache_;
 
@@ -752,8 +796,15 @@ class Parser {
   Target* target_stack_;  // for break, continue statements
   v8::Extension* extension_;
   ScriptDataImpl* pre_data_;
+  ParserRecorder* function_log_;
   FuncNameInferrer* fni_;
 
+  // When a function is recompiled for optimization, the shared function
+  // infos of its inner functions are taken from its unoptimized code and
+  // their bodies are skipped.
+  ZoneList<Handle<SharedFunctionInfo> >* compiled_functions_;
+  Scope* recompiled_scope_;
+
   Mode mode_;
   bool allow_natives_syntax_;
   bool allow_lazy_;
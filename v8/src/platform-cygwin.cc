@@ -308,6 +308,16 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+  // Nothing to do on Cygwin.
+}
+
+
+bool OS::ArmThreadCpuTimer(int microseconds, void (*handler)()) {
+  return false;
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   // Not supported on Cygwin.
   return 0;
@@ -37,6 +37,7 @@
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <time.h>
 
 // Ubuntu Dapper requires memory pages to be marked as
 // executable. Otherwise, OS raises an exception when executing code
@@ -78,11 +79,19 @@ double ceiling(double x) {
 static Mutex* limit_mutex = NULL;
 
 
+// Number of times a contended mutex is retried before the thread blocks in
+// the kernel.  Spinning only pays off when the owner can run at the same
+// time, so it is disabled on single processor machines.
+static const int kMutexSpinCount = 100;
+static int mutex_spin_count = 0;
+
+
 void OS::Setup() {
   // Seed the random number generator. We preserve microsecond resolution.
   uint64_t seed = Ticks() ^ (getpid() << 16);
   srandom(static_cast<unsigned int>(seed));
   limit_mutex = CreateMutex();
+  if (sysconf(_SC_NPROCESSORS_ONLN) > 1) mutex_spin_count = kMutexSpinCount;
 
 #ifdef __arm__
   // When running on ARM hardware check that the EABI used by V8 and
@@ -551,6 +560,26 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+  // Support for perf's jitdump.
+  //
+  // "perf inject --jit" finds the dump file of a process through the
+  // mmap event the kernel logs for it, so map the first page with
+  // PROT_EXEC.  Like the GC marker above the mapping is dropped at once,
+  // the event is already in the kernel's stream.
+  int size = sysconf(_SC_PAGESIZE);
+  fflush(file);
+  void* addr = mmap(OS::GetRandomMmapAddr(),
+                    size,
+                    PROT_READ | PROT_EXEC,
+                    MAP_PRIVATE,
+                    fileno(file),
+                    0);
+  if (addr == MAP_FAILED) return;
+  OS::Free(addr, size);
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   // backtrace is a glibc extension.
 #ifdef __GLIBC__
@@ -680,6 +709,25 @@ void* VirtualMemory::ReserveRegion(size_t size) {
 }
 
 
+// Makes the pages of a committed region prefer the NUMA node of the calling
+// thread.  Pages are normally placed on the node of the thread that touches
+// them first, which for the heap is often a scavenger, marking or sweeper
+// thread running on another node.
+static void PreferCurrentNumaNode(void* base, size_t size) {
+#if defined(__NR_getcpu) && defined(__NR_mbind)
+  unsigned cpu;
+  unsigned node;
+  if (syscall(__NR_getcpu, &cpu, &node, NULL) != 0) return;
+  unsigned long nodes = 1;  // NOLINT
+  if (node >= sizeof(nodes) * kBitsPerByte) return;
+  nodes <<= node;
+  const int kMemoryPolicyPreferred = 1;  // MPOL_PREFERRED in numaif.h.
+  syscall(__NR_mbind, base, size, kMemoryPolicyPreferred, &nodes,
+          sizeof(nodes) * kBitsPerByte + 1, 0);
+#endif
+}
+
+
 bool VirtualMemory::CommitRegion(void* base, size_t size, bool is_executable) {
   int prot = PROT_READ | PROT_WRITE | (is_executable ? PROT_EXEC : 0);
   if (MAP_FAILED == mmap(base,
@@ -691,6 +739,14 @@ bool VirtualMemory::CommitRegion(void* base, size_t size, bool is_executable) {
     return false;
   }
 
+#ifdef MADV_HUGEPAGE
+  // The kernel only uses huge pages for aligned 2 MB blocks of adjacent
+  // regions that all have the advice, such as a growing semispace, so
+  // single 1 MB heap pages are not affected.
+  if (FLAG_huge_pages) madvise(base, size, MADV_HUGEPAGE);
+#endif
+  if (FLAG_numa_local_heap) PreferCurrentNumaNode(base, size);
+
   UpdateAllocatedSpaceLimits(base, size);
   return true;
 }
@@ -829,6 +885,15 @@ class LinuxMutex : public Mutex {
   virtual ~LinuxMutex() { pthread_mutex_destroy(&mutex_); }
 
   virtual int Lock() {
+    // The critical sections guarded by these mutexes are short, so a
+    // contended lock is usually released again soon.  Retry for a while
+    // before letting the thread sleep in the kernel.
+    for (int i = 0; i < mutex_spin_count; i++) {
+      if (pthread_mutex_trylock(&mutex_) == 0) return 0;
+#if defined(__i386__) || defined(__x86_64__)
+      __asm__ __volatile__("pause");
+#endif
+    }
     int result = pthread_mutex_lock(&mutex_);
     return result;
   }
@@ -1017,14 +1082,152 @@ static void ProfilerSignalHandler(int signal, siginfo_t* info, void* context) {
 }
 
 
+#if !defined(ANDROID)
+#ifndef SIGEV_THREAD_ID
+#define SIGEV_THREAD_ID 4
+#endif
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#define V8_HAS_THREAD_CPU_TIMER 1
+#endif
+
+
+#ifdef V8_HAS_THREAD_CPU_TIMER
+// Time slice timers, see OS::ArmThreadCpuTimer.  Each thread gets its own
+// timer on its CPU time clock that signals the thread itself with
+// SIGVTALRM; the kernel timer id is kept in a thread-local slot, off by one
+// so that NULL means none, and deleted when the thread exits.
+static void (*time_slice_handler)() = NULL;
+static pthread_once_t time_slice_once = PTHREAD_ONCE_INIT;
+static pthread_key_t time_slice_timer_key;
+
+
+static void TimeSliceSignalHandler(int signal, siginfo_t* info, void* context) {
+  USE(info);
+  USE(context);
+  if (signal != SIGVTALRM) return;
+  void (*handler)() = time_slice_handler;
+  if (handler != NULL) handler();
+}
+
+
+static void DeleteTimeSliceTimer(void* value) {
+  int timer_id = static_cast<int>(reinterpret_cast<intptr_t>(value) - 1);
+  syscall(SYS_timer_delete, timer_id);
+}
+
+
+static void InitializeTimeSlices() {
+  pthread_key_create(&time_slice_timer_key, DeleteTimeSliceTimer);
+  struct sigaction sa;
+  sa.sa_sigaction = TimeSliceSignalHandler;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART | SA_SIGINFO;
+  sigaction(SIGVTALRM, &sa, NULL);
+}
+#endif
+
+
+bool OS::ArmThreadCpuTimer(int microseconds, void (*handler)()) {
+#ifdef V8_HAS_THREAD_CPU_TIMER
+  pthread_once(&time_slice_once, InitializeTimeSlices);
+  intptr_t slot = reinterpret_cast<intptr_t>(
+      pthread_getspecific(time_slice_timer_key));
+  int timer_id;
+  if (slot != 0) {
+    timer_id = static_cast<int>(slot - 1);
+  } else {
+    if (microseconds <= 0) return true;
+    clockid_t clock;
+    if (pthread_getcpuclockid(pthread_self(), &clock) != 0) return false;
+    struct sigevent event;
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGVTALRM;
+    event.sigev_notify_thread_id = GetThreadID();
+    if (syscall(SYS_timer_create, clock, &event, &timer_id) != 0) {
+      return false;
+    }
+    pthread_setspecific(time_slice_timer_key,
+                        reinterpret_cast<void*>(timer_id + 1));
+  }
+  if (handler != NULL) time_slice_handler = handler;
+  struct itimerspec spec;
+  if (microseconds <= 0) microseconds = 0;
+  spec.it_interval.tv_sec = microseconds / 1000000;
+  spec.it_interval.tv_nsec = (microseconds % 1000000) * 1000;
+  spec.it_value = spec.it_interval;
+  return syscall(SYS_timer_settime, timer_id, 0, &spec, NULL) == 0;
+#else
+  USE(microseconds);
+  USE(handler);
+  return false;
+#endif
+}
+
+
 class Sampler::PlatformData : public Malloced {
  public:
-  PlatformData() : vm_tid_(GetThreadID()) {}
+  PlatformData() : vm_tid_(GetThreadID()), cpu_timer_armed_(false) {
+    has_cpu_clock_ = (pthread_getcpuclockid(pthread_self(), &cpu_clock_) == 0);
+  }
+
+  ~PlatformData() { DisarmCpuTimer(); }
 
   int vm_tid() const { return vm_tid_; }
 
+  // Arms a timer on the CPU time clock of the VM thread that delivers
+  // SIGPROF to that thread whenever it has consumed another interval_us
+  // microseconds of CPU time. An idle VM thread is not interrupted and no
+  // other thread has to wake up to take samples. Returns false if the timer
+  // could not be created, in which case the caller has to send signals.
+  // The timer syscalls are used directly to avoid linking librt.
+  bool ArmCpuTimer(int interval_us) {
+#ifdef V8_HAS_THREAD_CPU_TIMER
+    if (cpu_timer_armed_) return true;
+    if (!has_cpu_clock_ || interval_us <= 0) return false;
+    struct sigevent event;
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = vm_tid_;
+    if (syscall(SYS_timer_create, cpu_clock_, &event, &cpu_timer_) != 0) {
+      has_cpu_clock_ = false;
+      return false;
+    }
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = interval_us / 1000000;
+    spec.it_interval.tv_nsec = (interval_us % 1000000) * 1000;
+    spec.it_value = spec.it_interval;
+    if (syscall(SYS_timer_settime, cpu_timer_, 0, &spec, NULL) != 0) {
+      syscall(SYS_timer_delete, cpu_timer_);
+      has_cpu_clock_ = false;
+      return false;
+    }
+    cpu_timer_armed_ = true;
+    return true;
+#else
+    USE(interval_us);
+    return false;
+#endif
+  }
+
+  void DisarmCpuTimer() {
+#ifdef V8_HAS_THREAD_CPU_TIMER
+    if (!cpu_timer_armed_) return;
+    syscall(SYS_timer_delete, cpu_timer_);
+    cpu_timer_armed_ = false;
+#endif
+  }
+
  private:
   const int vm_tid_;
+  bool has_cpu_clock_;
+  clockid_t cpu_clock_;
+  // Kernel timer id, the kernel uses an int rather than the libc timer_t.
+  int cpu_timer_;
+  bool cpu_timer_armed_;
 };
 
 
@@ -1072,6 +1275,9 @@ class SignalSender : public Thread {
   static void RemoveActiveSampler(Sampler* sampler) {
     ScopedLock lock(mutex_);
     SamplerRegistry::RemoveActiveSampler(sampler);
+    // The sender thread no longer visits the sampler, so its timer can be
+    // released without racing with DoCpuProfile.
+    sampler->platform_data()->DisarmCpuTimer();
     if (SamplerRegistry::GetState() == SamplerRegistry::HAS_NO_SAMPLERS) {
       RuntimeProfiler::StopRuntimeProfilerThreadBeforeShutdown(instance_);
       delete instance_;
@@ -1091,6 +1297,10 @@ class SignalSender : public Thread {
       if (cpu_profiling_enabled && !signal_handler_installed_) {
         InstallSignalHandler();
       } else if (!cpu_profiling_enabled && signal_handler_installed_) {
+        // Timers must not fire once the default SIGPROF action is back.
+        if (!SamplerRegistry::IterateActiveSamplers(&DisarmCpuTimer, NULL)) {
+          return;
+        }
         RestoreSignalHandler();
       }
       // When CPU profiling is enabled both JavaScript and C++ code is
@@ -1126,11 +1336,22 @@ class SignalSender : public Thread {
   }
 
   static void DoCpuProfile(Sampler* sampler, void* raw_sender) {
-    if (!sampler->IsProfiling()) return;
+    if (!sampler->IsProfiling()) {
+      sampler->platform_data()->DisarmCpuTimer();
+      return;
+    }
+    if (FLAG_prof_cpu_timer && signal_handler_installed_ &&
+        sampler->platform_data()->ArmCpuTimer(FLAG_prof_cpu_timer_interval)) {
+      return;
+    }
     SignalSender* sender = reinterpret_cast<SignalSender*>(raw_sender);
     sender->SendProfilingSignal(sampler->platform_data()->vm_tid());
   }
 
+  static void DisarmCpuTimer(Sampler* sampler, void* ignored) {
+    sampler->platform_data()->DisarmCpuTimer();
+  }
+
   static void DoRuntimeProfile(Sampler* sampler, void* ignored) {
     if (!sampler->isolate()->IsInitialized()) return;
     sampler->isolate()->runtime_profiler()->NotifyTick();
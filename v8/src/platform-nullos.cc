@@ -86,6 +86,18 @@ int64_t OS::Ticks() {
 }
 
 
+int64_t OS::MonotonicNanoseconds() {
+  UNIMPLEMENTED();
+  return 0;
+}
+
+
+int OS::GetCurrentProcessId() {
+  UNIMPLEMENTED();
+  return 0;
+}
+
+
 // Returns a string identifying the current timezone taking into
 // account daylight saving.
 const char* OS::LocalTimezone(double time) {
@@ -222,6 +234,10 @@ void OS::Guard(void* address, const size_t size) {
 }
 
 
+void OS::DiscardMemory(void* address, const size_t size) {
+}
+
+
 void OS::Sleep(int milliseconds) {
   UNIMPLEMENTED();
 }
@@ -261,6 +277,16 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+  UNIMPLEMENTED();
+}
+
+
+bool OS::ArmThreadCpuTimer(int microseconds, void (*handler)()) {
+  return false;
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   UNIMPLEMENTED();
   return 0;
@@ -347,6 +347,15 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+}
+
+
+bool OS::ArmThreadCpuTimer(int microseconds, void (*handler)()) {
+  return false;
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   // backtrace is a glibc extension.
   int frames_size = frames.length();
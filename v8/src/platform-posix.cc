@@ -84,6 +84,13 @@ void OS::Guard(void* address, const size_t size) {
 #endif  // __CYGWIN__
 
 
+void OS::DiscardMemory(void* address, const size_t size) {
+#ifdef MADV_DONTNEED
+  madvise(address, size, MADV_DONTNEED);
+#endif
+}
+
+
 void* OS::GetRandomMmapAddr() {
   Isolate* isolate = Isolate::UncheckedCurrent();
   // Note that the current isolate isn't set up in a call path via
@@ -140,6 +147,22 @@ int OS::GetUserTime(uint32_t* secs,  uint32_t* usecs) {
 }
 
 
+int64_t OS::MonotonicNanoseconds() {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+    return (static_cast<int64_t>(ts.tv_sec) * 1000000000) + ts.tv_nsec;
+  }
+#endif
+  return Ticks() * 1000;
+}
+
+
+int OS::GetCurrentProcessId() {
+  return static_cast<int>(getpid());
+}
+
+
 double OS::TimeCurrentMillis() {
   struct timeval tv;
   if (gettimeofday(&tv, NULL) < 0) return 0.0;
@@ -275,10 +298,11 @@ int OS::VSNPrintF(Vector<char> str,
 }
 
 
-#if defined(V8_TARGET_ARCH_IA32)
+#if defined(V8_TARGET_ARCH_IA32) || \
+    (defined(V8_TARGET_ARCH_ARM) && !defined(USE_SIMULATOR))
 static OS::MemCopyFunction memcopy_function = NULL;
 static Mutex* memcopy_function_mutex = OS::CreateMutex();
-// Defined in codegen-ia32.cc.
+// Defined in codegen-ia32.cc and codegen-arm.cc.
 OS::MemCopyFunction CreateMemCopyFunction();
 
 // Copy memory area to disjoint memory area.
@@ -298,7 +322,7 @@ void OS::MemCopy(void* dest, const void* src, size_t size) {
   CHECK_EQ(0, memcmp(dest, src, size));
 #endif
 }
-#endif  // V8_TARGET_ARCH_IA32
+#endif  // V8_TARGET_ARCH_IA32 || (V8_TARGET_ARCH_ARM && !USE_SIMULATOR)
 
 // ----------------------------------------------------------------------------
 // POSIX string support.
@@ -45,6 +45,12 @@
 #include "platform-tls-mac.h"
 #endif
 
+// GCC on Linux supports the __thread storage class, which is much cheaper
+// to read than a pthread key.  It is used to cache the current isolate.
+#if defined(__linux__) && defined(__GNUC__) && !defined(ANDROID)
+#define V8_THREAD_STORAGE_CLASS_SUPPORTED 1
+#endif
+
 #endif
 
 #endif  // V8_PLATFORM_TLS_H_
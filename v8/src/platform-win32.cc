@@ -573,6 +573,16 @@ int64_t OS::Ticks() {
 }
 
 
+int64_t OS::MonotonicNanoseconds() {
+  return Ticks() * 1000;
+}
+
+
+int OS::GetCurrentProcessId() {
+  return static_cast<int>(::GetCurrentProcessId());
+}
+
+
 // Returns a string identifying the current timezone taking into
 // account daylight saving.
 const char* OS::LocalTimezone(double time) {
@@ -901,6 +911,11 @@ void OS::Guard(void* address, const size_t size) {
 }
 
 
+void OS::DiscardMemory(void* address, const size_t size) {
+  VirtualAlloc(address, size, MEM_RESET, PAGE_NOACCESS);
+}
+
+
 void OS::Sleep(int milliseconds) {
   ::Sleep(milliseconds);
 }
@@ -1236,6 +1251,15 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+}
+
+
+bool OS::ArmThreadCpuTimer(int microseconds, void (*handler)()) {
+  return false;
+}
+
+
 // Walk the stack using the facilities in dbghelp.dll and tlhelp32.dll
 
 // Switch off warning 4748 (/GS can not protect parameters and local variables
@@ -1361,6 +1385,10 @@ int OS::StackWalk(Vector<OS::StackFrame> frames) {
 #else  // __MINGW32__
 void OS::LogSharedLibraryAddresses() { }
 void OS::SignalCodeMovingGC() { }
+void OS::SignalJitDumpFile(FILE* file) { }
+bool OS::ArmThreadCpuTimer(int microseconds, void (*handler)()) {
+  return false;
+}
 int OS::StackWalk(Vector<OS::StackFrame> frames) { return 0; }
 #endif  // __MINGW32__
 
@@ -121,6 +121,14 @@ class OS {
   // Used for calculating time intervals.
   static int64_t Ticks();
 
+  // Returns a timestamp in nanoseconds from the monotonic clock that
+  // "perf record -k mono" uses, where the platform has one.  Used to
+  // order jitdump records against perf samples.
+  static int64_t MonotonicNanoseconds();
+
+  // Returns the id of the current process.
+  static int GetCurrentProcessId();
+
   // Returns current time as the number of milliseconds since
   // 00:00:00 UTC, January 1, 1970.
   static double TimeCurrentMillis();
@@ -178,6 +186,11 @@ class OS {
   // Assign memory as a guard page so that access will cause an exception.
   static void Guard(void* address, const size_t size);
 
+  // Tells the operating system that the contents of the pages are no longer
+  // needed, so it can reuse their physical memory.  The pages stay
+  // accessible but their contents are undefined afterwards.
+  static void DiscardMemory(void* address, const size_t size);
+
   // Generate a random address to be used for hinting mmap().
   static void* GetRandomMmapAddr();
 
@@ -252,6 +265,18 @@ class OS {
   // using --never-compact) if accurate profiling is desired.
   static void SignalCodeMovingGC();
 
+  // Support for perf's jitdump.  Maps the jitdump file into memory with
+  // PROT_EXEC so that "perf record" logs its name and "perf inject" can
+  // find it.  Can do nothing on platforms without perf.
+  static void SignalJitDumpFile(FILE* file);
+
+  // Support for cooperative time slicing.  Arms a timer that calls the
+  // handler in signal context on the calling thread each time the thread
+  // has used the given number of microseconds of CPU time.  Arming again
+  // restarts the period; 0 microseconds disarms it.  Returns false if the
+  // platform has no per-thread CPU timers.
+  static bool ArmThreadCpuTimer(int microseconds, void (*handler)());
+
   // The return value indicates the CPU features we are sure of because of the
   // OS.  For example MacOSX doesn't run on any x86 CPUs that don't have SSE2
   // instructions.
@@ -283,7 +308,8 @@ class OS {
 
   static void ReleaseStore(volatile AtomicWord* ptr, AtomicWord value);
 
-#if defined(V8_TARGET_ARCH_IA32)
+#if defined(V8_TARGET_ARCH_IA32) || \
+    (defined(V8_TARGET_ARCH_ARM) && !defined(USE_SIMULATOR))
   // Copy memory area to disjoint memory area.
   static void MemCopy(void* dest, const void* src, size_t size);
   // Limit below which the extra overhead of the MemCopy function is likely
@@ -291,12 +317,12 @@ class OS {
   static const int kMinComplexMemCopy = 64;
   typedef void (*MemCopyFunction)(void* dest, const void* src, size_t size);
 
-#else  // V8_TARGET_ARCH_IA32
+#else  // V8_TARGET_ARCH_IA32 || (V8_TARGET_ARCH_ARM && !USE_SIMULATOR)
   static void MemCopy(void* dest, const void* src, size_t size) {
     memcpy(dest, src, size);
   }
   static const int kMinComplexMemCopy = 256;
-#endif  // V8_TARGET_ARCH_IA32
+#endif  // V8_TARGET_ARCH_IA32 || (V8_TARGET_ARCH_ARM && !USE_SIMULATOR)
 
  private:
   static const int msPerSecond = 1000;
@@ -310,6 +336,9 @@ class OS {
 // from the original object.
 class VirtualMemory {
  public:
+  // The size and alignment of a transparent huge page, for --huge-pages.
+  static const int kHugePageSize = 2 * MB;
+
   // Empty VirtualMemory object, controlling no reserved memory.
   VirtualMemory();
 
@@ -38,6 +38,8 @@ struct PreparseDataConstants {
   // Layout and constants of the preparse data exchange format.
   static const unsigned kMagicNumber = 0xBadDead;
   static const unsigned kCurrentVersion = 7;
+  // Marks data that holds serialized code instead of preparse data.
+  static const unsigned kCodeCacheMagicNumber = 0xC0DECAC;
 
   static const int kMagicOffset = 0;
   static const int kVersionOffset = 1;
@@ -29,6 +29,7 @@
 
 #include "profile-generator-inl.h"
 
+#include "frames-inl.h"
 #include "global-handles.h"
 #include "heap-profiler.h"
 #include "scopeinfo.h"
@@ -110,7 +111,7 @@ const char* StringsStorage::GetCopy(const char* src) {
   Vector<char> dst = Vector<char>::New(len + 1);
   OS::StrNCpy(dst, src, len);
   dst[len] = '\0';
-  uint32_t hash = HashSequentialString(dst.start(), len);
+  uint32_t hash = HashSequentialString(dst.start(), len, HEAP->HashSeed());
   return AddOrDisposeString(dst.start(), hash);
 }
 
@@ -143,7 +144,7 @@ const char* StringsStorage::GetVFormatted(const char* format, va_list args) {
     DeleteArray(str.start());
     return format;
   }
-  uint32_t hash = HashSequentialString(str.start(), len);
+  uint32_t hash = HashSequentialString(str.start(), len, HEAP->HashSeed());
   return AddOrDisposeString(str.start(), hash);
 }
 
@@ -153,7 +154,7 @@ const char* StringsStorage::GetName(String* name) {
     int length = Min(kMaxNameSize, name->length());
     SmartArrayPointer<char> data =
         name->ToCString(DISALLOW_NULLS, ROBUST_STRING_TRAVERSAL, 0, length);
-    uint32_t hash = HashSequentialString(*data, length);
+    uint32_t hash = HashSequentialString(*data, length, HEAP->HashSeed());
     return AddOrDisposeString(data.Detach(), hash);
   }
   return "";
@@ -166,6 +167,7 @@ const char* StringsStorage::GetName(int index) {
 
 
 const char* const CodeEntry::kEmptyNamePrefix = "";
+const char* const CodeEntry::kEmptyBailoutReason = "";
 
 
 void CodeEntry::CopyData(const CodeEntry& source) {
@@ -174,6 +176,7 @@ void CodeEntry::CopyData(const CodeEntry& source) {
   name_ = source.name_;
   resource_name_ = source.resource_name_;
   line_number_ = source.line_number_;
+  bailout_reason_ = source.bailout_reason_;
 }
 
 
@@ -472,6 +475,120 @@ CpuProfile* CpuProfile::FilteredClone(int security_token_id) {
 }
 
 
+CpuProfile::~CpuProfile() {
+  delete delta_serializer_;
+}
+
+
+CpuProfileSerializer* CpuProfile::delta_serializer() {
+  if (delta_serializer_ == NULL) {
+    delta_serializer_ = new CpuProfileSerializer(this);
+  }
+  return delta_serializer_;
+}
+
+
+const char CpuProfileSerializer::kMagic[] = "V8CP";
+
+
+void CpuProfileSerializer::Encode(List<char>* buffer) {
+  ASSERT(buffer_ == NULL);
+  buffer_ = buffer;
+  EncodeBytes(kMagic, StrLength(kMagic));
+  EncodeUnsigned(kVersion);
+  EncodeUnsigned(profile_->uid());
+  EncodeUnsigned(exports_count_++);
+  EncodeNode(profile_->top_down()->root(), 0);
+  EncodeUnsigned(kEndTag);
+  buffer_ = NULL;
+}
+
+
+void CpuProfileSerializer::Write(const List<char>& buffer,
+                                 v8::OutputStream* stream) {
+  const int chunk_size = stream->GetChunkSize();
+  ASSERT(chunk_size > 0);
+  ScopedVector<char> chunk(chunk_size);
+  for (int pos = 0; pos < buffer.length(); pos += chunk_size) {
+    int length = Min(chunk_size, buffer.length() - pos);
+    memcpy(chunk.start(), &buffer[pos], length);
+    if (stream->WriteAsciiChunk(chunk.start(), length) ==
+        v8::OutputStream::kAbort) {
+      return;
+    }
+  }
+  stream->EndOfStream();
+}
+
+
+int CpuProfileSerializer::GetEntryId(CodeEntry* entry) {
+  HashMap::Entry* cache_entry =
+      entries_.Lookup(entry, PointerHash(entry), true);
+  if (cache_entry->value == NULL) {
+    int id = entries_.occupancy();
+    cache_entry->value = reinterpret_cast<void*>(id);
+    EncodeUnsigned(kCodeEntryTag);
+    EncodeUnsigned(id);
+    EncodeUnsigned(entry->tag());
+    EncodeString(entry->name_prefix());
+    EncodeString(entry->name());
+    EncodeString(entry->resource_name());
+    EncodeUnsigned(entry->line_number());
+  }
+  return static_cast<int>(reinterpret_cast<intptr_t>(cache_entry->value));
+}
+
+
+void CpuProfileSerializer::EncodeNode(ProfileNode* node, int parent_id) {
+  HashMap::Entry* cache_entry = nodes_.Lookup(node, PointerHash(node), true);
+  if (cache_entry->value == NULL) {
+    int entry_id = GetEntryId(node->entry());
+    int id = nodes_.occupancy();
+    cache_entry->value = reinterpret_cast<void*>(id);
+    if (exported_ticks_.length() == 0) exported_ticks_.Add(0);  // Unused id 0.
+    ASSERT(exported_ticks_.length() == id);
+    exported_ticks_.Add(0);
+    EncodeUnsigned(kNodeTag);
+    EncodeUnsigned(id);
+    EncodeUnsigned(parent_id);
+    EncodeUnsigned(entry_id);
+  }
+  int id = static_cast<int>(reinterpret_cast<intptr_t>(cache_entry->value));
+  unsigned new_ticks = node->self_ticks() - exported_ticks_[id];
+  if (new_ticks > 0) {
+    EncodeUnsigned(kTicksTag);
+    EncodeUnsigned(id);
+    EncodeUnsigned(new_ticks);
+    exported_ticks_[id] = node->self_ticks();
+  }
+  const List<ProfileNode*>* children = node->children();
+  for (int i = 0; i < children->length(); i++) {
+    EncodeNode(children->at(i), id);
+  }
+}
+
+
+void CpuProfileSerializer::EncodeUnsigned(unsigned value) {
+  while (value >= 0x80) {
+    buffer_->Add(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buffer_->Add(static_cast<char>(value));
+}
+
+
+void CpuProfileSerializer::EncodeString(const char* s) {
+  int length = StrLength(s);
+  EncodeUnsigned(length);
+  EncodeBytes(s, length);
+}
+
+
+void CpuProfileSerializer::EncodeBytes(const char* s, int length) {
+  for (int i = 0; i < length; i++) buffer_->Add(s[i]);
+}
+
+
 void CpuProfile::ShortPrint() {
   OS::Print("top down ");
   top_down_.ShortPrint();
@@ -488,79 +605,170 @@ void CpuProfile::Print() {
 }
 
 
-CodeEntry* const CodeMap::kSharedFunctionCodeEntry = NULL;
-const CodeMap::CodeTreeConfig::Key CodeMap::CodeTreeConfig::kNoKey = NULL;
+static bool AddressesMatch(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
+CodeMap::CodeMap()
+    : pending_low_(NULL),
+      pending_high_(NULL),
+      cache_start_(NULL),
+      cache_end_(NULL),
+      cache_entry_(NULL),
+      shared_ids_(AddressesMatch),
+      next_shared_id_(1) {
+}
 
 
 void CodeMap::AddCode(Address addr, CodeEntry* entry, unsigned size) {
-  DeleteAllCoveredCode(addr, addr + size);
-  CodeTree::Locator locator;
-  tree_.Insert(addr, &locator);
-  locator.set_value(CodeEntryInfo(entry, size));
+  ClearCache();
+  if (pending_.is_empty() || addr < pending_low_) pending_low_ = addr;
+  if (pending_.is_empty() || addr + size > pending_high_) {
+    pending_high_ = addr + size;
+  }
+  pending_.Add(CodeEntryInfo(addr, entry, size));
 }
 
 
-void CodeMap::DeleteAllCoveredCode(Address start, Address end) {
-  List<Address> to_delete;
-  Address addr = end - 1;
-  while (addr >= start) {
-    CodeTree::Locator locator;
-    if (!tree_.FindGreatestLessThan(addr, &locator)) break;
-    Address start2 = locator.key(), end2 = start2 + locator.value().size;
-    if (start2 < end && start < end2) to_delete.Add(start2);
-    addr = start2 - 1;
+int CodeMap::CompareStart(const CodeEntryInfo* a, const CodeEntryInfo* b) {
+  return a->start < b->start ? -1 : (a->start > b->start ? 1 : 0);
+}
+
+
+int CodeMap::FindIndex(Address addr) {
+  int low = 0;
+  int high = code_.length();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (code_[mid].start <= addr) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
   }
-  for (int i = 0; i < to_delete.length(); ++i) tree_.Remove(to_delete[i]);
+  return low - 1;
 }
 
 
-CodeEntry* CodeMap::FindEntry(Address addr) {
-  CodeTree::Locator locator;
-  if (tree_.FindGreatestLessThan(addr, &locator)) {
-    // locator.key() <= addr. Need to check that addr is within entry.
-    const CodeEntryInfo& entry = locator.value();
-    if (addr < (locator.key() + entry.size))
-      return entry.entry;
+void CodeMap::Merge(const List<CodeEntryInfo>& added) {
+  List<CodeEntryInfo> merged(code_.length() + added.length());
+  int j = 0;
+  for (int i = 0; i < code_.length(); i++) {
+    const CodeEntryInfo& old = code_[i];
+    while (j < added.length() && added[j].start < old.start) {
+      if (!added[j].moved) merged.Add(added[j]);
+      j++;
+    }
+    if (old.moved) continue;
+    // Only the last added range starting before old and the first one
+    // starting at or after it can overlap it.
+    bool covered = (j > 0 && added[j - 1].end() > old.start) ||
+        (j < added.length() && added[j].start < old.end());
+    if (!covered) merged.Add(old);
+  }
+  for (; j < added.length(); j++) {
+    if (!added[j].moved) merged.Add(added[j]);
+  }
+  code_.Rewind(0);
+  code_.AddAll(merged);
+}
+
+
+void CodeMap::Flush() {
+  ClearCache();
+  List<CodeEntryInfo> added(pending_.length());
+  added.AddAll(pending_);
+  added.Sort(CompareStart);
+  bool overlapping = false;
+  for (int i = 1; i < added.length(); i++) {
+    if (added[i].start < added[i - 1].end()) {
+      overlapping = true;
+      break;
+    }
   }
-  return NULL;
+  if (!overlapping) {
+    Merge(added);
+  } else {
+    // A range was reused within the batch, so the later range has to win:
+    // merge the ranges one at a time in the order they were added.
+    for (int i = 0; i < pending_.length(); i++) {
+      added.Rewind(0);
+      added.Add(pending_[i]);
+      Merge(added);
+    }
+  }
+  pending_.Rewind(0);
+}
+
+
+CodeEntry* CodeMap::FindEntry(Address addr) {
+  if (cache_start_ <= addr && addr < cache_end_) return cache_entry_;
+  if (!pending_.is_empty()) Flush();
+  int index = FindIndex(addr);
+  if (index < 0) return NULL;
+  // The ranges do not overlap, so only the last one starting at or before
+  // addr can contain it.
+  const CodeEntryInfo& info = code_[index];
+  if (info.moved || addr >= info.end()) return NULL;
+  cache_start_ = info.start;
+  cache_end_ = info.end();
+  cache_entry_ = info.entry;
+  return info.entry;
 }
 
 
 int CodeMap::GetSharedId(Address addr) {
-  CodeTree::Locator locator;
-  // For shared function entries, 'size' field is used to store their IDs.
-  if (tree_.Find(addr, &locator)) {
-    const CodeEntryInfo& entry = locator.value();
-    ASSERT(entry.entry == kSharedFunctionCodeEntry);
-    return entry.size;
-  } else {
-    tree_.Insert(addr, &locator);
-    int id = next_shared_id_++;
-    locator.set_value(CodeEntryInfo(kSharedFunctionCodeEntry, id));
-    return id;
+  HashMap::Entry* entry =
+      shared_ids_.Lookup(addr, ComputePointerHash(addr), true);
+  if (entry->value == NULL) {
+    entry->value =
+        reinterpret_cast<void*>(static_cast<intptr_t>(next_shared_id_++));
   }
+  return static_cast<int>(reinterpret_cast<intptr_t>(entry->value));
 }
 
 
 void CodeMap::MoveCode(Address from, Address to) {
   if (from == to) return;
-  CodeTree::Locator locator;
-  if (!tree_.Find(from, &locator)) return;
-  CodeEntryInfo entry = locator.value();
-  tree_.Remove(from);
-  AddCode(to, entry.entry, entry.size);
-}
-
+  uint32_t from_hash = ComputePointerHash(from);
+  HashMap::Entry* shared = shared_ids_.Lookup(from, from_hash, false);
+  if (shared != NULL) {
+    void* id = shared->value;
+    shared_ids_.Remove(from, from_hash);
+    shared_ids_.Lookup(to, ComputePointerHash(to), true)->value = id;
+    return;
+  }
 
-void CodeMap::CodeTreePrinter::Call(
-    const Address& key, const CodeMap::CodeEntryInfo& value) {
-  OS::Print("%p %5d %s\n", key, value.size, value.entry->name());
+  // Live code does not overlap, so the code at from is the latest range
+  // starting there.
+  CodeEntryInfo* info = NULL;
+  if (!pending_.is_empty() && pending_low_ <= from && from < pending_high_) {
+    for (int i = pending_.length() - 1; i >= 0; i--) {
+      if (pending_[i].start == from && !pending_[i].moved) {
+        info = &pending_[i];
+        break;
+      }
+    }
+  }
+  if (info == NULL) {
+    int index = FindIndex(from);
+    if (index >= 0 && code_[index].start == from && !code_[index].moved) {
+      info = &code_[index];
+    }
+  }
+  if (info == NULL) return;
+  info->moved = true;
+  AddCode(to, info->entry, info->size);
 }
 
 
 void CodeMap::Print() {
-  CodeTreePrinter printer;
-  tree_.ForEach(&printer);
+  if (!pending_.is_empty()) Flush();
+  for (int i = 0; i < code_.length(); i++) {
+    const CodeEntryInfo& info = code_[i];
+    OS::Print("%p %5d %s\n", info.start, info.size, info.entry->name());
+  }
 }
 
 
@@ -831,6 +1039,23 @@ void CpuProfilesCollection::AddPathToCurrentProfiles(
 }
 
 
+bool CpuProfilesCollection::EncodeCurrentProfileDelta(const char* title,
+                                                      List<char>* buffer) {
+  // Keeps the profile generator thread from adding samples meanwhile.
+  bool found = false;
+  current_profiles_semaphore_->Wait();
+  for (int i = current_profiles_.length() - 1; i >= 0; --i) {
+    if (strcmp(current_profiles_[i]->title(), title) == 0) {
+      current_profiles_[i]->delta_serializer()->Encode(buffer);
+      found = true;
+      break;
+    }
+  }
+  current_profiles_semaphore_->Signal();
+  return found;
+}
+
+
 void SampleRateCalculator::Tick() {
   if (--wall_time_query_countdown_ == 0)
     UpdateMeasurements(OS::TimeCurrentMillis());
@@ -933,7 +1158,7 @@ void HeapGraphEdge::Init(
   child_index_ = child_index;
   type_ = type;
   name_ = name;
-  to_ = to;
+  set_to(to);
 }
 
 
@@ -942,7 +1167,7 @@ void HeapGraphEdge::Init(int child_index, Type type, int index, HeapEntry* to) {
   child_index_ = child_index;
   type_ = type;
   index_ = index;
-  to_ = to;
+  set_to(to);
 }
 
 
@@ -971,13 +1196,9 @@ void HeapEntry::Init(HeapSnapshot* snapshot,
   retained_size_ = 0;
   children_count_ = children_count;
   retainers_count_ = retainers_count;
-  dominator_ = NULL;
-
-  union {
-    uint64_t set_id;
-    Id stored_id;
-  } id_adaptor = {id};
-  id_ = id_adaptor.stored_id;
+  dominator_offset_ = kNoDominator;
+  ASSERT(id <= kMaxUInt32);
+  id_ = static_cast<uint32_t>(id);
 }
 
 
@@ -987,7 +1208,8 @@ void HeapEntry::SetNamedReference(HeapGraphEdge::Type type,
                                   HeapEntry* entry,
                                   int retainer_index) {
   children_arr()[child_index].Init(child_index, type, name, entry);
-  entry->retainers_arr()[retainer_index] = children_arr() + child_index;
+  entry->retainers_arr()[retainer_index] =
+      entry->OffsetTo(children_arr() + child_index);
 }
 
 
@@ -997,7 +1219,8 @@ void HeapEntry::SetIndexedReference(HeapGraphEdge::Type type,
                                     HeapEntry* entry,
                                     int retainer_index) {
   children_arr()[child_index].Init(child_index, type, index, entry);
-  entry->retainers_arr()[retainer_index] = children_arr() + child_index;
+  entry->retainers_arr()[retainer_index] =
+      entry->OffsetTo(children_arr() + child_index);
 }
 
 
@@ -1121,7 +1344,8 @@ int HeapEntry::EntriesSize(int entries_count,
                            int retainers_count) {
   return sizeof(HeapEntry) * entries_count         // NOLINT
       + sizeof(HeapGraphEdge) * children_count     // NOLINT
-      + sizeof(HeapGraphEdge*) * retainers_count;  // NOLINT
+      + sizeof(int32_t) * retainers_count          // NOLINT
+      + kEntryPadding * entries_count;
 }
 
 
@@ -1186,12 +1410,12 @@ template <size_t ptr_size> struct SnapshotSizeConstants;
 
 template <> struct SnapshotSizeConstants<4> {
   static const int kExpectedHeapGraphEdgeSize = 12;
-  static const int kExpectedHeapEntrySize = 36;
+  static const int kExpectedHeapEntrySize = 32;
 };
 
 template <> struct SnapshotSizeConstants<8> {
-  static const int kExpectedHeapGraphEdgeSize = 24;
-  static const int kExpectedHeapEntrySize = 48;
+  static const int kExpectedHeapGraphEdgeSize = 16;
+  static const int kExpectedHeapEntrySize = 40;
 };
 
 }  // namespace
@@ -1462,13 +1686,16 @@ void HeapObjectsMap::RemoveDeadEntries() {
 
 
 uint64_t HeapObjectsMap::GenerateId(v8::RetainedObjectInfo* info) {
-  uint64_t id = static_cast<uint64_t>(info->GetHash());
+  uint32_t id = static_cast<uint32_t>(info->GetHash());
   const char* label = info->GetLabel();
-  id ^= HashSequentialString(label, static_cast<int>(strlen(label)));
+  id ^= HashSequentialString(label,
+                             static_cast<int>(strlen(label)),
+                             HEAP->HashSeed());
   intptr_t element_count = info->GetElementCount();
   if (element_count != -1)
     id ^= ComputeIntegerHash(static_cast<uint32_t>(element_count));
-  return id << 1;
+  // Keep ids within 32 bits, which is what snapshot entries store.
+  return static_cast<uint64_t>(id & (kMaxUInt32 >> 1)) << 1;
 }
 
 
@@ -1561,9 +1788,6 @@ HeapEntriesMap::HeapEntriesMap()
 
 
 HeapEntriesMap::~HeapEntriesMap() {
-  for (HashMap::Entry* p = entries_.Start(); p != NULL; p = entries_.Next(p)) {
-    delete reinterpret_cast<EntryInfo*>(p->value);
-  }
 }
 
 
@@ -1571,7 +1795,7 @@ void HeapEntriesMap::AllocateEntries() {
   for (HashMap::Entry* p = entries_.Start();
        p != NULL;
        p = entries_.Next(p)) {
-    EntryInfo* entry_info = reinterpret_cast<EntryInfo*>(p->value);
+    EntryInfo* entry_info = GetEntryInfo(p);
     entry_info->entry = entry_info->allocator->AllocateEntry(
         p->key,
         entry_info->children_count,
@@ -1587,8 +1811,7 @@ void HeapEntriesMap::AllocateEntries() {
 HeapEntry* HeapEntriesMap::Map(HeapThing thing) {
   HashMap::Entry* cache_entry = entries_.Lookup(thing, Hash(thing), false);
   if (cache_entry != NULL) {
-    EntryInfo* entry_info = reinterpret_cast<EntryInfo*>(cache_entry->value);
-    return entry_info->entry;
+    return GetEntryInfo(cache_entry)->entry;
   } else {
     return NULL;
   }
@@ -1599,7 +1822,8 @@ void HeapEntriesMap::Pair(
     HeapThing thing, HeapEntriesAllocator* allocator, HeapEntry* entry) {
   HashMap::Entry* cache_entry = entries_.Lookup(thing, Hash(thing), true);
   ASSERT(cache_entry->value == NULL);
-  cache_entry->value = new EntryInfo(entry, allocator);
+  cache_entry->value = reinterpret_cast<void*>(entries_info_.length());
+  entries_info_.Add(EntryInfo(entry, allocator));
   ++entries_count_;
 }
 
@@ -1611,10 +1835,8 @@ void HeapEntriesMap::CountReference(HeapThing from, HeapThing to,
   HashMap::Entry* to_cache_entry = entries_.Lookup(to, Hash(to), false);
   ASSERT(from_cache_entry != NULL);
   ASSERT(to_cache_entry != NULL);
-  EntryInfo* from_entry_info =
-      reinterpret_cast<EntryInfo*>(from_cache_entry->value);
-  EntryInfo* to_entry_info =
-      reinterpret_cast<EntryInfo*>(to_cache_entry->value);
+  EntryInfo* from_entry_info = GetEntryInfo(from_cache_entry);
+  EntryInfo* to_entry_info = GetEntryInfo(to_cache_entry);
   if (prev_children_count)
     *prev_children_count = from_entry_info->children_count;
   if (prev_retainers_count)
@@ -2984,19 +3206,22 @@ bool HeapSnapshotGenerator::BuildDominatorTree(
     changed = 0;
     for (int i = root_index - 1; i >= 0; --i) {
       HeapEntry* new_idom = NULL;
-      Vector<HeapGraphEdge*> rets = entries[i]->retainers();
+      HeapEntry* entry = entries[i];
+      const int retainers_count = entry->retainers_count();
       int j = 0;
-      for (; j < rets.length(); ++j) {
-        if (rets[j]->type() == HeapGraphEdge::kShortcut) continue;
-        HeapEntry* ret = rets[j]->From();
+      for (; j < retainers_count; ++j) {
+        HeapGraphEdge* retainer = entry->retainer(j);
+        if (retainer->type() == HeapGraphEdge::kShortcut) continue;
+        HeapEntry* ret = retainer->From();
         if (dominators->at(ret->ordered_index()) != NULL) {
           new_idom = ret;
           break;
         }
       }
-      for (++j; j < rets.length(); ++j) {
-        if (rets[j]->type() == HeapGraphEdge::kShortcut) continue;
-        HeapEntry* ret = rets[j]->From();
+      for (++j; j < retainers_count; ++j) {
+        HeapGraphEdge* retainer = entry->retainer(j);
+        if (retainer->type() == HeapGraphEdge::kShortcut) continue;
+        HeapEntry* ret = retainer->From();
         if (dominators->at(ret->ordered_index()) != NULL) {
           new_idom = entries[Intersect(ret->ordered_index(),
                                        new_idom->ordered_index(),
@@ -3192,31 +3417,40 @@ void HeapSnapshotJSONSerializer::SerializeImpl() {
 }
 
 
-class HeapSnapshotJSONSerializerEnumerator {
- public:
-  explicit HeapSnapshotJSONSerializerEnumerator(HeapSnapshotJSONSerializer* s)
-      : s_(s) {
-  }
-  void Apply(HeapEntry** entry) {
-    s_->GetNodeId(*entry);
-  }
- private:
-  HeapSnapshotJSONSerializer* s_;
-};
+static int SortByAddresses(HeapEntry* const* x, HeapEntry* const* y) {
+  if (*x == *y) return 0;
+  return *x < *y ? -1 : 1;
+}
+
 
 void HeapSnapshotJSONSerializer::EnumerateNodes() {
-  GetNodeId(snapshot_->root());  // Make sure root gets the first id.
-  HeapSnapshotJSONSerializerEnumerator iter(this);
-  snapshot_->IterateEntries(&iter);
+  List<HeapEntry*>* entries = snapshot_->entries();
+  nodes_.Initialize(entries->length());
+  nodes_.AddAll(*entries);
+  nodes_.Sort(SortByAddresses);
+  node_positions_.Initialize(nodes_.length());
+  node_positions_.AddBlock(0, nodes_.length());
 }
 
 
 int HeapSnapshotJSONSerializer::GetNodeId(HeapEntry* entry) {
-  HashMap::Entry* cache_entry = nodes_.Lookup(entry, ObjectHash(entry), true);
-  if (cache_entry->value == NULL) {
-    cache_entry->value = reinterpret_cast<void*>(next_node_id_++);
+  // Perform a binary search by address.
+  int low = 0;
+  int high = nodes_.length() - 1;
+  while (low <= high) {
+    int mid =
+        (static_cast<unsigned int>(low) + static_cast<unsigned int>(high)) >> 1;
+    HeapEntry* mid_entry = nodes_[mid];
+    if (mid_entry > entry) {
+      high = mid - 1;
+    } else if (mid_entry < entry) {
+      low = mid + 1;
+    } else {
+      return node_positions_[mid];
+    }
   }
-  return static_cast<int>(reinterpret_cast<intptr_t>(cache_entry->value));
+  UNREACHABLE();
+  return 0;
 }
 
 
@@ -3325,23 +3559,31 @@ void HeapSnapshotJSONSerializer::SerializeNodes() {
   const int node_fields_count = 7;
   // type,name,id,self_size,retained_size,dominator,children_count.
   const int edge_fields_count = 3;  // type,name|index,to_node.
-  List<HashMap::Entry*> sorted_nodes;
-  SortHashMap(&nodes_, &sorted_nodes);
-  // Rewrite node ids, so they refer to actual array positions.
-  if (sorted_nodes.length() > 1) {
-    // Nodes start from array index 1.
-    int prev_value = 1;
-    sorted_nodes[0]->value = reinterpret_cast<void*>(prev_value);
-    for (int i = 1; i < sorted_nodes.length(); ++i) {
-      HeapEntry* prev_heap_entry =
-          reinterpret_cast<HeapEntry*>(sorted_nodes[i-1]->key);
-      prev_value += node_fields_count +
-          prev_heap_entry->children().length() * edge_fields_count;
-      sorted_nodes[i]->value = reinterpret_cast<void*>(prev_value);
-    }
-  }
-  for (int i = 0; i < sorted_nodes.length(); ++i) {
-    SerializeNode(reinterpret_cast<HeapEntry*>(sorted_nodes[i]->key));
+  // Node ids refer to actual array positions. Nodes start from array
+  // index 1 with the root, the rest follow in address order.
+  HeapEntry* root = snapshot_->root();
+  int root_index = -1;
+  int position = 1;
+  for (int i = 0; i < nodes_.length(); ++i) {
+    if (nodes_[i] == root) {
+      root_index = i;
+      break;
+    }
+  }
+  ASSERT(root_index != -1);
+  node_positions_[root_index] = position;
+  position += node_fields_count + root->children().length() * edge_fields_count;
+  for (int i = 0; i < nodes_.length(); ++i) {
+    if (i == root_index) continue;
+    node_positions_[i] = position;
+    position += node_fields_count +
+        nodes_[i]->children().length() * edge_fields_count;
+  }
+  SerializeNode(root);
+  if (writer_->aborted()) return;
+  for (int i = 0; i < nodes_.length(); ++i) {
+    if (i == root_index) continue;
+    SerializeNode(nodes_[i]);
     if (writer_->aborted()) return;
   }
 }
@@ -3365,53 +3607,59 @@ static void WriteUChar(OutputStreamWriter* w, unibrow::uchar u) {
   w->AddCharacter(hex_chars[u & 0xf]);
 }
 
-void HeapSnapshotJSONSerializer::SerializeString(const unsigned char* s) {
-  writer_->AddCharacter('\n');
-  writer_->AddCharacter('\"');
+
+static void WriteJSONString(OutputStreamWriter* w, const unsigned char* s) {
+  w->AddCharacter('\"');
   for ( ; *s != '\0'; ++s) {
     switch (*s) {
       case '\b':
-        writer_->AddString("\\b");
+        w->AddString("\\b");
         continue;
       case '\f':
-        writer_->AddString("\\f");
+        w->AddString("\\f");
         continue;
       case '\n':
-        writer_->AddString("\\n");
+        w->AddString("\\n");
         continue;
       case '\r':
-        writer_->AddString("\\r");
+        w->AddString("\\r");
         continue;
       case '\t':
-        writer_->AddString("\\t");
+        w->AddString("\\t");
         continue;
       case '\"':
       case '\\':
-        writer_->AddCharacter('\\');
-        writer_->AddCharacter(*s);
+        w->AddCharacter('\\');
+        w->AddCharacter(*s);
         continue;
       default:
         if (*s > 31 && *s < 128) {
-          writer_->AddCharacter(*s);
+          w->AddCharacter(*s);
         } else if (*s <= 31) {
           // Special character with no dedicated literal.
-          WriteUChar(writer_, *s);
+          WriteUChar(w, *s);
         } else {
           // Convert UTF-8 into \u UTF-16 literal.
           unsigned length = 1, cursor = 0;
           for ( ; length <= 4 && *(s + length) != '\0'; ++length) { }
           unibrow::uchar c = unibrow::Utf8::CalculateValue(s, length, &cursor);
           if (c != unibrow::Utf8::kBadChar) {
-            WriteUChar(writer_, c);
+            WriteUChar(w, c);
             ASSERT(cursor != 0);
             s += cursor - 1;
           } else {
-            writer_->AddCharacter('?');
+            w->AddCharacter('?');
           }
         }
     }
   }
-  writer_->AddCharacter('\"');
+  w->AddCharacter('\"');
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeString(const unsigned char* s) {
+  writer_->AddCharacter('\n');
+  WriteJSONString(writer_, s);
 }
 
 
@@ -3449,4 +3697,175 @@ void HeapSnapshotJSONSerializer::SortHashMap(
   sorted_entries->Sort(SortUsingEntryValue);
 }
 
+
+AllocationSampler::StackNode::~StackNode() {
+  for (int i = 0; i < children_.length(); ++i) delete children_[i];
+}
+
+
+AllocationSampler::StackNode* AllocationSampler::StackNode::FindOrAddChild(
+    const char* name, const char* script_name, int position) {
+  // Names come from a StringsStorage, so equal names share their address.
+  for (int i = 0; i < children_.length(); ++i) {
+    StackNode* child = children_[i];
+    if (child->name_ == name &&
+        child->script_name_ == script_name &&
+        child->position_ == position) {
+      return child;
+    }
+  }
+  StackNode* child = new StackNode(this, name, script_name, position);
+  children_.Add(child);
+  return child;
+}
+
+
+AllocationSampler::AllocationSampler(Isolate* isolate,
+                                     intptr_t sample_interval)
+    : isolate_(isolate),
+      sample_interval_(sample_interval),
+      bytes_until_sample_(0),
+      root_(NULL, "(root)", "", 0),
+      samples_(SamplesMatch) {
+  ASSERT(sample_interval > 0);
+  bytes_until_sample_ = NextSampleInterval();
+}
+
+
+AllocationSampler::~AllocationSampler() {
+  GlobalHandles* global_handles = isolate_->global_handles();
+  for (HashMap::Entry* p = samples_.Start(); p != NULL; p = samples_.Next(p)) {
+    Object** location = reinterpret_cast<Object**>(p->value);
+    global_handles->ClearWeakness(location);
+    global_handles->Destroy(location);
+    delete reinterpret_cast<Sample*>(p->key);
+  }
+}
+
+
+intptr_t AllocationSampler::NextSampleInterval() {
+  // Gaps between samples of a Poisson process are exponentially
+  // distributed. Map the random value into (0, 1] to keep log finite.
+  double u = (V8::RandomPrivate(isolate_) + 1.0) / 4294967296.0;
+  double next = -log(u) * static_cast<double>(sample_interval_);
+  // Guard against outliers that would stop sampling for a long time.
+  next = Min(next, 20.0 * static_cast<double>(sample_interval_));
+  return Max(static_cast<intptr_t>(next), static_cast<intptr_t>(kPointerSize));
+}
+
+
+bool AllocationSampler::AllocationEvent(HeapObject* object,
+                                        int size,
+                                        intptr_t bytes_allocated) {
+  bytes_until_sample_ -= bytes_allocated;
+  if (bytes_until_sample_ > 0) return false;
+  SampleObject(object, size);
+  bytes_until_sample_ = NextSampleInterval();
+  return true;
+}
+
+
+AllocationSampler::StackNode* AllocationSampler::CaptureStack() {
+  // The sampled object is not initialized yet and nothing may be allocated
+  // in the V8 heap here, so the stack is walked with raw pointers only.
+  struct Frame {
+    const char* name;
+    const char* script_name;
+    int position;
+  };
+  Frame frames[kMaxStackDepth];
+  int depth = 0;
+  for (JavaScriptFrameIterator it(isolate_);
+       !it.done() && depth < kMaxStackDepth;
+       it.Advance()) {
+    JSFunction* function = JSFunction::cast(it.frame()->function());
+    SharedFunctionInfo* shared = function->shared();
+    Frame& frame = frames[depth++];
+    frame.name = names_.GetFunctionName(shared->DebugName());
+    frame.script_name = "";
+    if (shared->script()->IsScript()) {
+      Object* script_name = Script::cast(shared->script())->name();
+      if (script_name->IsString()) {
+        frame.script_name = names_.GetName(String::cast(script_name));
+      }
+    }
+    frame.position = shared->start_position();
+  }
+  // Frames are iterated from the innermost one, the tree grows from the
+  // outermost one.
+  StackNode* node = &root_;
+  for (int i = depth - 1; i >= 0; --i) {
+    node = node->FindOrAddChild(
+        frames[i].name, frames[i].script_name, frames[i].position);
+  }
+  return node;
+}
+
+
+void AllocationSampler::SampleObject(HeapObject* object, int size) {
+  Sample* sample = new Sample;
+  sample->sampler = this;
+  sample->node = CaptureStack();
+  sample->size = size;
+  sample->node->live_size_ += size;
+  sample->node->live_count_++;
+  GlobalHandles* global_handles = isolate_->global_handles();
+  Handle<Object> handle = global_handles->Create(object);
+  global_handles->MakeWeak(handle.location(), sample, SampleDiedCallback);
+  global_handles->MarkIndependent(handle.location());
+  HashMap::Entry* entry =
+      samples_.Lookup(sample, ComputePointerHash(sample), true);
+  entry->value = handle.location();
+}
+
+
+void AllocationSampler::SampleDiedCallback(v8::Persistent<v8::Value> handle,
+                                           void* parameter) {
+  Sample* sample = reinterpret_cast<Sample*>(parameter);
+  sample->sampler->SampleDied(sample);
+  handle.Dispose();
+}
+
+
+void AllocationSampler::SampleDied(Sample* sample) {
+  sample->node->live_size_ -= sample->size;
+  sample->node->live_count_--;
+  samples_.Remove(sample, ComputePointerHash(sample));
+  delete sample;
+}
+
+
+void AllocationSampler::Serialize(v8::OutputStream* stream) {
+  OutputStreamWriter writer(stream);
+  writer.AddString("{\"interval\":");
+  writer.AddNumber(static_cast<int>(sample_interval_));
+  writer.AddString(",\"head\":");
+  SerializeNode(&writer, &root_);
+  writer.AddCharacter('}');
+  writer.Finalize();
+}
+
+
+void AllocationSampler::SerializeNode(OutputStreamWriter* writer,
+                                      StackNode* node) {
+  if (writer->aborted()) return;
+  writer->AddString("{\"functionName\":");
+  WriteJSONString(writer, reinterpret_cast<const unsigned char*>(node->name_));
+  writer->AddString(",\"scriptName\":");
+  WriteJSONString(writer,
+                  reinterpret_cast<const unsigned char*>(node->script_name_));
+  writer->AddString(",\"position\":");
+  writer->AddNumber(node->position_);
+  writer->AddString(",\"selfSize\":");
+  writer->AddNumber(static_cast<int>(node->live_size_));
+  writer->AddString(",\"count\":");
+  writer->AddNumber(node->live_count_);
+  writer->AddString(",\"children\":[");
+  for (int i = 0; i < node->children_.length(); ++i) {
+    if (i > 0) writer->AddCharacter(',');
+    SerializeNode(writer, node->children_[i]);
+  }
+  writer->AddString("]}");
+}
+
 } }  // namespace v8::internal
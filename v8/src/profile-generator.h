@@ -100,6 +100,7 @@ class CodeEntry {
                    int security_token_id));
 
   INLINE(bool is_js_function() const) { return is_js_function_tag(tag_); }
+  INLINE(Logger::LogEventsAndTags tag() const) { return tag_; }
   INLINE(const char* name_prefix() const) { return name_prefix_; }
   INLINE(bool has_name_prefix() const) { return name_prefix_[0] != '\0'; }
   INLINE(const char* name() const) { return name_; }
@@ -108,6 +109,10 @@ class CodeEntry {
   INLINE(int shared_id() const) { return shared_id_; }
   INLINE(void set_shared_id(int shared_id)) { shared_id_ = shared_id; }
   INLINE(int security_token_id() const) { return security_token_id_; }
+  INLINE(const char* bailout_reason() const) { return bailout_reason_; }
+  INLINE(void set_bailout_reason(const char* bailout_reason)) {
+    bailout_reason_ = bailout_reason;
+  }
 
   INLINE(static bool is_js_function_tag(Logger::LogEventsAndTags tag));
 
@@ -116,6 +121,7 @@ class CodeEntry {
   bool IsSameAs(CodeEntry* entry) const;
 
   static const char* const kEmptyNamePrefix;
+  static const char* const kEmptyBailoutReason;
 
  private:
   Logger::LogEventsAndTags tag_;
@@ -125,6 +131,8 @@ class CodeEntry {
   int line_number_;
   int shared_id_;
   int security_token_id_;
+  // Why the optimizing compiler gave up on the function, if it did.
+  const char* bailout_reason_;
 
   DISALLOW_COPY_AND_ASSIGN(CodeEntry);
 };
@@ -206,10 +214,13 @@ class ProfileTree {
 };
 
 
+class CpuProfileSerializer;
+
 class CpuProfile {
  public:
   CpuProfile(const char* title, unsigned uid)
-      : title_(title), uid_(uid) { }
+      : title_(title), uid_(uid), delta_serializer_(NULL) { }
+  ~CpuProfile();
 
   // Add pc -> ... -> main() call path to the profile.
   void AddPath(const Vector<CodeEntry*>& path);
@@ -224,6 +235,10 @@ class CpuProfile {
 
   void UpdateTicksScale();
 
+  // Serializer remembering what previous exports of this profile contained,
+  // used to export a profile that is still being collected in pieces.
+  CpuProfileSerializer* delta_serializer();
+
   void ShortPrint();
   void Print();
 
@@ -232,14 +247,76 @@ class CpuProfile {
   unsigned uid_;
   ProfileTree top_down_;
   ProfileTree bottom_up_;
+  CpuProfileSerializer* delta_serializer_;
 
   DISALLOW_COPY_AND_ASSIGN(CpuProfile);
 };
 
 
+// Writes the top down tree of a CPU profile in the compact binary format
+// described at v8::CpuProfile::Serialize. Each Encode call covers the code
+// entries, nodes and self ticks added since the previous call on the same
+// serializer, so a fresh serializer exports the whole profile.
+class CpuProfileSerializer {
+ public:
+  explicit CpuProfileSerializer(CpuProfile* profile)
+      : profile_(profile),
+        entries_(PointersMatch),
+        nodes_(PointersMatch),
+        exports_count_(0),
+        buffer_(NULL) {
+  }
+
+  void Encode(List<char>* buffer);
+  static void Write(const List<char>& buffer, v8::OutputStream* stream);
+
+  enum RecordTag {
+    kEndTag = 0,
+    kCodeEntryTag = 1,
+    kNodeTag = 2,
+    kTicksTag = 3
+  };
+  static const char kMagic[];
+  static const int kVersion = 1;
+
+ private:
+  INLINE(static bool PointersMatch(void* key1, void* key2)) {
+    return key1 == key2;
+  }
+
+  INLINE(static uint32_t PointerHash(const void* key)) {
+    return ComputeIntegerHash(
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(key)));
+  }
+
+  int GetEntryId(CodeEntry* entry);
+  void EncodeNode(ProfileNode* node, int parent_id);
+  void EncodeUnsigned(unsigned value);
+  void EncodeString(const char* s);
+  void EncodeBytes(const char* s, int length);
+
+  CpuProfile* profile_;
+  // Mapping from CodeEntry* and ProfileNode* to the ids already exported.
+  HashMap entries_;
+  HashMap nodes_;
+  // Self ticks of each node as of the previous export, indexed by node id.
+  List<unsigned> exported_ticks_;
+  int exports_count_;
+  List<char>* buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(CpuProfileSerializer);
+};
+
+
+// Maps code addresses to their entries.  The code ranges are kept in an
+// array sorted by start address, so resolving the addresses of a tick is a
+// binary search that writes nothing.  Added ranges are buffered and merged
+// into the array in one pass before the next lookup, so the code events of
+// startup or of a GC do not each shift the whole array.  The range of the
+// last hit is cached, as consecutive ticks mostly land in the same code.
 class CodeMap {
  public:
-  CodeMap() : next_shared_id_(1) { }
+  CodeMap();
   void AddCode(Address addr, CodeEntry* entry, unsigned size);
   void MoveCode(Address from, Address to);
   CodeEntry* FindEntry(Address addr);
@@ -249,34 +326,42 @@ class CodeMap {
 
  private:
   struct CodeEntryInfo {
-    CodeEntryInfo(CodeEntry* an_entry, unsigned a_size)
-        : entry(an_entry), size(a_size) { }
+    CodeEntryInfo() : start(NULL), entry(NULL), size(0), moved(false) { }
+    CodeEntryInfo(Address a_start, CodeEntry* an_entry, unsigned a_size)
+        : start(a_start), entry(an_entry), size(a_size), moved(false) { }
+    Address end() const { return start + size; }
+    Address start;
     CodeEntry* entry;
     unsigned size;
+    // The code has moved away.  A moved pending range still removes the
+    // older ranges it overlaps when it is merged.
+    bool moved;
   };
 
-  struct CodeTreeConfig {
-    typedef Address Key;
-    typedef CodeEntryInfo Value;
-    static const Key kNoKey;
-    static const Value NoValue() { return CodeEntryInfo(NULL, 0); }
-    static int Compare(const Key& a, const Key& b) {
-      return a < b ? -1 : (a > b ? 1 : 0);
-    }
-  };
-  typedef SplayTree<CodeTreeConfig> CodeTree;
-
-  class CodeTreePrinter {
-   public:
-    void Call(const Address& key, const CodeEntryInfo& value);
-  };
-
-  void DeleteAllCoveredCode(Address start, Address end);
-
-  // Fake CodeEntry pointer to distinguish shared function entries.
-  static CodeEntry* const kSharedFunctionCodeEntry;
-
-  CodeTree tree_;
+  static int CompareStart(const CodeEntryInfo* a, const CodeEntryInfo* b);
+
+  // Returns the index of the last range in code_ starting at or before
+  // addr, or -1.
+  int FindIndex(Address addr);
+  // Merges the pending ranges into code_.
+  void Flush();
+  // Merges ranges sorted by start that do not overlap each other into
+  // code_, removing the ranges of code_ they overlap.
+  void Merge(const List<CodeEntryInfo>& added);
+  void ClearCache() { cache_start_ = cache_end_ = NULL; }
+
+  // Sorted by start address; the ranges do not overlap.
+  List<CodeEntryInfo> code_;
+  // Ranges added since the last lookup, in the order of the events.
+  List<CodeEntryInfo> pending_;
+  Address pending_low_;
+  Address pending_high_;
+
+  Address cache_start_;
+  Address cache_end_;
+  CodeEntry* cache_entry_;
+
+  HashMap shared_ids_;
   int next_shared_id_;
 
   DISALLOW_COPY_AND_ASSIGN(CodeMap);
@@ -316,6 +401,10 @@ class CpuProfilesCollection {
   // Called from profile generator thread.
   void AddPathToCurrentProfiles(const Vector<CodeEntry*>& path);
 
+  // Encodes what the profile being collected under the given title gained
+  // since its previous export. Returns false if there is no such profile.
+  bool EncodeCurrentProfileDelta(const char* title, List<char>* buffer);
+
   // Limits the number of profiles that can be simultaneously collected.
   static const int kMaxSimultaneousProfiles = 100;
 
@@ -419,6 +508,10 @@ class ProfileGenerator {
     return profiles_->NewCodeEntry(security_token_id);
   }
 
+  INLINE(const char* GetName(String* name)) {
+    return profiles_->GetName(name);
+  }
+
   void RecordTickSample(const TickSample& sample);
 
   INLINE(CodeMap* code_map()) { return &code_map_; }
@@ -475,18 +568,28 @@ class HeapGraphEdge BASE_EMBEDDED {
            || type_ == kShortcut);
     return name_;
   }
-  HeapEntry* to() { return to_; }
+  HeapEntry* to() {
+    return reinterpret_cast<HeapEntry*>(
+        reinterpret_cast<char*>(this) + to_offset_);
+  }
 
   HeapEntry* From();
 
  private:
+  void set_to(HeapEntry* to) {
+    to_offset_ = static_cast<int32_t>(
+        reinterpret_cast<char*>(to) - reinterpret_cast<char*>(this));
+  }
+
   int child_index_ : 29;
   unsigned type_ : 3;
+  // Edges and entries of a snapshot live in one raw buffer, which is
+  // smaller than 2GB, so the target is kept as an offset from the edge.
+  int32_t to_offset_;
   union {
     int index_;
     const char* name_;
   };
-  HeapEntry* to_;
 
   DISALLOW_COPY_AND_ASSIGN(HeapGraphEdge);
 };
@@ -505,13 +608,16 @@ class HeapSnapshot;
 //           ...         } children_count
 //      HeapGraphEdge    |
 //   +-----------------+
-//      HeapGraphEdge*   |
+//      int32_t          |
 //           ...         } retainers_count
-//      HeapGraphEdge*   |
+//      int32_t          |
 //   +-----------------+
 //
 // In a HeapSnapshot, all entries are hand-allocated in a continuous array
-// of raw bytes.
+// of raw bytes. References between entries and edges of a snapshot are
+// stored as 32-bit offsets from the referencing entry or edge: retainers
+// are offsets of the retaining edges, and an entry is padded to keep the
+// next one pointer aligned.
 //
 class HeapEntry BASE_EMBEDDED {
  public:
@@ -539,7 +645,7 @@ class HeapEntry BASE_EMBEDDED {
   HeapSnapshot* snapshot() { return snapshot_; }
   Type type() { return static_cast<Type>(type_); }
   const char* name() { return name_; }
-  inline uint64_t id();
+  uint64_t id() { return id_; }
   int self_size() { return self_size_; }
   int retained_size() { return retained_size_; }
   void add_retained_size(int size) { retained_size_ += size; }
@@ -549,12 +655,20 @@ class HeapEntry BASE_EMBEDDED {
 
   Vector<HeapGraphEdge> children() {
     return Vector<HeapGraphEdge>(children_arr(), children_count_); }
-  Vector<HeapGraphEdge*> retainers() {
-    return Vector<HeapGraphEdge*>(retainers_arr(), retainers_count_); }
-  HeapEntry* dominator() { return dominator_; }
+  int retainers_count() { return retainers_count_; }
+  HeapGraphEdge* retainer(int index) {
+    ASSERT(index >= 0 && index < retainers_count_);
+    return reinterpret_cast<HeapGraphEdge*>(
+        reinterpret_cast<char*>(this) + retainers_arr()[index]);
+  }
+  HeapEntry* dominator() {
+    if (dominator_offset_ == kNoDominator) return NULL;
+    return reinterpret_cast<HeapEntry*>(
+        reinterpret_cast<char*>(this) + dominator_offset_);
+  }
   void set_dominator(HeapEntry* entry) {
     ASSERT(entry != NULL);
-    dominator_ = entry;
+    dominator_offset_ = OffsetTo(entry);
   }
 
   void clear_paint() { painted_ = kUnpainted; }
@@ -585,7 +699,11 @@ class HeapEntry BASE_EMBEDDED {
                          int retainer_index);
   void SetUnidirElementReference(int child_index, int index, HeapEntry* entry);
 
-  int EntrySize() { return EntriesSize(1, children_count_, retainers_count_); }
+  int EntrySize() {
+    return RoundUp(
+        EntriesSize(1, children_count_, retainers_count_) - kEntryPadding,
+        kPointerSize);
+  }
   int RetainedSize(bool exact);
 
   void Print(int max_depth, int indent);
@@ -600,8 +718,12 @@ class HeapEntry BASE_EMBEDDED {
   HeapGraphEdge* children_arr() {
     return reinterpret_cast<HeapGraphEdge*>(this + 1);
   }
-  HeapGraphEdge** retainers_arr() {
-    return reinterpret_cast<HeapGraphEdge**>(children_arr() + children_count_);
+  int32_t* retainers_arr() {
+    return reinterpret_cast<int32_t*>(children_arr() + children_count_);
+  }
+  int32_t OffsetTo(void* target) {
+    return static_cast<int32_t>(
+        reinterpret_cast<char*>(target) - reinterpret_cast<char*>(this));
   }
   void CalculateExactRetainedSize();
   const char* TypeAsString();
@@ -615,12 +737,10 @@ class HeapEntry BASE_EMBEDDED {
     int ordered_index_;  // Used during dominator tree building.
     int retained_size_;  // At that moment, there is no retained size yet.
   };
-  HeapEntry* dominator_;
+  // Object ids are handed out sequentially and fit into 32 bits.
+  uint32_t id_;
+  int32_t dominator_offset_;
   HeapSnapshot* snapshot_;
-  struct Id {
-    uint32_t id1_;
-    uint32_t id2_;
-  } id_;  // This is to avoid extra padding of 64-bit value.
   const char* name_;
 
   // Paints used for exact retained sizes calculation.
@@ -630,6 +750,12 @@ class HeapEntry BASE_EMBEDDED {
 
   static const int kExactRetainedSizeTag = 1;
 
+  // Entries are pointer aligned, so an odd offset never refers to one.
+  static const int32_t kNoDominator = 1;
+
+  // The most an entry can be padded by to keep the next one aligned.
+  static const int kEntryPadding = kPointerSize - sizeof(int32_t);  // NOLINT
+
   DISALLOW_COPY_AND_ASSIGN(HeapEntry);
 };
 
@@ -847,7 +973,15 @@ class HeapEntriesMap {
     return key1 == key2;
   }
 
+  EntryInfo* GetEntryInfo(HashMap::Entry* cache_entry) {
+    return &entries_info_[
+        static_cast<int>(reinterpret_cast<intptr_t>(cache_entry->value))];
+  }
+
+  // Maps HeapThings to indexes into entries_info_, which avoids a separate
+  // allocation per snapshotted object.
   HashMap entries_;
+  List<EntryInfo> entries_info_;
   int entries_count_;
   int total_children_count_;
   int total_retainers_count_;
@@ -1087,9 +1221,7 @@ class HeapSnapshotJSONSerializer {
  public:
   explicit HeapSnapshotJSONSerializer(HeapSnapshot* snapshot)
       : snapshot_(snapshot),
-        nodes_(ObjectsMatch),
         strings_(ObjectsMatch),
-        next_node_id_(1),
         next_string_id_(1),
         writer_(NULL) {
   }
@@ -1121,18 +1253,97 @@ class HeapSnapshotJSONSerializer {
   static const int kMaxSerializableSnapshotRawSize;
 
   HeapSnapshot* snapshot_;
-  HashMap nodes_;
+  // Entries sorted by address and their positions in the serialized nodes
+  // array. Entries are looked up by binary search, which costs much less
+  // memory than a hash map.
+  List<HeapEntry*> nodes_;
+  List<int> node_positions_;
   HashMap strings_;
-  int next_node_id_;
   int next_string_id_;
   OutputStreamWriter* writer_;
 
-  friend class HeapSnapshotJSONSerializerEnumerator;
-  friend class HeapSnapshotJSONSerializerIterator;
-
   DISALLOW_COPY_AND_ASSIGN(HeapSnapshotJSONSerializer);
 };
 
+
+// Samples allocations at an average rate of one per sample_interval bytes,
+// with exponentially distributed gaps so that every allocated byte is equally
+// likely to be sampled. Each sample records the JavaScript stack that
+// allocated it and stays alive until the sampled object is collected, so the
+// profile reflects the live heap broken down by allocation site.
+class AllocationSampler {
+ public:
+  AllocationSampler(Isolate* isolate, intptr_t sample_interval);
+  ~AllocationSampler();
+
+  // Accounts for bytes_allocated freshly allocated bytes, of which object
+  // is the last one. Returns true if a sample was taken.
+  bool AllocationEvent(HeapObject* object, int size, intptr_t bytes_allocated);
+  intptr_t bytes_until_sample() { return bytes_until_sample_; }
+
+  int live_samples_count() { return static_cast<int>(samples_.occupancy()); }
+  void Serialize(v8::OutputStream* stream);
+
+  static const int kMaxStackDepth = 64;
+
+ private:
+  class StackNode {
+   public:
+    StackNode(StackNode* parent,
+              const char* name,
+              const char* script_name,
+              int position)
+        : parent_(parent),
+          name_(name),
+          script_name_(script_name),
+          position_(position),
+          live_size_(0),
+          live_count_(0) { }
+    ~StackNode();
+
+    StackNode* FindOrAddChild(const char* name,
+                              const char* script_name,
+                              int position);
+
+    StackNode* parent_;
+    const char* name_;
+    const char* script_name_;
+    int position_;
+    intptr_t live_size_;
+    int live_count_;
+    List<StackNode*> children_;
+  };
+
+  struct Sample {
+    AllocationSampler* sampler;
+    StackNode* node;
+    int size;
+  };
+
+  INLINE(static bool SamplesMatch(void* key1, void* key2)) {
+    return key1 == key2;
+  }
+
+  intptr_t NextSampleInterval();
+  StackNode* CaptureStack();
+  void SampleObject(HeapObject* object, int size);
+  void SampleDied(Sample* sample);
+  void SerializeNode(OutputStreamWriter* writer, StackNode* node);
+  static void SampleDiedCallback(v8::Persistent<v8::Value> handle,
+                                 void* parameter);
+
+  Isolate* isolate_;
+  intptr_t sample_interval_;
+  intptr_t bytes_until_sample_;
+  StringsStorage names_;
+  StackNode root_;
+  // Live samples keyed by their Sample record, mapped to the weak global
+  // handle location of the sampled object.
+  HashMap samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSampler);
+};
+
 } }  // namespace v8::internal
 
 #endif  // V8_PROFILE_GENERATOR_H_
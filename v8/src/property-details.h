@@ -73,6 +73,20 @@ enum PropertyType {
 };
 
 
+// How a FIELD property keeps its value (see FLAG_unbox_double_fields).
+enum FieldRepresentation {
+  // The field holds the value.
+  TAGGED_FIELD = 0,
+  // The field holds a mutable heap number that belongs to the object and
+  // never escapes from it.  Its value is the value of the property, so
+  // storing a number overwrites it in place instead of allocating.
+  DOUBLE_FIELD = 1,
+  // The field was a double field until a value other than a number was
+  // stored in it, so it may still hold a mutable heap number.
+  MIXED_FIELD = 2
+};
+
+
 inline bool IsTransitionType(PropertyType type) {
   switch (type) {
     case MAP_TRANSITION:
@@ -119,13 +133,16 @@ class PropertyDetails BASE_EMBEDDED {
  public:
   PropertyDetails(PropertyAttributes attributes,
                   PropertyType type,
-                  int index = 0) {
+                  int index = 0,
+                  FieldRepresentation representation = TAGGED_FIELD) {
     ASSERT(TypeField::is_valid(type));
     ASSERT(AttributesField::is_valid(attributes));
     ASSERT(StorageField::is_valid(index));
+    ASSERT(type == FIELD || representation == TAGGED_FIELD);
 
     value_ = TypeField::encode(type)
         | AttributesField::encode(attributes)
+        | RepresentationField::encode(representation)
         | StorageField::encode(index);
 
     ASSERT(type == this->type());
@@ -153,6 +170,14 @@ class PropertyDetails BASE_EMBEDDED {
 
   int index() { return StorageField::decode(value_); }
 
+  FieldRepresentation representation() {
+    return RepresentationField::decode(value_);
+  }
+
+  PropertyDetails set_representation(FieldRepresentation representation) {
+    return PropertyDetails(attributes(), type(), index(), representation);
+  }
+
   inline PropertyDetails AsDeleted();
 
   static bool IsValidIndex(int index) {
@@ -169,7 +194,9 @@ class PropertyDetails BASE_EMBEDDED {
   class TypeField:       public BitField<PropertyType,       0, 4> {};
   class AttributesField: public BitField<PropertyAttributes, 4, 3> {};
   class DeletedField:    public BitField<uint32_t,           7, 1> {};
-  class StorageField:    public BitField<uint32_t,           8, 32-8> {};
+  class RepresentationField:
+      public BitField<FieldRepresentation, 8, 2> {};
+  class StorageField:    public BitField<uint32_t,          10, 32-10> {};
 
   static const int kInitialIndex = 1;
 
@@ -68,7 +68,8 @@ class Descriptor BASE_EMBEDDED {
 
   void SetEnumerationIndex(int index) {
     ASSERT(PropertyDetails::IsValidIndex(index));
-    details_ = PropertyDetails(details_.attributes(), details_.type(), index);
+    details_ = PropertyDetails(details_.attributes(), details_.type(), index,
+                               details_.representation());
   }
 
  private:
@@ -137,8 +138,11 @@ class FieldDescriptor: public Descriptor {
   FieldDescriptor(String* key,
                   int field_index,
                   PropertyAttributes attributes,
-                  int index = 0)
-      : Descriptor(key, Smi::FromInt(field_index), attributes, FIELD, index) {}
+                  int index = 0,
+                  FieldRepresentation representation = TAGGED_FIELD)
+      : Descriptor(key,
+                   Smi::FromInt(field_index),
+                   PropertyDetails(attributes, FIELD, index, representation)) {}
 };
 
 
@@ -311,6 +315,12 @@ class LookupResult BASE_EMBEDDED {
     return Descriptor::IndexFromValue(GetValue());
   }
 
+  FieldRepresentation GetFieldRepresentation() {
+    ASSERT(lookup_type_ == DESCRIPTOR_TYPE);
+    ASSERT(type() == FIELD);
+    return details_.representation();
+  }
+
   int GetLocalFieldIndexFromMap(Map* map) {
     ASSERT(lookup_type_ == DESCRIPTOR_TYPE);
     ASSERT(type() == FIELD);
@@ -166,6 +166,7 @@ NativeRegExpMacroAssembler::Result NativeRegExpMacroAssembler::Execute(
   // Ensure that the minimum stack has been allocated.
   RegExpStackScope stack_scope(isolate);
   Address stack_base = stack_scope.stack()->stack_base();
+  stack_scope.stack()->ResetBacktrackBudget();
 
   int direct_call = 0;
   int result = CALL_GENERATED_REGEXP_CODE(code->entry(),
@@ -181,9 +182,9 @@ NativeRegExpMacroAssembler::Result NativeRegExpMacroAssembler::Execute(
   ASSERT(result >= RETRY);
 
   if (result == EXCEPTION && !isolate->has_pending_exception()) {
-    // We detected a stack overflow (on the backtrack stack) in RegExp code,
-    // but haven't created the exception yet.
-    isolate->StackOverflow();
+    // We detected a stack overflow (on the backtrack stack) or ran out of
+    // backtrack budget in RegExp code, but haven't created the exception yet.
+    RegExpImpl::ThrowExecutionException(isolate);
   }
   return static_cast<Result>(result);
 }
@@ -82,13 +82,31 @@ class RegExpStack {
   // If passing zero, the default/minimum size buffer is allocated.
   Address EnsureCapacity(size_t size);
 
+  // Starts a new backtrack budget for the next regexp execution. Without a
+  // --regexp-backtrack-limit the budget is practically unlimited.
+  void ResetBacktrackBudget() {
+    thread_local_.backtracks_left_ =
+        FLAG_regexp_backtrack_limit > 0 ? FLAG_regexp_backtrack_limit
+                                        : kMaxInt;
+  }
+
+  // Counts one backtrack against the budget. Returns false when the budget
+  // is used up.
+  bool ConsumeBacktrack() { return --thread_local_.backtracks_left_ != 0; }
+
+  // Tells whether the last execution failed because it ran out of budget.
+  bool BacktrackBudgetExhausted() {
+    return thread_local_.backtracks_left_ == 0;
+  }
+
   // Thread local archiving.
   static int ArchiveSpacePerThread() {
     return static_cast<int>(sizeof(ThreadLocal));
   }
   char* ArchiveStack(char* to);
   char* RestoreStack(char* from);
-  void FreeThreadResources() { thread_local_.Free(); }
+  // Keeps a default sized buffer for the next thread to take the lock.
+  void FreeThreadResources() { Reset(); }
 
  private:
   RegExpStack();
@@ -110,10 +128,13 @@ class RegExpStack {
     Address memory_;
     size_t memory_size_;
     Address limit_;
+    // Remaining backtracks, decremented by generated code.
+    int backtracks_left_;
     void Clear() {
       memory_ = NULL;
       memory_size_ = 0;
       limit_ = reinterpret_cast<Address>(kMemoryTop);
+      backtracks_left_ = kMaxInt;
     }
     void Free();
   };
@@ -128,6 +149,11 @@ class RegExpStack {
     return reinterpret_cast<Address>(&thread_local_.memory_size_);
   }
 
+  // Address of the remaining backtrack budget.
+  Address backtracks_left_address() {
+    return reinterpret_cast<Address>(&thread_local_.backtracks_left_);
+  }
+
   // Resets the buffer if it has grown beyond the default/minimum size.
   // After this, the buffer is either the default size, or it is empty, so
   // you have to call EnsureCapacity before using it again.
@@ -48,6 +48,11 @@ namespace internal {
 static const int kSamplerFrameCount = 2;
 static const int kSamplerFrameWeight[kSamplerFrameCount] = { 2, 1 };
 
+// Weight added to a sample taken at a loop back edge of unoptimized code,
+// so that functions spinning in a loop are optimized and replaced on the
+// stack sooner.
+static const int kSamplerBackEdgeWeight = 2;
+
 static const int kSamplerTicksBetweenThresholdAdjustment = 32;
 
 static const int kSamplerThresholdInit = 3;
@@ -58,6 +63,11 @@ static const int kSamplerThresholdSizeFactorInit = 3;
 
 static const int kSizeLimit = 1500;
 
+// With count-based interrupts a tick stands for a fixed amount of executed
+// code in the function on top of the stack, so a function is hot after a
+// number of ticks, which is larger for big functions.
+static const int kProfilerTicksSizeFactor = 3;
+
 
 Atomic32 RuntimeProfiler::state_ = 0;
 // TODO(isolates): Create the semaphore lazily and clean it up when no
@@ -107,10 +117,10 @@ void RuntimeProfiler::Optimize(JSFunction* function) {
 
 void RuntimeProfiler::AttemptOnStackReplacement(JSFunction* function) {
   // See AlwaysFullCompiler (in compiler.cc) comment on why we need
-  // Debug::has_break_points().
-  ASSERT(function->IsMarkedForLazyRecompilation());
+  // Isolate::DebuggerNeedsFullCode().
+  ASSERT(function->IsMarkedForLazyRecompilation() || function->IsOptimized());
   if (!FLAG_use_osr ||
-      isolate_->DebuggerHasBreakPoints() ||
+      isolate_->DebuggerNeedsFullCode(function->shared()) ||
       function->IsBuiltin()) {
     return;
   }
@@ -134,13 +144,21 @@ void RuntimeProfiler::AttemptOnStackReplacement(JSFunction* function) {
   }
 
   // Get the stack check stub code object to match against.  We aren't
-  // prepared to generate it, but we don't expect to have to.
-  StackCheckStub check_stub;
+  // prepared to generate it, but we don't expect to have to.  Code with an
+  // interrupt budget calls the interrupt stub at its back edges instead.
+  Code* unoptimized_code = shared->code();
   Code* stack_check_code = NULL;
-  if (check_stub.FindCodeInCache(&stack_check_code)) {
+  bool found;
+  if (unoptimized_code->has_interrupt_budget()) {
+    InterruptStub interrupt_stub;
+    found = interrupt_stub.FindCodeInCache(&stack_check_code);
+  } else {
+    StackCheckStub check_stub;
+    found = check_stub.FindCodeInCache(&stack_check_code);
+  }
+  if (found) {
     Code* replacement_code =
         isolate_->builtins()->builtin(Builtins::kOnStackReplacement);
-    Code* unoptimized_code = shared->code();
     Deoptimizer::PatchStackCheckCode(unoptimized_code,
                                      stack_check_code,
                                      replacement_code);
@@ -148,6 +166,19 @@ void RuntimeProfiler::AttemptOnStackReplacement(JSFunction* function) {
 }
 
 
+void RuntimeProfiler::AllowOnStackReplacement(JSFunction* function,
+                                              int loop_depth) {
+  Code* unoptimized = function->shared()->code();
+  int nesting = unoptimized->allow_osr_at_loop_nesting_level();
+  if (nesting == 0) AttemptOnStackReplacement(function);
+  // Allow OSR one loop nesting level deeper on every tick, and at once at
+  // the loop the function is running in.
+  int new_nesting =
+      Min(Max(nesting + 1, loop_depth), Code::kMaxLoopNestingMarker);
+  unoptimized->set_allow_osr_at_loop_nesting_level(new_nesting);
+}
+
+
 void RuntimeProfiler::ClearSampleBuffer() {
   memset(sampler_window_, 0, sizeof(sampler_window_));
   memset(sampler_window_weight_, 0, sizeof(sampler_window_weight_));
@@ -184,10 +215,14 @@ void RuntimeProfiler::OptimizeNow() {
   // have a sample of the function, we mark it for optimizations
   // (eagerly or lazily).
   JSFunction* samples[kSamplerFrameCount];
+  int sample_weights[kSamplerFrameCount];
   int sample_count = 0;
   int frame_count = 0;
+  // With count-based interrupts only the function whose interrupt budget
+  // ran out is ticked.
+  int frame_limit = FLAG_count_based_interrupts ? 1 : kSamplerFrameCount;
   for (JavaScriptFrameIterator it(isolate_);
-       frame_count++ < kSamplerFrameCount && !it.done();
+       frame_count++ < frame_limit && !it.done();
        it.Advance()) {
     JavaScriptFrame* frame = it.frame();
     JSFunction* function = JSFunction::cast(frame->function());
@@ -207,17 +242,55 @@ void RuntimeProfiler::OptimizeNow() {
       }
     }
 
-    if (function->IsMarkedForLazyRecompilation()) {
-      Code* unoptimized = function->shared()->code();
-      int nesting = unoptimized->allow_osr_at_loop_nesting_level();
-      if (nesting == 0) AttemptOnStackReplacement(function);
-      int new_nesting = Min(nesting + 1, Code::kMaxLoopNestingMarker);
-      unoptimized->set_allow_osr_at_loop_nesting_level(new_nesting);
+    // The profiler tick is handled in the stack checks of unoptimized code,
+    // so the frame may be at a loop back edge of the function's code.
+    int loop_depth = 0;
+    if (frame->is_optimized()) {
+      // Keep running optimized code from being evicted as unused.
+      frame->LookupCode()->set_last_used_gc(isolate_->heap()->ms_count());
+    } else {
+      Code* code = frame->LookupCode();
+      if (code->kind() != Code::FUNCTION ||
+          code != function->shared()->code() ||
+          code->LookupOsrEntryAt(frame->pc(), &loop_depth) ==
+              AstNode::kNoNumber) {
+        loop_depth = 0;
+      }
+    }
+
+    // An activation that is running a loop of a function that has been
+    // optimized in the meantime can be replaced on the stack, too.
+    if (function->IsMarkedForLazyRecompilation() ||
+        (loop_depth > 0 && function->IsOptimized())) {
+      AllowOnStackReplacement(function, loop_depth);
     }
 
     // Do not record non-optimizable functions.
     if (!function->IsOptimizable()) continue;
-    samples[sample_count++] = function;
+
+    if (FLAG_count_based_interrupts) {
+      Code* unoptimized = function->shared()->code();
+      int ticks = unoptimized->profiler_ticks();
+      int ticks_for_optimization = FLAG_profiler_ticks_before_optimization;
+      if (function->shared()->SourceSize() > kSizeLimit) {
+        ticks_for_optimization *= kProfilerTicksSizeFactor;
+      }
+      if (function->shared()->optimize_from_profile() ||
+          ticks + 1 >= ticks_for_optimization) {
+        function->shared()->set_optimize_from_profile(false);
+        unoptimized->set_profiler_ticks(0);
+        Optimize(function);
+        if (loop_depth > 0) AllowOnStackReplacement(function, loop_depth);
+      } else {
+        unoptimized->set_profiler_ticks(ticks + 1);
+      }
+      continue;
+    }
+
+    int weight = kSamplerFrameWeight[frame_count - 1];
+    if (loop_depth > 0) weight += kSamplerBackEdgeWeight;
+    samples[sample_count] = function;
+    sample_weights[sample_count++] = weight;
 
     int function_size = function->shared()->SourceSize();
     int threshold_size_factor = (function_size > kSizeLimit)
@@ -226,8 +299,20 @@ void RuntimeProfiler::OptimizeNow() {
 
     int threshold = sampler_threshold_ * threshold_size_factor;
 
-    if (LookupSample(function) >= threshold) {
+    if (function->shared()->optimize_from_profile()) {
+      // The loaded feedback profile says this function got hot in an
+      // earlier run; do not wait for it to accumulate samples again.
+      function->shared()->set_optimize_from_profile(false);
       Optimize(function);
+      if (function->shared()->used_on_stack_replacement()) {
+        AttemptOnStackReplacement(function);
+      }
+    } else if (LookupSample(function) + (loop_depth > 0 ? weight : 0) >=
+               threshold) {
+      // A function that is looping does not have to wait for the next
+      // tick to enter the optimized code.
+      Optimize(function);
+      if (loop_depth > 0) AllowOnStackReplacement(function, loop_depth);
     }
   }
 
@@ -235,12 +320,14 @@ void RuntimeProfiler::OptimizeNow() {
   // this as part of collecting them because this will interfere with
   // the sample lookup in case of recursive functions.
   for (int i = 0; i < sample_count; i++) {
-    AddSample(samples[i], kSamplerFrameWeight[i]);
+    AddSample(samples[i], sample_weights[i]);
   }
 }
 
 
 void RuntimeProfiler::NotifyTick() {
+  // Code with an interrupt budget ticks the profiler itself.
+  if (FLAG_count_based_interrupts) return;
   isolate_->stack_guard()->RequestRuntimeProfilerTick();
 }
 
@@ -250,7 +337,9 @@ void RuntimeProfiler::Setup() {
   ClearSampleBuffer();
   // If the ticker hasn't already started, make sure to do so to get
   // the ticks for the runtime profiler.
-  if (IsEnabled()) isolate_->logger()->EnsureTickerStarted();
+  if (IsEnabled() && !FLAG_count_based_interrupts) {
+    isolate_->logger()->EnsureTickerStarted();
+  }
 }
 
 
@@ -101,6 +101,10 @@ class RuntimeProfiler {
 
   void AttemptOnStackReplacement(JSFunction* function);
 
+  // Patches the function's unoptimized code for on-stack replacement at
+  // increasing loop nesting levels, starting with the given loop depth.
+  void AllowOnStackReplacement(JSFunction* function, int loop_depth);
+
   void ClearSampleBuffer();
 
   void ClearSampleBufferNewSpaceEntries();
@@ -37,6 +37,7 @@
 #include "compilation-cache.h"
 #include "compiler.h"
 #include "cpu.h"
+#include "date.h"
 #include "dateparser-inl.h"
 #include "debug.h"
 #include "deoptimizer.h"
@@ -127,14 +128,16 @@ namespace internal {
       static_cast<LanguageMode>(args.smi_at(index));
 
 
-MUST_USE_RESULT static MaybeObject* DeepCopyBoilerplate(Isolate* isolate,
-                                                   JSObject* boilerplate) {
+MUST_USE_RESULT static MaybeObject* DeepCopyBoilerplate(
+    Isolate* isolate,
+    JSObject* boilerplate,
+    PretenureFlag pretenure = NOT_TENURED) {
   StackLimitCheck check(isolate);
   if (check.HasOverflowed()) return isolate->StackOverflow();
 
   Heap* heap = isolate->heap();
   Object* result;
-  { MaybeObject* maybe_result = heap->CopyJSObject(boilerplate);
+  { MaybeObject* maybe_result = heap->CopyJSObject(boilerplate, pretenure);
     if (!maybe_result->ToObject(&result)) return maybe_result;
   }
   JSObject* copy = JSObject::cast(result);
@@ -146,7 +149,8 @@ MUST_USE_RESULT static MaybeObject* DeepCopyBoilerplate(Isolate* isolate,
       Object* value = properties->get(i);
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        { MaybeObject* maybe_result = DeepCopyBoilerplate(isolate, js_object);
+        { MaybeObject* maybe_result =
+              DeepCopyBoilerplate(isolate, js_object, pretenure);
           if (!maybe_result->ToObject(&result)) return maybe_result;
         }
         properties->set(i, result);
@@ -157,7 +161,8 @@ MUST_USE_RESULT static MaybeObject* DeepCopyBoilerplate(Isolate* isolate,
       Object* value = copy->InObjectPropertyAt(i);
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        { MaybeObject* maybe_result = DeepCopyBoilerplate(isolate, js_object);
+        { MaybeObject* maybe_result =
+              DeepCopyBoilerplate(isolate, js_object, pretenure);
           if (!maybe_result->ToObject(&result)) return maybe_result;
         }
         copy->InObjectPropertyAtPut(i, result);
@@ -183,7 +188,8 @@ MUST_USE_RESULT static MaybeObject* DeepCopyBoilerplate(Isolate* isolate,
           copy->GetProperty(key_string, &attributes)->ToObjectUnchecked();
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        { MaybeObject* maybe_result = DeepCopyBoilerplate(isolate, js_object);
+        { MaybeObject* maybe_result =
+              DeepCopyBoilerplate(isolate, js_object, pretenure);
           if (!maybe_result->ToObject(&result)) return maybe_result;
         }
         { MaybeObject* maybe_result =
@@ -218,7 +224,8 @@ MUST_USE_RESULT static MaybeObject* DeepCopyBoilerplate(Isolate* isolate,
           if (value->IsJSObject()) {
             JSObject* js_object = JSObject::cast(value);
             { MaybeObject* maybe_result = DeepCopyBoilerplate(isolate,
-                                                              js_object);
+                                                              js_object,
+                                                              pretenure);
               if (!maybe_result->ToObject(&result)) return maybe_result;
             }
             elements->set(i, result);
@@ -237,7 +244,8 @@ MUST_USE_RESULT static MaybeObject* DeepCopyBoilerplate(Isolate* isolate,
           if (value->IsJSObject()) {
             JSObject* js_object = JSObject::cast(value);
             { MaybeObject* maybe_result = DeepCopyBoilerplate(isolate,
-                                                              js_object);
+                                                              js_object,
+                                                              pretenure);
               if (!maybe_result->ToObject(&result)) return maybe_result;
             }
             element_dictionary->ValueAtPut(i, result);
@@ -544,6 +552,26 @@ static Handle<Object> CreateLiteralBoilerplate(
 }
 
 
+// Copies the boilerplate of a literal site, in old space if the copies of
+// the site tend to survive, and samples the copy for the pretenuring
+// tracker.
+MUST_USE_RESULT static MaybeObject* CopyLiteralBoilerplate(
+    Isolate* isolate,
+    JSObject* boilerplate,
+    bool deep) {
+  PretenuringTracker* tracker = isolate->heap()->pretenuring_tracker();
+  PretenureFlag pretenure = tracker->GetPretenureFlag(boilerplate);
+  Object* copy;
+  { MaybeObject* maybe_copy = deep
+        ? DeepCopyBoilerplate(isolate, boilerplate, pretenure)
+        : isolate->heap()->CopyJSObject(boilerplate, pretenure);
+    if (!maybe_copy->ToObject(&copy)) return maybe_copy;
+  }
+  tracker->RecordAllocation(boilerplate, JSObject::cast(copy));
+  return copy;
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateObjectLiteral) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 4);
@@ -566,7 +594,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateObjectLiteral) {
     // Update the functions literal and return the boilerplate.
     literals->set(literals_index, *boilerplate);
   }
-  return DeepCopyBoilerplate(isolate, JSObject::cast(*boilerplate));
+  return CopyLiteralBoilerplate(isolate, JSObject::cast(*boilerplate), true);
 }
 
 
@@ -592,7 +620,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateObjectLiteralShallow) {
     // Update the functions literal and return the boilerplate.
     literals->set(literals_index, *boilerplate);
   }
-  return isolate->heap()->CopyJSObject(JSObject::cast(*boilerplate));
+  return CopyLiteralBoilerplate(isolate, JSObject::cast(*boilerplate), false);
 }
 
 
@@ -611,7 +639,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateArrayLiteral) {
     // Update the functions literal and return the boilerplate.
     literals->set(literals_index, *boilerplate);
   }
-  return DeepCopyBoilerplate(isolate, JSObject::cast(*boilerplate));
+  return CopyLiteralBoilerplate(isolate, JSObject::cast(*boilerplate), true);
 }
 
 
@@ -634,7 +662,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateArrayLiteralShallow) {
       isolate->heap()->fixed_cow_array_map()) {
     isolate->counters()->cow_arrays_created_runtime()->Increment();
   }
-  return isolate->heap()->CopyJSObject(JSObject::cast(*boilerplate));
+  return CopyLiteralBoilerplate(isolate, JSObject::cast(*boilerplate), false);
 }
 
 
@@ -708,7 +736,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_SetInitialize) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 1);
   CONVERT_ARG_CHECKED(JSSet, holder, 0);
-  Handle<ObjectHashSet> table = isolate->factory()->NewObjectHashSet(0);
+  Handle<OrderedHashTable> table = isolate->factory()->NewOrderedHashTable(0);
   holder->set_table(*table);
   return *holder;
 }
@@ -719,8 +747,8 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_SetAdd) {
   ASSERT(args.length() == 2);
   CONVERT_ARG_CHECKED(JSSet, holder, 0);
   Handle<Object> key(args[1]);
-  Handle<ObjectHashSet> table(ObjectHashSet::cast(holder->table()));
-  table = ObjectHashSetAdd(table, key);
+  Handle<OrderedHashTable> table(OrderedHashTable::cast(holder->table()));
+  table = OrderedHashTablePut(table, key, isolate->factory()->true_value());
   holder->set_table(*table);
   return isolate->heap()->undefined_symbol();
 }
@@ -731,8 +759,9 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_SetHas) {
   ASSERT(args.length() == 2);
   CONVERT_ARG_CHECKED(JSSet, holder, 0);
   Handle<Object> key(args[1]);
-  Handle<ObjectHashSet> table(ObjectHashSet::cast(holder->table()));
-  return isolate->heap()->ToBoolean(table->Contains(*key));
+  OrderedHashTable* table = OrderedHashTable::cast(holder->table());
+  return isolate->heap()->ToBoolean(
+      table->FindEntry(*key) != OrderedHashTable::kNotFound);
 }
 
 
@@ -741,29 +770,55 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_SetDelete) {
   ASSERT(args.length() == 2);
   CONVERT_ARG_CHECKED(JSSet, holder, 0);
   Handle<Object> key(args[1]);
-  Handle<ObjectHashSet> table(ObjectHashSet::cast(holder->table()));
-  table = ObjectHashSetRemove(table, key);
+  Handle<OrderedHashTable> table(OrderedHashTable::cast(holder->table()));
+  table = OrderedHashTableRemove(table, key);
   holder->set_table(*table);
   return isolate->heap()->undefined_symbol();
 }
 
 
+RUNTIME_FUNCTION(MaybeObject*, Runtime_SetGetSize) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+  CONVERT_CHECKED(JSSet, holder, args[0]);
+  OrderedHashTable* table = OrderedHashTable::cast(holder->table());
+  return Smi::FromInt(table->NumberOfElements());
+}
+
+
+// Returns an array of the keys of a set in insertion order.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_SetGetKeys) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 1);
+  CONVERT_ARG_CHECKED(JSSet, holder, 0);
+  Handle<OrderedHashTable> table(OrderedHashTable::cast(holder->table()));
+  Handle<FixedArray> keys =
+      isolate->factory()->NewFixedArray(table->NumberOfElements());
+  int used = table->UsedCapacity();
+  int index = 0;
+  for (int i = 0; i < used; i++) {
+    if (table->IsLiveEntry(i)) keys->set(index++, table->KeyAt(i));
+  }
+  ASSERT(index == keys->length());
+  return *isolate->factory()->NewJSArrayWithElements(keys);
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_MapInitialize) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 1);
   CONVERT_ARG_CHECKED(JSMap, holder, 0);
-  Handle<ObjectHashTable> table = isolate->factory()->NewObjectHashTable(0);
+  Handle<OrderedHashTable> table = isolate->factory()->NewOrderedHashTable(0);
   holder->set_table(*table);
   return *holder;
 }
 
 
 RUNTIME_FUNCTION(MaybeObject*, Runtime_MapGet) {
-  HandleScope scope(isolate);
+  NoHandleAllocation ha;
   ASSERT(args.length() == 2);
-  CONVERT_ARG_CHECKED(JSMap, holder, 0);
-  Handle<Object> key(args[1]);
-  return ObjectHashTable::cast(holder->table())->Lookup(*key);
+  CONVERT_CHECKED(JSMap, holder, args[0]);
+  return OrderedHashTable::cast(holder->table())->Lookup(args[1]);
 }
 
 
@@ -773,13 +828,48 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_MapSet) {
   CONVERT_ARG_CHECKED(JSMap, holder, 0);
   Handle<Object> key(args[1]);
   Handle<Object> value(args[2]);
-  Handle<ObjectHashTable> table(ObjectHashTable::cast(holder->table()));
-  Handle<ObjectHashTable> new_table = PutIntoObjectHashTable(table, key, value);
-  holder->set_table(*new_table);
+  Handle<OrderedHashTable> table(OrderedHashTable::cast(holder->table()));
+  // Mapping a key to the undefined value removes the entry.
+  if (value->IsUndefined()) {
+    table = OrderedHashTableRemove(table, key);
+  } else {
+    table = OrderedHashTablePut(table, key, value);
+  }
+  holder->set_table(*table);
   return *value;
 }
 
 
+RUNTIME_FUNCTION(MaybeObject*, Runtime_MapGetSize) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+  CONVERT_CHECKED(JSMap, holder, args[0]);
+  OrderedHashTable* table = OrderedHashTable::cast(holder->table());
+  return Smi::FromInt(table->NumberOfElements());
+}
+
+
+// Returns an array of the keys and values of a map in insertion order, with
+// each key followed by its value.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_MapGetEntries) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 1);
+  CONVERT_ARG_CHECKED(JSMap, holder, 0);
+  Handle<OrderedHashTable> table(OrderedHashTable::cast(holder->table()));
+  Handle<FixedArray> entries =
+      isolate->factory()->NewFixedArray(table->NumberOfElements() * 2);
+  int used = table->UsedCapacity();
+  int index = 0;
+  for (int i = 0; i < used; i++) {
+    if (!table->IsLiveEntry(i)) continue;
+    entries->set(index++, table->KeyAt(i));
+    entries->set(index++, table->ValueAt(i));
+  }
+  ASSERT(index == entries->length());
+  return *isolate->factory()->NewJSArrayWithElements(entries);
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_WeakMapInitialize) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 1);
@@ -814,6 +904,142 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_WeakMapSet) {
 }
 
 
+// Frees the backing store of an ArrayBuffer that died.  Its views keep it
+// alive through their buffer property.
+static void ArrayBufferWeakCallback(v8::Persistent<v8::Value> object,
+                                    void* data) {
+  Isolate* isolate = Isolate::Current();
+  Handle<JSValue> holder =
+      Handle<JSValue>::cast(v8::Utils::OpenHandle(*object));
+  int byte_length = ExternalArray::cast(holder->value())->length();
+  isolate->heap()->AdjustAmountOfExternalAllocatedMemory(-byte_length);
+  free(data);
+  object.Dispose();
+}
+
+
+// An ArrayBuffer is a JSValue whose value is an external byte array over a
+// zero-filled backing store.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_ArrayBufferInitialize) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 2);
+  CONVERT_ARG_CHECKED(JSValue, holder, 0);
+  CONVERT_SMI_ARG_CHECKED(byte_length, 1);
+  RUNTIME_ASSERT(holder->value()->IsUndefined());
+  RUNTIME_ASSERT(byte_length >= 0 && byte_length <= ExternalArray::kMaxLength);
+  void* data = NULL;
+  if (byte_length > 0) {
+    data = calloc(byte_length, 1);
+    if (data == NULL) {
+      V8::FatalProcessOutOfMemory("Runtime_ArrayBufferInitialize");
+    }
+    isolate->heap()->AdjustAmountOfExternalAllocatedMemory(byte_length);
+  }
+  Handle<ExternalArray> backing_store = isolate->factory()->NewExternalArray(
+      byte_length, kExternalUnsignedByteArray, data);
+  holder->set_value(*backing_store);
+  if (data != NULL) {
+    Handle<Object> weak_holder = isolate->global_handles()->Create(*holder);
+    isolate->global_handles()->MakeWeak(weak_holder.location(),
+                                        data,
+                                        ArrayBufferWeakCallback);
+  }
+  return *holder;
+}
+
+
+static bool IsArrayBuffer(JSValue* buffer) {
+  return buffer->value()->IsExternalUnsignedByteArray();
+}
+
+
+static ExternalUnsignedByteArray* ArrayBufferBackingStore(JSValue* buffer) {
+  return ExternalUnsignedByteArray::cast(buffer->value());
+}
+
+
+// Copies the bytes of source from start on into target, which is as long as
+// the slice.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_ArrayBufferSliceImpl) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 3);
+  CONVERT_CHECKED(JSValue, source, args[0]);
+  CONVERT_CHECKED(JSValue, target, args[1]);
+  CONVERT_SMI_ARG_CHECKED(start, 2);
+  RUNTIME_ASSERT(IsArrayBuffer(source) && IsArrayBuffer(target));
+  ExternalUnsignedByteArray* source_store = ArrayBufferBackingStore(source);
+  ExternalUnsignedByteArray* target_store = ArrayBufferBackingStore(target);
+  int length = target_store->length();
+  RUNTIME_ASSERT(start >= 0 && start <= source_store->length() - length);
+  if (length > 0) {
+    memcpy(target_store->external_pointer(),
+           static_cast<uint8_t*>(source_store->external_pointer()) + start,
+           length);
+  }
+  return isolate->heap()->undefined_value();
+}
+
+
+static int ExternalArrayElementSize(ExternalArrayType array_type) {
+  switch (array_type) {
+    case kExternalByteArray:
+    case kExternalUnsignedByteArray:
+    case kExternalPixelArray:
+      return 1;
+    case kExternalShortArray:
+    case kExternalUnsignedShortArray:
+      return 2;
+    case kExternalIntArray:
+    case kExternalUnsignedIntArray:
+    case kExternalFloatArray:
+      return 4;
+    case kExternalDoubleArray:
+      return 8;
+  }
+  UNREACHABLE();
+  return 0;
+}
+
+
+// Makes holder a view of length elements of the given external array type
+// on buffer, starting at byte_offset.  The view shares the backing store of
+// the buffer.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_TypedArrayInitialize) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 5);
+  CONVERT_ARG_CHECKED(JSObject, holder, 0);
+  CONVERT_SMI_ARG_CHECKED(type, 1);
+  CONVERT_ARG_CHECKED(JSValue, buffer, 2);
+  CONVERT_SMI_ARG_CHECKED(byte_offset, 3);
+  CONVERT_SMI_ARG_CHECKED(length, 4);
+  RUNTIME_ASSERT(!holder->IsJSArray() && IsArrayBuffer(*buffer));
+  RUNTIME_ASSERT(type >= kExternalByteArray && type <= kExternalPixelArray);
+  ExternalArrayType array_type = static_cast<ExternalArrayType>(type);
+  ExternalUnsignedByteArray* backing_store = ArrayBufferBackingStore(*buffer);
+  int byte_length = backing_store->length();
+  RUNTIME_ASSERT(byte_offset >= 0 && byte_offset <= byte_length);
+  RUNTIME_ASSERT(length >= 0 &&
+                 length <= (byte_length - byte_offset) /
+                     ExternalArrayElementSize(array_type));
+  void* data =
+      static_cast<uint8_t*>(backing_store->external_pointer()) + byte_offset;
+  Handle<ExternalArray> elements =
+      isolate->factory()->NewExternalArray(length, array_type, data);
+
+  // The external element kinds are in the order of the array types.
+  STATIC_ASSERT(EXTERNAL_UNSIGNED_BYTE_ELEMENTS - EXTERNAL_BYTE_ELEMENTS ==
+                kExternalUnsignedByteArray - kExternalByteArray);
+  STATIC_ASSERT(EXTERNAL_PIXEL_ELEMENTS - EXTERNAL_BYTE_ELEMENTS ==
+                kExternalPixelArray - kExternalByteArray);
+  ElementsKind kind = static_cast<ElementsKind>(
+      EXTERNAL_BYTE_ELEMENTS + (array_type - kExternalByteArray));
+  Handle<Map> map = isolate->factory()->GetElementsTransitionMap(holder, kind);
+  holder->set_map(*map);
+  holder->set_elements(*elements);
+  return *holder;
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_ClassOf) {
   NoHandleAllocation ha;
   ASSERT(args.length() == 1);
@@ -1697,6 +1923,18 @@ RUNTIME_FUNCTION(MaybeObject*,
 }
 
 
+// Used by front ends to define methods on class prototypes, see
+// JSObject::DefineMethod.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_DefineMethod) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 3);
+  CONVERT_CHECKED(JSObject, holder, args[0]);
+  CONVERT_CHECKED(String, name, args[1]);
+  CONVERT_CHECKED(JSFunction, function, args[2]);
+  return holder->DefineMethod(name, function);
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_RegExpExec) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 4);
@@ -1864,6 +2102,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_SpecialArrayFunctions) {
   InstallBuiltin(isolate, holder, "slice", Builtins::kArraySlice);
   InstallBuiltin(isolate, holder, "splice", Builtins::kArraySplice);
   InstallBuiltin(isolate, holder, "concat", Builtins::kArrayConcat);
+  InstallBuiltin(isolate, holder, "sort", Builtins::kArraySort);
 
   return *holder;
 }
@@ -2490,7 +2729,7 @@ class CompiledReplacement {
   void Apply(ReplacementStringBuilder* builder,
              int match_from,
              int match_to,
-             Handle<JSArray> last_match_info);
+             int32_t* match);
 
   // Number of distinct parts of the replacement pattern.
   int parts() {
@@ -2715,7 +2954,7 @@ void CompiledReplacement::Compile(Handle<String> replacement,
 void CompiledReplacement::Apply(ReplacementStringBuilder* builder,
                                 int match_from,
                                 int match_to,
-                                Handle<JSArray> last_match_info) {
+                                int32_t* match) {
   for (int i = 0, n = parts_.length(); i < n; i++) {
     ReplacementPart part = parts_[i];
     switch (part.tag) {
@@ -2731,9 +2970,8 @@ void CompiledReplacement::Apply(ReplacementStringBuilder* builder,
       }
       case SUBJECT_CAPTURE: {
         int capture = part.data;
-        FixedArray* match_info = FixedArray::cast(last_match_info->elements());
-        int from = RegExpImpl::GetCapture(match_info, capture * 2);
-        int to = RegExpImpl::GetCapture(match_info, capture * 2 + 1);
+        int from = match[capture * 2];
+        int to = match[capture * 2 + 1];
         if (from >= 0 && to > from) {
           builder->AddSubjectSlice(from, to);
         }
@@ -2931,14 +3169,15 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithString(
   Handle<JSRegExp> regexp_handle(regexp);
   Handle<String> replacement_handle(replacement);
   Handle<JSArray> last_match_info_handle(last_match_info);
-  Handle<Object> match = RegExpImpl::Exec(regexp_handle,
-                                          subject_handle,
-                                          0,
-                                          last_match_info_handle);
-  if (match.is_null()) {
-    return Failure::Exception();
-  }
-  if (match->IsNull()) {
+  bool is_global = regexp_handle->GetFlags().is_global();
+
+  RegExpImpl::GlobalCache global_cache(regexp_handle,
+                                       subject_handle,
+                                       is_global);
+  if (global_cache.HasException()) return Failure::Exception();
+  int32_t* current_match = global_cache.FetchNext();
+  if (current_match == NULL) {
+    if (global_cache.HasException()) return Failure::Exception();
     return *subject_handle;
   }
 
@@ -2951,12 +3190,14 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithString(
                                capture_count,
                                length);
 
-  bool is_global = regexp_handle->GetFlags().is_global();
-
   // Shortcut for simple non-regexp global replacements
   if (is_global &&
       regexp_handle->TypeTag() == JSRegExp::ATOM &&
       compiled_replacement.simple_hint()) {
+    RegExpImpl::SetLastMatchInfo(last_match_info_handle,
+                                 subject_handle,
+                                 capture_count,
+                                 current_match);
     if (subject_handle->HasOnlyAsciiChars() &&
         replacement_handle->HasOnlyAsciiChars()) {
       return StringReplaceStringWithString<SeqAsciiString>(
@@ -2983,25 +3224,14 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithString(
   // string and possibly suffix after last match.  It is possible for
   // all components to use two elements when encoded as two smis.
   const int parts_added_per_loop = 2 * (compiled_replacement.parts() + 2);
-  bool matched = true;
   do {
-    ASSERT(last_match_info_handle->HasFastElements());
     // Increase the capacity of the builder before entering local handle-scope,
     // so its internal buffer can safely allocate a new handle if it grows.
     builder.EnsureCapacity(parts_added_per_loop);
 
     HandleScope loop_scope(isolate);
-    int start, end;
-    {
-      AssertNoAllocation match_info_array_is_not_in_a_handle;
-      FixedArray* match_info_array =
-          FixedArray::cast(last_match_info_handle->elements());
-
-      ASSERT_EQ(capture_count * 2 + 2,
-                RegExpImpl::GetLastCaptureCount(match_info_array));
-      start = RegExpImpl::GetCapture(match_info_array, 0);
-      end = RegExpImpl::GetCapture(match_info_array, 1);
-    }
+    int start = current_match[0];
+    int end = current_match[1];
 
     if (prev < start) {
       builder.AddSubjectSlice(prev, start);
@@ -3009,33 +3239,23 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithString(
     compiled_replacement.Apply(&builder,
                                start,
                                end,
-                               last_match_info_handle);
+                               current_match);
     prev = end;
 
-    // Only continue checking for global regexps.
-    if (!is_global) break;
+    current_match = global_cache.FetchNext();
+  } while (current_match != NULL);
 
-    // Continue from where the match ended, unless it was an empty match.
-    int next = end;
-    if (start == end) {
-      next = end + 1;
-      if (next > length) break;
-    }
-
-    match = RegExpImpl::Exec(regexp_handle,
-                             subject_handle,
-                             next,
-                             last_match_info_handle);
-    if (match.is_null()) {
-      return Failure::Exception();
-    }
-    matched = !match->IsNull();
-  } while (matched);
+  if (global_cache.HasException()) return Failure::Exception();
 
   if (prev < length) {
     builder.AddSubjectSlice(prev, length);
   }
 
+  RegExpImpl::SetLastMatchInfo(last_match_info_handle,
+                               subject_handle,
+                               capture_count,
+                               global_cache.LastSuccessfulMatch());
+
   return *(builder.ToString());
 }
 
@@ -3067,28 +3287,29 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithEmptyString(
   }
 
   Handle<JSArray> last_match_info_handle(last_match_info);
-  Handle<Object> match = RegExpImpl::Exec(regexp_handle,
-                                          subject_handle,
-                                          0,
-                                          last_match_info_handle);
-  if (match.is_null()) return Failure::Exception();
-  if (match->IsNull()) return *subject_handle;
-
-  ASSERT(last_match_info_handle->HasFastElements());
-
-  int start, end;
-  {
-    AssertNoAllocation match_info_array_is_not_in_a_handle;
-    FixedArray* match_info_array =
-        FixedArray::cast(last_match_info_handle->elements());
+  bool is_global = regexp_handle->GetFlags().is_global();
+  int capture_count = regexp_handle->CaptureCount();
 
-    start = RegExpImpl::GetCapture(match_info_array, 0);
-    end = RegExpImpl::GetCapture(match_info_array, 1);
+  RegExpImpl::GlobalCache global_cache(regexp_handle,
+                                       subject_handle,
+                                       is_global);
+  if (global_cache.HasException()) return Failure::Exception();
+  int32_t* current_match = global_cache.FetchNext();
+  if (current_match == NULL) {
+    if (global_cache.HasException()) return Failure::Exception();
+    return *subject_handle;
   }
 
+  int start = current_match[0];
+  int end = current_match[1];
+
   int length = subject_handle->length();
   int new_length = length - (end - start);
   if (new_length == 0) {
+    RegExpImpl::SetLastMatchInfo(last_match_info_handle,
+                                 subject_handle,
+                                 capture_count,
+                                 current_match);
     return isolate->heap()->empty_string();
   }
   Handle<ResultSeqString> answer;
@@ -3101,7 +3322,11 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithEmptyString(
   }
 
   // If the regexp isn't global, only match once.
-  if (!regexp_handle->GetFlags().is_global()) {
+  if (!is_global) {
+    RegExpImpl::SetLastMatchInfo(last_match_info_handle,
+                                 subject_handle,
+                                 capture_count,
+                                 current_match);
     if (start > 0) {
       String::WriteToFlat(*subject_handle,
                           answer->GetChars(),
@@ -3118,7 +3343,6 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithEmptyString(
   }
 
   int prev = 0;  // Index of end of last match.
-  int next = 0;  // Start of next search (prev unless last match was empty).
   int position = 0;
 
   do {
@@ -3131,30 +3355,21 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithEmptyString(
       position += start - prev;
     }
     prev = end;
-    next = end;
-    // Continue from where the match ended, unless it was an empty match.
-    if (start == end) {
-      next++;
-      if (next > length) break;
-    }
-    match = RegExpImpl::Exec(regexp_handle,
-                             subject_handle,
-                             next,
-                             last_match_info_handle);
-    if (match.is_null()) return Failure::Exception();
-    if (match->IsNull()) break;
-
-    ASSERT(last_match_info_handle->HasFastElements());
+
     HandleScope loop_scope(isolate);
-    {
-      AssertNoAllocation match_info_array_is_not_in_a_handle;
-      FixedArray* match_info_array =
-          FixedArray::cast(last_match_info_handle->elements());
-      start = RegExpImpl::GetCapture(match_info_array, 0);
-      end = RegExpImpl::GetCapture(match_info_array, 1);
-    }
+    current_match = global_cache.FetchNext();
+    if (current_match == NULL) break;
+    start = current_match[0];
+    end = current_match[1];
   } while (true);
 
+  if (global_cache.HasException()) return Failure::Exception();
+
+  RegExpImpl::SetLastMatchInfo(last_match_info_handle,
+                               subject_handle,
+                               capture_count,
+                               global_cache.LastSuccessfulMatch());
+
   if (prev < length) {
     // Add substring subject[prev;length] to answer string.
     String::WriteToFlat(*subject_handle,
@@ -3173,6 +3388,7 @@ MUST_USE_RESULT static MaybeObject* StringReplaceRegExpWithEmptyString(
   int allocated_string_size = ResultSeqString::SizeFor(new_length);
   int delta = allocated_string_size - string_size;
 
+  if (delta != 0) isolate->heap()->EnsureSweptBeforeResizing(*answer);
   answer->set_length(position);
   if (delta == 0) return *answer;
 
@@ -3234,6 +3450,40 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_StringReplaceRegExpWithString) {
 }
 
 
+// Length of the pieces a cons string is copied in when it is searched
+// without being flattened.
+static const int kChunkedSearchLength = 16 * KB;
+
+
+// Searches a subject that is not flat, starting at *index, by copying it to a
+// buffer one piece at a time. The pieces overlap by the pattern length minus
+// one so that matches across two pieces are found. The search gives up once
+// it reaches limit and then leaves the position to resume at in *index.
+template <typename schar, typename pchar>
+static int SearchStringInChunks(Isolate* isolate,
+                                String* subject,
+                                Vector<const pchar> pattern,
+                                int* index,
+                                int limit) {
+  int pattern_length = pattern.length();
+  int subject_length = subject->length();
+  ScopedVector<schar> buffer(kChunkedSearchLength + pattern_length - 1);
+  int from = *index;
+  while (from + pattern_length <= subject_length && from < limit) {
+    int to = Min(from + buffer.length(), subject_length);
+    String::WriteToFlat(subject, buffer.start(), from, to);
+    int position = SearchString(isolate,
+                                Vector<const schar>(buffer.start(), to - from),
+                                pattern,
+                                0);
+    if (position >= 0) return from + position;
+    from += kChunkedSearchLength;
+  }
+  *index = from;
+  return -1;
+}
+
+
 // Perform string match of pattern on subject, starting at start index.
 // Caller must ensure that 0 <= start_index <= sub->length(),
 // and should check that pat->length() + start_index <= sub->length().
@@ -3250,9 +3500,40 @@ int Runtime::StringMatch(Isolate* isolate,
   int subject_length = sub->length();
   if (start_index + pattern_length > subject_length) return -1;
 
-  if (!sub->IsFlat()) FlattenString(sub);
   if (!pat->IsFlat()) FlattenString(pat);
 
+  // Flattening a long cons string copies all of it, even if the pattern
+  // occurs near the start. Search the first half of the rest of such a
+  // subject piece by piece instead, and only flatten it for the remainder,
+  // which also makes later searches in the same string fast.
+  if (!sub->IsFlat() &&
+      subject_length - start_index >= 4 * kChunkedSearchLength &&
+      pattern_length <= kChunkedSearchLength) {
+    AssertNoAllocation no_heap_allocation;  // ensure vectors stay valid
+    String::FlatContent seq_pat = pat->GetFlatContent();
+    int limit = start_index + (subject_length - start_index) / 2;
+    int position;
+    if (seq_pat.IsAscii()) {
+      Vector<const char> pat_vector = seq_pat.ToAsciiVector();
+      position = sub->IsAsciiRepresentation()
+          ? SearchStringInChunks<char>(
+                isolate, *sub, pat_vector, &start_index, limit)
+          : SearchStringInChunks<uc16>(
+                isolate, *sub, pat_vector, &start_index, limit);
+    } else {
+      Vector<const uc16> pat_vector = seq_pat.ToUC16Vector();
+      position = sub->IsAsciiRepresentation()
+          ? SearchStringInChunks<char>(
+                isolate, *sub, pat_vector, &start_index, limit)
+          : SearchStringInChunks<uc16>(
+                isolate, *sub, pat_vector, &start_index, limit);
+    }
+    if (position >= 0) return position;
+    if (start_index + pattern_length > subject_length) return -1;
+  }
+
+  if (!sub->IsFlat()) FlattenString(sub);
+
   AssertNoAllocation no_heap_allocation;  // ensure vectors stay valid
   // Extract flattened substrings of cons strings before determining asciiness.
   String::FlatContent seq_sub = sub->GetFlatContent();
@@ -3480,35 +3761,24 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_StringMatch) {
   CONVERT_ARG_CHECKED(JSArray, regexp_info, 2);
   HandleScope handles;
 
-  Handle<Object> match = RegExpImpl::Exec(regexp, subject, 0, regexp_info);
-
-  if (match.is_null()) {
-    return Failure::Exception();
-  }
-  if (match->IsNull()) {
-    return isolate->heap()->null_value();
-  }
-  int length = subject->length();
+  RegExpImpl::GlobalCache global_cache(regexp, subject, true);
+  if (global_cache.HasException()) return Failure::Exception();
 
   ZoneScope zone_space(isolate, DELETE_ON_EXIT);
   ZoneList<int> offsets(8);
-  int start;
-  int end;
-  do {
-    {
-      AssertNoAllocation no_alloc;
-      FixedArray* elements = FixedArray::cast(regexp_info->elements());
-      start = Smi::cast(elements->get(RegExpImpl::kFirstCapture))->value();
-      end = Smi::cast(elements->get(RegExpImpl::kFirstCapture + 1))->value();
-    }
-    offsets.Add(start);
-    offsets.Add(end);
-    if (start == end) if (++end > length) break;
-    match = RegExpImpl::Exec(regexp, subject, end, regexp_info);
-    if (match.is_null()) {
-      return Failure::Exception();
-    }
-  } while (!match->IsNull());
+  while (true) {
+    int32_t* match = global_cache.FetchNext();
+    if (match == NULL) break;
+    offsets.Add(match[0]);
+    offsets.Add(match[1]);
+  }
+  if (global_cache.HasException()) return Failure::Exception();
+  if (offsets.is_empty()) return isolate->heap()->null_value();
+
+  RegExpImpl::SetLastMatchInfo(regexp_info,
+                               subject,
+                               regexp->CaptureCount(),
+                               global_cache.LastSuccessfulMatch());
   int matches = offsets.length() / 2;
   Handle<FixedArray> elements = isolate->factory()->NewFixedArray(matches);
   Handle<String> substring = isolate->factory()->
@@ -3664,55 +3934,38 @@ static RegExpImpl::IrregexpResult SearchRegExpNoCaptureMultiple(
   ASSERT(subject->IsFlat());
   int match_start = -1;
   int match_end = 0;
-  int pos = 0;
-  int required_registers = RegExpImpl::IrregexpPrepare(regexp, subject);
-  if (required_registers < 0) return RegExpImpl::RE_EXCEPTION;
-
-  OffsetsVector registers(required_registers);
-  Vector<int32_t> register_vector(registers.vector(), registers.length());
   int subject_length = subject->length();
   bool first = true;
 
-  for (;;) {  // Break on failure, return on exception.
-    RegExpImpl::IrregexpResult result =
-        RegExpImpl::IrregexpExecOnce(regexp,
-                                     subject,
-                                     pos,
-                                     register_vector);
-    if (result == RegExpImpl::RE_SUCCESS) {
-      match_start = register_vector[0];
-      builder->EnsureCapacity(kMaxBuilderEntriesPerRegExpMatch);
-      if (match_end < match_start) {
-        ReplacementStringBuilder::AddSubjectSlice(builder,
-                                                  match_end,
-                                                  match_start);
-      }
-      match_end = register_vector[1];
-      HandleScope loop_scope(isolate);
-      if (!first) {
-        builder->Add(*isolate->factory()->NewProperSubString(subject,
-                                                             match_start,
-                                                             match_end));
-      } else {
-        builder->Add(*isolate->factory()->NewSubString(subject,
-                                                       match_start,
-                                                       match_end));
-      }
-      if (match_start != match_end) {
-        pos = match_end;
-      } else {
-        pos = match_end + 1;
-        if (pos > subject_length) break;
-      }
-    } else if (result == RegExpImpl::RE_FAILURE) {
-      break;
+  RegExpImpl::GlobalCache global_cache(regexp, subject, true);
+  if (global_cache.HasException()) return RegExpImpl::RE_EXCEPTION;
+
+  for (;;) {  // Break when there are no more matches.
+    int32_t* current_match = global_cache.FetchNext();
+    if (current_match == NULL) break;
+    match_start = current_match[0];
+    builder->EnsureCapacity(kMaxBuilderEntriesPerRegExpMatch);
+    if (match_end < match_start) {
+      ReplacementStringBuilder::AddSubjectSlice(builder,
+                                                match_end,
+                                                match_start);
+    }
+    match_end = current_match[1];
+    HandleScope loop_scope(isolate);
+    if (!first) {
+      builder->Add(*isolate->factory()->NewProperSubString(subject,
+                                                           match_start,
+                                                           match_end));
     } else {
-      ASSERT_EQ(result, RegExpImpl::RE_EXCEPTION);
-      return result;
+      builder->Add(*isolate->factory()->NewSubString(subject,
+                                                     match_start,
+                                                     match_end));
     }
     first = false;
   }
 
+  if (global_cache.HasException()) return RegExpImpl::RE_EXCEPTION;
+
   if (match_start >= 0) {
     if (match_end < subject_length) {
       ReplacementStringBuilder::AddSubjectSlice(builder,
@@ -3736,131 +3989,87 @@ static RegExpImpl::IrregexpResult SearchRegExpMultiple(
     Handle<JSRegExp> regexp,
     Handle<JSArray> last_match_array,
     FixedArrayBuilder* builder) {
-
   ASSERT(subject->IsFlat());
-  int required_registers = RegExpImpl::IrregexpPrepare(regexp, subject);
-  if (required_registers < 0) return RegExpImpl::RE_EXCEPTION;
-
-  OffsetsVector registers(required_registers);
-  Vector<int32_t> register_vector(registers.vector(), registers.length());
-
-  RegExpImpl::IrregexpResult result =
-      RegExpImpl::IrregexpExecOnce(regexp,
-                                   subject,
-                                   0,
-                                   register_vector);
-
   int capture_count = regexp->CaptureCount();
   int subject_length = subject->length();
 
-  // Position to search from.
-  int pos = 0;
+  RegExpImpl::GlobalCache global_cache(regexp, subject, true);
+  if (global_cache.HasException()) return RegExpImpl::RE_EXCEPTION;
+
   // End of previous match. Differs from pos if match was empty.
   int match_end = 0;
-  if (result == RegExpImpl::RE_SUCCESS) {
-    // Need to keep a copy of the previous match for creating last_match_info
-    // at the end, so we have two vectors that we swap between.
-    OffsetsVector registers2(required_registers);
-    Vector<int> prev_register_vector(registers2.vector(), registers2.length());
-    bool first = true;
-    do {
-      int match_start = register_vector[0];
-      builder->EnsureCapacity(kMaxBuilderEntriesPerRegExpMatch);
-      if (match_end < match_start) {
-        ReplacementStringBuilder::AddSubjectSlice(builder,
-                                                  match_end,
-                                                  match_start);
-      }
-      match_end = register_vector[1];
-
-      {
-        // Avoid accumulating new handles inside loop.
-        HandleScope temp_scope(isolate);
-        // Arguments array to replace function is match, captures, index and
-        // subject, i.e., 3 + capture count in total.
-        Handle<FixedArray> elements =
-            isolate->factory()->NewFixedArray(3 + capture_count);
-        Handle<String> match;
-        if (!first) {
-          match = isolate->factory()->NewProperSubString(subject,
-                                                         match_start,
-                                                         match_end);
-        } else {
-          match = isolate->factory()->NewSubString(subject,
-                                                   match_start,
-                                                   match_end);
-        }
-        elements->set(0, *match);
-        for (int i = 1; i <= capture_count; i++) {
-          int start = register_vector[i * 2];
-          if (start >= 0) {
-            int end = register_vector[i * 2 + 1];
-            ASSERT(start <= end);
-            Handle<String> substring;
-            if (!first) {
-              substring = isolate->factory()->NewProperSubString(subject,
-                                                                 start,
-                                                                 end);
-            } else {
-              substring = isolate->factory()->NewSubString(subject, start, end);
-            }
-            elements->set(i, *substring);
+  bool first = true;
+  for (;;) {  // Break when there are no more matches.
+    int32_t* current_match = global_cache.FetchNext();
+    if (current_match == NULL) break;
+    int match_start = current_match[0];
+    builder->EnsureCapacity(kMaxBuilderEntriesPerRegExpMatch);
+    if (match_end < match_start) {
+      ReplacementStringBuilder::AddSubjectSlice(builder,
+                                                match_end,
+                                                match_start);
+    }
+    match_end = current_match[1];
+
+    {
+      // Avoid accumulating new handles inside loop.
+      HandleScope temp_scope(isolate);
+      // Arguments array to replace function is match, captures, index and
+      // subject, i.e., 3 + capture count in total.
+      Handle<FixedArray> elements =
+          isolate->factory()->NewFixedArray(3 + capture_count);
+      Handle<String> match;
+      if (!first) {
+        match = isolate->factory()->NewProperSubString(subject,
+                                                       match_start,
+                                                       match_end);
+      } else {
+        match = isolate->factory()->NewSubString(subject,
+                                                 match_start,
+                                                 match_end);
+      }
+      elements->set(0, *match);
+      for (int i = 1; i <= capture_count; i++) {
+        int start = current_match[i * 2];
+        if (start >= 0) {
+          int end = current_match[i * 2 + 1];
+          ASSERT(start <= end);
+          Handle<String> substring;
+          if (!first) {
+            substring = isolate->factory()->NewProperSubString(subject,
+                                                               start,
+                                                               end);
           } else {
-            ASSERT(register_vector[i * 2 + 1] < 0);
-            elements->set(i, isolate->heap()->undefined_value());
+            substring = isolate->factory()->NewSubString(subject, start, end);
           }
-        }
-        elements->set(capture_count + 1, Smi::FromInt(match_start));
-        elements->set(capture_count + 2, *subject);
-        builder->Add(*isolate->factory()->NewJSArrayWithElements(elements));
-      }
-      // Swap register vectors, so the last successful match is in
-      // prev_register_vector.
-      Vector<int32_t> tmp = prev_register_vector;
-      prev_register_vector = register_vector;
-      register_vector = tmp;
-
-      if (match_end > match_start) {
-        pos = match_end;
-      } else {
-        pos = match_end + 1;
-        if (pos > subject_length) {
-          break;
+          elements->set(i, *substring);
+        } else {
+          ASSERT(current_match[i * 2 + 1] < 0);
+          elements->set(i, isolate->heap()->undefined_value());
         }
       }
+      elements->set(capture_count + 1, Smi::FromInt(match_start));
+      elements->set(capture_count + 2, *subject);
+      builder->Add(*isolate->factory()->NewJSArrayWithElements(elements));
+    }
+    first = false;
+  }
 
-      result = RegExpImpl::IrregexpExecOnce(regexp,
-                                            subject,
-                                            pos,
-                                            register_vector);
-      first = false;
-    } while (result == RegExpImpl::RE_SUCCESS);
-
-    if (result != RegExpImpl::RE_EXCEPTION) {
-      // Finished matching, with at least one match.
-      if (match_end < subject_length) {
-        ReplacementStringBuilder::AddSubjectSlice(builder,
-                                                  match_end,
-                                                  subject_length);
-      }
+  if (global_cache.HasException()) return RegExpImpl::RE_EXCEPTION;
+  // No matches at all.
+  if (first) return RegExpImpl::RE_FAILURE;
 
-      int last_match_capture_count = (capture_count + 1) * 2;
-      int last_match_array_size =
-          last_match_capture_count + RegExpImpl::kLastMatchOverhead;
-      last_match_array->EnsureSize(last_match_array_size);
-      AssertNoAllocation no_gc;
-      FixedArray* elements = FixedArray::cast(last_match_array->elements());
-      RegExpImpl::SetLastCaptureCount(elements, last_match_capture_count);
-      RegExpImpl::SetLastSubject(elements, *subject);
-      RegExpImpl::SetLastInput(elements, *subject);
-      for (int i = 0; i < last_match_capture_count; i++) {
-        RegExpImpl::SetCapture(elements, i, prev_register_vector[i]);
-      }
-      return RegExpImpl::RE_SUCCESS;
-    }
+  // Finished matching, with at least one match.
+  if (match_end < subject_length) {
+    ReplacementStringBuilder::AddSubjectSlice(builder,
+                                              match_end,
+                                              subject_length);
   }
-  // No matches at all, return failure or exception result directly.
-  return result;
+  RegExpImpl::SetLastMatchInfo(last_match_array,
+                               subject,
+                               capture_count,
+                               global_cache.LastSuccessfulMatch());
+  return RegExpImpl::RE_SUCCESS;
 }
 
 
@@ -3920,6 +4129,146 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_RegExpExecMultiple) {
 }
 
 
+// Implements String.prototype.split with a regexp separator for a
+// non-empty subject and a non-zero limit (ECMA-262 section 15.5.4.14).
+// Returns null if the separator does not match at all.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_RegExpSplit) {
+  ASSERT(args.length() == 4);
+  HandleScope handles(isolate);
+
+  CONVERT_ARG_CHECKED(String, subject, 0);
+  if (!subject->IsFlat()) FlattenString(subject);
+  CONVERT_ARG_CHECKED(JSRegExp, regexp, 1);
+  CONVERT_NUMBER_CHECKED(uint32_t, limit, Uint32, args[2]);
+  CONVERT_ARG_CHECKED(JSArray, last_match_info, 3);
+
+  int length = subject->length();
+  RUNTIME_ASSERT(length > 0);
+  RUNTIME_ASSERT(limit > 0);
+  int capture_count = regexp->CaptureCount();
+
+  bool use_cache = limit == 0xffffffffu && subject->IsSymbol();
+  if (use_cache) {
+    Object* last_match_registers;
+    Object* cached_parts = StringSplitCache::Lookup(
+        isolate->heap()->string_split_cache(),
+        *subject,
+        regexp->data(),
+        &last_match_registers);
+    if (cached_parts != Smi::FromInt(0)) {
+      Handle<FixedArray> parts(FixedArray::cast(cached_parts));
+      Handle<FixedArray> registers(FixedArray::cast(last_match_registers));
+      ScopedVector<int32_t> last_match(registers->length());
+      for (int i = 0; i < registers->length(); i++) {
+        last_match[i] = Smi::cast(registers->get(i))->value();
+      }
+      RegExpImpl::SetLastMatchInfo(last_match_info,
+                                   subject,
+                                   capture_count,
+                                   last_match.start());
+      return *isolate->factory()->NewJSArrayWithElements(parts);
+    }
+  }
+
+  // The separator is matched the way a global regexp steps through the
+  // subject, whether or not it is global.
+  RegExpImpl::GlobalCache global_cache(regexp, subject, true);
+  if (global_cache.HasException()) return Failure::Exception();
+
+  FixedArrayBuilder builder(isolate, 16);
+  int current_index = 0;
+  // The last match that the loop looked at, unless the loop ran out of
+  // matches.
+  int32_t* last_match = NULL;
+  bool matched = false;
+  bool add_rest = true;
+  while (true) {
+    int32_t* match = global_cache.FetchNext();
+    last_match = match;
+    if (match == NULL) break;
+    matched = true;
+    int match_start = match[0];
+    int match_end = match[1];
+    if (match_start == length) break;
+    // A zero-length match at the current index is ignored.
+    if (match_start == match_end && match_end == current_index) {
+      if (match_end + 1 == length) break;
+      continue;
+    }
+
+    // The builder may grow its backing store; do that outside the scope.
+    builder.EnsureCapacity(1 + capture_count);
+    HandleScope loop_scope(isolate);
+    builder.Add(*isolate->factory()->NewSubString(subject,
+                                                  current_index,
+                                                  match_start));
+    if (static_cast<uint32_t>(builder.length()) == limit) {
+      add_rest = false;
+      break;
+    }
+    for (int i = 1; i <= capture_count; i++) {
+      int start = match[i * 2];
+      if (start >= 0) {
+        builder.Add(*isolate->factory()->NewSubString(subject,
+                                                      start,
+                                                      match[i * 2 + 1]));
+      } else {
+        builder.Add(isolate->heap()->undefined_value());
+      }
+      if (static_cast<uint32_t>(builder.length()) == limit) break;
+    }
+    if (static_cast<uint32_t>(builder.length()) == limit) {
+      add_rest = false;
+      break;
+    }
+    current_index = match_end;
+    // Like the specification, do not try to match again once the next
+    // search would start at the end of the subject.
+    int next = match_start == match_end ? match_end + 1 : match_end;
+    if (next == length) break;
+  }
+  if (global_cache.HasException()) return Failure::Exception();
+  if (!matched) return isolate->heap()->null_value();
+
+  if (add_rest) {
+    builder.EnsureCapacity(1);
+    builder.Add(*isolate->factory()->NewSubString(subject,
+                                                  current_index,
+                                                  length));
+  }
+  if (last_match == NULL) last_match = global_cache.LastSuccessfulMatch();
+  RegExpImpl::SetLastMatchInfo(last_match_info,
+                               subject,
+                               capture_count,
+                               last_match);
+  if (!use_cache) return *builder.ToJSArray();
+
+  // The cache holds the parts and the last match in arrays of exact size.
+  int part_count = builder.length();
+  int register_count = (capture_count + 1) * 2;
+  Handle<FixedArray> registers =
+      isolate->factory()->NewFixedArray(register_count);
+  for (int i = 0; i < register_count; i++) {
+    registers->set(i, Smi::FromInt(last_match[i]));
+  }
+  Handle<FixedArray> parts = isolate->factory()->NewFixedArray(part_count);
+  {
+    AssertNoAllocation no_gc;
+    WriteBarrierMode mode = parts->GetWriteBarrierMode(no_gc);
+    for (int i = 0; i < part_count; i++) {
+      parts->set(i, builder.array()->get(i), mode);
+    }
+  }
+  StringSplitCache::Enter(isolate->heap(),
+                          isolate->heap()->string_split_cache(),
+                          *subject,
+                          regexp->data(),
+                          *parts,
+                          *registers);
+  return *isolate->factory()->NewJSArrayWithElements(parts);
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_NumberToRadixString) {
   NoHandleAllocation ha;
   ASSERT(args.length() == 2);
@@ -4060,6 +4409,15 @@ MaybeObject* Runtime::GetElementOrCharAt(Isolate* isolate,
     if (!result->IsUndefined()) return *result;
   }
 
+  // Handle [] indexing on string buffers
+  if (object->IsStringBuffer()) {
+    Handle<StringBuffer> buffer = Handle<StringBuffer>::cast(object);
+    if (index < static_cast<uint32_t>(buffer->length())) {
+      return isolate->heap()->LookupSingleCharacterStringFromCode(
+          buffer->buffer()->Get(index));
+    }
+  }
+
   if (object->IsString() || object->IsNumber() || object->IsBoolean()) {
     Handle<Object> prototype = GetPrototype(object);
     return prototype->GetElement(index);
@@ -4172,10 +4530,12 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_KeyedGetProperty) {
               : value;
         }
         // Lookup cache miss.  Perform lookup and update the cache if
-        // appropriate.
+        // appropriate.  The generated code reads cached fields directly,
+        // so double fields are not cached.
         LookupResult result(isolate);
         receiver->LocalLookup(key, &result);
-        if (result.IsProperty() && result.type() == FIELD) {
+        if (result.IsProperty() && result.type() == FIELD &&
+            result.GetFieldRepresentation() == TAGGED_FIELD) {
           int offset = result.GetFieldIndex();
           keyed_lookup_cache->Update(receiver_map, key, offset);
           return receiver->FastPropertyAt(offset);
@@ -5179,7 +5539,11 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_Typeof) {
   NoHandleAllocation ha;
 
   Object* obj = args[0];
-  if (obj->IsNumber()) return isolate->heap()->number_symbol();
+  if (obj->IsNumber() || obj->IsBigInteger()) {
+    return isolate->heap()->number_symbol();
+  }
+  if (obj->IsAtom()) return isolate->heap()->symbol_symbol();
+  if (obj->IsStringBuffer()) return isolate->heap()->string_symbol();
   HeapObject* heap_obj = HeapObject::cast(obj);
 
   // typeof an undetectable object is 'undefined'
@@ -5533,6 +5897,292 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_URIUnescape) {
 }
 
 
+// Characters that encodeURIComponent leaves unescaped are marked with 1,
+// the reserved characters and '#', which encodeURI also leaves unescaped
+// and decodeURI does not decode, with 2.
+static const char kURICharacterClass[128] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 2, 2, 0, 2, 1, 1, 1, 1, 2, 2, 1, 1, 2,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 0, 2, 0, 2,
+  2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0,
+};
+
+
+static inline bool IsURIUnescaped(uc16 c, bool is_component) {
+  if (c > String::kMaxAsciiCharCode) return false;
+  int character_class = kURICharacterClass[c];
+  return character_class == 1 || (character_class == 2 && !is_component);
+}
+
+
+static inline bool IsURIReserved(int c, bool is_component) {
+  ASSERT(c <= String::kMaxAsciiCharCode);
+  return !is_component && kURICharacterClass[c] == 2;
+}
+
+
+// Returns the length of the UTF-8 octets of the code point starting at
+// chars[i], or -1 for a lone surrogate.  Sets *step to the number of
+// characters of the code point.
+template <typename Char>
+static inline int URIEncodedOctets(Vector<const Char> chars, int i, int* step) {
+  uc16 c = chars[i];
+  *step = 1;
+  if (c <= unibrow::Utf8::kMaxOneByteChar) return 1;
+  if (c <= unibrow::Utf8::kMaxTwoByteChar) return 2;
+  if (c < 0xD800 || c > 0xDFFF) return 3;
+  if (c >= 0xDC00 || i + 1 == chars.length()) return -1;
+  uc16 next = chars[i + 1];
+  if (next < 0xDC00 || next > 0xDFFF) return -1;
+  *step = 2;
+  return 4;
+}
+
+
+template <typename Char>
+static int URIEncode(Vector<const Char> chars, char* dest, bool is_component) {
+  const char hex_chars[] = "0123456789ABCDEF";
+  int length = chars.length();
+  int dest_position = 0;
+  for (int i = 0; i < length;) {
+    uc16 c = chars[i];
+    if (IsURIUnescaped(c, is_component)) {
+      if (dest != NULL) dest[dest_position] = static_cast<char>(c);
+      dest_position++;
+      i++;
+      continue;
+    }
+    int step;
+    int octet_count = URIEncodedOctets(chars, i, &step);
+    if (octet_count < 0) return -1;
+    if (dest != NULL) {
+      uint32_t code_point = c;
+      if (step == 2) {
+        code_point = 0x10000 + ((c - 0xD800) << 10) + (chars[i + 1] - 0xDC00);
+      }
+      uint8_t octets[4];
+      if (octet_count == 1) {
+        octets[0] = code_point;
+      } else {
+        for (int j = octet_count - 1; j > 0; j--) {
+          octets[j] = 0x80 | (code_point & 0x3F);
+          code_point >>= 6;
+        }
+        octets[0] = (0xF00 >> octet_count) | code_point;
+      }
+      for (int j = 0; j < octet_count; j++) {
+        dest[dest_position + 3 * j] = '%';
+        dest[dest_position + 3 * j + 1] = hex_chars[octets[j] >> 4];
+        dest[dest_position + 3 * j + 2] = hex_chars[octets[j] & 0xF];
+      }
+    }
+    dest_position += 3 * octet_count;
+    // We don't allow strings that are longer than a maximal length.
+    ASSERT(String::kMaxLength < 0x7fffffff - 12);  // Cannot overflow.
+    if (dest_position > String::kMaxLength) return String::kMaxLength + 1;
+    i += step;
+  }
+  return dest_position;
+}
+
+
+// Decodes the percent-encoded UTF-8 sequence that starts with the '%' at
+// chars[i].  Returns the code point and sets *step to the number of
+// characters read, or returns -1 if the sequence is malformed.
+template <typename Char>
+static int URIDecodeOctets(Vector<const Char> chars, int i, int* step) {
+  static const int kMinCodePoint[] = { 0, 0, 0x80, 0x800, 0x10000 };
+  int length = chars.length();
+  if (i + 2 >= length) return -1;
+  int octet = TwoDigitHex(chars[i + 1], chars[i + 2]);
+  if (octet < 0) return -1;
+  *step = 3;
+  if (octet <= String::kMaxAsciiCharCode) return octet;
+
+  int octet_count;
+  if ((octet & 0xE0) == 0xC0) {
+    octet_count = 2;
+  } else if ((octet & 0xF0) == 0xE0) {
+    octet_count = 3;
+  } else if ((octet & 0xF8) == 0xF0) {
+    octet_count = 4;
+  } else {
+    return -1;
+  }
+  int code_point = octet & (0xFF >> (octet_count + 1));
+  int position = i + 3;
+  for (int j = 1; j < octet_count; j++) {
+    if (position + 2 >= length || chars[position] != '%') return -1;
+    octet = TwoDigitHex(chars[position + 1], chars[position + 2]);
+    if (octet < 0 || (octet & 0xC0) != 0x80) return -1;
+    code_point = (code_point << 6) | (octet & 0x3F);
+    position += 3;
+  }
+  if (code_point < kMinCodePoint[octet_count] ||
+      code_point > 0x10FFFF ||
+      (0xD800 <= code_point && code_point <= 0xDFFF)) {
+    return -1;
+  }
+  *step = position - i;
+  return code_point;
+}
+
+
+// Decodes chars into dest, or only computes the length of the result if
+// dest is NULL.  Returns -1 for a malformed URI.  Sets *is_ascii to
+// whether the result has only ASCII characters.
+template <typename Char, typename SinkChar>
+static int URIDecode(Vector<const Char> chars,
+                     SinkChar* dest,
+                     bool is_component,
+                     bool* is_ascii) {
+  int length = chars.length();
+  int dest_position = 0;
+  uc16 char_mask = 0;
+  for (int i = 0; i < length;) {
+    uc16 c = chars[i];
+    if (c != '%') {
+      if (dest != NULL) dest[dest_position] = c;
+      char_mask |= c;
+      dest_position++;
+      i++;
+      continue;
+    }
+    int step;
+    int code_point = URIDecodeOctets(chars, i, &step);
+    if (code_point < 0) return -1;
+    if (code_point <= String::kMaxAsciiCharCode &&
+        IsURIReserved(code_point, is_component)) {
+      // Reserved characters stay escaped, as they were written.
+      for (int j = 0; j < 3; j++) {
+        if (dest != NULL) dest[dest_position] = chars[i + j];
+        char_mask |= chars[i + j];
+        dest_position++;
+      }
+    } else if (code_point < 0x10000) {
+      if (dest != NULL) dest[dest_position] = code_point;
+      char_mask |= code_point;
+      dest_position++;
+    } else {
+      uc16 lead = (code_point >> 10) + 0xD7C0;
+      uc16 trail = (code_point & 0x3FF) + 0xDC00;
+      if (dest != NULL) {
+        dest[dest_position] = lead;
+        dest[dest_position + 1] = trail;
+      }
+      char_mask |= lead;
+      dest_position += 2;
+    }
+    i += step;
+  }
+  *is_ascii = char_mask <= String::kMaxAsciiCharCode;
+  return dest_position;
+}
+
+
+// Encodes the string like encodeURI or encodeURIComponent.  Returns the
+// string itself if it has no characters to escape, and undefined if it
+// is malformed, in which case uri.js reports the error.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_URIEncode) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 2);
+  CONVERT_CHECKED(String, source, args[0]);
+  CONVERT_BOOLEAN_CHECKED(is_component, args[1]);
+
+  source->TryFlatten();
+  if (!source->IsFlat()) return isolate->heap()->undefined_value();
+
+  int length = source->length();
+  int encoded_length;
+  {
+    AssertNoAllocation no_allocation;
+    String::FlatContent content = source->GetFlatContent();
+    encoded_length = content.IsAscii()
+        ? URIEncode(content.ToAsciiVector(), NULL, is_component)
+        : URIEncode(content.ToUC16Vector(), NULL, is_component);
+  }
+  if (encoded_length < 0) return isolate->heap()->undefined_value();
+  if (encoded_length > String::kMaxLength) {
+    isolate->context()->mark_out_of_memory();
+    return Failure::OutOfMemoryException();
+  }
+  // No length change implies no change.  Return original string if no change.
+  if (encoded_length == length) return source;
+
+  Object* o;
+  { MaybeObject* maybe_o =
+        isolate->heap()->AllocateRawAsciiString(encoded_length);
+    if (!maybe_o->ToObject(&o)) return maybe_o;
+  }
+  SeqAsciiString* result = SeqAsciiString::cast(o);
+  String::FlatContent content = source->GetFlatContent();
+  if (content.IsAscii()) {
+    URIEncode(content.ToAsciiVector(), result->GetChars(), is_component);
+  } else {
+    URIEncode(content.ToUC16Vector(), result->GetChars(), is_component);
+  }
+  return result;
+}
+
+
+// Decodes the string like decodeURI or decodeURIComponent.  Returns the
+// string itself if it has nothing to decode, and undefined if it is
+// malformed, in which case uri.js reports the error.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_URIDecode) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 2);
+  CONVERT_CHECKED(String, source, args[0]);
+  CONVERT_BOOLEAN_CHECKED(is_component, args[1]);
+
+  source->TryFlatten();
+  if (!source->IsFlat()) return isolate->heap()->undefined_value();
+
+  int length = source->length();
+  int decoded_length;
+  bool is_ascii;
+  {
+    AssertNoAllocation no_allocation;
+    String::FlatContent content = source->GetFlatContent();
+    decoded_length = content.IsAscii()
+        ? URIDecode(content.ToAsciiVector(),
+                    static_cast<char*>(NULL), is_component, &is_ascii)
+        : URIDecode(content.ToUC16Vector(),
+                    static_cast<uc16*>(NULL), is_component, &is_ascii);
+  }
+  if (decoded_length < 0) return isolate->heap()->undefined_value();
+  // No length change implies no change.  Return original string if no change.
+  if (decoded_length == length) return source;
+
+  Object* o;
+  { MaybeObject* maybe_o = is_ascii
+        ? isolate->heap()->AllocateRawAsciiString(decoded_length)
+        : isolate->heap()->AllocateRawTwoByteString(decoded_length);
+    if (!maybe_o->ToObject(&o)) return maybe_o;
+  }
+  String::FlatContent content = source->GetFlatContent();
+  if (is_ascii) {
+    char* dest = SeqAsciiString::cast(o)->GetChars();
+    if (content.IsAscii()) {
+      URIDecode(content.ToAsciiVector(), dest, is_component, &is_ascii);
+    } else {
+      URIDecode(content.ToUC16Vector(), dest, is_component, &is_ascii);
+    }
+  } else {
+    uc16* dest = SeqTwoByteString::cast(o)->GetChars();
+    if (content.IsAscii()) {
+      URIDecode(content.ToAsciiVector(), dest, is_component, &is_ascii);
+    } else {
+      URIDecode(content.ToUC16Vector(), dest, is_component, &is_ascii);
+    }
+  }
+  return o;
+}
+
+
 static const unsigned int kQuoteTableLength = 128u;
 
 static const int kJsonQuotesCharactersPerEntry = 8;
@@ -5891,6 +6541,372 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_QuoteJSONStringArray) {
 }
 
 
+// A C++ version of BasicJSONSerialize in json.js for JSON.stringify calls
+// without replacer and gap.  It only serializes what it can without running
+// JavaScript: primitives, arrays with fast elements and no holes, and plain
+// fast-mode objects without accessors.  Anything else, including any toJSON
+// property it would have to look at, makes it give up.  It has no side
+// effects, so the JavaScript version can then start over.
+template <typename Char>
+class BasicJsonStringifier BASE_EMBEDDED {
+ public:
+  enum Result { SUCCESS, UNDEFINED, BAILOUT, TWO_BYTE };
+
+  explicit BasicJsonStringifier(Isolate* isolate)
+      : heap_(isolate->heap()),
+        isolate_(isolate),
+        buffer_(NewArray<Char>(kInitialCapacity)),
+        length_(0),
+        capacity_(kInitialCapacity),
+        stack_(4),
+        properties_(16),
+        checked_maps_(4) { }
+
+  ~BasicJsonStringifier() { DeleteArray(buffer_); }
+
+  Result Serialize(Object* object) {
+    Result result = SerializeValue(object);
+    if (result == SUCCESS && length_ > String::kMaxLength) return BAILOUT;
+    return result;
+  }
+
+  Vector<const Char> output() {
+    return Vector<const Char>(buffer_, length_);
+  }
+
+ private:
+  struct PropertyEntry {
+    int enumeration_index;
+    int descriptor;
+  };
+
+  static int CompareEntries(const PropertyEntry* a, const PropertyEntry* b) {
+    return a->enumeration_index - b->enumeration_index;
+  }
+
+  static const int kInitialCapacity = 256;
+  static const int kMaxCheckedMaps = 16;
+
+  void EnsureCapacity(int additional) {
+    if (capacity_ - length_ >= additional) return;
+    int new_capacity = Max(2 * capacity_, length_ + additional);
+    Char* new_buffer = NewArray<Char>(new_capacity);
+    CopyChars(new_buffer, buffer_, length_);
+    DeleteArray(buffer_);
+    buffer_ = new_buffer;
+    capacity_ = new_capacity;
+  }
+
+  void Append(char c) {
+    EnsureCapacity(1);
+    buffer_[length_++] = c;
+  }
+
+  void Append(const char* chars) {
+    int length = StrLength(chars);
+    EnsureCapacity(length);
+    for (int i = 0; i < length; i++) buffer_[length_++] = chars[i];
+  }
+
+  void AppendNumber(double value) {
+    if (isnan(value) || isinf(value)) {
+      Append("null");
+    } else {
+      char chars[kDoubleToCStringMinBufferSize];
+      Append(DoubleToCString(value, Vector<char>(chars, sizeof(chars))));
+    }
+  }
+
+  void AppendSmi(Smi* value) {
+    char chars[kMaxSmiChars];
+    Append(IntToCString(value->value(), Vector<char>(chars, sizeof(chars))));
+  }
+
+  template <typename SourceChar>
+  Result AppendQuoted(Vector<const SourceChar> chars) {
+    EnsureCapacity(chars.length() * kJsonQuoteWorstCaseBlowup + 2);
+    Char* cursor = buffer_ + length_;
+    *(cursor++) = '"';
+    for (int i = 0; i < chars.length(); i++) {
+      SourceChar c = chars[i];
+      if (sizeof(SourceChar) > 1u &&
+          static_cast<unsigned>(c) >= kQuoteTableLength) {
+        if (sizeof(Char) == 1u) return TWO_BYTE;
+        *(cursor++) = static_cast<Char>(c);
+      } else {
+        int len = JsonQuoteLengths[static_cast<unsigned>(c)];
+        const char* replacement = JsonQuotes +
+            static_cast<unsigned>(c) * kJsonQuotesCharactersPerEntry;
+        for (int j = 0; j < len; j++) *(cursor++) = replacement[j];
+      }
+    }
+    *(cursor++) = '"';
+    length_ = static_cast<int>(cursor - buffer_);
+    return SUCCESS;
+  }
+
+  Result SerializeString(String* string) {
+    String::FlatContent content = string->GetFlatContent();
+    if (content.IsAscii()) return AppendQuoted(content.ToAsciiVector());
+    if (content.IsTwoByte()) return AppendQuoted(content.ToUC16Vector());
+    int length = string->length();
+    ScopedVector<uc16> chars(length);
+    String::WriteToFlat(string, chars.start(), 0, length);
+    return AppendQuoted(Vector<const uc16>(chars.start(), length));
+  }
+
+  // Returns whether looking up toJSON on the object could find something,
+  // or could run code.
+  bool MayHaveToJSON(JSObject* object) {
+    Map* map = object->map();
+    for (int i = 0; i < checked_maps_.length(); i++) {
+      if (checked_maps_[i] == map) return false;
+    }
+    Object* current = object;
+    while (!current->IsNull()) {
+      if (!current->IsJSObject()) return true;
+      JSObject* holder = JSObject::cast(current);
+      if (holder->IsAccessCheckNeeded() ||
+          holder->map()->has_named_interceptor()) {
+        return true;
+      }
+      LookupResult result(isolate_);
+      holder->LocalLookupRealNamedProperty(heap_->to_json_symbol(), &result);
+      if (result.IsProperty()) return true;
+      current = holder->GetPrototype();
+    }
+    // Objects with the same fast map have the same prototype and the same
+    // own properties, and no JavaScript runs until we are done.
+    if (object->HasFastProperties() &&
+        checked_maps_.length() < kMaxCheckedMaps) {
+      checked_maps_.Add(map);
+    }
+    return false;
+  }
+
+  // Cyclic structures make JSON.stringify throw, which is left to json.js.
+  bool IsOnStack(JSObject* object) {
+    for (int i = 0; i < stack_.length(); i++) {
+      if (stack_[i] == object) return true;
+    }
+    return false;
+  }
+
+  Result SerializeValue(Object* object) {
+    StackLimitCheck check(isolate_);
+    if (check.HasOverflowed()) return BAILOUT;
+    if (object->IsSmi()) {
+      AppendSmi(Smi::cast(object));
+      return SUCCESS;
+    }
+    InstanceType type = HeapObject::cast(object)->map()->instance_type();
+    if (type < FIRST_NONSTRING_TYPE) {
+      return SerializeString(String::cast(object));
+    }
+    switch (type) {
+      case HEAP_NUMBER_TYPE:
+        AppendNumber(HeapNumber::cast(object)->value());
+        return SUCCESS;
+      case ODDBALL_TYPE:
+        if (object->IsTrue()) {
+          Append("true");
+        } else if (object->IsFalse()) {
+          Append("false");
+        } else if (object->IsNull()) {
+          Append("null");
+        } else if (object->IsUndefined()) {
+          return UNDEFINED;
+        } else {
+          return BAILOUT;
+        }
+        return SUCCESS;
+      case JS_ARRAY_TYPE:
+        if (MayHaveToJSON(JSObject::cast(object))) return BAILOUT;
+        return SerializeArray(JSArray::cast(object));
+      case JS_OBJECT_TYPE:
+        if (MayHaveToJSON(JSObject::cast(object))) return BAILOUT;
+        return SerializeObject(JSObject::cast(object));
+      case JS_FUNCTION_TYPE:
+        if (MayHaveToJSON(JSObject::cast(object))) return BAILOUT;
+        return UNDEFINED;
+      default:
+        return BAILOUT;
+    }
+  }
+
+  Result SerializeArray(JSArray* array) {
+    if (!array->length()->IsSmi() || IsOnStack(array)) return BAILOUT;
+    int length = Smi::cast(array->length())->value();
+    if (length == 0) {
+      Append("[]");
+      return SUCCESS;
+    }
+    if (array->elements()->length() < length) return BAILOUT;
+    stack_.Add(array);
+    Append('[');
+    switch (array->GetElementsKind()) {
+      case FAST_SMI_ONLY_ELEMENTS:
+      case FAST_ELEMENTS: {
+        FixedArray* elements = FixedArray::cast(array->elements());
+        for (int i = 0; i < length; i++) {
+          Object* element = elements->get(i);
+          // Holes would be looked up in the prototype chain.
+          if (element->IsTheHole()) return BAILOUT;
+          if (i > 0) Append(',');
+          Result result = SerializeValue(element);
+          if (result == UNDEFINED) {
+            Append("null");
+          } else if (result != SUCCESS) {
+            return result;
+          }
+        }
+        break;
+      }
+      case FAST_DOUBLE_ELEMENTS: {
+        FixedDoubleArray* elements = FixedDoubleArray::cast(array->elements());
+        for (int i = 0; i < length; i++) {
+          if (elements->is_the_hole(i)) return BAILOUT;
+          if (i > 0) Append(',');
+          AppendNumber(elements->get_scalar(i));
+        }
+        break;
+      }
+      default:
+        return BAILOUT;
+    }
+    Append(']');
+    stack_.RemoveLast();
+    return SUCCESS;
+  }
+
+  Result SerializeObject(JSObject* object) {
+    if (!object->HasFastProperties() ||
+        object->elements()->length() > 0 ||
+        IsOnStack(object)) {
+      return BAILOUT;
+    }
+    // Collect the enumerable properties in for-in order.  The entries of
+    // nested objects go on top of ours, so only use indices into the list.
+    DescriptorArray* descriptors = object->map()->instance_descriptors();
+    int base = properties_.length();
+    for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+      if (descriptors->IsDontEnum(i)) continue;
+      PropertyDetails details(descriptors->GetDetails(i));
+      switch (details.type()) {
+        case FIELD:
+        case CONSTANT_FUNCTION: {
+          PropertyEntry entry = { details.index(), i };
+          properties_.Add(entry);
+          break;
+        }
+        case NORMAL:
+        case CALLBACKS:
+        case HANDLER:
+        case INTERCEPTOR:
+          return BAILOUT;
+        default:
+          // Transitions and null descriptors are not properties.
+          break;
+      }
+    }
+    int count = properties_.length() - base;
+    if (count > 1) {
+      Vector<PropertyEntry>(&properties_[base], count).Sort(CompareEntries);
+    }
+
+    stack_.Add(object);
+    Append('{');
+    bool comma = false;
+    for (int i = 0; i < count; i++) {
+      int descriptor = properties_[base + i].descriptor;
+      Object* value = descriptors->GetType(descriptor) == FIELD
+          ? object->FastPropertyAt(descriptors->GetFieldIndex(descriptor))
+          : descriptors->GetConstantFunction(descriptor);
+      int mark = length_;
+      if (comma) Append(',');
+      Result result = SerializeString(descriptors->GetKey(descriptor));
+      if (result != SUCCESS) return result;
+      Append(':');
+      result = SerializeValue(value);
+      if (result == UNDEFINED) {
+        // Properties with undefined or function values are left out.
+        length_ = mark;
+      } else if (result != SUCCESS) {
+        return result;
+      } else {
+        comma = true;
+      }
+    }
+    Append('}');
+    properties_.Rewind(base);
+    stack_.RemoveLast();
+    return SUCCESS;
+  }
+
+  // Enough for the sign and the ten digits of a 32-bit integer.
+  static const int kMaxSmiChars = 16;
+
+  Heap* heap_;
+  Isolate* isolate_;
+  Char* buffer_;
+  int length_;
+  int capacity_;
+  List<JSObject*> stack_;
+  List<PropertyEntry> properties_;
+  List<Map*> checked_maps_;
+
+  DISALLOW_COPY_AND_ASSIGN(BasicJsonStringifier);
+};
+
+
+template <typename Char, typename StringType>
+static MaybeObject* BasicJsonStringify(Isolate* isolate,
+                                       Object* object,
+                                       bool* two_byte) {
+  BasicJsonStringifier<Char> stringifier(isolate);
+  typename BasicJsonStringifier<Char>::Result result;
+  { AssertNoAllocation no_allocation;
+    result = stringifier.Serialize(object);
+  }
+  switch (result) {
+    case BasicJsonStringifier<Char>::SUCCESS:
+      break;
+    case BasicJsonStringifier<Char>::UNDEFINED:
+      return isolate->heap()->undefined_value();
+    case BasicJsonStringifier<Char>::TWO_BYTE:
+      *two_byte = true;
+      return isolate->heap()->false_value();
+    case BasicJsonStringifier<Char>::BAILOUT:
+      return isolate->heap()->false_value();
+  }
+  Vector<const Char> output = stringifier.output();
+  Object* string;
+  { MaybeObject* maybe_string =
+        AllocateRawString<StringType>(isolate, output.length());
+    if (!maybe_string->ToObject(&string)) return maybe_string;
+  }
+  CopyChars(StringType::cast(string)->GetChars(),
+            output.start(),
+            output.length());
+  return string;
+}
+
+
+// Returns the JSON text for the argument, undefined if it has none, or
+// false if the caller has to serialize it in JavaScript instead.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_BasicJSONStringify) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+  bool two_byte = false;
+  MaybeObject* result =
+      BasicJsonStringify<char, SeqAsciiString>(isolate, args[0], &two_byte);
+  if (!two_byte) return result;
+  return BasicJsonStringify<uc16, SeqTwoByteString>(isolate,
+                                                    args[0],
+                                                    &two_byte);
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_StringParseInt) {
   NoHandleAllocation ha;
 
@@ -6056,10 +7072,10 @@ enum AsciiCaseConversion {
 
 template <AsciiCaseConversion dir>
 struct FastAsciiConverter {
-  static bool Convert(char* dst, char* src, int length) {
+  static bool Convert(char* dst, const char* src, int length) {
 #ifdef DEBUG
     char* saved_dst = dst;
-    char* saved_src = src;
+    const char* saved_src = src;
 #endif
     // We rely on the distance between upper and lower case letters
     // being a known power of 2.
@@ -6068,12 +7084,12 @@ struct FastAsciiConverter {
     const char lo = (dir == ASCII_TO_LOWER) ? 'A' - 1 : 'a' - 1;
     const char hi = (dir == ASCII_TO_LOWER) ? 'Z' + 1 : 'z' + 1;
     bool changed = false;
-    char* const limit = src + length;
+    const char* const limit = src + length;
 #ifdef V8_HOST_CAN_READ_UNALIGNED
     // Process the prefix of the input that requires no conversion one
     // (machine) word at a time.
     while (src <= limit - sizeof(uintptr_t)) {
-      uintptr_t w = *reinterpret_cast<uintptr_t*>(src);
+      uintptr_t w = *reinterpret_cast<const uintptr_t*>(src);
       if (AsciiRangeMask(w, lo, hi) != 0) {
         changed = true;
         break;
@@ -6085,7 +7101,7 @@ struct FastAsciiConverter {
     // Process the remainder of the input performing conversion when
     // required one word at a time.
     while (src <= limit - sizeof(uintptr_t)) {
-      uintptr_t w = *reinterpret_cast<uintptr_t*>(src);
+      uintptr_t w = *reinterpret_cast<const uintptr_t*>(src);
       uintptr_t m = AsciiRangeMask(w, lo, hi);
       // The mask has high (7th) bit set in every byte that needs
       // conversion and we know that the distance between cases is
@@ -6114,7 +7130,10 @@ struct FastAsciiConverter {
   }
 
 #ifdef DEBUG
-  static void CheckConvert(char* dst, char* src, int length, bool changed) {
+  static void CheckConvert(char* dst,
+                           const char* src,
+                           int length,
+                           bool changed) {
     bool expected_changed = false;
     for (int i = 0; i < length; i++) {
       if (dst[i] == src[i]) continue;
@@ -6134,10 +7153,40 @@ struct FastAsciiConverter {
 };
 
 
+// Converts the case of two-byte characters that are all Latin-1 with a
+// single-character case, using a table from RuntimeState.  Returns false
+// without writing anything if there are other characters.
+static bool ConvertLatin1Case(uc16* dst,
+                              Vector<const uc16> src,
+                              const uc16* table,
+                              bool* changed) {
+  int length = src.length();
+  for (int i = 0; i < length; i++) {
+    uc16 c = src[i];
+    if (c >= RuntimeState::kLatin1TableSize ||
+        table[c] == RuntimeState::kNoLatin1CaseMapping) {
+      return false;
+    }
+  }
+  bool has_changed_character = false;
+  for (int i = 0; i < length; i++) {
+    uc16 c = table[src[i]];
+    has_changed_character |= (c != src[i]);
+    dst[i] = c;
+  }
+  *changed = has_changed_character;
+  return true;
+}
+
+
 struct ToLowerTraits {
   typedef unibrow::ToLowercase UnibrowConverter;
 
   typedef FastAsciiConverter<ASCII_TO_LOWER> AsciiConverter;
+
+  static const uc16* Latin1Table(RuntimeState* state) {
+    return state->latin1_to_lower();
+  }
 };
 
 
@@ -6145,11 +7194,37 @@ struct ToUpperTraits {
   typedef unibrow::ToUppercase UnibrowConverter;
 
   typedef FastAsciiConverter<ASCII_TO_UPPER> AsciiConverter;
+
+  static const uc16* Latin1Table(RuntimeState* state) {
+    return state->latin1_to_upper();
+  }
 };
 
 }  // namespace
 
 
+template <class Converter>
+static uc16 Latin1CaseMapping(unibrow::Mapping<Converter, 128>* mapping,
+                              uc16 c) {
+  unibrow::uchar chars[Converter::kMaxWidth];
+  int length = mapping->get(c, 0, chars);
+  if (length == 0) return c;
+  if (length == 1 && chars[0] < RuntimeState::kNoLatin1CaseMapping) {
+    return static_cast<uc16>(chars[0]);
+  }
+  return RuntimeState::kNoLatin1CaseMapping;
+}
+
+
+void RuntimeState::InitializeLatin1Tables() {
+  for (int c = 0; c < kLatin1TableSize; c++) {
+    latin1_to_upper_[c] = Latin1CaseMapping(&to_upper_mapping_, c);
+    latin1_to_lower_[c] = Latin1CaseMapping(&to_lower_mapping_, c);
+  }
+  latin1_tables_initialized_ = true;
+}
+
+
 template <typename ConvertTraits>
 MUST_USE_RESULT static MaybeObject* ConvertCase(
     Arguments args,
@@ -6169,17 +7244,37 @@ MUST_USE_RESULT static MaybeObject* ConvertCase(
   // character is also ascii.  This is currently the case, but it
   // might break in the future if we implement more context and locale
   // dependent upper/lower conversions.
-  if (s->IsSeqAsciiString()) {
+  if (s->IsFlat() && s->IsAsciiRepresentation()) {
     Object* o;
     { MaybeObject* maybe_o = isolate->heap()->AllocateRawAsciiString(length);
       if (!maybe_o->ToObject(&o)) return maybe_o;
     }
     SeqAsciiString* result = SeqAsciiString::cast(o);
     bool has_changed_character = ConvertTraits::AsciiConverter::Convert(
-        result->GetChars(), SeqAsciiString::cast(s)->GetChars(), length);
+        result->GetChars(),
+        s->GetFlatContent().ToAsciiVector().start(),
+        length);
     return has_changed_character ? result : s;
   }
 
+  // Two-byte strings of Latin-1 text are converted through a table.
+  if (s->IsFlat() && s->IsTwoByteRepresentation()) {
+    Object* o;
+    { MaybeObject* maybe_o =
+          isolate->heap()->AllocateRawTwoByteString(length);
+      if (!maybe_o->ToObject(&o)) return maybe_o;
+    }
+    SeqTwoByteString* result = SeqTwoByteString::cast(o);
+    bool has_changed_character;
+    if (ConvertLatin1Case(
+            result->GetChars(),
+            s->GetFlatContent().ToUC16Vector(),
+            ConvertTraits::Latin1Table(isolate->runtime_state()),
+            &has_changed_character)) {
+      return has_changed_character ? result : s;
+    }
+  }
+
   Object* answer;
   { MaybeObject* maybe_answer =
         ConvertCaseHelper(isolate, s, length, length, mapping);
@@ -6583,6 +7678,127 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_NumberAlloc) {
 }
 
 
+static bool IsInteger(Object* value) {
+  return value->IsSmi() || value->IsBigInteger();
+}
+
+
+// Integer arithmetic is exact while both operands are smis or
+// BigIntegers, promoting to BigInteger instead of losing precision.  Any
+// other operand gives the ordinary JavaScript result.
+static MaybeObject* IntegerOperation(Arguments args,
+                                     Isolate* isolate,
+                                     Token::Value op) {
+  Object* x = args[0];
+  Object* y = args[1];
+  Heap* heap = isolate->heap();
+  if (IsInteger(x) && IsInteger(y)) {
+    switch (op) {
+      case Token::ADD: return BigInteger::Add(heap, x, y);
+      case Token::SUB: return BigInteger::Subtract(heap, x, y);
+      case Token::MUL: return BigInteger::Multiply(heap, x, y);
+      default: UNREACHABLE();
+    }
+  }
+
+  if ((x->IsNumber() || x->IsBigInteger()) &&
+      (y->IsNumber() || y->IsBigInteger())) {
+    double a = x->IsBigInteger() ? BigInteger::cast(x)->ToDouble()
+                                 : x->Number();
+    double b = y->IsBigInteger() ? BigInteger::cast(y)->ToDouble()
+                                 : y->Number();
+    switch (op) {
+      case Token::ADD: return heap->NumberFromDouble(a + b);
+      case Token::SUB: return heap->NumberFromDouble(a - b);
+      case Token::MUL: return heap->NumberFromDouble(a * b);
+      default: UNREACHABLE();
+    }
+  }
+
+  HandleScope scope(isolate);
+  Handle<Object> left(x, isolate);
+  Handle<Object> right(y, isolate);
+  Handle<JSBuiltinsObject> builtins = Handle<JSBuiltinsObject>(
+      isolate->thread_local_top()->context_->builtins(), isolate);
+  Object* builtin = NULL;
+  switch (op) {
+    case Token::ADD:
+      builtin = builtins->javascript_builtin(Builtins::ADD);
+      break;
+    case Token::SUB:
+      builtin = builtins->javascript_builtin(Builtins::SUB);
+      break;
+    case Token::MUL:
+      builtin = builtins->javascript_builtin(Builtins::MUL);
+      break;
+    default:
+      UNREACHABLE();
+  }
+  Handle<JSFunction> builtin_function(JSFunction::cast(builtin), isolate);
+  bool caught_exception;
+  Handle<Object> builtin_args[] = { right };
+  Handle<Object> result = Execution::Call(builtin_function,
+                                          left,
+                                          ARRAY_SIZE(builtin_args),
+                                          builtin_args,
+                                          &caught_exception);
+  if (caught_exception) return Failure::Exception();
+  return *result;
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_IntegerAdd) {
+  ASSERT(args.length() == 2);
+  return IntegerOperation(args, isolate, Token::ADD);
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_IntegerSub) {
+  ASSERT(args.length() == 2);
+  return IntegerOperation(args, isolate, Token::SUB);
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_IntegerMul) {
+  ASSERT(args.length() == 2);
+  return IntegerOperation(args, isolate, Token::MUL);
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_IntegerToNumber) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+
+  CONVERT_CHECKED(BigInteger, x, args[0]);
+  return isolate->heap()->NumberFromDouble(x->ToDouble());
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_IntegerToString) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+
+  CONVERT_CHECKED(BigInteger, x, args[0]);
+  return x->ToString();
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_IsAtom) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+  return isolate->heap()->ToBoolean(args[0]->IsAtom());
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_AtomName) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+
+  CONVERT_CHECKED(Atom, atom, args[0]);
+  return atom->name();
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_NumberDiv) {
   NoHandleAllocation ha;
   ASSERT(args.length() == 2);
@@ -6606,12 +7822,27 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_NumberMod) {
 }
 
 
+static MaybeObject* RebalancingStringAdd(Isolate* isolate,
+                                         String* first,
+                                         String* second) {
+  HandleScope scope(isolate);
+  return *isolate->factory()->NewConsString(Handle<String>(first, isolate),
+                                            Handle<String>(second, isolate));
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_StringAdd) {
   NoHandleAllocation ha;
   ASSERT(args.length() == 2);
   CONVERT_CHECKED(String, str1, args[0]);
   CONVERT_CHECKED(String, str2, args[1]);
   isolate->counters()->string_add_runtime()->Increment();
+  int depth = Max(ConsString::DepthOf(str1), ConsString::DepthOf(str2)) + 1;
+  if (depth > ConsString::kMaxDepth) {
+    // Rebalancing allocates many cons cells and may need to collect garbage
+    // in between.
+    return RebalancingStringAdd(isolate, str1, str2);
+  }
   return isolate->heap()->AllocateConsString(str1, str2);
 }
 
@@ -6854,6 +8085,260 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_StringBuilderJoin) {
   return answer;
 }
 
+
+// The string builders in the JavaScript natives accumulate their result in a
+// sequential string of which only a prefix is in use.  Appending writes into
+// the rest of it, and a full buffer is replaced by one twice as large, so the
+// cost of an append is amortized constant per character.  Buffers never
+// escape to user code.
+static const int kStringBuilderMinCapacity = 16;
+
+
+static MaybeObject* AllocateStringBuilderBuffer(Heap* heap,
+                                                String* buffer,
+                                                int length,
+                                                int capacity,
+                                                bool ascii) {
+  Object* object;
+  { MaybeObject* maybe_object = ascii ?
+        heap->AllocateRawAsciiString(capacity) :
+        heap->AllocateRawTwoByteString(capacity);
+    if (!maybe_object->ToObject(&object)) return maybe_object;
+  }
+  if (ascii) {
+    String::WriteToFlat(buffer,
+                        SeqAsciiString::cast(object)->GetChars(),
+                        0,
+                        length);
+  } else {
+    String::WriteToFlat(buffer,
+                        SeqTwoByteString::cast(object)->GetChars(),
+                        0,
+                        length);
+  }
+  return object;
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_StringBuilderNew) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+  CONVERT_SMI_ARG_CHECKED(capacity, 0);
+  RUNTIME_ASSERT(capacity >= 0);
+  capacity = Min(Max(capacity, kStringBuilderMinCapacity), String::kMaxLength);
+  return isolate->heap()->AllocateRawAsciiString(capacity);
+}
+
+
+// Appends the characters [from, to) of string to the first length
+// characters of buffer and returns the buffer to use from now on.
+static MaybeObject* StringBuilderAppend(Isolate* isolate,
+                                        SeqString* buffer,
+                                        int length,
+                                        String* string,
+                                        int from,
+                                        int to) {
+  int count = to - from;
+  if (count > String::kMaxLength - length) {
+    isolate->context()->mark_out_of_memory();
+    return Failure::OutOfMemoryException();
+  }
+  int needed = length + count;
+  bool ascii = buffer->IsAsciiRepresentation();
+  if (ascii && !string->HasOnlyAsciiChars()) ascii = false;
+
+  if (needed > buffer->length() || ascii != buffer->IsAsciiRepresentation()) {
+    int capacity = Max(needed, kStringBuilderMinCapacity);
+    capacity = Max(capacity, Min(2 * buffer->length(), String::kMaxLength));
+    Object* object;
+    { MaybeObject* maybe_object = AllocateStringBuilderBuffer(
+          isolate->heap(), buffer, length, capacity, ascii);
+      if (!maybe_object->ToObject(&object)) return maybe_object;
+    }
+    buffer = SeqString::cast(object);
+  }
+
+  if (ascii) {
+    String::WriteToFlat(string,
+                        SeqAsciiString::cast(buffer)->GetChars() + length,
+                        from,
+                        to);
+  } else {
+    String::WriteToFlat(string,
+                        SeqTwoByteString::cast(buffer)->GetChars() + length,
+                        from,
+                        to);
+  }
+  return buffer;
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_StringBuilderAppend) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 5);
+  CONVERT_CHECKED(SeqString, buffer, args[0]);
+  CONVERT_SMI_ARG_CHECKED(length, 1);
+  CONVERT_CHECKED(String, string, args[2]);
+  CONVERT_SMI_ARG_CHECKED(from, 3);
+  CONVERT_SMI_ARG_CHECKED(to, 4);
+  RUNTIME_ASSERT(0 <= length && length <= buffer->length());
+  RUNTIME_ASSERT(0 <= from && from <= to && to <= string->length());
+  return StringBuilderAppend(isolate, buffer, length, string, from, to);
+}
+
+
+// Returns the first length characters of buffer as a string of its own.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_StringBuilderFinish) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 2);
+  CONVERT_CHECKED(SeqString, buffer, args[0]);
+  CONVERT_SMI_ARG_CHECKED(length, 1);
+  RUNTIME_ASSERT(0 <= length && length <= buffer->length());
+
+  Heap* heap = isolate->heap();
+  if (length == 0) return heap->empty_string();
+  if (length == buffer->length()) return buffer;
+
+  // The most recently grown buffer is usually still the last object in new
+  // space, in which case it can give back its unused tail.
+  bool ascii = buffer->IsAsciiRepresentation();
+  int size = ascii ? SeqAsciiString::SizeFor(buffer->length())
+                   : SeqTwoByteString::SizeFor(buffer->length());
+  if (heap->new_space()->Contains(buffer) &&
+      buffer->address() + size == heap->new_space()->top()) {
+    if (ascii) {
+      heap->new_space()->ShrinkStringAtAllocationBoundary<SeqAsciiString>(
+          buffer, length);
+    } else {
+      heap->new_space()->ShrinkStringAtAllocationBoundary<SeqTwoByteString>(
+          buffer, length);
+    }
+    return buffer;
+  }
+  return AllocateStringBuilderBuffer(heap, buffer, length, length, ascii);
+}
+
+
+// String buffers use the same growth policy as the string builders, but
+// keep their backing store and length in a StringBuffer, which may escape.
+// Appending to a string, which is immutable, copies it into a new buffer.
+static MaybeObject* StringAppend(Isolate* isolate,
+                                 Object* receiver,
+                                 String* string,
+                                 int from,
+                                 int to) {
+  Heap* heap = isolate->heap();
+  StringBuffer* target;
+  if (receiver->IsStringBuffer()) {
+    target = StringBuffer::cast(receiver);
+  } else {
+    String* initial = String::cast(receiver);
+    int length = initial->length();
+    Object* buffer;
+    { MaybeObject* maybe_buffer = AllocateStringBuilderBuffer(
+          heap,
+          initial,
+          length,
+          Max(length, kStringBuilderMinCapacity),
+          initial->IsAsciiRepresentation());
+      if (!maybe_buffer->ToObject(&buffer)) return maybe_buffer;
+    }
+    Object* object;
+    { MaybeObject* maybe_object = heap->AllocateStruct(STRING_BUFFER_TYPE);
+      if (!maybe_object->ToObject(&object)) return maybe_object;
+    }
+    target = StringBuffer::cast(object);
+    target->set_buffer(SeqString::cast(buffer));
+    target->set_length(length);
+  }
+
+  Object* buffer;
+  { MaybeObject* maybe_buffer = StringBuilderAppend(
+        isolate, target->buffer(), target->length(), string, from, to);
+    if (!maybe_buffer->ToObject(&buffer)) return maybe_buffer;
+  }
+  target->set_buffer(SeqString::cast(buffer));
+  target->set_length(target->length() + to - from);
+  return target;
+}
+
+
+// Implements Ruby's '<<'.  Appends the string value of the second argument
+// to a string buffer in place and returns the buffer, or to a string, in
+// which case the result is a new buffer.  Any other receiver is shifted
+// left as by the JavaScript operator.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_StringAppend) {
+  ASSERT(args.length() == 2);
+  Object* receiver = args[0];
+  Object* value = args[1];
+  if (receiver->IsString() || receiver->IsStringBuffer()) {
+    if (value->IsString()) {
+      return StringAppend(isolate,
+                          receiver,
+                          String::cast(value),
+                          0,
+                          String::cast(value)->length());
+    }
+    if (value->IsStringBuffer()) {
+      StringBuffer* source = StringBuffer::cast(value);
+      return StringAppend(isolate,
+                          receiver,
+                          source->buffer(),
+                          0,
+                          source->length());
+    }
+  }
+
+  HandleScope scope(isolate);
+  Handle<Object> left = args.at<Object>(0);
+  Handle<Object> right = args.at<Object>(1);
+  bool caught_exception;
+  if (left->IsString() || left->IsStringBuffer()) {
+    Handle<Object> string = Execution::ToString(right, &caught_exception);
+    if (caught_exception) return Failure::Exception();
+    return StringAppend(isolate,
+                        *left,
+                        String::cast(*string),
+                        0,
+                        String::cast(*string)->length());
+  }
+
+  Handle<JSBuiltinsObject> builtins = Handle<JSBuiltinsObject>(
+      isolate->thread_local_top()->context_->builtins(), isolate);
+  Handle<JSFunction> builtin_function(
+      JSFunction::cast(builtins->javascript_builtin(Builtins::SHL)), isolate);
+  Handle<Object> builtin_args[] = { right };
+  Handle<Object> result = Execution::Call(builtin_function,
+                                          left,
+                                          ARRAY_SIZE(builtin_args),
+                                          builtin_args,
+                                          &caught_exception);
+  if (caught_exception) return Failure::Exception();
+  return *result;
+}
+
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_IsStringBuffer) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+  return isolate->heap()->ToBoolean(args[0]->IsStringBuffer());
+}
+
+
+// Returns a flat string with the contents of a string buffer.  Long
+// contents are a slice of the backing store, which is safe because
+// appending never changes characters that are in use.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_StringBufferToString) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 1);
+
+  CONVERT_CHECKED(StringBuffer, buffer, args[0]);
+  return isolate->heap()->AllocateSubString(buffer->buffer(),
+                                            0,
+                                            buffer->length());
+}
+
+
 template <typename Char>
 static void JoinSparseArrayWithSeparator(FixedArray* elements,
                                          int elements_length,
@@ -7504,51 +8989,6 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_Math_tan) {
 }
 
 
-static int MakeDay(int year, int month) {
-  static const int day_from_month[] = {0, 31, 59, 90, 120, 151,
-                                       181, 212, 243, 273, 304, 334};
-  static const int day_from_month_leap[] = {0, 31, 60, 91, 121, 152,
-                                            182, 213, 244, 274, 305, 335};
-
-  year += month / 12;
-  month %= 12;
-  if (month < 0) {
-    year--;
-    month += 12;
-  }
-
-  ASSERT(month >= 0);
-  ASSERT(month < 12);
-
-  // year_delta is an arbitrary number such that:
-  // a) year_delta = -1 (mod 400)
-  // b) year + year_delta > 0 for years in the range defined by
-  //    ECMA 262 - 15.9.1.1, i.e. upto 100,000,000 days on either side of
-  //    Jan 1 1970. This is required so that we don't run into integer
-  //    division of negative numbers.
-  // c) there shouldn't be an overflow for 32-bit integers in the following
-  //    operations.
-  static const int year_delta = 399999;
-  static const int base_day = 365 * (1970 + year_delta) +
-                              (1970 + year_delta) / 4 -
-                              (1970 + year_delta) / 100 +
-                              (1970 + year_delta) / 400;
-
-  int year1 = year + year_delta;
-  int day_from_year = 365 * year1 +
-                      year1 / 4 -
-                      year1 / 100 +
-                      year1 / 400 -
-                      base_day;
-
-  if ((year % 4 != 0) || (year % 100 == 0 && year % 400 != 0)) {
-    return day_from_year + day_from_month[month];
-  }
-
-  return day_from_year + day_from_month_leap[month];
-}
-
-
 RUNTIME_FUNCTION(MaybeObject*, Runtime_DateMakeDay) {
   NoHandleAllocation ha;
   ASSERT(args.length() == 2);
@@ -7556,319 +8996,77 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_DateMakeDay) {
   CONVERT_SMI_ARG_CHECKED(year, 0);
   CONVERT_SMI_ARG_CHECKED(month, 1);
 
-  return Smi::FromInt(MakeDay(year, month));
-}
-
-
-static const int kDays4Years[] = {0, 365, 2 * 365, 3 * 365 + 1};
-static const int kDaysIn4Years = 4 * 365 + 1;
-static const int kDaysIn100Years = 25 * kDaysIn4Years - 1;
-static const int kDaysIn400Years = 4 * kDaysIn100Years + 1;
-static const int kDays1970to2000 = 30 * 365 + 7;
-static const int kDaysOffset = 1000 * kDaysIn400Years + 5 * kDaysIn400Years -
-                               kDays1970to2000;
-static const int kYearsOffset = 400000;
-
-static const char kDayInYear[] = {
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30,
-      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
-      22, 23, 24, 25, 26, 27, 28, 29, 30, 31};
-
-static const char kMonthInYear[] = {
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-      0, 0, 0, 0, 0, 0,
-      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-      1, 1, 1,
-      2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-      2, 2, 2, 2, 2, 2,
-      3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-      3, 3, 3, 3, 3,
-      4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-      4, 4, 4, 4, 4, 4,
-      5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-      5, 5, 5, 5, 5,
-      6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
-      6, 6, 6, 6, 6, 6,
-      7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-      7, 7, 7, 7, 7, 7,
-      8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-      8, 8, 8, 8, 8,
-      9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
-      9, 9, 9, 9, 9, 9,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
-
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-      0, 0, 0, 0, 0, 0,
-      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-      1, 1, 1,
-      2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-      2, 2, 2, 2, 2, 2,
-      3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-      3, 3, 3, 3, 3,
-      4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-      4, 4, 4, 4, 4, 4,
-      5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-      5, 5, 5, 5, 5,
-      6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
-      6, 6, 6, 6, 6, 6,
-      7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-      7, 7, 7, 7, 7, 7,
-      8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-      8, 8, 8, 8, 8,
-      9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
-      9, 9, 9, 9, 9, 9,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
-
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-      0, 0, 0, 0, 0, 0,
-      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-      1, 1, 1, 1,
-      2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-      2, 2, 2, 2, 2, 2,
-      3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-      3, 3, 3, 3, 3,
-      4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-      4, 4, 4, 4, 4, 4,
-      5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-      5, 5, 5, 5, 5,
-      6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
-      6, 6, 6, 6, 6, 6,
-      7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-      7, 7, 7, 7, 7, 7,
-      8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-      8, 8, 8, 8, 8,
-      9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
-      9, 9, 9, 9, 9, 9,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
-
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-      0, 0, 0, 0, 0, 0,
-      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-      1, 1, 1,
-      2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-      2, 2, 2, 2, 2, 2,
-      3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-      3, 3, 3, 3, 3,
-      4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-      4, 4, 4, 4, 4, 4,
-      5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-      5, 5, 5, 5, 5,
-      6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
-      6, 6, 6, 6, 6, 6,
-      7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-      7, 7, 7, 7, 7, 7,
-      8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-      8, 8, 8, 8, 8,
-      9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
-      9, 9, 9, 9, 9, 9,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
-      11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11};
-
-
-// This function works for dates from 1970 to 2099.
-static inline void DateYMDFromTimeAfter1970(int date,
-                                            int& year, int& month, int& day) {
-#ifdef DEBUG
-  int save_date = date;  // Need this for ASSERT in the end.
-#endif
-
-  year = 1970 + (4 * date + 2) / kDaysIn4Years;
-  date %= kDaysIn4Years;
-
-  month = kMonthInYear[date];
-  day = kDayInYear[date];
-
-  ASSERT(MakeDay(year, month) + day - 1 == save_date);
+  return Smi::FromInt(DateCache::DaysFromYearMonth(year, month));
 }
 
 
-static inline void DateYMDFromTimeSlow(int date,
-                                       int& year, int& month, int& day) {
-#ifdef DEBUG
-  int save_date = date;  // Need this for ASSERT in the end.
-#endif
-
-  date += kDaysOffset;
-  year = 400 * (date / kDaysIn400Years) - kYearsOffset;
-  date %= kDaysIn400Years;
-
-  ASSERT(MakeDay(year, 0) + date == save_date);
-
-  date--;
-  int yd1 = date / kDaysIn100Years;
-  date %= kDaysIn100Years;
-  year += 100 * yd1;
-
-  date++;
-  int yd2 = date / kDaysIn4Years;
-  date %= kDaysIn4Years;
-  year += 4 * yd2;
-
-  date--;
-  int yd3 = date / 365;
-  date %= 365;
-  year += yd3;
-
-  bool is_leap = (!yd1 || yd2) && !yd3;
-
-  ASSERT(date >= -1);
-  ASSERT(is_leap || (date >= 0));
-  ASSERT((date < 365) || (is_leap && (date < 366)));
-  ASSERT(is_leap == ((year % 4 == 0) && (year % 100 || (year % 400 == 0))));
-  ASSERT(is_leap || ((MakeDay(year, 0) + date) == save_date));
-  ASSERT(!is_leap || ((MakeDay(year, 0) + date + 1) == save_date));
-
-  if (is_leap) {
-    day = kDayInYear[2*365 + 1 + date];
-    month = kMonthInYear[2*365 + 1 + date];
-  } else {
-    day = kDayInYear[date];
-    month = kMonthInYear[date];
-  }
-
-  ASSERT(MakeDay(year, month) + day - 1 == save_date);
-}
-
+// Sets the time value of a date, given in UTC or, if is_utc is 0, in local
+// time.  Clips the time like TimeClip in ECMA 262 - 15.9.1.14 and returns
+// the new value.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_DateSetValue) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 3);
 
-static inline void DateYMDFromTime(int date,
-                                   int& year, int& month, int& day) {
-  if (date >= 0 && date < 32 * kDaysIn4Years) {
-    DateYMDFromTimeAfter1970(date, year, month, day);
-  } else {
-    DateYMDFromTimeSlow(date, year, month, day);
+  CONVERT_CHECKED(JSDate, date, args[0]);
+  CONVERT_DOUBLE_ARG_CHECKED(time, 1);
+  CONVERT_SMI_ARG_CHECKED(is_utc, 2);
+
+  DateCache* date_cache = isolate->date_cache();
+
+  Object* value = isolate->heap()->nan_value();
+  bool is_value_nan = true;
+  if (!isnan(time) &&
+      (is_utc ||
+       (time >= -DateCache::kMaxTimeBeforeUTCInMs &&
+        time <= DateCache::kMaxTimeBeforeUTCInMs))) {
+    if (!is_utc) {
+      time = static_cast<double>(
+          date_cache->ToUTC(static_cast<int64_t>(time)));
+    }
+    if (time >= -DateCache::kMaxTimeInMs && time <= DateCache::kMaxTimeInMs) {
+      MaybeObject* maybe_value =
+          isolate->heap()->AllocateHeapNumber(DoubleToInteger(time));
+      if (!maybe_value->ToObject(&value)) return maybe_value;
+      is_value_nan = false;
+    }
   }
+  date->SetValue(value, is_value_nan);
+  return value;
 }
 
 
-RUNTIME_FUNCTION(MaybeObject*, Runtime_DateYMDFromTime) {
+// ECMA 262 - 15.9.5.43.  The caller checks that the time value is not NaN.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_DateToISOString) {
   NoHandleAllocation ha;
-  ASSERT(args.length() == 2);
+  ASSERT(args.length() == 1);
 
-  CONVERT_DOUBLE_ARG_CHECKED(t, 0);
-  CONVERT_CHECKED(JSArray, res_array, args[1]);
+  CONVERT_CHECKED(JSDate, date, args[0]);
+  double time = date->value()->Number();
+  RUNTIME_ASSERT(!isnan(time));
 
+  int64_t time_ms = static_cast<int64_t>(time);
+  int days = DateCache::DaysFromTime(time_ms);
+  int time_in_day_ms = DateCache::TimeInDay(time_ms, days);
   int year, month, day;
-  DateYMDFromTime(static_cast<int>(floor(t / 86400000)), year, month, day);
-
-  FixedArrayBase* elms_base = FixedArrayBase::cast(res_array->elements());
-  RUNTIME_ASSERT(elms_base->length() == 3);
-  RUNTIME_ASSERT(res_array->HasFastTypeElements());
-
-  MaybeObject* maybe = res_array->EnsureWritableFastElements();
-  if (maybe->IsFailure()) return maybe;
-  FixedArray* elms = FixedArray::cast(res_array->elements());
-  elms->set(0, Smi::FromInt(year));
-  elms->set(1, Smi::FromInt(month));
-  elms->set(2, Smi::FromInt(day));
-
-  return isolate->heap()->undefined_value();
+  isolate->date_cache()->YearMonthDayFromDays(days, &year, &month, &day);
+  int hour = time_in_day_ms / (60 * 60 * 1000);
+  int min = (time_in_day_ms / (60 * 1000)) % 60;
+  int sec = (time_in_day_ms / 1000) % 60;
+  int ms = time_in_day_ms % 1000;
+
+  static const int kBufferSize = 32;
+  char buffer[kBufferSize];
+  Vector<char> vector(buffer, kBufferSize);
+  if (year >= 0 && year <= 9999) {
+    OS::SNPrintF(vector, "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                 year, month + 1, day, hour, min, sec, ms);
+  } else {
+    // Extended years have a sign and six digits.
+    OS::SNPrintF(vector, "%c%06d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                 year < 0 ? '-' : '+', year < 0 ? -year : year,
+                 month + 1, day, hour, min, sec, ms);
+  }
+  return isolate->heap()->AllocateStringFromAscii(CStrVector(buffer));
 }
 
 
@@ -8004,6 +9202,18 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_NewStrictArgumentsFast) {
 }
 
 
+// Allocates the arguments object of an optimized function that lets it
+// escape, from the arguments in the function's frame or in the adaptor
+// frame below it.
+RUNTIME_FUNCTION(MaybeObject*, Runtime_NewArgumentsFromOptimizedFrame) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 1);
+  CONVERT_ARG_CHECKED(JSFunction, callee, 0);
+  ASSERT(!callee->shared()->native());
+  return Accessors::FunctionGetArguments(*callee, NULL);
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_NewClosure) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 3);
@@ -8037,16 +9247,18 @@ static SmartArrayPointer<Handle<Object> > GetCallerArguments(
     int inlined_frame_index = functions.length() - 1;
     JSFunction* inlined_function = functions[inlined_frame_index];
     int args_count = inlined_function->shared()->formal_parameter_count();
-    ScopedVector<SlotRef> args_slots(args_count);
+    List<SlotRef> args_slots(args_count);
     SlotRef::ComputeSlotMappingForArguments(frame,
                                             inlined_frame_index,
+                                            args_count,
                                             &args_slots);
 
     *total_argc = prefix_argc + args_count;
     SmartArrayPointer<Handle<Object> > param_data(
         NewArray<Handle<Object> >(*total_argc));
+    int slot_index = 0;
     for (int i = 0; i < args_count; i++) {
-      Handle<Object> val = args_slots[i].GetValue();
+      Handle<Object> val = SlotRef::GetNextValue(args_slots, &slot_index);
       param_data[prefix_argc + i] = val;
     }
     return param_data;
@@ -8286,8 +9498,10 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_FinalizeInstanceSize) {
   ASSERT(args.length() == 1);
 
   CONVERT_ARG_CHECKED(JSFunction, function, 0);
-  function->shared()->CompleteInobjectSlackTracking();
-  TrySettingInlineConstructStub(isolate, function);
+  function->shared()->CompleteInobjectSlackTrackingRound();
+  if (!function->shared()->IsInobjectSlackTrackingInProgress()) {
+    TrySettingInlineConstructStub(isolate, function);
+  }
 
   return isolate->heap()->undefined_value();
 }
@@ -8334,17 +9548,20 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_LazyRecompile) {
   // If the function is not optimizable or debugger is active continue using the
   // code from the full compiler.
   if (!function->shared()->code()->optimizable() ||
-      isolate->DebuggerHasBreakPoints()) {
+      isolate->DebuggerNeedsFullCode(function->shared())) {
     if (FLAG_trace_opt) {
       PrintF("[failed to optimize ");
       function->PrintName();
       PrintF(": is code optimizable: %s, is debugger enabled: %s]\n",
           function->shared()->code()->optimizable() ? "T" : "F",
-          isolate->DebuggerHasBreakPoints() ? "T" : "F");
+          isolate->DebuggerNeedsFullCode(function->shared()) ? "T" : "F");
     }
     function->ReplaceCode(function->shared()->code());
     return function->code();
   }
+  if (Compiler::RecompileConcurrent(function)) {
+    return function->code();
+  }
   if (JSFunction::CompileOptimized(function,
                                    AstNode::kNoNumber,
                                    CLEAR_EXCEPTION)) {
@@ -8395,9 +9612,21 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_NotifyDeoptimized) {
   ASSERT(isolate->heap()->IsAllocationAllowed());
   int frames = deoptimizer->output_count();
 
-  deoptimizer->MaterializeHeapNumbers();
+  // Remember the site before materialization can move the function.
+  Handle<SharedFunctionInfo> site_shared;
+  int site_id = deoptimizer->deopt_site_id();
+  if (type == Deoptimizer::EAGER) {
+    site_shared = Handle<SharedFunctionInfo>(
+        deoptimizer->deopt_site_function()->shared(), isolate);
+  }
+
+  deoptimizer->MaterializeHeapObjects();
   delete deoptimizer;
 
+  if (!site_shared.is_null()) {
+    Deoptimizer::RecordDeoptimizationSite(site_shared, site_id);
+  }
+
   JavaScriptFrameIterator it(isolate);
   JavaScriptFrame* frame = NULL;
   for (int i = 0; i < frames - 1; i++) it.Advance();
@@ -8562,34 +9791,37 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
     ASSERT(frame->LookupCode() == *unoptimized);
     ASSERT(unoptimized->contains(frame->pc()));
 
-    // Use linear search of the unoptimized code's stack check table to find
-    // the AST id matching the PC.
-    Address start = unoptimized->instruction_start();
-    unsigned target_pc_offset = static_cast<unsigned>(frame->pc() - start);
-    Address table_cursor = start + unoptimized->stack_check_table_offset();
-    uint32_t table_length = Memory::uint32_at(table_cursor);
-    table_cursor += kIntSize;
-    for (unsigned i = 0; i < table_length; ++i) {
-      // Table entries are (AST id, pc offset) pairs.
-      uint32_t pc_offset = Memory::uint32_at(table_cursor + kIntSize);
-      if (pc_offset == target_pc_offset) {
-        ast_id = static_cast<int>(Memory::uint32_at(table_cursor));
-        break;
-      }
-      table_cursor += 2 * kIntSize;
-    }
+    // Use the unoptimized code's stack check table to find the AST id
+    // matching the PC.
+    int loop_depth = 0;
+    ast_id = unoptimized->LookupOsrEntryAt(frame->pc(), &loop_depth);
     ASSERT(ast_id != AstNode::kNoNumber);
     if (FLAG_trace_osr) {
-      PrintF("[replacing on-stack at AST id %d in ", ast_id);
+      PrintF("[replacing on-stack at AST id %d, loop depth %d in ",
+             ast_id, loop_depth);
       function->PrintName();
       PrintF("]\n");
     }
 
-    // Try to compile the optimized code.  A true return value from
+    // Optimized code is compiled for one OSR entry.  If the function's
+    // optimized code already has an entry at this loop, for instance from an
+    // earlier replacement in another activation, enter it again.  Otherwise
+    // try to compile the optimized code.  A true return value from
     // CompileOptimized means that compilation succeeded, not necessarily
     // that optimization succeeded.
-    if (JSFunction::CompileOptimized(function, ast_id, CLEAR_EXCEPTION) &&
-        function->IsOptimized()) {
+    bool cached = false;
+    if (function->IsOptimized()) {
+      DeoptimizationInputData* data = DeoptimizationInputData::cast(
+          function->code()->deoptimization_data());
+      cached = data->OsrAstId()->value() == ast_id &&
+          data->OsrPcOffset()->value() >= 0;
+      if (cached && FLAG_trace_osr) {
+        PrintF("[reusing optimized code with on-stack entry]\n");
+      }
+    }
+    if (cached ||
+        (JSFunction::CompileOptimized(function, ast_id, CLEAR_EXCEPTION) &&
+         function->IsOptimized())) {
       DeoptimizationInputData* data = DeoptimizationInputData::cast(
           function->code()->deoptimization_data());
       if (data->OsrPcOffset()->value() >= 0) {
@@ -8614,8 +9846,14 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
     function->PrintName();
     PrintF("]\n");
   }
-  StackCheckStub check_stub;
-  Handle<Code> check_code = check_stub.GetCode();
+  Handle<Code> check_code;
+  if (unoptimized->has_interrupt_budget()) {
+    InterruptStub interrupt_stub;
+    check_code = interrupt_stub.GetCode();
+  } else {
+    StackCheckStub check_stub;
+    check_code = check_stub.GetCode();
+  }
   Handle<Code> replacement_code = isolate->builtins()->OnStackReplacement();
   Deoptimizer::RevertStackCheckCode(*unoptimized,
                                     *check_code,
@@ -8629,6 +9867,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
   // frame to an optimized one.
   if (succeeded) {
     ASSERT(function->code()->kind() == Code::OPTIMIZED_FUNCTION);
+    function->shared()->set_used_on_stack_replacement(true);
     return Smi::FromInt(ast_id);
   } else {
     if (function->IsMarkedForLazyRecompilation()) {
@@ -9177,6 +10416,28 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_StackGuard) {
 }
 
 
+RUNTIME_FUNCTION(MaybeObject*, Runtime_Interrupt) {
+  ASSERT(args.length() == 1);
+  CONVERT_CHECKED(JSGlobalPropertyCell, profiling_counter, args[0]);
+
+  // The interrupt budget of the calling code has run out.  Refill it, count
+  // a profiler tick for the function on top of the stack, and handle the
+  // interrupts that were requested meanwhile, because code with an
+  // interrupt budget does not check the stack limit at back edges.
+  profiling_counter->set_value(Smi::FromInt(FLAG_interrupt_budget));
+  isolate->counters()->runtime_profiler_ticks()->Increment();
+  isolate->runtime_profiler()->OptimizeNow();
+  // The budget runs out whether or not an interrupt is pending, so only a
+  // stack pointer below the real limit is an overflow.
+  StackLimitCheck check(isolate);
+  if (check.HasOverflowed()) {
+    NoHandleAllocation na;
+    return isolate->StackOverflow();
+  }
+  return Execution::HandleStackGuardInterrupt();
+}
+
+
 static int StackSize() {
   int n = 0;
   for (JavaScriptFrameIterator it; !it.done(); it.Advance()) n++;
@@ -9296,6 +10557,25 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_DateParseString) {
   CONVERT_ARG_CHECKED(String, str, 0);
   FlattenString(str);
 
+  // Strings in the common ES5 ISO 8601 layout are converted to a time
+  // value right away, without the tokenizer and without computing the day
+  // in JavaScript.
+  double time;
+  bool is_iso_date_time;
+  {
+    AssertNoAllocation no_allocation;
+    String::FlatContent str_content = str->GetFlatContent();
+    if (str_content.IsAscii()) {
+      is_iso_date_time = DateParser::ParseISODateTime(
+          str_content.ToAsciiVector(), isolate->date_cache(), &time);
+    } else {
+      ASSERT(str_content.IsTwoByte());
+      is_iso_date_time = DateParser::ParseISODateTime(
+          str_content.ToUC16Vector(), isolate->date_cache(), &time);
+    }
+  }
+  if (is_iso_date_time) return isolate->heap()->NumberFromDouble(time);
+
   CONVERT_ARG_CHECKED(JSArray, output, 1);
 
   MaybeObject* maybe_result_array =
@@ -9333,25 +10613,19 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_DateLocalTimezone) {
   ASSERT(args.length() == 1);
 
   CONVERT_DOUBLE_ARG_CHECKED(x, 0);
-  const char* zone = OS::LocalTimezone(x);
+  const char* zone =
+      isolate->date_cache()->LocalTimezone(static_cast<int64_t>(x));
   return isolate->heap()->AllocateStringFromUtf8(CStrVector(zone));
 }
 
 
-RUNTIME_FUNCTION(MaybeObject*, Runtime_DateLocalTimeOffset) {
-  NoHandleAllocation ha;
-  ASSERT(args.length() == 0);
-
-  return isolate->heap()->NumberFromDouble(OS::LocalTimeOffset());
-}
-
-
-RUNTIME_FUNCTION(MaybeObject*, Runtime_DateDaylightSavingsOffset) {
+RUNTIME_FUNCTION(MaybeObject*, Runtime_DateToUTC) {
   NoHandleAllocation ha;
   ASSERT(args.length() == 1);
 
   CONVERT_DOUBLE_ARG_CHECKED(x, 0);
-  return isolate->heap()->NumberFromDouble(OS::DaylightSavingsOffset(x));
+  int64_t time = isolate->date_cache()->ToUTC(static_cast<int64_t>(x));
+  return isolate->heap()->NumberFromDouble(static_cast<double>(time));
 }
 
 
@@ -9369,10 +10643,13 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_ParseJson) {
   CONVERT_ARG_CHECKED(String, source, 0);
 
   source = Handle<String>(source->TryFlattenGetString());
-  // Optimized fast case where we only have ascii characters.
+  // Optimized fast case where we only have ascii characters.  External
+  // ascii strings are read in place from the embedder's buffer.
   Handle<Object> result;
   if (source->IsSeqAsciiString()) {
     result = JsonParser<true>::Parse(source);
+  } else if (source->IsExternalAsciiString()) {
+    result = JsonParser<true, true>::Parse(source);
   } else {
     result = JsonParser<false>::Parse(source);
   }
@@ -10363,7 +11640,8 @@ static MaybeObject* DebugLookupResultValue(Heap* heap,
       if (value->IsTheHole()) {
         return heap->undefined_value();
       }
-      return value;
+      return JSObject::cast(
+          result->holder())->FastPropertyValueAt(result->GetFieldIndex());
     case CONSTANT_FUNCTION:
       return result->GetConstantFunction();
     case CALLBACKS: {
@@ -13129,6 +14407,45 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_GetScript) {
 }
 
 
+// Line lookups on the compact line ends table of a script, used by the
+// Script functions in messages.js.
+// args[0]: script wrapper
+RUNTIME_FUNCTION(MaybeObject*, Runtime_ScriptLineCount) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 1);
+
+  CONVERT_CHECKED(JSValue, wrapper, args[0]);
+  Handle<Script> script(Script::cast(wrapper->value()));
+  return Smi::FromInt(GetScriptLineCount(script));
+}
+
+
+// args[0]: script wrapper
+// args[1]: source position
+RUNTIME_FUNCTION(MaybeObject*, Runtime_ScriptLineFromPosition) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 2);
+
+  CONVERT_CHECKED(JSValue, wrapper, args[0]);
+  CONVERT_NUMBER_CHECKED(int, position, Int32, args[1]);
+  Handle<Script> script(Script::cast(wrapper->value()));
+  return Smi::FromInt(GetScriptLineFromPosition(script, position));
+}
+
+
+// args[0]: script wrapper
+// args[1]: line number, ignoring the script's line offset
+RUNTIME_FUNCTION(MaybeObject*, Runtime_ScriptLineEnd) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 2);
+
+  CONVERT_CHECKED(JSValue, wrapper, args[0]);
+  CONVERT_NUMBER_CHECKED(int, line, Int32, args[1]);
+  Handle<Script> script(Script::cast(wrapper->value()));
+  return Smi::FromInt(GetScriptLineEnd(script, line));
+}
+
+
 // Determines whether the given stack frame should be displayed in
 // a stack trace.  The caller is the error constructor that asked
 // for the stack trace to be collected.  The first time a construct
@@ -13486,6 +14803,13 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_HaveSameMap) {
   return isolate->heap()->ToBoolean(obj1->map() == obj2->map());
 }
 
+
+RUNTIME_FUNCTION(MaybeObject*, Runtime_HasFastProperties) {
+  ASSERT(args.length() == 1);
+  CONVERT_CHECKED(JSObject, obj, args[0]);
+  return isolate->heap()->ToBoolean(obj->HasFastProperties());
+}
+
 // ----------------------------------------------------------------------------
 // Implementation of Runtime
 
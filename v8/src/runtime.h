@@ -85,6 +85,7 @@ namespace internal {
   F(GetConstructorDelegate, 1, 1) \
   F(NewArgumentsFast, 3, 1) \
   F(NewStrictArgumentsFast, 3, 1) \
+  F(NewArgumentsFromOptimizedFrame, 1, 1) \
   F(LazyCompile, 1, 1) \
   F(LazyRecompile, 1, 1) \
   F(NotifyDeoptimized, 1, 1) \
@@ -118,9 +119,12 @@ namespace internal {
   F(CharFromCode, 1, 1) \
   F(URIEscape, 1, 1) \
   F(URIUnescape, 1, 1) \
+  F(URIEncode, 2, 1) \
+  F(URIDecode, 2, 1) \
   F(QuoteJSONString, 1, 1) \
   F(QuoteJSONStringComma, 1, 1) \
   F(QuoteJSONStringArray, 1, 1) \
+  F(BasicJSONStringify, 1, 1) \
   \
   F(NumberToString, 1, 1) \
   F(NumberToStringSkipCache, 1, 1) \
@@ -139,10 +143,23 @@ namespace internal {
   F(NumberMod, 2, 1) \
   F(NumberUnaryMinus, 1, 1) \
   F(NumberAlloc, 0, 1) \
+  F(IntegerAdd, 2, 1) \
+  F(IntegerSub, 2, 1) \
+  F(IntegerMul, 2, 1) \
+  F(IntegerToNumber, 1, 1) \
+  F(IntegerToString, 1, 1) \
+  F(IsAtom, 1, 1) \
+  F(AtomName, 1, 1) \
   \
   F(StringAdd, 2, 1) \
   F(StringBuilderConcat, 3, 1) \
   F(StringBuilderJoin, 3, 1) \
+  F(StringBuilderNew, 1, 1) \
+  F(StringBuilderAppend, 5, 1) \
+  F(StringBuilderFinish, 2, 1) \
+  F(StringAppend, 2, 1) \
+  F(IsStringBuffer, 1, 1) \
+  F(StringBufferToString, 1, 1) \
   F(SparseJoinWithSeparator, 3, 1) \
   \
   /* Bit operations */ \
@@ -184,6 +201,7 @@ namespace internal {
   F(RegExpCompile, 3, 1) \
   F(RegExpExec, 4, 1) \
   F(RegExpExecMultiple, 4, 1) \
+  F(RegExpSplit, 4, 1) \
   F(RegExpInitializeObject, 5, 1) \
   F(RegExpConstructResult, 3, 1) \
   \
@@ -228,6 +246,9 @@ namespace internal {
   F(FunctionIsAPIFunction, 1, 1) \
   F(FunctionIsBuiltin, 1, 1) \
   F(GetScript, 1, 1) \
+  F(ScriptLineCount, 1, 1) \
+  F(ScriptLineFromPosition, 2, 1) \
+  F(ScriptLineEnd, 2, 1) \
   F(CollectStackTrace, 2, 1) \
   F(GetV8Version, 0, 1) \
   \
@@ -245,10 +266,10 @@ namespace internal {
   F(DateCurrentTime, 0, 1) \
   F(DateParseString, 2, 1) \
   F(DateLocalTimezone, 1, 1) \
-  F(DateLocalTimeOffset, 0, 1) \
-  F(DateDaylightSavingsOffset, 1, 1) \
+  F(DateToUTC, 1, 1) \
   F(DateMakeDay, 2, 1) \
-  F(DateYMDFromTime, 2, 1) \
+  F(DateSetValue, 3, 1) \
+  F(DateToISOString, 1, 1) \
   \
   /* Numbers */ \
   \
@@ -298,17 +319,26 @@ namespace internal {
   F(SetAdd, 2, 1) \
   F(SetHas, 2, 1) \
   F(SetDelete, 2, 1) \
+  F(SetGetSize, 1, 1) \
+  F(SetGetKeys, 1, 1) \
   \
   /* Harmony maps */ \
   F(MapInitialize, 1, 1) \
   F(MapGet, 2, 1) \
   F(MapSet, 3, 1) \
+  F(MapGetSize, 1, 1) \
+  F(MapGetEntries, 1, 1) \
   \
   /* Harmony weakmaps */ \
   F(WeakMapInitialize, 1, 1) \
   F(WeakMapGet, 2, 1) \
   F(WeakMapSet, 3, 1) \
   \
+  /* Harmony typed arrays */ \
+  F(ArrayBufferInitialize, 2, 1) \
+  F(ArrayBufferSliceImpl, 3, 1) \
+  F(TypedArrayInitialize, 5, 1) \
+  \
   /* Statements */ \
   F(NewClosure, 3, 1) \
   F(NewObject, 1, 1) \
@@ -318,6 +348,7 @@ namespace internal {
   F(ReThrow, 1, 1) \
   F(ThrowReferenceError, 1, 1) \
   F(StackGuard, 0, 1) \
+  F(Interrupt, 1, 1) \
   F(PromoteScheduledException, 0, 1) \
   \
   /* Contexts */ \
@@ -337,6 +368,7 @@ namespace internal {
   F(InitializeConstGlobal, 2, 1) \
   F(InitializeConstContextSlot, 3, 1) \
   F(OptimizeObjectForAddingMultipleProperties, 2, 1) \
+  F(DefineMethod, 3, 1) \
   \
   /* Debugging */ \
   F(DebugPrint, 1, 1) \
@@ -380,6 +412,7 @@ namespace internal {
   F(TransitionElementsSmiToDouble, 1, 1) \
   F(TransitionElementsDoubleToObject, 1, 1) \
   F(HaveSameMap, 2, 1) \
+  F(HasFastProperties, 1, 1) \
   /* profiler */ \
   F(ProfilerResume, 0, 1) \
   F(ProfilerPause, 0, 1)
@@ -511,7 +544,8 @@ namespace internal {
   F(IsRegExpEquivalent, 2, 1)                                                \
   F(HasCachedArrayIndex, 1, 1)                                               \
   F(GetCachedArrayIndex, 1, 1)                                               \
-  F(FastAsciiArrayJoin, 2, 1)
+  F(FastAsciiArrayJoin, 2, 1)                                                \
+  F(DateField, 2 /* date object, field index */, 1)
 
 
 // ----------------------------------------------------------------------------
@@ -531,7 +565,10 @@ namespace internal {
   F(RegExpConstructResult, 3, 1)                                             \
   F(GetFromCache, 2, 1)                                                      \
   F(NumberToString, 1, 1)                                                    \
-  F(SwapElements, 3, 1)
+  F(SwapElements, 3, 1)                                                      \
+  F(IntegerAdd, 2, 1)                                                        \
+  F(IntegerSub, 2, 1)                                                        \
+  F(IntegerMul, 2, 1)
 
 
 //---------------------------------------------------------------------------
@@ -561,8 +598,24 @@ class RuntimeState {
     return &string_locale_compare_buf2_;
   }
 
+  // Marks the characters in the Latin-1 case tables whose case is not a
+  // single character.
+  static const uc16 kNoLatin1CaseMapping = 0xFFFF;
+  static const int kLatin1TableSize = 256;
+
+  // Upper and lower case of the Latin-1 characters, built on first use.
+  const uc16* latin1_to_upper() {
+    if (!latin1_tables_initialized_) InitializeLatin1Tables();
+    return latin1_to_upper_;
+  }
+  const uc16* latin1_to_lower() {
+    if (!latin1_tables_initialized_) InitializeLatin1Tables();
+    return latin1_to_lower_;
+  }
+
  private:
-  RuntimeState() {}
+  RuntimeState() : latin1_tables_initialized_(false) {}
+  void InitializeLatin1Tables();
   // Non-reentrant string buffer for efficient general use in the runtime.
   StaticResource<StringInputBuffer> string_input_buffer_;
   unibrow::Mapping<unibrow::ToUppercase, 128> to_upper_mapping_;
@@ -571,6 +624,9 @@ class RuntimeState {
   StringInputBuffer string_input_buffer_compare_bufy_;
   StringInputBuffer string_locale_compare_buf1_;
   StringInputBuffer string_locale_compare_buf2_;
+  bool latin1_tables_initialized_;
+  uc16 latin1_to_upper_[kLatin1TableSize];
+  uc16 latin1_to_lower_[kLatin1TableSize];
 
   friend class Isolate;
   friend class Runtime;
@@ -72,6 +72,13 @@ function EQUALS(y) {
         if (IS_NUMBER(y)) return %NumberEquals(%ToNumber(x), y);
         if (IS_BOOLEAN(y)) return %NumberEquals(%ToNumber(x), %ToNumber(y));
         if (IS_NULL_OR_UNDEFINED(y)) return 1;  // not equal
+        if (!IS_SPEC_OBJECT(y)) {
+          // Big integer, atom or string buffer.
+          if (%IsStringBuffer(y)) {
+            return %StringEquals(x, %StringBufferToString(y));
+          }
+          return %NumberEquals(%ToNumber(x), %ToNumber(y));
+        }
         y = %ToPrimitive(y, NO_HINT);
       }
     } else if (IS_BOOLEAN(x)) {
@@ -84,6 +91,12 @@ function EQUALS(y) {
       y = %ToPrimitive(y, NO_HINT);
     } else if (IS_NULL_OR_UNDEFINED(x)) {
       return IS_NULL_OR_UNDEFINED(y) ? 0 : 1;
+    } else if (!IS_SPEC_OBJECT(x)) {
+      // x is a big integer, an atom or a string buffer.  Atoms are only
+      // equal to themselves.
+      if (%_ObjectEquals(x, y)) return 0;
+      if (IS_NULL_OR_UNDEFINED(y) || %IsAtom(x)) return 1;
+      x = %IsStringBuffer(x) ? %StringBufferToString(x) : %ToNumber(x);
     } else {
       // x is an object.
       if (IS_SPEC_OBJECT(y)) {
@@ -420,6 +433,46 @@ function CALL_NON_FUNCTION_AS_CONSTRUCTOR() {
 }
 
 
+// Returns a function that calls the method_missing method of its receiver
+// with the atom followed by its own arguments.  Call ICs call it in place of
+// the method named by the atom when the receiver does not have that method.
+function MethodMissingTrampoline(atom) {
+  var trampoline = function() {
+    var method_missing = this.method_missing;
+    if (!IS_SPEC_FUNCTION(method_missing)) {
+      throw %MakeTypeError('undefined_method', [%AtomName(atom), this]);
+    }
+    var length = %_ArgumentsLength();
+    var args = new InternalArray(length + 1);
+    args[0] = atom;
+    for (var i = 0; i < length; i++) {
+      args[i + 1] = %_Arguments(i);
+    }
+    return %Apply(method_missing, this, args, 0, length + 1);
+  };
+  %FunctionSetName(trampoline, %AtomName(atom));
+  return trampoline;
+}
+
+
+// Runs a Ruby begin statement whose body, rescue clauses and ensure clause
+// the Ruby front end has turned into closures.  The try statement is here
+// instead of in the Ruby method, so the method can still be optimized.
+// rescue and ensure are undefined if the statement does not have them.
+function RubyBegin(receiver, body, rescue, ensure) {
+  try {
+    if (IS_UNDEFINED(rescue)) return %_CallFunction(receiver, body);
+    try {
+      return %_CallFunction(receiver, body);
+    } catch (e) {
+      return %_CallFunction(receiver, e, rescue);
+    }
+  } finally {
+    if (!IS_UNDEFINED(ensure)) %_CallFunction(receiver, ensure);
+  }
+}
+
+
 function CALL_FUNCTION_PROXY() {
   var arity = %_ArgumentsLength() - 1;
   var proxy = %_Arguments(arity);  // The proxy comes in as an additional arg.
@@ -507,7 +560,10 @@ function ToPrimitive(x, hint) {
   // Fast case check.
   if (IS_STRING(x)) return x;
   // Normal behavior.
-  if (!IS_SPEC_OBJECT(x)) return x;
+  if (!IS_SPEC_OBJECT(x)) {
+    // String buffers are the only primitives that convert.
+    return IS_NUMBER(x) || !%IsStringBuffer(x) ? x : %StringBufferToString(x);
+  }
   if (hint == NO_HINT) hint = (IS_DATE(x)) ? STRING_HINT : NUMBER_HINT;
   return (hint == NUMBER_HINT) ? %DefaultNumber(x) : %DefaultString(x);
 }
@@ -532,7 +588,11 @@ function ToNumber(x) {
   }
   if (IS_BOOLEAN(x)) return x ? 1 : 0;
   if (IS_UNDEFINED(x)) return $NaN;
-  return (IS_NULL(x)) ? 0 : ToNumber(%DefaultNumber(x));
+  if (IS_NULL(x)) return 0;
+  if (IS_SPEC_OBJECT(x)) return ToNumber(%DefaultNumber(x));
+  // The only other primitives are big integers, atoms and string buffers.
+  if (%IsStringBuffer(x)) return %StringToNumber(%StringBufferToString(x));
+  return %IsAtom(x) ? $NaN : %IntegerToNumber(x);
 }
 
 function NonNumberToNumber(x) {
@@ -542,7 +602,11 @@ function NonNumberToNumber(x) {
   }
   if (IS_BOOLEAN(x)) return x ? 1 : 0;
   if (IS_UNDEFINED(x)) return $NaN;
-  return (IS_NULL(x)) ? 0 : ToNumber(%DefaultNumber(x));
+  if (IS_NULL(x)) return 0;
+  if (IS_SPEC_OBJECT(x)) return ToNumber(%DefaultNumber(x));
+  // The only other primitives are big integers, atoms and string buffers.
+  if (%IsStringBuffer(x)) return %StringToNumber(%StringBufferToString(x));
+  return %IsAtom(x) ? $NaN : %IntegerToNumber(x);
 }
 
 
@@ -552,14 +616,22 @@ function ToString(x) {
   if (IS_NUMBER(x)) return %_NumberToString(x);
   if (IS_BOOLEAN(x)) return x ? 'true' : 'false';
   if (IS_UNDEFINED(x)) return 'undefined';
-  return (IS_NULL(x)) ? 'null' : %ToString(%DefaultString(x));
+  if (IS_NULL(x)) return 'null';
+  if (IS_SPEC_OBJECT(x)) return %ToString(%DefaultString(x));
+  // The only other primitives are big integers, atoms and string buffers.
+  if (%IsStringBuffer(x)) return %StringBufferToString(x);
+  return %IsAtom(x) ? %AtomName(x) : %IntegerToString(x);
 }
 
 function NonStringToString(x) {
   if (IS_NUMBER(x)) return %_NumberToString(x);
   if (IS_BOOLEAN(x)) return x ? 'true' : 'false';
   if (IS_UNDEFINED(x)) return 'undefined';
-  return (IS_NULL(x)) ? 'null' : %ToString(%DefaultString(x));
+  if (IS_NULL(x)) return 'null';
+  if (IS_SPEC_OBJECT(x)) return %ToString(%DefaultString(x));
+  // The only other primitives are big integers, atoms and string buffers.
+  if (%IsStringBuffer(x)) return %StringBufferToString(x);
+  return %IsAtom(x) ? %AtomName(x) : %IntegerToString(x);
 }
 
 
@@ -152,6 +152,48 @@ unsigned GenericStringUC16CharacterStream::FillBuffer(unsigned from_pos,
 }
 
 
+// ----------------------------------------------------------------------------
+// ExternalAsciiStringUC16CharacterStream
+
+
+ExternalAsciiStringUC16CharacterStream::ExternalAsciiStringUC16CharacterStream(
+    Handle<ExternalAsciiString> data,
+    unsigned start_position,
+    unsigned end_position)
+    : source_(data),
+      raw_data_(reinterpret_cast<const byte*>(data->GetChars())),
+      length_(end_position) {
+  ASSERT(end_position >= start_position);
+  buffer_cursor_ = buffer_;
+  buffer_end_ = buffer_;
+  pos_ = start_position;
+}
+
+
+ExternalAsciiStringUC16CharacterStream::
+    ~ExternalAsciiStringUC16CharacterStream() { }
+
+
+unsigned ExternalAsciiStringUC16CharacterStream::BufferSeekForward(
+    unsigned delta) {
+  unsigned old_pos = pos_;
+  pos_ = Min(pos_ + delta, length_);
+  ReadBlock();
+  return pos_ - old_pos;
+}
+
+
+unsigned ExternalAsciiStringUC16CharacterStream::FillBuffer(unsigned from_pos,
+                                                            unsigned length) {
+  if (from_pos >= length_) return 0;
+  if (from_pos + length > length_) {
+    length = length_ - from_pos;
+  }
+  CopyChars(buffer_, raw_data_ + from_pos, static_cast<int>(length));
+  return length;
+}
+
+
 // ----------------------------------------------------------------------------
 // Utf8ToUC16CharacterStream
 Utf8ToUC16CharacterStream::Utf8ToUC16CharacterStream(const byte* data,
@@ -192,15 +234,24 @@ unsigned Utf8ToUC16CharacterStream::FillBuffer(unsigned char_position,
     if (raw_data_pos_ == raw_data_length_) break;
     unibrow::uchar c = raw_data_[raw_data_pos_];
     if (c <= unibrow::Utf8::kMaxOneByteChar) {
-      raw_data_pos_++;
-    } else {
-      c =  unibrow::Utf8::CalculateValue(raw_data_ + raw_data_pos_,
-                                         raw_data_length_ - raw_data_pos_,
-                                         &raw_data_pos_);
-      // Don't allow characters outside of the BMP.
-      if (c > kMaxUC16Character) {
-        c = unibrow::Utf8::kBadChar;
-      }
+      // Most sources are plain ASCII; widen a whole run of single-byte
+      // characters without going through the decoder.
+      unsigned run_limit = Min(raw_data_length_, raw_data_pos_ + (length - i));
+      int run_length = String::NonAsciiStart(
+          reinterpret_cast<const char*>(raw_data_ + raw_data_pos_),
+          static_cast<int>(run_limit - raw_data_pos_));
+      ASSERT(run_length > 0);
+      CopyChars(buffer_ + i, raw_data_ + raw_data_pos_, run_length);
+      raw_data_pos_ += run_length;
+      i += run_length;
+      continue;
+    }
+    c =  unibrow::Utf8::CalculateValue(raw_data_ + raw_data_pos_,
+                                       raw_data_length_ - raw_data_pos_,
+                                       &raw_data_pos_);
+    // Don't allow characters outside of the BMP.
+    if (c > kMaxUC16Character) {
+      c = unibrow::Utf8::kBadChar;
     }
     buffer_[i++] = static_cast<uc16>(c);
   }
@@ -77,6 +77,27 @@ class GenericStringUC16CharacterStream: public BufferedUC16CharacterStream {
 };
 
 
+// One-byte buffer to read characters from an external ASCII string.  The
+// source characters are widened straight into the buffer, avoiding the
+// generic String::WriteToFlat dispatch.
+class ExternalAsciiStringUC16CharacterStream
+    : public BufferedUC16CharacterStream {
+ public:
+  ExternalAsciiStringUC16CharacterStream(Handle<ExternalAsciiString> data,
+                                         unsigned start_position,
+                                         unsigned end_position);
+  virtual ~ExternalAsciiStringUC16CharacterStream();
+
+ protected:
+  virtual unsigned BufferSeekForward(unsigned delta);
+  virtual unsigned FillBuffer(unsigned position, unsigned length);
+
+  Handle<ExternalAsciiString> source_;
+  const byte* raw_data_;  // Pointer to the actual array of characters.
+  unsigned length_;
+};
+
+
 // UC16 stream based on a literal UTF-8 string.
 class Utf8ToUC16CharacterStream: public BufferedUC16CharacterStream {
  public:
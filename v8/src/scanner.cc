@@ -258,7 +258,13 @@ bool Scanner::SkipWhiteSpace() {
   while (true) {
     // We treat byte-order marks (BOMs) as whitespace for better
     // compatibility with Spidermonkey and other JavaScript engines.
-    while (unicode_cache_->IsWhiteSpace(c0_) || IsByteOrderMark(c0_)) {
+    while (true) {
+      if (c0_ == ' ' || c0_ == '\t') {
+        // Fast case for the most common whitespace characters.
+        Advance();
+        continue;
+      }
+      if (!unicode_cache_->IsWhiteSpace(c0_) && !IsByteOrderMark(c0_)) break;
       // IsWhiteSpace() includes line terminators!
       if (unicode_cache_->IsLineTerminator(c0_)) {
         // Ignore line terminators, but remember them. This is necessary
@@ -300,8 +306,8 @@ Token::Value Scanner::SkipSingleLineComment() {
   // separately by the lexical grammar and becomes part of the
   // stream of input elements for the syntactic grammar (see
   // ECMA-262, section 7.4).
-  while (c0_ >= 0 && !unicode_cache_->IsLineTerminator(c0_)) {
-    Advance();
+  if (c0_ >= 0 && !unicode_cache_->IsLineTerminator(c0_)) {
+    c0_ = source_->AdvanceToLineTerminator();
   }
 
   return Token::WHITESPACE;
@@ -917,6 +923,15 @@ static Token::Value KeywordOrIdentifierToken(const char* input,
 }
 
 
+// Quick check for the ASCII identifier characters, which make up almost
+// all identifiers in practice, before consulting the Unicode tables.
+static inline bool IsAsciiIdentifierPart(uc32 c) {
+  return static_cast<unsigned>((c | 0x20) - 'a') <= 'z' - 'a' ||
+         static_cast<unsigned>(c - '0') <= 9 ||
+         c == '_' || c == '$';
+}
+
+
 Token::Value Scanner::ScanIdentifierOrKeyword() {
   ASSERT(unicode_cache_->IsIdentifierStart(c0_));
   LiteralScope literal(this);
@@ -938,7 +953,8 @@ Token::Value Scanner::ScanIdentifierOrKeyword() {
   AddLiteralChar(first_char);
 
   // Scan the rest of the identifier characters.
-  while (unicode_cache_->IsIdentifierPart(c0_)) {
+  while (IsAsciiIdentifierPart(c0_) ||
+         unicode_cache_->IsIdentifierPart(c0_)) {
     if (c0_ != '\\') {
       uc32 next_char = c0_;
       Advance();
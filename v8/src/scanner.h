@@ -96,6 +96,32 @@ class UC16CharacterStream {
     return kEndOfInput;
   }
 
+  // Advances past characters up to and including the next line terminator
+  // and returns that terminator, or kEndOfInput if there is none.  The
+  // result is the same as calling Advance() until it returns a line
+  // terminator, but the search runs over the buffer a block at a time.
+  inline uc32 AdvanceToLineTerminator() {
+    while (true) {
+      const uc16* cursor = buffer_cursor_;
+      while (cursor < buffer_end_) {
+        uc16 c = *cursor++;
+        // Line terminators are '\n', '\r', U+2028 and U+2029.
+        if (c == '\n' || c == '\r' || (c | 1) == 0x2029) {
+          pos_ += static_cast<unsigned>(cursor - buffer_cursor_);
+          buffer_cursor_ = cursor;
+          return static_cast<uc32>(c);
+        }
+      }
+      pos_ += static_cast<unsigned>(cursor - buffer_cursor_);
+      buffer_cursor_ = cursor;
+      if (!ReadBlock()) {
+        // See Advance() for why the position moves past the end.
+        pos_++;
+        return kEndOfInput;
+      }
+    }
+  }
+
   // Return the current position in the character stream.
   // Starts at zero.
   inline unsigned pos() const { return pos_; }
@@ -38,26 +38,6 @@
 namespace v8 {
 namespace internal {
 
-// ----------------------------------------------------------------------------
-// A Zone allocator for use with LocalsMap.
-
-// TODO(isolates): It is probably worth it to change the Allocator class to
-//                 take a pointer to an isolate.
-class ZoneAllocator: public Allocator {
- public:
-  /* nothing to do */
-  virtual ~ZoneAllocator()  {}
-
-  virtual void* New(size_t size)  { return ZONE->New(static_cast<int>(size)); }
-
-  /* ignored - Zone is freed in one fell swoop */
-  virtual void Delete(void* p)  {}
-};
-
-
-static ZoneAllocator* LocalsMapAllocator = ::new ZoneAllocator();
-
-
 // ----------------------------------------------------------------------------
 // Implementation of LocalsMap
 //
@@ -76,7 +56,7 @@ static bool Match(void* key1, void* key2) {
 }
 
 
-VariableMap::VariableMap() : HashMap(Match, LocalsMapAllocator, 8) {}
+VariableMap::VariableMap() : ZoneHashMap(Match, 8) {}
 VariableMap::~VariableMap() {}
 
 
@@ -87,7 +67,7 @@ Variable* VariableMap::Declare(
     bool is_valid_lhs,
     Variable::Kind kind,
     InitializationFlag initialization_flag) {
-  HashMap::Entry* p = HashMap::Lookup(name.location(), name->Hash(), true);
+  Entry* p = ZoneHashMap::Lookup(name.location(), name->Hash(), true);
   if (p->value == NULL) {
     // The variable has not been declared yet -> insert it.
     ASSERT(p->key == name.location());
@@ -103,7 +83,7 @@ Variable* VariableMap::Declare(
 
 
 Variable* VariableMap::Lookup(Handle<String> name) {
-  HashMap::Entry* p = HashMap::Lookup(name.location(), name->Hash(), false);
+  Entry* p = ZoneHashMap::Lookup(name.location(), name->Hash(), false);
   if (p != NULL) {
     ASSERT(*reinterpret_cast<String**>(p->key) == *name);
     ASSERT(p->value != NULL);
@@ -1148,6 +1128,32 @@ void Scope::AllocateNonParameterLocals() {
 }
 
 
+void Scope::AllocateReusedContextLocals() {
+  // Variables used only by inner functions that were not parsed again are
+  // not marked as used, so mark the ones that were context allocated.
+  VariableMode mode;
+  InitializationFlag init_flag;
+  for (VariableMap::Entry* p = variables_.Start();
+       p != NULL;
+       p = variables_.Next(p)) {
+    Variable* var = reinterpret_cast<Variable*>(p->value);
+    if (reused_scope_info_->ContextSlotIndex(
+            *var->name(), &mode, &init_flag) >= 0) {
+      var->set_is_used(true);
+      var->ForceContextAllocation();
+    }
+  }
+  if (function_ != NULL) {
+    Variable* var = function_->var();
+    if (reused_scope_info_->FunctionContextSlotIndex(*var->name(),
+                                                     &mode) >= 0) {
+      var->set_is_used(true);
+      var->ForceContextAllocation();
+    }
+  }
+}
+
+
 void Scope::AllocateVariablesRecursively() {
   // Allocate variables for inner scopes.
   for (int i = 0; i < inner_scopes_.length(); i++) {
@@ -1163,6 +1169,7 @@ void Scope::AllocateVariablesRecursively() {
 
   // Allocate variables for this scope.
   // Parameters must be allocated first, if any.
+  if (!reused_scope_info_.is_null()) AllocateReusedContextLocals();
   if (is_function_scope()) AllocateParameterLocals();
   AllocateNonParameterLocals();
 
@@ -1180,6 +1187,8 @@ void Scope::AllocateVariablesRecursively() {
 
   // Allocation done.
   ASSERT(num_heap_slots_ == 0 || num_heap_slots_ >= Context::MIN_CONTEXT_SLOTS);
+  ASSERT(reused_scope_info_.is_null() ||
+         num_heap_slots_ == reused_scope_info_->ContextLength());
 }
 
 
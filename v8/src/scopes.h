@@ -38,7 +38,7 @@ class CompilationInfo;
 
 
 // A hash map to support fast variable declaration and lookup.
-class VariableMap: public HashMap {
+class VariableMap: public ZoneHashMap {
  public:
   VariableMap();
 
@@ -201,6 +201,14 @@ class Scope: public ZoneObject {
     language_mode_ = language_mode;
   }
 
+  // Inform the scope that its inner functions were not parsed and that its
+  // variables have to be allocated to the context slots recorded in the
+  // scope info of its previous compilation.
+  void ReuseScopeInfo(Handle<ScopeInfo> scope_info) {
+    ASSERT(is_function_scope());
+    reused_scope_info_ = scope_info;
+  }
+
   // Position in the source where this scope begins and ends.
   //
   // * For the scope of a with statement
@@ -458,6 +466,7 @@ class Scope: public ZoneObject {
 
   // Serialized scope info support.
   Handle<ScopeInfo> scope_info_;
+  Handle<ScopeInfo> reused_scope_info_;
   bool already_resolved() { return already_resolved_; }
 
   // Create a non-local variable with a given name.
@@ -534,6 +543,7 @@ class Scope: public ZoneObject {
   void AllocateParameterLocals();
   void AllocateNonParameterLocal(Variable* var);
   void AllocateNonParameterLocals();
+  void AllocateReusedContextLocals();
   void AllocateVariablesRecursively();
 
  private:
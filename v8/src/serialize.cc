@@ -34,11 +34,13 @@
 #include "global-handles.h"
 #include "ic-inl.h"
 #include "natives.h"
+#include "parser.h"
 #include "platform.h"
 #include "runtime.h"
 #include "serialize.h"
 #include "stub-cache.h"
 #include "v8threads.h"
+#include "version.h"
 
 namespace v8 {
 namespace internal {
@@ -281,6 +283,14 @@ void ExternalReferenceTable::PopulateTable(Isolate* isolate) {
       STUB_CACHE_TABLE,
       4,
       "StubCache::secondary_->value");
+  Add(stub_cache->mask_reference(StubCache::kPrimary).address(),
+      STUB_CACHE_TABLE,
+      5,
+      "StubCache::primary_mask_");
+  Add(stub_cache->mask_reference(StubCache::kSecondary).address(),
+      STUB_CACHE_TABLE,
+      6,
+      "StubCache::secondary_mask_");
 
   // Runtime entries
   Add(ExternalReference::perform_gc_function(isolate).address(),
@@ -494,6 +504,40 @@ void ExternalReferenceTable::PopulateTable(Isolate* isolate) {
       UNCLASSIFIED,
       45,
       "the_hole_nan");
+  Add(ExternalReference::get_date_field_function(isolate).address(),
+      UNCLASSIFIED,
+      46,
+      "JSDate::GetField");
+  Add(ExternalReference::date_cache_stamp(isolate).address(),
+      UNCLASSIFIED,
+      47,
+      "date_cache_stamp");
+  Add(ExternalReference::address_of_uint32_bias().address(),
+      UNCLASSIFIED,
+      48,
+      "LDoubleConstant::uint32_bias");
+  Add(ExternalReference::keyed_lookup_cache_mask(isolate).address(),
+      UNCLASSIFIED,
+      49,
+      "KeyedLookupCache::mask()");
+  Add(ExternalReference::instanceof_cache_functions(isolate).address(),
+      UNCLASSIFIED,
+      50,
+      "InstanceofCache::functions()");
+  Add(ExternalReference::instanceof_cache_maps(isolate).address(),
+      UNCLASSIFIED,
+      51,
+      "InstanceofCache::maps()");
+  Add(ExternalReference::instanceof_cache_answers(isolate).address(),
+      UNCLASSIFIED,
+      52,
+      "InstanceofCache::answers()");
+#ifndef V8_INTERPRETED_REGEXP
+  Add(ExternalReference::address_of_regexp_backtracks_left(isolate).address(),
+      UNCLASSIFIED,
+      53,
+      "RegExpStack::backtracks_left()");
+#endif  // V8_INTERPRETED_REGEXP
 }
 
 
@@ -811,6 +855,15 @@ void Deserializer::ReadChunk(Object** current,
             Address address = external_reference_decoder_->                    \
                 Decode(reference_id);                                          \
             new_object = reinterpret_cast<Object*>(address);                   \
+          } else if (where == kAttachedReference) {                            \
+            int index = source_->GetInt();                                     \
+            new_object = *attached_objects_[index];                            \
+            emit_write_barrier = isolate->heap()->InNewSpace(new_object);      \
+          } else if (where == kBuiltin) {                                      \
+            int builtin_id = source_->GetInt();                                \
+            ASSERT(builtin_id < Builtins::builtin_count);                      \
+            Builtins::Name name = static_cast<Builtins::Name>(builtin_id);     \
+            new_object = isolate->builtins()->builtin(name);                   \
           } else if (where == kBackref) {                                      \
             emit_write_barrier = (space_number == NEW_SPACE);                  \
             new_object = GetAddressFromEnd(data & kSpaceMask);                 \
@@ -1025,6 +1078,35 @@ void Deserializer::ReadChunk(Object** current,
                 kStartOfObject,
                 0,
                 kUnknownOffsetFromStart)
+      // Find an object in the attached objects and write a pointer to it to
+      // the current object or the current code object.
+      CASE_STATEMENT(kAttachedReference, kPlain, kStartOfObject, 0)
+      CASE_BODY(kAttachedReference,
+                kPlain,
+                kStartOfObject,
+                0,
+                kUnknownOffsetFromStart)
+      CASE_STATEMENT(kAttachedReference, kFromCode, kStartOfObject, 0)
+      CASE_BODY(kAttachedReference,
+                kFromCode,
+                kStartOfObject,
+                0,
+                kUnknownOffsetFromStart)
+      // Find a builtin and write a pointer to it to the current object.
+      CASE_STATEMENT(kBuiltin, kPlain, kStartOfObject, 0)
+      CASE_BODY(kBuiltin,
+                kPlain,
+                kStartOfObject,
+                0,
+                kUnknownOffsetFromStart)
+      // Find a builtin and write a pointer to its first instruction to the
+      // current code object.
+      CASE_STATEMENT(kBuiltin, kFromCode, kFirstInstruction, 0)
+      CASE_BODY(kBuiltin,
+                kFromCode,
+                kFirstInstruction,
+                0,
+                kUnknownOffsetFromStart)
 
 #undef CASE_STATEMENT
 #undef CASE_BODY
@@ -1677,4 +1759,332 @@ int Serializer::Allocate(int space, int size, bool* new_page) {
 }
 
 
+// A sink that collects the serialized data in a growable list.
+class ListSnapshotSink : public SnapshotByteSink {
+ public:
+  explicit ListSnapshotSink(List<byte>* data) : data_(data) { }
+  virtual void Put(int byte, const char* description) { data_->Add(byte); }
+  virtual int Position() { return data_->length(); }
+
+ private:
+  List<byte>* data_;
+};
+
+
+static bool SymbolMatchFun(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
+// Returns the index of the given code object in the builtins table, or -1 if
+// it is not a builtin.
+static int BuiltinIndex(Code* code) {
+  Builtins* builtins = Isolate::Current()->builtins();
+  for (int i = 0; i < Builtins::builtin_count; i++) {
+    if (builtins->builtin(static_cast<Builtins::Name>(i)) == code) return i;
+  }
+  return -1;
+}
+
+
+// The number of unsigned units needed to store the characters of a symbol.
+static int SymbolDataSize(int length, bool is_ascii) {
+  int bytes = is_ascii ? length : length * kUC16Size;
+  return (bytes + sizeof(unsigned) - 1) / sizeof(unsigned);
+}
+
+
+static uint32_t AddToHash(uint32_t hash, uint32_t value) {
+  hash += value;
+  hash += hash << 10;
+  hash ^= hash >> 6;
+  return hash;
+}
+
+
+CodeSerializer::CodeSerializer(SnapshotByteSink* sink, Script* script)
+    : Serializer(sink),
+      script_(script),
+      symbol_map_(new HashMap(&SymbolMatchFun)),
+      unsupported_(false) {
+  set_root_index_wave_front(Heap::kStrongRootListLength);
+}
+
+
+CodeSerializer::~CodeSerializer() {
+  delete symbol_map_;
+}
+
+
+void CodeSerializer::SerializeObject(
+    Object* o,
+    HowToCode how_to_code,
+    WhereToPoint where_to_point) {
+  CHECK(o->IsHeapObject());
+  HeapObject* heap_object = HeapObject::cast(o);
+
+  int root_index;
+  if ((root_index = RootIndex(heap_object)) != kInvalidRootIndex) {
+    PutRoot(root_index, heap_object, how_to_code, where_to_point);
+    return;
+  }
+
+  if (address_mapper_.IsMapped(heap_object)) {
+    int space = SpaceOfAlreadySerializedObject(heap_object);
+    int address = address_mapper_.MappedTo(heap_object);
+    SerializeReferenceToPreviousObject(space,
+                                       address,
+                                       how_to_code,
+                                       where_to_point);
+    return;
+  }
+
+  if (heap_object == script_ && where_to_point == kStartOfObject) {
+    sink_->Put(kAttachedReference + how_to_code + where_to_point, "Script");
+    sink_->PutInt(kScriptIndex, "attached_index");
+    return;
+  }
+
+  if (heap_object->IsSymbol() && where_to_point == kStartOfObject) {
+    SerializeSymbol(String::cast(heap_object), how_to_code, where_to_point);
+    return;
+  }
+
+  if (heap_object->IsCode()) {
+    int builtin_index = BuiltinIndex(Code::cast(heap_object));
+    if (builtin_index >= 0) {
+      SerializeBuiltin(builtin_index, how_to_code, where_to_point);
+      return;
+    }
+  }
+
+  if (!IsSerializable(heap_object)) {
+    // Emit something harmless to keep the output well formed.  The output is
+    // discarded at the end of the serialization.
+    unsupported_ = true;
+    sink_->Put(kSkip, "Unsupported");
+    return;
+  }
+
+  // Object has not yet been serialized.  Serialize it here.
+  ObjectSerializer serializer(this,
+                              heap_object,
+                              sink_,
+                              how_to_code,
+                              where_to_point);
+  serializer.Serialize();
+}
+
+
+void CodeSerializer::SerializeSymbol(String* symbol,
+                                     HowToCode how_to_code,
+                                     WhereToPoint where_to_point) {
+  HashMap::Entry* entry = symbol_map_->Lookup(symbol, symbol->Hash(), true);
+  if (entry->value == NULL) {
+    int index = kFirstSymbolIndex + symbols_.length();
+    entry->value = reinterpret_cast<void*>(static_cast<intptr_t>(index));
+    symbols_.Add(symbol);
+  }
+  int index = static_cast<int>(reinterpret_cast<intptr_t>(entry->value));
+  sink_->Put(kAttachedReference + how_to_code + where_to_point, "Symbol");
+  sink_->PutInt(index, "attached_index");
+}
+
+
+void CodeSerializer::SerializeBuiltin(int builtin_index,
+                                      HowToCode how_to_code,
+                                      WhereToPoint where_to_point) {
+  // The deserializer only knows how to write builtins into plain slots and
+  // as call targets.
+  if ((how_to_code == kPlain && where_to_point == kStartOfObject) ||
+      (how_to_code == kFromCode && where_to_point == kFirstInstruction)) {
+    sink_->Put(kBuiltin + how_to_code + where_to_point, "Builtin");
+    sink_->PutInt(builtin_index, "builtin_index");
+  } else {
+    unsupported_ = true;
+    sink_->Put(kSkip, "Unsupported");
+  }
+}
+
+
+bool CodeSerializer::IsSerializable(HeapObject* object) {
+  // Objects that belong to a context or point outside of the heap cannot be
+  // shared with another context, let alone another process.
+  if (object->IsJSReceiver() ||
+      object->IsContext() ||
+      object->IsMap() ||
+      object->IsScript() ||
+      object->IsForeign() ||
+      object->IsExternalString() ||
+      object->IsDebugInfo()) {
+    return false;
+  }
+  if (object->IsCode()) {
+    Code* code = Code::cast(object);
+    if (code->kind() == Code::OPTIMIZED_FUNCTION) return false;
+    // Monomorphic stubs for global loads and stores refer to the property
+    // cells of a global object.
+    int mask = RelocInfo::ModeMask(RelocInfo::GLOBAL_PROPERTY_CELL);
+    if (!RelocIterator(code, mask).done()) return false;
+  }
+  return true;
+}
+
+
+uint32_t CodeSerializer::SourceHash(Handle<String> source) {
+  // The hash of the string itself only covers a prefix of long strings.
+  FlattenString(source);
+  int length = source->length();
+  uint32_t hash = static_cast<uint32_t>(length);
+  for (int i = 0; i < length; i++) {
+    hash = AddToHash(hash, source->Get(i));
+  }
+  return ComputeIntegerHash(hash);
+}
+
+
+uint32_t CodeSerializer::VersionHash() {
+  uint32_t hash = 0;
+  hash = AddToHash(hash, Version::GetMajor());
+  hash = AddToHash(hash, Version::GetMinor());
+  hash = AddToHash(hash, Version::GetBuild());
+  hash = AddToHash(hash, Version::GetPatch());
+  return ComputeIntegerHash(hash);
+}
+
+
+ScriptDataImpl* CodeSerializer::Serialize(Handle<SharedFunctionInfo> info) {
+  Isolate* isolate = info->GetIsolate();
+  // Code generated without serialization enabled addresses external
+  // references relative to the roots and cannot be relocated.
+  if (!Serializer::enabled() || !isolate->IsDefaultIsolate()) return NULL;
+  if (!info->script()->IsScript()) return NULL;
+  Handle<Script> script(Script::cast(info->script()), isolate);
+  if (!script->source()->IsString()) return NULL;
+  uint32_t source_hash =
+      SourceHash(Handle<String>(String::cast(script->source()), isolate));
+  uint32_t flag_hash = FlagList::Hash();
+
+  List<byte> payload;
+  ListSnapshotSink sink(&payload);
+  CodeSerializer serializer(&sink, *script);
+  Object* root = *info;
+  serializer.VisitPointer(&root);
+  if (serializer.unsupported_) return NULL;
+
+  List<String*>* symbols = &serializer.symbols_;
+  int symbol_data_size = 0;
+  for (int i = 0; i < symbols->length(); i++) {
+    String* symbol = symbols->at(i);
+    symbol_data_size +=
+        2 + SymbolDataSize(symbol->length(), symbol->IsAsciiRepresentation());
+  }
+  int payload_size = SymbolDataSize(payload.length(), true);
+  Vector<unsigned> data =
+      Vector<unsigned>::New(kHeaderSize + symbol_data_size + payload_size);
+  memset(data.start(), 0, data.length() * sizeof(unsigned));
+
+  data[kMagicOffset] = PreparseDataConstants::kCodeCacheMagicNumber;
+  data[kVersionHashOffset] = VersionHash();
+  data[kSourceHashOffset] = source_hash;
+  data[kFlagHashOffset] = flag_hash;
+  data[kSymbolCountOffset] = symbols->length();
+  data[kSymbolDataSizeOffset] = symbol_data_size;
+  data[kPayloadLengthOffset] = payload.length();
+  for (int i = 0; i <= LAST_SPACE; i++) {
+    data[kReservationsOffset + i] = serializer.CurrentAllocationAddress(i);
+  }
+
+  unsigned* cursor = data.start() + kHeaderSize;
+  for (int i = 0; i < symbols->length(); i++) {
+    String* symbol = symbols->at(i);
+    int length = symbol->length();
+    bool is_ascii = symbol->IsAsciiRepresentation();
+    *cursor++ = length;
+    *cursor++ = is_ascii ? 1 : 0;
+    if (is_ascii) {
+      String::WriteToFlat(symbol, reinterpret_cast<char*>(cursor), 0, length);
+    } else {
+      String::WriteToFlat(symbol, reinterpret_cast<uc16*>(cursor), 0, length);
+    }
+    cursor += SymbolDataSize(length, is_ascii);
+  }
+  memcpy(cursor, payload.ToVector().start(), payload.length());
+
+  return new ScriptDataImpl(data);
+}
+
+
+bool CodeSerializer::SanityCheck(Vector<unsigned> data, Handle<String> source) {
+  if (data.length() < kHeaderSize) return false;
+  if (data[kMagicOffset] != PreparseDataConstants::kCodeCacheMagicNumber) {
+    return false;
+  }
+  if (data[kVersionHashOffset] != VersionHash()) return false;
+  if (data[kFlagHashOffset] != FlagList::Hash()) return false;
+  int symbol_data_size = static_cast<int>(data[kSymbolDataSizeOffset]);
+  int payload_length = static_cast<int>(data[kPayloadLengthOffset]);
+  if (symbol_data_size < 0 || payload_length < 0) return false;
+  if (data.length() != kHeaderSize + symbol_data_size +
+                       SymbolDataSize(payload_length, true)) {
+    return false;
+  }
+  return data[kSourceHashOffset] == SourceHash(source);
+}
+
+
+Handle<SharedFunctionInfo> CodeSerializer::Deserialize(
+    Handle<Script> script,
+    ScriptDataImpl* cached_data) {
+  Isolate* isolate = script->GetIsolate();
+  Vector<unsigned> data = cached_data->store_;
+  Handle<String> source(String::cast(script->source()), isolate);
+  if (!SanityCheck(data, source)) return Handle<SharedFunctionInfo>::null();
+
+  const unsigned* symbol_data = data.start() + kHeaderSize;
+  const unsigned* symbol_data_end =
+      symbol_data + data[kSymbolDataSizeOffset];
+  const byte* payload = reinterpret_cast<const byte*>(symbol_data_end);
+  SnapshotByteSource payload_source(payload, data[kPayloadLengthOffset]);
+  Deserializer deserializer(&payload_source);
+
+  // Look up the symbols before reserving space for the deserialized objects,
+  // as adding symbols to the symbol table allocates.
+  deserializer.AddAttachedObject(script);
+  int symbol_count = static_cast<int>(data[kSymbolCountOffset]);
+  const unsigned* cursor = symbol_data;
+  for (int i = 0; i < symbol_count; i++) {
+    if (cursor + 2 > symbol_data_end) return Handle<SharedFunctionInfo>::null();
+    int length = static_cast<int>(*cursor++);
+    bool is_ascii = *cursor++ != 0;
+    int size = SymbolDataSize(length, is_ascii);
+    if (length < 0 || cursor + size > symbol_data_end) {
+      return Handle<SharedFunctionInfo>::null();
+    }
+    Handle<String> symbol;
+    if (is_ascii) {
+      Vector<const char> chars(reinterpret_cast<const char*>(cursor), length);
+      symbol = isolate->factory()->LookupAsciiSymbol(chars);
+    } else {
+      Vector<const uc16> chars(reinterpret_cast<const uc16*>(cursor), length);
+      symbol = isolate->factory()->LookupTwoByteSymbol(chars);
+    }
+    deserializer.AddAttachedObject(symbol);
+    cursor += size;
+  }
+
+  isolate->heap()->ReserveSpace(data[kReservationsOffset + NEW_SPACE],
+                                data[kReservationsOffset + OLD_POINTER_SPACE],
+                                data[kReservationsOffset + OLD_DATA_SPACE],
+                                data[kReservationsOffset + CODE_SPACE],
+                                data[kReservationsOffset + MAP_SPACE],
+                                data[kReservationsOffset + CELL_SPACE],
+                                data[kReservationsOffset + LO_SPACE]);
+  Object* root;
+  deserializer.DeserializePartial(&root);
+  CHECK(root->IsSharedFunctionInfo());
+  return Handle<SharedFunctionInfo>(SharedFunctionInfo::cast(root), isolate);
+}
+
+
 } }  // namespace v8::internal
@@ -33,6 +33,8 @@
 namespace v8 {
 namespace internal {
 
+class ScriptDataImpl;
+
 // A TypeCode is used to distinguish different kinds of external reference.
 // It is a single bit to make testing for types easy.
 enum TypeCode {
@@ -221,7 +223,9 @@ class SerializerDeserializer: public ObjectVisitor {
     kPartialSnapshotCache = 0xa,    // Object is in the cache.
     kExternalReference = 0xb,       // Pointer to an external reference.
     kSkip = 0xc,                    // Skip a pointer sized cell.
-    // 0xd-0xf                         Free.
+    kAttachedReference = 0xd,       // Object is in the attached objects.
+    kBuiltin = 0xe,                 // Object is a builtin code object.
+    // 0xf                             Free.
     kBackref = 0x10,                 // Object is described relative to end.
     // 0x11-0x18                       One per space.
     // 0x19-0x1f                       Free.
@@ -341,6 +345,12 @@ class Deserializer: public SerializerDeserializer {
   // Deserialize a single object and the objects reachable from it.
   void DeserializePartial(Object** root);
 
+  // Objects that the serialized data refers to by index instead of
+  // containing them, e.g. the script and the symbols of a code cache.
+  void AddAttachedObject(Handle<Object> attached_object) {
+    attached_objects_.Add(attached_object);
+  }
+
 #ifdef DEBUG
   virtual void Synchronize(const char* tag);
 #endif
@@ -388,6 +398,8 @@ class Deserializer: public SerializerDeserializer {
 
   ExternalReferenceDecoder* external_reference_decoder_;
 
+  List<Handle<Object> > attached_objects_;
+
   DISALLOW_COPY_AND_ASSIGN(Deserializer);
 };
 
@@ -650,6 +662,74 @@ class StartupSerializer : public Serializer {
 };
 
 
+// Serializes the shared function info of a compiled script together with
+// its code and everything reachable from it, so that a later compilation of
+// the same source can deserialize it instead of parsing and compiling.  The
+// script and the symbols are not part of the serialized object graph: the
+// script is recreated by the compiler and the symbols are stored separately
+// and looked up in the symbol table when deserializing.  The result can only
+// be deserialized by the same V8 version running with the same flags.
+class CodeSerializer : public Serializer {
+ public:
+  // Returns NULL if the code cannot be serialized, e.g. because the code was
+  // not generated with serialization enabled or it refers to objects that
+  // belong to a context.
+  static ScriptDataImpl* Serialize(Handle<SharedFunctionInfo> info);
+
+  // Returns a null handle if the cached data does not match the source of
+  // the script or the current flags.
+  static Handle<SharedFunctionInfo> Deserialize(Handle<Script> script,
+                                                ScriptDataImpl* cached_data);
+
+  virtual void SerializeObject(Object* o,
+                               HowToCode how_to_code,
+                               WhereToPoint where_to_point);
+
+  // Layout of the header of the cached data, in units of unsigned.
+  static const int kMagicOffset = 0;
+  static const int kVersionHashOffset = 1;
+  static const int kSourceHashOffset = 2;
+  static const int kFlagHashOffset = 3;
+  static const int kSymbolCountOffset = 4;
+  static const int kSymbolDataSizeOffset = 5;
+  static const int kPayloadLengthOffset = 6;
+  static const int kReservationsOffset = 7;
+  static const int kHeaderSize = kReservationsOffset + LAST_SPACE + 1;
+
+ private:
+  CodeSerializer(SnapshotByteSink* sink, Script* script);
+  ~CodeSerializer();
+
+  virtual bool ShouldBeInThePartialSnapshotCache(HeapObject* o) {
+    return false;
+  }
+
+  void SerializeSymbol(String* symbol,
+                       HowToCode how_to_code,
+                       WhereToPoint where_to_point);
+  void SerializeBuiltin(int builtin_index,
+                        HowToCode how_to_code,
+                        WhereToPoint where_to_point);
+  static bool IsSerializable(HeapObject* object);
+
+  static uint32_t SourceHash(Handle<String> source);
+  static uint32_t VersionHash();
+  static bool SanityCheck(Vector<unsigned> data, Handle<String> source);
+
+  // The script is attached object 0, the symbols follow in the order they
+  // were first encountered.
+  static const int kScriptIndex = 0;
+  static const int kFirstSymbolIndex = 1;
+
+  Script* script_;
+  List<String*> symbols_;
+  HashMap* symbol_map_;
+  bool unsupported_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeSerializer);
+};
+
+
 } }  // namespace v8::internal
 
 #endif  // V8_SERIALIZE_H_
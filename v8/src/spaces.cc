@@ -255,6 +255,78 @@ void CodeRange::TearDown() {
 }
 
 
+// -----------------------------------------------------------------------------
+// PagePool
+//
+
+static Mutex* page_pool_mutex = OS::CreateMutex();
+PagePool::Entry* PagePool::entries_ = NULL;
+size_t PagePool::size_ = 0;
+
+
+bool PagePool::Put(VirtualMemory* reservation,
+                   Address base,
+                   size_t size,
+                   bool committed) {
+  ASSERT(reservation->IsReserved());
+  size_t reserved = reservation->size();
+  ScopedLock lock(page_pool_mutex);
+  if (size_ + reserved > static_cast<size_t>(FLAG_page_pool_size) * MB) {
+    return false;
+  }
+  Entry* entry = new Entry();
+  entry->reservation.TakeControl(reservation);
+  entry->base = base;
+  entry->size = size;
+  entry->committed = committed;
+  entry->next = entries_;
+  entries_ = entry;
+  size_ += reserved;
+  return true;
+}
+
+
+Address PagePool::Get(size_t size,
+                      size_t alignment,
+                      bool committed,
+                      VirtualMemory* controller) {
+  ScopedLock lock(page_pool_mutex);
+  Entry** link = &entries_;
+  for (Entry* entry = entries_; entry != NULL; entry = entry->next) {
+    if (entry->committed == committed &&
+        entry->size == size &&
+        IsAddressAligned(entry->base, alignment, 0)) {
+      Address base = entry->base;
+      *link = entry->next;
+      size_ -= entry->reservation.size();
+      controller->TakeControl(&entry->reservation);
+      delete entry;
+      return base;
+    }
+    link = &entry->next;
+  }
+  return NULL;
+}
+
+
+size_t PagePool::Size() {
+  ScopedLock lock(page_pool_mutex);
+  return size_;
+}
+
+
+void PagePool::TearDown() {
+  ScopedLock lock(page_pool_mutex);
+  while (entries_ != NULL) {
+    Entry* entry = entries_;
+    entries_ = entry->next;
+    entry->reservation.Release();
+    delete entry;
+  }
+  size_ = 0;
+}
+
+
 // -----------------------------------------------------------------------------
 // MemoryAllocator
 //
@@ -264,7 +336,9 @@ MemoryAllocator::MemoryAllocator(Isolate* isolate)
       capacity_(0),
       capacity_executable_(0),
       size_(0),
-      size_executable_(0) {
+      size_executable_(0),
+      large_chunk_cache_(NULL),
+      large_chunk_cache_size_(0) {
 }
 
 
@@ -281,6 +355,7 @@ bool MemoryAllocator::Setup(intptr_t capacity, intptr_t capacity_executable) {
 
 
 void MemoryAllocator::TearDown() {
+  ReleaseLargeChunkCache();
   // Check that spaces were torn down before MemoryAllocator.
   ASSERT(size_ == 0);
   // TODO(gc) this will be true again when we fix FreeMemory.
@@ -312,6 +387,22 @@ void MemoryAllocator::FreeMemory(VirtualMemory* reservation,
 }
 
 
+void MemoryAllocator::PoolMemory(VirtualMemory* reservation,
+                                 Address base,
+                                 size_t size,
+                                 bool committed) {
+  size_t reserved = reservation->size();
+  if (!PagePool::Put(reservation, base, size, committed)) {
+    FreeMemory(reservation, NOT_EXECUTABLE);
+    return;
+  }
+  ASSERT(size_ >= reserved);
+  size_ -= reserved;
+  isolate_->counters()->memory_allocated()->Decrement(
+      static_cast<int>(reserved));
+}
+
+
 void MemoryAllocator::FreeMemory(Address base,
                                  size_t size,
                                  Executability executable) {
@@ -340,12 +431,15 @@ void MemoryAllocator::FreeMemory(Address base,
 Address MemoryAllocator::ReserveAlignedMemory(size_t size,
                                               size_t alignment,
                                               VirtualMemory* controller) {
-  VirtualMemory reservation(size, alignment);
-
-  if (!reservation.IsReserved()) return NULL;
+  VirtualMemory reservation;
+  Address base = PagePool::Get(size, alignment, false, &reservation);
+  if (base == NULL) {
+    VirtualMemory fresh(size, alignment);
+    if (!fresh.IsReserved()) return NULL;
+    reservation.TakeControl(&fresh);
+    base = RoundUp(static_cast<Address>(reservation.address()), alignment);
+  }
   size_ += reservation.size();
-  Address base = RoundUp(static_cast<Address>(reservation.address()),
-                         alignment);
   controller->TakeControl(&reservation);
   return base;
 }
@@ -356,6 +450,14 @@ Address MemoryAllocator::AllocateAlignedMemory(size_t size,
                                                Executability executable,
                                                VirtualMemory* controller) {
   VirtualMemory reservation;
+  if (executable == NOT_EXECUTABLE) {
+    Address base = PagePool::Get(size, alignment, true, &reservation);
+    if (base != NULL) {
+      size_ += reservation.size();
+      controller->TakeControl(&reservation);
+      return base;
+    }
+  }
   Address base = ReserveAlignedMemory(size, alignment, &reservation);
   if (base == NULL) return NULL;
   if (!reservation.Commit(base,
@@ -423,6 +525,10 @@ MemoryChunk* MemoryChunk::Initialize(Heap* heap,
   chunk->InitializeReservedMemory();
   chunk->slots_buffer_ = NULL;
   chunk->skip_list_ = NULL;
+  chunk->parallel_sweeping_ = SWEEPING_DONE;
+  chunk->card_table_ = NULL;
+  chunk->card_count_ = 0;
+  chunk->store_buffer_overflows_ = 0;
   chunk->ResetLiveBytes();
   Bitmap::Clear(chunk);
   chunk->initialize_scan_on_scavenge(false);
@@ -430,6 +536,7 @@ MemoryChunk* MemoryChunk::Initialize(Heap* heap,
 
   ASSERT(OFFSET_OF(MemoryChunk, flags_) == kFlagsOffset);
   ASSERT(OFFSET_OF(MemoryChunk, live_byte_count_) == kLiveBytesOffset);
+  ASSERT(OFFSET_OF(MemoryChunk, card_table_) == kCardTableOffset);
 
   if (executable == EXECUTABLE) chunk->SetFlag(IS_EXECUTABLE);
 
@@ -447,6 +554,26 @@ void MemoryChunk::InsertAfter(MemoryChunk* other) {
 }
 
 
+void MemoryChunk::EnableCardTable() {
+  ASSERT(!uses_card_table());
+  ASSERT(owner() == heap_->old_pointer_space() ||
+         owner() == heap_->lo_space());
+  set_scan_on_scavenge(false);
+  card_count_ = static_cast<int>((size() + kCardSize - 1) >> kCardSizeLog2);
+  card_table_ = NewArray<uint8_t>(card_count_);
+  memset(card_table_, kDirtyCard, card_count_);
+  SetFlag(USES_CARD_TABLE);
+}
+
+
+void MemoryChunk::ReleaseCardTable() {
+  ClearFlag(USES_CARD_TABLE);
+  DeleteArray(card_table_);
+  card_table_ = NULL;
+  card_count_ = 0;
+}
+
+
 void MemoryChunk::Unlink() {
   if (!InNewSpace() && IsFlagSet(SCAN_ON_SCAVENGE)) {
     heap_->decrement_scan_on_scavenge_pages();
@@ -495,8 +622,15 @@ MemoryChunk* MemoryAllocator::AllocateChunk(intptr_t body_size,
       size_executable_ += reservation.size();
     }
   } else {
+    // Chunks of large objects are aligned for huge pages, so that most of
+    // their memory can be backed by them.
+    size_t alignment = MemoryChunk::kAlignment;
+    if (FLAG_huge_pages &&
+        chunk_size >= static_cast<size_t>(VirtualMemory::kHugePageSize)) {
+      alignment = VirtualMemory::kHugePageSize;
+    }
     base = AllocateAlignedMemory(chunk_size,
-                                 MemoryChunk::kAlignment,
+                                 alignment,
                                  executable,
                                  &reservation);
 
@@ -538,7 +672,11 @@ Page* MemoryAllocator::AllocatePage(PagedSpace* owner,
 LargePage* MemoryAllocator::AllocateLargePage(intptr_t object_size,
                                               Executability executable,
                                               Space* owner) {
-  MemoryChunk* chunk = AllocateChunk(object_size, executable, owner);
+  MemoryChunk* chunk = NULL;
+  if (executable == NOT_EXECUTABLE) {
+    chunk = TakeCachedLargeChunk(object_size, owner);
+  }
+  if (chunk == NULL) chunk = AllocateChunk(object_size, executable, owner);
   if (chunk == NULL) return NULL;
   return LargePage::Initialize(isolate_->heap(), chunk);
 }
@@ -554,9 +692,21 @@ void MemoryAllocator::Free(MemoryChunk* chunk) {
 
   delete chunk->slots_buffer();
   delete chunk->skip_list();
+  chunk->ReleaseCardTable();
+
+  if (chunk->owner() != NULL &&
+      chunk->owner()->identity() == LO_SPACE &&
+      CacheLargeChunk(chunk)) {
+    return;
+  }
 
   VirtualMemory* reservation = chunk->reserved_memory();
-  if (reservation->IsReserved()) {
+  if (reservation->IsReserved() &&
+      chunk->executable() == NOT_EXECUTABLE &&
+      chunk->size() == static_cast<size_t>(Page::kPageSize)) {
+    // Ordinary pages are committed all the time and are worth reusing.
+    PoolMemory(reservation, chunk->address(), chunk->size(), true);
+  } else if (reservation->IsReserved()) {
     FreeMemory(reservation, chunk->executable());
   } else {
     FreeMemory(chunk->address(),
@@ -566,6 +716,105 @@ void MemoryAllocator::Free(MemoryChunk* chunk) {
 }
 
 
+bool MemoryAllocator::CacheLargeChunk(MemoryChunk* chunk) {
+  VirtualMemory* reservation = chunk->reserved_memory();
+  if (!reservation->IsReserved() ||
+      chunk->executable() == EXECUTABLE ||
+      large_chunk_cache_size_ + chunk->size() >
+          static_cast<size_t>(FLAG_large_object_cache_size) * MB) {
+    return false;
+  }
+  size_t reserved = reservation->size();
+  CachedLargeChunk* entry = new CachedLargeChunk();
+  entry->base = chunk->address();
+  entry->size = chunk->size();
+  entry->age = 0;
+  entry->reservation.TakeControl(reservation);
+  entry->next = large_chunk_cache_;
+  large_chunk_cache_ = entry;
+  large_chunk_cache_size_ += entry->size;
+
+  ASSERT(size_ >= reserved);
+  size_ -= reserved;
+  isolate_->counters()->memory_allocated()->Decrement(
+      static_cast<int>(entry->size));
+  return true;
+}
+
+
+MemoryChunk* MemoryAllocator::TakeCachedLargeChunk(intptr_t body_size,
+                                                   Space* owner) {
+  size_t chunk_size = MemoryChunk::kObjectStartOffset + body_size;
+  CachedLargeChunk** best = NULL;
+  for (CachedLargeChunk** link = &large_chunk_cache_;
+       *link != NULL;
+       link = &(*link)->next) {
+    size_t size = (*link)->size;
+    if (size < chunk_size ||
+        size - chunk_size > chunk_size / kLargeChunkCacheSlackDivisor) {
+      continue;
+    }
+    if (best == NULL || size < (*best)->size) best = link;
+  }
+  if (best == NULL) return NULL;
+
+  CachedLargeChunk* entry = *best;
+  *best = entry->next;
+  large_chunk_cache_size_ -= entry->size;
+  VirtualMemory reservation;
+  reservation.TakeControl(&entry->reservation);
+  Address base = entry->base;
+  chunk_size = entry->size;
+  delete entry;
+
+  size_ += reservation.size();
+#ifdef DEBUG
+  ZapBlock(base, chunk_size);
+#endif
+  isolate_->counters()->memory_allocated()->
+      Increment(static_cast<int>(chunk_size));
+
+  LOG(isolate_, NewEvent("MemoryChunk", base, chunk_size));
+  ObjectSpace space = static_cast<ObjectSpace>(1 << owner->identity());
+  PerformAllocationCallback(space, kAllocationActionAllocate, chunk_size);
+
+  MemoryChunk* result = MemoryChunk::Initialize(isolate_->heap(),
+                                                base,
+                                                chunk_size,
+                                                NOT_EXECUTABLE,
+                                                owner);
+  result->set_reserved_memory(&reservation);
+  return result;
+}
+
+
+void MemoryAllocator::AgeLargeChunkCache() {
+  CachedLargeChunk** link = &large_chunk_cache_;
+  while (*link != NULL) {
+    CachedLargeChunk* entry = *link;
+    if (++entry->age <= FLAG_large_object_cache_age) {
+      link = &entry->next;
+      continue;
+    }
+    *link = entry->next;
+    large_chunk_cache_size_ -= entry->size;
+    entry->reservation.Release();
+    delete entry;
+  }
+}
+
+
+void MemoryAllocator::ReleaseLargeChunkCache() {
+  while (large_chunk_cache_ != NULL) {
+    CachedLargeChunk* entry = large_chunk_cache_;
+    large_chunk_cache_ = entry->next;
+    entry->reservation.Release();
+    delete entry;
+  }
+  large_chunk_cache_size_ = 0;
+}
+
+
 bool MemoryAllocator::CommitBlock(Address start,
                                   size_t size,
                                   Executability executable) {
@@ -658,7 +907,10 @@ PagedSpace::PagedSpace(Heap* heap,
     : Space(heap, id, executable),
       free_list_(this),
       was_swept_conservatively_(false),
-      first_unswept_page_(Page::FromAddress(NULL)) {
+      first_unswept_page_(Page::FromAddress(NULL)),
+      concurrently_swept_free_list_(this),
+      concurrently_freed_bytes_(0),
+      concurrent_sweeping_mutex_(NULL) {
   max_capacity_ = (RoundDown(max_capacity, Page::kPageSize) / Page::kPageSize)
                   * Page::kObjectAreaSize;
   accounting_stats_.Clear();
@@ -671,7 +923,8 @@ PagedSpace::PagedSpace(Heap* heap,
 
 
 bool PagedSpace::Setup() {
-  return true;
+  concurrent_sweeping_mutex_ = OS::CreateMutex();
+  return concurrent_sweeping_mutex_ != NULL;
 }
 
 
@@ -688,6 +941,8 @@ void PagedSpace::TearDown() {
   anchor_.set_next_page(&anchor_);
   anchor_.set_prev_page(&anchor_);
   accounting_stats_.Clear();
+  delete concurrent_sweeping_mutex_;
+  concurrent_sweeping_mutex_ = NULL;
 }
 
 
@@ -723,6 +978,11 @@ bool PagedSpace::CanExpand() {
   return true;
 }
 
+
+bool PagedSpace::CanExpandBy(int pages) {
+  return Capacity() + pages * Page::kPageSize <= max_capacity_;
+}
+
 bool PagedSpace::Expand() {
   if (!CanExpand()) return false;
 
@@ -784,6 +1044,13 @@ void PagedSpace::ReleasePage(Page* page) {
 
 
 void PagedSpace::ReleaseAllUnusedPages() {
+  // Neither the free list nor the live bytes are final while the sweeper
+  // threads are still running.
+  MarkCompactCollector* collector = heap()->mark_compact_collector();
+  if (collector->IsConcurrentSweepingInProgress()) {
+    collector->WaitUntilSweepingCompleted();
+  }
+
   PageIterator it(this);
   while (it.has_next()) {
     Page* page = it.next();
@@ -944,14 +1211,19 @@ void NewSpace::TearDown() {
   allocation_info_.top = NULL;
   allocation_info_.limit = NULL;
 
+  // Give the memory back before the reservation goes to the page pool.
+  if (to_space_.is_committed()) to_space_.Uncommit();
+  if (from_space_.is_committed()) from_space_.Uncommit();
   to_space_.TearDown();
   from_space_.TearDown();
 
   LOG(heap()->isolate(), DeleteEvent("InitialChunk", chunk_base_));
 
   ASSERT(reservation_.IsReserved());
-  heap()->isolate()->memory_allocator()->FreeMemory(&reservation_,
-                                                    NOT_EXECUTABLE);
+  heap()->isolate()->memory_allocator()->PoolMemory(&reservation_,
+                                                    chunk_base_,
+                                                    chunk_size_,
+                                                    false);
   chunk_base_ = NULL;
   chunk_size_ = 0;
 }
@@ -1008,11 +1280,14 @@ void NewSpace::UpdateAllocationInfo() {
   allocation_info_.top = to_space_.page_low();
   allocation_info_.limit = to_space_.page_high();
 
-  // Lower limit during incremental marking.
+  // Lower limit during incremental marking and allocation sampling.
+  intptr_t step = allocation_sampling_step_;
   if (heap()->incremental_marking()->IsMarking() &&
       inline_allocation_limit_step() != 0) {
-    Address new_limit =
-        allocation_info_.top + inline_allocation_limit_step();
+    step = effective_inline_allocation_limit_step();
+  }
+  if (step != 0) {
+    Address new_limit = allocation_info_.top + step;
     allocation_info_.limit = Min(new_limit, allocation_info_.limit);
   }
   ASSERT_SEMISPACE_ALLOCATION_INFO(allocation_info_, to_space_);
@@ -1068,21 +1343,29 @@ MaybeObject* NewSpace::SlowAllocateRaw(int size_in_bytes) {
   Address new_top = old_top + size_in_bytes;
   Address high = to_space_.page_high();
   if (allocation_info_.limit < high) {
-    // Incremental marking has lowered the limit to get a
-    // chance to do a step.
+    // Incremental marking or allocation sampling has lowered the limit to
+    // get a chance to do a step.
     allocation_info_.limit = Min(
-        allocation_info_.limit + inline_allocation_limit_step_,
+        allocation_info_.limit + effective_inline_allocation_limit_step(),
         high);
     int bytes_allocated = static_cast<int>(new_top - top_on_previous_step_);
     heap()->incremental_marking()->Step(bytes_allocated);
     top_on_previous_step_ = new_top;
-    return AllocateRaw(size_in_bytes);
+    MaybeObject* result = AllocateRaw(size_in_bytes);
+    if (allocation_sampling_step_ != 0) {
+      heap()->SampleAllocation(result, size_in_bytes, bytes_allocated);
+    }
+    return result;
   } else if (AddFreshPage()) {
     // Switched to new page. Try allocating again.
     int bytes_allocated = static_cast<int>(old_top - top_on_previous_step_);
     heap()->incremental_marking()->Step(bytes_allocated);
     top_on_previous_step_ = to_space_.page_low();
-    return AllocateRaw(size_in_bytes);
+    MaybeObject* result = AllocateRaw(size_in_bytes);
+    if (allocation_sampling_step_ != 0) {
+      heap()->SampleAllocation(result, size_in_bytes, bytes_allocated);
+    }
+    return result;
   } else {
     return Failure::RetryAfterGC();
   }
@@ -1756,6 +2039,30 @@ int FreeList::Free(Address start, int size_in_bytes) {
 }
 
 
+void FreeList::ConcatenateList(FreeListNode** list, FreeListNode** other) {
+  if (*other == NULL) return;
+  // Prepend the other list by linking its last node to our current head.
+  FreeListNode* tail = *other;
+  while (tail->next() != NULL) tail = tail->next();
+  tail->set_next(*list);
+  *list = *other;
+  *other = NULL;
+}
+
+
+intptr_t FreeList::Concatenate(FreeList* other) {
+  intptr_t moved_bytes = other->available_;
+  ConcatenateList(&small_list_, &other->small_list_);
+  ConcatenateList(&medium_list_, &other->medium_list_);
+  ConcatenateList(&large_list_, &other->large_list_);
+  ConcatenateList(&huge_list_, &other->huge_list_);
+  available_ += other->available_;
+  other->available_ = 0;
+  ASSERT(IsVeryLong() || available_ == SumFreeLists());
+  return moved_bytes;
+}
+
+
 FreeListNode* FreeList::PickNodeFromList(FreeListNode** list, int* node_size) {
   FreeListNode* node = *list;
 
@@ -1940,6 +2247,32 @@ static intptr_t EvictFreeListItemsInList(FreeListNode** n, Page* p) {
 }
 
 
+static intptr_t DiscardFreeListItemsInList(FreeListNode* n) {
+  intptr_t sum = 0;
+  uintptr_t page_size = OS::AllocateAlignment();
+  for (; n != NULL; n = n->next()) {
+    // Keep the map, size and next pointer of the node.
+    uintptr_t start =
+        reinterpret_cast<uintptr_t>(n->next_address()) + kPointerSize;
+    uintptr_t end = reinterpret_cast<uintptr_t>(n->address()) +
+        reinterpret_cast<FreeSpace*>(n)->Size();
+    start = RoundUp(start, page_size);
+    end = RoundDown(end, page_size);
+    if (start < end) {
+      OS::DiscardMemory(reinterpret_cast<void*>(start), end - start);
+      sum += end - start;
+    }
+  }
+  return sum;
+}
+
+
+intptr_t FreeList::DiscardFreeMemory() {
+  return DiscardFreeListItemsInList(huge_list_) +
+      DiscardFreeListItemsInList(large_list_);
+}
+
+
 intptr_t FreeList::EvictFreeListItems(Page* p) {
   intptr_t sum = EvictFreeListItemsInList(&huge_list_, p);
 
@@ -2093,9 +2426,66 @@ bool LargeObjectSpace::ReserveSpace(int bytes) {
 }
 
 
+void PagedSpace::AddConcurrentlySweptMemory(FreeList* free_list,
+                                            intptr_t freed_bytes) {
+  ScopedLock lock(concurrent_sweeping_mutex_);
+  concurrently_swept_free_list_.Concatenate(free_list);
+  concurrently_freed_bytes_ += freed_bytes;
+}
+
+
+intptr_t PagedSpace::RefillFreeListFromSweeperThreads() {
+  intptr_t freed_bytes;
+  {
+    ScopedLock lock(concurrent_sweeping_mutex_);
+    free_list_.Concatenate(&concurrently_swept_free_list_);
+    freed_bytes = concurrently_freed_bytes_;
+    concurrently_freed_bytes_ = 0;
+  }
+  accounting_stats_.DeallocateBytes(freed_bytes);
+  heap()->LowerOldGenLimits(freed_bytes);
+  return freed_bytes;
+}
+
+
+intptr_t PagedSpace::SweepPendingPage(Page* p) {
+  if (!p->TryParallelSweeping()) return 0;
+  intptr_t freed_bytes =
+      MarkCompactCollector::SweepConservatively(this, &free_list_, p);
+  p->ResetLiveBytes();
+  p->set_parallel_sweeping(MemoryChunk::SWEEPING_DONE);
+  accounting_stats_.DeallocateBytes(freed_bytes);
+  heap()->LowerOldGenLimits(freed_bytes);
+  return freed_bytes;
+}
+
+
 bool PagedSpace::AdvanceSweeper(intptr_t bytes_to_sweep) {
   if (IsSweepingComplete()) return true;
 
+  MarkCompactCollector* collector = heap()->mark_compact_collector();
+  if (collector->IsConcurrentSweepingInProgress()) {
+    // Pick up what the sweeper threads have freed so far and help them with
+    // the pages nobody has claimed yet.
+    intptr_t freed_bytes = RefillFreeListFromSweeperThreads();
+    Page* p = first_unswept_page_;
+    while (p != anchor() && freed_bytes < bytes_to_sweep) {
+      if (FLAG_gc_verbose &&
+          p->parallel_sweeping() == MemoryChunk::SWEEPING_PENDING) {
+        PrintF("Sweeping 0x%" V8PRIxPTR " concurrently advanced.\n",
+               reinterpret_cast<intptr_t>(p));
+      }
+      freed_bytes += SweepPendingPage(p);
+      p = p->next_page();
+    }
+    if (p == anchor()) {
+      collector->WaitUntilSweepingCompleted();
+    } else {
+      first_unswept_page_ = p;
+    }
+    return IsSweepingComplete();
+  }
+
   intptr_t freed_bytes = 0;
   Page* p = first_unswept_page_;
   do {
@@ -2533,6 +2923,34 @@ void LargeObjectSpace::FreeUnmarkedObjects() {
     }
   }
   heap()->FreeQueuedChunks();
+  heap()->isolate()->memory_allocator()->AgeLargeChunkCache();
+}
+
+
+void LargeObjectSpace::TrimObject(HeapObject* object, int trimmed_bytes) {
+  ASSERT(Contains(object));
+  MemoryChunk* page = MemoryChunk::FromAddress(object->address());
+  objects_size_ -= trimmed_bytes;
+  if (Marking::IsBlack(Marking::MarkBitFrom(object))) {
+    MemoryChunk::IncrementLiveBytes(object->address(), -trimmed_bytes);
+  }
+  // Slots recorded for compaction may point into the tail while marking.
+  if (page->executable() == EXECUTABLE ||
+      heap()->incremental_marking()->IsMarking()) {
+    return;
+  }
+
+  Address object_end = object->address() + object->Size();
+  Address new_end = RoundUp(object_end, OS::AllocateAlignment());
+  Address old_end = page->address() + page->size();
+  if (new_end >= old_end) return;
+  size_t delta = static_cast<size_t>(old_end - new_end);
+  heap()->store_buffer()->RemoveSlots(new_end, old_end);
+  if (!heap()->isolate()->memory_allocator()->UncommitBlock(new_end, delta)) {
+    return;
+  }
+  page->set_size(static_cast<size_t>(new_end - page->address()));
+  size_ -= static_cast<intptr_t>(delta);
 }
 
 
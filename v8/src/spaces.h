@@ -29,6 +29,7 @@
 #define V8_SPACES_H_
 
 #include "allocation.h"
+#include "atomicops.h"
 #include "list.h"
 #include "log.h"
 
@@ -140,6 +141,21 @@ class MarkBit {
   inline bool Get() { return (*cell_ & mask_) != 0; }
   inline void Clear() { *cell_ &= ~mask_; }
 
+  // Set the bit with a compare-and-swap on the whole cell so that threads
+  // marking neighbouring objects do not lose each other's updates.  Returns
+  // false if the bit was already set.
+  inline bool SetAtomically() {
+    volatile Atomic32* cell = reinterpret_cast<volatile Atomic32*>(cell_);
+    Atomic32 mask = static_cast<Atomic32>(mask_);
+    Atomic32 old_value;
+    do {
+      old_value = NoBarrier_Load(cell);
+      if ((old_value & mask) != 0) return false;
+    } while (NoBarrier_CompareAndSwap(cell, old_value, old_value | mask) !=
+             old_value);
+    return true;
+  }
+
   inline bool data_only() { return data_only_; }
 
   inline MarkBit Next() {
@@ -391,6 +407,11 @@ class MemoryChunk {
     EVACUATION_CANDIDATE,
     RESCAN_ON_EVACUATION,
 
+    // The old-to-new pointers of the page are remembered in its card table
+    // rather than in the store buffer.  Mutually exclusive with
+    // SCAN_ON_SCAVENGE.
+    USES_CARD_TABLE,
+
     // Pages swept precisely can be iterated, hitting only the live objects.
     // Whereas those swept conservatively cannot be iterated over. Both flags
     // indicate that marking bits have been cleared by the sweeper, otherwise
@@ -475,6 +496,12 @@ class MemoryChunk {
   static void IncrementLiveBytes(Address address, int by) {
     MemoryChunk::FromAddress(address)->IncrementLiveBytes(by);
   }
+  // Used by the parallel marker, whose threads share pages.
+  static void IncrementLiveBytesAtomically(Address address, int by) {
+    MemoryChunk* chunk = MemoryChunk::FromAddress(address);
+    NoBarrier_AtomicIncrement(
+        reinterpret_cast<volatile Atomic32*>(&chunk->live_byte_count_), by);
+  }
 
   static const intptr_t kAlignment =
       (static_cast<uintptr_t>(1) << kPageSizeBits);
@@ -489,8 +516,11 @@ class MemoryChunk {
 
   static const size_t kSlotsBufferOffset = kLiveBytesOffset + kIntSize;
 
+  static const size_t kCardTableOffset =
+      kSlotsBufferOffset + kPointerSize + kPointerSize + kPointerSize;
+
   static const size_t kHeaderSize =
-      kSlotsBufferOffset + kPointerSize + kPointerSize;
+      kCardTableOffset + kPointerSize + kIntSize + kIntSize;
 
   static const int kBodyOffset =
     CODE_POINTER_ALIGN(MAP_POINTER_ALIGN(kHeaderSize + Bitmap::kSize));
@@ -552,6 +582,59 @@ class MemoryChunk {
     return this->address() + (index << kPointerSizeLog2);
   }
 
+  // ---------------------------------------------------------------------
+  // Card table support
+  //
+  // A chunk that keeps overflowing the store buffer can switch to a card
+  // table with one byte per kCardSize bytes of the chunk.  The write barrier
+  // dirties the card of a slot instead of entering the slot into the store
+  // buffer, and the scavenger only scans the dirty cards.
+
+  static const int kCardSizeLog2 = 9;
+  static const int kCardSize = 1 << kCardSizeLog2;
+
+  static const uint8_t kCleanCard = 0;
+  static const uint8_t kDirtyCard = 1;
+  // A card that is being scanned.  It becomes clean after the scan unless a
+  // surviving pointer to new space dirtied it again.
+  static const uint8_t kScanningCard = 2;
+
+  bool uses_card_table() { return IsFlagSet(USES_CARD_TABLE); }
+
+  // Allocates the card table with all cards dirty, so that slots which were
+  // only remembered by the store buffer are still found.
+  void EnableCardTable();
+  void ReleaseCardTable();
+
+  int card_count() { return card_count_; }
+
+  int AddressToCardIndex(Address addr) {
+    return static_cast<int>((addr - address()) >> kCardSizeLog2);
+  }
+
+  Address CardIndexToAddress(int index) {
+    return address() + (static_cast<intptr_t>(index) << kCardSizeLog2);
+  }
+
+  uint8_t card(int index) {
+    ASSERT(index >= 0 && index < card_count_);
+    return card_table_[index];
+  }
+
+  void set_card(int index, uint8_t value) {
+    ASSERT(index >= 0 && index < card_count_);
+    card_table_[index] = value;
+  }
+
+  void MarkCard(Address slot) {
+    set_card(AddressToCardIndex(slot), kDirtyCard);
+  }
+
+  // Number of times the store buffer exempted this chunk because it had too
+  // many entries.
+  int store_buffer_overflows() { return store_buffer_overflows_; }
+  void increment_store_buffer_overflows() { store_buffer_overflows_++; }
+
   void InsertAfter(MemoryChunk* other);
   void Unlink();
 
@@ -591,6 +674,34 @@ class MemoryChunk {
     ClearFlag(EVACUATION_CANDIDATE);
   }
 
+  // State of a page with respect to the concurrent sweeper threads.  Pages
+  // handed to the sweepers start out pending.  Whichever thread manages to
+  // move a page from pending to in progress sweeps it and then marks it done.
+  // The state lives outside of flags_ because the sweepers must not write
+  // flags_ while the main thread may be updating it.
+  enum ParallelSweepingState {
+    SWEEPING_DONE,
+    SWEEPING_IN_PROGRESS,
+    SWEEPING_PENDING
+  };
+
+  ParallelSweepingState parallel_sweeping() {
+    return static_cast<ParallelSweepingState>(
+        Acquire_Load(&parallel_sweeping_));
+  }
+
+  void set_parallel_sweeping(ParallelSweepingState state) {
+    Release_Store(&parallel_sweeping_, state);
+  }
+
+  // Tries to claim the page for sweeping.  Returns true if the calling thread
+  // is now responsible for sweeping it.
+  bool TryParallelSweeping() {
+    return Acquire_CompareAndSwap(&parallel_sweeping_,
+                                  SWEEPING_PENDING,
+                                  SWEEPING_IN_PROGRESS) == SWEEPING_PENDING;
+  }
+
 
  protected:
   MemoryChunk* next_chunk_;
@@ -611,6 +722,10 @@ class MemoryChunk {
   int live_byte_count_;
   SlotsBuffer* slots_buffer_;
   SkipList* skip_list_;
+  AtomicWord parallel_sweeping_;
+  uint8_t* card_table_;
+  int card_count_;
+  int store_buffer_overflows_;
 
   static MemoryChunk* Initialize(Heap* heap,
                                  Address base,
@@ -930,6 +1045,48 @@ class SkipList {
 };
 
 
+// ----------------------------------------------------------------------------
+// The page pool keeps non-executable reservations released by the memory
+// allocators of all isolates in the process, so that an isolate that needs
+// a page or a new space can reuse one instead of unmapping and mapping
+// memory again.  Its size is bounded by --page-pool-size.
+class PagePool : public AllStatic {
+ public:
+  // Takes control of the reservation if the pool has room for it.  The
+  // block [base, base + size[ is the part of it that was handed out, and
+  // committed tells whether that block is committed.
+  static bool Put(VirtualMemory* reservation,
+                  Address base,
+                  size_t size,
+                  bool committed);
+
+  // Hands out a pooled reservation with a block of the given size, aligned
+  // start and commit state.  Returns the start of the block or NULL.
+  static Address Get(size_t size,
+                     size_t alignment,
+                     bool committed,
+                     VirtualMemory* controller);
+
+  // Returns the number of bytes reserved by the pooled memory.
+  static size_t Size();
+
+  // Releases all pooled memory to the operating system.
+  static void TearDown();
+
+ private:
+  struct Entry : public Malloced {
+    VirtualMemory reservation;
+    Address base;
+    size_t size;
+    bool committed;
+    Entry* next;
+  };
+
+  static Entry* entries_;
+  static size_t size_;
+};
+
+
 // ----------------------------------------------------------------------------
 // A space acquires chunks of memory from the operating system. The memory
 // allocator allocated and deallocates pages for the paged heap spaces and large
@@ -995,6 +1152,13 @@ class MemoryAllocator {
   void FreeMemory(VirtualMemory* reservation, Executability executable);
   void FreeMemory(Address addr, size_t size, Executability executable);
 
+  // Like FreeMemory for non-executable memory, but offers the reservation
+  // to the page pool before releasing it.
+  void PoolMemory(VirtualMemory* reservation,
+                  Address base,
+                  size_t size,
+                  bool committed);
+
   // Commit a contiguous block of memory from the initial chunk.  Assumes that
   // the address is not NULL, the size is greater than zero, and that the
   // block is contained in the initial chunk.  Returns true if it succeeded
@@ -1025,6 +1189,14 @@ class MemoryAllocator {
   bool MemoryAllocationCallbackRegistered(
       MemoryAllocationCallback callback);
 
+  // Freed non-executable large object chunks are cached for reuse by large
+  // object allocations of a similar size.  Their number is bounded by
+  // --large-object-cache-size, and chunks that have not been reused for
+  // --large-object-cache-age full collections are released.
+  void AgeLargeChunkCache();
+  void ReleaseLargeChunkCache();
+  intptr_t LargeChunkCacheSize() { return large_chunk_cache_size_; }
+
  private:
   Isolate* isolate_;
 
@@ -1053,6 +1225,24 @@ class MemoryAllocator {
   List<MemoryAllocationCallbackRegistration>
       memory_allocation_callbacks_;
 
+  struct CachedLargeChunk : public Malloced {
+    VirtualMemory reservation;
+    Address base;
+    size_t size;
+    int age;
+    CachedLargeChunk* next;
+  };
+
+  // A cached chunk is reused for an allocation that needs at least this
+  // fraction of it.
+  static const int kLargeChunkCacheSlackDivisor = 4;
+
+  bool CacheLargeChunk(MemoryChunk* chunk);
+  MemoryChunk* TakeCachedLargeChunk(intptr_t body_size, Space* owner);
+
+  CachedLargeChunk* large_chunk_cache_;
+  intptr_t large_chunk_cache_size_;
+
   // Initializes pages in a chunk. Returns the first page address.
   // This function and GetChunkId() are provided for the mark-compact
   // collector to rebuild page headers in the from space, which is
@@ -1345,6 +1535,11 @@ class FreeList BASE_EMBEDDED {
   // aligned, and the size should be a non-zero multiple of the word size.
   int Free(Address start, int size_in_bytes);
 
+  // Move all blocks of the free list 'other' onto this free list, leaving
+  // 'other' empty.  Used to hand over the memory found by a sweeper thread.
+  // Returns the number of bytes that were moved.
+  intptr_t Concatenate(FreeList* other);
+
   // Allocate a block of size 'size_in_bytes' from the free list.  The block
   // is unitialized.  A failure is returned if no block is available.  The
   // number of bytes lost to fragmentation is returned in the output parameter
@@ -1374,6 +1569,10 @@ class FreeList BASE_EMBEDDED {
 
   intptr_t EvictFreeListItems(Page* p);
 
+  // Discards the memory of the operating system pages that lie entirely
+  // inside large free list nodes.  Returns the number of bytes discarded.
+  intptr_t DiscardFreeMemory();
+
  private:
   // The size range of blocks, in bytes.
   static const int kMinBlockSize = 3 * kPointerSize;
@@ -1381,6 +1580,8 @@ class FreeList BASE_EMBEDDED {
 
   FreeListNode* PickNodeFromList(FreeListNode** list, int* node_size);
 
+  static void ConcatenateList(FreeListNode** list, FreeListNode** other);
+
   FreeListNode* FindNodeFor(int size_in_bytes, int* node_size);
 
   PagedSpace* owner_;
@@ -1522,6 +1723,10 @@ class PagedSpace : public Space {
   // Releases all of the unused pages.
   void ReleaseAllUnusedPages();
 
+  // Gives the memory in large free blocks back to the operating system.
+  // Returns the number of bytes discarded.
+  intptr_t DiscardFreeMemory() { return free_list_.DiscardFreeMemory(); }
+
   // The dummy page that anchors the linked list of pages.
   Page* anchor() { return &anchor_; }
 
@@ -1567,6 +1772,18 @@ class PagedSpace : public Space {
     return !first_unswept_page_->is_valid();
   }
 
+  // Concurrent sweeping support.  Sweeper threads hand the memory they free
+  // over with AddConcurrentlySweptMemory; the main thread picks it up with
+  // RefillFreeListFromSweeperThreads.  Both return or take the number of
+  // reclaimed bytes.
+  void AddConcurrentlySweptMemory(FreeList* free_list, intptr_t freed_bytes);
+  intptr_t RefillFreeListFromSweeperThreads();
+
+  // Sweeps a page that is pending concurrent sweeping on the main thread,
+  // unless a sweeper thread has already claimed it.  Returns the number of
+  // reclaimed bytes.
+  intptr_t SweepPendingPage(Page* p);
+
   Page* FirstPage() { return anchor_.next_page(); }
   Page* LastPage() { return anchor_.prev_page(); }
 
@@ -1616,10 +1833,21 @@ class PagedSpace : public Space {
     return static_cast<int>(ratio - ratio_threshold);
   }
 
+  // Returns the percentage of the object area of a swept page that is on
+  // the free list.
+  int FreePercentage(Page* p) {
+    FreeList::SizeStats sizes;
+    free_list_.CountFreeListItems(p, &sizes);
+    return static_cast<int>(sizes.Total() * 100 / Page::kObjectAreaSize);
+  }
+
   void EvictEvacuationCandidatesFromFreeLists();
 
   bool CanExpand();
 
+  // Whether the space can grow by the given number of pages.
+  bool CanExpandBy(int pages);
+
   // Returns the number of total pages in this space.
   int CountTotalPages();
 
@@ -1649,6 +1877,12 @@ class PagedSpace : public Space {
 
   Page* first_unswept_page_;
 
+  // Memory reclaimed by the sweeper threads that has not yet been moved to
+  // free_list_, guarded by concurrent_sweeping_mutex_.
+  FreeList concurrently_swept_free_list_;
+  intptr_t concurrently_freed_bytes_;
+  Mutex* concurrent_sweeping_mutex_;
+
   // Expands the space by allocating a fixed number of pages. Returns false if
   // it cannot allocate requested number of pages from OS, or if the hard heap
   // size limit has been hit.
@@ -2051,7 +2285,8 @@ class NewSpace : public Space {
       to_space_(heap, kToSpace),
       from_space_(heap, kFromSpace),
       reservation_(),
-      inline_allocation_limit_step_(0) {}
+      inline_allocation_limit_step_(0),
+      allocation_sampling_step_(0) {}
 
   // Sets up the new space using the given chunk.
   bool Setup(int reserved_semispace_size_, int max_semispace_size);
@@ -2173,14 +2408,14 @@ class NewSpace : public Space {
 
   void LowerInlineAllocationLimit(intptr_t step) {
     inline_allocation_limit_step_ = step;
-    if (step == 0) {
-      allocation_info_.limit = to_space_.page_high();
-    } else {
-      allocation_info_.limit = Min(
-          allocation_info_.top + inline_allocation_limit_step_,
-          allocation_info_.limit);
-    }
-    top_on_previous_step_ = allocation_info_.top;
+    UpdateInlineAllocationLimit();
+  }
+
+  // Lowers the inline allocation limit so that the allocation sampler gets
+  // a chance to run after step bytes. A step of 0 stops sampling.
+  void SetAllocationSamplingStep(intptr_t step) {
+    allocation_sampling_step_ = step;
+    UpdateInlineAllocationLimit();
   }
 
   // Get the extent of the inactive semispace (for use as a marking stack,
@@ -2256,12 +2491,38 @@ class NewSpace : public Space {
     return inline_allocation_limit_step_;
   }
 
+  inline intptr_t allocation_sampling_step() {
+    return allocation_sampling_step_;
+  }
+
+  // The smaller of the nonzero incremental marking and allocation sampling
+  // steps, or 0 if neither lowers the limit.
+  intptr_t effective_inline_allocation_limit_step() {
+    if (inline_allocation_limit_step_ == 0) return allocation_sampling_step_;
+    if (allocation_sampling_step_ == 0) return inline_allocation_limit_step_;
+    return Min(inline_allocation_limit_step_, allocation_sampling_step_);
+  }
+
   SemiSpace* active_space() { return &to_space_; }
 
  private:
   // Update allocation info to match the current to-space page.
   void UpdateAllocationInfo();
 
+  // Lower the limit to the top plus the effective step after one of the
+  // steps changed.
+  void UpdateInlineAllocationLimit() {
+    intptr_t step = effective_inline_allocation_limit_step();
+    if (step == 0) {
+      allocation_info_.limit = to_space_.page_high();
+    } else {
+      allocation_info_.limit = Min(
+          allocation_info_.top + step,
+          allocation_info_.limit);
+    }
+    top_on_previous_step_ = allocation_info_.top;
+  }
+
   Address chunk_base_;
   uintptr_t chunk_size_;
 
@@ -2287,6 +2548,10 @@ class NewSpace : public Space {
   // when all allocation is performed from inlined generated code.
   intptr_t inline_allocation_limit_step_;
 
+  // Like inline_allocation_limit_step_, but for the allocation sampler of
+  // the heap profiler.
+  intptr_t allocation_sampling_step_;
+
   Address top_on_previous_step_;
 
   HistogramInfo* allocated_histogram_;
@@ -2503,6 +2768,10 @@ class LargeObjectSpace : public Space {
   // Frees unmarked objects.
   void FreeUnmarkedObjects();
 
+  // Gives back the memory behind the end of an object whose size was
+  // reduced in place by the given number of bytes.
+  void TrimObject(HeapObject* object, int trimmed_bytes);
+
   // Checks whether a heap object is in this space; O(1).
   bool Contains(HeapObject* obj);
 
@@ -161,7 +161,9 @@ void StoreBuffer::HandleFullness() {
   PointerChunkIterator it(heap_);
   MemoryChunk* chunk;
   while ((chunk = it.next()) != NULL) {
-    if (chunk->scan_on_scavenge()) page_has_scan_on_scavenge_flag = true;
+    if (chunk->scan_on_scavenge() || chunk->uses_card_table()) {
+      page_has_scan_on_scavenge_flag = true;
+    }
   }
 
   if (page_has_scan_on_scavenge_flag) {
@@ -195,8 +197,16 @@ void StoreBuffer::HandleFullness() {
 }
 
 
+static bool CanUseCardTable(Heap* heap, MemoryChunk* chunk) {
+  // Map space is scanned map by map, which the cards do not line up with.
+  return chunk->owner() == heap->old_pointer_space() ||
+         chunk->owner() == heap->lo_space();
+}
+
+
 // Sample the store buffer to see if some pages are taking up a lot of space
-// in the store buffer.
+// in the store buffer.  Pages that are exempted over and over again switch to
+// a card table if card marking is enabled.
 void StoreBuffer::ExemptPopularPages(int prime_sample_step, int threshold) {
   PointerChunkIterator it(heap_);
   MemoryChunk* chunk;
@@ -215,7 +225,17 @@ void StoreBuffer::ExemptPopularPages(int prime_sample_step, int threshold) {
     }
     int old_counter = containing_chunk->store_buffer_counter();
     if (old_counter == threshold) {
-      containing_chunk->set_scan_on_scavenge(true);
+      if (!containing_chunk->uses_card_table()) {
+        containing_chunk->increment_store_buffer_overflows();
+        if (FLAG_card_marking &&
+            CanUseCardTable(heap_, containing_chunk) &&
+            containing_chunk->store_buffer_overflows() >=
+                FLAG_card_marking_threshold) {
+          containing_chunk->EnableCardTable();
+        } else {
+          containing_chunk->set_scan_on_scavenge(true);
+        }
+      }
       created_new_scan_on_scavenge_pages = true;
     }
     containing_chunk->set_store_buffer_counter(old_counter + 1);
@@ -240,7 +260,23 @@ void StoreBuffer::Filter(int flag) {
       containing_chunk = MemoryChunk::FromAnyPointerAddress(addr);
       previous_chunk = containing_chunk;
     }
-    if (!containing_chunk->IsFlagSet(flag)) {
+    if (containing_chunk->uses_card_table()) {
+      // Entries for a page with a card table are moved to its cards.
+      containing_chunk->MarkCard(addr);
+    } else if (!containing_chunk->IsFlagSet(flag)) {
+      *new_top++ = addr;
+    }
+  }
+  old_top_ = new_top;
+}
+
+
+void StoreBuffer::RemoveSlots(Address start, Address end) {
+  Compact();
+  Address* new_top = old_start_;
+  for (Address* p = old_start_; p < old_top_; p++) {
+    Address addr = *p;
+    if (addr < start || addr >= end) {
       *new_top++ = addr;
     }
   }
@@ -268,7 +304,9 @@ bool StoreBuffer::PrepareForIteration() {
   MemoryChunk* chunk;
   bool page_has_scan_on_scavenge_flag = false;
   while ((chunk = it.next()) != NULL) {
-    if (chunk->scan_on_scavenge()) page_has_scan_on_scavenge_flag = true;
+    if (chunk->scan_on_scavenge() || chunk->uses_card_table()) {
+      page_has_scan_on_scavenge_flag = true;
+    }
   }
 
   if (page_has_scan_on_scavenge_flag) {
@@ -552,6 +590,73 @@ void StoreBuffer::FindPointersToNewSpaceOnPage(
 }
 
 
+void StoreBuffer::FindPointersToNewSpaceInCards(
+    Address start, Address end, ObjectSlotCallback slot_callback) {
+  MemoryChunk* chunk = MemoryChunk::FromAddress(start);
+  while (start < end) {
+    int index = chunk->AddressToCardIndex(start);
+    Address card_end = Min(end, chunk->CardIndexToAddress(index + 1));
+    if (chunk->card(index) != MemoryChunk::kCleanCard) {
+      for (Address slot_address = start;
+           slot_address < card_end;
+           slot_address += kPointerSize) {
+        Object** slot = reinterpret_cast<Object**>(slot_address);
+        if (heap_->InNewSpace(*slot)) {
+          HeapObject* object = reinterpret_cast<HeapObject*>(*slot);
+          ASSERT(object->IsHeapObject());
+          slot_callback(reinterpret_cast<HeapObject**>(slot), object);
+          if (heap_->InNewSpace(*slot)) {
+            chunk->set_card(index, MemoryChunk::kDirtyCard);
+          }
+        }
+      }
+    }
+    start = card_end;
+  }
+}
+
+
+// Scans the dirty cards of a chunk.  The cards are cleaned as they are scanned
+// and dirtied again for the pointers that still point to new space afterwards,
+// so nothing is entered into the store buffer for the chunk.
+void StoreBuffer::FindPointersToNewSpaceInCardTable(
+    MemoryChunk* chunk,
+    ObjectSlotCallback slot_callback) {
+  bool has_dirty_cards = false;
+  int card_count = chunk->card_count();
+  for (int i = 0; i < card_count; i++) {
+    if (chunk->card(i) == MemoryChunk::kDirtyCard) {
+      chunk->set_card(i, MemoryChunk::kScanningCard);
+      has_dirty_cards = true;
+    }
+  }
+  if (!has_dirty_cards) return;
+
+  if (chunk->owner() == heap_->lo_space()) {
+    LargePage* large_page = reinterpret_cast<LargePage*>(chunk);
+    HeapObject* array = large_page->GetObject();
+    ASSERT(array->IsFixedArray());
+    Address start = array->address();
+    Address end = start + array->Size();
+    FindPointersToNewSpaceInCards(start, end, slot_callback);
+  } else {
+    Page* page = reinterpret_cast<Page*>(chunk);
+    heap_->mark_compact_collector()->EnsurePageIsSwept(page);
+    FindPointersToNewSpaceOnPage(
+        reinterpret_cast<PagedSpace*>(page->owner()),
+        page,
+        &StoreBuffer::FindPointersToNewSpaceInCards,
+        slot_callback);
+  }
+
+  for (int i = 0; i < card_count; i++) {
+    if (chunk->card(i) == MemoryChunk::kScanningCard) {
+      chunk->set_card(i, MemoryChunk::kCleanCard);
+    }
+  }
+}
+
+
 void StoreBuffer::IteratePointersInStoreBuffer(
     ObjectSlotCallback slot_callback) {
   Address* limit = old_top_;
@@ -596,7 +701,8 @@ void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback slot_callback) {
   // keep the scan_on_scavenge flag on the page and discard the pointers that
   // were added to the store buffer.  If there are not many pointers to new
   // space left on the page we will keep the pointers in the store buffer and
-  // remove the flag from the page.
+  // remove the flag from the page.  Pages with a card table have their dirty
+  // cards scanned instead and never add anything to the store buffer.
   if (some_pages_to_scan) {
     if (callback_ != NULL) {
       (*callback_)(heap_, NULL, kStoreBufferStartScanningPagesEvent);
@@ -604,7 +710,9 @@ void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback slot_callback) {
     PointerChunkIterator it(heap_);
     MemoryChunk* chunk;
     while ((chunk = it.next()) != NULL) {
-      if (chunk->scan_on_scavenge()) {
+      if (chunk->uses_card_table()) {
+        FindPointersToNewSpaceInCardTable(chunk, slot_callback);
+      } else if (chunk->scan_on_scavenge()) {
         chunk->set_scan_on_scavenge(false);
         if (callback_ != NULL) {
           (*callback_)(heap_, chunk, kStoreBufferScanningPageEvent);
@@ -619,6 +727,9 @@ void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback slot_callback) {
         } else {
           Page* page = reinterpret_cast<Page*>(chunk);
           PagedSpace* owner = reinterpret_cast<PagedSpace*>(page->owner());
+          // The page is scanned word by word, which is only safe once the
+          // sweeper threads are done with it.
+          heap_->mark_compact_collector()->EnsurePageIsSwept(page);
           FindPointersToNewSpaceOnPage(
               owner,
               page,
@@ -120,8 +120,13 @@ class StoreBuffer {
   bool CellIsInStoreBuffer(Address cell);
 #endif
 
+  // Removes the entries on pages with the given flag.  The entries on pages
+  // with a card table are moved to their cards.
   void Filter(int flag);
 
+  // Removes the slots in [start, end[, whose memory is going away.
+  void RemoveSlots(Address start, Address end);
+
  private:
   Heap* heap_;
 
@@ -159,6 +164,15 @@ class StoreBuffer {
                                       Address end,
                                       ObjectSlotCallback slot_callback);
 
+  // Like FindPointersToNewSpaceInRegion, but only visits the parts of the
+  // region that are covered by a dirty card.
+  void FindPointersToNewSpaceInCards(Address start,
+                                     Address end,
+                                     ObjectSlotCallback slot_callback);
+
+  void FindPointersToNewSpaceInCardTable(MemoryChunk* chunk,
+                                         ObjectSlotCallback slot_callback);
+
   // For each region of pointers on a page in use from an old space call
   // visit_pointer_region callback.
   // If either visit_pointer_region or callback can cause an allocation
@@ -202,6 +202,38 @@ class StringSearch : private StringSearchBase {
 };
 
 
+// Returns the first position from index up to, but not including, limit
+// where the subject has the first character of the pattern, or -1.  Uses
+// memchr on ASCII subjects and FindUC16 on two-byte subjects.
+template <typename PatternChar, typename SubjectChar>
+inline int FindFirstCharacter(Vector<const PatternChar> pattern,
+                              Vector<const SubjectChar> subject,
+                              int index,
+                              int limit) {
+  ASSERT(index <= limit);
+  PatternChar pattern_first_char = pattern[0];
+  if (sizeof(PatternChar) > sizeof(SubjectChar)) {
+    if (static_cast<uc16>(pattern_first_char) > String::kMaxAsciiCharCodeU) {
+      return -1;
+    }
+  }
+  SubjectChar search_char = static_cast<SubjectChar>(pattern_first_char);
+  const SubjectChar* start = subject.start();
+  const SubjectChar* pos;
+  if (sizeof(SubjectChar) == 1) {
+    pos = reinterpret_cast<const SubjectChar*>(
+        memchr(start + index, search_char, limit - index));
+  } else {
+    pos = reinterpret_cast<const SubjectChar*>(
+        FindUC16(reinterpret_cast<const uc16*>(start + index),
+                 static_cast<uc16>(search_char),
+                 limit - index));
+  }
+  if (pos == NULL) return -1;
+  return static_cast<int>(pos - start);
+}
+
+
 //---------------------------------------------------------------------
 // Single Character Pattern Search Strategy
 //---------------------------------------------------------------------
@@ -212,28 +244,7 @@ int StringSearch<PatternChar, SubjectChar>::SingleCharSearch(
     Vector<const SubjectChar> subject,
     int index) {
   ASSERT_EQ(1, search->pattern_.length());
-  PatternChar pattern_first_char = search->pattern_[0];
-  int i = index;
-  if (sizeof(SubjectChar) == 1 && sizeof(PatternChar) == 1) {
-    const SubjectChar* pos = reinterpret_cast<const SubjectChar*>(
-        memchr(subject.start() + i,
-               pattern_first_char,
-               subject.length() - i));
-    if (pos == NULL) return -1;
-    return static_cast<int>(pos - subject.start());
-  } else {
-    if (sizeof(PatternChar) > sizeof(SubjectChar)) {
-      if (static_cast<uc16>(pattern_first_char) > String::kMaxAsciiCharCodeU) {
-        return -1;
-      }
-    }
-    SubjectChar search_char = static_cast<SubjectChar>(pattern_first_char);
-    int n = subject.length();
-    while (i < n) {
-      if (subject[i++] == search_char) return i - 1;
-    }
-    return -1;
-  }
+  return FindFirstCharacter(search->pattern_, subject, index, subject.length());
 }
 
 //---------------------------------------------------------------------
@@ -266,20 +277,12 @@ int StringSearch<PatternChar, SubjectChar>::LinearSearch(
   Vector<const PatternChar> pattern = search->pattern_;
   ASSERT(pattern.length() > 1);
   int pattern_length = pattern.length();
-  PatternChar pattern_first_char = pattern[0];
   int i = index;
   int n = subject.length() - pattern_length;
   while (i <= n) {
-    if (sizeof(SubjectChar) == 1 && sizeof(PatternChar) == 1) {
-      const SubjectChar* pos = reinterpret_cast<const SubjectChar*>(
-          memchr(subject.start() + i,
-                 pattern_first_char,
-                 n - i + 1));
-      if (pos == NULL) return -1;
-      i = static_cast<int>(pos - subject.start()) + 1;
-    } else {
-      if (subject[i++] != pattern_first_char) continue;
-    }
+    i = FindFirstCharacter(pattern, subject, i, n + 1);
+    if (i == -1) return -1;
+    i++;
     // Loop extracted to separate function to allow using return to do
     // a deeper break.
     if (CharCompare(pattern.start() + 1,
@@ -511,24 +514,14 @@ int StringSearch<PatternChar, SubjectChar>::InitialSearch(
   // algorithm.
   int badness = -10 - (pattern_length << 2);
 
-  // We know our pattern is at least 2 characters, we cache the first so
-  // the common case of the first character not matching is faster.
-  PatternChar pattern_first_char = pattern[0];
+  // We know our pattern is at least 2 characters, we skip to the next
+  // occurrence of the first so the common case of the first character not
+  // matching is faster.
   for (int i = index, n = subject.length() - pattern_length; i <= n; i++) {
     badness++;
     if (badness <= 0) {
-      if (sizeof(SubjectChar) == 1 && sizeof(PatternChar) == 1) {
-        const SubjectChar* pos = reinterpret_cast<const SubjectChar*>(
-            memchr(subject.start() + i,
-                   pattern_first_char,
-                   n - i + 1));
-        if (pos == NULL) {
-          return -1;
-        }
-        i = static_cast<int>(pos - subject.start());
-      } else {
-        if (subject[i] != pattern_first_char) continue;
-      }
+      i = FindFirstCharacter(pattern, subject, i, n + 1);
+      if (i == -1) return -1;
       int j = 1;
       do {
         if (pattern[j] != subject[i + j]) {
@@ -47,6 +47,7 @@
 // ECMA-262 section 15.5.4.2
 function StringToString() {
   if (!IS_STRING(this) && !IS_STRING_WRAPPER(this)) {
+    if (%IsStringBuffer(this)) return %StringBufferToString(this);
     throw new $TypeError('String.prototype.toString is not generic');
   }
   return %_ValueOf(this);
@@ -56,6 +57,7 @@ function StringToString() {
 // ECMA-262 section 15.5.4.3
 function StringValueOf() {
   if (!IS_STRING(this) && !IS_STRING_WRAPPER(this)) {
+    if (%IsStringBuffer(this)) return %StringBufferToString(this);
     throw new $TypeError('String.prototype.valueOf is not generic');
   }
   return %_ValueOf(this);
@@ -278,17 +280,16 @@ function StringReplace(search, replace) {
 // the result.
 function ExpandReplacement(string, subject, matchInfo, builder) {
   var length = string.length;
-  var builder_elements = builder.elements;
   var next = %StringIndexOf(string, '$', 0);
   if (next < 0) {
-    if (length > 0) builder_elements.push(string);
+    builder.add(string);
     return;
   }
 
   // Compute the number of captures; see ECMA-262, 15.5.4.11, p. 102.
   var m = NUMBER_OF_CAPTURES(matchInfo) >> 1;  // Includes the match.
 
-  if (next > 0) builder_elements.push(SubString(string, 0, next));
+  builder.addSlice(string, 0, next);
 
   while (true) {
     var expansion = '$';
@@ -297,7 +298,7 @@ function ExpandReplacement(string, subject, matchInfo, builder) {
       var peek = %_StringCharCodeAt(string, position);
       if (peek == 36) {         // $$
         ++position;
-        builder_elements.push('$');
+        builder.add('$');
       } else if (peek == 38) {  // $& - match
         ++position;
         builder.addSpecialSlice(matchInfo[CAPTURE0],
@@ -334,14 +335,14 @@ function ExpandReplacement(string, subject, matchInfo, builder) {
           // digit capture references, we can only enter here when a
           // single digit capture reference is outside the range of
           // captures.
-          builder_elements.push('$');
+          builder.add('$');
           --position;
         }
       } else {
-        builder_elements.push('$');
+        builder.add('$');
       }
     } else {
-      builder_elements.push('$');
+      builder.add('$');
     }
 
     // Go the the next $ in the string.
@@ -350,16 +351,12 @@ function ExpandReplacement(string, subject, matchInfo, builder) {
     // Return if there are no more $ characters in the string. If we
     // haven't reached the end, we need to append the suffix.
     if (next < 0) {
-      if (position < length) {
-        builder_elements.push(SubString(string, position, length));
-      }
+      builder.addSlice(string, position, length);
       return;
     }
 
     // Append substring between the previous and the next $ character.
-    if (next > position) {
-      builder_elements.push(SubString(string, position, next));
-    }
+    builder.addSlice(string, position, next);
   }
 }
 
@@ -456,8 +453,7 @@ function StringReplaceGlobalRegExpWithFunction(subject, regexp, replace) {
       i++;
     }
   }
-  var resultBuilder = new ReplaceResultBuilder(subject, res);
-  var result = resultBuilder.generate();
+  var result = %StringBuilderConcat(res, res.length, subject);
   resultArray.length = 0;
   reusableReplaceArray = resultArray;
   return result;
@@ -614,59 +610,11 @@ function StringSplit(separator, limit) {
     return [subject];
   }
 
-  var currentIndex = 0;
-  var startIndex = 0;
-  var startMatch = 0;
-  var result = [];
-
-  outer_loop:
-  while (true) {
-
-    if (startIndex === length) {
-      result.push(SubString(subject, currentIndex, length));
-      break;
-    }
-
-    var matchInfo = DoRegExpExec(separator, subject, startIndex);
-    if (matchInfo == null || length === (startMatch = matchInfo[CAPTURE0])) {
-      result.push(SubString(subject, currentIndex, length));
-      break;
-    }
-    var endIndex = matchInfo[CAPTURE1];
-
-    // We ignore a zero-length match at the currentIndex.
-    if (startIndex === endIndex && endIndex === currentIndex) {
-      startIndex++;
-      continue;
-    }
-
-    if (currentIndex + 1 == startMatch) {
-      result.push(%_StringCharAt(subject, currentIndex));
-    } else {
-      result.push(%_SubString(subject, currentIndex, startMatch));
-    }
-
-    if (result.length === limit) break;
-
-    var matchinfo_len = NUMBER_OF_CAPTURES(matchInfo) + REGEXP_FIRST_CAPTURE;
-    for (var i = REGEXP_FIRST_CAPTURE + 2; i < matchinfo_len; ) {
-      var start = matchInfo[i++];
-      var end = matchInfo[i++];
-      if (end != -1) {
-        if (start + 1 == end) {
-          result.push(%_StringCharAt(subject, start));
-        } else {
-          result.push(%_SubString(subject, start, end));
-        }
-      } else {
-        result.push(void 0);
-      }
-      if (result.length === limit) break outer_loop;
-    }
-
-    startIndex = currentIndex = endIndex;
-  }
-  return result;
+  // lastMatchInfo is defined in regexp.js.
+  var parts = %RegExpSplit(subject, separator, limit, lastMatchInfo);
+  if (IS_NULL(parts)) return [subject];
+  lastMatchInfoOverride = null;
+  return parts;
 }
 
 
@@ -916,37 +864,42 @@ function StringSup() {
 
 
 // ReplaceResultBuilder support.
+// The result is accumulated in a native buffer that is sized for a result
+// about as long as the subject and grows as needed.
 function ReplaceResultBuilder(str) {
-  if (%_ArgumentsLength() > 1) {
-    this.elements = %_Arguments(1);
-  } else {
-    this.elements = new InternalArray();
-  }
+  this.buffer = %StringBuilderNew(str.length);
+  this.length = 0;
   this.special_string = str;
 }
 
 SetUpLockedPrototype(ReplaceResultBuilder,
-  $Array("elements", "special_string"), $Array(
+  $Array("buffer", "length", "special_string"), $Array(
   "add", function(str) {
     str = TO_STRING_INLINE(str);
-    if (str.length > 0) this.elements.push(str);
+    var len = str.length;
+    if (len > 0) {
+      this.buffer = %StringBuilderAppend(this.buffer, this.length, str, 0, len);
+      this.length += len;
+    }
+  },
+  "addSlice", function(str, start, end) {
+    // The str argument must be a string.
+    var len = end - start;
+    if (len > 0) {
+      this.buffer = %StringBuilderAppend(this.buffer, this.length,
+                                         str, start, end);
+      this.length += len;
+    }
   },
   "addSpecialSlice", function(start, end) {
     var len = end - start;
     if (start < 0 || len <= 0) return;
-    if (start < 0x80000 && len < 0x800) {
-      this.elements.push((start << 11) | len);
-    } else {
-      // 0 < len <= String::kMaxLength and Smi::kMaxValue >= String::kMaxLength,
-      // so -len is a smi.
-      var elements = this.elements;
-      elements.push(-len);
-      elements.push(start);
-    }
+    this.buffer = %StringBuilderAppend(this.buffer, this.length,
+                                       this.special_string, start, end);
+    this.length += len;
   },
   "generate", function() {
-    var elements = this.elements;
-    return %StringBuilderConcat(elements, elements.length, this.special_string);
+    return %StringBuilderFinish(this.buffer, this.length);
   }
 ));
 
@@ -0,0 +1,541 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "hashmap.h"
+#include "list-inl.h"
+
+namespace v8 {
+namespace internal {
+
+// The serialized form is a sequence of tagged values.  Objects are numbered
+// in the order they are written, and later occurrences of the same object
+// are written as a reference to that number.  Integers and doubles are
+// stored in native byte order since the data never leaves the process.
+enum CloneTag {
+  kCloneUndefined = '_',
+  kCloneNull = '0',
+  kCloneTrue = 'T',
+  kCloneFalse = 'F',
+  kCloneInt32 = 'I',
+  kCloneDouble = 'N',
+  kCloneString = 'S',
+  kCloneDate = 'D',
+  // Property count, then key/value pairs.
+  kCloneObject = '{',
+  // Length, then the elements.
+  kCloneArray = '[',
+  // A missing array element.
+  kCloneHole = '-',
+  // Type, length and the data, then the properties as for kCloneObject.
+  kCloneExternalArray = 'X',
+  // Type, length and the index of a transferred backing store, then the
+  // properties as for kCloneObject.
+  kCloneTransferredArray = 'Y',
+  // The number of an object that was written before.
+  kCloneReference = '^'
+};
+
+
+// Deeper graphs are rejected instead of overflowing the C++ stack.
+static const int kMaxCloneDepth = 1000;
+
+
+static int ExternalArrayElementSize(v8::ExternalArrayType type) {
+  switch (type) {
+    case v8::kExternalByteArray:
+    case v8::kExternalUnsignedByteArray:
+    case v8::kExternalPixelArray:
+      return 1;
+    case v8::kExternalShortArray:
+    case v8::kExternalUnsignedShortArray:
+      return 2;
+    case v8::kExternalIntArray:
+    case v8::kExternalUnsignedIntArray:
+    case v8::kExternalFloatArray:
+      return 4;
+    case v8::kExternalDoubleArray:
+      return 8;
+  }
+  UNREACHABLE();
+  return 0;
+}
+
+
+class CloneWriter {
+ public:
+  explicit CloneWriter(v8::Handle<v8::Array> transfer)
+      : transfer_(transfer),
+        object_map_(KeysMatch) { }
+
+  // Returns false if the value cannot be cloned.  An exception is pending
+  // afterwards, either from a getter or the one thrown by the writer.
+  bool WriteValue(v8::Handle<v8::Value> value, int depth);
+
+  // Detaches the backing stores of the transferred arrays from their
+  // source objects.  Only called once the whole value has been written.
+  void DetachTransferred();
+
+  List<uint8_t>* buffer() { return &buffer_; }
+  List<void*>* transferred() { return &transferred_; }
+
+ private:
+  template <typename T>
+  void WriteRaw(T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    for (size_t i = 0; i < sizeof(value); i++) buffer_.Add(bytes[i]);
+  }
+
+  void WriteTag(CloneTag tag) { buffer_.Add(static_cast<uint8_t>(tag)); }
+  void WriteString(v8::Handle<v8::String> string);
+  bool WriteObject(v8::Handle<v8::Object> object, int depth);
+  bool WriteProperties(v8::Handle<v8::Object> object, int depth,
+                       int skip_indices_below);
+
+  // Returns the number of an object written before, or -1.  New objects
+  // are numbered and remembered.
+  int LookupOrRemember(v8::Handle<v8::Object> object);
+
+  // Returns the position of |object| in the transfer list, or -1.
+  int TransferIndex(v8::Handle<v8::Object> object);
+
+  static bool KeysMatch(void* key1, void* key2) { return key1 == key2; }
+
+  bool Fail(const char* message) {
+    v8::ThrowException(v8::Exception::Error(v8::String::New(message)));
+    return false;
+  }
+
+  v8::Handle<v8::Array> transfer_;
+  List<uint8_t> buffer_;
+  List<void*> transferred_;
+  List<v8::Handle<v8::Object> > transferred_objects_;
+
+  // Objects written so far, with a hash map from identity hash to the most
+  // recent object with that hash and a chain to the earlier ones.
+  List<v8::Handle<v8::Object> > objects_;
+  List<int> object_chain_;
+  HashMap object_map_;
+};
+
+
+int CloneWriter::LookupOrRemember(v8::Handle<v8::Object> object) {
+  uint32_t hash = static_cast<uint32_t>(object->GetIdentityHash());
+  void* key = reinterpret_cast<void*>(static_cast<uintptr_t>(hash) + 1);
+  HashMap::Entry* entry = object_map_.Lookup(key, hash, true);
+  int previous = -1;
+  if (entry->value != NULL) {
+    previous = static_cast<int>(reinterpret_cast<intptr_t>(entry->value)) - 1;
+    for (int index = previous; index >= 0; index = object_chain_[index]) {
+      if (objects_[index]->StrictEquals(object)) return index;
+    }
+  }
+  objects_.Add(object);
+  object_chain_.Add(previous);
+  entry->value = reinterpret_cast<void*>(
+      static_cast<intptr_t>(objects_.length()));
+  return -1;
+}
+
+
+int CloneWriter::TransferIndex(v8::Handle<v8::Object> object) {
+  if (transfer_.IsEmpty()) return -1;
+  for (uint32_t i = 0; i < transfer_->Length(); i++) {
+    if (transfer_->Get(i)->StrictEquals(object)) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+
+void CloneWriter::WriteString(v8::Handle<v8::String> string) {
+  int length = string->Length();
+  WriteTag(kCloneString);
+  WriteRaw<int32_t>(length);
+  int start = buffer_.length();
+  for (int i = 0; i < length * 2; i++) buffer_.Add(0);
+  // The buffer may not be aligned for uint16_t, so write through a copy.
+  ScopedVector<uint16_t> chars(length + 1);
+  string->Write(chars.start(), 0, length, v8::String::NO_NULL_TERMINATION);
+  memcpy(&buffer_[start], chars.start(), length * sizeof(uint16_t));
+}
+
+
+bool CloneWriter::WriteValue(v8::Handle<v8::Value> value, int depth) {
+  if (value->IsUndefined()) {
+    WriteTag(kCloneUndefined);
+  } else if (value->IsNull()) {
+    WriteTag(kCloneNull);
+  } else if (value->IsTrue()) {
+    WriteTag(kCloneTrue);
+  } else if (value->IsFalse()) {
+    WriteTag(kCloneFalse);
+  } else if (value->IsInt32()) {
+    WriteTag(kCloneInt32);
+    WriteRaw<int32_t>(value->Int32Value());
+  } else if (value->IsNumber()) {
+    WriteTag(kCloneDouble);
+    WriteRaw<double>(value->NumberValue());
+  } else if (value->IsString()) {
+    WriteString(value.As<v8::String>());
+  } else if (value->IsObject()) {
+    if (depth >= kMaxCloneDepth) return Fail("Object graph is too deep");
+    return WriteObject(value.As<v8::Object>(), depth + 1);
+  } else {
+    return Fail("Value cannot be cloned");
+  }
+  return true;
+}
+
+
+bool CloneWriter::WriteObject(v8::Handle<v8::Object> object, int depth) {
+  if (object->IsFunction()) return Fail("Functions cannot be cloned");
+  if (object->InternalFieldCount() > 0) {
+    return Fail("Host objects cannot be cloned");
+  }
+  int reference = LookupOrRemember(object);
+  if (reference >= 0) {
+    WriteTag(kCloneReference);
+    WriteRaw<int32_t>(reference);
+    return true;
+  }
+
+  if (object->IsDate()) {
+    WriteTag(kCloneDate);
+    WriteRaw<double>(object->NumberValue());
+    return true;
+  }
+
+  if (object->IsArray()) {
+    v8::Handle<v8::Array> array = object.As<v8::Array>();
+    uint32_t length = array->Length();
+    WriteTag(kCloneArray);
+    WriteRaw<uint32_t>(length);
+    for (uint32_t i = 0; i < length; i++) {
+      if (!array->HasRealIndexedProperty(i)) {
+        WriteTag(kCloneHole);
+        continue;
+      }
+      v8::Handle<v8::Value> element = array->Get(i);
+      if (element.IsEmpty() || !WriteValue(element, depth)) return false;
+    }
+    return true;
+  }
+
+  int skip_indices_below = 0;
+  if (object->HasIndexedPropertiesInExternalArrayData()) {
+    v8::ExternalArrayType type =
+        object->GetIndexedPropertiesExternalArrayDataType();
+    int length = object->GetIndexedPropertiesExternalArrayDataLength();
+    void* data = object->GetIndexedPropertiesExternalArrayData();
+    int transfer_index = TransferIndex(object);
+    if (transfer_index >= 0) {
+      WriteTag(kCloneTransferredArray);
+      WriteRaw<int32_t>(type);
+      WriteRaw<int32_t>(length);
+      WriteRaw<int32_t>(transferred_.length());
+      transferred_.Add(data);
+      transferred_objects_.Add(object);
+    } else {
+      int size = length * ExternalArrayElementSize(type);
+      WriteTag(kCloneExternalArray);
+      WriteRaw<int32_t>(type);
+      WriteRaw<int32_t>(length);
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      for (int i = 0; i < size; i++) buffer_.Add(bytes[i]);
+    }
+    // The elements are the array data, so only named properties follow.
+    skip_indices_below = length;
+  } else {
+    WriteTag(kCloneObject);
+  }
+  return WriteProperties(object, depth, skip_indices_below);
+}
+
+
+bool CloneWriter::WriteProperties(v8::Handle<v8::Object> object, int depth,
+                                  int skip_indices_below) {
+  v8::Handle<v8::Array> names = object->GetOwnPropertyNames();
+  if (names.IsEmpty()) return false;
+  // The count is patched once the skipped indices are known.
+  int count_position = buffer_.length();
+  WriteRaw<int32_t>(0);
+  int32_t count = 0;
+  for (uint32_t i = 0; i < names->Length(); i++) {
+    v8::Handle<v8::Value> name = names->Get(i);
+    if (name.IsEmpty()) return false;
+    if (skip_indices_below > 0) {
+      v8::Local<v8::Uint32> index = name->ToArrayIndex();
+      if (!index.IsEmpty() &&
+          index->Value() < static_cast<uint32_t>(skip_indices_below)) {
+        continue;
+      }
+    }
+    v8::Handle<v8::Value> value = object->Get(name);
+    if (value.IsEmpty()) return false;
+    if (!WriteValue(name, depth) || !WriteValue(value, depth)) return false;
+    count++;
+  }
+  memcpy(&buffer_[count_position], &count, sizeof(count));
+  return true;
+}
+
+
+void CloneWriter::DetachTransferred() {
+  for (int i = 0; i < transferred_objects_.length(); i++) {
+    v8::Handle<v8::Object> object = transferred_objects_[i];
+    object->SetIndexedPropertiesToExternalArrayData(
+        NULL, object->GetIndexedPropertiesExternalArrayDataType(), 0);
+  }
+}
+
+
+class CloneReader {
+ public:
+  CloneReader(const uint8_t* data, int length,
+              void** transferred, int transferred_count,
+              v8::StructuredClone::Delegate* delegate)
+      : data_(data),
+        end_(data + length),
+        transferred_(transferred),
+        transferred_count_(transferred_count),
+        delegate_(delegate) { }
+
+  // Returns an empty handle if the data is malformed.
+  v8::Local<v8::Value> ReadValue();
+
+ private:
+  template <typename T>
+  bool ReadRaw(T* value) {
+    if (end_ - data_ < static_cast<int>(sizeof(T))) return false;
+    memcpy(value, data_, sizeof(T));
+    data_ += sizeof(T);
+    return true;
+  }
+
+  v8::Local<v8::Value> ReadString();
+  v8::Local<v8::Value> ReadExternalArray(bool transferred);
+  bool ReadProperties(v8::Handle<v8::Object> object);
+
+  const uint8_t* data_;
+  const uint8_t* end_;
+  void** transferred_;
+  int transferred_count_;
+  v8::StructuredClone::Delegate* delegate_;
+  List<v8::Local<v8::Object> > objects_;
+};
+
+
+v8::Local<v8::Value> CloneReader::ReadString() {
+  int32_t length;
+  if (!ReadRaw(&length) || length < 0 ||
+      end_ - data_ < length * static_cast<int>(sizeof(uint16_t))) {
+    return v8::Local<v8::Value>();
+  }
+  ScopedVector<uint16_t> chars(length + 1);
+  memcpy(chars.start(), data_, length * sizeof(uint16_t));
+  data_ += length * sizeof(uint16_t);
+  return v8::String::New(chars.start(), length);
+}
+
+
+v8::Local<v8::Value> CloneReader::ReadExternalArray(bool transferred) {
+  int32_t type;
+  int32_t length;
+  if (!ReadRaw(&type) || !ReadRaw(&length) || length < 0 ||
+      type < v8::kExternalByteArray || type > v8::kExternalPixelArray) {
+    return v8::Local<v8::Value>();
+  }
+  v8::ExternalArrayType array_type = static_cast<v8::ExternalArrayType>(type);
+  void* store;
+  if (transferred) {
+    int32_t index;
+    if (!ReadRaw(&index) || index < 0 || index >= transferred_count_ ||
+        transferred_[index] == NULL) {
+      return v8::Local<v8::Value>();
+    }
+    store = transferred_[index];
+    // The store now belongs to the new object.
+    transferred_[index] = NULL;
+  } else {
+    int size = length * ExternalArrayElementSize(array_type);
+    if (end_ - data_ < size) return v8::Local<v8::Value>();
+    store = delegate_->AllocateExternalArrayData(size);
+    memcpy(store, data_, size);
+    data_ += size;
+  }
+  v8::Local<v8::Object> object = v8::Object::New();
+  objects_.Add(object);
+  object->SetIndexedPropertiesToExternalArrayData(store, array_type, length);
+  delegate_->ExternalArrayCreated(object, store);
+  if (!ReadProperties(object)) return v8::Local<v8::Value>();
+  return object;
+}
+
+
+bool CloneReader::ReadProperties(v8::Handle<v8::Object> object) {
+  int32_t count;
+  if (!ReadRaw(&count)) return false;
+  for (int32_t i = 0; i < count; i++) {
+    v8::Local<v8::Value> name = ReadValue();
+    if (name.IsEmpty()) return false;
+    v8::Local<v8::Value> value = ReadValue();
+    if (value.IsEmpty()) return false;
+    object->Set(name, value);
+  }
+  return true;
+}
+
+
+v8::Local<v8::Value> CloneReader::ReadValue() {
+  uint8_t tag;
+  if (!ReadRaw(&tag)) return v8::Local<v8::Value>();
+  switch (tag) {
+    case kCloneUndefined:
+      return v8::Local<v8::Value>::New(v8::Undefined());
+    case kCloneNull:
+      return v8::Local<v8::Value>::New(v8::Null());
+    case kCloneTrue:
+      return v8::Local<v8::Value>::New(v8::True());
+    case kCloneFalse:
+      return v8::Local<v8::Value>::New(v8::False());
+    case kCloneInt32: {
+      int32_t value;
+      if (!ReadRaw(&value)) break;
+      return v8::Integer::New(value);
+    }
+    case kCloneDouble: {
+      double value;
+      if (!ReadRaw(&value)) break;
+      return v8::Number::New(value);
+    }
+    case kCloneString:
+      return ReadString();
+    case kCloneDate: {
+      double time;
+      if (!ReadRaw(&time)) break;
+      v8::Local<v8::Value> date = v8::Date::New(time);
+      objects_.Add(date.As<v8::Object>());
+      return date;
+    }
+    case kCloneObject: {
+      v8::Local<v8::Object> object = v8::Object::New();
+      objects_.Add(object);
+      if (!ReadProperties(object)) break;
+      return object;
+    }
+    case kCloneArray: {
+      uint32_t length;
+      if (!ReadRaw(&length)) break;
+      v8::Local<v8::Array> array =
+          v8::Array::New(static_cast<int>(Min<uint32_t>(length, kMaxInt)));
+      objects_.Add(array);
+      for (uint32_t i = 0; i < length; i++) {
+        if (data_ < end_ && *data_ == kCloneHole) {
+          data_++;
+          continue;
+        }
+        v8::Local<v8::Value> element = ReadValue();
+        if (element.IsEmpty()) return element;
+        array->Set(i, element);
+      }
+      return array;
+    }
+    case kCloneExternalArray:
+      return ReadExternalArray(false);
+    case kCloneTransferredArray:
+      return ReadExternalArray(true);
+    case kCloneReference: {
+      int32_t index;
+      if (!ReadRaw(&index) || index < 0 || index >= objects_.length()) break;
+      return objects_[index];
+    }
+  }
+  return v8::Local<v8::Value>();
+}
+
+}  // namespace internal
+
+
+StructuredClone::StructuredClone(uint8_t* data, int length,
+                                 void** transferred, int transferred_count,
+                                 Delegate* delegate)
+    : data_(data),
+      length_(length),
+      transferred_(transferred),
+      transferred_count_(transferred_count),
+      delegate_(delegate) {
+}
+
+
+StructuredClone::~StructuredClone() {
+  for (int i = 0; i < transferred_count_; i++) {
+    if (transferred_[i] != NULL) {
+      delegate_->FreeExternalArrayData(transferred_[i]);
+    }
+  }
+  i::DeleteArray(transferred_);
+  i::DeleteArray(data_);
+}
+
+
+StructuredClone* StructuredClone::Serialize(Handle<Value> value,
+                                            Handle<Array> transfer,
+                                            Delegate* delegate) {
+  HandleScope scope;
+  i::CloneWriter writer(transfer);
+  if (!writer.WriteValue(value, 0)) return NULL;
+  writer.DetachTransferred();
+
+  i::List<uint8_t>* buffer = writer.buffer();
+  uint8_t* data = i::NewArray<uint8_t>(buffer->length());
+  if (buffer->length() > 0) {
+    memcpy(data, &buffer->first(), buffer->length());
+  }
+  i::List<void*>* transferred = writer.transferred();
+  void** stores = i::NewArray<void*>(transferred->length());
+  for (int i = 0; i < transferred->length(); i++) {
+    stores[i] = transferred->at(i);
+  }
+  return new StructuredClone(data, buffer->length(),
+                             stores, transferred->length(), delegate);
+}
+
+
+Local<Value> StructuredClone::Deserialize() {
+  HandleScope scope;
+  i::CloneReader reader(data_, length_, transferred_, transferred_count_,
+                        delegate_);
+  Local<Value> result = reader.ReadValue();
+  if (result.IsEmpty()) {
+    ThrowException(Exception::Error(String::New("Malformed clone data")));
+    return Local<Value>();
+  }
+  return scope.Close(result);
+}
+
+}  // namespace v8
@@ -43,24 +43,39 @@ namespace internal {
 // StubCache implementation.
 
 
-StubCache::StubCache(Isolate* isolate) : isolate_(isolate) {
+StubCache::StubCache(Isolate* isolate, int primary_size)
+    : isolate_(isolate) {
   ASSERT(isolate == Isolate::Current());
-  memset(primary_, 0, sizeof(primary_[0]) * StubCache::kPrimaryTableSize);
-  memset(secondary_, 0, sizeof(secondary_[0]) * StubCache::kSecondaryTableSize);
+  primary_size = Max(primary_size, kMinPrimaryTableSize);
+  primary_size = Min(primary_size, kMaxPrimaryTableSize);
+  primary_size_ = static_cast<int>(RoundUpToPowerOf2(primary_size));
+  secondary_size_ = primary_size_ / 4;
+  primary_mask_ = (primary_size_ - 1) << kHeapObjectTagSize;
+  secondary_mask_ = (secondary_size_ - 1) << kHeapObjectTagSize;
+  primary_ = NewArray<Entry>(primary_size_);
+  secondary_ = NewArray<Entry>(secondary_size_);
+  memset(primary_, 0, sizeof(primary_[0]) * primary_size_);
+  memset(secondary_, 0, sizeof(secondary_[0]) * secondary_size_);
+}
+
+
+StubCache::~StubCache() {
+  DeleteArray(primary_);
+  DeleteArray(secondary_);
 }
 
 
 void StubCache::Initialize(bool create_heap_objects) {
-  ASSERT(IsPowerOf2(kPrimaryTableSize));
-  ASSERT(IsPowerOf2(kSecondaryTableSize));
+  ASSERT(IsPowerOf2(primary_size_));
+  ASSERT(IsPowerOf2(secondary_size_));
   if (create_heap_objects) {
     HandleScope scope;
     Code* empty = isolate_->builtins()->builtin(Builtins::kIllegal);
-    for (int i = 0; i < kPrimaryTableSize; i++) {
+    for (int i = 0; i < primary_size_; i++) {
       primary_[i].key = heap()->empty_string();
       primary_[i].value = empty;
     }
-    for (int j = 0; j < kSecondaryTableSize; j++) {
+    for (int j = 0; j < secondary_size_; j++) {
       secondary_[j].key = heap()->empty_string();
       secondary_[j].value = empty;
     }
@@ -94,13 +109,18 @@ Code* StubCache::Set(String* name, Map* map, Code* code) {
 
   // If the primary entry has useful data in it, we retire it to the
   // secondary cache before overwriting it.
-  if (hit != isolate_->builtins()->builtin(Builtins::kIllegal)) {
+  Code* empty = isolate_->builtins()->builtin(Builtins::kIllegal);
+  if (hit != empty) {
     Code::Flags primary_flags = Code::RemoveTypeFromFlags(hit->flags());
     int secondary_offset =
         SecondaryOffset(primary->key, primary_flags, primary_offset);
     Entry* secondary = entry(secondary_, secondary_offset);
+    if (secondary->value != empty) {
+      isolate_->counters()->stub_cache_evictions()->Increment();
+    }
     *secondary = *primary;
   }
+  isolate_->counters()->stub_cache_updates()->Increment();
 
   // Update primary cache.
   primary->key = name;
@@ -864,11 +884,11 @@ Handle<Code> StubCache::ComputeCallDebugPrepareStepIn(int argc,
 
 void StubCache::Clear() {
   Code* empty = isolate_->builtins()->builtin(Builtins::kIllegal);
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_size_; i++) {
     primary_[i].key = heap()->empty_string();
     primary_[i].value = empty;
   }
-  for (int j = 0; j < kSecondaryTableSize; j++) {
+  for (int j = 0; j < secondary_size_; j++) {
     secondary_[j].key = heap()->empty_string();
     secondary_[j].value = empty;
   }
@@ -878,7 +898,7 @@ void StubCache::Clear() {
 void StubCache::CollectMatchingMaps(SmallMapList* types,
                                     String* name,
                                     Code::Flags flags) {
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_size_; i++) {
     if (primary_[i].key == name) {
       Map* map = primary_[i].value->FindFirstMap();
       // Map can be NULL, if the stub is constant function call
@@ -892,7 +912,7 @@ void StubCache::CollectMatchingMaps(SmallMapList* types,
     }
   }
 
-  for (int i = 0; i < kSecondaryTableSize; i++) {
+  for (int i = 0; i < secondary_size_; i++) {
     if (secondary_[i].key == name) {
       Map* map = secondary_[i].value->FindFirstMap();
       // Map can be NULL, if the stub is constant function call
@@ -1304,6 +1324,19 @@ void StubCompiler::LookupPostInterceptor(Handle<JSObject> holder,
 }
 
 
+FieldRepresentation StubCompiler::GetFieldRepresentation(Map* map,
+                                                         int index) {
+  DescriptorArray* descriptors = map->instance_descriptors();
+  for (int i = 0; i < descriptors->number_of_descriptors(); i++) {
+    if (descriptors->GetType(i) == FIELD &&
+        descriptors->GetFieldIndex(i) == index) {
+      return PropertyDetails(descriptors->GetDetails(i)).representation();
+    }
+  }
+  return TAGGED_FIELD;
+}
+
+
 Handle<Code> LoadStubCompiler::GetCode(PropertyType type, Handle<String> name) {
   Code::Flags flags = Code::ComputeMonomorphicFlags(Code::LOAD_IC, type);
   Handle<Code> code = GetCodeWithFlags(flags, name);
@@ -1494,6 +1527,9 @@ void CallOptimization::AnalyzePossibleApiFunction(Handle<JSFunction> function) {
   if (info->call_code()->IsUndefined()) return;
   api_call_info_ =
       Handle<CallHandlerInfo>(CallHandlerInfo::cast(info->call_code()));
+  // Typed fast calls are dispatched by the HandleApiCall builtin, which a
+  // fast API call stub would bypass.
+  if (!api_call_info_->fast_callback()->IsUndefined()) return;
 
   // Accept signatures that either have no restrictions at all or
   // only have restrictions on the receiver.
@@ -279,6 +279,20 @@ class StubCache {
   }
 
 
+  // The generated probing code loads the hash masks from memory, so that
+  // code compiled into the snapshot works with any table size.
+  SCTableReference mask_reference(StubCache::Table table) {
+    switch (table) {
+      case StubCache::kPrimary:
+        return SCTableReference(reinterpret_cast<Address>(&primary_mask_));
+      case StubCache::kSecondary:
+        return SCTableReference(reinterpret_cast<Address>(&secondary_mask_));
+    }
+    UNREACHABLE();
+    return SCTableReference(NULL);
+  }
+
+
   StubCache::Entry* first_entry(StubCache::Table table) {
     switch (table) {
       case StubCache::kPrimary: return StubCache::primary_;
@@ -288,19 +302,30 @@ class StubCache {
     return NULL;
   }
 
+  int primary_size() const { return primary_size_; }
+  int secondary_size() const { return secondary_size_; }
+
   Isolate* isolate() { return isolate_; }
   Heap* heap() { return isolate()->heap(); }
   Factory* factory() { return isolate()->factory(); }
 
+  // Bounds for the number of primary table entries.  The secondary table
+  // has a quarter of the primary table's entries.
+  static const int kMinPrimaryTableSize = 64;
+  static const int kMaxPrimaryTableSize = 1 << 20;
+
  private:
-  explicit StubCache(Isolate* isolate);
+  // The primary table size is rounded up to a power of two and clamped to
+  // the bounds above.
+  StubCache(Isolate* isolate, int primary_size);
+  ~StubCache();
 
   Handle<Code> ComputeCallInitialize(int argc,
                                      RelocInfo::Mode mode,
                                      Code::Kind kind);
 
   // Computes the hashed offsets for primary and secondary caches.
-  static int PrimaryOffset(String* name, Code::Flags flags, Map* map) {
+  int PrimaryOffset(String* name, Code::Flags flags, Map* map) {
     // This works well because the heap object tag size and the hash
     // shift are equal.  Shifting down the length field to get the
     // hash code would effectively throw away two bits of the hash
@@ -320,15 +345,15 @@ class StubCache {
         (static_cast<uint32_t>(flags) & ~Code::kFlagsNotUsedInLookup);
     // Base the offset on a simple combination of name, flags, and map.
     uint32_t key = (map_low32bits + field) ^ iflags;
-    return key & ((kPrimaryTableSize - 1) << kHeapObjectTagSize);
+    return key & primary_mask_;
   }
 
-  static int SecondaryOffset(String* name, Code::Flags flags, int seed) {
+  int SecondaryOffset(String* name, Code::Flags flags, int seed) {
     // Use the seed from the primary cache in the secondary cache.
     uint32_t string_low32bits =
         static_cast<uint32_t>(reinterpret_cast<uintptr_t>(name));
     uint32_t key = seed - string_low32bits + flags;
-    return key & ((kSecondaryTableSize - 1) << kHeapObjectTagSize);
+    return key & secondary_mask_;
   }
 
   // Compute the entry for a given offset in exactly the same way as
@@ -342,11 +367,13 @@ class StubCache {
         reinterpret_cast<Address>(table) + (offset << shift_amount));
   }
 
-  static const int kPrimaryTableSize = 2048;
-  static const int kSecondaryTableSize = 512;
-
-  Entry primary_[kPrimaryTableSize];
-  Entry secondary_[kSecondaryTableSize];
+  Entry* primary_;
+  Entry* secondary_;
+  int primary_size_;
+  int secondary_size_;
+  // (size - 1) << kHeapObjectTagSize for the respective table.
+  uint32_t primary_mask_;
+  uint32_t secondary_mask_;
   Isolate* isolate_;
 
   friend class Isolate;
@@ -415,6 +442,11 @@ class StubCompiler BASE_EMBEDDED {
                                        Handle<JSObject> holder,
                                        int index);
 
+  // Returns the representation of the field with the given field index in
+  // the map's descriptors.  Stubs loading from or storing to a double or
+  // mixed field have to copy or update the mutable heap number it holds.
+  static FieldRepresentation GetFieldRepresentation(Map* map, int index);
+
   static void GenerateLoadArrayLength(MacroAssembler* masm,
                                       Register receiver,
                                       Register scratch,
@@ -0,0 +1,399 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Prints the statistical profile of a log written with --prof --prof-binary,
+// in the format of tools/tickprocessor.js:
+//
+//   tick-processor [v8.log.bin]
+//
+// The code map and the bottom up profile are the CodeMap and ProfileTree of
+// the CPU profiler.  Shared libraries are reported as a whole, because the
+// processor does not read their symbol tables, so there is no C++ section.
+
+#include <stdio.h>
+
+#include "v8.h"
+
+#include "profile-generator-inl.h"
+
+namespace i = v8::internal;
+
+namespace v8 {
+namespace internal {
+
+
+static const char* const kTagNames[Logger::NUMBER_OF_LOG_EVENTS] = {
+#define DECLARE_TAG_NAME(ignore, name) name,
+  LOG_EVENTS_AND_TAGS_LIST(DECLARE_TAG_NAME)
+#undef DECLARE_TAG_NAME
+};
+
+// Callers with a smaller share of their parent's ticks are not shown.
+static const double kCallProfileCutoffPercent = 2.0;
+
+// Depth limit of the bottom up profile.
+static const int kMaxHeavyProfileIndent = 10;
+
+
+// Reads the records of a --prof-binary log, see BinaryLogFormat.
+class BinaryLogReader {
+ public:
+  explicit BinaryLogReader(FILE* file)
+      : file_(file), previous_address_(0), error_(false) { }
+
+  bool ReadHeader() {
+    char magic[BinaryLogFormat::kMagicSize];
+    if (fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+        memcmp(magic, BinaryLogFormat::kMagic, sizeof(magic)) != 0) {
+      return false;
+    }
+    return getc(file_) == kPointerSize;
+  }
+
+  // Returns the type of the next record, or -1 at the end of the file.
+  int ReadRecordType() {
+    previous_address_ = 0;
+    return getc(file_);
+  }
+
+  uintptr_t ReadUnsigned() {
+    uintptr_t value = 0;
+    for (int shift = 0; shift < kBitsPerPointer; shift += 7) {
+      int c = getc(file_);
+      if (c == EOF) {
+        error_ = true;
+        return 0;
+      }
+      value |= static_cast<uintptr_t>(c & 0x7f) << shift;
+      if ((c & 0x80) == 0) break;
+    }
+    return value;
+  }
+
+  Address ReadAddress() {
+    uintptr_t zigzag = ReadUnsigned();
+    intptr_t delta = static_cast<intptr_t>(zigzag >> 1) ^
+                     -static_cast<intptr_t>(zigzag & 1);
+    previous_address_ += delta;
+    return reinterpret_cast<Address>(previous_address_);
+  }
+
+  // Reads a name into the buffer and terminates it.
+  void ReadName(Vector<char> buffer) {
+    int length = static_cast<int>(ReadUnsigned());
+    int kept = Min(length, buffer.length() - 1);
+    if (fread(buffer.start(), 1, kept, file_) != static_cast<size_t>(kept)) {
+      error_ = true;
+      kept = 0;
+    }
+    buffer[kept] = '\0';
+    for (int i = kept; i < length; i++) getc(file_);
+  }
+
+  bool error() const { return error_; }
+
+ private:
+  FILE* file_;
+  intptr_t previous_address_;
+  bool error_;
+};
+
+
+class TickProcessor {
+ public:
+  TickProcessor() : total_ticks_(0), unaccounted_ticks_(0), gc_ticks_(0) { }
+
+  ~TickProcessor() {
+    for (int i = 0; i < entries_.length(); i++) delete entries_[i];
+  }
+
+  bool ProcessLog(FILE* file);
+  void PrintStatistics(const char* file_name);
+
+ private:
+  CodeEntry* NewEntry(Logger::LogEventsAndTags tag, const char* name) {
+    CodeEntry* entry = new CodeEntry(tag,
+                                     CodeEntry::kEmptyNamePrefix,
+                                     names_.GetCopy(name),
+                                     "",
+                                     v8::CpuProfileNode::kNoLineNumberInfo,
+                                     TokenEnumerator::kNoSecurityToken);
+    entries_.Add(entry);
+    return entry;
+  }
+
+  bool IsSharedLibrary(CodeEntry* entry) {
+    return libraries_.Contains(entry);
+  }
+
+  void ProcessTick(int state, bool has_external_callback, Address pc,
+                   Address tos_or_callback, const Vector<Address>& frames);
+
+  void PrintHeader(const char* title);
+  void PrintCounter(int ticks);
+  void PrintEntries(const List<ProfileNode*>& nodes, int non_library_ticks,
+                    bool libraries);
+  void PrintHeavyProfile(ProfileNode* parent, int parent_ticks, int indent);
+
+  CodeMap code_map_;
+  ProfileTree bottom_up_;
+  StringsStorage names_;
+  List<CodeEntry*> entries_;
+  List<CodeEntry*> libraries_;
+  int total_ticks_;
+  int unaccounted_ticks_;
+  int gc_ticks_;
+};
+
+
+bool TickProcessor::ProcessLog(FILE* file) {
+  BinaryLogReader reader(file);
+  if (!reader.ReadHeader()) {
+    fprintf(stderr, "Not a --prof-binary log of this architecture.\n");
+    return false;
+  }
+  EmbeddedVector<char, 1024> name;
+  Address frames[TickSample::kMaxFramesCount];
+  while (!reader.error()) {
+    int type = reader.ReadRecordType();
+    switch (type) {
+      case EOF:
+        return true;
+      case BinaryLogFormat::kCodeCreation: {
+        int tag = static_cast<int>(reader.ReadUnsigned());
+        Address address = reader.ReadAddress();
+        unsigned size = static_cast<unsigned>(reader.ReadUnsigned());
+        reader.ReadName(name);
+        if (tag >= Logger::NUMBER_OF_LOG_EVENTS) tag = Logger::STUB_TAG;
+        CodeEntry* entry = NewEntry(
+            static_cast<Logger::LogEventsAndTags>(tag),
+            names_.GetFormatted("%s: %s", kTagNames[tag], name.start()));
+        code_map_.AddCode(address, entry, size);
+        break;
+      }
+      case BinaryLogFormat::kCodeMove: {
+        Address from = reader.ReadAddress();
+        Address to = reader.ReadAddress();
+        code_map_.MoveCode(from, to);
+        break;
+      }
+      case BinaryLogFormat::kCodeDelete:
+        // Code created at the same address later replaces the entry.
+        reader.ReadAddress();
+        break;
+      case BinaryLogFormat::kTick: {
+        int state = static_cast<int>(reader.ReadUnsigned());
+        int flags = static_cast<int>(reader.ReadUnsigned());
+        Address pc = reader.ReadAddress();
+        Address tos_or_callback = reader.ReadAddress();
+        int count = Min(static_cast<int>(reader.ReadUnsigned()),
+                        TickSample::kMaxFramesCount);
+        for (int i = 0; i < count; i++) frames[i] = reader.ReadAddress();
+        ProcessTick(state,
+                    (flags & BinaryLogFormat::kHasExternalCallback) != 0,
+                    pc,
+                    tos_or_callback,
+                    Vector<Address>(frames, count));
+        break;
+      }
+      case BinaryLogFormat::kSharedLibrary: {
+        Address start = reader.ReadAddress();
+        Address end = reader.ReadAddress();
+        reader.ReadName(name);
+        // Not a JavaScript tag, so that the entry is not a JS function.
+        CodeEntry* entry = NewEntry(Logger::BUILTIN_TAG, name.start());
+        libraries_.Add(entry);
+        code_map_.AddCode(start, entry, static_cast<unsigned>(end - start));
+        break;
+      }
+      default:
+        fprintf(stderr, "Unknown record type %d.\n", type);
+        return false;
+    }
+  }
+  fprintf(stderr, "Truncated log.\n");
+  return false;
+}
+
+
+// Builds the stack the same way as TickProcessor.processTick in
+// tools/tickprocessor.js.
+void TickProcessor::ProcessTick(int state,
+                                bool has_external_callback,
+                                Address pc,
+                                Address tos_or_callback,
+                                const Vector<Address>& frames) {
+  total_ticks_++;
+  if (state == GC) gc_ticks_++;
+
+  CodeEntry* path[TickSample::kMaxFramesCount + 2];
+  int length = 0;
+  if (has_external_callback) {
+    // The VM was in a native callback, whose code is not in the map.
+    path[length++] = code_map_.FindEntry(tos_or_callback);
+  } else {
+    path[length++] = code_map_.FindEntry(pc);
+    // A JavaScript function on top of the stack called a stub that did not
+    // set up a frame.
+    CodeEntry* tos = code_map_.FindEntry(tos_or_callback);
+    if (tos != NULL && tos->is_js_function()) path[length++] = tos;
+  }
+  if (path[0] == NULL) {
+    unaccounted_ticks_++;
+    return;
+  }
+  for (int i = 0; i < frames.length(); i++) {
+    path[length++] = code_map_.FindEntry(frames[i]);
+  }
+  bottom_up_.AddPathFromStart(Vector<CodeEntry*>(path, length));
+}
+
+
+static int CompareSelfTicks(ProfileNode* const* a, ProfileNode* const* b) {
+  // Bottom up, the ticks of a top level node are its self ticks.
+  if ((*a)->total_ticks() != (*b)->total_ticks()) {
+    return (*a)->total_ticks() > (*b)->total_ticks() ? -1 : 1;
+  }
+  return strcmp((*b)->entry()->name(), (*a)->entry()->name());
+}
+
+
+static double Percent(int ticks, int total) {
+  return total > 0 ? ticks * 100.0 / total : 0.0;
+}
+
+
+void TickProcessor::PrintHeader(const char* title) {
+  printf("\n [%s]:\n", title);
+  printf("   ticks  total  nonlib   name\n");
+}
+
+
+void TickProcessor::PrintCounter(int ticks) {
+  printf("  %5d  %5.1f%%\n", ticks, Percent(ticks, total_ticks_));
+}
+
+
+void TickProcessor::PrintEntries(const List<ProfileNode*>& nodes,
+                                 int non_library_ticks,
+                                 bool libraries) {
+  for (int i = 0; i < nodes.length(); i++) {
+    CodeEntry* entry = nodes[i]->entry();
+    if (IsSharedLibrary(entry) != libraries) continue;
+    int ticks = nodes[i]->total_ticks();
+    printf("  %5d  %5.1f%%  %5.1f%%  %s\n",
+           ticks,
+           Percent(ticks, total_ticks_),
+           libraries ? 0.0 : Percent(ticks, non_library_ticks),
+           entry->name());
+  }
+}
+
+
+void TickProcessor::PrintHeavyProfile(ProfileNode* parent,
+                                      int parent_ticks,
+                                      int indent) {
+  List<ProfileNode*> nodes(parent->children()->length());
+  nodes.AddAll(*parent->children());
+  nodes.Sort(CompareSelfTicks);
+  for (int i = 0; i < nodes.length(); i++) {
+    int ticks = nodes[i]->total_ticks();
+    double percent = Percent(ticks, parent_ticks);
+    if (percent < kCallProfileCutoffPercent) continue;
+    printf("  %5d  %5.1f%%  %*s%s\n",
+           ticks, percent, indent, "", nodes[i]->entry()->name());
+    if (indent < kMaxHeavyProfileIndent) {
+      PrintHeavyProfile(nodes[i], ticks, indent + 2);
+    }
+    if (indent == 0) printf("\n");
+  }
+}
+
+
+void TickProcessor::PrintStatistics(const char* file_name) {
+  printf("Statistical profiling result from %s, "
+         "(%d ticks, %d unaccounted, 0 excluded).\n",
+         file_name, total_ticks_, unaccounted_ticks_);
+  if (total_ticks_ == 0) return;
+
+  if (unaccounted_ticks_ > 0) {
+    printf("\n [Unknown]:\n");
+    PrintCounter(unaccounted_ticks_);
+  }
+
+  bottom_up_.CalculateTotalTicks();
+  List<ProfileNode*> flat(bottom_up_.root()->children()->length());
+  flat.AddAll(*bottom_up_.root()->children());
+  flat.Sort(CompareSelfTicks);
+
+  int library_ticks = 0;
+  for (int i = 0; i < flat.length(); i++) {
+    if (IsSharedLibrary(flat[i]->entry())) {
+      library_ticks += flat[i]->total_ticks();
+    }
+  }
+
+  PrintHeader("Shared libraries");
+  PrintEntries(flat, 0, true);
+  PrintHeader("JavaScript");
+  PrintEntries(flat, total_ticks_ - library_ticks, false);
+  PrintHeader("GC");
+  PrintCounter(gc_ticks_);
+
+  printf("\n [Bottom up (heavy) profile]:\n");
+  printf("  Note: percentage shows a share of a particular caller in the "
+         "total\n  amount of its parent calls.\n");
+  printf("  Callers occupying less than %.1f%% are not shown.\n\n",
+         kCallProfileCutoffPercent);
+  printf("   ticks parent  name\n");
+  PrintHeavyProfile(bottom_up_.root(), total_ticks_, 0);
+}
+
+
+} }  // namespace v8::internal
+
+
+int main(int argc, char** argv) {
+  const char* file_name = argc > 1 ? argv[1] : "v8.log.bin";
+  if (argc > 2) {
+    fprintf(stderr, "Usage: %s [v8.log.bin]\n", argv[0]);
+    return 1;
+  }
+  FILE* file = fopen(file_name, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Cannot open '%s'.\n", file_name);
+    return 1;
+  }
+  // The strings storage of the profiler hashes with the heap's seed.
+  v8::V8::Initialize();
+  i::TickProcessor processor;
+  bool ok = processor.ProcessLog(file);
+  fclose(file);
+  if (ok) processor.PrintStatistics(file_name);
+  return ok ? 0 : 1;
+}
@@ -30,6 +30,7 @@
 #include "ast.h"
 #include "code-stubs.h"
 #include "compiler.h"
+#include "feedback-profile.h"
 #include "ic.h"
 #include "macro-assembler.h"
 #include "stub-cache.h"
@@ -60,11 +61,12 @@ TypeInfo TypeInfo::TypeFromValue(Handle<Object> value) {
 
 
 TypeFeedbackOracle::TypeFeedbackOracle(Handle<Code> code,
+                                       Handle<SharedFunctionInfo> shared,
                                        Handle<Context> global_context,
                                        Isolate* isolate) {
   global_context_ = global_context;
   isolate_ = isolate;
-  BuildDictionary(code);
+  BuildDictionary(code, shared);
   ASSERT(reinterpret_cast<Address>(*dictionary_.location()) != kHandleZapValue);
 }
 
@@ -77,6 +79,23 @@ Handle<Object> TypeFeedbackOracle::GetInfo(unsigned ast_id) {
 }
 
 
+bool TypeFeedbackOracle::GetICState(unsigned ast_id,
+                                    Code::Kind kind,
+                                    int* state) {
+  Handle<Object> object = GetInfo(ast_id);
+  if (object->IsSmi()) {
+    // State taken over from the feedback profile.
+    *state = Smi::cast(*object)->value();
+    return true;
+  }
+  if (!object->IsCode()) return false;
+  Handle<Code> code = Handle<Code>::cast(object);
+  if (code->kind() != kind) return false;
+  *state = FeedbackProfile::EncodeICState(*code);
+  return true;
+}
+
+
 bool TypeFeedbackOracle::LoadIsMonomorphicNormal(Property* expr) {
   Handle<Object> map_or_code = GetInfo(expr->id());
   if (map_or_code->IsMap()) return true;
@@ -240,13 +259,11 @@ bool TypeFeedbackOracle::LoadIsBuiltin(Property* expr, Builtins::Name id) {
 
 
 TypeInfo TypeFeedbackOracle::CompareType(CompareOperation* expr) {
-  Handle<Object> object = GetInfo(expr->id());
   TypeInfo unknown = TypeInfo::Unknown();
-  if (!object->IsCode()) return unknown;
-  Handle<Code> code = Handle<Code>::cast(object);
-  if (!code->is_compare_ic_stub()) return unknown;
+  int ic_state;
+  if (!GetICState(expr->id(), Code::COMPARE_IC, &ic_state)) return unknown;
 
-  CompareIC::State state = static_cast<CompareIC::State>(code->compare_state());
+  CompareIC::State state = static_cast<CompareIC::State>(ic_state);
   switch (state) {
     case CompareIC::UNINITIALIZED:
       // Uninitialized means never executed.
@@ -269,23 +286,18 @@ TypeInfo TypeFeedbackOracle::CompareType(CompareOperation* expr) {
 
 
 bool TypeFeedbackOracle::IsSymbolCompare(CompareOperation* expr) {
-  Handle<Object> object = GetInfo(expr->id());
-  if (!object->IsCode()) return false;
-  Handle<Code> code = Handle<Code>::cast(object);
-  if (!code->is_compare_ic_stub()) return false;
-  CompareIC::State state = static_cast<CompareIC::State>(code->compare_state());
+  int ic_state;
+  if (!GetICState(expr->id(), Code::COMPARE_IC, &ic_state)) return false;
+  CompareIC::State state = static_cast<CompareIC::State>(ic_state);
   return state == CompareIC::SYMBOLS;
 }
 
 
 TypeInfo TypeFeedbackOracle::UnaryType(UnaryOperation* expr) {
-  Handle<Object> object = GetInfo(expr->id());
   TypeInfo unknown = TypeInfo::Unknown();
-  if (!object->IsCode()) return unknown;
-  Handle<Code> code = Handle<Code>::cast(object);
-  ASSERT(code->is_unary_op_stub());
-  UnaryOpIC::TypeInfo type = static_cast<UnaryOpIC::TypeInfo>(
-      code->unary_op_type());
+  int ic_state;
+  if (!GetICState(expr->id(), Code::UNARY_OP_IC, &ic_state)) return unknown;
+  UnaryOpIC::TypeInfo type = static_cast<UnaryOpIC::TypeInfo>(ic_state);
   switch (type) {
     case UnaryOpIC::SMI:
       return TypeInfo::Smi();
@@ -298,15 +310,12 @@ TypeInfo TypeFeedbackOracle::UnaryType(UnaryOperation* expr) {
 
 
 TypeInfo TypeFeedbackOracle::BinaryType(BinaryOperation* expr) {
-  Handle<Object> object = GetInfo(expr->id());
   TypeInfo unknown = TypeInfo::Unknown();
-  if (!object->IsCode()) return unknown;
-  Handle<Code> code = Handle<Code>::cast(object);
-  if (code->is_binary_op_stub()) {
-    BinaryOpIC::TypeInfo type = static_cast<BinaryOpIC::TypeInfo>(
-        code->binary_op_type());
-    BinaryOpIC::TypeInfo result_type = static_cast<BinaryOpIC::TypeInfo>(
-        code->binary_op_result_type());
+  int ic_state;
+  if (GetICState(expr->id(), Code::BINARY_OP_IC, &ic_state)) {
+    BinaryOpIC::TypeInfo type = FeedbackProfile::BinaryOpType(ic_state);
+    BinaryOpIC::TypeInfo result_type =
+        FeedbackProfile::BinaryOpResultType(ic_state);
 
     switch (type) {
       case BinaryOpIC::UNINITIALIZED:
@@ -346,13 +355,13 @@ TypeInfo TypeFeedbackOracle::BinaryType(BinaryOperation* expr) {
 
 
 TypeInfo TypeFeedbackOracle::SwitchType(CaseClause* clause) {
-  Handle<Object> object = GetInfo(clause->CompareId());
   TypeInfo unknown = TypeInfo::Unknown();
-  if (!object->IsCode()) return unknown;
-  Handle<Code> code = Handle<Code>::cast(object);
-  if (!code->is_compare_ic_stub()) return unknown;
+  int ic_state;
+  if (!GetICState(clause->CompareId(), Code::COMPARE_IC, &ic_state)) {
+    return unknown;
+  }
 
-  CompareIC::State state = static_cast<CompareIC::State>(code->compare_state());
+  CompareIC::State state = static_cast<CompareIC::State>(ic_state);
   switch (state) {
     case CompareIC::UNINITIALIZED:
       // Uninitialized means never executed.
@@ -377,14 +386,13 @@ TypeInfo TypeFeedbackOracle::SwitchType(CaseClause* clause) {
 
 
 TypeInfo TypeFeedbackOracle::IncrementType(CountOperation* expr) {
-  Handle<Object> object = GetInfo(expr->CountId());
   TypeInfo unknown = TypeInfo::Unknown();
-  if (!object->IsCode()) return unknown;
-  Handle<Code> code = Handle<Code>::cast(object);
-  if (!code->is_binary_op_stub()) return unknown;
+  int ic_state;
+  if (!GetICState(expr->CountId(), Code::BINARY_OP_IC, &ic_state)) {
+    return unknown;
+  }
 
-  BinaryOpIC::TypeInfo type = static_cast<BinaryOpIC::TypeInfo>(
-      code->binary_op_type());
+  BinaryOpIC::TypeInfo type = FeedbackProfile::BinaryOpType(ic_state);
   switch (type) {
     case BinaryOpIC::UNINITIALIZED:
     case BinaryOpIC::SMI:
@@ -457,8 +465,9 @@ void TypeFeedbackOracle::CollectKeyedReceiverTypes(unsigned ast_id,
 
 
 byte TypeFeedbackOracle::ToBooleanTypes(unsigned ast_id) {
-  Handle<Object> object = GetInfo(ast_id);
-  return object->IsCode() ? Handle<Code>::cast(object)->to_boolean_state() : 0;
+  int ic_state;
+  if (!GetICState(ast_id, Code::TO_BOOLEAN_IC, &ic_state)) return 0;
+  return static_cast<byte>(ic_state);
 }
 
 
@@ -466,13 +475,17 @@ byte TypeFeedbackOracle::ToBooleanTypes(unsigned ast_id) {
 // themselves are not GC-safe, so we first get all infos, then we create the
 // dictionary (possibly triggering GC), and finally we relocate the collected
 // infos before we process them.
-void TypeFeedbackOracle::BuildDictionary(Handle<Code> code) {
+void TypeFeedbackOracle::BuildDictionary(Handle<Code> code,
+                                         Handle<SharedFunctionInfo> shared) {
   AssertNoAllocation no_allocation;
   ZoneList<RelocInfo> infos(16);
   HandleScope scope;
   GetRelocInfos(code, &infos);
   CreateDictionary(code, &infos);
-  ProcessRelocInfos(&infos);
+  FeedbackProfile* profile = isolate_->feedback_profile();
+  FeedbackProfileEntry* profile_entry =
+      (profile == NULL || shared.is_null()) ? NULL : profile->Find(*shared);
+  ProcessRelocInfos(&infos, profile_entry);
   // Allocate handle in the parent scope.
   dictionary_ = scope.CloseAndEscape(dictionary_);
 }
@@ -507,7 +520,9 @@ void TypeFeedbackOracle::RelocateRelocInfos(ZoneList<RelocInfo>* infos,
 }
 
 
-void TypeFeedbackOracle::ProcessRelocInfos(ZoneList<RelocInfo>* infos) {
+void TypeFeedbackOracle::ProcessRelocInfos(
+    ZoneList<RelocInfo>* infos,
+    FeedbackProfileEntry* profile_entry) {
   for (int i = 0; i < infos->length(); i++) {
     RelocInfo reloc_entry = (*infos)[i];
     Address target_address = reloc_entry.target_address();
@@ -542,9 +557,20 @@ void TypeFeedbackOracle::ProcessRelocInfos(ZoneList<RelocInfo>* infos) {
       case Code::UNARY_OP_IC:
       case Code::BINARY_OP_IC:
       case Code::COMPARE_IC:
-      case Code::TO_BOOLEAN_IC:
+      case Code::TO_BOOLEAN_IC: {
+        // ICs that have not been reached yet in this run take over the
+        // state recorded in the feedback profile, if any.
+        int state = FeedbackProfile::EncodeICState(target);
+        if (state == 0 && profile_entry != NULL) {
+          state = profile_entry->ICState(target->kind(), ast_id);
+          if (state != 0) {
+            SetInfo(ast_id, Smi::FromInt(state));
+            break;
+          }
+        }
         SetInfo(ast_id, target);
         break;
+      }
 
       case Code::STUB:
         if (target->major_key() == CodeStub::CallFunction &&
@@ -223,6 +223,7 @@ class CaseClause;
 class CompareOperation;
 class CompilationInfo;
 class CountOperation;
+class FeedbackProfileEntry;
 class Property;
 class SmallMapList;
 class UnaryOperation;
@@ -231,6 +232,7 @@ class UnaryOperation;
 class TypeFeedbackOracle BASE_EMBEDDED {
  public:
   TypeFeedbackOracle(Handle<Code> code,
+                     Handle<SharedFunctionInfo> shared,
                      Handle<Context> global_context,
                      Isolate* isolate);
 
@@ -284,18 +286,24 @@ class TypeFeedbackOracle BASE_EMBEDDED {
 
   void SetInfo(unsigned ast_id, Object* target);
 
-  void BuildDictionary(Handle<Code> code);
+  void BuildDictionary(Handle<Code> code, Handle<SharedFunctionInfo> shared);
   void GetRelocInfos(Handle<Code> code, ZoneList<RelocInfo>* infos);
   void CreateDictionary(Handle<Code> code, ZoneList<RelocInfo>* infos);
   void RelocateRelocInfos(ZoneList<RelocInfo>* infos,
                           byte* old_start,
                           byte* new_start);
-  void ProcessRelocInfos(ZoneList<RelocInfo>* infos);
+  void ProcessRelocInfos(ZoneList<RelocInfo>* infos,
+                         FeedbackProfileEntry* profile_entry);
 
   // Returns an element from the backing store. Returns undefined if
   // there is no information.
   Handle<Object> GetInfo(unsigned ast_id);
 
+  // Returns the state of the unary, binary, compare or ToBoolean IC of the
+  // given kind at ast_id, encoded as by FeedbackProfile::EncodeICState.
+  // Returns false if there is no such IC.
+  bool GetICState(unsigned ast_id, Code::Kind kind, int* state);
+
   Handle<Context> global_context_;
   Isolate* isolate_;
   Handle<NumberDictionary> dictionary_;
@@ -0,0 +1,231 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+const $ArrayBuffer = global.ArrayBuffer;
+
+// The external array types of include/v8.h.
+const kExternalByteArray = 1;
+const kExternalUnsignedByteArray = 2;
+const kExternalShortArray = 3;
+const kExternalUnsignedShortArray = 4;
+const kExternalIntArray = 5;
+const kExternalUnsignedIntArray = 6;
+const kExternalFloatArray = 7;
+const kExternalDoubleArray = 8;
+const kExternalPixelArray = 9;
+
+// ExternalArray::kMaxLength.
+const kMaxArrayBufferLength = 0x3fffffff;
+
+//-------------------------------------------------------------------
+
+function IsArrayBuffer(obj) {
+  return IS_SPEC_OBJECT(obj) && %_ClassOf(obj) === 'ArrayBuffer';
+}
+
+
+function ArrayBufferConstructor(byteLength) {
+  if (%_IsConstructCall()) {
+    var length = TO_INTEGER_MAP_MINUS_ZERO(byteLength);
+    if (length < 0 || length > kMaxArrayBufferLength) {
+      throw MakeRangeError('invalid_array_buffer_length', []);
+    }
+    %ArrayBufferInitialize(this, length);
+    %SetProperty(this, "byteLength", length,
+                 READ_ONLY | DONT_ENUM | DONT_DELETE);
+  } else {
+    return new $ArrayBuffer(byteLength);
+  }
+}
+
+
+// Clamps a relative index, which counts from the end if it is negative, to
+// [0, length].
+function ClampRelativeIndex(index, length) {
+  index = TO_INTEGER_MAP_MINUS_ZERO(index);
+  if (index < 0) return MathMax(0, length + index);
+  return MathMin(index, length);
+}
+
+
+function ArrayBufferSlice(begin, end) {
+  if (!IsArrayBuffer(this)) {
+    throw MakeTypeError('incompatible_method_receiver',
+                        ['ArrayBuffer.prototype.slice', this]);
+  }
+  var length = this.byteLength;
+  var first = ClampRelativeIndex(begin, length);
+  var last = IS_UNDEFINED(end) ? length : ClampRelativeIndex(end, length);
+  var result = new $ArrayBuffer(MathMax(0, last - first));
+  %ArrayBufferSliceImpl(this, result, first);
+  return result;
+}
+
+
+// Sets up the constructor and prototype of one kind of view.  The elements
+// of a view are an external array on the backing store of its buffer, so
+// the keyed load and store stubs and Crankshaft access them inline.
+function SetUpTypedArray(constructor, name, type, elementSize) {
+  function TypedArrayConstructor(arg0, arg1, arg2) {
+    if (!%_IsConstructCall()) return new constructor(arg0, arg1, arg2);
+
+    var buffer;
+    var byteOffset = 0;
+    var length;
+    var source = null;
+    if (IsArrayBuffer(arg0)) {
+      buffer = arg0;
+      byteOffset = TO_INTEGER_MAP_MINUS_ZERO(arg1);
+      if (byteOffset < 0 || byteOffset > buffer.byteLength ||
+          byteOffset % elementSize != 0) {
+        throw MakeRangeError('invalid_typed_array_offset', [byteOffset]);
+      }
+      if (IS_UNDEFINED(arg2)) {
+        var byteLength = buffer.byteLength - byteOffset;
+        if (byteLength % elementSize != 0) {
+          throw MakeRangeError('invalid_typed_array_length', []);
+        }
+        length = byteLength / elementSize;
+      } else {
+        length = TO_INTEGER_MAP_MINUS_ZERO(arg2);
+        if (length < 0 ||
+            length > (buffer.byteLength - byteOffset) / elementSize) {
+          throw MakeRangeError('invalid_typed_array_length', []);
+        }
+      }
+    } else {
+      if (IS_SPEC_OBJECT(arg0)) {
+        source = arg0;
+        var sourceLength = source.length;
+        length = TO_INTEGER_MAP_MINUS_ZERO(sourceLength);
+      } else {
+        length = TO_INTEGER_MAP_MINUS_ZERO(arg0);
+      }
+      if (length < 0 || length > kMaxArrayBufferLength / elementSize) {
+        throw MakeRangeError('invalid_typed_array_length', []);
+      }
+      buffer = new $ArrayBuffer(length * elementSize);
+    }
+
+    %TypedArrayInitialize(this, type, buffer, byteOffset, length);
+    %SetProperty(this, "buffer", buffer, READ_ONLY | DONT_ENUM | DONT_DELETE);
+    %SetProperty(this, "byteOffset", byteOffset,
+                 READ_ONLY | DONT_ENUM | DONT_DELETE);
+    %SetProperty(this, "byteLength", length * elementSize,
+                 READ_ONLY | DONT_ENUM | DONT_DELETE);
+    %SetProperty(this, "length", length, READ_ONLY | DONT_ENUM | DONT_DELETE);
+    if (source !== null) {
+      for (var i = 0; i < length; i++) {
+        this[i] = source[i];
+      }
+    }
+  }
+
+  function CheckReceiver(method, receiver) {
+    if (!IS_SPEC_OBJECT(receiver) || %_ClassOf(receiver) !== name) {
+      throw MakeTypeError('incompatible_method_receiver',
+                          [name + '.prototype.' + method, receiver]);
+    }
+  }
+
+  // Copies the elements of array into this view, starting at offset.
+  function TypedArraySet(array, offset) {
+    CheckReceiver('set', this);
+    if (!IS_SPEC_OBJECT(array)) {
+      throw MakeTypeError('invalid_typed_array_source', [array]);
+    }
+    var start = IS_UNDEFINED(offset) ? 0 : TO_INTEGER_MAP_MINUS_ZERO(offset);
+    var length = array.length;
+    length = TO_INTEGER_MAP_MINUS_ZERO(length);
+    if (start < 0 || length < 0 || start + length > this.length) {
+      throw MakeRangeError('invalid_typed_array_length', []);
+    }
+    // A view on the same buffer may overlap this one, so its elements are
+    // read before any is written.
+    if (array.buffer === this.buffer && IsArrayBuffer(array.buffer)) {
+      var copy = new $Array(length);
+      for (var i = 0; i < length; i++) copy[i] = array[i];
+      array = copy;
+    }
+    for (var i = 0; i < length; i++) {
+      this[start + i] = array[i];
+    }
+  }
+
+  // Returns a view of the elements from begin to end on the same buffer.
+  function TypedArraySubarray(begin, end) {
+    CheckReceiver('subarray', this);
+    var length = this.length;
+    var first = ClampRelativeIndex(begin, length);
+    var last = IS_UNDEFINED(end) ? length : ClampRelativeIndex(end, length);
+    return new constructor(this.buffer,
+                           this.byteOffset + first * elementSize,
+                           MathMax(0, last - first));
+  }
+
+  %SetCode(constructor, TypedArrayConstructor);
+  %SetProperty(constructor.prototype, "constructor", constructor, DONT_ENUM);
+  %SetProperty(constructor, "BYTES_PER_ELEMENT", elementSize,
+               READ_ONLY | DONT_ENUM | DONT_DELETE);
+  %SetProperty(constructor.prototype, "BYTES_PER_ELEMENT", elementSize,
+               READ_ONLY | DONT_ENUM | DONT_DELETE);
+  InstallFunctions(constructor.prototype, DONT_ENUM, $Array(
+    "set", TypedArraySet,
+    "subarray", TypedArraySubarray
+  ));
+}
+
+// -------------------------------------------------------------------
+
+(function () {
+  %CheckIsBootstrapping();
+
+  // Set up the ArrayBuffer constructor function.
+  %SetCode($ArrayBuffer, ArrayBufferConstructor);
+  %SetProperty($ArrayBuffer.prototype, "constructor", $ArrayBuffer,
+               DONT_ENUM);
+  InstallFunctions($ArrayBuffer.prototype, DONT_ENUM, $Array(
+    "slice", ArrayBufferSlice
+  ));
+
+  // Set up the views.
+  SetUpTypedArray(global.Int8Array, 'Int8Array', kExternalByteArray, 1);
+  SetUpTypedArray(global.Uint8Array, 'Uint8Array',
+                  kExternalUnsignedByteArray, 1);
+  SetUpTypedArray(global.Uint8ClampedArray, 'Uint8ClampedArray',
+                  kExternalPixelArray, 1);
+  SetUpTypedArray(global.Int16Array, 'Int16Array', kExternalShortArray, 2);
+  SetUpTypedArray(global.Uint16Array, 'Uint16Array',
+                  kExternalUnsignedShortArray, 2);
+  SetUpTypedArray(global.Int32Array, 'Int32Array', kExternalIntArray, 4);
+  SetUpTypedArray(global.Uint32Array, 'Uint32Array',
+                  kExternalUnsignedIntArray, 4);
+  SetUpTypedArray(global.Float32Array, 'Float32Array',
+                  kExternalFloatArray, 4);
+  SetUpTypedArray(global.Float64Array, 'Float64Array',
+                  kExternalDoubleArray, 8);
+})();
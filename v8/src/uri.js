@@ -248,36 +248,31 @@ function Decode(uri, reserved) {
 }
 
 
-// ECMA-262 - 15.1.3.1.
-function URIDecode(uri) {
-  function reservedPredicate(cc) {
-    // #$
-    if (35 <= cc && cc <= 36) return true;
-    // &
-    if (cc == 38) return true;
-    // +,
-    if (43 <= cc && cc <= 44) return true;
-    // /
-    if (cc == 47) return true;
-    // :;
-    if (58 <= cc && cc <= 59) return true;
-    // =
-    if (cc == 61) return true;
-    // ?@
-    if (63 <= cc && cc <= 64) return true;
-
-    return false;
-  }
-  var string = ToString(uri);
-  return Decode(string, reservedPredicate);
+// Predicates for Decode and Encode.  They live outside of the URI
+// functions, so that calls that the runtime handles do not create them.
+
+function URIDecodeReservedPredicate(cc) {
+  // #$
+  if (35 <= cc && cc <= 36) return true;
+  // &
+  if (cc == 38) return true;
+  // +,
+  if (43 <= cc && cc <= 44) return true;
+  // /
+  if (cc == 47) return true;
+  // :;
+  if (58 <= cc && cc <= 59) return true;
+  // =
+  if (cc == 61) return true;
+  // ?@
+  if (63 <= cc && cc <= 64) return true;
+
+  return false;
 }
 
 
-// ECMA-262 - 15.1.3.2.
-function URIDecodeComponent(component) {
-  function reservedPredicate(cc) { return false; }
-  var string = ToString(component);
-  return Decode(string, reservedPredicate);
+function URIDecodeComponentReservedPredicate(cc) {
+  return false;
 }
 
 
@@ -294,55 +289,83 @@ function isAlphaNumeric(cc) {
 }
 
 
+function URIEncodeUnescapePredicate(cc) {
+  if (isAlphaNumeric(cc)) return true;
+  // !
+  if (cc == 33) return true;
+  // #$
+  if (35 <= cc && cc <= 36) return true;
+  // &'()*+,-./
+  if (38 <= cc && cc <= 47) return true;
+  // :;
+  if (58 <= cc && cc <= 59) return true;
+  // =
+  if (cc == 61) return true;
+  // ?@
+  if (63 <= cc && cc <= 64) return true;
+  // _
+  if (cc == 95) return true;
+  // ~
+  if (cc == 126) return true;
+
+  return false;
+}
+
+
+function URIEncodeComponentUnescapePredicate(cc) {
+  if (isAlphaNumeric(cc)) return true;
+  // !
+  if (cc == 33) return true;
+  // '()*
+  if (39 <= cc && cc <= 42) return true;
+  // -.
+  if (45 <= cc && cc <= 46) return true;
+  // _
+  if (cc == 95) return true;
+  // ~
+  if (cc == 126) return true;
+
+  return false;
+}
+
+
+// The runtime encodes and decodes well-formed URIs natively.  It returns
+// undefined for malformed ones, and Encode or Decode then throws the
+// error.
+
+// ECMA-262 - 15.1.3.1.
+function URIDecode(uri) {
+  var string = ToString(uri);
+  var result = %URIDecode(string, false);
+  if (!IS_UNDEFINED(result)) return result;
+  return Decode(string, URIDecodeReservedPredicate);
+}
+
+
+// ECMA-262 - 15.1.3.2.
+function URIDecodeComponent(component) {
+  var string = ToString(component);
+  var result = %URIDecode(string, true);
+  if (!IS_UNDEFINED(result)) return result;
+  return Decode(string, URIDecodeComponentReservedPredicate);
+}
+
+
 // ECMA-262 - 15.1.3.3.
 function URIEncode(uri) {
-  function unescapePredicate(cc) {
-    if (isAlphaNumeric(cc)) return true;
-    // !
-    if (cc == 33) return true;
-    // #$
-    if (35 <= cc && cc <= 36) return true;
-    // &'()*+,-./
-    if (38 <= cc && cc <= 47) return true;
-    // :;
-    if (58 <= cc && cc <= 59) return true;
-    // =
-    if (cc == 61) return true;
-    // ?@
-    if (63 <= cc && cc <= 64) return true;
-    // _
-    if (cc == 95) return true;
-    // ~
-    if (cc == 126) return true;
-
-    return false;
-  }
-
   var string = ToString(uri);
-  return Encode(string, unescapePredicate);
+  var result = %URIEncode(string, false);
+  if (!IS_UNDEFINED(result)) return result;
+  return Encode(string, URIEncodeUnescapePredicate);
 }
 
 
 // ECMA-262 - 15.1.3.4
 function URIEncodeComponent(component) {
-  function unescapePredicate(cc) {
-    if (isAlphaNumeric(cc)) return true;
-    // !
-    if (cc == 33) return true;
-    // '()*
-    if (39 <= cc && cc <= 42) return true;
-    // -.
-    if (45 <= cc && cc <= 46) return true;
-    // _
-    if (cc == 95) return true;
-    // ~
-    if (cc == 126) return true;
-
-    return false;
-  }
-
   var string = ToString(component);
-  return Encode(string, unescapePredicate);
+  var result = %URIEncode(string, true);
+  if (!IS_UNDEFINED(result)) return result;
+  return Encode(string, URIEncodeComponentUnescapePredicate);
 }
 
 
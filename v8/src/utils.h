@@ -36,6 +36,18 @@
 #include "checks.h"
 #include "allocation.h"
 
+// The string kernels below use SIMD compares when the compiler targets a
+// host that always has them.  Generated code selects instructions through
+// CpuFeatures instead.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define V8_HOST_CAN_USE_SSE2 1
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define V8_HOST_CAN_USE_NEON 1
+#endif
+
 namespace v8 {
 namespace internal {
 
@@ -732,10 +744,72 @@ class SequenceCollector : public Collector<T, growth_factor, max_growth> {
 };
 
 
+// Returns the number of leading characters of lhs and rhs that are covered
+// by equal 16 byte blocks.  Always 0 on hosts without SIMD compares.
+template <typename Char>
+inline int SkipEqualBlocks(const Char* lhs, const Char* rhs, int chars) {
+  static const int kBlockSize = 16 / sizeof(Char);  // NOLINT
+  int i = 0;
+#if defined(V8_HOST_CAN_USE_SSE2)
+  for (; i <= chars - kBlockSize; i += kBlockSize) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF) break;
+  }
+#elif defined(V8_HOST_CAN_USE_NEON)
+  for (; i <= chars - kBlockSize; i += kBlockSize) {
+    uint8x16_t a = vld1q_u8(reinterpret_cast<const uint8_t*>(lhs + i));
+    uint8x16_t b = vld1q_u8(reinterpret_cast<const uint8_t*>(rhs + i));
+    uint64x2_t equal = vreinterpretq_u64_u8(vceqq_u8(a, b));
+    if ((vgetq_lane_u64(equal, 0) & vgetq_lane_u64(equal, 1)) != ~0ULL) {
+      break;
+    }
+  }
+#else
+  USE(lhs);
+  USE(rhs);
+  USE(kBlockSize);
+#endif
+  return i;
+}
+
+
+// Returns the first occurrence of c in the length characters at chars, or
+// NULL.  The 16 bit counterpart of memchr.
+inline const uc16* FindUC16(const uc16* chars, uc16 c, int length) {
+  int i = 0;
+#if defined(V8_HOST_CAN_USE_SSE2)
+  __m128i pattern = _mm_set1_epi16(static_cast<int16_t>(c));
+  for (; i <= length - 8; i += 8) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(block, pattern)) != 0) break;
+  }
+#elif defined(V8_HOST_CAN_USE_NEON)
+  uint16x8_t pattern = vdupq_n_u16(c);
+  for (; i <= length - 8; i += 8) {
+    uint64x2_t found = vreinterpretq_u64_u16(vceqq_u16(vld1q_u16(chars + i),
+                                                       pattern));
+    if ((vgetq_lane_u64(found, 0) | vgetq_lane_u64(found, 1)) != 0) break;
+  }
+#endif
+  for (; i < length; i++) {
+    if (chars[i] == c) return chars + i;
+  }
+  return NULL;
+}
+
+
 // Compare ASCII/16bit chars to ASCII/16bit chars.
 template <typename lchar, typename rchar>
 inline int CompareChars(const lchar* lhs, const rchar* rhs, int chars) {
   const lchar* limit = lhs + chars;
+  if (sizeof(*lhs) == sizeof(*rhs)) {
+    int skipped =
+        SkipEqualBlocks(lhs, reinterpret_cast<const lchar*>(rhs), chars);
+    lhs += skipped;
+    rhs += skipped;
+  }
 #ifdef V8_HOST_CAN_READ_UNALIGNED
   if (sizeof(*lhs) == sizeof(*rhs)) {
     // Number of characters in a uintptr_t.
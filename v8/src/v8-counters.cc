@@ -39,6 +39,12 @@ Counters::Counters() {
     HISTOGRAM_TIMER_LIST(HT)
 #undef HT
 
+#define HR(name, caption, min, max, num_buckets) \
+    Histogram name = { #caption, min, max, num_buckets, NULL, false }; \
+    name##_ = name;
+    HISTOGRAM_LIST(HR)
+#undef HR
+
 #define SC(name, caption) \
     StatsCounter name = { "c:" #caption, NULL, false };\
     name##_ = name;
@@ -59,4 +65,17 @@ Counters::Counters() {
   }
 }
 
+
+void Counters::BindStatsCounters() {
+#define SC(name, caption) \
+    name##_.Enabled();
+    STATS_COUNTER_LIST_1(SC)
+    STATS_COUNTER_LIST_2(SC)
+#undef SC
+
+  for (int i = 0; i < kSlidingStateWindowCounterCount; ++i) {
+    state_counters_[i].Enabled();
+  }
+}
+
 } }  // namespace v8::internal
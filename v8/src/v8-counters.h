@@ -50,6 +50,22 @@ namespace internal {
   HT(compile_lazy, V8.CompileLazy)
 
 
+#define HISTOGRAM_LIST(HR)                                            \
+  /* Garbage collection phase times, in milliseconds. */              \
+  HR(gc_external, V8.GCExternal, 0, 10000, 50)                        \
+  HR(gc_mark, V8.GCMark, 0, 10000, 50)                                \
+  HR(gc_sweep, V8.GCSweep, 0, 10000, 50)                              \
+  HR(gc_evacuate, V8.GCEvacuate, 0, 10000, 50)                        \
+  HR(gc_update_pointers, V8.GCUpdatePointers, 0, 10000, 50)           \
+  HR(gc_scavenge_roots, V8.GCScavengeRoots, 0, 10000, 50)             \
+  HR(gc_weak_processing, V8.GCWeakProcessing, 0, 10000, 50)           \
+  /* Garbage collection sizes, in kilobytes. */                       \
+  HR(gc_promoted, V8.GCPromotedKB, 0, 1024 * 1024, 50)                \
+  HR(gc_freed, V8.GCFreedKB, 0, 1024 * 1024, 50)                      \
+  /* Time spent waiting for the v8::Locker lock, in microseconds. */  \
+  HR(locker_wait, V8.LockerWaitMicroseconds, 0, 1000000, 50)
+
+
 // WARNING: STATS_COUNTER_LIST_* is a very large macro that is causing MSVC
 // Intellisense to crash.  It was broken into two macros (each of length 40
 // lines) rather than one macro (of length about 80 lines) to work around
@@ -64,8 +80,14 @@ namespace internal {
   SC(memory_allocated, V8.OsMemoryAllocated)                          \
   SC(normalized_maps, V8.NormalizedMaps)                              \
   SC(props_to_dictionary, V8.ObjectPropertiesToDictionary)            \
+  SC(props_to_fast_after_reads, V8.ObjectPropertiesToFastAfterReads)  \
+  SC(shared_field_descriptors, V8.SharedFieldDescriptors)             \
   SC(elements_to_dictionary, V8.ObjectElementsToDictionary)           \
   SC(alive_after_last_gc, V8.AliveAfterLastGC)                        \
+  SC(code_space_bytes_committed, V8.MemoryCodeSpaceBytesCommitted)    \
+  SC(code_space_bytes_used, V8.MemoryCodeSpaceBytesUsed)              \
+  SC(executable_bytes, V8.MemoryExecutableBytes)                      \
+  SC(optimized_code_evicted, V8.OptimizedCodeEvicted)                 \
   SC(objs_since_last_young, V8.ObjsSinceLastYoung)                    \
   SC(objs_since_last_full, V8.ObjsSinceLastFull)                      \
   SC(symbol_table_capacity, V8.SymbolTableCapacity)                   \
@@ -78,8 +100,11 @@ namespace internal {
   SC(arguments_adaptors, V8.ArgumentsAdaptors)                        \
   SC(compilation_cache_hits, V8.CompilationCacheHits)                 \
   SC(compilation_cache_misses, V8.CompilationCacheMisses)             \
+  SC(compilation_cache_evicted_age, V8.CompilationCacheEvictedAge)    \
+  SC(compilation_cache_evicted_size, V8.CompilationCacheEvictedSize)  \
   SC(regexp_cache_hits, V8.RegExpCacheHits)                           \
   SC(regexp_cache_misses, V8.RegExpCacheMisses)                       \
+  SC(regexp_cache_retained_size, V8.RegExpCacheRetainedSize)          \
   SC(string_ctor_calls, V8.StringConstructorCalls)                    \
   SC(string_ctor_conversions, V8.StringConstructorConversions)        \
   SC(string_ctor_cached_number, V8.StringConstructorCachedNumber)     \
@@ -110,7 +135,20 @@ namespace internal {
   SC(pc_to_code_cached, V8.PcToCodeCached)                            \
   /* The store-buffer implementation of the write barrier. */         \
   SC(store_buffer_compactions, V8.StoreBufferCompactions)             \
-  SC(store_buffer_overflows, V8.StoreBufferOverflows)
+  SC(store_buffer_overflows, V8.StoreBufferOverflows)                 \
+  /* Megamorphic stub cache.  Probes are counted by generated code */ \
+  /* (--native-code-counters); hits are probes minus misses. */       \
+  SC(stub_cache_probes, V8.StubCacheProbes)                           \
+  SC(stub_cache_secondary_probes, V8.StubCacheSecondaryProbes)        \
+  SC(stub_cache_misses, V8.StubCacheMisses)                           \
+  SC(stub_cache_updates, V8.StubCacheUpdates)                         \
+  SC(stub_cache_evictions, V8.StubCacheEvictions)                     \
+  /* v8::Locker handoffs between threads. */                          \
+  SC(locker_acquisitions, V8.LockerAcquisitions)                      \
+  SC(locker_contended_acquisitions, V8.LockerContendedAcquisitions)   \
+  SC(thread_state_archives, V8.ThreadStateArchives)                   \
+  SC(thread_state_restores, V8.ThreadStateRestores)                   \
+  SC(thread_state_lazy_restores, V8.ThreadStateLazyRestores)
 
 
 #define STATS_COUNTER_LIST_2(SC)                                      \
@@ -134,6 +172,10 @@ namespace internal {
   SC(keyed_load_generic_symbol, V8.KeyedLoadGenericSymbol)            \
   SC(keyed_load_generic_lookup_cache, V8.KeyedLoadGenericLookupCache) \
   SC(keyed_load_generic_slow, V8.KeyedLoadGenericSlow)                \
+  SC(keyed_lookup_cache_hits, V8.KeyedLookupCacheHits)                \
+  SC(keyed_lookup_cache_misses, V8.KeyedLookupCacheMisses)            \
+  SC(descriptor_lookup_cache_hits, V8.DescriptorLookupCacheHits)      \
+  SC(descriptor_lookup_cache_misses, V8.DescriptorLookupCacheMisses)  \
   SC(keyed_load_polymorphic_stubs, V8.KeyedLoadPolymorphicStubs)      \
   SC(keyed_load_external_array_slow, V8.KeyedLoadExternalArraySlow)   \
   /* How is the generic keyed-call stub used? */                      \
@@ -204,12 +246,18 @@ namespace internal {
   SC(enum_cache_hits, V8.EnumCacheHits)                               \
   SC(enum_cache_misses, V8.EnumCacheMisses)                           \
   SC(zone_segment_bytes, V8.ZoneSegmentBytes)                         \
+  SC(zone_segment_pool_bytes, V8.ZoneSegmentPoolBytes)                \
+  SC(zone_parse_high_water_mark, V8.ZoneParseHighWaterMark)           \
+  SC(zone_hydrogen_high_water_mark, V8.ZoneHydrogenHighWaterMark)     \
+  SC(zone_lithium_high_water_mark, V8.ZoneLithiumHighWaterMark)       \
+  SC(zone_regexp_high_water_mark, V8.ZoneRegExpHighWaterMark)         \
   SC(compute_entry_frame, V8.ComputeEntryFrame)                       \
   SC(generic_binary_stub_calls, V8.GenericBinaryStubCalls)            \
   SC(generic_binary_stub_calls_regs, V8.GenericBinaryStubCallsRegs)   \
   SC(string_add_runtime, V8.StringAddRuntime)                         \
   SC(string_add_native, V8.StringAddNative)                           \
   SC(string_add_runtime_ext_to_ascii, V8.StringAddRuntimeExtToAscii)  \
+  SC(cons_strings_rebalanced, V8.ConsStringsRebalanced)               \
   SC(sub_string_runtime, V8.SubStringRuntime)                         \
   SC(sub_string_native, V8.SubStringNative)                           \
   SC(string_add_make_two_char, V8.StringAddMakeTwoChar)               \
@@ -237,6 +285,8 @@ namespace internal {
   SC(transcendental_cache_miss, V8.TranscendentalCacheMiss)           \
   SC(stack_interrupts, V8.StackInterrupts)                            \
   SC(runtime_profiler_ticks, V8.RuntimeProfilerTicks)                 \
+  SC(time_slice_callbacks, V8.TimeSliceCallbacks)                     \
+  SC(fast_api_calls, V8.FastApiCalls)                                 \
   SC(other_ticks, V8.OtherTicks)                                      \
   SC(js_opt_ticks, V8.JsOptTicks)                                     \
   SC(js_non_opt_ticks, V8.JsNonoptTicks)                              \
@@ -255,6 +305,11 @@ class Counters {
   HISTOGRAM_TIMER_LIST(HT)
 #undef HT
 
+#define HR(name, caption, min, max, num_buckets) \
+  Histogram* name() { return &name##_; }
+  HISTOGRAM_LIST(HR)
+#undef HR
+
 #define SC(name, caption) \
   StatsCounter* name() { return &name##_; }
   STATS_COUNTER_LIST_1(SC)
@@ -279,12 +334,21 @@ class Counters {
     return &state_counters_[state];
   }
 
+  // Looks up every stats counter in the isolate's StatsTable up front,
+  // so that all of them are visible by name from the start.
+  void BindStatsCounters();
+
  private:
 #define HT(name, caption) \
   HistogramTimer name##_;
   HISTOGRAM_TIMER_LIST(HT)
 #undef HT
 
+#define HR(name, caption, min, max, num_buckets) \
+  Histogram name##_;
+  HISTOGRAM_LIST(HR)
+#undef HR
+
 #define SC(name, caption) \
   StatsCounter name##_;
   STATS_COUNTER_LIST_1(SC)
@@ -51,6 +51,7 @@ bool V8::has_been_setup_ = false;
 bool V8::has_been_disposed_ = false;
 bool V8::has_fatal_error_ = false;
 bool V8::use_crankshaft_ = true;
+v8::TaskRunner* V8::task_runner_ = NULL;
 
 static Mutex* entropy_mutex = OS::CreateMutex();
 static EntropySource entropy_source;
@@ -64,6 +65,7 @@ bool V8::Initialize(Deserializer* des) {
     FLAG_harmony_scoping = true;
     FLAG_harmony_proxies = true;
     FLAG_harmony_collections = true;
+    FLAG_harmony_typed_arrays = true;
   }
 
   InitializeOncePerProcess();
@@ -108,6 +110,7 @@ void V8::TearDown() {
 
   if (!has_been_setup_ || has_been_disposed_) return;
   isolate->TearDown();
+  PagePool::TearDown();
 
   is_running_ = false;
   has_been_disposed_ = true;
@@ -149,6 +152,11 @@ void V8::SetEntropySource(EntropySource source) {
 }
 
 
+void V8::SetTaskRunner(v8::TaskRunner* runner) {
+  task_runner_ = runner;
+}
+
+
 // Used by JavaScript APIs
 uint32_t V8::Random(Context* context) {
   ASSERT(context->IsGlobalContext());
@@ -176,6 +184,12 @@ bool V8::IdleNotification(int hint) {
 }
 
 
+int V8::IdleNotificationWithDeadline(int idle_time_in_us) {
+  if (!FLAG_use_idle_notification) return 0;
+  return HEAP->IdleNotificationWithDeadline(idle_time_in_us);
+}
+
+
 // Use a union type to avoid type-aliasing optimizations in GCC.
 typedef union {
   double double_value;
@@ -221,10 +235,20 @@ void V8::InitializeOncePerProcess() {
     use_crankshaft_ = false;
   }
 
-  RuntimeProfiler::GlobalSetup();
+  // The interrupt budget only drives the optimizing compiler, and only the
+  // ia32 and x64 full code generators count it down.
+  if (!use_crankshaft_ || !FLAG_opt) FLAG_count_based_interrupts = false;
+#if !defined(V8_TARGET_ARCH_IA32) && !defined(V8_TARGET_ARCH_X64)
+  FLAG_count_based_interrupts = false;
+#endif
 
-  // Peephole optimization might interfere with deoptimization.
-  FLAG_peephole_optimization = !use_crankshaft_;
+  // Only the ia32 and x64 stub compilers and lithium backends know about
+  // double fields.
+#if !defined(V8_TARGET_ARCH_IA32) && !defined(V8_TARGET_ARCH_X64)
+  FLAG_unbox_double_fields = false;
+#endif
+
+  RuntimeProfiler::GlobalSetup();
 
   ElementsAccessor::InitializeOncePerProcess();
 
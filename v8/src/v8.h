@@ -95,6 +95,9 @@ class V8 : public AllStatic {
   // Allows an entropy source to be provided for use in random number
   // generation.
   static void SetEntropySource(EntropySource source);
+  static void SetTaskRunner(v8::TaskRunner* runner);
+  // The embedder's task runner, or NULL if V8 should use its own threads.
+  static v8::TaskRunner* task_runner() { return task_runner_; }
   // Random number generation support. Not cryptographically safe.
   static uint32_t Random(Context* context);
   // We use random numbers internally in memory allocation and in the
@@ -107,6 +110,7 @@ class V8 : public AllStatic {
 
   // Idle notification directly from the API.
   static bool IdleNotification(int hint);
+  static int IdleNotificationWithDeadline(int idle_time_in_us);
 
  private:
   static void InitializeOncePerProcess();
@@ -123,6 +127,8 @@ class V8 : public AllStatic {
   static bool has_been_disposed_;
   // True if we are using the crankshaft optimizing compiler.
   static bool use_crankshaft_;
+  // Set by the embedder to run V8's background work.
+  static v8::TaskRunner* task_runner_;
 };
 
 
@@ -86,6 +86,8 @@ double StringToDouble(UnicodeCache* unicode_cache,
   if (shape.IsSequentialAscii()) {
     const char* begin = SeqAsciiString::cast(str)->GetChars();
     const char* end = begin + str->length();
+    double result;
+    if (FastAsciiStringToDouble(begin, end, &result)) return result;
     return InternalStringToDouble(unicode_cache, begin, end, flags,
                                   empty_string_val);
   } else if (shape.IsSequentialTwoByte()) {
@@ -167,6 +167,9 @@ bool ThreadManager::RestoreThread() {
     lazily_archived_thread_state_->LinkInto(ThreadState::FREE_LIST);
     lazily_archived_thread_state_ = NULL;
     per_thread->set_thread_state(NULL);
+    if (isolate_->IsInitialized()) {
+      isolate_->counters()->thread_state_lazy_restores()->Increment();
+    }
     return true;
   }
 
@@ -197,6 +200,7 @@ bool ThreadManager::RestoreThread() {
   from = isolate_->stack_guard()->RestoreStackGuard(from);
   from = isolate_->regexp_stack()->RestoreStack(from);
   from = isolate_->bootstrapper()->RestoreState(from);
+  isolate_->counters()->thread_state_restores()->Increment();
   per_thread->set_thread_state(NULL);
   if (state->terminate_on_restore()) {
     isolate_->stack_guard()->TerminateExecution();
@@ -210,9 +214,23 @@ bool ThreadManager::RestoreThread() {
 
 
 void ThreadManager::Lock() {
-  mutex_->Lock();
+  // The clock is only read when another thread holds the lock, so an
+  // uncontended acquisition stays as cheap as before.
+  int64_t wait_time = 0;
+  if (!mutex_->TryLock()) {
+    int64_t start = OS::Ticks();
+    mutex_->Lock();
+    wait_time = OS::Ticks() - start;
+  }
   mutex_owner_ = ThreadId::Current();
   ASSERT(IsLockedByCurrentThread());
+  if (isolate_->IsInitialized()) {
+    Counters* counters = isolate_->counters();
+    counters->locker_acquisitions()->Increment();
+    if (wait_time > 0) counters->locker_contended_acquisitions()->Increment();
+    counters->locker_wait()->AddSample(
+        static_cast<int>(Min<int64_t>(wait_time, kMaxInt)));
+  }
 }
 
 
@@ -344,6 +362,7 @@ void ThreadManager::EagerlyArchiveThread() {
   to = isolate_->stack_guard()->ArchiveStackGuard(to);
   to = isolate_->regexp_stack()->ArchiveStack(to);
   to = isolate_->bootstrapper()->ArchiveState(to);
+  isolate_->counters()->thread_state_archives()->Increment();
   lazily_archived_thread_ = ThreadId::Invalid();
   lazily_archived_thread_state_ = NULL;
 }
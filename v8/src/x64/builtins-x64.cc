@@ -176,7 +176,7 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
         __ push(rdi);
 
         __ push(rdi);  // constructor
-        // The call will replace the stub, so the countdown is only done once.
+        // The call either restarts the countdown or replaces the stub.
         __ CallRuntime(Runtime::kFinalizeInstanceSize, 1);
 
         __ pop(rdi);
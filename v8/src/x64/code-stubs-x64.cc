@@ -2616,6 +2616,18 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   Condition is_string = masm->IsObjectStringType(rdi, rbx, rbx);
   __ j(NegateCondition(is_string), &runtime);
 
+  // rdi: Subject string.
+  // rax: RegExp data (FixedArray).
+  // rdx: Number of capture registers.
+  // Long subjects are searched for the literal prefix in the runtime.
+  Label no_literal_prefix;
+  __ movq(rbx, FieldOperand(rax, JSRegExp::kIrregexpLiteralPrefixOffset));
+  __ JumpIfSmi(rbx, &no_literal_prefix);
+  __ SmiCompare(FieldOperand(rdi, String::kLengthOffset),
+                Smi::FromInt(JSRegExp::kLiteralPrefixMinSubjectLength));
+  __ j(greater_equal, &runtime);
+  __ bind(&no_literal_prefix);
+
   // rdi: Subject string.
   // rax: RegExp data (FixedArray).
   // rdx: Number of capture registers.
@@ -3475,6 +3487,15 @@ void StackCheckStub::Generate(MacroAssembler* masm) {
 }
 
 
+void InterruptStub::Generate(MacroAssembler* masm) {
+  // rbx holds the profiling counter cell.
+  __ pop(rcx);  // Return address.
+  __ push(rbx);
+  __ push(rcx);
+  __ TailCallRuntime(Runtime::kInterrupt, 1, 1);
+}
+
+
 void CallFunctionStub::FinishCode(Handle<Code> code) {
   code->set_has_function_cache(false);
 }
@@ -4017,14 +4038,27 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
 
   // If there is a call site cache don't look in the global cache, but do the
   // real lookup and update the call site cache.
+  ExternalReference cache_functions =
+      ExternalReference::instanceof_cache_functions(masm->isolate());
+  ExternalReference cache_maps =
+      ExternalReference::instanceof_cache_maps(masm->isolate());
+  ExternalReference cache_answers =
+      ExternalReference::instanceof_cache_answers(masm->isolate());
   if (!HasCallSiteInlineCheck()) {
-    // Look up the function and the map in the instanceof cache.
+    // Look up the function and the map in the instanceof cache.  Leave the
+    // offset of the cache entry in rdi.
     Label miss;
-    __ CompareRoot(rdx, Heap::kInstanceofCacheFunctionRootIndex);
-    __ j(not_equal, &miss, Label::kNear);
-    __ CompareRoot(rax, Heap::kInstanceofCacheMapRootIndex);
-    __ j(not_equal, &miss, Label::kNear);
-    __ LoadRoot(rax, Heap::kInstanceofCacheAnswerRootIndex);
+    __ movq(rdi, rax);
+    __ xor_(rdi, rdx);
+    __ and_(rdi, Immediate(InstanceofCache::kOffsetMask));
+    __ LoadAddress(kScratchRegister, cache_functions);
+    __ cmpq(rdx, Operand(kScratchRegister, rdi, times_1, 0));
+    __ j(not_equal, &miss);
+    __ LoadAddress(kScratchRegister, cache_maps);
+    __ cmpq(rax, Operand(kScratchRegister, rdi, times_1, 0));
+    __ j(not_equal, &miss);
+    __ LoadAddress(kScratchRegister, cache_answers);
+    __ movq(rax, Operand(kScratchRegister, rdi, times_1, 0));
     __ ret(2 * kPointerSize);
     __ bind(&miss);
   }
@@ -4042,9 +4076,13 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   //   rax is object map.
   //   rdx is function.
   //   rbx is function prototype.
+  //   rdi is the offset of the instanceof cache entry without a call site
+  //   cache.
   if (!HasCallSiteInlineCheck()) {
-    __ StoreRoot(rdx, Heap::kInstanceofCacheFunctionRootIndex);
-    __ StoreRoot(rax, Heap::kInstanceofCacheMapRootIndex);
+    __ LoadAddress(kScratchRegister, cache_functions);
+    __ movq(Operand(kScratchRegister, rdi, times_1, 0), rdx);
+    __ LoadAddress(kScratchRegister, cache_maps);
+    __ movq(Operand(kScratchRegister, rdi, times_1, 0), rax);
   } else {
     // Get return address and delta to inlined map check.
     __ movq(kScratchRegister, Operand(rsp, 0 * kPointerSize));
@@ -4076,9 +4114,9 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   __ bind(&is_instance);
   if (!HasCallSiteInlineCheck()) {
     __ xorl(rax, rax);
-    // Store bitwise zero in the cache.  This is a Smi in GC terms.
-    STATIC_ASSERT(kSmiTag == 0);
-    __ StoreRoot(rax, Heap::kInstanceofCacheAnswerRootIndex);
+    // Store bitwise zero in the cache.
+    __ LoadAddress(kScratchRegister, cache_answers);
+    __ movq(Operand(kScratchRegister, rdi, times_1, 0), rax);
   } else {
     // Store offset of true in the root array at the inline check site.
     int true_offset = 0x100 +
@@ -4101,7 +4139,8 @@ void InstanceofStub::Generate(MacroAssembler* masm) {
   __ bind(&is_not_instance);
   if (!HasCallSiteInlineCheck()) {
     // We have to store a non-zero value in the cache.
-    __ StoreRoot(kScratchRegister, Heap::kInstanceofCacheAnswerRootIndex);
+    __ LoadAddress(rcx, cache_answers);
+    __ movq(Operand(rcx, rdi, times_1, 0), kScratchRegister);
   } else {
     // Store offset of false in the root array at the inline check site.
     int false_offset = 0x100 +
@@ -4462,6 +4501,31 @@ void StringAddStub::Generate(MacroAssembler* masm) {
           Immediate(String::kEmptyHashField));
   __ movq(FieldOperand(rcx, ConsString::kFirstOffset), rax);
   __ movq(FieldOperand(rcx, ConsString::kSecondOffset), rdx);
+  // The depth of the result is one more than that of its deeper part.  Too
+  // deep results are left to the runtime, which rebalances them.
+  Label first_is_flat, second_is_flat;
+  __ Move(rdi, Smi::FromInt(0));
+  __ movq(r11, FieldOperand(rax, HeapObject::kMapOffset));
+  __ movzxbl(r11, FieldOperand(r11, Map::kInstanceTypeOffset));
+  __ andl(r11, Immediate(kStringRepresentationMask));
+  __ cmpl(r11, Immediate(kConsStringTag));
+  __ j(not_equal, &first_is_flat, Label::kNear);
+  __ movq(rdi, FieldOperand(rax, ConsString::kDepthOffset));
+  __ bind(&first_is_flat);
+  __ movq(r11, FieldOperand(rdx, HeapObject::kMapOffset));
+  __ movzxbl(r11, FieldOperand(r11, Map::kInstanceTypeOffset));
+  __ andl(r11, Immediate(kStringRepresentationMask));
+  __ cmpl(r11, Immediate(kConsStringTag));
+  __ j(not_equal, &second_is_flat, Label::kNear);
+  __ movq(r11, FieldOperand(rdx, ConsString::kDepthOffset));
+  __ SmiCompare(r11, rdi);
+  __ j(less_equal, &second_is_flat, Label::kNear);
+  __ movq(rdi, r11);
+  __ bind(&second_is_flat);
+  __ SmiAddConstant(rdi, rdi, Smi::FromInt(1));
+  __ movq(FieldOperand(rcx, ConsString::kDepthOffset), rdi);
+  __ SmiCompare(rdi, Smi::FromInt(ConsString::kMaxDepth));
+  __ j(greater, &string_add_runtime);
   __ movq(rax, rcx);
   __ IncrementCounter(counters->string_add_native(), 1);
   __ ret(2 * kPointerSize);
@@ -4849,10 +4913,13 @@ void StringHelper::GenerateHashInit(MacroAssembler* masm,
                                     Register hash,
                                     Register character,
                                     Register scratch) {
-  // hash = character + (character << 10);
-  __ movl(hash, character);
-  __ shll(hash, Immediate(10));
-  __ addl(hash, character);
+  // hash = (seed + character) + ((seed + character) << 10);
+  __ LoadRoot(scratch, Heap::kHashSeedRootIndex);
+  __ SmiToInteger32(scratch, scratch);
+  __ addl(scratch, character);
+  __ movl(hash, scratch);
+  __ shll(scratch, Immediate(10));
+  __ addl(hash, scratch);
   // hash ^= hash >> 6;
   __ movl(scratch, hash);
   __ shrl(scratch, Immediate(6));
@@ -462,30 +462,52 @@ void KeyedLoadIC::GenerateGeneric(MacroAssembler* masm) {
   __ movl(rdi, FieldOperand(rax, String::kHashFieldOffset));
   __ shr(rdi, Immediate(String::kHashShift));
   __ xor_(rcx, rdi);
-  __ and_(rcx, Immediate(KeyedLookupCache::kCapacityMask));
-
-  // Load the key (consisting of map and symbol) from the cache and
-  // check for match.
+  ExternalReference cache_mask
+      = ExternalReference::keyed_lookup_cache_mask(masm->isolate());
+  __ andl(rcx, masm->ExternalOperand(cache_mask));
+
+  // Load the key (consisting of map and symbol) from each entry of the
+  // cache bucket and check for match.
+  Label load_in_object_property;
+  static const int kEntriesPerBucket = KeyedLookupCache::kEntriesPerBucket;
+  Label hit_on_nth_entry[kEntriesPerBucket];
   ExternalReference cache_keys
       = ExternalReference::keyed_lookup_cache_keys(masm->isolate());
   __ movq(rdi, rcx);
   __ shl(rdi, Immediate(kPointerSizeLog2 + 1));
   __ LoadAddress(kScratchRegister, cache_keys);
-  __ cmpq(rbx, Operand(kScratchRegister, rdi, times_1, 0));
+  for (int i = 0; i < kEntriesPerBucket - 1; i++) {
+    Label try_next_entry;
+    int offset = i * kPointerSize * 2;
+    __ cmpq(rbx, Operand(kScratchRegister, rdi, times_1, offset));
+    __ j(not_equal, &try_next_entry);
+    __ cmpq(rax,
+            Operand(kScratchRegister, rdi, times_1, offset + kPointerSize));
+    __ j(equal, &hit_on_nth_entry[i]);
+    __ bind(&try_next_entry);
+  }
+  int last_offset = (kEntriesPerBucket - 1) * kPointerSize * 2;
+  __ cmpq(rbx, Operand(kScratchRegister, rdi, times_1, last_offset));
   __ j(not_equal, &slow);
-  __ cmpq(rax, Operand(kScratchRegister, rdi, times_1, kPointerSize));
+  __ cmpq(rax,
+          Operand(kScratchRegister, rdi, times_1, last_offset + kPointerSize));
   __ j(not_equal, &slow);
 
   // Get field offset, which is a 32-bit integer.
   ExternalReference cache_field_offsets
       = ExternalReference::keyed_lookup_cache_field_offsets(masm->isolate());
-  __ LoadAddress(kScratchRegister, cache_field_offsets);
-  __ movl(rdi, Operand(kScratchRegister, rcx, times_4, 0));
-  __ movzxbq(rcx, FieldOperand(rbx, Map::kInObjectPropertiesOffset));
-  __ subq(rdi, rcx);
-  __ j(above_equal, &property_array_property);
+  for (int i = kEntriesPerBucket - 1; i >= 0; i--) {
+    __ bind(&hit_on_nth_entry[i]);
+    __ LoadAddress(kScratchRegister, cache_field_offsets);
+    __ movl(rdi, Operand(kScratchRegister, rcx, times_4, i * kIntSize));
+    __ movzxbq(rcx, FieldOperand(rbx, Map::kInObjectPropertiesOffset));
+    __ subq(rdi, rcx);
+    __ j(above_equal, &property_array_property);
+    if (i != 0) __ jmp(&load_in_object_property);
+  }
 
   // Load in-object property.
+  __ bind(&load_in_object_property);
   __ movzxbq(rcx, FieldOperand(rbx, Map::kInstanceSizeOffset));
   __ addq(rcx, rdi);
   __ movq(rax, FieldOperand(rdx, rcx, times_pointer_size, 0));
@@ -607,6 +629,7 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
   Label slow, slow_with_tagged_index, fast, array, extra, check_extra_double;
   Label fast_object_with_map_check, fast_object_without_map_check;
   Label fast_double_with_map_check, fast_double_without_map_check;
+  Label transition_smi_elements, finish_object_store;
 
   // Check that the object isn't a smi.
   __ JumpIfSmi(rdx, &slow_with_tagged_index);
@@ -709,7 +732,8 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
   __ bind(&non_smi_value);
   // Writing a non-smi, check whether array allows non-smi elements.
   // r9: receiver's map
-  __ CheckFastObjectElements(r9, &slow, Label::kNear);
+  __ CheckFastObjectElements(r9, &transition_smi_elements);
+  __ bind(&finish_object_store);
   __ movq(FieldOperand(rbx, rcx, times_pointer_size, FixedArray::kHeaderSize),
           rax);
   __ movq(rdx, rax);  // Preserve the value which is returned.
@@ -717,6 +741,28 @@ void KeyedStoreIC::GenerateGeneric(MacroAssembler* masm,
       rbx, rdx, rcx, kDontSaveFPRegs, EMIT_REMEMBERED_SET, OMIT_SMI_CHECK);
   __ ret(0);
 
+  __ bind(&transition_smi_elements);
+  // Arrays that still have the initial smi-only array map move to object
+  // elements in place.  Heap numbers need double elements, which are left
+  // to the runtime.
+  // r9: receiver's map
+  __ CompareRoot(FieldOperand(rax, HeapObject::kMapOffset),
+                 Heap::kHeapNumberMapRootIndex);
+  __ j(equal, &slow);
+  __ LoadGlobalFunction(Context::SMI_JS_ARRAY_MAP_INDEX, rdi);
+  __ cmpq(r9, rdi);
+  __ j(not_equal, &slow);
+  __ LoadGlobalFunction(Context::OBJECT_JS_ARRAY_MAP_INDEX, r9);
+  __ movq(FieldOperand(rdx, HeapObject::kMapOffset), r9);
+  __ RecordWriteField(rdx,
+                      HeapObject::kMapOffset,
+                      r9,
+                      rdi,
+                      kDontSaveFPRegs,
+                      EMIT_REMEMBERED_SET,
+                      OMIT_SMI_CHECK);
+  __ jmp(&finish_object_store);
+
   __ bind(&fast_double_with_map_check);
   // Check for fast double array case. If this fails, call through to the
   // runtime.
@@ -1274,6 +1320,19 @@ void LoadIC::GenerateNormal(MacroAssembler* masm) {
 
   GenerateStringDictionaryReceiverCheck(masm, rax, rdx, rbx, &miss);
 
+  if (FLAG_fast_properties_read_threshold > 0) {
+    // Count the read and let the runtime give the receiver fast properties
+    // back when it has been read often enough without changing shape.
+    Label not_counted;
+    __ movq(rbx, FieldOperand(rdx, StringDictionary::kReadCountOffset));
+    __ JumpIfNotSmi(rbx, &not_counted);
+    __ SmiAddConstant(rbx, rbx, Smi::FromInt(1));
+    __ movq(FieldOperand(rdx, StringDictionary::kReadCountOffset), rbx);
+    __ SmiCompare(rbx, Smi::FromInt(FLAG_fast_properties_read_threshold));
+    __ j(greater_equal, &miss);
+    __ bind(&not_counted);
+  }
+
   //  rdx: elements
   // Search the dictionary placing the result in rax.
   GenerateDictionaryLoad(masm, &miss, rdx, rcx, rbx, rdi, rax);
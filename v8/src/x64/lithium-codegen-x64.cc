@@ -101,6 +101,7 @@ void LCodeGen::Abort(const char* format, ...) {
     va_end(arguments);
     PrintF("\n");
   }
+  info()->set_bailout_reason(format);
   status_ = ABORTED;
 }
 
@@ -359,16 +360,36 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
                                 Translation* translation) {
   if (environment == NULL) return;
 
-  // The translation includes one command per value in the environment.
-  int translation_size = environment->values()->length();
+  // The translation includes one command per frame value in the environment.
+  int translation_size = environment->translation_size();
   // The output frame height does not include the parameters.
   int height = translation_size - environment->parameter_count();
 
   WriteTranslation(environment->outer(), translation);
   int closure_id = DefineDeoptimizationLiteral(environment->closure());
+  if (environment->has_dynamic_closure()) {
+    closure_id = Translation::DynamicClosureId(closure_id);
+  }
   translation->BeginFrame(environment->ast_id(), closure_id, height);
+  // The fields of captured objects follow the frame values.
+  int field_index = translation_size;
   for (int i = 0; i < translation_size; ++i) {
     LOperand* value = environment->values()->at(i);
+    LCapturedObject* captured = environment->CapturedObjectAt(i);
+    if (captured != NULL) {
+      int boilerplate_id =
+          DefineDeoptimizationLiteral(captured->boilerplate());
+      translation->StoreCapturedObject(boilerplate_id,
+                                       captured->field_count());
+      for (int j = 0; j < captured->field_count(); ++j) {
+        AddToTranslation(translation,
+                         environment->values()->at(field_index),
+                         environment->HasTaggedValueAt(field_index),
+                         environment->HasUint32ValueAt(field_index));
+        field_index++;
+      }
+      continue;
+    }
     // spilled_registers_ and spilled_double_registers_ are either
     // both NULL or both set.
     if (environment->spilled_registers() != NULL && value != NULL) {
@@ -377,7 +398,8 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         translation->MarkDuplicate();
         AddToTranslation(translation,
                          environment->spilled_registers()[value->index()],
-                         environment->HasTaggedValueAt(i));
+                         environment->HasTaggedValueAt(i),
+                         environment->HasUint32ValueAt(i));
       } else if (
           value->IsDoubleRegister() &&
           environment->spilled_double_registers()[value->index()] != NULL) {
@@ -385,18 +407,23 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
         AddToTranslation(
             translation,
             environment->spilled_double_registers()[value->index()],
+            false,
             false);
       }
     }
 
-    AddToTranslation(translation, value, environment->HasTaggedValueAt(i));
+    AddToTranslation(translation,
+                     value,
+                     environment->HasTaggedValueAt(i),
+                     environment->HasUint32ValueAt(i));
   }
 }
 
 
 void LCodeGen::AddToTranslation(Translation* translation,
                                 LOperand* op,
-                                bool is_tagged) {
+                                bool is_tagged,
+                                bool is_uint32) {
   if (op == NULL) {
     // TODO(twuerthinger): Introduce marker operands to indicate that this value
     // is not present and must be reconstructed from the deoptimizer. Currently
@@ -405,6 +432,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
   } else if (op->IsStackSlot()) {
     if (is_tagged) {
       translation->StoreStackSlot(op->index());
+    } else if (is_uint32) {
+      translation->StoreUint32StackSlot(op->index());
     } else {
       translation->StoreInt32StackSlot(op->index());
     }
@@ -418,6 +447,8 @@ void LCodeGen::AddToTranslation(Translation* translation,
     Register reg = ToRegister(op);
     if (is_tagged) {
       translation->StoreRegister(reg);
+    } else if (is_uint32) {
+      translation->StoreUint32Register(reg);
     } else {
       translation->StoreInt32Register(reg);
     }
@@ -559,6 +590,15 @@ void LCodeGen::PopulateDeoptimizationData(Handle<Code> code) {
   }
   data->SetLiteralArray(*literals);
 
+  const ZoneList<Handle<JSGlobalPropertyCell> >* cells =
+      graph()->dependent_cells();
+  Handle<FixedArray> dependent_cells =
+      factory()->NewFixedArray(cells->length(), TENURED);
+  for (int i = 0; i < cells->length(); i++) {
+    dependent_cells->set(i, *cells->at(i));
+  }
+  data->SetDependentCells(*dependent_cells);
+
   data->SetOsrAstId(Smi::FromInt(info_->osr_ast_id()));
   data->SetOsrPcOffset(Smi::FromInt(osr_pc_offset_));
 
@@ -752,6 +792,73 @@ void LCodeGen::DoUnknownOSRValue(LUnknownOSRValue* instr) {
 }
 
 
+void LCodeGen::DoMathMinMax(LMathMinMax* instr) {
+  LOperand* left = instr->InputAt(0);
+  LOperand* right = instr->InputAt(1);
+  ASSERT(left->Equals(instr->result()));
+  HMathMinMax::Operation operation = instr->hydrogen()->operation();
+  if (instr->hydrogen()->representation().IsInteger32()) {
+    Label return_left;
+    Condition condition = (operation == HMathMinMax::kMathMin)
+        ? less_equal
+        : greater_equal;
+    Register left_reg = ToRegister(left);
+    if (right->IsConstantOperand()) {
+      Immediate right_imm =
+          Immediate(ToInteger32(LConstantOperand::cast(right)));
+      __ cmpl(left_reg, right_imm);
+      __ j(condition, &return_left, Label::kNear);
+      __ movl(left_reg, right_imm);
+    } else if (right->IsRegister()) {
+      Register right_reg = ToRegister(right);
+      __ cmpl(left_reg, right_reg);
+      __ j(condition, &return_left, Label::kNear);
+      __ movl(left_reg, right_reg);
+    } else {
+      Operand right_op = ToOperand(right);
+      __ cmpl(left_reg, right_op);
+      __ j(condition, &return_left, Label::kNear);
+      __ movl(left_reg, right_op);
+    }
+    __ bind(&return_left);
+  } else {
+    ASSERT(instr->hydrogen()->representation().IsDouble());
+    Label check_nan_left, check_zero, return_left, return_right;
+    Condition condition = (operation == HMathMinMax::kMathMin) ? below : above;
+    XMMRegister left_reg = ToDoubleRegister(left);
+    XMMRegister right_reg = ToDoubleRegister(right);
+    __ ucomisd(left_reg, right_reg);
+    __ j(parity_even, &check_nan_left, Label::kNear);  // At least one NaN.
+    __ j(equal, &check_zero, Label::kNear);  // left == right.
+    __ j(condition, &return_left, Label::kNear);
+    __ jmp(&return_right, Label::kNear);
+
+    __ bind(&check_zero);
+    XMMRegister xmm_scratch = xmm0;
+    __ xorps(xmm_scratch, xmm_scratch);
+    __ ucomisd(left_reg, xmm_scratch);
+    __ j(not_equal, &return_left, Label::kNear);  // left == right != 0.
+    // At this point, both left and right are either 0 or -0.
+    if (operation == HMathMinMax::kMathMin) {
+      __ orpd(left_reg, right_reg);
+    } else {
+      // Since we operate on +0 and/or -0, addsd and andsd have the same
+      // effect.
+      __ addsd(left_reg, right_reg);
+    }
+    __ jmp(&return_left, Label::kNear);
+
+    __ bind(&check_nan_left);
+    __ ucomisd(left_reg, left_reg);  // NaN check.
+    __ j(parity_even, &return_left, Label::kNear);  // left == NaN.
+    __ bind(&return_right);
+    __ movsd(left_reg, right_reg);
+
+    __ bind(&return_left);
+  }
+}
+
+
 void LCodeGen::DoModI(LModI* instr) {
   if (instr->hydrogen()->HasPowerOf2Divisor()) {
     Register dividend = ToRegister(instr->InputAt(0));
@@ -905,9 +1012,11 @@ void LCodeGen::DoDivI(LDivI* instr) {
   __ cdq();
   __ idivl(right_reg);
 
-  // Deoptimize if remainder is not 0.
-  __ testl(rdx, rdx);
-  DeoptimizeIf(not_zero, instr->environment());
+  // Deoptimize if remainder is not 0, unless the result is truncated.
+  if (!instr->hydrogen()->all_uses_truncating()) {
+    __ testl(rdx, rdx);
+    DeoptimizeIf(not_zero, instr->environment());
+  }
 }
 
 
@@ -1201,6 +1310,49 @@ void LCodeGen::DoValueOf(LValueOf* instr) {
 }
 
 
+void LCodeGen::DoDateField(LDateField* instr) {
+  Register object = ToRegister(instr->InputAt(0));
+  Register result = ToRegister(instr->result());
+  Smi* index = instr->index();
+  Label runtime, done;
+  ASSERT(object.is(result));
+  ASSERT(object.is(rax));
+
+#ifdef DEBUG
+  __ AbortIfSmi(object);
+  __ CmpObjectType(object, JS_DATE_TYPE, kScratchRegister);
+  __ Assert(equal, "Trying to get date field from non-date.");
+#endif
+
+  if (index->value() == 0) {
+    __ movq(result, FieldOperand(object, JSDate::kValueOffset));
+  } else {
+    if (index->value() < JSDate::kFirstUncachedField) {
+      ExternalReference stamp = ExternalReference::date_cache_stamp(isolate());
+      __ Load(kScratchRegister, stamp);
+      __ cmpq(kScratchRegister, FieldOperand(object,
+                                             JSDate::kCacheStampOffset));
+      __ j(not_equal, &runtime, Label::kNear);
+      __ movq(result, FieldOperand(object, JSDate::kValueOffset +
+                                           kPointerSize * index->value()));
+      __ jmp(&done);
+    }
+    __ bind(&runtime);
+    __ PrepareCallCFunction(2);
+#ifdef _WIN64
+    __ movq(rcx, object);
+    __ Move(rdx, index);
+#else
+    __ movq(rdi, object);
+    __ Move(rsi, index);
+#endif
+    __ CallCFunction(ExternalReference::get_date_field_function(isolate()), 2);
+    __ movq(rsi, Operand(rbp, StandardFrameConstants::kContextOffset));
+    __ bind(&done);
+  }
+}
+
+
 void LCodeGen::DoBitNotI(LBitNotI* instr) {
   LOperand* input = instr->InputAt(0);
   ASSERT(input->Equals(instr->result()));
@@ -1674,6 +1826,28 @@ void LCodeGen::DoStringCompareAndBranch(LStringCompareAndBranch* instr) {
   int true_block = chunk_->LookupDestination(instr->true_block_id());
   int false_block = chunk_->LookupDestination(instr->false_block_id());
 
+  if (op == Token::EQ || op == Token::EQ_STRICT) {
+    // Identical strings are equal.  Different symbols and strings of
+    // different lengths are not.
+    Register left = ToRegister(instr->InputAt(0));
+    Register right = ToRegister(instr->InputAt(1));
+    Label* true_label = chunk_->GetAssemblyLabel(true_block);
+    Label* false_label = chunk_->GetAssemblyLabel(false_block);
+    __ cmpq(left, right);
+    __ j(equal, true_label);
+    __ movq(rbx, FieldOperand(left, HeapObject::kMapOffset));
+    __ movq(rcx, FieldOperand(right, HeapObject::kMapOffset));
+    __ movzxbl(rbx, FieldOperand(rbx, Map::kInstanceTypeOffset));
+    __ movzxbl(rcx, FieldOperand(rcx, Map::kInstanceTypeOffset));
+    STATIC_ASSERT(kSymbolTag != 0);
+    __ andl(rbx, rcx);
+    __ testl(rbx, Immediate(kIsSymbolMask));
+    __ j(not_zero, false_label);
+    __ movq(rbx, FieldOperand(left, String::kLengthOffset));
+    __ cmpq(rbx, FieldOperand(right, String::kLengthOffset));
+    __ j(not_equal, false_label);
+  }
+
   Handle<Code> ic = CompareIC::GetUninitialized(op);
   CallCode(ic, RelocInfo::CODE_TARGET, instr);
 
@@ -2109,6 +2283,18 @@ void LCodeGen::DoStoreContextSlot(LStoreContextSlot* instr) {
 
 void LCodeGen::DoLoadNamedField(LLoadNamedField* instr) {
   Register object = ToRegister(instr->InputAt(0));
+  if (instr->hydrogen()->is_double_field()) {
+    Register box = ToRegister(instr->TempAt(0));
+    EmitLoadMutableHeapNumber(box,
+                              object,
+                              instr->hydrogen()->is_in_object(),
+                              instr->hydrogen()->offset(),
+                              instr->environment());
+    __ movsd(ToDoubleRegister(instr->result()),
+             FieldOperand(box, HeapNumber::kValueOffset));
+    return;
+  }
+
   Register result = ToRegister(instr->result());
   if (instr->hydrogen()->is_in_object()) {
     __ movq(result, FieldOperand(object, instr->hydrogen()->offset()));
@@ -2119,6 +2305,25 @@ void LCodeGen::DoLoadNamedField(LLoadNamedField* instr) {
 }
 
 
+void LCodeGen::EmitLoadMutableHeapNumber(Register box,
+                                         Register object,
+                                         bool is_in_object,
+                                         int offset,
+                                         LEnvironment* env) {
+  if (is_in_object) {
+    __ movq(box, FieldOperand(object, offset));
+  } else {
+    __ movq(box, FieldOperand(object, JSObject::kPropertiesOffset));
+    __ movq(box, FieldOperand(box, offset));
+  }
+  Condition is_smi = masm()->CheckSmi(box);
+  DeoptimizeIf(is_smi, env);
+  __ CompareRoot(FieldOperand(box, HeapObject::kMapOffset),
+                 Heap::kMutableHeapNumberMapRootIndex);
+  DeoptimizeIf(not_equal, env);
+}
+
+
 void LCodeGen::EmitLoadFieldOrConstantFunction(Register result,
                                                Register object,
                                                Handle<Map> type,
@@ -2392,11 +2597,10 @@ void LCodeGen::DoLoadKeyedSpecializedArrayElement(
         break;
       case EXTERNAL_UNSIGNED_INT_ELEMENTS:
         __ movl(result, operand);
-        __ testl(result, result);
-        // TODO(danno): we could be more clever here, perhaps having a special
-        // version of the stub that detects if the overflow case actually
-        // happens, and generate code that returns a double rather than int.
-        DeoptimizeIf(negative, instr->environment());
+        if (!instr->hydrogen_value()->IsUint32()) {
+          __ testl(result, result);
+          DeoptimizeIf(negative, instr->environment());
+        }
         break;
       case EXTERNAL_FLOAT_ELEMENTS:
       case EXTERNAL_DOUBLE_ELEMENTS:
@@ -2422,6 +2626,14 @@ void LCodeGen::DoLoadKeyedGeneric(LLoadKeyedGeneric* instr) {
 
 
 void LCodeGen::DoArgumentsElements(LArgumentsElements* instr) {
+  if (instr->hydrogen()->from_inlined()) {
+    // The arguments of an inlined function were just pushed.  The result is
+    // biased like a frame pointer, for LAccessArgumentsAt.
+    Register result = ToRegister(instr->result());
+    __ lea(result, Operand(rsp, -2 * kPointerSize));
+    return;
+  }
+
   Register result = ToRegister(instr->result());
 
   // Check for arguments adapter frame.
@@ -2561,6 +2773,11 @@ void LCodeGen::DoPushArgument(LPushArgument* instr) {
 }
 
 
+void LCodeGen::DoDrop(LDrop* instr) {
+  __ Drop(instr->count());
+}
+
+
 void LCodeGen::DoThisFunction(LThisFunction* instr) {
   Register result = ToRegister(instr->result());
   LoadHeapObject(result, instr->hydrogen()->closure());
@@ -2609,8 +2826,19 @@ void LCodeGen::CallKnownFunction(Handle<JSFunction> function,
 
   // Set rax to arguments count if adaption is not needed. Assumes that rax
   // is available to write to at this point.
+  int formal_count = function->shared()->formal_parameter_count();
   if (!function->NeedsArgumentsAdaption()) {
     __ Set(rax, arity);
+  } else if (arity != formal_count) {
+    // The target does not look at the actual argument count, so adapt the
+    // arguments here instead of going through the arguments adaptor.
+    ASSERT(!function->shared()->uses_arguments());
+    if (arity < formal_count) {
+      __ LoadRoot(kScratchRegister, Heap::kUndefinedValueRootIndex);
+      for (int i = arity; i < formal_count; i++) __ push(kScratchRegister);
+    } else {
+      __ Drop(arity - formal_count);
+    }
   }
 
   LPointerMap* pointers = instr->pointer_map();
@@ -3064,9 +3292,22 @@ void LCodeGen::DoCallRuntime(LCallRuntime* instr) {
 
 void LCodeGen::DoStoreNamedField(LStoreNamedField* instr) {
   Register object = ToRegister(instr->object());
-  Register value = ToRegister(instr->value());
   int offset = instr->offset();
 
+  if (instr->hydrogen()->is_double_field()) {
+    // Update the field's mutable heap number in place.
+    Register box = ToRegister(instr->TempAt(0));
+    EmitLoadMutableHeapNumber(box,
+                              object,
+                              instr->is_in_object(),
+                              offset,
+                              instr->environment());
+    __ movsd(FieldOperand(box, HeapNumber::kValueOffset),
+             ToDoubleRegister(instr->value()));
+    return;
+  }
+
+  Register value = ToRegister(instr->value());
   if (!instr->transition().is_null()) {
     __ Move(FieldOperand(object, HeapObject::kMapOffset), instr->transition());
   }
@@ -3245,6 +3486,109 @@ void LCodeGen::DoStoreKeyedFastDoubleElement(
   __ movsd(double_store_operand, value);
 }
 
+void LCodeGen::EmitFastDoubleArrayOperand(Register operand,
+                                          bool is_array,
+                                          Register limit,
+                                          XMMRegister scalar,
+                                          Label* bailout) {
+  if (is_array) {
+    __ JumpIfSmi(operand, bailout);
+    __ CmpObjectType(operand, JS_ARRAY_TYPE, kScratchRegister);
+    __ j(not_equal, bailout);
+    __ movzxbl(kScratchRegister,
+               FieldOperand(kScratchRegister, Map::kBitField2Offset));
+    __ andl(kScratchRegister, Immediate(Map::kElementsKindMask));
+    __ cmpl(kScratchRegister,
+            Immediate(FAST_DOUBLE_ELEMENTS << Map::kElementsKindShift));
+    __ j(not_equal, bailout);
+    Label in_bounds;
+    __ SmiCompare(limit, FieldOperand(operand, JSArray::kLengthOffset));
+    __ j(less_equal, &in_bounds, Label::kNear);
+    __ movq(limit, FieldOperand(operand, JSArray::kLengthOffset));
+    __ bind(&in_bounds);
+    __ movq(operand, FieldOperand(operand, JSObject::kElementsOffset));
+  } else {
+    Label is_smi, loaded;
+    __ JumpIfSmi(operand, &is_smi, Label::kNear);
+    __ CompareRoot(FieldOperand(operand, HeapObject::kMapOffset),
+                   Heap::kHeapNumberMapRootIndex);
+    __ j(not_equal, bailout);
+    __ movsd(scalar, FieldOperand(operand, HeapNumber::kValueOffset));
+    __ jmp(&loaded, Label::kNear);
+    __ bind(&is_smi);
+    __ SmiToInteger32(kScratchRegister, operand);
+    __ cvtlsi2sd(scalar, kScratchRegister);
+    __ bind(&loaded);
+    __ unpcklpd(scalar, scalar);
+  }
+}
+
+
+void LCodeGen::DoFastDoubleArrayMap(LFastDoubleArrayMap* instr) {
+  HFastDoubleArrayMap* hinstr = instr->hydrogen();
+  Register target = ToRegister(instr->target());
+  Register left = ToRegister(instr->left());
+  Register right = ToRegister(instr->right());
+  Register index = ToRegister(instr->start());
+  Register limit = ToRegister(instr->limit());
+  ASSERT(index.is(ToRegister(instr->result())));
+  // The instruction is marked as a call, so every allocatable register is
+  // free to use here.
+  XMMRegister left_value = xmm1;
+  XMMRegister right_value = xmm2;
+  XMMRegister nan_mask = xmm3;
+  Label loop, exit, done;
+
+  // Anything unexpected leaves all elements to the scalar loop.
+  __ JumpUnlessNonNegativeSmi(index, &done);
+  __ JumpIfNotSmi(limit, &done);
+  EmitFastDoubleArrayOperand(target, true, limit, xmm0, &done);
+  EmitFastDoubleArrayOperand(
+      left, hinstr->left_is_array(), limit, left_value, &done);
+  EmitFastDoubleArrayOperand(
+      right, hinstr->right_is_array(), limit, right_value, &done);
+
+  // Each iteration handles the elements at index and index + 1.
+  __ SmiToInteger32(index, index);
+  __ SmiToInteger32(limit, limit);
+  __ subl(limit, Immediate(1));
+  __ bind(&loop);
+  __ cmpl(index, limit);
+  __ j(greater_equal, &exit);
+  if (hinstr->left_is_array()) {
+    __ movupd(xmm0, FieldOperand(left, index, times_8,
+                                 FixedDoubleArray::kHeaderSize));
+  } else {
+    __ movaps(xmm0, left_value);
+  }
+  if (hinstr->right_is_array()) {
+    __ movupd(right_value, FieldOperand(right, index, times_8,
+                                        FixedDoubleArray::kHeaderSize));
+  }
+  switch (hinstr->op()) {
+    case Token::ADD: __ addpd(xmm0, right_value); break;
+    case Token::SUB: __ subpd(xmm0, right_value); break;
+    case Token::MUL: __ mulpd(xmm0, right_value); break;
+    case Token::DIV: __ divpd(xmm0, right_value); break;
+    default: UNREACHABLE();
+  }
+  // NaN results, including those computed from holes, are left to the
+  // scalar loop.
+  __ movaps(nan_mask, xmm0);
+  __ cmpunordpd(nan_mask, nan_mask);
+  __ movmskpd(kScratchRegister, nan_mask);
+  __ testl(kScratchRegister, kScratchRegister);
+  __ j(not_zero, &exit);
+  __ movupd(FieldOperand(target, index, times_8,
+                         FixedDoubleArray::kHeaderSize), xmm0);
+  __ addl(index, Immediate(2));
+  __ jmp(&loop);
+  __ bind(&exit);
+  __ Integer32ToSmi(index, index);
+  __ bind(&done);
+}
+
+
 void LCodeGen::DoStoreKeyedGeneric(LStoreKeyedGeneric* instr) {
   ASSERT(ToRegister(instr->object()).is(rdx));
   ASSERT(ToRegister(instr->key()).is(rcx));
@@ -3299,10 +3643,89 @@ void LCodeGen::DoTransitionElementsKind(LTransitionElementsKind* instr) {
 
 
 void LCodeGen::DoStringAdd(LStringAdd* instr) {
-  EmitPushTaggedOperand(instr->left());
-  EmitPushTaggedOperand(instr->right());
+  Register left = ToRegister(instr->left());
+  Register right = ToRegister(instr->right());
+  ASSERT(left.is(rdx));
+  ASSERT(right.is(rax));
+  ASSERT(ToRegister(instr->result()).is(rax));
+
+  Label call_stub, done;
+  if (FLAG_inline_new) {
+    // Adding an empty string returns the other string.
+    Label both_not_empty;
+    __ movq(rbx, FieldOperand(left, String::kLengthOffset));
+    __ SmiTest(rbx);
+    __ j(zero, &done);
+    __ movq(rcx, FieldOperand(right, String::kLengthOffset));
+    __ SmiTest(rcx);
+    __ j(not_zero, &both_not_empty, Label::kNear);
+    __ movq(rax, left);
+    __ jmp(&done);
+    __ bind(&both_not_empty);
+
+    // Results shorter than a cons string are flat strings, which the stub
+    // builds.  Exceptionally long results are handled by the stub too.
+    STATIC_ASSERT(String::kMaxLength <= Smi::kMaxValue / 2);
+    __ SmiAdd(rbx, rbx, rcx);
+    __ SmiCompare(rbx, Smi::FromInt(String::kMinNonFlatLength));
+    __ j(below, &call_stub);
+    __ SmiCompare(rbx, Smi::FromInt(String::kMaxLength));
+    __ j(above, &call_stub);
+
+    // The depth of the result is one more than that of its deeper part.
+    // Too deep results are rebalanced by the runtime system.
+    Label left_is_flat, right_is_flat;
+    __ Move(rdi, Smi::FromInt(0));
+    __ movq(rcx, FieldOperand(left, HeapObject::kMapOffset));
+    __ movzxbl(rcx, FieldOperand(rcx, Map::kInstanceTypeOffset));
+    __ movl(r11, rcx);
+    __ andl(r11, Immediate(kStringRepresentationMask));
+    __ cmpl(r11, Immediate(kConsStringTag));
+    __ j(not_equal, &left_is_flat, Label::kNear);
+    __ movq(rdi, FieldOperand(left, ConsString::kDepthOffset));
+    __ bind(&left_is_flat);
+    __ movq(r11, FieldOperand(right, HeapObject::kMapOffset));
+    __ movzxbl(r11, FieldOperand(r11, Map::kInstanceTypeOffset));
+    __ andl(rcx, r11);
+    __ andl(r11, Immediate(kStringRepresentationMask));
+    __ cmpl(r11, Immediate(kConsStringTag));
+    __ j(not_equal, &right_is_flat, Label::kNear);
+    __ movq(r11, FieldOperand(right, ConsString::kDepthOffset));
+    __ SmiCompare(r11, rdi);
+    __ j(less_equal, &right_is_flat, Label::kNear);
+    __ movq(rdi, r11);
+    __ bind(&right_is_flat);
+    __ SmiAddConstant(rdi, rdi, Smi::FromInt(1));
+    __ SmiCompare(rdi, Smi::FromInt(ConsString::kMaxDepth));
+    __ j(greater, &call_stub);
+
+    // The result is an ASCII cons string if both strings are ASCII.
+    Label two_byte, allocated;
+    STATIC_ASSERT((kStringEncodingMask & kAsciiStringTag) != 0);
+    STATIC_ASSERT((kStringEncodingMask & kTwoByteStringTag) == 0);
+    __ testl(rcx, Immediate(kStringEncodingMask));
+    __ j(zero, &two_byte, Label::kNear);
+    __ AllocateAsciiConsString(rcx, r11, no_reg, &call_stub);
+    __ jmp(&allocated, Label::kNear);
+    __ bind(&two_byte);
+    __ AllocateTwoByteConsString(rcx, r11, no_reg, &call_stub);
+    __ bind(&allocated);
+    __ movq(FieldOperand(rcx, ConsString::kLengthOffset), rbx);
+    __ movq(FieldOperand(rcx, ConsString::kHashFieldOffset),
+            Immediate(String::kEmptyHashField));
+    __ movq(FieldOperand(rcx, ConsString::kFirstOffset), left);
+    __ movq(FieldOperand(rcx, ConsString::kSecondOffset), right);
+    __ movq(FieldOperand(rcx, ConsString::kDepthOffset), rdi);
+    __ movq(rax, rcx);
+    __ jmp(&done);
+  }
+
+  __ bind(&call_stub);
+  __ push(left);
+  __ push(right);
   StringAddStub stub(NO_STRING_CHECK_IN_STUB);
   CallCode(stub.GetCode(), RelocInfo::CODE_TARGET, instr);
+  __ bind(&done);
 }
 
 
@@ -3408,6 +3831,13 @@ void LCodeGen::DoDeferredStringCharFromCode(LStringCharFromCode* instr) {
 }
 
 
+void LCodeGen::DoStringHashField(LStringHashField* instr) {
+  Register string = ToRegister(instr->string());
+  Register result = ToRegister(instr->result());
+  __ movl(result, FieldOperand(string, String::kHashFieldOffset));
+}
+
+
 void LCodeGen::DoStringLength(LStringLength* instr) {
   Register string = ToRegister(instr->string());
   Register result = ToRegister(instr->result());
@@ -3428,6 +3858,15 @@ void LCodeGen::DoInteger32ToDouble(LInteger32ToDouble* instr) {
 }
 
 
+void LCodeGen::DoUint32ToDouble(LUint32ToDouble* instr) {
+  LOperand* input = instr->InputAt(0);
+  LOperand* output = instr->result();
+  // Zero-extend the value and convert it as a 64-bit integer.
+  __ movl(kScratchRegister, ToRegister(input));
+  __ cvtqsi2sd(ToDoubleRegister(output), kScratchRegister);
+}
+
+
 void LCodeGen::DoNumberTagI(LNumberTagI* instr) {
   LOperand* input = instr->InputAt(0);
   ASSERT(input->IsRegister() && input->Equals(instr->result()));
@@ -3437,6 +3876,70 @@ void LCodeGen::DoNumberTagI(LNumberTagI* instr) {
 }
 
 
+void LCodeGen::DoNumberTagU(LNumberTagU* instr) {
+  class DeferredNumberTagU: public LDeferredCode {
+   public:
+    DeferredNumberTagU(LCodeGen* codegen, LNumberTagU* instr)
+        : LDeferredCode(codegen), instr_(instr) { }
+    virtual void Generate() { codegen()->DoDeferredNumberTagU(instr_); }
+    virtual LInstruction* instr() { return instr_; }
+   private:
+    LNumberTagU* instr_;
+  };
+
+  LOperand* input = instr->InputAt(0);
+  ASSERT(input->IsRegister() && input->Equals(instr->result()));
+  Register reg = ToRegister(input);
+
+  DeferredNumberTagU* deferred = new DeferredNumberTagU(this, instr);
+  __ cmpl(reg, Immediate(Smi::kMaxValue));
+  __ j(above, deferred->entry());
+  __ Integer32ToSmi(reg, reg);
+  __ bind(deferred->exit());
+}
+
+
+void LCodeGen::DoDeferredNumberTagU(LNumberTagU* instr) {
+  Label slow;
+  Register reg = ToRegister(instr->InputAt(0));
+  Register tmp = reg.is(rax) ? rcx : rax;
+  // The temp is an allocatable double register, so the runtime call
+  // preserves it.
+  XMMRegister value = ToDoubleRegister(instr->TempAt(0));
+
+  // Preserve the value of all registers.
+  PushSafepointRegistersScope scope(this);
+
+  // The value does not fit in a smi. Try to allocate a heap number in new
+  // space and store the value in there. If that fails, call the runtime
+  // system.
+  Label done;
+  __ movl(reg, reg);
+  __ cvtqsi2sd(value, reg);
+  if (FLAG_inline_new) {
+    __ AllocateHeapNumber(reg, tmp, &slow);
+    __ jmp(&done, Label::kNear);
+  }
+
+  // Slow case: Call the runtime system to do the number allocation.
+  __ bind(&slow);
+
+  // Put a valid pointer value in the stack slot where the result register
+  // is stored, as this register is in the pointer map, but contains an
+  // integer value.
+  __ Set(kScratchRegister, 0);
+  __ StoreToSafepointRegisterSlot(reg, kScratchRegister);
+  CallRuntimeFromDeferred(Runtime::kAllocateHeapNumber, 0, instr);
+  if (!reg.is(rax)) __ movq(reg, rax);
+
+  // Done. Put the value in the temp into the value of the allocated heap
+  // number.
+  __ bind(&done);
+  __ movsd(FieldOperand(reg, HeapNumber::kValueOffset), value);
+  __ StoreToSafepointRegisterSlot(reg, reg);
+}
+
+
 void LCodeGen::DoNumberTagD(LNumberTagD* instr) {
   class DeferredNumberTagD: public LDeferredCode {
    public:
@@ -3882,8 +4385,6 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 
   // Copy object header.
   ASSERT(object->properties()->length() == 0);
-  ASSERT(object->elements()->length() == 0 ||
-         object->elements()->map() == isolate()->heap()->fixed_cow_array_map());
   int inobject_properties = object->map()->inobject_properties();
   int header_size = size - inobject_properties * kPointerSize;
   for (int i = 0; i < header_size; i += kPointerSize) {
@@ -3891,6 +4392,24 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
     __ movq(FieldOperand(result, current_offset + i), rcx);
   }
 
+  // Copy the elements of a small array literal to right after it.
+  Handle<FixedArrayBase> elements(object->elements());
+  if (elements->length() > 0 &&
+      elements->map() != isolate()->heap()->fixed_cow_array_map()) {
+    ASSERT(object->IsJSArray() && inobject_properties == 0);
+    int elements_offset = *offset;
+    int elements_size = elements->Size();
+    *offset += elements_size;
+    __ lea(rcx, Operand(result, elements_offset));
+    __ movq(FieldOperand(result, current_offset + JSObject::kElementsOffset),
+            rcx);
+    __ movq(source, FieldOperand(source, JSObject::kElementsOffset));
+    for (int i = 0; i < elements_size; i += kPointerSize) {
+      __ movq(rcx, FieldOperand(source, i));
+      __ movq(FieldOperand(result, elements_offset + i), rcx);
+    }
+  }
+
   // Copy in-object properties.
   for (int i = 0; i < inobject_properties; i++) {
     int total_offset = current_offset + object->GetInObjectPropertyOffset(i);
@@ -3912,8 +4431,58 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 }
 
 
+void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
+  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
+  Handle<Map> initial_map = instr->hydrogen()->initial_map();
+  int instance_size = initial_map->instance_size();
+
+  // Deoptimize if the constructor got a new initial map since, for
+  // example because its prototype was replaced.
+  LoadHeapObject(rcx, constructor);
+  __ Cmp(FieldOperand(rcx, JSFunction::kPrototypeOrInitialMapOffset),
+         initial_map);
+  DeoptimizeIf(not_equal, instr->environment());
+
+  // The object is always allocated in new space, so the stores that
+  // initialize its properties need no write barrier.
+  Label allocated, runtime_allocate;
+  __ AllocateInNewSpace(instance_size, rax, rcx, rdx, &runtime_allocate,
+                        TAG_OBJECT);
+  __ jmp(&allocated);
+
+  __ bind(&runtime_allocate);
+  __ Push(Smi::FromInt(instance_size));
+  CallRuntime(Runtime::kAllocateInNewSpace, 1, instr);
+
+  __ bind(&allocated);
+  __ Move(FieldOperand(rax, JSObject::kMapOffset), initial_map);
+  __ LoadRoot(rcx, Heap::kEmptyFixedArrayRootIndex);
+  __ movq(FieldOperand(rax, JSObject::kPropertiesOffset), rcx);
+  __ movq(FieldOperand(rax, JSObject::kElementsOffset), rcx);
+  // The in-object properties follow the header.
+  ASSERT(initial_map->instance_size() ==
+         JSObject::kHeaderSize +
+         initial_map->inobject_properties() * kPointerSize);
+  __ LoadRoot(rcx, Heap::kUndefinedValueRootIndex);
+  for (int offset = JSObject::kHeaderSize;
+       offset < instance_size;
+       offset += kPointerSize) {
+    __ movq(FieldOperand(rax, offset), rcx);
+  }
+}
+
+
 void LCodeGen::DoObjectLiteralFast(LObjectLiteralFast* instr) {
   int size = instr->hydrogen()->total_size();
+  Handle<JSObject> boilerplate = instr->hydrogen()->boilerplate();
+
+  // Deoptimize if the elements kind of the boilerplate changed since.
+  if (instr->hydrogen()->copies_elements()) {
+    LoadHeapObject(rbx, boilerplate);
+    __ Cmp(FieldOperand(rbx, HeapObject::kMapOffset),
+           Handle<Map>(boilerplate->map()));
+    DeoptimizeIf(not_equal, instr->environment());
+  }
 
   // Allocate all objects that are part of the literal in one big
   // allocation. This avoids multiple limit checks.
@@ -3927,8 +4496,8 @@ void LCodeGen::DoObjectLiteralFast(LObjectLiteralFast* instr) {
 
   __ bind(&allocated);
   int offset = 0;
-  LoadHeapObject(rbx, instr->hydrogen()->boilerplate());
-  EmitDeepCopy(instr->hydrogen()->boilerplate(), rax, rbx, &offset);
+  LoadHeapObject(rbx, boilerplate);
+  EmitDeepCopy(boilerplate, rax, rbx, &offset);
   ASSERT_EQ(size, offset);
 }
 
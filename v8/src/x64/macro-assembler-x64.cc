@@ -197,7 +197,7 @@ void MacroAssembler::CompareRoot(const Operand& with,
 }
 
 
-void MacroAssembler::RememberedSetHelper(Register object,  // For debug tests.
+void MacroAssembler::RememberedSetHelper(Register object,
                                          Register addr,
                                          Register scratch,
                                          SaveFPRegsMode save_fp,
@@ -208,6 +208,29 @@ void MacroAssembler::RememberedSetHelper(Register object,  // For debug tests.
     int3();
     bind(&ok);
   }
+  Label done;
+  Label use_store_buffer;
+  ASSERT(!scratch.is(object));
+  CheckPageFlag(object,
+                scratch,
+                1 << MemoryChunk::USES_CARD_TABLE,
+                zero,
+                &use_store_buffer,
+                Label::kNear);
+  // Dirty the card of the slot.  CheckPageFlag left the chunk of the holder
+  // in scratch, which is also the chunk of the slot for large objects.
+  subq(addr, scratch);
+  shr(addr, Immediate(MemoryChunk::kCardSizeLog2));
+  movq(scratch, Operand(scratch, MemoryChunk::kCardTableOffset));
+  movb(Operand(scratch, addr, times_1, 0),
+       Immediate(MemoryChunk::kDirtyCard));
+  if (and_then == kReturnAtEnd) {
+    ret(0);
+  } else {
+    ASSERT(and_then == kFallThroughAtEnd);
+    jmp(&done);
+  }
+  bind(&use_store_buffer);
   // Load store buffer top.
   LoadRoot(scratch, Heap::kStoreBufferTopRootIndex);
   // Store pointer to buffer.
@@ -217,7 +240,6 @@ void MacroAssembler::RememberedSetHelper(Register object,  // For debug tests.
   // Write back new top of buffer.
   StoreRoot(scratch, Heap::kStoreBufferTopRootIndex);
   // Call stub on end of buffer.
-  Label done;
   // Check for end of buffer.
   testq(scratch, Immediate(StoreBuffer::kStoreBufferOverflowBit));
   if (and_then == kReturnAtEnd) {
@@ -164,8 +164,9 @@ class MacroAssembler: public Assembler {
 
   // Record in the remembered set the fact that we have a pointer to new space
   // at the address pointed to by the addr register.  Only works if addr is not
-  // in new space.
-  void RememberedSetHelper(Register object,  // Used for debug code.
+  // in new space.  If the page of the object holding the slot uses a card
+  // table the card of the slot is dirtied instead, which clobbers addr.
+  void RememberedSetHelper(Register object,  // Holder of the slot.
                            Register addr,
                            Register scratch,
                            SaveFPRegsMode save_fp,
@@ -166,6 +166,7 @@ void RegExpMacroAssemblerX64::AdvanceRegister(int reg, int by) {
 
 void RegExpMacroAssemblerX64::Backtrack() {
   CheckPreemption();
+  CheckBacktrackLimit();
   // Pop Code* offset from backtrack stack, add Code* and jump to location.
   Pop(rbx);
   __ addq(rbx, code_object_pointer());
@@ -963,6 +964,12 @@ Handle<HeapObject> RegExpMacroAssemblerX64::GetCode(Handle<String> source) {
     SafeReturn();
   }
 
+  if (backtrack_limit_label_.is_linked()) {
+    // Reached if the backtrack budget has been used up.
+    __ bind(&backtrack_limit_label_);
+    __ jmp(&exit_with_exception);
+  }
+
   if (exit_with_exception.is_linked()) {
     // If any of the code above needed to exit with an exception.
     __ bind(&exit_with_exception);
@@ -1378,6 +1385,16 @@ void RegExpMacroAssemblerX64::CheckPreemption() {
 }
 
 
+void RegExpMacroAssemblerX64::CheckBacktrackLimit() {
+  if (FLAG_regexp_backtrack_limit <= 0) return;
+  ExternalReference backtracks_left =
+      ExternalReference::address_of_regexp_backtracks_left(masm_.isolate());
+  __ movq(kScratchRegister, backtracks_left);
+  __ subl(Operand(kScratchRegister, 0), Immediate(1));
+  __ j(zero, &backtrack_limit_label_);
+}
+
+
 void RegExpMacroAssemblerX64::CheckStackLimit() {
   Label no_stack_overflow;
   ExternalReference stack_limit =
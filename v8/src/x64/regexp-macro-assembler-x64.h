@@ -197,6 +197,9 @@ class RegExpMacroAssemblerX64: public NativeRegExpMacroAssembler {
   // Check whether preemption has been requested.
   void CheckPreemption();
 
+  // Count a backtrack against the budget set by --regexp-backtrack-limit.
+  void CheckBacktrackLimit();
+
   // Check whether we are exceeding the stack limit on the backtrack stack.
   void CheckStackLimit();
 
@@ -279,6 +282,7 @@ class RegExpMacroAssemblerX64: public NativeRegExpMacroAssembler {
   Label exit_label_;
   Label check_preempt_label_;
   Label stack_overflow_label_;
+  Label backtrack_limit_label_;
 };
 
 #endif  // V8_INTERPRETED_REGEXP
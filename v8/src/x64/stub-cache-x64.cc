@@ -154,6 +154,11 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   ASSERT(!scratch.is(no_reg));
   ASSERT(extra2.is(no_reg));
 
+  Counters* counters = isolate->counters();
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
+  __ IncrementCounter(counters->stub_cache_probes(), 1);
+
   // Check that the receiver isn't a smi.
   __ JumpIfSmi(receiver, &miss);
 
@@ -162,19 +167,20 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   // Use only the low 32 bits of the map pointer.
   __ addl(scratch, FieldOperand(receiver, HeapObject::kMapOffset));
   __ xor_(scratch, Immediate(flags));
-  __ and_(scratch, Immediate((kPrimaryTableSize - 1) << kHeapObjectTagSize));
+  __ andl(scratch, masm->ExternalOperand(primary_mask));
 
   // Probe the primary table.
   ProbeTable(isolate, masm, flags, kPrimary, name, scratch);
 
   // Primary miss: Compute hash for secondary probe.
+  __ IncrementCounter(counters->stub_cache_secondary_probes(), 1);
   __ movl(scratch, FieldOperand(name, String::kHashFieldOffset));
   __ addl(scratch, FieldOperand(receiver, HeapObject::kMapOffset));
   __ xor_(scratch, Immediate(flags));
-  __ and_(scratch, Immediate((kPrimaryTableSize - 1) << kHeapObjectTagSize));
+  __ andl(scratch, masm->ExternalOperand(primary_mask));
   __ subl(scratch, name);
   __ addl(scratch, Immediate(flags));
-  __ and_(scratch, Immediate((kSecondaryTableSize - 1) << kHeapObjectTagSize));
+  __ andl(scratch, masm->ExternalOperand(secondary_mask));
 
   // Probe the secondary table.
   ProbeTable(isolate, masm, flags, kSecondary, name, scratch);
@@ -182,6 +188,7 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   // Cache miss: Fall-through and let caller handle the miss by
   // entering the runtime system.
   __ bind(&miss);
+  __ IncrementCounter(counters->stub_cache_misses(), 1);
 }
 
 
@@ -681,6 +688,26 @@ void StubCompiler::GenerateKeyedLoadMissForceGeneric(MacroAssembler* masm) {
 }
 
 
+// Loads the number in value, a smi or a heap number, into xmm0.  Jumps to
+// miss if value is not a number.
+static void GenerateLoadNumber(MacroAssembler* masm,
+                               Register value,
+                               Register scratch,
+                               Label* miss) {
+  Label heap_number, done;
+  __ JumpIfNotSmi(value, &heap_number);
+  __ SmiToInteger32(scratch, value);
+  __ cvtlsi2sd(xmm0, scratch);
+  __ jmp(&done);
+  __ bind(&heap_number);
+  __ CompareRoot(FieldOperand(value, HeapObject::kMapOffset),
+                 Heap::kHeapNumberMapRootIndex);
+  __ j(not_equal, miss);
+  __ movsd(xmm0, FieldOperand(value, HeapNumber::kValueOffset));
+  __ bind(&done);
+}
+
+
 // Both name_reg and receiver_reg are preserved on jumps to miss_label,
 // but may be destroyed if store is successful.
 void StubCompiler::GenerateStoreField(MacroAssembler* masm,
@@ -708,8 +735,16 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
   // checks.
   ASSERT(object->IsJSGlobalProxy() || !object->IsAccessCheckNeeded());
 
+  // Double fields only take numbers; storing anything else generalizes the
+  // field in the runtime.
+  FieldRepresentation representation = GetFieldRepresentation(
+      transition.is_null() ? object->map() : *transition, index);
+
   // Perform map transition for the receiver if necessary.
   if (!transition.is_null() && (object->map()->unused_property_fields() == 0)) {
+    if (representation == DOUBLE_FIELD) {
+      GenerateLoadNumber(masm, rax, scratch, miss_label);
+    }
     // The properties must be extended before we can store the value.
     // We jump to a runtime call that extends the properties array.
     __ pop(scratch);  // Return address.
@@ -725,39 +760,75 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
     return;
   }
 
+  // Adjust for the number of properties stored in the object. Even in the
+  // face of a transition we can use the old map here because the size of the
+  // object and the number of in-object properties is not going to change.
+  index -= object->map()->inobject_properties();
+  int offset = index < 0
+      ? object->map()->instance_size() + (index * kPointerSize)
+      : index * kPointerSize + FixedArray::kHeaderSize;
+
+  // The value stored in the field, rax or the mutable heap number of a
+  // double field.
+  Register value = rax;
+  if (representation == DOUBLE_FIELD) {
+    GenerateLoadNumber(masm, rax, scratch, miss_label);
+    if (transition.is_null()) {
+      // Update the mutable heap number in place.  It may have been replaced
+      // by another value if the field was generalized.
+      if (index < 0) {
+        __ movq(scratch, FieldOperand(receiver_reg, offset));
+      } else {
+        __ movq(scratch,
+                FieldOperand(receiver_reg, JSObject::kPropertiesOffset));
+        __ movq(scratch, FieldOperand(scratch, offset));
+      }
+      __ JumpIfSmi(scratch, miss_label);
+      __ CompareRoot(FieldOperand(scratch, HeapObject::kMapOffset),
+                     Heap::kMutableHeapNumberMapRootIndex);
+      __ j(not_equal, miss_label);
+      __ movsd(FieldOperand(scratch, HeapNumber::kValueOffset), xmm0);
+      __ ret(0);
+      return;
+    }
+    // The new field gets a mutable heap number of its own.
+    __ AllocateHeapNumber(scratch, no_reg, miss_label);
+    __ LoadRoot(kScratchRegister, Heap::kMutableHeapNumberMapRootIndex);
+    __ movq(FieldOperand(scratch, HeapObject::kMapOffset), kScratchRegister);
+    __ movsd(FieldOperand(scratch, HeapNumber::kValueOffset), xmm0);
+    value = scratch;
+  }
+
   if (!transition.is_null()) {
     // Update the map of the object; no write barrier updating is
     // needed because the map is never in new space.
     __ Move(FieldOperand(receiver_reg, HeapObject::kMapOffset), transition);
   }
 
-  // Adjust for the number of properties stored in the object. Even in the
-  // face of a transition we can use the old map here because the size of the
-  // object and the number of in-object properties is not going to change.
-  index -= object->map()->inobject_properties();
-
   if (index < 0) {
     // Set the property straight into the object.
-    int offset = object->map()->instance_size() + (index * kPointerSize);
-    __ movq(FieldOperand(receiver_reg, offset), rax);
+    __ movq(FieldOperand(receiver_reg, offset), value);
 
     // Update the write barrier for the array address.
     // Pass the value being stored in the now unused name_reg.
-    __ movq(name_reg, rax);
+    __ movq(name_reg, value);
     __ RecordWriteField(
         receiver_reg, offset, name_reg, scratch, kDontSaveFPRegs);
   } else {
     // Write to the properties array.
-    int offset = index * kPointerSize + FixedArray::kHeaderSize;
-    // Get the properties array (optimistically).
-    __ movq(scratch, FieldOperand(receiver_reg, JSObject::kPropertiesOffset));
-    __ movq(FieldOperand(scratch, offset), rax);
+    // Get the properties array (optimistically).  The properties array
+    // goes in receiver_reg when scratch holds a new mutable heap number.
+    Register properties = value.is(scratch) ? receiver_reg : scratch;
+    __ movq(properties,
+            FieldOperand(receiver_reg, JSObject::kPropertiesOffset));
+    __ movq(FieldOperand(properties, offset), value);
 
     // Update the write barrier for the array address.
     // Pass the value being stored in the now unused name_reg.
-    __ movq(name_reg, rax);
-    __ RecordWriteField(
-        scratch, offset, name_reg, receiver_reg, kDontSaveFPRegs);
+    __ movq(name_reg, value);
+    __ RecordWriteField(properties, offset, name_reg,
+                        properties.is(scratch) ? receiver_reg : scratch,
+                        kDontSaveFPRegs);
   }
 
   // Return the value (register rax).
@@ -937,7 +1008,26 @@ void StubCompiler::GenerateLoadField(Handle<JSObject> object,
       object, receiver, holder, scratch1, scratch2, scratch3, name, miss);
 
   // Get the value from the properties.
-  GenerateFastPropertyLoad(masm(), rax, reg, holder, index);
+  if (GetFieldRepresentation(holder->map(), index) == TAGGED_FIELD) {
+    GenerateFastPropertyLoad(masm(), rax, reg, holder, index);
+    __ ret(0);
+    return;
+  }
+
+  // A double field holds a mutable heap number owned by the holder, which
+  // must not escape.  Return a copy of it instead.
+  Label done;
+  GenerateFastPropertyLoad(masm(), scratch3, reg, holder, index);
+  __ JumpIfSmi(scratch3, &done);
+  __ CompareRoot(FieldOperand(scratch3, HeapObject::kMapOffset),
+                 Heap::kMutableHeapNumberMapRootIndex);
+  __ j(not_equal, &done);
+  __ AllocateHeapNumber(scratch1, no_reg, miss);
+  __ movsd(xmm0, FieldOperand(scratch3, HeapNumber::kValueOffset));
+  __ movsd(FieldOperand(scratch1, HeapNumber::kValueOffset), xmm0);
+  __ movq(scratch3, scratch1);
+  __ bind(&done);
+  __ movq(rax, scratch3);
   __ ret(0);
 }
 
@@ -1053,7 +1143,10 @@ void StubCompiler::GenerateLoadInterceptor(Handle<JSObject> object,
   bool compile_followup_inline = false;
   if (lookup->IsProperty() && lookup->IsCacheable()) {
     if (lookup->type() == FIELD) {
-      compile_followup_inline = true;
+      // Loads from double fields copy the field's heap number, which the
+      // inlined follow-up does not.
+      compile_followup_inline =
+          lookup->GetFieldRepresentation() == TAGGED_FIELD;
     } else if (lookup->type() == CALLBACKS &&
                lookup->GetCallbackObject()->IsAccessorInfo()) {
       compile_followup_inline =
@@ -2368,6 +2461,12 @@ Handle<Code> StoreStubCompiler::CompileStoreGlobal(
   __ CompareRoot(cell_operand, Heap::kTheHoleValueRootIndex);
   __ j(equal, &miss);
 
+  // Check that optimized code does not embed the value in the cell. The
+  // runtime system deoptimizes that code before changing it.
+  __ SmiCompare(FieldOperand(rbx, JSGlobalPropertyCell::kStateOffset),
+                Smi::FromInt(JSGlobalPropertyCell::CONSTANT));
+  __ j(equal, &miss);
+
   // Store the value in the cell.
   __ movq(cell_operand, rax);
   Label done;
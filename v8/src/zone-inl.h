@@ -94,6 +94,14 @@ void Zone::adjust_segment_bytes_allocated(int delta) {
 }
 
 
+void Zone::RecordHighWaterMark(StatsCounter* counter) {
+  if (counter->Enabled() &&
+      *counter->GetInternalPointer() < segment_bytes_allocated_) {
+    counter->Set(segment_bytes_allocated_);
+  }
+}
+
+
 template <typename Config>
 ZoneSplayTree<Config>::~ZoneSplayTree() {
   // Reset the root to avoid unneeded iteration over all tree nodes
@@ -38,7 +38,8 @@ namespace internal {
 // (encoded in the this pointer) and a size in bytes. Segments are
 // chained together forming a LIFO structure with the newest segment
 // available as segment_head_. Segments are allocated using malloc()
-// and de-allocated using free().
+// and de-allocated using free(), going through the segment pool of the
+// isolate which keeps some of them around for reuse.
 
 class Segment {
  public:
@@ -75,6 +76,17 @@ Zone::Zone()
       scope_nesting_(0),
       segment_head_(NULL) {
 }
+
+
+Zone::Zone(Isolate* isolate)
+    : zone_excess_limit_(256 * MB),
+      segment_bytes_allocated_(0),
+      position_(0),
+      limit_(0),
+      scope_nesting_(0),
+      segment_head_(NULL),
+      isolate_(isolate) {
+}
 unsigned Zone::allocation_size_ = 0;
 
 ZoneScope::~ZoneScope() {
@@ -84,10 +96,78 @@ ZoneScope::~ZoneScope() {
 }
 
 
+ZoneSegmentPool::ZoneSegmentPool(Isolate* isolate)
+    : isolate_(isolate),
+      mutex_(OS::CreateMutex()),
+      head_(NULL),
+      size_(0) {
+}
+
+
+ZoneSegmentPool::~ZoneSegmentPool() {
+  Clear();
+  delete mutex_;
+}
+
+
+Segment* ZoneSegmentPool::Get(int size) {
+  ScopedLock lock(mutex_);
+  Segment* previous = NULL;
+  for (Segment* current = head_;
+       current != NULL;
+       previous = current, current = current->next()) {
+    if (current->size() < size) continue;
+    if (previous == NULL) {
+      head_ = current->next();
+    } else {
+      previous->Initialize(current->next(), previous->size());
+    }
+    size_ -= current->size();
+    isolate_->counters()->zone_segment_pool_bytes()->Set(size_);
+    return current;
+  }
+  return NULL;
+}
+
+
+void ZoneSegmentPool::Put(Segment* segment, int size) {
+  {
+    ScopedLock lock(mutex_);
+    if (size_ + size <= FLAG_zone_segment_pool_size * KB) {
+      segment->Initialize(head_, size);
+      head_ = segment;
+      size_ += size;
+      isolate_->counters()->zone_segment_pool_bytes()->Set(size_);
+      return;
+    }
+  }
+  Malloced::Delete(segment);
+}
+
+
+void ZoneSegmentPool::Clear() {
+  ScopedLock lock(mutex_);
+  while (head_ != NULL) {
+    Segment* next = head_->next();
+    Malloced::Delete(head_);
+    head_ = next;
+  }
+  size_ = 0;
+  isolate_->counters()->zone_segment_pool_bytes()->Set(0);
+}
+
+
 // Creates a new segment, sets it size, and pushes it to the front
-// of the segment chain. Returns the new segment.
+// of the segment chain. Returns the new segment. Reuses a pooled
+// segment if there is one large enough.
 Segment* Zone::NewSegment(int size) {
-  Segment* result = reinterpret_cast<Segment*>(Malloced::New(size));
+  ZoneSegmentPool* pool = isolate_->zone_segment_pool();
+  Segment* result = (pool == NULL) ? NULL : pool->Get(size);
+  if (result != NULL) {
+    size = result->size();
+  } else {
+    result = reinterpret_cast<Segment*>(Malloced::New(size));
+  }
   adjust_segment_bytes_allocated(size);
   if (result != NULL) {
     result->Initialize(segment_head_, size);
@@ -97,10 +177,16 @@ Segment* Zone::NewSegment(int size) {
 }
 
 
-// Deletes the given segment. Does not touch the segment chain.
+// Releases the given segment to the segment pool. Does not touch the
+// segment chain.
 void Zone::DeleteSegment(Segment* segment, int size) {
   adjust_segment_bytes_allocated(-size);
-  Malloced::Delete(segment);
+  ZoneSegmentPool* pool = isolate_->zone_segment_pool();
+  if (pool != NULL) {
+    pool->Put(segment, size);
+  } else {
+    Malloced::Delete(segment);
+  }
 }
 
 
@@ -29,6 +29,7 @@
 #define V8_ZONE_H_
 
 #include "allocation.h"
+#include "hashmap.h"
 
 namespace v8 {
 namespace internal {
@@ -42,6 +43,8 @@ enum ZoneScopeMode {
 };
 
 class Segment;
+class Mutex;
+struct StatsCounter;
 
 // The Zone supports very fast allocation of small chunks of
 // memory. The chunks cannot be deallocated individually, but instead
@@ -65,11 +68,12 @@ class Zone {
   template <typename T>
   inline T* NewArray(int length);
 
-  // Deletes all objects and free all memory allocated in the Zone. Keeps one
-  // small (size <= kMaximumKeptSegmentSize) segment around if it finds one.
+  // Deletes all objects and releases all memory allocated in the Zone to the
+  // segment pool of the isolate. Keeps one small
+  // (size <= kMaximumKeptSegmentSize) segment around if it finds one.
   void DeleteAll();
 
-  // Deletes the last small segment kept around by DeleteAll().
+  // Releases the last small segment kept around by DeleteAll().
   void DeleteKeptSegment();
 
   // Returns true if more memory has been allocated in zones than
@@ -78,8 +82,18 @@ class Zone {
 
   inline void adjust_segment_bytes_allocated(int delta);
 
+  // Raises the counter to the number of bytes currently held in segments if
+  // it is lower. Called at the end of the compilation phases to record the
+  // peak zone usage of each of them.
+  inline void RecordHighWaterMark(StatsCounter* counter);
+
   inline Isolate* isolate() { return isolate_; }
 
+  // Creates a zone of the given isolate besides the isolate's own zone.
+  // Used for the graphs of functions that are optimized by the optimizing
+  // compiler thread, which outlive the zone scope they were built in.
+  explicit Zone(Isolate* isolate);
+
   static unsigned allocation_size_;
 
  private:
@@ -121,7 +135,8 @@ class Zone {
   // of the segment chain. Returns the new segment.
   Segment* NewSegment(int size);
 
-  // Deletes the given segment. Does not touch the segment chain.
+  // Releases the given segment to the segment pool. Does not touch the
+  // segment chain.
   void DeleteSegment(Segment* segment, int size);
 
   // The free region in the current (front) segment is represented as
@@ -137,6 +152,37 @@ class Zone {
 };
 
 
+// Keeps the segments released by the zones of an isolate for reuse, so that
+// back-to-back compilations do not go through malloc() and free() for all of
+// their zone memory. At most --zone-segment-pool-size KB of segments are
+// retained. The zones of the optimizing compiler thread share the pool with
+// the isolate's zone, so it is protected by a mutex.
+class ZoneSegmentPool {
+ public:
+  explicit ZoneSegmentPool(Isolate* isolate);
+  ~ZoneSegmentPool();
+
+  // Returns a retained segment of at least the given size in bytes, or NULL
+  // if there is none.
+  Segment* Get(int size);
+
+  // Retains the given segment of the given size for reuse, or frees it if
+  // the pool is full.
+  void Put(Segment* segment, int size);
+
+  // Frees all retained segments.
+  void Clear();
+
+ private:
+  Isolate* isolate_;
+  Mutex* mutex_;
+  Segment* head_;
+  int size_;  // The number of bytes in the retained segments.
+
+  DISALLOW_COPY_AND_ASSIGN(ZoneSegmentPool);
+};
+
+
 // ZoneObject is an abstraction that helps define classes of objects
 // allocated in the Zone. Use it as a base class; see ast.h.
 class ZoneObject {
@@ -243,6 +289,11 @@ class ZoneSplayTree: public SplayTree<Config, ZoneListAllocationPolicy> {
 };
 
 
+// A hash map whose table is allocated in the Zone, for maps that live no
+// longer than a compilation.
+typedef TemplateHashMapImpl<ZoneListAllocationPolicy> ZoneHashMap;
+
+
 } }  // namespace v8::internal
 
 #endif  // V8_ZONE_H_
@@ -55,8 +55,10 @@
         'test-circular-queue.cc',
         'test-compiler.cc',
         'test-conversions.cc',
+        'test-counters.cc',
         'test-cpu-profiler.cc',
         'test-dataflow.cc',
+        'test-date.cc',
         'test-debug.cc',
         'test-decls.cc',
         'test-deoptimization.cc',
@@ -77,6 +79,7 @@
         'test-lock.cc',
         'test-lockers.cc',
         'test-log.cc',
+        'test-lz-codec.cc',
         'test-mark-compact.cc',
         'test-parsing.cc',
         'test-platform-tls.cc',
@@ -38,6 +38,7 @@
 #include "utils.h"
 #include "cctest.h"
 #include "parser.h"
+#include "stub-cache.h"
 #include "unicode-inl.h"
 
 static const bool kLogThreading = false;
@@ -566,6 +567,73 @@ TEST(MakingExternalAsciiStringConditions) {
 }
 
 
+TEST(MakingFreshExternalStringAboveGuaranteedLength) {
+  v8::HandleScope scope;
+  LocalContext env;
+  HEAP->CollectGarbage(i::NEW_SPACE);
+
+  const int length = String::kMinGuaranteedExternalLength;
+  char* buf = i::NewArray<char>(length + 1);
+  memset(buf, 'b', length);
+  buf[length] = '\0';
+  Local<String> string = String::New(buf);
+  // Fresh, unused and young, but long enough to be externalized in place.
+  CHECK(HEAP->InNewSpace(*v8::Utils::OpenHandle(*string)));
+  CHECK(string->CanMakeExternal());
+  int dispose_count = 0;
+  CHECK(string->MakeExternal(new TestAsciiResource(buf, &dispose_count)));
+  CHECK(string->IsExternalAscii());
+  CHECK(HEAP->InNewSpace(*v8::Utils::OpenHandle(*string)));
+  CHECK(!string->CanMakeExternal());
+}
+
+
+class TestLatin1Resource: public String::ExternalLatin1StringResource {
+ public:
+  TestLatin1Resource(const char* data, int* counter)
+    : data_(data), length_(strlen(data)), counter_(counter) { }
+
+  ~TestLatin1Resource() { ++*counter_; }
+
+  const char* data() const {
+    return data_;
+  }
+
+  size_t length() const {
+    return length_;
+  }
+ private:
+  const char* data_;
+  size_t length_;
+  int* counter_;
+};
+
+
+THREADED_TEST(ExternalLatin1Strings) {
+  int dispose_count = 0;
+  {
+    v8::HandleScope scope;
+    LocalContext env;
+    // Pure ASCII data is used in place.
+    Local<String> ascii =
+        String::NewExternal(new TestLatin1Resource("plain", &dispose_count));
+    CHECK(ascii->IsExternalAscii());
+    CHECK_EQ(5, ascii->Length());
+    CHECK_EQ(0, dispose_count);
+    // Anything else is widened and the resource disposed at once.
+    Local<String> latin1 = String::NewExternal(
+        new TestLatin1Resource("caf\xe9 \xfc", &dispose_count));
+    CHECK(latin1->IsExternal());
+    CHECK_EQ(1, dispose_count);
+    CHECK_EQ(6, latin1->Length());
+    env->Global()->Set(v8_str("s"), latin1);
+    ExpectTrue("s.charCodeAt(3) == 0xe9 && s.charCodeAt(5) == 0xfc");
+  }
+  HEAP->CollectAllAvailableGarbage();
+  CHECK_EQ(2, dispose_count);
+}
+
+
 THREADED_TEST(UsingExternalString) {
   {
     v8::HandleScope scope;
@@ -826,6 +894,52 @@ THREADED_TEST(FunctionTemplate) {
 }
 
 
+static int fast_add_calls = 0;
+static int slow_add_calls = 0;
+
+static int32_t FastAdd(int32_t a, double b) {
+  fast_add_calls++;
+  return a + static_cast<int32_t>(b);
+}
+
+
+static v8::Handle<Value> SlowAdd(const v8::Arguments& args) {
+  slow_add_calls++;
+  return v8::Integer::New(args[0]->Int32Value() + args[1]->Int32Value());
+}
+
+
+TEST(FastCallHandler) {
+  v8::HandleScope scope;
+  LocalContext env;
+  Local<v8::FunctionTemplate> fun_templ = v8::FunctionTemplate::New(SlowAdd);
+  fun_templ->SetFastCallHandler(
+      reinterpret_cast<v8::FastCallFunction>(FastAdd),
+      v8::FastCallSignature(v8::FastCallSignature::kInt32,
+                            v8::FastCallSignature::kInt32,
+                            v8::FastCallSignature::kDouble));
+  env->Global()->Set(v8_str("add"), fun_templ->GetFunction());
+  fast_add_calls = 0;
+  slow_add_calls = 0;
+  Local<Value> result = CompileRun(
+      "var sum = 0;"
+      "for (var i = 0; i < 100; i++) sum += add(i, 2.5);"
+      "sum");
+  CHECK_EQ(5150, result->Int32Value());
+  CHECK_EQ(100, fast_add_calls);
+  CHECK_EQ(0, slow_add_calls);
+  // Arguments that do not convert losslessly fall back to the call handler.
+  CHECK_EQ(3, CompileRun("add('1', 2)")->Int32Value());
+  CHECK_EQ(3, CompileRun("add(1.5, 2)")->Int32Value());
+  CHECK_EQ(1, CompileRun("add(1)")->Int32Value());
+  CHECK_EQ(100, fast_add_calls);
+  CHECK_EQ(3, slow_add_calls);
+  // Construct calls always use the call handler.
+  CompileRun("new add(1, 2)");
+  CHECK_EQ(4, slow_add_calls);
+}
+
+
 static void* expected_ptr;
 static v8::Handle<v8::Value> callback(const v8::Arguments& args) {
   void* ptr = v8::External::Unwrap(args.Data());
@@ -2436,6 +2550,73 @@ THREADED_TEST(Array) {
 }
 
 
+THREADED_TEST(ArrayBulkAccess) {
+  v8::HandleScope scope;
+  LocalContext context;
+
+  // Smi, double and generic elements, a hole and a getter.
+  Local<v8::Array> smis = Local<v8::Array>::Cast(CompileRun("[1, 2, 3, 4]"));
+  Local<v8::Array> doubles =
+      Local<v8::Array>::Cast(CompileRun("[0.5, 1.5, , 3.5]"));
+  Local<v8::Array> mixed = Local<v8::Array>::Cast(CompileRun(
+      "var mixed = [1, '2', {}, 4.5];"
+      "mixed.__defineGetter__(4, function() { return 7; });"
+      "mixed"));
+
+  double d[5];
+  CHECK(smis->CopyTo(1, 3, d));
+  CHECK_EQ(2.0, d[0]);
+  CHECK_EQ(4.0, d[2]);
+  CHECK(doubles->CopyTo(0, 4, d));
+  CHECK_EQ(0.5, d[0]);
+  CHECK(d[2] != d[2]);  // The hole reads as undefined, i.e. NaN.
+  CHECK_EQ(3.5, d[3]);
+  CHECK(mixed->CopyTo(0, 5, d));
+  CHECK_EQ(2.0, d[1]);
+  CHECK(d[2] != d[2]);
+  CHECK_EQ(4.5, d[3]);
+  CHECK_EQ(7.0, d[4]);
+
+  int32_t n[5];
+  CHECK(doubles->CopyTo(0, 4, n));
+  CHECK_EQ(0, n[0]);
+  CHECK_EQ(0, n[2]);
+  CHECK_EQ(3, n[3]);
+  CHECK(mixed->CopyTo(0, 5, n));
+  CHECK_EQ(2, n[1]);
+  CHECK_EQ(7, n[4]);
+
+  Local<Value> v[5];
+  CHECK(mixed->CopyTo(0, 5, v));
+  CHECK(v[1]->IsString());
+  CHECK(v[2]->IsObject());
+  CHECK_EQ(7, v[4]->Int32Value());
+  CHECK(doubles->CopyTo(1, 2, v));
+  CHECK_EQ(1.5, v[0]->NumberValue());
+  CHECK(v[1]->IsUndefined());
+
+  // Conversions that throw are reported.
+  Local<v8::Array> throwing = Local<v8::Array>::Cast(CompileRun(
+      "[1, { valueOf: function() { throw 'no'; } }]"));
+  {
+    v8::TryCatch try_catch;
+    CHECK(!throwing->CopyTo(0, 2, d));
+    CHECK(try_catch.HasCaught());
+  }
+
+  const double double_values[] = { 0.25, -1, 1e300 };
+  context->Global()->Set(v8_str("a"), v8::Array::New(double_values, 3));
+  ExpectTrue("a.length == 3 && a[0] == 0.25 && a[1] == -1 && a[2] == 1e300");
+  const int32_t int_values[] = { 1, -2, 0x7fffffff };
+  context->Global()->Set(v8_str("b"), v8::Array::New(int_values, 3));
+  ExpectTrue("b.length == 3 && b[1] == -2 && b[2] == 0x7fffffff");
+  Handle<Value> handles[] = { v8_str("x"), v8_num(2), v8::Null() };
+  context->Global()->Set(v8_str("c"), v8::Array::New(handles, 3));
+  ExpectTrue("c.length == 3 && c[0] == 'x' && c[1] == 2 && c[2] === null");
+  CHECK_EQ(0, v8::Array::New(double_values, 0)->Length());
+}
+
+
 v8::Handle<Value> HandleF(const v8::Arguments& args) {
   v8::HandleScope scope;
   ApiTestFuzzer::Fuzz();
@@ -2536,6 +2717,50 @@ THREADED_TEST(FunctionCall) {
 }
 
 
+THREADED_TEST(PreparedCall) {
+  v8::HandleScope scope;
+  LocalContext context;
+  CompileRun(
+    "var calls = 0;"
+    "function Add(a, b) {"
+    "  calls++;"
+    "  if (a === 'throw') throw b;"
+    "  return this.base + a + b;"
+    "}");
+  Local<Function> add =
+      Local<Function>::Cast(context->Global()->Get(v8_str("Add")));
+  Local<v8::Object> receiver = v8::Object::New();
+  receiver->Set(v8_str("base"), v8_num(100));
+
+  v8::PreparedCall call(add, receiver, 2);
+  CHECK_EQ(2, call.argc());
+  for (int i = 0; i < 1000; i++) {
+    v8::HandleScope inner_scope;
+    call.SetArgument(0, v8::Integer::New(i));
+    call.SetArgument(1, v8::Integer::New(2 * i));
+    CHECK_EQ(100 + 3 * i, call.Call()->Int32Value());
+  }
+  CHECK_EQ(1000, CompileRun("calls")->Int32Value());
+
+  // Arguments survive garbage collections and keep their values.
+  call.SetArgument(0, v8_str("x"));
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  CHECK_EQ(v8_str("100x1998"), call.Call());
+
+  // Exceptions are reported like for Function::Call.
+  {
+    v8::TryCatch try_catch;
+    call.SetArgument(0, v8_str("throw"));
+    call.SetArgument(1, v8_num(42));
+    CHECK(call.Call().IsEmpty());
+    CHECK(try_catch.HasCaught());
+    CHECK_EQ(42, try_catch.Exception()->Int32Value());
+  }
+  call.SetArgument(0, v8_num(1));
+  CHECK_EQ(100 + 1 + 42, call.Call()->Int32Value());
+}
+
+
 static const char* js_code_causing_out_of_memory =
     "var a = new Array(); while(true) a.push(a);";
 
@@ -3325,6 +3550,26 @@ static v8::Handle<Value> GetXValue(Local<String> name,
 }
 
 
+THREADED_TEST(ObjectTemplateNewInstance) {
+  v8::HandleScope scope;
+  LocalContext env;
+
+  Local<v8::ObjectTemplate> templ = v8::ObjectTemplate::New();
+  templ->SetInternalFieldCount(2);
+  templ->SetAccessor(v8_str("x"), GetXValue, NULL, v8_str("donut"));
+  Local<v8::Object> first = templ->NewInstance();
+  Local<v8::Object> second = templ->NewInstance();
+  CHECK(!first->Equals(second));
+  CHECK_EQ(2, second->InternalFieldCount());
+  CHECK(second->GetInternalField(1)->IsUndefined());
+  second->SetInternalField(1, v8_num(17));
+  CHECK_EQ(17, second->GetInternalField(1)->Int32Value());
+  CHECK(first->GetInternalField(1)->IsUndefined());
+  env->Global()->Set(v8_str("second"), second);
+  CHECK_EQ(v8_str("x"), CompileRun("second.x"));
+}
+
+
 THREADED_TEST(SimplePropertyRead) {
   v8::HandleScope scope;
   Local<ObjectTemplate> templ = ObjectTemplate::New();
@@ -3744,6 +3989,78 @@ THREADED_TEST(NamedInterceptorMapTransitionRead) {
 }
 
 
+static int keyed_interceptor_calls = 0;
+
+static v8::Handle<Value> CountingXPropertyGetter(Local<String> property,
+                                                 const AccessorInfo& info) {
+  keyed_interceptor_calls++;
+  return property;
+}
+
+
+TEST(NamedInterceptorKeys) {
+  v8::HandleScope scope;
+  Local<v8::FunctionTemplate> function_template = v8::FunctionTemplate::New();
+  Local<v8::ObjectTemplate> instance_template =
+      function_template->InstanceTemplate();
+  instance_template->SetNamedPropertyHandler(CountingXPropertyGetter);
+  v8::Handle<v8::Array> keys = v8::Array::New(1);
+  keys->Set(0, v8_str("x"));
+  instance_template->SetNamedPropertyHandlerKeys(keys);
+  LocalContext context;
+  context->Global()->Set(v8_str("F"), function_template->GetFunction());
+  keyed_interceptor_calls = 0;
+  // Names outside the key set are looked up on the object and its
+  // prototypes without consulting the interceptor.
+  Local<Value> result = CompileRun(
+      "F.prototype.y = 1;"
+      "var o = new F();"
+      "o.z = 2;"
+      "var sum = 0;"
+      "for (var i = 0; i < 10; i++) sum += o.y + o.z + (o.w === undefined);"
+      "sum");
+  CHECK_EQ(40, result->Int32Value());
+  CHECK_EQ(0, keyed_interceptor_calls);
+  result = CompileRun(
+      "var s = '';"
+      "for (var i = 0; i < 10; i++) s = o.x;"
+      "s");
+  CHECK_EQ(v8_str("x"), result);
+  CHECK_EQ(10, keyed_interceptor_calls);
+  ExpectTrue("'y' in o && !o.hasOwnProperty('y') && delete o.z && !('z' in o)");
+}
+
+
+TEST(InternalFieldAccessor) {
+  v8::HandleScope scope;
+  Local<v8::ObjectTemplate> templ = ObjectTemplate::New();
+  templ->SetInternalFieldCount(2);
+  templ->SetInternalFieldAccessor(v8_str("first"), 0);
+  templ->SetInternalFieldAccessor(v8_str("second"), 1);
+  LocalContext context;
+  Local<v8::Object> obj = templ->NewInstance();
+  obj->SetInternalField(0, v8_str("a"));
+  obj->SetInternalField(1, v8_num(42));
+  context->Global()->Set(v8_str("obj"), obj);
+  Local<Value> result = CompileRun(
+      "function get(o) { return o.first + o.second; }"
+      "var r;"
+      "for (var i = 0; i < 10; i++) r = get(obj);"
+      "r");
+  CHECK_EQ(v8_str("a42"), result);
+  // The loads see later changes to the fields.
+  obj->SetInternalField(1, v8_num(7));
+  CHECK_EQ(v8_str("a7"), CompileRun("get(obj)"));
+  // The accessors are read-only.
+  CHECK_EQ(v8_str("a7"), CompileRun("obj.second = 1; get(obj)"));
+  // Prototype chain loads go to the holder's fields.
+  CHECK_EQ(v8_str("a7"), CompileRun(
+      "var child = Object.create(obj);"
+      "for (var i = 0; i < 10; i++) r = get(child);"
+      "r"));
+}
+
+
 static v8::Handle<Value> IndexedPropertyGetter(uint32_t index,
                                                const AccessorInfo& info) {
   ApiTestFuzzer::Fuzz();
@@ -5052,6 +5369,52 @@ THREADED_TEST(IndependentWeakHandle) {
 }
 
 
+static int batched_weak_count = 0;
+static int batched_weak_calls = 0;
+
+static void CountBatchedWeak(void** parameters, int count) {
+  for (int i = 0; i < count; i++) {
+    *reinterpret_cast<bool*>(parameters[i]) = true;
+  }
+  batched_weak_count += count;
+  batched_weak_calls++;
+}
+
+
+TEST(BatchedWeakHandles) {
+  v8::Persistent<Context> context = Context::New();
+  Context::Scope context_scope(context);
+  v8::V8::SetWeakReferenceBatchCallback(&CountBatchedWeak);
+  batched_weak_count = 0;
+  batched_weak_calls = 0;
+
+  const int kHandles = 100;
+  v8::Persistent<v8::Object> objects[kHandles];
+  bool disposed[kHandles];
+  for (int i = 0; i < kHandles; i++) {
+    v8::HandleScope handle_scope;
+    objects[i] = v8::Persistent<v8::Object>::New(v8::Object::New());
+    disposed[i] = false;
+  }
+  // Keep one alive with a strong handle.
+  v8::Persistent<v8::Object> strong =
+      v8::Persistent<v8::Object>::New(objects[0]);
+  for (int i = 0; i < kHandles; i++) objects[i].MakeWeakBatched(&disposed[i]);
+
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  CHECK_EQ(kHandles - 1, batched_weak_count);
+  CHECK_EQ(1, batched_weak_calls);
+  CHECK(!disposed[0]);
+  for (int i = 1; i < kHandles; i++) CHECK(disposed[i]);
+
+  strong.Dispose();
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  CHECK_EQ(kHandles, batched_weak_count);
+  CHECK(disposed[0]);
+  v8::V8::SetWeakReferenceBatchCallback(NULL);
+}
+
+
 static void InvokeScavenge() {
   HEAP->PerformScavenge();
 }
@@ -6328,6 +6691,65 @@ TEST(DetachAndReattachGlobal) {
 }
 
 
+TEST(ContextNewFrom) {
+  v8::HandleScope scope;
+  v8::Persistent<Context> source = Context::New();
+  {
+    Context::Scope source_scope(source);
+    CompileRun(
+        "var counter = 1;"
+        "var name = 'tenant';"
+        "var table = [1, 2, 3, 4];"
+        "var config = { limit: 10, nested: { flag: true }, list: table };"
+        "config.self = config;"
+        "function Next() { return counter++; }"
+        "var closure = (function() {"
+        "  var x = 0;"
+        "  return function() { return x++; };"
+        "})();");
+  }
+
+  v8::Persistent<Context> clone = Context::NewFrom(source);
+  CHECK(!clone.IsEmpty());
+  {
+    Context::Scope clone_scope(clone);
+    CHECK_EQ(1, CompileRun("counter")->Int32Value());
+    CHECK_EQ(v8_str("tenant"), CompileRun("name"));
+    CHECK_EQ(4, CompileRun("table.length")->Int32Value());
+    CHECK(CompileRun("table instanceof Array")->BooleanValue());
+    CHECK(CompileRun(
+        "Object.getPrototypeOf(config) === Object.prototype")->BooleanValue());
+    CHECK(CompileRun("config.nested.flag")->BooleanValue());
+    CHECK(CompileRun("config.list === table")->BooleanValue());
+    CHECK(CompileRun("config.self === config")->BooleanValue());
+    // Top-level functions run against the globals of the new context.
+    CHECK_EQ(1, CompileRun("Next()")->Int32Value());
+    CHECK_EQ(2, CompileRun("Next()")->Int32Value());
+    // Closures over function scopes are not copied.
+    CHECK(CompileRun("typeof closure === 'undefined'")->BooleanValue());
+    CompileRun("table[0] = 42; config.limit = 20;");
+  }
+
+  // Writes in one context are not visible in the other.
+  {
+    Context::Scope source_scope(source);
+    CHECK_EQ(1, CompileRun("counter")->Int32Value());
+    CHECK_EQ(1, CompileRun("table[0]")->Int32Value());
+    CHECK_EQ(10, CompileRun("config.limit")->Int32Value());
+    CHECK_EQ(0, CompileRun("closure()")->Int32Value());
+    CompileRun("table[1] = 43;");
+  }
+  {
+    Context::Scope clone_scope(clone);
+    CHECK_EQ(42, CompileRun("table[0]")->Int32Value());
+    CHECK_EQ(2, CompileRun("table[1]")->Int32Value());
+  }
+
+  clone.Dispose();
+  source.Dispose();
+}
+
+
 static bool allowed_access_type[v8::ACCESS_KEYS + 1] = { false };
 static bool NamedAccessBlocker(Local<v8::Object> global,
                                Local<Value> name,
@@ -10507,6 +10929,36 @@ THREADED_TEST(ExternalAllocatedMemory) {
 }
 
 
+TEST(ExternalAllocatedMemoryTypes) {
+  v8::HandleScope outer;
+  v8::Persistent<Context> env(Context::New());
+  const int kSize = 1024*1024;
+  CHECK_EQ(kSize, v8::V8::AdjustAmountOfExternalAllocatedMemory(
+      kSize, v8::kExternalArrayMemory));
+  CHECK_EQ(3 * kSize, v8::V8::AdjustAmountOfExternalAllocatedMemory(
+      2 * kSize, v8::kExternalStringMemory));
+  v8::HeapStatistics stats;
+  v8::V8::GetHeapStatistics(&stats);
+  CHECK_EQ(kSize,
+           static_cast<int>(stats.external_memory_size(
+               v8::kExternalArrayMemory)));
+  CHECK_EQ(2 * kSize,
+           static_cast<int>(stats.external_memory_size(
+               v8::kExternalStringMemory)));
+  CHECK_EQ(0,
+           static_cast<int>(stats.external_memory_size(v8::kEmbedderMemory)));
+  CHECK_EQ(2 * kSize, v8::V8::AdjustAmountOfExternalAllocatedMemory(
+      -kSize, v8::kExternalArrayMemory));
+  CHECK_EQ(0, v8::V8::AdjustAmountOfExternalAllocatedMemory(
+      -2 * kSize, v8::kExternalStringMemory));
+  v8::V8::GetHeapStatistics(&stats);
+  CHECK_EQ(0,
+           static_cast<int>(stats.external_memory_size(
+               v8::kExternalArrayMemory)));
+  env.Dispose();
+}
+
+
 THREADED_TEST(DisposeEnteredContext) {
   v8::HandleScope scope;
   LocalContext outer;
@@ -13571,6 +14023,119 @@ TEST(SetResourceConstraintsInThread) {
 }
 
 
+static int stub_cache_probes;
+static int stub_cache_misses;
+static int stub_cache_updates;
+
+
+static int* LookupStubCacheCounter(const char* name) {
+  if (strcmp(name, "c:V8.StubCacheProbes") == 0) return &stub_cache_probes;
+  if (strcmp(name, "c:V8.StubCacheMisses") == 0) return &stub_cache_misses;
+  if (strcmp(name, "c:V8.StubCacheUpdates") == 0) return &stub_cache_updates;
+  return NULL;
+}
+
+
+TEST(SetStubCacheSize) {
+  bool native_code_counters = i::FLAG_native_code_counters;
+  i::FLAG_native_code_counters = true;
+  v8::Isolate* isolate = v8::Isolate::New();
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::ResourceConstraints constraints;
+    constraints.set_stub_cache_size(100);
+    CHECK(v8::SetResourceConstraints(&constraints));
+    v8::V8::SetCounterFunction(LookupStubCacheCounter);
+
+    v8::HandleScope scope;
+    LocalContext env;
+    i::StubCache* stub_cache =
+        reinterpret_cast<i::Isolate*>(isolate)->stub_cache();
+    CHECK_EQ(128, stub_cache->primary_size());
+    CHECK_EQ(32, stub_cache->secondary_size());
+
+    // A load site that sees many maps probes the stub cache.
+    stub_cache_probes = stub_cache_misses = stub_cache_updates = 0;
+    CompileRun("var objects = [];"
+               "for (var i = 0; i < 20; i++) {"
+               "  var o = {};"
+               "  o['p' + i] = i;"
+               "  o.x = i;"
+               "  objects.push(o);"
+               "}"
+               "function load(o) { return o.x; }"
+               "for (var j = 0; j < 10; j++) {"
+               "  for (var i = 0; i < objects.length; i++) load(objects[i]);"
+               "}");
+    CHECK_GT(stub_cache_probes, 0);
+    CHECK_GT(stub_cache_updates, 0);
+    CHECK_GT(stub_cache_probes, stub_cache_misses);
+  }
+  isolate->Dispose();
+  i::FLAG_native_code_counters = native_code_counters;
+}
+
+
+static int keyed_lookup_cache_misses;
+static int descriptor_lookup_cache_hits;
+static int descriptor_lookup_cache_misses;
+
+
+static int* LookupLookupCacheCounter(const char* name) {
+  if (strcmp(name, "c:V8.KeyedLookupCacheMisses") == 0) {
+    return &keyed_lookup_cache_misses;
+  }
+  if (strcmp(name, "c:V8.DescriptorLookupCacheHits") == 0) {
+    return &descriptor_lookup_cache_hits;
+  }
+  if (strcmp(name, "c:V8.DescriptorLookupCacheMisses") == 0) {
+    return &descriptor_lookup_cache_misses;
+  }
+  return NULL;
+}
+
+
+TEST(SetLookupCacheSize) {
+  v8::Isolate* isolate = v8::Isolate::New();
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::ResourceConstraints constraints;
+    constraints.set_lookup_cache_size(100);
+    CHECK(v8::SetResourceConstraints(&constraints));
+    v8::V8::SetCounterFunction(LookupLookupCacheCounter);
+
+    v8::HandleScope scope;
+    LocalContext env;
+    i::Isolate* internal_isolate = reinterpret_cast<i::Isolate*>(isolate);
+    CHECK_EQ(128, internal_isolate->keyed_lookup_cache()->length());
+    CHECK_EQ(128, internal_isolate->descriptor_lookup_cache()->length());
+
+    // Keyed loads with many names go through the generic keyed load stub,
+    // which falls back to the runtime on lookup cache misses.
+    keyed_lookup_cache_misses = 0;
+    descriptor_lookup_cache_hits = descriptor_lookup_cache_misses = 0;
+    CompileRun("var o = {};"
+               "var names = [];"
+               "for (var i = 0; i < 10; i++) {"
+               "  names.push('p' + i);"
+               "  o[names[i]] = i;"
+               "}"
+               "function load(o, name) { return o[name]; }"
+               "var sum = 0;"
+               "for (var j = 0; j < 10; j++) {"
+               "  for (var i = 0; i < names.length; i++) {"
+               "    sum += load(o, names[i]);"
+               "  }"
+               "}");
+    CHECK_EQ(450, CompileRun("sum")->Int32Value());
+    CHECK_GT(keyed_lookup_cache_misses, 0);
+    CHECK_GT(descriptor_lookup_cache_misses, 0);
+    CHECK_GT(descriptor_lookup_cache_hits, 0);
+  }
+  isolate->Dispose();
+}
+
+
 THREADED_TEST(GetHeapStatistics) {
   v8::HandleScope scope;
   LocalContext c1;
@@ -14482,6 +15047,30 @@ TEST(RunDefaultAndAnotherIsolate) {
   ExpectTrue("function f() { return bar == 371; }; f()");
 }
 
+TEST(HandleScopeInIsolate) {
+  v8::Isolate* default_isolate = v8::Isolate::GetCurrent();
+  v8::Isolate* isolate = v8::Isolate::New();
+  CHECK(isolate);
+  isolate->Enter();
+  CHECK_EQ(isolate, v8::Isolate::GetCurrent());
+  {
+    v8::HandleScope scope(isolate);
+    LocalContext context;
+    Local<Value> number = v8::Number::New(153);
+    Local<Value> copy;
+    {
+      v8::HandleScope inner_scope(isolate);
+      copy = inner_scope.Close(Local<Value>::New(isolate, number));
+    }
+    CHECK_EQ(153, copy->Int32Value());
+    Local<Value> object = Local<Value>::New(isolate, CompileRun("({a: 1})"));
+    CHECK(object->IsObject());
+  }
+  isolate->Exit();
+  CHECK_EQ(default_isolate, v8::Isolate::GetCurrent());
+  isolate->Dispose();
+}
+
 TEST(DisposeIsolateWhenInUse) {
   v8::Isolate* isolate = v8::Isolate::New();
   CHECK(isolate);
@@ -15644,3 +16233,329 @@ THREADED_TEST(ForeignFunctionReceiver) {
 
   foreign_context.Dispose();
 }
+
+
+TEST(ContextPool) {
+  v8::HandleScope scope;
+  Local<ObjectTemplate> global_template = ObjectTemplate::New();
+  global_template->Set(v8_str("fromTemplate"), v8_num(42));
+  v8::ContextPool::Options options;
+  options.size = 2;
+  v8::ContextPool pool(v8::Isolate::GetCurrent(), options, global_template);
+  CHECK_EQ(0, pool.AvailableCount());
+  pool.Refill();
+  CHECK_EQ(2, pool.AvailableCount());
+
+  v8::Persistent<Context> first = pool.Acquire();
+  CHECK_EQ(1, pool.AvailableCount());
+  Local<v8::Object> first_global;
+  {
+    Context::Scope context_scope(first);
+    first_global = first->Global();
+    CHECK_EQ(42, CompileRun("fromTemplate")->Int32Value());
+    CompileRun("var leaked = 1;");
+  }
+  pool.Release(first, v8::ContextPool::kRecycle);
+
+  // Refilling reuses the recycled global proxy with a fresh global object.
+  pool.Refill();
+  CHECK_EQ(2, pool.AvailableCount());
+  v8::Persistent<Context> second = pool.Acquire();
+  v8::Persistent<Context> third = pool.Acquire();
+  CHECK_EQ(0, pool.AvailableCount());
+  v8::Persistent<Context> recycled =
+      second->Global()->Equals(first_global) ? second : third;
+  CHECK(recycled->Global()->Equals(first_global));
+  {
+    Context::Scope context_scope(recycled);
+    CHECK_EQ(42, CompileRun("fromTemplate")->Int32Value());
+    CHECK(CompileRun("typeof leaked")->Equals(v8_str("undefined")));
+  }
+
+  // An empty pool still hands out contexts.
+  v8::Persistent<Context> fourth = pool.Acquire();
+  CHECK(!fourth.IsEmpty());
+  pool.Release(second);
+  pool.Release(third);
+  pool.Release(fourth);
+}
+
+
+class TestCloneDelegate : public v8::StructuredClone::Delegate {
+ public:
+  TestCloneDelegate() : allocated_(0), freed_(0), created_(0) { }
+
+  virtual void* AllocateExternalArrayData(size_t size) {
+    allocated_++;
+    return malloc(size);
+  }
+
+  virtual void FreeExternalArrayData(void* data) {
+    freed_++;
+    free(data);
+  }
+
+  virtual void ExternalArrayCreated(v8::Handle<v8::Object> object,
+                                    void* data) {
+    created_++;
+  }
+
+  int allocated_;
+  int freed_;
+  int created_;
+};
+
+
+THREADED_TEST(StructuredClone) {
+  v8::HandleScope scope;
+  LocalContext env;
+  TestCloneDelegate delegate;
+  Local<Value> value = CompileRun(
+      "var shared = { s: 'shared' };"
+      "var o = { a: 1, b: 2.5, c: 'str\\u1234', d: [1, , shared, null],"
+      "          e: shared, f: new Date(12345), g: undefined, h: true };"
+      "o.self = o;"
+      "o");
+  v8::StructuredClone* clone =
+      v8::StructuredClone::Serialize(value, Local<v8::Array>(), &delegate);
+  CHECK(clone != NULL);
+  CHECK_GT(clone->length(), 0);
+
+  LocalContext other;
+  Local<Value> copy = clone->Deserialize();
+  delete clone;
+  CHECK(copy->IsObject());
+  CHECK(!copy->StrictEquals(value));
+  other->Global()->Set(v8_str("copy"), copy);
+  ExpectTrue("copy.a === 1");
+  ExpectTrue("copy.b === 2.5");
+  ExpectTrue("copy.c === 'str\\u1234'");
+  ExpectTrue("copy.d.length === 4 && !(1 in copy.d)");
+  ExpectTrue("copy.d[2] === copy.e && copy.e.s === 'shared'");
+  ExpectTrue("copy.d[3] === null");
+  ExpectTrue("copy.f instanceof Date && copy.f.getTime() === 12345");
+  ExpectTrue("'g' in copy && copy.g === undefined && copy.h === true");
+  ExpectTrue("copy.self === copy");
+
+  // Functions cannot be cloned.
+  {
+    v8::TryCatch try_catch;
+    CHECK(v8::StructuredClone::Serialize(CompileRun("({ f: function() {} })"),
+                                         Local<v8::Array>(),
+                                         &delegate) == NULL);
+    CHECK(try_catch.HasCaught());
+  }
+}
+
+
+THREADED_TEST(StructuredCloneExternalArrays) {
+  v8::HandleScope scope;
+  LocalContext env;
+  TestCloneDelegate delegate;
+  const int kLength = 16;
+  uint8_t* copied_data = static_cast<uint8_t*>(malloc(kLength));
+  uint8_t* moved_data = static_cast<uint8_t*>(malloc(kLength));
+  for (int i = 0; i < kLength; i++) {
+    copied_data[i] = i;
+    moved_data[i] = 2 * i;
+  }
+  Local<v8::Object> copied = v8::Object::New();
+  copied->SetIndexedPropertiesToExternalArrayData(
+      copied_data, v8::kExternalUnsignedByteArray, kLength);
+  copied->Set(v8_str("name"), v8_str("copied"));
+  Local<v8::Object> moved = v8::Object::New();
+  moved->SetIndexedPropertiesToExternalArrayData(
+      moved_data, v8::kExternalUnsignedByteArray, kLength);
+  Local<v8::Array> value = v8::Array::New(2);
+  value->Set(0, copied);
+  value->Set(1, moved);
+  Local<v8::Array> transfer = v8::Array::New(1);
+  transfer->Set(0, moved);
+
+  v8::StructuredClone* clone =
+      v8::StructuredClone::Serialize(value, transfer, &delegate);
+  CHECK(clone != NULL);
+  // The transferred array is left empty, the copied one is untouched.
+  CHECK_EQ(0, moved->GetIndexedPropertiesExternalArrayDataLength());
+  CHECK_EQ(kLength, copied->GetIndexedPropertiesExternalArrayDataLength());
+
+  Local<v8::Array> copy = Local<v8::Array>::Cast(clone->Deserialize());
+  delete clone;
+  CHECK_EQ(1, delegate.allocated_);
+  CHECK_EQ(2, delegate.created_);
+  CHECK_EQ(0, delegate.freed_);
+
+  Local<v8::Object> copied_copy = copy->Get(0)->ToObject();
+  Local<v8::Object> moved_copy = copy->Get(1)->ToObject();
+  CHECK(copied_copy->GetIndexedPropertiesExternalArrayData() != copied_data);
+  CHECK_EQ(moved_data, moved_copy->GetIndexedPropertiesExternalArrayData());
+  CHECK_EQ(kLength, moved_copy->GetIndexedPropertiesExternalArrayDataLength());
+  CHECK_EQ(5, copied_copy->Get(5)->Int32Value());
+  CHECK_EQ(10, moved_copy->Get(5)->Int32Value());
+  CHECK(copied_copy->Get(v8_str("name"))->Equals(v8_str("copied")));
+
+  free(copied_data);
+  free(moved_data);
+  free(copied_copy->GetIndexedPropertiesExternalArrayData());
+
+  // A transferred store that is never deserialized goes back to the
+  // delegate.
+  uint8_t* dropped_data = static_cast<uint8_t*>(malloc(kLength));
+  Local<v8::Object> dropped = v8::Object::New();
+  dropped->SetIndexedPropertiesToExternalArrayData(
+      dropped_data, v8::kExternalUnsignedByteArray, kLength);
+  Local<v8::Array> dropped_transfer = v8::Array::New(1);
+  dropped_transfer->Set(0, dropped);
+  delete v8::StructuredClone::Serialize(dropped, dropped_transfer, &delegate);
+  CHECK_EQ(1, delegate.freed_);
+}
+
+
+// Runs background tasks on threads of their own and queues isolate tasks
+// until the test pumps them.
+class QueueingTaskRunner : public v8::TaskRunner {
+ public:
+  QueueingTaskRunner() : mutex_(i::OS::CreateMutex()), background_tasks_(0) { }
+
+  ~QueueingTaskRunner() {
+    for (int i = 0; i < threads_.length(); i++) {
+      threads_[i]->Join();
+      delete threads_[i];
+    }
+    delete mutex_;
+  }
+
+  void PostBackgroundTask(v8::Task* task) {
+    i::ScopedLock lock(mutex_);
+    background_tasks_++;
+    TaskThread* thread = new TaskThread(task);
+    thread->Start();
+    threads_.Add(thread);
+  }
+
+  void PostIsolateTask(v8::Isolate* isolate, v8::Task* task) {
+    i::ScopedLock lock(mutex_);
+    isolate_tasks_.Add(task);
+  }
+
+  bool RunIsolateTask() {
+    v8::Task* task = NULL;
+    {
+      i::ScopedLock lock(mutex_);
+      if (isolate_tasks_.is_empty()) return false;
+      task = isolate_tasks_.Remove(0);
+    }
+    task->Run();
+    delete task;
+    return true;
+  }
+
+  int background_tasks() {
+    i::ScopedLock lock(mutex_);
+    return background_tasks_;
+  }
+
+ private:
+  class TaskThread : public i::Thread {
+   public:
+    explicit TaskThread(v8::Task* task)
+        : Thread("QueueingTaskRunner"), task_(task) { }
+    void Run() {
+      task_->Run();
+      delete task_;
+    }
+   private:
+    v8::Task* task_;
+  };
+
+  i::Mutex* mutex_;
+  int background_tasks_;
+  i::List<TaskThread*> threads_;
+  i::List<v8::Task*> isolate_tasks_;
+};
+
+
+static int compiled_scripts = 0;
+static int failed_scripts = 0;
+
+
+static void ScriptCompiled(v8::Local<v8::Script> script,
+                           v8::Local<v8::Value> exception,
+                           void* data) {
+  if (script.IsEmpty()) {
+    CHECK(!exception.IsEmpty());
+    failed_scripts++;
+    return;
+  }
+  CHECK(exception.IsEmpty());
+  CHECK_EQ(42, script->Run()->Int32Value());
+  compiled_scripts++;
+}
+
+
+TEST(TaskRunner) {
+  QueueingTaskRunner runner;
+  v8::V8::SetTaskRunner(&runner);
+  {
+    v8::HandleScope scope;
+    LocalContext env;
+
+    v8::Script::CompileAsync(v8_str("function f() { return 42; } f()"),
+                             v8_str("ok.js"),
+                             ScriptCompiled);
+    v8::Script::CompileAsync(v8_str("function ("),
+                             v8_str("error.js"),
+                             ScriptCompiled);
+    // Both compilations finish in isolate tasks.
+    CHECK_EQ(0, compiled_scripts + failed_scripts);
+    while (compiled_scripts + failed_scripts < 2) {
+      if (!runner.RunIsolateTask()) i::OS::Sleep(1);
+    }
+    CHECK_EQ(1, compiled_scripts);
+    CHECK_EQ(1, failed_scripts);
+    CHECK_EQ(2, runner.background_tasks());
+
+    // Concurrent sweeping runs on the task runner, too.
+    i::FLAG_concurrent_sweeping = true;
+    CompileRun("var garbage = [];"
+               "for (var i = 0; i < 20000; i++) garbage.push({ g: i });");
+    HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+    HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+    CompileRun("garbage = null;");
+    HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+    HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+    CHECK_GT(runner.background_tasks(), 2);
+    i::FLAG_concurrent_sweeping = false;
+  }
+  v8::V8::SetTaskRunner(NULL);
+}
+
+
+TEST(FunctionBailoutReasons) {
+  i::FLAG_allow_natives_syntax = true;
+  v8::HandleScope scope;
+  LocalContext env;
+  if (!i::V8::UseCrankshaft()) return;
+
+  CompileRun("function f() { try { return 1; } catch (e) { return 2; } }"
+             "function g() { return 1; }"
+             "f(); %OptimizeFunctionOnNextCall(f); f();"
+             "g(); %OptimizeFunctionOnNextCall(g); g();");
+  Local<v8::Function> f =
+      Local<v8::Function>::Cast(env->Global()->Get(v8_str("f")));
+  Local<v8::Function> g =
+      Local<v8::Function>::Cast(env->Global()->Get(v8_str("g")));
+
+  CHECK(f->IsOptimizationDisabled());
+  CHECK(f->GetBailoutReason()->Equals(v8_str("TryCatchStatement")));
+  Local<v8::Array> reasons = f->GetBailoutReasons();
+  CHECK_EQ(1, reasons->Length());
+  Local<v8::Array> pair = Local<v8::Array>::Cast(reasons->Get(0));
+  CHECK(pair->Get(0)->Equals(v8_str("TryCatchStatement")));
+  CHECK_EQ(1, pair->Get(1)->Int32Value());
+  CHECK_EQ(0, f->GetDeoptimizationCount());
+
+  CHECK(!g->IsOptimizationDisabled());
+  CHECK(g->GetBailoutReason()->IsUndefined());
+  CHECK_EQ(0, g->GetBailoutReasons()->Length());
+}
@@ -56,3 +56,34 @@ TEST(List) {
   CHECK_EQ(0, list->length());
   delete list;
 }
+
+
+TEST(ZoneSegmentPool) {
+  v8::internal::V8::Initialize(NULL);
+  Isolate* isolate = Isolate::Current();
+  ZoneSegmentPool* pool = isolate->zone_segment_pool();
+  pool->Clear();
+
+  // A segment too large to be kept by the zone goes to the pool when the
+  // zone is deleted, and the next zone expansion reuses it.
+  static const int kSize = 256 * KB;
+  void* first;
+  { ZoneScope zone_scope(isolate, DELETE_ON_EXIT);
+    first = ZONE->New(kSize);
+  }
+  void* second;
+  { ZoneScope zone_scope(isolate, DELETE_ON_EXIT);
+    second = ZONE->New(kSize);
+  }
+  CHECK_EQ(first, second);
+
+  // Nothing is retained when the pool is disabled.
+  int pool_size = FLAG_zone_segment_pool_size;
+  FLAG_zone_segment_pool_size = 0;
+  pool->Clear();
+  { ZoneScope zone_scope(isolate, DELETE_ON_EXIT);
+    ZONE->New(kSize);
+  }
+  CHECK(pool->Get(kSize) == NULL);
+  FLAG_zone_segment_pool_size = pool_size;
+}
@@ -35,7 +35,10 @@
 #include "disassembler.h"
 #include "execution.h"
 #include "factory.h"
+#include "feedback-profile.h"
+#include "ic-inl.h"
 #include "platform.h"
+#include "version.h"
 #include "cctest.h"
 
 using namespace v8::internal;
@@ -353,6 +356,158 @@ TEST(GetScriptLineNumber) {
 }
 
 
+// The compact line ends table must agree with a plain array of line ends
+// across chunk boundaries and for lines longer than a one byte delta.
+TEST(ScriptLineEndsTable) {
+  InitializeVM();
+  v8::HandleScope scope;
+
+  const int kLines = 300;
+  List<char> chars;
+  for (int i = 0; i < kLines; i++) {
+    int length = (i % 7 == 0) ? 200 + i * 50 : i % 5;
+    for (int j = 0; j < length; j++) chars.Add('x');
+    chars.Add('\n');
+  }
+  for (int j = 0; j < 10; j++) chars.Add('y');  // Unterminated last line.
+  Handle<String> source = FACTORY->NewStringFromAscii(
+      Vector<const char>(chars.ToVector().start(), chars.length()));
+  Handle<Script> script = FACTORY->NewScript(source);
+  script->set_line_offset(Smi::FromInt(3));
+
+  Handle<FixedArray> expected = CalculateLineEnds(source, true);
+  CHECK_EQ(kLines + 1, expected->length());
+  CHECK_EQ(expected->length(), GetScriptLineCount(script));
+  Handle<FixedArray> line_ends = GetScriptLineEnds(script);
+  for (int i = 0; i < expected->length(); i++) {
+    CHECK_EQ(expected->get(i), line_ends->get(i));
+    CHECK_EQ(Smi::cast(expected->get(i))->value(), GetScriptLineEnd(script, i));
+  }
+  CHECK_EQ(-1, GetScriptLineEnd(script, expected->length()));
+
+  int line = 0;
+  for (int pos = 0; pos <= source->length(); pos++) {
+    while (line < expected->length() &&
+           Smi::cast(expected->get(line))->value() < pos) {
+      line++;
+    }
+    int line_or_end = line < expected->length() ? line : -1;
+    CHECK_EQ(line_or_end, GetScriptLineFromPosition(script, pos));
+    // GetScriptLineNumber counts a line end character as part of the next
+    // line, except on the first line.
+    int number = line;
+    if (line > 0 && line < expected->length() &&
+        Smi::cast(expected->get(line))->value() == pos) {
+      number++;
+    }
+    CHECK_EQ(number + 3, GetScriptLineNumber(script, pos));
+  }
+}
+
+
+TEST(ConcurrentRecompilation) {
+  FLAG_concurrent_recompilation = true;
+  FLAG_allow_natives_syntax = true;
+  v8::HandleScope scope;
+  LocalContext env;
+  if (!V8::UseCrankshaft()) return;
+
+  CompileRun("function f(x) {"
+             "  var s = 0;"
+             "  for (var i = 0; i < x; i++) s += i;"
+             "  return s;"
+             "}"
+             "f(10); f(10);"
+             "%OptimizeFunctionOnNextCall(f);"
+             "f(10);");
+  v8::Local<v8::Function> fun =
+      v8::Local<v8::Function>::Cast(env->Global()->Get(v8_str("f")));
+  Handle<JSFunction> f = v8::Utils::OpenHandle(*fun);
+
+  // The graph of a queued function must survive objects being moved.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+
+  // The optimized code is installed at a stack guard check once the
+  // optimizing compiler thread is done with it.
+  for (int i = 0; i < 1000 && !f->IsOptimized(); i++) {
+    OS::Sleep(1);
+    CompileRun("f(10);");
+  }
+  CHECK(f->IsOptimized());
+  CHECK_EQ(45, CompileRun("f(10)")->Int32Value());
+}
+
+
+TEST(FeedbackProfile) {
+  FLAG_allow_natives_syntax = true;
+  v8::HandleScope scope;
+  LocalContext env;
+  if (!V8::UseCrankshaft()) return;
+
+  v8::Script::Compile(v8_str("function f(x) {"
+                             "  var s = 0;"
+                             "  for (var i = 0; i < x; i++) s += i;"
+                             "  return s;"
+                             "}"
+                             "function g(x) { return x + 1; }"
+                             "f(10); f(10);"
+                             "%OptimizeFunctionOnNextCall(f);"
+                             "f(10); g(1);"),
+                      v8_str("profile.js"))->Run();
+  v8::Local<v8::Function> fun =
+      v8::Local<v8::Function>::Cast(env->Global()->Get(v8_str("f")));
+  Handle<JSFunction> f = v8::Utils::OpenHandle(*fun);
+  fun = v8::Local<v8::Function>::Cast(env->Global()->Get(v8_str("g")));
+  Handle<JSFunction> g = v8::Utils::OpenHandle(*fun);
+  CHECK(f->IsOptimized());
+
+  FeedbackProfile profile(Isolate::Current());
+  profile.Record();
+  FeedbackProfileEntry* entry = profile.Find(f->shared());
+  CHECK(entry != NULL);
+  CHECK(profile.Find(g->shared()) != NULL);
+  SmartArrayPointer<const char> data = profile.Serialize();
+
+  // Loading the serialized profile gives back the same profile.
+  FeedbackProfile loaded(Isolate::Current());
+  CHECK(loaded.Deserialize(CStrVector(*data)));
+  CHECK_EQ(profile.length(), loaded.length());
+  CHECK_EQ(*data, *loaded.Serialize());
+
+  // Only the functions that got optimized are optimized eagerly.
+  CHECK(!f->shared()->optimize_from_profile());
+  loaded.ApplyTo(f->shared());
+  CHECK(f->shared()->optimize_from_profile());
+  loaded.ApplyTo(g->shared());
+  CHECK(!g->shared()->optimize_from_profile());
+
+  // Malformed profiles are rejected as a whole.
+  EmbeddedVector<char, 256> buffer;
+  const char* header = "v8-feedback-profile 2 %s\n%s";
+  OS::SNPrintF(buffer, header, Version::GetVersion(), "i 1 2 3\n");
+  CHECK(!loaded.Deserialize(CStrVector(buffer.start())));
+  CHECK_EQ(0, loaded.length());
+  CHECK(!loaded.Deserialize(CStrVector("garbage")));
+
+  // So are IC states out of range for the kind of IC.
+  EmbeddedVector<char, 64> ic;
+  OS::SNPrintF(ic, "f 0 10 0 profile.js\ni %d 1 %d\n",
+               Code::COMPARE_IC, CompareIC::GENERIC + 1);
+  OS::SNPrintF(buffer, header, Version::GetVersion(), ic.start());
+  CHECK(!loaded.Deserialize(CStrVector(buffer.start())));
+  OS::SNPrintF(ic, "f 0 10 0 profile.js\ni %d 1 %d\n",
+               Code::COMPARE_IC, CompareIC::GENERIC);
+  OS::SNPrintF(buffer, header, Version::GetVersion(), ic.start());
+  CHECK(loaded.Deserialize(CStrVector(buffer.start())));
+  CHECK_EQ(1, loaded.length());
+
+  // And profiles saved by another V8 version.
+  CHECK(!loaded.Deserialize(CStrVector(
+      "v8-feedback-profile 2 0.0.0\nf 0 10 0 profile.js\n")));
+  CHECK_EQ(0, loaded.length());
+}
+
+
 #ifdef ENABLE_DISASSEMBLER
 static Handle<JSFunction> GetJSFunction(v8::Handle<v8::Object> obj,
                                  const char* property_name) {
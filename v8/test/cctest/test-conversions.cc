@@ -224,6 +224,67 @@ TEST(ExponentNumberStr) {
   CHECK_EQ(1e-106, StringToDouble(&uc, ".000001e-100", NO_FLAGS));
 }
 
+
+TEST(FastAsciiStringToDouble) {
+  UnicodeCache uc;
+  const char* integers[] = {
+    "0", "-0", "7", "-42", "12345678", "123456789", "123456789012345"
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(integers); i++) {
+    const char* str = integers[i];
+    double fast;
+    CHECK(FastAsciiStringToDouble(str, str + StrLength(str), &fast));
+    CHECK_EQ(strtod(str, NULL), fast);
+    CHECK_EQ(strtod(str, NULL), StringToDouble(&uc, str, NO_FLAGS));
+  }
+  // Fractions are not converted on platforms with x87 double rounding.
+  const char* fractions[] = {
+    "0.5", "-0.25", "3.14159265358979", "12345678.1234567", "0.00000001",
+    "99999999.9999999", "1234567.8"
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(fractions); i++) {
+    const char* str = fractions[i];
+    double fast;
+    if (FastAsciiStringToDouble(str, str + StrLength(str), &fast)) {
+      CHECK_EQ(strtod(str, NULL), fast);
+    }
+    CHECK_EQ(strtod(str, NULL), StringToDouble(&uc, str, NO_FLAGS));
+  }
+  const char* minus_zero_str = "-0";
+  double minus_zero;
+  CHECK(FastAsciiStringToDouble(minus_zero_str, minus_zero_str + 2,
+                                &minus_zero));
+  CHECK(minus_zero == 0 && signbit(minus_zero));
+
+  // Anything else is left to the general conversion.
+  const char* others[] = {
+    "", "-", " 1", "1 ", "+1", "01", "00", "1.", ".5", "1e5", "0x10",
+    "1234567890123456", "1.2.3", "12345678a", "Infinity"
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(others); i++) {
+    const char* str = others[i];
+    double result = 17;
+    CHECK(!FastAsciiStringToDouble(str, str + StrLength(str), &result));
+    CHECK_EQ(17.0, result);
+  }
+  CHECK_EQ(1.0, StringToDouble(&uc, "01", NO_FLAGS));
+  CHECK_EQ(1234567890123456.0,
+           StringToDouble(&uc, "1234567890123456", NO_FLAGS));
+}
+
+
+TEST(DoubleToCStringIntegers) {
+  char buffer[kDoubleToCStringMinBufferSize];
+  Vector<char> vector(buffer, ARRAY_SIZE(buffer));
+  CHECK_EQ("42", DoubleToCString(42.0, vector));
+  CHECK_EQ("-42", DoubleToCString(-42.0, vector));
+  CHECK_EQ("9007199254740991", DoubleToCString(9007199254740991.0, vector));
+  CHECK_EQ("-9007199254740991", DoubleToCString(-9007199254740991.0, vector));
+  CHECK_EQ("9007199254740992", DoubleToCString(9007199254740992.0, vector));
+  CHECK_EQ("1e+21", DoubleToCString(1e21, vector));
+  CHECK_EQ("42.5", DoubleToCString(42.5, vector));
+}
+
 class OneBit1: public BitField<uint32_t, 0, 1> {};
 class OneBit2: public BitField<uint32_t, 7, 1> {};
 class EightBit1: public BitField<uint32_t, 0, 8> {};
@@ -0,0 +1,132 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <stdlib.h>
+
+#include "v8.h"
+
+#include "cctest.h"
+#include "counters.h"
+
+using namespace v8::internal;
+
+
+TEST(CounterBlock) {
+  CounterBlock* block = CounterBlock::New(NULL);
+  CHECK_NE(NULL, block);
+  CHECK_EQ(0, block->counters_in_use());
+
+  int* a = block->Lookup("c:V8.A");
+  int* b = block->Lookup("c:V8.B");
+  CHECK_NE(NULL, a);
+  CHECK_NE(NULL, b);
+  CHECK_EQ(2, block->counters_in_use());
+  CHECK_EQ(a, block->Lookup("c:V8.A"));
+  // Every counter has a cache line to itself.
+  CHECK(abs(static_cast<int>(reinterpret_cast<char*>(b) -
+                             reinterpret_cast<char*>(a))) >= 64);
+
+  *a += 3;
+  (*b)++;
+  CHECK_EQ("c:V8.A", block->name(0));
+  CHECK_EQ(3, block->value(0));
+  CHECK_EQ("c:V8.B", block->name(1));
+  CHECK_EQ(1, block->value(1));
+
+  // Names longer than a slot are truncated and still found.
+  char long_name[CounterBlock::kMaxNameSize * 2];
+  memset(long_name, 'x', sizeof(long_name) - 1);
+  long_name[sizeof(long_name) - 1] = '\0';
+  int* c = block->Lookup(long_name);
+  CHECK_EQ(c, block->Lookup(long_name));
+  CHECK_EQ(CounterBlock::kMaxNameSize - 1,
+           static_cast<int>(strlen(block->name(2))));
+
+  // Lookups fail once the block is full.
+  char name[16];
+  for (int i = block->counters_in_use(); i < CounterBlock::kMaxCounters; i++) {
+    OS::SNPrintF(Vector<char>(name, sizeof(name)), "c:%d", i);
+    CHECK_NE(NULL, block->Lookup(name));
+  }
+  CHECK_EQ(NULL, block->Lookup("c:V8.Overflow"));
+  CHECK_EQ(a, block->Lookup("c:V8.A"));
+  delete block;
+}
+
+
+TEST(CounterBlockInStatsTable) {
+  v8::HandleScope scope;
+  LocalContext env;
+  StatsTable* table = Isolate::Current()->stats_table();
+  CHECK(!table->HasCounterFunction());
+  CHECK(table->EnableCounterBlock(NULL));
+  int* location = table->FindLocation("c:V8.Test");
+  CHECK_NE(NULL, location);
+  CHECK_EQ(location, table->counter_block()->Lookup("c:V8.Test"));
+}
+
+
+class RuntimeCallCollector : public v8::RuntimeCallStatsVisitor {
+ public:
+  RuntimeCallCollector() : calls_(0), split_count_(0), sorted_(true),
+                           last_time_(0) {}
+
+  virtual void VisitRuntimeCall(const char* name, int count, double time_ms) {
+    CHECK_GT(count, 0);
+    if (calls_ > 0 && time_ms > last_time_) sorted_ = false;
+    last_time_ = time_ms;
+    calls_++;
+    if (strcmp(name, "Runtime_StringSplit") == 0) split_count_ = count;
+  }
+
+  int calls_;
+  int split_count_;
+  bool sorted_;
+  double last_time_;
+};
+
+
+TEST(RuntimeCallStats) {
+  FLAG_runtime_call_stats = true;
+  v8::HandleScope scope;
+  LocalContext env;
+  v8::V8::ResetRuntimeCallStats();
+  CompileRun("for (var i = 0; i < 10; i++) ('a,b,' + i).split(',');");
+
+  RuntimeCallCollector collector;
+  v8::V8::VisitRuntimeCallStats(&collector);
+  CHECK_GT(collector.calls_, 0);
+  CHECK_EQ(10, collector.split_count_);
+  CHECK(collector.sorted_);
+
+  v8::V8::ResetRuntimeCallStats();
+  RuntimeCallCollector after_reset;
+  v8::V8::VisitRuntimeCallStats(&after_reset);
+  CHECK_EQ(0, after_reset.calls_);
+  FLAG_runtime_call_stats = false;
+}
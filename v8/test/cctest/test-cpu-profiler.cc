@@ -397,3 +397,83 @@ TEST(DeleteCpuProfileDifferentTokens) {
   CHECK_EQ(0, CpuProfiler::GetProfilesCount());
   CHECK_EQ(NULL, v8::CpuProfiler::FindProfile(uid3));
 }
+
+
+// Sampling from a timer on the VM thread's CPU time clock must produce
+// ticks. Platforms without such timers fall back to signals.
+TEST(CpuTimerSampling) {
+  bool saved_cpu_timer = i::FLAG_prof_cpu_timer;
+  int saved_interval = i::FLAG_prof_cpu_timer_interval;
+  i::FLAG_prof_cpu_timer = true;
+  i::FLAG_prof_cpu_timer_interval = 500;
+  v8::HandleScope scope;
+  LocalContext env;
+
+  v8::Local<v8::String> name = v8::String::New("cpu-timer");
+  v8::CpuProfiler::StartProfiling(name);
+  CompileRun("function spin() {"
+             "  var s = 0;"
+             "  for (var i = 0; i < 1000000; i++) s += i % 7;"
+             "  return s;"
+             "}");
+  double start = i::OS::TimeCurrentMillis();
+  while (i::OS::TimeCurrentMillis() - start < 200) CompileRun("spin();");
+  const v8::CpuProfile* profile = v8::CpuProfiler::StopProfiling(name);
+  CHECK_NE(NULL, profile);
+  CHECK_GT(profile->GetTopDownRoot()->GetTotalSamplesCount(), 0);
+
+  const_cast<v8::CpuProfile*>(profile)->Delete();
+  i::FLAG_prof_cpu_timer = saved_cpu_timer;
+  i::FLAG_prof_cpu_timer_interval = saved_interval;
+}
+
+
+static int ic_megamorphic_transitions = 0;
+
+
+static void CountMegamorphicTransitions(const char* function_name,
+                                        int position,
+                                        v8::ICProfile::Kind kind,
+                                        v8::ICProfile::State from,
+                                        v8::ICProfile::State to,
+                                        int maps_count) {
+  if (strcmp(function_name, "getX") == 0 &&
+      kind == v8::ICProfile::kLoad &&
+      to == v8::ICProfile::kMegamorphic) {
+    ic_megamorphic_transitions++;
+  }
+}
+
+
+TEST(ICProfilerMegamorphicLoad) {
+  v8::HandleScope scope;
+  LocalContext env;
+  v8::ICProfiler::DeleteAllProfiles();
+  v8::ICProfiler::StartRecording();
+  v8::ICProfiler::SetTransitionCallback(CountMegamorphicTransitions);
+  ic_megamorphic_transitions = 0;
+  CompileRun(
+      "function getX(o) { return o.x; }"
+      "var objects = [{x: 1}, {x: 1, a: 1}, {x: 1, b: 1}, {x: 1, c: 1}];"
+      "for (var i = 0; i < 4; i++) getX(objects[i]);");
+  v8::ICProfiler::StopRecording();
+  v8::ICProfiler::SetTransitionCallback(NULL);
+  CHECK_GT(ic_megamorphic_transitions, 0);
+
+  const v8::ICProfile* profile = NULL;
+  for (int i = 0; i < v8::ICProfiler::GetProfilesCount(); i++) {
+    const v8::ICProfile* candidate = v8::ICProfiler::GetProfile(i);
+    v8::String::AsciiValue name(candidate->GetFunctionName());
+    if (strcmp(*name, "getX") == 0) profile = candidate;
+  }
+  CHECK_NE(NULL, profile);
+  CHECK_EQ(1, profile->GetSitesCount());
+  CHECK_EQ(v8::ICProfile::kLoad, profile->GetSiteKind(0));
+  CHECK_EQ(v8::ICProfile::kMegamorphic, profile->GetSiteState(0));
+  CHECK_GT(profile->GetSiteTransitionsCount(0), 1);
+  CHECK_EQ(1, profile->GetSitesCountInState(v8::ICProfile::kMegamorphic));
+  CHECK_EQ(0, profile->GetSitesCountInState(v8::ICProfile::kMonomorphic));
+
+  v8::ICProfiler::DeleteAllProfiles();
+  CHECK_EQ(0, v8::ICProfiler::GetProfilesCount());
+}
@@ -0,0 +1,169 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "date.h"
+#include "dateparser-inl.h"
+#include "cctest.h"
+
+using namespace v8::internal;
+
+static const int64_t kMsPerHour = 60 * DateCache::kMsPerMin;
+
+
+// A date cache whose local timezone is one hour east of UTC and which
+// observes daylight savings time from the start of April to the start
+// of October of every year.
+class MockDateCache : public DateCache {
+ public:
+  MockDateCache() : os_calls_(0) {}
+
+  virtual int GetDaylightSavingsOffsetFromOS(int64_t time_sec) {
+    os_calls_++;
+    int days = DaysFromTime(time_sec * 1000);
+    int year, month, day;
+    YearMonthDayFromDays(days, &year, &month, &day);
+    return (3 <= month && month < 9) ? static_cast<int>(kMsPerHour) : 0;
+  }
+
+  virtual int GetLocalOffsetFromOS() {
+    return static_cast<int>(kMsPerHour);
+  }
+
+  int os_calls() { return os_calls_; }
+
+ private:
+  int os_calls_;
+};
+
+
+static int64_t TimeFromDate(int year, int month, int day, int hour) {
+  int days = DateCache::DaysFromYearMonth(year, month) + day - 1;
+  return days * DateCache::kMsPerDay + hour * kMsPerHour;
+}
+
+
+TEST(DaysFromYearMonth) {
+  CHECK_EQ(0, DateCache::DaysFromYearMonth(1970, 0));
+  CHECK_EQ(31, DateCache::DaysFromYearMonth(1970, 1));
+  CHECK_EQ(365, DateCache::DaysFromYearMonth(1970, 12));
+  CHECK_EQ(-365, DateCache::DaysFromYearMonth(1969, 0));
+  CHECK_EQ(11017, DateCache::DaysFromYearMonth(2000, 2));
+  CHECK_EQ(-719528, DateCache::DaysFromYearMonth(0, 0));
+}
+
+
+TEST(YearMonthDayFromDays) {
+  MockDateCache cache;
+  // Covers both the table driven range and the years outside of it, and
+  // goes forward and backward to exercise the cache of the last result.
+  for (int days = -800000; days < 800000; days += 97) {
+    int year, month, day;
+    cache.YearMonthDayFromDays(days, &year, &month, &day);
+    CHECK(0 <= month && month < 12);
+    CHECK(1 <= day && day <= 31);
+    CHECK_EQ(days, DateCache::DaysFromYearMonth(year, month) + day - 1);
+    cache.YearMonthDayFromDays(days + 1, &year, &month, &day);
+    CHECK_EQ(days + 1, DateCache::DaysFromYearMonth(year, month) + day - 1);
+    cache.YearMonthDayFromDays(days - 1, &year, &month, &day);
+    CHECK_EQ(days - 1, DateCache::DaysFromYearMonth(year, month) + day - 1);
+  }
+}
+
+
+TEST(DaylightSavingsTime) {
+  MockDateCache cache;
+  int64_t winter = TimeFromDate(2012, 0, 15, 12);
+  int64_t summer = TimeFromDate(2012, 6, 15, 12);
+  CHECK_EQ(winter + kMsPerHour, cache.ToLocal(winter));
+  CHECK_EQ(summer + 2 * kMsPerHour, cache.ToLocal(summer));
+  CHECK_EQ(winter, cache.ToUTC(winter + kMsPerHour));
+  CHECK_EQ(summer, cache.ToUTC(summer + 2 * kMsPerHour));
+  CHECK_EQ(-60, cache.TimezoneOffset(winter));
+  CHECK_EQ(-120, cache.TimezoneOffset(summer));
+
+  // Walking through a year hour by hour finds both transitions and asks
+  // the OS far less often than once per hour.
+  int64_t start = TimeFromDate(2013, 0, 1, 0);
+  int64_t end = TimeFromDate(2014, 0, 1, 0);
+  int calls = cache.os_calls();
+  for (int64_t t = start; t < end; t += kMsPerHour) {
+    int year, month, day;
+    cache.YearMonthDayFromDays(DateCache::DaysFromTime(t), &year, &month, &day);
+    int64_t expected = (3 <= month && month < 9) ? 2 : 1;
+    CHECK_EQ(t + expected * kMsPerHour, cache.ToLocal(t));
+  }
+  CHECK(cache.os_calls() - calls < 365 * 24 / 10);
+
+  // Resetting the cache changes the stamp, which invalidates the fields
+  // cached on JSDate objects.
+  Smi* stamp = cache.stamp();
+  cache.ResetDateCache();
+  CHECK_NE(stamp, cache.stamp());
+  CHECK_EQ(summer + 2 * kMsPerHour, cache.ToLocal(summer));
+}
+
+
+static bool ParseISO(MockDateCache* cache, const char* str, double* time) {
+  return DateParser::ParseISODateTime(CStrVector(str), cache, time);
+}
+
+
+TEST(ParseISODateTime) {
+  MockDateCache cache;
+  double time;
+  CHECK(ParseISO(&cache, "2012-03-04", &time));
+  CHECK_EQ(static_cast<double>(TimeFromDate(2012, 2, 4, 0)), time);
+  CHECK(ParseISO(&cache, "2012-03-04T05:06", &time));
+  CHECK_EQ(static_cast<double>(TimeFromDate(2012, 2, 4, 5) + 6 * 60000), time);
+  CHECK(ParseISO(&cache, "2012-03-04T05:06:07.089Z", &time));
+  CHECK_EQ(static_cast<double>(TimeFromDate(2012, 2, 4, 5) + 367089), time);
+  CHECK(ParseISO(&cache, "2012-03-04T05:06:07+01:30", &time));
+  CHECK_EQ(static_cast<double>(TimeFromDate(2012, 2, 4, 5) + 367000 -
+                               90 * 60000), time);
+  CHECK(ParseISO(&cache, "2012-03-04T05:06:07-01:30", &time));
+  CHECK_EQ(static_cast<double>(TimeFromDate(2012, 2, 4, 5) + 367000 +
+                               90 * 60000), time);
+
+  // The day of a cached prefix is reused; a different day in the same
+  // entry replaces it.
+  CHECK(ParseISO(&cache, "2012-03-14T00:00Z", &time));
+  CHECK_EQ(static_cast<double>(TimeFromDate(2012, 2, 14, 0)), time);
+  CHECK(ParseISO(&cache, "2012-03-04T00:00Z", &time));
+  CHECK_EQ(static_cast<double>(TimeFromDate(2012, 2, 4, 0)), time);
+
+  // Other layouts and invalid values are left to the general parser.
+  CHECK(!ParseISO(&cache, "2012-3-04", &time));
+  CHECK(!ParseISO(&cache, "2012-13-04", &time));
+  CHECK(!ParseISO(&cache, "2012-03-04 05:06", &time));
+  CHECK(!ParseISO(&cache, "2012-03-04T24:00", &time));
+  CHECK(!ParseISO(&cache, "2012-03-04T05:06:07.0891Z", &time));
+  CHECK(!ParseISO(&cache, "2012-03-04T05:06+0130", &time));
+  CHECK(!ParseISO(&cache, "+002012-03-04", &time));
+  CHECK(!ParseISO(&cache, "Sun Mar 04 2012", &time));
+}
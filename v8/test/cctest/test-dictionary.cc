@@ -100,6 +100,49 @@ TEST(ObjectHashTable) {
 
 
 #ifdef DEBUG
+TEST(OrderedHashTable) {
+  v8::HandleScope scope;
+  LocalContext context;
+  Handle<OrderedHashTable> table = FACTORY->NewOrderedHashTable(0);
+  CHECK_EQ(OrderedHashTable::kMinCapacity, table->Capacity());
+
+  // Entries are kept in insertion order while the table grows.
+  static const int kNumberOfKeys = 50;
+  Handle<JSObject> keys[kNumberOfKeys];
+  for (int i = 0; i < kNumberOfKeys; i++) {
+    keys[i] = FACTORY->NewJSArray(7);
+    table = OrderedHashTablePut(table, keys[i], Handle<Smi>(Smi::FromInt(i)));
+  }
+  CHECK_EQ(kNumberOfKeys, table->NumberOfElements());
+  for (int i = 0; i < kNumberOfKeys; i++) {
+    CHECK_EQ(*keys[i], table->KeyAt(i));
+    CHECK_EQ(Smi::FromInt(i), table->Lookup(*keys[i]));
+  }
+
+  // Removed entries leave holes until the table is compacted.
+  table = OrderedHashTableRemove(table, keys[0]);
+  CHECK_EQ(kNumberOfKeys - 1, table->NumberOfElements());
+  CHECK_EQ(1, table->NumberOfDeletedElements());
+  CHECK(!table->IsLiveEntry(0));
+  CHECK_EQ(OrderedHashTable::kNotFound, table->FindEntry(*keys[0]));
+  CHECK_EQ(HEAP->undefined_value(), table->Lookup(*keys[0]));
+
+  // Removing most keys shrinks the table and keeps the order of the rest.
+  for (int i = 1; i < kNumberOfKeys - 3; i++) {
+    table = OrderedHashTableRemove(table, keys[i]);
+  }
+  CHECK_EQ(3, table->NumberOfElements());
+  CHECK(table->Capacity() < 2 * kNumberOfKeys);
+  int live = 0;
+  for (int i = 0; i < table->UsedCapacity(); i++) {
+    if (!table->IsLiveEntry(i)) continue;
+    CHECK_EQ(*keys[kNumberOfKeys - 3 + live], table->KeyAt(i));
+    live++;
+  }
+  CHECK_EQ(3, live);
+}
+
+
 TEST(ObjectHashSetCausesGC) {
   v8::HandleScope scope;
   LocalContext context;
@@ -441,6 +441,21 @@ TEST(DisasmIa320) {
     }
   }
 
+  // Packed double instructions.
+  {
+    if (CpuFeatures::IsSupported(SSE2)) {
+      CpuFeatures::Scope fscope(SSE2);
+      __ movupd(xmm0, Operand(ebx, ecx, times_8, 10000));
+      __ movupd(Operand(ebx, ecx, times_8, 10000), xmm1);
+      __ addpd(xmm0, xmm1);
+      __ subpd(xmm1, xmm2);
+      __ mulpd(xmm2, xmm3);
+      __ divpd(xmm3, xmm4);
+      __ unpcklpd(xmm4, xmm4);
+      __ cmpunordpd(xmm5, xmm5);
+    }
+  }
+
   {
     if (CpuFeatures::IsSupported(SSE4_1)) {
       CpuFeatures::Scope scope(SSE4_1);
@@ -29,6 +29,7 @@
 
 #include "v8.h"
 #include "hashmap.h"
+#include "zone-inl.h"
 #include "cctest.h"
 
 using namespace v8::internal;
@@ -41,13 +42,15 @@ static bool DefaultMatchFun(void* a, void* b) {
 typedef uint32_t (*IntKeyHash)(uint32_t key);
 
 
+template<class Map>
 class IntSet {
  public:
   explicit IntSet(IntKeyHash hash) : hash_(hash), map_(DefaultMatchFun)  {}
 
   void Insert(int x) {
     CHECK_NE(0, x);  // 0 corresponds to (void*)NULL - illegal key value
-    HashMap::Entry* p = map_.Lookup(reinterpret_cast<void*>(x), hash_(x), true);
+    typename Map::Entry* p =
+        map_.Lookup(reinterpret_cast<void*>(x), hash_(x), true);
     CHECK(p != NULL);  // insert is set!
     CHECK_EQ(reinterpret_cast<void*>(x), p->key);
     // we don't care about p->value
@@ -59,7 +62,7 @@ class IntSet {
   }
 
   bool Present(int x) {
-    HashMap::Entry* p =
+    typename Map::Entry* p =
         map_.Lookup(reinterpret_cast<void*>(x), hash_(x), false);
     if (p != NULL) {
       CHECK_EQ(reinterpret_cast<void*>(x), p->key);
@@ -73,7 +76,7 @@ class IntSet {
 
   uint32_t occupancy() const {
     uint32_t count = 0;
-    for (HashMap::Entry* p = map_.Start(); p != NULL; p = map_.Next(p)) {
+    for (typename Map::Entry* p = map_.Start(); p != NULL; p = map_.Next(p)) {
       count++;
     }
     CHECK_EQ(map_.occupancy(), static_cast<double>(count));
@@ -82,7 +85,7 @@ class IntSet {
 
  private:
   IntKeyHash hash_;
-  HashMap map_;
+  Map map_;
 };
 
 
@@ -90,8 +93,9 @@ static uint32_t Hash(uint32_t key)  { return 23; }
 static uint32_t CollisionHash(uint32_t key)  { return key & 0x3; }
 
 
+template<class Map>
 void TestSet(IntKeyHash hash, int size) {
-  IntSet set(hash);
+  IntSet<Map> set(hash);
   CHECK_EQ(0, set.occupancy());
 
   set.Insert(1);
@@ -171,6 +175,15 @@ void TestSet(IntKeyHash hash, int size) {
 
 
 TEST(Set) {
-  TestSet(Hash, 100);
-  TestSet(CollisionHash, 50);
+  TestSet<HashMap>(Hash, 100);
+  TestSet<HashMap>(CollisionHash, 50);
+}
+
+
+TEST(ZoneSet) {
+  v8::internal::V8::Initialize(NULL);
+  Isolate* isolate = Isolate::Current();
+  ZoneScope zone_scope(isolate, DELETE_ON_EXIT);
+  TestSet<ZoneHashMap>(Hash, 100);
+  TestSet<ZoneHashMap>(CollisionHash, 50);
 }
@@ -1065,3 +1065,61 @@ TEST(FastCaseGetter) {
       GetProperty(obj1, v8::HeapGraphEdge::kProperty, "set-propWithSetter");
   CHECK_NE(NULL, setterFunction);
 }
+
+
+static int AllocationSamplesCount(LocalContext* env, const char* name) {
+  TestJSONStream stream;
+  CHECK(v8::HeapProfiler::SerializeAllocationSamples(&stream));
+  CHECK_EQ(1, stream.eos_signaled());
+  i::ScopedVector<char> json(stream.size());
+  stream.WriteTo(json);
+  (*env)->Global()->Set(v8_str("json_samples"),
+                        v8::String::New(json.start(), json.length()));
+  (*env)->Global()->Set(v8_str("sampled_name"), v8_str(name));
+  v8::Local<v8::Value> count = CompileRun(
+      "function countSamples(node) {\n"
+      "  var count = node.functionName == sampled_name ? node.count : 0;\n"
+      "  for (var i = 0; i < node.children.length; ++i)\n"
+      "    count += countSamples(node.children[i]);\n"
+      "  return count;\n"
+      "}\n"
+      "countSamples(JSON.parse(json_samples).head);");
+  return count->Int32Value();
+}
+
+
+TEST(AllocationSampling) {
+  v8::HandleScope scope;
+  LocalContext env;
+
+  v8::HeapProfiler::StartAllocationSampling(256);
+  CompileRun(
+      "var retained = [];\n"
+      "function allocateRetained() {\n"
+      "  for (var i = 0; i < 10000; ++i) retained.push([i, i + 1, i + 2]);\n"
+      "}\n"
+      "function allocateGarbage() {\n"
+      "  var sum = 0;\n"
+      "  for (var i = 0; i < 10000; ++i) sum += [i, i + 1, i + 2].length;\n"
+      "  return sum;\n"
+      "}\n"
+      "allocateRetained();\n"
+      "allocateGarbage();\n");
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+
+  // Samples of retained objects survive, samples of garbage are dropped.
+  // Code and stubs allocated while running the functions stay alive, so
+  // only compare the counts.
+  int retained = AllocationSamplesCount(&env, "allocateRetained");
+  int garbage = AllocationSamplesCount(&env, "allocateGarbage");
+  CHECK_GT(retained, 100);
+  CHECK_LT(garbage * 10, retained);
+
+  CompileRun("retained = null;");
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  CHECK_LT(AllocationSamplesCount(&env, "allocateRetained") * 10, retained);
+
+  v8::HeapProfiler::StopAllocationSampling();
+  TestJSONStream stream;
+  CHECK(!v8::HeapProfiler::SerializeAllocationSamples(&stream));
+}
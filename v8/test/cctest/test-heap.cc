@@ -4,6 +4,9 @@
 
 #include "v8.h"
 
+#include "api.h"
+#include "code-stubs.h"
+#include "compilation-cache.h"
 #include "execution.h"
 #include "factory.h"
 #include "macro-assembler.h"
@@ -193,6 +196,58 @@ TEST(Tagging) {
 }
 
 
+static void CheckIntegerString(Object* value, const char* expected) {
+  CHECK(value->IsBigInteger());
+  Object* string = BigInteger::cast(value)->ToString()->ToObjectChecked();
+  CHECK(String::cast(string)->IsEqualTo(CStrVector(expected)));
+}
+
+
+TEST(BigIntegerArithmetic) {
+  InitializeVM();
+  v8::HandleScope sc;
+  Heap* heap = HEAP;
+  Smi* max = Smi::FromInt(Smi::kMaxValue);
+  Smi* min = Smi::FromInt(Smi::kMinValue);
+  Smi* one = Smi::FromInt(1);
+
+  // Results in smi range stay smis.
+  Object* value = BigInteger::Add(heap, max, Smi::FromInt(-1))
+      ->ToObjectChecked();
+  CHECK_EQ(Smi::FromInt(Smi::kMaxValue - 1), value);
+
+  // Overflow promotes instead of losing precision.
+  Object* above_max = BigInteger::Add(heap, max, one)->ToObjectChecked();
+  CHECK(above_max->IsBigInteger());
+  CHECK_EQ(static_cast<double>(Smi::kMaxValue) + 1,
+           BigInteger::cast(above_max)->ToDouble());
+  value = BigInteger::Subtract(heap, above_max, one)->ToObjectChecked();
+  CHECK_EQ(max, value);
+  value = BigInteger::Subtract(heap, min, one)->ToObjectChecked();
+  CHECK(value->IsBigInteger());
+  CHECK(BigInteger::cast(value)->is_negative());
+  value = BigInteger::Add(heap, value, one)->ToObjectChecked();
+  CHECK_EQ(min, value);
+
+  // 10^18 * 10^18 is exact well beyond double precision.
+  Object* billion = Smi::FromInt(1000000000);
+  Object* big = BigInteger::Multiply(heap, billion, billion)->ToObjectChecked();
+  big = BigInteger::Multiply(heap, big, big)->ToObjectChecked();
+  CheckIntegerString(big, "1000000000000000000000000000000000000");
+  value = BigInteger::Multiply(heap, big, Smi::FromInt(-1))->ToObjectChecked();
+  CheckIntegerString(value, "-1000000000000000000000000000000000000");
+  value = BigInteger::Add(heap, value, big)->ToObjectChecked();
+  CHECK_EQ(Smi::FromInt(0), value);
+  value = BigInteger::Subtract(heap, big, one)->ToObjectChecked();
+  CheckIntegerString(value, "999999999999999999999999999999999999");
+
+  // BigIntegers survive garbage collection.
+  Handle<Object> handle(big);
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  CheckIntegerString(*handle, "1000000000000000000000000000000000000");
+}
+
+
 TEST(GarbageCollection) {
   InitializeVM();
 
@@ -981,6 +1036,45 @@ TEST(TestCodeFlushing) {
 }
 
 
+// Tests that calling a function resets the age of its code, so that code
+// that keeps being used is not flushed.
+TEST(TestCodeFlushingOfUsedFunction) {
+  // If we do not flush code this test is invalid.
+  if (!FLAG_flush_code) return;
+  InitializeVM();
+  v8::HandleScope scope;
+  const char* source = "function bar() {"
+                       "  var x = 42;"
+                       "  return x + 1;"
+                       "};"
+                       "bar()";
+  Handle<String> bar_name = FACTORY->LookupAsciiSymbol("bar");
+
+  { v8::HandleScope scope;
+    CompileRun(source);
+  }
+
+  Object* func_value = Isolate::Current()->context()->global()->
+      GetProperty(*bar_name)->ToObjectChecked();
+  CHECK(func_value->IsJSFunction());
+  Handle<JSFunction> function(JSFunction::cast(func_value));
+  CHECK(function->shared()->is_compiled());
+
+  // Calling bar between the collections keeps its code alive.
+  for (int i = 0; i < 8; i++) {
+    HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+    CompileRun("bar()");
+    CHECK(function->shared()->is_compiled());
+  }
+
+  // Without calls the code is flushed again.
+  for (int i = 0; i < 8; i++) {
+    HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+  }
+  CHECK(!function->shared()->is_compiled() || function->IsOptimized());
+}
+
+
 // Count the number of global contexts in the weak list of global contexts.
 static int CountGlobalContexts() {
   int count = 0;
@@ -1317,3 +1411,782 @@ TEST(IdleNotificationAdvancesIncrementalMarking) {
   intptr_t new_size = HEAP->SizeOfObjects();
   CHECK(no_idle_work || new_size < 3 * old_size / 4);
 }
+
+
+TEST(IdleNotificationWithDeadlineFinishesIncrementalMarking) {
+  if (!FLAG_incremental_marking || !FLAG_incremental_marking_steps) return;
+  InitializeVM();
+  v8::HandleScope scope;
+  CompileRun("var list = null;"
+             "for (var i = 0; i < 50000; i++) {"
+             "  list = { value: i, next: list };"
+             "}"
+             "list = null;");
+  HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+  HEAP->incremental_marking()->Start();
+  CHECK(!HEAP->incremental_marking()->IsStopped());
+
+  int ms_count = HEAP->ms_count();
+  for (int i = 0; i < 1000 && HEAP->ms_count() == ms_count; i++) {
+    CHECK_GE(v8::V8::IdleNotificationWithDeadline(10000), 0);
+  }
+  CHECK_GT(HEAP->ms_count(), ms_count);
+  CHECK(HEAP->incremental_marking()->IsStopped());
+}
+
+
+TEST(ShrinkingLargeArrayTrimsItsPage) {
+  InitializeVM();
+  v8::HandleScope scope;
+  v8::Handle<v8::Object> result = v8::Handle<v8::Object>::Cast(
+      CompileRun("var a = [];"
+                 "for (var i = 0; i < 200000; i++) a.push(i);"
+                 "a"));
+  Handle<JSObject> array = v8::Utils::OpenHandle(*result);
+  // The page is not trimmed while incremental marking is in progress.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(HEAP->incremental_marking()->IsStopped());
+  CHECK(HEAP->lo_space()->Contains(array->elements()));
+  MemoryChunk* page = MemoryChunk::FromAddress(array->elements()->address());
+  size_t old_size = page->size();
+  intptr_t old_lo_size = HEAP->lo_space()->Size();
+
+  CompileRun("a.length = 1000;");
+  CHECK(page->size() < old_size / 4);
+  CHECK(HEAP->lo_space()->Size() < old_lo_size);
+  CompileRun("for (var i = 0; i < 1000; i++) a[i] = i + 1;");
+  CHECK_EQ(1000, CompileRun("a[999]")->Int32Value());
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK_EQ(1000, CompileRun("a[999]")->Int32Value());
+}
+
+
+TEST(PretenuringOfSurvivingLiterals) {
+  if (!FLAG_pretenuring) return;
+  InitializeVM();
+  v8::HandleScope scope;
+  CompileRun("var cache = [];"
+             "function make() { return { key: { value: 1 } }; }");
+  for (int i = 0; i < 100; i++) {
+    CompileRun("cache.push(make());");
+    HEAP->CollectGarbage(NEW_SPACE);
+  }
+  v8::Handle<v8::Object> result =
+      v8::Handle<v8::Object>::Cast(CompileRun("make()"));
+  Handle<JSObject> o = v8::Utils::OpenHandle(*result);
+  CHECK(!HEAP->InNewSpace(*o));
+  CHECK(!HEAP->InNewSpace(o->InObjectPropertyAt(0)));
+
+  // Copies of a literal whose copies die stay in new space.
+  CompileRun("function temp() { return { key: { value: 1 } }; }");
+  for (int i = 0; i < 100; i++) {
+    { v8::HandleScope inner_scope;
+      CompileRun("temp();");
+    }
+    HEAP->CollectGarbage(NEW_SPACE);
+  }
+  result = v8::Handle<v8::Object>::Cast(CompileRun("temp()"));
+  CHECK(HEAP->InNewSpace(*v8::Utils::OpenHandle(*result)));
+}
+
+
+TEST(IncrementalMarkingFinishesWithinGrowthTarget) {
+  if (!FLAG_incremental_marking || !FLAG_incremental_marking_steps) return;
+  InitializeVM();
+  v8::HandleScope scope;
+  CompileRun("var list = null;"
+             "for (var i = 0; i < 50000; i++) {"
+             "  list = { value: i, next: list };"
+             "}");
+  // Leave no lazy sweeping behind so that marking starts right away.
+  HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+
+  IncrementalMarking* marking = HEAP->incremental_marking();
+  marking->SetPauseTarget(0, 10);
+  intptr_t growth_target = HEAP->PromotedTotalSize() / 10;
+  marking->Start();
+  CHECK(marking->IsMarking());
+  intptr_t allocated = 0;
+  while (!marking->IsComplete()) {
+    marking->Step(IncrementalMarking::kAllocatedThreshold);
+    allocated += IncrementalMarking::kAllocatedThreshold;
+    CHECK(allocated <= growth_target + IncrementalMarking::kAllocatedThreshold);
+  }
+  CHECK(marking->biggest_step_bytes() >
+        IncrementalMarking::kAllocatedThreshold);
+  marking->SetPauseTarget(0, 0);
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(marking->IsStopped());
+}
+
+
+TEST(ParallelScavengePreservesObjectGraph) {
+  FLAG_parallel_scavenge = true;
+  InitializeVM();
+  v8::HandleScope scope;
+  CompileRun("var list = null;"
+             "for (var i = 0; i < 20000; i++) {"
+             "  list = { value: i, next: list, name: 'n' + i, a: [i, i + 1] };"
+             "}");
+  // The first scavenge copies the list within new space, the second one
+  // promotes it.
+  for (int i = 0; i < 3; i++) {
+    HEAP->CollectGarbage(NEW_SPACE);
+    v8::Local<v8::Value> result = CompileRun(
+        "var sum = 0;"
+        "for (var l = list; l !== null; l = l.next) {"
+        "  if (l.name != 'n' + l.value || l.a[1] != l.value + 1) throw 'bad';"
+        "  sum += l.value;"
+        "}"
+        "sum");
+    CHECK_EQ(19999.0 * 20000.0 / 2, result->NumberValue());
+  }
+  FLAG_parallel_scavenge = false;
+}
+
+
+TEST(ParallelScavengeOfFullNewSpace) {
+  FLAG_parallel_scavenge = true;
+  InitializeVM();
+  v8::HandleScope scope;
+  NewSpace* new_space = HEAP->new_space();
+  // Keep new space completely full of live objects.  The survivors do not
+  // all fit into the allocation buffers of the workers and some have to be
+  // promoted early.
+  int count = static_cast<int>(
+      new_space->EffectiveCapacity() / FixedArray::SizeFor(100)) - 10;
+  Handle<FixedArray> survivors = FACTORY->NewFixedArray(count, TENURED);
+  {
+    AlwaysAllocateScope always_allocate;
+    for (int i = 0; i < count; i++) {
+      Handle<FixedArray> array = FACTORY->NewFixedArray(100, NOT_TENURED);
+      array->set(0, Smi::FromInt(i));
+      survivors->set(i, *array);
+    }
+  }
+  for (int i = 0; i < 2; i++) {
+    HEAP->CollectGarbage(NEW_SPACE);
+    for (int j = 0; j < count; j++) {
+      FixedArray* array = FixedArray::cast(survivors->get(j));
+      CHECK_EQ(j, Smi::cast(array->get(0))->value());
+    }
+  }
+  FLAG_parallel_scavenge = false;
+}
+
+
+TEST(ConcurrentSweepingPreservesLiveObjects) {
+  FLAG_concurrent_sweeping = true;
+  InitializeVM();
+  v8::HandleScope scope;
+  CompileRun("var list = null;"
+             "var garbage = [];"
+             "for (var i = 0; i < 20000; i++) {"
+             "  list = { value: i, next: list, a: [i, i + 1, i + 2] };"
+             "  garbage.push({ g: i, s: 'g' + i });"
+             "}");
+  // Move everything to old space, then free the garbage so that the next
+  // collection leaves plenty of pages for the sweeper threads.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CompileRun("garbage = null;");
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  // Allocate, promote and trim while the sweepers may still be running.
+  const char* check =
+      "var sum = 0;"
+      "for (var l = list; l !== null; l = l.next) {"
+      "  l.a.shift();"
+      "  if (l.a[0] != l.value + 1) throw 'bad';"
+      "  l.a.unshift(l.value);"
+      "  sum += l.value;"
+      "}"
+      "var more = [];"
+      "for (var j = 0; j < 5000; j++) more.push({ m: j, s: 'm' + j });"
+      "sum";
+  for (int i = 0; i < 3; i++) {
+    v8::Local<v8::Value> result = CompileRun(check);
+    CHECK_EQ(19999.0 * 20000.0 / 2, result->NumberValue());
+    HEAP->CollectGarbage(NEW_SPACE);
+    HEAP->CollectGarbage(NEW_SPACE);
+  }
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(!HEAP->mark_compact_collector()->IsConcurrentSweepingInProgress() ||
+        !HEAP->IsSweepingComplete());
+  v8::Local<v8::Value> result = CompileRun(check);
+  CHECK_EQ(19999.0 * 20000.0 / 2, result->NumberValue());
+  FLAG_concurrent_sweeping = false;
+}
+
+
+TEST(ParallelMarkingPreservesLiveObjects) {
+  FLAG_parallel_marking = true;
+  InitializeVM();
+  v8::HandleScope scope;
+  // A wide and a deep structure, with functions and maps that the marking
+  // threads leave for the main thread.
+  CompileRun("var wide = [];"
+             "var list = null;"
+             "for (var i = 0; i < 20000; i++) {"
+             "  var o = { value: i, s: 'w' + i, a: [i, i + 1] };"
+             "  if (i % 100 == 0) o.f = function() { return this.value; };"
+             "  wide.push(o);"
+             "  list = { value: i, next: list };"
+             "}");
+  const char* check =
+      "var sum = 0;"
+      "for (var i = 0; i < wide.length; i++) {"
+      "  if (wide[i].s != 'w' + i || wide[i].a[1] != i + 1) throw 'bad';"
+      "  sum += wide[i].value;"
+      "}"
+      "for (var l = list; l !== null; l = l.next) sum -= l.value;"
+      "sum + wide[100].f()";
+  for (int i = 0; i < 3; i++) {
+    HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+    v8::Local<v8::Value> result = CompileRun(check);
+    CHECK_EQ(100.0, result->NumberValue());
+  }
+  FLAG_parallel_marking = false;
+}
+
+
+TEST(ParallelEvacuationPreservesLiveObjects) {
+  FLAG_parallel_evacuation = true;
+  FLAG_always_compact = true;
+  InitializeVM();
+  v8::HandleScope scope;
+  // Interleave live and dead objects so that the old space pages become
+  // evacuation candidates, and keep pointers from old to new space.
+  CompileRun("var live = [];"
+             "var dead = [];"
+             "for (var i = 0; i < 20000; i++) {"
+             "  live.push({ value: i, s: 'l' + i, d: i + 0.5 });"
+             "  dead.push({ value: i, s: 'd' + i });"
+             "}");
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CompileRun("dead = null;"
+             "for (var i = 0; i < live.length; i += 10) live[i].n = { i: i };");
+  const char* check =
+      "var sum = 0;"
+      "for (var i = 0; i < live.length; i++) {"
+      "  var o = live[i];"
+      "  if (o.s != 'l' + i || o.d != i + 0.5) throw 'bad';"
+      "  if (i % 10 == 0 && o.n.i != i) throw 'bad';"
+      "  sum += o.value;"
+      "}"
+      "sum";
+  for (int i = 0; i < 3; i++) {
+    HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+    v8::Local<v8::Value> result = CompileRun(check);
+    CHECK_EQ(19999.0 * 20000.0 / 2, result->NumberValue());
+  }
+  FLAG_always_compact = false;
+  FLAG_parallel_evacuation = false;
+}
+
+
+TEST(CardMarkingForOverflowingPages) {
+  InitializeVM();
+  if (!FLAG_card_marking) return;
+  v8::HandleScope scope;
+  // The elements of a large array that is filled with pointers to new space
+  // over and over again keep overflowing the store buffer.
+  Handle<FixedArray> elements = FACTORY->NewFixedArray(300000, TENURED);
+  CHECK(HEAP->lo_space()->Contains(*elements));
+  Handle<JSArray> array = FACTORY->NewJSArrayWithElements(elements);
+  env->Global()->Set(v8_str("a"), v8::Utils::ToLocal(array));
+  CompileRun("function fill(o) {"
+             "  for (var i = 0; i < a.length; i++) a[i] = o;"
+             "}"
+             "function check(o) {"
+             "  for (var i = 0; i < a.length; i++) {"
+             "    if (a[i] !== o) return false;"
+             "  }"
+             "  return true;"
+             "}");
+  MemoryChunk* chunk = MemoryChunk::FromAddress(elements->address());
+  for (int i = 0; i < 10 && !chunk->uses_card_table(); i++) {
+    CompileRun("fill({})");
+    HEAP->CollectGarbage(NEW_SPACE);
+    HEAP->CollectGarbage(NEW_SPACE);
+  }
+  CHECK(chunk->uses_card_table());
+  CHECK(!chunk->scan_on_scavenge());
+
+  // The scavenges clean the cards once the pointers no longer point to new
+  // space, and the write barrier dirties them again.
+  HEAP->CollectGarbage(NEW_SPACE);
+  HEAP->CollectGarbage(NEW_SPACE);
+  int index = chunk->AddressToCardIndex(
+      elements->address() + FixedArray::OffsetOfElementAt(100000));
+  CHECK(chunk->card(index) == MemoryChunk::kCleanCard);
+  CompileRun("var o = {}; fill(o);");
+  CHECK(chunk->card(index) == MemoryChunk::kDirtyCard);
+  HEAP->CollectGarbage(NEW_SPACE);
+  CHECK(CompileRun("check(o)")->BooleanValue());
+  HEAP->CollectGarbage(NEW_SPACE);
+  CHECK(CompileRun("check(o)")->BooleanValue());
+  CHECK(chunk->card(index) == MemoryChunk::kCleanCard);
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(CompileRun("check(o)")->BooleanValue());
+}
+
+
+static Handle<JSObject> CompileRunInNewContext(
+    v8::Persistent<v8::Context>* context, const char* source) {
+  *context = v8::Context::New();
+  v8::Context::Scope scope(*context);
+  return v8::Utils::OpenHandle(*v8::Handle<v8::Object>::Cast(
+      CompileRun(source)));
+}
+
+
+TEST(FieldDescriptorsSharedAcrossContexts) {
+  InitializeVM();
+  if (!FLAG_share_field_descriptors) return;
+  v8::HandleScope scope;
+  const char* source =
+      "function Point(x, y) { this.x = x; this.y = y; }"
+      "new Point(1, 2);";
+  v8::Persistent<v8::Context> ctx1;
+  v8::Persistent<v8::Context> ctx2;
+  Handle<JSObject> p1 = CompileRunInNewContext(&ctx1, source);
+  Handle<JSObject> p2 = CompileRunInNewContext(&ctx2, source);
+
+  // The maps refer to each context's own prototype, but the descriptors only
+  // describe the two fields and are shared.
+  CHECK(p1->map() != p2->map());
+  CHECK(p1->map()->prototype() != p2->map()->prototype());
+  CHECK_EQ(2, p1->map()->instance_descriptors()->number_of_descriptors());
+  CHECK_EQ(p1->map()->instance_descriptors(),
+           p2->map()->instance_descriptors());
+
+  // Both objects keep their own, correct view of the fields.
+  {
+    v8::Context::Scope scope(ctx2);
+    v8::Handle<v8::Object> p = v8::Utils::ToLocal(p2);
+    CHECK_EQ(1, p->Get(v8_str("x"))->Int32Value());
+    CHECK_EQ(2, p->Get(v8_str("y"))->Int32Value());
+  }
+
+  ctx1.Dispose();
+  ctx2.Dispose();
+}
+
+
+static Handle<FixedArray> LookupRegExpData(const char* source) {
+  Handle<String> pattern = FACTORY->NewStringFromAscii(CStrVector(source));
+  return ISOLATE->compilation_cache()->LookupRegExp(
+      pattern, JSRegExp::Flags(JSRegExp::NONE));
+}
+
+
+TEST(RegExpCacheRetainedAcrossGCs) {
+  InitializeVM();
+  if (!FLAG_compilation_cache) return;
+  v8::HandleScope scope;
+  ISOLATE->compilation_cache()->Clear();
+
+  CompileRun("new RegExp('[a-z]+\\\\d{2,}').test('abc12');");
+  Handle<FixedArray> data = LookupRegExpData("[a-z]+\\d{2,}");
+  CHECK(!data.is_null());
+
+  // Enough mark-compacts to age the regexp out of the generational tables.
+  for (int i = 0; i < 4; i++) HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  Handle<FixedArray> retained = LookupRegExpData("[a-z]+\\d{2,}");
+  CHECK(!retained.is_null());
+  CHECK_EQ(*data, *retained);
+
+  // Without room to spare only the most recently used regexp is retained.
+  int saved_size = FLAG_regexp_cache_retained_size;
+  FLAG_regexp_cache_retained_size = 0;
+  CompileRun("new RegExp('x(y|z)+').test('xyz');"
+             "new RegExp('w(y|z)+').test('wyz');");
+  for (int i = 0; i < 4; i++) HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(LookupRegExpData("x(y|z)+").is_null());
+  CHECK(!LookupRegExpData("w(y|z)+").is_null());
+  FLAG_regexp_cache_retained_size = saved_size;
+}
+
+
+TEST(CompilationCacheAgedOncePerIncrementalGC) {
+  if (!FLAG_incremental_marking) return;
+  InitializeVM();
+  if (!FLAG_compilation_cache) return;
+  v8::HandleScope scope;
+  // Finish sweeping so that incremental marking starts right away.
+  HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+  ISOLATE->compilation_cache()->Clear();
+
+  const char* source = "function aged_once() { return 42; }";
+  CompileRun(source);
+
+  // Starting incremental marking and finishing the collection must age the
+  // cache only once, otherwise three collections evict all generations.
+  for (int i = 0; i < 3; i++) {
+    HEAP->incremental_marking()->Start();
+    CHECK(HEAP->incremental_marking()->IsMarking());
+    HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+    CHECK(HEAP->incremental_marking()->IsStopped());
+  }
+
+  Handle<String> source_string =
+      FACTORY->NewStringFromAscii(CStrVector(source));
+  Handle<SharedFunctionInfo> info =
+      ISOLATE->compilation_cache()->LookupScript(
+          source_string, Handle<Object>(), 0, 0);
+  CHECK(!info.is_null());
+}
+
+
+TEST(NumberStringCacheGrows) {
+  InitializeVM();
+  v8::HandleScope scope;
+  int initial_length = HEAP->number_string_cache()->length();
+
+  // Smis hash to themselves, so converting more smis than the cache has
+  // entries collides.
+  int count = initial_length;
+  for (int i = 0; i < count; i++) {
+    HEAP->NumberToString(Smi::FromInt(i))->ToObjectChecked();
+  }
+  CHECK_GT(HEAP->number_string_cache()->length(), initial_length);
+
+  for (int i = 0; i < count; i++) {
+    String* string = String::cast(
+        HEAP->NumberToString(Smi::FromInt(i))->ToObjectChecked());
+    CHECK_EQ(string, HEAP->NumberToString(Smi::FromInt(i))->ToObjectChecked());
+    EmbeddedVector<char, 16> expected;
+    OS::SNPrintF(expected, "%d", i);
+    CHECK(string->IsEqualTo(CStrVector(expected.start())));
+  }
+}
+
+
+static int gc_events_count = 0;
+static v8::GCEvent last_gc_event;
+
+static void RecordGCEvent(const v8::GCEvent& event) {
+  gc_events_count++;
+  last_gc_event = event;
+}
+
+
+TEST(GCEventCallback) {
+  InitializeVM();
+  v8::HandleScope scope;
+  v8::V8::SetGCEventCallback(RecordGCEvent);
+
+  // Allocate some garbage so that collections free something.
+  { v8::HandleScope inner_scope;
+    for (int i = 0; i < 1000; i++) FACTORY->NewFixedArray(100);
+  }
+
+  gc_events_count = 0;
+  HEAP->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(1, gc_events_count);
+  CHECK_EQ(v8::kGCTypeScavenge, last_gc_event.type());
+  CHECK_EQ(0.0, last_gc_event.phase_time(v8::GCEvent::kMark));
+  CHECK_GE(last_gc_event.pause_time(),
+           last_gc_event.phase_time(v8::GCEvent::kScavengeRoots));
+
+  { v8::HandleScope inner_scope;
+    for (int i = 0; i < 1000; i++) FACTORY->NewFixedArray(100, TENURED);
+  }
+
+  // The tenured allocations may have started incremental marking, which
+  // would turn the request into a scavenge.
+  HEAP->incremental_marking()->Abort();
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK_EQ(2, gc_events_count);
+  CHECK_EQ(v8::kGCTypeMarkSweepCompact, last_gc_event.type());
+  CHECK_EQ(0.0, last_gc_event.phase_time(v8::GCEvent::kScavengeRoots));
+  double phases = 0;
+  for (int i = 0; i < v8::GCEvent::kNumberOfPhases; i++) {
+    phases += last_gc_event.phase_time(static_cast<v8::GCEvent::Phase>(i));
+  }
+  CHECK_GE(last_gc_event.pause_time(), phases);
+  CHECK_GT(last_gc_event.size_before(), last_gc_event.size_after());
+  CHECK_GT(last_gc_event.freed_bytes(), 0);
+
+  v8::V8::SetGCEventCallback(NULL);
+  HEAP->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(2, gc_events_count);
+}
+
+
+TEST(StartupHeapSize) {
+  InitializeVM();
+  v8::HeapStatistics stats;
+  v8::V8::GetHeapStatistics(&stats);
+  CHECK(stats.startup_heap_size() > 0);
+  CHECK(stats.startup_committed_heap_size() >= stats.startup_heap_size());
+  CHECK_EQ(HEAP->startup_size(),
+           static_cast<intptr_t>(stats.startup_heap_size()));
+}
+
+
+TEST(DefineMethodKeepsConstantFunctions) {
+  InitializeVM();
+  v8::HandleScope scope;
+  CompileRun("function C() {}"
+             "C.prototype.m = function() { return 1; };"
+             "var f = function() { return 2; };"
+             "var g = function() { return 3; };");
+  // Promote the closures so they can be constant functions.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  Handle<JSObject> prototype = v8::Utils::OpenHandle(
+      *v8::Handle<v8::Object>::Cast(CompileRun("C.prototype")));
+  Handle<JSFunction> f = v8::Utils::OpenHandle(
+      *v8::Handle<v8::Function>::Cast(CompileRun("f")));
+  Handle<JSFunction> g = v8::Utils::OpenHandle(
+      *v8::Handle<v8::Function>::Cast(CompileRun("g")));
+  CHECK(!HEAP->InNewSpace(*f));
+  CHECK(!HEAP->InNewSpace(*g));
+  Handle<String> name = FACTORY->LookupAsciiSymbol("m");
+  LookupResult lookup(Isolate::Current());
+  prototype->LocalLookupRealNamedProperty(*name, &lookup);
+  CHECK_EQ(CONSTANT_FUNCTION, lookup.type());
+
+  // Redefinition moves the prototype to a new map and keeps the method a
+  // constant function.
+  Map* old_map = prototype->map();
+  prototype->DefineMethod(*name, *f)->ToObjectChecked();
+  CHECK(prototype->map() != old_map);
+  prototype->LocalLookupRealNamedProperty(*name, &lookup);
+  CHECK_EQ(CONSTANT_FUNCTION, lookup.type());
+  CHECK_EQ(*f, lookup.GetConstantFunction());
+  CHECK_EQ(2, CompileRun("new C().m()")->Int32Value());
+
+  // Defining the same function again is a no-op.
+  old_map = prototype->map();
+  prototype->DefineMethod(*name, *f)->ToObjectChecked();
+  CHECK_EQ(old_map, prototype->map());
+
+  // An object that keeps being redefined ends up with a field.
+  for (int i = 0; i <= Map::kMaxMethodRedefinitions; i++) {
+    prototype->DefineMethod(*name, i % 2 == 0 ? *g : *f)->ToObjectChecked();
+  }
+  prototype->LocalLookupRealNamedProperty(*name, &lookup);
+  CHECK_EQ(FIELD, lookup.type());
+  CHECK_EQ(2, CompileRun("new C().m()")->Int32Value());
+}
+
+
+TEST(AtomsAreInterned) {
+  InitializeVM();
+  v8::HandleScope scope;
+
+  Handle<String> foo = FACTORY->NewStringFromAscii(CStrVector("foo"));
+  Handle<Atom> a = FACTORY->LookupAtom(foo);
+  Handle<Atom> b = FACTORY->LookupAtom(FACTORY->LookupAsciiSymbol("foo"));
+  Handle<Atom> c = FACTORY->LookupAtom(FACTORY->LookupAsciiSymbol("bar"));
+  CHECK_EQ(*a, *b);
+  CHECK_NE(*a, *c);
+  CHECK(a->name()->IsSymbol());
+  CHECK(a->name()->Equals(*foo));
+  CHECK_EQ(static_cast<int>(foo->Hash()), a->hash()->value());
+
+  // Atoms are immortal and never move into new space.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(!HEAP->InNewSpace(*a));
+  CHECK_EQ(*a, *FACTORY->LookupAtom(foo));
+
+  v8::Handle<v8::Object> global = env->Global();
+  global->Set(v8_str("a"), v8::Utils::ToLocal(Handle<Object>::cast(a)));
+  global->Set(v8_str("b"), v8::Utils::ToLocal(Handle<Object>::cast(b)));
+  global->Set(v8_str("c"), v8::Utils::ToLocal(Handle<Object>::cast(c)));
+  CHECK(CompileRun("a === b")->IsTrue());
+  CHECK(CompileRun("a == b")->IsTrue());
+  CHECK(CompileRun("a !== c")->IsTrue());
+  CHECK(CompileRun("a != 'foo'")->IsTrue());
+  CHECK(CompileRun("a != 0")->IsTrue());
+  CHECK(CompileRun("a ? true : false")->IsTrue());
+  v8::String::AsciiValue type(CompileRun("typeof a"));
+  CHECK_EQ("symbol", *type);
+  v8::String::AsciiValue string(CompileRun("'' + a"));
+  CHECK_EQ("foo", *string);
+}
+
+
+TEST(InobjectSlackTrackingKeepsLateProperties) {
+  InitializeVM();
+  v8::HandleScope scope;
+  // The third property is only added from the 13th construction on, after
+  // the first round of slack tracking.
+  CompileRun("function P(n) {"
+             "  this.a = 1; this.b = 2; if (n >= 12) this.c = 3;"
+             "}"
+             "for (var i = 0; i < 40; i++) var p = new P(i);");
+  Handle<JSObject> p = v8::Utils::OpenHandle(
+      *v8::Handle<v8::Object>::Cast(CompileRun("p")));
+  Handle<JSFunction> f = v8::Utils::OpenHandle(
+      *v8::Handle<v8::Function>::Cast(CompileRun("P")));
+  CHECK(!f->shared()->IsInobjectSlackTrackingInProgress());
+  CHECK_EQ(3, p->map()->inobject_properties());
+  CHECK_EQ(0, p->properties()->length());
+  CHECK_EQ(3, f->initial_map()->inobject_properties());
+}
+
+
+TEST(InitialMapGrowsWhenPropertiesSpill) {
+  InitializeVM();
+  v8::HandleScope scope;
+  CompileRun("function Q() { this.a = 1; }"
+             "for (var i = 0; i < 40; i++) new Q();");
+  Handle<JSFunction> f = v8::Utils::OpenHandle(
+      *v8::Handle<v8::Function>::Cast(CompileRun("Q")));
+  CHECK(!f->shared()->IsInobjectSlackTrackingInProgress());
+  CHECK_EQ(1, f->initial_map()->inobject_properties());
+
+  // The first property that does not fit drops the initial map.
+  CompileRun("var q = new Q(); q.b = 2;");
+  CHECK(!f->has_initial_map());
+
+  // Later instances get room for more properties.
+  Handle<JSObject> r = v8::Utils::OpenHandle(*v8::Handle<v8::Object>::Cast(
+      CompileRun("var r = new Q(); r.b = 2; r.c = 3; r.d = 4; r")));
+  CHECK_EQ(1 + JSObject::kFieldsAdded, r->map()->inobject_properties());
+  CHECK_EQ(0, r->properties()->length());
+  CHECK_EQ(4, CompileRun("r.d")->Int32Value());
+  CHECK_EQ(2, CompileRun("q.b")->Int32Value());
+}
+
+
+TEST(ReduceMemoryFootprintReleasesSparsePages) {
+  InitializeVM();
+  v8::HandleScope scope;
+  // Keep one object in twenty, so the old space pages end up sparse.
+  CompileRun("var live = [];"
+             "var dead = [];"
+             "for (var i = 0; i < 100000; i++) {"
+             "  var o = { value: i, s: 'o' + i };"
+             "  if (i % 20 == 0) live.push(o); else dead.push(o);"
+             "}");
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CompileRun("dead = null;");
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  HEAP->EnsureHeapIsIterable();
+  int pages_before = HEAP->old_pointer_space()->CountTotalPages();
+  HEAP->ReduceMemoryFootprint();
+  CHECK_LT(HEAP->old_pointer_space()->CountTotalPages(), pages_before);
+  v8::Local<v8::Value> result = CompileRun(
+      "var sum = 0;"
+      "for (var i = 0; i < live.length; i++) {"
+      "  if (live[i].s != 'o' + live[i].value) throw 'bad';"
+      "  sum += live[i].value;"
+      "}"
+      "sum");
+  CHECK_EQ(20.0 * 4999.0 * 5000.0 / 2, result->NumberValue());
+}
+
+
+// Copies a range of new space numbers into an old space array in one go and
+// checks that the scavenger still finds every copied slot.
+static void CheckBulkCopySurvivesScavenge(int length) {
+  v8::HandleScope scope;
+  Handle<FixedArray> source = FACTORY->NewFixedArray(length);
+  for (int i = 0; i < length; i++) {
+    Handle<Object> number = FACTORY->NewNumber(i + 0.5);
+    CHECK(HEAP->InNewSpace(*number));
+    source->set(i, *number);
+  }
+  Handle<FixedArray> target = FACTORY->NewFixedArray(length + 1, TENURED);
+  CHECK(!HEAP->InNewSpace(*target));
+  source->CopyTo(0, *target, 1, length);
+  HEAP->CollectGarbage(NEW_SPACE);
+  HEAP->CollectGarbage(NEW_SPACE);
+  for (int i = 0; i < length; i++) {
+    CHECK_EQ(i + 0.5, target->get(i + 1)->Number());
+  }
+}
+
+
+TEST(BulkCopyRecordsWrites) {
+  InitializeVM();
+  CheckBulkCopySurvivesScavenge(10);
+  // More slots than a single range may enter into the store buffer.
+  CheckBulkCopySurvivesScavenge(StoreBuffer::kStoreBufferLength);
+}
+
+
+class ObjectStatsCollector : public v8::ObjectStatsVisitor {
+ public:
+  ObjectStatsCollector()
+      : type_count_(0), type_size_(0), space_count_(0), space_size_(0),
+        array_count_(0), builtin_count_(0) { }
+
+  virtual void VisitObjectStats(Category category,
+                                const char* name,
+                                int count,
+                                size_t size) {
+    CHECK_GT(count, 0);
+    CHECK(size > 0);
+    switch (category) {
+      case kInstanceType:
+        type_count_ += count;
+        type_size_ += size;
+        if (strcmp(name, "JS_ARRAY_TYPE") == 0) array_count_ = count;
+        break;
+      case kSpace:
+        space_count_ += count;
+        space_size_ += size;
+        break;
+      case kCodeKind:
+        if (strcmp(name, "BUILTIN") == 0) builtin_count_ = count;
+        break;
+    }
+  }
+
+  int type_count_;
+  size_t type_size_;
+  int space_count_;
+  size_t space_size_;
+  int array_count_;
+  int builtin_count_;
+};
+
+
+TEST(ObjectStats) {
+  FLAG_track_object_stats = true;
+  InitializeVM();
+  v8::HandleScope scope;
+
+  static const int kArrays = 100;
+  Handle<FixedArray> holder = FACTORY->NewFixedArray(kArrays);
+  for (int i = 0; i < kArrays; i++) {
+    holder->set(i, *FACTORY->NewJSArray(0));
+  }
+
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  ObjectStatsCollector collector;
+  CHECK(v8::V8::VisitObjectStats(&collector));
+  CHECK_GE(collector.array_count_, kArrays);
+  CHECK_GT(collector.builtin_count_, 0);
+  CHECK_EQ(collector.type_count_, collector.space_count_);
+  CHECK(collector.type_size_ == collector.space_size_);
+  CHECK(collector.space_size_ <= static_cast<size_t>(HEAP->SizeOfObjects()));
+  FLAG_track_object_stats = false;
+}
+
+
+TEST(CodeStubLookupCache) {
+  InitializeVM();
+  v8::HandleScope scope;
+
+  BinaryOpStub stub(Token::ADD, NO_OVERWRITE);
+  Handle<Code> code = stub.GetCode();
+  Code* found = NULL;
+  CHECK(stub.FindCodeInCache(&found));
+  CHECK_EQ(*code, found);
+  CHECK(stub.FindCodeInCache(&found));
+  CHECK_EQ(*code, found);
+
+  // Code may move in a full GC, which empties the cache.  Lookups then fall
+  // back to the code stubs dictionary.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(stub.FindCodeInCache(&found));
+  CHECK_EQ(*code, found);
+  CHECK_EQ(*code, *stub.GetCode());
+}
@@ -720,3 +720,89 @@ TEST(ExtensionsRegistration) {
   }
   StartJoinAndDeleteThreads(threads);
 }
+
+
+class HandoffThread : public JoinableThread {
+ public:
+  HandoffThread(v8::Isolate* isolate, v8::Handle<v8::Context> context)
+    : JoinableThread("HandoffThread"),
+      isolate_(isolate),
+      context_(context) {
+  }
+
+  virtual void Run() {
+    v8::Locker locker(isolate_);
+    v8::Isolate::Scope isolate_scope(isolate_);
+    v8::HandleScope handle_scope;
+    v8::Context::Scope context_scope(context_);
+    CalcFibAndCheck();
+  }
+
+ private:
+  v8::Isolate* isolate_;
+  v8::Persistent<v8::Context> context_;
+};
+
+// Handing the isolate to another thread from inside an Unlocker archives
+// the state of the unlocked thread exactly once and restores it once.
+TEST(LockerHandoffCounters) {
+  i::FLAG_counters_block = true;
+  v8::Isolate* isolate = v8::Isolate::New();
+  {
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope;
+    Persistent<v8::Context> context = v8::Context::New();
+    {
+      v8::Context::Scope context_scope(context);
+      {
+        v8::Unlocker unlocker(isolate);
+        HandoffThread thread(isolate, context);
+        thread.Start();
+        thread.Join();
+      }
+      CalcFibAndCheck();
+    }
+    i::CounterBlock* block =
+        reinterpret_cast<i::Isolate*>(isolate)->stats_table()->counter_block();
+    CHECK_NE(NULL, block);
+    // The first Locker initializes the isolate, so only the handoff thread
+    // and the Unlocker destructor are counted.
+    CHECK_EQ(2, *block->Lookup("c:V8.LockerAcquisitions"));
+    CHECK_EQ(1, *block->Lookup("c:V8.ThreadStateArchives"));
+    CHECK_EQ(1, *block->Lookup("c:V8.ThreadStateRestores"));
+    CHECK_EQ(0, *block->Lookup("c:V8.ThreadStateLazyRestores"));
+    context.Dispose();
+  }
+  isolate->Dispose();
+}
+
+
+// The pool thread fills the pool while the main thread is unlocked.
+TEST(ContextPoolBackgroundRefill) {
+  v8::Isolate* isolate = v8::Isolate::New();
+  {
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope;
+    v8::ContextPool::Options options;
+    options.size = 3;
+    options.background_refill = true;
+    v8::ContextPool pool(isolate, options);
+    {
+      v8::Unlocker unlocker(isolate);
+      while (pool.AvailableCount() < 3) i::OS::Sleep(1);
+    }
+    v8::Persistent<v8::Context> context = pool.Acquire();
+    {
+      v8::Context::Scope context_scope(context);
+      CalcFibAndCheck();
+    }
+    pool.Release(context);
+    {
+      v8::Unlocker unlocker(isolate);
+      while (pool.AvailableCount() < 3) i::OS::Sleep(1);
+    }
+  }
+  isolate->Dispose();
+}
@@ -469,6 +469,31 @@ TEST(IsLoggingPreserved) {
 }
 
 
+TEST(PerfBasicProf) {
+  // Must be set before V8 initializes the logger.
+  i::FLAG_perf_basic_prof = true;
+  v8::HandleScope scope;
+  LocalContext env;
+  CHECK(LOGGER->is_logging());
+
+  CompileRun("function perfBasicProfFunction() { return 42; }\n"
+             "perfBasicProfFunction();");
+
+  EmbeddedVector<char, 64> file_name;
+  i::OS::SNPrintF(file_name, "/tmp/perf-%d.map",
+                  i::OS::GetCurrentProcessId());
+  bool exists = false;
+  i::Vector<const char> map = i::ReadFile(file_name.start(), &exists, true);
+  CHECK(exists);
+  CHECK_NE(NULL, StrNStr(map.start(), "perfBasicProfFunction", map.length()));
+  map.Dispose();
+
+  LOGGER->TearDown();
+  remove(file_name.start());
+  i::FLAG_perf_basic_prof = false;
+}
+
+
 typedef i::NativesCollection<i::TEST> TestSources;
 
 
@@ -0,0 +1,94 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <stdlib.h>
+
+#include "v8.h"
+
+#include "cctest.h"
+#include "lz-codec.h"
+
+using namespace v8::internal;
+
+
+static Vector<const byte> ToConst(Vector<byte> v) {
+  return Vector<const byte>(v.start(), v.length());
+}
+
+
+static void CheckRoundTrip(Vector<const byte> input) {
+  ScopedVector<byte> compressed(LZCodec::MaxCompressedSize(input.length()));
+  int compressed_length = LZCodec::Compress(input, compressed.start());
+  CHECK_LE(compressed_length, compressed.length());
+  ScopedVector<byte> output(input.length());
+  CHECK(LZCodec::Decompress(
+      ToConst(compressed.SubVector(0, compressed_length)), output));
+  CHECK_EQ(0, memcmp(input.start(), output.start(), input.length()));
+}
+
+
+TEST(LZCodecRoundTrip) {
+  CheckRoundTrip(Vector<const byte>(NULL, 0));
+  const char* text = "abcabcabcabcabcabcabc the quick brown fox abcabcabc";
+  CheckRoundTrip(Vector<const byte>(reinterpret_cast<const byte*>(text),
+                                    StrLength(text)));
+
+  const int kLength = 200000;
+  ScopedVector<byte> data(kLength);
+  // Long runs need extended literal and match lengths.
+  for (int i = 0; i < kLength; i++) data[i] = (i < kLength / 2) ? 'x' : 0;
+  CheckRoundTrip(ToConst(data));
+  // Random data is mostly literals; matches reach back up to 64KB.
+  srand(42);
+  for (int i = 0; i < kLength; i++) {
+    data[i] = (i % 1000 < 500) ? static_cast<byte>(rand())
+                               : data[i - 70000 > 0 ? i - 70000 : i / 2];
+  }
+  CheckRoundTrip(ToConst(data));
+}
+
+
+TEST(LZCodecMalformedInput) {
+  const char* text = "abcdabcdabcdabcdabcdabcd";
+  Vector<const byte> input(reinterpret_cast<const byte*>(text),
+                           StrLength(text));
+  ScopedVector<byte> compressed(LZCodec::MaxCompressedSize(input.length()));
+  int compressed_length = LZCodec::Compress(input, compressed.start());
+  ScopedVector<byte> output(input.length());
+  // Truncated input.
+  CHECK(!LZCodec::Decompress(
+      ToConst(compressed.SubVector(0, compressed_length / 2)), output));
+  // Output of the wrong size.
+  CHECK(!LZCodec::Decompress(
+      ToConst(compressed.SubVector(0, compressed_length)),
+      output.SubVector(0, input.length() - 1)));
+  // An offset that points before the start of the output.
+  compressed[5] = 0xFF;
+  compressed[6] = 0xFF;
+  CHECK(!LZCodec::Decompress(
+      ToConst(compressed.SubVector(0, compressed_length)), output));
+}
@@ -32,12 +32,15 @@
 #include "v8.h"
 
 #include "cctest.h"
+#include "compilation-cache.h"
 #include "compiler.h"
 #include "execution.h"
 #include "isolate.h"
+#include "natives.h"
 #include "parser.h"
 #include "preparser.h"
 #include "scanner-character-streams.h"
+#include "string-stream.h"
 #include "token.h"
 #include "utils.h"
 
@@ -235,6 +238,185 @@ TEST(Preparsing) {
 }
 
 
+class BackgroundPreparseThread : public i::Thread {
+ public:
+  BackgroundPreparseThread(const char* source, int length)
+      : Thread("BackgroundPreparseThread"),
+        source_(source),
+        length_(length),
+        result_(NULL) { }
+
+  virtual void Run() {
+    result_ = v8::ScriptData::PreCompileInBackground(source_, length_,
+                                                     128 * 1024);
+  }
+
+  v8::ScriptData* result() { return result_; }
+
+ private:
+  const char* source_;
+  int length_;
+  v8::ScriptData* result_;
+};
+
+
+TEST(BackgroundPreparsing) {
+  v8::HandleScope handles;
+  v8::Persistent<v8::Context> context = v8::Context::New();
+  v8::Context::Scope context_scope(context);
+
+  const char* sources[] = {
+    "function f(a) { return function lazy(b) { return a + b; } } f(1)(2);",
+    "var o = { get x() { return 42; } }; function g() { return o.x; } g();",
+    "var x = y z;"
+  };
+  const int kThreads = ARRAY_SIZE(sources);
+
+  BackgroundPreparseThread* threads[kThreads];
+  for (int i = 0; i < kThreads; i++) {
+    threads[i] =
+        new BackgroundPreparseThread(sources[i], i::StrLength(sources[i]));
+    threads[i]->Start();
+  }
+
+  for (int i = 0; i < kThreads; i++) {
+    threads[i]->Join();
+    v8::ScriptData* background = threads[i]->result();
+    CHECK(background != NULL);
+
+    // The result must match preparsing on the isolate's own thread.
+    int length = i::StrLength(sources[i]);
+    v8::ScriptData* foreground = v8::ScriptData::PreCompile(sources[i], length);
+    CHECK_EQ(foreground->HasError(), background->HasError());
+    CHECK_EQ(foreground->Length(), background->Length());
+    CHECK_EQ(0, memcmp(foreground->Data(), background->Data(),
+                       foreground->Length()));
+
+    if (!background->HasError()) {
+      ScriptResource* resource = new ScriptResource(sources[i], length);
+      v8::Local<v8::String> script_source = v8::String::NewExternal(resource);
+      v8::Local<v8::Script> script =
+          v8::Script::Compile(script_source, NULL, background);
+      CHECK(!script.IsEmpty());
+      CHECK(!script->Run().IsEmpty());
+    }
+
+    delete foreground;
+    delete background;
+    delete threads[i];
+  }
+  context.Dispose();
+}
+
+
+TEST(PreparseDataCache) {
+  v8::HandleScope handles;
+  v8::Persistent<v8::Context> context = v8::Context::New();
+  v8::Context::Scope context_scope(context);
+
+  // A script long enough to be parsed lazily, with lazily compiled functions.
+  static const int kFunctions = 100;
+  i::HeapStringAllocator allocator;
+  i::StringStream stream(&allocator);
+  for (int i = 0; i < kFunctions; i++) {
+    stream.Add("function f%d(x) { var y = [x, %d]; return y[1]; }\n", i, i);
+  }
+  stream.Add("f7(0) + f%d(0);", kFunctions - 1);
+  i::SmartArrayPointer<const char> source = stream.ToCString();
+  CHECK_GT(i::StrLength(*source), i::FLAG_min_preparse_length);
+
+  i::CompilationCache* cache = i::Isolate::Current()->compilation_cache();
+  cache->Clear();
+  v8::Local<v8::String> source_string = v8_str(*source);
+  i::Handle<i::String> internal_source = v8::Utils::OpenHandle(*source_string);
+  int flags = i::kAllowLazy;
+  CHECK(cache->LookupPreparseData(internal_source, flags).is_null());
+
+  // The first parse records the entries of the lazily compiled functions.
+  v8::ScriptOrigin first_origin(v8_str("first"));
+  v8::Local<v8::Value> first =
+      v8::Script::Compile(source_string, &first_origin)->Run();
+  CHECK_EQ(7 + kFunctions - 1, first->Int32Value());
+  i::Handle<i::ByteArray> data =
+      cache->LookupPreparseData(internal_source, flags);
+  CHECK(!data.is_null());
+  CHECK(cache->LookupPreparseData(internal_source,
+                                  flags | i::kAllowNativesSyntax).is_null());
+
+  // Another origin misses the script cache, so the source is parsed again
+  // using the recorded entries.
+  v8::ScriptOrigin second_origin(v8_str("second"));
+  v8::Local<v8::Value> second =
+      v8::Script::Compile(source_string, &second_origin)->Run();
+  CHECK_EQ(7 + kFunctions - 1, second->Int32Value());
+  CHECK_EQ(*data, *cache->LookupPreparseData(internal_source, flags));
+  context.Dispose();
+}
+
+
+static bool IsCompiled(const char* name) {
+  v8::Local<v8::Value> value = v8::Context::GetCurrent()->Global()->Get(
+      v8_str(name));
+  i::Handle<i::JSFunction> function =
+      i::Handle<i::JSFunction>::cast(v8::Utils::OpenHandle(*value));
+  return function->shared()->is_compiled();
+}
+
+
+TEST(PreparseDataCacheShortScript) {
+  v8::HandleScope handles;
+  v8::Persistent<v8::Context> context = v8::Context::New();
+  v8::Context::Scope context_scope(context);
+
+  // Too short to be parsed lazily the first time.
+  const char* source =
+      "function f(x) { return [x, 1][1]; }\n"
+      "function g(x) { return {a: x}.a; }\n"
+      "(function h() { return 2; })() + f(0);";
+  CHECK_LT(i::StrLength(source), i::FLAG_min_preparse_length);
+  i::CompilationCache* cache = i::Isolate::Current()->compilation_cache();
+  cache->Clear();
+  v8::Local<v8::String> source_string = v8_str(source);
+  i::Handle<i::String> internal_source = v8::Utils::OpenHandle(*source_string);
+
+  // The full parse records the top-level functions.
+  v8::ScriptOrigin first_origin(v8_str("first"));
+  CHECK_EQ(3, v8::Script::Compile(source_string, &first_origin)->
+      Run()->Int32Value());
+  CHECK(IsCompiled("g"));
+  CHECK(!cache->LookupPreparseData(internal_source, i::kAllowLazy).is_null());
+
+  // The next parse uses them to compile the functions lazily.
+  v8::ScriptOrigin second_origin(v8_str("second"));
+  CHECK_EQ(3, v8::Script::Compile(source_string, &second_origin)->
+      Run()->Int32Value());
+  CHECK(IsCompiled("f"));
+  CHECK(!IsCompiled("g"));
+  CHECK_EQ(2, CompileRun("g(2)")->Int32Value());
+  context.Dispose();
+}
+
+
+TEST(PreparseNatives) {
+  // The bootstrapper compiles the natives with function entries recorded by
+  // preparsing them, so every native script must preparse without errors.
+  v8::HandleScope handles;
+  v8::Persistent<v8::Context> context = v8::Context::New();
+  v8::Context::Scope context_scope(context);
+  for (int i = 0; i < i::Natives::GetBuiltinsCount(); i++) {
+    i::Handle<i::String> source = FACTORY->NewStringFromAscii(
+        i::Natives::GetRawScriptSource(i));
+    i::ScriptDataImpl* data =
+        i::ParserApi::PartialPreParse(source, NULL, i::kAllowNativesSyntax);
+    CHECK(data != NULL);
+    CHECK(!data->HasError());
+    CHECK_GT(data->Length(), 0);
+    delete data;
+  }
+  context.Dispose();
+}
+
+
 TEST(StandAlonePreParser) {
   v8::V8::Initialize();
 
@@ -428,6 +610,27 @@ class TestExternalResource: public v8::String::ExternalStringResource {
 };
 
 
+class TestExternalAsciiResource
+    : public v8::String::ExternalAsciiStringResource {
+ public:
+  TestExternalAsciiResource(const char* data, int length)
+      : data_(data), length_(static_cast<size_t>(length)) { }
+
+  ~TestExternalAsciiResource() { }
+
+  const char* data() const {
+    return data_;
+  }
+
+  size_t length() const {
+    return length_;
+  }
+ private:
+  const char* data_;
+  size_t length_;
+};
+
+
 #define CHECK_EQU(v1, v2) CHECK_EQ(static_cast<int>(v1), static_cast<int>(v2))
 
 void TestCharacterStream(const char* ascii_source,
@@ -447,9 +650,15 @@ void TestCharacterStream(const char* ascii_source,
   TestExternalResource resource(*uc16_buffer, length);
   i::Handle<i::String> uc16_string(
       FACTORY->NewExternalStringFromTwoByte(&resource));
+  TestExternalAsciiResource ascii_resource(ascii_source, length);
+  i::Handle<i::String> ascii_external_string(
+      FACTORY->NewExternalStringFromAscii(&ascii_resource));
 
   i::ExternalTwoByteStringUC16CharacterStream uc16_stream(
       i::Handle<i::ExternalTwoByteString>::cast(uc16_string), start, end);
+  i::ExternalAsciiStringUC16CharacterStream ascii_stream(
+      i::Handle<i::ExternalAsciiString>::cast(ascii_external_string),
+      start, end);
   i::GenericStringUC16CharacterStream string_stream(ascii_string, start, end);
   i::Utf8ToUC16CharacterStream utf8_stream(
       reinterpret_cast<const i::byte*>(ascii_source), end);
@@ -459,17 +668,21 @@ void TestCharacterStream(const char* ascii_source,
   while (i < end) {
     // Read streams one char at a time
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
     int32_t c0 = ascii_source[i];
     int32_t c1 = uc16_stream.Advance();
+    int32_t c4 = ascii_stream.Advance();
     int32_t c2 = string_stream.Advance();
     int32_t c3 = utf8_stream.Advance();
     i++;
     CHECK_EQ(c0, c1);
+    CHECK_EQ(c0, c4);
     CHECK_EQ(c0, c2);
     CHECK_EQ(c0, c3);
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
   }
@@ -477,64 +690,80 @@ void TestCharacterStream(const char* ascii_source,
     // Pushback, re-read, pushback again.
     int32_t c0 = ascii_source[i - 1];
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
     uc16_stream.PushBack(c0);
+    ascii_stream.PushBack(c0);
     string_stream.PushBack(c0);
     utf8_stream.PushBack(c0);
     i--;
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
     int32_t c1 = uc16_stream.Advance();
+    int32_t c4 = ascii_stream.Advance();
     int32_t c2 = string_stream.Advance();
     int32_t c3 = utf8_stream.Advance();
     i++;
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
     CHECK_EQ(c0, c1);
+    CHECK_EQ(c0, c4);
     CHECK_EQ(c0, c2);
     CHECK_EQ(c0, c3);
     uc16_stream.PushBack(c0);
+    ascii_stream.PushBack(c0);
     string_stream.PushBack(c0);
     utf8_stream.PushBack(c0);
     i--;
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
   }
   unsigned halfway = start + sub_length / 2;
   uc16_stream.SeekForward(halfway - i);
+  ascii_stream.SeekForward(halfway - i);
   string_stream.SeekForward(halfway - i);
   utf8_stream.SeekForward(halfway - i);
   i = halfway;
   CHECK_EQU(i, uc16_stream.pos());
+  CHECK_EQU(i, ascii_stream.pos());
   CHECK_EQU(i, string_stream.pos());
   CHECK_EQU(i, utf8_stream.pos());
 
   while (i < end) {
     // Read streams one char at a time
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
     int32_t c0 = ascii_source[i];
     int32_t c1 = uc16_stream.Advance();
+    int32_t c4 = ascii_stream.Advance();
     int32_t c2 = string_stream.Advance();
     int32_t c3 = utf8_stream.Advance();
     i++;
     CHECK_EQ(c0, c1);
+    CHECK_EQ(c0, c4);
     CHECK_EQ(c0, c2);
     CHECK_EQ(c0, c3);
     CHECK_EQU(i, uc16_stream.pos());
+    CHECK_EQU(i, ascii_stream.pos());
     CHECK_EQU(i, string_stream.pos());
     CHECK_EQU(i, utf8_stream.pos());
   }
 
   int32_t c1 = uc16_stream.Advance();
+  int32_t c4 = ascii_stream.Advance();
   int32_t c2 = string_stream.Advance();
   int32_t c3 = utf8_stream.Advance();
   CHECK_LT(c1, 0);
+  CHECK_LT(c4, 0);
   CHECK_LT(c2, 0);
   CHECK_LT(c3, 0);
 }
@@ -710,6 +939,46 @@ void TestScanRegExp(const char* re_source, const char* expected) {
 }
 
 
+TEST(ScanLongComments) {
+  v8::V8::Initialize();
+
+  // Single-line comments and whitespace runs longer than the character
+  // stream buffer, ended by each kind of line terminator (and by the end
+  // of input).
+  static const int kCommentLength = 3000;
+  const char* terminators[] = {
+    "\n", "\r", "\xe2\x80\xa8", "\xe2\x80\xa9", ""
+  };
+  for (size_t t = 0; t < ARRAY_SIZE(terminators); t++) {
+    i::SmartArrayPointer<char> source(new char[2 * kCommentLength + 32]);
+    char* cursor = *source;
+    cursor += i::OS::SNPrintF(i::Vector<char>(cursor, 8), "a //");
+    for (int i = 0; i < kCommentLength; i++) *cursor++ = 'x';
+    cursor += i::OS::SNPrintF(i::Vector<char>(cursor, 8), "%s",
+                              terminators[t]);
+    for (int i = 0; i < kCommentLength; i++) *cursor++ = i % 2 ? ' ' : '\t';
+    *cursor++ = 'b';
+    int length = static_cast<int>(cursor - *source);
+
+    i::Utf8ToUC16CharacterStream stream(
+        reinterpret_cast<const i::byte*>(*source), length);
+    i::Scanner scanner(i::Isolate::Current()->unicode_cache());
+    scanner.Initialize(&stream);
+    CHECK_EQ(i::Token::IDENTIFIER, scanner.Next());
+    if (terminators[t][0] == '\0') {
+      // Without a line terminator, the rest of the input is comment.
+      CHECK(!scanner.HasAnyLineTerminatorBeforeNext());
+      CHECK_EQ(i::Token::EOS, scanner.Next());
+      continue;
+    }
+    CHECK(scanner.HasAnyLineTerminatorBeforeNext());
+    CHECK_EQ(i::Token::IDENTIFIER, scanner.Next());
+    CHECK_EQ(2 * kCommentLength + 5, scanner.location().beg_pos);
+    CHECK_EQ(i::Token::EOS, scanner.Next());
+  }
+}
+
+
 TEST(RegExpScanning) {
   v8::V8::Initialize();
 
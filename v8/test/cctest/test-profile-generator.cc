@@ -505,6 +505,140 @@ static inline i::Address ToAddress(int n) {
   return reinterpret_cast<i::Address>(n);
 }
 
+namespace {
+
+// Decodes a serialized CPU profile, counting its records.
+class CpuProfileDecoder {
+ public:
+  explicit CpuProfileDecoder(const i::List<char>& buffer)
+      : buffer_(buffer), pos_(0), entries_(0), nodes_(0), ticks_(0) {
+    CHECK_EQ(0, strncmp(&buffer_[0], "V8CP", 4));
+    pos_ = 4;
+    version_ = ReadUnsigned();
+    uid_ = ReadUnsigned();
+    sequence_ = ReadUnsigned();
+    for (unsigned tag = ReadUnsigned(); tag != 0; tag = ReadUnsigned()) {
+      if (tag == i::CpuProfileSerializer::kCodeEntryTag) {
+        ReadUnsigned();  // id
+        ReadUnsigned();  // log tag
+        SkipString();    // name prefix
+        ReadString(last_name_, sizeof(last_name_));
+        SkipString();    // resource name
+        ReadUnsigned();  // line
+        entries_++;
+      } else if (tag == i::CpuProfileSerializer::kNodeTag) {
+        ReadUnsigned();  // id
+        ReadUnsigned();  // parent id
+        ReadUnsigned();  // code entry id
+        nodes_++;
+      } else {
+        CHECK_EQ(i::CpuProfileSerializer::kTicksTag, static_cast<int>(tag));
+        ReadUnsigned();  // node id
+        ticks_ += ReadUnsigned();
+      }
+    }
+    CHECK_EQ(buffer_.length(), pos_);
+  }
+
+  unsigned version() const { return version_; }
+  unsigned uid() const { return uid_; }
+  unsigned sequence() const { return sequence_; }
+  int entries() const { return entries_; }
+  int nodes() const { return nodes_; }
+  unsigned ticks() const { return ticks_; }
+  const char* last_name() const { return last_name_; }
+
+ private:
+  unsigned ReadUnsigned() {
+    unsigned value = 0;
+    int shift = 0;
+    unsigned char b;
+    do {
+      b = static_cast<unsigned char>(buffer_[pos_++]);
+      value |= (b & 0x7f) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    return value;
+  }
+
+  void SkipString() { pos_ += ReadUnsigned(); }
+
+  void ReadString(char* result, int size) {
+    int length = ReadUnsigned();
+    int copied = i::Min(length, size - 1);
+    memcpy(result, &buffer_[pos_], copied);
+    result[copied] = '\0';
+    pos_ += length;
+  }
+
+  const i::List<char>& buffer_;
+  int pos_;
+  unsigned version_;
+  unsigned uid_;
+  unsigned sequence_;
+  int entries_;
+  int nodes_;
+  unsigned ticks_;
+  char last_name_[16];
+};
+
+}  // namespace
+
+
+TEST(CpuProfileSerializeDelta) {
+  CodeEntry entry1(i::Logger::FUNCTION_TAG, "", "aaa", "", 0,
+                   TokenEnumerator::kNoSecurityToken);
+  CodeEntry entry2(i::Logger::FUNCTION_TAG, "", "bbb", "", 0,
+                   TokenEnumerator::kNoSecurityToken);
+  CodeEntry entry3(i::Logger::FUNCTION_TAG, "", "ccc", "", 0,
+                   TokenEnumerator::kNoSecurityToken);
+  CpuProfile profile("", 7);
+  CodeEntry* path1[] = {&entry2, &entry1};
+  profile.AddPath(Vector<CodeEntry*>(path1, 2));
+  profile.AddPath(Vector<CodeEntry*>(path1, 2));
+
+  // The first export holds the root, aaa and bbb and both ticks.
+  i::List<char> first;
+  profile.delta_serializer()->Encode(&first);
+  {
+    CpuProfileDecoder decoder(first);
+    CHECK_EQ(i::CpuProfileSerializer::kVersion,
+             static_cast<int>(decoder.version()));
+    CHECK_EQ(7, decoder.uid());
+    CHECK_EQ(0, decoder.sequence());
+    CHECK_EQ(3, decoder.entries());
+    CHECK_EQ(3, decoder.nodes());
+    CHECK_EQ(2, decoder.ticks());
+  }
+
+  // The next one only holds what was added since.
+  CodeEntry* path2[] = {&entry3, &entry1};
+  profile.AddPath(Vector<CodeEntry*>(path2, 2));
+  i::List<char> second;
+  profile.delta_serializer()->Encode(&second);
+  {
+    CpuProfileDecoder decoder(second);
+    CHECK_EQ(1, decoder.sequence());
+    CHECK_EQ(1, decoder.entries());
+    CHECK_EQ("ccc", decoder.last_name());
+    CHECK_EQ(1, decoder.nodes());
+    CHECK_EQ(1, decoder.ticks());
+  }
+
+  // A fresh serializer exports the whole profile.
+  i::CpuProfileSerializer serializer(&profile);
+  i::List<char> full;
+  serializer.Encode(&full);
+  {
+    CpuProfileDecoder decoder(full);
+    CHECK_EQ(0, decoder.sequence());
+    CHECK_EQ(4, decoder.entries());
+    CHECK_EQ(4, decoder.nodes());
+    CHECK_EQ(3, decoder.ticks());
+  }
+}
+
+
 TEST(CodeMapAddCode) {
   CodeMap code_map;
   CodeEntry entry1(i::Logger::FUNCTION_TAG, "", "aaa", "", 0,
@@ -560,6 +694,43 @@ TEST(CodeMapMoveAndDeleteCode) {
 }
 
 
+TEST(CodeMapUpdatesBetweenLookups) {
+  CodeMap code_map;
+  CodeEntry entry1(i::Logger::FUNCTION_TAG, "", "aaa", "", 0,
+                   TokenEnumerator::kNoSecurityToken);
+  CodeEntry entry2(i::Logger::FUNCTION_TAG, "", "bbb", "", 0,
+                   TokenEnumerator::kNoSecurityToken);
+  CodeEntry entry3(i::Logger::FUNCTION_TAG, "", "ccc", "", 0,
+                   TokenEnumerator::kNoSecurityToken);
+  code_map.AddCode(ToAddress(0x1500), &entry1, 0x100);
+  CHECK_EQ(&entry1, code_map.FindEntry(ToAddress(0x1550)));
+  // Code reused within one batch of updates: the later code wins.
+  code_map.AddCode(ToAddress(0x1700), &entry2, 0x100);
+  code_map.AddCode(ToAddress(0x1780), &entry3, 0x100);
+  code_map.AddCode(ToAddress(0x1400), &entry2, 0x180);
+  CHECK_EQ(&entry2, code_map.FindEntry(ToAddress(0x1400)));
+  CHECK_EQ(NULL, code_map.FindEntry(ToAddress(0x1590)));
+  CHECK_EQ(NULL, code_map.FindEntry(ToAddress(0x1700)));
+  CHECK_EQ(&entry3, code_map.FindEntry(ToAddress(0x1780)));
+  // Code moved before it was looked up, and code added where the moved
+  // code was.
+  code_map.AddCode(ToAddress(0x2000), &entry1, 0x100);
+  code_map.MoveCode(ToAddress(0x2000), ToAddress(0x3000));
+  code_map.MoveCode(ToAddress(0x1780), ToAddress(0x2000));
+  CHECK_EQ(&entry3, code_map.FindEntry(ToAddress(0x2000)));
+  CHECK_EQ(&entry1, code_map.FindEntry(ToAddress(0x3000)));
+  CHECK_EQ(NULL, code_map.FindEntry(ToAddress(0x1780)));
+  CHECK_EQ(NULL, code_map.FindEntry(ToAddress(0x2100)));
+  // Shared function ids follow moves.
+  int id = code_map.GetSharedId(ToAddress(0x5000));
+  CHECK_EQ(id, code_map.GetSharedId(ToAddress(0x5000)));
+  CHECK_NE(id, code_map.GetSharedId(ToAddress(0x6000)));
+  code_map.MoveCode(ToAddress(0x5000), ToAddress(0x7000));
+  CHECK_EQ(id, code_map.GetSharedId(ToAddress(0x7000)));
+  CHECK_EQ(NULL, code_map.FindEntry(ToAddress(0x5000)));
+}
+
+
 namespace {
 
 class TestSetup {
@@ -503,7 +503,8 @@ static RegExpNode* Compile(const char* input, bool multiline, bool is_ascii) {
     return NULL;
   Handle<String> pattern = isolate->factory()->
       NewStringFromUtf8(CStrVector(input));
-  RegExpEngine::Compile(&compile_data, false, multiline, pattern, is_ascii);
+  RegExpEngine::Compile(&compile_data, false, multiline, pattern, is_ascii,
+                        false);
   return compile_data.node;
 }
 
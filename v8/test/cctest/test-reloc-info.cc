@@ -113,4 +113,65 @@ TEST(Positions) {
   }
 }
 
+
+// Tests that ids and positions with deltas of all sizes and signs, which
+// use the variable length encoding when they do not fit in a tagged byte,
+// are read back as written.
+TEST(VariableLengthData) {
+  static const int kDeltas[] = {
+    0, 1, -1, 31, -32, 32, -33, 63, -64, 64, -65, 8191, -8192, 8192, -8193,
+    1 << 20, -(1 << 20), kMaxInt, -kMaxInt, 12345, -12345
+  };
+  const int delta_count = ARRAY_SIZE(kDeltas);
+  const int code_size = 10 * KB;
+  int relocation_info_size = 10 * KB;
+  const int buffer_size = code_size + relocation_info_size;
+  SmartArrayPointer<byte> buffer(new byte[buffer_size]);
+
+  byte* pc = *buffer;
+  byte* buffer_end = *buffer + buffer_size;
+
+  RelocInfoWriter writer(buffer_end, pc);
+  byte* relocation_info_end = buffer_end - relocation_info_size;
+  int id = 0;
+  int pos = 0;
+  for (int i = 0; i < delta_count; i++, pc += i) {
+    // Keep the absolute values in range so that the deltas are exact.
+    id = (i % 2 == 0) ? kDeltas[i] : 0;
+    pos = kDeltas[i] / 2;
+    WriteRinfo(&writer, pc, RelocInfo::CODE_TARGET_WITH_ID, id);
+    WriteRinfo(&writer, pc, RelocInfo::POSITION, pos);
+    CHECK(writer.pos() - RelocInfoWriter::kMaxSize >= relocation_info_end);
+  }
+
+  relocation_info_size = static_cast<int>(buffer_end - writer.pos());
+  CodeDesc desc = { *buffer, buffer_size, code_size,
+                    relocation_info_size, NULL };
+
+  // Read only the ids, skipping the positions.
+  {
+    RelocIterator it(desc, RelocInfo::ModeMask(RelocInfo::CODE_TARGET_WITH_ID));
+    pc = *buffer;
+    for (int i = 0; i < delta_count; i++, pc += i) {
+      CHECK_EQ(pc, it.rinfo()->pc());
+      CHECK_EQ((i % 2 == 0) ? kDeltas[i] : 0,
+               static_cast<int>(it.rinfo()->data()));
+      it.next();
+    }
+    CHECK(it.done());
+  }
+
+  // Read only the positions, skipping the ids.
+  {
+    RelocIterator it(desc, RelocInfo::ModeMask(RelocInfo::POSITION));
+    pc = *buffer;
+    for (int i = 0; i < delta_count; i++, pc += i) {
+      CHECK_EQ(pc, it.rinfo()->pc());
+      CHECK_EQ(kDeltas[i] / 2, static_cast<int>(it.rinfo()->data()));
+      it.next();
+    }
+    CHECK(it.done());
+  }
+}
+
 } }  // namespace v8::internal
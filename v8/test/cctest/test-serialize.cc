@@ -30,8 +30,10 @@
 #include "sys/stat.h"
 #include "v8.h"
 
+#include "compilation-cache.h"
 #include "debug.h"
 #include "ic-inl.h"
+#include "parser.h"
 #include "runtime.h"
 #include "serialize.h"
 #include "scopeinfo.h"
@@ -555,6 +557,92 @@ DEPENDENT_TEST(ContextDeserialization, ContextSerialization) {
 }
 
 
+TEST(CustomContextSerialization) {
+  Serializer::Enable();
+  v8::V8::Initialize();
+
+  v8::Persistent<v8::Context> env = v8::Context::New();
+  ASSERT(!env.IsEmpty());
+  env->Enter();
+  // Run some code in the context, like mksnapshot does with --extra-code.
+  { v8::HandleScope scope;
+    v8::Script::Compile(v8::String::New(
+        "var o = { answer: 42 };"
+        "function f() { return o.answer; }"))->Run();
+  }
+  // Make sure all builtin scripts are cached.
+  { HandleScope scope;
+    for (int i = 0; i < Natives::GetBuiltinsCount(); i++) {
+      Isolate::Current()->bootstrapper()->NativesSourceLookup(i);
+    }
+  }
+  // If we don't do this then we end up with a stray root pointing at the
+  // context even after we have disposed of env.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+
+  int file_name_length = StrLength(FLAG_testing_serialization_file) + 10;
+  Vector<char> startup_name = Vector<char>::New(file_name_length + 1);
+  OS::SNPrintF(startup_name, "%s.startup", FLAG_testing_serialization_file);
+
+  env->Exit();
+
+  Object* raw_context = *(v8::Utils::OpenHandle(*env));
+
+  env.Dispose();
+
+  FileByteSink startup_sink(startup_name.start());
+  startup_name.Dispose();
+  StartupSerializer startup_serializer(&startup_sink);
+  startup_serializer.SerializeStrongReferences();
+
+  FileByteSink partial_sink(FLAG_testing_serialization_file);
+  PartialSerializer p_ser(&startup_serializer, &partial_sink);
+  p_ser.Serialize(&raw_context);
+  startup_serializer.SerializeWeakReferences();
+  partial_sink.WriteSpaceUsed(p_ser.CurrentAllocationAddress(NEW_SPACE),
+                              p_ser.CurrentAllocationAddress(OLD_POINTER_SPACE),
+                              p_ser.CurrentAllocationAddress(OLD_DATA_SPACE),
+                              p_ser.CurrentAllocationAddress(CODE_SPACE),
+                              p_ser.CurrentAllocationAddress(MAP_SPACE),
+                              p_ser.CurrentAllocationAddress(CELL_SPACE),
+                              p_ser.CurrentAllocationAddress(LO_SPACE));
+}
+
+
+DEPENDENT_TEST(CustomContextDeserialization, CustomContextSerialization) {
+  if (!Snapshot::IsEnabled()) {
+    int file_name_length = StrLength(FLAG_testing_serialization_file) + 10;
+    Vector<char> startup_name = Vector<char>::New(file_name_length + 1);
+    OS::SNPrintF(startup_name, "%s.startup", FLAG_testing_serialization_file);
+
+    CHECK(Snapshot::Initialize(startup_name.start()));
+    startup_name.Dispose();
+
+    const char* file_name = FLAG_testing_serialization_file;
+    ReserveSpaceForPartialSnapshot(file_name);
+
+    int snapshot_size = 0;
+    byte* snapshot = ReadBytes(file_name, &snapshot_size);
+
+    Object* root;
+    {
+      SnapshotByteSource source(snapshot, snapshot_size);
+      Deserializer deserializer(&source);
+      deserializer.DeserializePartial(&root);
+      CHECK(root->IsContext());
+    }
+    v8::HandleScope handle_scope;
+    Handle<Context> context(Context::cast(root));
+    Handle<JSObject> global(context->global());
+    Handle<Object> o = GetProperty(global, "o");
+    CHECK(o->IsJSObject());
+    CHECK_EQ(Smi::FromInt(42), *GetProperty(Handle<JSObject>::cast(o),
+                                            "answer"));
+    CHECK(GetProperty(global, "f")->IsJSFunction());
+  }
+}
+
+
 TEST(LinearAllocation) {
   v8::V8::Initialize();
   int new_space_max = 512 * KB;
@@ -667,6 +755,53 @@ TEST(LinearAllocation) {
 }
 
 
+TEST(CodeCache) {
+  v8::V8::EnableCodeCacheCreation();
+  v8::V8::Initialize();
+
+  v8::HandleScope scope;
+  v8::Persistent<v8::Context> env = v8::Context::New();
+  env->Enter();
+
+  const char* source =
+      "function f(x) { return x + 1; }"
+      "var s = 'abc';"
+      "f(41) + s.length";
+  v8::Local<v8::String> source_string = v8::String::New(source);
+  v8::ScriptData* cache = v8::Script::New(source_string)->CreateCodeCache();
+  CHECK(cache != NULL);
+  CHECK(!cache->HasError());
+
+  // Read the cache back like an embedder loading it from disk.
+  v8::ScriptData* loaded = v8::ScriptData::New(cache->Data(), cache->Length());
+  ScriptDataImpl* loaded_impl = static_cast<ScriptDataImpl*>(loaded);
+  CHECK(loaded_impl->is_code_cache());
+
+  Handle<String> internal_source = v8::Utils::OpenHandle(*source_string);
+  CHECK(!CodeSerializer::Deserialize(FACTORY->NewScript(internal_source),
+                                     loaded_impl).is_null());
+  Handle<String> other_source = FACTORY->LookupAsciiSymbol("6 * 7");
+  CHECK(CodeSerializer::Deserialize(FACTORY->NewScript(other_source),
+                                    loaded_impl).is_null());
+
+  // Make sure the script is not found in the compilation cache.
+  Isolate::Current()->compilation_cache()->Clear();
+  v8::Local<v8::Script> script =
+      v8::Script::Compile(source_string, NULL, loaded);
+  CHECK_EQ(45, script->Run()->Int32Value());
+
+  // A cache for another source is ignored.
+  v8::Local<v8::Script> other =
+      v8::Script::Compile(v8::String::New("6 * 7"), NULL, loaded);
+  CHECK_EQ(42, other->Run()->Int32Value());
+
+  delete loaded;
+  delete cache;
+  env->Exit();
+  env.Dispose();
+}
+
+
 TEST(TestThatAlwaysSucceeds) {
 }
 
@@ -174,6 +174,42 @@ TEST(MemoryAllocator) {
 }
 
 
+TEST(PagePoolReusesFreedPages) {
+  OS::Setup();
+  Isolate* isolate = Isolate::Current();
+  isolate->InitializeLoggingAndCounters();
+  Heap* heap = isolate->heap();
+  CHECK(isolate->heap()->ConfigureHeapDefault());
+
+  MemoryAllocator* memory_allocator = new MemoryAllocator(isolate);
+  CHECK(memory_allocator->Setup(heap->MaxReserved(),
+                                heap->MaxExecutableSize()));
+  OldSpace faked_space(heap,
+                       heap->MaxReserved(),
+                       OLD_POINTER_SPACE,
+                       NOT_EXECUTABLE);
+
+  PagePool::TearDown();
+  Page* page = memory_allocator->AllocatePage(&faked_space, NOT_EXECUTABLE);
+  CHECK(page->is_valid());
+  Address address = page->address();
+  memory_allocator->Free(page);
+  CHECK_EQ(0, static_cast<int>(memory_allocator->Size()));
+  CHECK(PagePool::Size() >= static_cast<size_t>(Page::kPageSize));
+
+  // The next page comes out of the pool instead of a new mapping.
+  page = memory_allocator->AllocatePage(&faked_space, NOT_EXECUTABLE);
+  CHECK(address == page->address());
+  CHECK_EQ(0, static_cast<int>(PagePool::Size()));
+
+  memory_allocator->Free(page);
+  PagePool::TearDown();
+  CHECK_EQ(0, static_cast<int>(PagePool::Size()));
+  memory_allocator->TearDown();
+  delete memory_allocator;
+}
+
+
 TEST(NewSpace) {
   OS::Setup();
   Isolate* isolate = Isolate::Current();
@@ -264,3 +300,39 @@ TEST(LargeObjectSpace) {
 
   CHECK(lo->AllocateRaw(lo_size, NOT_EXECUTABLE)->IsFailure());
 }
+
+
+TEST(LargeObjectChunkCache) {
+  v8::V8::Initialize();
+
+  MemoryAllocator* memory_allocator = Isolate::Current()->memory_allocator();
+  memory_allocator->ReleaseLargeChunkCache();
+
+  const int kLength = Page::kPageSize / kPointerSize;
+  Address address;
+  { AlwaysAllocateScope always_allocate;
+    FixedArray* array =
+        FixedArray::cast(HEAP->AllocateFixedArray(kLength)->ToObjectChecked());
+    CHECK(HEAP->lo_space()->Contains(array));
+    address = array->address();
+  }
+  // The array is not referenced from anywhere and its chunk gets cached.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(memory_allocator->LargeChunkCacheSize() > 0);
+
+  // A slightly smaller array reuses the chunk.
+  { AlwaysAllocateScope always_allocate;
+    FixedArray* array = FixedArray::cast(
+        HEAP->AllocateFixedArray(kLength - 1000)->ToObjectChecked());
+    CHECK(array->address() == address);
+    CHECK_EQ(0, static_cast<int>(memory_allocator->LargeChunkCacheSize()));
+  }
+
+  // Cached chunks that are not reused are released after a few GCs.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(memory_allocator->LargeChunkCacheSize() > 0);
+  for (int i = 0; i <= FLAG_large_object_cache_age; i++) {
+    HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  }
+  CHECK_EQ(0, static_cast<int>(memory_allocator->LargeChunkCacheSize()));
+}
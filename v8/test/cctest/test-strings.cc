@@ -273,6 +273,33 @@ TEST(Traverse) {
 }
 
 
+TEST(ConsDepthIsBounded) {
+  InitializeVM();
+  v8::HandleScope scope;
+  Handle<String> building_blocks[NUMBER_OF_BUILDING_BLOCKS];
+  ZoneScope zone(Isolate::Current(), DELETE_ON_EXIT);
+  InitializeBuildingBlocks(building_blocks);
+  Handle<String> flat = ConstructBalanced(building_blocks);
+  FlattenString(flat);
+  Handle<String> left = ConstructLeft(building_blocks, DEEP_DEPTH);
+  Handle<String> right = ConstructRight(building_blocks, DEEP_DEPTH);
+  CHECK_LE(ConsString::DepthOf(*left), ConsString::kMaxDepth);
+  CHECK_LE(ConsString::DepthOf(*right), ConsString::kMaxDepth);
+  Traverse(flat, left);
+  Traverse(flat, right);
+
+  // Appends done by generated code are bounded as well.
+  v8::Local<v8::Value> result = CompileRun(
+      "var s = '';"
+      "for (var i = 0; i < 20000; i++) s += 'abcdefghijklmnopqrstuvwxyz';"
+      "s;");
+  Handle<String> appended = v8::Utils::OpenHandle(v8::String::Cast(*result));
+  CHECK_EQ(20000 * 26, appended->length());
+  CHECK_LE(ConsString::DepthOf(*appended), ConsString::kMaxDepth);
+  CHECK_EQ('z', appended->Get(appended->length() - 1));
+}
+
+
 static const int DEEP_ASCII_DEPTH = 100000;
 
 
@@ -347,6 +374,34 @@ TEST(Utf8Conversion) {
 }
 
 
+TEST(Utf8RoundTrip) {
+  // Decode and re-encode utf-8 with ascii runs around non-ascii characters.
+  InitializeVM();
+  v8::HandleScope handle_scope;
+  // U+00E9 -> C3 A9
+  // U+20AC -> E2 82 AC
+  const char* utf8 =
+      "0123456789abcdefghij\xC3\xA9klmnop\xE2\x82\xAC\xE2\x82\xAC"
+      "0123456789abcdefghij";
+  int utf8_length = StrLength(utf8);
+  v8::Handle<v8::String> str = v8::String::New(utf8, utf8_length);
+  CHECK_EQ(49, str->Length());
+  Handle<String> flat = v8::Utils::OpenHandle(*str);
+  CHECK_EQ('j', flat->Get(19));
+  CHECK_EQ(0xE9, flat->Get(20));
+  CHECK_EQ(0x20AC, flat->Get(27));
+  CHECK_EQ(0x20AC, flat->Get(28));
+  CHECK_EQ('0', flat->Get(29));
+  CHECK_EQ(utf8_length, str->Utf8Length());
+  char buffer[64];
+  int chars_written;
+  int written = str->WriteUtf8(buffer, sizeof(buffer), &chars_written);
+  CHECK_EQ(utf8_length + 1, written);
+  CHECK_EQ(49, chars_written);
+  CHECK_EQ(0, strcmp(utf8, buffer));
+}
+
+
 TEST(ExternalShortStringAdd) {
   ZoneScope zone(Isolate::Current(), DELETE_ON_EXIT);
 
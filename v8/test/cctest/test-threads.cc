@@ -53,6 +53,46 @@ TEST(Preemption) {
 }
 
 
+static int time_slices = 0;
+
+
+static void TimeSliceCallback() {
+  time_slices++;
+}
+
+
+static v8::Handle<v8::Value> TimeSlices(const v8::Arguments& args) {
+  return v8::Integer::New(time_slices);
+}
+
+
+TEST(TimeSlice) {
+  v8::HandleScope scope;
+  v8::Handle<v8::ObjectTemplate> global = v8::ObjectTemplate::New();
+  global->Set(v8::String::New("timeSlices"),
+              v8::FunctionTemplate::New(TimeSlices));
+  v8::Persistent<v8::Context> context = v8::Context::New(NULL, global);
+  v8::Context::Scope context_scope(context);
+
+  // Without a per-thread CPU timer there is nothing to test.
+  if (!v8::V8::SetTimeSlice(1000, TimeSliceCallback)) return;
+
+  // The loop only ends if the callback runs at its stack checks.
+  v8::Handle<v8::Script> script = v8::Script::Compile(
+      v8::String::New("var i = 0; while (timeSlices() < 3) i++; i"));
+  CHECK(script->Run()->Int32Value() > 0);
+  CHECK_GE(time_slices, 3);
+
+  CHECK(v8::V8::SetTimeSlice(0, NULL));
+  int slices = time_slices;
+  script = v8::Script::Compile(v8::String::New(
+      "var start = Date.now(); while (Date.now() - start < 20) {}"));
+  script->Run();
+  CHECK_EQ(slices, time_slices);
+  context.Dispose();
+}
+
+
 enum Turn {
   FILL_CACHE,
   CLEAN_CACHE,
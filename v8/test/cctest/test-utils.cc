@@ -136,6 +136,38 @@ TEST(MemCopy) {
 }
 
 
+TEST(CompareCharsAndFindUC16) {
+  const int kLength = 80;
+  uc16 a[kLength];
+  uc16 b[kLength];
+  char c[kLength];
+  char d[kLength];
+  for (int i = 0; i < kLength; i++) {
+    a[i] = b[i] = static_cast<uc16>(0x100 + i);
+    c[i] = d[i] = static_cast<char>('0' + (i & 0x3F));
+  }
+  // Every offset and length around the 16 byte blocks, with and without a
+  // difference at each position.
+  for (int start = 0; start < 16; start++) {
+    for (int length = 0; start + length <= kLength; length++) {
+      CHECK_EQ(0, CompareChars(a + start, b + start, length));
+      CHECK_EQ(0, CompareChars(c + start, d + start, length));
+      CHECK(FindUC16(a + start, 0x1234, length) == NULL);
+      for (int i = 0; i < length; i++) {
+        b[start + i] = 0x1234;
+        d[start + i] = '~';
+        CHECK(CompareChars(a + start, b + start, length) < 0);
+        CHECK(CompareChars(c + start, d + start, length) < 0);
+        CHECK(CompareChars(b + start, a + start, length) > 0);
+        CHECK(FindUC16(b + start, 0x1234, length) == b + start + i);
+        b[start + i] = a[start + i];
+        d[start + i] = c[start + i];
+      }
+    }
+  }
+}
+
+
 TEST(Collector) {
   Collector<int> collector(8);
   const int kLoops = 5;
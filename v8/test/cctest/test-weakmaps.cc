@@ -152,3 +152,27 @@ TEST(Shrinking) {
   // Check shrunk capacity.
   CHECK_EQ(32, ObjectHashTable::cast(weakmap->table())->Capacity());
 }
+
+
+TEST(Rehashing) {
+  LocalContext context;
+  v8::HandleScope scope;
+  Handle<JSWeakMap> weakmap = AllocateJSWeakMap();
+
+  // Grow the table a few times while keeping all keys alive.
+  static const int kNumberOfKeys = 100;
+  Handle<JSObject> keys[kNumberOfKeys];
+  Handle<Map> map = FACTORY->NewMap(JS_OBJECT_TYPE, JSObject::kHeaderSize);
+  for (int i = 0; i < kNumberOfKeys; i++) {
+    keys[i] = FACTORY->NewJSObjectFromMap(map);
+    PutIntoWeakMap(weakmap, keys[i], i);
+  }
+
+  // Every key is found again with the hash stored next to it after the
+  // table was rehashed.
+  ObjectHashTable* table = ObjectHashTable::cast(weakmap->table());
+  CHECK_EQ(kNumberOfKeys, table->NumberOfElements());
+  for (int i = 0; i < kNumberOfKeys; i++) {
+    CHECK_EQ(Smi::FromInt(i), table->Lookup(*keys[i]));
+  }
+}
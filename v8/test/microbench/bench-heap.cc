@@ -0,0 +1,91 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Raw allocation and scavenge throughput.
+
+#include "v8.h"
+
+#include "factory.h"
+#include "microbench.h"
+
+using namespace v8::internal;
+
+
+static void AllocateRawLoop(MicroBenchmark* bench, int size) {
+  Heap* heap = Isolate::Current()->heap();
+  heap->CollectGarbage(NEW_SPACE);
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    Object* object;
+    MaybeObject* maybe = heap->AllocateRaw(size, NEW_SPACE, OLD_DATA_SPACE);
+    if (!maybe->ToObject(&object)) {
+      // New space is full; scavenge outside the measured time.
+      bench->StopTiming();
+      heap->CollectGarbage(NEW_SPACE);
+      bench->StartTiming();
+      continue;
+    }
+    // Keep the heap iterable for the next scavenge.
+    heap->CreateFillerObjectAt(HeapObject::cast(object)->address(), size);
+  }
+  bench->StopTiming();
+}
+
+
+BENCHMARK(AllocateRawSmall) {
+  AllocateRawLoop(bench, 4 * kPointerSize);
+}
+
+
+BENCHMARK(AllocateRawLarge) {
+  AllocateRawLoop(bench, 1 * KB);
+}
+
+
+// Each iteration fills new space with kLiveBytes of reachable arrays and
+// times a single scavenge, which has to copy all of them.
+static const int kLiveBytes = 512 * KB;
+static const int kArrayLength = 126;
+
+
+BENCHMARK(ScavengeLive) {
+  Heap* heap = Isolate::Current()->heap();
+  const int array_size = FixedArray::SizeFor(kArrayLength);
+  const int count = kLiveBytes / array_size;
+  bench->SetBytesPerIteration(count * array_size);
+  for (int i = 0; i < bench->iterations(); i++) {
+    HandleScope scope;
+    heap->CollectGarbage(NEW_SPACE);
+    Handle<FixedArray> holder = FACTORY->NewFixedArray(count);
+    for (int j = 0; j < count; j++) {
+      holder->set(j, *FACTORY->NewFixedArray(kArrayLength));
+    }
+    bench->StartTiming();
+    heap->CollectGarbage(NEW_SPACE);
+    bench->StopTiming();
+  }
+}
@@ -0,0 +1,110 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Property access through inline caches.  Crankshaft is switched off so the
+// numbers measure the IC stubs rather than optimized code.
+
+#include "v8.h"
+
+#include "microbench.h"
+
+using namespace v8::internal;
+
+
+static void RunLoop(MicroBenchmark* bench, const char* setup) {
+  bool saved_crankshaft = FLAG_crankshaft;
+  FLAG_crankshaft = false;
+  v8::Script::Compile(v8::String::New(setup))->Run();
+  v8::Local<v8::Function> loop = v8::Local<v8::Function>::Cast(
+      v8::Context::GetCurrent()->Global()->Get(v8::String::New("loop")));
+  v8::Handle<v8::Value> args[] = { v8::Integer::New(bench->iterations()) };
+  // Warm up the ICs before timing.
+  v8::Handle<v8::Value> warmup[] = { v8::Integer::New(10) };
+  loop->Call(v8::Context::GetCurrent()->Global(), 1, warmup);
+  bench->StartTiming();
+  loop->Call(v8::Context::GetCurrent()->Global(), 1, args);
+  bench->StopTiming();
+  FLAG_crankshaft = saved_crankshaft;
+}
+
+
+BENCHMARK(MonomorphicLoad) {
+  RunLoop(bench,
+      "function loop(n) {"
+      "  var o = { x: 1, y: 2 }, s = 0;"
+      "  for (var i = 0; i < n; i++) s += o.y;"
+      "  return s;"
+      "}");
+}
+
+
+BENCHMARK(MonomorphicStore) {
+  RunLoop(bench,
+      "function loop(n) {"
+      "  var o = { x: 1, y: 2 };"
+      "  for (var i = 0; i < n; i++) o.y = i;"
+      "  return o;"
+      "}");
+}
+
+
+BENCHMARK(PolymorphicLoad) {
+  RunLoop(bench,
+      "function loop(n) {"
+      "  var os = [{ x: 1 }, { y: 2, x: 1 }, { z: 3, x: 1 }, { w: 4, x: 1 }];"
+      "  var s = 0;"
+      "  for (var i = 0; i < n; i++) s += os[i & 3].x;"
+      "  return s;"
+      "}");
+}
+
+
+BENCHMARK(KeyedLoad) {
+  RunLoop(bench,
+      "function loop(n) {"
+      "  var a = [1, 2, 3, 4, 5, 6, 7, 8], s = 0;"
+      "  for (var i = 0; i < n; i++) s += a[i & 7];"
+      "  return s;"
+      "}");
+}
+
+
+BENCHMARK(MegamorphicLoad) {
+  RunLoop(bench,
+      "function loop(n) {"
+      "  var os = [];"
+      "  for (var j = 0; j < 16; j++) {"
+      "    var o = {};"
+      "    o['p' + j] = j;"
+      "    o.x = j;"
+      "    os.push(o);"
+      "  }"
+      "  var s = 0;"
+      "  for (var i = 0; i < n; i++) s += os[i & 15].x;"
+      "  return s;"
+      "}");
+}
@@ -0,0 +1,128 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// JSON parsing, string search and number conversions.
+
+#include "v8.h"
+
+#include "conversions.h"
+#include "factory.h"
+#include "json-parser.h"
+#include "microbench.h"
+#include "string-search.h"
+#include "zone-inl.h"
+
+using namespace v8::internal;
+
+
+static const char* kJsonSource =
+    "{\"id\":12345,\"name\":\"microbench\",\"ratio\":0.625,"
+    "\"tags\":[\"alpha\",\"beta\",\"gamma\"],\"valid\":true,"
+    "\"nested\":{\"a\":[1,2,3,4,5,6,7,8],\"b\":null,\"c\":-1.5e10}}";
+
+
+BENCHMARK(JsonParse) {
+  Handle<String> source =
+      FACTORY->NewStringFromAscii(CStrVector(kJsonSource));
+  bench->SetBytesPerIteration(source->length());
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    HandleScope scope;
+    DoNotOptimize(*JsonParser<true>::Parse(source));
+  }
+  bench->StopTiming();
+}
+
+
+static const int kSubjectLength = 4 * KB;
+
+
+static void StringSearchLoop(MicroBenchmark* bench, const char* pattern) {
+  // A subject without matches, apart from the pattern at the very end.
+  static char subject[kSubjectLength + 1];
+  int pattern_length = StrLength(pattern);
+  for (int i = 0; i < kSubjectLength; i++) subject[i] = 'a' + (i * 7) % 23;
+  memcpy(subject + kSubjectLength - pattern_length, pattern, pattern_length);
+  subject[kSubjectLength] = '\0';
+  Isolate* isolate = Isolate::Current();
+  Vector<const char> subject_vector(subject, kSubjectLength);
+  Vector<const char> pattern_vector(pattern, pattern_length);
+  bench->SetBytesPerIteration(kSubjectLength);
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    DoNotOptimize(SearchString(isolate, subject_vector, pattern_vector, 0));
+  }
+  bench->StopTiming();
+}
+
+
+BENCHMARK(StringSearchSingleChar) {
+  StringSearchLoop(bench, "Z");
+}
+
+
+BENCHMARK(StringSearchShort) {
+  StringSearchLoop(bench, "XYZ");
+}
+
+
+BENCHMARK(StringSearchLong) {
+  StringSearchLoop(bench, "abcdefghijklmnopqrstuvwXYZ");
+}
+
+
+static const double kDoubles[] = {
+  0.1, 3.14159265358979, 1e21, 123456789012.0, 5e-324, 0.000001234, 42.0,
+  -2.718281828459045
+};
+static const char* kDoubleStrings[] = {
+  "0.1", "3.14159265358979", "1e21", "123456789012", "5e-324",
+  "0.000001234", "42", "-2.718281828459045"
+};
+
+
+BENCHMARK(DoubleToCString) {
+  char buffer[100];
+  Vector<char> vector(buffer, sizeof(buffer));
+  const int count = ARRAY_SIZE(kDoubles);
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    DoNotOptimize(DoubleToCString(kDoubles[i % count], vector));
+  }
+  bench->StopTiming();
+}
+
+
+BENCHMARK(StringToDouble) {
+  UnicodeCache* cache = Isolate::Current()->unicode_cache();
+  const int count = ARRAY_SIZE(kDoubleStrings);
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    DoNotOptimize(StringToDouble(cache, kDoubleStrings[i % count], NO_FLAGS));
+  }
+  bench->StopTiming();
+}
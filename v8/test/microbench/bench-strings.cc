@@ -0,0 +1,81 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// String concatenation and flattening.
+
+#include "v8.h"
+
+#include "factory.h"
+#include "microbench.h"
+
+using namespace v8::internal;
+
+
+BENCHMARK(ConsStringConcat) {
+  Factory* factory = Isolate::Current()->factory();
+  Handle<String> left = factory->NewStringFromAscii(CStrVector("abcdefghij"));
+  Handle<String> right = factory->NewStringFromAscii(CStrVector("klmnopqrst"));
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    HandleScope scope;
+    DoNotOptimize(*factory->NewConsString(left, right));
+  }
+  bench->StopTiming();
+}
+
+
+// Builds a cons string of kPieces * kPieceLength characters.  The tree is
+// left-leaning, as produced by repeated += in JavaScript.
+static const int kPieces = 64;
+static const int kPieceLength = 16;
+static const int kBatch = 32;
+
+
+static Handle<String> BuildConsString(Factory* factory) {
+  Handle<String> piece =
+      factory->NewStringFromAscii(CStrVector("0123456789abcdef"));
+  Handle<String> result = piece;
+  for (int i = 1; i < kPieces; i++) {
+    result = factory->NewConsString(result, piece);
+  }
+  return result;
+}
+
+
+BENCHMARK(ConsStringFlatten) {
+  Factory* factory = Isolate::Current()->factory();
+  bench->SetBytesPerIteration(kPieces * kPieceLength);
+  Handle<String> strings[kBatch];
+  for (int i = 0; i < bench->iterations(); i += kBatch) {
+    HandleScope scope;
+    int count = Min(kBatch, bench->iterations() - i);
+    for (int j = 0; j < count; j++) strings[j] = BuildConsString(factory);
+    bench->StartTiming();
+    for (int j = 0; j < count; j++) FlattenString(strings[j]);
+    bench->StopTiming();
+  }
+}
@@ -0,0 +1,130 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// HashMap lookups and Zone allocation.
+
+#include "v8.h"
+
+#include "hashmap.h"
+#include "microbench.h"
+#include "zone-inl.h"
+
+using namespace v8::internal;
+
+
+static bool PointerMatch(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
+static const int kHashMapEntries = 1024;
+
+
+BENCHMARK(HashMapLookup) {
+  HashMap map(PointerMatch);
+  for (int i = 0; i < kHashMapEntries; i++) {
+    void* key = reinterpret_cast<void*>((i + 1) * kPointerSize);
+    map.Lookup(key, ComputePointerHash(key), true)->value = key;
+  }
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    void* key = reinterpret_cast<void*>(
+        ((i & (kHashMapEntries - 1)) + 1) * kPointerSize);
+    DoNotOptimize(map.Lookup(key, ComputePointerHash(key), false));
+  }
+  bench->StopTiming();
+}
+
+
+BENCHMARK(HashMapInsertRemove) {
+  HashMap map(PointerMatch);
+  bench->StartTiming();
+  for (int i = 0; i < bench->iterations(); i++) {
+    void* key = reinterpret_cast<void*>(
+        ((i & (kHashMapEntries - 1)) + 1) * kPointerSize);
+    uint32_t hash = ComputePointerHash(key);
+    map.Lookup(key, hash, true);
+    if ((i & (kHashMapEntries - 1)) == kHashMapEntries - 1) {
+      // Empty the map again so it does not grow without bound.
+      for (int j = 0; j < kHashMapEntries; j++) {
+        void* old_key = reinterpret_cast<void*>((j + 1) * kPointerSize);
+        map.Remove(old_key, ComputePointerHash(old_key));
+      }
+    }
+  }
+  bench->StopTiming();
+}
+
+
+// Zone memory is released in chunks so a long run does not hold on to
+// gigabytes of segments.
+static const int kZoneChunk = 64 * KB;
+
+
+// Builds a small map in the zone, like the parser does for the properties
+// of an object literal or the variables of a scope.
+BENCHMARK(ZoneHashMapBuild) {
+  static const int kEntries = 16;
+  Isolate* isolate = Isolate::Current();
+  for (int i = 0; i < bench->iterations(); i += kZoneChunk) {
+    ZoneScope scope(isolate, DELETE_ON_EXIT);
+    int count = Min(kZoneChunk, bench->iterations() - i);
+    bench->StartTiming();
+    for (int j = 0; j < count; j++) {
+      ZoneHashMap map(PointerMatch);
+      for (int k = 1; k <= kEntries; k++) {
+        void* key = reinterpret_cast<void*>(k * kPointerSize);
+        map.Lookup(key, ComputePointerHash(key), true);
+      }
+      DoNotOptimize(map.Start());
+    }
+    bench->StopTiming();
+  }
+}
+
+
+static void ZoneAllocateLoop(MicroBenchmark* bench, int size) {
+  Isolate* isolate = Isolate::Current();
+  Zone* zone = isolate->zone();
+  for (int i = 0; i < bench->iterations(); i += kZoneChunk) {
+    ZoneScope scope(isolate, DELETE_ON_EXIT);
+    int count = Min(kZoneChunk, bench->iterations() - i);
+    bench->StartTiming();
+    for (int j = 0; j < count; j++) DoNotOptimize(zone->New(size));
+    bench->StopTiming();
+  }
+}
+
+
+BENCHMARK(ZoneAllocateSmall) {
+  ZoneAllocateLoop(bench, 2 * kPointerSize);
+}
+
+
+BENCHMARK(ZoneAllocateMedium) {
+  ZoneAllocateLoop(bench, 256);
+}
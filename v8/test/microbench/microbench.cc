@@ -0,0 +1,294 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <stdlib.h>
+
+#include "v8.h"
+
+#include "microbench.h"
+#include "platform.h"
+
+namespace i = v8::internal;
+
+
+MicroBenchmark* MicroBenchmark::last_ = NULL;
+
+
+MicroBenchmark::MicroBenchmark(BenchmarkFunction* callback, const char* file,
+                               const char* name)
+    : callback_(callback),
+      name_(name),
+      iterations_(0),
+      bytes_per_iteration_(0),
+      elapsed_(0),
+      start_(-1),
+      prev_(last_) {
+  // Use the base name of the file without its extension, like cctest.
+  const char* basename = strrchr(file, '/');
+  if (basename == NULL) basename = strrchr(file, '\\');
+  char* copy = i::StrDup(basename == NULL ? file : basename + 1);
+  char* extension = strrchr(copy, '.');
+  if (extension != NULL) *extension = 0;
+  file_ = copy;
+  last_ = this;
+}
+
+
+void MicroBenchmark::StartTiming() {
+  ASSERT(start_ < 0);
+  start_ = i::OS::Ticks();
+}
+
+
+void MicroBenchmark::StopTiming() {
+  ASSERT(start_ >= 0);
+  elapsed_ += i::OS::Ticks() - start_;
+  start_ = -1;
+}
+
+
+int64_t MicroBenchmark::RunOnce(int iterations) {
+  iterations_ = iterations;
+  elapsed_ = 0;
+  start_ = -1;
+  v8::HandleScope scope;
+  callback_(this);
+  if (start_ >= 0) StopTiming();
+  return elapsed_;
+}
+
+
+static int CompareDoubles(const double* a, const double* b) {
+  if (*a < *b) return -1;
+  if (*a > *b) return 1;
+  return 0;
+}
+
+
+double MicroBenchmark::Run(int min_time_ms, int repetitions) {
+  const int64_t min_time = static_cast<int64_t>(min_time_ms) * 1000;
+  const int kMaxIterations = 1 << 30;
+
+  // Grow the iteration count until one run is long enough for the timer
+  // resolution not to matter.
+  int iterations = 1;
+  int64_t elapsed = RunOnce(iterations);
+  while (elapsed < min_time && iterations < kMaxIterations) {
+    int64_t next = iterations * 10;
+    if (elapsed > 0) {
+      // Aim a little past the minimum, but grow by at most 10x per step.
+      int64_t estimate = (min_time * 5 / 4) * iterations / elapsed + 1;
+      if (estimate < next) next = estimate;
+    }
+    if (next <= iterations) next = iterations + 1;
+    if (next > kMaxIterations) next = kMaxIterations;
+    iterations = static_cast<int>(next);
+    elapsed = RunOnce(iterations);
+  }
+
+  i::List<double> samples(repetitions);
+  samples.Add(static_cast<double>(elapsed) * 1000 / iterations);
+  for (int r = 1; r < repetitions; r++) {
+    samples.Add(static_cast<double>(RunOnce(iterations)) * 1000 / iterations);
+  }
+  samples.Sort(CompareDoubles);
+  return samples[samples.length() / 2];
+}
+
+
+// Baseline results are stored one per line as "file/name ns_per_op".
+class BaselineEntry {
+ public:
+  BaselineEntry(char* key, double ns) : key_(key), ns_(ns) { }
+  char* key() const { return key_; }
+  double ns() const { return ns_; }
+ private:
+  char* key_;
+  double ns_;
+};
+
+
+static void ReadBaseline(const char* file_name, i::List<BaselineEntry>* out) {
+  FILE* file = i::OS::FOpen(file_name, "r");
+  if (file == NULL) {
+    fprintf(stderr, "Cannot open baseline file %s\n", file_name);
+    exit(1);
+  }
+  char key[256];
+  double ns;
+  while (fscanf(file, "%255s %lf", key, &ns) == 2) {
+    out->Add(BaselineEntry(i::StrDup(key), ns));
+  }
+  fclose(file);
+}
+
+
+static const BaselineEntry* FindBaseline(const i::List<BaselineEntry>& list,
+                                         const char* key) {
+  for (int j = 0; j < list.length(); j++) {
+    if (strcmp(list[j].key(), key) == 0) return &list[j];
+  }
+  return NULL;
+}
+
+
+static bool Matches(MicroBenchmark* bench, int argc, char* argv[]) {
+  bool any_filter = false;
+  for (int j = 1; j < argc; j++) {
+    const char* arg = argv[j];
+    if (arg[0] == '-') continue;
+    any_filter = true;
+    const char* slash = strchr(arg, '/');
+    if (slash != NULL) {
+      int file_length = static_cast<int>(slash - arg);
+      if (static_cast<int>(strlen(bench->file())) == file_length &&
+          strncmp(bench->file(), arg, file_length) == 0 &&
+          strcmp(bench->name(), slash + 1) == 0) {
+        return true;
+      }
+    } else if (strcmp(bench->file(), arg) == 0 ||
+               strcmp(bench->name(), arg) == 0) {
+      return true;
+    }
+  }
+  return !any_filter;
+}
+
+
+static void PrintBenchmarkList(MicroBenchmark* current) {
+  if (current == NULL) return;
+  PrintBenchmarkList(current->prev());
+  printf("%s/%s\n", current->file(), current->name());
+}
+
+
+static void CollectBenchmarks(MicroBenchmark* current,
+                              i::List<MicroBenchmark*>* out) {
+  if (current == NULL) return;
+  CollectBenchmarks(current->prev(), out);
+  out->Add(current);
+}
+
+
+static const char* kUsage =
+    "Usage: microbench [options] [file | name | file/name]...\n"
+    "  --list               list the available benchmarks\n"
+    "  --min-time=<ms>      minimum duration of a timed run (default 100)\n"
+    "  --repetitions=<n>    timed runs per benchmark, median wins (default 5)\n"
+    "  --output=<file>      write the results to <file>\n"
+    "  --baseline=<file>    compare against results written with --output\n"
+    "  --threshold=<pct>    slowdown reported as a regression (default 10)\n"
+    "Other arguments are passed to V8 as flags.\n";
+
+
+int main(int argc, char* argv[]) {
+  v8::internal::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+
+  int min_time_ms = 100;
+  int repetitions = 5;
+  double threshold = 10;
+  const char* output_file = NULL;
+  const char* baseline_file = NULL;
+  for (int j = 1; j < argc; j++) {
+    const char* arg = argv[j];
+    if (strcmp(arg, "--list") == 0) {
+      PrintBenchmarkList(MicroBenchmark::last());
+      return 0;
+    } else if (strncmp(arg, "--min-time=", 11) == 0) {
+      min_time_ms = atoi(arg + 11);
+    } else if (strncmp(arg, "--repetitions=", 14) == 0) {
+      repetitions = atoi(arg + 14);
+      if (repetitions < 1) repetitions = 1;
+    } else if (strncmp(arg, "--output=", 9) == 0) {
+      output_file = arg + 9;
+    } else if (strncmp(arg, "--baseline=", 11) == 0) {
+      baseline_file = arg + 11;
+    } else if (strncmp(arg, "--threshold=", 12) == 0) {
+      threshold = atof(arg + 12);
+    } else if (arg[0] == '-') {
+      fprintf(stderr, "Unknown option %s\n%s", arg, kUsage);
+      return 1;
+    }
+  }
+
+  i::List<BaselineEntry> baseline;
+  if (baseline_file != NULL) ReadBaseline(baseline_file, &baseline);
+
+  FILE* output = NULL;
+  if (output_file != NULL) {
+    output = i::OS::FOpen(output_file, "w");
+    if (output == NULL) {
+      fprintf(stderr, "Cannot open output file %s\n", output_file);
+      return 1;
+    }
+  }
+
+  i::List<MicroBenchmark*> benchmarks;
+  CollectBenchmarks(MicroBenchmark::last(), &benchmarks);
+
+  v8::V8::Initialize();
+  int regressions = 0;
+  {
+    v8::HandleScope scope;
+    v8::Persistent<v8::Context> context = v8::Context::New();
+    context->Enter();
+
+    for (int j = 0; j < benchmarks.length(); j++) {
+      MicroBenchmark* bench = benchmarks[j];
+      if (!Matches(bench, argc, argv)) continue;
+      i::EmbeddedVector<char, 256> key;
+      i::OS::SNPrintF(key, "%s/%s", bench->file(), bench->name());
+
+      double ns = bench->Run(min_time_ms, repetitions);
+      printf("%-40s %12.2f ns/op", key.start(), ns);
+      if (bench->bytes_per_iteration() > 0 && ns > 0) {
+        double mb_per_s = bench->bytes_per_iteration() * 1e3 / ns;
+        printf(" %10.2f MB/s", mb_per_s);
+      }
+      const BaselineEntry* entry = FindBaseline(baseline, key.start());
+      if (entry != NULL && entry->ns() > 0) {
+        double change = (ns - entry->ns()) * 100 / entry->ns();
+        bool regressed = change > threshold;
+        printf("  %+7.1f%%%s", change, regressed ? "  REGRESSION" : "");
+        if (regressed) regressions++;
+      }
+      printf("\n");
+      fflush(stdout);
+      if (output != NULL) fprintf(output, "%s %.3f\n", key.start(), ns);
+    }
+
+    context->Exit();
+    context.Dispose();
+  }
+  if (output != NULL) fclose(output);
+  if (regressions > 0) {
+    printf("%d benchmark(s) slower than the baseline by more than %.1f%%.\n",
+           regressions, threshold);
+  }
+  v8::V8::Dispose();
+  return regressions > 0 ? 1 : 0;
+}
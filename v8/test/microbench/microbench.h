@@ -0,0 +1,106 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef MICROBENCH_H_
+#define MICROBENCH_H_
+
+#include "v8.h"
+
+// Registers a benchmark.  The body is handed a MicroBenchmark and must run
+// the measured operation bench->iterations() times, bracketing the measured
+// part with StartTiming() and StopTiming():
+//
+//   BENCHMARK(Something) {
+//     ... untimed setup ...
+//     bench->StartTiming();
+//     for (int i = 0; i < bench->iterations(); i++) { ... }
+//     bench->StopTiming();
+//   }
+//
+// The body is called repeatedly with a growing iteration count until a run
+// takes at least --min-time milliseconds, so it must not depend on state
+// left behind by an earlier call.
+#ifndef BENCHMARK
+#define BENCHMARK(Name)                                                  \
+  static void Benchmark##Name(MicroBenchmark* bench);                    \
+  MicroBenchmark register_benchmark_##Name(Benchmark##Name, __FILE__,    \
+                                           #Name);                       \
+  static void Benchmark##Name(MicroBenchmark* bench)
+#endif
+
+class MicroBenchmark {
+ public:
+  typedef void (BenchmarkFunction)(MicroBenchmark* bench);
+  MicroBenchmark(BenchmarkFunction* callback, const char* file,
+                 const char* name);
+
+  // Runs the benchmark until the timing is stable and returns the median
+  // time per iteration in nanoseconds.
+  double Run(int min_time_ms, int repetitions);
+
+  int iterations() const { return iterations_; }
+
+  // Timing accumulates, so a benchmark may stop the clock around per
+  // iteration work that should not be measured.
+  void StartTiming();
+  void StopTiming();
+
+  // Lets throughput benchmarks report MB/s alongside ns/op.
+  void SetBytesPerIteration(int bytes) { bytes_per_iteration_ = bytes; }
+  int bytes_per_iteration() const { return bytes_per_iteration_; }
+
+  static MicroBenchmark* last() { return last_; }
+  MicroBenchmark* prev() { return prev_; }
+  const char* file() { return file_; }
+  const char* name() { return name_; }
+
+ private:
+  // Calls the benchmark once with the given iteration count and returns the
+  // timed microseconds.
+  int64_t RunOnce(int iterations);
+
+  BenchmarkFunction* callback_;
+  const char* file_;
+  const char* name_;
+  int iterations_;
+  int bytes_per_iteration_;
+  int64_t elapsed_;
+  int64_t start_;
+  static MicroBenchmark* last_;
+  MicroBenchmark* prev_;
+};
+
+
+// Keeps the compiler from discarding the result of a measured computation.
+template <typename T>
+inline void DoNotOptimize(T value) {
+  static volatile T sink;
+  sink = value;
+  v8::internal::USE(sink);
+}
+
+#endif  // ifndef MICROBENCH_H_
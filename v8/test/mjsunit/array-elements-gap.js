@@ -0,0 +1,64 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test that a store a little beyond the end of a large dense array keeps
+// the array in fast mode, while stores far beyond small arrays still turn
+// them into dictionaries.
+
+function HasFastElementsOfAnyKind(a) {
+  return %HasFastSmiOnlyElements(a) || %HasFastElements(a) ||
+         %HasFastDoubleElements(a);
+}
+
+var large = [];
+for (var i = 0; i < 20000; i++) large.push(i);
+assertTrue(HasFastElementsOfAnyKind(large));
+
+// The gap exceeds the absolute limit but is small relative to the array.
+large[22000] = 42;
+assertTrue(HasFastElementsOfAnyKind(large));
+assertEquals(22001, large.length);
+assertEquals(42, large[22000]);
+assertEquals(19999, large[19999]);
+assertEquals(undefined, large[21000]);
+
+// Same for double arrays.
+var doubles = [];
+for (var i = 0; i < 20000; i++) doubles.push(i + 0.5);
+doubles[22000] = 1.5;
+assertTrue(HasFastElementsOfAnyKind(doubles));
+assertEquals(1.5, doubles[22000]);
+assertEquals(19999.5, doubles[19999]);
+
+// A real outlier still normalizes a small array.
+var small = [1, 2, 3];
+small[100000] = 4;
+assertTrue(%HasDictionaryElements(small));
+assertEquals(100001, small.length);
+assertEquals(4, small[100000]);
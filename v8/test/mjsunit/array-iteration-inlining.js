@@ -0,0 +1,127 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Tests inlining of Array.prototype.forEach, map and filter, and of the
+// callbacks they call, into optimized code.
+
+var sum = 0;
+function add(x) { sum += x; }
+function twice(x) { return x * 2; }
+function isOdd(x) { return (x & 1) == 1; }
+
+function sumOf(a) {
+  sum = 0;
+  a.forEach(add);
+  return sum;
+}
+
+function doubled(a) {
+  return a.map(twice);
+}
+
+function odd(a) {
+  return a.filter(isOdd);
+}
+
+function test(a) {
+  assertEquals(15, sumOf(a));
+  assertEquals([2, 4, 6, 8, 10], doubled(a));
+  assertEquals([1, 3, 5], odd(a));
+}
+
+for (var i = 0; i < 3; i++) test([1, 2, 3, 4, 5]);
+%OptimizeFunctionOnNextCall(sumOf);
+%OptimizeFunctionOnNextCall(doubled);
+%OptimizeFunctionOnNextCall(odd);
+test([1, 2, 3, 4, 5]);
+
+// Other elements kinds and holes.
+assertEquals(7.5, sumOf([1.5, 2.5, 3.5]));
+assertEquals([2, 4, 6], doubled([1, 2, 3]));
+assertEquals(["x", "xx"], [1, 2].map(function(n) {
+  var s = ""; for (var i = 0; i < n; i++) s += "x"; return s;
+}));
+var holey = [1, , 3];
+assertEquals(4, sumOf(holey));
+var mapped = doubled(holey);
+assertEquals(3, mapped.length);
+assertFalse(1 in mapped);
+
+// Changing the callback deoptimizes.
+twice = function(x) { return x * 3; };
+assertEquals([3, 6, 9], doubled([1, 2, 3]));
+
+// Callbacks see the index, the array and the receiver.
+function collect(a) {
+  var seen = [];
+  a.forEach(function(x, i, array) {
+    seen.push(x + ":" + i + ":" + (array === a) + ":" + this.tag);
+  }, { tag: "t" });
+  return seen;
+}
+for (var i = 0; i < 3; i++) collect([7, 8]);
+%OptimizeFunctionOnNextCall(collect);
+assertEquals(["7:0:true:t", "8:1:true:t"], collect([7, 8]));
+
+// Callbacks that modify the array.
+function grow(x, i, array) {
+  if (array.length < 10) array.push(x);
+  return x;
+}
+function growing(a) { return a.map(grow); }
+for (var i = 0; i < 3; i++) growing([1, 2]);
+%OptimizeFunctionOnNextCall(growing);
+var a = [1, 2];
+assertEquals([1, 2], growing(a));
+assertEquals([1, 2, 1, 2], a);
+
+function shrink(x, i, array) { array.length = 1; }
+function shrinking(a) { var n = 0; a.forEach(shrink); return a; }
+for (var i = 0; i < 3; i++) shrinking([1, 2, 3]);
+%OptimizeFunctionOnNextCall(shrinking);
+assertEquals([1], shrinking([1, 2, 3]));
+
+// Exceptions thrown by the callback and by the builtins.
+function thrower(x) { if (x == 2) throw "stop"; }
+function throwing(a) {
+  try {
+    a.forEach(thrower);
+  } catch (e) {
+    return e;
+  }
+  return "done";
+}
+for (var i = 0; i < 3; i++) throwing([1]);
+%OptimizeFunctionOnNextCall(throwing);
+assertEquals("done", throwing([1]));
+assertEquals("stop", throwing([1, 2, 3]));
+assertThrows(function() { [1].forEach(1); }, TypeError);
+assertThrows(function() { [1].map(); }, TypeError);
+assertThrows(function() { Array.prototype.filter.call(null, add); },
+             TypeError);
@@ -106,3 +106,29 @@
   assertEquals(array[7], array_proto[7]);
   assertFalse(array.hasOwnProperty(7));
 })();
+
+// Use arrays as queues, around the size where a backing store would be
+// allocated in large object space.
+(function() {
+  var queue = [];
+  for (var i = 0; i < 132000; i++) queue.push(i);
+  for (var i = 0; i < 2000; i++) {
+    assertEquals(i, queue.shift());
+    queue.push(132000 + i);
+  }
+  assertEquals(132000, queue.length);
+  for (var i = 2000; i < 134000; i++) assertEquals(i, queue.shift());
+  assertEquals(0, queue.length);
+  assertEquals(undefined, queue.shift());
+})();
+
+(function() {
+  var queue = [];
+  for (var i = 0; i < 100000; i++) {
+    queue.push(i, i);
+    assertEquals(i >> 1, queue.shift());
+  }
+  assertEquals(100000, queue.length);
+  assertEquals(50000, queue[0]);
+  assertEquals(99999, queue[queue.length - 1]);
+})();
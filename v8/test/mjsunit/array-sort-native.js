@@ -0,0 +1,108 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Tests the native sort of packed smi, double and string arrays against
+// sorting with an explicit comparator, which uses the JavaScript sort.
+
+function defaultCompare(a, b) {
+  a = String(a);
+  b = String(b);
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+function check(array) {
+  var expected = array.slice().sort(defaultCompare);
+  var result = array.sort();
+  assertSame(array, result);
+  assertEquals(expected.length, result.length);
+  for (var i = 0; i < expected.length; i++) {
+    assertEquals(String(expected[i]), String(result[i]));
+  }
+}
+
+// Smis, both below and above the length at which radix sort is used.
+check([3, 1, 2]);
+check([10, 9, 1, 100, -1, -10, 0, -2, 2]);
+check([1073741823, -1073741824, 0, 7, 70, 700, 7000]);
+function randomSmis(length) {
+  var result = [];
+  for (var i = 0; i < length; i++) {
+    result.push(((Math.random() * 0x7fffffff) | 0) - 0x3fffffff);
+  }
+  return result;
+}
+check(randomSmis(100));
+check(randomSmis(1000));
+var sorted = [];
+for (var i = 0; i < 1000; i++) sorted.push(i);
+check(sorted);
+check(sorted.reverse());
+
+// Doubles.
+check([1.5, 0.25, -3.75, 10.5, 2.5]);
+check([NaN, Infinity, -Infinity, 1.5, 0.5, -0.5, 1e21, 1e-7, 2.5]);
+var doubles = [];
+for (var i = 0; i < 200; i++) doubles.push(Math.random() * 1000 - 500);
+check(doubles);
+var zeros = [0.5, -0, 0, 1.5];
+zeros.sort();
+assertEquals(-Infinity, 1 / zeros[0]);
+assertEquals(Infinity, 1 / zeros[1]);
+
+// Strings, including two byte and cons strings.
+check(["b", "a", "c", "ab", "", "aa"]);
+check(["ሴ", "z", "ÿ", "ሴa", "aሴ"]);
+var strings = [];
+for (var i = 0; i < 200; i++) {
+  strings.push("x" + Math.floor(Math.random() * 1000) + "y");
+}
+check(strings);
+
+// Copy on write literal arrays must not change the literal.
+function literal() { return [3, 2, 1]; }
+assertEquals([1, 2, 3], literal().sort());
+assertEquals([3, 2, 1], literal());
+function stringLiteral() { return ["c", "b", "a"]; }
+assertEquals(["a", "b", "c"], stringLiteral().sort());
+assertEquals(["c", "b", "a"], stringLiteral());
+
+// Arrays that are left to the JavaScript sort.
+check([3, "b", 1, "a", 2.5]);
+check([3, 2, undefined, 1]);
+var holey = [3, , 1];
+holey.sort();
+assertEquals([1, 3, undefined], holey);
+assertFalse(2 in holey);
+var withComparator = [1, 2, 3];
+withComparator.sort(function(a, b) { return b - a; });
+assertEquals([3, 2, 1], withComparator);
+var object = { length: 3, 0: "c", 1: "a", 2: "b" };
+Array.prototype.sort.call(object);
+assertEquals("a", object[0]);
+assertEquals("b", object[1]);
+assertEquals("c", object[2]);
+assertEquals(1, Array.prototype.sort.length);
@@ -0,0 +1,107 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --expose-gc --inline-construct
+
+// Test inline allocation of objects of constructors with simple bodies.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+  this.tag = "point";
+}
+
+function Empty() {
+}
+
+function make(a, b) {
+  return new Point(a, b);
+}
+
+function makeMissing(a) {
+  return new Point(a);
+}
+
+function makeObjects(o) {
+  return new Point(o, [o]);
+}
+
+function test() {
+  var p = make(1, 2);
+  assertEquals(1, p.x);
+  assertEquals(2, p.y);
+  assertEquals("point", p.tag);
+  assertTrue(p instanceof Point);
+  assertEquals(Point.prototype, Object.getPrototypeOf(p));
+
+  var d = make(1.5, -0.25);
+  assertEquals(1.5, d.x);
+  assertEquals(-0.25, d.y);
+
+  var m = makeMissing(3);
+  assertEquals(3, m.x);
+  assertEquals(undefined, m.y);
+  assertTrue("y" in m);
+
+  var o = {};
+  var q = makeObjects(o);
+  assertSame(o, q.x);
+  assertSame(o, q.y[0]);
+}
+
+// Let the runtime system install the specialized construct stub first.
+for (var i = 0; i < 5; i++) {
+  new Point(i, i);
+  new Empty();
+  test();
+}
+%OptimizeFunctionOnNextCall(make);
+%OptimizeFunctionOnNextCall(makeMissing);
+%OptimizeFunctionOnNextCall(makeObjects);
+test();
+
+// Objects survive garbage collections with their properties intact.
+var points = [];
+for (var i = 0; i < 10000; i++) points.push(makeObjects({ i: i }));
+gc();
+for (var i = 0; i < 10000; i++) {
+  assertEquals(i, points[i].x.i);
+  assertEquals(i, points[i].y[0].i);
+}
+
+// Replacing the prototype gives the constructor a new initial map.
+Point.prototype = { sum: function() { return this.x + this.y; } };
+var r = make(3, 4);
+assertEquals(7, r.sum());
+assertEquals(3, r.x);
+
+// Replacing the constructor falls back to a generic construct call.
+Point = function(x, y) { this.x = y; this.y = x; };
+r = make(3, 4);
+assertEquals(4, r.x);
+assertEquals(3, r.y);
+assertEquals(undefined, r.tag);
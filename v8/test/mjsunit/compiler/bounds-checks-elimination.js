@@ -0,0 +1,90 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test that eliminated, merged and hoisted array bounds checks still
+// deoptimize when an access actually goes out of bounds.
+
+function Sum(a) {
+  var s = 0;
+  for (var i = 0; i < a.length; i++) s += a[i];
+  return s;
+}
+
+function Reverse(a) {
+  var s = 0;
+  for (var i = a.length - 1; i >= 0; i--) s += a[i];
+  return s;
+}
+
+function Window(a) {
+  var s = 0;
+  for (var i = 1; i < a.length - 1; i++) s += a[i - 1] + a[i] + a[i + 1];
+  return s;
+}
+
+function UpTo(a, n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) s += a[i];
+  return s;
+}
+
+function Neighbours(a, i) {
+  return a[i] + a[i + 1] + a[i + 2] + a[i + 3] + a[i - 1];
+}
+
+var a = [];
+for (var k = 0; k < 100; k++) a.push(k);
+
+for (var k = 0; k < 5; k++) {
+  Sum(a);
+  Reverse(a);
+  Window(a);
+  UpTo(a, 50);
+}
+%OptimizeFunctionOnNextCall(Sum);
+%OptimizeFunctionOnNextCall(Reverse);
+%OptimizeFunctionOnNextCall(Window);
+%OptimizeFunctionOnNextCall(UpTo);
+assertEquals(4950, Sum(a));
+assertEquals(4950, Reverse(a));
+assertEquals(14553, Window(a));
+assertEquals(1225, UpTo(a, 50));
+assertEquals(4950, UpTo(a, 100));
+assertEquals(0, UpTo(a, 0));
+assertEquals(NaN, UpTo(a, 101));
+assertEquals(1770, UpTo(a, 60));
+
+var b = [1, 2, 3, 4, 5, 6, 7, 8];
+for (var k = 0; k < 5; k++) Neighbours(b, 1);
+%OptimizeFunctionOnNextCall(Neighbours);
+assertEquals(15, Neighbours(b, 1));
+assertEquals(20, Neighbours(b, 2));
+assertEquals(30, Neighbours(b, 4));
+assertEquals(NaN, Neighbours(b, 5));
+assertEquals(NaN, Neighbours(b, 0));
@@ -0,0 +1,67 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test direct calls to known functions with an argument count that
+// differs from the number of formal parameters.  The callees contain
+// try-catch so that they are called rather than inlined.
+
+function sum3(a, b, c) {
+  try { return [a, b, c]; } catch (e) { }
+}
+
+function count() {
+  try { return arguments.length; } catch (e) { }
+}
+
+var o = { sum3: sum3 };
+
+var log = [];
+function effect(x) { log.push(x); return x; }
+
+function few() { return sum3(1, 2); }
+function many() { return sum3(1, 2, 3, effect(4), effect(5)); }
+function method_few(x) { return o.sum3(x); }
+function counted() { return count(1, 2) + count(); }
+
+function test() {
+  assertEquals([1, 2, undefined], few());
+  log = [];
+  assertEquals([1, 2, 3], many());
+  assertEquals([4, 5], log);
+  assertEquals([7, undefined, undefined], method_few(7));
+  assertEquals(2, counted());
+}
+
+for (var i = 0; i < 5; i++) test();
+%OptimizeFunctionOnNextCall(few);
+%OptimizeFunctionOnNextCall(many);
+%OptimizeFunctionOnNextCall(method_few);
+%OptimizeFunctionOnNextCall(counted);
+test();
+test();
@@ -0,0 +1,92 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --check-elimination
+
+// Map checks implied by dominating checks and transitions are removed.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+function sum(p) {
+  var result = p.x;
+  result += p.y;
+  if (result > 100) result -= p.x;
+  return result + p.y;
+}
+
+for (var i = 0; i < 5; i++) assertEquals(5, sum(new Point(1, 2)));
+%OptimizeFunctionOnNextCall(sum);
+assertEquals(5, sum(new Point(1, 2)));
+assertEquals(200, sum(new Point(100, 100)));
+var other = { y: 2, x: 1 };
+assertEquals(5, sum(other));
+
+
+// A transition changes the map of every object that is the stored object.
+function store_twice(a, b) {
+  a.first = 1;
+  b.second = 2;
+  return a.second;
+}
+
+for (var i = 0; i < 5; i++) store_twice({}, {});
+%OptimizeFunctionOnNextCall(store_twice);
+assertEquals(undefined, store_twice({}, {}));
+var same = {};
+assertEquals(2, store_twice(same, same));
+assertEquals(1, same.first);
+
+
+// A call in between can change the map.
+function add_property(o) { o.z = 3; }
+function around_call(p) {
+  var a = p.x;
+  add_property(p);
+  return a + p.x + p.z;
+}
+
+for (var i = 0; i < 5; i++) assertEquals(5, around_call(new Point(1, 2)));
+%OptimizeFunctionOnNextCall(around_call);
+assertEquals(5, around_call(new Point(1, 2)));
+
+
+// Transitions inside a loop.
+function grow(o, n) {
+  var total = 0;
+  for (var i = 0; i < n; i++) {
+    total += o.x;
+    if (i == 1) o.extra = 1;
+  }
+  return total;
+}
+
+for (var i = 0; i < 5; i++) assertEquals(3, grow(new Point(1, 2), 3));
+%OptimizeFunctionOnNextCall(grow);
+assertEquals(3, grow(new Point(1, 2), 3));
@@ -0,0 +1,99 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --constant-global-cells
+
+// Optimized code embeds the values of global properties that are not
+// written.  Writing one of them deoptimizes that code.
+
+var CONSTANT = 10;
+function Klass() { this.x = CONSTANT; }
+function get() { return CONSTANT + new Klass().x; }
+
+for (var i = 0; i < 5; i++) assertEquals(20, get());
+%OptimizeFunctionOnNextCall(get);
+assertEquals(20, get());
+CONSTANT = 11;
+assertEquals(22, get());
+%OptimizeFunctionOnNextCall(get);
+assertEquals(22, get());
+CONSTANT = 12;
+assertEquals(24, get());
+
+
+// A write from a function called by the optimized code.
+var limit = 3;
+function bump() { limit = 100; }
+function loop() {
+  var n = 0;
+  for (var i = 0; i < limit; i++) {
+    n++;
+    if (n == 2) bump();
+  }
+  return n;
+}
+
+for (var i = 0; i < 3; i++) { limit = 3; loop(); }
+limit = 3;
+%OptimizeFunctionOnNextCall(loop);
+assertEquals(100, loop());
+
+
+// Reads and writes of the same property in optimized code.
+var counter = 0;
+function count() {
+  for (var i = 0; i < 10; i++) counter = counter + 1;
+  return counter;
+}
+
+count();
+count();
+%OptimizeFunctionOnNextCall(count);
+assertEquals(30, count());
+assertEquals(40, count());
+
+
+// A global function called from optimized code and replaced later.
+function callee() { return 1; }
+function caller() { return callee(); }
+
+for (var i = 0; i < 5; i++) assertEquals(1, caller());
+%OptimizeFunctionOnNextCall(caller);
+assertEquals(1, caller());
+callee = function() { return 2; };
+assertEquals(2, caller());
+
+
+// Deleting a property.
+this.deletable = 5;
+function read_deletable() { return typeof deletable; }
+
+for (var i = 0; i < 5; i++) assertEquals("number", read_deletable());
+%OptimizeFunctionOnNextCall(read_deletable);
+assertEquals("number", read_deletable());
+delete this.deletable;
+assertEquals("undefined", read_deletable());
@@ -0,0 +1,54 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --count-based-interrupts
+// Flags: --interrupt-budget=100 --noweighted-back-edges
+
+// With an unweighted budget of 100, every 101st return or back edge of a
+// function ticks the profiler, and the second tick marks the function for
+// optimization.  So the optimization points depend only on how often the
+// code ran.
+
+function add(a, b) {
+  return a + b;
+}
+
+for (var i = 0; i < 150; i++) add(i, 1);
+assertTrue(%GetOptimizationStatus(add) != 1);
+for (var i = 0; i < 150; i++) add(i, 1);
+assertTrue(%GetOptimizationStatus(add) != 2);
+
+// A function that only loops uses up its budget at the back edge and is
+// replaced on the stack.
+function loop(n) {
+  var sum = 0;
+  for (var i = 0; i < n; i++) sum += i;
+  return sum;
+}
+
+assertEquals(499500, loop(1000));
+assertTrue(%GetOptimizationStatus(loop) != 2);
@@ -0,0 +1,101 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --dead-code-elimination --sink-instructions
+
+// Unused pure values are removed and values used on only one side of a
+// branch are computed there.
+
+function Unused(a, b) {
+  var x = a * b;
+  var y = a + b;
+  return y;
+}
+
+assertEquals(5, Unused(2, 3));
+assertEquals(5, Unused(2, 3));
+%OptimizeFunctionOnNextCall(Unused);
+assertEquals(5, Unused(2, 3));
+assertEquals(0x7fffffff + 1, Unused(0x7fffffff, 1));
+
+function Sink(a, b, c) {
+  var x = (a * b) | 0;
+  var y = x + 1;
+  if (c) return y;
+  return a;
+}
+
+assertEquals(7, Sink(2, 3, true));
+assertEquals(2, Sink(2, 3, false));
+%OptimizeFunctionOnNextCall(Sink);
+assertEquals(7, Sink(2, 3, true));
+assertEquals(2, Sink(2, 3, false));
+// Overflow deoptimizes in the branch the addition was moved to.
+assertEquals(0x7fffffff + 1, Sink(0x7fffffff, 1, true));
+assertEquals(0x7fffffff, Sink(0x7fffffff, 1, false));
+
+function SinkBothUses(a, b, c) {
+  var x = a - b;
+  if (c) {
+    if (a > b) return x;
+    return -x;
+  }
+  return 0;
+}
+
+assertEquals(1, SinkBothUses(3, 2, true));
+assertEquals(1, SinkBothUses(2, 3, true));
+assertEquals(0, SinkBothUses(2, 3, false));
+%OptimizeFunctionOnNextCall(SinkBothUses);
+assertEquals(1, SinkBothUses(3, 2, true));
+assertEquals(1, SinkBothUses(2, 3, true));
+assertEquals(0, SinkBothUses(2, 3, false));
+
+function NoSinkIntoLoop(a, n) {
+  var x = a * 2;
+  var sum = 0;
+  for (var i = 0; i < n; i++) sum += x;
+  return sum;
+}
+
+assertEquals(12, NoSinkIntoLoop(2, 3));
+assertEquals(12, NoSinkIntoLoop(2, 3));
+%OptimizeFunctionOnNextCall(NoSinkIntoLoop);
+assertEquals(12, NoSinkIntoLoop(2, 3));
+assertEquals(0, NoSinkIntoLoop(2, 0));
+
+function DeoptWithUnusedValue(a, o) {
+  var x = a + 1;
+  var y = o.y;
+  return x;
+}
+
+assertEquals(2, DeoptWithUnusedValue(1, {y: 1}));
+assertEquals(2, DeoptWithUnusedValue(1, {y: 1}));
+%OptimizeFunctionOnNextCall(DeoptWithUnusedValue);
+assertEquals(2, DeoptWithUnusedValue(1, {y: 1}));
+assertEquals(2, DeoptWithUnusedValue(1, {z: 0, y: 1}));
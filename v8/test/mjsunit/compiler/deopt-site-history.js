@@ -0,0 +1,69 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax
+
+// Some checks in optimized code fail without changing the type feedback
+// collected by unoptimized code, so recompiling with the same feedback
+// would deoptimize at the same site again.  After a few deoptimizations
+// such sites use generic operations and the function stays optimized.
+
+function Optimize(f, good, bad) {
+  for (var round = 0; round < 4; round++) {
+    good();
+    good();
+    %OptimizeFunctionOnNextCall(f);
+    good();
+    bad();
+  }
+  assertTrue(%GetOptimizationStatus(f) != 2);
+}
+
+
+// Bounds check of an inlined String.prototype.charCodeAt.
+function CharCodeAt(s, i) {
+  return s.charCodeAt(i);
+}
+
+Optimize(CharCodeAt,
+         function() { assertEquals(98, CharCodeAt("abc", 1)); },
+         function() { assertTrue(isNaN(CharCodeAt("abc", 7))); });
+assertEquals(99, CharCodeAt("abc", 2));
+assertTrue(isNaN(CharCodeAt("abc", -1)));
+
+
+// Unsigned shift with a result outside the int32 range.
+function ShiftRightLogical(x) {
+  return x >>> 0;
+}
+
+Optimize(ShiftRightLogical,
+         function() { assertEquals(5, ShiftRightLogical(5)); },
+         function() { assertEquals(4294967295, ShiftRightLogical(-1)); });
+assertEquals(4294967294, ShiftRightLogical(-2));
+assertEquals(7, ShiftRightLogical(7));
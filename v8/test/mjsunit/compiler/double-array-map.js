@@ -0,0 +1,139 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax --smi-only-arrays
+
+// Element-wise loops over double arrays are partly run two elements at a
+// time.  Check that the elements left to the loop itself (odd lengths,
+// holes, NaN results, non-double arrays) still get the right values.
+
+function DoubleArray(length, offset) {
+  var result = [0.5];
+  for (var i = 0; i < length; i++) result[i] = i + offset;
+  assertTrue(%HasFastDoubleElements(result));
+  return result;
+}
+
+function Add(dst, a, b, n) {
+  for (var i = 0; i < n; i++) dst[i] = a[i] + b[i];
+}
+
+function Scale(dst, a, s) {
+  for (var i = 0; i < a.length; i++) {
+    dst[i] = a[i] * s;
+  }
+}
+
+function Invert(dst, a) {
+  for (var i = 0; i < dst.length; i++) dst[i] = 1 / a[i];
+}
+
+function Subtract(dst, a, b, n) {
+  for (var i = 1; i < n; i++) dst[i] = a[i] - b[i];
+}
+
+function Optimize(f, args) {
+  f.apply(null, args);
+  f.apply(null, args);
+  %OptimizeFunctionOnNextCall(f);
+  f.apply(null, args);
+}
+
+Optimize(Add, [DoubleArray(4, 0), DoubleArray(4, 0.5), DoubleArray(4, 1), 4]);
+Optimize(Scale, [DoubleArray(4, 0), DoubleArray(4, 0.5), 2]);
+Optimize(Invert, [DoubleArray(4, 0), DoubleArray(4, 0.5)]);
+Optimize(Subtract,
+         [DoubleArray(4, 0), DoubleArray(4, 0.5), DoubleArray(4, 1), 4]);
+
+// Odd lengths and limits below the array lengths.
+var a = DoubleArray(7, 0.25);
+var b = DoubleArray(7, 1);
+var dst = DoubleArray(7, 0);
+Add(dst, a, b, 7);
+for (var i = 0; i < 7; i++) assertEquals(2 * i + 1.25, dst[i]);
+dst = DoubleArray(7, 0);
+Add(dst, a, b, 4);
+for (var i = 0; i < 7; i++) assertEquals(i < 4 ? 2 * i + 1.25 : i, dst[i]);
+
+// The limit is clamped to the shortest array, the loop does the rest.
+dst = DoubleArray(3, 0);
+Add(dst, a, b, 5);
+assertEquals([1.25, 3.25, 5.25, 7.25, 9.25], dst);
+dst = DoubleArray(7, 0);
+Add(dst, a, DoubleArray(2, 1), 4);
+assertEquals([1.25, 3.25, NaN, NaN, 4, 5, 6], dst);
+
+// Scalars on either side, including heap numbers.
+dst = DoubleArray(5, 0);
+Scale(dst, DoubleArray(5, 1), 0.5);
+assertEquals([0.5, 1, 1.5, 2, 2.5], dst);
+Invert(dst, DoubleArray(5, 1));
+assertEquals([1, 1 / 2, 1 / 3, 1 / 4, 1 / 5], dst);
+dst = DoubleArray(5, 0);
+Scale(dst, DoubleArray(5, 1), -0);
+assertEquals(-Infinity, 1 / dst[4]);
+
+// Holes and NaN results stop the kernel but not the loop.
+a = DoubleArray(8, 0.5);
+delete a[3];
+dst = DoubleArray(8, 0);
+Scale(dst, a, 2);
+assertEquals([1, 3, 5, NaN, 9, 11, 13, 15], dst);
+a = DoubleArray(6, 0.5);
+a[2] = NaN;
+dst = DoubleArray(6, 0);
+Scale(dst, a, 4);
+assertEquals([2, 6, NaN, 14, 18, 22], dst);
+
+// The target can be one of the operands.
+a = DoubleArray(9, 1);
+Scale(a, a, 3);
+assertEquals([3, 6, 9, 12, 15, 18, 21, 24, 27], a);
+a = DoubleArray(5, 1);
+Add(a, a, a, 5);
+assertEquals([2, 4, 6, 8, 10], a);
+
+// A start index that is not zero.
+a = DoubleArray(6, 1);
+dst = DoubleArray(6, 0);
+Subtract(dst, a, DoubleArray(6, 0.5), 6);
+assertEquals([0, 0.5, 0.5, 0.5, 0.5, 0.5], dst);
+
+// Arrays without double elements and non-number scalars.
+dst = DoubleArray(4, 0);
+Scale(dst, [1, 2, 3, 4], 2);
+assertEquals([2, 4, 6, 8], dst);
+var objects = [1, "2", {}, 4.5];
+Scale(dst, objects, 2);
+assertEquals([2, 4, NaN, 9], dst);
+dst = DoubleArray(4, 0);
+Scale(dst, DoubleArray(4, 1), "3");
+assertEquals([3, 6, 9, 12], dst);
+dst = DoubleArray(4, 0);
+Add(dst, DoubleArray(4, 1), DoubleArray(4, 1), 2.5);
+assertEquals([2, 4, 6, 3], dst);
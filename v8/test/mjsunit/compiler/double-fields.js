@@ -0,0 +1,102 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Flags: --allow-natives-syntax --unbox-double-fields
+
+// Double properties live in mutable heap numbers owned by the object.
+// Loads must never hand them out.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+function getX(p) { return p.x; }
+function setX(p, x) { p.x = x; }
+
+function test() {
+  var p = new Point(1.5, 2.5);
+  var q = new Point(3.5, 4.5);
+  var x = getX(p);
+  setX(p, 7.25);
+  assertEquals(1.5, x);
+  assertEquals(7.25, getX(p));
+  assertEquals(3.5, getX(q));
+  setX(p, 3);
+  assertEquals(3, p.x);
+  var y = p["y"];
+  p.y = 0.5;
+  assertEquals(2.5, y);
+  assertEquals(0.5, p["y"]);
+}
+
+for (var i = 0; i < 5; i++) test();
+%OptimizeFunctionOnNextCall(getX);
+%OptimizeFunctionOnNextCall(setX);
+test();
+test();
+
+// Prototype chain loads copy the number as well.
+var proto = new Point(0.5, 0.25);
+function Derived() {}
+Derived.prototype = proto;
+function getProtoX(o) { return o.x; }
+var d = new Derived();
+for (var i = 0; i < 5; i++) {
+  var v = getProtoX(d);
+  proto.x = i + 0.5;
+  assertEquals(i === 0 ? 0.5 : i - 0.5, v);
+}
+
+// Storing something other than a number generalizes the field.
+var p = new Point(1.5, 2.5);
+var saved = getX(p);
+setX(p, "string");
+assertEquals("string", getX(p));
+assertEquals(1.5, saved);
+setX(p, 8.5);
+assertEquals(8.5, getX(p));
+assertEquals(2.5, new Point(2.5, 0).x);
+var u = new Point(1.5, 2.5);
+setX(u, undefined);
+assertEquals(undefined, getX(u));
+
+// Copies and normalized objects get their own numbers.
+var original = new Point(1.5, 2.5);
+var json = JSON.stringify(original);
+assertEquals('{"x":1.5,"y":2.5}', json);
+delete original.y;
+var x = original.x;
+original.x = 6.5;
+assertEquals(1.5, x);
+assertEquals(6.5, original.x);
+
+function literal() { return {a: 1.5, b: 2.5}; }
+var l1 = literal();
+var l2 = literal();
+l1.a = 9.5;
+assertEquals(1.5, l2.a);
+assertEquals(1.5, literal().a);
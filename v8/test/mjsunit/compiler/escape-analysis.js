@@ -0,0 +1,122 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --expose-gc
+
+// Test that object literals replaced by their fields are rebuilt with
+// the right field values when the optimized code deoptimizes.
+
+function Length(p) {
+  return Math.sqrt(p.x * p.x + p.y * p.y);
+}
+
+function Add(a, b) {
+  return { x: a.x + b.x, y: a.y + b.y };
+}
+
+function AddLength(x, y) {
+  var p = { x: x, y: y };
+  var q = { x: 1, y: 2 };
+  return Length(Add(p, q));
+}
+
+for (var i = 0; i < 5; i++) AddLength(2, 2);
+%OptimizeFunctionOnNextCall(AddLength);
+assertEquals(5, AddLength(2, 2));
+assertEquals(5, AddLength(2, 2));
+// Doubles deoptimize the code that expects small integers.
+assertEquals(2.5, AddLength(0.5, 0));
+
+
+var deopt = false;
+
+// Not inlined because of the try statement.
+function Deopt() {
+  try {
+    if (deopt) {
+      %DeoptimizeFunction(Materialize);
+      gc();
+      return 1;
+    }
+  } catch (e) { }
+  return 0;
+}
+
+function Materialize(a, b) {
+  var p = { x: a, y: b, z: 0 };
+  p.z = p.x + p.y;
+  // The lazy deoptimization environment of the call refers to p.
+  var d = Deopt();
+  return p.x + p.y + p.z + d;
+}
+
+for (var i = 0; i < 5; i++) Materialize(1, 2);
+%OptimizeFunctionOnNextCall(Materialize);
+assertEquals(6, Materialize(1, 2));
+deopt = true;
+assertEquals(7, Materialize(1, 2));
+deopt = false;
+for (var i = 0; i < 5; i++) Materialize(1, 2);
+%OptimizeFunctionOnNextCall(Materialize);
+assertEquals(6, Materialize(1, 2));
+// Doubles deoptimize eagerly after the object is allocated.
+assertEquals(6, Materialize(1.5, 1.5));
+
+
+// The object has to be rebuilt when it is the argument of an inlined
+// function that reads its own arguments.
+function Inner(p) {
+  return Arguments().x;
+}
+
+function Arguments() {
+  return Inner.arguments[0];
+}
+
+function Outer(a) {
+  return Inner({ x: a });
+}
+
+for (var i = 0; i < 5; i++) Outer(1);
+%OptimizeFunctionOnNextCall(Outer);
+assertEquals(1, Outer(1));
+assertEquals("a", Outer("a"));
+
+
+// Objects that escape are not replaced.
+var escaped;
+
+function Escape(a) {
+  var p = { x: a };
+  escaped = p;
+  return p.x;
+}
+
+for (var i = 0; i < 5; i++) Escape(1);
+%OptimizeFunctionOnNextCall(Escape);
+assertEquals(3, Escape(3));
+assertEquals(3, escaped.x);
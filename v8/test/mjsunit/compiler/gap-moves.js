@@ -0,0 +1,77 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --optimize-gap-moves
+
+// Register pressure and calls force values into spill slots and back.
+
+function Spill(a, b, c, d, e, f, g, h) {
+  var s0 = a + b, s1 = b + c, s2 = c + d, s3 = d + e;
+  var s4 = e + f, s5 = f + g, s6 = g + h, s7 = h + a;
+  var x = Math.floor(s0 / 2);
+  return [s0, s1, s2, s3, s4, s5, s6, s7, x].join();
+}
+
+var expected = "3,5,7,9,11,13,15,9,1";
+assertEquals(expected, Spill(1, 2, 3, 4, 5, 6, 7, 8));
+assertEquals(expected, Spill(1, 2, 3, 4, 5, 6, 7, 8));
+%OptimizeFunctionOnNextCall(Spill);
+assertEquals(expected, Spill(1, 2, 3, 4, 5, 6, 7, 8));
+
+// Loop phis that swap values need cyclic moves at the back edge.
+function Swap(n) {
+  var a = 1, b = 2, c = 3;
+  for (var i = 0; i < n; i++) {
+    var t = a;
+    a = b;
+    b = c;
+    c = t;
+  }
+  return a * 100 + b * 10 + c;
+}
+
+assertEquals(231, Swap(1));
+assertEquals(312, Swap(2));
+%OptimizeFunctionOnNextCall(Swap);
+assertEquals(123, Swap(3));
+assertEquals(231, Swap(4));
+
+function Doubles(n) {
+  var x = 0.5, y = 1.5, z = 2.5;
+  for (var i = 0; i < n; i++) {
+    var t = x + String(i).length;
+    x = y;
+    y = z;
+    z = t;
+  }
+  return x + y + z;
+}
+
+assertEquals(4.5 + 3, Doubles(3));
+%OptimizeFunctionOnNextCall(Doubles);
+assertEquals(4.5 + 3, Doubles(3));
+assertEquals(4.5 + 10, Doubles(10));
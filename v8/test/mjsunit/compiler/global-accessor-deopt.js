@@ -0,0 +1,66 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax
+
+// Turning a global property into an accessor deoptimizes the optimized
+// code that accesses its property cell, and only that code.
+
+x = 1;
+y = 2;
+
+function LoadX() { return x; }
+function StoreX(value) { x = value; }
+function LoadY() { return y; }
+
+function Optimize(f, arg) {
+  f(arg);
+  f(arg);
+  %OptimizeFunctionOnNextCall(f);
+  f(arg);
+}
+
+Optimize(LoadX);
+Optimize(StoreX, 1);
+Optimize(LoadY);
+assertEquals(1, LoadX());
+assertEquals(2, LoadY());
+
+var stored;
+this.__defineGetter__("x", function() { return 42; });
+this.__defineSetter__("x", function(value) { stored = value; });
+
+assertTrue(%GetOptimizationStatus(LoadX) != 1);
+assertTrue(%GetOptimizationStatus(StoreX) != 1);
+assertTrue(%GetOptimizationStatus(LoadY) != 2);
+
+assertEquals(42, LoadX());
+StoreX(7);
+assertEquals(7, stored);
+assertEquals(42, x);
+assertEquals(2, LoadY());
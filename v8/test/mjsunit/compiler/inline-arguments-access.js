@@ -0,0 +1,128 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test functions that use the arguments object when they are inlined and
+// when the arguments object escapes.
+
+// Inlined uses of arguments.length and of arguments[i] with a variable
+// index, with fewer and more arguments than parameters.
+function sum() {
+  var result = 0;
+  for (var i = 0; i < arguments.length; i++) result += arguments[i];
+  return result;
+}
+
+function strictSecond(a, b) {
+  "use strict";
+  return arguments[1];
+}
+
+function callSum(x) {
+  return sum(x, x + 1, x + 2) + sum() + strictSecond(x) + strictSecond(x, x);
+}
+
+for (var i = 0; i < 5; ++i) assertEquals(NaN, callSum(1));
+%OptimizeFunctionOnNextCall(callSum);
+assertEquals(NaN, callSum(1));
+
+function callSumOnly(x) { return sum(x, x, x) + strictSecond(x, 2 * x); }
+
+for (var i = 0; i < 5; ++i) callSumOnly(1);
+%OptimizeFunctionOnNextCall(callSumOnly);
+assertEquals(5, callSumOnly(1));
+assertEquals(10, callSumOnly(2));
+
+// An argument index out of range.
+function outOfRange(i) { "use strict"; return arguments[i + 1]; }
+function callOutOfRange(i) { return outOfRange(i, 7); }
+
+for (var i = 0; i < 5; ++i) callOutOfRange(0);
+%OptimizeFunctionOnNextCall(callOutOfRange);
+assertEquals(7, callOutOfRange(0));
+assertEquals(undefined, callOutOfRange(1));
+
+// A deoptimization inside the inlined function materializes its arguments
+// object.
+function deoptInside() {
+  var first = arguments[0];
+  first.value++;
+  return arguments;
+}
+
+function leaky(o) { return deoptInside(o, 2).length; }
+
+// The arguments object escapes from deoptInside, so it is not inlined.
+for (var i = 0; i < 5; ++i) leaky({ value: 1 });
+%OptimizeFunctionOnNextCall(leaky);
+assertEquals(2, leaky({ value: 1 }));
+
+function second() {
+  var value = arguments[0].value;
+  return arguments[1] + value;
+}
+
+function callSecond(o) { return second(o, 10); }
+
+for (var i = 0; i < 5; ++i) callSecond({ value: 1 });
+%OptimizeFunctionOnNextCall(callSecond);
+assertEquals(11, callSecond({ value: 1 }));
+// A different map deoptimizes inside the inlined function.
+assertEquals(12, callSecond({ other: 0, value: 2 }));
+
+// Inlined Function.prototype.apply forwarding the arguments.
+function add(a, b) { return a + b; }
+function forward() { return add.apply(this, arguments); }
+function callForward(x) { return forward(x, 3) + forward(x, x, 5); }
+
+for (var i = 0; i < 5; ++i) callForward(1);
+%OptimizeFunctionOnNextCall(callForward);
+assertEquals(6, callForward(1));
+assertEquals(9, callForward(2));
+
+// The arguments object escaping from an optimized function.
+function escapes() { return arguments; }
+function escapesStrict(a) { "use strict"; a = 0; return arguments; }
+function passes() { return sum.apply(null, [].slice.call(arguments)); }
+
+for (var i = 0; i < 5; ++i) {
+  escapes(1, 2);
+  escapesStrict(1, 2);
+  passes(1, 2);
+}
+%OptimizeFunctionOnNextCall(escapes);
+%OptimizeFunctionOnNextCall(escapesStrict);
+%OptimizeFunctionOnNextCall(passes);
+var args = escapes(1, 2);
+assertEquals(2, args.length);
+assertEquals(2, args[1]);
+assertSame(escapes, args.callee);
+args = escapesStrict(3, 4);
+assertEquals(2, args.length);
+assertEquals(3, args[0]);
+assertEquals(6, passes(1, 2, 3));
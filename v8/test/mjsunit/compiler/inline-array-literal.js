@@ -0,0 +1,80 @@
+// Copyright 2008 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Small array literals are copied inline with their elements by optimized
+// code.  Check that the copies are independent, and that the code copes
+// with the boilerplate changing its elements kind.
+
+function pair(a, b) {
+  return [a, b, 3];
+}
+
+function check_pair(a, b) {
+  var p = pair(a, b);
+  assertEquals(3, p.length);
+  assertEquals(a, p[0]);
+  assertEquals(b, p[1]);
+  assertEquals(3, p[2]);
+  return p;
+}
+
+check_pair(1, 2);
+check_pair(3, 4);
+%OptimizeFunctionOnNextCall(pair);
+var p1 = check_pair(5, 6);
+var p2 = check_pair(7, 8);
+p1[0] = 100;
+p1.push(9);
+assertEquals(7, p2[0]);
+assertEquals(3, p2.length);
+assertEquals(4, p1.length);
+
+// Doubles and objects change the elements kind of the boilerplate.
+check_pair(1.5, 2);
+check_pair("a", {});
+%OptimizeFunctionOnNextCall(pair);
+check_pair(1, 2);
+check_pair("b", 2.5);
+
+function doubles() {
+  return [1.5, 2.5];
+}
+
+for (var i = 0; i < 3; i++) {
+  if (i == 2) %OptimizeFunctionOnNextCall(doubles);
+  var d = doubles();
+  assertEquals(1.5, d[0]);
+  assertEquals(2.5, d[1]);
+  d[0] = 0;
+}
+var d1 = doubles();
+var d2 = doubles();
+d1[1] = "x";
+assertEquals(2.5, d2[1]);
+assertEquals("x", d1[1]);
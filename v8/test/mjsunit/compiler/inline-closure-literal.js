@@ -0,0 +1,78 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax
+
+// A closure created by the optimized function and passed to an inlined
+// function can be inlined where that function calls it.  Check that the
+// inlined closure uses the context it is created in, and that its frame
+// gets the right function when it deoptimizes.
+
+function Each(array, f) {
+  var result = 0;
+  for (var i = 0; i < array.length; i++) result += f(array[i]);
+  return result;
+}
+
+function SumScaled(array, scale) {
+  var calls = 0;
+  var sum = Each(array, function(x) {
+    calls++;
+    return x * scale;
+  });
+  return [sum, calls];
+}
+
+var array = [1, 2, 3];
+assertEquals([12, 3], SumScaled(array, 2));
+assertEquals([12, 3], SumScaled(array, 2));
+%OptimizeFunctionOnNextCall(SumScaled);
+assertEquals([18, 3], SumScaled(array, 3));
+
+// Deoptimize in the inlined closure.
+assertEquals([0.5 + 1 + 1.5, 3], SumScaled(array, 0.5));
+assertEquals([12, 3], SumScaled(array, "2"));
+
+// Deoptimize the whole function from the inlined closure.
+function Call(f) {
+  return f();
+}
+
+function CallClosure(deopt) {
+  var value = 1;
+  return Call(function() {
+    if (deopt) %DeoptimizeFunction(CallClosure);
+    return value + 1;
+  });
+}
+
+assertEquals(2, CallClosure(false));
+assertEquals(2, CallClosure(false));
+%OptimizeFunctionOnNextCall(CallClosure);
+assertEquals(2, CallClosure(false));
+assertEquals(2, CallClosure(true));
@@ -0,0 +1,92 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --load-elimination
+
+// Stored field values are forwarded to loads, and field loads and stores
+// are only removed when no other write can intervene.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+function forward(p, v) {
+  p.x = v;
+  p.y = 1;
+  return p.x + p.y;
+}
+
+function overwrite(p) {
+  p.x = 1;
+  p.x = 2;
+  return p.x;
+}
+
+function alias(p, q) {
+  var before = p.x;
+  q.x = 10;
+  return before + p.x;
+}
+
+function call(p, f) {
+  var before = p.x;
+  f(p);
+  return before + p.x;
+}
+
+function loop(p, n) {
+  var result = 0;
+  for (var i = 0; i < n; i++) {
+    result += p.x;
+    p.x = i;
+  }
+  return result;
+}
+
+function test() {
+  var p = new Point(1, 2);
+  assertEquals(6, forward(p, 5));
+  assertEquals(5, p.x);
+  assertEquals(2, overwrite(p));
+  assertEquals(2, p.x);
+  p = new Point(1, 2);
+  assertEquals(11, alias(p, p));
+  assertEquals(2, alias(new Point(1, 2), new Point(3, 4)));
+  assertEquals(8, call(p, function(o) { o.x = -2; }));
+  p = new Point(1, 2);
+  assertEquals(4, loop(p, 4));
+  assertEquals(3, p.x);
+}
+
+for (var i = 0; i < 5; i++) test();
+%OptimizeFunctionOnNextCall(forward);
+%OptimizeFunctionOnNextCall(overwrite);
+%OptimizeFunctionOnNextCall(alias);
+%OptimizeFunctionOnNextCall(call);
+%OptimizeFunctionOnNextCall(loop);
+test();
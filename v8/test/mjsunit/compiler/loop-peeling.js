@@ -0,0 +1,121 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --loop-peeling
+
+// Test that peeling the first iteration of small inner loops preserves
+// their semantics.
+
+function Sum(a) {
+  var sum = 0;
+  for (var i = 0; i < a.length; i++) sum += a[i].x;
+  return sum;
+}
+
+var points = [{x: 1}, {x: 2}, {x: 3}];
+assertEquals(6, Sum(points));
+assertEquals(6, Sum(points));
+%OptimizeFunctionOnNextCall(Sum);
+assertEquals(6, Sum(points));
+assertEquals(0, Sum([]));
+assertEquals(1, Sum([{x: 1}]));
+// Deoptimize in the peeled iteration and in the loop.
+assertEquals(1.5, Sum([{x: 1.5}]));
+assertEquals(3.5, Sum([{x: 1}, {x: 2.5}]));
+
+
+function FindFirst(a, value) {
+  var i = 0;
+  while (i < a.length) {
+    if (a[i] === value) break;
+    i++;
+  }
+  return i;
+}
+
+for (var n = 0; n < 3; n++) {
+  assertEquals(0, FindFirst([1, 2, 3], 1));
+  assertEquals(2, FindFirst([1, 2, 3], 3));
+  assertEquals(3, FindFirst([1, 2, 3], 4));
+  assertEquals(0, FindFirst([], 4));
+  %OptimizeFunctionOnNextCall(FindFirst);
+}
+
+
+function CountOdd(a) {
+  var count = 0;
+  for (var i = 0; i < a.length; i++) {
+    if ((a[i] & 1) == 0) continue;
+    count++;
+  }
+  return count;
+}
+
+for (var n = 0; n < 3; n++) {
+  assertEquals(2, CountOdd([1, 2, 3]));
+  assertEquals(1, CountOdd([2, 3, 4]));
+  assertEquals(0, CountOdd([]));
+  %OptimizeFunctionOnNextCall(CountOdd);
+}
+
+
+function IndexOf(a, value) {
+  for (var i = 0; ; i++) {
+    if (i == a.length) return -1;
+    if (a[i] == value) return i;
+  }
+}
+
+for (var n = 0; n < 3; n++) {
+  assertEquals(0, IndexOf([5, 6], 5));
+  assertEquals(1, IndexOf([5, 6], 6));
+  assertEquals(-1, IndexOf([5, 6], 7));
+  assertEquals(-1, IndexOf([], 7));
+  %OptimizeFunctionOnNextCall(IndexOf);
+}
+
+
+function Nested(rows) {
+  var result = 0;
+  outer: for (var i = 0; i < rows.length; i++) {
+    var row = rows[i];
+    for (var j = 0; j < row.length; j++) {
+      if (row[j] < 0) continue outer;
+      if (row[j] == 0) break outer;
+      result += row[j];
+    }
+  }
+  return result;
+}
+
+var rows = [[1, 2], [-1, 5], [3, 0, 7], [100]];
+for (var n = 0; n < 3; n++) {
+  assertEquals(6, Nested(rows));
+  assertEquals(0, Nested([[0, 1]]));
+  assertEquals(1, Nested([[-1], [1]]));
+  %OptimizeFunctionOnNextCall(Nested);
+}
@@ -0,0 +1,86 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test inlined Math.min, Math.max and truncating integer division.
+
+function min(a, b) { return Math.min(a, b); }
+function max(a, b) { return Math.max(a, b); }
+
+function testMinMax() {
+  assertEquals(1, min(1, 2));
+  assertEquals(-2, min(1, -2));
+  assertEquals(2, max(1, 2));
+  assertEquals(1, max(1, -2));
+  assertEquals(1.5, min(1.5, 2.5));
+  assertEquals(2.5, max(1.5, 2.5));
+  assertTrue(isNaN(min(NaN, 1)));
+  assertTrue(isNaN(min(1, NaN)));
+  assertTrue(isNaN(max(NaN, 1.5)));
+  assertTrue(isNaN(max(1.5, NaN)));
+  assertEquals(-Infinity, 1 / min(0.0, -0.0));
+  assertEquals(-Infinity, 1 / min(-0.0, 0.0));
+  assertEquals(Infinity, 1 / max(0.0, -0.0));
+  assertEquals(Infinity, 1 / max(-0.0, 0.0));
+  assertEquals(-Infinity, 1 / max(-0.0, -0.0));
+}
+
+for (var i = 0; i < 5; i++) testMinMax();
+%OptimizeFunctionOnNextCall(min);
+%OptimizeFunctionOnNextCall(max);
+testMinMax();
+
+function intMinMax(a, b) {
+  return Math.min(a, b) + Math.max(a, b) * 3;
+}
+for (var i = 0; i < 5; i++) intMinMax(i, 2);
+%OptimizeFunctionOnNextCall(intMinMax);
+assertEquals(1 + 7 * 3, intMinMax(7, 1));
+assertEquals(-5 + 2 * 3, intMinMax(-5, 2));
+
+
+function div(a, b) { return a / b | 0; }
+
+for (var i = 1; i < 5; i++) div(i * 4, 2);
+%OptimizeFunctionOnNextCall(div);
+assertEquals(3, div(7, 2));
+assertEquals(-3, div(-7, 2));
+assertEquals(-3, div(7, -2));
+assertEquals(0, div(1, 3));
+assertEquals(5, div(10, 2));
+assertEquals(0, div(1, 0));
+assertEquals(-2147483648, div(-2147483648, -1));
+
+
+function roundAndFloor(a) { return Math.round(a) + Math.floor(a); }
+
+for (var i = 0; i < 5; i++) roundAndFloor(i);
+%OptimizeFunctionOnNextCall(roundAndFloor);
+assertEquals(6, roundAndFloor(3));
+assertEquals(-6, roundAndFloor(-3));
+assertEquals(5, roundAndFloor(2.6));
@@ -0,0 +1,96 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax --optimize-for-in
+
+// Optimized for-in loops iterate the enum cache of the map of the object,
+// and deoptimize when the object has elements, keys on its prototypes or
+// changes its map while the loop runs.
+
+function Keys(o) {
+  var result = "";
+  for (var k in o) result += k;
+  return result;
+}
+
+function Sum(o) {
+  var result = 0;
+  for (var k in o) {
+    if (k == "skip") continue;
+    if (k == "stop") break;
+    result += o[k];
+  }
+  return result;
+}
+
+function Pairs(a, b) {
+  var result = [];
+  outer: for (var i in a) {
+    for (var j in b) {
+      if (j == "c") continue outer;
+      if (i == "c") break outer;
+      result.push(i + j);
+    }
+  }
+  return result.join(",");
+}
+
+function Optimize(f, args) {
+  f.apply(null, args);
+  f.apply(null, args);
+  %OptimizeFunctionOnNextCall(f);
+  return f.apply(null, args);
+}
+
+assertEquals("abc", Optimize(Keys, [{a: 1, b: 2, c: 3}]));
+assertEquals("abc", Keys({a: 1, b: 2, c: 3}));
+assertEquals("", Keys({}));
+assertEquals("", Keys(null));
+assertEquals("", Keys(undefined));
+assertEquals("01", Keys([5, 6]));
+assertEquals("xy", Keys(Object.create({x: 1, y: 2})));
+
+assertEquals(6, Optimize(Sum, [{a: 1, b: 2, c: 3}]));
+assertEquals(4, Sum({a: 1, skip: 2, c: 3}));
+assertEquals(1, Sum({a: 1, stop: 2, c: 3}));
+
+assertEquals("aa,ab,ba,bb", Optimize(Pairs, [{a: 1, b: 2, c: 3},
+                                            {a: 1, b: 2, c: 3}]));
+
+// Deleting a key that was not visited yet skips it.
+function DeleteWhileIterating(o) {
+  var result = "";
+  for (var k in o) {
+    result += k;
+    delete o.b;
+  }
+  return result;
+}
+
+assertEquals("ac", Optimize(DeleteWhileIterating, [{a: 1, b: 2, c: 3}]));
+assertEquals("ac", DeleteWhileIterating({a: 1, b: 2, c: 3}));
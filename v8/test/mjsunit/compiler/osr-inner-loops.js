@@ -0,0 +1,60 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --use-osr
+
+// Inner loops are replaced on the stack without waiting for the outer
+// loop to come around.
+function nested(outer, inner) {
+  var sum = 0;
+  for (var i = 0; i < outer; i++) {
+    for (var j = 0; j < inner; j++) {
+      for (var k = 0; k < 10; k++) sum += k & 1;
+    }
+  }
+  return sum;
+}
+
+assertEquals(1000000, nested(2, 100000));
+assertEquals(1000000, nested(2, 100000));
+
+// An activation that keeps looping after the function got optimized in a
+// nested call can enter the optimized code, too.
+function late(n) {
+  var sum = 0;
+  for (var i = 0; i < n; i++) {
+    if (i == 10) {
+      %OptimizeFunctionOnNextCall(late);
+      late(1);
+    }
+    sum += i % 7;
+  }
+  return sum;
+}
+
+assertEquals(2999997, late(1000000));
+assertEquals(2999997, late(1000000));
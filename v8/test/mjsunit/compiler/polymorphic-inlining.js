@@ -0,0 +1,76 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test inlining of the targets of polymorphic method calls.
+
+function Circle(r) { this.r = r; }
+Circle.prototype.area = function() { return 3 * this.r * this.r; };
+
+function Square(s) { this.s = s; }
+Square.prototype.area = function() { return this.s * this.s; };
+
+function Rect(w, h) { this.w = w; this.h = h; }
+Rect.prototype.area = function() { return this.w * this.h; };
+
+function Triangle(b, h) { this.b = b; this.h = h; }
+Triangle.prototype.area = function() { return this.b * this.h / 2; };
+
+function TotalArea(shapes) {
+  var total = 0;
+  for (var i = 0; i < shapes.length; i++) {
+    total += shapes[i].area();
+  }
+  return total;
+}
+
+var shapes = [new Circle(1), new Square(2), new Rect(2, 3)];
+assertEquals(13, TotalArea(shapes));
+assertEquals(13, TotalArea(shapes));
+%OptimizeFunctionOnNextCall(TotalArea);
+assertEquals(13, TotalArea(shapes));
+
+// A receiver map that was not seen before deoptimizes.
+shapes.push(new Triangle(2, 2));
+assertEquals(15, TotalArea(shapes));
+%OptimizeFunctionOnNextCall(TotalArea);
+assertEquals(15, TotalArea(shapes));
+
+
+// Test polymorphic inlining in a test context.
+function IsBig(shape) {
+  if (shape.area() > 5) return true;
+  return false;
+}
+
+assertFalse(IsBig(new Circle(1)));
+assertTrue(IsBig(new Rect(2, 3)));
+%OptimizeFunctionOnNextCall(IsBig);
+assertFalse(IsBig(new Square(2)));
+assertTrue(IsBig(new Circle(2)));
+assertTrue(IsBig(new Rect(2, 3)));
@@ -0,0 +1,72 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --reuse-scope-info
+
+// Recompiling a function for optimization reuses its compiled inner
+// functions without parsing them again.  Variables only used by the inner
+// functions must keep their context slots.
+
+function outer(a, b) {
+  var only_inner = a * 2;
+  var shared = b;
+  var local = a + b;
+  function get() { return only_inner + shared; }
+  var set = function(v) { shared = v; };
+  var nested = function() {
+    return function() { return a + only_inner; };
+  };
+  set(local);
+  return [get, set, nested()];
+}
+
+var fs;
+for (var i = 0; i < 5; i++) fs = outer(i, 1);
+%OptimizeFunctionOnNextCall(outer);
+fs = outer(3, 4);
+assertEquals(13, fs[0]());
+fs[1](10);
+assertEquals(16, fs[0]());
+assertEquals(9, fs[2]());
+
+// Closures created by the old code and the new code share the same inner
+// function code.
+var old_closures = outer(1, 1);
+%OptimizeFunctionOnNextCall(outer);
+var new_closures = outer(1, 1);
+assertEquals(old_closures[0](), new_closures[0]());
+assertEquals(4, new_closures[0]());
+
+
+// A named function expression whose name is only used by an inner function.
+var named = function self(n) {
+  var inner = function() { return self; };
+  return n > 0 ? inner : null;
+};
+for (var i = 0; i < 5; i++) named(1);
+%OptimizeFunctionOnNextCall(named);
+assertSame(named, named(1)());
@@ -0,0 +1,115 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test inlined string concatenation and string equality in optimized code.
+
+function add(a, b) {
+  return a + b;
+}
+
+function testAdd() {
+  assertEquals("abc", add("", "abc"));
+  assertEquals("abc", add("abc", ""));
+  assertEquals("", add("", ""));
+  assertEquals("abcdef", add("abc", "def"));
+  var long1 = "abcdefghijklmnop";
+  var long2 = "qrstuvwxyz";
+  assertEquals("abcdefghijklmnopqrstuvwxyz", add(long1, long2));
+  assertEquals(26, add(long1, long2).length);
+  var two_byte = "\u1234\u5678abcdefghijkl";
+  var mixed = add(long1, two_byte);
+  assertEquals(30, mixed.length);
+  assertEquals(0x1234, mixed.charCodeAt(16));
+  assertEquals("a", mixed.charAt(0));
+}
+
+for (var i = 0; i < 5; i++) testAdd();
+%OptimizeFunctionOnNextCall(add);
+testAdd();
+
+// Deep cons strings built in a loop must stay correct when their depth
+// exceeds the limit handled inline.
+function build(n) {
+  var s = "0123456789abcdef";
+  for (var i = 0; i < n; i++) s = add(s, "x" + (i % 10));
+  return s;
+}
+
+var deep = build(2000);
+assertEquals(16 + 2 * 2000, deep.length);
+assertEquals("x9", deep.substring(deep.length - 2));
+assertEquals("0123456789abcdefx0x1", deep.substring(0, 20));
+
+function eq(a, b) {
+  return a == b;
+}
+
+function strictEq(a, b) {
+  return a === b;
+}
+
+function testEq(f) {
+  var a = "hello world";
+  var b = "hello" + " world";
+  assertEquals(true, f(a, a));
+  assertEquals(true, f(a, b));
+  assertEquals(false, f(a, "hello"));
+  assertEquals(false, f(a, "hello worle"));
+  assertEquals(false, f("foo", "bar"));
+  assertEquals(true, f("foo", "foo"));
+  assertEquals(true, f("", ""));
+  assertEquals(false, f("", "x"));
+}
+
+for (var i = 0; i < 5; i++) {
+  testEq(eq);
+  testEq(strictEq);
+}
+%OptimizeFunctionOnNextCall(eq);
+%OptimizeFunctionOnNextCall(strictEq);
+testEq(eq);
+testEq(strictEq);
+
+function sw(s) {
+  switch (s) {
+    case "alpha": return 1;
+    case "beta" + "gamma": return 2;
+    default: return 3;
+  }
+}
+
+for (var i = 0; i < 5; i++) {
+  assertEquals(1, sw("alpha"));
+  assertEquals(2, sw("betagamma"));
+  assertEquals(3, sw("delta"));
+}
+%OptimizeFunctionOnNextCall(sw);
+assertEquals(1, sw("alp" + "ha"));
+assertEquals(2, sw("betagamma"));
+assertEquals(3, sw("betagammb"));
@@ -0,0 +1,165 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test optimized switch statements with many clauses, on smis, on strings
+// and with labels that are not all literals of one type.
+
+function smiSwitch(x) {
+  var result = "";
+  switch (x) {
+    case 0: return "zero";
+    case 1: result += "one";
+    case 2: result += "two"; break;
+    case -5: return "minus five";
+    case 7: return "seven";
+    case 100: return "hundred";
+    case 1: return "second one";
+    case 12: return "twelve";
+    default: result += "default";
+    case 13: result += "thirteen"; break;
+    case 1000000: return "million";
+    case 42: return "answer";
+  }
+  return result;
+}
+
+function testSmiSwitch() {
+  assertEquals("zero", smiSwitch(0));
+  assertEquals("onetwo", smiSwitch(1));
+  assertEquals("two", smiSwitch(2));
+  assertEquals("minus five", smiSwitch(-5));
+  assertEquals("seven", smiSwitch(7));
+  assertEquals("hundred", smiSwitch(100));
+  assertEquals("twelve", smiSwitch(12));
+  assertEquals("thirteen", smiSwitch(13));
+  assertEquals("million", smiSwitch(1000000));
+  assertEquals("answer", smiSwitch(42));
+  assertEquals("defaultthirteen", smiSwitch(3));
+  assertEquals("defaultthirteen", smiSwitch(-1));
+  assertEquals("defaultthirteen", smiSwitch(99));
+}
+
+for (var i = 0; i < 5; ++i) testSmiSwitch();
+%OptimizeFunctionOnNextCall(smiSwitch);
+testSmiSwitch();
+// Non-smi tags.
+assertEquals("seven", smiSwitch(7.0));
+assertEquals("defaultthirteen", smiSwitch(7.5));
+assertEquals("defaultthirteen", smiSwitch("7"));
+assertEquals("defaultthirteen", smiSwitch(undefined));
+testSmiSwitch();
+
+function stringSwitch(x) {
+  switch (x) {
+    case "alpha": return 1;
+    case "beta": return 2;
+    case "gamma": return 3;
+    case "delta": return 4;
+    case "beta": return 5;
+    case "epsilon": return 6;
+    case "": return 7;
+    case "123": return 8;
+    case "zeta": return 9;
+    default: return 0;
+  }
+}
+
+function testStringSwitch() {
+  assertEquals(1, stringSwitch("alpha"));
+  assertEquals(2, stringSwitch("beta"));
+  assertEquals(3, stringSwitch("gamma"));
+  assertEquals(4, stringSwitch("delta"));
+  assertEquals(6, stringSwitch("epsilon"));
+  assertEquals(7, stringSwitch(""));
+  assertEquals(8, stringSwitch("123"));
+  assertEquals(9, stringSwitch("zeta"));
+  assertEquals(0, stringSwitch("eta"));
+  assertEquals(0, stringSwitch("Alpha"));
+}
+
+for (var i = 0; i < 5; ++i) testStringSwitch();
+%OptimizeFunctionOnNextCall(stringSwitch);
+testStringSwitch();
+// Strings that are not symbols, with and without a computed hash.
+var prefix = "ga";
+assertEquals(3, stringSwitch(prefix + "mma"));
+var flat = (prefix + "mma").substring(0);
+var object = {};
+object[flat] = true;
+assertEquals(3, stringSwitch(flat));
+assertEquals(2, stringSwitch(["b", "e", "t", "a"].join("")));
+// Tags that are not strings.
+assertEquals(0, stringSwitch(123));
+assertEquals(0, stringSwitch(null));
+assertEquals(0, stringSwitch({ toString: function() { return "alpha"; } }));
+testStringSwitch();
+
+var log;
+function label(value) { log.push(value); return value; }
+
+function genericSwitch(x) {
+  log = [];
+  switch (x) {
+    case 1: return "one";
+    case "1": return "string one";
+    case label(2): return "two";
+    case undefined: return "undefined";
+    case label(x): return "same";
+  }
+  return "none";
+}
+
+function testGenericSwitch() {
+  assertEquals("one", genericSwitch(1));
+  assertEquals([], log);
+  assertEquals("string one", genericSwitch("1"));
+  assertEquals("two", genericSwitch(2));
+  assertEquals([2], log);
+  assertEquals("undefined", genericSwitch(undefined));
+  assertEquals("same", genericSwitch(3.5));
+  assertEquals([2, 3.5], log);
+  assertEquals("none", genericSwitch(NaN));
+  var o = {};
+  assertEquals("same", genericSwitch(o));
+}
+
+for (var i = 0; i < 5; ++i) testGenericSwitch();
+%OptimizeFunctionOnNextCall(genericSwitch);
+testGenericSwitch();
+
+// A switch with more clauses than the old limit of the optimizing compiler.
+var source = "var f = function(x) { switch (x) {";
+for (var i = 0; i < 300; ++i) {
+  source += "case " + (i * 3) + ": return " + i + ";";
+}
+source += "} return -1; }";
+eval(source);
+for (var i = 0; i < 5; ++i) f(6);
+%OptimizeFunctionOnNextCall(f);
+for (var i = 0; i < 900; ++i) assertEquals(i % 3 == 0 ? i / 3 : -1, f(i));
@@ -0,0 +1,109 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --uint32-analysis
+
+// Unsigned 32-bit values stay in integer registers unless they are used
+// in a way that observes their sign.
+
+var K = 0xFFFFFFFF;
+
+function ChangeToUint32(x) {
+  return x >>> 0;
+}
+
+assertEquals(K, ChangeToUint32(-1));
+assertEquals(K, ChangeToUint32(-1));
+%OptimizeFunctionOnNextCall(ChangeToUint32);
+assertEquals(K, ChangeToUint32(-1));
+assertEquals(1, ChangeToUint32(1));
+assertEquals(0x80000000, ChangeToUint32(0x80000000 | 0));
+
+var u32 = new Uint32Array(4);
+u32[0] = K;
+u32[1] = 0x80000000;
+u32[2] = 7;
+
+function LoadUint32(a, i) {
+  return a[i];
+}
+
+assertEquals(K, LoadUint32(u32, 0));
+assertEquals(K, LoadUint32(u32, 0));
+%OptimizeFunctionOnNextCall(LoadUint32);
+assertEquals(K, LoadUint32(u32, 0));
+assertEquals(0x80000000, LoadUint32(u32, 1));
+assertEquals(7, LoadUint32(u32, 2));
+
+function Crc(a, n) {
+  var crc = K;
+  for (var i = 0; i < n; i++) {
+    crc = (crc >>> 8) ^ a[i];
+  }
+  return crc >>> 0;
+}
+
+var expected = Crc(u32, 3);
+assertEquals(expected, Crc(u32, 3));
+%OptimizeFunctionOnNextCall(Crc);
+assertEquals(expected, Crc(u32, 3));
+
+function StoreUint32(dst, src) {
+  for (var i = 0; i < 3; i++) dst[i] = src[i] >>> 0;
+}
+
+var dst = new Uint32Array(4);
+StoreUint32(dst, u32);
+StoreUint32(dst, u32);
+%OptimizeFunctionOnNextCall(StoreUint32);
+StoreUint32(dst, u32);
+assertEquals(K, dst[0]);
+assertEquals(0x80000000, dst[1]);
+
+function Phi(a, b, c) {
+  var x = c ? (a >>> 0) : (b >>> 0);
+  return x;
+}
+
+assertEquals(K, Phi(-1, 0, true));
+assertEquals(0, Phi(-1, 0, false));
+%OptimizeFunctionOnNextCall(Phi);
+assertEquals(K, Phi(-1, 0, true));
+assertEquals(1, Phi(-1, 1, false));
+
+// Deoptimization with an unsigned value live in the environment.
+function Deopt(a, o) {
+  var x = a >>> 0;
+  var y = o.y;
+  return x + y;
+}
+
+assertEquals(K + 1, Deopt(-1, {y: 1}));
+assertEquals(K + 1, Deopt(-1, {y: 1}));
+%OptimizeFunctionOnNextCall(Deopt);
+assertEquals(K + 1, Deopt(-1, {y: 1}));
+assertEquals(K + 1, Deopt(-1, {z: 0, y: 1}));
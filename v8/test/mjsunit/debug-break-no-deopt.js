@@ -0,0 +1,88 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --expose-debug-as debug --allow-natives-syntax
+
+// Tests that setting a break point only deoptimizes the code that contains
+// the function with the break point, and that such a function is neither
+// optimized nor inlined while it has break points.
+
+Debug = debug.Debug;
+
+var break_count = 0;
+
+function listener(event, exec_state, event_data, data) {
+  if (event == Debug.DebugEvent.Break) break_count++;
+}
+
+function g(x) {
+  return x + 1;  // Break point is set here.
+}
+
+function f(x) {
+  return g(x) * 2;
+}
+
+function unrelated(x) {
+  return x * 3;
+}
+
+for (var i = 0; i < 3; i++) {
+  f(i);
+  unrelated(i);
+}
+%OptimizeFunctionOnNextCall(f);
+%OptimizeFunctionOnNextCall(unrelated);
+f(1);
+unrelated(1);
+
+// 1 means optimized, see runtime.cc.
+var optimized = %GetOptimizationStatus(unrelated) == 1;
+
+Debug.setListener(listener);
+var bp = Debug.setBreakPoint(g, 1);
+
+if (optimized) {
+  assertEquals(1, %GetOptimizationStatus(unrelated));
+  assertEquals(2, %GetOptimizationStatus(f));
+}
+
+assertEquals(4, f(1));
+assertEquals(1, break_count);
+
+// f can be optimized again, but g is not inlined into it.
+%OptimizeFunctionOnNextCall(f);
+assertEquals(6, f(2));
+assertEquals(2, break_count);
+assertEquals(8, f(3));
+assertEquals(3, break_count);
+
+Debug.clearBreakPoint(bp);
+assertEquals(10, f(4));
+assertEquals(3, break_count);
+
+Debug.setListener(null);
@@ -0,0 +1,85 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax --smi-only-arrays
+
+// Tests the transitions done by the generic keyed store stub.
+
+support_smi_only_arrays = %HasFastSmiOnlyElements([]);
+
+function store(a, i, v) { a[i] = v; }
+
+// Make the keyed store site go generic.
+var objects = [{}, {a: 1}, {b: 1}, {c: 1}, {d: 1}, {e: 1}, {f: 1}];
+for (var i = 0; i < objects.length; i++) store(objects[i], 0, 1);
+
+function make_array(length) {
+  var array = new Array(length);
+  for (var i = 0; i < length; i++) array[i] = i;
+  return array;
+}
+
+if (support_smi_only_arrays) {
+  // Smi-only arrays switch to object elements in place.
+  var a = make_array(3);
+  assertTrue(%HasFastSmiOnlyElements(a));
+  store(a, 1, "str");
+  assertTrue(%HasFastElements(a));
+  assertEquals([0, "str", 2], a);
+
+  // The transitioned map is the one the runtime would pick.
+  var b = make_array(3);
+  b[0] = {};
+  assertTrue(%HaveSameMap(a, b));
+
+  // Appending a non-smi.
+  var c = make_array(2);
+  var o = {x: 1};
+  store(c, 2, o);
+  assertTrue(%HasFastElements(c));
+  assertEquals(3, c.length);
+  assertSame(o, c[2]);
+
+  // Heap numbers still go to double elements.
+  var d = make_array(2);
+  store(d, 0, 1.5);
+  assertTrue(%HasFastDoubleElements(d));
+  assertEquals([1.5, 1], d);
+
+  // Arrays that do not have the initial array map are left to the runtime.
+  var e = make_array(2);
+  e.foo = 1;
+  store(e, 0, "str");
+  assertTrue(%HasFastElements(e));
+  assertEquals(["str", 1], e);
+
+  // Smi stores leave the elements kind alone.
+  var f = make_array(2);
+  store(f, 0, 7);
+  assertTrue(%HasFastSmiOnlyElements(f));
+}
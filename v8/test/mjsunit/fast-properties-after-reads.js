@@ -0,0 +1,90 @@
+// Copyright 2008 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --fast-properties-read-threshold=100
+
+// Objects in dictionary mode that are read often without changing shape get
+// fast properties again, and objects of the same shape share a map.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+  this.z = 0;
+}
+
+function makeSlow(x, y) {
+  var p = new Point(x, y);
+  delete p.z;
+  p.z = x + y;
+  assertFalse(%HasFastProperties(p));
+  return p;
+}
+
+function read(p, n) {
+  var sum = 0;
+  for (var i = 0; i < n; i++) sum += p.x + p.y + p.z;
+  return sum;
+}
+
+var p = makeSlow(1, 2);
+var q = makeSlow(3, 4);
+assertEquals(300, read(p, 50));
+assertEquals(700, read(q, 50));
+assertTrue(%HasFastProperties(p));
+assertTrue(%HasFastProperties(q));
+assertTrue(%HaveSameMap(p, q));
+assertEquals([1, 2, 3], [p.x, p.y, p.z]);
+assertEquals([3, 4, 7], [q.x, q.y, q.z]);
+assertEquals(["x", "y", "z"], Object.keys(p));
+assertEquals(["x", "y", "z"], Object.keys(q));
+
+// Adding properties keeps resetting the count.
+var r = makeSlow(5, 6);
+for (var i = 0; i < 8; i++) {
+  read(r, 20);
+  r["p" + i] = i;
+}
+assertFalse(%HasFastProperties(r));
+read(r, 100);
+assertTrue(%HasFastProperties(r));
+assertEquals(7, r.p7);
+
+// The same properties in another enumeration order need another map.
+var s = new Point(1, 2);
+delete s.x;
+s.x = 1;
+read(s, 200);
+assertTrue(%HasFastProperties(s));
+assertFalse(%HaveSameMap(p, s));
+assertEquals(["y", "z", "x"], Object.keys(s));
+
+// Objects used as hash tables stay in dictionary mode.
+var table = {};
+for (var i = 0; i < 100; i++) table["k" + i] = i;
+assertFalse(%HasFastProperties(table));
+for (var i = 0; i < 200; i++) table.k1;
+assertFalse(%HasFastProperties(table));
@@ -0,0 +1,109 @@
+// Copyright 2011 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --harmony-collections --expose-gc
+
+
+// Test that sets are iterated in insertion order.
+function SetKeys(s) {
+  var keys = [];
+  s.forEach(function (key, same, set) {
+    assertSame(key, same);
+    assertSame(s, set);
+    keys.push(key);
+  });
+  return keys;
+}
+
+var s = new Set;
+assertEquals(0, s.size);
+s.add('c');
+s.add('a');
+s.add(undefined);
+s.add('b');
+s.add('a');
+assertEquals(4, s.size);
+assertEquals(['c', 'a', undefined, 'b'], SetKeys(s));
+s.delete('a');
+assertEquals(3, s.size);
+assertEquals(['c', undefined, 'b'], SetKeys(s));
+s.add('a');
+assertEquals(['c', undefined, 'b', 'a'], SetKeys(s));
+
+
+// Test that maps are iterated in insertion order, also across growing,
+// shrinking and garbage collections.
+function MapEntries(m) {
+  var entries = [];
+  m.forEach(function (value, key, map) {
+    assertSame(m, map);
+    entries.push(key, value);
+  });
+  return entries;
+}
+
+var m = new Map;
+var keys = [];
+for (var i = 0; i < 100; i++) {
+  var key = (i % 3 == 0) ? { id: i } : (i % 3 == 1) ? 'key-' + i : i / 2;
+  keys.push(key);
+  m.set(key, i);
+}
+assertEquals(100, m.size);
+for (var i = 0; i < 100; i += 2) {
+  assertTrue(m.delete(keys[i]));
+}
+assertEquals(50, m.size);
+gc();
+var entries = MapEntries(m);
+assertEquals(100, entries.length);
+for (var i = 0; i < 50; i++) {
+  assertSame(keys[2 * i + 1], entries[2 * i]);
+  assertEquals(2 * i + 1, entries[2 * i + 1]);
+  assertSame(2 * i + 1, m.get(keys[2 * i + 1]));
+  assertFalse(m.has(keys[2 * i]));
+}
+
+// Overwriting a value keeps the position of the key.
+m.set(keys[1], 'first');
+assertEquals([keys[1], 'first'], MapEntries(m).slice(0, 2));
+
+
+// Test the receiver and the entries visited by forEach.
+var receiver = {};
+var visited = 0;
+m = new Map;
+m.set('x', 1);
+m.set('y', 2);
+m.forEach(function (value, key) {
+  assertSame(receiver, this);
+  m.set('z' + key, 3);
+  visited++;
+}, receiver);
+assertEquals(2, visited);
+assertEquals(4, m.size);
+assertThrows(function () { m.forEach(0) }, TypeError);
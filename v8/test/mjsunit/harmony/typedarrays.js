@@ -0,0 +1,188 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --harmony-typed-arrays --allow-natives-syntax
+
+
+// Test ArrayBuffer construction and slicing.
+function TestArrayBuffer() {
+  var buffer = new ArrayBuffer(16);
+  assertEquals(16, buffer.byteLength);
+  assertEquals("[object ArrayBuffer]", Object.prototype.toString.call(buffer));
+  assertEquals(0, new ArrayBuffer(0).byteLength);
+  assertEquals(8, ArrayBuffer(8).byteLength);
+  assertThrows(function () { new ArrayBuffer(-1) }, RangeError);
+
+  var bytes = new Uint8Array(buffer);
+  for (var i = 0; i < 16; i++) {
+    assertEquals(0, bytes[i]);
+    bytes[i] = i;
+  }
+  var slice = buffer.slice(4, -4);
+  assertEquals(8, slice.byteLength);
+  var sliceBytes = new Uint8Array(slice);
+  for (var i = 0; i < 8; i++) assertEquals(i + 4, sliceBytes[i]);
+  sliceBytes[0] = 100;
+  assertEquals(4, bytes[4]);
+  assertEquals(0, buffer.slice(10, 2).byteLength);
+  assertEquals(16, buffer.slice(-100).byteLength);
+}
+TestArrayBuffer();
+
+
+// Test the element conversions and construction of each kind of view.
+function TestView(constructor, elementSize, value, expected) {
+  assertEquals(elementSize, constructor.BYTES_PER_ELEMENT);
+  assertEquals(elementSize, constructor.prototype.BYTES_PER_ELEMENT);
+
+  var a = new constructor(4);
+  assertEquals(4, a.length);
+  assertEquals(4 * elementSize, a.byteLength);
+  assertEquals(0, a.byteOffset);
+  assertEquals(4 * elementSize, a.buffer.byteLength);
+  assertSame(constructor, a.constructor);
+  a[1] = value;
+  assertEquals(expected, a[1]);
+  assertEquals(0, a[0]);
+  assertEquals(undefined, a[4]);
+
+  var b = new constructor([1, 2, 3]);
+  assertEquals(3, b.length);
+  assertEquals(2, b[1]);
+  var c = new constructor(b);
+  b[1] = 5;
+  assertEquals(2, c[1]);
+
+  var buffer = new ArrayBuffer(8 * elementSize);
+  var d = new constructor(buffer, 2 * elementSize, 3);
+  assertSame(buffer, d.buffer);
+  assertEquals(3, d.length);
+  assertEquals(2 * elementSize, d.byteOffset);
+  var e = new constructor(buffer);
+  d[0] = 7;
+  assertEquals(7, e[2]);
+  assertEquals(6, new constructor(buffer, 2 * elementSize).length);
+
+  assertThrows(function () { new constructor(-1) }, RangeError);
+  assertThrows(function () { new constructor(buffer, 9 * elementSize) },
+               RangeError);
+  assertThrows(function () { new constructor(buffer, 0, 9) }, RangeError);
+  if (elementSize > 1) {
+    assertThrows(function () { new constructor(buffer, 1) }, RangeError);
+    assertThrows(function () { new constructor(new ArrayBuffer(3)) },
+                 RangeError);
+  }
+}
+TestView(Int8Array, 1, 200, -56);
+TestView(Uint8Array, 1, 300, 44);
+TestView(Uint8ClampedArray, 1, 300, 255);
+TestView(Int16Array, 2, 40000, -25536);
+TestView(Uint16Array, 2, -1, 65535);
+TestView(Int32Array, 4, 0x80000000, -0x80000000);
+TestView(Uint32Array, 4, -1, 0xffffffff);
+TestView(Float32Array, 4, 0.5, 0.5);
+TestView(Float64Array, 8, 0.1, 0.1);
+
+
+// Test views of different types on one buffer.
+function TestAliasing() {
+  var buffer = new ArrayBuffer(8);
+  var words = new Uint32Array(buffer);
+  var bytes = new Uint8Array(buffer);
+  words[0] = 0x01020304;
+  var little_endian = bytes[0] == 4;
+  assertEquals(little_endian ? 1 : 4, bytes[3]);
+  var doubles = new Float64Array(buffer);
+  doubles[0] = 1;
+  assertEquals(little_endian ? 0x3ff00000 : 0, words[1]);
+}
+TestAliasing();
+
+
+// Test set and subarray.
+function TestSetAndSubarray() {
+  var a = new Int16Array([0, 1, 2, 3, 4, 5, 6, 7]);
+  var sub = a.subarray(2, -2);
+  assertEquals(4, sub.length);
+  assertSame(a.buffer, sub.buffer);
+  assertEquals(4, sub.byteOffset);
+  assertEquals(2, sub[0]);
+  sub[0] = 20;
+  assertEquals(20, a[2]);
+  assertEquals(0, a.subarray(5, 3).length);
+  assertEquals(8, a.subarray(-100).length);
+
+  a.set([10, 11], 6);
+  assertEquals(10, a[6]);
+  assertEquals(11, a[7]);
+  assertThrows(function () { a.set([1, 2], 7) }, RangeError);
+
+  // Overlapping views on the same buffer.
+  var b = new Int16Array([0, 1, 2, 3, 4, 5, 6, 7]);
+  b.set(b.subarray(0, 6), 2);
+  for (var i = 0; i < 6; i++) assertEquals(i, b[i + 2]);
+  b = new Int16Array([0, 1, 2, 3, 4, 5, 6, 7]);
+  b.set(b.subarray(2), 0);
+  for (var i = 0; i < 6; i++) assertEquals(i + 2, b[i]);
+
+  // A view of another type on the same buffer.
+  var bytes = new Uint8Array([1, 2, 3, 4]);
+  var shorts = new Uint16Array(bytes.buffer);
+  shorts.set(bytes.subarray(0, 2));
+  assertEquals(1, shorts[0]);
+  assertEquals(2, shorts[1]);
+
+  assertThrows(function () { Int16Array.prototype.set.call(bytes, [1]) },
+               TypeError);
+  assertThrows(function () { a.subarray.call({}, 0) }, TypeError);
+}
+TestSetAndSubarray();
+
+
+// Test optimized element access.
+function Sum(a) {
+  var sum = 0;
+  for (var i = 0; i < a.length; i++) sum += a[i];
+  return sum;
+}
+
+function Fill(a, value) {
+  for (var i = 0; i < a.length; i++) a[i] = value;
+}
+
+var floats = new Float64Array(100);
+var ints = new Int32Array(floats.buffer);
+for (var i = 0; i < 3; i++) {
+  Fill(floats, 0.5);
+  assertEquals(50, Sum(floats));
+}
+%OptimizeFunctionOnNextCall(Fill);
+%OptimizeFunctionOnNextCall(Sum);
+Fill(floats, 1.5);
+assertEquals(150, Sum(floats));
+Fill(ints, 3);
+assertEquals(600, Sum(ints));
@@ -0,0 +1,67 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --harmony-collections --expose-gc
+
+// Weak map entries keep their values alive only as long as their keys are
+// alive.  Chains of entries, where the value of one entry is the key of the
+// next, are only reachable through the weak maps themselves.
+
+var kLength = 1000;
+
+function BuildChain(maps, length) {
+  var head = {};
+  var key = head;
+  for (var i = 0; i < length; i++) {
+    var next = { index: i };
+    maps[i % maps.length].set(key, next);
+    key = next;
+  }
+  return head;
+}
+
+function CheckChain(maps, head, length) {
+  var key = head;
+  for (var i = 0; i < length; i++) {
+    key = maps[i % maps.length].get(key);
+    assertEquals(i, key.index);
+  }
+  assertFalse(maps[length % maps.length].has(key));
+}
+
+var single = [new WeakMap()];
+var alternating = [new WeakMap(), new WeakMap(), new WeakMap()];
+var single_head = BuildChain(single, kLength);
+var alternating_head = BuildChain(alternating, kLength);
+// A chain whose head dies takes all of its entries with it.
+BuildChain(alternating, kLength);
+
+gc();
+gc();
+
+CheckChain(single, single_head, kLength);
+CheckChain(alternating, alternating_head, kLength);
@@ -0,0 +1,89 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --expose-gc
+
+// Alternating instanceof checks against different functions at the same
+// site must give the right answers, also after the prototypes change and
+// across garbage collections.
+
+function A() {}
+function B() {}
+function C() {}
+C.prototype = new A();
+
+function isInstance(o, f) { return o instanceof f; }
+
+var a = new A();
+var b = new B();
+var c = new C();
+
+function checkAll() {
+  for (var i = 0; i < 20; i++) {
+    assertTrue(isInstance(a, A));
+    assertFalse(isInstance(a, B));
+    assertTrue(isInstance(b, B));
+    assertFalse(isInstance(b, A));
+    assertTrue(isInstance(c, A));
+    assertTrue(isInstance(c, C));
+    assertFalse(isInstance(c, B));
+  }
+}
+
+checkAll();
+gc();
+checkAll();
+
+// Changing a prototype chain has to invalidate the cached answers.
+C.prototype.__proto__ = B.prototype;
+var d = new C();
+assertFalse(isInstance(d, A));
+assertTrue(isInstance(d, B));
+assertTrue(isInstance(c, B));
+assertFalse(isInstance(c, A));
+C.prototype.__proto__ = A.prototype;
+checkAll();
+
+// Optimized code with functions loaded from an object on the right.
+var classes = { A: A, B: B };
+function isA(o) { return o instanceof classes.A; }
+function isB(o) { return o instanceof classes.B; }
+for (var i = 0; i < 5; i++) {
+  assertTrue(isA(a));
+  assertFalse(isA(b));
+  assertTrue(isB(b));
+  assertFalse(isB(a));
+}
+%OptimizeFunctionOnNextCall(isA);
+%OptimizeFunctionOnNextCall(isB);
+for (var i = 0; i < 5; i++) {
+  assertTrue(isA(a));
+  assertFalse(isA(b));
+  assertTrue(isA(c));
+  assertTrue(isB(b));
+  assertFalse(isB(a));
+}
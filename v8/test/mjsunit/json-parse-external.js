@@ -0,0 +1,73 @@
+// Copyright 2009 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --expose-externalize-string --expose-gc
+
+// JSON.parse reads external ascii strings in place.  Make sure symbols,
+// strings, numbers and escapes come out the same as for heap strings.
+
+function external(text) {
+  // Force a flat copy that can be externalized.
+  var copy = (text + " ").slice(0, text.length);
+  copy = copy.split("").join("");
+  externalizeString(copy, false);
+  assertTrue(isAsciiString(copy));
+  return copy;
+}
+
+var sources = [
+  '{"a":1,"b":[true,false,null],"c":"str","d":-1.5e3}',
+  '[{"key":"value"},{"key":"other\\nline"},{"x\\u0041":0.25}]',
+  '  "plain string"  ',
+  '[1,2,3,4,5,6,7,8,9,10,1e100,-0]',
+  '{"nested":{"deeper":{"deepest":["a","b",{"c":"d"}]}}}'
+];
+
+for (var i = 0; i < sources.length; i++) {
+  var text = sources[i];
+  var ext = external(text);
+  assertEquals(JSON.stringify(JSON.parse(text)),
+               JSON.stringify(JSON.parse(ext)));
+}
+
+// A larger document whose parse allocates enough to trigger GCs.
+var parts = [];
+for (var i = 0; i < 2000; i++) {
+  parts.push('{"id":' + i + ',"name":"item' + i + '","tags":["x","y"]}');
+}
+var big = '[' + parts.join(',') + ']';
+var bigExt = external(big);
+gc();
+var parsed = JSON.parse(bigExt);
+assertEquals(2000, parsed.length);
+assertEquals(1999, parsed[1999].id);
+assertEquals("item1234", parsed[1234].name);
+assertEquals(big, JSON.stringify(parsed));
+
+// Syntax errors still report through the external source.
+assertThrows(function() { JSON.parse(external('{"a":1,}')); }, SyntaxError);
+assertThrows(function() { JSON.parse(external('[1,2')); }, SyntaxError);
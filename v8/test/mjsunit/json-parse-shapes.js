@@ -0,0 +1,97 @@
+// Copyright 2009 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --expose-gc
+
+// JSON.parse reuses the map transitions of previously parsed objects with
+// the same keys.  Check that the cached path produces the same objects as
+// the generic one for all kinds of near-miss shapes.
+
+function check(text) {
+  var parsed = JSON.parse(text);
+  assertEquals(text, JSON.stringify(parsed));
+  return parsed;
+}
+
+var records = [];
+for (var i = 0; i < 100; i++) {
+  records.push('{"id":' + i + ',"name":"n' + i + '","a":1,"b":2,' +
+               '"c":3,"d":4,"e":5,"f":[' + i + ']}');
+}
+var parsed = check('[' + records.join(',') + ']');
+for (var i = 1; i < parsed.length; i++) {
+  assertTrue(%HaveSameMap(parsed[0], parsed[i]));
+  assertEquals(i, parsed[i].id);
+  assertEquals("n" + i, parsed[i].name);
+  assertEquals(i, parsed[i].f[0]);
+}
+
+// Keys that share a prefix with, or are a prefix of, a cached key.
+check('[{"ab":1,"c":2},{"a":1,"c":2},{"abc":1,"c":2},{"ab":3,"c":4}]');
+check('[{"ab":1},{"ab ":2},{"ab":3}]');
+
+// Keys with escapes are never matched verbatim.
+parsed = JSON.parse('[{"a\\"b":1},{"a\\"b":2},{"a\\u0062":3},{"ab":4}]');
+assertEquals(1, parsed[0]['a"b']);
+assertEquals(2, parsed[1]['a"b']);
+assertEquals(3, parsed[2].ab);
+assertEquals(4, parsed[3].ab);
+
+// Different key orders, missing and extra keys.
+check('[{"x":1,"y":2},{"y":1,"x":2},{"x":1},{"x":1,"y":2,"z":3},{"x":1,"y":2}]');
+
+// Element keys, __proto__ and duplicate keys interleaved with named ones.
+parsed = JSON.parse('[{"a":1,"0":2,"b":3},{"a":1,"0":2,"b":3},{"a":1,"1":2}]');
+assertEquals('{"0":2,"a":1,"b":3}', JSON.stringify(parsed[1]));
+assertEquals('{"1":2,"a":1}', JSON.stringify(parsed[2]));
+parsed = JSON.parse('[{"a":1,"__proto__":{"p":1}},{"a":2,"__proto__":null}]');
+assertEquals(1, parsed[0].p);
+assertEquals(null, Object.getPrototypeOf(parsed[1]));
+parsed = JSON.parse('[{"a":1,"a":2,"b":3},{"a":1,"a":2,"b":3},{"a":4}]');
+assertEquals(2, parsed[0].a);
+assertEquals(2, parsed[1].a);
+assertEquals(3, parsed[1].b);
+assertEquals(4, parsed[2].a);
+
+// Nested objects at the same position with different shapes.
+check('[{"o":{"p":1,"q":2}},{"o":{"q":1,"p":2}},{"o":{"p":{"p":1}}}]');
+
+// Two-byte sources take the generic path and must agree.
+check('[{"ሴ":1,"b":2},{"ሴ":3,"b":4},{"b":5}]');
+
+// Keys near the end of the source.
+assertThrows(function() { JSON.parse('[{"abc":1},{"ab'); }, SyntaxError);
+assertThrows(function() { JSON.parse('[{"abc":1},{"abc'); }, SyntaxError);
+assertThrows(function() { JSON.parse('[{"abc":1},{"abc"'); }, SyntaxError);
+
+// Objects that are modified after parsing keep working.
+parsed = JSON.parse('[{"k":1,"l":2},{"k":3,"l":4}]');
+delete parsed[0].k;
+parsed[1].m = 5;
+gc();
+parsed = check('[{"k":1,"l":2},{"k":3,"l":4}]');
+assertTrue(%HaveSameMap(parsed[0], parsed[1]));
@@ -0,0 +1,107 @@
+// Copyright 2009 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// JSON.stringify without replacer and gap has a native fast path.  Check that
+// it agrees with the general path, which is taken when a replacer argument is
+// passed, even an undefined one.
+
+function check(value) {
+  assertEquals(JSON.stringify(value, undefined), JSON.stringify(value));
+}
+
+var long_string = "";
+for (var i = 0; i < 100; i++) long_string += "0123456789";
+
+check(undefined);
+check(null);
+check(true);
+check(false);
+check(0);
+check(-0);
+check(42);
+check(-1073741824);
+check(3.14159);
+check(1e100);
+check(NaN);
+check(Infinity);
+check(-Infinity);
+check("");
+check("abc");
+check("\"\\\b\f\n\r\t\u0000\u001f\u007f");
+check("ሴ\u0000ascii");
+check(long_string + "ģ");
+check(function() {});
+check([]);
+check({});
+check([1, 2.5, "three", null, undefined, true, function() {}]);
+check([1.5, 2.5, NaN, -0]);
+check([1, , 3]);
+check({ a: 1, b: "two", c: [3], d: { e: undefined, f: null }, g: Math.max });
+check({ "ሴ": "噸", "key\n": "value\t" });
+check({ z: 1, a: 2, m: 3 });
+check([{ x: 1, y: 2 }, { x: 3, y: 4 }, { y: 5, x: 6 }]);
+check(new Date(0));
+check(new Number(3));
+check(new String("str"));
+check(new Boolean(false));
+check(/regexp/);
+check({ toJSON: function() { return "custom"; } });
+check({ get getter() { return "gotten"; } });
+check(Object.create({ inherited: 1 }, { own: { value: 2, enumerable: true } }));
+check(Object.defineProperty({}, "hidden", { value: 1, enumerable: false }));
+
+var dictionary = { a: 1, b: 2, c: 3 };
+delete dictionary.b;
+check(dictionary);
+
+var with_elements = { a: 1 };
+with_elements[0] = "zero";
+check(with_elements);
+
+var deep = [];
+for (var i = 0; i < 1000; i++) deep = [deep, { level: i }];
+check(deep);
+
+var cyclic = { a: 1 };
+cyclic.self = cyclic;
+assertThrows(function() { JSON.stringify(cyclic); }, TypeError);
+var cyclic_array = [1];
+cyclic_array.push([cyclic_array]);
+assertThrows(function() { JSON.stringify(cyclic_array); }, TypeError);
+
+// A toJSON anywhere on the prototype chain is honoured.
+Object.prototype.toJSON = function() { return "object"; };
+assertEquals('"object"', JSON.stringify({ a: 1 }));
+assertEquals('"object"', JSON.stringify([1, 2]));
+delete Object.prototype.toJSON;
+assertEquals('{"a":1}', JSON.stringify({ a: 1 }));
+
+Array.prototype[1] = "from prototype";
+assertEquals('[1,"from prototype",3]', JSON.stringify([1, , 3]));
+delete Array.prototype[1];
+assertEquals('[1,null,3]', JSON.stringify([1, , 3]));
@@ -0,0 +1,77 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Calls to missing methods go to method_missing, with the name as an atom
+// followed by the arguments.
+function Ghost() {}
+Ghost.prototype.method_missing = function(name, a, b) {
+  return [String(name), a, b, this];
+};
+
+var g = new Ghost();
+function CallFoo(o) { return o.foo(1, 2); }
+for (var i = 0; i < 10; i++) {
+  var result = CallFoo(g);
+  assertEquals("foo", result[0]);
+  assertEquals(1, result[1]);
+  assertEquals(2, result[2]);
+  assertSame(g, result[3]);
+}
+
+// Keyed calls and other names work the same way.
+assertEquals("bar", g.bar()[0]);
+assertEquals("bar", g["bar"]()[0]);
+
+// Defining the method later takes precedence.
+Ghost.prototype.foo = function() { return "foo"; };
+assertEquals("foo", CallFoo(g));
+
+// Receivers in dictionary mode are handled too.
+var d = new Ghost();
+for (var i = 0; i < 100; i++) d["p" + i] = i;
+for (var i = 0; i < 100; i++) delete d["p" + i];
+function CallQux(o) { return o.qux(3); }
+for (var i = 0; i < 10; i++) assertEquals(3, CallQux(d)[1]);
+d.qux = function(x) { return x + 1; };
+assertEquals(4, CallQux(d));
+
+// Objects without method_missing still throw, and so does a
+// method_missing that is not a function.
+assertThrows(function() { ({}).foo(); }, TypeError);
+assertThrows(function() { foo(); }, ReferenceError);
+var h = new Ghost();
+h.method_missing = 42;
+assertThrows(function() { h.quux(); }, TypeError);
+
+// Methods added anywhere on the prototype chain take precedence.
+function CallBaz(o) { return o.baz(); }
+for (var i = 0; i < 10; i++) assertEquals("baz", CallBaz(g)[0]);
+Object.prototype.baz = function() { return "Object.prototype.baz"; };
+assertEquals("Object.prototype.baz", CallBaz(g));
+delete Object.prototype.baz;
+assertEquals("baz", CallBaz(g)[0]);
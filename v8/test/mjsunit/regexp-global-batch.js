@@ -0,0 +1,169 @@
+// Copyright 2008 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Global matching in replace, match and split finds matches in batches.
+// Check results and the last match state against exec-based reference
+// implementations, with more matches than fit into a single batch.
+
+function ReferenceSplit(subject, separator, limit) {
+  limit = (limit === undefined) ? 0xffffffff : limit >>> 0;
+  if (limit === 0) return [];
+  var length = subject.length;
+  if (length === 0) return separator.exec(subject) ? [] : [subject];
+  var re = new RegExp(separator.source,
+                      (separator.ignoreCase ? "i" : "") +
+                      (separator.multiline ? "m" : "") + "g");
+  var currentIndex = 0;
+  var startIndex = 0;
+  var result = [];
+  outer: while (true) {
+    if (startIndex === length) {
+      result.push(subject.substring(currentIndex, length));
+      break;
+    }
+    re.lastIndex = startIndex;
+    var match = re.exec(subject);
+    if (match === null || match.index === length) {
+      result.push(subject.substring(currentIndex, length));
+      break;
+    }
+    var endIndex = match.index + match[0].length;
+    if (startIndex === endIndex && endIndex === currentIndex) {
+      startIndex++;
+      continue;
+    }
+    result.push(subject.substring(currentIndex, match.index));
+    if (result.length === limit) break;
+    for (var i = 1; i < match.length; i++) {
+      result.push(match[i]);
+      if (result.length === limit) break outer;
+    }
+    startIndex = currentIndex = endIndex;
+  }
+  return result;
+}
+
+function ReferenceMatches(subject, re) {
+  var global = new RegExp(re.source, (re.ignoreCase ? "i" : "") + "g");
+  var matches = [];
+  var match;
+  while ((match = global.exec(subject)) !== null) {
+    matches.push(match);
+    if (match[0].length === 0) global.lastIndex++;
+    if (global.lastIndex > subject.length) break;
+  }
+  return matches;
+}
+
+function LastMatchState() {
+  return [RegExp.lastMatch, RegExp.leftContext, RegExp.$1, RegExp.$2];
+}
+
+var long_subject = "";
+for (var i = 0; i < 700; i++) {
+  long_subject += "k" + i + "=v" + (i % 13) + (i % 3 ? ";" : ";;");
+}
+
+var subjects = ["", "a", "aaa", "a,b,,c", "xaxbx", "ሴ,ሴ,x", long_subject];
+var separators = [/,/, /(,)/, /a*/, /(a)|(b)/, /x*?/, /(?:)/, /;/,
+                  /(\d+);/, /=v(\d)(;)?/, /k(9)(9)?/, /ሴ/, /$/, /^/m];
+
+for (var i = 0; i < subjects.length; i++) {
+  var subject = subjects[i];
+  for (var j = 0; j < separators.length; j++) {
+    var separator = separators[j];
+    var limits = [undefined, 1, 2, 3, 200, 1500];
+    for (var k = 0; k < limits.length; k++) {
+      var limit = limits[k];
+      var expected = ReferenceSplit(subject, separator, limit);
+      var expected_state = LastMatchState();
+      "reset".match(/r(e)(s)/);
+      var actual = subject.split(separator, limit);
+      assertEquals(expected, actual, separator + " " + limit);
+      if (subject.length > 0 && separator.exec(subject)) {
+        separator.exec("");  // Do not disturb the state below.
+      }
+    }
+
+    var matches = ReferenceMatches(subject, separator);
+    var global = new RegExp(separator.source,
+                            (separator.multiline ? "m" : "") + "g");
+    var expected_matches = matches.map(function(m) { return m[0]; });
+    if (matches.length == 0) expected_matches = null;
+    assertEquals(expected_matches, subject.match(global), "match " + global);
+
+    var expected_replace = subject;
+    if (matches.length > 0) {
+      expected_replace = "";
+      var prev = 0;
+      for (var m = 0; m < matches.length; m++) {
+        var match = matches[m];
+        expected_replace += subject.substring(prev, match.index) +
+            "<" + (match.length < 2 ? "$1" :
+                   match[1] === undefined ? "" : match[1]) + ">";
+        prev = match.index + match[0].length;
+      }
+      expected_replace += subject.substring(prev);
+    }
+    assertEquals(expected_replace, subject.replace(global, "<$1>"),
+                 "replace " + global);
+    if (matches.length > 0) {
+      var last = matches[matches.length - 1];
+      assertEquals(last[0], RegExp.lastMatch, "lastMatch " + global);
+      // Replacing a plain string pattern records its first match instead.
+      if (last.length > 1) {
+        assertEquals(subject.substring(0, last.index), RegExp.leftContext);
+      }
+    }
+
+    var expected_empty = subject;
+    if (matches.length > 0) {
+      expected_empty = expected_replace.replace(/<[^>]*>/g, "");
+    }
+    if (subject.indexOf("<") == -1) {
+      assertEquals(expected_empty, subject.replace(global, ""),
+                   "replace empty " + global);
+    }
+
+    var calls = 0;
+    subject.replace(global, function() { calls++; return ""; });
+    assertEquals(matches.length, calls, "replace function " + global);
+  }
+}
+
+// The last match of a split is the last one the splitting looked at.
+"a1b2c3".split(/(\d)/);
+assertEquals("3", RegExp.lastMatch);
+"a1b2c3".split(/(\d)/, 2);
+assertEquals("1", RegExp.lastMatch);
+"a1b2c".split(/(\d)/);
+assertEquals("2", RegExp.lastMatch);
+
+// Non-global replace only replaces the first match.
+assertEquals("<a>,b,a", "a,b,a".replace(/(a)/, "<$1>"));
+assertEquals("a", RegExp.lastMatch);
+assertEquals(",b,a", "a,b,a".replace(/a/, ""));
@@ -0,0 +1,81 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Regexps that start with a literal are only entered at occurrences of the
+// literal.  Check them against subjects on both sides of the length at
+// which the generated code hands over to the runtime.
+
+function filler(length) {
+  var s = "";
+  while (s.length < length) s += "abcdefghij ";
+  return s.substring(0, length);
+}
+
+var lengths = [0, 10, 255, 256, 1000];
+for (var i = 0; i < lengths.length; i++) {
+  var pad = filler(lengths[i]);
+
+  var m = /abc(\d+)/.exec(pad + "abcx abc12 abc3");
+  assertEquals("abc12", m[0]);
+  assertEquals("12", m[1]);
+  assertEquals(pad.length + 5, m.index);
+
+  assertNull(/xyz(\d)/.exec(pad + "xyz"));
+  assertNull(/xyz\d/.exec(pad));
+  assertTrue(/d(e)f/.test(pad + "def"));
+  assertEquals(pad.length > 0, /a(.)?/.test(pad));
+
+  // The prefix occurs right at the end.
+  assertEquals(1, (pad + "xyz").match(/xyz$/g).length);
+  assertNull(/xyz./.exec(pad + "xyz"));
+
+  // Prefixes within captures and alternatives that do not have one.
+  assertEquals("(q)r", /(\(q\))r/.exec(pad + "(q)r")[0]);
+  assertEquals("zz", /zz|yy/.exec(pad + "yzz zz")[0]);
+  assertEquals("yy", /(?:yy|zz)/.exec(pad + "yyzz")[0]);
+  assertEquals("qq1", /q*q1/.exec(pad + "qqq1")[0].substring(1));
+
+  // Case-insensitive patterns are not searched literally.
+  assertEquals("XyZ", /xyz/i.exec(pad + "XyZ")[0]);
+  assertEquals("XyZ1", /xyz\d/i.exec(pad + "XyZ1")[0]);
+
+  // Global matching, replace and split restart the prefix search at
+  // lastIndex.
+  var subject = pad + "k1 k2 kx k3";
+  assertEquals(["k1", "k2", "k3"], subject.match(/k\d/g));
+  assertEquals(pad + "<1> <2> kx <3>", subject.replace(/k(\d)/g, "<$1>"));
+  assertEquals([pad, " ", " kx ", ""], subject.split(/k\d/));
+  var re = /k(\d)/g;
+  re.lastIndex = pad.length + 2;
+  assertEquals("k2", re.exec(subject)[0]);
+  assertEquals(pad.length + 5, re.lastIndex);
+
+  // Two-byte subjects and prefixes.
+  assertEquals("ሴx1", /ሴx(\d)/.exec(pad + "ሴy ሴx1")[0]);
+  assertNull(/ሴx(\d)/.exec(pad + "x1"));
+  assertEquals("ab1", /ab\d/.exec("ሴ" + pad + "ab1")[0]);
+}
@@ -0,0 +1,86 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --regexp-tier-up --regexp-tier-up-executions=3
+// Flags: --regexp-tier-up-subject-length=200
+
+// Regexps are interpreted until they are hot and then compiled to native
+// code. Results must not change when a regexp tiers up.
+
+function CheckExec(re, subject, expected) {
+  re.lastIndex = 0;
+  var result = re.exec(subject);
+  assertEquals(expected, result === null ? null : result.slice(0));
+  if (result !== null) assertEquals(subject.indexOf(expected[0]), result.index);
+}
+
+// Tier up by number of executions, on ASCII and two-byte subjects.
+for (var i = 0; i < 10; i++) {
+  var re = /(a+)(b*)?c/;
+  CheckExec(re, "xxaabbc", ["aabbc", "aa", "bb"]);
+  CheckExec(re, "xxac", ["ac", "a", undefined]);
+  CheckExec(re, "\u1234aaac", ["aaac", "aaa", undefined]);
+  CheckExec(re, "xxabb", null);
+}
+
+// Tier up by subject length.
+var long_subject = new Array(50).join("foo ") + "bar42";
+for (var i = 0; i < 5; i++) {
+  CheckExec(/b(a)r(\d+)/, long_subject, ["bar42", "a", "42"]);
+}
+
+// Global matching on long subjects interprets and runs native code.
+var words = new Array(300).join("ab12 ") + "cd3";
+for (var i = 0; i < 5; i++) {
+  var matches = words.match(/[a-z]+(\d+)/g);
+  assertEquals(300, matches.length);
+  assertEquals("ab12", matches[0]);
+  assertEquals("cd3", matches[299]);
+}
+
+// The regexp becomes hot in the middle of a global replace while its
+// callback runs the same regexp.
+var inner_count = 0;
+function Swap(m, letter, digits) {
+  inner_count++;
+  var inner = /([a-z])(\d+)/.exec(m + m + m);
+  assertEquals(m, inner[0]);
+  return digits + letter;
+}
+var replaced = "x1y22z333".replace(/([a-z])(\d+)/g, Swap);
+assertEquals("1x22y333z", replaced);
+assertEquals(3, inner_count);
+
+// Backreferences, case-insensitivity and multiline behave the same before
+// and after tiering up.
+for (var i = 0; i < 6; i++) {
+  assertTrue(/(\w)\1/.test("abccd"));
+  assertFalse(/(\w)\1/.test("abcd"));
+  assertTrue(/ABC/i.test("xxabcxx"));
+  assertEquals(["b"], "a\nb".match(/^b/m).slice(0));
+  assertEquals("a-b-c", "a b c".split(/\s/).join("-"));
+}
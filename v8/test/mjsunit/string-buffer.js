@@ -0,0 +1,87 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax
+
+// Appending to a string makes a string buffer, and appending to a buffer
+// changes it in place.
+var s = %StringAppend("abc", "def");
+assertTrue(%IsStringBuffer(s));
+assertEquals("string", typeof s);
+assertEquals(6, s.length);
+assertSame(s, %StringAppend(s, "ghi"));
+assertEquals(9, s.length);
+assertEquals("abcdefghi", String(s));
+assertEquals("b", s[1]);
+assertEquals(undefined, s[9]);
+
+// Buffers read as flat strings.
+assertEquals("abcdefghi!", s + "!");
+assertEquals("ABCDEFGHI", s.toUpperCase());
+assertEquals(3, s.indexOf("def"));
+assertTrue(s == "abcdefghi");
+assertFalse(s === "abcdefghi");
+assertTrue(s < "b");
+
+// Views taken before an append keep their contents.
+var before = String(s);
+%StringAppend(s, "jkl");
+assertEquals("abcdefghi", before);
+assertEquals("abcdefghijkl", String(s));
+
+// Non-strings are converted, buffers are appended by contents, and a
+// buffer can be appended to itself.
+var t = %StringAppend("", 42);
+%StringAppend(t, null);
+assertEquals("42null", String(t));
+%StringAppend(t, t);
+assertEquals("42null42null", String(t));
+var u = %StringAppend("x", t);
+assertEquals("x42null42null", String(u));
+
+// Growing switches to two-byte characters when needed.
+var w = %StringAppend("", "a");
+for (var i = 0; i < 100; i++) %StringAppend(w, "b");
+%StringAppend(w, "ሴ");
+assertEquals(102, w.length);
+assertEquals("ሴ", w[101]);
+assertEquals("ab", String(w).substring(0, 2));
+
+// Any other receiver is shifted left.
+assertEquals(8, %StringAppend(1, 3));
+
+function Build(n) {
+  var b = "";
+  for (var i = 0; i < n; i++) b = %StringAppend(b, i % 10);
+  return b;
+}
+
+assertEquals("0123456789", String(Build(10)));
+for (var i = 0; i < 5; i++) Build(100);
+%OptimizeFunctionOnNextCall(Build);
+assertEquals(1000, Build(1000).length);
@@ -69,3 +69,20 @@ for (var i = 1; i <= 128; i <<= 1); {
     }
   }
 }
+
+// Two-byte strings of Latin-1 text, and Latin-1 characters whose case is
+// outside of Latin-1 or longer than one character.
+assertEquals("ÀÉÎÕÜ ÀÉÎÕÜ", "àéîõü ÀÉÎÕÜ".toUpperCase());
+assertEquals("àéîõü àéîõü", "àéîõü ÀÉÎÕÜ".toLowerCase());
+assertEquals("×÷", "×÷".toUpperCase());
+assertEquals("ŸΜ", "ÿµ".toUpperCase());
+assertEquals("STRASSE", "straße".toUpperCase());
+assertEquals("ÀΚΟΣΜΟΣ", "àκοσμος".toUpperCase());
+
+// Slices of ASCII and two-byte strings.
+var ascii = "Hello, World! This string is long enough to be sliced.";
+assertEquals("WORLD! THIS STRING IS LONG ENOUGH",
+             ascii.substring(7, 40).toUpperCase());
+var two_byte = "Ünïcödé, World! This string is long enough to be sliced.";
+assertEquals("ünïcödé, world! this string is long",
+             two_byte.substring(0, 35).toLowerCase());
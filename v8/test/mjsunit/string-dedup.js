@@ -0,0 +1,57 @@
+// Copyright 2008 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --string-dedup --expose-gc --noincremental-marking
+
+// Build many equal strings that are not symbols, hold them in arrays and
+// sliced strings, and check that they survive full collections that make
+// them share copies.
+
+var values = ["red", "green", "blue", "cyan", "αβγ"];
+var strings = [];
+var slices = [];
+for (var i = 0; i < 5000; i++) {
+  var s = values[i % values.length];
+  var copy = (s + "!").substring(0, s.length);
+  strings.push(copy);
+  slices.push((copy + "0123456789abcdef").substring(1, 20));
+}
+
+for (var round = 0; round < 3; round++) {
+  gc();
+  for (var i = 0; i < strings.length; i++) {
+    var expected = values[i % values.length];
+    assertEquals(expected, strings[i]);
+    assertEquals((expected + "0123456789abcdef").substring(1, 20), slices[i]);
+  }
+}
+
+var o = {};
+for (var i = 0; i < strings.length; i++) o[strings[i]] = i;
+gc();
+assertEquals(4995, o.red);
+assertEquals(4999, o["αβγ"]);
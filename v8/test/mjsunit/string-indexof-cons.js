@@ -0,0 +1,74 @@
+// Copyright 2008 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Test indexOf on long cons strings, which are searched piece by piece
+// before they are flattened.
+
+function Filler(c, n) {
+  return new Array(n + 1).join(c);
+}
+
+// Builds a deep cons string from many short pieces.
+function Build(pieces) {
+  var s = '';
+  for (var i = 0; i < pieces; i++) {
+    s += 'abcdefghijklmnopqrst';
+  }
+  return s;
+}
+
+var tail = Filler('b', 200000);
+var boundaries = [0, 16 * 1024, 32 * 1024, 100000];
+for (var i = 0; i < boundaries.length; i++) {
+  for (var delta = -7; delta <= 7; delta++) {
+    var position = boundaries[i] + delta;
+    if (position < 0) continue;
+    var subject = Filler('a', position) + 'needle' + tail;
+    assertEquals(position, subject.indexOf('needle'));
+    assertEquals(position, subject.indexOf('needle', position));
+    assertEquals(-1, subject.indexOf('needle', position + 1));
+    assertEquals(-1, subject.indexOf('needlex'));
+  }
+}
+
+// Two-byte subjects and patterns.
+var subject = Filler('a', 40000) + 'ሴ噸' + tail;
+assertEquals(40000, subject.indexOf('ሴ噸'));
+assertEquals(40001, subject.indexOf('噸b'));
+assertEquals(-1, subject.indexOf('噸a'));
+subject = Filler('x', 70000) + 'needleሴ' + Filler('y', 70000);
+assertEquals(70000, subject.indexOf('needle'));
+assertEquals(70000, subject.indexOf('needleሴ'));
+
+// Deep cons strings.
+subject = Build(10000) + 'needle' + Build(10000);
+assertEquals(200000, subject.indexOf('needle'));
+assertEquals(19, subject.indexOf('ta'));
+assertEquals(200000 - 21, subject.indexOf('t', 200000 - 25));
+assertEquals(-1, subject.indexOf('needle', 200001));
+assertEquals(200000, subject.indexOf('needle'));
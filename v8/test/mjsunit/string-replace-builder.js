@@ -0,0 +1,51 @@
+// Copyright 2009 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Test replacements whose result outgrows the subject or mixes ASCII and
+// two-byte parts.
+
+var subject = "abcabc";
+function repeat(s, n) {
+  var result = "";
+  for (var i = 0; i < n; i++) result += s;
+  return result;
+}
+var long = repeat("x", 1000);
+
+assertEquals("a" + long + "cabc",
+             subject.replace("b", function() { return long; }));
+assertEquals("a" + long + "cabc", subject.replace("b", long));
+assertEquals("aሴcabc", subject.replace("b", "ሴ"));
+assertEquals("aሴcabc", subject.replace(/b/, function() { return "ሴ"; }));
+assertEquals("ሴaሴ", "ሴbሴ".replace("b", "a"));
+assertEquals("a[b]" + long + "cabc", subject.replace("b", "[$&]" + long));
+assertEquals("a$b" + long + "$cabc", subject.replace("b", "$$$&" + long + "$"));
+assertEquals("aaሴcabc", subject.replace("b", "$`ሴ"));
+assertEquals("acabcccabc", subject.replace("b", "$'c"));
+assertEquals("", "b".replace("b", ""));
+assertEquals("ac", "abc".replace(/(b)/, function(m, c) { return ""; }));
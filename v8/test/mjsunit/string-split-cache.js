@@ -38,3 +38,33 @@ assertEquals("c", str[2]);
 var array = str.split("");
 var expected = ["a", "b", "c", "d", "e", "f"];
 assertArrayEquals(expected, array);
+
+
+// Splits of a symbol by a regexp are cached.  The cached parts are shared
+// copy-on-write and a hit restores the last match.
+function splitByRegExp() {
+  return "a1b22c333d".split(/(\d)\d*/);
+}
+
+for (var i = 0; i < 3; i++) {
+  var parts = splitByRegExp();
+  assertArrayEquals(["a", "1", "b", "2", "c", "3", "d"], parts);
+  assertEquals("333", RegExp.lastMatch);
+  assertEquals("3", RegExp.$1);
+  assertEquals("c", RegExp.leftContext.slice(-1));
+  parts[0] = "x";
+  parts.push("y");
+}
+
+// Captures that do not participate are undefined in the cached parts.
+for (var i = 0; i < 3; i++) {
+  assertArrayEquals(["a", undefined, "b", "-", "c"],
+                    "a,b-c".split(/,|(-)/));
+  assertEquals("-", RegExp.lastMatch);
+}
+
+// Different regexps with the same subject do not share an entry.
+for (var i = 0; i < 3; i++) {
+  assertArrayEquals(["a", "b,c"], "a;b,c".split(/;/));
+  assertArrayEquals(["a;b", "c"], "a;b,c".split(/,/));
+}
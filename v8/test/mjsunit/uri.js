@@ -76,3 +76,22 @@ assertEquals(cc8_2, decodeURI(encodeURI(s8)).charCodeAt(1));
 assertEquals(cc9_1, decodeURI(encodeURI(s9)).charCodeAt(0));
 assertEquals(cc9_2, decodeURI(encodeURI(s9)).charCodeAt(1));
 assertEquals(cc10, decodeURI(encodeURI(s10)).charCodeAt(0));
+
+// Strings without anything to escape or decode come back unchanged.
+var plain = "abc-DEF_123.~!*'()";
+assertEquals(plain, encodeURIComponent(plain));
+assertEquals(plain, decodeURIComponent(plain));
+
+// Reserved characters stay escaped in decodeURI, as they were written.
+assertEquals("a%2fb%3F c", decodeURI("a%2fb%3F%20c"));
+assertEquals("a/b? c", decodeURIComponent("a%2fb%3F%20c"));
+assertEquals("a/b?%20c#", encodeURI("a/b? c#"));
+assertEquals("a%2Fb%3F%20c%23", encodeURIComponent("a/b? c#"));
+
+// Malformed input still throws.
+assertThrows("decodeURIComponent('%')", URIError);
+assertThrows("decodeURIComponent('%E2%82')", URIError);
+assertThrows("decodeURIComponent('%C0%80')", URIError);
+assertThrows("decodeURIComponent('%ED%A0%80')", URIError);
+assertThrows("encodeURIComponent('\\ud800')", URIError);
+assertThrows("encodeURIComponent('\\udc00x')", URIError);
@@ -148,6 +148,13 @@
                 ],
               },
               'conditions': [
+                ['embed_script!=""', {
+                  'variables': {
+                    'mksnapshot_flags': [
+                      '--extra-code', '<(embed_script)',
+                    ],
+                  },
+                }],
                 ['v8_target_arch=="arm"', {
                   # The following rules should be consistent with chromium's
                   # common.gypi and V8's runtime rule to ensure they all generate
@@ -265,6 +272,8 @@
             '../../src/compilation-cache.h',
             '../../src/compiler.cc',
             '../../src/compiler.h',
+            '../../src/context-pool.cc',
+            '../../src/context-pool.h',
             '../../src/contexts.cc',
             '../../src/contexts.h',
             '../../src/conversions-inl.h',
@@ -278,6 +287,8 @@
             '../../src/cpu-profiler.h',
             '../../src/data-flow.cc',
             '../../src/data-flow.h',
+            '../../src/date.cc',
+            '../../src/date.h',
             '../../src/dateparser.cc',
             '../../src/dateparser.h',
             '../../src/dateparser-inl.h',
@@ -304,6 +315,8 @@
             '../../src/fast-dtoa.cc',
             '../../src/fast-dtoa.h',
             '../../src/flag-definitions.h',
+            '../../src/feedback-profile.cc',
+            '../../src/feedback-profile.h',
             '../../src/fixed-dtoa.cc',
             '../../src/fixed-dtoa.h',
             '../../src/flags.cc',
@@ -321,7 +334,6 @@
             '../../src/handles-inl.h',
             '../../src/handles.cc',
             '../../src/handles.h',
-            '../../src/hashmap.cc',
             '../../src/hashmap.h',
             '../../src/heap-inl.h',
             '../../src/heap.cc',
@@ -363,6 +375,8 @@
             '../../src/log-utils.h',
             '../../src/log.cc',
             '../../src/log.h',
+            '../../src/lz-codec.cc',
+            '../../src/lz-codec.h',
             '../../src/macro-assembler.h',
             '../../src/mark-compact.cc',
             '../../src/mark-compact.h',
@@ -376,6 +390,8 @@
             '../../src/objects-visiting.h',
             '../../src/objects.cc',
             '../../src/objects.h',
+            '../../src/optimizing-compiler-thread.cc',
+            '../../src/optimizing-compiler-thread.h',
             '../../src/parser.cc',
             '../../src/parser.h',
             '../../src/platform-tls-mac.h',
@@ -438,6 +454,7 @@
             '../../src/string-stream.h',
             '../../src/strtod.cc',
             '../../src/strtod.h',
+            '../../src/structured-clone.cc',
             '../../src/stub-cache.cc',
             '../../src/stub-cache.h',
             '../../src/token.cc',
@@ -745,6 +762,7 @@
               '../../src/macros.py',
               '../../src/proxy.js',
               '../../src/collection.js',
+              '../../src/typedarray.js',
             ],
           },
           'actions': [
@@ -812,6 +830,32 @@
             }],
           ],
         },
+        {
+          'target_name': 'tick-processor',
+          'type': 'executable',
+          'dependencies': [
+            'v8_base',
+            'v8_nosnapshot',
+          ],
+          'include_dirs+': [
+            '../../src',
+          ],
+          'sources': [
+            '../../src/tick-processor.cc',
+          ],
+          'conditions': [
+            ['want_separate_host_toolset==1', {
+              'toolsets': ['host'],
+            }, {
+              'toolsets': ['target'],
+            }],
+            ['v8_compress_startup_data=="bz2"', {
+              'libraries': [
+                '-lbz2',
+              ]
+            }],
+          ],
+        },
         {
           'target_name': 'v8_shell',
           'type': 'executable',
@@ -871,7 +915,6 @@
             '../../src/fixed-dtoa.cc',
             '../../src/fixed-dtoa.h',
             '../../src/globals.h',
-            '../../src/hashmap.cc',
             '../../src/hashmap.h',
             '../../src/list-inl.h',
             '../../src/list.h',
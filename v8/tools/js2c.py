@@ -52,6 +52,50 @@ def ToCArray(lines):
   return ", ".join(result)
 
 
+def LZCompress(data):
+  """Compresses data in the format read by LZCodec::Decompress (lz-codec.h)."""
+  MIN_MATCH = 4
+  MAX_OFFSET = 0xFFFF
+  result = []
+
+  def AppendLength(length):
+    while length >= 255:
+      result.append(chr(255))
+      length -= 255
+    result.append(chr(length))
+
+  def AppendSequence(literals, offset, match_length):
+    match_code = 0
+    if match_length > 0: match_code = match_length - MIN_MATCH
+    result.append(chr((min(len(literals), 15) << 4) | min(match_code, 15)))
+    if len(literals) >= 15: AppendLength(len(literals) - 15)
+    result.append(literals)
+    if match_length == 0: return
+    result.append(chr(offset & 0xFF))
+    result.append(chr(offset >> 8))
+    if match_code >= 15: AppendLength(match_code - 15)
+
+  last_seen = {}
+  anchor = 0
+  pos = 0
+  while pos + MIN_MATCH <= len(data):
+    sequence = data[pos:pos + MIN_MATCH]
+    candidate = last_seen.get(sequence, -1)
+    last_seen[sequence] = pos
+    if candidate >= 0 and pos - candidate <= MAX_OFFSET:
+      match_length = MIN_MATCH
+      while (pos + match_length < len(data) and
+             data[candidate + match_length] == data[pos + match_length]):
+        match_length += 1
+      AppendSequence(data[anchor:pos], pos - candidate, match_length)
+      pos += match_length
+      anchor = pos
+    else:
+      pos += 1
+  AppendSequence(data[anchor:], 0, 0)
+  return "".join(result)
+
+
 def RemoveCommentsAndTrailingWhitespace(lines):
   lines = re.sub(r'//.*\n', '\n', lines) # end-of-line comments
   lines = re.sub(re.compile(r'/\*.*?\*/', re.DOTALL), '', lines) # comments.
@@ -128,12 +172,13 @@ def ExpandMacros(lines, macros):
       end = pattern_match.end()
       assert lines[end - 1] == '('
       last_match = end
-      arg_index = 0
+      arg_index = [0]  # Wrap state into array, to work around Python "scoping"
       mapping = { }
       def add_arg(str):
         # Remember to expand recursively in the arguments
         replacement = ExpandMacros(str.strip(), macros)
-        mapping[macro.args[arg_index]] = replacement
+        mapping[macro.args[arg_index[0]]] = replacement
+        arg_index[0] += 1
       while end < len(lines) and height > 0:
         # We don't count commas at higher nesting levels.
         if lines[end] == ',' and height == 1:
@@ -344,6 +389,8 @@ def JS2C(source, target, env):
     raw_sources_declaration = RAW_SOURCES_COMPRESSION_DECLARATION
     if env['COMPRESSION'] == 'bz2':
       all_sources = bz2.compress("".join(all_sources))
+    elif env['COMPRESSION'] == 'lz':
+      all_sources = LZCompress("".join(all_sources))
     total_length = len(all_sources)
     sources_data = ToCArray(all_sources)
 
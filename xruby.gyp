@@ -15,10 +15,28 @@
       'target_name': 'xruby',
       'sources': [
         'src/main.cpp',
+        'src/ruby_parser.cpp',
       ],
       'include_dirs': [
         #'ruby19/include',
       ],
+    },
+    {
+      # Runs Ruby scripts through the front end and checks what they print,
+      # see src/ruby_parser_test.cpp.
+      'target_name': 'xruby_test',
+      'sources': [
+        'src/ruby_parser.cpp',
+        'src/ruby_parser_test.cpp',
+      ],
+    },
+    {
+      # Runs v8/benchmarks natively and reports statistics, see
+      # src/benchmark_runner.cpp.
+      'target_name': 'xruby_benchmark',
+      'sources': [
+        'src/benchmark_runner.cpp',
+      ],
     }
   ],
 }